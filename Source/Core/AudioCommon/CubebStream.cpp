@@ -46,9 +46,14 @@ bool CubebStream::Init()
     ERROR_LOG(AUDIO, "Error getting minimum latency");
   INFO_LOG(AUDIO, "Minimum latency: %i frames", minimum_latency);
 
+  // Low latency mode asks for the backend's minimum rather than our default buffer.
+  u32 latency = std::max(BUFFER_SAMPLES, minimum_latency);
+  if (SConfig::GetInstance().m_audio_low_latency && minimum_latency != 0)
+    latency = minimum_latency;
+
   return cubeb_stream_init(m_ctx.get(), &m_stream, "Dolphin Audio Output", nullptr, nullptr,
-                           nullptr, &params, std::max(BUFFER_SAMPLES, minimum_latency),
-                           DataCallback, StateCallback, this) == CUBEB_OK;
+                           nullptr, &params, latency, DataCallback, StateCallback,
+                           this) == CUBEB_OK;
 }
 
 bool CubebStream::SetRunning(bool running)
@@ -56,7 +61,18 @@ bool CubebStream::SetRunning(bool running)
   // Can be called by multiple threads (main and emulation)
   CubebUtils::ScopedThreadAccess thread_access;
   if (running)
-    return cubeb_stream_start(m_stream) == CUBEB_OK;
+  {
+    if (cubeb_stream_start(m_stream) != CUBEB_OK)
+      return false;
+
+    u32 latency = 0;
+    if (cubeb_stream_get_latency(m_stream, &latency) == CUBEB_OK)
+    {
+      NOTICE_LOG(AUDIO, "Cubeb output latency: %u frames (%.2f ms)", latency,
+                 1000.0 * latency / m_mixer->GetSampleRate());
+    }
+    return true;
+  }
   else
     return cubeb_stream_stop(m_stream) == CUBEB_OK;
 }
@@ -4,16 +4,25 @@
 
 #include "AudioCommon/Mixer.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 
+#if defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
 #include "AudioCommon/DPL2Decoder.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
 #include "Common/Swap.h"
+#include "Common/Thread.h"
+#include "Common/TraceEvents.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
 
 Mixer::Mixer(unsigned int BackendSampleRate)
     : m_sampleRate(BackendSampleRate), m_stretcher(BackendSampleRate)
@@ -33,19 +42,161 @@ void Mixer::DoState(PointerWrap& p)
   m_wiimote_speaker_mixer.DoState(p);
 }
 
+namespace
+{
+// Dot product of SINC_TAPS input samples with one phase of the Q14 kernel.
+s32 SincDot(const s16* input, const s16* kernel)
+{
+#if defined(_M_X86)
+  const __m128i* in = reinterpret_cast<const __m128i*>(input);
+  const __m128i* k = reinterpret_cast<const __m128i*>(kernel);
+  __m128i sum = _mm_add_epi32(_mm_madd_epi16(_mm_loadu_si128(in), _mm_load_si128(k)),
+                              _mm_madd_epi16(_mm_loadu_si128(in + 1), _mm_load_si128(k + 1)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+#elif defined(_M_ARM_64)
+  int32x4_t sum = vmull_s16(vld1_s16(input), vld1_s16(kernel));
+  sum = vmlal_s16(sum, vld1_s16(input + 4), vld1_s16(kernel + 4));
+  sum = vmlal_s16(sum, vld1_s16(input + 8), vld1_s16(kernel + 8));
+  sum = vmlal_s16(sum, vld1_s16(input + 12), vld1_s16(kernel + 12));
+  return vaddvq_s32(sum);
+#else
+  s32 sum = 0;
+  for (int i = 0; i < 16; ++i)
+    sum += input[i] * kernel[i];
+  return sum;
+#endif
+}
+}  // namespace
+
+const std::array<s16, Mixer::SINC_PHASES * Mixer::SINC_TAPS>& Mixer::SincKernel()
+{
+  static_assert(SINC_TAPS == 16, "SincDot assumes 16 taps");
+
+  alignas(16) static const std::array<s16, SINC_PHASES * SINC_TAPS> s_kernel = [] {
+    // Blackman-windowed sinc, cut off a little below the input Nyquist frequency so that the
+    // transition band doesn't alias.
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double CUTOFF = 0.9;
+    constexpr double HALF_WIDTH = SINC_TAPS / 2;
+
+    std::array<s16, SINC_PHASES * SINC_TAPS> kernel;
+    for (u32 phase = 0; phase < SINC_PHASES; ++phase)
+    {
+      const double frac = static_cast<double>(phase) / SINC_PHASES;
+      std::array<double, SINC_TAPS> taps;
+      double sum = 0.0;
+      for (u32 i = 0; i < SINC_TAPS; ++i)
+      {
+        const double x = static_cast<double>(i) - SINC_HISTORY - frac;
+        const double sinc = x == 0.0 ? 1.0 : std::sin(PI * CUTOFF * x) / (PI * CUTOFF * x);
+        const double window = 0.42 + 0.5 * std::cos(PI * x / HALF_WIDTH) +
+                              0.08 * std::cos(2.0 * PI * x / HALF_WIDTH);
+        taps[i] = sinc * window;
+        sum += taps[i];
+      }
+
+      // Normalize to unity gain at DC, putting the rounding error on the nearest tap.
+      s32 total = 0;
+      for (u32 i = 0; i < SINC_TAPS; ++i)
+      {
+        kernel[phase * SINC_TAPS + i] = static_cast<s16>(std::lround(taps[i] / sum * 16384.0));
+        total += kernel[phase * SINC_TAPS + i];
+      }
+      kernel[phase * SINC_TAPS + SINC_HISTORY + (phase >= SINC_PHASES / 2)] += 16384 - total;
+    }
+    return kernel;
+  }();
+
+  return s_kernel;
+}
+
+// Copies count sample pairs starting at index to m_left/m_right, so the resamplers can run
+// without masking or byteswapping every read.
+void Mixer::MixerFifo::Unpack(u32 index, u32 count)
+{
+  const u32 pos = index & INDEX_MASK;
+  const u32 first = std::min(count, (MAX_SAMPLES * 2 - pos) / 2);
+  for (u32 i = 0; i < first; ++i)
+  {
+    m_left[i] = Common::swap16(m_buffer[pos + i * 2]);
+    m_right[i] = Common::swap16(m_buffer[pos + i * 2 + 1]);
+  }
+  for (u32 i = first; i < count; ++i)
+  {
+    m_left[i] = Common::swap16(m_buffer[(i - first) * 2]);
+    m_right[i] = Common::swap16(m_buffer[(i - first) * 2 + 1]);
+  }
+}
+
+u32 Mixer::MixerFifo::ResampleLinear(short* samples, u32 count, u32 ratio, s32 lvolume,
+                                     s32 rvolume)
+{
+  u32 frac = m_frac;
+  u32 pos = 0;
+  for (u32 i = 0; i < count; ++i)
+  {
+    const s16 l1 = m_left[pos];      // current
+    const s16 l2 = m_left[pos + 1];  // next
+    int sampleL = ((l1 << 16) + (l2 - l1) * (u16)frac) >> 16;
+    sampleL = (sampleL * lvolume) >> 8;
+    sampleL += samples[i * 2 + 1];
+    samples[i * 2 + 1] = MathUtil::Clamp(sampleL, -32767, 32767);
+
+    const s16 r1 = m_right[pos];      // current
+    const s16 r2 = m_right[pos + 1];  // next
+    int sampleR = ((r1 << 16) + (r2 - r1) * (u16)frac) >> 16;
+    sampleR = (sampleR * rvolume) >> 8;
+    sampleR += samples[i * 2];
+    samples[i * 2] = MathUtil::Clamp(sampleR, -32767, 32767);
+
+    frac += ratio;
+    pos += frac >> 16;
+    frac &= 0xffff;
+  }
+  m_frac = frac;
+  return pos;
+}
+
+// m_left/m_right start SINC_HISTORY samples before the read position here.
+u32 Mixer::MixerFifo::ResampleSinc(short* samples, u32 count, u32 ratio, s32 lvolume,
+                                   s32 rvolume)
+{
+  const s16* kernel = SincKernel().data();
+  u32 frac = m_frac;
+  u32 pos = 0;
+  for (u32 i = 0; i < count; ++i)
+  {
+    const s16* phase = kernel + (frac >> (16 - SINC_PHASE_BITS)) * SINC_TAPS;
+
+    int sampleL = (SincDot(&m_left[pos], phase) + (1 << 13)) >> 14;
+    sampleL = (sampleL * lvolume) >> 8;
+    sampleL += samples[i * 2 + 1];
+    samples[i * 2 + 1] = MathUtil::Clamp(sampleL, -32767, 32767);
+
+    int sampleR = (SincDot(&m_right[pos], phase) + (1 << 13)) >> 14;
+    sampleR = (sampleR * rvolume) >> 8;
+    sampleR += samples[i * 2];
+    samples[i * 2] = MathUtil::Clamp(sampleR, -32767, 32767);
+
+    frac += ratio;
+    pos += frac >> 16;
+    frac &= 0xffff;
+  }
+  m_frac = frac;
+  return pos;
+}
+
 // Executed from sound stream thread
 unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
                                    bool consider_framelimit)
 {
-  unsigned int currentSample = 0;
-
   // Cache access in non-volatile variable
   // This is the only function changing the read value, so it's safe to
   // cache it locally although it's written here.
   // The writing pointer will be modified outside, but it will only increase,
   // so we will just ignore new written data while interpolating.
-  // Without this cache, the compiler wouldn't be allowed to optimize the
-  // interpolation loop.
   u32 indexR = m_indexR.load();
   u32 indexW = m_indexW.load();
 
@@ -53,13 +204,28 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   // advance indexR with sample position
   // remember fractional offset
 
-  float emulationspeed = SConfig::GetInstance().m_EmulationSpeed;
+  const SConfig& config = SConfig::GetInstance();
+  float emulationspeed = config.m_EmulationSpeed;
   float aid_sample_rate = static_cast<float>(m_input_sample_rate);
-  if (consider_framelimit && emulationspeed > 0.0f)
+  if (consider_framelimit && config.m_audio_stretch && config.m_audio_rate_control)
+  {
+    // Cheap stretching: steer the FIFO towards half the stretch latency by nudging the
+    // resampling rate. This follows the speed the game actually runs at, at the cost of a
+    // slight pitch shift while it is off.
+    float numLeft = static_cast<float>(((indexW - indexR) & INDEX_MASK) / 2);
+    float target = m_input_sample_rate * config.m_audio_stretch_max_latency / 2000.0f;
+    target = std::min(target, static_cast<float>(MAX_SAMPLES / 2));
+
+    m_numLeftI = (numLeft + m_numLeftI * (CONTROL_AVG - 1)) / CONTROL_AVG;
+    const float adjust = MathUtil::Clamp((m_numLeftI - target) / target * RATE_CONTROL_GAIN,
+                                         -RATE_CONTROL_MAX, RATE_CONTROL_MAX);
+    aid_sample_rate *= 1.0f + adjust;
+  }
+  else if (consider_framelimit && emulationspeed > 0.0f)
   {
     float numLeft = static_cast<float>(((indexW - indexR) & INDEX_MASK) / 2);
 
-    u32 low_waterwark = m_input_sample_rate * SConfig::GetInstance().iTimingVariance / 1000;
+    u32 low_waterwark = m_input_sample_rate * config.iTimingVariance / 1000;
     low_waterwark = std::min(low_waterwark, MAX_SAMPLES / 2);
 
     m_numLeftI = (numLeft + m_numLeftI * (CONTROL_AVG - 1)) / CONTROL_AVG;
@@ -77,32 +243,31 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   s32 lvolume = m_LVolume.load();
   s32 rvolume = m_RVolume.load();
 
-  // TODO: consider a higher-quality resampling algorithm.
-  for (; currentSample < numSamples * 2 && ((indexW - indexR) & INDEX_MASK) > 2; currentSample += 2)
+  // Work out up front how many output samples the buffered input covers, so the resampling
+  // loops don't have to check for underruns.
+  const bool sinc = config.m_audio_sinc_resampler;
+  const u32 history = sinc ? SINC_HISTORY : 0;
+  const u32 lookahead = sinc ? SINC_LOOKAHEAD : 1;
+  const u32 available = ((indexW - indexR) & INDEX_MASK) / 2;
+  u32 count = 0;
+  if (available > lookahead)
   {
-    u32 indexR2 = indexR + 2;  // next sample
-
-    s16 l1 = Common::swap16(m_buffer[indexR & INDEX_MASK]);   // current
-    s16 l2 = Common::swap16(m_buffer[indexR2 & INDEX_MASK]);  // next
-    int sampleL = ((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16;
-    sampleL = (sampleL * lvolume) >> 8;
-    sampleL += samples[currentSample + 1];
-    samples[currentSample + 1] = MathUtil::Clamp(sampleL, -32767, 32767);
-
-    s16 r1 = Common::swap16(m_buffer[(indexR + 1) & INDEX_MASK]);   // current
-    s16 r2 = Common::swap16(m_buffer[(indexR2 + 1) & INDEX_MASK]);  // next
-    int sampleR = ((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16;
-    sampleR = (sampleR * rvolume) >> 8;
-    sampleR += samples[currentSample];
-    samples[currentSample] = MathUtil::Clamp(sampleR, -32767, 32767);
+    const u64 span = (static_cast<u64>(available - lookahead) << 16) - m_frac;
+    count = ratio ? static_cast<u32>(std::min<u64>((span + ratio - 1) / ratio, numSamples)) :
+                    numSamples;
+  }
 
-    m_frac += ratio;
-    indexR += 2 * (u16)(m_frac >> 16);
-    m_frac &= 0xffff;
+  if (count)
+  {
+    const u32 last = static_cast<u32>((m_frac + static_cast<u64>(count - 1) * ratio) >> 16);
+    Unpack(indexR - history * 2, history + last + lookahead + 1);
+    const u32 advance = sinc ? ResampleSinc(samples, count, ratio, lvolume, rvolume) :
+                               ResampleLinear(samples, count, ratio, lvolume, rvolume);
+    indexR += advance * 2;
   }
 
   // Actual number of samples written to the buffer without padding.
-  unsigned int actual_sample_count = currentSample / 2;
+  unsigned int actual_sample_count = count;
 
   // Padding
   short s[2];
@@ -110,7 +275,8 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   s[1] = Common::swap16(m_buffer[(indexR - 2) & INDEX_MASK]);
   s[0] = (s[0] * rvolume) >> 8;
   s[1] = (s[1] * lvolume) >> 8;
-  for (; currentSample < numSamples * 2; currentSample += 2)
+  for (unsigned int currentSample = count * 2; currentSample < numSamples * 2;
+       currentSample += 2)
   {
     int sampleR = MathUtil::Clamp(s[0] + samples[currentSample + 0], -32767, 32767);
     int sampleL = MathUtil::Clamp(s[1] + samples[currentSample + 1], -32767, 32767);
@@ -127,12 +293,15 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
 
 unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
 {
+  TRACE_SCOPE("Mixer::Mix");
   if (!samples)
     return 0;
 
   memset(samples, 0, num_samples * 2 * sizeof(short));
 
-  if (SConfig::GetInstance().m_audio_stretch)
+  // Rate control stretching is done by the FIFOs themselves.
+  const SConfig& config = SConfig::GetInstance();
+  if (config.m_audio_stretch && !config.m_audio_rate_control)
   {
     unsigned int available_samples =
         std::min(m_dma_mixer.AvailableSamples(), m_streaming_mixer.AvailableSamples());
@@ -164,6 +333,7 @@ unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
 
 unsigned int Mixer::MixSurround(float* samples, unsigned int num_samples)
 {
+  TRACE_SCOPE("Mixer::MixSurround");
   if (!num_samples)
     return 0;
 
@@ -172,28 +342,30 @@ unsigned int Mixer::MixSurround(float* samples, unsigned int num_samples)
   // Mix() may also use m_scratch_buffer internally, but is safe because it alternates reads and
   // writes.
   unsigned int available_samples = Mix(m_scratch_buffer.data(), num_samples);
+  const float scale = 1.0f / static_cast<float>(std::numeric_limits<short>::max());
   for (size_t i = 0; i < static_cast<size_t>(available_samples) * 2; ++i)
-  {
-    m_float_conversion_buffer[i] =
-        m_scratch_buffer[i] / static_cast<float>(std::numeric_limits<short>::max());
-  }
+    m_float_conversion_buffer[i] = m_scratch_buffer[i] * scale;
 
   DPL2Decode(m_float_conversion_buffer.data(), available_samples, samples);
 
   return available_samples;
 }
 
+// May be called from several threads at once.
 void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_samples)
 {
-  // Cache access in non-volatile variable
-  // indexR isn't allowed to cache in the audio throttling loop as it
-  // needs to get updates to not deadlock.
-  u32 indexW = m_indexW.load();
-
-  // Check if we have enough free space
-  // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW
-  if (num_samples * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) >= MAX_SAMPLES * 2)
-    return;
+  // Claim space for the samples.
+  // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW.
+  // The sinc resampler also still reads the SINC_HISTORY samples behind indexR.
+  u32 indexW = m_indexReserve.load();
+  do
+  {
+    if ((num_samples + SINC_HISTORY) * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) >=
+        MAX_SAMPLES * 2)
+    {
+      return;
+    }
+  } while (!m_indexReserve.compare_exchange_weak(indexW, indexW + num_samples * 2));
 
   // AyuanX: Actual re-sampling work has been moved to sound thread
   // to alleviate the workload on main thread
@@ -209,11 +381,17 @@ void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_sample
     memcpy(&m_buffer[indexW & INDEX_MASK], samples, num_samples * 4);
   }
 
-  m_indexW.fetch_add(num_samples * 2);
+  // Publish in the order the space was claimed, after any producer that got in before us.
+  while (m_indexW.load() != indexW)
+    Common::YieldCPU();
+  m_indexW.store(indexW + num_samples * 2);
 }
 
 void Mixer::PushSamples(const short* samples, unsigned int num_samples)
 {
+  if (Core::IsOutputSuppressed())
+    return;
+
   m_dma_mixer.PushSamples(samples, num_samples);
   int sample_rate = m_dma_mixer.GetInputSampleRate();
   if (m_log_dsp_audio)
@@ -222,6 +400,9 @@ void Mixer::PushSamples(const short* samples, unsigned int num_samples)
 
 void Mixer::PushStreamingSamples(const short* samples, unsigned int num_samples)
 {
+  if (Core::IsOutputSuppressed())
+    return;
+
   m_streaming_mixer.PushSamples(samples, num_samples);
   int sample_rate = m_streaming_mixer.GetInputSampleRate();
   if (m_log_dtk_audio)
@@ -233,7 +414,7 @@ void Mixer::PushWiimoteSpeakerSamples(const short* samples, unsigned int num_sam
 {
   short samples_stereo[MAX_SAMPLES * 2];
 
-  if (num_samples < MAX_SAMPLES)
+  if (num_samples < MAX_SAMPLES && !Core::IsOutputSuppressed())
   {
     m_wiimote_speaker_mixer.SetInputSampleRate(sample_rate);
 
@@ -367,7 +548,10 @@ void Mixer::MixerFifo::SetVolume(unsigned int lvolume, unsigned int rvolume)
 unsigned int Mixer::MixerFifo::AvailableSamples() const
 {
   unsigned int samples_in_fifo = ((m_indexW.load() - m_indexR.load()) & INDEX_MASK) / 2;
-  if (samples_in_fifo <= 1)
-    return 0;  // Mixer::MixerFifo::Mix always keeps one sample in the buffer.
-  return (samples_in_fifo - 1) * m_mixer->m_sampleRate / m_input_sample_rate;
+  // Mixer::MixerFifo::Mix always keeps the samples ahead of the read position that the
+  // resampler interpolates with in the buffer.
+  const u32 lookahead = SConfig::GetInstance().m_audio_sinc_resampler ? SINC_LOOKAHEAD : 1;
+  if (samples_in_fifo <= lookahead)
+    return 0;
+  return (samples_in_fifo - lookahead) * m_mixer->m_sampleRate / m_input_sample_rate;
 }
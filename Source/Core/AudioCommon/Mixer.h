@@ -50,6 +50,21 @@ private:
   static constexpr int MAX_FREQ_SHIFT = 200;  // Per 32000 Hz
   static constexpr float CONTROL_FACTOR = 0.2f;
   static constexpr u32 CONTROL_AVG = 32;  // In freq_shift per FIFO size offset
+  // Rate control stretching: relative rate change per relative offset from the target fill,
+  // and the largest change it may make.
+  static constexpr float RATE_CONTROL_GAIN = 0.1f;
+  static constexpr float RATE_CONTROL_MAX = 0.1f;
+
+  // Windowed-sinc resampler: each output sample reads SINC_HISTORY input samples before the
+  // current position and SINC_LOOKAHEAD after it. The kernel is tabulated for SINC_PHASES
+  // fractional positions in Q14.
+  static constexpr u32 SINC_TAPS = 16;
+  static constexpr u32 SINC_HISTORY = SINC_TAPS / 2 - 1;
+  static constexpr u32 SINC_LOOKAHEAD = SINC_TAPS / 2;
+  static constexpr u32 SINC_PHASE_BITS = 8;
+  static constexpr u32 SINC_PHASES = 1 << SINC_PHASE_BITS;
+
+  static const std::array<s16, SINC_PHASES * SINC_TAPS>& SincKernel();
 
   class MixerFifo final
   {
@@ -66,11 +81,21 @@ private:
     unsigned int AvailableSamples() const;
 
   private:
+    void Unpack(u32 index, u32 count);
+    u32 ResampleLinear(short* samples, u32 count, u32 ratio, s32 lvolume, s32 rvolume);
+    u32 ResampleSinc(short* samples, u32 count, u32 ratio, s32 lvolume, s32 rvolume);
+
     Mixer* m_mixer;
     unsigned m_input_sample_rate;
     std::array<short, MAX_SAMPLES * 2> m_buffer{};
+    // Producers claim space by advancing m_indexReserve, and publish it through m_indexW in the
+    // order it was claimed.
+    std::atomic<u32> m_indexReserve{0};
     std::atomic<u32> m_indexW{0};
     std::atomic<u32> m_indexR{0};
+    // Native-endian, deinterleaved copy of the samples read by the current Mix call
+    std::array<s16, MAX_SAMPLES + SINC_TAPS> m_left{};
+    std::array<s16, MAX_SAMPLES + SINC_TAPS> m_right{};
     // Volume ranges from 0-256
     std::atomic<s32> m_LVolume{256};
     std::atomic<s32> m_RVolume{256};
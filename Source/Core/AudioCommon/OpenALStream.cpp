@@ -14,6 +14,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 #include "Core/ConfigManager.h"
+#include "Core/ThreadPolicy.h"
 
 static HMODULE s_openal_dll = nullptr;
 
@@ -218,6 +219,7 @@ static bool IsCreativeXFi()
 void OpenALStream::SoundLoop()
 {
   Common::SetCurrentThreadName("Audio thread - openal");
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::Role::Audio);
 
   bool float32_capable = palIsExtensionPresent("AL_EXT_float32") != 0;
   bool surround_capable = palIsExtensionPresent("AL_EXT_MCFORMATS") || IsCreativeXFi();
@@ -22,6 +22,7 @@
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
 #include "Core/ConfigManager.h"
+#include "Core/ThreadPolicy.h"
 #include "VideoCommon/OnScreenDisplay.h"
 
 using Microsoft::WRL::ComPtr;
@@ -224,7 +225,11 @@ bool WASAPIStream::SetRunning(bool running)
 
     result = audio_client->GetDevicePeriod(nullptr, &device_period);
 
-    device_period += SConfig::GetInstance().iLatency * (10000 / m_format.Format.nChannels);
+    // In low latency mode, run at the device's minimum period instead of padding it with the
+    // latency setting.
+    const bool low_latency = SConfig::GetInstance().m_audio_low_latency;
+    if (!low_latency)
+      device_period += SConfig::GetInstance().iLatency * (10000 / m_format.Format.nChannels);
     INFO_LOG(AUDIO, "Audio period set to %d", device_period);
 
     if (!HandleWinAPI("Failed to obtain device period", result))
@@ -260,7 +265,7 @@ bool WASAPIStream::SetRunning(bool running)
       device_period =
         static_cast<REFERENCE_TIME>(
           10000.0 * 1000 * m_frames_in_buffer / m_format.Format.nSamplesPerSec + 0.5) +
-        SConfig::GetInstance().iLatency * 10000;
+        (low_latency ? 0 : SConfig::GetInstance().iLatency * 10000);
 
       result = audio_client->Initialize(
         AUDCLNT_SHAREMODE_EXCLUSIVE,
@@ -276,6 +281,11 @@ bool WASAPIStream::SetRunning(bool running)
     if (!HandleWinAPI("Failed to get buffer size from IAudioClient", result))
       return false;
 
+    REFERENCE_TIME stream_latency = 0;
+    audio_client->GetStreamLatency(&stream_latency);
+    NOTICE_LOG(AUDIO, "WASAPI: %u frame buffer, output latency %.2f ms", m_frames_in_buffer,
+      stream_latency / 10000.0 + 1000.0 * m_frames_in_buffer / m_format.Format.nSamplesPerSec);
+
     ComPtr<IAudioRenderClient> audio_renderer;
 
     result = audio_client->GetService(IID_PPV_ARGS(audio_renderer.GetAddressOf()));
@@ -321,6 +331,7 @@ bool WASAPIStream::SetRunning(bool running)
 void WASAPIStream::SoundLoop()
 {
   Common::SetCurrentThreadName("WASAPI Handler");
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::Role::Audio);
   BYTE* data;
 
   m_audio_renderer->GetBuffer(m_frames_in_buffer, &data);
@@ -4,6 +4,9 @@
 
 #include "AudioCommon/WaveFile.h"
 
+#include <algorithm>
+#include <chrono>
+#include <sstream>
 #include <string>
 
 #include "Common/CommonTypes.h"
@@ -12,6 +15,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
+#include "Common/Thread.h"
 #include "Core/ConfigManager.h"
 
 constexpr size_t WaveFileWriter::BUFFER_SIZE;
@@ -26,6 +30,29 @@ WaveFileWriter::~WaveFileWriter()
 }
 
 bool WaveFileWriter::Start(const std::string& filename, unsigned int HLESampleRate)
+{
+  if (!Open(filename, HLESampleRate))
+    return false;
+
+  conv_buffer.resize(BUFFER_SIZE);
+  conv_buffer_used = 0;
+  stop_requested.Clear();
+  thread = std::thread(&WaveFileWriter::WriterThread, this);
+  return true;
+}
+
+void WaveFileWriter::Stop()
+{
+  if (thread.joinable())
+  {
+    stop_requested.Set();
+    queue_event.Set();
+    thread.join();
+  }
+  Close();
+}
+
+bool WaveFileWriter::Open(const std::string& filename, unsigned int HLESampleRate)
 {
   // Ask to delete file
   if (File::Exists(filename))
@@ -92,7 +119,7 @@ bool WaveFileWriter::Start(const std::string& filename, unsigned int HLESampleRa
   return true;
 }
 
-void WaveFileWriter::Stop()
+void WaveFileWriter::Close()
 {
   // u32 file_size = (u32)ftello(file);
   file.Seek(4, SEEK_SET);
@@ -116,43 +143,76 @@ void WaveFileWriter::Write4(const char* ptr)
 
 void WaveFileWriter::AddStereoSamplesBE(const short* sample_data, u32 count, int sample_rate)
 {
-  if (!file)
+  if (!thread.joinable())
     PanicAlertT("WaveFileWriter - file not open.");
 
-  if (count > BUFFER_SIZE * 2)
-    PanicAlert("WaveFileWriter - buffer too small (count = %u).", count);
-
-  if (skip_silence)
+  if (skip_silence &&
+      std::all_of(sample_data, sample_data + count * 2, [](short sample) { return sample == 0; }))
   {
-    bool all_zero = true;
+    return;
+  }
 
-    for (u32 i = 0; i < count * 2; i++)
-    {
-      if (sample_data[i])
-        all_zero = false;
-    }
+  SampleBlock block;
+  free_blocks.Pop(block.samples);
+  block.samples.assign(sample_data, sample_data + count * 2);
+  block.sample_rate = sample_rate;
+  queue.Push(std::move(block));
+}
 
-    if (all_zero)
-      return;
-  }
+void WaveFileWriter::WriterThread()
+{
+  Common::SetCurrentThreadName("Audio dump writer");
 
-  for (u32 i = 0; i < count; i++)
+  // The producer doesn't signal every block, a few hundred milliseconds of queued samples are
+  // fine for a dump.
+  while (true)
   {
-    // Flip the audio channels from RL to LR
-    conv_buffer[2 * i] = Common::swap16((u16)sample_data[2 * i + 1]);
-    conv_buffer[2 * i + 1] = Common::swap16((u16)sample_data[2 * i]);
+    // Checked before draining, so every block queued before Stop() is written.
+    const bool stopping = stop_requested.IsSet();
+    SampleBlock block;
+    while (queue.Pop(block))
+    {
+      WriteBlock(block);
+      free_blocks.Push(std::move(block.samples));
+    }
+    if (stopping)
+      break;
+    queue_event.WaitFor(std::chrono::milliseconds(250));
   }
+  FlushBuffer();
+}
 
-  if (sample_rate != current_sample_rate)
+void WaveFileWriter::WriteBlock(const SampleBlock& block)
+{
+  if (block.sample_rate != current_sample_rate)
   {
-    Stop();
+    FlushBuffer();
+    Close();
     file_index++;
     std::stringstream filename;
     filename << File::GetUserPath(D_DUMPAUDIO_IDX) << basename << file_index << ".wav";
-    Start(filename.str(), sample_rate);
-    current_sample_rate = sample_rate;
+    Open(filename.str(), block.sample_rate);
+    current_sample_rate = block.sample_rate;
   }
 
-  file.WriteBytes(conv_buffer.data(), count * 4);
-  audio_size += count * 4;
+  const size_t count = block.samples.size() / 2;
+  for (size_t i = 0; i < count; i++)
+  {
+    if (conv_buffer_used == conv_buffer.size())
+      FlushBuffer();
+
+    // Flip the audio channels from RL to LR
+    conv_buffer[conv_buffer_used++] = Common::swap16((u16)block.samples[2 * i + 1]);
+    conv_buffer[conv_buffer_used++] = Common::swap16((u16)block.samples[2 * i]);
+  }
+}
+
+void WaveFileWriter::FlushBuffer()
+{
+  if (conv_buffer_used == 0)
+    return;
+
+  file.WriteBytes(conv_buffer.data(), conv_buffer_used * sizeof(short));
+  audio_size += static_cast<u32>(conv_buffer_used * sizeof(short));
+  conv_buffer_used = 0;
 }
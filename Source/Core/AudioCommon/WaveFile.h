@@ -6,19 +6,24 @@
 // Class: WaveFileWriter
 // Description: Simple utility class to make it easy to write long 16-bit stereo
 // audio streams to disk.
-// Use Start() to start recording to a file, and AddStereoSamples to add wave data.
-// The float variant will convert from -1.0-1.0 range and clamp.
-// Alternatively, AddSamplesBE for big endian wave data.
+// Use Start() to start recording to a file, and AddStereoSamplesBE to add big endian wave data.
+// The samples are queued and converted and written by a writer thread in large blocks, so the
+// thread producing them never waits for the disk.
 // If Stop is not called when it destructs, the destructor will call Stop().
 // ---------------------------------------------------------------------------------
 
 #pragma once
 
-#include <array>
+#include <atomic>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Event.h"
 #include "Common/File.h"
+#include "Common/Flag.h"
+#include "Common/SPSCQueue.h"
 
 class WaveFileWriter
 {
@@ -36,17 +41,41 @@ public:
 
   void SetSkipSilence(bool skip) { skip_silence = skip; }
   void AddStereoSamplesBE(const short* sample_data, u32 count, int sample_rate);  // big endian
-  u32 GetAudioSize() const { return audio_size; }
+  u32 GetAudioSize() const { return audio_size.load(); }
 private:
-  static constexpr size_t BUFFER_SIZE = 32 * 1024;
+  // In shorts, 512 KiB of converted samples are written at once.
+  static constexpr size_t BUFFER_SIZE = 256 * 1024;
 
+  struct SampleBlock
+  {
+    std::vector<short> samples;
+    int sample_rate = 0;
+  };
+
+  bool Open(const std::string& filename, unsigned int sample_rate);
+  void Close();
+  void WriterThread();
+  void WriteBlock(const SampleBlock& block);
+  void FlushBuffer();
+
+  // Owned by the writer thread while it runs.
   File::IOFile file;
-  bool skip_silence = false;
-  u32 audio_size = 0;
-  std::array<short, BUFFER_SIZE> conv_buffer{};
+  std::atomic<u32> audio_size{0};
+  std::vector<short> conv_buffer;
+  size_t conv_buffer_used = 0;
   void Write(u32 value);
   void Write4(const char* ptr);
   std::string basename;
   int current_sample_rate;
   int file_index = 0;
+
+  // Owned by the thread adding samples.
+  bool skip_silence = false;
+
+  std::thread thread;
+  Common::SPSCQueue<SampleBlock, false> queue;
+  // Sample vectors handed back by the writer thread for reuse.
+  Common::SPSCQueue<std::vector<short>, false> free_blocks;
+  Common::Event queue_event;
+  Common::Flag stop_requested;
 };
@@ -46,6 +46,7 @@ public:
       return;
 
     // Else as the worker thread may sleep now, we have to set the event.
+    m_wakeup_count++;
     m_new_work_event.Set();
   }
 
@@ -176,6 +177,7 @@ public:
 
       case STATE_SLEEPING:
         // Just relax
+        m_sleep_count++;
         if (timeout > 0)
         {
           m_new_work_event.WaitFor(std::chrono::milliseconds(timeout));
@@ -227,6 +229,11 @@ public:
 
   bool IsRunning() const { return !m_stopped.IsSet() && !m_shutdown.IsSet(); }
   bool IsDone() const { return m_stopped.IsSet() || m_running_state.load() <= STATE_DONE; }
+  bool IsSleeping() const { return m_running_state.load() == STATE_SLEEPING; }
+  // Number of times Wakeup() had to signal the event and the worker went to sleep, since the
+  // last call.
+  int TakeWakeupCount() { return m_wakeup_count.exchange(0); }
+  int TakeSleepCount() { return m_sleep_count.exchange(0); }
   // This function should be triggered regularly over time so
   // that we will fall back from the busy loop to sleeping.
   void AllowSleep() { m_may_sleep.Set(); }
@@ -251,5 +258,8 @@ private:
 
   Flag m_may_sleep;  // If this is set, we fall back from the busy loop to an event based
                      // synchronization.
+
+  std::atomic<int> m_wakeup_count{0};
+  std::atomic<int> m_sleep_count{0};
 };
 }
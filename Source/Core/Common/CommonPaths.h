@@ -41,12 +41,16 @@
 #define CACHE_DIR "Cache"
 #define SHADERCACHE_DIR "Shaders"
 #define SHADERUIDCACHE_DIR  "ShadersUIDS"
+#define JIT_CACHE_DIR "JIT"
 #define STATESAVES_DIR "StateSaves"
 #define SCREENSHOTS_DIR "ScreenShots"
 #define OPENCL_DIR			 "OpenCL"
 #define LOAD_DIR "Load"
 #define HIRES_TEXTURES_DIR "Textures"
 #define PPS_PRESETS_DIR     "ShaderPresets"
+#define SHADER_UIDS_DIR "ShaderUIDs"
+#define FRAME_TELEMETRY_DIR "Telemetry"
+#define TRACE_DIR "Trace"
 #define DUMP_DIR "Dump"
 #define DUMP_TEXTURES_DIR "Textures"
 #define DUMP_FRAMES_DIR "Frames"
@@ -102,6 +106,7 @@
 // Files in the directory returned by GetUserPath(D_MEMORYWATCHER_IDX)
 #define MEMORYWATCHER_LOCATIONS "Locations.txt"
 #define MEMORYWATCHER_SOCKET "MemoryWatcher"
+#define MEMORYWATCHER_RING "MemoryWatcher.ring"
 
 // Sys files
 #define TOTALDB "totaldb.dsy"
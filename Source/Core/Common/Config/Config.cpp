@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <list>
 #include <map>
 #include <tuple>
@@ -14,6 +15,8 @@ namespace Config
 {
 static Layers s_layers;
 static std::list<ConfigChangedCallback> s_callbacks;
+// Starts at 1 so that a CachedInfo that was never read is always out of date
+static std::atomic<u64> s_config_version{1};
 
 void InvokeConfigChangedCallbacks();
 
@@ -57,10 +60,16 @@ void AddConfigChangedCallback(ConfigChangedCallback func)
 
 void InvokeConfigChangedCallbacks()
 {
+  ++s_config_version;
   for (const auto& callback : s_callbacks)
     callback();
 }
 
+u64 GetConfigVersion()
+{
+  return s_config_version.load(std::memory_order_relaxed);
+}
+
 // Explicit load and save of layers
 void Load()
 {
@@ -89,6 +98,7 @@ void Shutdown()
 void ClearCurrentRunLayer()
 {
   s_layers[LayerType::CurrentRun] = std::make_unique<Layer>(LayerType::CurrentRun);
+  ++s_config_version;
 }
 
 static const std::map<System, std::string> system_to_name = {
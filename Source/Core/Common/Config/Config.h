@@ -30,6 +30,10 @@ bool LayerExists(LayerType layer);
 void AddConfigChangedCallback(ConfigChangedCallback func);
 void InvokeConfigChangedCallbacks();
 
+// Incremented whenever a layer may have changed. Code that keeps resolved settings around can
+// compare it to the value it saw last time instead of looking everything up again.
+u64 GetConfigVersion();
+
 // Explicit load and save of layers
 void Load();
 void Save();
@@ -72,8 +76,8 @@ LayerType GetActiveLayerForConfig(const ConfigInfo<T>& info)
 template <typename T>
 void Set(LayerType layer, const ConfigInfo<T>& info, const T& value)
 {
-  GetLayer(layer)->Set(info, value);
-  InvokeConfigChangedCallbacks();
+  if (GetLayer(layer)->Set(info, value))
+    InvokeConfigChangedCallbacks();
 }
 
 template <typename T>
@@ -88,6 +92,32 @@ void SetCurrent(const ConfigInfo<T>& info, const std::common_type_t<T>& value)
   Set<T>(LayerType::CurrentRun, info, value);
 }
 
+// A setting that is read often, e.g. once per frame. The value is resolved through the layers
+// only when the config version has changed since the last read. Not thread-safe, each thread
+// that reads the setting should have its own instance.
+template <typename T>
+class CachedInfo
+{
+public:
+  explicit CachedInfo(const ConfigInfo<T>& info) : m_info(info) {}
+
+  const T& Get() const
+  {
+    const u64 version = GetConfigVersion();
+    if (m_version != version)
+    {
+      m_value = Config::Get(m_info);
+      m_version = version;
+    }
+    return m_value;
+  }
+
+private:
+  const ConfigInfo<T>& m_info;
+  mutable T m_value{};
+  mutable u64 m_version = 0;
+};
+
 template <typename T>
 void SetBaseOrCurrent(const ConfigInfo<T>& info, const T& value)
 {
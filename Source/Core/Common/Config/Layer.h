@@ -107,27 +107,30 @@ public:
   template <typename T>
   std::optional<T> Get(const ConfigLocation& location)
   {
-    const std::optional<std::string>& str_value = m_map[location];
-    if (!str_value)
+    // Reading must not insert into the map, other threads may be reading it as well
+    const auto iter = m_map.find(location);
+    if (iter == m_map.end() || !iter->second)
       return std::nullopt;
-    return detail::TryParse<T>(*str_value);
+    return detail::TryParse<T>(*iter->second);
   }
 
+  // Returns false if the layer already had this value
   template <typename T>
-  void Set(const ConfigInfo<T>& config_info, const T& value)
+  bool Set(const ConfigInfo<T>& config_info, const T& value)
   {
-    Set<T>(config_info.location, value);
+    return Set<T>(config_info.location, value);
   }
 
   template <typename T>
-  void Set(const ConfigLocation& location, const T& value)
+  bool Set(const ConfigLocation& location, const T& value)
   {
     const std::string new_value = detail::ValueToString(value);
     std::optional<std::string>& current_value = m_map[location];
     if (current_value == new_value)
-      return;
+      return false;
     m_is_dirty = true;
     current_value = new_value;
+    return true;
   }
 
   Section GetSection(System system, const std::string& section);
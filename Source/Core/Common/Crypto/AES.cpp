@@ -2,9 +2,16 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <cstring>
 #include <mbedtls/aes.h>
 
+#include "Common/CPUDetect.h"
 #include "Common/Crypto/AES.h"
+#include "Common/Intrinsics.h"
+
+#if defined(_M_ARM_64) && defined(__ARM_FEATURE_CRYPTO)
+#include <arm_neon.h>
+#endif
 
 namespace Common
 {
@@ -35,5 +42,122 @@ std::vector<u8> Encrypt(const u8* key, u8* iv, const u8* src, size_t size)
 {
   return DecryptEncrypt(key, iv, src, size, Mode::Encrypt);
 }
+
+// CBC decryption has no dependency between blocks, so they are interleaved to hide the latency of
+// the AES instructions.
+constexpr size_t PARALLEL_BLOCKS = 8;
+
+#if defined(_M_X86)
+FUNCTION_TARGET_AES
+static void DecryptCBC_AESNI(const mbedtls_aes_context* context, const u8* iv, const u8* src,
+                             u8* dst, size_t num_blocks)
+{
+  const int rounds = context->nr;
+  __m128i keys[15];
+  for (int i = 0; i <= rounds; i++)
+    keys[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(context->rk) + i);
+
+  __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iv));
+  const __m128i* in = reinterpret_cast<const __m128i*>(src);
+  __m128i* out = reinterpret_cast<__m128i*>(dst);
+  size_t i = 0;
+  for (; i + PARALLEL_BLOCKS <= num_blocks; i += PARALLEL_BLOCKS)
+  {
+    __m128i cipher[PARALLEL_BLOCKS];
+    __m128i state[PARALLEL_BLOCKS];
+    for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+    {
+      cipher[j] = _mm_loadu_si128(in + i + j);
+      state[j] = _mm_xor_si128(cipher[j], keys[0]);
+    }
+    for (int round = 1; round < rounds; round++)
+    {
+      for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+        state[j] = _mm_aesdec_si128(state[j], keys[round]);
+    }
+    for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+    {
+      state[j] = _mm_aesdeclast_si128(state[j], keys[rounds]);
+      state[j] = _mm_xor_si128(state[j], j == 0 ? previous : cipher[j - 1]);
+      _mm_storeu_si128(out + i + j, state[j]);
+    }
+    previous = cipher[PARALLEL_BLOCKS - 1];
+  }
+  for (; i < num_blocks; i++)
+  {
+    const __m128i cipher = _mm_loadu_si128(in + i);
+    __m128i state = _mm_xor_si128(cipher, keys[0]);
+    for (int round = 1; round < rounds; round++)
+      state = _mm_aesdec_si128(state, keys[round]);
+    state = _mm_aesdeclast_si128(state, keys[rounds]);
+    _mm_storeu_si128(out + i, _mm_xor_si128(state, previous));
+    previous = cipher;
+  }
+}
+#elif defined(_M_ARM_64) && defined(__ARM_FEATURE_CRYPTO)
+static void DecryptCBC_ARMv8(const mbedtls_aes_context* context, const u8* iv, const u8* src,
+                             u8* dst, size_t num_blocks)
+{
+  const int rounds = context->nr;
+  uint8x16_t keys[15];
+  for (int i = 0; i <= rounds; i++)
+    keys[i] = vld1q_u8(reinterpret_cast<const u8*>(context->rk) + i * 16);
+
+  // AESD adds the round key before the inverse rounds instead of after, so the key schedule is
+  // shifted by one compared to AES-NI and the last key is added separately.
+  uint8x16_t previous = vld1q_u8(iv);
+  size_t i = 0;
+  for (; i + PARALLEL_BLOCKS <= num_blocks; i += PARALLEL_BLOCKS)
+  {
+    uint8x16_t cipher[PARALLEL_BLOCKS];
+    uint8x16_t state[PARALLEL_BLOCKS];
+    for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+      state[j] = cipher[j] = vld1q_u8(src + (i + j) * 16);
+    for (int round = 0; round < rounds - 1; round++)
+    {
+      for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+        state[j] = vaesimcq_u8(vaesdq_u8(state[j], keys[round]));
+    }
+    for (size_t j = 0; j < PARALLEL_BLOCKS; j++)
+    {
+      state[j] = veorq_u8(vaesdq_u8(state[j], keys[rounds - 1]), keys[rounds]);
+      state[j] = veorq_u8(state[j], j == 0 ? previous : cipher[j - 1]);
+      vst1q_u8(dst + (i + j) * 16, state[j]);
+    }
+    previous = cipher[PARALLEL_BLOCKS - 1];
+  }
+  for (; i < num_blocks; i++)
+  {
+    const uint8x16_t cipher = vld1q_u8(src + i * 16);
+    uint8x16_t state = cipher;
+    for (int round = 0; round < rounds - 1; round++)
+      state = vaesimcq_u8(vaesdq_u8(state, keys[round]));
+    state = veorq_u8(vaesdq_u8(state, keys[rounds - 1]), keys[rounds]);
+    vst1q_u8(dst + i * 16, veorq_u8(state, previous));
+    previous = cipher;
+  }
+}
+#endif
+
+void DecryptCBC(mbedtls_aes_context* context, const u8* iv, const u8* src, u8* dst, size_t size)
+{
+#if defined(_M_X86)
+  if (cpu_info.bAES)
+  {
+    DecryptCBC_AESNI(context, iv, src, dst, size / 16);
+    return;
+  }
+#elif defined(_M_ARM_64) && defined(__ARM_FEATURE_CRYPTO)
+  if (cpu_info.bAES)
+  {
+    DecryptCBC_ARMv8(context, iv, src, dst, size / 16);
+    return;
+  }
+#endif
+
+  u8 iv_copy[16];
+  std::memcpy(iv_copy, iv, sizeof(iv_copy));
+  mbedtls_aes_crypt_cbc(context, MBEDTLS_AES_DECRYPT, size, iv_copy, src, dst);
+}
 }  // namespace AES
 }  // namespace Common
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <mbedtls/aes.h>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -23,5 +24,11 @@ std::vector<u8> DecryptEncrypt(const u8* key, u8* iv, const u8* src, size_t size
 // Convenience functions
 std::vector<u8> Decrypt(const u8* key, u8* iv, const u8* src, size_t size);
 std::vector<u8> Encrypt(const u8* key, u8* iv, const u8* src, size_t size);
+
+// Decrypts CBC data (size must be a multiple of 16) with a context set up by
+// mbedtls_aes_setkey_dec. src and dst may be the same buffer. Unlike mbedtls_aes_crypt_cbc,
+// several blocks are decrypted at once with AES-NI or the ARMv8 crypto extensions when available,
+// and iv is left untouched.
+void DecryptCBC(mbedtls_aes_context* context, const u8* iv, const u8* src, u8* dst, size_t size);
 }  // namespace AES
 }  // namespace Common
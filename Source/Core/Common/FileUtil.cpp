@@ -794,6 +794,7 @@ static void RebuildUserDirectories(unsigned int dir_index)
         s_user_paths[D_MEMORYWATCHER_IDX] + MEMORYWATCHER_LOCATIONS;
     s_user_paths[F_MEMORYWATCHERSOCKET_IDX] =
         s_user_paths[D_MEMORYWATCHER_IDX] + MEMORYWATCHER_SOCKET;
+    s_user_paths[F_MEMORYWATCHERRING_IDX] = s_user_paths[D_MEMORYWATCHER_IDX] + MEMORYWATCHER_RING;
 
     // The shader cache has moved to the cache directory, so remove the old one.
     // TODO: remove that someday.
@@ -66,6 +66,7 @@ enum
   F_GCSRAM_IDX,
   F_MEMORYWATCHERLOCATIONS_IDX,
   F_MEMORYWATCHERSOCKET_IDX,
+  F_MEMORYWATCHERRING_IDX,
   F_WIISDCARD_IDX,
   NUM_PATH_INDICES
 };
@@ -0,0 +1,144 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+namespace Common
+{
+namespace FrameArena
+{
+namespace
+{
+constexpr size_t MIN_BLOCK_SIZE = 256 * 1024;
+
+struct Block
+{
+  std::unique_ptr<u8[]> data;
+  size_t size;
+};
+
+struct Arena
+{
+  std::vector<Block> blocks;
+  // Block allocations are made from, and the offset of its free space.
+  size_t current = 0;
+  size_t offset = 0;
+  // Bytes in the blocks before the current one.
+  size_t previous_blocks_size = 0;
+};
+
+thread_local Arena s_arena;
+
+u8* AlignPointer(u8* pointer, size_t alignment)
+{
+  const uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+  return reinterpret_cast<u8*>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+}
+}  // Anonymous namespace
+
+void* Allocate(size_t size, size_t alignment)
+{
+  Arena& arena = s_arena;
+  while (arena.current < arena.blocks.size())
+  {
+    Block& block = arena.blocks[arena.current];
+    u8* const start = block.data.get() + arena.offset;
+    u8* const aligned = AlignPointer(start, alignment);
+    if (aligned + size <= block.data.get() + block.size)
+    {
+      arena.offset = aligned + size - block.data.get();
+      return aligned;
+    }
+    arena.previous_blocks_size += arena.offset;
+    arena.current++;
+    arena.offset = 0;
+  }
+
+  const size_t block_size = std::max(MIN_BLOCK_SIZE, size + alignment);
+  arena.blocks.push_back({std::make_unique<u8[]>(block_size), block_size});
+  arena.current = arena.blocks.size() - 1;
+  u8* const aligned = AlignPointer(arena.blocks.back().data.get(), alignment);
+  arena.offset = aligned + size - arena.blocks.back().data.get();
+  return aligned;
+}
+
+void Reset()
+{
+  Arena& arena = s_arena;
+  // A frame that needed several blocks gets them as one from now on.
+  if (arena.blocks.size() > 1)
+  {
+    size_t total_size = 0;
+    for (const Block& block : arena.blocks)
+      total_size += block.size;
+    arena.blocks.clear();
+    arena.blocks.push_back({std::make_unique<u8[]>(total_size), total_size});
+  }
+  arena.current = 0;
+  arena.offset = 0;
+  arena.previous_blocks_size = 0;
+}
+
+size_t GetUsedBytes()
+{
+  return s_arena.previous_blocks_size + s_arena.offset;
+}
+}  // namespace FrameArena
+
+#ifdef ENABLE_ALLOCATION_COUNTING
+static thread_local u64 s_heap_allocations = 0;
+
+u64 GetThreadHeapAllocationCount()
+{
+  return s_heap_allocations;
+}
+#else
+u64 GetThreadHeapAllocationCount()
+{
+  return 0;
+}
+#endif
+}  // namespace Common
+
+#ifdef ENABLE_ALLOCATION_COUNTING
+// The other forms of operator new and delete end up in these.
+void* operator new(std::size_t size)
+{
+  Common::s_heap_allocations++;
+  if (void* pointer = std::malloc(size ? size : 1))
+    return pointer;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+#endif
@@ -0,0 +1,65 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// Bump allocator for data that doesn't outlive the current frame. Every thread has its own arena,
+// which only the thread itself may use and reset. The video thread resets its arena at every
+// swap, other threads shouldn't use one.
+namespace FrameArena
+{
+void* Allocate(size_t size, size_t alignment);
+// Releases everything the calling thread allocated since the last reset. The memory is kept, in
+// one block, for the next frame.
+void Reset();
+// Bytes the calling thread allocated since the last reset.
+size_t GetUsedBytes();
+
+// Never frees anything, growing a container leaves its old storage behind until the next reset.
+template <typename T>
+struct Allocator
+{
+  using value_type = T;
+
+  Allocator() = default;
+  template <typename U>
+  Allocator(const Allocator<U>&)
+  {
+  }
+
+  T* allocate(size_t n) { return static_cast<T*>(Allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T*, size_t) {}
+
+  template <typename U>
+  bool operator==(const Allocator<U>&) const
+  {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const Allocator<U>&) const
+  {
+    return false;
+  }
+};
+
+template <typename T>
+using Vector = std::vector<T, Allocator<T>>;
+}  // namespace FrameArena
+
+// Number of times the calling thread called operator new. Only counted in builds with the
+// ENABLE_ALLOCATION_COUNTING CMake option, which replaces the global operator new.
+#ifdef ENABLE_ALLOCATION_COUNTING
+constexpr bool HEAP_ALLOCATION_COUNTING = true;
+#else
+constexpr bool HEAP_ALLOCATION_COUNTING = false;
+#endif
+u64 GetThreadHeapAllocationCount();
+}  // namespace Common
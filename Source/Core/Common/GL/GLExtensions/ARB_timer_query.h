@@ -0,0 +1,38 @@
+/*
+** Copyright (c) 2013-2015 The Khronos Group Inc.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a
+** copy of this software and/or associated documentation files (the
+** "Materials"), to deal in the Materials without restriction, including
+** without limitation the rights to use, copy, modify, merge, publish,
+** distribute, sublicense, and/or sell copies of the Materials, and to
+** permit persons to whom the Materials are furnished to do so, subject to
+** the following conditions:
+**
+** The above copyright notice and this permission notice shall be included
+** in all copies or substantial portions of the Materials.
+**
+** THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+** EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+** MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+** IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+** CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+** TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+** MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+*/
+
+#include "Common/GL/GLExtensions/gl_common.h"
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_TIMESTAMP 0x8E28
+
+typedef void(APIENTRYP PFNDOLQUERYCOUNTERPROC)(GLuint id, GLenum target);
+typedef void(APIENTRYP PFNDOLGETQUERYOBJECTI64VPROC)(GLuint id, GLenum pname, GLint64* params);
+typedef void(APIENTRYP PFNDOLGETQUERYOBJECTUI64VPROC)(GLuint id, GLenum pname, GLuint64* params);
+
+extern PFNDOLQUERYCOUNTERPROC dolQueryCounter;
+extern PFNDOLGETQUERYOBJECTI64VPROC dolGetQueryObjecti64v;
+extern PFNDOLGETQUERYOBJECTUI64VPROC dolGetQueryObjectui64v;
+
+#define glQueryCounter dolQueryCounter
+#define glGetQueryObjecti64v dolGetQueryObjecti64v
+#define glGetQueryObjectui64v dolGetQueryObjectui64v
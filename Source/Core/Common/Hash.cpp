@@ -11,6 +11,7 @@
 
 #ifdef _M_ARM_64
 #include <arm_acle.h>
+#include <arm_neon.h>
 #endif
 
 static u64 (*ptrHashFunction)(const u8* src, u32 len, u32 samples) = nullptr;
@@ -612,28 +613,240 @@ u64 GetHashHiresTexture(const u8* src, u32 len, u32 samples)
 }
 #endif
 
-u64 GetHash64(const u8* src, u32 len, u32 samples)
+// Stripe hash modelled after XXH3: eight 64 bit lanes each take a 32x32->64 bit multiply of
+// the data mixed with a sliding key per 64 byte stripe, and the lanes are scrambled every 16
+// stripes. All implementations produce the same values, so the result is independent of the
+// CPU it was computed on.
+namespace
 {
-  return ptrHashFunction(src, len, samples);
+constexpr u32 STRIPE_SIZE = 64;
+constexpr u32 STRIPES_PER_BLOCK = 16;
+constexpr u32 STRIPE_LANES = STRIPE_SIZE / sizeof(u64);
+constexpr u64 HASH_PRIME32_1 = 0x9E3779B1U;
+
+// Lanes 0-7 of a stripe use s_stripe_key[stripe..stripe + 7], the scramble uses the last 8.
+alignas(32) const u64 s_stripe_key[STRIPES_PER_BLOCK + STRIPE_LANES] = {
+    0x4EF86A75018C6093, 0x7E03F9CBA1703BFF, 0x52FE3A0CC50DF6D9, 0xF6620F5B18124084,
+    0x086420EE48C24906, 0x1303A74CCF602076, 0x1D7958E8C1B643CA, 0x8911659856C5BE44,
+    0x1D1224F72A2A9C84, 0x5D24E7843912D503, 0x7000BDEE6D709882, 0x28DD2553184B31BA,
+    0xEAEF0160F596699B, 0xC8EFB8A85BC7A324, 0x43D4ABBB56968CFE, 0x0D4D2E60FEE2061E,
+    0xFA4DD82F10CE9C8A, 0x196DD2A364EAB47C, 0x0C4E5A603443F117, 0x5B8CB8C1FDDE78E4,
+    0x527289058C5E06D1, 0xD4BE38678528B55F, 0xA2ADFD959765E58F, 0x42E20311C7FB927B};
+const u64* const s_scramble_key = s_stripe_key + STRIPES_PER_BLOCK;
+
+// Hashes count stripes, stride bytes apart, and scrambles the lanes if a whole block was done.
+using AccumulateStripesFunction = void (*)(u64* acc, const u8* data, u32 count, u32 stride);
+
+void AccumulateStripesGeneric(u64* acc, const u8* data, u32 count, u32 stride)
+{
+  for (u32 stripe = 0; stripe < count; stripe++, data += stride)
+  {
+    const u64* key = s_stripe_key + stripe;
+    for (u32 i = 0; i < STRIPE_LANES; i++)
+    {
+      u64 value;
+      std::memcpy(&value, data + i * sizeof(u64), sizeof(u64));
+      const u64 data_key = value ^ key[i];
+      acc[i ^ 1] += value;
+      acc[i] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+    }
+  }
+  if (count != STRIPES_PER_BLOCK)
+    return;
+  for (u32 i = 0; i < STRIPE_LANES; i++)
+  {
+    u64 value = acc[i];
+    value ^= value >> 47;
+    value ^= s_scramble_key[i];
+    acc[i] = value * HASH_PRIME32_1;
+  }
 }
 
-// sets the hash function used for the texture cache
-void SetHash64Function()
+#if defined(_M_X86)
+void AccumulateStripesSSE2(u64* acc, const u8* data, u32 count, u32 stride)
+{
+  __m128i lanes[4];
+  for (u32 i = 0; i < 4; i++)
+    lanes[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(acc) + i);
+
+  for (u32 stripe = 0; stripe < count; stripe++, data += stride)
+  {
+    const __m128i* key = reinterpret_cast<const __m128i*>(s_stripe_key + stripe);
+    for (u32 i = 0; i < 4; i++)
+    {
+      const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data) + i);
+      const __m128i data_key = _mm_xor_si128(value, _mm_loadu_si128(key + i));
+      const __m128i product =
+          _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+      lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+    }
+  }
+
+  if (count == STRIPES_PER_BLOCK)
+  {
+    const __m128i prime = _mm_set1_epi32(HASH_PRIME32_1);
+    for (u32 i = 0; i < 4; i++)
+    {
+      __m128i value = _mm_xor_si128(lanes[i], _mm_srli_epi64(lanes[i], 47));
+      value = _mm_xor_si128(
+          value, _mm_load_si128(reinterpret_cast<const __m128i*>(s_scramble_key) + i));
+      const __m128i low = _mm_mul_epu32(value, prime);
+      const __m128i high =
+          _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+      lanes[i] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+    }
+  }
+
+  for (u32 i = 0; i < 4; i++)
+    _mm_store_si128(reinterpret_cast<__m128i*>(acc) + i, lanes[i]);
+}
+
+FUNCTION_TARGET_AVX2
+void AccumulateStripesAVX2(u64* acc, const u8* data, u32 count, u32 stride)
 {
-#if defined(_M_X86_64) || defined(_M_X86)
-  if (cpu_info.bSSE4_2)  // sse crc32 version
+  __m256i lanes[2];
+  for (u32 i = 0; i < 2; i++)
+    lanes[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc) + i);
+
+  for (u32 stripe = 0; stripe < count; stripe++, data += stride)
   {
-    ptrHashFunction = &GetCRC32;
+    const __m256i* key = reinterpret_cast<const __m256i*>(s_stripe_key + stripe);
+    for (u32 i = 0; i < 2; i++)
+    {
+      const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data) + i);
+      const __m256i data_key = _mm256_xor_si256(value, _mm256_loadu_si256(key + i));
+      const __m256i product =
+          _mm256_mul_epu32(data_key, _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+      lanes[i] = _mm256_add_epi64(lanes[i], _mm256_add_epi64(product, swapped));
+    }
+  }
+
+  if (count == STRIPES_PER_BLOCK)
+  {
+    const __m256i prime = _mm256_set1_epi32(HASH_PRIME32_1);
+    for (u32 i = 0; i < 2; i++)
+    {
+      __m256i value = _mm256_xor_si256(lanes[i], _mm256_srli_epi64(lanes[i], 47));
+      value = _mm256_xor_si256(
+          value, _mm256_load_si256(reinterpret_cast<const __m256i*>(s_scramble_key) + i));
+      const __m256i low = _mm256_mul_epu32(value, prime);
+      const __m256i high =
+          _mm256_mul_epu32(_mm256_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+      lanes[i] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+    }
   }
-  else
+
+  for (u32 i = 0; i < 2; i++)
+    _mm256_store_si256(reinterpret_cast<__m256i*>(acc) + i, lanes[i]);
+}
 #elif defined(_M_ARM_64)
-  if (cpu_info.bCRC32)
+void AccumulateStripesNEON(u64* acc, const u8* data, u32 count, u32 stride)
+{
+  uint64x2_t lanes[4];
+  for (u32 i = 0; i < 4; i++)
+    lanes[i] = vld1q_u64(acc + i * 2);
+
+  for (u32 stripe = 0; stripe < count; stripe++, data += stride)
+  {
+    const u64* key = s_stripe_key + stripe;
+    for (u32 i = 0; i < 4; i++)
+    {
+      const uint64x2_t value = vreinterpretq_u64_u8(vld1q_u8(data + i * 16));
+      const uint64x2_t data_key = veorq_u64(value, vld1q_u64(key + i * 2));
+      const uint64x2_t product = vmull_u32(vmovn_u64(data_key), vshrn_n_u64(data_key, 32));
+      const uint64x2_t swapped = vextq_u64(value, value, 1);
+      lanes[i] = vaddq_u64(lanes[i], vaddq_u64(product, swapped));
+    }
+  }
+
+  if (count == STRIPES_PER_BLOCK)
   {
-    ptrHashFunction = &GetCRC32;
+    const uint32x2_t prime = vdup_n_u32(HASH_PRIME32_1);
+    for (u32 i = 0; i < 4; i++)
+    {
+      uint64x2_t value = veorq_u64(lanes[i], vshrq_n_u64(lanes[i], 47));
+      value = veorq_u64(value, vld1q_u64(s_scramble_key + i * 2));
+      const uint64x2_t low = vmull_u32(vmovn_u64(value), prime);
+      const uint64x2_t high = vmull_u32(vshrn_n_u64(value, 32), prime);
+      lanes[i] = vaddq_u64(low, vshlq_n_u64(high, 32));
+    }
   }
-  else
+
+  for (u32 i = 0; i < 4; i++)
+    vst1q_u64(acc + i * 2, lanes[i]);
+}
 #endif
+
+AccumulateStripesFunction s_accumulate_stripes = AccumulateStripesGeneric;
+
+u64 Mul128Fold64(u64 a, u64 b)
+{
+  const u64 a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+  const u64 b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+  const u64 low_low = a_low * b_low;
+  const u64 high_low = a_high * b_low;
+  const u64 low_high = a_low * b_high;
+  const u64 high_high = a_high * b_high;
+  const u64 cross = (low_low >> 32) + (high_low & 0xFFFFFFFF) + low_high;
+  const u64 upper = (high_low >> 32) + (cross >> 32) + high_high;
+  const u64 lower = (cross << 32) | (low_low & 0xFFFFFFFF);
+  return upper ^ lower;
+}
+}  // Anonymous namespace
+
+u64 GetStripeHash64(const u8* src, u32 len, u32 samples)
+{
+  alignas(32) u64 acc[STRIPE_LANES] = {0x000000009E3779B1, 0x9E3779B185EBCA87,
+                                       0xC2B2AE3D27D4EB4F, 0x165667B19E3779F9,
+                                       0x85EBCA77C2B2AE63, 0x0000000085EBCA77,
+                                       0x27D4EB2F165667C5, 0x00000000C2B2AE3D};
+  const u32 stripes = len / STRIPE_SIZE;
+  // samples counts 64 bit words, like the other hashes
+  u32 step = 1;
+  if (samples != 0)
+    step = std::max(stripes / std::max(samples / STRIPE_LANES, 1u), 1u);
+
+  const u8* data = src;
+  u32 remaining = (stripes + step - 1) / step;
+  while (remaining != 0)
+  {
+    const u32 count = std::min(remaining, STRIPES_PER_BLOCK);
+    s_accumulate_stripes(acc, data, count, step * STRIPE_SIZE);
+    data += count * step * STRIPE_SIZE;
+    remaining -= count;
+  }
+
+  const u32 tail = len % STRIPE_SIZE;
+  if (tail != 0)
   {
-    ptrHashFunction = &GetMurmurHash3;
+    alignas(32) u8 last_stripe[STRIPE_SIZE] = {};
+    std::memcpy(last_stripe, src + stripes * STRIPE_SIZE, tail);
+    s_accumulate_stripes(acc, last_stripe, 1, STRIPE_SIZE);
   }
+
+  u64 h = len * 0x9E3779B185EBCA87;
+  for (u32 i = 0; i < STRIPE_LANES; i += 2)
+    h += Mul128Fold64(acc[i] ^ s_stripe_key[8 + i], acc[i + 1] ^ s_stripe_key[9 + i]);
+  h ^= h >> 37;
+  h *= 0x165667919E3779F9;
+  h ^= h >> 32;
+  return h;
+}
+
+u64 GetHash64(const u8* src, u32 len, u32 samples)
+{
+  return ptrHashFunction(src, len, samples);
+}
+
+// sets the hash function used for the texture cache
+void SetHash64Function()
+{
+#if defined(_M_X86)
+  s_accumulate_stripes = cpu_info.bAVX2 ? AccumulateStripesAVX2 : AccumulateStripesSSE2;
+#elif defined(_M_ARM_64)
+  s_accumulate_stripes = AccumulateStripesNEON;
+#endif
+  ptrHashFunction = &GetStripeHash64;
 }
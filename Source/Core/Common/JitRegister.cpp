@@ -7,7 +7,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
@@ -20,6 +22,13 @@
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <elf.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
 #if defined USE_OPROFILE && USE_OPROFILE
 #include <opagent.h>
 #endif
@@ -34,19 +43,181 @@ static op_agent_t s_agent = nullptr;
 #endif
 
 static File::IOFile s_perf_map_file;
+static File::IOFile s_jit_dump_file;
 
 namespace JitRegister
 {
 static bool s_is_enabled = false;
+static int s_init_count = 0;
+// Code is registered from the CPU, DSP and video threads.
+static std::mutex s_mutex;
+
+#ifdef __linux__
+// The jitdump format of perf, see tools/perf/Documentation/jitdump-specification.txt in the
+// Linux tree.
+enum : u32
+{
+  JIT_DUMP_MAGIC = 0x4A695444,
+  JIT_DUMP_VERSION = 1,
+  JIT_CODE_LOAD = 0,
+  JIT_CODE_DEBUG_INFO = 2,
+  JIT_CODE_CLOSE = 3,
+};
+
+struct JitDumpHeader
+{
+  u32 magic;
+  u32 version;
+  u32 total_size;
+  u32 elf_mach;
+  u32 pad1;
+  u32 pid;
+  u64 timestamp;
+  u64 flags;
+};
+
+struct JitDumpRecordHeader
+{
+  u32 id;
+  u32 total_size;
+  u64 timestamp;
+};
+
+struct JitDumpCodeLoad
+{
+  JitDumpRecordHeader header;
+  u32 pid;
+  u32 tid;
+  u64 vma;
+  u64 code_addr;
+  u64 code_size;
+  u64 code_index;
+};
+
+struct JitDumpDebugInfo
+{
+  JitDumpRecordHeader header;
+  u64 code_addr;
+  u64 nr_entry;
+};
+
+struct JitDumpDebugEntry
+{
+  u64 code_addr;
+  u32 line;
+  u32 discrim;
+};
+
+static void* s_jit_dump_marker = nullptr;
+// Every load gets a new index, perf tells code that reuses an address apart by it and by the
+// timestamp.
+static u64 s_code_index = 0;
 
-void Init(const std::string& perf_dir)
+// Samples have to be recorded with the same clock (perf record -k mono).
+static u64 GetTimestamp()
 {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<u64>(ts.tv_sec) * 1000000000 + static_cast<u64>(ts.tv_nsec);
+}
+
+static void OpenJitDump(const std::string& dir)
+{
+  std::string filename = StringFromFormat("%s/jit-%d.dump", dir.data(), getpid());
+  if (!s_jit_dump_file.Open(filename, "w+b"))
+    return;
+
+  // perf finds the file through an executable mapping of it in the recorded process.
+  s_jit_dump_marker = mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE,
+                           fileno(s_jit_dump_file.GetHandle()), 0);
+  if (s_jit_dump_marker == MAP_FAILED)
+  {
+    s_jit_dump_marker = nullptr;
+    s_jit_dump_file.Close();
+    return;
+  }
+
+  JitDumpHeader header = {};
+  header.magic = JIT_DUMP_MAGIC;
+  header.version = JIT_DUMP_VERSION;
+  header.total_size = sizeof(header);
+#if defined(_M_X86_64)
+  header.elf_mach = EM_X86_64;
+#elif defined(_M_ARM_64)
+  header.elf_mach = EM_AARCH64;
+#endif
+  header.pid = static_cast<u32>(getpid());
+  header.timestamp = GetTimestamp();
+  s_jit_dump_file.WriteBytes(&header, sizeof(header));
+  s_jit_dump_file.Flush();
+}
+
+static void CloseJitDump()
+{
+  if (!s_jit_dump_file.IsOpen())
+    return;
+
+  JitDumpRecordHeader record = {JIT_CODE_CLOSE, sizeof(record), GetTimestamp()};
+  s_jit_dump_file.WriteBytes(&record, sizeof(record));
+  munmap(s_jit_dump_marker, sysconf(_SC_PAGESIZE));
+  s_jit_dump_marker = nullptr;
+  s_jit_dump_file.Close();
+}
+
+static void WriteJitDump(const void* base_address, u32 code_size, const std::string& symbol_name,
+                         const std::string& source_name, const std::vector<CodeLine>* lines)
+{
+  const u64 timestamp = GetTimestamp();
+
+  // The debug info has to come before the code it describes.
+  if (lines && !lines->empty())
+  {
+    JitDumpDebugInfo info = {};
+    info.header.id = JIT_CODE_DEBUG_INFO;
+    info.header.total_size = static_cast<u32>(
+        sizeof(info) + lines->size() * (sizeof(JitDumpDebugEntry) + source_name.size() + 1));
+    info.header.timestamp = timestamp;
+    info.code_addr = reinterpret_cast<u64>(base_address);
+    info.nr_entry = lines->size();
+    s_jit_dump_file.WriteBytes(&info, sizeof(info));
+    for (const CodeLine& line : *lines)
+    {
+      JitDumpDebugEntry entry = {reinterpret_cast<u64>(line.code_address), line.guest_address, 0};
+      s_jit_dump_file.WriteBytes(&entry, sizeof(entry));
+      s_jit_dump_file.WriteBytes(source_name.c_str(), source_name.size() + 1);
+    }
+  }
+
+  JitDumpCodeLoad load = {};
+  load.header.id = JIT_CODE_LOAD;
+  load.header.total_size = static_cast<u32>(sizeof(load) + symbol_name.size() + 1 + code_size);
+  load.header.timestamp = timestamp;
+  load.pid = static_cast<u32>(getpid());
+  load.tid = static_cast<u32>(syscall(SYS_gettid));
+  load.vma = reinterpret_cast<u64>(base_address);
+  load.code_addr = load.vma;
+  load.code_size = code_size;
+  load.code_index = s_code_index++;
+  s_jit_dump_file.WriteBytes(&load, sizeof(load));
+  s_jit_dump_file.WriteBytes(symbol_name.c_str(), symbol_name.size() + 1);
+  s_jit_dump_file.WriteBytes(base_address, code_size);
+  // Like the map file, don't lose records in the event of a crash.
+  s_jit_dump_file.Flush();
+}
+#endif
+
+void Init(const std::string& perf_dir, bool jit_dump)
+{
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (s_init_count++ != 0)
+    return;
+
 #if defined USE_OPROFILE && USE_OPROFILE
   s_agent = op_open_agent();
   s_is_enabled = true;
 #endif
 
-  if (!perf_dir.empty() || getenv("PERF_BUILDID_DIR"))
+  if (!perf_dir.empty() || jit_dump || getenv("PERF_BUILDID_DIR"))
   {
     std::string dir = perf_dir.empty() ? "/tmp" : perf_dir;
     std::string filename = StringFromFormat("%s/perf-%d.map", dir.data(), getpid());
@@ -55,11 +226,20 @@ void Init(const std::string& perf_dir)
     // if the event of a crash:
     std::setvbuf(s_perf_map_file.GetHandle(), nullptr, _IONBF, 0);
     s_is_enabled = true;
+
+#ifdef __linux__
+    if (jit_dump)
+      OpenJitDump(dir);
+#endif
   }
 }
 
 void Shutdown()
 {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (s_init_count == 0 || --s_init_count != 0)
+    return;
+
 #if defined USE_OPROFILE && USE_OPROFILE
   op_close_agent(s_agent);
   s_agent = nullptr;
@@ -72,6 +252,10 @@ void Shutdown()
   if (s_perf_map_file.IsOpen())
     s_perf_map_file.Close();
 
+#ifdef __linux__
+  CloseJitDump();
+#endif
+
   s_is_enabled = false;
 }
 
@@ -80,14 +264,16 @@ bool IsEnabled()
   return s_is_enabled;
 }
 
-void RegisterV(const void* base_address, u32 code_size, const char* format, va_list args)
+static void RegisterCode(const void* base_address, u32 code_size, const std::string& source_name,
+                         const std::vector<CodeLine>* lines, const char* format, va_list args)
 {
 #if !(defined USE_OPROFILE && USE_OPROFILE) && !defined(USE_VTUNE)
-  if (!s_perf_map_file.IsOpen())
+  if (!s_is_enabled)
     return;
 #endif
 
   std::string symbol_name = StringFromFormatV(format, args);
+  std::lock_guard<std::mutex> lock(s_mutex);
 
 #if defined USE_OPROFILE && USE_OPROFILE
   op_write_native_code(s_agent, symbol_name.data(), (u64)base_address, base_address, code_size);
@@ -109,5 +295,21 @@ void RegisterV(const void* base_address, u32 code_size, const char* format, va_l
       StringFromFormat("%" PRIx64 " %x %s\n", (u64)base_address, code_size, symbol_name.data());
     s_perf_map_file.WriteBytes(entry.data(), entry.size());
   }
+
+#ifdef __linux__
+  if (s_jit_dump_file.IsOpen())
+    WriteJitDump(base_address, code_size, symbol_name, source_name, lines);
+#endif
+}
+
+void RegisterV(const void* base_address, u32 code_size, const char* format, va_list args)
+{
+  RegisterCode(base_address, code_size, {}, nullptr, format, args);
+}
+
+void RegisterLinesV(const void* base_address, u32 code_size, const std::string& source_name,
+                    const std::vector<CodeLine>& lines, const char* format, va_list args)
+{
+  RegisterCode(base_address, code_size, source_name, &lines, format, args);
 }
 }
@@ -5,13 +5,26 @@
 #pragma once
 #include <stdarg.h>
 #include <string>
+#include <vector>
 #include "Common/CommonTypes.h"
 
 namespace JitRegister
 {
-void Init(const std::string& perf_dir);
+// Maps generated code back to the guest code it was compiled from. The jitdump file reports the
+// guest address as the line number, and the source name as the file name.
+struct CodeLine
+{
+  const void* code_address;
+  u32 guest_address;
+};
+
+// Init and Shutdown are reference counted, so that each JIT can call them. With jit_dump, a
+// jit-<pid>.dump file for `perf inject --jit` is written as well as the perf-<pid>.map file.
+void Init(const std::string& perf_dir, bool jit_dump = false);
 void Shutdown();
 void RegisterV(const void* base_address, u32 code_size, const char* format, va_list args);
+void RegisterLinesV(const void* base_address, u32 code_size, const std::string& source_name,
+                    const std::vector<CodeLine>& lines, const char* format, va_list args);
 bool IsEnabled();
 
 inline void Register(const void* base_address, u32 code_size, const char* format, ...)
@@ -30,4 +43,13 @@ inline void Register(const void* start, const void* end, const char* format, ...
   RegisterV(start, code_size, format, args);
   va_end(args);
 }
+
+inline void RegisterLines(const void* base_address, u32 code_size, const std::string& source_name,
+                          const std::vector<CodeLine>& lines, const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  RegisterLinesV(base_address, code_size, source_name, lines, format, args);
+  va_end(args);
+}
 }
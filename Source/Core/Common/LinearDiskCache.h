@@ -4,13 +4,16 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/MappedFile.h"
 #include "Common/Version.h"
 
 // On disk format:
@@ -35,7 +38,8 @@ public:
 };
 
 // Dead simple unsorted key-value store with append functionality.
-// No random read functionality, all reading is done in OpenAndRead.
+// No random read functionality, all reading is done in OpenAndRead. The file is memory-mapped
+// for that where possible, so the values are handed to the reader straight from the page cache.
 // Keys and values can contain any characters, including \0.
 //
 // Suitable for caching generated shader bytecode between executions.
@@ -69,14 +73,6 @@ public:
     Close();
     m_num_entries = 0;
 
-    // try opening for reading/writing
-    File::OpenFStream(m_file, filename, ios_base::in | ios_base::out | ios_base::binary);
-
-    m_file.seekg(0, std::ios::end);
-    std::fstream::pos_type end_pos = m_file.tellg();
-    m_file.seekg(0, std::ios::beg);
-    std::fstream::pos_type start_pos = m_file.tellg();
-    std::streamoff file_size = end_pos - start_pos;
     if (version.empty())
     {
     m_header.Init();
@@ -85,6 +81,32 @@ public:
     {
       m_header.Init(version);
     }
+
+    // The mapping is closed before the file is opened for writing, Windows wouldn't allow both
+    u64 valid_size = 0;
+    bool read_mapped = false;
+    {
+      File::MappedFile mapping;
+      read_mapped = mapping.Open(filename) && ReadMapped(mapping, reader, &valid_size);
+    }
+
+    // try opening for reading/writing
+    File::OpenFStream(m_file, filename, ios_base::in | ios_base::out | ios_base::binary);
+
+    if (read_mapped)
+    {
+      // continue appending after the last valid entry
+      if (m_file.is_open())
+        m_file.seekp(valid_size);
+      return m_num_entries;
+    }
+
+    m_file.seekg(0, std::ios::end);
+    std::fstream::pos_type end_pos = m_file.tellg();
+    m_file.seekg(0, std::ios::beg);
+    std::fstream::pos_type start_pos = m_file.tellg();
+    std::streamoff file_size = end_pos - start_pos;
+
     if (m_file.is_open() && ValidateHeader())
     {
       // good header, read some key/value pairs
@@ -156,6 +178,54 @@ public:
   }
 
 private:
+  // Returns false if the header doesn't match, valid_size is set to the end of the last good entry
+  bool ReadMapped(const File::MappedFile& mapping, LinearDiskCacheReader<K, V>& reader,
+                  u64* valid_size)
+  {
+    const u8* data = mapping.GetData();
+    const u64 size = mapping.GetSize();
+    if (size < sizeof(Header) || std::memcmp(&m_header, data, sizeof(Header)) != 0)
+      return false;
+
+    // Only used for values that aren't aligned for V in the file
+    std::vector<V> aligned_value;
+    u64 offset = sizeof(Header);
+    while (size - offset >= sizeof(u32))
+    {
+      u32 value_size;
+      std::memcpy(&value_size, data + offset, sizeof(value_size));
+      const u64 value_bytes = static_cast<u64>(value_size) * sizeof(V);
+      const u64 entry_size = sizeof(value_size) + sizeof(K) + value_bytes + sizeof(u32);
+      if (size - offset < entry_size)
+        break;
+
+      K key;
+      const u8* key_ptr = data + offset + sizeof(value_size);
+      std::memcpy(&key, key_ptr, sizeof(K));
+      const u8* value_ptr = key_ptr + sizeof(K);
+      u32 entry_number;
+      std::memcpy(&entry_number, value_ptr + value_bytes, sizeof(entry_number));
+      if (entry_number != m_num_entries + 1)
+        break;
+
+      if (reinterpret_cast<uintptr_t>(value_ptr) % alignof(V) == 0)
+      {
+        reader.Read(key, reinterpret_cast<const V*>(value_ptr), value_size);
+      }
+      else
+      {
+        aligned_value.resize(value_size);
+        std::memcpy(aligned_value.data(), value_ptr, value_bytes);
+        reader.Read(key, aligned_value.data(), value_size);
+      }
+
+      m_num_entries++;
+      offset += entry_size;
+    }
+    *valid_size = offset;
+    return true;
+  }
+
   void WriteHeader() { Write(&m_header); }
   bool ValidateHeader()
   {
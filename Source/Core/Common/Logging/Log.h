@@ -72,6 +72,10 @@ enum LOG_LEVELS
 
 static const char LOG_LEVEL_TO_CHAR[7] = "-NEWID";
 
+// The highest level that is logged for each type, 0 while the type or all listeners are off.
+// Kept up to date by LogManager so that disabled messages cost a single compare.
+extern unsigned char g_level_limits[NUMBER_OF_LOGS];
+
 }  // namespace
 
 void GenericLog(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
@@ -92,7 +96,7 @@ void GenericLog(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char*
 // Let the compiler optimize this out
 #define GENERIC_LOG(t, v, ...)                                                                     \
   {                                                                                                \
-    if (v <= MAX_LOGLEVEL)                                                                         \
+    if (v <= MAX_LOGLEVEL && v <= LogTypes::g_level_limits[t])                                     \
       GenericLog(v, t, __FILE__, __LINE__, __VA_ARGS__);                                           \
   }
 
@@ -3,8 +3,10 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <cstdarg>
 #include <cstring>
+#include <ctime>
 #include <mutex>
 #include <ostream>
 #include <string>
@@ -17,10 +19,15 @@
 #include "Common/Logging/Log.h"
 #include "Common/Logging/LogManager.h"
 #include "Common/StringUtil.h"
-#include "Common/Timer.h"
+#include "Common/Thread.h"
 
 constexpr size_t MAX_MSGLEN = 1024;
 
+namespace LogTypes
+{
+unsigned char g_level_limits[NUMBER_OF_LOGS];
+}
+
 const Config::ConfigInfo<bool> LOGGER_WRITE_TO_FILE{
     {Config::System::Logger, "Options", "WriteToFile"}, false};
 const Config::ConfigInfo<bool> LOGGER_WRITE_TO_CONSOLE{
@@ -44,7 +51,14 @@ public:
       return;
 
     std::lock_guard<std::mutex> lk(m_log_lock);
-    m_logfile << msg << std::flush;
+    m_logfile << msg;
+  }
+
+  // Called by the writer thread after each batch instead of flushing every line
+  void Flush()
+  {
+    std::lock_guard<std::mutex> lk(m_log_lock);
+    m_logfile.flush();
   }
 
   bool IsValid() const { return m_logfile.good(); }
@@ -56,6 +70,49 @@ private:
   bool m_enable;
 };
 
+struct LogRecord
+{
+  u64 sequence;
+  std::chrono::system_clock::time_point time;
+  LogTypes::LOG_LEVELS level;
+  LogTypes::LOG_TYPE type;
+  const char* file;
+  int line;
+  char text[MAX_MSGLEN];
+};
+
+// Written only by the thread that owns it and read only by the writer thread
+class LogRing
+{
+public:
+  static constexpr size_t SIZE = 64;
+
+  std::array<LogRecord, SIZE> records;
+  std::atomic<size_t> read_index{0};
+  std::atomic<size_t> write_index{0};
+  // Set when the owning thread exits, the writer drops the ring once it is empty
+  std::atomic<bool> abandoned{false};
+};
+
+namespace
+{
+struct ThreadRing
+{
+  ~ThreadRing()
+  {
+    if (ring)
+      ring->abandoned.store(true);
+  }
+
+  std::shared_ptr<LogRing> ring;
+  // The LogManager the ring is registered with, as it can be recreated
+  u32 generation = 0;
+};
+}
+
+static thread_local ThreadRing s_thread_ring;
+static std::atomic<u32> s_generation{0};
+
 void GenericLog(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
                 const char* fmt, ...)
 {
@@ -161,10 +218,20 @@ LogManager::LogManager()
         Config::ConfigInfo<bool>{{Config::System::Logger, "Logs", container.m_short_name}, false});
 
   m_path_cutoff_point = DeterminePathCutOffPoint();
+
+  m_generation = ++s_generation;
+  m_writer_thread = std::thread(&LogManager::WriterThread, this);
+  UpdateLevelLimits();
 }
 
 LogManager::~LogManager()
 {
+  std::fill(std::begin(LogTypes::g_level_limits), std::end(LogTypes::g_level_limits), 0);
+  // The writer passes on whatever is still queued before it exits
+  m_writer_exiting.store(true);
+  WakeWriter();
+  m_writer_thread.join();
+
   // The log window listener pointer is owned by the GUI code.
   delete m_listeners[LogListener::CONSOLE_LISTENER];
   delete m_listeners[LogListener::FILE_LISTENER];
@@ -198,16 +265,160 @@ void LogManager::LogWithFullPath(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE
   if (!IsEnabled(type, level) || !static_cast<bool>(m_listener_ids))
     return;
 
-  char temp[MAX_MSGLEN];
-  CharArrayFromFormatV(temp, MAX_MSGLEN, format, args);
+  // The arguments can't outlive this call, so the message text is formatted here. Everything
+  // else, including the time stamp, is left to the writer thread.
+  LogRing& ring = GetThreadRing();
+  const size_t write_index = ring.write_index.load(std::memory_order_relaxed);
+  while (write_index - ring.read_index.load(std::memory_order_acquire) >= LogRing::SIZE)
+  {
+    WakeWriter();
+    Common::YieldCPU();
+  }
+
+  LogRecord& record = ring.records[write_index % LogRing::SIZE];
+  record.sequence = m_next_sequence.fetch_add(1, std::memory_order_relaxed);
+  record.time = std::chrono::system_clock::now();
+  record.level = level;
+  record.type = type;
+  record.file = file;
+  record.line = line;
+  CharArrayFromFormatV(record.text, MAX_MSGLEN, format, args);
+  ring.write_index.store(write_index + 1);
+
+  if (m_writer_sleeping.load())
+    WakeWriter();
+}
+
+LogRing& LogManager::GetThreadRing()
+{
+  if (!s_thread_ring.ring || s_thread_ring.generation != m_generation)
+  {
+    if (s_thread_ring.ring)
+      s_thread_ring.ring->abandoned.store(true);
+    s_thread_ring.ring = std::make_shared<LogRing>();
+    s_thread_ring.generation = m_generation;
 
-  std::string msg =
-      StringFromFormat("%s %s:%u %c[%s]: %s\n", Common::Timer::GetTimeFormatted().c_str(), file,
-                       line, LogTypes::LOG_LEVEL_TO_CHAR[(int)level], GetShortName(type), temp);
+    std::lock_guard<std::mutex> lk(m_rings_lock);
+    m_rings.push_back(s_thread_ring.ring);
+  }
+  return *s_thread_ring.ring;
+}
 
-  for (auto listener_id : m_listener_ids)
-    if (m_listeners[listener_id])
-      m_listeners[listener_id]->Log(level, msg.c_str());
+void LogManager::WakeWriter()
+{
+  // Taking the lock makes sure the writer is either waiting already or will see the new records
+  // before it waits.
+  {
+    std::lock_guard<std::mutex> lk(m_writer_lock);
+  }
+  m_writer_wakeup.notify_one();
+}
+
+void LogManager::WriterThread()
+{
+  Common::SetCurrentThreadName("Log writer");
+
+  while (true)
+  {
+    const bool exiting = m_writer_exiting.load();
+    if (WriteQueuedMessages())
+      continue;
+    if (exiting)
+      break;
+
+    std::unique_lock<std::mutex> lk(m_writer_lock);
+    m_writer_sleeping.store(true);
+    bool pending = m_writer_exiting.load();
+    {
+      std::lock_guard<std::mutex> rings_lk(m_rings_lock);
+      for (const auto& ring : m_rings)
+        pending |= ring->read_index.load(std::memory_order_relaxed) != ring->write_index.load();
+    }
+    if (!pending)
+      m_writer_wakeup.wait_for(lk, std::chrono::milliseconds(100));
+    m_writer_sleeping.store(false);
+  }
+}
+
+static std::string FormatTime(std::chrono::system_clock::time_point time)
+{
+  const std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+  const int milliseconds = static_cast<int>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() %
+      1000);
+  // Only ever called from the writer thread, so the static buffer of localtime is fine
+  char formatted[16];
+  std::strftime(formatted, sizeof(formatted), "%M:%S", std::localtime(&seconds));
+  return StringFromFormat("%s:%03i", formatted, milliseconds);
+}
+
+bool LogManager::WriteQueuedMessages()
+{
+  struct Message
+  {
+    u64 sequence;
+    LogTypes::LOG_LEVELS level;
+    std::string text;
+  };
+  std::vector<Message> messages;
+
+  std::vector<std::shared_ptr<LogRing>> rings;
+  {
+    std::lock_guard<std::mutex> lk(m_rings_lock);
+    rings = m_rings;
+  }
+  for (const auto& ring : rings)
+  {
+    const size_t write_index = ring->write_index.load(std::memory_order_acquire);
+    for (size_t i = ring->read_index.load(std::memory_order_relaxed); i != write_index; ++i)
+    {
+      const LogRecord& record = ring->records[i % LogRing::SIZE];
+      messages.push_back({record.sequence, record.level,
+                          StringFromFormat("%s %s:%u %c[%s]: %s\n",
+                                           FormatTime(record.time).c_str(), record.file,
+                                           record.line, LogTypes::LOG_LEVEL_TO_CHAR[record.level],
+                                           GetShortName(record.type), record.text)});
+      ring->read_index.store(i + 1, std::memory_order_release);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(m_rings_lock);
+    m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+                                 [](const std::shared_ptr<LogRing>& ring) {
+                                   return ring->abandoned.load() &&
+                                          ring->read_index.load() == ring->write_index.load();
+                                 }),
+                  m_rings.end());
+  }
+
+  if (messages.empty())
+    return false;
+
+  // Restore the order the messages were logged in across threads
+  std::sort(messages.begin(), messages.end(),
+            [](const Message& a, const Message& b) { return a.sequence < b.sequence; });
+
+  std::lock_guard<std::mutex> lk(m_listener_lock);
+  for (const Message& message : messages)
+  {
+    for (auto listener_id : m_listener_ids)
+      if (m_listeners[listener_id])
+        m_listeners[listener_id]->Log(message.level, message.text.c_str());
+  }
+  if (m_listeners[LogListener::FILE_LISTENER])
+    static_cast<FileLogListener*>(m_listeners[LogListener::FILE_LISTENER])->Flush();
+  return true;
+}
+
+void LogManager::UpdateLevelLimits()
+{
+  const bool any_listener = static_cast<bool>(m_listener_ids);
+  for (size_t i = 0; i < LogTypes::NUMBER_OF_LOGS; ++i)
+  {
+    LogTypes::g_level_limits[i] =
+        static_cast<unsigned char>(any_listener && m_log[i].m_enable ? m_level : 0);
+  }
 }
 
 LogTypes::LOG_LEVELS LogManager::GetLogLevel() const
@@ -218,11 +429,13 @@ LogTypes::LOG_LEVELS LogManager::GetLogLevel() const
 void LogManager::SetLogLevel(LogTypes::LOG_LEVELS level)
 {
   m_level = level;
+  UpdateLevelLimits();
 }
 
 void LogManager::SetEnable(LogTypes::LOG_TYPE type, bool enable)
 {
   m_log[type].m_enable = enable;
+  UpdateLevelLimits();
 }
 
 bool LogManager::IsEnabled(LogTypes::LOG_TYPE type, LogTypes::LOG_LEVELS level) const
@@ -242,12 +455,14 @@ const char* LogManager::GetFullName(LogTypes::LOG_TYPE type) const
 
 void LogManager::RegisterListener(LogListener::LISTENER id, LogListener* listener)
 {
+  std::lock_guard<std::mutex> lk(m_listener_lock);
   m_listeners[id] = listener;
 }
 
 void LogManager::EnableListener(LogListener::LISTENER id, bool enable)
 {
   m_listener_ids[id] = enable;
+  UpdateLevelLimits();
 }
 
 bool LogManager::IsListenerEnabled(LogListener::LISTENER id) const
@@ -5,9 +5,17 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "Common/BitSet.h"
+#include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 
 // pure virtual interface
@@ -27,6 +35,11 @@ public:
   };
 };
 
+class LogRing;
+
+// Messages are formatted into a ring buffer of the logging thread. A background thread takes
+// them from there, adds the time stamp and passes them to the listeners, so slow listeners such
+// as the log file don't hold up emulation.
 class LogManager
 {
 public:
@@ -70,9 +83,28 @@ private:
   LogManager(LogManager&&) = delete;
   LogManager& operator=(LogManager&&) = delete;
 
+  void UpdateLevelLimits();
+  LogRing& GetThreadRing();
+  void WakeWriter();
+  void WriterThread();
+  // Passes everything in the rings to the listeners, returns false if there was nothing
+  bool WriteQueuedMessages();
+
   LogTypes::LOG_LEVELS m_level;
   std::array<LogContainer, LogTypes::NUMBER_OF_LOGS> m_log{};
   std::array<LogListener*, LogListener::NUMBER_OF_LISTENERS> m_listeners{};
   BitSet32 m_listener_ids;
   size_t m_path_cutoff_point = 0;
+
+  u32 m_generation;
+  std::atomic<u64> m_next_sequence{0};
+  std::mutex m_rings_lock;
+  std::vector<std::shared_ptr<LogRing>> m_rings;
+  // Held while messages are passed to the listeners, so that they can be unregistered safely
+  std::mutex m_listener_lock;
+  std::mutex m_writer_lock;
+  std::condition_variable m_writer_wakeup;
+  std::atomic<bool> m_writer_sleeping{false};
+  std::atomic<bool> m_writer_exiting{false};
+  std::thread m_writer_thread;
 };
@@ -0,0 +1,167 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/MappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+
+#include "Common/StringUtil.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/vfs.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#include <sys/mount.h>
+#include <sys/param.h>
+#endif
+#endif
+
+#include "Common/CommonTypes.h"
+
+namespace File
+{
+static bool IsOnLocalDrive(const std::string& path)
+{
+#if defined(_WIN32)
+  wchar_t volume[MAX_PATH];
+  if (!GetVolumePathNameW(UTF8ToTStr(path).c_str(), volume, MAX_PATH))
+    return false;
+  return GetDriveTypeW(volume) == DRIVE_FIXED;
+#elif defined(__linux__)
+  struct statfs buf;
+  if (statfs(path.c_str(), &buf) != 0)
+    return false;
+  switch (static_cast<u32>(buf.f_type))
+  {
+  case 0x6969:      // NFS
+  case 0x517B:      // SMB
+  case 0xFF534D42:  // CIFS
+  case 0xFE534D42:  // SMB2
+  case 0x65735546:  // FUSE
+  case 0x01021997:  // 9P
+    return false;
+  default:
+    return true;
+  }
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+  struct statfs buf;
+  if (statfs(path.c_str(), &buf) != 0)
+    return false;
+  return (buf.f_flags & MNT_LOCAL) != 0;
+#else
+  return false;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+  Close();
+  if (!IsOnLocalDrive(path))
+    return false;
+
+#ifdef _WIN32
+  HANDLE file = CreateFileW(UTF8ToTStr(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+  HANDLE mapping = nullptr;
+  if (GetFileSizeEx(file, &size) && size.QuadPart != 0)
+    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  // The view keeps the file open, the handles aren't needed anymore.
+  CloseHandle(file);
+  if (!mapping)
+    return false;
+
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (!data)
+    return false;
+  m_size = static_cast<u64>(size.QuadPart);
+#else
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat file_info;
+  void* data = MAP_FAILED;
+  if (fstat(fd, &file_info) == 0 && S_ISREG(file_info.st_mode) && file_info.st_size != 0)
+    data = mmap(nullptr, file_info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps the file open, the descriptor isn't needed anymore.
+  close(fd);
+  if (data == MAP_FAILED)
+    return false;
+  m_size = static_cast<u64>(file_info.st_size);
+#endif
+
+  m_data = static_cast<const u8*>(data);
+  return true;
+}
+
+void MappedFile::Close()
+{
+  if (!m_data)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_data);
+#else
+  munmap(const_cast<u8*>(m_data), m_size);
+#endif
+  m_data = nullptr;
+  m_size = 0;
+}
+
+bool MappedFile::Read(u64 offset, u64 size, u8* out_ptr) const
+{
+  if (offset > m_size || size > m_size - offset)
+    return false;
+  std::memcpy(out_ptr, m_data + offset, static_cast<size_t>(size));
+  return true;
+}
+
+void MappedFile::SetAccessPattern(AccessPattern pattern) const
+{
+#if !defined(_WIN32) && !defined(__ANDROID__)
+  if (!m_data)
+    return;
+
+  int advice = POSIX_MADV_NORMAL;
+  if (pattern == AccessPattern::Sequential)
+    advice = POSIX_MADV_SEQUENTIAL;
+  else if (pattern == AccessPattern::Random)
+    advice = POSIX_MADV_RANDOM;
+  posix_madvise(const_cast<u8*>(m_data), m_size, advice);
+#endif
+}
+
+void MappedFile::Prefetch(u64 offset, u64 size) const
+{
+#if !defined(_WIN32) && !defined(__ANDROID__)
+  if (!m_data || offset >= m_size)
+    return;
+
+  // madvise wants a page-aligned start
+  const u64 page_size = static_cast<u64>(sysconf(_SC_PAGESIZE));
+  const u64 start = offset - offset % page_size;
+  const u64 end = std::min(offset + size, m_size);
+  posix_madvise(const_cast<u8*>(m_data + start), end - start, POSIX_MADV_WILLNEED);
+#endif
+}
+
+}  // namespace
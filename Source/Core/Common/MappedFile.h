@@ -0,0 +1,53 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+namespace File
+{
+// A read-only view of a whole file. Reading from it is a memcpy from the page cache, without a
+// seek and a read call per access.
+//
+// An I/O error on mapped memory can't be reported like a failed read and kills the process
+// instead, so only files on local drives are mapped. Callers need a fallback for when Open fails.
+class MappedFile
+{
+public:
+  enum class AccessPattern
+  {
+    Normal,
+    Sequential,
+    Random,
+  };
+
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool Open(const std::string& path);
+  void Close();
+
+  bool IsOpen() const { return m_data != nullptr; }
+  const u8* GetData() const { return m_data; }
+  u64 GetSize() const { return m_size; }
+
+  // Copies size bytes at offset, returns false if they are past the end of the file.
+  bool Read(u64 offset, u64 size, u8* out_ptr) const;
+
+  // Hints for the kernel's read-ahead. They are no-ops where not supported.
+  void SetAccessPattern(AccessPattern pattern) const;
+  void Prefetch(u64 offset, u64 size) const;
+
+private:
+  const u8* m_data = nullptr;
+  u64 m_size = 0;
+};
+
+}  // namespace
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <set>
 #include <string>
@@ -11,6 +12,7 @@
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 
@@ -52,8 +54,11 @@ static int AshmemCreateFileMapping(const char* name, size_t size)
 }
 #endif
 
-void MemArena::GrabSHMSegment(size_t size)
+void MemArena::GrabSHMSegment(size_t size, bool huge_pages)
 {
+  // Large pages on Windows need the "Lock pages in memory" privilege and large page aligned views,
+  // which the mirrors smaller than 2 MiB can't have. Only Linux's transparent huge pages are used.
+  m_huge_pages = huge_pages;
 #ifdef _WIN32
   const std::string name = "dolphin-emu." + std::to_string(GetCurrentProcessId());
   hMemoryMapping = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
@@ -104,6 +109,8 @@ void* MemArena::CreateView(s64 offset, size_t size, void* base)
   }
   else
   {
+    if (m_huge_pages && size >= HUGE_PAGE_SIZE)
+      Common::AdviseHugePages(retval, size);
     return retval;
   }
 #endif
@@ -144,13 +151,15 @@ u8* MemArena::FindMemoryBase()
 #else
   const int flags = MAP_ANON | MAP_PRIVATE;
 #endif
-  void* base = mmap(nullptr, memory_size, PROT_NONE, flags, -1, 0);
+  // Reserve extra space so that the base can be aligned for huge pages
+  void* base = mmap(nullptr, memory_size + HUGE_PAGE_SIZE, PROT_NONE, flags, -1, 0);
   if (base == MAP_FAILED)
   {
     PanicAlert("Failed to map enough memory space: %s", LastStrerrorString().c_str());
     return nullptr;
   }
-  munmap(base, memory_size);
-  return static_cast<u8*>(base);
+  munmap(base, memory_size + HUGE_PAGE_SIZE);
+  const uintptr_t address = reinterpret_cast<uintptr_t>(base);
+  return reinterpret_cast<u8*>((address + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
 #endif
 }
@@ -20,15 +20,20 @@
 class MemArena
 {
 public:
-  void GrabSHMSegment(size_t size);
+  // With huge_pages, views are backed by 2 MiB pages where the host allows it. They only get
+  // them where the view's address and its offset in the segment are both 2 MiB aligned.
+  void GrabSHMSegment(size_t size, bool huge_pages = false);
   void ReleaseSHMSegment();
   void* CreateView(s64 offset, size_t size, void* base = nullptr);
   void ReleaseView(void* view, size_t size);
 
-  // This finds 1 GB in 32-bit, 16 GB in 64-bit.
+  // This finds 1 GB in 32-bit, 16 GB in 64-bit. The base is aligned to HUGE_PAGE_SIZE.
   static u8* FindMemoryBase();
 
+  static constexpr size_t HUGE_PAGE_SIZE = 0x200000;
+
 private:
+  bool m_huge_pages = false;
 #ifdef _WIN32
   HANDLE hMemoryMapping;
 #else
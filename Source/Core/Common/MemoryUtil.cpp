@@ -98,6 +98,16 @@ void FreeMemoryPages(void* ptr, size_t size)
   }
 }
 
+bool AdviseHugePages(void* ptr, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+  if (madvise(ptr, size, MADV_HUGEPAGE) == 0)
+    return true;
+  WARN_LOG(MEMMAP, "madvise(MADV_HUGEPAGE) failed: %s", LastStrerrorString().c_str());
+#endif
+  return false;
+}
+
 void FreeAlignedMemory(void* ptr)
 {
   if (ptr)
@@ -17,6 +17,8 @@ void FreeAlignedMemory(void* ptr);
 void ReadProtectMemory(void* ptr, size_t size);
 void WriteProtectMemory(void* ptr, size_t size, bool executable = false);
 void UnWriteProtectMemory(void* ptr, size_t size, bool allowExecute = false);
+// Asks the kernel to back the range with transparent huge pages, returns false where unsupported.
+bool AdviseHugePages(void* ptr, size_t size);
 std::string MemUsage();
 size_t MemPhysical();
 
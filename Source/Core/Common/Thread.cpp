@@ -3,15 +3,30 @@
 // Refer to the license.txt file included.
 
 #include "Common/Thread.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/TraceEvents.h"
 
 #ifdef _WIN32
 #include <windows.h>
 #else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
 #ifdef __APPLE__
 #include <mach/mach.h>
 #elif defined BSD4_4 || defined __FreeBSD__ || defined __OpenBSD__
@@ -40,14 +55,65 @@ int CurrentThreadId()
 
 #ifdef _WIN32
 
-void SetThreadAffinity(std::thread::native_handle_type thread, u32 mask)
+bool SetThreadAffinity(std::thread::native_handle_type thread, u64 mask)
+{
+  return SetThreadAffinityMask(thread, static_cast<DWORD_PTR>(mask)) != 0;
+}
+
+bool SetCurrentThreadAffinity(u64 mask)
 {
-  SetThreadAffinityMask(thread, mask);
+  return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(mask)) != 0;
 }
 
-void SetCurrentThreadAffinity(u32 mask)
+std::vector<LogicalCPU> GetCPUTopology()
 {
-  SetThreadAffinityMask(GetCurrentThread(), mask);
+  DWORD length = 0;
+  GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &length);
+  std::vector<u8> buffer(length);
+  if (!length ||
+      !GetLogicalProcessorInformationEx(
+          RelationProcessorCore,
+          reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length))
+  {
+    return {};
+  }
+
+  // Affinity masks only name the CPUs of the processor group the thread is in.
+  GROUP_AFFINITY thread_group = {};
+  GetThreadGroupAffinity(GetCurrentThread(), &thread_group);
+
+  std::vector<LogicalCPU> cpus;
+  std::vector<BYTE> efficiency_classes;
+  BYTE max_efficiency_class = 0;
+  u32 core = 0;
+  for (DWORD offset = 0; offset < length; core++)
+  {
+    const auto* info =
+        reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+    offset += info->Size;
+    const PROCESSOR_RELATIONSHIP& processor = info->Processor;
+    // Higher classes are faster, all cores share the same class on CPUs that aren't hybrid.
+    max_efficiency_class = std::max(max_efficiency_class, processor.EfficiencyClass);
+    for (WORD i = 0; i < processor.GroupCount; i++)
+    {
+      if (processor.GroupMask[i].Group != thread_group.Group)
+        continue;
+      for (u32 bit = 0; bit < sizeof(KAFFINITY) * 8; bit++)
+      {
+        if ((processor.GroupMask[i].Mask >> bit) & 1)
+        {
+          cpus.push_back({bit, core, true});
+          efficiency_classes.push_back(processor.EfficiencyClass);
+        }
+      }
+    }
+  }
+
+  for (size_t i = 0; i < cpus.size(); i++)
+    cpus[i].performance = efficiency_classes[i] == max_efficiency_class;
+  std::sort(cpus.begin(), cpus.end(),
+            [](const LogicalCPU& a, const LogicalCPU& b) { return a.index < b.index; });
+  return cpus;
 }
 
 // Supporting functions
@@ -61,11 +127,31 @@ void SwitchCurrentThread()
   SwitchToThread();
 }
 
+bool SetCurrentThreadRealtimePriority()
+{
+  return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+}
+
+bool SetCurrentThreadPriority(ThreadPriority priority)
+{
+  switch (priority)
+  {
+  case ThreadPriority::High:
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST) != 0;
+  case ThreadPriority::Realtime:
+    return SetCurrentThreadRealtimePriority();
+  default:
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_NORMAL) != 0;
+  }
+}
+
 // Sets the debugger-visible name of the current thread.
 // Uses trick documented in:
 // https://docs.microsoft.com/en-us/visualstudio/debugger/how-to-set-a-thread-name-in-native-code
 void SetCurrentThreadName(const char* szThreadName)
 {
+  Trace::SetThreadName(szThreadName);
+
   static const DWORD MS_VC_EXCEPTION = 0x406D1388;
 
 #pragma pack(push, 8)
@@ -94,10 +180,12 @@ void SetCurrentThreadName(const char* szThreadName)
 
 #else  // !WIN32, so must be POSIX threads
 
-void SetThreadAffinity(std::thread::native_handle_type thread, u32 mask)
+bool SetThreadAffinity(std::thread::native_handle_type thread, u64 mask)
 {
 #ifdef __APPLE__
-  thread_policy_set(pthread_mach_thread_np(thread), THREAD_AFFINITY_POLICY, (integer_t*)&mask, 1);
+  integer_t tag = static_cast<integer_t>(mask);
+  return thread_policy_set(pthread_mach_thread_np(thread), THREAD_AFFINITY_POLICY, &tag, 1) ==
+         KERN_SUCCESS;
 #elif (defined __linux__ || defined BSD4_4 || defined __FreeBSD__) && !(defined ANDROID)
 #ifdef __FreeBSD__
   cpuset_t cpu_set;
@@ -110,13 +198,86 @@ void SetThreadAffinity(std::thread::native_handle_type thread, u32 mask)
     if ((mask >> i) & 1)
       CPU_SET(i, &cpu_set);
 
-  pthread_setaffinity_np(thread, sizeof(cpu_set), &cpu_set);
+  return pthread_setaffinity_np(thread, sizeof(cpu_set), &cpu_set) == 0;
+#else
+  return false;
 #endif
 }
 
-void SetCurrentThreadAffinity(u32 mask)
+bool SetCurrentThreadAffinity(u64 mask)
 {
-  SetThreadAffinity(pthread_self(), mask);
+  return SetThreadAffinity(pthread_self(), mask);
+}
+
+#ifdef __linux__
+// Parses the "0-3,8,10-11" lists sysfs uses for sets of CPUs.
+static std::vector<u32> ParseCPUList(const std::string& list)
+{
+  std::vector<u32> cpus;
+  for (const std::string& range : SplitString(StripSpaces(list), ','))
+  {
+    u32 first, last;
+    const int fields = std::sscanf(range.c_str(), "%u-%u", &first, &last);
+    if (fields < 1)
+      continue;
+    if (fields == 1)
+      last = first;
+    for (u32 cpu = first; cpu <= last; cpu++)
+      cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+static u32 ReadSysfsValue(const std::string& path, u32 default_value)
+{
+  std::string value;
+  u32 result;
+  if (!File::ReadFileToString(path, value) || !TryParse(StripSpaces(value), &result))
+    return default_value;
+  return result;
+}
+#endif
+
+std::vector<LogicalCPU> GetCPUTopology()
+{
+#ifdef __linux__
+  std::string online;
+  if (!File::ReadFileToString("/sys/devices/system/cpu/online", online))
+    return {};
+
+  // Intel hybrid CPUs list their performance cores here.
+  std::string performance_list;
+  const bool hybrid = File::ReadFileToString("/sys/devices/cpu_core/cpus", performance_list);
+  const std::vector<u32> performance_cpus = ParseCPUList(performance_list);
+
+  std::vector<LogicalCPU> cpus;
+  std::vector<u32> capacities;
+  u32 max_capacity = 0;
+  for (u32 index : ParseCPUList(online))
+  {
+    if (index >= 64)
+      break;
+    const std::string dir = StringFromFormat("/sys/devices/system/cpu/cpu%u/", index);
+    const u32 package = ReadSysfsValue(dir + "topology/physical_package_id", 0);
+    const u32 core = ReadSysfsValue(dir + "topology/core_id", index);
+    // Arm big.LITTLE CPUs report the relative performance of their cores instead.
+    const u32 capacity = ReadSysfsValue(dir + "cpu_capacity", 0);
+    max_capacity = std::max(max_capacity, capacity);
+    capacities.push_back(capacity);
+    cpus.push_back({index, (package << 16) | core,
+                    !hybrid || std::find(performance_cpus.begin(), performance_cpus.end(),
+                                         index) != performance_cpus.end()});
+  }
+
+  if (!hybrid && max_capacity)
+  {
+    for (size_t i = 0; i < cpus.size(); i++)
+      cpus[i].performance = capacities[i] == max_capacity;
+  }
+  return cpus;
+#else
+  return {};
+#endif
 }
 
 void SleepCurrentThread(int ms)
@@ -129,8 +290,36 @@ void SwitchCurrentThread()
   usleep(1000 * 1);
 }
 
+bool SetCurrentThreadRealtimePriority()
+{
+  // Just above the lowest real-time priority, so that kernel threads still preempt it.
+  sched_param param = {};
+  param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+  return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+}
+
+bool SetCurrentThreadPriority(ThreadPriority priority)
+{
+  if (priority == ThreadPriority::Realtime)
+    return SetCurrentThreadRealtimePriority();
+
+  sched_param param = {};
+  if (pthread_setschedparam(pthread_self(), SCHED_OTHER, &param) != 0)
+    return false;
+  if (priority == ThreadPriority::Normal)
+    return true;
+#ifdef __linux__
+  // Linux applies nice values to single threads.
+  return setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), -10) == 0;
+#else
+  return false;
+#endif
+}
+
 void SetCurrentThreadName(const char* szThreadName)
 {
+  Trace::SetThreadName(szThreadName);
+
 #ifdef __APPLE__
   pthread_setname_np(szThreadName);
 #elif defined __FreeBSD__ || defined __OpenBSD__
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <thread>
+#include <vector>
 
 // Don't include Common.h here as it will break LogManager
 #include "Common/CommonTypes.h"
@@ -20,8 +21,22 @@ namespace Common
 {
 int CurrentThreadId();
 
-void SetThreadAffinity(std::thread::native_handle_type thread, u32 mask);
-void SetCurrentThreadAffinity(u32 mask);
+// Bit i of the mask allows logical CPU i. Returns false if the OS refused or doesn't support it.
+bool SetThreadAffinity(std::thread::native_handle_type thread, u64 mask);
+bool SetCurrentThreadAffinity(u64 mask);
+
+struct LogicalCPU
+{
+  // Bit of the CPU in affinity masks.
+  u32 index;
+  // Shared by the SMT siblings of a physical core.
+  u32 core;
+  // False for the efficiency cores of hybrid CPUs.
+  bool performance;
+};
+
+// Empty if the OS doesn't tell. Only the CPUs an affinity mask can name are listed.
+std::vector<LogicalCPU> GetCPUTopology();
 
 void SleepCurrentThread(int ms);
 void SwitchCurrentThread();  // On Linux, this is equal to sleep 1ms
@@ -36,4 +51,21 @@ inline void YieldCPU()
 
 void SetCurrentThreadName(const char* name);
 
+// Asks the scheduler to run the current thread ahead of normal threads. This usually needs
+// elevated privileges outside of Windows; returns false if the request was refused.
+bool SetCurrentThreadRealtimePriority();
+
+enum class ThreadPriority
+{
+  Normal,
+  // Ahead of the other threads of normal priority, but not of the whole system.
+  High,
+  // Same as SetCurrentThreadRealtimePriority.
+  Realtime,
+};
+
+// Raising the priority usually needs elevated privileges outside of Windows; returns false if the
+// request was refused.
+bool SetCurrentThreadPriority(ThreadPriority priority);
+
 }  // namespace Common
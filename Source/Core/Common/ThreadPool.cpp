@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <chrono>
+
 #include "Common/Common.h"
 #include "Common/CPUDetect.h"
 #include "Common/ThreadPool.h"
@@ -6,8 +9,9 @@
 #endif
 using namespace Common;
 std::mutex ThreadPool::m_workerLock;
+static thread_local s32 s_worker_id = -1;
 
-ThreadPool::ThreadPool() : m_workflag(0), m_workercount(0), m_workers(16)
+ThreadPool::ThreadPool() : m_workflag(0), m_workercount(0), m_sleeping(0), m_workers(16)
 {
   m_working.store(true);
   int workers = cpu_info.logical_cpu_count - 2;
@@ -24,7 +28,11 @@ ThreadPool::ThreadPool() : m_workflag(0), m_workercount(0), m_workers(16)
 
 ThreadPool::~ThreadPool()
 {
-  m_working.store(false);
+  {
+    std::lock_guard<std::mutex> guard(m_sleepLock);
+    m_working.store(false);
+  }
+  m_wakeup.notify_all();
   for (u32 i = 0; i < m_workerThreads.size(); i++)
   {
     std::thread* current = m_workerThreads[i].get();
@@ -43,7 +51,17 @@ ThreadPool& ThreadPool::Getinstance()
 
 void ThreadPool::NotifyWorkPending()
 {
-  ThreadPool::Getinstance().m_workflag.fetch_add(2);
+  ThreadPool& instance = ThreadPool::Getinstance();
+  // Each pending notification wakes one thread, there is no point in having more than threads.
+  if (instance.m_workflag.load() < static_cast<s32>(instance.m_workerThreads.size()))
+    instance.m_workflag.fetch_add(1);
+  // A thread that is about to sleep registers itself before it checks m_workflag, so either it
+  // sees the notification or it is counted here.
+  if (instance.m_sleeping.load() > 0)
+  {
+    std::lock_guard<std::mutex> guard(instance.m_sleepLock);
+    instance.m_wakeup.notify_one();
+  }
 }
 
 void ThreadPool::RegisterWorker(IWorker* worker)
@@ -75,84 +93,221 @@ void ThreadPool::UnregisterWorker(IWorker* worker)
   }
 }
 
+s32 ThreadPool::GetCurrentThreadID()
+{
+  return s_worker_id;
+}
+
 void ThreadPool::Workloop(ThreadPool &state, size_t ID)
 {
-  u32 rest_time = 1;
+  s_worker_id = static_cast<s32>(ID);
   while (state.m_working.load())
   {
-    if (state.m_workflag.load() > ID)
-    {
-      bool worked = false;
-      u32 count = state.m_workercount.load();
-      for (u32 i = 0; i < count; i++)
-      {
-        IWorker* worker = state.m_workers[i];
-        if (worker)
-        {
-          if (worker->NextTask(ID))
-          {
-            worked = true;
-            state.m_workflag.fetch_sub(1);
-          }
-        }
-      }
-      if (worked)
-      {
-        Common::YieldCPU();
-        continue;
-      }
-      else if (state.m_workflag.load() > ID)
-      {
-        state.m_workflag.fetch_sub(1);
-      }
-      rest_time = 1;
-    }
-    else
+    bool worked = false;
+    u32 count = state.m_workercount.load();
+    for (u32 i = 0; i < count; i++)
     {
-      rest_time++;
-      rest_time = rest_time > 5 ? 5 : rest_time;
+      IWorker* worker = state.m_workers[i];
+      if (worker && worker->NextTask(ID))
+        worked = true;
     }
-    SleepCurrentThread(rest_time);
+    if (worked)
+      continue;
+
+    // Nothing to do, sleep until new work is announced.
+    std::unique_lock<std::mutex> lock(state.m_sleepLock);
+    state.m_sleeping.fetch_add(1);
+    state.m_wakeup.wait(lock, [&state] {
+      return state.m_workflag.load() > 0 || !state.m_working.load();
+    });
+    state.m_sleeping.fetch_sub(1);
+    if (state.m_workflag.load() > 0)
+      state.m_workflag.fetch_sub(1);
   }
 }
 
-AsyncWorker& AsyncWorker::Getinstance()
+TaskScheduler& TaskScheduler::Getinstance()
 {
-  static AsyncWorker intance;
-  return intance;
+  static TaskScheduler instance;
+  return instance;
 }
 
-AsyncWorker::AsyncWorker() : m_inputsize(0), m_TaskQueue()
+TaskScheduler::TaskScheduler() : m_task_count(0)
 {
+  for (size_t i = 0; i <= ThreadPool::GetThreadCount(); i++)
+    m_queues.push_back(std::make_unique<TaskQueue>());
   ThreadPool::RegisterWorker(this);
 }
 
-AsyncWorker::~AsyncWorker()
+TaskScheduler::~TaskScheduler()
 {
   ThreadPool::UnregisterWorker(this);
 }
 
-bool AsyncWorker::NextTask(size_t ID)
+bool TaskScheduler::PopBack(TaskQueue& queue, size_t priority, std::function<void()>* task)
+{
+  std::lock_guard<std::mutex> guard(queue.lock);
+  if (queue.tasks[priority].empty())
+    return false;
+  *task = std::move(queue.tasks[priority].back());
+  queue.tasks[priority].pop_back();
+  return true;
+}
+
+bool TaskScheduler::PopFront(TaskQueue& queue, size_t priority, std::function<void()>* task)
+{
+  std::lock_guard<std::mutex> guard(queue.lock);
+  if (queue.tasks[priority].empty())
+    return false;
+  *task = std::move(queue.tasks[priority].front());
+  queue.tasks[priority].pop_front();
+  return true;
+}
+
+bool TaskScheduler::RunTask(size_t queue_index)
 {
-  if (m_inputsize.load() > 0)
+  if (m_task_count.load() <= 0)
+    return false;
+
+  const size_t shared_index = m_queues.size() - 1;
+  std::function<void()> task;
+  bool found = false;
+  for (size_t priority = 0; priority < PRIORITY_COUNT && !found; priority++)
+  {
+    // The newest task of our own deque is the most likely to still be in the cache
+    if (queue_index != shared_index)
+      found = PopBack(*m_queues[queue_index], priority, &task);
+    if (!found)
+      found = PopFront(*m_queues[shared_index], priority, &task);
+    // Steal the oldest task of another thread, starting with the next one to spread the load
+    for (size_t i = 1; i < shared_index && !found; i++)
+      found = PopFront(*m_queues[(queue_index + i) % shared_index], priority, &task);
+  }
+  if (!found)
+    return false;
+
+  m_task_count.fetch_sub(1);
+  task();
+  return true;
+}
+
+bool TaskScheduler::NextTask(size_t ID)
+{
+  return RunTask(ID);
+}
+
+void TaskScheduler::Run(std::function<void()> &&func, TaskPriority priority)
+{
+  TaskScheduler& instance = Getinstance();
+  const s32 worker_id = ThreadPool::GetCurrentThreadID();
+  const size_t queue_index = worker_id >= 0 ? worker_id : instance.m_queues.size() - 1;
+  TaskQueue& queue = *instance.m_queues[queue_index];
+  {
+    std::lock_guard<std::mutex> guard(queue.lock);
+    queue.tasks[static_cast<size_t>(priority)].push_back(std::move(func));
+  }
+  instance.m_task_count.fetch_add(1);
+  ThreadPool::NotifyWorkPending();
+}
+
+bool TaskScheduler::RunPendingTask()
+{
+  TaskScheduler& instance = Getinstance();
+  const s32 worker_id = ThreadPool::GetCurrentThreadID();
+  return instance.RunTask(worker_id >= 0 ? worker_id : instance.m_queues.size() - 1);
+}
+
+void TaskGroup::Run(std::function<void()> &&func, TaskPriority priority)
+{
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_pending++;
+  }
+  TaskScheduler::Run([this, func = std::move(func)] {
+    func();
+    // Notified under the lock, so that Wait can't return and destroy the group before this is
+    // done with it.
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (--m_pending == 0)
+      m_done.notify_all();
+  }, priority);
+}
+
+void TaskGroup::Wait()
+{
+  while (true)
   {
-    std::function<void()> func;
-    if (m_TaskQueue.try_pop(func))
     {
-      func();
-      m_inputsize.fetch_sub(1);
-      return true;
+      std::lock_guard<std::mutex> guard(m_lock);
+      if (m_pending == 0)
+        return;
     }
+    // Help with the queued tasks, ours might be among them
+    if (TaskScheduler::RunPendingTask())
+      continue;
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_done.wait_for(lock, std::chrono::milliseconds(1), [this] { return m_pending == 0; });
   }
-  return false;
 }
 
 void AsyncWorker::ExecuteAsync(std::function<void()> &&func)
 {
-  AsyncWorker& instance = Getinstance();
-  instance.m_inputsize.fetch_add(1);
-  instance.m_TaskQueue.push(std::move(func));
-  ThreadPool::NotifyWorkPending();
+  TaskScheduler::Run(std::move(func), TaskPriority::Low);
+}
+
+bool ParallelForWorker::RunChunk(Job& job)
+{
+  const s32 chunk = job.next_chunk.fetch_add(1);
+  if (chunk >= job.chunk_count)
+    return false;
+  const s32 chunk_begin = job.begin + chunk * job.chunk_size;
+  const s32 chunk_end = std::min(chunk_begin + job.chunk_size, job.end);
+  (*job.func)(chunk_begin, chunk_end);
+  job.pending_chunks.fetch_sub(1, std::memory_order_release);
+  return true;
 }
 
+void ParallelForWorker::Loop(s32 begin, s32 end, s32 min_chunk, const std::function<void(s32, s32)>& func)
+{
+  const s32 count = end - begin;
+  if (count <= 0)
+    return;
+  // A few chunks per thread so a slow one doesn't hold up the whole loop.
+  const s32 threads = static_cast<s32>(ThreadPool::GetThreadCount()) + 1;
+  const s32 max_chunks = std::max(count / std::max(min_chunk, 1), 1);
+  const s32 chunk_count = std::min(threads * 2, max_chunks);
+  if (chunk_count < 2)
+  {
+    func(begin, end);
+    return;
+  }
+
+  auto job = std::make_shared<Job>();
+  job->func = &func;
+  job->begin = begin;
+  job->end = end;
+  job->chunk_size = (count + chunk_count - 1) / chunk_count;
+  job->chunk_count = (count + job->chunk_size - 1) / job->chunk_size;
+  job->next_chunk.store(0);
+  job->pending_chunks.store(job->chunk_count);
 
+  // The helpers may only start after the loop is done. They keep the job alive, and they don't
+  // touch func once all chunks are taken.
+  const s32 helpers = std::min(job->chunk_count, threads) - 1;
+  for (s32 i = 0; i < helpers; i++)
+  {
+    TaskScheduler::Run([job] {
+      while (RunChunk(*job))
+      {
+      }
+    }, TaskPriority::High);
+  }
+  while (RunChunk(*job))
+  {
+  }
+
+  // Wait for the chunks still running on the workers.
+  size_t spins = 0;
+  while (job->pending_chunks.load(std::memory_order_acquire) > 0)
+    cYield(spins++);
+}
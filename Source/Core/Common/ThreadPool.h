@@ -32,6 +32,7 @@
 #pragma once
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -39,6 +40,7 @@
 #include <utility>
 #include <vector>
 
+#include "Common/Common.h"
 #include "Common/Thread.h"
 
 namespace Common
@@ -437,6 +439,8 @@ public:
   virtual bool NextTask(size_t ID) = 0;
 };
 
+// Worker threads scan the registered IWorkers for something to do, and sleep on a condition
+// variable once none of them has work left until NotifyWorkPending wakes one of them up.
 class ThreadPool
 {
 private:
@@ -444,7 +448,10 @@ private:
   std::vector<IWorker*> m_workers;
   std::atomic<s32> m_workflag;
   std::atomic<s32> m_workercount;
+  std::atomic<s32> m_sleeping;
   std::atomic<bool> m_working;
+  std::mutex m_sleepLock;
+  std::condition_variable m_wakeup;
   static std::mutex m_workerLock;
   static void Workloop(ThreadPool &state, size_t ID);
   static ThreadPool &Getinstance();
@@ -459,18 +466,92 @@ public:
   static inline size_t GetThreadCount() {
     return Getinstance().m_workerThreads.size();
   }
+  // The ID passed to IWorker::NextTask on pool threads, -1 on any other thread.
+  static s32 GetCurrentThreadID();
 };
 
-class AsyncWorker final : IWorker
+enum class TaskPriority
+{
+  High,
+  Normal,
+  Low,
+};
+
+// Work-stealing scheduler for independent tasks. Every pool thread has its own deque: tasks
+// started on a pool thread are pushed to its back and taken from there again, idle threads steal
+// from the front of the other deques. Tasks from other threads go through a shared deque.
+// Higher priority tasks are taken first from each deque.
+class TaskScheduler final : IWorker
 {
 private:
-  std::atomic<s32> m_inputsize;
-  ManyToManyQueue<std::function<void()>, OneToOneQueue<std::function<void()>>> m_TaskQueue;
-  static AsyncWorker &Getinstance();
-  AsyncWorker();
+  static constexpr size_t PRIORITY_COUNT = 3;
+  struct TaskQueue
+  {
+    std::mutex lock;
+    std::deque<std::function<void()>> tasks[PRIORITY_COUNT];
+  };
+  // One per pool thread, the last one is shared by all other threads.
+  std::vector<std::unique_ptr<TaskQueue>> m_queues;
+  std::atomic<s32> m_task_count;
+  static TaskScheduler &Getinstance();
+  static bool PopBack(TaskQueue& queue, size_t priority, std::function<void()>* task);
+  static bool PopFront(TaskQueue& queue, size_t priority, std::function<void()>* task);
+  bool RunTask(size_t queue_index);
+  TaskScheduler();
 public:
-  virtual ~AsyncWorker();
+  virtual ~TaskScheduler();
   bool NextTask(size_t ID) override;
+  static void Run(std::function<void()> &&func, TaskPriority priority = TaskPriority::Normal);
+  // Runs one queued task on the calling thread, returns false if there was none.
+  static bool RunPendingTask();
+};
+
+// A set of tasks that can be waited for together.
+class TaskGroup
+{
+private:
+  s32 m_pending = 0;
+  std::mutex m_lock;
+  std::condition_variable m_done;
+public:
+  TaskGroup() = default;
+  ~TaskGroup()
+  {
+    Wait();
+  }
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+  void Run(std::function<void()> &&func, TaskPriority priority = TaskPriority::Normal);
+  // Runs queued tasks on the calling thread until all tasks of the group are done.
+  void Wait();
+};
+
+// Runs fire-and-forget tasks at low priority on the TaskScheduler.
+class AsyncWorker final
+{
+public:
   static void ExecuteAsync(std::function<void()> &&func);
 };
+
+// Splits [begin, end) into chunks and runs func(chunk_begin, chunk_end) on the pool.
+// The calling thread works on chunks too and only returns once all of them are done.
+// Loops may be nested and run from several threads at once.
+class ParallelForWorker final
+{
+private:
+  struct Job
+  {
+    const std::function<void(s32, s32)>* func;
+    s32 begin;
+    s32 end;
+    s32 chunk_size;
+    s32 chunk_count;
+    std::atomic<s32> next_chunk;
+    std::atomic<s32> pending_chunks;
+  };
+  static bool RunChunk(Job& job);
+public:
+  // min_chunk is the smallest amount of items worth handing to another thread.
+  static void Loop(s32 begin, s32 end, s32 min_chunk, const std::function<void(s32, s32)>& func);
+};
 }
@@ -0,0 +1,162 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/TraceEvents.h"
+
+namespace Common
+{
+namespace Trace
+{
+std::atomic<bool> g_capturing{false};
+
+namespace
+{
+struct Event
+{
+  const char* name;
+  u64 start;
+  u64 end;
+};
+
+// Bounds a forgotten capture to a few hundred megabytes.
+constexpr size_t MAX_EVENTS_PER_THREAD = 1 << 22;
+
+// Every thread records into its own buffer. The lock is only contended while a capture is
+// written out.
+struct ThreadBuffer
+{
+  std::mutex lock;
+  std::vector<Event> events;
+  std::string name;
+  u32 id;
+};
+
+std::mutex s_buffers_lock;
+// Buffers outlive their thread, so events of threads that exited during the capture are kept.
+std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer* GetThreadBuffer()
+{
+  if (!t_buffer)
+  {
+    std::lock_guard<std::mutex> guard(s_buffers_lock);
+    s_buffers.push_back(std::make_unique<ThreadBuffer>());
+    t_buffer = s_buffers.back().get();
+    t_buffer->id = static_cast<u32>(s_buffers.size());
+  }
+  return t_buffer;
+}
+
+std::string EscapeJSON(const std::string& str)
+{
+  std::string result;
+  for (char c : str)
+  {
+    if (c == '"' || c == '\\')
+      result += '\\';
+    if (static_cast<unsigned char>(c) >= 0x20)
+      result += c;
+  }
+  return result;
+}
+}  // Anonymous namespace
+
+u64 GetTimestamp()
+{
+  return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch())
+                              .count());
+}
+
+void AddEvent(const char* name, u64 start, u64 end)
+{
+  ThreadBuffer* buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> guard(buffer->lock);
+  if (buffer->events.size() < MAX_EVENTS_PER_THREAD)
+    buffer->events.push_back({name, start, end});
+}
+
+void SetThreadName(const char* name)
+{
+  ThreadBuffer* buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> guard(buffer->lock);
+  buffer->name = name;
+}
+
+void Start()
+{
+  {
+    std::lock_guard<std::mutex> guard(s_buffers_lock);
+    for (auto& buffer : s_buffers)
+    {
+      std::lock_guard<std::mutex> buffer_guard(buffer->lock);
+      buffer->events.clear();
+    }
+  }
+  g_capturing.store(true, std::memory_order_relaxed);
+}
+
+bool Stop(const std::string& filename)
+{
+  if (!g_capturing.exchange(false, std::memory_order_relaxed))
+    return false;
+
+  File::CreateFullPath(filename);
+  std::ofstream file;
+  File::OpenFStream(file, filename, std::ios_base::out);
+  if (!file.is_open())
+    return false;
+
+  std::lock_guard<std::mutex> guard(s_buffers_lock);
+
+  // Events are stored in the order they end, an outer scope can start before the first one.
+  u64 base = std::numeric_limits<u64>::max();
+  for (auto& buffer : s_buffers)
+  {
+    std::lock_guard<std::mutex> buffer_guard(buffer->lock);
+    for (const Event& event : buffer->events)
+      base = std::min(base, event.start);
+  }
+
+  // Complete ("X") events in microseconds, plus one metadata event per thread for its name.
+  file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  for (auto& buffer : s_buffers)
+  {
+    std::lock_guard<std::mutex> buffer_guard(buffer->lock);
+    if (buffer->events.empty())
+      continue;
+
+    const std::string thread_name =
+        buffer->name.empty() ? StringFromFormat("Thread %u", buffer->id) : buffer->name;
+    file << (first ? "\n" : ",\n");
+    first = false;
+    file << StringFromFormat("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                             "\"args\":{\"name\":\"%s\"}}",
+                             buffer->id, EscapeJSON(thread_name).c_str());
+    for (const Event& event : buffer->events)
+    {
+      file << StringFromFormat(",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                               "\"ts\":%.3f,\"dur\":%.3f}",
+                               event.name, buffer->id, (event.start - base) / 1000.0,
+                               (event.end - event.start) / 1000.0);
+    }
+    buffer->events.clear();
+  }
+  file << "\n]}\n";
+  return file.good();
+}
+}  // namespace Trace
+}  // namespace Common
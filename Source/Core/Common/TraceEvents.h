@@ -0,0 +1,65 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Timeline of scoped events on every thread, written in the Chrome trace event format so it can
+// be opened in chrome://tracing or Perfetto. When no capture is running a TRACE_SCOPE costs a
+// relaxed load and a branch.
+namespace Common
+{
+namespace Trace
+{
+extern std::atomic<bool> g_capturing;
+
+inline bool IsCapturing()
+{
+  return g_capturing.load(std::memory_order_relaxed);
+}
+
+// Throws away what an earlier capture recorded.
+void Start();
+// Returns false if there was no capture or the file couldn't be written.
+bool Stop(const std::string& filename);
+
+// Called by SetCurrentThreadName, names the thread's track in the trace.
+void SetThreadName(const char* name);
+
+u64 GetTimestamp();
+// name has to outlive the capture, in practice it is a string literal.
+void AddEvent(const char* name, u64 start, u64 end);
+
+class ScopedEvent
+{
+public:
+  explicit ScopedEvent(const char* name) : m_name(IsCapturing() ? name : nullptr)
+  {
+    if (m_name)
+      m_start = GetTimestamp();
+  }
+  ~ScopedEvent()
+  {
+    if (m_name)
+      AddEvent(m_name, m_start, GetTimestamp());
+  }
+
+  ScopedEvent(const ScopedEvent&) = delete;
+  ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+private:
+  const char* m_name;
+  u64 m_start = 0;
+};
+}  // namespace Trace
+}  // namespace Common
+
+#define TRACE_SCOPE_CONCAT2(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT2(a, b)
+#define TRACE_SCOPE(name)                                                                          \
+  Common::Trace::ScopedEvent TRACE_SCOPE_CONCAT(trace_scope_, __LINE__)(name)
@@ -1,21 +1,41 @@
 // This file is public domain, in case it's useful to anyone. -comex
 
 // The central server implementation.
+//
+// The server can run as several shards ("traversal_server [shards]"), one thread each. On Linux
+// every shard binds its own socket to the port with SO_REUSEPORT, so the kernel keeps a given
+// client on one shard, and receives and sends packets in batches with recvmmsg/sendmmsg.
+//
+// A host ID belongs to the shard which handed it out (the ID modulo the shard count). Only that
+// shard writes its entry in the host table; the other shards look it up without locking. The same
+// goes for request IDs of the packets a shard sends, so acks and pings which land on a different
+// shard than the state they refer to are passed on to the owning shard.
+#include <algorithm>
 #include <arpa/inet.h>
+#include <atomic>
 #include <cerrno>
+#include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <memory>
+#include <mutex>
 #include <netinet/in.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <thread>
 #include <unistd.h>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
 #ifdef HAVE_LIBSYSTEMD
 #include <systemd/sd-daemon.h>
 #endif
@@ -25,99 +45,29 @@
 #define DEBUG 0
 #define NUMBER_OF_TRIES 5
 #define PORT 6262
+#define MAX_SHARDS 64
+// Packets moved per recvmmsg/sendmmsg call.
+#define BATCH_SIZE 64
+// Host table entries per shard; must be a power of two.
+#define HOST_TABLE_SIZE (1 << 16)
+#define METRICS_INTERVAL 10
 
-static u64 currentTime;
-
-struct OutgoingPacketInfo
-{
-  TraversalPacket packet;
-  TraversalRequestId misc;
-  sockaddr_in6 dest;
-  int tries;
-  u64 sendTime;
-};
-
-template <typename T>
-struct EvictEntry
-{
-  u64 updateTime;
-  T value;
-};
-
-template <typename V>
-struct EvictFindResult
-{
-  bool found;
-  V* value;
-};
-
-template <typename K, typename V>
-EvictFindResult<V> EvictFind(std::unordered_map<K, EvictEntry<V>>& map, const K& key,
-                             bool refresh = false)
-{
-retry:
-  const u64 expiryTime = 30 * 1000000;  // 30s
-  EvictFindResult<V> result;
-  if (map.bucket_count())
-  {
-    auto bucket = map.bucket(key);
-    auto it = map.begin(bucket);
-    for (; it != map.end(bucket); ++it)
-    {
-      if (currentTime - it->second.updateTime > expiryTime)
-      {
-        map.erase(it->first);
-        goto retry;
-      }
-      if (it->first == key)
-      {
-        if (refresh)
-          it->second.updateTime = currentTime;
-        result.found = true;
-        result.value = &it->second.value;
-        return result;
-      }
-    }
-  }
-#if DEBUG
-  printf("failed to find key '");
-  for (size_t i = 0; i < sizeof(key); i++)
-  {
-    printf("%02x", ((u8*)&key)[i]);
-  }
-  printf("'\n");
-#endif
-  result.found = false;
-  return result;
-}
+static const u64 expiryTime = 30 * 1000000;  // 30s
 
-template <typename K, typename V>
-V* EvictSet(std::unordered_map<K, EvictEntry<V>>& map, const K& key)
-{
-  // can't use a local_iterator to emplace...
-  auto& result = map[key];
-  result.updateTime = currentTime;
-  return &result.value;
-}
+static int urandomFd;
+static u32 numShards = 1;
 
-namespace std
+static u64 GetCurrentTime()
 {
-template <>
-struct hash<TraversalHostId>
-{
-  size_t operator()(const TraversalHostId& id) const
+  timeval tv;
+  if (gettimeofday(&tv, nullptr) < 0)
   {
-    auto p = (u32*)id.data();
-    return p[0] ^ ((p[1] << 13) | (p[1] >> 19));
+    perror("gettimeofday");
+    exit(1);
   }
-};
+  return (u64)tv.tv_sec * 1000000 + tv.tv_usec;
 }
 
-static int sock;
-static int urandomFd;
-static std::unordered_map<TraversalRequestId, OutgoingPacketInfo> outgoingPackets;
-static std::unordered_map<TraversalHostId, EvictEntry<TraversalInetAddress>> connectedClients;
-
 static TraversalInetAddress MakeInetAddress(const sockaddr_in6& addr)
 {
   if (addr.sin6_family != AF_INET6)
@@ -166,302 +116,783 @@ static sockaddr_in6 MakeSinAddr(const TraversalInetAddress& addr)
   return result;
 }
 
-static void GetRandomBytes(void* output, size_t size)
-{
-  static u8 bytes[8192];
-  static size_t bytesLeft = 0;
-  if (bytesLeft < size)
-  {
-    ssize_t rv = read(urandomFd, bytes, sizeof(bytes));
-    if (rv != sizeof(bytes))
-    {
-      perror("read from /dev/urandom");
-      exit(1);
-    }
-    bytesLeft = sizeof(bytes);
-  }
-  memcpy(output, bytes + (bytesLeft -= size), size);
-}
-
-static void GetRandomHostId(TraversalHostId* hostId)
-{
-  char buf[9];
-  u32 num;
-  GetRandomBytes(&num, sizeof(num));
-  sprintf(buf, "%08x", num);
-  memcpy(hostId->data(), buf, 8);
-}
-
 static const char* SenderName(sockaddr_in6* addr)
 {
-  static char buf[INET6_ADDRSTRLEN + 10];
+  static thread_local char buf[INET6_ADDRSTRLEN + 10];
   inet_ntop(PF_INET6, &addr->sin6_addr, buf, sizeof(buf));
   sprintf(buf + strlen(buf), ":%d", ntohs(addr->sin6_port));
   return buf;
 }
 
-static void TrySend(const void* buffer, size_t size, sockaddr_in6* addr)
+// Host IDs are eight hex digits; returns false for anything else.
+static bool ParseHostId(const TraversalHostId& hostId, u32* num)
 {
-#if DEBUG
-  printf("-> %d %llu %s\n", ((TraversalPacket*)buffer)->type,
-         (long long)((TraversalPacket*)buffer)->requestId, SenderName(addr));
-#endif
-  if ((size_t)sendto(sock, buffer, size, 0, (sockaddr*)addr, sizeof(*addr)) != size)
+  u32 result = 0;
+  for (char c : hostId)
   {
-    perror("sendto");
+    u32 digit;
+    if (c >= '0' && c <= '9')
+      digit = c - '0';
+    else if (c >= 'a' && c <= 'f')
+      digit = c - 'a' + 10;
+    else
+      return false;
+    result = (result << 4) | digit;
   }
+  *num = result;
+  return true;
 }
 
-static TraversalPacket* AllocPacket(const sockaddr_in6& dest, TraversalRequestId misc = 0)
+// An open addressing table of host ID -> address, written only by the owning shard and read by
+// all of them. Each slot is guarded by a sequence counter which is odd while the writer updates
+// it; readers retry until they see the same even value before and after copying the slot.
+// Entries are never removed, only left to expire, so probe chains stay intact and an expired slot
+// can be reused by a new host ID.
+class HostTable
 {
-  TraversalRequestId requestId;
-  GetRandomBytes(&requestId, sizeof(requestId));
-  OutgoingPacketInfo* info = &outgoingPackets[requestId];
-  info->dest = dest;
-  info->misc = misc;
-  info->tries = 0;
-  info->sendTime = currentTime;
-  TraversalPacket* result = &info->packet;
-  memset(result, 0, sizeof(*result));
-  result->requestId = requestId;
-  return result;
-}
+public:
+  void Set(u32 num, const TraversalInetAddress& addr, u64 now)
+  {
+    u32 words[ADDRESS_WORDS] = {};
+    memcpy(words, &addr, sizeof(addr));
+    Slot& slot = m_slots[FindFreeSlot(num, now)];
+    u32 seq = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.key.store((u64)num + 1, std::memory_order_relaxed);
+    for (int i = 0; i < ADDRESS_WORDS; i++)
+      slot.address[i].store(words[i], std::memory_order_relaxed);
+    slot.updateTime.store(now, std::memory_order_relaxed);
+    slot.sequence.store(seq + 2, std::memory_order_release);
+  }
 
-static void SendPacket(OutgoingPacketInfo* info)
-{
-  info->tries++;
-  info->sendTime = currentTime;
-  TrySend(&info->packet, sizeof(info->packet), &info->dest);
-}
+  // Only called by the owning shard, so no sequence is needed; a reader racing with this sees
+  // either the old or the new time, both of which are fine.
+  bool Refresh(u32 num, u64 now)
+  {
+    Slot* slot = FindSlot(num, now);
+    if (!slot)
+      return false;
+    slot->updateTime.store(now, std::memory_order_relaxed);
+    return true;
+  }
 
-static void ResendPackets()
-{
-  std::vector<std::pair<TraversalInetAddress, TraversalRequestId>> todoFailures;
-  todoFailures.clear();
-  for (auto it = outgoingPackets.begin(); it != outgoingPackets.end();)
+  bool Get(u32 num, u64 now, TraversalInetAddress* addr) const
   {
-    OutgoingPacketInfo* info = &it->second;
-    if (currentTime - info->sendTime >= (u64)(300000 * info->tries))
+    u32 index = Hash(num);
+    for (u32 probe = 0; probe < HOST_TABLE_SIZE; probe++, index = (index + 1) & MASK)
     {
-      if (info->tries >= NUMBER_OF_TRIES)
+      const Slot& slot = m_slots[index];
+      u32 words[ADDRESS_WORDS];
+      u64 key, updateTime;
+      u32 seq;
+      do
       {
-        if (info->packet.type == TraversalPacketPleaseSendPacket)
-        {
-          todoFailures.push_back(std::make_pair(info->packet.pleaseSendPacket.address, info->misc));
-        }
-        it = outgoingPackets.erase(it);
-        continue;
+        seq = slot.sequence.load(std::memory_order_acquire);
+        key = slot.key.load(std::memory_order_relaxed);
+        for (int i = 0; i < ADDRESS_WORDS; i++)
+          words[i] = slot.address[i].load(std::memory_order_relaxed);
+        updateTime = slot.updateTime.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+      } while ((seq & 1) || slot.sequence.load(std::memory_order_relaxed) != seq);
+
+      if (key == 0)
+        return false;
+      if (key == (u64)num + 1)
+      {
+        // Another shard's clock may be slightly behind ours.
+        if (now > updateTime && now - updateTime > expiryTime)
+          return false;
+        memcpy(addr, words, sizeof(*addr));
+        return true;
       }
-      else
+    }
+    return false;
+  }
+
+  bool Contains(u32 num, u64 now) { return FindSlot(num, now) != nullptr; }
+  bool IsFull(u64 now) { return FindFreeSlot(0, now) == HOST_TABLE_SIZE; }
+
+private:
+  static const int ADDRESS_WORDS = (sizeof(TraversalInetAddress) + 3) / 4;
+  static const u32 MASK = HOST_TABLE_SIZE - 1;
+
+  struct Slot
+  {
+    std::atomic<u32> sequence{0};
+    // Host ID number + 1, 0 for a slot which was never used.
+    std::atomic<u64> key{0};
+    std::atomic<u64> updateTime{0};
+    std::atomic<u32> address[ADDRESS_WORDS] = {};
+  };
+
+  static u32 Hash(u32 num) { return ((num / numShards) * 2654435761u) & MASK; }
+
+  // Writer side only.
+  Slot* FindSlot(u32 num, u64 now)
+  {
+    u32 index = Hash(num);
+    for (u32 probe = 0; probe < HOST_TABLE_SIZE; probe++, index = (index + 1) & MASK)
+    {
+      Slot& slot = m_slots[index];
+      u64 key = slot.key.load(std::memory_order_relaxed);
+      if (key == 0)
+        return nullptr;
+      if (key == (u64)num + 1)
       {
-        SendPacket(info);
+        if (now - slot.updateTime.load(std::memory_order_relaxed) > expiryTime)
+          return nullptr;
+        return &slot;
       }
     }
-    ++it;
+    return nullptr;
   }
 
-  for (const auto& p : todoFailures)
+  u32 FindFreeSlot(u32 num, u64 now)
   {
-    TraversalPacket* fail = AllocPacket(MakeSinAddr(p.first));
-    fail->type = TraversalPacketConnectFailed;
-    fail->connectFailed.requestId = p.second;
-    fail->connectFailed.reason = TraversalConnectFailedClientDidntRespond;
+    u32 index = Hash(num);
+    for (u32 probe = 0; probe < HOST_TABLE_SIZE; probe++, index = (index + 1) & MASK)
+    {
+      Slot& slot = m_slots[index];
+      if (slot.key.load(std::memory_order_relaxed) == 0 ||
+          now - slot.updateTime.load(std::memory_order_relaxed) > expiryTime)
+      {
+        return index;
+      }
+    }
+    return HOST_TABLE_SIZE;
   }
-}
 
-static void HandlePacket(TraversalPacket* packet, sockaddr_in6* addr)
+  std::unique_ptr<Slot[]> m_slots{new Slot[HOST_TABLE_SIZE]};
+};
+
+struct OutgoingPacketInfo
 {
-#if DEBUG
-  printf("<- %d %llu %s\n", packet->type, (long long)packet->requestId, SenderName(addr));
+  TraversalPacket packet;
+  TraversalRequestId misc;
+  sockaddr_in6 dest;
+  int tries;
+  u64 sendTime;
+  // When the ConnectPlease which caused this packet arrived, for the latency metrics.
+  u64 connectStart;
+};
+
+struct ReceivedPacket
+{
+  TraversalPacket packet;
+  sockaddr_in6 addr;
+};
+
+struct ShardMetrics
+{
+  std::atomic<u64> packetsIn{0};
+  std::atomic<u64> packetsOut{0};
+  std::atomic<u64> connects{0};
+  std::atomic<u64> connectsFailed{0};
+  std::atomic<u64> connectLatencyTotal{0};
+  std::atomic<u64> connectLatencyMax{0};
+};
+
+class Shard;
+static std::vector<std::unique_ptr<Shard>> shards;
+
+class Shard
+{
+public:
+  explicit Shard(u32 index) : m_index(index) {}
+
+  bool Open(bool reusePort)
+  {
+    m_sock = socket(PF_INET6, SOCK_DGRAM, 0);
+    if (m_sock == -1)
+    {
+      perror("socket");
+      return false;
+    }
+    int no = 0;
+    int rv = setsockopt(m_sock, IPPROTO_IPV6, IPV6_V6ONLY, &no, sizeof(no));
+    if (rv < 0)
+    {
+      perror("setsockopt IPV6_V6ONLY");
+      return false;
+    }
+#ifdef SO_REUSEPORT
+    if (reusePort)
+    {
+      int yes = 1;
+      rv = setsockopt(m_sock, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes));
+      if (rv < 0)
+      {
+        perror("setsockopt SO_REUSEPORT");
+        return false;
+      }
+    }
+#endif
+    in6_addr any = IN6ADDR_ANY_INIT;
+    sockaddr_in6 addr;
+#ifdef SIN6_LEN
+    addr.sin6_len = sizeof(addr);
 #endif
-  bool packetOk = true;
-  switch (packet->type)
+    addr.sin6_family = AF_INET6;
+    addr.sin6_port = htons(PORT);
+    addr.sin6_flowinfo = 0;
+    addr.sin6_addr = any;
+    addr.sin6_scope_id = 0;
+
+    rv = bind(m_sock, (sockaddr*)&addr, sizeof(addr));
+    if (rv < 0)
+    {
+      perror("bind");
+      return false;
+    }
+
+#ifdef __linux__
+    m_wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (m_wakeFd < 0)
+    {
+      perror("eventfd");
+      return false;
+    }
+#else
+    timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = 300000;
+    rv = setsockopt(m_sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (rv < 0)
+    {
+      perror("setsockopt SO_RCVTIMEO");
+      return false;
+    }
+#endif
+    return true;
+  }
+
+  void Run()
   {
-  case TraversalPacketAck:
+    while (true)
+    {
+      Receive();
+      m_currentTime = GetCurrentTime();
+      m_heartbeat.store(m_currentTime, std::memory_order_relaxed);
+      for (auto& received : m_received)
+        HandlePacket(&received.packet, &received.addr);
+      m_received.clear();
+
+      {
+        std::lock_guard<std::mutex> lk(m_inboxLock);
+        std::swap(m_inbox, m_forwarded);
+      }
+      for (auto& forwarded : m_forwarded)
+        HandlePacket(&forwarded.packet, &forwarded.addr);
+      m_forwarded.clear();
+
+      ResendPackets();
+      FlushSends();
+    }
+  }
+
+  // Called from other shards.
+  void Forward(const TraversalPacket& packet, const sockaddr_in6& addr)
   {
-    auto it = outgoingPackets.find(packet->requestId);
-    if (it == outgoingPackets.end())
-      break;
+    {
+      std::lock_guard<std::mutex> lk(m_inboxLock);
+      m_inbox.push_back({packet, addr});
+    }
+#ifdef __linux__
+    u64 one = 1;
+    if (write(m_wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+      perror("write eventfd");
+#endif
+  }
 
-    OutgoingPacketInfo* info = &it->second;
+  const HostTable& GetHostTable() const { return m_hosts; }
+  ShardMetrics& GetMetrics() { return m_metrics; }
+  u64 GetHeartbeat() const { return m_heartbeat.load(std::memory_order_relaxed); }
 
-    if (info->packet.type == TraversalPacketPleaseSendPacket)
+private:
+  void Receive()
+  {
+#ifdef __linux__
+    pollfd fds[2] = {{m_sock, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+    int rv = poll(fds, 2, 300);
+    if (rv < 0)
     {
-      TraversalPacket* ready = AllocPacket(MakeSinAddr(info->packet.pleaseSendPacket.address));
-      if (packet->ack.ok)
+      if (errno != EINTR)
       {
-        ready->type = TraversalPacketConnectReady;
-        ready->connectReady.requestId = info->misc;
-        ready->connectReady.address = MakeInetAddress(info->dest);
+        perror("poll");
+        exit(1);
       }
+      return;
+    }
+    if (fds[1].revents & POLLIN)
+    {
+      u64 count;
+      if (read(m_wakeFd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+        perror("read eventfd");
+    }
+    if (!(fds[0].revents & POLLIN))
+      return;
+
+    ReceivedPacket packets[BATCH_SIZE];
+    mmsghdr msgs[BATCH_SIZE];
+    iovec iovs[BATCH_SIZE];
+    for (int i = 0; i < BATCH_SIZE; i++)
+    {
+      iovs[i].iov_base = &packets[i].packet;
+      iovs[i].iov_len = sizeof(packets[i].packet);
+      memset(&msgs[i], 0, sizeof(msgs[i]));
+      msgs[i].msg_hdr.msg_name = &packets[i].addr;
+      msgs[i].msg_hdr.msg_namelen = sizeof(packets[i].addr);
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    rv = recvmmsg(m_sock, msgs, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    if (rv < 0)
+    {
+      if (errno != EINTR && errno != EAGAIN)
+      {
+        perror("recvmmsg");
+        exit(1);
+      }
+      return;
+    }
+    m_metrics.packetsIn.fetch_add(rv, std::memory_order_relaxed);
+    for (int i = 0; i < rv; i++)
+    {
+      if (msgs[i].msg_len < sizeof(TraversalPacket))
+        fprintf(stderr, "received short packet from %s\n", SenderName(&packets[i].addr));
       else
+        m_received.push_back(packets[i]);
+    }
+#else
+    ReceivedPacket received;
+    socklen_t addrLen = sizeof(received.addr);
+    int rv = recvfrom(m_sock, &received.packet, sizeof(received.packet), 0,
+                      (sockaddr*)&received.addr, &addrLen);
+    if (rv < 0)
+    {
+      if (errno != EINTR && errno != EAGAIN)
+      {
+        perror("recvfrom");
+        exit(1);
+      }
+      return;
+    }
+    m_metrics.packetsIn.fetch_add(1, std::memory_order_relaxed);
+    if ((size_t)rv < sizeof(received.packet))
+      fprintf(stderr, "received short packet from %s\n", SenderName(&received.addr));
+    else
+      m_received.push_back(received);
+#endif
+  }
+
+  void TrySend(const void* buffer, size_t size, sockaddr_in6* addr)
+  {
+#if DEBUG
+    printf("-> %d %llu %s\n", ((TraversalPacket*)buffer)->type,
+           (long long)((TraversalPacket*)buffer)->requestId, SenderName(addr));
+#endif
+    ReceivedPacket outgoing;
+    memcpy(&outgoing.packet, buffer, std::min(size, sizeof(outgoing.packet)));
+    outgoing.addr = *addr;
+    m_sends.push_back(outgoing);
+    if (m_sends.size() >= BATCH_SIZE)
+      FlushSends();
+  }
+
+  void FlushSends()
+  {
+    if (m_sends.empty())
+      return;
+    m_metrics.packetsOut.fetch_add(m_sends.size(), std::memory_order_relaxed);
+#ifdef __linux__
+    mmsghdr msgs[BATCH_SIZE];
+    iovec iovs[BATCH_SIZE];
+    size_t count = m_sends.size();
+    for (size_t i = 0; i < count; i++)
+    {
+      iovs[i].iov_base = &m_sends[i].packet;
+      iovs[i].iov_len = sizeof(m_sends[i].packet);
+      memset(&msgs[i], 0, sizeof(msgs[i]));
+      msgs[i].msg_hdr.msg_name = &m_sends[i].addr;
+      msgs[i].msg_hdr.msg_namelen = sizeof(m_sends[i].addr);
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    size_t sent = 0;
+    while (sent < count)
+    {
+      int rv = sendmmsg(m_sock, msgs + sent, count - sent, 0);
+      if (rv < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        perror("sendmmsg");
+        // Skip the packet that failed, like a failed sendto would.
+        sent++;
+        continue;
+      }
+      sent += rv;
+    }
+#else
+    for (auto& outgoing : m_sends)
+    {
+      if ((size_t)sendto(m_sock, &outgoing.packet, sizeof(outgoing.packet), 0,
+                         (sockaddr*)&outgoing.addr, sizeof(outgoing.addr)) != sizeof(outgoing.packet))
+      {
+        perror("sendto");
+      }
+    }
+#endif
+    m_sends.clear();
+  }
+
+  void GetRandomBytes(void* output, size_t size)
+  {
+    if (m_randomBytesLeft < size)
+    {
+      ssize_t rv = read(urandomFd, m_randomBytes, sizeof(m_randomBytes));
+      if (rv != sizeof(m_randomBytes))
       {
-        ready->type = TraversalPacketConnectFailed;
-        ready->connectFailed.requestId = info->misc;
-        ready->connectFailed.reason = TraversalConnectFailedClientFailure;
+        perror("read from /dev/urandom");
+        exit(1);
       }
+      m_randomBytesLeft = sizeof(m_randomBytes);
     }
+    memcpy(output, m_randomBytes + (m_randomBytesLeft -= size), size);
+  }
 
-    outgoingPackets.erase(it);
-    break;
+  // The low part of a host ID names the shard which owns it.
+  u32 GetRandomHostId(TraversalHostId* hostId)
+  {
+    char buf[9];
+    u32 num;
+    GetRandomBytes(&num, sizeof(num));
+    num = (num % (0xffffffff / numShards)) * numShards + m_index;
+    sprintf(buf, "%08x", num);
+    memcpy(hostId->data(), buf, 8);
+    return num;
   }
-  case TraversalPacketPing:
+
+  TraversalPacket* AllocPacket(const sockaddr_in6& dest, TraversalRequestId misc = 0)
   {
-    auto r = EvictFind(connectedClients, packet->ping.hostId, true);
-    packetOk = r.found;
-    break;
+    TraversalRequestId requestId;
+    GetRandomBytes(&requestId, sizeof(requestId));
+    // Acks for this packet may arrive on any shard; they find us by the request ID.
+    requestId = (requestId % (UINT64_MAX / numShards)) * numShards + m_index;
+    OutgoingPacketInfo* info = &m_outgoingPackets[requestId];
+    info->dest = dest;
+    info->misc = misc;
+    info->tries = 0;
+    info->sendTime = m_currentTime;
+    info->connectStart = 0;
+    TraversalPacket* result = &info->packet;
+    memset(result, 0, sizeof(*result));
+    result->requestId = requestId;
+    return result;
   }
-  case TraversalPacketHelloFromClient:
+
+  void SendPacket(OutgoingPacketInfo* info)
   {
-    u8 ok = packet->helloFromClient.protoVersion <= TraversalProtoVersion;
-    TraversalPacket* reply = AllocPacket(*addr);
-    reply->type = TraversalPacketHelloFromServer;
-    reply->helloFromServer.ok = ok;
+    info->tries++;
+    info->sendTime = m_currentTime;
+    TrySend(&info->packet, sizeof(info->packet), &info->dest);
+  }
+
+  void RecordConnect(u64 start, bool ok)
+  {
+    u64 latency = m_currentTime - start;
     if (ok)
+      m_metrics.connects.fetch_add(1, std::memory_order_relaxed);
+    else
+      m_metrics.connectsFailed.fetch_add(1, std::memory_order_relaxed);
+    m_metrics.connectLatencyTotal.fetch_add(latency, std::memory_order_relaxed);
+    u64 max = m_metrics.connectLatencyMax.load(std::memory_order_relaxed);
+    while (latency > max && !m_metrics.connectLatencyMax.compare_exchange_weak(
+                                max, latency, std::memory_order_relaxed))
     {
-      TraversalHostId hostId;
-      TraversalInetAddress* iaddr;
-      // not that there is any significant change of
-      // duplication, but...
-      GetRandomHostId(&hostId);
-      while (true)
+    }
+  }
+
+  void ResendPackets()
+  {
+    std::vector<std::pair<TraversalInetAddress, TraversalRequestId>> todoFailures;
+    for (auto it = m_outgoingPackets.begin(); it != m_outgoingPackets.end();)
+    {
+      OutgoingPacketInfo* info = &it->second;
+      if (m_currentTime - info->sendTime >= (u64)(300000 * info->tries))
       {
-        auto r = EvictFind(connectedClients, hostId);
-        if (!r.found)
+        if (info->tries >= NUMBER_OF_TRIES)
+        {
+          if (info->packet.type == TraversalPacketPleaseSendPacket)
+          {
+            todoFailures.push_back(
+                std::make_pair(info->packet.pleaseSendPacket.address, info->misc));
+            RecordConnect(info->connectStart, false);
+          }
+          it = m_outgoingPackets.erase(it);
+          continue;
+        }
+        else
         {
-          iaddr = EvictSet(connectedClients, hostId);
-          break;
+          SendPacket(info);
         }
       }
+      ++it;
+    }
 
-      *iaddr = MakeInetAddress(*addr);
-
-      reply->helloFromServer.yourAddress = *iaddr;
-      reply->helloFromServer.yourHostId = hostId;
+    for (const auto& p : todoFailures)
+    {
+      TraversalPacket* fail = AllocPacket(MakeSinAddr(p.first));
+      fail->type = TraversalPacketConnectFailed;
+      fail->connectFailed.requestId = p.second;
+      fail->connectFailed.reason = TraversalConnectFailedClientDidntRespond;
     }
-    break;
   }
-  case TraversalPacketConnectPlease:
+
+  // Returns the shard whose state the packet refers to, or nullptr if it's ours.
+  Shard* GetOwner(const TraversalPacket* packet)
   {
-    TraversalHostId& hostId = packet->connectPlease.hostId;
-    auto r = EvictFind(connectedClients, hostId);
-    if (!r.found)
+    u32 owner = m_index;
+    if (packet->type == TraversalPacketAck)
     {
-      TraversalPacket* reply = AllocPacket(*addr);
-      reply->type = TraversalPacketConnectFailed;
-      reply->connectFailed.requestId = packet->requestId;
-      reply->connectFailed.reason = TraversalConnectFailedNoSuchClient;
+      owner = packet->requestId % numShards;
     }
-    else
+    else if (packet->type == TraversalPacketPing)
     {
-      TraversalPacket* please = AllocPacket(MakeSinAddr(*r.value), packet->requestId);
-      please->type = TraversalPacketPleaseSendPacket;
-      please->pleaseSendPacket.address = MakeInetAddress(*addr);
+      u32 num;
+      if (ParseHostId(packet->ping.hostId, &num))
+        owner = num % numShards;
     }
-    break;
+    return owner == m_index ? nullptr : shards[owner].get();
   }
-  default:
-    fprintf(stderr, "received unknown packet type %d from %s\n", packet->type, SenderName(addr));
-  }
-  if (packet->type != TraversalPacketAck)
+
+  void HandlePacket(TraversalPacket* packet, sockaddr_in6* addr)
   {
-    TraversalPacket ack = {};
-    ack.type = TraversalPacketAck;
-    ack.requestId = packet->requestId;
-    ack.ack.ok = packetOk;
-    TrySend(&ack, sizeof(ack), addr);
+#if DEBUG
+    printf("<- %d %llu %s\n", packet->type, (long long)packet->requestId, SenderName(addr));
+#endif
+    if (Shard* owner = GetOwner(packet))
+    {
+      owner->Forward(*packet, *addr);
+      return;
+    }
+
+    bool packetOk = true;
+    switch (packet->type)
+    {
+    case TraversalPacketAck:
+    {
+      auto it = m_outgoingPackets.find(packet->requestId);
+      if (it == m_outgoingPackets.end())
+        break;
+
+      OutgoingPacketInfo* info = &it->second;
+
+      if (info->packet.type == TraversalPacketPleaseSendPacket)
+      {
+        // Copy out what we need; AllocPacket may rehash the map.
+        TraversalInetAddress requester = info->packet.pleaseSendPacket.address;
+        TraversalRequestId misc = info->misc;
+        sockaddr_in6 dest = info->dest;
+        RecordConnect(info->connectStart, packet->ack.ok);
+        m_outgoingPackets.erase(it);
+
+        TraversalPacket* ready = AllocPacket(MakeSinAddr(requester));
+        if (packet->ack.ok)
+        {
+          ready->type = TraversalPacketConnectReady;
+          ready->connectReady.requestId = misc;
+          ready->connectReady.address = MakeInetAddress(dest);
+        }
+        else
+        {
+          ready->type = TraversalPacketConnectFailed;
+          ready->connectFailed.requestId = misc;
+          ready->connectFailed.reason = TraversalConnectFailedClientFailure;
+        }
+        break;
+      }
+
+      m_outgoingPackets.erase(it);
+      break;
+    }
+    case TraversalPacketPing:
+    {
+      u32 num;
+      packetOk = ParseHostId(packet->ping.hostId, &num) && m_hosts.Refresh(num, m_currentTime);
+      break;
+    }
+    case TraversalPacketHelloFromClient:
+    {
+      u8 ok = packet->helloFromClient.protoVersion <= TraversalProtoVersion &&
+              !m_hosts.IsFull(m_currentTime);
+      TraversalPacket* reply = AllocPacket(*addr);
+      reply->type = TraversalPacketHelloFromServer;
+      reply->helloFromServer.ok = ok;
+      if (ok)
+      {
+        TraversalHostId hostId;
+        // not that there is any significant change of
+        // duplication, but...
+        u32 num;
+        do
+        {
+          num = GetRandomHostId(&hostId);
+        } while (m_hosts.Contains(num, m_currentTime));
+
+        TraversalInetAddress iaddr = MakeInetAddress(*addr);
+        m_hosts.Set(num, iaddr, m_currentTime);
+
+        reply->helloFromServer.yourAddress = iaddr;
+        reply->helloFromServer.yourHostId = hostId;
+      }
+      break;
+    }
+    case TraversalPacketConnectPlease:
+    {
+      TraversalHostId& hostId = packet->connectPlease.hostId;
+      TraversalInetAddress hostAddr;
+      u32 num;
+      if (!ParseHostId(hostId, &num) ||
+          !shards[num % numShards]->GetHostTable().Get(num, m_currentTime, &hostAddr))
+      {
+        TraversalPacket* reply = AllocPacket(*addr);
+        reply->type = TraversalPacketConnectFailed;
+        reply->connectFailed.requestId = packet->requestId;
+        reply->connectFailed.reason = TraversalConnectFailedNoSuchClient;
+      }
+      else
+      {
+        TraversalPacket* please = AllocPacket(MakeSinAddr(hostAddr), packet->requestId);
+        please->type = TraversalPacketPleaseSendPacket;
+        please->pleaseSendPacket.address = MakeInetAddress(*addr);
+        m_outgoingPackets[please->requestId].connectStart = m_currentTime;
+      }
+      break;
+    }
+    default:
+      fprintf(stderr, "received unknown packet type %d from %s\n", packet->type, SenderName(addr));
+    }
+    if (packet->type != TraversalPacketAck)
+    {
+      TraversalPacket ack = {};
+      ack.type = TraversalPacketAck;
+      ack.requestId = packet->requestId;
+      ack.ack.ok = packetOk;
+      TrySend(&ack, sizeof(ack), addr);
+    }
   }
-}
 
-int main()
-{
-  int rv;
+  u32 m_index;
+  int m_sock = -1;
+  int m_wakeFd = -1;
+  u64 m_currentTime = 0;
+  u8 m_randomBytes[8192];
+  size_t m_randomBytesLeft = 0;
+  std::unordered_map<TraversalRequestId, OutgoingPacketInfo> m_outgoingPackets;
+  HostTable m_hosts;
+  std::vector<ReceivedPacket> m_received;
+  std::vector<ReceivedPacket> m_sends;
+  std::vector<ReceivedPacket> m_forwarded;
+  std::mutex m_inboxLock;
+  std::vector<ReceivedPacket> m_inbox;
+  ShardMetrics m_metrics;
+  std::atomic<u64> m_heartbeat{0};
+};
 
-  urandomFd = open("/dev/urandom", O_RDONLY);
-  if (urandomFd < 0)
+static void PrintMetrics(double seconds)
+{
+  u64 packetsIn = 0, packetsOut = 0, connects = 0, connectsFailed = 0;
+  u64 latencyTotal = 0, latencyMax = 0;
+  for (auto& shard : shards)
   {
-    perror("open /dev/urandom");
-    return 1;
+    ShardMetrics& metrics = shard->GetMetrics();
+    packetsIn += metrics.packetsIn.exchange(0, std::memory_order_relaxed);
+    packetsOut += metrics.packetsOut.exchange(0, std::memory_order_relaxed);
+    connects += metrics.connects.exchange(0, std::memory_order_relaxed);
+    connectsFailed += metrics.connectsFailed.exchange(0, std::memory_order_relaxed);
+    latencyTotal += metrics.connectLatencyTotal.exchange(0, std::memory_order_relaxed);
+    latencyMax = std::max(latencyMax, metrics.connectLatencyMax.exchange(0, std::memory_order_relaxed));
   }
+  u64 connectsTotal = connects + connectsFailed;
+  double latencyAvg = connectsTotal ? (double)latencyTotal / connectsTotal / 1000 : 0;
+  printf("%.0f packets/s in, %.0f packets/s out, %" PRIu64 " connects (%" PRIu64
+         " failed), connect latency avg %.1f ms, max %.1f ms\n",
+         packetsIn / seconds, packetsOut / seconds, connects, connectsFailed, latencyAvg,
+         latencyMax / 1000.0);
+  fflush(stdout);
+#ifdef HAVE_LIBSYSTEMD
+  sd_notifyf(0, "STATUS=Listening on port %d with %u shards, %.0f packets/s", PORT, numShards,
+             (packetsIn + packetsOut) / seconds);
+#endif
+}
 
-  sock = socket(PF_INET6, SOCK_DGRAM, 0);
-  if (sock == -1)
+int main(int argc, char** argv)
+{
+  if (argc > 1)
   {
-    perror("socket");
-    return 1;
+    int requested = atoi(argv[1]);
+    if (requested < 1 || requested > MAX_SHARDS)
+    {
+      fprintf(stderr, "usage: %s [shards (1-%d)]\n", argv[0], MAX_SHARDS);
+      return 1;
+    }
+    numShards = requested;
   }
-  int no = 0;
-  rv = setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, &no, sizeof(no));
-  if (rv < 0)
+#ifndef __linux__
+  if (numShards > 1)
   {
-    perror("setsockopt IPV6_V6ONLY");
-    return 1;
+    fprintf(stderr, "sharding needs SO_REUSEPORT load balancing; using one shard\n");
+    numShards = 1;
   }
-  in6_addr any = IN6ADDR_ANY_INIT;
-  sockaddr_in6 addr;
-#ifdef SIN6_LEN
-  addr.sin6_len = sizeof(addr);
 #endif
-  addr.sin6_family = AF_INET6;
-  addr.sin6_port = htons(PORT);
-  addr.sin6_flowinfo = 0;
-  addr.sin6_addr = any;
-  addr.sin6_scope_id = 0;
 
-  rv = bind(sock, (sockaddr*)&addr, sizeof(addr));
-  if (rv < 0)
+  urandomFd = open("/dev/urandom", O_RDONLY);
+  if (urandomFd < 0)
   {
-    perror("bind");
+    perror("open /dev/urandom");
     return 1;
   }
 
-  timeval tv;
-  tv.tv_sec = 0;
-  tv.tv_usec = 300000;
-  rv = setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-  if (rv < 0)
+  for (u32 i = 0; i < numShards; i++)
   {
-    perror("setsockopt SO_RCVTIMEO");
-    return 1;
+    shards.push_back(std::make_unique<Shard>(i));
+    if (!shards.back()->Open(numShards > 1))
+      return 1;
   }
 
 #ifdef HAVE_LIBSYSTEMD
   sd_notifyf(0, "READY=1\nSTATUS=Listening on port %d", PORT);
 #endif
 
+  for (auto& shard : shards)
+  {
+    Shard* s = shard.get();
+    std::thread([s] { s->Run(); }).detach();
+  }
+
+  u64 lastMetrics = GetCurrentTime();
   while (true)
   {
-    sockaddr_in6 raddr;
-    socklen_t addrLen = sizeof(raddr);
-    TraversalPacket packet;
-    // note: switch to recvmmsg (yes, mmsg) if this becomes
-    // expensive
-    rv = recvfrom(sock, &packet, sizeof(packet), 0, (sockaddr*)&raddr, &addrLen);
-    if (gettimeofday(&tv, nullptr) < 0)
-    {
-      perror("gettimeofday");
-      exit(1);
-    }
-    currentTime = (u64)tv.tv_sec * 1000000 + tv.tv_usec;
-    if (rv < 0)
-    {
-      if (errno != EINTR && errno != EAGAIN)
-      {
-        perror("recvfrom");
-        return 1;
-      }
-    }
-    else if ((size_t)rv < sizeof(packet))
+    usleep(300000);
+    u64 now = GetCurrentTime();
+#ifdef HAVE_LIBSYSTEMD
+    // Only keep the watchdog happy while every shard is still looping.
+    bool alive = true;
+    for (auto& shard : shards)
     {
-      fprintf(stderr, "received short packet from %s\n", SenderName(&raddr));
+      u64 heartbeat = shard->GetHeartbeat();
+      if (heartbeat && now > heartbeat && now - heartbeat > 5 * 1000000)
+        alive = false;
     }
-    else
+    if (alive)
+      sd_notify(0, "WATCHDOG=1");
+#endif
+    if (now - lastMetrics >= METRICS_INTERVAL * 1000000)
     {
-      HandlePacket(&packet, &raddr);
+      PrintMetrics((now - lastMetrics) / 1000000.0);
+      lastMetrics = now;
     }
-    ResendPackets();
-#ifdef HAVE_LIBSYSTEMD
-    sd_notify(0, "WATCHDOG=1");
-#endif
   }
 }
@@ -107,6 +107,59 @@ struct ARAddr
   operator u32() const { return address; }
 };
 
+// Codes made only of RAM writes are flattened into a list of writes when they are applied, so
+// running them every frame skips the interpreter. They are kept in s_compiled_codes to be
+// interpreted on the first run after a change, which is the only run that logs.
+struct RamWrite
+{
+  u32 address;
+  u32 value;
+  u32 count;
+  u32 size;
+};
+static std::vector<ARCode> s_compiled_codes;
+static std::vector<RamWrite> s_compiled_writes;
+
+static bool CompileRamWrites(const ARCode& code, std::vector<RamWrite>* writes)
+{
+  std::vector<RamWrite> code_writes;
+  for (const AREntry& entry : code.ops)
+  {
+    const ARAddr addr(entry.cmd_addr);
+    // Zero codes, conditionals and other subtypes need the interpreter.
+    if (addr == 0 || addr.type != 0x00 || addr.subtype != SUB_RAM_WRITE ||
+        (addr >= 0x00002000 && addr < 0x00003000))
+    {
+      return false;
+    }
+
+    switch (addr.size)
+    {
+    case DATATYPE_8BIT:
+      code_writes.push_back({addr.GCAddress(), entry.value & 0xFF, (entry.value >> 8) + 1, 1});
+      break;
+    case DATATYPE_16BIT:
+      code_writes.push_back({addr.GCAddress(), entry.value & 0xFFFF, (entry.value >> 16) + 1, 2});
+      break;
+    default:
+      code_writes.push_back({addr.GCAddress(), entry.value, 1, 4});
+      break;
+    }
+  }
+
+  writes->insert(writes->end(), code_writes.begin(), code_writes.end());
+  return true;
+}
+
+// Sorts an active code into the compiled or interpreted list. Requires s_lock.
+static void AddActiveCodeLocked(ARCode code)
+{
+  if (CompileRamWrites(code, &s_compiled_writes))
+    s_compiled_codes.emplace_back(std::move(code));
+  else
+    s_active_codes.emplace_back(std::move(code));
+}
+
 // ----------------------
 // AR Remote Functions
 void ApplyCodes(const std::vector<ARCode>& codes)
@@ -117,8 +170,13 @@ void ApplyCodes(const std::vector<ARCode>& codes)
   std::lock_guard<std::mutex> guard(s_lock);
   s_disable_logging = false;
   s_active_codes.clear();
-  std::copy_if(codes.begin(), codes.end(), std::back_inserter(s_active_codes),
-    [](const ARCode& code) { return code.active; });
+  s_compiled_codes.clear();
+  s_compiled_writes.clear();
+  for (const ARCode& code : codes)
+  {
+    if (code.active)
+      AddActiveCodeLocked(code);
+  }
   s_active_codes.shrink_to_fit();
 }
 
@@ -131,7 +189,7 @@ void AddCode(ARCode code)
   {
     std::lock_guard<std::mutex> guard(s_lock);
     s_disable_logging = false;
-    s_active_codes.emplace_back(std::move(code));
+    AddActiveCodeLocked(std::move(code));
   }
 }
 
@@ -945,6 +1003,33 @@ void RunAllActive()
   // are only atomic ops unless contested. It should be rare for this to
   // be contested.
   std::lock_guard<std::mutex> guard(s_lock);
+
+  if (s_disable_logging)
+  {
+    for (const RamWrite& write : s_compiled_writes)
+    {
+      for (u32 i = 0; i < write.count; ++i)
+      {
+        const u32 address = write.address + i * write.size;
+        if (write.size == 1)
+          PowerPC::HostWrite_U8(static_cast<u8>(write.value), address);
+        else if (write.size == 2)
+          PowerPC::HostWrite_U16(static_cast<u16>(write.value), address);
+        else
+          PowerPC::HostWrite_U32(write.value, address);
+      }
+    }
+  }
+  else
+  {
+    // Interpret the compiled codes once so they show up in the log.
+    for (const ARCode& code : s_compiled_codes)
+    {
+      RunCodeLocked(code);
+      LogInfo("\n");
+    }
+  }
+
   s_active_codes.erase(std::remove_if(s_active_codes.begin(), s_active_codes.end(),
     [](const ARCode& code) {
     bool success = RunCodeLocked(code);
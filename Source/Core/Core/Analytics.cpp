@@ -1,5 +1,6 @@
 #include "Core/Analytics.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <mbedtls/sha1.h>
 #include <memory>
@@ -109,6 +110,8 @@ void DolphinAnalytics::ReportDolphinStart(const std::string& ui_type)
 
 void DolphinAnalytics::ReportGameStart()
 {
+  // A Wii title launching another one starts a new game without stopping.
+  ReportGameEnd();
   MakePerGameBuilder();
 
   Common::AnalyticsReportBuilder builder(m_per_game_builder);
@@ -116,6 +119,76 @@ void DolphinAnalytics::ReportGameStart()
   Send(builder);
 }
 
+void DolphinAnalytics::ReportGameEnd()
+{
+  PerformanceSummary summary;
+  {
+    std::lock_guard<std::mutex> lk(m_performance_mutex);
+    std::swap(summary, m_performance);
+  }
+  if (!summary.frames || !SConfig::GetInstance().m_analytics_enabled)
+    return;
+
+  Common::AnalyticsReportBuilder builder(m_per_game_builder);
+  builder.AddData("type", "performance");
+  builder.AddData("frames", summary.frames);
+  builder.AddData("frame-time-avg-us",
+                  static_cast<u32>(summary.frame_time_ms * 1000 / summary.frames));
+  builder.AddData("frame-time-p50-us", summary.GetFrameTimePercentileUs(0.5));
+  builder.AddData("frame-time-p95-us", summary.GetFrameTimePercentileUs(0.95));
+  builder.AddData("frame-time-p99-us", summary.GetFrameTimePercentileUs(0.99));
+  builder.AddData("shader-stall-frames", summary.shader_stall_frames);
+  builder.AddData("shader-stall-total-ms", static_cast<u32>(summary.shader_stall_ms));
+  builder.AddData("shaders-compiled", summary.shaders_compiled);
+  builder.AddData("jit-cache-flushes", summary.jit_cache_flushes);
+  builder.AddData("texture-cache-hits", summary.texture_cache_hits);
+  builder.AddData("texture-cache-misses", summary.texture_cache_misses);
+  builder.AddData("texture-uploads", summary.texture_uploads);
+  Send(builder);
+}
+
+void DolphinAnalytics::ReportPerformanceInfo(const PerformanceSample& sample)
+{
+  if (!SConfig::GetInstance().m_analytics_enabled)
+    return;
+
+  std::lock_guard<std::mutex> lk(m_performance_mutex);
+  PerformanceSummary& summary = m_performance;
+  const size_t bucket = std::min(static_cast<size_t>(sample.frame_time_ms * 10),
+                                 summary.frame_time_histogram.size() - 1);
+  summary.frame_time_histogram[bucket]++;
+  summary.frames++;
+  summary.frame_time_ms += sample.frame_time_ms;
+  if (sample.shader_stall_ms > 0)
+  {
+    summary.shader_stall_frames++;
+    summary.shader_stall_ms += sample.shader_stall_ms;
+  }
+  summary.shaders_compiled += sample.shaders_compiled;
+  summary.texture_cache_hits += sample.texture_cache_hits;
+  summary.texture_cache_misses += sample.texture_cache_misses;
+  summary.texture_uploads += sample.texture_uploads;
+}
+
+void DolphinAnalytics::ReportJitCacheFlush()
+{
+  std::lock_guard<std::mutex> lk(m_performance_mutex);
+  m_performance.jit_cache_flushes++;
+}
+
+u32 DolphinAnalytics::PerformanceSummary::GetFrameTimePercentileUs(double percentile) const
+{
+  const u64 wanted = static_cast<u64>(frames * percentile);
+  u64 count = 0;
+  for (size_t i = 0; i < frame_time_histogram.size(); i++)
+  {
+    count += frame_time_histogram[i];
+    if (count > wanted)
+      return static_cast<u32>(i * 100 + 50);
+  }
+  return static_cast<u32>(frame_time_histogram.size() * 100);
+}
+
 void DolphinAnalytics::MakeBaseBuilder()
 {
   Common::AnalyticsReportBuilder builder;
@@ -4,11 +4,13 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <mutex>
 #include <string>
 
 #include "Common/Analytics.h"
+#include "Common/CommonTypes.h"
 
 // Non generic part of the Dolphin Analytics framework. See Common/Analytics.h
 // for the main documentation.
@@ -34,6 +36,30 @@ public:
   // per-game base data.
   void ReportGameStart();
 
+  // Sends the performance summary of the running game, if it drew any frames.
+  // Called when emulation stops, and by ReportGameStart when the title changes.
+  void ReportGameEnd();
+
+  struct PerformanceSample
+  {
+    float frame_time_ms;
+    // Time above the median of the recent frames, on frames that compiled
+    // shaders.
+    float shader_stall_ms;
+    u32 shaders_compiled;
+    u32 texture_cache_hits;
+    u32 texture_cache_misses;
+    u32 texture_uploads;
+  };
+
+  // Adds a frame to the performance summary of the session. Called by the
+  // video thread. Only aggregated locally, and only when analytics are
+  // enabled.
+  void ReportPerformanceInfo(const PerformanceSample& sample);
+
+  // Called by the JIT whenever it throws its code cache away.
+  void ReportJitCacheFlush();
+
   // Forward Send method calls to the reporter.
   template <typename T>
   void Send(T report)
@@ -48,6 +74,23 @@ private:
   void MakeBaseBuilder();
   void MakePerGameBuilder();
 
+  struct PerformanceSummary
+  {
+    // 0.1 ms steps, the last bucket takes everything slower.
+    std::array<u32, 2000> frame_time_histogram{};
+    u64 frames = 0;
+    double frame_time_ms = 0;
+    u32 shader_stall_frames = 0;
+    double shader_stall_ms = 0;
+    u64 shaders_compiled = 0;
+    u32 jit_cache_flushes = 0;
+    u64 texture_cache_hits = 0;
+    u64 texture_cache_misses = 0;
+    u64 texture_uploads = 0;
+
+    u32 GetFrameTimePercentileUs(double percentile) const;
+  };
+
   // Returns a unique ID derived on the global unique ID, hashed with some
   // report-specific data. This avoid correlation between different types of
   // events.
@@ -68,6 +111,9 @@ private:
   std::mutex m_reporter_mutex;
   Common::AnalyticsReporter m_reporter;
 
+  std::mutex m_performance_mutex;
+  PerformanceSummary m_performance;
+
   // Shared pointer in order to allow for multithreaded use of the instance and
   // avoid races at reinitialization time.
   static std::mutex s_instance_mutex;
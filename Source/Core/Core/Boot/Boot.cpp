@@ -27,7 +27,9 @@
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 
+#include "Core/Boot/BootTiming.h"
 #include "Core/Boot/DolReader.h"
+#include "Core/Boot/FastBoot.h"
 #include "Core/Boot/ElfReader.h"
 #include "Core/CommonTitles.h"
 #include "Core/Config/SYSCONFSettings.h"
@@ -72,7 +74,7 @@ BootParameters::GenerateFromFile(const std::string& path,
   std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
 
   static const std::unordered_set<std::string> disc_image_extensions = {
-    { ".gcm", ".iso", ".tgc", ".wbfs", ".ciso", ".gcz", ".dol", ".elf" } };
+    { ".gcm", ".iso", ".tgc", ".wbfs", ".ciso", ".gcz", ".dcz", ".dol", ".elf" } };
   if (disc_image_extensions.find(extension) != disc_image_extensions.end() || is_drive)
   {
     std::unique_ptr<DiscIO::Volume> volume = DiscIO::CreateVolumeFromFilename(path);
@@ -327,8 +329,12 @@ bool CBoot::BootUp(std::unique_ptr<BootParameters> boot)
       if (!volume)
         return false;
 
-      if (!EmulatedBS2(config.bWii, *volume))
-        return false;
+      if (!FastBoot::UseSnapshot(*volume))
+      {
+        BootTiming::ScopedPhase phase(BootTiming::Phase::BS2);
+        if (!EmulatedBS2(config.bWii, *volume))
+          return false;
+      }
 
       // Try to load the symbol map if there is one, and then scan it for
       // and eventually replace code
@@ -410,8 +416,11 @@ bool CBoot::BootUp(std::unique_ptr<BootParameters> boot)
         return false;
       }
 
-      if (!Load_BS2(ipl.path))
-        return false;
+      {
+        BootTiming::ScopedPhase phase(BootTiming::Phase::BS2);
+        if (!Load_BS2(ipl.path))
+          return false;
+      }
 
       if (ipl.disc)
       {
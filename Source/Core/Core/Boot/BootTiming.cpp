@@ -0,0 +1,118 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/Boot/BootTiming.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/TraceEvents.h"
+
+namespace BootTiming
+{
+namespace
+{
+constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::Count);
+constexpr std::array<const char*, PHASE_COUNT> PHASE_NAMES = {
+    {"BootCore", "Hardware init", "Video backend init", "BootUp", "IPL/apploader HLE",
+     "Fast boot snapshot", "Video prepare", "First frame"}};
+
+struct PhaseTime
+{
+  u64 start = 0;
+  u64 end = 0;
+};
+
+std::mutex s_lock;
+// Cleared by Start(), so phases outside a boot cost an atomic load.
+std::atomic<bool> s_done{true};
+u64 s_boot_start = 0;
+std::array<PhaseTime, PHASE_COUNT> s_phases;
+std::string s_report;
+
+double ToMs(u64 ns)
+{
+  return ns / 1000000.0;
+}
+
+std::string BuildReport()
+{
+  std::string report = "Boot phases (ms since BootCore):\n";
+  for (size_t i = 0; i < PHASE_COUNT; i++)
+  {
+    const PhaseTime& phase = s_phases[i];
+    if (!phase.start || !phase.end)
+      continue;
+    report += StringFromFormat("  %-20s start %9.1f  took %9.1f\n", PHASE_NAMES[i],
+                               ToMs(phase.start - s_boot_start), ToMs(phase.end - phase.start));
+  }
+  const PhaseTime& first_frame = s_phases[static_cast<size_t>(Phase::FirstFrame)];
+  report += StringFromFormat("Time to first frame: %.1f ms", ToMs(first_frame.end - s_boot_start));
+  return report;
+}
+}  // Anonymous namespace
+
+void Start()
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+  s_boot_start = Common::Trace::GetTimestamp();
+  s_phases = {};
+  s_report.clear();
+  s_done.store(false, std::memory_order_relaxed);
+}
+
+void BeginPhase(Phase phase)
+{
+  if (s_done.load(std::memory_order_relaxed))
+    return;
+
+  std::lock_guard<std::mutex> lk(s_lock);
+  s_phases[static_cast<size_t>(phase)] = {Common::Trace::GetTimestamp(), 0};
+}
+
+void EndPhase(Phase phase)
+{
+  if (s_done.load(std::memory_order_relaxed))
+    return;
+
+  std::lock_guard<std::mutex> lk(s_lock);
+  PhaseTime& time = s_phases[static_cast<size_t>(phase)];
+  if (!time.start)
+    return;
+  time.end = Common::Trace::GetTimestamp();
+  if (Common::Trace::IsCapturing())
+    Common::Trace::AddEvent(PHASE_NAMES[static_cast<size_t>(phase)], time.start, time.end);
+}
+
+void OnFrameDrawn()
+{
+  if (s_done.load(std::memory_order_relaxed))
+    return;
+
+  EndPhase(Phase::FirstFrame);
+
+  std::lock_guard<std::mutex> lk(s_lock);
+  if (s_done.load(std::memory_order_relaxed) ||
+      !s_phases[static_cast<size_t>(Phase::FirstFrame)].end)
+  {
+    return;
+  }
+  s_report = BuildReport();
+  s_done.store(true, std::memory_order_relaxed);
+  for (const std::string& line : SplitString(s_report, '\n'))
+    NOTICE_LOG(BOOT, "%s", line.c_str());
+}
+
+std::string GetReport()
+{
+  std::lock_guard<std::mutex> lk(s_lock);
+  return s_report;
+}
+}  // namespace BootTiming
@@ -0,0 +1,55 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+// Wall clock breakdown of a boot, from BootManager::BootCore to the first frame the video backend
+// draws. Phases nest (the apploader runs inside BootUp), so each one is reported with its own
+// start and duration. The breakdown is logged once the first frame is drawn, and the phases also
+// show up in a running trace capture.
+namespace BootTiming
+{
+enum class Phase
+{
+  BootCore,
+  HardwareInit,
+  VideoBackendInit,
+  BootUp,
+  // IPL and apploader HLE.
+  BS2,
+  FastBootSnapshot,
+  // Video_Prepare, where most backends load their shader caches.
+  VideoPrepare,
+  // From the CPU thread starting to run to the first frame.
+  FirstFrame,
+  Count,
+};
+
+// Starts timing a new boot, called by BootManager::BootCore.
+void Start();
+
+void BeginPhase(Phase phase);
+void EndPhase(Phase phase);
+
+// Called by the video thread for every drawn frame, ends the boot with the first one.
+void OnFrameDrawn();
+
+// Empty until the boot has ended.
+std::string GetReport();
+
+class ScopedPhase
+{
+public:
+  explicit ScopedPhase(Phase phase) : m_phase(phase) { BeginPhase(phase); }
+  ~ScopedPhase() { EndPhase(m_phase); }
+
+  ScopedPhase(const ScopedPhase&) = delete;
+  ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+  Phase m_phase;
+};
+}  // namespace BootTiming
@@ -0,0 +1,103 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/Boot/FastBoot.h"
+
+#include <cinttypes>
+#include <cstring>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/Version.h"
+#include "Core/Boot/BootTiming.h"
+#include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/Movie.h"
+#include "Core/NetPlayProto.h"
+#include "Core/State.h"
+#include "DiscIO/Volume.h"
+
+namespace FastBoot
+{
+namespace
+{
+// Set by UseSnapshot on the emu thread before the CPU thread is started.
+std::string s_load_path;
+std::string s_save_path;
+
+// The settings that change what the BS2 leaves behind or what the savestate contains. A new
+// Dolphin build gets new snapshots too, since states don't load across versions.
+std::string GetSnapshotPath(const DiscIO::Volume& volume)
+{
+  const SConfig& config = SConfig::GetInstance();
+  std::string key = StringFromFormat(
+      "%s|%s|%u|%u|%d|%d|%d|%d|%d|%d|%d", Common::scm_rev_git_str.c_str(),
+      volume.GetGameID().c_str(), volume.GetRevision().value_or(0),
+      volume.GetDiscNumber().value_or(0), config.bWii, config.bDSPHLE, config.bMMU,
+      config.bFastDiscSpeed, config.SelectedLanguage, static_cast<int>(config.m_region),
+      config.m_bt_passthrough_enabled);
+  for (const auto device : config.m_EXIDevice)
+    key += StringFromFormat("|%d", static_cast<int>(device));
+  for (const auto device : config.m_SIDevice)
+    key += StringFromFormat("|%d", static_cast<int>(device));
+
+  const u64 hash =
+      GetMurmurHash3(reinterpret_cast<const u8*>(key.data()), static_cast<u32>(key.size()), 0);
+  return File::GetUserPath(D_CACHE_IDX) + "FastBoot/" + volume.GetGameID() +
+         StringFromFormat("_%016" PRIx64 ".sav", hash);
+}
+}  // Anonymous namespace
+
+bool UseSnapshot(const DiscIO::Volume& volume)
+{
+  Clear();
+  if (!Config::Get(Config::MAIN_FAST_BOOT_CACHE) || Movie::IsMovieActive() ||
+      NetPlay::IsNetPlayRunning())
+  {
+    return false;
+  }
+
+  const std::string path = GetSnapshotPath(volume);
+  State::StateHeader header;
+  if (!File::Exists(path) || !State::ReadHeader(path, header) ||
+      volume.GetGameID().compare(0, sizeof(header.gameID), header.gameID,
+                                 strnlen(header.gameID, sizeof(header.gameID))) != 0)
+  {
+    s_save_path = path;
+    return false;
+  }
+
+  NOTICE_LOG(BOOT, "Booting from fast boot snapshot %s", path.c_str());
+  s_load_path = path;
+  return true;
+}
+
+void OnCPUThreadStart()
+{
+  if (!s_load_path.empty())
+  {
+    BootTiming::ScopedPhase phase(BootTiming::Phase::FastBootSnapshot);
+    State::LoadAs(s_load_path);
+  }
+  else if (!s_save_path.empty())
+  {
+    BootTiming::ScopedPhase phase(BootTiming::Phase::FastBootSnapshot);
+    File::CreateFullPath(s_save_path);
+    State::SaveAs(s_save_path, true);
+    NOTICE_LOG(BOOT, "Saved fast boot snapshot %s", s_save_path.c_str());
+  }
+  Clear();
+}
+
+void Clear()
+{
+  s_load_path.clear();
+  s_save_path.clear();
+}
+}  // namespace FastBoot
@@ -0,0 +1,27 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+namespace DiscIO
+{
+class Volume;
+}
+
+// Snapshots of the console right after the IPL/apploader HLE, one per game and config, kept in
+// Cache/FastBoot. With Core.FastBootCache enabled, the first boot of a disc saves one when the
+// CPU thread starts, and later boots load it instead of running the apploader again. Movies and
+// netplay always boot normally.
+namespace FastBoot
+{
+// Called by CBoot for disc boots. Returns true if a snapshot will be loaded, in which case the
+// IPL/apploader HLE should be skipped.
+bool UseSnapshot(const DiscIO::Volume& volume);
+
+// Called on the CPU thread before it starts running, unless it loads a savestate anyway.
+void OnCPUThreadStart();
+
+// Forgets what the last boot was going to do, called when emulation stops.
+void Clear();
+}  // namespace FastBoot
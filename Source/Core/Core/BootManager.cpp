@@ -33,6 +33,7 @@
 
 #include "Common/Config/Config.h"
 #include "Core/Boot/Boot.h"
+#include "Core/Boot/BootTiming.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/Config/SYSCONFSettings.h"
 #include "Core/ConfigLoaders/BaseConfigLoader.h"
@@ -77,14 +78,17 @@ private:
   bool valid;
   bool bCPUThread;
   bool bEnableCheats;
+  bool bGeckoNative;
   bool bSyncGPUOnSkipIdleHack;
   bool bFPRF;
   bool bAccurateNaNs;
   bool bMMU;
   bool bDCBZOFF;
+  bool bAccurateDataCache;
   bool bLowDCBZHack;
   bool m_EnableJIT;
   bool bSyncGPU;
+  int iGpuSyncMaxDeferredFields;
   bool bFastDiscSpeed;
   bool bDSPHLE;
   bool bHLE_BS2;
@@ -111,13 +115,16 @@ void ConfigCache::SaveConfig(const SConfig& config)
 
   bCPUThread = config.bCPUThread;
   bEnableCheats = config.bEnableCheats;
+  bGeckoNative = config.bGeckoNative;
   bSyncGPUOnSkipIdleHack = config.bSyncGPUOnSkipIdleHack;
   bFPRF = config.bFPRF;
   bAccurateNaNs = config.bAccurateNaNs;
   bMMU = config.bMMU;
   bDCBZOFF = config.bDCBZOFF;
+  bAccurateDataCache = config.bAccurateDataCache;
   m_EnableJIT = config.m_DSPEnableJIT;
   bSyncGPU = config.bSyncGPU;
+  iGpuSyncMaxDeferredFields = config.iGpuSyncMaxDeferredFields;
   bFastDiscSpeed = config.bFastDiscSpeed;
   bDSPHLE = config.bDSPHLE;
   bHLE_BS2 = config.bHLE_BS2;
@@ -154,14 +161,17 @@ void ConfigCache::RestoreConfig(SConfig* config)
 
   config->bCPUThread = bCPUThread;
   config->bEnableCheats = bEnableCheats;
+  config->bGeckoNative = bGeckoNative;
   config->bSyncGPUOnSkipIdleHack = bSyncGPUOnSkipIdleHack;
   config->bFPRF = bFPRF;
   config->bAccurateNaNs = bAccurateNaNs;
   config->bMMU = bMMU;
   config->bDCBZOFF = bDCBZOFF;
+  config->bAccurateDataCache = bAccurateDataCache;
   config->bLowDCBZHack = bLowDCBZHack;
   config->m_DSPEnableJIT = m_EnableJIT;
   config->bSyncGPU = bSyncGPU;
+  config->iGpuSyncMaxDeferredFields = iGpuSyncMaxDeferredFields;
   config->bFastDiscSpeed = bFastDiscSpeed;
   config->bDSPHLE = bDSPHLE;
   config->bHLE_BS2 = bHLE_BS2;
@@ -236,6 +246,9 @@ bool BootCore(std::unique_ptr<BootParameters> boot)
   if (!boot)
     return false;
 
+  BootTiming::Start();
+  BootTiming::ScopedPhase phase(BootTiming::Phase::BootCore);
+
   SConfig& StartUp = SConfig::GetInstance();
 
   StartUp.bRunCompareClient = false;
@@ -264,6 +277,8 @@ bool BootCore(std::unique_ptr<BootParameters> boot)
     core_section->Get("AccurateNaNs", &StartUp.bAccurateNaNs, StartUp.bAccurateNaNs);
     core_section->Get("MMU", &StartUp.bMMU, StartUp.bMMU);
     core_section->Get("DCBZ", &StartUp.bDCBZOFF, StartUp.bDCBZOFF);
+    core_section->Get("AccurateDataCache", &StartUp.bAccurateDataCache,
+                      StartUp.bAccurateDataCache);
     core_section->Get("LowDCBZHack", &StartUp.bLowDCBZHack, StartUp.bLowDCBZHack);
     core_section->Get("Video_Rate", &StartUp.iVideoRate, StartUp.iVideoRate);
     core_section->Get("HalfAudioRate", &StartUp.bHalfAudioRate, StartUp.bHalfAudioRate);
@@ -274,6 +289,8 @@ bool BootCore(std::unique_ptr<BootParameters> boot)
     StartUp.iPollingMethod = polling_method == "OnSIRead" ? POLLING_ONSIREAD : POLLING_CONSOLE;
 
     core_section->Get("SyncGPU", &StartUp.bSyncGPU, StartUp.bSyncGPU);
+    core_section->Get("GpuSyncMaxDeferredFields", &StartUp.iGpuSyncMaxDeferredFields,
+      StartUp.iGpuSyncMaxDeferredFields);
     core_section->Get("FastDiscSpeed", &StartUp.bFastDiscSpeed, StartUp.bFastDiscSpeed);
     core_section->Get("DSPHLE", &StartUp.bDSPHLE, StartUp.bDSPHLE);
     core_section->Get("GFXBackend", &StartUp.m_strVideoBackend, StartUp.m_strVideoBackend);
@@ -362,6 +379,7 @@ bool BootCore(std::unique_ptr<BootParameters> boot)
     Config::AddLayer(ConfigLoaders::GenerateNetPlayConfigLoader(g_NetPlaySettings));
     StartUp.bCPUThread = g_NetPlaySettings.m_CPUthread;
     StartUp.bEnableCheats = g_NetPlaySettings.m_EnableCheats;
+    StartUp.bGeckoNative = g_NetPlaySettings.m_GeckoNative;
     StartUp.bDSPHLE = g_NetPlaySettings.m_DSPHLE;
     StartUp.bEnableMemcardSdWriting = g_NetPlaySettings.m_WriteToMemcard;
     StartUp.bCopyWiiSaveNetplay = g_NetPlaySettings.m_CopyWiiSave;
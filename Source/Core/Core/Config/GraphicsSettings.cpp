@@ -15,6 +15,7 @@ namespace Config
 // Graphics.Hardware
 
 const ConfigInfo<bool> GFX_VSYNC{{System::GFX, "Hardware", "VSync"}, false};
+const ConfigInfo<bool> GFX_LOW_LATENCY{{System::GFX, "Hardware", "LowLatency"}, false};
 const ConfigInfo<int> GFX_ADAPTER{{System::GFX, "Hardware", "Adapter"}, 0};
 
 // Graphics.Settings
@@ -35,6 +36,8 @@ const ConfigInfo<bool> GFX_SHOW_NETPLAY_MESSAGES{{System::GFX, "Settings", "Show
                                                  true};
 const ConfigInfo<bool> GFX_SHOW_OSD_CLOCK{ {System::GFX, "Settings", "ShowOSDClock"}, true };
 const ConfigInfo<bool> GFX_SHOW_FRAME_TIMES{ {System::GFX, "Settings", "ShowFrameTimes"}, true };
+const ConfigInfo<bool> GFX_SHOW_FRAME_TIME_STATS{{System::GFX, "Settings", "ShowFrameTimeStats"},
+                                                 false};
 const ConfigInfo<bool> GFX_LOG_RENDER_TIME_TO_FILE{{System::GFX, "Settings", "LogRenderTimeToFile"},
                                                    false};
 const ConfigInfo<bool> GFX_OVERLAY_STATS{{System::GFX, "Settings", "OverlayStats"}, false};
@@ -47,16 +50,22 @@ const ConfigInfo<bool> GFX_CACHE_HIRES_TEXTURES{{System::GFX, "Settings", "Cache
                                                 false};
 const ConfigInfo<bool> GFX_WAIT_CACHE_HIRES_TEXTURES{{System::GFX, "Settings", "WaitForCachedHiresTextures"},
                                                 false};
+const ConfigInfo<bool> GFX_STREAM_HIRES_TEXTURES{{System::GFX, "Settings", "StreamHiresTextures"},
+                                                 false};
+const ConfigInfo<int> GFX_HIRES_TEXTURES_MEMORY_BUDGET{
+    {System::GFX, "Settings", "HiresTexturesMemoryBudget"}, 0};
 const ConfigInfo<bool> GFX_DUMP_EFB_TARGET{{System::GFX, "Settings", "DumpEFBTarget"}, false};
 const ConfigInfo<bool> GFX_DUMP_FRAMES_AS_IMAGES{{System::GFX, "Settings", "DumpFramesAsImages"},
                                                  false};
 const ConfigInfo<bool> GFX_FREE_LOOK{{System::GFX, "Settings", "FreeLook"}, false};
 const ConfigInfo<bool> GFX_COMPILE_SHADERS_ON_STARTUP{ { System::GFX, "Settings", "CompileShaderOnStartup" }, true };
+const ConfigInfo<int> GFX_COMPILE_SHADERS_ON_STARTUP_PERCENT{ { System::GFX, "Settings", "CompileShaderOnStartupPercent" }, 100 };
 const ConfigInfo<int> GFX_USE_BLACK_FRAME_INSERTION{ {System::GFX, "Settings", "BlackFrameInsertion"}, VideoConfig::BFI_OFF };
 const ConfigInfo<int> GFX_USE_BLACK_FRAME_BIR{ {System::GFX, "Settings", "BlackFrameInsertionBIR"}, VideoConfig::BFIR_30 };
 const ConfigInfo<bool> GFX_USE_FFV1{{System::GFX, "Settings", "UseFFV1"}, false};
 const ConfigInfo<std::string> GFX_DUMP_FORMAT{{System::GFX, "Settings", "DumpFormat"}, "avi"};
 const ConfigInfo<std::string> GFX_DUMP_CODEC{{System::GFX, "Settings", "DumpCodec"}, ""};
+const ConfigInfo<std::string> GFX_DUMP_ENCODER{{System::GFX, "Settings", "DumpEncoder"}, ""};
 const ConfigInfo<std::string> GFX_DUMP_PATH{{System::GFX, "Settings", "DumpPath"}, ""};
 const ConfigInfo<int> GFX_BITRATE_KBPS{{System::GFX, "Settings", "BitrateKbps"}, 2500};
 const ConfigInfo<bool> GFX_INTERNAL_RESOLUTION_FRAME_DUMPS{
@@ -89,6 +98,7 @@ const ConfigInfo<u32> GFX_MSAA{{System::GFX, "Settings", "MSAA"}, 1};
 const ConfigInfo<bool> GFX_SSAA{{System::GFX, "Settings", "SSAA"}, false};
 const ConfigInfo<int> GFX_EFB_SCALE{{System::GFX, "Settings", "EFBScale"},
                                     static_cast<int>(SCALE_1X)};
+const ConfigInfo<bool> GFX_DYNAMIC_EFB_SCALE{{System::GFX, "Settings", "DynamicEFBScale"}, false};
 const ConfigInfo<bool> GFX_TEXFMT_OVERLAY_ENABLE{{System::GFX, "Settings", "TexFmtOverlayEnable"},
                                                  false};
 const ConfigInfo<bool> GFX_TEXFMT_OVERLAY_CENTER{{System::GFX, "Settings", "TexFmtOverlayCenter"},
@@ -111,6 +121,8 @@ const ConfigInfo<bool> GFX_BACKGROUND_SHADER_COMPILING{
   { System::GFX, "Settings", "BackgroundShaderCompiling" }, false };
 const ConfigInfo<bool> GFX_DISABLE_SPECIALIZED_SHADERS{
   { System::GFX, "Settings", "DisableSpecializedShaders" }, false };
+const ConfigInfo<bool> GFX_UBERSHADER_SPECIALIZATION{
+  { System::GFX, "Settings", "UberShaderSpecialization" }, true };
 
 const ConfigInfo<bool> GFX_SW_ZCOMPLOC{{System::GFX, "Settings", "SWZComploc"}, true};
 const ConfigInfo<bool> GFX_SW_ZFREEZE{{System::GFX, "Settings", "SWZFreeze"}, true};
@@ -146,6 +158,8 @@ const ConfigInfo<int> GFX_ENHANCE_TEXTURE_SCALING_TYPE{ { System::GFX, "Enhancem
 const ConfigInfo<int> GFX_ENHANCE_TEXTURE_SCALING_FACTOR{ { System::GFX, "Enhancements", "TextureScalingFactor" }, 2 };
 const ConfigInfo<bool> GFX_ENHANCE_USE_DEPOSTERIZE{ { System::GFX, "Enhancements", "UseDePosterize" },
 true };
+const ConfigInfo<bool> GFX_ENHANCE_TEXTURE_SCALING_ASYNC{ { System::GFX, "Enhancements", "TextureScalingAsync" }, false };
+const ConfigInfo<bool> GFX_ENHANCE_TEXTURE_SCALING_CACHE{ { System::GFX, "Enhancements", "TextureScalingCache" }, true };
 
 const ConfigInfo<bool> GFX_ENHANCE_TESSELLATION{ { System::GFX, "Enhancements", "Tessellation" }, true };
 const ConfigInfo<bool> GFX_ENHANCE_TESSELLATION_EARLY_CULLING{ { System::GFX, "Enhancements", "TessellationEarlyCulling" }, false };
@@ -153,6 +167,8 @@ const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_DISTANCE{ { System::GFX, "Enhance
 const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_MAX{ { System::GFX, "Enhancements", "TessellationMax" }, 6 };
 const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_ROUNDING_INTENSITY{ { System::GFX, "Enhancements", "TessellationRoundingIntensity" }, 0 };
 const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_DISPLACEMENT_INTENSITY{ { System::GFX, "Enhancements", "TessellationDisplacementIntensity" }, 0 };
+const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_EDGE_LENGTH{ { System::GFX, "Enhancements", "TessellationEdgeLength" }, 0 };
+const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_TRIANGLE_BUDGET{ { System::GFX, "Enhancements", "TessellationTriangleBudget" }, 0 };
 // Graphics.Stereoscopy
 
 const ConfigInfo<int> GFX_STEREO_MODE{{System::GFX, "Stereoscopy", "StereoMode"}, 0};
@@ -173,9 +189,14 @@ const ConfigInfo<std::string> GFX_STEREO_SHADER{
 const ConfigInfo<bool> GFX_HACK_EFB_ACCESS_ENABLE{{System::GFX, "Hacks", "EFBAccessEnable"}, false};
 const ConfigInfo<bool> GFX_HACK_EFB_FAST_ACCESS_ENABLE{ { System::GFX, "Hacks", "EFBFastAccess" }, false };
 const ConfigInfo<int> GFX_HACK_BBOX_MODE{{System::GFX, "Hacks", "BoundingBoxMode"}, 0};
+const ConfigInfo<bool> GFX_HACK_BBOX_LATENCY_TOLERANT{
+    {System::GFX, "Hacks", "BBoxLatencyTolerant"}, false};
 const ConfigInfo<bool> GFX_HACK_FORCE_PROGRESSIVE{{System::GFX, "Hacks", "ForceProgressive"}, true};
 const ConfigInfo<bool> GFX_HACK_SKIP_EFB_COPY_TO_RAM{{System::GFX, "Hacks", "EFBToTextureEnable"},
                                                      true};
+const ConfigInfo<bool> GFX_HACK_DEFER_EFB_COPIES{{System::GFX, "Hacks", "DeferEFBCopies"}, false};
+const ConfigInfo<bool> GFX_HACK_SKIP_REDUNDANT_EFB_COPIES{
+    {System::GFX, "Hacks", "SkipRedundantEFBCopies"}, true};
 const ConfigInfo<bool> GFX_HACK_COPY_EFB_SCALED{{System::GFX, "Hacks", "EFBScaledCopy"}, false};
 const ConfigInfo<bool> GFX_HACK_EFB_EMULATE_FORMAT_CHANGES{
     {System::GFX, "Hacks", "EFBEmulateFormatChanges"}, false};
@@ -186,6 +207,11 @@ const ConfigInfo<bool> GFX_HACK_FULL_ASYNC_SHADER_COMPILATION{ { System::GFX, "H
 const ConfigInfo<bool> GFX_HACK_LAST_HISTORY_EFBTORAM{ { System::GFX, "Hacks", "LastStoryEFBToRam" }, false };
 const ConfigInfo<bool> GFX_HACK_FORCE_LOGICOP_BLEND{ { System::GFX, "Hacks", "ForceLogicOpBlend" }, false };
 const ConfigInfo<int> GFX_HACK_CULL_MODE{ { System::GFX, "Hacks", "CullMode" }, 0 };
+const ConfigInfo<bool> GFX_HACK_DISPLAY_LIST_CACHE{ { System::GFX, "Hacks", "DisplayListCache" }, true };
+const ConfigInfo<bool> GFX_HACK_VERTEX_DATA_CACHE{ { System::GFX, "Hacks", "VertexDataCache" }, true };
+const ConfigInfo<bool> GFX_HACK_CPU_CULL{ { System::GFX, "Hacks", "CPUCull" }, false };
+const ConfigInfo<bool> GFX_HACK_KEEP_TEXTURES_ON_STATE_LOAD{
+    { System::GFX, "Hacks", "KeepTexturesOnStateLoad" }, false };
 
 // Graphics.GameSpecific
 
@@ -198,4 +224,6 @@ const ConfigInfo<std::string> GFX_PROJECTION_HACK_ZFAR{{System::GFX, "GameSpecif
                                                        ""};
 const ConfigInfo<bool> GFX_PERF_QUERIES_ENABLE{{System::GFX, "GameSpecific", "PerfQueriesEnable"},
                                                false};
+const ConfigInfo<bool> GFX_PERF_QUERIES_ASYNC{{System::GFX, "GameSpecific", "PerfQueriesAsync"},
+                                              false};
 }  // namespace Config
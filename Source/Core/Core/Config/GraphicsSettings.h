@@ -15,6 +15,7 @@ namespace Config
 // Graphics.Hardware
 
 extern const ConfigInfo<bool> GFX_VSYNC;
+extern const ConfigInfo<bool> GFX_LOW_LATENCY;
 extern const ConfigInfo<int> GFX_ADAPTER;
 
 // Graphics.Settings
@@ -31,6 +32,7 @@ extern const ConfigInfo<bool> GFX_SHOW_NETPLAY_PING;
 extern const ConfigInfo<bool> GFX_SHOW_NETPLAY_MESSAGES;
 extern const ConfigInfo<bool> GFX_SHOW_OSD_CLOCK;
 extern const ConfigInfo<bool> GFX_SHOW_FRAME_TIMES;
+extern const ConfigInfo<bool> GFX_SHOW_FRAME_TIME_STATS;
 extern const ConfigInfo<bool> GFX_LOG_RENDER_TIME_TO_FILE;
 extern const ConfigInfo<bool> GFX_OVERLAY_STATS;
 extern const ConfigInfo<bool> GFX_OVERLAY_PROJ_STATS;
@@ -40,15 +42,19 @@ extern const ConfigInfo<bool> GFX_HIRES_MATERIAL_MAPS;
 extern const ConfigInfo<bool> GFX_HIRES_MATERIAL_MAPS_BUILD;
 extern const ConfigInfo<bool> GFX_CACHE_HIRES_TEXTURES;
 extern const ConfigInfo<bool> GFX_WAIT_CACHE_HIRES_TEXTURES;
+extern const ConfigInfo<bool> GFX_STREAM_HIRES_TEXTURES;
+extern const ConfigInfo<int> GFX_HIRES_TEXTURES_MEMORY_BUDGET;
 extern const ConfigInfo<bool> GFX_DUMP_EFB_TARGET;
 extern const ConfigInfo<bool> GFX_DUMP_FRAMES_AS_IMAGES;
 extern const ConfigInfo<bool> GFX_FREE_LOOK;
 extern const ConfigInfo<bool> GFX_COMPILE_SHADERS_ON_STARTUP;
+extern const ConfigInfo<int> GFX_COMPILE_SHADERS_ON_STARTUP_PERCENT;
 extern const ConfigInfo<int> GFX_USE_BLACK_FRAME_INSERTION;
 extern const ConfigInfo<int> GFX_USE_BLACK_FRAME_BIR;
 extern const ConfigInfo<bool> GFX_USE_FFV1;
 extern const ConfigInfo<std::string> GFX_DUMP_FORMAT;
 extern const ConfigInfo<std::string> GFX_DUMP_CODEC;
+extern const ConfigInfo<std::string> GFX_DUMP_ENCODER;
 extern const ConfigInfo<std::string> GFX_DUMP_PATH;
 extern const ConfigInfo<int> GFX_BITRATE_KBPS;
 extern const ConfigInfo<bool> GFX_INTERNAL_RESOLUTION_FRAME_DUMPS;
@@ -74,6 +80,7 @@ extern const ConfigInfo<bool> GFX_FAST_DEPTH_CALC;
 extern const ConfigInfo<u32> GFX_MSAA;
 extern const ConfigInfo<bool> GFX_SSAA;
 extern const ConfigInfo<int> GFX_EFB_SCALE;
+extern const ConfigInfo<bool> GFX_DYNAMIC_EFB_SCALE;
 extern const ConfigInfo<bool> GFX_TEXFMT_OVERLAY_ENABLE;
 extern const ConfigInfo<bool> GFX_TEXFMT_OVERLAY_CENTER;
 extern const ConfigInfo<bool> GFX_ENABLE_WIREFRAME;
@@ -86,6 +93,7 @@ extern const ConfigInfo<int> GFX_COMMAND_BUFFER_EXECUTE_INTERVAL;
 extern const ConfigInfo<bool> GFX_SHADER_CACHE;
 extern const ConfigInfo<bool> GFX_BACKGROUND_SHADER_COMPILING;
 extern const ConfigInfo<bool> GFX_DISABLE_SPECIALIZED_SHADERS;
+extern const ConfigInfo<bool> GFX_UBERSHADER_SPECIALIZATION;
 
 extern const ConfigInfo<bool> GFX_SW_ZCOMPLOC;
 extern const ConfigInfo<bool> GFX_SW_ZFREEZE;
@@ -111,12 +119,16 @@ extern const ConfigInfo<bool> GFX_ENHANCE_USE_SCALING_FILTER;
 extern const ConfigInfo<int> GFX_ENHANCE_TEXTURE_SCALING_TYPE;
 extern const ConfigInfo<int> GFX_ENHANCE_TEXTURE_SCALING_FACTOR;
 extern const ConfigInfo<bool> GFX_ENHANCE_USE_DEPOSTERIZE;
+extern const ConfigInfo<bool> GFX_ENHANCE_TEXTURE_SCALING_ASYNC;
+extern const ConfigInfo<bool> GFX_ENHANCE_TEXTURE_SCALING_CACHE;
 extern const ConfigInfo<bool> GFX_ENHANCE_TESSELLATION;
 extern const ConfigInfo<bool> GFX_ENHANCE_TESSELLATION_EARLY_CULLING;
 extern const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_DISTANCE;
 extern const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_MAX;
 extern const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_ROUNDING_INTENSITY;
 extern const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_DISPLACEMENT_INTENSITY;
+extern const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_EDGE_LENGTH;
+extern const ConfigInfo<int> GFX_ENHANCE_TESSELLATION_TRIANGLE_BUDGET;
 
 // Graphics.Stereoscopy
 
@@ -134,8 +146,11 @@ extern const ConfigInfo<std::string> GFX_STEREO_SHADER;
 extern const ConfigInfo<bool> GFX_HACK_EFB_ACCESS_ENABLE;
 extern const ConfigInfo<bool> GFX_HACK_EFB_FAST_ACCESS_ENABLE;
 extern const ConfigInfo<int> GFX_HACK_BBOX_MODE;
+extern const ConfigInfo<bool> GFX_HACK_BBOX_LATENCY_TOLERANT;
 extern const ConfigInfo<bool> GFX_HACK_FORCE_PROGRESSIVE;
 extern const ConfigInfo<bool> GFX_HACK_SKIP_EFB_COPY_TO_RAM;
+extern const ConfigInfo<bool> GFX_HACK_DEFER_EFB_COPIES;
+extern const ConfigInfo<bool> GFX_HACK_SKIP_REDUNDANT_EFB_COPIES;
 extern const ConfigInfo<bool> GFX_HACK_COPY_EFB_SCALED;
 extern const ConfigInfo<bool> GFX_HACK_EFB_EMULATE_FORMAT_CHANGES;
 extern const ConfigInfo<bool> GFX_HACK_VERTEX_ROUDING;
@@ -144,6 +159,10 @@ extern const ConfigInfo<bool> GFX_HACK_FULL_ASYNC_SHADER_COMPILATION;
 extern const ConfigInfo<bool> GFX_HACK_LAST_HISTORY_EFBTORAM;
 extern const ConfigInfo<bool> GFX_HACK_FORCE_LOGICOP_BLEND;
 extern const ConfigInfo<int> GFX_HACK_CULL_MODE;
+extern const ConfigInfo<bool> GFX_HACK_DISPLAY_LIST_CACHE;
+extern const ConfigInfo<bool> GFX_HACK_VERTEX_DATA_CACHE;
+extern const ConfigInfo<bool> GFX_HACK_CPU_CULL;
+extern const ConfigInfo<bool> GFX_HACK_KEEP_TEXTURES_ON_STATE_LOAD;
 
 // Graphics.GameSpecific
 
@@ -153,6 +172,7 @@ extern const ConfigInfo<int> GFX_PROJECTION_HACK_SZFAR;
 extern const ConfigInfo<std::string> GFX_PROJECTION_HACK_ZNEAR;
 extern const ConfigInfo<std::string> GFX_PROJECTION_HACK_ZFAR;
 extern const ConfigInfo<bool> GFX_PERF_QUERIES_ENABLE;
+extern const ConfigInfo<bool> GFX_PERF_QUERIES_ASYNC;
 
 
 
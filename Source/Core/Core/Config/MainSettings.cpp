@@ -89,11 +89,21 @@ const ConfigInfo<std::string> MAIN_GFX_BACKEND{{System::Main, "Core", "GFXBacken
 const ConfigInfo<std::string> MAIN_GPU_DETERMINISM_MODE{
     {System::Main, "Core", "GPUDeterminismMode"}, "auto"};
 const ConfigInfo<std::string> MAIN_PERF_MAP_DIR{{System::Main, "Core", "PerfMapDir"}, ""};
+const ConfigInfo<bool> MAIN_PERF_JIT_DUMP{{System::Main, "Core", "PerfJitDump"}, false};
 const ConfigInfo<bool> MAIN_CUSTOM_RTC_ENABLE{{System::Main, "Core", "EnableCustomRTC"}, false};
 // Default to seconds between 1.1.1970 and 1.1.2000
 const ConfigInfo<u32> MAIN_CUSTOM_RTC_VALUE{{System::Main, "Core", "CustomRTCValue"}, 946684800};
 const ConfigInfo<bool> MAIN_ENABLE_SIGNATURE_CHECKS{{System::Main, "Core", "EnableSignatureChecks"},
                                                     true};
+const ConfigInfo<int> MAIN_CPU_THREAD_AFFINITY{{System::Main, "Core", "CPUThreadAffinity"}, 1};
+const ConfigInfo<int> MAIN_CPU_THREAD_PRIORITY{{System::Main, "Core", "CPUThreadPriority"}, 0};
+const ConfigInfo<int> MAIN_GPU_THREAD_AFFINITY{{System::Main, "Core", "GPUThreadAffinity"}, 1};
+const ConfigInfo<int> MAIN_GPU_THREAD_PRIORITY{{System::Main, "Core", "GPUThreadPriority"}, 0};
+const ConfigInfo<int> MAIN_DSP_THREAD_AFFINITY{{System::Main, "Core", "DSPThreadAffinity"}, 1};
+const ConfigInfo<int> MAIN_DSP_THREAD_PRIORITY{{System::Main, "Core", "DSPThreadPriority"}, 0};
+const ConfigInfo<int> MAIN_AUDIO_THREAD_AFFINITY{{System::Main, "Core", "AudioThreadAffinity"}, 0};
+const ConfigInfo<int> MAIN_AUDIO_THREAD_PRIORITY{{System::Main, "Core", "AudioThreadPriority"}, 2};
+const ConfigInfo<bool> MAIN_FAST_BOOT_CACHE{{System::Main, "Core", "FastBootCache"}, false};
 
 // Main.DSP
 
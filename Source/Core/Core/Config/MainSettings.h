@@ -64,9 +64,20 @@ extern const ConfigInfo<bool> MAIN_OVERCLOCK_ENABLE;
 extern const ConfigInfo<std::string> MAIN_GFX_BACKEND;
 extern const ConfigInfo<std::string> MAIN_GPU_DETERMINISM_MODE;
 extern const ConfigInfo<std::string> MAIN_PERF_MAP_DIR;
+extern const ConfigInfo<bool> MAIN_PERF_JIT_DUMP;
 extern const ConfigInfo<bool> MAIN_CUSTOM_RTC_ENABLE;
 extern const ConfigInfo<u32> MAIN_CUSTOM_RTC_VALUE;
 extern const ConfigInfo<bool> MAIN_ENABLE_SIGNATURE_CHECKS;
+// ThreadPolicy::Affinity and Common::ThreadPriority values.
+extern const ConfigInfo<int> MAIN_CPU_THREAD_AFFINITY;
+extern const ConfigInfo<int> MAIN_CPU_THREAD_PRIORITY;
+extern const ConfigInfo<int> MAIN_GPU_THREAD_AFFINITY;
+extern const ConfigInfo<int> MAIN_GPU_THREAD_PRIORITY;
+extern const ConfigInfo<int> MAIN_DSP_THREAD_AFFINITY;
+extern const ConfigInfo<int> MAIN_DSP_THREAD_PRIORITY;
+extern const ConfigInfo<int> MAIN_AUDIO_THREAD_AFFINITY;
+extern const ConfigInfo<int> MAIN_AUDIO_THREAD_PRIORITY;
+extern const ConfigInfo<bool> MAIN_FAST_BOOT_CACHE;
 
 // Main.DSP
 
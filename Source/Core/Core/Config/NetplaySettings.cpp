@@ -36,5 +36,8 @@ const ConfigInfo<std::string> NETPLAY_SELECTED_HOST_GAME{
 const ConfigInfo<bool> NETPLAY_USE_UPNP{{System::Main, "NetPlay", "UseUPNP"}, false};
 const ConfigInfo<bool> NETPLAY_ENABLE_QOS{ { System::Main, "NetPlay", "EnableQoS" }, true };
 const ConfigInfo<int> NETPLAY_BUFFER_SIZE{{System::Main, "NetPlay", "BufferSize"}, 4 };
+const ConfigInfo<bool> NETPLAY_AUTO_BUFFER{{System::Main, "NetPlay", "AutoBuffer"}, false};
+const ConfigInfo<bool> NETPLAY_ROLLBACK{{System::Main, "NetPlay", "Rollback"}, false};
+const ConfigInfo<int> NETPLAY_ROLLBACK_FRAMES{{System::Main, "NetPlay", "RollbackFrames"}, 8};
 
 }  // namespace Config
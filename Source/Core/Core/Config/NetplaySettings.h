@@ -32,5 +32,8 @@ extern const ConfigInfo<std::string> NETPLAY_SELECTED_HOST_GAME;
 extern const ConfigInfo<bool> NETPLAY_USE_UPNP;
 extern const ConfigInfo<bool> NETPLAY_ENABLE_QOS;
 extern const ConfigInfo<int> NETPLAY_BUFFER_SIZE;
+extern const ConfigInfo<bool> NETPLAY_AUTO_BUFFER;
+extern const ConfigInfo<bool> NETPLAY_ROLLBACK;
+extern const ConfigInfo<int> NETPLAY_ROLLBACK_FRAMES;
 
 }  // namespace Config
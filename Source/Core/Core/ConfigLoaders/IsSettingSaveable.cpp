@@ -25,6 +25,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       // Graphics.Hardware
 
       Config::GFX_VSYNC.location,
+      Config::GFX_LOW_LATENCY.location,
       Config::GFX_ADAPTER.location,
 
       // Graphics.Settings
@@ -42,6 +43,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_SHOW_NETPLAY_MESSAGES.location,
       Config::GFX_SHOW_OSD_CLOCK.location,
       Config::GFX_SHOW_FRAME_TIMES.location,
+      Config::GFX_SHOW_FRAME_TIME_STATS.location,
       Config::GFX_LOG_RENDER_TIME_TO_FILE.location,
       Config::GFX_OVERLAY_STATS.location,
       Config::GFX_OVERLAY_PROJ_STATS.location,
@@ -51,13 +53,17 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_HIRES_MATERIAL_MAPS_BUILD.location,
       Config::GFX_CACHE_HIRES_TEXTURES.location,
       Config::GFX_WAIT_CACHE_HIRES_TEXTURES.location,
+      Config::GFX_STREAM_HIRES_TEXTURES.location,
+      Config::GFX_HIRES_TEXTURES_MEMORY_BUDGET.location,
       Config::GFX_DUMP_EFB_TARGET.location,
       Config::GFX_DUMP_FRAMES_AS_IMAGES.location,
       Config::GFX_FREE_LOOK.location,
       Config::GFX_COMPILE_SHADERS_ON_STARTUP.location,
+      Config::GFX_COMPILE_SHADERS_ON_STARTUP_PERCENT.location,
       Config::GFX_USE_FFV1.location,
       Config::GFX_DUMP_FORMAT.location,
       Config::GFX_DUMP_CODEC.location,
+      Config::GFX_DUMP_ENCODER.location,
       Config::GFX_DUMP_PATH.location,
       Config::GFX_BITRATE_KBPS.location,
       Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS.location,
@@ -80,6 +86,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_MSAA.location,
       Config::GFX_SSAA.location,
       Config::GFX_EFB_SCALE.location,
+      Config::GFX_DYNAMIC_EFB_SCALE.location,
       Config::GFX_TEXFMT_OVERLAY_ENABLE.location,
       Config::GFX_TEXFMT_OVERLAY_CENTER.location,
       Config::GFX_ENABLE_WIREFRAME.location,
@@ -100,6 +107,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_SW_DRAW_END.location,
       Config::GFX_BACKGROUND_SHADER_COMPILING.location,
       Config::GFX_DISABLE_SPECIALIZED_SHADERS.location,
+      Config::GFX_UBERSHADER_SPECIALIZATION.location,
       // Graphics.Enhancements
 
       Config::GFX_ENHANCE_FILTERING_MODE.location,
@@ -114,12 +122,16 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_ENHANCE_TEXTURE_SCALING_TYPE.location,
       Config::GFX_ENHANCE_TEXTURE_SCALING_FACTOR.location,
       Config::GFX_ENHANCE_USE_DEPOSTERIZE.location,
+      Config::GFX_ENHANCE_TEXTURE_SCALING_ASYNC.location,
+      Config::GFX_ENHANCE_TEXTURE_SCALING_CACHE.location,
       Config::GFX_ENHANCE_TESSELLATION.location,
       Config::GFX_ENHANCE_TESSELLATION_EARLY_CULLING.location,
       Config::GFX_ENHANCE_TESSELLATION_DISTANCE.location,
       Config::GFX_ENHANCE_TESSELLATION_MAX.location,
       Config::GFX_ENHANCE_TESSELLATION_ROUNDING_INTENSITY.location,
       Config::GFX_ENHANCE_TESSELLATION_DISPLACEMENT_INTENSITY.location,
+      Config::GFX_ENHANCE_TESSELLATION_EDGE_LENGTH.location,
+      Config::GFX_ENHANCE_TESSELLATION_TRIANGLE_BUDGET.location,
 
       // Graphics.Stereoscopy
 
@@ -136,8 +148,11 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_HACK_EFB_ACCESS_ENABLE.location,
       Config::GFX_HACK_EFB_FAST_ACCESS_ENABLE.location,
       Config::GFX_HACK_BBOX_MODE.location,
+      Config::GFX_HACK_BBOX_LATENCY_TOLERANT.location,
       Config::GFX_HACK_FORCE_PROGRESSIVE.location,
       Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM.location,
+      Config::GFX_HACK_DEFER_EFB_COPIES.location,
+      Config::GFX_HACK_SKIP_REDUNDANT_EFB_COPIES.location,
       Config::GFX_HACK_COPY_EFB_SCALED.location,
       Config::GFX_HACK_EFB_EMULATE_FORMAT_CHANGES.location,
       Config::GFX_HACK_VERTEX_ROUDING.location,
@@ -146,6 +161,10 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_HACK_LAST_HISTORY_EFBTORAM.location,
       Config::GFX_HACK_FORCE_LOGICOP_BLEND.location,
       Config::GFX_HACK_CULL_MODE.location,
+      Config::GFX_HACK_DISPLAY_LIST_CACHE.location,
+      Config::GFX_HACK_VERTEX_DATA_CACHE.location,
+      Config::GFX_HACK_CPU_CULL.location,
+      Config::GFX_HACK_KEEP_TEXTURES_ON_STATE_LOAD.location,
 
       // Graphics.GameSpecific
 
@@ -155,6 +174,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_PROJECTION_HACK_ZNEAR.location,
       Config::GFX_PROJECTION_HACK_ZFAR.location,
       Config::GFX_PERF_QUERIES_ENABLE.location,
+      Config::GFX_PERF_QUERIES_ASYNC.location,
 
       // UI.General
 
@@ -240,7 +240,12 @@ void SConfig::SaveCoreSettings(IniFile& ini)
   core->Set("SkipIPL", bHLE_BS2);
   core->Set("TimingVariance", iTimingVariance);
   core->Set("CPUCore", iCPUCore);
+  core->Set("TimingWheel", bTimingWheel);
   core->Set("Fastmem", bFastmem);
+  core->Set("JITPersistentCache", bJITPersistentCache);
+  core->Set("HLELibrary", bHLELibrary);
+  core->Set("HugePages", bHugePages);
+  core->Set("JITCodeCacheSize", iJITCodeCacheSize);
   core->Set("CPUThread", bCPUThread);
   core->Set("DSPHLE", bDSPHLE);
   core->Set("SyncOnSkipIdle", bSyncGPUOnSkipIdleHack);
@@ -248,10 +253,14 @@ void SConfig::SaveCoreSettings(IniFile& ini)
   core->Set("SyncGpuMaxDistance", iSyncGpuMaxDistance);
   core->Set("SyncGpuMinDistance", iSyncGpuMinDistance);
   core->Set("SyncGpuOverclock", fSyncGpuOverclock);
+  core->Set("GpuWakeupThreshold", iGpuWakeupThreshold);
+  core->Set("GpuSyncMaxDeferredFields", iGpuSyncMaxDeferredFields);
+  core->Set("GpuFifoDirectRead", bGpuFifoDirectRead);
   core->Set("FPRF", bFPRF);
   core->Set("AccurateNaNs", bAccurateNaNs);
   core->Set("DefaultISO", m_strDefaultISO);
   core->Set("EnableCheats", bEnableCheats);
+  core->Set("GeckoNative", bGeckoNative);
   core->Set("SDWritable", bAllowSdWriting);
   core->Set("SelectedLanguage", SelectedLanguage);
   core->Set("OverrideGCLang", bOverrideGCLanguage);
@@ -260,6 +269,15 @@ void SConfig::SaveCoreSettings(IniFile& ini)
   core->Set("AudioLatency", iLatency);
   core->Set("AudioStretch", m_audio_stretch);
   core->Set("AudioStretchMaxLatency", m_audio_stretch_max_latency);
+  core->Set("AudioRateControl", m_audio_rate_control);
+  core->Set("AudioSincResampler", m_audio_sinc_resampler);
+  core->Set("AudioLowLatency", m_audio_low_latency);
+  core->Set("Rewind", m_rewind_enabled);
+  core->Set("RewindInterval", m_rewind_interval);
+  core->Set("RewindBufferSize", m_rewind_buffer_size);
+  core->Set("RunAheadFrames", m_run_ahead_frames);
+  core->Set("MemoryWatcherRing", m_memory_watcher_ring);
+  core->Set("MemoryWatcherWatchpoints", m_memory_watcher_watchpoints);
   core->Set("MemcardAPath", m_strMemoryCardA);
   core->Set("MemcardBPath", m_strMemoryCardB);
   core->Set("AgpCartAPath", m_strGbaCartA);
@@ -287,11 +305,19 @@ void SConfig::SaveCoreSettings(IniFile& ini)
   core->Set("GFXBackend", m_strVideoBackend);
   core->Set("GPUDeterminismMode", m_strGPUDeterminismMode);
   core->Set("PerfMapDir", m_perfDir);
+  core->Set("PerfJitDump", m_perfJitDump);
   core->Set("EnableCustomRTC", bEnableCustomRTC);
   core->Set("CustomRTCValue", m_customRTCValue);
   core->Set("EnableSignatureChecks", m_enable_signature_checks);
   core->Set("QoSEnabled", bQoSEnabled);
   core->Set("AdapterWarning", bAdapterWarning);
+  core->Set("AdapterPollRate", m_adapter_poll_rate);
+  core->Set("AdapterRealtimeThread", m_adapter_realtime_thread);
+  core->Set("AdapterMatchPollTime", m_adapter_match_poll_time);
+  core->Set("DVDReadAhead", m_dvd_read_ahead);
+  core->Set("DVDAccessPatterns", m_dvd_access_patterns);
+  core->Set("LateInputLatch", m_late_input_latch);
+  core->Set("PreciseFrameLimiter", m_precise_frame_limiter);
   core->Set("WiiNetplaySaveReplays", bSaveNetplayReplays);
 }
 
@@ -305,6 +331,7 @@ void SConfig::SaveMovieSettings(IniFile& ini)
   movie->Set("DumpFramesSilent", m_DumpFramesSilent);
   movie->Set("ShowInputDisplay", m_ShowInputDisplay);
   movie->Set("ShowRTC", m_ShowRTC);
+  movie->Set("KeyframeInterval", m_movie_keyframe_interval);
 }
 
 void SConfig::SaveDSPSettings(IniFile& ini)
@@ -545,12 +572,18 @@ void SConfig::LoadCoreSettings(IniFile& ini)
   core->Get("CPUCore", &iCPUCore, PowerPC::CORE_INTERPRETER);
 #endif
   core->Get("Fastmem", &bFastmem, true);
+  core->Get("TimingWheel", &bTimingWheel, false);
+  core->Get("JITPersistentCache", &bJITPersistentCache, false);
+  core->Get("HLELibrary", &bHLELibrary, false);
+  core->Get("HugePages", &bHugePages, false);
+  core->Get("JITCodeCacheSize", &iJITCodeCacheSize, 32);
   core->Get("DSPHLE", &bDSPHLE, true);
   core->Get("TimingVariance", &iTimingVariance, 40);
   core->Get("CPUThread", &bCPUThread, true);
   core->Get("SyncOnSkipIdle", &bSyncGPUOnSkipIdleHack, true);
   core->Get("DefaultISO", &m_strDefaultISO);
   core->Get("EnableCheats", &bEnableCheats, true);
+  core->Get("GeckoNative", &bGeckoNative, false);
   core->Get("SDWritable", &bAllowSdWriting, true);
   core->Get("SelectedLanguage", &SelectedLanguage, 0);
   core->Get("OverrideGCLang", &bOverrideGCLanguage, false);
@@ -559,6 +592,15 @@ void SConfig::LoadCoreSettings(IniFile& ini)
   core->Get("AudioLatency", &iLatency, 20);
   core->Get("AudioStretch", &m_audio_stretch, false);
   core->Get("AudioStretchMaxLatency", &m_audio_stretch_max_latency, 80);
+  core->Get("AudioRateControl", &m_audio_rate_control, false);
+  core->Get("AudioSincResampler", &m_audio_sinc_resampler, false);
+  core->Get("AudioLowLatency", &m_audio_low_latency, false);
+  core->Get("Rewind", &m_rewind_enabled, false);
+  core->Get("RewindInterval", &m_rewind_interval, 30);
+  core->Get("RewindBufferSize", &m_rewind_buffer_size, 256);
+  core->Get("RunAheadFrames", &m_run_ahead_frames, 0);
+  core->Get("MemoryWatcherRing", &m_memory_watcher_ring, false);
+  core->Get("MemoryWatcherWatchpoints", &m_memory_watcher_watchpoints, false);
   core->Get("MemcardAPath", &m_strMemoryCardA);
   core->Get("MemcardBPath", &m_strMemoryCardB);
   core->Get("AgpCartAPath", &m_strGbaCartA);
@@ -586,8 +628,16 @@ void SConfig::LoadCoreSettings(IniFile& ini)
   core->Get("SyncGpuMaxDistance", &iSyncGpuMaxDistance, 200000);
   core->Get("SyncGpuMinDistance", &iSyncGpuMinDistance, -200000);
   core->Get("SyncGpuOverclock", &fSyncGpuOverclock, 1.0f);
+  core->Get("GpuWakeupThreshold", &iGpuWakeupThreshold, 0);
+  core->Get("GpuSyncMaxDeferredFields", &iGpuSyncMaxDeferredFields, 0);
+  core->Get("GpuFifoDirectRead", &bGpuFifoDirectRead, true);
   core->Get("FastDiscSpeed", &bFastDiscSpeed, false);
+  core->Get("DVDReadAhead", &m_dvd_read_ahead, 8);
+  core->Get("DVDAccessPatterns", &m_dvd_access_patterns, true);
+  core->Get("LateInputLatch", &m_late_input_latch, false);
+  core->Get("PreciseFrameLimiter", &m_precise_frame_limiter, false);
   core->Get("DCBZ", &bDCBZOFF, false);
+  core->Get("AccurateDataCache", &bAccurateDataCache, false);
   core->Get("LowDCBZHack", &bLowDCBZHack, false);
   core->Get("FPRF", &bFPRF, false);
   core->Get("AccurateNaNs", &bAccurateNaNs, false);
@@ -598,12 +648,16 @@ void SConfig::LoadCoreSettings(IniFile& ini)
   core->Get("GFXBackend", &m_strVideoBackend, "");
   core->Get("GPUDeterminismMode", &m_strGPUDeterminismMode, "auto");
   core->Get("PerfMapDir", &m_perfDir, "");
+  core->Get("PerfJitDump", &m_perfJitDump, false);
   core->Get("EnableCustomRTC", &bEnableCustomRTC, false);
   // Default to seconds between 1.1.1970 and 1.1.2000
   core->Get("CustomRTCValue", &m_customRTCValue, 946684800);
   core->Get("EnableSignatureChecks", &m_enable_signature_checks, true);
   core->Get("QoSEnabled", &bQoSEnabled, true);
   core->Get("AdapterWarning", &bAdapterWarning, true);
+  core->Get("AdapterPollRate", &m_adapter_poll_rate, 0);
+  core->Get("AdapterRealtimeThread", &m_adapter_realtime_thread, true);
+  core->Get("AdapterMatchPollTime", &m_adapter_match_poll_time, false);
   core->Get("WiiNetplaySaveReplays", &bSaveNetplayReplays, true);
 }
 
@@ -617,6 +671,7 @@ void SConfig::LoadMovieSettings(IniFile& ini)
   movie->Get("DumpFramesSilent", &m_DumpFramesSilent, false);
   movie->Get("ShowInputDisplay", &m_ShowInputDisplay, false);
   movie->Get("ShowRTC", &m_ShowRTC, false);
+  movie->Get("KeyframeInterval", &m_movie_keyframe_interval, 0);
 }
 
 void SConfig::LoadDSPSettings(IniFile& ini)
@@ -819,10 +874,18 @@ void SConfig::LoadDefaults()
   bMMU = false;
 #endif
   bDCBZOFF = false;
+  bAccurateDataCache = false;
   bLowDCBZHack = false;
   iBBDumpPort = -1;
   bSyncGPU = false;
+  iGpuWakeupThreshold = 0;
+  iGpuSyncMaxDeferredFields = 0;
+  bGpuFifoDirectRead = true;
   bFastDiscSpeed = false;
+  m_dvd_read_ahead = 8;
+  m_dvd_access_patterns = true;
+  m_late_input_latch = false;
+  m_precise_frame_limiter = false;
   m_strWiiSDCardPath = File::GetUserPath(F_WIISDCARD_IDX);
   bEnableMemcardSdWriting = true;
   bAllowSdWriting = true;
@@ -834,6 +897,16 @@ void SConfig::LoadDefaults()
   iLatency = 20;
   m_audio_stretch = false;
   m_audio_stretch_max_latency = 80;
+  m_audio_rate_control = false;
+  m_audio_sinc_resampler = false;
+  m_audio_low_latency = false;
+  m_rewind_enabled = false;
+  m_rewind_interval = 30;
+  m_rewind_buffer_size = 256;
+  m_run_ahead_frames = 0;
+  m_memory_watcher_ring = false;
+  m_memory_watcher_watchpoints = false;
+  m_movie_keyframe_interval = 0;
 
   iPosX = INT_MIN;
   iPosY = INT_MIN;
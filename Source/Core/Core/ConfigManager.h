@@ -82,9 +82,19 @@ struct SConfig
   bool bBootToPause = false;
 
   int iCPUCore;  // Uses the values of PowerPC::CPUCore
+  // Schedule CoreTiming events on a timing wheel instead of a heap.
+  bool bTimingWheel = false;
 
   bool bJITNoBlockCache = false;
   bool bJITNoBlockLinking = false;
+  // Remember the compiled blocks of each game and compile them up front on the next boot.
+  bool bJITPersistentCache = false;
+  // Run memcpy, DCFlushRange, PSMTXConcat and other hot library routines on the host.
+  bool bHLELibrary = false;
+  // Back emulated RAM and the JIT code cache with 2 MiB pages where the host supports it.
+  bool bHugePages = false;
+  // Size of the JIT code space in MiB, far code and trampolines grow along with it.
+  int iJITCodeCacheSize = 32;
   bool bJITOff = false;
   bool bJITLoadStoreOff = false;
   bool bJITLoadStorelXzOff = false;
@@ -109,9 +119,16 @@ struct SConfig
   bool bSyncGPUOnSkipIdleHack = true;
   bool bHLE_BS2 = true;
   bool bEnableCheats = true;
+  // Apply Gecko codes on the host instead of running the code handler, when all of them can be.
+  bool bGeckoNative = false;
   bool bNTSC = false;
   bool bQoSEnabled = true;
   bool bAdapterWarning = true;
+  // GC adapter reads per second, up to 1000; 0 reads as fast as the adapter sends reports.
+  int m_adapter_poll_rate = 0;
+  bool m_adapter_realtime_thread = true;
+  // Hand the game the adapter report read closest to the host time its SI poll is emulated for.
+  bool m_adapter_match_poll_time = false;
   bool bEnableMemcardSdWriting = true;
   bool bAllowSdWriting = true;
   bool bCopyWiiSaveNetplay = true;
@@ -121,24 +138,54 @@ struct SConfig
   int iLatency = 20;
   bool m_audio_stretch = false;
   int m_audio_stretch_max_latency = 80;
+  bool m_audio_rate_control = false;
+  bool m_audio_sinc_resampler = false;
+  bool m_audio_low_latency = false;
+
+  bool m_rewind_enabled = false;
+  int m_rewind_interval = 30;  // in fields
+  int m_rewind_buffer_size = 256;  // in MiB
+  int m_run_ahead_frames = 0;  // in fields
+  bool m_memory_watcher_ring = false;
+  bool m_memory_watcher_watchpoints = false;
 
   bool bRunCompareServer = false;
   bool bRunCompareClient = false;
 
   bool bMMU = false;
   bool bDCBZOFF = false;
+  bool bAccurateDataCache = false;
   bool bLowDCBZHack = false;
   int iBBDumpPort = 0;
   bool bFastDiscSpeed = false;
+  // Blocks the DVD thread reads ahead of the game, 0 turns read-ahead off.
+  int m_dvd_read_ahead = 8;
+  // Learn where each game seeks to and prefetch those blocks on later runs.
+  bool m_dvd_access_patterns = true;
   int iVideoRate = 8;
   bool bHalfAudioRate = false;
 
   PollingMethod iPollingMethod = POLLING_CONSOLE;
+  // Refresh the host input right before the game reads a controller instead of using the state
+  // sampled at the last SI poll.
+  bool m_late_input_latch = false;
+  // Spin through the last part of each frame limiter wait instead of sleeping, for steadier frame
+  // pacing at the cost of a busy CPU thread.
+  bool m_precise_frame_limiter = false;
 
   bool bSyncGPU = false;
   int iSyncGpuMaxDistance;
   int iSyncGpuMinDistance;
   float fSyncGpuOverclock;
+  // Dual core: gather pipe bursts wake a sleeping GPU thread once this many bytes are pending,
+  // the rest is picked up at the next VI field. 0 wakes it on every burst.
+  int iGpuWakeupThreshold = 0;
+  // Deterministic dual core: swap syncs are skipped while the GPU thread is busy, for at most this
+  // many fields in a row. 0 syncs at every swap.
+  int iGpuSyncMaxDeferredFields = 0;
+  // Dual core: the GPU thread decodes the FIFO where the CPU wrote it in emulated RAM instead of
+  // copying it to its own buffer first.
+  bool bGpuFifoDirectRead = true;
 
   int SelectedLanguage = 0;
   bool bOverrideGCLanguage = false;
@@ -205,6 +252,8 @@ struct SConfig
   std::string m_strWiiSDCardPath;
 
   std::string m_perfDir;
+  // Also write a jitdump file for perf inject, with the code and guest addresses of JIT blocks.
+  bool m_perfJitDump = false;
 
   std::string m_debugger_game_id;
   // TODO: remove this as soon as the ticket view hack in IOS/ES/Views is dropped.
@@ -300,8 +349,9 @@ struct SConfig
   bool m_ShowLag;
   bool m_ShowFrameCount;
   bool m_ShowRTC;
+  int m_movie_keyframe_interval = 0;  // in seconds, 0 disables keyframes
   std::string m_strMovieAuthor;
-  unsigned int m_FrameSkip;
+  unsigned int m_FrameSkip;  // frames skipped per rendered frame while fast-forwarding
   bool m_DumpFrames;
   bool m_DumpFramesSilent;
   bool m_ShowInputDisplay;
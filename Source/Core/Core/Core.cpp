@@ -6,6 +6,7 @@
 
 #include <atomic>
 #include <cstring>
+#include <future>
 #include <locale>
 #include <mutex>
 #include <queue>
@@ -30,6 +31,7 @@
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/Analytics.h"
 #include "Core/BootManager.h"
@@ -42,6 +44,8 @@
 #include "Core/MemoryWatcher.h"
 #endif
 #include "Core/Boot/Boot.h"
+#include "Core/Boot/BootTiming.h"
+#include "Core/Boot/FastBoot.h"
 #include "Core/FifoPlayer/FifoPlayer.h"
 #include "Core/HLE/HLE.h"
 #include "Core/HW/CPU.h"
@@ -61,6 +65,7 @@
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/State.h"
+#include "Core/ThreadPolicy.h"
 #include "Core/WiiRoot.h"
 
 #ifdef USE_GDBSTUB
@@ -102,6 +107,12 @@ static StateChangedCallbackFunc s_on_state_changed_callback;
 static std::thread s_cpu_thread;
 static bool s_request_refresh_info = false;
 static bool s_is_throttler_temp_disabled = false;
+static std::atomic<bool> s_is_output_suppressed{false};
+static std::atomic<u32> s_output_interval{0};
+static std::atomic<bool> s_is_field_hidden{false};
+static u32 s_output_interval_field = 0;
+static std::unique_ptr<::State::Snapshot> s_run_ahead_snapshot;
+static int s_run_ahead_fields_left = 0;
 static bool s_frame_step = false;
 
 struct HostJob
@@ -135,6 +146,30 @@ void SetIsThrottlerTempDisabled(bool disable)
   s_is_throttler_temp_disabled = disable;
 }
 
+bool IsOutputSuppressed()
+{
+  return s_is_output_suppressed.load(std::memory_order_relaxed) ||
+         s_is_field_hidden.load(std::memory_order_relaxed);
+}
+
+void SetOutputSuppressed(bool suppress)
+{
+  s_is_output_suppressed.store(suppress, std::memory_order_relaxed);
+}
+
+void SetOutputInterval(u32 fields)
+{
+  s_output_interval = fields;
+}
+
+// Called from VI at the end of every field, decides whether the next one is shown.
+void OutputIntervalFieldUpdate()
+{
+  const u32 interval = s_output_interval;
+  s_output_interval_field = interval > 1 ? (s_output_interval_field + 1) % interval : 0;
+  s_is_field_hidden = s_output_interval_field != 0;
+}
+
 void FrameUpdateOnCPUThread()
 {
   if (NetPlay::IsNetPlayRunning())
@@ -343,9 +378,13 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
   else
   {
     Common::SetCurrentThreadName("CPU-GPU thread");
-    video_backend->Video_Prepare();
+    {
+      BootTiming::ScopedPhase phase(BootTiming::Phase::VideoPrepare);
+      video_backend->Video_Prepare();
+    }
     Host_Message(WM_USER_CREATE);
   }
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::Role::CPU);
 
   // This needs to be delayed until after the video backend is ready.
   DolphinAnalytics::Instance()->ReportGameStart();
@@ -383,11 +422,18 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
     if (delete_savestate)
       File::Delete(*savestate_path);
   }
+  else
+  {
+    FastBoot::OnCPUThreadStart();
+  }
+
+  BootTiming::BeginPhase(BootTiming::Phase::FirstFrame);
 
   // Enter CPU run loop. When we leave it - we are done.
   CPU::Run();
 
   s_is_started = false;
+  DolphinAnalytics::Instance()->ReportGameEnd();
 
   if (!_CoreParameter.bCPUThread)
     video_backend->Video_Cleanup();
@@ -408,10 +454,14 @@ static void FifoPlayerThread(const std::optional<std::string>& savestate_path,
   }
   else
   {
-    video_backend->Video_Prepare();
+    {
+      BootTiming::ScopedPhase phase(BootTiming::Phase::VideoPrepare);
+      video_backend->Video_Prepare();
+    }
     Host_Message(WM_USER_CREATE);
     Common::SetCurrentThreadName("FIFO-GPU thread");
   }
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::Role::CPU);
 
   // Enter CPU run loop. When we leave it - we are done.
   if (auto cpu_core = FifoPlayer::GetInstance().GetCPUCore())
@@ -472,6 +522,18 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
 
   Common::SetCurrentThreadName("Emuthread - Starting");
   VideoBackendBase* video_backend = g_video_backend;
+  const u32 init_start_time = Common::Timer::GetTimeMs();
+
+  // Opening the audio device doesn't depend on anything below and can take a while with some
+  // backends, so it happens while the hardware, video backend and controllers are initialized.
+  std::future<void> audio_init = std::async(std::launch::async, AudioCommon::InitSoundStream);
+  Common::ScopeGuard audio_init_guard{ [&audio_init] {
+    // Only reached with a pending init if the boot failed before the audio guard below
+    if (!audio_init.valid())
+      return;
+    audio_init.wait();
+    AudioCommon::ShutdownSoundStream();
+  } };
 
   // For a time this acts as the CPU thread...
   DeclareAsCPUThread();
@@ -479,6 +541,7 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
   Movie::Init(*boot);
   Common::ScopeGuard movie_guard{ Movie::Shutdown };
 
+  BootTiming::BeginPhase(BootTiming::Phase::HardwareInit);
   HW::Init();
   Common::ScopeGuard hw_guard{ [] {
     // We must set up this flag before executing HW::Shutdown()
@@ -487,6 +550,12 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
     HW::Shutdown();
     INFO_LOG(CONSOLE, "%s", StopMessage(false, "HW shutdown").c_str());
 
+    s_run_ahead_snapshot.reset();
+    s_run_ahead_fields_left = 0;
+    SetOutputSuppressed(false);
+    s_output_interval_field = 0;
+    s_is_field_hidden = false;
+
     // Clear on screen messages that haven't expired
     OSD::ClearMessages();
 
@@ -496,12 +565,16 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
 
     PatchEngine::Shutdown();
     HLE::Clear();
+    FastBoot::Clear();
   } };
 
-  if (!video_backend->Initialize(s_window_handle))
   {
-    PanicAlert("Failed to initialize video backend!");
-    return;
+    BootTiming::ScopedPhase phase(BootTiming::Phase::VideoBackendInit);
+    if (!video_backend->Initialize(s_window_handle))
+    {
+      PanicAlert("Failed to initialize video backend!");
+      return;
+    }
   }
   Common::ScopeGuard video_guard{ [&] { video_backend->Shutdown(); } };
 
@@ -560,8 +633,11 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
     g_controller_interface.Shutdown();
   } };
 
-  AudioCommon::InitSoundStream();
+  audio_init.get();
   Common::ScopeGuard audio_guard{ AudioCommon::ShutdownSoundStream };
+  BootTiming::EndPhase(BootTiming::Phase::HardwareInit);
+  INFO_LOG(BOOT, "Emulated hardware initialized in %u ms",
+           Common::Timer::GetTimeMs() - init_start_time);
 
   // The hardware is initialized.
   s_hardware_initialized = true;
@@ -580,8 +656,11 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
   else
     cpuThreadFunc = CpuThread;
 
-  if (!CBoot::BootUp(std::move(boot)))
-    return;
+  {
+    BootTiming::ScopedPhase phase(BootTiming::Phase::BootUp);
+    if (!CBoot::BootUp(std::move(boot)))
+      return;
+  }
 
   // This adds the SyncGPU handler to CoreTiming, so now CoreTiming::Advance might block.
   Fifo::Prepare();
@@ -610,8 +689,12 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
     // This thread, after creating the EmuWindow, spawns a CPU
     // thread, and then takes over and becomes the video thread
     Common::SetCurrentThreadName("Video thread");
+    ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::Role::GPU);
 
-    video_backend->Video_Prepare();
+    {
+      BootTiming::ScopedPhase phase(BootTiming::Phase::VideoPrepare);
+      video_backend->Video_Prepare();
+    }
     Host_Message(WM_USER_CREATE);
 
     // Spawn the CPU thread
@@ -768,6 +851,28 @@ void SaveScreenShot(const std::string& name, bool wait_for_completion)
     SetState(State::Running);
 }
 
+void ToggleTraceCapture()
+{
+  if (!Common::Trace::IsCapturing())
+  {
+    Common::Trace::Start();
+    OSD::AddMessage("Trace capture started");
+    return;
+  }
+
+  const std::string path = File::GetUserPath(D_DUMP_IDX) + TRACE_DIR DIR_SEP +
+                           SConfig::GetInstance().GetGameID();
+  std::string name;
+  for (int i = 1; File::Exists(name = StringFromFormat("%s-%d.json", path.c_str(), i)); ++i)
+  {
+  }
+
+  if (Common::Trace::Stop(name))
+    OSD::AddMessage("Trace saved to " + name);
+  else
+    OSD::AddMessage("Failed to save trace to " + name);
+}
+
 void RequestRefreshInfo()
 {
   s_request_refresh_info = true;
@@ -856,6 +961,43 @@ void VideoThrottle()
   }
 }
 
+// Run-ahead, called from VI at the end of every field. After each real field a snapshot is
+// taken, and the next few fields are emulated as if the current input were held, with only the
+// last of them shown. Loading the snapshot then returns to the real field, which is emulated
+// without output. This hides as many fields of the game's own input lag.
+void RunAheadFieldUpdate()
+{
+  if (s_run_ahead_fields_left > 0)
+  {
+    if (--s_run_ahead_fields_left > 0)
+    {
+      SetOutputSuppressed(s_run_ahead_fields_left > 1);
+      return;
+    }
+
+    ::State::LoadFromSnapshot(*s_run_ahead_snapshot);
+    SetOutputSuppressed(true);
+    return;
+  }
+
+  const int fields = SConfig::GetInstance().m_run_ahead_frames;
+  if (fields <= 0 || NetPlay::IsNetPlayRunning() || Movie::IsMovieActive())
+  {
+    if (s_run_ahead_snapshot)
+    {
+      s_run_ahead_snapshot.reset();
+      SetOutputSuppressed(false);
+    }
+    return;
+  }
+
+  if (!s_run_ahead_snapshot)
+    s_run_ahead_snapshot = std::make_unique<::State::Snapshot>();
+  ::State::SaveToSnapshot(*s_run_ahead_snapshot);
+  s_run_ahead_fields_left = fields;
+  SetOutputSuppressed(fields > 1);
+}
+
 // Executed from GPU thread
 // reports if a frame should be skipped or not
 // depending on the emulation speed set
@@ -876,7 +1018,10 @@ bool ShouldSkipFrame(int skipped)
 void Callback_VideoCopiedToXFB(bool video_update)
 {
   if (video_update)
+  {
     s_drawn_frame++;
+    BootTiming::OnFrameDrawn();
+  }
 
   if (s_frame_step)
   {
@@ -943,6 +1088,13 @@ void UpdateTitle()
       SFPS += StringFromFormat(" | CPU: ~%i MHz [Real: %i + IdleSkip: %i] / %i MHz (~%3.0f%%)",
         (int)(diff), (int)(diff - idleDiff), (int)(idleDiff),
         SystemTimers::GetTicksPerSecond() / 1000000, TicksPercentage);
+
+      const SystemTimers::ThrottleStats throttle = SystemTimers::GetThrottleStats();
+      if (throttle.waits)
+      {
+        SFPS += StringFromFormat(" | Limiter: avg %+i us, max %+i us",
+          (int)throttle.average_error_us, (int)throttle.max_error_us);
+      }
     }
   }
 
@@ -24,6 +24,14 @@ namespace Core
 bool GetIsThrottlerTempDisabled();
 void SetIsThrottlerTempDisabled(bool disable);
 
+// While set, frames are emulated unthrottled and without video or audio output, e.g. to
+// re-simulate frames after a rollback.
+bool IsOutputSuppressed();
+void SetOutputSuppressed(bool suppress);
+// Only shows every Nth field, the others are emulated as if output was suppressed. 0 or 1 show
+// every field.
+void SetOutputInterval(u32 fields);
+
 void Callback_VideoCopiedToXFB(bool video_update);
 
 enum class State
@@ -59,6 +67,9 @@ State GetState();
 void SaveScreenShot(bool wait_for_completion = false);
 void SaveScreenShot(const std::string& name, bool wait_for_completion = false);
 
+// Starts a trace capture, or stops it and writes it to Dump/Trace.
+void ToggleTraceCapture();
+
 void Callback_WiimoteInterruptChannel(int _number, u16 _channelID, const void* _pData, u32 _Size);
 
 // This displays messages in a user-visible way.
@@ -68,6 +79,8 @@ void FrameUpdateOnCPUThread();
 
 bool ShouldSkipFrame(int skipped);
 void VideoThrottle();
+void RunAheadFieldUpdate();
+void OutputIntervalFieldUpdate();
 void RequestRefreshInfo();
 
 void UpdateTitle();
@@ -5,6 +5,7 @@
 #include "Core/CoreTiming.h"
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <mutex>
 #include <string>
@@ -17,10 +18,12 @@
 #include "Common/SPSCQueue.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Profiler.h"
 
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -31,6 +34,8 @@ struct EventType
 {
   TimedCallback callback;
   const std::string* name;
+  // First of this type's events in the timing wheel.
+  u32 first_wheel_node;
 };
 
 struct Event
@@ -51,6 +56,317 @@ static bool operator<(const Event& left, const Event& right)
   return std::tie(left.time, left.fifo_order) < std::tie(right.time, right.fifo_order);
 }
 
+// The alternative to the heap below, selected by Core/TimingWheel. Each of the levels has 256
+// slots, and an event goes into the level of the highest byte in which its time differs from
+// the wheel's current time, in the slot given by its time's byte in that level. Scheduling and
+// removing an event don't touch any other event, and as time moves on, events move down at most
+// once per level. Events that are due are moved into a heap, so they run in the same order as
+// with the heap scheduler.
+class TimingWheel
+{
+public:
+  void Clear(s64 now);
+  void Insert(const Event& event);
+  void Remove(EventType* type);
+
+  // Moves the wheel's current time forward to now, and makes the events up to it due.
+  void AdvanceTo(s64 now);
+  bool PopDue(s64 now, Event* event);
+
+  bool Empty() const { return m_due.empty() && m_free.size() == m_nodes.size(); }
+  // Time of the earliest event, which must exist.
+  s64 GetNextTime() const;
+  std::vector<Event> GetEvents() const;
+
+private:
+  static constexpr int LEVELS = 4;
+  static constexpr int SLOT_BITS = 8;
+  static constexpr u32 SLOTS = 1 << SLOT_BITS;
+  // Events that are more than 2^32 cycles out.
+  static constexpr u8 OVERFLOW_LEVEL = LEVELS;
+  static constexpr u8 FREE_LEVEL = 0xFF;
+  static constexpr u32 NONE = UINT32_MAX;
+
+  struct Node
+  {
+    Event event;
+    u32 prev;
+    u32 next;
+    u32 type_prev;
+    u32 type_next;
+    u8 level;
+    u8 slot;
+  };
+
+  u32& Head(u8 level, u8 slot)
+  {
+    return level == OVERFLOW_LEVEL ? m_overflow : m_slots[level][slot];
+  }
+  void Place(u32 index);
+  void Unlink(u32 index);
+  void Free(u32 index);
+  void ReplaceList(u32 head);
+  void ReplaceSlot(int level, u32 slot);
+
+  s64 m_now = 0;
+  std::vector<Node> m_nodes;
+  std::vector<u32> m_free;
+  std::array<std::array<u32, SLOTS>, LEVELS> m_slots;
+  std::array<std::array<u64, SLOTS / 64>, LEVELS> m_occupied;
+  u32 m_overflow = NONE;
+  // A min-heap, like s_event_queue.
+  std::vector<Event> m_due;
+};
+
+void TimingWheel::Clear(s64 now)
+{
+  for (const Node& node : m_nodes)
+  {
+    if (node.level != FREE_LEVEL)
+      node.event.type->first_wheel_node = NONE;
+  }
+  m_now = now;
+  m_nodes.clear();
+  m_free.clear();
+  for (auto& level : m_slots)
+    level.fill(NONE);
+  for (auto& level : m_occupied)
+    level.fill(0);
+  m_overflow = NONE;
+  m_due.clear();
+}
+
+void TimingWheel::Insert(const Event& event)
+{
+  if (event.time <= m_now)
+  {
+    m_due.push_back(event);
+    std::push_heap(m_due.begin(), m_due.end(), std::greater<Event>());
+    return;
+  }
+
+  u32 index;
+  if (m_free.empty())
+  {
+    index = static_cast<u32>(m_nodes.size());
+    m_nodes.emplace_back();
+  }
+  else
+  {
+    index = m_free.back();
+    m_free.pop_back();
+  }
+
+  Node& node = m_nodes[index];
+  node.event = event;
+  node.type_prev = NONE;
+  node.type_next = event.type->first_wheel_node;
+  if (node.type_next != NONE)
+    m_nodes[node.type_next].type_prev = index;
+  event.type->first_wheel_node = index;
+  Place(index);
+}
+
+void TimingWheel::Place(u32 index)
+{
+  Node& node = m_nodes[index];
+  if (node.event.time <= m_now)
+  {
+    m_due.push_back(node.event);
+    std::push_heap(m_due.begin(), m_due.end(), std::greater<Event>());
+    Free(index);
+    return;
+  }
+
+  const u64 diff = static_cast<u64>(node.event.time ^ m_now);
+  if (diff >> (LEVELS * SLOT_BITS))
+  {
+    node.level = OVERFLOW_LEVEL;
+    node.slot = 0;
+  }
+  else
+  {
+    node.level = 0;
+    while (diff >> ((node.level + 1) * SLOT_BITS))
+      node.level++;
+    node.slot = static_cast<u8>(node.event.time >> (node.level * SLOT_BITS));
+    m_occupied[node.level][node.slot / 64] |= 1ULL << (node.slot % 64);
+  }
+
+  u32& head = Head(node.level, node.slot);
+  node.prev = NONE;
+  node.next = head;
+  if (head != NONE)
+    m_nodes[head].prev = index;
+  head = index;
+}
+
+void TimingWheel::Unlink(u32 index)
+{
+  const Node& node = m_nodes[index];
+  if (node.next != NONE)
+    m_nodes[node.next].prev = node.prev;
+  if (node.prev != NONE)
+  {
+    m_nodes[node.prev].next = node.next;
+  }
+  else
+  {
+    Head(node.level, node.slot) = node.next;
+    if (node.next == NONE && node.level != OVERFLOW_LEVEL)
+      m_occupied[node.level][node.slot / 64] &= ~(1ULL << (node.slot % 64));
+  }
+}
+
+void TimingWheel::Free(u32 index)
+{
+  Node& node = m_nodes[index];
+  if (node.type_next != NONE)
+    m_nodes[node.type_next].type_prev = node.type_prev;
+  if (node.type_prev != NONE)
+    m_nodes[node.type_prev].type_next = node.type_next;
+  else
+    node.event.type->first_wheel_node = node.type_next;
+  node.level = FREE_LEVEL;
+  m_free.push_back(index);
+}
+
+void TimingWheel::Remove(EventType* type)
+{
+  while (type->first_wheel_node != NONE)
+  {
+    const u32 index = type->first_wheel_node;
+    Unlink(index);
+    Free(index);
+  }
+
+  auto itr = std::remove_if(m_due.begin(), m_due.end(),
+                            [&](const Event& e) { return e.type == type; });
+  if (itr != m_due.end())
+  {
+    m_due.erase(itr, m_due.end());
+    std::make_heap(m_due.begin(), m_due.end(), std::greater<Event>());
+  }
+}
+
+// Places every node of a list that has been taken out of its slot again.
+void TimingWheel::ReplaceList(u32 head)
+{
+  while (head != NONE)
+  {
+    const u32 next = m_nodes[head].next;
+    Place(head);
+    head = next;
+  }
+}
+
+void TimingWheel::ReplaceSlot(int level, u32 slot)
+{
+  u32& head = m_slots[level][slot];
+  const u32 list = head;
+  head = NONE;
+  m_occupied[level][slot / 64] &= ~(1ULL << (slot % 64));
+  ReplaceList(list);
+}
+
+void TimingWheel::AdvanceTo(s64 now)
+{
+  if (now < m_now)
+  {
+    // Only happens when the timer is set back by hand.
+    const std::vector<Event> events = GetEvents();
+    Clear(now);
+    for (const Event& event : events)
+      Insert(event);
+    return;
+  }
+
+  const u64 changed = static_cast<u64>(m_now ^ now);
+  const s64 before = m_now;
+  m_now = now;
+  if (changed >> (LEVELS * SLOT_BITS))
+  {
+    const u32 list = m_overflow;
+    m_overflow = NONE;
+    ReplaceList(list);
+  }
+
+  // Top down, so that nothing is placed into a slot that hasn't been looked at yet.
+  for (int level = LEVELS - 1; level >= 0; level--)
+  {
+    const int shift = level * SLOT_BITS;
+    if (changed >> (shift + SLOT_BITS))
+    {
+      // Everything in the level belonged to an earlier range of the level above.
+      for (u32 slot = 0; slot < SLOTS; slot++)
+      {
+        if (m_slots[level][slot] != NONE)
+          ReplaceSlot(level, slot);
+      }
+    }
+    else
+    {
+      const u32 first = static_cast<u32>((before >> shift) & (SLOTS - 1)) + 1;
+      const u32 last = static_cast<u32>((now >> shift) & (SLOTS - 1));
+      for (u32 slot = first; slot <= last; slot++)
+      {
+        if (m_slots[level][slot] != NONE)
+          ReplaceSlot(level, slot);
+      }
+    }
+  }
+}
+
+bool TimingWheel::PopDue(s64 now, Event* event)
+{
+  if (m_due.empty() || m_due.front().time > now)
+    return false;
+
+  *event = std::move(m_due.front());
+  std::pop_heap(m_due.begin(), m_due.end(), std::greater<Event>());
+  m_due.pop_back();
+  return true;
+}
+
+s64 TimingWheel::GetNextTime() const
+{
+  if (!m_due.empty())
+    return m_due.front().time;
+
+  // Everything in a level is earlier than everything in the levels above it.
+  for (int level = 0; level < LEVELS; level++)
+  {
+    for (u32 word = 0; word < SLOTS / 64; word++)
+    {
+      const u64 bits = m_occupied[level][word];
+      if (!bits)
+        continue;
+      u32 slot = word * 64;
+      while (!(bits & (1ULL << (slot % 64))))
+        slot++;
+      s64 time = INT64_MAX;
+      for (u32 index = m_slots[level][slot]; index != NONE; index = m_nodes[index].next)
+        time = std::min(time, m_nodes[index].event.time);
+      return time;
+    }
+  }
+  s64 time = INT64_MAX;
+  for (u32 index = m_overflow; index != NONE; index = m_nodes[index].next)
+    time = std::min(time, m_nodes[index].event.time);
+  return time;
+}
+
+std::vector<Event> TimingWheel::GetEvents() const
+{
+  std::vector<Event> events = m_due;
+  for (const Node& node : m_nodes)
+  {
+    if (node.level != FREE_LEVEL)
+      events.push_back(node.event);
+  }
+  return events;
+}
+
 // unordered_map stores each element separately as a linked list node so pointers to elements
 // remain stable regardless of rehashes/resizing.
 static std::unordered_map<std::string, EventType> s_event_types;
@@ -64,6 +380,8 @@ static std::vector<Event> s_event_queue;
 static u64 s_event_fifo_id;
 static std::mutex s_ts_write_lock;
 static Common::SPSCQueue<Event, false> s_ts_queue;
+static TimingWheel s_timing_wheel;
+static bool s_use_timing_wheel;
 
 static float s_last_OC_factor;
 static constexpr int MAX_SLICE_LENGTH = 20000;
@@ -100,6 +418,46 @@ static int CyclesToDowncount(int cycles)
   return static_cast<int>(cycles * s_last_OC_factor);
 }
 
+static bool IsEventQueueEmpty()
+{
+  return s_use_timing_wheel ? s_timing_wheel.Empty() : s_event_queue.empty();
+}
+
+static void PushEvent(const Event& ev)
+{
+  if (s_use_timing_wheel)
+  {
+    s_timing_wheel.Insert(ev);
+    return;
+  }
+  s_event_queue.emplace_back(ev);
+  std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+}
+
+// Takes out the earliest event if it is due.
+static bool PopDueEvent(Event* ev)
+{
+  if (s_use_timing_wheel)
+    return s_timing_wheel.PopDue(g.global_timer, ev);
+
+  if (s_event_queue.empty() || s_event_queue.front().time > g.global_timer)
+    return false;
+  *ev = std::move(s_event_queue.front());
+  std::pop_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+  s_event_queue.pop_back();
+  return true;
+}
+
+static s64 GetNextEventTime()
+{
+  return s_use_timing_wheel ? s_timing_wheel.GetNextTime() : s_event_queue.front().time;
+}
+
+static std::vector<Event> GetPendingEvents()
+{
+  return s_use_timing_wheel ? s_timing_wheel.GetEvents() : s_event_queue;
+}
+
 EventType* RegisterEvent(const std::string& name, TimedCallback callback)
 {
   // check for existing type with same name.
@@ -109,7 +467,7 @@ EventType* RegisterEvent(const std::string& name, TimedCallback callback)
                "during Init to avoid breaking save states.",
                name.c_str());
 
-  auto info = s_event_types.emplace(name, EventType{callback, nullptr});
+  auto info = s_event_types.emplace(name, EventType{callback, nullptr, UINT32_MAX});
   EventType* event_type = &info.first->second;
   event_type->name = &info.first->first;
   return event_type;
@@ -117,7 +475,7 @@ EventType* RegisterEvent(const std::string& name, TimedCallback callback)
 
 void UnregisterAllEvents()
 {
-  ASSERT_MSG(POWERPC, s_event_queue.empty(), "Cannot unregister events with events pending");
+  ASSERT_MSG(POWERPC, IsEventQueueEmpty(), "Cannot unregister events with events pending");
   s_event_types.clear();
 }
 
@@ -136,6 +494,8 @@ void Init()
   // that slice.
   s_is_global_timer_sane = true;
 
+  s_use_timing_wheel = SConfig::GetInstance().bTimingWheel;
+  s_timing_wheel.Clear(0);
   s_event_fifo_id = 0;
   s_ev_lost = RegisterEvent("_lost_event", &EmptyTimedCallback);
 }
@@ -165,7 +525,12 @@ void DoState(PointerWrap& p)
   p.DoMarker("CoreTimingData");
 
   MoveEvents();
-  p.DoEachElement(s_event_queue, [](PointerWrap& pw, Event& ev) {
+  // The wheel's events are saved as a list like the heap's, so states work with either.
+  std::vector<Event> wheel_events;
+  if (s_use_timing_wheel && p.GetMode() != PointerWrap::MODE_READ)
+    wheel_events = s_timing_wheel.GetEvents();
+  std::vector<Event>& events = s_use_timing_wheel ? wheel_events : s_event_queue;
+  p.DoEachElement(events, [](PointerWrap& pw, Event& ev) {
     pw.Do(ev.time);
     pw.Do(ev.fifo_order);
 
@@ -202,7 +567,18 @@ void DoState(PointerWrap& p)
   // The exact layout of the heap in memory is implementation defined, therefore it is platform
   // and library version specific.
   if (p.GetMode() == PointerWrap::MODE_READ)
-    std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+  {
+    if (s_use_timing_wheel)
+    {
+      s_timing_wheel.Clear(g.global_timer);
+      for (const Event& ev : wheel_events)
+        s_timing_wheel.Insert(ev);
+    }
+    else
+    {
+      std::make_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    }
+  }
 }
 
 // This should only be called from the CPU thread. If you are calling
@@ -226,6 +602,7 @@ u64 GetIdleTicks()
 void ClearPendingEvents()
 {
   s_event_queue.clear();
+  s_timing_wheel.Clear(g.global_timer);
 }
 
 void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata, FromThread from)
@@ -253,8 +630,7 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
     if (!s_is_global_timer_sane)
       ForceExceptionCheck(cycles_into_future);
 
-    s_event_queue.emplace_back(Event{timeout, s_event_fifo_id++, userdata, event_type});
-    std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    PushEvent(Event{timeout, s_event_fifo_id++, userdata, event_type});
   }
   else
   {
@@ -272,6 +648,12 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
 
 void RemoveEvent(EventType* event_type)
 {
+  if (s_use_timing_wheel)
+  {
+    s_timing_wheel.Remove(event_type);
+    return;
+  }
+
   auto itr = std::remove_if(s_event_queue.begin(), s_event_queue.end(),
                             [&](const Event& e) { return e.type == event_type; });
 
@@ -293,11 +675,8 @@ void RemoveAllEvents(EventType* event_type)
 void ProcessFifoWaitEvents()
 {
   MoveEvents();
-  while (!s_event_queue.empty() && s_event_queue.front().time <= g.global_timer)
+  for (Event evt; PopDueEvent(&evt);)
   {
-    Event evt = std::move(s_event_queue.front());
-    std::pop_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-    s_event_queue.pop_back();
     // NOTICE_LOG(POWERPC, "[Scheduler] %-20s (%lld, %lld)", evt.type->name->c_str(),
     //            g.global_timer, evt.time);
     evt.type->callback(evt.userdata, g.global_timer - evt.time);
@@ -321,13 +700,13 @@ void MoveEvents()
   for (Event ev; s_ts_queue.Pop(ev);)
   {
     ev.fifo_order = s_event_fifo_id++;
-    s_event_queue.emplace_back(std::move(ev));
-    std::push_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
+    PushEvent(ev);
   }
 }
 
 void Advance()
 {
+  TRACE_SCOPE("CoreTiming::Advance");
   MoveEvents();
 
   int cyclesExecuted = g.slice_length - DowncountToCycles(PowerPC::ppcState.downcount);
@@ -338,11 +717,11 @@ void Advance()
 
   s_is_global_timer_sane = true;
 
-  while (!s_event_queue.empty() && s_event_queue.front().time <= g.global_timer)
+  if (s_use_timing_wheel)
+    s_timing_wheel.AdvanceTo(g.global_timer);
+
+  for (Event evt; PopDueEvent(&evt);)
   {
-    Event evt = std::move(s_event_queue.front());
-    std::pop_heap(s_event_queue.begin(), s_event_queue.end(), std::greater<Event>());
-    s_event_queue.pop_back();
     // NOTICE_LOG(POWERPC, "[Scheduler] %-20s (%lld, %lld)", evt.type->name->c_str(),
     //            g.global_timer, evt.time);
     evt.type->callback(evt.userdata, g.global_timer - evt.time);
@@ -350,11 +729,14 @@ void Advance()
 
   s_is_global_timer_sane = false;
 
+  if (Profiler::g_sample_requested.load(std::memory_order_relaxed))
+    Profiler::TakeSample();
+
   // Still events left (scheduled in the future)
-  if (!s_event_queue.empty())
+  if (!IsEventQueueEmpty())
   {
-    g.slice_length = static_cast<int>(
-        std::min<s64>(s_event_queue.front().time - g.global_timer, MAX_SLICE_LENGTH));
+    g.slice_length =
+        static_cast<int>(std::min<s64>(GetNextEventTime() - g.global_timer, MAX_SLICE_LENGTH));
   }
 
   PowerPC::ppcState.downcount = CyclesToDowncount(g.slice_length);
@@ -368,7 +750,7 @@ void Advance()
 
 void LogPendingEvents()
 {
-  auto clone = s_event_queue;
+  auto clone = GetPendingEvents();
   std::sort(clone.begin(), clone.end());
   for (const Event& ev : clone)
   {
@@ -380,11 +762,21 @@ void LogPendingEvents()
 // Should only be called from the CPU thread after the PPC clock has changed
 void AdjustEventQueueTimes(u32 new_ppc_clock, u32 old_ppc_clock)
 {
-  for (Event& ev : s_event_queue)
+  std::vector<Event> wheel_events;
+  if (s_use_timing_wheel)
+  {
+    wheel_events = s_timing_wheel.GetEvents();
+    s_timing_wheel.Clear(g.global_timer);
+  }
+
+  for (Event& ev : s_use_timing_wheel ? wheel_events : s_event_queue)
   {
     const s64 ticks = (ev.time - g.global_timer) * new_ppc_clock / old_ppc_clock;
     ev.time = g.global_timer + ticks;
   }
+
+  for (const Event& ev : wheel_events)
+    s_timing_wheel.Insert(ev);
 }
 
 void Idle()
@@ -406,7 +798,7 @@ std::string GetScheduledEventsSummary()
   std::string text = "Scheduled events\n";
   text.reserve(1000);
 
-  auto clone = s_event_queue;
+  auto clone = GetPendingEvents();
   std::sort(clone.begin(), clone.end());
   for (const Event& ev : clone)
   {
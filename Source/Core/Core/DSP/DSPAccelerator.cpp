@@ -4,6 +4,8 @@
 
 #include "Core/DSP/DSPAccelerator.h"
 
+#include <algorithm>
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -160,6 +162,70 @@ u16 Accelerator::Read(s16* coefs)
   return val;
 }
 
+// Number of ADPCM samples that can be decoded from the current address by only
+// incrementing it: the run stops before the next frame header and before the
+// end address, where Read() has to handle the special cases.
+u32 Accelerator::GetADPCMRunLength() const
+{
+  u32 run = 15 - (m_current_address & 15);
+  if (m_current_address <= m_end_address)
+    run = std::min(run, m_end_address - m_current_address >= 2 ?
+                            m_end_address - m_current_address - 2 :
+                            0);
+  return run;
+}
+
+void Accelerator::DecodeADPCMRun(const s16* coefs, s16* samples, u32 count)
+{
+  const int scale = 1 << (m_pred_scale & 0xF);
+  const int coef_idx = (m_pred_scale >> 4) & 0x7;
+  const s32 coef1 = coefs[coef_idx * 2 + 0];
+  const s32 coef2 = coefs[coef_idx * 2 + 1];
+
+  s32 yn1 = m_yn1;
+  s32 yn2 = m_yn2;
+  u32 address = m_current_address;
+  u8 byte = ReadMemory(address >> 1);
+  for (u32 i = 0; i < count; ++i, ++address)
+  {
+    if (i != 0 && (address & 1) == 0)
+      byte = ReadMemory(address >> 1);
+
+    int temp = (address & 1) ? (byte & 0xF) : (byte >> 4);
+    if (temp >= 8)
+      temp -= 16;
+
+    const s32 val32 = (scale * temp) + ((0x400 + coef1 * yn1 + coef2 * yn2) >> 11);
+    yn2 = yn1;
+    yn1 = MathUtil::Clamp<s32>(val32, -0x7FFF, 0x7FFF);
+    samples[i] = static_cast<s16>(yn1);
+  }
+
+  m_yn1 = static_cast<s16>(yn1);
+  m_yn2 = static_cast<s16>(yn2);
+  m_current_address = address;
+}
+
+void Accelerator::ReadSamples(s16* coefs, s16* samples, u32 count)
+{
+  u32 i = 0;
+  while (i < count)
+  {
+    if (m_sample_format == 0x00 && !m_reads_stopped)
+    {
+      const u32 run = std::min(count - i, GetADPCMRunLength());
+      if (run != 0)
+      {
+        DecodeADPCMRun(coefs, samples + i, run);
+        i += run;
+        continue;
+      }
+    }
+
+    samples[i++] = static_cast<s16>(Read(coefs));
+  }
+}
+
 void Accelerator::DoState(PointerWrap& p)
 {
   p.Do(m_start_address);
@@ -16,6 +16,9 @@ public:
   virtual ~Accelerator() = default;
 
   u16 Read(s16* coefs);
+  // Same as calling Read() count times, but decodes runs of ADPCM samples
+  // within a frame without going through the per sample checks.
+  void ReadSamples(s16* coefs, s16* samples, u32 count);
   // Zelda ucode reads ARAM through 0xffd3.
   u16 ReadD3();
   void WriteD3(u16 value);
@@ -38,6 +41,9 @@ public:
   void DoState(PointerWrap& p);
 
 protected:
+  u32 GetADPCMRunLength() const;
+  void DecodeADPCMRun(const s16* coefs, s16* samples, u32 count);
+
   virtual void OnEndException() = 0;
   virtual u8 ReadMemory(u32 address) = 0;
   virtual void WriteMemory(u32 address, u8 value) = 0;
@@ -12,6 +12,7 @@
 #include "Common/BitSet.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/JitRegister.h"
 #include "Common/Logging/Log.h"
 
 #include "Core/DSP/DSPAnalyzer.h"
@@ -228,6 +229,7 @@ void DSPEmitter::Compile(u16 start_addr)
   m_compile_pc = start_addr;
   bool fixup_pc = false;
   m_block_size[start_addr] = 0;
+  m_code_lines.clear();
 
   while (m_compile_pc < start_addr + MAX_BLOCK_SIZE)
   {
@@ -237,6 +239,8 @@ void DSPEmitter::Compile(u16 start_addr)
     UDSPInstruction inst = dsp_imem_read(m_compile_pc);
     const DSPOPCTemplate* opcode = GetOpTemplate(inst);
 
+    if (JitRegister::IsEnabled())
+      m_code_lines.push_back({GetCodePtr(), m_compile_pc});
     EmitInstruction(inst);
 
     m_block_size[start_addr]++;
@@ -261,6 +265,9 @@ void DSPEmitter::Compile(u16 start_addr)
 
       if (!opcode->branch)
       {
+        if (!(Analyzer::GetCodeFlags(start_addr) & Analyzer::CODE_IDLE_SKIP))
+          WriteLoopLink();
+
         // branch insns update the g_dsp.pc
         MOV(16, M_SDSP_pc(), Imm16(m_compile_pc));
       }
@@ -329,6 +336,11 @@ void DSPEmitter::Compile(u16 start_addr)
 
   if (fixup_pc)
   {
+    // The block was cut short rather than ended by a branch, so link straight
+    // into the block that follows. Idle skip blocks are always entered through
+    // the dispatcher so that the skipped cycles are accounted for.
+    if (!(Analyzer::GetCodeFlags(m_compile_pc) & Analyzer::CODE_IDLE_SKIP))
+      WriteDirectLink(m_compile_pc);
     MOV(16, M_SDSP_pc(), Imm16(m_compile_pc));
   }
 
@@ -376,6 +388,9 @@ void DSPEmitter::Compile(u16 start_addr)
     MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
   }
   JMP(m_return_dispatcher, true);
+
+  JitRegister::RegisterLines(entryPoint, static_cast<u32>(GetCodePtr() - entryPoint), "JIT_DSP",
+                             m_code_lines, "JIT_DSP_%04x", start_addr);
 }
 
 static void CompileCurrent(DSPEmitter& emitter)
@@ -407,6 +422,7 @@ const u8* DSPEmitter::CompileStub()
   ABI_CallFunction(CompileCurrent);
   XOR(32, R(EAX), R(EAX));  // Return 0 cycles executed
   JMP(m_return_dispatcher);
+  JitRegister::Register(entryPoint, GetCodePtr(), "JIT_DSP_Stub");
   return entryPoint;
 }
 
@@ -454,6 +470,7 @@ void DSPEmitter::CompileDispatcher()
   // MOV(32, M(&cyclesLeft), Imm32(0));
   ABI_PopRegistersAndAdjustStack(registers_used, 8);
   RET();
+  JitRegister::Register(m_enter_dispatcher, GetCodePtr(), "JIT_DSP_Dispatcher");
 }
 
 Gen::OpArg DSPEmitter::M_SDSP_pc()
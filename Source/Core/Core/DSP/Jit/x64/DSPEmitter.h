@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/JitRegister.h"
 #include "Common/x64ABI.h"
 #include "Common/x64Emitter.h"
 
@@ -212,6 +213,7 @@ public:
 private:
   void WriteBranchExit();
   void WriteBlockLink(u16 dest);
+  void WriteDirectLink(u16 dest);
 
   void ReJitConditional(UDSPInstruction opc, void (DSPEmitter::*conditional_fn)(UDSPInstruction));
   void r_jcc(UDSPInstruction opc);
@@ -241,6 +243,7 @@ private:
 
   // Branch helpers
   void HandleLoop();
+  void WriteLoopLink();
 
   // CC helpers
   void Update_SR_Register64(Gen::X64Reg val = Gen::EAX, Gen::X64Reg scratch = Gen::EDX);
@@ -308,6 +311,8 @@ private:
   std::vector<u16> m_block_size;
   std::vector<Block> m_block_links;
   Block m_block_link_entry;
+  // Where the code of each instruction of the block being compiled starts, for JitRegister.
+  std::vector<JitRegister::CodeLine> m_code_lines;
 
   u16 m_cycles_left = 0;
 
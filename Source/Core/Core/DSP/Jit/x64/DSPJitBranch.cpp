@@ -104,27 +104,30 @@ void DSPEmitter::WriteBlockLink(u16 dest)
 {
   // Jump directly to the called block if it has already been compiled.
   if (!(dest >= m_start_address && dest <= m_compile_pc))
+    WriteDirectLink(dest);
+}
+
+void DSPEmitter::WriteDirectLink(u16 dest)
+{
+  if (m_block_links[dest] != nullptr)
   {
-    if (m_block_links[dest] != nullptr)
-    {
-      m_gpr.FlushRegs();
-      // Check if we have enough cycles to execute the next block
-      MOV(64, R(RAX), ImmPtr(&m_cycles_left));
-      MOV(16, R(ECX), MatR(RAX));
-      CMP(16, R(ECX), Imm16(m_block_size[m_start_address] + m_block_size[dest]));
-      FixupBranch notEnoughCycles = J_CC(CC_BE);
-
-      SUB(16, R(ECX), Imm16(m_block_size[m_start_address]));
-      MOV(16, MatR(RAX), R(ECX));
-      JMP(m_block_links[dest], true);
-      SetJumpTarget(notEnoughCycles);
-    }
-    else
-    {
-      // The destination has not been compiled yet.  Add it to the list
-      // of blocks that this block is waiting on.
-      m_unresolved_jumps[m_start_address].push_back(dest);
-    }
+    m_gpr.FlushRegsForLink();
+    // Check if we have enough cycles to execute the next block
+    MOV(64, R(RAX), ImmPtr(&m_cycles_left));
+    MOV(16, R(ECX), MatR(RAX));
+    CMP(16, R(ECX), Imm16(m_block_size[m_start_address] + m_block_size[dest]));
+    FixupBranch notEnoughCycles = J_CC(CC_BE);
+
+    SUB(16, R(ECX), Imm16(m_block_size[m_start_address]));
+    MOV(16, MatR(RAX), R(ECX));
+    JMP(m_block_links[dest], true);
+    SetJumpTarget(notEnoughCycles);
+  }
+  else
+  {
+    // The destination has not been compiled yet.  Add it to the list
+    // of blocks that this block is waiting on.
+    m_unresolved_jumps[m_start_address].push_back(dest);
   }
 }
 
@@ -321,6 +324,45 @@ void DSPEmitter::HandleLoop()
   SetJumpTarget(rLoopCntG);
 }
 
+// Fast path for the common case of a loop that restarts at the start of the
+// current block: as long as the counter does not run out and there are enough
+// cycles left, jump straight back to the block entry instead of going through
+// the dispatcher. Everything else is left to HandleLoop.
+void DSPEmitter::WriteLoopLink()
+{
+  const u16 block_cycles = m_block_size[m_start_address];
+
+  CMP(16, M_SDSP_r_st(2), Imm16(m_compile_pc - 1));
+  FixupBranch notLoopEnd = J_CC(CC_NE, true);
+  CMP(16, M_SDSP_r_st(0), Imm16(m_start_address));
+  FixupBranch notBlockStart = J_CC(CC_NE, true);
+
+  // Same condition as HandleLoop for the loop to continue.
+  MOV(16, R(EAX), M_SDSP_r_st(3));
+  SUB(16, R(EAX), Imm16(1));
+  TEST(16, R(EAX), R(EAX));
+  FixupBranch loopDone = J_CC(CC_LE, true);
+
+  MOV(64, R(RCX), ImmPtr(&m_cycles_left));
+  MOV(16, R(EDX), MatR(RCX));
+  CMP(16, R(EDX), Imm16(2 * block_cycles));
+  FixupBranch notEnoughCycles = J_CC(CC_BE, true);
+
+  MOV(16, M_SDSP_r_st(3), R(EAX));
+  SUB(16, R(EDX), Imm16(block_cycles));
+  MOV(16, MatR(RCX), R(EDX));
+
+  DSPJitRegCache c(m_gpr);
+  m_gpr.FlushRegsForLink();
+  JMP(m_block_link_entry, true);
+  m_gpr.FlushRegs(c, false);
+
+  SetJumpTarget(notLoopEnd);
+  SetJumpTarget(notBlockStart);
+  SetJumpTarget(loopDone);
+  SetJumpTarget(notEnoughCycles);
+}
+
 // LOOP $R
 // 0000 0000 010r rrrr
 // Repeatedly execute following opcode until counter specified by value
@@ -380,6 +380,21 @@ void DSPJitRegCache::FlushRegs()
   m_use_ctr = 0;
 }
 
+void DSPJitRegCache::FlushRegsForLink()
+{
+  // Leaves the static regs unshifted in their host regs, which is the state
+  // LoadRegs() establishes at the link entry of every block.
+  FlushMemBackedRegs();
+
+  for (size_t i = 0; i < m_regs.size(); i++)
+  {
+    ASSERT_MSG(DSPLLE, m_regs[i].loc.IsSimpleReg() == (m_regs[i].host_reg != INVALID_REG),
+      "register %zu is not in its link state", i);
+  }
+
+  m_use_ctr = 0;
+}
+
 void DSPJitRegCache::LoadRegs(bool emit)
 {
   for (size_t i = 0; i < m_regs.size(); i++)
@@ -387,6 +402,10 @@ void DSPJitRegCache::LoadRegs(bool emit)
     if (m_regs[i].host_reg != INVALID_REG)
     {
       MovToHostReg(i, m_regs[i].host_reg, emit);
+      // The block may have been entered through a link with this reg not
+      // yet written back, so it must be stored on the way out.
+      if (emit)
+        m_regs[i].dirty = true;
     }
   }
 }
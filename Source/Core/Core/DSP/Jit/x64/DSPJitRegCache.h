@@ -106,6 +106,9 @@ public:
 
   // Prepare state so that another flushed DSPJitRegCache can take over
   void FlushRegs();
+  // Prepare state for a direct jump to the link entry of a block. Unlike FlushRegs(),
+  // statically allocated regs are left live in their host regs without being written back.
+  void FlushRegsForLink();
 
   void LoadRegs(bool emit = true);  // Load statically allocated regs from memory
   void SaveRegs();                  // Save statically allocated regs to memory
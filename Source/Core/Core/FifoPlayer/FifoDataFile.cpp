@@ -9,14 +9,18 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <zlib.h>
 
 #include "Common/File.h"
+#include "Common/Logging/Log.h"
 
 enum
 {
   FILE_ID = 0x0d01f1f0,
-  VERSION_NUMBER = 4,
+  VERSION_NUMBER = 5,
   MIN_LOADER_VERSION = 1,
+  // Frames are compressed from version 5 on, older loaders can't read them.
+  MIN_COMPRESSED_LOADER_VERSION = 5,
 };
 
 #pragma pack(push, 1)
@@ -51,7 +55,10 @@ struct FileFrameInfo
   u32 fifoEnd;
   u64 memoryUpdatesOffset;
   u32 numMemoryUpdates;
-  u8 reserved[32];
+  // Only valid in compressed files.
+  u32 compressedSize;
+  u32 uncompressedSize;
+  u8 reserved[24];
 };
 static_assert(sizeof(FileFrameInfo) == 64, "FileFrameInfo should be 64 bytes");
 
@@ -68,6 +75,41 @@ static_assert(sizeof(FileMemoryUpdate) == 24, "FileMemoryUpdate should be 24 byt
 
 #pragma pack(pop)
 
+// Lays out a frame the way it is stored: the FIFO data, the memory update list and then the data
+// of every update. The offsets in the update list start at base.
+static std::vector<u8> BuildFrameBlock(const FifoFrameInfo& frame, u64 base,
+                                       u64* memoryUpdatesOffset)
+{
+  const size_t listOffset = frame.fifoData.size();
+  size_t dataOffset = listOffset + frame.memoryUpdates.size() * sizeof(FileMemoryUpdate);
+  size_t size = dataOffset;
+  for (const MemoryUpdate& update : frame.memoryUpdates)
+    size += update.data.size();
+
+  std::vector<u8> block(size);
+  std::copy(frame.fifoData.begin(), frame.fifoData.end(), block.begin());
+
+  for (size_t i = 0; i < frame.memoryUpdates.size(); ++i)
+  {
+    const MemoryUpdate& srcUpdate = frame.memoryUpdates[i];
+
+    FileMemoryUpdate dstUpdate = {};
+    dstUpdate.address = srcUpdate.address;
+    dstUpdate.dataOffset = base + dataOffset;
+    dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
+    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+    dstUpdate.type = srcUpdate.type;
+    std::memcpy(&block[listOffset + i * sizeof(FileMemoryUpdate)], &dstUpdate,
+                sizeof(FileMemoryUpdate));
+
+    std::copy(srcUpdate.data.begin(), srcUpdate.data.end(), block.begin() + dataOffset);
+    dataOffset += srcUpdate.data.size();
+  }
+
+  *memoryUpdatesOffset = base + listOffset;
+  return block;
+}
+
 FifoDataFile::FifoDataFile() = default;
 
 FifoDataFile::~FifoDataFile() = default;
@@ -94,21 +136,46 @@ bool FifoDataFile::GetIsWii() const
 
 void FifoDataFile::AddFrame(const FifoFrameInfo& frameInfo)
 {
-  m_Frames.push_back(frameInfo);
+  m_Frames.push_back(std::make_shared<FifoFrameInfo>(frameInfo));
+}
+
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::GetFrame(u32 frame) const
+{
+  if (!m_File)
+    return m_Frames[frame];
+
+  std::lock_guard<std::mutex> lock(m_FileLock);
+  auto iter = std::find_if(m_FrameCache.begin(), m_FrameCache.end(),
+                           [frame](const auto& entry) { return entry.first == frame; });
+  if (iter != m_FrameCache.end())
+    return iter->second;
+
+  std::shared_ptr<const FifoFrameInfo> frameInfo = ReadFrame(m_FrameLocations[frame]);
+  if (m_FrameCache.size() >= FRAME_CACHE_SIZE)
+    m_FrameCache.erase(m_FrameCache.begin());
+  m_FrameCache.emplace_back(frame, frameInfo);
+  return frameInfo;
 }
 
-bool FifoDataFile::Save(const std::string& filename)
+u32 FifoDataFile::GetFrameCount() const
+{
+  return static_cast<u32>(m_File ? m_FrameLocations.size() : m_Frames.size());
+}
+
+bool FifoDataFile::Save(const std::string& filename, bool compressFrames)
 {
   File::IOFile file;
   if (!file.Open(filename, "wb"))
     return false;
 
+  const u32 frameCount = GetFrameCount();
+
   // Add space for header
   PadFile(sizeof(FileHeader), file);
 
   // Add space for frame list
   u64 frameListOffset = file.Tell();
-  PadFile(m_Frames.size() * sizeof(FileFrameInfo), file);
+  PadFile(frameCount * sizeof(FileFrameInfo), file);
 
   u64 bpMemOffset = file.Tell();
   file.WriteArray(m_BPMem, BP_MEM_SIZE);
@@ -126,10 +193,10 @@ bool FifoDataFile::Save(const std::string& filename)
   file.WriteArray(m_TexMem, TEX_MEM_SIZE);
 
   // Write header
-  FileHeader header;
+  FileHeader header = {};
   header.fileId = FILE_ID;
   header.file_version = VERSION_NUMBER;
-  header.min_loader_version = MIN_LOADER_VERSION;
+  header.min_loader_version = compressFrames ? MIN_COMPRESSED_LOADER_VERSION : MIN_LOADER_VERSION;
 
   header.bpMemOffset = bpMemOffset;
   header.bpMemSize = BP_MEM_SIZE;
@@ -147,32 +214,50 @@ bool FifoDataFile::Save(const std::string& filename)
   header.texMemSize = TEX_MEM_SIZE;
 
   header.frameListOffset = frameListOffset;
-  header.frameCount = (u32)m_Frames.size();
+  header.frameCount = frameCount;
 
-  header.flags = m_Flags;
+  header.flags = compressFrames ? (m_Flags | FLAG_COMPRESSED) : (m_Flags & ~FLAG_COMPRESSED);
 
   file.Seek(0, SEEK_SET);
   file.WriteBytes(&header, sizeof(FileHeader));
 
   // Write frames list
-  for (unsigned int i = 0; i < m_Frames.size(); ++i)
+  for (u32 i = 0; i < frameCount; ++i)
   {
-    const FifoFrameInfo& srcFrame = m_Frames[i];
+    const std::shared_ptr<const FifoFrameInfo> srcFrame = GetFrame(i);
 
-    // Write FIFO data
     file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcFrame.fifoData.data(), srcFrame.fifoData.size());
-
-    u64 memoryUpdatesOffset = WriteMemoryUpdates(srcFrame.memoryUpdates, file);
-
-    FileFrameInfo dstFrame;
-    dstFrame.fifoDataSize = static_cast<u32>(srcFrame.fifoData.size());
+    const u64 dataOffset = file.Tell();
+
+    FileFrameInfo dstFrame = {};
+    u64 memoryUpdatesOffset;
+    if (compressFrames)
+    {
+      // Each frame is its own zlib stream so playback can start at any frame.
+      const std::vector<u8> block = BuildFrameBlock(*srcFrame, 0, &memoryUpdatesOffset);
+      std::vector<u8> compressed(compressBound(static_cast<uLong>(block.size())));
+      uLongf compressedSize = static_cast<uLongf>(compressed.size());
+      if (compress2(compressed.data(), &compressedSize, block.data(),
+                    static_cast<uLong>(block.size()), Z_BEST_SPEED) != Z_OK)
+      {
+        return false;
+      }
+      file.WriteBytes(compressed.data(), compressedSize);
+      dstFrame.compressedSize = static_cast<u32>(compressedSize);
+      dstFrame.uncompressedSize = static_cast<u32>(block.size());
+    }
+    else
+    {
+      const std::vector<u8> block = BuildFrameBlock(*srcFrame, dataOffset, &memoryUpdatesOffset);
+      file.WriteBytes(block.data(), block.size());
+    }
+
+    dstFrame.fifoDataSize = static_cast<u32>(srcFrame->fifoData.size());
     dstFrame.fifoDataOffset = dataOffset;
-    dstFrame.fifoStart = srcFrame.fifoStart;
-    dstFrame.fifoEnd = srcFrame.fifoEnd;
+    dstFrame.fifoStart = srcFrame->fifoStart;
+    dstFrame.fifoEnd = srcFrame->fifoEnd;
     dstFrame.memoryUpdatesOffset = memoryUpdatesOffset;
-    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame.memoryUpdates.size());
+    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame->memoryUpdates.size());
 
     // Write frame info
     u64 frameOffset = frameListOffset + (i * sizeof(FileFrameInfo));
@@ -204,7 +289,7 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
 
   auto dataFile = std::make_unique<FifoDataFile>();
 
-  dataFile->m_Flags = header.flags;
+  dataFile->m_Flags = header.flags & ~FLAG_COMPRESSED;
   dataFile->m_Version = header.file_version;
 
   if (flagsOnly)
@@ -238,29 +323,29 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
     file.ReadArray(dataFile->m_TexMem, size);
   }
 
-  // Read frames
-  for (u32 i = 0; i < header.frameCount; ++i)
-  {
-    u64 frameOffset = header.frameListOffset + (i * sizeof(FileFrameInfo));
-    file.Seek(frameOffset, SEEK_SET);
-    FileFrameInfo srcFrame;
-    file.ReadBytes(&srcFrame, sizeof(FileFrameInfo));
-
-    FifoFrameInfo dstFrame;
-    dstFrame.fifoData.resize(srcFrame.fifoDataSize);
-    dstFrame.fifoStart = srcFrame.fifoStart;
-    dstFrame.fifoEnd = srcFrame.fifoEnd;
-
-    file.Seek(srcFrame.fifoDataOffset, SEEK_SET);
-    file.ReadBytes(dstFrame.fifoData.data(), srcFrame.fifoDataSize);
+  // Only the frame index is read, the frames themselves are read when they are played.
+  const bool compressed = dataFile->m_Version >= 5 && (header.flags & FLAG_COMPRESSED);
 
-    ReadMemoryUpdates(srcFrame.memoryUpdatesOffset, srcFrame.numMemoryUpdates,
-                      dstFrame.memoryUpdates, file);
+  std::vector<FileFrameInfo> frames(header.frameCount);
+  file.Seek(header.frameListOffset, SEEK_SET);
+  file.ReadArray(frames.data(), frames.size());
 
-    dataFile->AddFrame(dstFrame);
+  dataFile->m_FrameLocations.reserve(frames.size());
+  for (const FileFrameInfo& srcFrame : frames)
+  {
+    FrameLocation location;
+    location.fifoDataOffset = srcFrame.fifoDataOffset;
+    location.fifoDataSize = srcFrame.fifoDataSize;
+    location.fifoStart = srcFrame.fifoStart;
+    location.fifoEnd = srcFrame.fifoEnd;
+    location.memoryUpdatesOffset = srcFrame.memoryUpdatesOffset;
+    location.numMemoryUpdates = srcFrame.numMemoryUpdates;
+    location.compressedSize = compressed ? srcFrame.compressedSize : 0;
+    location.uncompressedSize = compressed ? srcFrame.uncompressedSize : 0;
+    dataFile->m_FrameLocations.push_back(location);
   }
 
-  file.Close();
+  dataFile->m_File = std::make_unique<File::IOFile>(std::move(file));
 
   return dataFile;
 }
@@ -284,56 +369,66 @@ bool FifoDataFile::GetFlag(u32 flag) const
   return !!(m_Flags & flag);
 }
 
-u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates,
-                                     File::IOFile& file)
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::ReadFrame(const FrameLocation& location) const
 {
-  // Add space for memory update list
-  u64 updateListOffset = file.Tell();
-  PadFile(memUpdates.size() * sizeof(FileMemoryUpdate), file);
+  m_File->Clear();
 
-  for (unsigned int i = 0; i < memUpdates.size(); ++i)
+  std::vector<u8> block;
+  bool good = true;
+  if (location.compressedSize)
   {
-    const MemoryUpdate& srcUpdate = memUpdates[i];
-
-    // Write memory
-    file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcUpdate.data.data(), srcUpdate.data.size());
-
-    FileMemoryUpdate dstUpdate;
-    dstUpdate.address = srcUpdate.address;
-    dstUpdate.dataOffset = dataOffset;
-    dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
-    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
-    dstUpdate.type = srcUpdate.type;
-
-    u64 updateOffset = updateListOffset + (i * sizeof(FileMemoryUpdate));
-    file.Seek(updateOffset, SEEK_SET);
-    file.WriteBytes(&dstUpdate, sizeof(FileMemoryUpdate));
+    std::vector<u8> compressed(location.compressedSize);
+    block.resize(location.uncompressedSize);
+    uLongf size = static_cast<uLongf>(block.size());
+    good = m_File->Seek(location.fifoDataOffset, SEEK_SET) &&
+           m_File->ReadBytes(compressed.data(), compressed.size()) &&
+           uncompress(block.data(), &size, compressed.data(),
+                      static_cast<uLong>(compressed.size())) == Z_OK &&
+           size == block.size();
   }
 
-  return updateListOffset;
-}
-
-void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
-                                     std::vector<MemoryUpdate>& memUpdates, File::IOFile& file)
-{
-  memUpdates.resize(numUpdates);
-
-  for (u32 i = 0; i < numUpdates; ++i)
+  // Offsets of compressed frames are relative to the decompressed block.
+  auto read = [&](u64 offset, void* data, size_t size) {
+    if (!location.compressedSize)
+      return m_File->Seek(offset, SEEK_SET) && m_File->ReadBytes(data, size);
+    if (offset > block.size() || size > block.size() - offset)
+      return false;
+    if (size)
+      std::memcpy(data, block.data() + offset, size);
+    return true;
+  };
+
+  auto frame = std::make_shared<FifoFrameInfo>();
+  frame->fifoStart = location.fifoStart;
+  frame->fifoEnd = location.fifoEnd;
+
+  frame->fifoData.resize(location.fifoDataSize);
+  good = good && read(location.compressedSize ? 0 : location.fifoDataOffset,
+                      frame->fifoData.data(), frame->fifoData.size());
+
+  frame->memoryUpdates.resize(location.numMemoryUpdates);
+  for (u32 i = 0; good && i < location.numMemoryUpdates; ++i)
   {
-    u64 updateOffset = fileOffset + (i * sizeof(FileMemoryUpdate));
-    file.Seek(updateOffset, SEEK_SET);
     FileMemoryUpdate srcUpdate;
-    file.ReadBytes(&srcUpdate, sizeof(FileMemoryUpdate));
+    good = read(location.memoryUpdatesOffset + (i * sizeof(FileMemoryUpdate)), &srcUpdate,
+                sizeof(FileMemoryUpdate));
+    if (!good)
+      break;
 
-    MemoryUpdate& dstUpdate = memUpdates[i];
+    MemoryUpdate& dstUpdate = frame->memoryUpdates[i];
     dstUpdate.address = srcUpdate.address;
     dstUpdate.fifoPosition = srcUpdate.fifoPosition;
     dstUpdate.data.resize(srcUpdate.dataSize);
     dstUpdate.type = static_cast<MemoryUpdate::Type>(srcUpdate.type);
+    good = read(srcUpdate.dataOffset, dstUpdate.data.data(), srcUpdate.dataSize);
+  }
 
-    file.Seek(srcUpdate.dataOffset, SEEK_SET);
-    file.ReadBytes(dstUpdate.data.data(), srcUpdate.dataSize);
+  if (!good)
+  {
+    ERROR_LOG(VIDEO, "Failed to read a frame of the FIFO log");
+    frame->fifoData.clear();
+    frame->memoryUpdates.clear();
   }
+
+  return frame;
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -68,26 +69,45 @@ public:
   u32* GetXFRegs() { return m_XFRegs; }
   u8* GetTexMem() { return m_TexMem; }
   void AddFrame(const FifoFrameInfo& frameInfo);
-  const FifoFrameInfo& GetFrame(u32 frame) const { return m_Frames[frame]; }
-  u32 GetFrameCount() const { return static_cast<u32>(m_Frames.size()); }
-  bool Save(const std::string& filename);
+  // Frames of a loaded file are read from disk when they are asked for. The frame stays valid
+  // for as long as the caller holds on to it.
+  std::shared_ptr<const FifoFrameInfo> GetFrame(u32 frame) const;
+  u32 GetFrameCount() const;
+  // Compressed files can only be played back by version 5 loaders and up.
+  bool Save(const std::string& filename, bool compressFrames = true);
 
   static std::unique_ptr<FifoDataFile> Load(const std::string& filename, bool flagsOnly);
 
 private:
   enum
   {
-    FLAG_IS_WII = 1
+    FLAG_IS_WII = 1,
+    FLAG_COMPRESSED = 2,
   };
 
+  // Where a frame of a loaded file is stored. Compressed frames are a single zlib stream at
+  // fifoDataOffset, and the other offsets are relative to its decompressed start.
+  struct FrameLocation
+  {
+    u64 fifoDataOffset;
+    u32 fifoDataSize;
+    u32 fifoStart;
+    u32 fifoEnd;
+    u64 memoryUpdatesOffset;
+    u32 numMemoryUpdates;
+    u32 compressedSize;
+    u32 uncompressedSize;
+  };
+
+  // Playback mostly asks for the same frame a few times in a row.
+  static constexpr size_t FRAME_CACHE_SIZE = 4;
+
   void PadFile(size_t numBytes, File::IOFile& file);
 
   void SetFlag(u32 flag, bool set);
   bool GetFlag(u32 flag) const;
 
-  u64 WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
-  static void ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
-                                std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
+  std::shared_ptr<const FifoFrameInfo> ReadFrame(const FrameLocation& location) const;
 
   u32 m_BPMem[BP_MEM_SIZE];
   u32 m_CPMem[CP_MEM_SIZE];
@@ -98,5 +118,12 @@ private:
   u32 m_Flags = 0;
   u32 m_Version = 0;
 
-  std::vector<FifoFrameInfo> m_Frames;
+  // Recorded frames, loaded files only keep where their frames are.
+  std::vector<std::shared_ptr<const FifoFrameInfo>> m_Frames;
+
+  // Loaded files stay open, only the frame index is kept in memory.
+  std::unique_ptr<File::IOFile> m_File;
+  std::vector<FrameLocation> m_FrameLocations;
+  mutable std::mutex m_FileLock;
+  mutable std::vector<std::pair<u32, std::shared_ptr<const FifoFrameInfo>>> m_FrameCache;
 };
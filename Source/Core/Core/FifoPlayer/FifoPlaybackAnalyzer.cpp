@@ -40,7 +40,8 @@ void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file,
 
   for (u32 frameIdx = 0; frameIdx < file->GetFrameCount(); ++frameIdx)
   {
-    const FifoFrameInfo& frame = file->GetFrame(frameIdx);
+    const std::shared_ptr<const FifoFrameInfo> frame_ptr = file->GetFrame(frameIdx);
+    const FifoFrameInfo& frame = *frame_ptr;
     AnalyzedFrameInfo& analyzed = frameInfo[frameIdx];
 
     s_DrawingObject = false;
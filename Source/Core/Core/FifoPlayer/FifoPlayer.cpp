@@ -25,6 +25,7 @@
 #include "Core/PowerPC/PowerPC.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/DrawProfiler.h"
 
 // We need to include TextureDecoder.h for the texMem array.
 // TODO: Move texMem somewhere else so this isn't an issue.
@@ -86,6 +87,7 @@ public:
     IsPlayingBackFifologWithBrokenEFBCopies = m_parent->m_File->HasBrokenEFBCopies();
 
     m_parent->m_CurrentFrame = m_parent->m_FrameRangeStart;
+    m_parent->m_LoopsPlayed = 0;
     m_parent->LoadMemory();
   }
 
@@ -133,7 +135,9 @@ CPU::State FifoPlayer::AdvanceFrame()
 {
   if (m_CurrentFrame >= m_FrameRangeEnd)
   {
-    if (!m_Loop)
+    ++m_LoopsPlayed;
+    const bool loop = m_LoopLimit ? m_LoopsPlayed < m_LoopLimit : m_Loop;
+    if (!loop)
       return CPU::State::PowerDown;
     // If there are zero frames in the range then sleep instead of busy spinning
     if (m_FrameRangeStart >= m_FrameRangeEnd)
@@ -154,7 +158,7 @@ CPU::State FifoPlayer::AdvanceFrame()
   if (m_EarlyMemoryUpdates && m_CurrentFrame == m_FrameRangeStart)
     WriteAllMemoryUpdates();
 
-  WriteFrame(m_File->GetFrame(m_CurrentFrame), m_FrameInfo[m_CurrentFrame]);
+  WriteFrame(*m_File->GetFrame(m_CurrentFrame), m_FrameInfo[m_CurrentFrame]);
 
   ++m_CurrentFrame;
   return CPU::State::Running;
@@ -188,6 +192,12 @@ u32 FifoPlayer::GetFrameObjectCount() const
   return 0;
 }
 
+void FifoPlayer::SetProfileDraws(bool enabled)
+{
+  m_ProfileDraws = enabled;
+  DrawProfiler::SetEnabled(enabled);
+}
+
 void FifoPlayer::SetFrameRangeStart(u32 start)
 {
   if (m_File)
@@ -263,7 +273,17 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
     }
 
     // Write objects in draw range
-    if (objectNum < numObjects && drawStart <= drawEnd)
+    if (m_ProfileDraws)
+    {
+      for (; objectNum < numObjects && objectNum <= drawEnd; ++objectNum)
+      {
+        DrawProfiler::SetCurrentObject(m_LoopsPlayed, m_CurrentFrame, objectNum);
+        WriteFramePart(position, info.objectEnds[objectNum], memoryUpdate, frame, info);
+        position = info.objectEnds[objectNum];
+        WaitForGPUIdle();
+      }
+    }
+    else if (objectNum < numObjects && drawStart <= drawEnd)
     {
       objectNum = drawEnd;
       WriteFramePart(position, info.objectEnds[objectNum], memoryUpdate, frame, info);
@@ -284,6 +304,11 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
   // Write data after the last object
   WriteFramePart(position, static_cast<u32>(frame.fifoData.size()), memoryUpdate, frame, info);
 
+  WaitForGPUIdle();
+}
+
+void FifoPlayer::WaitForGPUIdle()
+{
   FlushWGP();
 
   // Sleep while the GPU is active
@@ -332,8 +357,8 @@ void FifoPlayer::WriteAllMemoryUpdates()
 
   for (u32 frameNum = 0; frameNum < m_File->GetFrameCount(); ++frameNum)
   {
-    const FifoFrameInfo& frame = m_File->GetFrame(frameNum);
-    for (auto& update : frame.memoryUpdates)
+    const std::shared_ptr<const FifoFrameInfo> frame = m_File->GetFrame(frameNum);
+    for (auto& update : frame->memoryUpdates)
     {
       WriteMemory(update);
     }
@@ -388,7 +413,8 @@ void FifoPlayer::SetupFifo()
   WriteCP(CommandProcessor::CTRL_REGISTER, 0);   // disable read, BP, interrupts
   WriteCP(CommandProcessor::CLEAR_REGISTER, 7);  // clear overflow, underflow, metrics
 
-  const FifoFrameInfo& frame = m_File->GetFrame(m_CurrentFrame);
+  const std::shared_ptr<const FifoFrameInfo> frame_ptr = m_File->GetFrame(m_CurrentFrame);
+  const FifoFrameInfo& frame = *frame_ptr;
 
   // Set fifo bounds
   WriteCP(CommandProcessor::FIFO_BASE_LO, frame.fifoStart);
@@ -92,6 +92,12 @@ public:
   // If enabled then all memory updates happen at once before the first frame
   // Default is disabled
   void SetEarlyMemoryUpdates(bool enabled) { m_EarlyMemoryUpdates = enabled; }
+  // Powers down after the frame range was played this many times, 0 leaves it to the loop
+  // setting
+  void SetLoopLimit(u32 loops) { m_LoopLimit = loops; }
+  // Writes the objects in the range one at a time and waits for the GPU after each, so that
+  // DrawProfiler can attribute every draw to its object. Enables DrawProfiler too.
+  void SetProfileDraws(bool enabled);
   // Callbacks
   void SetFileLoadedCallback(CallbackFunc callback) { m_FileLoadedCb = callback; }
   void SetFrameWrittenCallback(CallbackFunc callback) { m_FrameWrittenCb = callback; }
@@ -109,6 +115,8 @@ private:
   void WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate, const FifoFrameInfo& frame,
     const AnalyzedFrameInfo& info);
 
+  void WaitForGPUIdle();
+
   void WriteAllMemoryUpdates();
   void WriteMemory(const MemoryUpdate& memUpdate);
 
@@ -148,6 +156,11 @@ private:
 
   bool m_EarlyMemoryUpdates = false;
 
+  u32 m_LoopLimit = 0;
+  u32 m_LoopsPlayed = 0;
+
+  bool m_ProfileDraws = false;
+
   u64 m_CyclesPerFrame = 0;
   u32 m_ElapsedCycles = 0;
   u32 m_FrameFifoSize = 0;
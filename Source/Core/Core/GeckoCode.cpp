@@ -17,6 +17,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/HW/Memmap.h"
 #include "Core/NetPlayProto.h"
+#include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
 
 #include <iostream>
@@ -24,6 +25,7 @@
 namespace Gecko
 {
 static constexpr u32 CODE_SIZE = 8;
+static constexpr u32 CODE_LIST_MAGIC = 0x00d0c0de;
 
 bool operator==(const GeckoCode& lhs, const GeckoCode& rhs)
 {
@@ -64,6 +66,68 @@ static Installation s_code_handler_installed = Installation::Uninstalled;
 // the currently active codes
 static std::vector<GeckoCode> s_active_codes;
 static std::mutex s_active_codes_lock;
+// Whether every active code is of a type RunCodesOnHost understands.
+static bool s_codes_supported_on_host = false;
+// The first code in the GCT, or 0 if it has to be looked up again.
+static u32 s_code_list_address = 0;
+
+// Number of lines of data that follow a string write or a C2 code.
+static u32 GetDataLines(u32 address, u32 data)
+{
+  switch ((address >> 24) & 0xEE)
+  {
+  case 0x06:
+    return (data + 7) / 8;
+  case 0xC2:
+    return data;
+  default:
+    return 0;
+  }
+}
+
+// Codes made only of the 8/16/32-bit and string writes, the 16/32-bit conditionals, C2 (insert
+// ASM) and the terminator and endif codes can be applied by the host without running the code
+// handler. Anything else, like the pointer, gecko register and C0 (execute ASM) codes, can't.
+static bool IsSupportedOnHost(const GeckoCode& gecko_code)
+{
+  for (size_t i = 0; i < gecko_code.codes.size(); ++i)
+  {
+    const GeckoCode::Code& code = gecko_code.codes[i];
+    const u32 opcode = code.address >> 24;
+    const bool pointer = (code.address & 0x10000000) != 0;
+    switch (opcode & 0xEE)
+    {
+    case 0x00:
+    case 0x02:
+    case 0x04:
+    case 0x20:
+    case 0x22:
+    case 0x24:
+    case 0x26:
+    case 0x28:
+    case 0x2A:
+    case 0x2C:
+    case 0x2E:
+      break;
+    case 0x06:
+      break;
+    case 0xC2:
+      if (pointer)
+        return false;
+      break;
+    case 0xE0:
+    case 0xE2:
+      // E0 (full terminator), F0 (end of codes) and E2 (endif), but not E2 with the else flag.
+      if (opcode != 0xE0 && opcode != 0xF0 && (opcode != 0xE2 || (code.address & 0x00100000)))
+        return false;
+      break;
+    default:
+      return false;
+    }
+    i += GetDataLines(code.address, code.data);
+  }
+  return true;
+}
 
 void SetActiveCodes(const std::vector<GeckoCode>& gcodes)
 {
@@ -77,6 +141,8 @@ void SetActiveCodes(const std::vector<GeckoCode>& gcodes)
                  [](const GeckoCode& code) { return code.enabled; });
   }
   s_active_codes.shrink_to_fit();
+  s_codes_supported_on_host =
+      std::all_of(s_active_codes.begin(), s_active_codes.end(), IsSupportedOnHost);
 
   s_code_handler_installed = Installation::Uninstalled;
 }
@@ -128,13 +194,14 @@ static Installation InstallCodeHandlerLocked()
   PowerPC::HostWrite_U32(MAGIC_GAMEID, INSTALLER_BASE_ADDRESS);
 
   // Create GCT in memory
-  PowerPC::HostWrite_U32(0x00d0c0de, codelist_base_address);
-  PowerPC::HostWrite_U32(0x00d0c0de, codelist_base_address + 4);
+  PowerPC::HostWrite_U32(CODE_LIST_MAGIC, codelist_base_address);
+  PowerPC::HostWrite_U32(CODE_LIST_MAGIC, codelist_base_address + 4);
 
   // Each code is 8 bytes (2 words) wide. There is a starter code and an end code.
   const u32 start_address = codelist_base_address + CODE_SIZE;
   const u32 end_address = codelist_end_address - CODE_SIZE;
   u32 next_address = start_address;
+  s_code_list_address = start_address;
 
   // NOTE: Only active codes are in the list
   for (const GeckoCode& active_code : s_active_codes)
@@ -185,6 +252,8 @@ void DoState(PointerWrap& p)
 {
   std::lock_guard<std::mutex> codes_lock(s_active_codes_lock);
   p.Do(s_code_handler_installed);
+  if (p.GetMode() == PointerWrap::MODE_READ)
+    s_code_list_address = 0;
   // FIXME: The active codes list will disagree with the embedded GCT
 }
 
@@ -193,6 +262,188 @@ void Shutdown()
   std::lock_guard<std::mutex> codes_lock(s_active_codes_lock);
   s_active_codes.clear();
   s_code_handler_installed = Installation::Uninstalled;
+  s_codes_supported_on_host = false;
+  s_code_list_address = 0;
+}
+
+// The GCT starts right after the code handler, whose size is only known while installing it.
+static u32 FindCodeList()
+{
+  for (u32 address = INSTALLER_BASE_ADDRESS; address < INSTALLER_END_ADDRESS - CODE_SIZE;
+       address += 4)
+  {
+    if (PowerPC::HostRead_U32(address) == CODE_LIST_MAGIC &&
+        PowerPC::HostRead_U32(address + 4) == CODE_LIST_MAGIC)
+    {
+      return address + CODE_SIZE;
+    }
+  }
+  return 0;
+}
+
+// Like the code handler, writes are skipped when they wouldn't change anything. Unlike it, the
+// instructions that did change are invalidated right away, so the JIT picks up patched code
+// without the ICache resets of HLE_Misc::GeckoCodeHandlerICacheFlush.
+static void WriteOnHost(u32 value, u32 address, u32 size)
+{
+  switch (size)
+  {
+  case 1:
+    if (PowerPC::HostRead_U8(address) == value)
+      return;
+    PowerPC::HostWrite_U8(value, address);
+    break;
+  case 2:
+    if (PowerPC::HostRead_U16(address) == value)
+      return;
+    PowerPC::HostWrite_U16(value, address);
+    break;
+  default:
+    if (PowerPC::HostRead_U32(address) == value)
+      return;
+    PowerPC::HostWrite_U32(value, address);
+    break;
+  }
+  PowerPC::ppcState.iCache.Invalidate(address);
+  JitInterface::InvalidateICache(address & ~0x1f, 32, false);
+}
+
+static u32 MakeBranch(u32 from, u32 to)
+{
+  return 0x48000000 | ((to - from) & 0x03FFFFFC);
+}
+
+// Does what the code handler would do with the GCT in memory, for the code types that
+// IsSupportedOnHost accepts. Returns false, before changing anything, if the GCT holds anything
+// else, e.g. because a code rewrote it.
+static bool RunCodesOnHost()
+{
+  if (!s_code_list_address)
+    s_code_list_address = FindCodeList();
+  if (!s_code_list_address)
+    return false;
+
+  // Check the whole list first, so that nothing is applied twice when falling back.
+  GeckoCode codes;
+  bool found_end = false;
+  u32 data_lines = 0;
+  for (u32 line = s_code_list_address; line < INSTALLER_END_ADDRESS && !found_end;
+       line += CODE_SIZE)
+  {
+    GeckoCode::Code code;
+    code.address = PowerPC::HostRead_U32(line);
+    code.data = PowerPC::HostRead_U32(line + 4);
+    codes.codes.push_back(code);
+    if (data_lines)
+    {
+      --data_lines;
+      continue;
+    }
+    data_lines = GetDataLines(code.address, code.data);
+    found_end = code.address >> 24 == 0xF0;
+  }
+  if (!found_end || !IsSupportedOnHost(codes))
+    return false;
+
+  u32 ba = 0x80000000;
+  u32 po = 0x80000000;
+  // One bit per nested conditional, set when it failed. Codes only run while it is 0.
+  u32 skip = 0;
+  for (size_t i = 0; i < codes.codes.size(); ++i)
+  {
+    const u32 line = s_code_list_address + static_cast<u32>(i) * CODE_SIZE;
+    const u32 address = codes.codes[i].address;
+    const u32 data = codes.codes[i].data;
+    const u32 opcode = address >> 24;
+    const u32 target = ((address & 0x10000000) ? po : ba) + (address & 0x01FFFFFF);
+    switch (opcode & 0xEE)
+    {
+    case 0x00:
+      for (u32 j = 0; !skip && j <= data >> 16; ++j)
+        WriteOnHost(data & 0xFF, target + j, 1);
+      break;
+    case 0x02:
+      for (u32 j = 0; !skip && j <= data >> 16; ++j)
+        WriteOnHost(data & 0xFFFF, target + j * 2, 2);
+      break;
+    case 0x04:
+      if (!skip)
+        WriteOnHost(data, target, 4);
+      break;
+    case 0x06:
+      for (u32 j = 0; !skip && j < data; ++j)
+        WriteOnHost(PowerPC::HostRead_U8(line + CODE_SIZE + j), target + j, 1);
+      break;
+    case 0x20:
+    case 0x22:
+    case 0x24:
+    case 0x26:
+    case 0x28:
+    case 0x2A:
+    case 0x2C:
+    case 0x2E:
+    {
+      if (address & 1)
+        skip >>= 1;
+      const u32 check = target & ~1;
+      u32 value = data;
+      u32 memory;
+      if (opcode & 0x08)
+      {
+        memory = PowerPC::HostRead_U16(check) & ~(data >> 16);
+        value &= 0xFFFF;
+      }
+      else
+      {
+        memory = PowerPC::HostRead_U32(check);
+      }
+
+      bool result;
+      switch (opcode & 0x06)
+      {
+      case 0x00:
+        result = memory == value;
+        break;
+      case 0x02:
+        result = memory != value;
+        break;
+      case 0x04:
+        result = memory > value;
+        break;
+      default:
+        result = memory < value;
+        break;
+      }
+      skip = (skip << 1) | !result;
+      break;
+    }
+    case 0xC2:
+      // Branches from the hooked instruction into the code and back after its last line.
+      if (!skip && data)
+      {
+        const u32 hook = ba + (address & 0x01FFFFFC);
+        const u32 last = line + data * CODE_SIZE + 4;
+        WriteOnHost(MakeBranch(last, hook + 4), last, 4);
+        WriteOnHost(MakeBranch(hook, line + CODE_SIZE), hook, 4);
+      }
+      break;
+    case 0xE0:
+    case 0xE2:
+      if (opcode == 0xE0)
+        skip = 0;
+      else if (opcode == 0xE2)
+        skip >>= std::min<u32>(address & 0xFF, 31);
+      else
+        return true;
+      if (data >> 16)
+        ba = data & 0xFFFF0000;
+      if (data & 0xFFFF)
+        po = data << 16;
+      break;
+    }
+    i += GetDataLines(address, data);
+  }
+  return true;
 }
 
 void RunCodeHandler()
@@ -201,6 +452,7 @@ void RunCodeHandler()
     return;
 
   // NOTE: Need to release the lock because of GUI deadlocks with PanicAlert in HostWrite_*
+  bool run_on_host;
   {
     std::lock_guard<std::mutex> codes_lock(s_active_codes_lock);
     if (s_code_handler_installed != Installation::Installed)
@@ -215,8 +467,12 @@ void RunCodeHandler()
       if (s_code_handler_installed != Installation::Installed)
         return;
     }
+    run_on_host = SConfig::GetInstance().bGeckoNative && s_codes_supported_on_host;
   }
 
+  if (run_on_host && RunCodesOnHost())
+    return;
+
   // We always do this to avoid problems with the stack since we're branching in random locations.
   // Even with function call return hooks (PC == LR), hand coded assembler won't necessarily
   // follow the ABI. [Volatile FPR, GPR, CR may not be volatile]
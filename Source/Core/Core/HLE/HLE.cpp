@@ -13,6 +13,7 @@
 #include "Core/GeckoCode.h"
 #include "Core/HLE/HLE_Misc.h"
 #include "Core/HLE/HLE_OS.h"
+#include "Core/HLE/HLE_SDK.h"
 #include "Core/HW/Memmap.h"
 #include "Core/IOS/ES/ES.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
@@ -69,6 +70,20 @@ static const SPatch OSPatches[] = {
 { "___blank",                     HLE_OS::HLE_GeneralDebugPrint,         HookType::Start,   HookFlag::Debug }, // used for early init things (normally)
 { "__write_console",              HLE_OS::HLE_write_console,             HookType::Start,   HookFlag::Debug }, // used by sysmenu (+more?)
 
+// Host versions of hot library routines
+{ "memcpy",                       HLE_SDK::HLE_memcpy,                   HookType::Replace, HookFlag::Library },
+{ "memmove",                      HLE_SDK::HLE_memcpy,                   HookType::Replace, HookFlag::Library },
+{ "memset",                       HLE_SDK::HLE_memset,                   HookType::Replace, HookFlag::Library },
+{ "DCFlushRange",                 HLE_SDK::HLE_DCFlushRange,             HookType::Replace, HookFlag::Library },
+{ "DCFlushRangeNoSync",           HLE_SDK::HLE_DCFlushRange,             HookType::Replace, HookFlag::Library },
+{ "DCStoreRange",                 HLE_SDK::HLE_DCFlushRange,             HookType::Replace, HookFlag::Library },
+{ "DCStoreRangeNoSync",           HLE_SDK::HLE_DCFlushRange,             HookType::Replace, HookFlag::Library },
+{ "DCInvalidateRange",            HLE_SDK::HLE_DCFlushRange,             HookType::Replace, HookFlag::Library },
+{ "PSMTXCopy",                    HLE_SDK::HLE_PSMTXCopy,                HookType::Replace, HookFlag::Library },
+{ "PSMTXConcat",                  HLE_SDK::HLE_PSMTXConcat,              HookType::Replace, HookFlag::Library },
+{ "PSMTXMultVec",                 HLE_SDK::HLE_PSMTXMultVec,             HookType::Replace, HookFlag::Library },
+{ "PSMTXMultVecSR",               HLE_SDK::HLE_PSMTXMultVecSR,           HookType::Replace, HookFlag::Library },
+
 { "GeckoCodehandler",             HLE_Misc::GeckoCodeHandlerICacheFlush, HookType::Start,   HookFlag::Fixed },
 { "GeckoHandlerReturnTrampoline", HLE_Misc::GeckoReturnTrampoline,       HookType::Replace, HookFlag::Fixed },
 { "AppLoaderReport",              HLE_OS::HLE_GeneralDebugPrint,         HookType::Replace, HookFlag::Fixed } // apploader needs OSReport-like function
@@ -213,6 +228,9 @@ HookFlag GetFunctionFlagsByIndex(u32 index)
 
 bool IsEnabled(HookFlag flag)
 {
+  // With the MMU, the guest's BATs and page tables decide where an address is.
+  if (flag == HLE::HookFlag::Library)
+    return SConfig::GetInstance().bHLELibrary && !SConfig::GetInstance().bMMU;
   return flag != HLE::HookFlag::Debug || SConfig::GetInstance().bEnableDebugging ||
     PowerPC::GetMode() == PowerPC::CoreMode::Interpreter;
 }
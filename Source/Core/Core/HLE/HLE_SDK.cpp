@@ -0,0 +1,226 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/HLE/HLE_SDK.h"
+
+#include <array>
+#include <cstring>
+
+#include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
+#include "Common/Swap.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+
+namespace HLE_SDK
+{
+using Matrix = std::array<float, 12>;
+using Vec = std::array<float, 3>;
+
+// Host pointer to a range of guest RAM, or nullptr if the range has to go through the MMU code
+// (MMIO, the locked cache, memory checks, or a range that leaves the RAM bank).
+static u8* GetRAMPointer(u32 address, u32 size)
+{
+  if (!size || address + size - 1 < address || PowerPC::memchecks.HasAny() ||
+      !PowerPC::IsOptimizableRAMAddress(address) ||
+      !PowerPC::IsOptimizableRAMAddress(address + size - 1))
+  {
+    return nullptr;
+  }
+
+  u8* start = Memory::GetPointer(address);
+  return start && Memory::GetPointer(address + size - 1) == start + size - 1 ? start : nullptr;
+}
+
+// Charges about as many cycles as the guest routine would have taken, so that replacing it
+// doesn't speed up the game.
+static void AddCycles(u32 cycles)
+{
+  PowerPC::ppcState.downcount -= cycles;
+}
+
+template <size_t N>
+static std::array<float, N> ReadFloats(u32 address)
+{
+  std::array<u32, N> words;
+  if (const u8* pointer = GetRAMPointer(address, N * 4))
+  {
+    for (size_t i = 0; i < N; i++)
+      words[i] = Common::swap32(pointer + i * 4);
+  }
+  else
+  {
+    for (size_t i = 0; i < N; i++)
+      words[i] = PowerPC::Read_U32(address + static_cast<u32>(i * 4));
+  }
+
+  std::array<float, N> values;
+  std::memcpy(values.data(), words.data(), sizeof(values));
+  return values;
+}
+
+template <size_t N>
+static void WriteFloats(const std::array<float, N>& values, u32 address)
+{
+  std::array<u32, N> words;
+  std::memcpy(words.data(), values.data(), sizeof(words));
+  if (u8* pointer = GetRAMPointer(address, N * 4))
+  {
+    for (size_t i = 0; i < N; i++)
+    {
+      const u32 word = Common::swap32(words[i]);
+      std::memcpy(pointer + i * 4, &word, sizeof(word));
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < N; i++)
+      PowerPC::Write_U32(words[i], address + static_cast<u32>(i * 4));
+  }
+}
+
+// memcpy and memmove, which handles the overlapping libraries sometimes rely on in memcpy too.
+// r3 is left alone, it is also the return value.
+void HLE_memcpy()
+{
+  const u32 dst = GPR(3);
+  const u32 src = GPR(4);
+  const u32 size = GPR(5);
+
+  u8* dst_pointer = GetRAMPointer(dst, size);
+  const u8* src_pointer = GetRAMPointer(src, size);
+  if (dst_pointer && src_pointer)
+  {
+    std::memmove(dst_pointer, src_pointer, size);
+  }
+  else if (dst <= src)
+  {
+    for (u32 i = 0; i < size; i++)
+      PowerPC::Write_U8(PowerPC::Read_U8(src + i), dst + i);
+  }
+  else
+  {
+    for (u32 i = size; i > 0; i--)
+      PowerPC::Write_U8(PowerPC::Read_U8(src + i - 1), dst + i - 1);
+  }
+
+  // The SDK's version copies a word in about two cycles once the pointers are aligned.
+  AddCycles(16 + size / 2);
+  NPC = LR;
+}
+
+void HLE_memset()
+{
+  const u32 dst = GPR(3);
+  const u8 value = static_cast<u8>(GPR(4));
+  const u32 size = GPR(5);
+
+  if (u8* pointer = GetRAMPointer(dst, size))
+  {
+    std::memset(pointer, value, size);
+  }
+  else
+  {
+    for (u32 i = 0; i < size; i++)
+      PowerPC::Write_U8(value, dst + i);
+  }
+
+  AddCycles(16 + size / 4);
+  NPC = LR;
+}
+
+// DCFlushRange, DCStoreRange, DCInvalidateRange and their NoSync versions. The data cache isn't
+// emulated, so all the dcbf/dcbst/dcbi loop does is drop the JIT blocks, which is done for the
+// whole range at once here.
+void HLE_DCFlushRange()
+{
+  const u32 address = GPR(3);
+  const u32 size = GPR(4);
+  if (size)
+  {
+    const u32 start = address & ~31;
+    const u32 lines = (address + size - start + 31) / 32;
+    JitInterface::InvalidateICache(start, lines * 32, false);
+    AddCycles(8 + lines * 2);
+  }
+  NPC = LR;
+}
+
+void HLE_PSMTXCopy()
+{
+  WriteFloats(ReadFloats<12>(GPR(3)), GPR(4));
+  AddCycles(20);
+  NPC = LR;
+}
+
+// ab = a * b for 3x4 matrices, with an implied last row of (0, 0, 0, 1). ab may be a or b.
+static Matrix Concat(const Matrix& a, const Matrix& b)
+{
+  Matrix ab;
+#if _M_SSE >= 0x200
+  const __m128 b0 = _mm_loadu_ps(&b[0]);
+  const __m128 b1 = _mm_loadu_ps(&b[4]);
+  const __m128 b2 = _mm_loadu_ps(&b[8]);
+  const __m128 b3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+  for (size_t row = 0; row < 3; row++)
+  {
+    const float* a_row = &a[row * 4];
+    __m128 sum = _mm_mul_ps(_mm_set1_ps(a_row[0]), b0);
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a_row[1]), b1));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a_row[2]), b2));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a_row[3]), b3));
+    _mm_storeu_ps(&ab[row * 4], sum);
+  }
+#else
+  for (size_t row = 0; row < 3; row++)
+  {
+    for (size_t column = 0; column < 4; column++)
+    {
+      float sum = a[row * 4] * b[column];
+      sum += a[row * 4 + 1] * b[4 + column];
+      sum += a[row * 4 + 2] * b[8 + column];
+      if (column == 3)
+        sum += a[row * 4 + 3];
+      ab[row * 4 + column] = sum;
+    }
+  }
+#endif
+  return ab;
+}
+
+void HLE_PSMTXConcat()
+{
+  WriteFloats(Concat(ReadFloats<12>(GPR(3)), ReadFloats<12>(GPR(4))), GPR(5));
+  AddCycles(40);
+  NPC = LR;
+}
+
+static Vec MultVec(const Matrix& m, const Vec& v, bool translate)
+{
+  Vec result;
+  for (size_t row = 0; row < 3; row++)
+  {
+    float sum = m[row * 4] * v[0] + m[row * 4 + 1] * v[1] + m[row * 4 + 2] * v[2];
+    if (translate)
+      sum += m[row * 4 + 3];
+    result[row] = sum;
+  }
+  return result;
+}
+
+void HLE_PSMTXMultVec()
+{
+  WriteFloats(MultVec(ReadFloats<12>(GPR(3)), ReadFloats<3>(GPR(4)), true), GPR(5));
+  AddCycles(20);
+  NPC = LR;
+}
+
+void HLE_PSMTXMultVecSR()
+{
+  WriteFloats(MultVec(ReadFloats<12>(GPR(3)), ReadFloats<3>(GPR(4)), false), GPR(5));
+  AddCycles(20);
+  NPC = LR;
+}
+}
@@ -0,0 +1,19 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+// Host versions of the libc, cache and matrix library routines games spend the most time in.
+// They are found by name, so they only apply where a symbol map or the signature database
+// identified the function.
+namespace HLE_SDK
+{
+void HLE_memcpy();
+void HLE_memset();
+void HLE_DCFlushRange();
+void HLE_PSMTXCopy();
+void HLE_PSMTXConcat();
+void HLE_PSMTXMultVec();
+void HLE_PSMTXMultVecSR();
+}
@@ -4,6 +4,10 @@
 
 #include "Core/HW/DSPHLE/UCodes/AX.h"
 
+#include <algorithm>
+#include <array>
+
+#include "Common/Assert.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
@@ -11,6 +15,8 @@
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
 #include "Common/Swap.h"
+#include "Common/ThreadPool.h"
+#include "Common/TraceEvents.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/DSPHLE.h"
 #include "Core/HW/DSPHLE/MailHandler.h"
@@ -95,6 +101,7 @@ void AXUCode::SignalWorkEnd()
 
 void AXUCode::HandleCommandList()
 {
+  TRACE_SCOPE("AX::HandleCommandList");
   // Temp variables for addresses computation
   u16 addr_hi, addr_lo;
   u16 addr2_hi, addr2_lo;
@@ -421,40 +428,108 @@ void AXUCode::DownloadAndMixWithVolume(u32 addr, u16 vol_main, u16 vol_auxa, u16
   }
 }
 
+void AXUCode::RenderVoices(u32 voice_count, int* const* buffers, const u32* buffer_sizes,
+                           size_t buffer_count,
+                           const std::function<void(u32, int* const*)>& render)
+{
+  const u32 group_count = (voice_count + VOICES_PER_GROUP - 1) / VOICES_PER_GROUP;
+  if (group_count < 2)
+  {
+    for (u32 voice = 0; voice < voice_count; ++voice)
+      render(voice, buffers);
+    return;
+  }
+
+  std::array<size_t, 32> offsets;
+  ASSERT(buffer_count <= offsets.size());
+  size_t group_size = 0;
+  for (size_t i = 0; i < buffer_count; ++i)
+  {
+    offsets[i] = group_size;
+    group_size += buffer_sizes[i];
+  }
+  m_group_samples.resize(group_count * group_size);
+
+  Common::ParallelForWorker::Loop(0, group_count, 1, [&](s32 begin, s32 end) {
+    for (s32 group = begin; group < end; ++group)
+    {
+      int* const samples = &m_group_samples[group * group_size];
+      std::fill(samples, samples + group_size, 0);
+
+      std::array<int*, 32> group_buffers;
+      for (size_t i = 0; i < buffer_count; ++i)
+        group_buffers[i] = samples + offsets[i];
+
+      const u32 voice_end = std::min(voice_count, (group + 1) * VOICES_PER_GROUP);
+      for (u32 voice = group * VOICES_PER_GROUP; voice < voice_end; ++voice)
+        render(voice, group_buffers.data());
+    }
+  });
+
+  for (u32 group = 0; group < group_count; ++group)
+  {
+    const int* samples = &m_group_samples[group * group_size];
+    for (size_t i = 0; i < buffer_count; ++i)
+    {
+      for (u32 j = 0; j < buffer_sizes[i]; ++j)
+        buffers[i][j] += samples[offsets[i] + j];
+    }
+  }
+}
+
 void AXUCode::ProcessPBList(u32 pb_addr)
 {
   // Samples per millisecond. In theory DSP sampling rate can be changed from
   // 32KHz to 48KHz, but AX always process at 32KHz.
   const u32 spms = 32;
 
-  AXPB pb;
-
+  // Read the whole list before rendering anything. Updates can change the
+  // link to the next PB, so they are applied to a copy to follow the list.
+  std::vector<u32> pb_addrs;
+  std::vector<AXPB> pbs;
   while (pb_addr)
   {
-    AXBuffers buffers = {{m_samples_left, m_samples_right, m_samples_surround, m_samples_auxA_left,
-                          m_samples_auxA_right, m_samples_auxA_surround, m_samples_auxB_left,
-                          m_samples_auxB_right, m_samples_auxB_surround}};
-
+    AXPB pb;
     ReadPB(pb_addr, pb, m_crc);
+    pb_addrs.push_back(pb_addr);
+    pbs.push_back(pb);
 
-    u32 updates_addr = HILO_TO_32(pb.updates.data);
-    u16* updates = (u16*)HLEMemory_Get_Pointer(updates_addr);
-
+    u16* updates = (u16*)HLEMemory_Get_Pointer(HILO_TO_32(pb.updates.data));
     for (int curr_ms = 0; curr_ms < 5; ++curr_ms)
-    {
       ApplyUpdatesForMs(curr_ms, (u16*)&pb, pb.updates.num_updates, updates);
+    pb_addr = HILO_TO_32(pb.next_pb);
+  }
 
-      ProcessVoice(pb, buffers, spms, ConvertMixerControl(pb.mixer_control),
-                   m_coeffs_available ? m_coeffs : nullptr);
+  int* const main_buffers[] = {m_samples_left,       m_samples_right,        m_samples_surround,
+                               m_samples_auxA_left,  m_samples_auxA_right,   m_samples_auxA_surround,
+                               m_samples_auxB_left,  m_samples_auxB_right,   m_samples_auxB_surround};
+  u32 buffer_sizes[ArraySize(main_buffers)];
+  std::fill(std::begin(buffer_sizes), std::end(buffer_sizes), spms * 5);
 
-      // Forward the buffers
-      for (size_t i = 0; i < ArraySize(buffers.ptrs); ++i)
-        buffers.ptrs[i] += spms;
-    }
+  RenderVoices(static_cast<u32>(pbs.size()), main_buffers, buffer_sizes, ArraySize(main_buffers),
+               [&](u32 voice, int* const* voice_buffers) {
+                 AXPB& pb = pbs[voice];
+                 AXBuffers buffers;
+                 std::copy(voice_buffers, voice_buffers + ArraySize(buffers.ptrs), buffers.ptrs);
 
-    WritePB(pb_addr, pb, m_crc);
-    pb_addr = HILO_TO_32(pb.next_pb);
-  }
+                 u32 updates_addr = HILO_TO_32(pb.updates.data);
+                 u16* updates = (u16*)HLEMemory_Get_Pointer(updates_addr);
+
+                 for (int curr_ms = 0; curr_ms < 5; ++curr_ms)
+                 {
+                   ApplyUpdatesForMs(curr_ms, (u16*)&pb, pb.updates.num_updates, updates);
+
+                   ProcessVoice(pb, buffers, spms, ConvertMixerControl(pb.mixer_control),
+                                m_coeffs_available ? m_coeffs : nullptr);
+
+                   // Forward the buffers
+                   for (size_t i = 0; i < ArraySize(buffers.ptrs); ++i)
+                     buffers.ptrs[i] += spms;
+                 }
+               });
+
+  for (size_t i = 0; i < pbs.size(); ++i)
+    WritePB(pb_addrs[i], pbs[i], m_crc);
 }
 
 void AXUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr)
@@ -614,6 +689,7 @@ void AXUCode::SendAUXAndMix(u32 main_auxa_up, u32 auxb_s_up, u32 main_l_dl, u32
 
 void AXUCode::HandleMail(u32 mail)
 {
+  TRACE_SCOPE("AX::HandleMail");
   // Indicates if the next message is a command list address.
   static bool next_is_cmdlist = false;
   static u16 cmdlist_size = 0;
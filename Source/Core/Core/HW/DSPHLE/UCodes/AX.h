@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include "Common/CommonTypes.h"
 #include "Core/HW/DSPHLE/UCodes/UCodes.h"
 
@@ -112,6 +115,18 @@ protected:
   // Apply updates to a PB. Generic, used in AX GC and AX Wii.
   void ApplyUpdatesForMs(int curr_ms, u16* pb, u16* num_updates, u16* updates);
 
+  // Voices are rendered in fixed groups of this many. When there is more than
+  // one group, the groups run on the thread pool, each mixing into its own
+  // copy of the buffers, and the copies are added to the real buffers in group
+  // order afterwards. Mixing only adds integers, so the output is the same as
+  // rendering every voice directly into the real buffers.
+  static constexpr u32 VOICES_PER_GROUP = 8;
+
+  // Calls render(voice, buffers) for every voice in [0, voice_count). buffers
+  // holds buffer_count mix buffers, the i-th one being buffer_sizes[i] samples.
+  void RenderVoices(u32 voice_count, int* const* buffers, const u32* buffer_sizes,
+                    size_t buffer_count, const std::function<void(u32, int* const*)>& render);
+
   virtual void HandleCommandList();
   void SignalWorkEnd();
 
@@ -131,6 +146,9 @@ protected:
   void DoAXState(PointerWrap& p);
 
 private:
+  // Per group mix buffers used by RenderVoices.
+  std::vector<int> m_group_samples;
+
   enum CmdType
   {
     CMD_SETUP = 0x00,
@@ -12,10 +12,14 @@
 #error AXVoice.h included without specifying version
 #endif
 
-#include <functional>
 #include <memory>
 
+#if defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/MathUtil.h"
 #include "Core/DSP/DSPAccelerator.h"
 #include "Core/HW/DSP.h"
@@ -163,9 +167,10 @@ void DumpPB(const PB_TYPE& pb)
 }
 #endif
 
-// Simulated accelerator state.
-static PB_TYPE* acc_pb;
-static bool acc_end_reached;
+// Simulated accelerator state. Voices can be rendered on several threads at
+// once, so every thread gets its own accelerator.
+static thread_local PB_TYPE* acc_pb;
+static thread_local bool acc_end_reached;
 
 class HLEAccelerator final : public Accelerator
 {
@@ -212,7 +217,8 @@ protected:
   void WriteMemory(u32 address, u8 value) override { WriteARAM(value, address); }
 };
 
-static std::unique_ptr<Accelerator> s_accelerator = std::make_unique<HLEAccelerator>();
+static thread_local std::unique_ptr<Accelerator> s_accelerator =
+    std::make_unique<HLEAccelerator>();
 
 // Sets up the simulated accelerator.
 void AcceleratorSetup(PB_TYPE* pb)
@@ -260,7 +266,8 @@ u16 AcceleratorGetSample()
 // We start getting samples not from sample 0, but 0.<curr_pos_frac>. This
 // avoids discontinuities in the audio stream, especially with very low ratios
 // which interpolate a lot of values between two "real" samples.
-u32 ResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count, s16* last_samples,
+template <typename InputCallback>
+u32 ResampleAudio(InputCallback input_callback, s16* output, u32 count, s16* last_samples,
                   u32 curr_pos, u32 ratio, int srctype, const s16* coeffs)
 {
   int read_samples_count = 0;
@@ -383,9 +390,26 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
 
   if (coeffs)
     coeffs += pb.coef_select * 0x200;
-  u32 curr_pos =
-      ResampleAudio([](u32) { return AcceleratorGetSample(); }, samples, count, pb.src.last_samples,
-                    pb.src.cur_addr_frac, HILO_TO_32(pb.src.ratio), pb.src_type, coeffs);
+
+  // The resampler consumes a known number of input samples (unless the ratio
+  // is large enough for the position to wrap), so decode them all at once.
+  const u32 ratio = HILO_TO_32(pb.src.ratio);
+  const u64 input_count = (pb.src_type == SRCTYPE_LINEAR || pb.src_type == SRCTYPE_POLYPHASE) ?
+                              (pb.src.cur_addr_frac + u64(count) * ratio) >> 16 :
+                              count;
+  s16 input[MAX_SAMPLES_PER_FRAME * 8];
+  u32 curr_pos;
+  if (!acc_end_reached && ratio <= 0xFFFF0000 && input_count <= ArraySize(input))
+  {
+    s_accelerator->ReadSamples(pb.adpcm.coefs, input, static_cast<u32>(input_count));
+    curr_pos = ResampleAudio([&input](u32 i) { return input[i]; }, samples, count,
+                             pb.src.last_samples, pb.src.cur_addr_frac, ratio, pb.src_type, coeffs);
+  }
+  else
+  {
+    curr_pos = ResampleAudio([](u32) { return AcceleratorGetSample(); }, samples, count,
+                             pb.src.last_samples, pb.src.cur_addr_frac, ratio, pb.src_type, coeffs);
+  }
   pb.src.cur_addr_frac = (curr_pos & 0xFFFF);
 
   // Update current position, YN1, YN2 and pred scale in the PB.
@@ -396,6 +420,84 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
   pb.adpcm.pred_scale = s_accelerator->GetPredScale();
 }
 
+#if defined(_M_X86)
+// Multiplies 8 samples by 8 unsigned 1.15 volumes, clamped like the scalar
+// code to [-32767, 32767].
+__m128i ScaleSamples(__m128i samples, __m128i volumes)
+{
+  const __m128i lo = _mm_mullo_epi16(samples, volumes);
+  // mulhi treats the volumes as signed; add the sample back for volumes >= 0x8000.
+  __m128i hi = _mm_mulhi_epi16(samples, volumes);
+  hi = _mm_add_epi16(hi, _mm_and_si128(samples, _mm_srai_epi16(volumes, 15)));
+  const __m128i prod0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+  const __m128i prod1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+  return _mm_max_epi16(_mm_packs_epi32(prod0, prod1), _mm_set1_epi16(-32767));
+}
+
+// Volumes for the next 8 samples of a ramp starting at <volume>.
+__m128i RampVolumes(u16 volume, u16 volume_delta)
+{
+  const __m128i steps = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+  return _mm_add_epi16(_mm_set1_epi16(volume),
+                       _mm_mullo_epi16(steps, _mm_set1_epi16(volume_delta)));
+}
+#elif defined(_M_ARM_64)
+int16x8_t ScaleSamples(int16x8_t samples, uint16x8_t volumes)
+{
+  const int32x4_t prod0 = vshrq_n_s32(
+      vmulq_s32(vmovl_s16(vget_low_s16(samples)),
+                vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(volumes)))),
+      15);
+  const int32x4_t prod1 = vshrq_n_s32(
+      vmulq_s32(vmovl_s16(vget_high_s16(samples)),
+                vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(volumes)))),
+      15);
+  return vmaxq_s16(vcombine_s16(vqmovn_s32(prod0), vqmovn_s32(prod1)), vdupq_n_s16(-32767));
+}
+
+uint16x8_t RampVolumes(u16 volume, u16 volume_delta)
+{
+  static const u16 steps[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  return vmlaq_n_u16(vdupq_n_u16(volume), vld1q_u16(steps), volume_delta);
+}
+#endif
+
+// Apply a volume ramp to the samples in place.
+void ApplyVolume(s16* samples, u32 count, u16* pvolume, u16 volume_delta)
+{
+  u16 volume = *pvolume;
+  u32 i = 0;
+
+#if defined(_M_X86)
+  const __m128i volume_step = _mm_set1_epi16(static_cast<u16>(volume_delta * 8));
+  __m128i volumes = RampVolumes(volume, volume_delta);
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i* ptr = reinterpret_cast<__m128i*>(samples + i);
+    _mm_storeu_si128(ptr, ScaleSamples(_mm_loadu_si128(ptr), volumes));
+    volumes = _mm_add_epi16(volumes, volume_step);
+  }
+  volume += static_cast<u16>(volume_delta * i);
+#elif defined(_M_ARM_64)
+  const uint16x8_t volume_step = vdupq_n_u16(static_cast<u16>(volume_delta * 8));
+  uint16x8_t volumes = RampVolumes(volume, volume_delta);
+  for (; i + 8 <= count; i += 8)
+  {
+    vst1q_s16(samples + i, ScaleSamples(vld1q_s16(samples + i), volumes));
+    volumes = vaddq_u16(volumes, volume_step);
+  }
+  volume += static_cast<u16>(volume_delta * i);
+#endif
+
+  for (; i < count; ++i)
+  {
+    samples[i] = MathUtil::Clamp(((s32)samples[i] * volume) >> 15, -32767, 32767);  // -32768 ?
+    volume += volume_delta;
+  }
+
+  *pvolume = volume;
+}
+
 // Add samples to an output buffer, with optional volume ramping.
 void MixAdd(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ramp)
 {
@@ -408,7 +510,49 @@ void MixAdd(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ra
   if (!ramp)
     volume_delta = 0;
 
-  for (u32 i = 0; i < count; ++i)
+  u32 i = 0;
+
+#if defined(_M_X86)
+  const __m128i volume_step = _mm_set1_epi16(static_cast<u16>(volume_delta * 8));
+  __m128i volumes = RampVolumes(volume, volume_delta);
+  __m128i scaled = _mm_setzero_si128();
+  for (; i + 8 <= count; i += 8)
+  {
+    scaled = ScaleSamples(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i)), volumes);
+    volumes = _mm_add_epi16(volumes, volume_step);
+
+    // Sign extend to 32 bits and accumulate.
+    __m128i* dst = reinterpret_cast<__m128i*>(out + i);
+    const __m128i scaled0 = _mm_srai_epi32(_mm_unpacklo_epi16(scaled, scaled), 16);
+    const __m128i scaled1 = _mm_srai_epi32(_mm_unpackhi_epi16(scaled, scaled), 16);
+    _mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), scaled0));
+    _mm_storeu_si128(dst + 1, _mm_add_epi32(_mm_loadu_si128(dst + 1), scaled1));
+  }
+  if (i)
+  {
+    volume += static_cast<u16>(volume_delta * i);
+    *dpop = static_cast<s16>(_mm_extract_epi16(scaled, 7));
+  }
+#elif defined(_M_ARM_64)
+  const uint16x8_t volume_step = vdupq_n_u16(static_cast<u16>(volume_delta * 8));
+  uint16x8_t volumes = RampVolumes(volume, volume_delta);
+  int16x8_t scaled = vdupq_n_s16(0);
+  for (; i + 8 <= count; i += 8)
+  {
+    scaled = ScaleSamples(vld1q_s16(input + i), volumes);
+    volumes = vaddq_u16(volumes, volume_step);
+
+    vst1q_s32(out + i, vaddw_s16(vld1q_s32(out + i), vget_low_s16(scaled)));
+    vst1q_s32(out + i + 4, vaddw_s16(vld1q_s32(out + i + 4), vget_high_s16(scaled)));
+  }
+  if (i)
+  {
+    volume += static_cast<u16>(volume_delta * i);
+    *dpop = vgetq_lane_s16(scaled, 7);
+  }
+#endif
+
+  for (; i < count; ++i)
   {
     s64 sample = input[i];
     sample *= volume;
@@ -445,12 +589,7 @@ void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl
   GetInputSamples(pb, samples, count, coeffs);
 
   // Apply a global volume ramp using the volume envelope parameters.
-  for (u32 i = 0; i < count; ++i)
-  {
-    samples[i] = MathUtil::Clamp(((s32)samples[i] * pb.vol_env.cur_volume) >> 15, -32767,
-                                 32767);  // -32768 ?
-    pb.vol_env.cur_volume += pb.vol_env.cur_volume_delta;
-  }
+  ApplyVolume(samples, count, &pb.vol_env.cur_volume, pb.vol_env.cur_volume_delta);
 
   // Optionally, execute a low pass filter
   // TODO: LPF code is currently broken, causing Super Monkey Ball sound
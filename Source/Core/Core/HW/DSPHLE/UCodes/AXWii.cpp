@@ -6,11 +6,15 @@
 
 #include "Core/HW/DSPHLE/UCodes/AXWii.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
 #include "Common/Swap.h"
+#include "Common/TraceEvents.h"
 #include "Core/HW/DSPHLE/DSPHLE.h"
 #include "Core/HW/DSPHLE/MailHandler.h"
 #include "Core/HW/DSPHLE/UCodes/AXStructs.h"
@@ -37,6 +41,7 @@ AXWiiUCode::~AXWiiUCode()
 
 void AXWiiUCode::HandleCommandList()
 {
+  TRACE_SCOPE("AXWii::HandleCommandList");
   // Temp variables for addresses computation
   u16 addr_hi, addr_lo;
   u16 addr2_hi, addr2_lo;
@@ -439,19 +444,16 @@ void AXWiiUCode::ReinjectUpdatesFields(AXPBWii& pb, u16* num_updates, u32 update
 
 void AXWiiUCode::ProcessPBList(u32 pb_addr)
 {
-  AXPBWii pb;
-
+  // Read the whole list before rendering anything. Updates can change the
+  // link to the next PB, so they are applied to a copy to follow the list.
+  std::vector<u32> pb_addrs;
+  std::vector<AXPBWii> pbs;
   while (pb_addr)
   {
-    AXBuffers buffers = {{m_samples_left,      m_samples_right,      m_samples_surround,
-                          m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
-                          m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround,
-                          m_samples_auxC_left, m_samples_auxC_right, m_samples_auxC_surround,
-                          m_samples_wm0,       m_samples_aux0,       m_samples_wm1,
-                          m_samples_aux1,      m_samples_wm2,        m_samples_aux2,
-                          m_samples_wm3,       m_samples_aux3}};
-
+    AXPBWii pb;
     ReadPB(pb_addr, pb, m_crc);
+    pb_addrs.push_back(pb_addr);
+    pbs.push_back(pb);
 
     u16 num_updates[3];
     u16 updates[1024];
@@ -459,26 +461,65 @@ void AXWiiUCode::ProcessPBList(u32 pb_addr)
     if (ExtractUpdatesFields(pb, num_updates, updates, &updates_addr))
     {
       for (int curr_ms = 0; curr_ms < 3; ++curr_ms)
-      {
         ApplyUpdatesForMs(curr_ms, (u16*)&pb, num_updates, updates);
-        ProcessVoice(pb, buffers, 32, ConvertMixerControl(HILO_TO_32(pb.mixer_control)),
-                     m_coeffs_available ? m_coeffs : nullptr);
-
-        // Forward the buffers
-        for (size_t i = 0; i < ArraySize(buffers.ptrs); ++i)
-          buffers.ptrs[i] += 32;
-      }
       ReinjectUpdatesFields(pb, num_updates, updates_addr);
     }
-    else
-    {
-      ProcessVoice(pb, buffers, 96, ConvertMixerControl(HILO_TO_32(pb.mixer_control)),
-                   m_coeffs_available ? m_coeffs : nullptr);
-    }
-
-    WritePB(pb_addr, pb, m_crc);
     pb_addr = HILO_TO_32(pb.next_pb);
   }
+
+  int* const main_buffers[] = {m_samples_left,      m_samples_right,      m_samples_surround,
+                               m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
+                               m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround,
+                               m_samples_auxC_left, m_samples_auxC_right, m_samples_auxC_surround,
+                               m_samples_wm0,       m_samples_aux0,       m_samples_wm1,
+                               m_samples_aux1,      m_samples_wm2,        m_samples_aux2,
+                               m_samples_wm3,       m_samples_aux3};
+  const u32 buffer_sizes[] = {
+      ArraySize(m_samples_left),      ArraySize(m_samples_right),
+      ArraySize(m_samples_surround),  ArraySize(m_samples_auxA_left),
+      ArraySize(m_samples_auxA_right), ArraySize(m_samples_auxA_surround),
+      ArraySize(m_samples_auxB_left), ArraySize(m_samples_auxB_right),
+      ArraySize(m_samples_auxB_surround), ArraySize(m_samples_auxC_left),
+      ArraySize(m_samples_auxC_right), ArraySize(m_samples_auxC_surround),
+      ArraySize(m_samples_wm0),       ArraySize(m_samples_aux0),
+      ArraySize(m_samples_wm1),       ArraySize(m_samples_aux1),
+      ArraySize(m_samples_wm2),       ArraySize(m_samples_aux2),
+      ArraySize(m_samples_wm3),       ArraySize(m_samples_aux3)};
+  static_assert(ArraySize(buffer_sizes) == ArraySize(main_buffers), "missing buffer size");
+
+  RenderVoices(static_cast<u32>(pbs.size()), main_buffers, buffer_sizes, ArraySize(main_buffers),
+               [&](u32 voice, int* const* voice_buffers) {
+                 AXPBWii& pb = pbs[voice];
+                 AXBuffers buffers;
+                 std::copy(voice_buffers, voice_buffers + ArraySize(buffers.ptrs), buffers.ptrs);
+
+                 u16 num_updates[3];
+                 u16 updates[1024];
+                 u32 updates_addr;
+                 if (ExtractUpdatesFields(pb, num_updates, updates, &updates_addr))
+                 {
+                   for (int curr_ms = 0; curr_ms < 3; ++curr_ms)
+                   {
+                     ApplyUpdatesForMs(curr_ms, (u16*)&pb, num_updates, updates);
+                     ProcessVoice(pb, buffers, 32,
+                                  ConvertMixerControl(HILO_TO_32(pb.mixer_control)),
+                                  m_coeffs_available ? m_coeffs : nullptr);
+
+                     // Forward the buffers
+                     for (size_t i = 0; i < ArraySize(buffers.ptrs); ++i)
+                       buffers.ptrs[i] += 32;
+                   }
+                   ReinjectUpdatesFields(pb, num_updates, updates_addr);
+                 }
+                 else
+                 {
+                   ProcessVoice(pb, buffers, 96, ConvertMixerControl(HILO_TO_32(pb.mixer_control)),
+                                m_coeffs_available ? m_coeffs : nullptr);
+                 }
+               });
+
+  for (size_t i = 0; i < pbs.size(); ++i)
+    WritePB(pb_addrs[i], pbs[i], m_crc);
 }
 
 void AXWiiUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr, u16 volume)
@@ -12,6 +12,7 @@
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
+#include "Common/JitRegister.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/Thread.h"
@@ -27,6 +28,7 @@
 #include "Core/HW/DSPLLE/DSPLLEGlobals.h"
 #include "Core/HW/Memmap.h"
 #include "Core/Host.h"
+#include "Core/ThreadPolicy.h"
 
 namespace DSP
 {
@@ -92,6 +94,7 @@ void DSPLLE::DoState(PointerWrap& p)
 void DSPLLE::DSPThread(DSPLLE* dsp_lle)
 {
   Common::SetCurrentThreadName("DSP thread");
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::Role::DSP);
 
   while (dsp_lle->m_is_running.IsSet())
   {
@@ -174,8 +177,15 @@ bool DSPLLE::Initialize(bool wii, bool dsp_thread)
   DSPInitOptions opts;
   if (!FillDSPInitOptions(&opts))
     return false;
+  // Before DSPCore_Init, which already compiles the dispatcher.
+  if (opts.core_type == DSPInitOptions::CORE_JIT)
+    JitRegister::Init(SConfig::GetInstance().m_perfDir, SConfig::GetInstance().m_perfJitDump);
   if (!DSPCore_Init(opts))
+  {
+    if (opts.core_type == DSPInitOptions::CORE_JIT)
+      JitRegister::Shutdown();
     return false;
+  }
 
   // needs to be after DSPCore_Init for the dspjit ptr
   if (Core::WantsDeterminism() || !g_dsp_jit)
@@ -215,6 +225,8 @@ void DSPLLE::DSP_StopSoundStream()
 
 void DSPLLE::Shutdown()
 {
+  if (g_dsp_jit)
+    JitRegister::Shutdown();
   DSPCore_Shutdown();
 }
 
@@ -0,0 +1,301 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/HW/DVD/DVDReadAhead.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Core/ConfigManager.h"
+
+#include "DiscIO/Volume.h"
+
+namespace DVDReadAhead
+{
+constexpr u64 BLOCK_SIZE = 0x20000;
+constexpr size_t CACHE_BLOCKS = 64;
+
+constexpr u32 PATTERN_MAGIC = 0x50414449;  // "IDAP"
+constexpr u32 PATTERN_VERSION = 1;
+constexpr size_t PATTERN_MAX_ENTRIES = 0x10000;
+
+struct BlockKey
+{
+  u64 partition;
+  u64 block;
+
+  bool operator<(const BlockKey& other) const
+  {
+    return partition != other.partition ? partition < other.partition : block < other.block;
+  }
+};
+
+struct CachedBlock
+{
+  std::vector<u8> data;
+  u64 last_use;
+};
+
+// Where a game went after reading a block, when that wasn't the next block.
+struct Jump
+{
+  u64 block;
+  u32 count;
+};
+
+struct PatternEntry
+{
+  u64 partition;
+  u64 from_block;
+  u64 to_block;
+  u32 count;
+  u32 padding;
+};
+
+static std::map<BlockKey, CachedBlock> s_cache;
+static u64 s_use_counter = 0;
+static std::deque<BlockKey> s_plan;
+
+static std::map<BlockKey, Jump> s_jumps;
+static std::string s_pattern_path;
+static bool s_pattern_dirty = false;
+
+static bool s_has_last_read = false;
+static BlockKey s_last_read;
+static u32 s_sequential_reads = 0;
+
+static u64 s_hits = 0;
+static u64 s_misses = 0;
+
+static std::string GetPatternPath(const DiscIO::Volume& volume)
+{
+  const std::string game_id = volume.GetGameID();
+  if (game_id.empty())
+    return "";
+  return File::GetUserPath(D_CACHE_IDX) + "DVD" DIR_SEP +
+         StringFromFormat("%s_%u.dap", game_id.c_str(), volume.GetDiscNumber().value_or(0));
+}
+
+static void LoadPattern()
+{
+  s_jumps.clear();
+  s_pattern_dirty = false;
+  if (s_pattern_path.empty() || !SConfig::GetInstance().m_dvd_access_patterns)
+    return;
+
+  File::IOFile file(s_pattern_path, "rb");
+  u32 header[3];
+  if (!file.ReadArray(header, 3) || header[0] != PATTERN_MAGIC || header[1] != PATTERN_VERSION ||
+      header[2] > PATTERN_MAX_ENTRIES)
+  {
+    return;
+  }
+  std::vector<PatternEntry> entries(header[2]);
+  if (!file.ReadArray(entries.data(), entries.size()))
+    return;
+
+  for (const PatternEntry& entry : entries)
+    s_jumps[{entry.partition, entry.from_block}] = {entry.to_block, entry.count};
+  INFO_LOG(DVDINTERFACE, "Loaded %zu DVD access pattern entries from %s", s_jumps.size(),
+           s_pattern_path.c_str());
+}
+
+static void SavePattern()
+{
+  if (!s_pattern_dirty || s_pattern_path.empty())
+    return;
+  s_pattern_dirty = false;
+
+  std::vector<PatternEntry> entries;
+  entries.reserve(s_jumps.size());
+  for (const auto& jump : s_jumps)
+  {
+    entries.push_back(
+        {jump.first.partition, jump.first.block, jump.second.block, jump.second.count, 0});
+  }
+
+  File::CreateFullPath(s_pattern_path);
+  File::IOFile file(s_pattern_path, "wb");
+  const u32 header[3] = {PATTERN_MAGIC, PATTERN_VERSION, static_cast<u32>(entries.size())};
+  if (!file.WriteArray(header, 3) || !file.WriteArray(entries.data(), entries.size()))
+    WARN_LOG(DVDINTERFACE, "Failed to write DVD access pattern %s", s_pattern_path.c_str());
+}
+
+static void Reset()
+{
+  if (s_hits || s_misses)
+  {
+    INFO_LOG(DVDINTERFACE, "DVD read-ahead served %" PRIu64 " of %" PRIu64 " reads", s_hits,
+             s_hits + s_misses);
+  }
+  s_cache.clear();
+  s_plan.clear();
+  s_has_last_read = false;
+  s_sequential_reads = 0;
+  s_hits = 0;
+  s_misses = 0;
+}
+
+void SetVolume(const DiscIO::Volume* volume)
+{
+  Shutdown();
+  s_pattern_path = volume ? GetPatternPath(*volume) : "";
+  LoadPattern();
+}
+
+void Shutdown()
+{
+  SavePattern();
+  Reset();
+  s_jumps.clear();
+  s_pattern_path.clear();
+}
+
+bool Read(u64 offset, u32 length, u8* buffer, const DiscIO::Partition& partition)
+{
+  if (length == 0 || s_cache.empty())
+    return false;
+
+  const u64 first = offset / BLOCK_SIZE;
+  const u64 last = (offset + length - 1) / BLOCK_SIZE;
+  for (u64 block = first; block <= last; block++)
+  {
+    if (!s_cache.count({partition.offset, block}))
+    {
+      s_misses++;
+      return false;
+    }
+  }
+
+  u64 position = offset;
+  const u64 end = offset + length;
+  for (u64 block = first; block <= last; block++)
+  {
+    CachedBlock& cached = s_cache[{partition.offset, block}];
+    cached.last_use = ++s_use_counter;
+    const u64 block_offset = position - block * BLOCK_SIZE;
+    const u64 size = std::min(end - position, BLOCK_SIZE - block_offset);
+    std::memcpy(buffer + (position - offset), cached.data.data() + block_offset, size);
+    position += size;
+  }
+  s_hits++;
+  return true;
+}
+
+static void Learn(const BlockKey& first, u32 count)
+{
+  if (!SConfig::GetInstance().m_dvd_access_patterns || s_pattern_path.empty())
+    return;
+
+  auto it = s_jumps.find(s_last_read);
+  if (it != s_jumps.end())
+  {
+    if (it->second.block == first.block && it->second.count == count)
+      return;
+    it->second = {first.block, count};
+  }
+  else if (s_jumps.size() < PATTERN_MAX_ENTRIES)
+  {
+    s_jumps.emplace(s_last_read, Jump{first.block, count});
+  }
+  else
+  {
+    return;
+  }
+  s_pattern_dirty = true;
+}
+
+void OnRead(u64 offset, u32 length, const DiscIO::Partition& partition)
+{
+  const u32 max_blocks =
+      std::min<u32>(std::max(SConfig::GetInstance().m_dvd_read_ahead, 0), CACHE_BLOCKS / 2);
+  if (max_blocks == 0 || length == 0)
+    return;
+
+  const BlockKey first = {partition.offset, offset / BLOCK_SIZE};
+  const BlockKey last = {partition.offset, (offset + length - 1) / BLOCK_SIZE};
+  const u32 count = static_cast<u32>(last.block - first.block + 1);
+
+  const bool same_partition = s_has_last_read && s_last_read.partition == first.partition;
+  const bool sequential = same_partition && (first.block == s_last_read.block ||
+                                             first.block == s_last_read.block + 1);
+  if (sequential)
+    s_sequential_reads++;
+  else
+    s_sequential_reads = 0;
+  if (same_partition && !sequential)
+    Learn(first, count);
+  s_has_last_read = true;
+  s_last_read = last;
+
+  // The plan is rebuilt after every read, whatever is left of the old one is stale.
+  s_plan.clear();
+  if (s_sequential_reads > 0)
+  {
+    for (u32 i = 1; i <= max_blocks; i++)
+      s_plan.push_back({partition.offset, last.block + i});
+    return;
+  }
+
+  // Follow the jumps taken on earlier runs, the chain can loop so it is bounded by the plan size.
+  BlockKey from = last;
+  while (s_plan.size() < max_blocks)
+  {
+    auto it = s_jumps.find(from);
+    if (it == s_jumps.end())
+      break;
+    for (u32 i = 0; i < it->second.count && s_plan.size() < max_blocks; i++)
+      s_plan.push_back({partition.offset, it->second.block + i});
+    from = {partition.offset, it->second.block + it->second.count - 1};
+  }
+}
+
+static void Evict()
+{
+  auto oldest = std::min_element(s_cache.begin(), s_cache.end(), [](const auto& a, const auto& b) {
+    return a.second.last_use < b.second.last_use;
+  });
+  s_cache.erase(oldest);
+}
+
+bool PrefetchNext(const DiscIO::Volume& volume)
+{
+  while (!s_plan.empty())
+  {
+    const BlockKey key = s_plan.front();
+    s_plan.pop_front();
+
+    auto it = s_cache.find(key);
+    if (it != s_cache.end())
+    {
+      it->second.last_use = ++s_use_counter;
+      continue;
+    }
+
+    std::vector<u8> data(BLOCK_SIZE);
+    if (!volume.Read(key.block * BLOCK_SIZE, BLOCK_SIZE, data.data(),
+                     DiscIO::Partition(key.partition)))
+    {
+      // Most likely the end of the partition, nothing after it is worth reading either.
+      s_plan.clear();
+      return false;
+    }
+
+    if (s_cache.size() >= CACHE_BLOCKS)
+      Evict();
+    s_cache[key] = {std::move(data), ++s_use_counter};
+    return true;
+  }
+  return false;
+}
+}
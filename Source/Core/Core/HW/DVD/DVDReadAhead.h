@@ -0,0 +1,37 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+namespace DiscIO
+{
+struct Partition;
+class Volume;
+}
+
+// Host-side read-ahead for the DVD thread. It only changes when the host reads the disc image;
+// emulated reads still complete at the time DVDInterface scheduled for them.
+//
+// Sequential streaming is detected and the blocks after it are prefetched. Jumps between
+// non-adjacent blocks are remembered per game and saved, so later runs can prefetch the block
+// a game is going to seek to next.
+//
+// Everything here is only called from the DVD thread, or from the CPU thread while the DVD thread
+// is idle (see DVDThread::WaitUntilIdle), so there is no locking.
+namespace DVDReadAhead
+{
+// Drops the cache and loads the access pattern learned for the volume, which can be null.
+void SetVolume(const DiscIO::Volume* volume);
+// Saves the access pattern learned for the current volume and drops the cache.
+void Shutdown();
+
+// Copies an emulated read out of the cache. Returns false unless all of it was cached.
+bool Read(u64 offset, u32 length, u8* buffer, const DiscIO::Partition& partition);
+// Learns from an emulated read and plans what to prefetch after it.
+void OnRead(u64 offset, u32 length, const DiscIO::Partition& partition);
+// Reads the next planned block into the cache. Returns false once the plan is done.
+bool PrefetchNext(const DiscIO::Volume& volume);
+}
@@ -4,6 +4,7 @@
 
 #include "Core/HW/DVD/DVDThread.h"
 
+#include <atomic>
 #include <cinttypes>
 #include <map>
 #include <memory>
@@ -27,6 +28,7 @@
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/DVD/DVDInterface.h"
+#include "Core/HW/DVD/DVDReadAhead.h"
 #include "Core/HW/DVD/FileMonitor.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
@@ -77,6 +79,7 @@ static void FinishRead(u64 id, s64 cycles_late);
 static CoreTiming::EventType* s_finish_read;
 
 static u64 s_next_id = 0;
+static std::atomic<u32> s_read_count{0};
 
 static std::thread s_dvd_thread;
 static Common::Event s_request_queue_expanded;    // Is set by CPU thread
@@ -115,6 +118,7 @@ static void StartDVDThread()
 void Stop()
 {
   StopDVDThread();
+  DVDReadAhead::Shutdown();
   s_disc.reset();
 }
 
@@ -161,7 +165,7 @@ void DoState(PointerWrap& p)
     if (had_disc)
       PanicAlertT("An inserted disc was expected but not found.");
     else
-      s_disc.reset();
+      SetDisc(nullptr);
   }
 
   // TODO: Savestates can be smaller if the buffers of results aren't saved,
@@ -179,6 +183,7 @@ void SetDisc(std::unique_ptr<DiscIO::Volume> disc)
 {
   WaitUntilIdle();
   s_disc = std::move(disc);
+  DVDReadAhead::SetVolume(s_disc.get());
 }
 
 bool HasDisc()
@@ -270,10 +275,16 @@ static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offs
 
   s_request_queue.Push(std::move(request));
   s_request_queue_expanded.Set();
+  s_read_count.fetch_add(1, std::memory_order_relaxed);
 
   CoreTiming::ScheduleEvent(ticks_until_completion, s_finish_read, id);
 }
 
+u32 TakeReadCount()
+{
+  return s_read_count.exchange(0, std::memory_order_relaxed);
+}
+
 static void FinishRead(u64 id, s64 cycles_late)
 {
   // We can't simply pop s_result_queue and always get the ReadResult
@@ -346,14 +357,21 @@ static void DVDThread()
     if (s_dvd_thread_exiting.IsSet())
       return;
 
+    bool did_read = false;
     ReadRequest request;
     while (s_request_queue.Pop(request))
     {
       FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
 
       std::vector<u8> buffer(request.length);
-      if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
+      if (!DVDReadAhead::Read(request.dvd_offset, request.length, buffer.data(),
+                              request.partition) &&
+          !s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
+      {
         buffer.resize(0);
+      }
+      DVDReadAhead::OnRead(request.dvd_offset, request.length, request.partition);
+      did_read = true;
 
       request.realtime_done_us = Common::Timer::GetTimeUs();
 
@@ -363,6 +381,14 @@ static void DVDThread()
       if (s_dvd_thread_exiting.IsSet())
         return;
     }
+
+    // Prefetch one block at a time while there is nothing else to do, so that a new request
+    // waits for at most one block. Spurious wakeups don't prefetch, since SetDisc may be
+    // replacing s_disc after restarting this thread.
+    while (did_read && s_request_queue.Empty() && !s_dvd_thread_exiting.IsSet() &&
+           DVDReadAhead::PrefetchNext(*s_disc))
+    {
+    }
   }
 }
 }
@@ -57,4 +57,7 @@ void StartRead(u64 dvd_offset, u32 length, const DiscIO::Partition& partition,
 void StartReadToEmulatedRAM(u32 output_address, u64 dvd_offset, u32 length,
                             const DiscIO::Partition& partition, DVDInterface::ReplyType reply_type,
                             s64 ticks_until_completion);
+
+// Number of reads started since the last call, safe to call from any thread.
+u32 TakeReadCount();
 }
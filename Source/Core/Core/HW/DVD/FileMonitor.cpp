@@ -21,8 +21,12 @@
 
 namespace FileMonitor
 {
+// The file the last logged read fell into, so that further reads of it can be skipped without
+// looking it up again.
+static const DiscIO::FileSystem* s_previous_file_system;
 static DiscIO::Partition s_previous_partition;
 static u64 s_previous_file_offset;
+static u64 s_previous_file_end;
 
 // Filtered files
 static bool IsSoundFile(const std::string& filename)
@@ -62,6 +66,13 @@ void Log(const DiscIO::Volume& volume, const DiscIO::Partition& partition, u64 o
   if (!file_system)
     return;
 
+  // Do nothing if the read is still in the last file
+  if (s_previous_file_system == file_system && s_previous_partition == partition &&
+      offset >= s_previous_file_offset && offset < s_previous_file_end)
+  {
+    return;
+  }
+
   const std::unique_ptr<DiscIO::FileInfo> file_info = file_system->FindFileInfo(offset);
 
   // Do nothing if no file was found at that offset
@@ -71,8 +82,11 @@ void Log(const DiscIO::Volume& volume, const DiscIO::Partition& partition, u64 o
   const u64 file_offset = file_info->GetOffset();
 
   // Do nothing if we found the same file again
-  if (s_previous_partition == partition && s_previous_file_offset == file_offset)
+  if (s_previous_file_system == file_system && s_previous_partition == partition &&
+      s_previous_file_offset == file_offset)
+  {
     return;
+  }
 
   const std::string size_string = ThousandSeparate(file_info->GetSize() / 1000, 7);
   const std::string path = file_info->GetPath();
@@ -83,8 +97,10 @@ void Log(const DiscIO::Volume& volume, const DiscIO::Partition& partition, u64 o
     WARN_LOG(FILEMON, "%s", log_string.c_str());
 
   // Update the last accessed file
+  s_previous_file_system = file_system;
   s_previous_partition = partition;
   s_previous_file_offset = file_offset;
+  s_previous_file_end = file_offset + file_info->GetSize();
 }
 
 }  // namespace FileMonitor
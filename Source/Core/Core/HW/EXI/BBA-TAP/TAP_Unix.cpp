@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 
 #ifndef _WIN32
@@ -28,6 +30,10 @@ namespace ExpansionInterface
 #define NOTIMPLEMENTED(Name)                                                                       \
   NOTICE_LOG(SP1, "CEXIETHERNET::%s not implemented for your UNIX", Name);
 
+#ifdef __linux__
+static void WriteThreadHandler(CEXIETHERNET* self);
+#endif
+
 bool CEXIETHERNET::Activate()
 {
 #ifdef __linux__
@@ -69,8 +75,17 @@ bool CEXIETHERNET::Activate()
     }
   }
   ioctl(fd, TUNSETNOCSUM, 1);
+  // The read thread drains every pending frame after select and stops at EAGAIN.
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
 
   INFO_LOG(SP1, "BBA initialized with associated tap %s", ifr.ifr_name);
+
+  if (!mTxQueue)
+    mTxQueue = std::make_unique<TxFrame[]>(TX_QUEUE_SIZE);
+  mTxQueueRead.store(0);
+  mTxQueueWrite.store(0);
+  writeThreadShutdown.Clear();
+  writeThread = std::thread(WriteThreadHandler, this);
   return RecvInit();
 #else
   NOTIMPLEMENTED("Activate");
@@ -81,13 +96,19 @@ bool CEXIETHERNET::Activate()
 void CEXIETHERNET::Deactivate()
 {
 #ifdef __linux__
-  close(fd);
-  fd = -1;
-
   readEnabled.Clear();
   readThreadShutdown.Set();
   if (readThread.joinable())
     readThread.join();
+
+  // Queued frames are still sent before the device is closed.
+  writeThreadShutdown.Set();
+  writeEvent.Set();
+  if (writeThread.joinable())
+    writeThread.join();
+
+  close(fd);
+  fd = -1;
 #else
   NOTIMPLEMENTED("Deactivate");
 #endif
@@ -107,17 +128,24 @@ bool CEXIETHERNET::SendFrame(const u8* frame, u32 size)
 #ifdef __linux__
   DEBUG_LOG(SP1, "SendFrame %x\n%s", size, ArrayToString(frame, size, 0x10).c_str());
 
-  int writtenBytes = write(fd, frame, size);
-  if ((u32)writtenBytes != size)
+  const u32 write_index = mTxQueueWrite.load(std::memory_order_relaxed);
+  if (write_index - mTxQueueRead.load(std::memory_order_acquire) == TX_QUEUE_SIZE)
   {
-    ERROR_LOG(SP1, "SendFrame(): expected to write %d bytes, instead wrote %d", size, writtenBytes);
-    return false;
+    // Like a real NIC with a full queue, the frame is lost and the protocol above resends it.
+    WARN_LOG(SP1, "SendFrame(): TX queue full, dropping %d bytes", size);
   }
   else
   {
-    SendComplete();
-    return true;
+    TxFrame& tx_frame = mTxQueue[write_index % TX_QUEUE_SIZE];
+    tx_frame.size = std::min<u32>(size, BBA_TXFIFO_SIZE);
+    memcpy(tx_frame.data, frame, tx_frame.size);
+    mTxQueueWrite.store(write_index + 1, std::memory_order_release);
+    writeEvent.Set();
   }
+
+  // The frame leaves the FIFO right away, the write thread sends it in the background.
+  SendComplete();
+  return true;
 #else
   NOTIMPLEMENTED("SendFrame");
   return false;
@@ -125,6 +153,32 @@ bool CEXIETHERNET::SendFrame(const u8* frame, u32 size)
 }
 
 #ifdef __linux__
+static void WriteThreadHandler(CEXIETHERNET* self)
+{
+  while (true)
+  {
+    self->writeEvent.Wait();
+
+    // Send everything that was queued since the last wakeup.
+    u32 read_index = self->mTxQueueRead.load(std::memory_order_relaxed);
+    while (read_index != self->mTxQueueWrite.load(std::memory_order_acquire))
+    {
+      const CEXIETHERNET::TxFrame& frame =
+          self->mTxQueue[read_index % CEXIETHERNET::TX_QUEUE_SIZE];
+      const int writtenBytes = write(self->fd, frame.data, frame.size);
+      if ((u32)writtenBytes != frame.size)
+      {
+        ERROR_LOG(SP1, "SendFrame(): expected to write %d bytes, instead wrote %d", frame.size,
+                  writtenBytes);
+      }
+      self->mTxQueueRead.store(++read_index, std::memory_order_release);
+    }
+
+    if (self->writeThreadShutdown.IsSet())
+      break;
+  }
+}
+
 static void ReadThreadHandler(CEXIETHERNET* self)
 {
   while (!self->readThreadShutdown.IsSet())
@@ -139,17 +193,23 @@ static void ReadThreadHandler(CEXIETHERNET* self)
     if (select(self->fd + 1, &rfds, nullptr, nullptr, &timeout) <= 0)
       continue;
 
-    int readBytes = read(self->fd, self->mRecvBuffer.get(), BBA_RECV_SIZE);
-    if (readBytes < 0)
-    {
-      ERROR_LOG(SP1, "Failed to read from BBA, err=%d", readBytes);
-    }
-    else if (self->readEnabled.IsSet())
+    // Handle every frame that arrived, instead of going back to select for each one.
+    while (true)
     {
-      DEBUG_LOG(SP1, "Read data: %s",
-                ArrayToString(self->mRecvBuffer.get(), readBytes, 0x10).c_str());
-      self->mRecvBufferLength = readBytes;
-      self->RecvHandlePacket();
+      int readBytes = read(self->fd, self->mRecvBuffer.get(), BBA_RECV_SIZE);
+      if (readBytes < 0)
+      {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+          ERROR_LOG(SP1, "Failed to read from BBA, err=%d", errno);
+        break;
+      }
+      if (self->readEnabled.IsSet())
+      {
+        DEBUG_LOG(SP1, "Read data: %s",
+                  ArrayToString(self->mRecvBuffer.get(), readBytes, 0x10).c_str());
+        self->mRecvBufferLength = readBytes;
+        self->RecvHandlePacket();
+      }
     }
   }
 }
@@ -158,6 +218,7 @@ static void ReadThreadHandler(CEXIETHERNET* self)
 bool CEXIETHERNET::RecvInit()
 {
 #ifdef __linux__
+  readThreadShutdown.Clear();
   readThread = std::thread(ReadThreadHandler, this);
   return true;
 #else
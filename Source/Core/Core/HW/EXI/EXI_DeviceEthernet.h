@@ -5,6 +5,7 @@
 #pragma once
 
 #include <atomic>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -12,6 +13,7 @@
 #include <Windows.h>
 #endif
 
+#include "Common/Event.h"
 #include "Common/Flag.h"
 #include "Core/HW/EXI/EXI_Device.h"
 
@@ -339,5 +341,22 @@ public:
   Common::Flag readEnabled;
   Common::Flag readThreadShutdown;
 #endif
+
+#if defined(__linux__)
+  // Frames waiting for the write thread, so sending never blocks the CPU thread on the TAP device.
+  // The CPU thread is the only producer and the write thread the only consumer.
+  struct TxFrame
+  {
+    u32 size;
+    u8 data[BBA_TXFIFO_SIZE];
+  };
+  static constexpr u32 TX_QUEUE_SIZE = 32;
+  std::unique_ptr<TxFrame[]> mTxQueue;
+  std::atomic<u32> mTxQueueRead{0};
+  std::atomic<u32> mTxQueueWrite{0};
+  std::thread writeThread;
+  Common::Event writeEvent;
+  Common::Flag writeThreadShutdown;
+#endif
 };
 }  // namespace ExpansionInterface
@@ -520,11 +520,38 @@ bool GCMemcardDirectory::SetUsedBlocks(int save_index)
   return true;
 }
 
+// Writes to a temporary file first so that a crash or a full disk can't leave a truncated save.
+static bool WriteGCIFile(const std::string& file_name, const DEntry& header,
+                         const std::vector<GCMBlock>& save_data)
+{
+  const std::string temp_name = file_name + ".tmp";
+  {
+    File::IOFile gci(temp_name, "wb");
+    if (!gci || !gci.WriteBytes(&header, DENTRY_SIZE) ||
+        !gci.WriteBytes(save_data.data(), BLOCK_SIZE * save_data.size()) || !gci.Close())
+    {
+      gci.Close();
+      File::Delete(temp_name);
+      return false;
+    }
+  }
+  return File::Rename(temp_name, file_name);
+}
+
 void GCMemcardDirectory::FlushToFile()
 {
+  struct PendingWrite
+  {
+    std::string file_name;
+    DEntry header;
+    std::vector<GCMBlock> save_data;
+  };
+  std::vector<PendingWrite> writes;
+  std::vector<std::string> deletions;
+
+  // Only the dirty saves are copied while the emulated card is locked, the file I/O happens
+  // afterwards so that the CPU thread doesn't wait for the disk when it writes to the card.
   std::unique_lock<std::mutex> l(m_write_mutex);
-  int errors = 0;
-  DEntry invalid;
   for (u16 i = 0; i < m_saves.size(); ++i)
   {
     if (m_saves[i].m_dirty)
@@ -557,36 +584,13 @@ void GCMemcardDirectory::FlushToFile()
                         default_save_name.c_str());
           m_saves[i].m_filename = default_save_name;
         }
-        File::IOFile gci(m_saves[i].m_filename, "wb");
-        if (gci)
-        {
-          gci.WriteBytes(&m_saves[i].m_gci_header, DENTRY_SIZE);
-          gci.WriteBytes(m_saves[i].m_save_data.data(), BLOCK_SIZE * m_saves[i].m_save_data.size());
-
-          if (gci.IsGood())
-          {
-            Core::DisplayMessage(
-                StringFromFormat("Wrote save contents to %s", m_saves[i].m_filename.c_str()), 4000);
-          }
-          else
-          {
-            ++errors;
-            Core::DisplayMessage(StringFromFormat("Failed to write save contents to %s",
-                                                  m_saves[i].m_filename.c_str()),
-                                 4000);
-            ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s",
-                      m_saves[i].m_filename.c_str());
-          }
-        }
+        writes.push_back(
+            {m_saves[i].m_filename, m_saves[i].m_gci_header, m_saves[i].m_save_data});
       }
       else if (m_saves[i].m_filename.length() != 0)
       {
         m_saves[i].m_dirty = false;
-        std::string& old_name = m_saves[i].m_filename;
-        std::string deleted_name = old_name + ".deleted";
-        if (File::Exists(deleted_name))
-          File::Delete(deleted_name);
-        File::Rename(old_name, deleted_name);
+        deletions.push_back(std::move(m_saves[i].m_filename));
         m_saves[i].m_filename.clear();
         m_saves[i].m_save_data.clear();
         m_saves[i].m_used_blocks.clear();
@@ -606,6 +610,31 @@ void GCMemcardDirectory::FlushToFile()
       m_saves[i].m_save_data.clear();
     }
   }
+  l.unlock();
+
+  for (const PendingWrite& write : writes)
+  {
+    if (WriteGCIFile(write.file_name, write.header, write.save_data))
+    {
+      Core::DisplayMessage(
+          StringFromFormat("Wrote save contents to %s", write.file_name.c_str()), 4000);
+    }
+    else
+    {
+      Core::DisplayMessage(
+          StringFromFormat("Failed to write save contents to %s", write.file_name.c_str()), 4000);
+      ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s", write.file_name.c_str());
+    }
+  }
+
+  for (const std::string& old_name : deletions)
+  {
+    std::string deleted_name = old_name + ".deleted";
+    if (File::Exists(deleted_name))
+      File::Delete(deleted_name);
+    File::Rename(old_name, deleted_name);
+  }
+
 #if _WRITE_MC_HEADER
   u8 mc[BLOCK_SIZE * MC_FST_BLOCKS];
   Read(0, BLOCK_SIZE * MC_FST_BLOCKS, mc);
@@ -10,15 +10,24 @@
 #include "Core/HW/Memmap.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <memory>
+#include <unordered_map>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "Common/Align.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/Swap.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
 #include "Core/HW/AudioInterface.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DVD/DVDInterface.h"
@@ -113,6 +122,7 @@ struct LogicalMemoryView
 {
   void* mapped_pointer;
   u32 mapped_size;
+  u32 physical_address;
 };
 
 // Dolphin allocates memory to represent four regions:
@@ -164,6 +174,60 @@ static PhysicalMemoryRegion physical_regions[] = {
 
 static std::vector<LogicalMemoryView> logical_mapped_entries;
 
+// Write tracking for RAM snapshots
+static constexpr u32 TRACKED_PAGE_SHIFT = 12;
+static constexpr u32 TRACKED_PAGE_SIZE = 1 << TRACKED_PAGE_SHIFT;
+
+struct TrackedRegion
+{
+  const PhysicalMemoryRegion* region;
+  // The generation in which each page was last written. Pages not written in the current
+  // generation are write-protected.
+  std::vector<u32> page_generation;
+};
+
+static std::array<TrackedRegion, 2> s_tracked_regions = {
+    {{&physical_regions[0], {}}, {&physical_regions[3], {}}}};
+static bool s_write_tracking = false;
+static u32 s_generation = 1;
+static bool s_do_state_skips_ram = false;
+
+static void ProtectPages(bool written, bool protect);
+
+// Page table fastmem
+static constexpr u32 MAPPED_PAGE_SHIFT = 12;
+static constexpr u32 MAPPED_PAGE_SIZE = 1 << MAPPED_PAGE_SHIFT;
+// Every page is a separate host mapping, and the number of those is limited (vm.max_map_count on
+// Linux). Once this many pages are mapped, they are all dropped and mapped again as needed.
+static constexpr size_t MAX_MAPPED_PAGES = 8192;
+// tlbie invalidates a whole set of the TLB, which is selected by these bits of the page index.
+static constexpr u32 TLB_SET_MASK = 0x3f;
+
+struct MappedPage
+{
+  u32 physical_address;
+  // Stores fault until the changed bit of the page is set.
+  bool writable;
+};
+
+static bool s_page_table_fastmem = false;
+// Keyed by logical address.
+static std::unordered_map<u32, MappedPage> s_mapped_pages;
+static std::array<std::vector<u32>, TLB_SET_MASK + 1> s_mapped_pages_by_set;
+
+static bool CanMapPageTable()
+{
+#if defined(_ARCH_32) || defined(_WIN32) || defined(_M_GENERIC) ||                                 \
+    (defined(__APPLE__) && !defined(USE_SIGACTION_ON_APPLE))
+  // Views are placed by the fault handler, and have to be as small as a guest page. Windows can
+  // only place views at a 64 KiB granularity.
+  return false;
+#else
+  return SConfig::GetInstance().bFastmem &&
+         sysconf(_SC_PAGESIZE) == static_cast<long>(MAPPED_PAGE_SIZE);
+#endif
+}
+
 void Init()
 {
   bool wii = SConfig::GetInstance().bWii;
@@ -181,15 +245,19 @@ void Init()
     flags |= PhysicalMemoryRegion::WII_ONLY;
   if (bFakeVMEM)
     flags |= PhysicalMemoryRegion::FAKE_VMEM;
+  const bool huge_pages = SConfig::GetInstance().bHugePages;
   u32 mem_size = 0;
   for (PhysicalMemoryRegion& region : physical_regions)
   {
     if ((flags & region.flags) != region.flags)
       continue;
+    // A huge page can only back a view if its offset in the segment is aligned like its address
+    if (huge_pages)
+      mem_size = Common::AlignUp(mem_size, MemArena::HUGE_PAGE_SIZE);
     region.shm_position = mem_size;
     mem_size += region.size;
   }
-  g_arena.GrabSHMSegment(mem_size);
+  g_arena.GrabSHMSegment(mem_size, huge_pages);
   physical_base = MemArena::FindMemoryBase();
 
   for (PhysicalMemoryRegion& region : physical_regions)
@@ -210,6 +278,7 @@ void Init()
 #ifndef _ARCH_32
   logical_base = physical_base + 0x200000000;
 #endif
+  s_page_table_fastmem = bMMU && CanMapPageTable();
 
   if (wii)
     mmio_mapping = InitMMIOWii();
@@ -224,6 +293,7 @@ void Init()
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 {
+  ClearPageTableMappings();
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
@@ -234,9 +304,17 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
     if (dbat_table[i] & PowerPC::BAT_PHYSICAL_BIT)
     {
       u32 logical_address = i << PowerPC::BAT_INDEX_SHIFT;
-      // TODO: Merge adjacent mappings to make this faster.
-      u32 logical_size = PowerPC::BAT_PAGE_SIZE;
       u32 translated_address = dbat_table[i] & PowerPC::BAT_RESULT_MASK;
+      // Entries that continue the same physical range are mapped as one view. That needs fewer
+      // mmap calls, and views of 2 MiB and more can be backed by huge pages.
+      u32 logical_size = PowerPC::BAT_PAGE_SIZE;
+      while (i + 1 < dbat_table.size() && (dbat_table[i + 1] & PowerPC::BAT_PHYSICAL_BIT) &&
+             translated_address + logical_size > translated_address &&
+             (dbat_table[i + 1] & PowerPC::BAT_RESULT_MASK) == translated_address + logical_size)
+      {
+        logical_size += PowerPC::BAT_PAGE_SIZE;
+        ++i;
+      }
       for (const auto& physical_region : physical_regions)
       {
         u32 mapping_address = physical_region.physical_address;
@@ -256,29 +334,400 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
             PanicAlert("MemoryMap_Setup: Failed finding a memory base.");
             exit(0);
           }
-          logical_mapped_entries.push_back({mapped_pointer, mapped_size});
+          logical_mapped_entries.push_back({mapped_pointer, mapped_size, intersection_start});
         }
       }
     }
   }
+
+  // New views of pages that are being tracked start out protected too.
+  if (s_write_tracking)
+    ProtectPages(false, true);
 }
 
 void DoState(PointerWrap& p)
 {
   bool wii = SConfig::GetInstance().bWii;
-  p.DoArray(m_pRAM, RAM_SIZE);
+  if (!s_do_state_skips_ram)
+    p.DoArray(m_pRAM, RAM_SIZE);
   p.DoArray(m_pL1Cache, L1_CACHE_SIZE);
   p.DoMarker("Memory RAM");
   if (m_pFakeVMEM)
     p.DoArray(m_pFakeVMEM, FAKEVMEM_SIZE);
   p.DoMarker("Memory FakeVMEM");
-  if (wii)
+  if (wii && !s_do_state_skips_ram)
     p.DoArray(m_pEXRAM, EXRAM_SIZE);
   p.DoMarker("Memory EXRAM");
 }
 
+void SetDoStateSkipsRAM(bool skip)
+{
+  s_do_state_skips_ram = skip;
+}
+
+// Changes the protection of a range of a tracked region in every view that maps it.
+static void SetRangeProtection(const PhysicalMemoryRegion& region, u32 offset, u32 size,
+                               bool protect)
+{
+  const auto set_protection = [protect](void* ptr, size_t len) {
+    if (protect)
+      Common::WriteProtectMemory(ptr, len);
+    else
+      Common::UnWriteProtectMemory(ptr, len);
+  };
+
+  set_protection(*region.out_pointer + offset, size);
+
+  const u32 start = region.physical_address + offset;
+  const u32 end = start + size;
+  for (const LogicalMemoryView& view : logical_mapped_entries)
+  {
+    const u32 view_start = std::max(start, view.physical_address);
+    const u32 view_end = std::min(end, view.physical_address + view.mapped_size);
+    if (view_start < view_end)
+    {
+      set_protection(static_cast<u8*>(view.mapped_pointer) + (view_start - view.physical_address),
+                     view_end - view_start);
+    }
+  }
+}
+
+// Protects (or unprotects) every run of pages that was, or wasn't, written in the current
+// generation.
+static void ProtectPages(bool written, bool protect)
+{
+  // Mapped pages get the new protection when they are mapped again.
+  ClearPageTableMappings();
+
+  for (const TrackedRegion& tracked : s_tracked_regions)
+  {
+    const u32 page_count = static_cast<u32>(tracked.page_generation.size());
+    u32 page = 0;
+    while (page < page_count)
+    {
+      if ((tracked.page_generation[page] == s_generation) != written)
+      {
+        ++page;
+        continue;
+      }
+
+      const u32 first = page;
+      while (page < page_count && (tracked.page_generation[page] == s_generation) == written)
+        ++page;
+      SetRangeProtection(*tracked.region, first << TRACKED_PAGE_SHIFT,
+                         (page - first) << TRACKED_PAGE_SHIFT, protect);
+    }
+  }
+}
+
+static bool CanTrackWrites()
+{
+#if defined(_M_GENERIC) || (defined(__APPLE__) && !defined(USE_SIGACTION_ON_APPLE))
+  // There is either no fault handler, or it only sees faults on the CPU thread.
+  return false;
+#else
+  return SConfig::GetInstance().bFastmem;
+#endif
+}
+
+static void StartWriteTracking()
+{
+  for (TrackedRegion& tracked : s_tracked_regions)
+  {
+    const bool present = *tracked.region->out_pointer != nullptr;
+    tracked.page_generation.assign(present ? tracked.region->size >> TRACKED_PAGE_SHIFT : 0,
+                                   s_generation);
+  }
+
+  // Everything counts as written in the generation before tracking started.
+  ++s_generation;
+  s_write_tracking = true;
+  ProtectPages(false, true);
+}
+
+static void StopWriteTracking()
+{
+  if (!s_write_tracking)
+    return;
+
+  ProtectPages(false, false);
+  s_write_tracking = false;
+  ++s_generation;
+  for (TrackedRegion& tracked : s_tracked_regions)
+    tracked.page_generation.clear();
+}
+
+// Returns the tracked region and the page in it of a physical address, or nullptr.
+static TrackedRegion* FindTrackedPage(u32 physical_address, u32* page)
+{
+  for (TrackedRegion& tracked : s_tracked_regions)
+  {
+    const PhysicalMemoryRegion& region = *tracked.region;
+    if (!tracked.page_generation.empty() && physical_address >= region.physical_address &&
+        physical_address - region.physical_address < region.size)
+    {
+      *page = (physical_address - region.physical_address) >> TRACKED_PAGE_SHIFT;
+      return &tracked;
+    }
+  }
+  return nullptr;
+}
+
+bool HandleWriteFault(uintptr_t address)
+{
+  if (!s_write_tracking)
+    return false;
+
+  for (TrackedRegion& tracked : s_tracked_regions)
+  {
+    const PhysicalMemoryRegion& region = *tracked.region;
+    if (tracked.page_generation.empty())
+      continue;
+
+    u32 offset = region.size;
+    const uintptr_t base = reinterpret_cast<uintptr_t>(*region.out_pointer);
+    if (address >= base && address < base + region.size)
+    {
+      offset = static_cast<u32>(address - base);
+    }
+    else
+    {
+      for (const LogicalMemoryView& view : logical_mapped_entries)
+      {
+        const uintptr_t view_base = reinterpret_cast<uintptr_t>(view.mapped_pointer);
+        if (address >= view_base && address < view_base + view.mapped_size &&
+            view.physical_address >= region.physical_address &&
+            view.physical_address < region.physical_address + region.size)
+        {
+          offset = static_cast<u32>(address - view_base) + view.physical_address -
+                   region.physical_address;
+          break;
+        }
+      }
+    }
+    if (offset >= region.size)
+      continue;
+
+    const u32 page = offset >> TRACKED_PAGE_SHIFT;
+    if (tracked.page_generation[page] != s_generation)
+    {
+      tracked.page_generation[page] = s_generation;
+      SetRangeProtection(region, page << TRACKED_PAGE_SHIFT, TRACKED_PAGE_SIZE, false);
+    }
+    return true;
+  }
+
+  return false;
+}
+
+void PrepareHostWrite(u32 address, u32 size)
+{
+  if (!s_write_tracking || size == 0)
+    return;
+
+  address &= 0x3FFFFFFF;
+  for (TrackedRegion& tracked : s_tracked_regions)
+  {
+    const PhysicalMemoryRegion& region = *tracked.region;
+    if (tracked.page_generation.empty() || address < region.physical_address ||
+        address - region.physical_address >= region.size)
+    {
+      continue;
+    }
+
+    const u32 offset = address - region.physical_address;
+    const u32 end = std::min(region.size, offset + size);
+    for (u32 page = offset >> TRACKED_PAGE_SHIFT; (page << TRACKED_PAGE_SHIFT) < end; ++page)
+    {
+      if (tracked.page_generation[page] != s_generation)
+      {
+        tracked.page_generation[page] = s_generation;
+        SetRangeProtection(region, page << TRACKED_PAGE_SHIFT, TRACKED_PAGE_SIZE, false);
+      }
+    }
+    return;
+  }
+}
+
+static void UnmapPage(u32 logical_address)
+{
+  g_arena.ReleaseView(logical_base + logical_address, MAPPED_PAGE_SIZE);
+  s_mapped_pages.erase(logical_address);
+}
+
+bool HandlePageTableFault(uintptr_t address)
+{
+  const uintptr_t base = reinterpret_cast<uintptr_t>(logical_base);
+  if (!s_page_table_fastmem || address < base || address - base >= 0x100000000 ||
+      !Core::IsCPUThread())
+  {
+    return false;
+  }
+
+  const u32 logical_address = static_cast<u32>(address - base) & ~(MAPPED_PAGE_SIZE - 1);
+  u8* view = logical_base + logical_address;
+  u32 physical_address;
+  bool changed;
+
+  auto it = s_mapped_pages.find(logical_address);
+  if (it != s_mapped_pages.end())
+  {
+    // A fault on a mapped page is a store, either the first one or one to a tracked page.
+    MappedPage& page = it->second;
+    if (!page.writable)
+    {
+      if (!PowerPC::TranslatePageTableAddress(logical_address, true, &physical_address,
+                                              &changed) ||
+          physical_address != page.physical_address)
+      {
+        UnmapPage(logical_address);
+        return false;
+      }
+      page.writable = true;
+    }
+
+    u32 tracked_page;
+    TrackedRegion* tracked = FindTrackedPage(page.physical_address, &tracked_page);
+    if (tracked && tracked->page_generation[tracked_page] != s_generation)
+    {
+      tracked->page_generation[tracked_page] = s_generation;
+      SetRangeProtection(*tracked->region, tracked_page << TRACKED_PAGE_SHIFT, TRACKED_PAGE_SIZE,
+                         false);
+    }
+    Common::UnWriteProtectMemory(view, MAPPED_PAGE_SIZE);
+    return true;
+  }
+
+  if (!PowerPC::TranslatePageTableAddress(logical_address, false, &physical_address, &changed))
+    return false;
+
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if (!*region.out_pointer || physical_address < region.physical_address ||
+        physical_address - region.physical_address >= region.size)
+    {
+      continue;
+    }
+
+    if (s_mapped_pages.size() >= MAX_MAPPED_PAGES)
+      ClearPageTableMappings();
+
+    const u32 position = region.shm_position + physical_address - region.physical_address;
+    if (!g_arena.CreateView(position, MAPPED_PAGE_SIZE, view))
+      return false;
+
+    u32 tracked_page;
+    const TrackedRegion* tracked = FindTrackedPage(physical_address, &tracked_page);
+    if (!changed || (tracked && tracked->page_generation[tracked_page] != s_generation))
+      Common::WriteProtectMemory(view, MAPPED_PAGE_SIZE);
+
+    s_mapped_pages[logical_address] = {physical_address, changed};
+    s_mapped_pages_by_set[(logical_address >> MAPPED_PAGE_SHIFT) & TLB_SET_MASK].push_back(
+        logical_address);
+    return true;
+  }
+
+  return false;
+}
+
+void InvalidatePageTableMappings(u32 address)
+{
+  std::vector<u32>& set = s_mapped_pages_by_set[(address >> MAPPED_PAGE_SHIFT) & TLB_SET_MASK];
+  for (u32 logical_address : set)
+  {
+    if (s_mapped_pages.count(logical_address))
+      UnmapPage(logical_address);
+  }
+  set.clear();
+}
+
+void ClearPageTableMappings()
+{
+  for (const auto& page : s_mapped_pages)
+    g_arena.ReleaseView(logical_base + page.first, MAPPED_PAGE_SIZE);
+  s_mapped_pages.clear();
+  for (std::vector<u32>& set : s_mapped_pages_by_set)
+    set.clear();
+}
+
+void SaveRAMSnapshot(RAMSnapshot& snapshot)
+{
+  if (!s_write_tracking && CanTrackWrites())
+    StartWriteTracking();
+
+  std::array<std::vector<u8>*, 2> copies = {{&snapshot.ram, &snapshot.exram}};
+  for (size_t i = 0; i < s_tracked_regions.size(); ++i)
+  {
+    const PhysicalMemoryRegion& region = *s_tracked_regions[i].region;
+    const std::vector<u32>& page_generation = s_tracked_regions[i].page_generation;
+    std::vector<u8>& copy = *copies[i];
+    const u8* memory = *region.out_pointer;
+    if (!memory)
+    {
+      copy.clear();
+      continue;
+    }
+
+    if (!s_write_tracking || copy.size() != region.size)
+    {
+      copy.assign(memory, memory + region.size);
+      continue;
+    }
+
+    for (size_t page = 0; page < page_generation.size(); ++page)
+    {
+      if (page_generation[page] >= snapshot.generation)
+      {
+        const size_t offset = page << TRACKED_PAGE_SHIFT;
+        std::memcpy(&copy[offset], memory + offset, TRACKED_PAGE_SIZE);
+      }
+    }
+  }
+
+  // Start a new generation, so that the next write to every page is seen again.
+  if (s_write_tracking)
+    ProtectPages(true, true);
+  ++s_generation;
+  snapshot.generation = s_generation;
+}
+
+void LoadRAMSnapshot(const RAMSnapshot& snapshot)
+{
+  std::array<const std::vector<u8>*, 2> copies = {{&snapshot.ram, &snapshot.exram}};
+  for (size_t i = 0; i < s_tracked_regions.size(); ++i)
+  {
+    const PhysicalMemoryRegion& region = *s_tracked_regions[i].region;
+    std::vector<u32>& page_generation = s_tracked_regions[i].page_generation;
+    const std::vector<u8>& copy = *copies[i];
+    u8* memory = *region.out_pointer;
+    if (!memory || copy.size() != region.size)
+      continue;
+
+    if (!s_write_tracking)
+    {
+      std::memcpy(memory, copy.data(), region.size);
+      continue;
+    }
+
+    for (size_t page = 0; page < page_generation.size(); ++page)
+    {
+      if (page_generation[page] < snapshot.generation)
+        continue;
+
+      const u32 offset = static_cast<u32>(page << TRACKED_PAGE_SHIFT);
+      if (page_generation[page] != s_generation)
+      {
+        page_generation[page] = s_generation;
+        SetRangeProtection(region, offset, TRACKED_PAGE_SIZE, false);
+      }
+      std::memcpy(memory + offset, &copy[offset], TRACKED_PAGE_SIZE);
+    }
+  }
+}
+
 void Shutdown()
 {
+  StopWriteTracking();
   m_IsInitialized = false;
   u32 flags = 0;
   if (SConfig::GetInstance().bWii)
@@ -297,6 +746,8 @@ void Shutdown()
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
   }
   logical_mapped_entries.clear();
+  ClearPageTableMappings();
+  s_page_table_fastmem = false;
   g_arena.ReleaseSHMSegment();
   physical_base = nullptr;
   logical_base = nullptr;
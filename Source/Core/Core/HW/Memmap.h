@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
@@ -68,6 +70,44 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
 void Clear();
 
+// Copies of RAM and EXRAM for in-memory savestates. While write tracking is available (it needs
+// the fastmem fault handler), RAM is write-protected after each snapshot and the first write to a
+// page is recorded, so saving or loading a snapshot only copies the pages written since that
+// snapshot was last saved.
+struct RAMSnapshot
+{
+  std::vector<u8> ram;
+  std::vector<u8> exram;
+  // Pages last written in this generation or later differ from the snapshot.
+  u32 generation = 0;
+};
+
+void SaveRAMSnapshot(RAMSnapshot& snapshot);
+void LoadRAMSnapshot(const RAMSnapshot& snapshot);
+
+// While set, DoState leaves out RAM and EXRAM, for states whose RAM is in a RAMSnapshot.
+void SetDoStateSkipsRAM(bool skip);
+
+// Called from the fault handler. Returns true if the fault was a write to a tracked page.
+bool HandleWriteFault(uintptr_t address);
+
+// Must be called before the host OS writes into emulated memory directly (e.g. a read() or
+// recv() into a pointer from GetPointer), since a write to a protected page from inside a system
+// call fails instead of raising a fault that can be handled.
+void PrepareHostWrite(u32 address, u32 size);
+
+// Page table fastmem. With the MMU enabled, only the BAT mapped ranges of logical memory have
+// views up front. When a JIT access to another address faults and the address translates through
+// the guest page table to memory, that 4 KiB page is mapped and the access is retried, instead of
+// the access being patched to the slow path. Pages stay read-only until their changed bit is set,
+// so the first store to a page still sets it.
+// Called from the fault handler. Returns true if the fault was handled.
+bool HandlePageTableFault(uintptr_t address);
+// Unmaps the pages in the TLB set that tlbie on this address invalidates.
+void InvalidatePageTableMappings(u32 address);
+// Unmaps all pages, for when the segment registers, SDR1 or the BATs change.
+void ClearPageTableMappings();
+
 // Routines to access physically addressed memory, designed for use by
 // emulated hardware outside the CPU. Use "Device_" prefix.
 std::string GetString(u32 em_address, size_t size = 0);
@@ -11,6 +11,8 @@
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+#include "Common/Timer.h"
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/MMIO.h"
@@ -223,6 +225,30 @@ static std::array<u8, 128> s_si_buffer;
 
 std::chrono::time_point<std::chrono::high_resolution_clock> last_si_read;
 
+// Time of the last host input update, to trace how old the input is when the game reads it.
+static u64 s_input_update_time = 0;
+// Whether the input was already refreshed for a controller read since the last SI poll.
+static bool s_input_latched = false;
+
+static void UpdateHostInput()
+{
+  g_controller_interface.UpdateInput();
+  s_input_update_time = Common::Timer::GetTimeUs();
+}
+
+// Late latch: refresh the host input when the game reads the first controller after a poll,
+// so it sees the newest state instead of the one sampled at the poll.
+static void LatchInput()
+{
+  if (s_input_latched || !SConfig::GetInstance().m_late_input_latch ||
+      NetPlay::IsNetPlayRunning())
+  {
+    return;
+  }
+  s_input_latched = true;
+  UpdateHostInput();
+}
+
 void DoState(PointerWrap& p)
 {
   for (int i = 0; i < MAX_SI_CHANNELS; i++)
@@ -372,6 +398,7 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
                 CoreTiming::ScheduleEvent(diff - (diff / NetPlayClient::buffer_accuracy) * (netplay_client->BufferSizeForPort(c) % NetPlayClient::buffer_accuracy), et_send_netplay_inputs);
 
               last_si_read = std::chrono::high_resolution_clock::now();
+              LatchInput();
             }
 
             // Stop if we are not the first plugged in controller
@@ -382,6 +409,17 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
         // the HI register is read before the LO register (at least by Melee)
         s_channel[i].device->GetData(s_channel[i].in_hi.hex, s_channel[i].in_lo.hex);
       }
+      else if (SConfig::GetInstance().m_late_input_latch && (s_status_reg.hex & (1 << rdst_bit)) &&
+               !NetPlay::IsNetPlayRunning())
+      {
+        // The game reads the data of the last poll for the first time, replace it with the
+        // current state.
+        LatchInput();
+        s_channel[i].device->GetData(s_channel[i].in_hi.hex, s_channel[i].in_lo.hex);
+      }
+
+      DEBUG_LOG(SERIALINTERFACE, "Channel %d read, input age %llu us", i,
+                static_cast<unsigned long long>(Common::Timer::GetTimeUs() - s_input_update_time));
 
       s_status_reg.hex &= ~(1 << rdst_bit);
       UpdateInterrupts();
@@ -616,7 +654,8 @@ void ChangeDeviceDeterministic(SIDevices device, int channel)
 void UpdateDevices()
 {
   // Update inputs at 240 hz
-  g_controller_interface.UpdateInput();
+  UpdateHostInput();
+  s_input_latched = false;
 
   if (SConfig::GetInstance().iPollingMethod == POLLING_ONSIREAD)
   {
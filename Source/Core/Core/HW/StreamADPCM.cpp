@@ -18,27 +18,18 @@ static s32 histl2;
 static s32 histr1;
 static s32 histr2;
 
-static s16 ADPDecodeSample(s32 bits, s32 q, s32& hist1, s32& hist2)
+// Predictor coefficients for hist1 and hist2, selected by the top nibble of
+// the block header. Only filters 0-3 exist, the others decode like filter 0.
+static constexpr s32 s_filter_coefs[16][2] = {
+    {0, 0}, {0x3c, 0}, {0x73, -0x34}, {0x62, -0x37},
+};
+
+static s16 ADPDecodeSample(s32 bits, s32 shift, s32 coef1, s32 coef2, s32& hist1, s32& hist2)
 {
-  s32 hist = 0;
-  switch (q >> 4)
-  {
-  case 0:
-    hist = 0;
-    break;
-  case 1:
-    hist = (hist1 * 0x3c);
-    break;
-  case 2:
-    hist = (hist1 * 0x73) - (hist2 * 0x34);
-    break;
-  case 3:
-    hist = (hist1 * 0x62) - (hist2 * 0x37);
-    break;
-  }
+  s32 hist = (hist1 * coef1) + (hist2 * coef2);
   hist = MathUtil::Clamp((hist + 0x20) >> 6, -0x200000, 0x1fffff);
 
-  s32 cur = (((s16)(bits << 12) >> (q & 0xf)) << 6) + hist;
+  s32 cur = (((s16)(bits << 12) >> shift) << 6) + hist;
 
   hist2 = hist1;
   hist1 = cur;
@@ -67,12 +58,21 @@ void DoState(PointerWrap& p)
 
 void DecodeBlock(s16* pcm, const u8* adpcm)
 {
+  // The filter and shift only change per block, so they are looked up once.
+  // Both channels are decoded in the same loop since they don't depend on
+  // each other.
+  const s32 shift_l = adpcm[0] & 0xf;
+  const s32 coef1_l = s_filter_coefs[adpcm[0] >> 4][0];
+  const s32 coef2_l = s_filter_coefs[adpcm[0] >> 4][1];
+  const s32 shift_r = adpcm[1] & 0xf;
+  const s32 coef1_r = s_filter_coefs[adpcm[1] >> 4][0];
+  const s32 coef2_r = s_filter_coefs[adpcm[1] >> 4][1];
+
+  const u8* data = adpcm + (ONE_BLOCK_SIZE - SAMPLES_PER_BLOCK);
   for (int i = 0; i < SAMPLES_PER_BLOCK; i++)
   {
-    pcm[i * 2] = ADPDecodeSample(adpcm[i + (ONE_BLOCK_SIZE - SAMPLES_PER_BLOCK)] & 0xf, adpcm[0],
-      histl1, histl2);
-    pcm[i * 2 + 1] = ADPDecodeSample(adpcm[i + (ONE_BLOCK_SIZE - SAMPLES_PER_BLOCK)] >> 4, adpcm[1],
-      histr1, histr2);
+    pcm[i * 2] = ADPDecodeSample(data[i] & 0xf, shift_l, coef1_l, coef2_l, histl1, histl2);
+    pcm[i * 2 + 1] = ADPDecodeSample(data[i] >> 4, shift_r, coef1_r, coef2_r, histr1, histr2);
   }
 }
 }
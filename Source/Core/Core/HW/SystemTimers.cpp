@@ -45,8 +45,11 @@ IPC_HLE_PERIOD: For the Wii Remote this is the call schedule:
 
 #include "Core/HW/SystemTimers.h"
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
+#include <thread>
 
 #include "Common/Atomic.h"
 #include "Common/CommonTypes.h"
@@ -91,6 +94,20 @@ static int s_ipc_hle_period;
 // Custom RTC
 static s64 s_localtime_rtc_offset = 0;
 
+// The host time the current throttle slice is meant to start at, for matching emulated events
+// to host timestamps. Only valid while the frame limiter runs.
+static bool s_throttle_slice_valid = false;
+static u64 s_throttle_slice_host_us = 0;
+static u64 s_throttle_slice_ticks = 0;
+static u32 s_throttle_slice_length = 1;
+
+// With the precise frame limiter, the last part of a wait is spun instead of slept, sleeping
+// overshoots by up to a scheduler tick.
+constexpr s64 THROTTLE_SPIN_US = 2000;
+static std::atomic<u32> s_throttle_waits{0};
+static std::atomic<s64> s_throttle_error_sum{0};
+static std::atomic<s64> s_throttle_error_max{0};
+
 u32 GetTicksPerSecond()
 {
   return s_cpu_core_clock;
@@ -195,32 +212,81 @@ static void PatchEngineCallback(u64 userdata, s64 cycles_late)
   CoreTiming::ScheduleEvent(next_schedule, et_PatchEngine, cycles_pruned);
 }
 
-static void ThrottleCallback(u64 last_time, s64 cyclesLate)
+// Returns the time the wait ended at.
+static u64 WaitUntil(u64 deadline_us, bool precise)
+{
+  const s64 sleep_us = s64(deadline_us - Common::Timer::GetTimeUs()) -
+                       (precise ? THROTTLE_SPIN_US : 0);
+  if (sleep_us > 0)
+    std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+
+  u64 time_us = Common::Timer::GetTimeUs();
+  while (precise && time_us < deadline_us)
+  {
+    Common::YieldCPU();
+    time_us = Common::Timer::GetTimeUs();
+  }
+  return time_us;
+}
+
+// The event's userdata is the host time in microseconds the slice is meant to start at.
+static void ThrottleCallback(u64 deadline_us, s64 cyclesLate)
 {
   // Allow the GPU thread to sleep. Setting this flag here limits the wakeups to 1 kHz.
   Fifo::GpuMaySleep();
 
-  u32 time = Common::Timer::GetTimeMs();
+  const u64 time_us = Common::Timer::GetTimeUs();
 
-  int diff = (u32)last_time - time;
+  const s64 diff = s64(deadline_us - time_us);
   const SConfig& config = SConfig::GetInstance();
-  bool frame_limiter = config.m_EmulationSpeed > 0.0f && !Core::GetIsThrottlerTempDisabled();
+  bool frame_limiter = config.m_EmulationSpeed > 0.0f && !Core::GetIsThrottlerTempDisabled() &&
+                       !Core::IsOutputSuppressed();
   u32 next_event = GetTicksPerSecond() / 1000;
   if (frame_limiter)
   {
     if (config.m_EmulationSpeed != 1.0f)
       next_event = u32(next_event * config.m_EmulationSpeed);
-    const int max_fallback = config.iTimingVariance;
-    if (abs(diff) > max_fallback)
+    const s64 max_fallback = s64(config.iTimingVariance) * 1000;
+    if (std::abs(diff) > max_fallback)
     {
       DEBUG_LOG(COMMON, "system too %s, %d ms skipped", diff < 0 ? "slow" : "fast",
-                abs(diff) - max_fallback);
-      last_time = time - max_fallback;
+                int((std::abs(diff) - max_fallback) / 1000));
+      deadline_us = time_us - max_fallback;
     }
     else if (diff > 0)
-      Common::SleepCurrentThread(diff);
+    {
+      const s64 error = s64(WaitUntil(deadline_us, config.m_precise_frame_limiter) - deadline_us);
+      s_throttle_waits++;
+      s_throttle_error_sum += error;
+      s64 max = s_throttle_error_max.load();
+      while (error > max && !s_throttle_error_max.compare_exchange_weak(max, error))
+      {
+      }
+    }
   }
-  CoreTiming::ScheduleEvent(next_event - cyclesLate, et_Throttle, last_time + 1);
+  s_throttle_slice_valid = frame_limiter;
+  s_throttle_slice_host_us = deadline_us;
+  s_throttle_slice_ticks = CoreTiming::GetTicks() - cyclesLate;
+  s_throttle_slice_length = next_event;
+  CoreTiming::ScheduleEvent(next_event - cyclesLate, et_Throttle, deadline_us + 1000);
+}
+
+ThrottleStats GetThrottleStats()
+{
+  ThrottleStats stats;
+  stats.waits = s_throttle_waits.exchange(0);
+  const s64 error_sum = s_throttle_error_sum.exchange(0);
+  stats.average_error_us = stats.waits ? error_sum / stats.waits : 0;
+  stats.max_error_us = s_throttle_error_max.exchange(0);
+  return stats;
+}
+
+u64 GetHostTimeUsAtTicks(u64 ticks)
+{
+  if (!s_throttle_slice_valid)
+    return 0;
+  const s64 ticks_into_slice = s64(ticks - s_throttle_slice_ticks);
+  return s_throttle_slice_host_us + ticks_into_slice * 1000 / s_throttle_slice_length;
 }
 
 // split from Init to break a circular dependency between VideoInterface::Init and
@@ -282,7 +348,7 @@ void Init()
   CoreTiming::ScheduleEvent(VideoInterface::GetTicksPerHalfLine(), et_VI);
   CoreTiming::ScheduleEvent(0, et_DSP);
   CoreTiming::ScheduleEvent(s_audio_dma_period, et_AudioDMA);
-  CoreTiming::ScheduleEvent(0, et_Throttle, Common::Timer::GetTimeMs());
+  CoreTiming::ScheduleEvent(0, et_Throttle, Common::Timer::GetTimeUs());
 
   CoreTiming::ScheduleEvent(VideoInterface::GetTicksPerField(), et_PatchEngine);
 
@@ -294,6 +360,7 @@ void Shutdown()
 {
   Common::Timer::RestoreResolution();
   s_localtime_rtc_offset = 0;
+  s_throttle_slice_valid = false;
 }
 
 }  // namespace
@@ -53,4 +53,18 @@ void TimeBaseSet();
 u64 GetFakeTimeBase();
 // Custom RTC
 s64 GetLocalTimeRTCOffset();
+
+// Host time (in Common::Timer::GetTimeUs() terms) that the given tick is emulated for,
+// or 0 if emulation isn't tied to host time because the frame limiter is off.
+u64 GetHostTimeUsAtTicks(u64 ticks);
+
+// How far the frame limiter's waits ended from their deadlines, positive when late.
+struct ThrottleStats
+{
+  u32 waits;
+  s64 average_error_us;
+  s64 max_error_us;
+};
+// Returns the stats since the last call.
+ThrottleStats GetThrottleStats();
 }
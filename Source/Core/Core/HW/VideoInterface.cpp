@@ -23,9 +23,13 @@
 #include "Core/HW/ProcessorInterface.h"
 #include "Core/HW/SI/SI.h"
 #include "Core/HW/SystemTimers.h"
+#include "Core/Movie.h"
+#include "Core/NetPlayProto.h"
+#include "Core/State.h"
 
 #include "DiscIO/Enums.h"
 
+#include "VideoCommon/Fifo.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -662,6 +666,9 @@ static void LogField(FieldType field, u32 xfb_address)
 
 static void BeginField(FieldType field, u64 ticks)
 {
+  // Gather pipe data the GPU thread wasn't woken for yet is due now.
+  Fifo::RunBatchedGpuWakeup();
+
   // Could we fit a second line of data in the stride?
   bool potentially_interlaced_xfb =
       ((m_PictureConfiguration.STD / m_PictureConfiguration.WPL) == 2);
@@ -713,13 +720,22 @@ static void BeginField(FieldType field, u64 ticks)
   // frame is scanning out.
   // To correctly handle that case we would need to collate all changes
   // to VI during scanout and delay outputting the frame till then.
-  if (xfbAddr)
+  if (xfbAddr && !Core::IsOutputSuppressed())
     g_video_backend->Video_BeginField(xfbAddr, fbWidth, fbStride, fbHeight, ticks);
+  else if (xfbAddr && g_ActiveConfig.bUseXFB)
+    Movie::FrameUpdate();  // hidden fields still count as movie frames
 }
 
 static void EndField()
 {
-  Core::VideoThrottle();
+  // Fields emulated without output don't count towards the speed.
+  if (!Core::IsOutputSuppressed())
+    Core::VideoThrottle();
+  Core::OutputIntervalFieldUpdate();
+  State::RewindFieldUpdate();
+  NetPlay::FieldUpdate();
+  Core::RunAheadFieldUpdate();
+  Movie::FieldUpdate();
 }
 
 // Purpose: Send VI interrupt when triggered
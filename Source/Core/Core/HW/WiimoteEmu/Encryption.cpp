@@ -272,12 +272,12 @@ void WiimoteGenerateKey(wiimote_key* const key, const u8* const keydata)
 void WiimoteEncrypt(const wiimote_key* const key, u8* const data, int addr, const u8 len)
 {
   for (int i = 0; i < len; ++i, ++addr)
-    data[i] = (data[i] - key->ft[addr % 8]) ^ key->sb[addr % 8];
+    data[i] = (data[i] - key->ft[addr & 7]) ^ key->sb[addr & 7];
 }
 
 /* Decrypt data */
 void WiimoteDecrypt(const wiimote_key* const key, u8* const data, int addr, const u8 len)
 {
   for (int i = 0; i < len; ++i, ++addr)
-    data[i] = (data[i] ^ key->sb[addr % 8]) + key->ft[addr % 8];
+    data[i] = (data[i] ^ key->sb[addr & 7]) + key->ft[addr & 7];
 }
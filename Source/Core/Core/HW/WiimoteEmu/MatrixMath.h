@@ -119,6 +119,19 @@ inline void MatrixMultiply(Matrix& r, const Matrix& a, const Matrix& b)
         r[i][j] += a[i][k] * b[k][j];
 }
 
+// Same as transforming the points by MatrixRotationByZ, without building the matrix. The
+// coordinates are in separate arrays so the loop vectorizes.
+inline void RotatePointsByZ(double* x, double* y, int count, double sin, double cos)
+{
+  for (int i = 0; i < count; i++)
+  {
+    const double ox = x[i];
+    const double oy = y[i];
+    x[i] = cos * ox - sin * oy;
+    y[i] = sin * ox + cos * oy;
+  }
+}
+
 inline void MatrixTransformVertex(Matrix const& m, Vertex& v)
 {
   Vertex ov;
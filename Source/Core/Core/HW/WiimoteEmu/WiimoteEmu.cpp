@@ -508,10 +508,50 @@ inline void LowPassFilter(double& var, double newval, double period)
   var = newval * alpha + var * (1.0 - alpha);
 }
 
+void Wiimote::ProjectIRPoints(ControlState xx, ControlState yy, ControlState zz, u16* x,
+                              u16* y) const
+{
+  static const int camWidth = 1024;
+  static const int camHeight = 768;
+  static const double bndup = -0.315447;
+  static const double bnddown = 0.85;
+  static const double bndleft = 0.443364;
+  static const double bndright = -0.443364;
+  static const double dist1 = 100.0 / camWidth;  // this seems the optimal distance for zelda
+  static const double dist2 = 1.2 * dist1;
+
+  double vx[4], vy[4];
+  for (int i = 0; i < 4; i++)
+  {
+    vx[i] = xx * (bndright - bndleft) / 2 + (bndleft + bndright) / 2;
+    if (m_sensor_bar_on_top)
+      vy[i] = yy * (bndup - bnddown) / 2 + (bndup + bnddown) / 2;
+    else
+      vy[i] = yy * (bndup - bnddown) / 2 - (bndup + bnddown) / 2;
+  }
+
+  vx[0] -= (zz * 0.5 + 1) * dist1;
+  vx[1] += (zz * 0.5 + 1) * dist1;
+  vx[2] -= (zz * 0.5 + 1) * dist2;
+  vx[3] += (zz * 0.5 + 1) * dist2;
+
+  // The camera transform is a rotation by the roll, the aspect scale is 1.
+  RotatePointsByZ(vx, vy, 4, ir_sin, ir_cos);
+
+  for (int i = 0; i < 4; i++)
+  {
+    if ((vx[i] < -1) || (vx[i] > 1) || (vy[i] < -1) || (vy[i] > 1))
+      continue;
+    x[i] = (u16)lround((vx[i] + 1) / 2 * (camWidth - 1));
+    y[i] = (u16)lround((vy[i] + 1) / 2 * (camHeight - 1));
+  }
+}
+
 void Wiimote::GetIRData(u8* const data, bool use_accel)
 {
   u16 x[4], y[4];
   memset(x, 0xFF, sizeof(x));
+  memset(y, 0xFF, sizeof(y));
 
   ControlState xx = 10000, yy = 0, zz = 0;
   double nsin, ncos;
@@ -547,50 +587,28 @@ void Wiimote::GetIRData(u8* const data, bool use_accel)
 
   m_ir->GetState(&xx, &yy, &zz, true);
 
-  Vertex v[4];
-
-  static const int camWidth = 1024;
-  static const int camHeight = 768;
-  static const double bndup = -0.315447;
-  static const double bnddown = 0.85;
-  static const double bndleft = 0.443364;
-  static const double bndright = -0.443364;
-  static const double dist1 = 100.0 / camWidth;  // this seems the optimal distance for zelda
-  static const double dist2 = 1.2 * dist1;
-
-  for (auto& vtx : v)
+  IRProjection& projection = m_ir_projection;
+  if (!projection.valid || projection.sin != ir_sin || projection.cos != ir_cos ||
+      projection.x != xx || projection.y != yy || projection.z != zz ||
+      projection.sensor_bar_on_top != m_sensor_bar_on_top)
   {
-    vtx.x = xx * (bndright - bndleft) / 2 + (bndleft + bndright) / 2;
-    if (m_sensor_bar_on_top)
-      vtx.y = yy * (bndup - bnddown) / 2 + (bndup + bnddown) / 2;
-    else
-      vtx.y = yy * (bndup - bnddown) / 2 - (bndup + bnddown) / 2;
-    vtx.z = 0;
+    ProjectIRPoints(xx, yy, zz, x, y);
+    projection.valid = true;
+    projection.sensor_bar_on_top = m_sensor_bar_on_top;
+    projection.sin = ir_sin;
+    projection.cos = ir_cos;
+    projection.x = xx;
+    projection.y = yy;
+    projection.z = zz;
+    std::copy(x, x + 4, projection.points_x);
+    std::copy(y, y + 4, projection.points_y);
   }
-
-  v[0].x -= (zz * 0.5 + 1) * dist1;
-  v[1].x += (zz * 0.5 + 1) * dist1;
-  v[2].x -= (zz * 0.5 + 1) * dist2;
-  v[3].x += (zz * 0.5 + 1) * dist2;
-
-#define printmatrix(m)                                                                             \
-  PanicAlert("%f %f %f %f\n%f %f %f %f\n%f %f %f %f\n%f %f %f %f\n", m[0][0], m[0][1], m[0][2],    \
-             m[0][3], m[1][0], m[1][1], m[1][2], m[1][3], m[2][0], m[2][1], m[2][2], m[2][3],      \
-             m[3][0], m[3][1], m[3][2], m[3][3])
-  Matrix rot, tot;
-  static Matrix scale;
-  MatrixScale(scale, 1, camWidth / camHeight, 1);
-  MatrixRotationByZ(rot, ir_sin, ir_cos);
-  MatrixMultiply(tot, scale, rot);
-
-  for (int i = 0; i < 4; i++)
+  else
   {
-    MatrixTransformVertex(tot, v[i]);
-    if ((v[i].x < -1) || (v[i].x > 1) || (v[i].y < -1) || (v[i].y > 1))
-      continue;
-    x[i] = (u16)lround((v[i].x + 1) / 2 * (camWidth - 1));
-    y[i] = (u16)lround((v[i].y + 1) / 2 * (camHeight - 1));
+    std::copy(projection.points_x, projection.points_x + 4, x);
+    std::copy(projection.points_y, projection.points_y + 4, y);
   }
+
   // Fill report with valid data when full handshake was done
   if (m_reg_ir.data[0x30])
     // ir mode
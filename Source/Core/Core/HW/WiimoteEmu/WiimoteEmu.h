@@ -221,6 +221,7 @@ protected:
   void GetButtonData(u8* const data);
   void GetAccelData(u8* const data, const ReportFeatures& rptf);
   void GetIRData(u8* const data, bool use_accel);
+  void ProjectIRPoints(ControlState xx, ControlState yy, ControlState zz, u16* x, u16* y) const;
   void GetExtData(u8* const data);
 
   bool HaveExtension() const;
@@ -267,6 +268,17 @@ private:
 
   double ir_sin, ir_cos;  // for the low pass filter
 
+  // Camera points of the last IR report and the state they were projected from, the projection
+  // is skipped while the pointer doesn't move.
+  struct IRProjection
+  {
+    bool valid;
+    bool sensor_bar_on_top;
+    double sin, cos;
+    ControlState x, y, z;
+    u16 points_x[4], points_y[4];
+  } m_ir_projection = {};
+
   bool m_rumble_on;
   bool m_speaker_mute;
 
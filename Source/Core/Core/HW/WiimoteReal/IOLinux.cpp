@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <bluetooth/bluetooth.h>
 #include <bluetooth/hci.h>
 #include <bluetooth/hci_lib.h>
@@ -222,14 +223,15 @@ void WiimoteLinux::IOWakeup()
 // zero = error
 int WiimoteLinux::IORead(u8* buf)
 {
-  // Block select for 1/2000th of a second
+  // Block until a report arrives or IOWakeup is called
 
   fd_set fds;
   FD_ZERO(&fds);
   FD_SET(m_int_sock, &fds);
   FD_SET(m_wakeup_pipe_r, &fds);
 
-  if (select(m_int_sock + 1, &fds, nullptr, nullptr, nullptr) == -1)
+  // Either descriptor can have the higher number, e.g. after reconnecting.
+  if (select(std::max(m_int_sock, m_wakeup_pipe_r) + 1, &fds, nullptr, nullptr, nullptr) == -1)
   {
     ERROR_LOG(WIIMOTE, "Unable to select Wiimote %i input socket.", m_index + 1);
     return -1;
@@ -116,7 +116,10 @@ bool WiimoteHidapi::IsConnected() const
 
 int WiimoteHidapi::IORead(u8* buf)
 {
-  int timeout = 200;  // ms
+  // hidapi has no way to interrupt a read, so IOWakeup can't cut this short and output reports
+  // wait for the read to time out. Keep it short; a Wii Remote that reports continuously sends
+  // data more often than this anyway.
+  int timeout = 10;  // ms
   int result = hid_read_timeout(m_handle, buf + 1, MAX_PAYLOAD - 1, timeout);
   // TODO: If and once we use hidapi across plaforms, change our internal API to clean up this mess.
   if (result == -1)
@@ -32,6 +32,8 @@ const std::string hotkey_labels[] = {
     _trans("Toggle OSD chat"),
     _trans("Send OSD chat message"),
     _trans("Take Screenshot"),
+    _trans("Export Frame Telemetry"),
+    _trans("Toggle Trace Capture"),
     _trans("Exit"),
 
     _trans("Volume Down"),
@@ -153,6 +155,7 @@ const std::string hotkey_labels[] = {
     _trans("Save Oldest State"),
     _trans("Undo Load State"),
     _trans("Undo Save State"),
+    _trans("Rewind"),
     _trans("Save State"),
     _trans("Load State"),
     _trans("Reload Post-Processing Shaders"),
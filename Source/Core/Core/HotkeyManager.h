@@ -30,6 +30,8 @@ enum Hotkey
   HK_SHOW_OSD_CHAT,
   HK_SEND_CHAT_MSG,
   HK_SCREENSHOT,
+  HK_EXPORT_FRAME_TELEMETRY,
+  HK_TOGGLE_TRACE_CAPTURE,
   HK_EXIT,
 
   HK_VOLUME_DOWN,
@@ -151,6 +153,7 @@ enum Hotkey
   HK_SAVE_FIRST_STATE,
   HK_UNDO_LOAD_STATE,
   HK_UNDO_SAVE_STATE,
+  HK_REWIND,
   HK_SAVE_STATE_FILE,
   HK_LOAD_STATE_FILE,
   HK_RELOAD_POSTPROCESS_SHADERS,
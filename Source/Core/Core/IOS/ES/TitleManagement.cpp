@@ -5,6 +5,7 @@
 #include "Core/IOS/ES/ES.h"
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cstddef>
 #include <utility>
@@ -332,12 +333,7 @@ IPCCommandResult ES::ImportContentData(Context& context, const IOCtlVRequest& re
       ImportContentData(context, content_fd, data_start, request.in_vectors[1].size));
 }
 
-static bool CheckIfContentHashMatches(const std::vector<u8>& content, const IOS::ES::Content& info)
-{
-  std::array<u8, 20> sha1;
-  mbedtls_sha1(content.data(), info.size, sha1.data());
-  return sha1 == info.sha1;
-}
+constexpr size_t IMPORT_CONTENT_CHUNK_SIZE = 0x10000;
 
 static std::string GetImportContentPath(u64 title_id, u32 content_id)
 {
@@ -351,23 +347,67 @@ ReturnCode ES::ImportContentEnd(Context& context, u32 content_fd)
   if (!context.title_import_export.valid || !context.title_import_export.content.valid)
     return ES_EINVAL;
 
-  std::vector<u8> decrypted_data(context.title_import_export.content.buffer.size());
-  const ReturnCode decrypt_ret = m_ios.GetIOSC().Decrypt(
-      context.title_import_export.key_handle, context.title_import_export.content.iv.data(),
-      context.title_import_export.content.buffer.data(),
-      context.title_import_export.content.buffer.size(), decrypted_data.data(), PID_ES);
-  if (decrypt_ret != IPC_SUCCESS)
-    return decrypt_ret;
-
   IOS::ES::Content content_info;
   context.title_import_export.tmd.FindContentById(context.title_import_export.content.id,
                                                   &content_info);
-  if (!CheckIfContentHashMatches(decrypted_data, content_info))
+  const std::vector<u8>& encrypted_data = context.title_import_export.content.buffer;
+  if (encrypted_data.size() < content_info.size)
   {
     ERROR_LOG(IOS_ES, "ImportContentEnd: Hash for content %08x doesn't match", content_info.id);
     return ES_HASH_MISMATCH;
   }
 
+  const std::string temp_path =
+      Common::RootUserPath(Common::FROM_SESSION_ROOT) +
+      StringFromFormat("/tmp/%08x.app", context.title_import_export.content.id);
+  File::CreateFullPath(temp_path);
+
+  // The content is decrypted, hashed and written in one pass over small chunks instead of a pass
+  // over the whole content for each step.
+  const ReturnCode write_ret = [&] {
+    File::IOFile file(temp_path, "wb");
+    std::vector<u8> chunk(std::min(IMPORT_CONTENT_CHUNK_SIZE, encrypted_data.size()));
+    std::array<u8, 16> iv = context.title_import_export.content.iv;
+    mbedtls_sha1_context sha1_context;
+    mbedtls_sha1_init(&sha1_context);
+    mbedtls_sha1_starts(&sha1_context);
+
+    u64 remaining = content_info.size;
+    for (size_t offset = 0; remaining > 0; offset += chunk.size())
+    {
+      const size_t size = std::min(chunk.size(), encrypted_data.size() - offset);
+      const ReturnCode decrypt_ret =
+          m_ios.GetIOSC().Decrypt(context.title_import_export.key_handle, iv.data(),
+                                  &encrypted_data[offset], size, chunk.data(), PID_ES);
+      if (decrypt_ret != IPC_SUCCESS)
+        return decrypt_ret;
+
+      const size_t content_bytes = static_cast<size_t>(std::min<u64>(size, remaining));
+      mbedtls_sha1_update(&sha1_context, chunk.data(), content_bytes);
+      if (!file.WriteBytes(chunk.data(), content_bytes))
+      {
+        ERROR_LOG(IOS_ES, "ImportContentEnd: Failed to write to %s", temp_path.c_str());
+        return ES_EIO;
+      }
+      remaining -= content_bytes;
+    }
+
+    std::array<u8, 20> sha1;
+    mbedtls_sha1_finish(&sha1_context, sha1.data());
+    mbedtls_sha1_free(&sha1_context);
+    if (sha1 != content_info.sha1)
+    {
+      ERROR_LOG(IOS_ES, "ImportContentEnd: Hash for content %08x doesn't match", content_info.id);
+      return ES_HASH_MISMATCH;
+    }
+    return IPC_SUCCESS;
+  }();
+  if (write_ret != IPC_SUCCESS)
+  {
+    File::Delete(temp_path);
+    return write_ret;
+  }
+
   std::string content_path;
   if (content_info.IsShared())
   {
@@ -381,20 +421,6 @@ ReturnCode ES::ImportContentEnd(Context& context, u32 content_fd)
   }
   File::CreateFullPath(content_path);
 
-  const std::string temp_path =
-      Common::RootUserPath(Common::FROM_SESSION_ROOT) +
-      StringFromFormat("/tmp/%08x.app", context.title_import_export.content.id);
-  File::CreateFullPath(temp_path);
-
-  {
-    File::IOFile file(temp_path, "wb");
-    if (!file.WriteBytes(decrypted_data.data(), content_info.size))
-    {
-      ERROR_LOG(IOS_ES, "ImportContentEnd: Failed to write to %s", temp_path.c_str());
-      return ES_EIO;
-    }
-  }
-
   if (!File::Rename(temp_path, content_path))
   {
     ERROR_LOG(IOS_ES, "ImportContentEnd: Failed to move content to %s", content_path.c_str());
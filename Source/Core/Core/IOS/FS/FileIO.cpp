@@ -4,7 +4,9 @@
 
 #include "Core/IOS/FS/FileIO.h"
 
+#include <algorithm>
 #include <cinttypes>
+#include <cstdint>
 #include <cstdio>
 #include <map>
 #include <memory>
@@ -24,7 +26,43 @@ namespace IOS
 {
 namespace HLE
 {
-static std::map<std::string, std::weak_ptr<File::IOFile>> openFiles;
+// A host file shared by every handle that opened the same NAND path.
+struct OpenedFile
+{
+  explicit OpenedFile(const std::string& path) : file(path, "r+b")
+  {
+    if (file)
+      size = static_cast<u32>(file.GetSize());
+  }
+
+  // Seeks the host file to offset unless the access continues where the last one stopped. Skipping
+  // the seek keeps stdio buffering consecutive writes until the file is closed, instead of
+  // flushing them on every request. Switching between reading and writing always seeks, which C
+  // requires on the same stream.
+  bool PrepareAccess(u32 offset, bool write)
+  {
+    if (position == offset && writing == write)
+      return true;
+    if (!file.Seek(offset, SEEK_SET))
+    {
+      position = INVALID_POSITION;
+      return false;
+    }
+    position = offset;
+    writing = write;
+    return true;
+  }
+
+  static constexpr u64 INVALID_POSITION = UINT64_MAX;
+
+  File::IOFile file;
+  // Kept up to date by the writes, so seeks and stats don't query the host.
+  u32 size = 0;
+  u64 position = 0;
+  bool writing = false;
+};
+
+static std::map<std::string, std::weak_ptr<OpenedFile>> openFiles;
 
 // This is used by several of the FileIO and /dev/fs functions
 std::string BuildFilename(const std::string& wii_path)
@@ -102,7 +140,10 @@ IPCCommandResult FileIO::Open(const OpenRequest& request)
 
   // The file must exist before we can open it
   // It should be created by ISFS_CreateFile, not here
-  if (!File::IsFile(m_filepath))
+  // Files that another handle holds open are known to exist.
+  const auto open_file = openFiles.find(m_name);
+  const bool already_open = open_file != openFiles.end() && !open_file->second.expired();
+  if (!already_open && !File::IsFile(m_filepath))
   {
     WARN_LOG(IOS_FILEIO, "FileIO: Open (%s) failed - File doesn't exist %s", Modes[m_Mode],
              m_filepath.c_str());
@@ -145,27 +186,27 @@ void FileIO::OpenFile()
   {
     std::string path = m_name;
     // This code will be called when all references to the shared pointer below have been removed.
-    auto deleter = [path](File::IOFile* ptr) {
-      delete ptr;             // IOFile's deconstructor closes the file.
+    auto deleter = [path](OpenedFile* ptr) {
+      delete ptr;             // IOFile's deconstructor flushes and closes the file.
       openFiles.erase(path);  // erase the weak pointer from the list of open files.
     };
 
     // All files are opened read/write. Actual access rights will be controlled per handle by the
     // read/write functions below
-    m_file = std::shared_ptr<File::IOFile>(new File::IOFile(m_filepath, "r+b"),
-                                           deleter);  // Use the custom deleter from above.
+    m_file = std::shared_ptr<OpenedFile>(new OpenedFile(m_filepath),
+                                         deleter);  // Use the custom deleter from above.
 
     // Store a weak pointer to our newly opened file in the cache.
-    openFiles[path] = std::weak_ptr<File::IOFile>(m_file);
+    openFiles[path] = std::weak_ptr<OpenedFile>(m_file);
   }
 }
 
 IPCCommandResult FileIO::Seek(const SeekRequest& request)
 {
-  if (!m_file->IsOpen())
+  if (!m_file->file.IsOpen())
     return GetDefaultReply(FS_ENOENT);
 
-  const u32 file_size = static_cast<u32>(m_file->GetSize());
+  const u32 file_size = m_file->size;
   DEBUG_LOG(IOS_FILEIO, "FileIO: Seek Pos: 0x%08x, Mode: %i (%s, Length=0x%08x)", request.offset,
             request.mode, m_name.c_str(), file_size);
 
@@ -197,7 +238,7 @@ IPCCommandResult FileIO::Seek(const SeekRequest& request)
 
 IPCCommandResult FileIO::Read(const ReadWriteRequest& request)
 {
-  if (!m_file->IsOpen())
+  if (!m_file->file.IsOpen())
   {
     ERROR_LOG(IOS_FILEIO, "Failed to read from %s (Addr=0x%08x Size=0x%x) - file could "
                           "not be opened or does not exist",
@@ -213,19 +254,25 @@ IPCCommandResult FileIO::Read(const ReadWriteRequest& request)
   }
 
   u32 requested_read_length = request.size;
-  const u32 file_size = static_cast<u32>(m_file->GetSize());
+  const u32 file_size = m_file->size;
   // IOS has this check in the read request handler.
   if (requested_read_length + m_SeekPos > file_size)
     requested_read_length = file_size - m_SeekPos;
 
   DEBUG_LOG(IOS_FILEIO, "Read 0x%x bytes to 0x%08x from %s", request.size, request.buffer,
             m_name.c_str());
-  m_file->Seek(m_SeekPos, SEEK_SET);  // File might be opened twice, need to seek before we read
-  const u32 number_of_bytes_read = static_cast<u32>(
-      fread(Memory::GetPointer(request.buffer), 1, requested_read_length, m_file->GetHandle()));
+  // File might be opened twice, need to seek before we read
+  if (!m_file->PrepareAccess(m_SeekPos, false))
+    return GetDefaultReply(FS_EACCESS);
+  const u32 number_of_bytes_read = static_cast<u32>(fread(
+      Memory::GetPointer(request.buffer), 1, requested_read_length, m_file->file.GetHandle()));
 
-  if (number_of_bytes_read != requested_read_length && ferror(m_file->GetHandle()))
+  if (number_of_bytes_read != requested_read_length && ferror(m_file->file.GetHandle()))
+  {
+    m_file->position = OpenedFile::INVALID_POSITION;
     return GetDefaultReply(FS_EACCESS);
+  }
+  m_file->position += number_of_bytes_read;
 
   // IOS returns the number of bytes read and adds that value to the seek position,
   // instead of adding the *requested* read length.
@@ -236,7 +283,7 @@ IPCCommandResult FileIO::Read(const ReadWriteRequest& request)
 IPCCommandResult FileIO::Write(const ReadWriteRequest& request)
 {
   s32 return_value = FS_EACCESS;
-  if (m_file->IsOpen())
+  if (m_file->file.IsOpen())
   {
     if (m_Mode == IOS_OPEN_READ)
     {
@@ -248,12 +295,18 @@ IPCCommandResult FileIO::Write(const ReadWriteRequest& request)
     {
       DEBUG_LOG(IOS_FILEIO, "FileIO: Write 0x%04x bytes from 0x%08x to %s", request.size,
                 request.buffer, m_name.c_str());
-      m_file->Seek(m_SeekPos,
-                   SEEK_SET);  // File might be opened twice, need to seek before we write
-      if (m_file->WriteBytes(Memory::GetPointer(request.buffer), request.size))
+      // File might be opened twice, need to seek before we write
+      if (m_file->PrepareAccess(m_SeekPos, true) &&
+          m_file->file.WriteBytes(Memory::GetPointer(request.buffer), request.size))
       {
         return_value = request.size;
         m_SeekPos += request.size;
+        m_file->position = m_SeekPos;
+        m_file->size = std::max(m_file->size, m_SeekPos);
+      }
+      else
+      {
+        m_file->position = OpenedFile::INVALID_POSITION;
       }
     }
   }
@@ -308,12 +361,11 @@ void FileIO::DoState(PointerWrap& p)
 
 IPCCommandResult FileIO::GetFileStats(const IOCtlRequest& request)
 {
-  if (!m_file->IsOpen())
+  if (!m_file->file.IsOpen())
     return GetDefaultReply(FS_ENOENT);
 
-  DEBUG_LOG(IOS_FILEIO, "File: %s, Length: %" PRIu64 ", Pos: %u", m_name.c_str(), m_file->GetSize(),
-            m_SeekPos);
-  Memory::Write_U32(static_cast<u32>(m_file->GetSize()), request.buffer_out);
+  DEBUG_LOG(IOS_FILEIO, "File: %s, Length: %u, Pos: %u", m_name.c_str(), m_file->size, m_SeekPos);
+  Memory::Write_U32(m_file->size, request.buffer_out);
   Memory::Write_U32(m_SeekPos, request.buffer_out + 4);
   return GetDefaultReply(IPC_SUCCESS);
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "Common/ChunkFile.h"
@@ -13,11 +14,6 @@
 
 class PointerWrap;
 
-namespace File
-{
-class IOFile;
-}
-
 namespace IOS
 {
 namespace HLE
@@ -25,6 +21,8 @@ namespace HLE
 std::string BuildFilename(const std::string& wii_path);
 void CreateVirtualFATFilesystem();
 
+struct OpenedFile;
+
 namespace Device
 {
 class FileIO : public Device
@@ -76,7 +74,7 @@ private:
   u32 m_SeekPos = 0;
 
   std::string m_filepath;
-  std::shared_ptr<File::IOFile> m_file;
+  std::shared_ptr<OpenedFile> m_file;
 };
 }  // namespace Device
 }  // namespace HLE
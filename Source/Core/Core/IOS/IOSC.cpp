@@ -271,6 +271,19 @@ ReturnCode IOSC::DecryptEncrypt(Common::AES::Mode mode, Handle key_handle, u8* i
   if (entry->data.size() != AES128_KEY_SIZE)
     return IOSC_FAIL_INTERNAL;
 
+  if (mode == Common::AES::Mode::Decrypt && size % 16 == 0)
+  {
+    // Straight into the output, with AES-NI where available. The IV for the next call is the last
+    // ciphertext block, which is gone once the data is decrypted in place.
+    mbedtls_aes_context aes_ctx;
+    mbedtls_aes_setkey_dec(&aes_ctx, entry->data.data(), 128);
+    std::array<u8, 16> next_iv;
+    std::memcpy(next_iv.data(), size ? input + size - 16 : iv, next_iv.size());
+    Common::AES::DecryptCBC(&aes_ctx, iv, input, output, size);
+    std::memcpy(iv, next_iv.data(), next_iv.size());
+    return IPC_SUCCESS;
+  }
+
   const std::vector<u8> data =
       Common::AES::DecryptEncrypt(entry->data.data(), iv, input, size, mode);
 
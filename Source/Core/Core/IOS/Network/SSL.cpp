@@ -54,6 +54,7 @@ NetSSL::~NetSSL()
   {
     if (ssl.active)
     {
+      ssl.handshake = {};
       mbedtls_ssl_close_notify(&ssl.ctx);
 
       mbedtls_x509_crt_free(&ssl.cacert);
@@ -254,6 +255,8 @@ IPCCommandResult NetSSL::IOCtlV(const IOCtlVRequest& request)
     {
       WII_SSL* ssl = &_SSL[sslID];
 
+      // Waits for a handshake step that is still running and drops its result
+      ssl->handshake = {};
       mbedtls_ssl_close_notify(&ssl->ctx);
 
       mbedtls_x509_crt_free(&ssl->cacert);
@@ -14,6 +14,7 @@
 #include <mbedtls/platform.h>
 #include <mbedtls/ssl.h>
 #include <mbedtls/x509_crt.h>
+#include <future>
 #include <string>
 
 // clang-format on
@@ -84,6 +85,8 @@ struct WII_SSL
   int hostfd;
   std::string hostname;
   bool active;
+  // A handshake step running on another thread, see WiiSocket::Update
+  std::future<int> handshake;
 };
 
 namespace Device
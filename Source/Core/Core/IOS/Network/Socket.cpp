@@ -6,14 +6,13 @@
 #include "Core/IOS/Network/Socket.h"
 
 #include <algorithm>
+#include <chrono>
+#include <future>
 #include <mbedtls/error.h>
 #ifndef _WIN32
 #include <arpa/inet.h>
 #include <unistd.h>
 #endif
-#ifdef __HAIKU__
-#include <sys/select.h>
-#endif
 
 #include "Common/File.h"
 #include "Common/FileUtil.h"
@@ -203,13 +202,14 @@ s32 WiiSocket::FCntl(u32 cmd, u32 arg)
   return ret;
 }
 
-void WiiSocket::Update(bool read, bool write, bool except)
+void WiiSocket::Update()
 {
   auto it = pending_sockops.begin();
   while (it != pending_sockops.end())
   {
     s32 ReturnValue = 0;
     bool forceNonBlock = false;
+    bool in_progress = false;
     IPCCommandType ct = it->request.command;
     if (!it->is_ssl && ct == IPC_CMD_IOCTL)
     {
@@ -327,8 +327,21 @@ void WiiSocket::Update(bool read, bool write, bool except)
           {
           case IOCTLV_NET_SSL_DOHANDSHAKE:
           {
-            mbedtls_ssl_context* ctx = &Device::NetSSL::_SSL[sslID].ctx;
-            int ret = mbedtls_ssl_handshake(ctx);
+            // The key exchange can take long enough to make emulation stutter, so the handshake
+            // runs on another thread and the request is only replied to once it is done.
+            WII_SSL& ssl = Device::NetSSL::_SSL[sslID];
+            mbedtls_ssl_context* ctx = &ssl.ctx;
+            if (!ssl.handshake.valid())
+            {
+              ssl.handshake =
+                  std::async(std::launch::async, [ctx] { return mbedtls_ssl_handshake(ctx); });
+            }
+            if (ssl.handshake.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+              in_progress = true;
+              break;
+            }
+            int ret = ssl.handshake.get();
             if (ret)
             {
               char error_buffer[256] = "";
@@ -554,6 +567,7 @@ void WiiSocket::Update(bool read, bool write, bool except)
           }
 #endif
           socklen_t addrlen = sizeof(sockaddr_in);
+          Memory::PrepareHostWrite(BufferOut, BufferOutSize);
           int ret = recvfrom(fd, data, data_len, flags,
                              BufferOutSize2 ? (struct sockaddr*)&local_name : nullptr,
                              BufferOutSize2 ? &addrlen : nullptr);
@@ -580,6 +594,10 @@ void WiiSocket::Update(bool read, bool write, bool except)
       }
     }
 
+    // Later requests on this socket have to wait for the handshake as well
+    if (in_progress)
+      break;
+
     if (nonBlock || forceNonBlock ||
         (!it->is_ssl && ReturnValue != -SO_EAGAIN && ReturnValue != -SO_EINPROGRESS &&
          ReturnValue != -SO_EALREADY) ||
@@ -681,50 +699,22 @@ s32 WiiSockMan::DeleteSocket(s32 s)
 
 void WiiSockMan::Update()
 {
-  s32 nfds = 0;
-  fd_set read_fds, write_fds, except_fds;
-  struct timeval t = {0, 0};
-  FD_ZERO(&read_fds);
-  FD_ZERO(&write_fds);
-  FD_ZERO(&except_fds);
-
+  // The host sockets are non-blocking and every pending operation is simply retried, so there
+  // is no need to ask the host which sockets are ready. Sockets without pending operations are
+  // skipped, which makes this a no-op while a game has its sockets open but idle.
   auto socket_iter = WiiSockets.begin();
-  auto end_socks = WiiSockets.end();
-
-  while (socket_iter != end_socks)
+  while (socket_iter != WiiSockets.end())
   {
     WiiSocket& sock = socket_iter->second;
-    if (sock.IsValid())
-    {
-      FD_SET(sock.fd, &read_fds);
-      FD_SET(sock.fd, &write_fds);
-      FD_SET(sock.fd, &except_fds);
-      nfds = std::max(nfds, sock.fd + 1);
-      ++socket_iter;
-    }
-    else
+    if (!sock.IsValid())
     {
       // Good time to clean up invalid sockets.
       socket_iter = WiiSockets.erase(socket_iter);
+      continue;
     }
-  }
-  s32 ret = select(nfds, &read_fds, &write_fds, &except_fds, &t);
-
-  if (ret >= 0)
-  {
-    for (auto& pair : WiiSockets)
-    {
-      WiiSocket& sock = pair.second;
-      sock.Update(FD_ISSET(sock.fd, &read_fds) != 0, FD_ISSET(sock.fd, &write_fds) != 0,
-                  FD_ISSET(sock.fd, &except_fds) != 0);
-    }
-  }
-  else
-  {
-    for (auto& elem : WiiSockets)
-    {
-      elem.second.Update(false, false, false);
-    }
+    if (!sock.pending_sockops.empty())
+      sock.Update();
+    ++socket_iter;
   }
 }
 
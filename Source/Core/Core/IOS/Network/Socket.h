@@ -198,7 +198,7 @@ private:
 
   void DoSock(Request request, NET_IOCTL type);
   void DoSock(Request request, SSL_IOCTL type);
-  void Update(bool read, bool write, bool except);
+  void Update();
   bool IsValid() const { return fd >= 0; }
 public:
   WiiSocket() : fd(-1), nonBlock(false) {}
@@ -25,6 +25,7 @@
 #include "Core/Host.h"
 #include "Core/IOS/Device.h"
 #include "Core/IOS/IOS.h"
+#include "Core/IOS/USB/Bluetooth/l2cap.h"
 #include "InputCommon/ControllerInterface/ControllerInterface.h"
 
 namespace IOS
@@ -183,6 +184,9 @@ IPCCommandResult BluetoothEmu::IOCtlV(const IOCtlVRequest& request)
     {
       m_ACLEndpoint = std::make_unique<USB::V0BulkMessage>(m_ios, request);
       DEBUG_LOG(IOS_WIIMOTE, "ACL_DATA_IN: 0x%08x ", request.address);
+      // The stack asks for the next packet right after getting one, so with several Wii
+      // Remotes the reports queued in the same update are handed out back to back.
+      SendQueuedACLPacket();
       send_reply = false;
       break;
     }
@@ -261,6 +265,41 @@ void BluetoothEmu::SendACLPacket(u16 connection_handle, const u8* data, u32 size
   }
 }
 
+void BluetoothEmu::SendL2capPacket(u16 connection_handle, u16 dcid, const u8* data, u32 size)
+{
+  DEBUG_LOG(IOS_WIIMOTE, "L2CAP packet from %x ready to send to stack...", connection_handle);
+
+  const u32 frame_size = sizeof(l2cap_hdr_t) + size;
+  const bool direct = m_ACLEndpoint && !m_HCIEndpoint && m_EventQueue.empty();
+  u8* frame;
+  if (direct)
+  {
+    hci_acldata_hdr_t* header =
+        reinterpret_cast<hci_acldata_hdr_t*>(Memory::GetPointer(m_ACLEndpoint->data_address));
+    header->con_handle = HCI_MK_CON_HANDLE(connection_handle, HCI_PACKET_START, HCI_POINT2POINT);
+    header->length = frame_size;
+    frame = reinterpret_cast<u8*>(header) + sizeof(hci_acldata_hdr_t);
+  }
+  else
+  {
+    DEBUG_LOG(IOS_WIIMOTE, "ACL endpoint not currently valid, queuing...");
+    frame = m_acl_pool.Allocate(frame_size, connection_handle);
+    if (!frame)
+      return;
+  }
+
+  l2cap_hdr_t* l2cap_header = reinterpret_cast<l2cap_hdr_t*>(frame);
+  l2cap_header->dcid = dcid;
+  l2cap_header->length = size;
+  memcpy(frame + sizeof(l2cap_hdr_t), data, size);
+
+  if (direct)
+  {
+    m_ios.EnqueueIPCReply(m_ACLEndpoint->ios_request, sizeof(hci_acldata_hdr_t) + frame_size);
+    m_ACLEndpoint.reset();
+  }
+}
+
 // These messages are sent from the Wii Remote to the game, for example RequestConnection()
 // or ConnectionComplete().
 //
@@ -327,11 +366,7 @@ void BluetoothEmu::Update()
   }
 
   // check ACL queue
-  if (!m_acl_pool.IsEmpty() && m_ACLEndpoint && m_EventQueue.empty())
-  {
-    m_acl_pool.WriteToEndpoint(*m_ACLEndpoint);
-    m_ACLEndpoint.reset();
-  }
+  SendQueuedACLPacket();
 
   // We wait for ScanEnable to be sent from the Bluetooth stack through HCI_CMD_WRITE_SCAN_ENABLE
   // before we initiate the connection.
@@ -368,28 +403,46 @@ void BluetoothEmu::Update()
     for (unsigned int i = 0; i < m_WiiMotes.size(); i++)
       Wiimote::Update(i, m_WiiMotes[i].IsConnected());
     m_last_ticks = now;
+    // The reports of all Wii Remotes were queued in one go, start handing them out now rather
+    // than on the next update.
+    SendQueuedACLPacket();
   }
 
   SendEventNumberOfCompletedPackets();
 }
 
+void BluetoothEmu::SendQueuedACLPacket()
+{
+  if (!m_acl_pool.IsEmpty() && m_ACLEndpoint && m_EventQueue.empty())
+  {
+    m_acl_pool.WriteToEndpoint(*m_ACLEndpoint);
+    m_ACLEndpoint.reset();
+  }
+}
+
 void BluetoothEmu::ACLPool::Store(const u8* data, const u16 size, const u16 conn_handle)
+{
+  u8* packet_data = Allocate(size, conn_handle);
+  if (packet_data)
+    std::copy(data, data + size, packet_data);
+}
+
+u8* BluetoothEmu::ACLPool::Allocate(const u16 size, const u16 conn_handle)
 {
   if (m_queue.size() >= 100)
   {
     // Many simultaneous exchanges of ACL packets tend to cause the queue to fill up.
     ERROR_LOG(IOS_WIIMOTE, "ACL queue size reached 100 - current packet will be dropped!");
-    return;
+    return nullptr;
   }
 
   DEBUG_ASSERT_MSG(IOS_WIIMOTE, size < ACL_PKT_SIZE, "ACL packet too large for pool");
 
-  m_queue.push_back(Packet());
+  m_queue.emplace_back();
   auto& packet = m_queue.back();
-
-  std::copy(data, data + size, packet.data);
   packet.size = size;
   packet.conn_handle = conn_handle;
+  return packet.data;
 }
 
 void BluetoothEmu::ACLPool::WriteToEndpoint(USB::V0BulkMessage& endpoint)
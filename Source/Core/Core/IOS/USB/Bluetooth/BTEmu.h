@@ -56,6 +56,9 @@ public:
 
   // Send ACL data back to Bluetooth stack
   void SendACLPacket(u16 connection_handle, const u8* data, u32 size);
+  // Same as SendACLPacket, for an L2CAP frame whose header is written straight to the ACL
+  // buffer (or the queue) along with the payload, without building the frame first.
+  void SendL2capPacket(u16 connection_handle, u16 dcid, const u8* data, u32 size);
 
   bool RemoteDisconnect(u16 _connectionHandle);
 
@@ -81,6 +84,8 @@ private:
   public:
     explicit ACLPool(Kernel& ios) : m_ios(ios), m_queue() {}
     void Store(const u8* data, const u16 size, const u16 conn_handle);
+    // Queues a packet of size bytes and returns its data, or nullptr if the queue is full.
+    u8* Allocate(const u16 size, const u16 conn_handle);
 
     void WriteToEndpoint(USB::V0BulkMessage& endpoint);
 
@@ -102,6 +107,9 @@ private:
   u32 m_PacketCount[MAX_BBMOTES] = {};
   u64 m_last_ticks = 0;
 
+  // Hands the oldest queued ACL packet to the stack if it is waiting for one.
+  void SendQueuedACLPacket();
+
   // Send ACL data to a device (wiimote)
   void IncDataPacket(u16 _ConnectionHandle);
   void SendToDevice(u16 _ConnectionHandle, u8* _pData, u32 _Size);
@@ -882,27 +882,13 @@ void WiimoteDevice::SendCommandToACL(u8 _Ident, u8 _Code, u8 _CommandLength, u8*
 
 void WiimoteDevice::ReceiveL2capData(u16 scid, const void* _pData, u32 _Size)
 {
-  // Allocate DataFrame
-  u8 DataFrame[1024];
-  u32 Offset = 0;
-  l2cap_hdr_t* pHeader = (l2cap_hdr_t*)DataFrame;
-  Offset += sizeof(l2cap_hdr_t);
-
   // Check if we are already reporting on this channel
   DEBUG_ASSERT(DoesChannelExist(scid));
   SChannel& rChannel = m_Channel[scid];
 
-  // Add an additional 4 byte header to the Wiimote report
-  pHeader->dcid = rChannel.DCID;
-  pHeader->length = _Size;
-
-  // Copy the Wiimote report to DataFrame
-  memcpy(DataFrame + Offset, _pData, _Size);
-  // Update Offset to the final size of the report
-  Offset += _Size;
-
-  // Send the report
-  m_pHost->SendACLPacket(GetConnectionHandle(), DataFrame, Offset);
+  // Send the report, the host adds the additional 4 byte header in place
+  m_pHost->SendL2capPacket(GetConnectionHandle(), rChannel.DCID,
+                           static_cast<const u8*>(_pData), _Size);
 }
 }  // namespace HLE
 }  // namespace IOS
@@ -469,6 +469,7 @@ IPCCommandResult WFSI::IOCtl(const IOCtlRequest& request)
     }
     else
     {
+      Memory::PrepareHostWrite(dol_addr, max_dol_size);
       fp.ReadBytes(Memory::GetPointer(dol_addr), max_dol_size);
     }
     Memory::Write_U32(real_dol_size, request.buffer_out);
@@ -517,6 +518,7 @@ u32 WFSI::GetTmd(u16 group_id, u32 title_id, u64 subtitle_id, u32 address, u32*
   }
   if (address)
   {
+    Memory::PrepareHostWrite(address, static_cast<u32>(fp.GetSize()));
     fp.ReadBytes(Memory::GetPointer(address), fp.GetSize());
   }
   *size = fp.GetSize();
@@ -298,6 +298,7 @@ IPCCommandResult WFSSRV::IOCtl(const IOCtlRequest& request)
       fd_obj->file.Seek(position, SEEK_SET);
     }
     size_t read_bytes;
+    Memory::PrepareHostWrite(addr, size);
     fd_obj->file.ReadArray(Memory::GetPointer(addr), size, &read_bytes);
     // TODO(wfs): Handle read errors.
     if (absolute)
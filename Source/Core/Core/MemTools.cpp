@@ -14,6 +14,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 
+#include "Core/HW/Memmap.h"
 #include "Core/MachineContext.h"
 #include "Core/PowerPC/JitInterface.h"
 
@@ -44,6 +45,12 @@ LONG NTAPI Handler(PEXCEPTION_POINTERS pPtrs)
     uintptr_t badAddress = (uintptr_t)pPtrs->ExceptionRecord->ExceptionInformation[1];
     CONTEXT* ctx = pPtrs->ContextRecord;
 
+    if (Memory::HandleWriteFault(badAddress))
+      return (DWORD)EXCEPTION_CONTINUE_EXECUTION;
+
+    if (Memory::HandlePageTableFault(badAddress))
+      return (DWORD)EXCEPTION_CONTINUE_EXECUTION;
+
     if (JitInterface::HandleFault(badAddress, ctx))
     {
       return (DWORD)EXCEPTION_CONTINUE_EXECUTION;
@@ -251,6 +258,14 @@ static void sigsegv_handler(int sig, siginfo_t* info, void* raw_context)
   }
   uintptr_t bad_address = (uintptr_t)info->si_addr;
 
+  // A write to a page that is protected for snapshot write tracking.
+  if (Memory::HandleWriteFault(bad_address))
+    return;
+
+  // An access to a page that the guest page table maps but that isn't mapped in logical memory yet.
+  if (Memory::HandlePageTableFault(bad_address))
+    return;
+
   // Get all the information we can out of the context.
 #ifdef __OpenBSD__
   ucontext_t* ctx = context;
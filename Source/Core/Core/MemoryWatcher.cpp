@@ -2,21 +2,31 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <fcntl.h>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <new>
 #include <sstream>
+#include <sys/mman.h>
 #include <unistd.h>
 
 #include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/MemoryWatcher.h"
+#include "Core/PowerPC/BreakPoints.h"
+#include "Core/PowerPC/PowerPC.h"
 
 static std::unique_ptr<MemoryWatcher> s_memory_watcher;
 static CoreTiming::EventType* s_event;
 static const int MW_RATE = 600;  // Steps per second
+static const u32 MW_RING_CAPACITY = 1 << 16;  // records
+static const u32 MW_RING_VERSION = 1;
 
 static void MWCallback(u64 userdata, s64 cyclesLate)
 {
@@ -42,8 +52,15 @@ MemoryWatcher::MemoryWatcher()
   m_running = false;
   if (!LoadAddresses(File::GetUserPath(F_MEMORYWATCHERLOCATIONS_IDX)))
     return;
-  if (!OpenSocket(File::GetUserPath(F_MEMORYWATCHERSOCKET_IDX)))
+  if (SConfig::GetInstance().m_memory_watcher_ring)
+  {
+    if (!OpenRing(File::GetUserPath(F_MEMORYWATCHERRING_IDX)))
+      return;
+  }
+  else if (!OpenSocket(File::GetUserPath(F_MEMORYWATCHERSOCKET_IDX)))
+  {
     return;
+  }
   m_running = true;
 }
 
@@ -53,7 +70,11 @@ MemoryWatcher::~MemoryWatcher()
     return;
 
   m_running = false;
-  close(m_fd);
+  RemoveWatchpoints();
+  if (m_ring)
+    munmap(m_ring, m_ring_size);
+  if (m_fd >= 0)
+    close(m_fd);
 }
 
 bool MemoryWatcher::LoadAddresses(const std::string& path)
@@ -64,22 +85,33 @@ bool MemoryWatcher::LoadAddresses(const std::string& path)
     return false;
 
   std::string line;
-  while (std::getline(locations, line))
-    ParseLine(line);
+  for (u32 line_number = 0; std::getline(locations, line); line_number++)
+    ParseLine(line, line_number);
 
-  return m_values.size() > 0;
+  return m_watches.size() > 0;
 }
 
-void MemoryWatcher::ParseLine(const std::string& line)
+// The addresses are parsed once here, so that polling doesn't have to.
+void MemoryWatcher::ParseLine(const std::string& line, u32 line_number)
 {
-  m_values[line] = 0;
-  m_addresses[line] = std::vector<u32>();
+  if (std::any_of(m_watches.begin(), m_watches.end(),
+                  [&](const Watch& watch) { return watch.line == line; }))
+  {
+    return;
+  }
+
+  Watch watch;
+  watch.line = line;
+  watch.line_number = line_number;
 
   std::stringstream offsets(line);
   offsets >> std::hex;
   u32 offset;
   while (offsets >> offset)
-    m_addresses[line].push_back(offset);
+    watch.offsets.push_back(offset);
+
+  if (!watch.offsets.empty())
+    m_watches.push_back(std::move(watch));
 }
 
 bool MemoryWatcher::OpenSocket(const std::string& path)
@@ -92,39 +124,161 @@ bool MemoryWatcher::OpenSocket(const std::string& path)
   return m_fd >= 0;
 }
 
-u32 MemoryWatcher::ChasePointer(const std::string& line)
+bool MemoryWatcher::OpenRing(const std::string& path)
+{
+  m_ring_size = sizeof(MemoryWatcherRingHeader) + MW_RING_CAPACITY * sizeof(MemoryWatcherRecord);
+
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    ERROR_LOG(CORE, "MemoryWatcher: could not create %s", path.c_str());
+    return false;
+  }
+  void* memory = nullptr;
+  if (ftruncate(fd, m_ring_size) == 0)
+    memory = mmap(nullptr, m_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (!memory || memory == MAP_FAILED)
+  {
+    ERROR_LOG(CORE, "MemoryWatcher: could not map %s", path.c_str());
+    return false;
+  }
+
+  // The file is zero-filled, so every record starts out incomplete.
+  m_ring = new (memory) MemoryWatcherRingHeader();
+  memcpy(&m_ring->magic, "MWRB", sizeof(m_ring->magic));
+  m_ring->version = MW_RING_VERSION;
+  m_ring->record_size = sizeof(MemoryWatcherRecord);
+  m_ring->capacity = MW_RING_CAPACITY;
+  m_ring->write_count.store(0, std::memory_order_release);
+  return true;
+}
+
+// Watchpoints go through the debugger's memory checks, which make the JIT use slow memory
+// accesses for the pages they are on. Only addresses without pointers to follow are watched;
+// the others keep being polled.
+void MemoryWatcher::AddWatchpoints()
+{
+  m_watchpoints_added = true;
+  for (size_t i = 0; i < m_watches.size(); i++)
+  {
+    Watch& watch = m_watches[i];
+    const u32 address = watch.offsets[0];
+    // Don't take over a memory check the user set up.
+    if (watch.offsets.size() != 1 || PowerPC::memchecks.GetMemCheck(address, 4))
+      continue;
+
+    TMemCheck check;
+    check.start_address = address;
+    check.end_address = address + 3;
+    check.is_ranged = true;
+    check.is_break_on_write = true;
+    check.on_hit = [this, i](u32 hit_address, u32 value, size_t size, bool write) {
+      if (write)
+        OnWrite(i, hit_address, value, size);
+    };
+    PowerPC::memchecks.Add(check);
+    watch.has_watchpoint = true;
+  }
+}
+
+void MemoryWatcher::RemoveWatchpoints()
+{
+  for (Watch& watch : m_watches)
+  {
+    if (watch.has_watchpoint)
+      PowerPC::memchecks.Remove(watch.offsets[0]);
+    watch.has_watchpoint = false;
+  }
+}
+
+u32 MemoryWatcher::ChasePointer(const Watch& watch, u32* address) const
 {
   u32 value = 0;
-  for (u32 offset : m_addresses[line])
-    value = Memory::Read_U32(value + offset);
+  for (u32 offset : watch.offsets)
+  {
+    *address = value + offset;
+    value = Memory::Read_U32(*address);
+  }
   return value;
 }
 
-std::string MemoryWatcher::ComposeMessage(const std::string& line, u32 value)
+std::string MemoryWatcher::ComposeMessage(const Watch& watch, u32 value) const
 {
   std::stringstream message_stream;
-  message_stream << line << '\n' << std::hex << value;
+  message_stream << watch.line << '\n' << std::hex << value;
   return message_stream.str();
 }
 
+void MemoryWatcher::Report(Watch& watch, u32 address, u32 value, u32 flags)
+{
+  watch.value = value;
+
+  if (!m_ring)
+  {
+    std::string message = ComposeMessage(watch, value);
+    sendto(m_fd, message.c_str(), message.size() + 1, 0, reinterpret_cast<sockaddr*>(&m_addr),
+           sizeof(m_addr));
+    return;
+  }
+
+  // Readers check the sequence before and after copying a record, so it is cleared first.
+  const u64 n = m_ring->write_count.load(std::memory_order_relaxed);
+  MemoryWatcherRecord* records = reinterpret_cast<MemoryWatcherRecord*>(m_ring + 1);
+  MemoryWatcherRecord& record = records[n & (MW_RING_CAPACITY - 1)];
+  record.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  record.ticks = CoreTiming::GetTicks();
+  record.line = watch.line_number;
+  record.address = address;
+  record.value = value;
+  record.flags = flags;
+  record.sequence.store(n + 1, std::memory_order_release);
+  m_ring->write_count.store(n + 1, std::memory_order_release);
+}
+
+// Called before the write happens, so the new value is made up of the written bytes and the
+// ones the write doesn't touch.
+void MemoryWatcher::OnWrite(size_t index, u32 address, u32 value, size_t size)
+{
+  if (!m_running)
+    return;
+
+  Watch& watch = m_watches[index];
+  const u32 watch_address = watch.offsets[0];
+  // Memory checks only get the low half of 64-bit writes, the value is polled instead.
+  if (size > 4)
+    return;
+
+  u32 new_value = Memory::Read_U32(watch_address);
+  for (u32 i = 0; i < size; i++)
+  {
+    const u32 byte_address = address + i;
+    if (byte_address < watch_address || byte_address > watch_address + 3)
+      continue;
+    const u32 shift = 8 * (3 - (byte_address - watch_address));
+    const u32 byte = (value >> (8 * (size - 1 - i))) & 0xFF;
+    new_value = (new_value & ~(0xFFu << shift)) | (byte << shift);
+  }
+
+  if (new_value != watch.value)
+    Report(watch, watch_address, new_value, MEMORYWATCHER_RECORD_WRITE);
+}
+
 void MemoryWatcher::Step()
 {
   if (!m_running)
     return;
 
-  for (auto& entry : m_values)
+  // Memory checks can only be added once the CPU thread runs.
+  if (!m_watchpoints_added && SConfig::GetInstance().m_memory_watcher_watchpoints)
+    AddWatchpoints();
+
+  for (Watch& watch : m_watches)
   {
-    std::string address = entry.first;
-    u32& current_value = entry.second;
-
-    u32 new_value = ChasePointer(address);
-    if (new_value != current_value)
-    {
-      // Update the value
-      current_value = new_value;
-      std::string message = ComposeMessage(address, new_value);
-      sendto(m_fd, message.c_str(), message.size() + 1, 0, reinterpret_cast<sockaddr*>(&m_addr),
-        sizeof(m_addr));
-    }
+    u32 address;
+    const u32 new_value = ChasePointer(watch, &address);
+    if (new_value != watch.value)
+      Report(watch, address, new_value, 0);
   }
 }
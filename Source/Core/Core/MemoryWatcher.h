@@ -4,11 +4,14 @@
 
 #pragma once
 
-#include <map>
+#include <atomic>
+#include <string>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <vector>
 
+#include "Common/CommonTypes.h"
+
 // MemoryWatcher reads a file containing in-game memory addresses and outputs
 // changes to those memory addresses to a unix domain socket as the game runs.
 //
@@ -17,6 +20,40 @@
 // "ABCD EF" will watch the address at (*0xABCD) + 0xEF.
 // The output to the socket is two lines. The first is the address from the
 // input file, and the second is the new value in hex.
+//
+// With MemoryWatcherRing set, changes are instead written as binary records to a ring buffer in
+// the memory-mapped file MemoryWatcher/MemoryWatcher.ring, laid out as a MemoryWatcherRingHeader
+// followed by its records. With MemoryWatcherWatchpoints also set, addresses without pointers
+// are watched for writes by the CPU, so every change is seen rather than only the value at the
+// next poll.
+
+struct MemoryWatcherRecord
+{
+  // n + 1 once record n is complete; 0 while it is being written.
+  std::atomic<u64> sequence;
+  u64 ticks;  // emulated CPU ticks at the change
+  u32 line;   // line of the watch in the input file, counting from 0
+  u32 address;
+  u32 value;
+  u32 flags;
+};
+
+enum : u32
+{
+  // The change was caught by a write watchpoint rather than by polling.
+  MEMORYWATCHER_RECORD_WRITE = 1,
+};
+
+struct MemoryWatcherRingHeader
+{
+  u32 magic;  // "MWRB"
+  u32 version;
+  u32 record_size;
+  u32 capacity;  // in records, a power of two
+  // Records written so far; record n is at index n % capacity.
+  std::atomic<u64> write_count;
+};
+
 class MemoryWatcher final
 {
 public:
@@ -28,20 +65,35 @@ public:
   static void Shutdown();
 
 private:
+  struct Watch
+  {
+    std::string line;
+    u32 line_number;
+    std::vector<u32> offsets;  // to follow
+    u32 value = 0;
+    bool has_watchpoint = false;
+  };
+
   bool LoadAddresses(const std::string& path);
   bool OpenSocket(const std::string& path);
+  bool OpenRing(const std::string& path);
+  void AddWatchpoints();
+  void RemoveWatchpoints();
 
-  void ParseLine(const std::string& line);
-  u32 ChasePointer(const std::string& line);
-  std::string ComposeMessage(const std::string& line, u32 value);
+  void ParseLine(const std::string& line, u32 line_number);
+  u32 ChasePointer(const Watch& watch, u32* address) const;
+  std::string ComposeMessage(const Watch& watch, u32 value) const;
+  void Report(Watch& watch, u32 address, u32 value, u32 flags);
+  void OnWrite(size_t index, u32 address, u32 value, size_t size);
 
   bool m_running;
 
-  int m_fd;
+  int m_fd = -1;
   sockaddr_un m_addr;
 
-  // Address as stored in the file -> list of offsets to follow
-  std::map<std::string, std::vector<u32>> m_addresses;
-  // Address as stored in the file -> current value
-  std::map<std::string, u32> m_values;
+  MemoryWatcherRingHeader* m_ring = nullptr;
+  size_t m_ring_size = 0;
+  bool m_watchpoints_added = false;
+
+  std::vector<Watch> m_watches;
 };
@@ -6,7 +6,9 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <cinttypes>
 #include <iomanip>
 #include <iterator>
 #include <mbedtls/config.h>
@@ -27,6 +29,7 @@
 #include "Common/Hash.h"
 #include "Common/NandPaths.h"
 #include "Common/StringUtil.h"
+#include "Common/Thread.h"
 #include "Common/Timer.h"
 #include "Common/Version.h"
 
@@ -43,6 +46,7 @@
 #include "Core/HW/EXI/EXI_DeviceIPL.h"
 #include "Core/HW/ProcessorInterface.h"
 #include "Core/HW/SI/SI.h"
+#include "Core/HW/VideoInterface.h"
 #include "Core/HW/Wiimote.h"
 #include "Core/HW/WiimoteCommon/WiimoteReport.h"
 #include "Core/HW/WiimoteEmu/WiimoteEmu.h"
@@ -102,6 +106,48 @@ static WiiManipFunction s_wii_manip_func;
 
 static std::string s_current_file_name;
 
+// Keyframes are compressed savestates taken every few seconds while a movie plays back. They are
+// kept next to the movie in <movie>.keyframes, so that SeekToFrame can start from the nearest one
+// instead of the beginning of the movie.
+#pragma pack(push, 1)
+struct KeyframeFileHeader
+{
+  u8 filetype[4];  // Unique Identifier (always "DTK"0x1A)
+  u32 version;
+  u8 gameID[6];
+  u32 inputHash;  // Adler-32 of the input data of the movie the keyframes were taken from
+  u64 inputSize;
+};
+
+struct KeyframeHeader
+{
+  u64 frame;
+  u64 stateSize;
+  u64 compressedSize;
+};
+#pragma pack(pop)
+
+static const u32 KEYFRAME_FILE_VERSION = 1;
+
+struct Keyframe
+{
+  u64 frame;
+  u64 offset;  // of the compressed state in the file
+  u64 stateSize;
+  u64 compressedSize;
+};
+
+// Guards the keyframe file and index, which are also used by the thread writing keyframes.
+static std::mutex s_keyframe_lock;
+static std::string s_keyframe_path;
+static KeyframeFileHeader s_keyframe_file_header;
+static std::vector<Keyframe> s_keyframes;  // sorted by frame
+static u64 s_keyframe_file_end = 0;
+static std::thread s_keyframe_thread;
+static std::atomic<bool> s_keyframe_writing{false};
+// Frame that a seek is fast-forwarding to, 0 if not seeking.
+static std::atomic<u64> s_seek_target{0};
+
 static void GetSettings();
 static bool IsMovieHeader(u8 magic[4])
 {
@@ -862,6 +908,200 @@ void ReadHeader()
   s_DSPcoefHash = tmpHeader.DSPcoefHash;
 }
 
+static void CloseKeyframes()
+{
+  if (s_keyframe_thread.joinable())
+    s_keyframe_thread.join();
+
+  std::lock_guard<std::mutex> lk(s_keyframe_lock);
+  s_keyframe_path.clear();
+  s_keyframes.clear();
+  s_keyframe_file_end = 0;
+}
+
+// Reads the keyframe index of a movie. Keyframes from a different version of the movie are
+// thrown away, as is anything after the last complete keyframe.
+static void OpenKeyframes(const std::string& movie_path)
+{
+  CloseKeyframes();
+
+  std::lock_guard<std::mutex> lk(s_keyframe_lock);
+  s_keyframe_path = movie_path + ".keyframes";
+
+  KeyframeFileHeader& expected = s_keyframe_file_header;
+  memset(&expected, 0, sizeof(expected));
+  memcpy(expected.filetype, "DTK\x1A", sizeof(expected.filetype));
+  expected.version = KEYFRAME_FILE_VERSION;
+  memcpy(expected.gameID, tmpHeader.gameID, sizeof(expected.gameID));
+  expected.inputHash = HashAdler32(s_temp_input.data(), s_temp_input.size());
+  expected.inputSize = s_temp_input.size();
+
+  File::IOFile file(s_keyframe_path, "rb");
+  KeyframeFileHeader header;
+  if (!file || !file.ReadArray(&header, 1) || memcmp(&header, &expected, sizeof(header)))
+  {
+    file.Close();
+    if (File::Exists(s_keyframe_path))
+      File::Delete(s_keyframe_path);
+    return;
+  }
+
+  const u64 file_size = file.GetSize();
+  s_keyframe_file_end = file.Tell();
+  KeyframeHeader keyframe;
+  while (file.ReadArray(&keyframe, 1))
+  {
+    const u64 offset = file.Tell();
+    if (keyframe.compressedSize > file_size - offset ||
+        (!s_keyframes.empty() && keyframe.frame <= s_keyframes.back().frame))
+    {
+      break;
+    }
+    s_keyframes.push_back({keyframe.frame, offset, keyframe.stateSize, keyframe.compressedSize});
+    s_keyframe_file_end = offset + keyframe.compressedSize;
+    file.Seek(keyframe.compressedSize, SEEK_CUR);
+  }
+}
+
+// NOTE: Keyframe Thread
+static void WriteKeyframe(u64 frame, std::vector<u8> state)
+{
+  Common::SetCurrentThreadName("Movie keyframe thread");
+
+  std::vector<u8> compressed;
+  State::CompressState(state, compressed);
+
+  {
+    std::lock_guard<std::mutex> lk(s_keyframe_lock);
+    if (!s_keyframe_path.empty())
+    {
+      File::IOFile file;
+      if (s_keyframe_file_end == 0)
+      {
+        file.Open(s_keyframe_path, "wb");
+        file.WriteArray(&s_keyframe_file_header, 1);
+      }
+      else
+      {
+        file.Open(s_keyframe_path, "r+b");
+        file.Seek(s_keyframe_file_end, SEEK_SET);
+      }
+
+      const KeyframeHeader header = {frame, state.size(), compressed.size()};
+      file.WriteArray(&header, 1);
+      const u64 offset = file.Tell();
+      if (file.WriteBytes(compressed.data(), compressed.size()))
+      {
+        s_keyframes.push_back({frame, offset, header.stateSize, header.compressedSize});
+        s_keyframe_file_end = file.Tell();
+        file.Resize(s_keyframe_file_end);
+      }
+      else
+      {
+        ERROR_LOG(CORE, "Failed to write movie keyframe to %s", s_keyframe_path.c_str());
+      }
+    }
+  }
+
+  s_keyframe_writing = false;
+}
+
+static bool ReadKeyframe(const Keyframe& keyframe, std::vector<u8>& state)
+{
+  File::IOFile file(s_keyframe_path, "rb");
+  std::vector<u8> compressed(keyframe.compressedSize);
+  if (!file.Seek(keyframe.offset, SEEK_SET) ||
+      !file.ReadBytes(compressed.data(), compressed.size()))
+  {
+    return false;
+  }
+
+  state.resize(keyframe.stateSize);
+  return State::DecompressState(compressed, state);
+}
+
+static void EndSeek()
+{
+  if (s_seek_target.exchange(0))
+    Core::SetOutputSuppressed(false);
+}
+
+// NOTE: CPU Thread
+void FieldUpdate()
+{
+  const u64 seek_target = s_seek_target;
+  if (seek_target && s_currentFrame >= seek_target)
+  {
+    EndSeek();
+    Core::DisplayMessage(StringFromFormat("Seeked to frame %" PRIu64, s_currentFrame), 2000);
+  }
+
+  const int interval = SConfig::GetInstance().m_movie_keyframe_interval;
+  if (s_playMode != MODE_PLAYING || interval <= 0 || s_keyframe_writing)
+    return;
+
+  const u64 spacing = static_cast<u64>(interval) * VideoInterface::GetTargetRefreshRate();
+  {
+    std::lock_guard<std::mutex> lk(s_keyframe_lock);
+    if (s_keyframe_path.empty())
+      return;
+    const u64 last_frame = s_keyframes.empty() ? 0 : s_keyframes.back().frame;
+    if (s_currentFrame < last_frame + spacing)
+      return;
+  }
+
+  // Only the copy happens here, compressing and writing the keyframe is left to another thread.
+  std::vector<u8> state;
+  State::SaveToBuffer(state);
+  if (s_keyframe_thread.joinable())
+    s_keyframe_thread.join();
+  s_keyframe_writing = true;
+  s_keyframe_thread = std::thread(WriteKeyframe, s_currentFrame, std::move(state));
+}
+
+// NOTE: Host Thread
+bool SeekToFrame(u64 frame)
+{
+  if (s_playMode != MODE_PLAYING || !Core::IsRunningAndStarted())
+    return false;
+
+  frame = std::min(frame, s_totalFrames);
+  bool success = true;
+  Core::RunAsCPUThread([&] {
+    std::vector<u8> state;
+    {
+      std::lock_guard<std::mutex> lk(s_keyframe_lock);
+      auto it = std::upper_bound(s_keyframes.begin(), s_keyframes.end(), frame,
+                                 [](u64 f, const Keyframe& keyframe) { return f < keyframe.frame; });
+      // Going forwards, a keyframe only helps if it's ahead of the current frame.
+      if (it != s_keyframes.begin() && (frame < s_currentFrame || (it - 1)->frame > s_currentFrame))
+      {
+        if (!ReadKeyframe(*(it - 1), state))
+          state.clear();
+      }
+    }
+
+    if (!state.empty())
+    {
+      State::LoadFromBuffer(state);
+    }
+    else if (frame < s_currentFrame)
+    {
+      Core::DisplayMessage(StringFromFormat("No keyframe before frame %" PRIu64, frame), 2000);
+      success = false;
+      return;
+    }
+
+    if (s_currentFrame < frame)
+    {
+      s_seek_target = frame;
+      Core::SetOutputSuppressed(true);
+    }
+  });
+
+  return success;
+}
+
 // NOTE: Host Thread
 bool PlayInput(const std::string& movie_path, std::optional<std::string>* savestate_path)
 {
@@ -899,6 +1139,8 @@ bool PlayInput(const std::string& movie_path, std::optional<std::string>* savest
   s_currentByte = 0;
   recording_file.Close();
 
+  OpenKeyframes(movie_path);
+
   // Load savestate (and skip to frame data)
   if (tmpHeader.bFromSaveState && savestate_path)
   {
@@ -1080,6 +1322,8 @@ void LoadInput(const std::string& movie_path)
     {
       if (s_playMode != MODE_RECORDING)
       {
+        // The keyframes belong to the input that was played back, which may change from now on.
+        CloseKeyframes();
         s_playMode = MODE_RECORDING;
         Core::UpdateWantDeterminism();
         Core::DisplayMessage("Switched to recording", 2000);
@@ -1259,6 +1503,8 @@ void EndPlayInput(bool cont)
     ASSERT(IsMovieActive());
 
     s_playMode = MODE_RECORDING;
+    EndSeek();
+    CloseKeyframes();
     Core::DisplayMessage("Reached movie end. Resuming recording.", 2000);
   }
   else if (s_playMode != MODE_NONE)
@@ -1270,6 +1516,8 @@ void EndPlayInput(bool cont)
     s_rerecords = 0;
     s_currentByte = 0;
     s_playMode = MODE_NONE;
+    EndSeek();
+    CloseKeyframes();
     Core::DisplayMessage("Movie End.", 2000);
     s_bRecordingFromSaveState = false;
     // we don't clear these things because otherwise we can't resume playback if we load a movie
@@ -1479,6 +1727,8 @@ static void GetMD5()
 // NOTE: EmuThread
 void Shutdown()
 {
+  EndSeek();
+  CloseKeyframes();
   s_currentInputCount = s_totalInputCount = s_totalFrames = s_tickCountAtLastInput = 0;
   s_temp_input.clear();
 }
@@ -116,6 +116,7 @@ static_assert(sizeof(DTMHeader) == 256, "DTMHeader should be 256 bytes");
 
 void FrameUpdate();
 void InputUpdate();
+void FieldUpdate();
 void Init(const BootParameters& boot);
 
 void SetPolledDevice();
@@ -165,6 +166,9 @@ void PlayController(GCPadStatus* PadStatus, int controllerID);
 bool PlayWiimote(int wiimote, u8* data, const struct WiimoteEmu::ReportFeatures& rptf, int ext,
   const wiimote_key key);
 void EndPlayInput(bool cont);
+// Jumps to a frame of the movie being played back by loading the nearest keyframe before it and
+// emulating the rest without output.
+bool SeekToFrame(u64 frame);
 void SaveRecording(const std::string& filename);
 void DoState(PointerWrap& p);
 void Shutdown();
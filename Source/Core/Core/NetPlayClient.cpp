@@ -5,6 +5,7 @@
 #include "Core/NetPlayClient.h"
 
 #include <algorithm>
+#include <cinttypes>
 #include <cstddef>
 #include <cstring>
 #include <fstream>
@@ -35,6 +36,7 @@
 #include "Core/HW/WiimoteReal/WiimoteReal.h"
 #include "Core/IOS/USB/Bluetooth/BTEmu.h"
 #include "Core/Movie.h"
+#include "Core/State.h"
 #include "InputCommon/GCAdapter.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoConfig.h"
@@ -43,6 +45,27 @@ static std::mutex crit_netplay_client;
 NetPlayClient* netplay_client = nullptr;
 NetSettings g_NetPlaySettings;
 
+struct NetPlayClient::RollbackFrame
+{
+  u64 field;
+  // The index of the next input of each port when the snapshot was taken.
+  std::array<u64, 4> next;
+  State::Snapshot snapshot;
+};
+
+static size_t GetRollbackWindow()
+{
+  return static_cast<size_t>(std::max(Config::Get(Config::NETPLAY_ROLLBACK_FRAMES), 1));
+}
+
+static bool IsSamePadStatus(const GCPadStatus& a, const GCPadStatus& b)
+{
+  return a.button == b.button && a.analogA == b.analogA && a.analogB == b.analogB &&
+         a.stickX == b.stickX && a.stickY == b.stickY && a.substickX == b.substickX &&
+         a.substickY == b.substickY && a.triggerLeft == b.triggerLeft &&
+         a.triggerRight == b.triggerRight;
+}
+
 // called from ---GUI--- thread
 NetPlayClient::~NetPlayClient()
 {
@@ -365,14 +388,33 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
   case NP_MSG_PAD_DATA:
   {
     PadMapping map = 0;
+    u32 index = 0;
     GCPadStatus pad;
-    packet >> map >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >>
-      pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
+    packet >> map >> index >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >>
+      pad.stickY >> pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
 
-    // Trusting server for good map value (>=0 && <4)
-    // add to pad buffer
-    m_pad_buffer.at(map).Push(pad);
-    m_gc_pad_event.Set();
+    OnPadData(map, index, pad);
+  }
+  break;
+
+  case NP_MSG_PAD_DATA_REDUNDANT:
+  case NP_MSG_PAD_DATA_BATCH:
+  {
+    PadMapping map = 0;
+    u32 first_index = 0;
+    u8 count = 0;
+    packet >> map >> first_index >> count;
+
+    for (u32 i = 0; i < count; ++i)
+    {
+      GCPadStatus pad;
+      packet >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >>
+        pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
+      if (!packet)
+        break;
+
+      OnPadData(map, first_index + i, pad);
+    }
   }
   break;
 
@@ -466,6 +508,7 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
       packet >> g_NetPlaySettings.m_CPUthread;
       packet >> g_NetPlaySettings.m_CPUcore;
       packet >> g_NetPlaySettings.m_EnableCheats;
+      packet >> g_NetPlaySettings.m_GeckoNative;
       packet >> g_NetPlaySettings.m_SelectedLanguage;
       packet >> g_NetPlaySettings.m_OverrideGCLanguage;
       packet >> g_NetPlaySettings.m_ProgressiveScan;
@@ -621,11 +664,32 @@ unsigned int NetPlayClient::OnData(sf::Packet& packet)
   return 0;
 }
 
+// called from ---NETPLAY--- thread
+void NetPlayClient::OnPadData(PadMapping map, u32 index, const GCPadStatus& pad)
+{
+  // Trusting server for good map value (>=0 && <4)
+  // Every input arrives at least twice, only take the next one in order.
+  if (index != m_pad_received_count.at(map))
+    return;
+
+  ++m_pad_received_count[map];
+
+  // add to pad buffer
+  m_pad_buffer[map].Push(pad);
+  m_gc_pad_event.Set();
+}
+
 void NetPlayClient::Send(sf::Packet& packet)
 {
-  ENetPacket* epac =
-    enet_packet_create(packet.getData(), packet.getDataSize(), ENET_PACKET_FLAG_RELIABLE);
-  enet_peer_send(m_server, 0, epac);
+  const bool redundant = packet.getDataSize() > 0 &&
+                         *static_cast<const u8*>(packet.getData()) == NP_MSG_PAD_DATA_REDUNDANT;
+  ENetPacket* epac = enet_packet_create(
+    packet.getData(), packet.getDataSize(),
+    redundant ? ENET_PACKET_FLAG_UNSEQUENCED : ENET_PACKET_FLAG_RELIABLE);
+  enet_peer_send(m_server, redundant && m_server->channelCount > NP_CHANNEL_REDUNDANT ?
+                             NP_CHANNEL_REDUNDANT :
+                             0,
+                 epac);
 }
 
 void NetPlayClient::DisplayPlayersPing()
@@ -899,13 +963,34 @@ void NetPlayClient::ReportFrameTimeToServer(float frame_time)
 // called from ---CPU--- thread
 void NetPlayClient::SendPadState(const int in_game_pad, const GCPadStatus& pad)
 {
+  const u32 index = m_pad_sent_count[in_game_pad]++;
+
   auto spac = std::make_unique<sf::Packet>();
   *spac << static_cast<MessageId>(NP_MSG_PAD_DATA);
   *spac << static_cast<PadMapping>(in_game_pad);
+  *spac << index;
   *spac << pad.button << pad.analogA << pad.analogB << pad.stickX << pad.stickY << pad.substickX
     << pad.substickY << pad.triggerLeft << pad.triggerRight;
 
   SendAsync(std::move(spac));
+
+  std::deque<GCPadStatus>& history = m_pad_sent_history[in_game_pad];
+  history.push_back(pad);
+  if (history.size() > NP_PAD_DATA_REDUNDANCY)
+    history.pop_front();
+
+  auto redundant = std::make_unique<sf::Packet>();
+  *redundant << static_cast<MessageId>(NP_MSG_PAD_DATA_REDUNDANT);
+  *redundant << static_cast<PadMapping>(in_game_pad);
+  *redundant << static_cast<u32>(index + 1 - history.size());
+  *redundant << static_cast<u8>(history.size());
+  for (const GCPadStatus& sent : history)
+  {
+    *redundant << sent.button << sent.analogA << sent.analogB << sent.stickX << sent.stickY
+      << sent.substickX << sent.substickY << sent.triggerLeft << sent.triggerRight;
+  }
+
+  SendAsync(std::move(redundant));
 }
 
 // called from ---CPU--- thread
@@ -959,6 +1044,11 @@ bool NetPlayClient::StartGame(const std::string& path)
   m_is_running.Set();
   NetPlay_Enable(this);
 
+  // Rollback only covers GameCube controllers; Wii Remote inputs can't be predicted or replayed.
+  m_rollback = Config::Get(Config::NETPLAY_ROLLBACK) && !dialog->IsRecording() &&
+               std::none_of(m_wiimote_map.begin(), m_wiimote_map.end(),
+                            [](PadMapping mapping) { return mapping > 0; });
+
   ClearBuffers();
 
   if (dialog->IsRecording())
@@ -1045,7 +1135,23 @@ void NetPlayClient::ClearBuffers()
 
     while (m_wiimote_buffer[i].Size())
       m_wiimote_buffer[i].Pop();
+
+    m_pad_sent_count[i] = 0;
+    m_pad_sent_history[i].clear();
+    m_pad_received_count[i] = 0;
   }
+
+  ClearRollback();
+}
+
+void NetPlayClient::ClearRollback()
+{
+  for (RollbackPad& pad : m_rollback_pads)
+    pad = RollbackPad();
+  m_rollback_frames.clear();
+  m_rollback_spare_frames.clear();
+  m_rollback_field = 0;
+  m_resimulate_until = 0;
 }
 
 // called from ---NETPLAY--- thread
@@ -1100,6 +1206,9 @@ void NetPlayClient::OnConnectFailed(u8 reason)
 // called from ---CPU--- thread
 bool NetPlayClient::GetNetPads(const int pad_nb, GCPadStatus* pad_status)
 {
+  if (m_rollback)
+    return GetRollbackPad(pad_nb, pad_status);
+
   SendNetPad(pad_nb);
 
   // Now, we either use the data pushed earlier, or wait for the
@@ -1129,6 +1238,219 @@ bool NetPlayClient::GetNetPads(const int pad_nb, GCPadStatus* pad_status)
   return true;
 }
 
+// called from ---CPU--- thread
+void NetPlayClient::ReceiveRollbackInputs(const int pad_nb)
+{
+  RollbackPad& pad = m_rollback_pads[pad_nb];
+  GCPadStatus status;
+  while (m_pad_buffer[pad_nb].Pop(status))
+  {
+    const u64 index = pad.received++;
+    if (index < pad.base + pad.inputs.size())
+    {
+      RollbackInput& input = pad.inputs[index - pad.base];
+      if (input.predicted && !IsSamePadStatus(input.status, status))
+        pad.mispredicted = std::min(pad.mispredicted, index);
+      input = {status, false};
+    }
+    else
+    {
+      pad.inputs.push_back({status, false});
+    }
+  }
+}
+
+// called from ---CPU--- thread
+bool NetPlayClient::GetRollbackPad(const int pad_nb, GCPadStatus* pad_status)
+{
+  RollbackPad& pad = m_rollback_pads[pad_nb];
+  ReceiveRollbackInputs(pad_nb);
+
+  // Local inputs are polled when the game first reads them, and replayed from then on.
+  if (pad.next >= pad.received && m_pad_map[pad_nb] == local_player->pid)
+  {
+    SendNetPad(pad_nb);
+    ReceiveRollbackInputs(pad_nb);
+  }
+
+  // Without a snapshot to return to, remote inputs can't be predicted yet.
+  while (pad.next >= pad.received && m_rollback_frames.empty())
+  {
+    if (!m_is_running.IsSet())
+      return false;
+
+    m_gc_pad_event.Wait();
+    ReceiveRollbackInputs(pad_nb);
+  }
+
+  if (pad.next == pad.base + pad.inputs.size())
+    pad.inputs.push_back({});
+
+  RollbackInput& input = pad.inputs[pad.next - pad.base];
+  if (pad.next >= pad.received)
+  {
+    // Predict that the remote player still holds the newest input that arrived.
+    if (pad.received > pad.base)
+    {
+      input.status = pad.inputs[pad.received - 1 - pad.base].status;
+    }
+    else
+    {
+      input.status = {};
+      input.status.stickX = GCPadStatus::MAIN_STICK_CENTER_X;
+      input.status.stickY = GCPadStatus::MAIN_STICK_CENTER_Y;
+      input.status.substickX = GCPadStatus::C_STICK_CENTER_X;
+      input.status.substickY = GCPadStatus::C_STICK_CENTER_Y;
+    }
+    input.predicted = true;
+  }
+
+  *pad_status = input.status;
+  ++pad.next;
+  return true;
+}
+
+// called from ---CPU--- thread
+// Before the oldest snapshot is dropped, the inputs read after it have to be confirmed, since a
+// misprediction among them could no longer be rolled back.
+bool NetPlayClient::WaitForRollbackWindow()
+{
+  if (m_rollback_frames.size() < GetRollbackWindow())
+    return true;
+
+  while (true)
+  {
+    bool confirmed = true;
+    for (int i = 0; i < 4; ++i)
+    {
+      ReceiveRollbackInputs(i);
+      const RollbackPad& pad = m_rollback_pads[i];
+      const u64 oldest_kept =
+          m_rollback_frames.size() > 1 ? m_rollback_frames[1]->next[i] : pad.next;
+      if (pad.received < oldest_kept)
+        confirmed = false;
+    }
+
+    if (confirmed)
+      return true;
+
+    if (!m_is_running.IsSet())
+      return false;
+
+    m_gc_pad_event.Wait();
+  }
+}
+
+// called from ---CPU--- thread
+bool NetPlayClient::RollBack()
+{
+  // Return to the newest snapshot from before every mispredicted input.
+  const auto frame = std::find_if(
+      m_rollback_frames.rbegin(), m_rollback_frames.rend(), [this](const auto& candidate) {
+        for (int i = 0; i < 4; ++i)
+        {
+          if (candidate->next[i] > m_rollback_pads[i].mispredicted)
+            return false;
+        }
+        return true;
+      });
+
+  for (RollbackPad& pad : m_rollback_pads)
+    pad.mispredicted = UINT64_MAX;
+
+  if (frame == m_rollback_frames.rend())
+  {
+    ERROR_LOG(NETPLAY, "Rollback: no snapshot from before the mispredicted input");
+    return false;
+  }
+
+  State::LoadFromSnapshot((*frame)->snapshot);
+  for (int i = 0; i < 4; ++i)
+    m_rollback_pads[i].next = (*frame)->next[i];
+
+  DEBUG_LOG(NETPLAY, "Rollback: re-simulating %" PRIu64 " fields",
+            m_rollback_field + 1 - (*frame)->field);
+
+  // Emulate up to the field that just ended again, without output.
+  m_resimulate_until = std::max(m_resimulate_until, m_rollback_field + 1);
+  m_rollback_field = (*frame)->field;
+  Core::SetOutputSuppressed(true);
+
+  // The snapshot that was loaded stays; the ones after it are taken again.
+  const size_t kept = static_cast<size_t>(frame.base() - m_rollback_frames.begin());
+  while (m_rollback_frames.size() > kept)
+  {
+    m_rollback_spare_frames.push_back(std::move(m_rollback_frames.back()));
+    m_rollback_frames.pop_back();
+  }
+
+  return true;
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::TakeRollbackSnapshot()
+{
+  std::unique_ptr<RollbackFrame> frame;
+  while (m_rollback_frames.size() >= GetRollbackWindow())
+  {
+    frame = std::move(m_rollback_frames.front());
+    m_rollback_frames.pop_front();
+  }
+  if (!frame && !m_rollback_spare_frames.empty())
+  {
+    frame = std::move(m_rollback_spare_frames.back());
+    m_rollback_spare_frames.pop_back();
+  }
+  if (!frame)
+    frame = std::make_unique<RollbackFrame>();
+
+  frame->field = m_rollback_field;
+  for (int i = 0; i < 4; ++i)
+    frame->next[i] = m_rollback_pads[i].next;
+  State::SaveToSnapshot(frame->snapshot);
+  m_rollback_frames.push_back(std::move(frame));
+
+  // Inputs from before the oldest snapshot are never read again. The newest confirmed one is
+  // still needed for predictions.
+  for (int i = 0; i < 4; ++i)
+  {
+    RollbackPad& pad = m_rollback_pads[i];
+    const u64 keep_from =
+        std::min(m_rollback_frames.front()->next[i], pad.received ? pad.received - 1 : 0);
+    while (pad.base < keep_from)
+    {
+      pad.inputs.pop_front();
+      ++pad.base;
+    }
+  }
+}
+
+// called from ---CPU--- thread
+void NetPlayClient::FieldUpdate()
+{
+  if (!m_rollback || !m_is_running.IsSet())
+    return;
+
+  if (!WaitForRollbackWindow())
+    return;
+
+  for (int i = 0; i < 4; ++i)
+    ReceiveRollbackInputs(i);
+
+  // A rollback restores the state from the end of an earlier field, i.e. from this point.
+  const bool mispredicted =
+      std::any_of(m_rollback_pads.begin(), m_rollback_pads.end(),
+                  [](const RollbackPad& pad) { return pad.mispredicted != UINT64_MAX; });
+  if (mispredicted && RollBack())
+    return;
+
+  ++m_rollback_field;
+  if (Core::IsOutputSuppressed() && m_rollback_field >= m_resimulate_until)
+    Core::SetOutputSuppressed(false);
+
+  TakeRollbackSnapshot();
+}
+
 // called from ---GUI--- thread
 void NetPlayClient::SendSpectatorSetting(bool spectator) {
   auto spac = std::make_unique<sf::Packet>();
@@ -1297,6 +1619,9 @@ bool NetPlayClient::StopGame()
 
   NetPlay_Disable();
 
+  ClearRollback();
+  Core::SetOutputSuppressed(false);
+
   // stop game
   dialog->StopGame();
 
@@ -1527,6 +1852,15 @@ bool NetPlay::IsNetPlayRunning()
   return netplay_client != nullptr;
 }
 
+// called from ---CPU--- thread
+void NetPlay::FieldUpdate()
+{
+  std::lock_guard<std::mutex> lk(crit_netplay_client);
+
+  if (netplay_client)
+    netplay_client->FieldUpdate();
+}
+
 void NetPlay_Enable(NetPlayClient* const np)
 {
   std::lock_guard<std::mutex> lk(crit_netplay_client);
@@ -6,6 +6,7 @@
 
 #include <SFML/Network/Packet.hpp>
 #include <array>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <string>
@@ -101,6 +102,7 @@ public:
   bool WiimoteUpdate(int _number, u8* data, const u8 size, u8 reporting_mode);
   bool GetNetPads(int pad_nb, GCPadStatus* pad_status);
   void SendNetPad(int pad_nb);
+  void FieldUpdate();
   void SendSpectatorSetting(bool spectator);
 
   void OnTraversalStateChanged() override;
@@ -126,6 +128,10 @@ public:
     if (m_pad_map[pad] <= 0)
       return 0;
 
+    // Rollback hides the latency of remote inputs, local ones are used right away.
+    if (m_rollback)
+      return 0;
+
     return std::max(m_minimum_buffer_size, m_players.at(m_pad_map.at(pad)).buffer);
   }
 
@@ -159,6 +165,11 @@ protected:
   Common::SPSCQueue<std::unique_ptr<sf::Packet>, false> m_async_queue;
 
   std::array<Common::SPSCQueue<GCPadStatus>, 4> m_pad_buffer;
+  // Number of inputs sent and received for each port, and the newest ones sent, for the
+  // redundant pad data.
+  std::array<u32, 4> m_pad_sent_count{};
+  std::array<std::deque<GCPadStatus>, 4> m_pad_sent_history;
+  std::array<u32, 4> m_pad_received_count{};
   std::array<Common::SPSCQueue<NetWiimote>, 4> m_wiimote_buffer;
 
   ENetHost* m_client = nullptr;
@@ -171,6 +182,40 @@ protected:
 
   unsigned int m_minimum_buffer_size = Config::Get(Config::NETPLAY_BUFFER_SIZE);
 
+  // Rollback mode. Inputs are numbered in the order the game reads them from each port, which is
+  // the same on every client. Remote inputs that haven't arrived yet are predicted, and a snapshot
+  // is taken every field; once a prediction turns out wrong, the newest snapshot from before it is
+  // loaded and the fields since are emulated again without output.
+  struct RollbackInput
+  {
+    GCPadStatus status;
+    bool predicted;
+  };
+
+  struct RollbackPad
+  {
+    // Inputs from index `base` on, confirmed ones followed by predictions.
+    std::deque<RollbackInput> inputs;
+    u64 base = 0;
+    // Index of the next input the game reads.
+    u64 next = 0;
+    // Number of confirmed inputs.
+    u64 received = 0;
+    // Earliest confirmed input that differed from what was predicted for it.
+    u64 mispredicted = UINT64_MAX;
+  };
+
+  struct RollbackFrame;
+
+  bool m_rollback = false;
+  std::array<RollbackPad, 4> m_rollback_pads;
+  // Oldest first. Frames that are dropped are kept in m_rollback_spare_frames, so that their
+  // snapshots only need to copy the RAM pages written since.
+  std::deque<std::unique_ptr<RollbackFrame>> m_rollback_frames;
+  std::vector<std::unique_ptr<RollbackFrame>> m_rollback_spare_frames;
+  u64 m_rollback_field = 0;
+  u64 m_resimulate_until = 0;
+
   u32 m_current_game = 0;
 
   PadMappingArray m_pad_map;
@@ -196,8 +241,15 @@ private:
 
   void UpdateDevices();
   void SendPadState(int in_game_pad, const GCPadStatus& np);
+  bool GetRollbackPad(int pad_nb, GCPadStatus* pad_status);
+  void ReceiveRollbackInputs(int pad_nb);
+  bool WaitForRollbackWindow();
+  bool RollBack();
+  void TakeRollbackSnapshot();
+  void ClearRollback();
   void SendWiimoteState(int in_game_pad, const NetWiimote& nw);
   unsigned int OnData(sf::Packet& packet);
+  void OnPadData(PadMapping map, u32 index, const GCPadStatus& pad);
   void Send(sf::Packet& packet);
   void Disconnect();
   bool Connect();
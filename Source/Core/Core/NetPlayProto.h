@@ -14,6 +14,7 @@ struct NetSettings
   bool m_CPUthread;
   int m_CPUcore;
   bool m_EnableCheats;
+  bool m_GeckoNative;
   int m_SelectedLanguage;
   bool m_OverrideGCLanguage;
   bool m_ProgressiveScan;
@@ -64,6 +65,8 @@ enum
   NP_MSG_PAD_MAPPING = 0x61,
   NP_MSG_PAD_BUFFER_MINIMUM = 0x62,
   NP_MSG_PAD_BUFFER_PLAYER = 0x63,
+  NP_MSG_PAD_DATA_REDUNDANT = 0x64,
+  NP_MSG_PAD_DATA_BATCH = 0x65,
 
   NP_MSG_WIIMOTE_DATA = 0x70,
   NP_MSG_WIIMOTE_MAPPING = 0x71,
@@ -93,6 +96,16 @@ enum
   NP_MSG_SYNC_GC_SRAM = 0xF0,
 };
 
+// Pad data is sent twice: reliably, and unsequenced on its own channel with the previous inputs
+// repeated, so that a lost packet is covered by the next one instead of waiting for ENet to
+// retransmit it. Every input carries its index, and duplicates are dropped when received.
+constexpr u8 NP_CHANNEL_REDUNDANT = 1;
+constexpr u8 NP_PAD_DATA_REDUNDANCY = 8;
+
+// Spectators (players without a pad or Wii Remote) don't need their inputs early, so they get
+// them reliably in batches of this many instead of one packet per input and two copies of each.
+constexpr u8 NP_SPECTATOR_PAD_BATCH = 8;
+
 enum
 {
   CON_ERR_SERVER_FULL = 1,
@@ -110,4 +123,6 @@ using PadMappingArray = std::array<PadMapping, 4>;
 namespace NetPlay
 {
 bool IsNetPlayRunning();
+// Called from the CPU thread at the end of every field.
+void FieldUpdate();
 }
@@ -5,6 +5,7 @@
 #include "Core/NetPlayServer.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdio>
 #include <memory>
@@ -23,7 +24,9 @@
 #include "Common/Version.h"
 #include "Core/Config/NetplaySettings.h"
 #include "Core/ConfigManager.h"
+#include "Core/Core.h"
 #include "Core/HW/Sram.h"
+#include "Core/HW/VideoInterface.h"
 #include "Core/NetPlayClient.h"  //for NetPlayUI
 #include "InputCommon/GCPadStatus.h"
 
@@ -133,6 +136,9 @@ void NetPlayServer::ThreadFunc()
       m_ping_timer.Start();
       SendToClients(spac);
       m_update_pings = false;
+
+      if (Config::Get(Config::NETPLAY_AUTO_BUFFER))
+        UpdateAutoPadBuffer();
     }
 
     ENetEvent netEvent;
@@ -548,6 +554,73 @@ void NetPlayServer::AdjustMinimumPadBufferSize(unsigned int size)
   SendAsyncToClients(std::move(spac));
 }
 
+// called from ---NETPLAY--- thread
+// Picks the smallest buffer that covers the time an input takes from one player to another
+// through the server, plus jitter. It grows as soon as that is needed, and only shrinks after
+// a few seconds of less being enough.
+void NetPlayServer::UpdateAutoPadBuffer()
+{
+  constexpr u32 SHRINK_DELAY_MS = 4000;
+
+  float latency = 0.0f;
+  {
+    std::lock_guard<std::recursive_mutex> lkp(m_crit.players);
+    for (const auto& sender : m_players)
+    {
+      const PlayerId pid = sender.second.pid;
+      const auto is_sender = [pid](PadMapping mapping) { return mapping == pid; };
+      if (sender.second.srtt < 0.0f ||
+          (std::none_of(m_pad_map.begin(), m_pad_map.end(), is_sender) &&
+           std::none_of(m_wiimote_map.begin(), m_wiimote_map.end(), is_sender)))
+      {
+        continue;
+      }
+
+      for (const auto& receiver : m_players)
+      {
+        if (receiver.second.pid == pid || receiver.second.srtt < 0.0f)
+          continue;
+
+        const float one_way = (sender.second.srtt + 4.0f * sender.second.rttvar +
+                               receiver.second.srtt + 4.0f * receiver.second.rttvar) /
+                              2.0f;
+        latency = std::max(latency, one_way);
+      }
+    }
+  }
+
+  const u32 refresh_rate = Core::IsRunning() ? VideoInterface::GetTargetRefreshRate() : 60;
+  const int units = SConfig::GetInstance().iPollingMethod == POLLING_ONSIREAD ?
+                        NetPlayClient::buffer_accuracy :
+                        1;
+  const unsigned int target =
+      static_cast<unsigned int>(std::ceil(latency * refresh_rate / 1000.0f * units));
+
+  std::lock_guard<std::recursive_mutex> lkg(m_crit.game);
+  if (target > m_minimum_buffer_size)
+  {
+    m_auto_buffer_lower_since = 0;
+    AdjustMinimumPadBufferSize(target);
+  }
+  else if (target < m_minimum_buffer_size)
+  {
+    const u32 now = Common::Timer::GetTimeMs();
+    if (m_auto_buffer_lower_since == 0)
+    {
+      m_auto_buffer_lower_since = now;
+    }
+    else if (now - m_auto_buffer_lower_since >= SHRINK_DELAY_MS)
+    {
+      m_auto_buffer_lower_since = now;
+      AdjustMinimumPadBufferSize(m_minimum_buffer_size - 1);
+    }
+  }
+  else
+  {
+    m_auto_buffer_lower_since = 0;
+  }
+}
+
 void NetPlayServer::SendAsyncToClients(sf::Packet&& packet)
 {
   {
@@ -642,9 +715,10 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
       break;
 
     PadMapping map = 0;
+    u32 index = 0;
     GCPadStatus pad;
-    packet >> map >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >>
-      pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight >> pad.isConnected;
+    packet >> map >> index >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >>
+      pad.stickY >> pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
 
     // If the data is not from the correct player,
     // then disconnect them.
@@ -656,11 +730,47 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
     // Relay to clients
     sf::Packet spac;
     spac << (MessageId)NP_MSG_PAD_DATA;
-    spac << map << pad.button << pad.analogA << pad.analogB << pad.stickX << pad.stickY
-      << pad.substickX << pad.substickY << pad.triggerLeft << pad.triggerRight
-      << pad.isConnected;
+    spac << map << index << pad.button << pad.analogA << pad.analogB << pad.stickX << pad.stickY
+      << pad.substickX << pad.substickY << pad.triggerLeft << pad.triggerRight;
 
-    SendToClients(spac, player.pid);
+    SendToClients(spac, player.pid, true);
+    RelayPadDataToSpectators(map, index, pad);
+  }
+  break;
+
+  case NP_MSG_PAD_DATA_REDUNDANT:
+  {
+    // if this is pad data from the last game still being received, ignore it
+    if (player.current_game != m_current_game)
+      break;
+
+    PadMapping map = 0;
+    u32 first_index = 0;
+    u8 count = 0;
+    packet >> map >> first_index >> count;
+
+    // If the data is not from the correct player,
+    // then disconnect them.
+    if (m_pad_map.at(map) != player.pid || count > NP_PAD_DATA_REDUNDANCY)
+    {
+      return 1;
+    }
+
+    // Relay to clients
+    sf::Packet spac;
+    spac << (MessageId)NP_MSG_PAD_DATA_REDUNDANT;
+    spac << map << first_index << count;
+    for (u32 i = 0; i < count; ++i)
+    {
+      GCPadStatus pad;
+      packet >> pad.button >> pad.analogA >> pad.analogB >> pad.stickX >> pad.stickY >>
+        pad.substickX >> pad.substickY >> pad.triggerLeft >> pad.triggerRight;
+      spac << pad.button << pad.analogA << pad.analogB << pad.stickX << pad.stickY
+        << pad.substickX << pad.substickY << pad.triggerLeft << pad.triggerRight;
+    }
+
+    if (packet)
+      SendToClients(spac, player.pid, true);
   }
   break;
 
@@ -707,6 +817,22 @@ unsigned int NetPlayServer::OnData(sf::Packet& packet, Client& player)
       player.ping = ping;
     }
 
+    // The key is the time the ping was sent, so late replies still count for the estimate.
+    const u32 rtt = Common::Timer::GetTimeMs() - ping_key;
+    if (rtt < 5000)
+    {
+      if (player.srtt < 0.0f)
+      {
+        player.srtt = static_cast<float>(rtt);
+        player.rttvar = rtt / 2.0f;
+      }
+      else
+      {
+        player.rttvar += (std::abs(player.srtt - rtt) - player.rttvar) / 4.0f;
+        player.srtt += (rtt - player.srtt) / 8.0f;
+      }
+    }
+
     sf::Packet spac;
     spac << (MessageId)NP_MSG_PLAYER_PING_DATA;
     spac << player.pid;
@@ -938,6 +1064,7 @@ bool NetPlayServer::StartGame()
   spac << m_settings.m_CPUthread;
   spac << m_settings.m_CPUcore;
   spac << m_settings.m_EnableCheats;
+  spac << m_settings.m_GeckoNative;
   spac << m_settings.m_SelectedLanguage;
   spac << m_settings.m_OverrideGCLanguage;
   spac << m_settings.m_ProgressiveScan;
@@ -961,22 +1088,67 @@ bool NetPlayServer::StartGame()
 }
 
 // called from multiple threads
-void NetPlayServer::SendToClients(const sf::Packet& packet, const PlayerId skip_pid)
+void NetPlayServer::SendToClients(const sf::Packet& packet, const PlayerId skip_pid,
+                                  const bool skip_spectators)
 {
   for (auto& p : m_players)
   {
-    if (p.second.pid && p.second.pid != skip_pid)
+    if (p.second.pid && p.second.pid != skip_pid &&
+        !(skip_spectators && IsSpectator(p.second.pid)))
     {
       Send(p.second.socket, packet);
     }
   }
 }
 
+bool NetPlayServer::IsSpectator(PlayerId pid) const
+{
+  return std::find(m_pad_map.begin(), m_pad_map.end(), pid) == m_pad_map.end() &&
+         std::find(m_wiimote_map.begin(), m_wiimote_map.end(), pid) == m_wiimote_map.end();
+}
+
+void NetPlayServer::RelayPadDataToSpectators(PadMapping map, u32 index, const GCPadStatus& pad)
+{
+  std::vector<GCPadStatus>& batch = m_spectator_pad_batch.at(map);
+
+  // Inputs arrive in order, a gap means a new game started.
+  if (batch.empty() || index != m_spectator_pad_batch_index[map] + batch.size())
+  {
+    batch.clear();
+    m_spectator_pad_batch_index[map] = index;
+  }
+  batch.push_back(pad);
+  if (batch.size() < NP_SPECTATOR_PAD_BATCH)
+    return;
+
+  sf::Packet spac;
+  spac << (MessageId)NP_MSG_PAD_DATA_BATCH;
+  spac << map << m_spectator_pad_batch_index[map] << static_cast<u8>(batch.size());
+  for (const GCPadStatus& p : batch)
+  {
+    spac << p.button << p.analogA << p.analogB << p.stickX << p.stickY << p.substickX
+         << p.substickY << p.triggerLeft << p.triggerRight;
+  }
+  batch.clear();
+
+  for (auto& p : m_players)
+  {
+    if (p.second.pid && IsSpectator(p.second.pid))
+      Send(p.second.socket, spac);
+  }
+}
+
 void NetPlayServer::Send(ENetPeer* socket, const sf::Packet& packet)
 {
-  ENetPacket* epac =
-    enet_packet_create(packet.getData(), packet.getDataSize(), ENET_PACKET_FLAG_RELIABLE);
-  enet_peer_send(socket, 0, epac);
+  const bool redundant = packet.getDataSize() > 0 &&
+                         *static_cast<const u8*>(packet.getData()) == NP_MSG_PAD_DATA_REDUNDANT;
+  ENetPacket* epac = enet_packet_create(
+    packet.getData(), packet.getDataSize(),
+    redundant ? ENET_PACKET_FLAG_UNSEQUENCED : ENET_PACKET_FLAG_RELIABLE);
+  enet_peer_send(socket, redundant && socket->channelCount > NP_CHANNEL_REDUNDANT ?
+                           NP_CHANNEL_REDUNDANT :
+                           0,
+                 epac);
 }
 
 void NetPlayServer::KickPlayer(PlayerId player)
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <SFML/Network/Packet.hpp>
+#include <array>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -13,6 +14,7 @@
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include "Common/QoSSession.h"
 #include "Common/SPSCQueue.h"
 #include "Common/Timer.h"
@@ -81,6 +83,10 @@ private:
 
     unsigned int buffer = 0;
 
+    // Smoothed round-trip time and its mean deviation, in ms (as in RFC 6298).
+    float srtt = -1.0f;
+    float rttvar = 0.0f;
+
 #ifdef _WIN32
     HANDLE qos_handle;
     QOS_FLOWID qos_flow_id;
@@ -91,7 +97,10 @@ private:
     bool operator==(const Client& other) const { return this == &other; }
   };
 
-  void SendToClients(const sf::Packet& packet, const PlayerId skip_pid = 0);
+  void SendToClients(const sf::Packet& packet, const PlayerId skip_pid = 0,
+                     const bool skip_spectators = false);
+  bool IsSpectator(PlayerId pid) const;
+  void RelayPadDataToSpectators(PadMapping map, u32 index, const GCPadStatus& pad);
   void Send(ENetPeer* socket, const sf::Packet& packet);
   unsigned int OnConnect(ENetPeer* socket);
   unsigned int OnDisconnect(const Client& player);
@@ -102,6 +111,7 @@ private:
   void OnConnectFailed(u8) override {}
   void UpdatePadMapping();
   void UpdateWiimoteMapping();
+  void UpdateAutoPadBuffer();
   std::vector<std::pair<std::string, std::string>> GetInterfaceListInternal() const;
 
   NetSettings m_settings;
@@ -113,9 +123,14 @@ private:
   bool m_update_pings = false;
   u32 m_current_game = 0;
   unsigned int m_minimum_buffer_size = 0;
+  u32 m_auto_buffer_lower_since = 0;
   PadMappingArray m_pad_map;
   PadMappingArray m_wiimote_map;
 
+  // Inputs waiting to be sent to spectators, and the index of the first one.
+  std::array<std::vector<GCPadStatus>, 4> m_spectator_pad_batch;
+  std::array<u32, 4> m_spectator_pad_batch_index{};
+
   std::map<PlayerId, Client> m_players;
 
   std::unordered_map<u32, std::vector<std::pair<PlayerId, u64>>> m_timebase_by_frame;
@@ -31,19 +31,17 @@ const char* PatchTypeStrings[] = {
     "byte", "word", "dword",
 };
 
-static std::vector<Patch> onFrame;
+// The entries of the enabled OnFrame patches, flattened once when the patches are loaded.
+static std::vector<PatchEntry> s_frame_writes;
+// Entries of the music off code, only written while netplay has the music turned off.
+static std::vector<PatchEntry> s_music_off_writes;
 static std::map<u32, int> speedHacks;
 
-static bool IsEnabledMusicCode(const Patch& patch)
+static const char MUSIC_OFF_CODE_NAME[] = "[P+] Music Off";
+
+static bool IsMusicOff()
 {
-  if (NetPlay::IsNetPlayRunning() && NetPlayDialog::GetInstance()->IsMusicOff() && patch.name == "[P+] Music Off")
-  {
-    return true;
-  }
-  else
-  {
-    return false;
-  }
+  return NetPlay::IsNetPlayRunning() && NetPlayDialog::GetInstance()->IsMusicOff();
 }
 
 static bool IsDisabledMusicCode(const Patch& patch)
@@ -163,13 +161,29 @@ int GetSpeedhackCycles(const u32 addr)
     return iter->second;
 }
 
+static void CompilePatches(const std::vector<Patch>& patches)
+{
+  s_frame_writes.clear();
+  s_music_off_writes.clear();
+  for (const Patch& patch : patches)
+  {
+    if (patch.active && !IsDisabledMusicCode(patch))
+      s_frame_writes.insert(s_frame_writes.end(), patch.entries.begin(), patch.entries.end());
+    else if (patch.name == MUSIC_OFF_CODE_NAME)
+      s_music_off_writes.insert(s_music_off_writes.end(), patch.entries.begin(),
+                                patch.entries.end());
+  }
+}
+
 void LoadPatches()
 {
   IniFile merged = SConfig::GetInstance().LoadGameIni();
   IniFile globalIni = SConfig::GetInstance().LoadDefaultGameIni();
   IniFile localIni = SConfig::GetInstance().LoadLocalGameIni();
 
-  LoadPatchSection("OnFrame", onFrame, globalIni, localIni);
+  std::vector<Patch> on_frame;
+  LoadPatchSection("OnFrame", on_frame, globalIni, localIni);
+  CompilePatches(on_frame);
   ActionReplay::LoadAndApplyCodes(globalIni, localIni);
 
   Gecko::SetActiveCodes(Gecko::LoadCodes(globalIni, localIni));
@@ -177,32 +191,26 @@ void LoadPatches()
   LoadSpeedhacks("Speedhacks", merged);
 }
 
-static void ApplyPatches(const std::vector<Patch>& patches)
+static void ApplyPatches(const std::vector<PatchEntry>& entries)
 {
-  for (const Patch& patch : patches)
+  for (const PatchEntry& entry : entries)
   {
-    if (patch.active && !IsDisabledMusicCode(patch) || IsEnabledMusicCode(patch))
+    u32 addr = entry.address;
+    u32 value = entry.value;
+    switch (entry.type)
     {
-      for (const PatchEntry& entry : patch.entries)
-      {
-        u32 addr = entry.address;
-        u32 value = entry.value;
-        switch (entry.type)
-        {
-        case PATCH_8BIT:
-          PowerPC::HostWrite_U8((u8)value, addr);
-          break;
-        case PATCH_16BIT:
-          PowerPC::HostWrite_U16((u16)value, addr);
-          break;
-        case PATCH_32BIT:
-          PowerPC::HostWrite_U32(value, addr);
-          break;
-        default:
-          // unknown patchtype
-          break;
-        }
-      }
+    case PATCH_8BIT:
+      PowerPC::HostWrite_U8((u8)value, addr);
+      break;
+    case PATCH_16BIT:
+      PowerPC::HostWrite_U16((u16)value, addr);
+      break;
+    case PATCH_32BIT:
+      PowerPC::HostWrite_U32(value, addr);
+      break;
+    default:
+      // unknown patchtype
+      break;
     }
   }
 }
@@ -246,7 +254,9 @@ bool ApplyFramePatches()
     return false;
   }
 
-  ApplyPatches(onFrame);
+  ApplyPatches(s_frame_writes);
+  if (!s_music_off_writes.empty() && IsMusicOff())
+    ApplyPatches(s_music_off_writes);
 
   // Run the Gecko code handler
   Gecko::RunCodeHandler();
@@ -257,7 +267,8 @@ bool ApplyFramePatches()
 
 void Shutdown()
 {
-  onFrame.clear();
+  s_frame_writes.clear();
+  s_music_off_writes.clear();
   speedHacks.clear();
   ActionReplay::ApplyCodes({});
   Gecko::Shutdown();
@@ -234,6 +234,8 @@ bool TMemCheck::Action(DebugInterface* debug_interface, u32 value, u32 addr, boo
 {
   if ((write && is_break_on_write) || (!write && is_break_on_read))
   {
+    if (on_hit)
+      on_hit(addr, value, size, write);
     if (log_on_hit)
     {
       NOTICE_LOG(MEMMAP, "MBP %08x (%s) %s%zu %0*x at %08x (%s)", pc,
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -34,6 +35,9 @@ struct TMemCheck
 
   u32 num_hits = 0;
 
+  // Called on every hit (before a write takes effect), e.g. for the memory watcher.
+  std::function<void(u32 address, u32 value, size_t size, bool write)> on_hit;
+
   // returns whether to break
   bool Action(DebugInterface* dbg_interface, u32 value, u32 addr, bool write, size_t size, u32 pc);
 };
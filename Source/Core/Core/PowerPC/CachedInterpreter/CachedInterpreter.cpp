@@ -4,6 +4,7 @@
 
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
 
+#include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
@@ -11,14 +12,28 @@
 #include "Core/HLE/HLE.h"
 #include "Core/HW/CPU.h"
 #include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
 #include "Core/PowerPC/Jit64Common/Jit64Base.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PowerPC.h"
 
 struct CachedInterpreter::Instruction
 {
+  // The fields of an instruction, extracted when the block is compiled. Fused pairs keep the
+  // second instruction's registers in d2/a2 and its immediate in imm2.
+  struct Operands
+  {
+    u32 imm;
+    u16 imm2;
+    u8 d;
+    u8 a;
+    u8 d2;
+    u8 a2;
+  };
+
   using CommonCallback = void (*)(UGeckoInstruction);
   using ConditionalCallback = bool (*)(u32);
+  using DecodedCallback = void (*)(const Operands&);
 
   Instruction() {}
   Instruction(const CommonCallback c, UGeckoInstruction i)
@@ -31,20 +46,31 @@ struct CachedInterpreter::Instruction
   {
   }
 
+  Instruction(const DecodedCallback c, const Operands& o)
+      : decoded_callback(c), operands(o), type(Type::Decoded)
+  {
+  }
+
   enum class Type
   {
     Abort,
     Common,
     Conditional,
+    Decoded,
   };
 
   union
   {
     const CommonCallback common_callback;
     const ConditionalCallback conditional_callback;
+    const DecodedCallback decoded_callback;
   };
 
-  u32 data = 0;
+  union
+  {
+    u32 data = 0;
+    Operands operands;
+  };
   Type type = Type::Abort;
 };
 
@@ -102,6 +128,10 @@ void CachedInterpreter::ExecuteOneBlock()
         return;
       break;
 
+    case Instruction::Type::Decoded:
+      code->decoded_callback(code->operands);
+      break;
+
     default:
       ERROR_LOG(POWERPC, "Unknown CachedInterpreter Instruction: %d", code->type);
       break;
@@ -172,6 +202,143 @@ static bool CheckDSI(u32 data)
   return false;
 }
 
+using Instruction = CachedInterpreter::Instruction;
+using Operands = Instruction::Operands;
+
+static void Li(const Operands& op)
+{
+  rGPR[op.d] = op.imm;
+}
+
+static void Addi(const Operands& op)
+{
+  rGPR[op.d] = rGPR[op.a] + op.imm;
+}
+
+static void Ori(const Operands& op)
+{
+  rGPR[op.d] = rGPR[op.a] | op.imm;
+}
+
+static void Rlwinm(const Operands& op)
+{
+  rGPR[op.d] = _rotl(rGPR[op.a], op.imm2) & op.imm;
+}
+
+static void Lwz(const Operands& op)
+{
+  const u32 temp = PowerPC::Read_U32(rGPR[op.a] + op.imm);
+  if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
+    rGPR[op.d] = temp;
+}
+
+static void Stw(const Operands& op)
+{
+  PowerPC::Write_U32(rGPR[op.d], rGPR[op.a] + op.imm);
+}
+
+template <typename T>
+static void Compare(u32 field, T a, T b)
+{
+  u32 flags = a < b ? 0x8 : a > b ? 0x4 : 0x2;
+  if (PowerPC::GetXER_SO())
+    flags |= 0x1;
+  PowerPC::SetCRField(field, flags);
+}
+
+static void Cmpi(const Operands& op)
+{
+  Compare<s32>(op.d, rGPR[op.a], op.imm);
+}
+
+static void Cmpli(const Operands& op)
+{
+  Compare<u32>(op.d, rGPR[op.a], op.imm);
+}
+
+// Fused pairs. Loading through a pointer and then advancing it is the usual loop body, comparing
+// right before a conditional branch is the usual loop end.
+static void LwzAddi(const Operands& op)
+{
+  Lwz(op);
+  rGPR[op.d2] = rGPR[op.a2] + static_cast<s16>(op.imm2);
+}
+
+static void CmpiBc(const Operands& op)
+{
+  Compare<s32>(op.d, rGPR[op.a], static_cast<s16>(op.imm2));
+  Interpreter::bcx(UGeckoInstruction(op.imm));
+}
+
+static void CmpliBc(const Operands& op)
+{
+  Compare<u32>(op.d, rGPR[op.a], op.imm2);
+  Interpreter::bcx(UGeckoInstruction(op.imm));
+}
+
+// Returns the pre-decoded handler for inst, or nullptr if it has none.
+static Instruction::DecodedCallback Decode(UGeckoInstruction inst, Operands* op)
+{
+  *op = {};
+  switch (inst.OPCD)
+  {
+  case 10:  // cmpli
+    if (inst.L)
+      return nullptr;
+    *op = {inst.UIMM, 0, static_cast<u8>(inst.CRFD), static_cast<u8>(inst.RA)};
+    return Cmpli;
+  case 11:  // cmpi
+    if (inst.L)
+      return nullptr;
+    *op = {static_cast<u32>(inst.SIMM_16), 0, static_cast<u8>(inst.CRFD), static_cast<u8>(inst.RA)};
+    return Cmpi;
+  case 14:  // addi
+  case 15:  // addis
+    op->imm = inst.OPCD == 15 ? static_cast<u32>(inst.SIMM_16) << 16 : inst.SIMM_16;
+    op->d = inst.RD;
+    op->a = inst.RA;
+    return inst.RA ? Addi : Li;
+  case 21:  // rlwinmx
+    if (inst.Rc)
+      return nullptr;
+    *op = {Helper_Mask(inst.MB, inst.ME), static_cast<u16>(inst.SH), static_cast<u8>(inst.RA),
+           static_cast<u8>(inst.RS)};
+    return Rlwinm;
+  case 24:  // ori
+    *op = {inst.UIMM, 0, static_cast<u8>(inst.RA), static_cast<u8>(inst.RS)};
+    return Ori;
+  case 32:  // lwz
+  case 36:  // stw
+    if (!inst.RA)
+      return nullptr;
+    *op = {static_cast<u32>(inst.SIMM_16), 0, static_cast<u8>(inst.RD), static_cast<u8>(inst.RA)};
+    return inst.OPCD == 32 ? Lwz : Stw;
+  default:
+    return nullptr;
+  }
+}
+
+// Returns the handler for first and second run together, or nullptr if the pair has none.
+// second must be the next instruction and have nothing of its own emitted in front of it.
+static Instruction::DecodedCallback DecodePair(UGeckoInstruction first, UGeckoInstruction second,
+                                               Operands* op)
+{
+  if (first.OPCD == 32 && first.RA && second.OPCD == 14 && second.RA)
+  {
+    *op = {static_cast<u32>(first.SIMM_16), static_cast<u16>(second.SIMM_16),
+           static_cast<u8>(first.RD), static_cast<u8>(first.RA), static_cast<u8>(second.RD),
+           static_cast<u8>(second.RA)};
+    return LwzAddi;
+  }
+  if ((first.OPCD == 10 || first.OPCD == 11) && !first.L && second.OPCD == 16)
+  {
+    *op = {second.hex, static_cast<u16>(first.UIMM), static_cast<u8>(first.CRFD),
+           static_cast<u8>(first.RA)};
+    return first.OPCD == 10 ? CmpliBc : CmpiBc;
+  }
+  return nullptr;
+}
+
 void CachedInterpreter::Jit(u32 address)
 {
   if (m_code.size() >= CODE_SIZE / sizeof(Instruction) - 0x1000 ||
@@ -242,9 +409,35 @@ void CachedInterpreter::Jit(u32 address)
         js.firstFPInstructionFound = true;
       }
 
+      // Fusing skips the HLE hook, FPU check and memory check of the second instruction, and
+      // the memory check of the first.
+      Instruction::Operands operands;
+      Instruction::DecodedCallback fused = nullptr;
+      if (i + 1 < code_block.m_num_instructions && !endblock && !memcheck && !ops[i + 1].skip &&
+          !(ops[i + 1].opinfo->flags & FL_USE_FPU) &&
+          HLE::GetFirstFunctionIndex(ops[i + 1].address) == 0)
+      {
+        fused = DecodePair(ops[i].inst, ops[i + 1].inst, &operands);
+      }
+      if (fused)
+      {
+        i++;
+        js.downcountAmount += ops[i].opinfo->numCycles;
+        endblock = (ops[i].opinfo->flags & FL_ENDBLOCK) != 0;
+        if (endblock)
+          m_code.emplace_back(WritePC, ops[i].address);
+        m_code.emplace_back(fused, operands);
+        if (endblock)
+          m_code.emplace_back(EndBlock, js.downcountAmount);
+        continue;
+      }
+
       if (endblock || memcheck)
         m_code.emplace_back(WritePC, ops[i].address);
-      m_code.emplace_back(PPCTables::GetInterpreterOp(ops[i].inst), ops[i].inst);
+      if (const Instruction::DecodedCallback decoded = Decode(ops[i].inst, &operands))
+        m_code.emplace_back(decoded, operands);
+      else
+        m_code.emplace_back(PPCTables::GetInterpreterOp(ops[i].inst), ops[i].inst);
       if (memcheck)
         m_code.emplace_back(CheckDSI, js.downcountAmount);
       if (endblock)
@@ -31,9 +31,10 @@ public:
   JitBaseBlockCache* GetBlockCache() override { return &m_block_cache; }
   const char* GetName() const override { return "Cached Interpreter"; }
   const CommonAsmRoutinesBase* GetAsmRoutines() override { return nullptr; }
-private:
   struct Instruction;
 
+private:
+
   const u8* GetCodePtr() const;
   void ExecuteOneBlock();
 
@@ -349,6 +349,7 @@ void Interpreter::dcbf(UGeckoInstruction inst)
   // the lack of precise L1 icache emulation in the JIT. (Portable software
   // should use icbi consistently, but games aren't portable.)
   const u32 address = Helper_Get_EA_X(inst);
+  PowerPC::FlushCacheLine(address);
   JitInterface::InvalidateICache(address & ~0x1f, 32, false);
 }
 
@@ -361,6 +362,7 @@ void Interpreter::dcbi(UGeckoInstruction inst)
   // the lack of precise L1 icache emulation in the JIT. (Portable software
   // should use icbi consistently, but games aren't portable.)
   const u32 address = Helper_Get_EA_X(inst);
+  PowerPC::InvalidateCacheLine(address);
   JitInterface::InvalidateICache(address & ~0x1f, 32, false);
 }
 
@@ -373,6 +375,7 @@ void Interpreter::dcbst(UGeckoInstruction inst)
   // the lack of precise L1 icache emulation in the JIT. (Portable software
   // should use icbi consistently, but games aren't portable.)
   const u32 address = Helper_Get_EA_X(inst);
+  PowerPC::StoreCacheLine(address);
   JitInterface::InvalidateICache(address & ~0x1f, 32, false);
 }
 
@@ -11,6 +11,7 @@
 #include "Common/FPURoundMode.h"
 #include "Common/Logging/Log.h"
 #include "Core/HW/GPFifo.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/PowerPC/Interpreter/Interpreter_FPUtils.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -164,6 +165,8 @@ static void SetSR(int index, u32 value)
 {
   DEBUG_LOG(POWERPC, "%08x: MMU: Segment register %i set to %08x", PowerPC::ppcState.pc, index,
             value);
+  if (PowerPC::ppcState.sr[index] != value)
+    Memory::ClearPageTableMappings();
   PowerPC::ppcState.sr[index] = value;
 }
 
@@ -283,6 +286,12 @@ void Interpreter::mtspr(UGeckoInstruction inst)
       // most games do it only once during initialization
       PowerPC::ppcState.iCache.Reset();
     }
+    if (HID0.DCFI)
+    {
+      HID0.DCFI = 0;
+      INFO_LOG(POWERPC, "Flash Invalidate Data Cache! DCE=%d", (int)HID0.DCE);
+      PowerPC::ppcState.dCache.Reset();
+    }
   }
   break;
   case SPR_HID2:  // HID2
@@ -4,7 +4,9 @@
 
 #include "Core/PowerPC/Jit64/Jit.h"
 
+#include <algorithm>
 #include <map>
+#include <numeric>
 #include <string>
 
 // for the PROFILER stuff
@@ -14,6 +16,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
+#include "Common/JitRegister.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/PerformanceCounter.h"
@@ -25,6 +28,7 @@
 #include "Core/HW/CPU.h"
 #include "Core/HW/GPFifo.h"
 #include "Core/HW/ProcessorInterface.h"
+#include "Core/MachineContext.h"
 #include "Core/PatchEngine.h"
 #include "Core/PowerPC/Jit64/JitAsm.h"
 #include "Core/PowerPC/Jit64/JitRegCache.h"
@@ -41,6 +45,12 @@
 using namespace Gen;
 using namespace PowerPC;
 
+// Runs before a block is recompiled as a superblock. Most of the time of CPU-bound games goes to
+// a small number of blocks, which pass this quickly.
+static constexpr u32 TIER_UP_RUN_COUNT = 10000;
+// Guest registers kept in host registers around a loop. The rest are left to the loop body.
+static constexpr size_t MAX_LOOP_REGS = 4;
+
 // Dolphin's PowerPC->x86_64 JIT dynamic recompiler
 // Written mostly by ector (hrydgard)
 // Features:
@@ -205,7 +215,16 @@ bool Jit64::HandleFault(uintptr_t access_address, SContext* ctx)
   if (m_enable_blr_optimization && diff >= GUARD_OFFSET && diff < GUARD_OFFSET + GUARD_SIZE)
     return HandleStackFault();
 
-  return Jitx86Base::HandleFault(access_address, ctx);
+  if (!IsHotCode(reinterpret_cast<const u8*>(ctx->CTX_PC)))
+    return Jitx86Base::HandleFault(access_address, ctx);
+
+  // The trampolines of hot blocks live in the hot region, so they go away together.
+  u8* const trampolines_ptr = trampolines.GetWritableCodePtr();
+  trampolines.SetCodePtr(m_hot_trampolines_ptr);
+  const bool handled = Jitx86Base::HandleFault(access_address, ctx);
+  m_hot_trampolines_ptr = trampolines.GetWritableCodePtr();
+  trampolines.SetCodePtr(trampolines_ptr);
+  return handled;
 }
 
 void Jit64::Init()
@@ -222,15 +241,23 @@ void Jit64::Init()
   gpr.SetEmitter(this);
   fpr.SetEmitter(this);
 
+  // Everything has to stay within rel32 range of the asm routines and the constant pool.
+  const size_t code_scale =
+      std::min(std::max(SConfig::GetInstance().iJITCodeCacheSize, 32), 256) / 32;
+  const size_t code_size = CODE_SIZE * code_scale;
   const size_t routines_size = asm_routines.CODE_SIZE;
-  const size_t trampolines_size = jo.memcheck ? TRAMPOLINE_CODE_SIZE_MMU : TRAMPOLINE_CODE_SIZE;
-  const size_t farcode_size = jo.memcheck ? FARCODE_SIZE_MMU : FARCODE_SIZE;
+  const size_t trampolines_size =
+      (jo.memcheck ? TRAMPOLINE_CODE_SIZE_MMU : TRAMPOLINE_CODE_SIZE) * code_scale;
+  const size_t farcode_size = (jo.memcheck ? FARCODE_SIZE_MMU : FARCODE_SIZE) * code_scale;
   const size_t constpool_size = m_const_pool.CONST_POOL_SIZE;
-  AllocCodeSpace(CODE_SIZE + routines_size + trampolines_size + farcode_size + constpool_size);
+  AllocCodeSpace(code_size + routines_size + trampolines_size + farcode_size + constpool_size);
+  if (SConfig::GetInstance().bHugePages)
+    Common::AdviseHugePages(region, total_region_size);
   AddChildCodeSpace(&asm_routines, routines_size);
   AddChildCodeSpace(&trampolines, trampolines_size);
   AddChildCodeSpace(&m_far_code, farcode_size);
   m_const_pool.Init(AllocChildCodeSpace(constpool_size), constpool_size);
+  ResetHotRegion();
 
   // BLR optimization has the same consequences as block linking, as well as
   // depending on the fault handler to be safe in the event of excessive BL.
@@ -266,6 +293,70 @@ void Jit64::ClearCache()
   ClearCodeSpace();
   Clear();
   UpdateMemoryOptions();
+  m_code_region = 0;
+  ResetHotRegion();
+}
+
+u8* Jit64::CodeRegionStart(const Gen::X64CodeBlock& space, size_t index)
+{
+  return space.GetRegionStart() + space.GetRegionSize() / (CODE_REGIONS + 1) * index;
+}
+
+bool Jit64::IsRegionFull(size_t index, const u8* near_ptr, const u8* far_ptr,
+                         const u8* trampolines_ptr) const
+{
+  // Same margin as IsAlmostFull(), bigger than the biggest block ever.
+  constexpr size_t MIN_SPACE_LEFT = 0x10000;
+  return static_cast<size_t>(CodeRegionStart(*this, index + 1) - near_ptr) < MIN_SPACE_LEFT ||
+         static_cast<size_t>(CodeRegionStart(m_far_code, index + 1) - far_ptr) <
+             MIN_SPACE_LEFT ||
+         static_cast<size_t>(CodeRegionStart(trampolines, index + 1) - trampolines_ptr) <
+             MIN_SPACE_LEFT;
+}
+
+bool Jit64::IsCodeRegionFull() const
+{
+  return IsRegionFull(m_code_region, GetCodePtr(), m_far_code.GetCodePtr(),
+                      trampolines.GetCodePtr());
+}
+
+void Jit64::EvictCodeRegion()
+{
+  m_code_region = (m_code_region + 1) % CODE_REGIONS;
+  u8* const begin = CodeRegionStart(*this, m_code_region);
+  u8* const end = CodeRegionStart(*this, m_code_region + 1);
+
+  // Only the oldest blocks go, their callers fall back to the dispatcher. Blocks that were hot
+  // before are recompiled with the tier-2 options right away.
+  const size_t evicted = blocks.EraseCodeRange(begin, end);
+  ClearBackPatchInfo(begin, end);
+  SetCodePtr(begin);
+  m_far_code.SetCodePtr(CodeRegionStart(m_far_code, m_code_region));
+  trampolines.SetCodePtr(CodeRegionStart(trampolines, m_code_region));
+  INFO_LOG(DYNA_REC, "JIT code space full, evicted %zu blocks from region %zu", evicted,
+           m_code_region);
+}
+
+void Jit64::ResetHotRegion()
+{
+  m_hot_code_ptr = CodeRegionStart(*this, HOT_REGION);
+  m_hot_far_code_ptr = CodeRegionStart(m_far_code, HOT_REGION);
+  m_hot_trampolines_ptr = CodeRegionStart(trampolines, HOT_REGION);
+}
+
+void Jit64::ClearHotRegion()
+{
+  u8* const begin = CodeRegionStart(*this, HOT_REGION);
+  u8* const end = CodeRegionStart(*this, HOT_REGION + 1);
+  const size_t evicted = blocks.EraseCodeRange(begin, end);
+  ClearBackPatchInfo(begin, end);
+  ResetHotRegion();
+  INFO_LOG(DYNA_REC, "JIT hot region full, evicted %zu blocks", evicted);
+}
+
+bool Jit64::IsHotCode(const u8* ptr) const
+{
+  return ptr >= CodeRegionStart(*this, HOT_REGION) && ptr < CodeRegionStart(*this, HOT_REGION + 1);
 }
 
 void Jit64::Shutdown()
@@ -429,6 +520,115 @@ void Jit64::WriteExit(u32 destination, bool bl, u32 after)
   JustWriteExit(destination, bl, after);
 }
 
+void Jit64::FlushAndWriteExit(u32 destination, bool bl, u32 after, RegCache::FlushMode mode)
+{
+  // Going around an idle loop again wouldn't change anything until the next event.
+  if (code_block.m_idle_loop && destination == js.blockStart && !bl && !CPU::IsStepping() &&
+      !SConfig::GetInstance().bEnableDebugging)
+  {
+    gpr.Flush(mode);
+    fpr.Flush(mode);
+    ABI_PushRegistersAndAdjustStack({}, 0);
+    ABI_CallFunction(CoreTiming::Idle);
+    ABI_PopRegistersAndAdjustStack({}, 0);
+    MOV(32, PPCSTATE(pc), Imm32(destination));
+    WriteExceptionExit();
+    return;
+  }
+
+  if (CanWriteLoopExit(destination, bl))
+  {
+    WriteLoopExit();
+    return;
+  }
+
+  gpr.Flush(mode);
+  fpr.Flush(mode);
+  WriteExit(destination, bl, after);
+}
+
+void Jit64::SetUpLoopEntry(const PPCAnalyst::CodeOp* ops)
+{
+  m_loop_entry = nullptr;
+  m_loop_regs = BitSet32(0);
+
+  // Unlinked blocks have to go through the dispatcher, and the loop entry can't bring back the
+  // speculative constants.
+  if (!jo.enableBlocklink || SConfig::GetInstance().bEnableDebugging)
+    return;
+  for (size_t i = 0; i < 32; i++)
+  {
+    if (gpr.R(i).IsImm())
+      return;
+  }
+
+  const auto branches_to_start = [this](const PPCAnalyst::CodeOp& op) {
+    const UGeckoInstruction inst = op.inst;
+    if (op.skip || inst.LK)
+      return false;
+    if (inst.OPCD == 18)
+      return SignExt26(inst.LI << 2) + (inst.AA ? 0 : op.address) == js.blockStart;
+    if (inst.OPCD == 16)
+      return SignExt16(inst.BD << 2) + (inst.AA ? 0 : op.address) == js.blockStart;
+    return false;
+  };
+  if (std::none_of(ops, ops + code_block.m_num_instructions, branches_to_start))
+    return;
+
+  // The loop entry expects the registers to be dirty, so every other exit writes them back.
+  std::array<int, 32> regs;
+  std::iota(regs.begin(), regs.end(), 0);
+  std::stable_sort(regs.begin(), regs.end(), [this](int a, int b) {
+    return code_block.m_gpa->GetTotalNumAccesses(a) > code_block.m_gpa->GetTotalNumAccesses(b);
+  });
+  for (int reg : regs)
+  {
+    if (m_loop_regs.Count() == MAX_LOOP_REGS || !code_block.m_gpa->numReads[reg])
+      break;
+    gpr.BindToRegister(reg, true, true);
+    m_loop_xregs[reg] = gpr.RX(reg);
+    m_loop_regs[reg] = true;
+  }
+  if (m_loop_regs)
+    m_loop_entry = GetCodePtr();
+}
+
+bool Jit64::CanWriteLoopExit(u32 destination, bool bl) const
+{
+  // Cleanup() would call functions with the loop registers loaded.
+  return m_loop_entry && destination == js.blockStart && !bl &&
+         !(jo.optimizeGatherPipe && js.fifoBytesSinceCheck > 0) && !MMCR0.Hex && !MMCR1.Hex &&
+         !Profiler::g_ProfileBlocks;
+}
+
+void Jit64::WriteLoopExit()
+{
+  // The loop entry expects everything but the loop registers in ppcState. The register caches
+  // keep their state, the code after a conditional exit still uses it.
+  gpr.Flush(RegCache::FlushMode::MaintainState, ~m_loop_regs);
+  fpr.Flush(RegCache::FlushMode::MaintainState);
+
+  // Loop registers the body moved elsewhere go through ppcState, so the moves can't collide.
+  BitSet32 moved;
+  for (int reg : m_loop_regs)
+  {
+    if (!gpr.R(reg).IsSimpleReg(m_loop_xregs[reg]))
+      moved[reg] = true;
+  }
+  gpr.Flush(RegCache::FlushMode::MaintainState, moved);
+  for (int reg : moved)
+    MOV(32, R(m_loop_xregs[reg]), PPCSTATE(gpr[reg]));
+
+  SUB(32, PPCSTATE(downcount), Imm32(js.downcountAmount));
+  J_CC(CC_G, m_loop_entry);
+
+  // Out of cycles, leave through the same path as the checked entry.
+  for (int reg : m_loop_regs)
+    MOV(32, PPCSTATE(gpr[reg]), R(m_loop_xregs[reg]));
+  MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+  JMP(asm_routines.doTiming, true);
+}
+
 void Jit64::JustWriteExit(u32 destination, bool bl, u32 after)
 {
   // If nobody has taken care of this yet (this can be removed when all branches are done)
@@ -581,11 +781,10 @@ void Jit64::Jit(u32 em_address)
 #endif
   }
 
-  if (IsAlmostFull() || m_far_code.IsAlmostFull() || trampolines.IsAlmostFull() ||
-      SConfig::GetInstance().bJITNoBlockCache)
-  {
+  if (SConfig::GetInstance().bJITNoBlockCache)
     ClearCache();
-  }
+  else if (IsCodeRegionFull())
+    EvictCodeRegion();
 
   int blockSize = code_buffer.GetSize();
 
@@ -614,10 +813,16 @@ void Jit64::Jit(u32 em_address)
     }
   }
 
+  // Blocks that ran often get recompiled with the wider tier-2 analysis.
+  const bool hot = js.hotBlockAddresses.find(em_address) != js.hotBlockAddresses.end();
+  if (hot)
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_SUPERBLOCK);
+
   // Analyze the block, collect all instructions it is made of (including inlining,
   // if that is enabled), reorder instructions for optimal performance, and join joinable
   // instructions.
   u32 nextPC = analyzer.Analyze(em_address, &code_block, &code_buffer, blockSize);
+  analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_SUPERBLOCK);
 
   if (code_block.m_memory_exception)
   {
@@ -629,9 +834,30 @@ void Jit64::Jit(u32 em_address)
     return;
   }
 
+  if (!hot)
+  {
+    JitBlock* b = blocks.AllocateBlock(em_address);
+    DoJit(em_address, &code_buffer, b, nextPC);
+    blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
+    return;
+  }
+
+  // Tier-2 blocks are emitted into the hot region.
+  if (IsRegionFull(HOT_REGION, m_hot_code_ptr, m_hot_far_code_ptr, m_hot_trampolines_ptr))
+    ClearHotRegion();
+  u8* const near_code_ptr = GetWritableCodePtr();
+  u8* const far_code_ptr = m_far_code.GetWritableCodePtr();
+  SetCodePtr(m_hot_code_ptr);
+  m_far_code.SetCodePtr(m_hot_far_code_ptr);
+
   JitBlock* b = blocks.AllocateBlock(em_address);
   DoJit(em_address, &code_buffer, b, nextPC);
   blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
+
+  m_hot_code_ptr = GetWritableCodePtr();
+  m_hot_far_code_ptr = m_far_code.GetWritableCodePtr();
+  SetCodePtr(near_code_ptr);
+  m_far_code.SetCodePtr(far_code_ptr);
 }
 
 const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBlock* b, u32 nextPC)
@@ -644,6 +870,7 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBloc
   js.curBlock = b;
   js.numLoadStoreInst = 0;
   js.numFloatingPointInst = 0;
+  js.codeLines.clear();
 
   PPCAnalyst::CodeOp* ops = code_buf->codebuffer;
 
@@ -669,6 +896,27 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBloc
     ABI_PopRegistersAndAdjustStack({}, 0);
   }
 
+  // Count the runs of the block, and have it recompiled as a superblock once it is hot. Nothing
+  // is live at the normal entry, so the flags and scratch registers are free.
+  if (!SConfig::GetInstance().bEnableDebugging &&
+      js.hotBlockAddresses.find(js.blockStart) == js.hotBlockAddresses.end())
+  {
+    b->tier_up_countdown = TIER_UP_RUN_COUNT;
+    MOV(64, R(RSCRATCH), ImmPtr(&b->tier_up_countdown));
+    SUB(32, MatR(RSCRATCH), Imm8(1));
+    FixupBranch tier_up = J_CC(CC_Z, true);
+
+    SwitchToFarCode();
+    SetJumpTarget(tier_up);
+    MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+    ABI_PushRegistersAndAdjustStack({}, 0);
+    ABI_CallFunctionC(JitInterface::CompileExceptionCheck,
+                      static_cast<u32>(JitInterface::ExceptionType::HotBlock));
+    ABI_PopRegistersAndAdjustStack({}, 0);
+    JMP(asm_routines.dispatcherNoCheck, true);
+    SwitchToNearCode();
+  }
+
   // Conditionally add profiling code.
   if (Profiler::g_ProfileBlocks)
   {
@@ -733,6 +981,8 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBloc
     IntializeSpeculativeConstants();
   }
 
+  SetUpLoopEntry(ops);
+
   // Translate instructions
   for (u32 i = 0; i < code_block.m_num_instructions; i++)
   {
@@ -740,6 +990,8 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBloc
     js.op = &ops[i];
     js.instructionNumber = i;
     js.instructionsLeft = (code_block.m_num_instructions - 1) - i;
+    if (JitRegister::IsEnabled())
+      js.codeLines.push_back({GetCodePtr(), ops[i].address});
     const GekkoOPInfo* opinfo = ops[i].opinfo;
     js.downcountAmount += opinfo->numCycles;
     js.fastmemLoadStore = nullptr;
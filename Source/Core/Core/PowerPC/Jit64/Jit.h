@@ -18,6 +18,8 @@
 // ----------
 #pragma once
 
+#include <array>
+
 #include "Common/CommonTypes.h"
 #include "Common/x64ABI.h"
 #include "Common/x64Emitter.h"
@@ -68,6 +70,9 @@ public:
 
   void FakeBLCall(u32 after);
   void WriteExit(u32 destination, bool bl = false, u32 after = 0);
+  // Flushes the register caches and writes the exit. A branch back to the start of a block with
+  // a loop entry jumps straight to it instead, see SetUpLoopEntry.
+  void FlushAndWriteExit(u32 destination, bool bl, u32 after, RegCache::FlushMode mode);
   void JustWriteExit(u32 destination, bool bl, u32 after);
   void WriteExitDestInRSCRATCH(bool bl = false, u32 after = 0);
   void WriteBLRExit();
@@ -88,7 +93,7 @@ public:
   Gen::OpArg ExtractFromReg(int reg, int offset);
   void AndWithMask(Gen::X64Reg reg, u32 mask);
   bool CheckMergedBranch(u32 crf);
-  void DoMergedBranch();
+  void DoMergedBranch(RegCache::FlushMode mode);
   void DoMergedBranchCondition();
   void DoMergedBranchImmediate(s64 val);
 
@@ -248,4 +253,37 @@ private:
   bool m_enable_blr_optimization;
   bool m_cleanup_after_stackfault;
   u8* m_stack;
+
+  // The near code, far code and trampoline spaces are each split in CODE_REGIONS + 1 parts.
+  // Blocks are compiled into part m_code_region of all three, and when one of them fills up the
+  // blocks of the next part are evicted to make room. Trampolines are only ever emitted into a
+  // part that is newer than their block's, so they outlive it.
+  // The last part, HOT_REGION, holds the tier-2 blocks together with their far code and
+  // trampolines, so the code that runs most is packed instead of spread over the whole cache.
+  // It is emptied at once when it is full, the blocks come back as soon as they run again.
+  static constexpr size_t CODE_REGIONS = 4;
+  static constexpr size_t HOT_REGION = CODE_REGIONS;
+  static u8* CodeRegionStart(const Gen::X64CodeBlock& space, size_t index);
+  bool IsRegionFull(size_t index, const u8* near_ptr, const u8* far_ptr,
+                    const u8* trampolines_ptr) const;
+  bool IsCodeRegionFull() const;
+  void EvictCodeRegion();
+  void ResetHotRegion();
+  void ClearHotRegion();
+  bool IsHotCode(const u8* ptr) const;
+  size_t m_code_region = 0;
+  u8* m_hot_code_ptr = nullptr;
+  u8* m_hot_far_code_ptr = nullptr;
+  u8* m_hot_trampolines_ptr = nullptr;
+
+private:
+  void SetUpLoopEntry(const PPCAnalyst::CodeOp* ops);
+  bool CanWriteLoopExit(u32 destination, bool bl) const;
+  void WriteLoopExit();
+
+  // Where a block that branches back to its own start begins its loop body, after loading
+  // m_loop_regs into m_loop_xregs. The back edge jumps here with the registers still loaded.
+  const u8* m_loop_entry = nullptr;
+  BitSet32 m_loop_regs;
+  std::array<Gen::X64Reg, 32> m_loop_xregs{};
 };
@@ -4,6 +4,9 @@
 
 #include "Core/PowerPC/Jit64/JitAsm.h"
 
+#include <array>
+
+
 #include "Common/CommonTypes.h"
 #include "Common/JitRegister.h"
 #include "Common/x64ABI.h"
@@ -109,46 +112,57 @@ void Jit64AsmRoutineManager::Generate()
   const bool assembly_dispatcher = true;
   if (assembly_dispatcher)
   {
-    // Fast block number lookup.
-    // ((PC >> 2) & mask) * sizeof(JitBlock*) = (PC & (mask << 2)) * 2
+    // Fast block set lookup.
+    // ((PC >> 2) & mask) * sizeof(JitBlock*) * ways = (PC & (mask << 2)) * 4
+    static_assert(JitBaseBlockCache::FAST_BLOCK_MAP_WAYS * sizeof(JitBlock*) == 16,
+                  "The set lookup is scaled for two ways");
     MOV(32, R(RSCRATCH), PPCSTATE(pc));
     u64 icache = reinterpret_cast<u64>(m_jit.GetBlockCache()->GetFastBlockMap());
-    AND(32, R(RSCRATCH), Imm32(JitBaseBlockCache::FAST_BLOCK_MAP_MASK << 2));
+    AND(32, R(RSCRATCH), Imm32(JitBaseBlockCache::FAST_BLOCK_MAP_SET_MASK << 2));
     if (icache <= INT_MAX)
     {
-      MOV(64, R(RSCRATCH), MScaled(RSCRATCH, SCALE_2, static_cast<s32>(icache)));
+      LEA(64, RSCRATCH, MScaled(RSCRATCH, SCALE_4, static_cast<s32>(icache)));
     }
     else
     {
       MOV(64, R(RSCRATCH2), Imm64(icache));
-      MOV(64, R(RSCRATCH), MComplex(RSCRATCH2, RSCRATCH, SCALE_2, 0));
+      LEA(64, RSCRATCH, MComplex(RSCRATCH2, RSCRATCH, SCALE_4, 0));
     }
 
-    // Check if we found a block.
-    TEST(64, R(RSCRATCH), R(RSCRATCH));
-    FixupBranch not_found = J_CC(CC_Z);
-
-    // Check both block.effectiveAddress and block.msrBits.
+    // Both block.effectiveAddress and block.msrBits have to match.
     MOV(32, R(RSCRATCH2), PPCSTATE(msr));
     AND(32, R(RSCRATCH2), Imm32(JitBaseBlockCache::JIT_CACHE_MSR_MASK));
     SHL(64, R(RSCRATCH2), Imm8(32));
     MOV(32, R(RSCRATCH_EXTRA), PPCSTATE(pc));
     OR(64, R(RSCRATCH2), R(RSCRATCH_EXTRA));
-    CMP(64, R(RSCRATCH2), MDisp(RSCRATCH, static_cast<s32>(offsetof(JitBlock, effectiveAddress))));
-    FixupBranch state_mismatch = J_CC(CC_NE);
+
+    // Check the ways of the set, an empty one doesn't mean the next one is empty too.
+    std::array<FixupBranch, JitBaseBlockCache::FAST_BLOCK_MAP_WAYS> found;
+    for (u32 way = 0; way < JitBaseBlockCache::FAST_BLOCK_MAP_WAYS; way++)
+    {
+      MOV(64, R(RSCRATCH_EXTRA), MDisp(RSCRATCH, static_cast<s32>(way * sizeof(JitBlock*))));
+      TEST(64, R(RSCRATCH_EXTRA), R(RSCRATCH_EXTRA));
+      FixupBranch empty = J_CC(CC_Z);
+      CMP(64, R(RSCRATCH2),
+          MDisp(RSCRATCH_EXTRA, static_cast<s32>(offsetof(JitBlock, effectiveAddress))));
+      found[way] = J_CC(CC_E);
+      SetJumpTarget(empty);
+    }
+    FixupBranch not_found = J();
 
     // Success; branch to the block we found.
     // Switch to the correct memory base, in case MSR.DR has changed.
+    for (const FixupBranch& branch : found)
+      SetJumpTarget(branch);
     TEST(32, PPCSTATE(msr), Imm32(1 << (31 - 27)));
     FixupBranch physmem = J_CC(CC_Z);
     MOV(64, R(RMEM), ImmPtr(Memory::logical_base));
-    JMPptr(MDisp(RSCRATCH, static_cast<s32>(offsetof(JitBlock, normalEntry))));
+    JMPptr(MDisp(RSCRATCH_EXTRA, static_cast<s32>(offsetof(JitBlock, normalEntry))));
     SetJumpTarget(physmem);
     MOV(64, R(RMEM), ImmPtr(Memory::physical_base));
-    JMPptr(MDisp(RSCRATCH, static_cast<s32>(offsetof(JitBlock, normalEntry))));
+    JMPptr(MDisp(RSCRATCH_EXTRA, static_cast<s32>(offsetof(JitBlock, normalEntry))));
 
     SetJumpTarget(not_found);
-    SetJumpTarget(state_mismatch);
 
     // Failure, fallback to the C++ dispatcher for calling the JIT.
   }
@@ -84,9 +84,6 @@ void Jit64::bx(UGeckoInstruction inst)
     return;
   }
 
-  gpr.Flush();
-  fpr.Flush();
-
   u32 destination;
   if (inst.AA)
     destination = SignExt26(inst.LI << 2);
@@ -98,6 +95,8 @@ void Jit64::bx(UGeckoInstruction inst)
 #endif
   if (destination == js.compilerPC)
   {
+    gpr.Flush();
+    fpr.Flush();
     ABI_PushRegistersAndAdjustStack({}, 0);
     ABI_CallFunction(CoreTiming::Idle);
     ABI_PopRegistersAndAdjustStack({}, 0);
@@ -105,7 +104,7 @@ void Jit64::bx(UGeckoInstruction inst)
     WriteExceptionExit();
     return;
   }
-  WriteExit(destination, inst.LK, js.compilerPC + 4);
+  FlushAndWriteExit(destination, inst.LK, js.compilerPC + 4, RegCache::FlushMode::All);
 }
 
 // TODO - optimize to hell and beyond
@@ -160,9 +159,7 @@ void Jit64::bcx(UGeckoInstruction inst)
   else
     destination = js.compilerPC + SignExt16(inst.BD << 2);
 
-  gpr.Flush(RegCache::FlushMode::MaintainState);
-  fpr.Flush(RegCache::FlushMode::MaintainState);
-  WriteExit(destination, inst.LK, js.compilerPC + 4);
+  FlushAndWriteExit(destination, inst.LK, js.compilerPC + 4, RegCache::FlushMode::MaintainState);
 
   if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
     SetJumpTarget(pConditionDontBranch);
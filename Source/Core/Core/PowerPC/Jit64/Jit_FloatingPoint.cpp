@@ -245,6 +245,11 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
   bool packed = inst.OPCD == 4 || (!cpu_info.bAtom && single && js.op->fprIsDuplicated[a] &&
                                    js.op->fprIsDuplicated[b] && js.op->fprIsDuplicated[c]);
 
+  bool use_fma = cpu_info.bFMA && !Core::WantsDeterminism();
+  // Without FMA, AVX can multiply straight out of c's register instead of copying it first.
+  bool vex_multiply = !use_fma && cpu_info.bAVX && !(single && round_input) &&
+                      inst.SUBOP5 != 14 && inst.SUBOP5 != 15 && fpr.R(c).IsSimpleReg();
+
   fpr.Lock(a, b, c, d);
 
   switch (inst.SUBOP5)
@@ -260,12 +265,12 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
       Force25BitPrecision(XMM1, R(XMM1), XMM0);
     break;
   default:
-    bool special = inst.SUBOP5 == 30 && (!cpu_info.bFMA || Core::WantsDeterminism());
+    bool special = inst.SUBOP5 == 30 && !use_fma;
     X64Reg tmp1 = special ? XMM0 : XMM1;
     X64Reg tmp2 = special ? XMM1 : XMM0;
     if (single && round_input)
       Force25BitPrecision(tmp1, fpr.R(c), tmp2);
-    else
+    else if (!vex_multiply)
       MOVAPD(tmp1, fpr.R(c));
     break;
   }
@@ -276,7 +281,7 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
   // Note that FMA isn't necessarily less correct (it may actually be closer to correct) compared
   // to what the Gekko does here; in deterministic mode, the important thing is multiple Dolphin
   // instances on different computers giving identical results.
-  if (cpu_info.bFMA && !Core::WantsDeterminism())
+  if (use_fma)
   {
     // Statistics suggests b is a lot less likely to be unbound in practice, so
     // if we have to pick one of a or b to bind, let's make it b.
@@ -319,23 +324,47 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
   {
     // We implement nmsub a little differently ((b - a*c) instead of -(a*c - b)), so handle it
     // separately.
-    MOVAPD(XMM1, fpr.R(b));
-    if (packed)
+    if (vex_multiply)
     {
-      MULPD(XMM0, fpr.R(a));
-      SUBPD(XMM1, R(XMM0));
+      if (packed)
+      {
+        VMULPD(XMM0, fpr.RX(c), fpr.R(a));
+        avx_op(&XEmitter::VSUBPD, &XEmitter::SUBPD, XMM1, fpr.R(b), R(XMM0));
+      }
+      else
+      {
+        VMULSD(XMM0, fpr.RX(c), fpr.R(a));
+        avx_op(&XEmitter::VSUBSD, &XEmitter::SUBSD, XMM1, fpr.R(b), R(XMM0), false);
+      }
     }
     else
     {
-      MULSD(XMM0, fpr.R(a));
-      SUBSD(XMM1, R(XMM0));
+      MOVAPD(XMM1, fpr.R(b));
+      if (packed)
+      {
+        MULPD(XMM0, fpr.R(a));
+        SUBPD(XMM1, R(XMM0));
+      }
+      else
+      {
+        MULSD(XMM0, fpr.R(a));
+        SUBSD(XMM1, R(XMM0));
+      }
     }
   }
   else
   {
+    if (vex_multiply)
+    {
+      if (packed)
+        VMULPD(XMM1, fpr.RX(c), fpr.R(a));
+      else
+        VMULSD(XMM1, fpr.RX(c), fpr.R(a));
+    }
     if (packed)
     {
-      MULPD(XMM1, fpr.R(a));
+      if (!vex_multiply)
+        MULPD(XMM1, fpr.R(a));
       if (inst.SUBOP5 == 28)  // msub
         SUBPD(XMM1, fpr.R(b));
       else  //(n)madd(s[01])
@@ -343,7 +372,8 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
     }
     else
     {
-      MULSD(XMM1, fpr.R(a));
+      if (!vex_multiply)
+        MULSD(XMM1, fpr.R(a));
       if (inst.SUBOP5 == 28)
         SUBSD(XMM1, fpr.R(b));
       else
@@ -366,7 +366,7 @@ bool Jit64::CheckMergedBranch(u32 crf)
           static_cast<u32>(next.BI >> 2) == crf);
 }
 
-void Jit64::DoMergedBranch()
+void Jit64::DoMergedBranch(RegCache::FlushMode mode)
 {
   // Code that handles successful PPC branching.
   const UGeckoInstruction& next = js.op[1].inst;
@@ -381,9 +381,13 @@ void Jit64::DoMergedBranch()
       destination = SignExt16(next.BD << 2);
     else
       destination = nextPC + SignExt16(next.BD << 2);
-    WriteExit(destination, next.LK, nextPC + 4);
+    FlushAndWriteExit(destination, next.LK, nextPC + 4, mode);
+    return;
   }
-  else if ((next.OPCD == 19) && (next.SUBOP10 == 528))  // bcctrx
+
+  gpr.Flush(mode);
+  fpr.Flush(mode);
+  if ((next.OPCD == 19) && (next.SUBOP10 == 528))  // bcctrx
   {
     if (next.LK)
       MOV(32, PPCSTATE(spr[SPR_LR]), Imm32(nextPC + 4));
@@ -427,10 +431,7 @@ void Jit64::DoMergedBranchCondition()
   else  // SO bit, do not branch (we don't emulate SO for cmp).
     pDontBranch = J(true);
 
-  gpr.Flush(RegCache::FlushMode::MaintainState);
-  fpr.Flush(RegCache::FlushMode::MaintainState);
-
-  DoMergedBranch();
+  DoMergedBranch(RegCache::FlushMode::MaintainState);
 
   SetJumpTarget(pDontBranch);
 
@@ -465,9 +466,7 @@ void Jit64::DoMergedBranchImmediate(s64 val)
 
   if (branch)
   {
-    gpr.Flush();
-    fpr.Flush();
-    DoMergedBranch();
+    DoMergedBranch(RegCache::FlushMode::All);
   }
   else if (!analyzer.HasOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE))
   {
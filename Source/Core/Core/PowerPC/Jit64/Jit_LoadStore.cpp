@@ -271,6 +271,7 @@ void Jit64::dcbx(UGeckoInstruction inst)
 {
   INSTRUCTION_START
   JITDISABLE(bJITLoadStoreOff);
+  FALLBACK_IF(SConfig::GetInstance().bAccurateDataCache);
 
   X64Reg addr = RSCRATCH;
   X64Reg value = RSCRATCH2;
@@ -318,8 +319,10 @@ void Jit64::dcbt(UGeckoInstruction inst)
   // This is important because invalidating the block cache when we don't
   // need to is terrible for performance.
   // (Invalidating the jit block cache on dcbst is a heuristic.)
-  if (CanMergeNextInstructions(1) && js.op[1].inst.OPCD == 31 && js.op[1].inst.SUBOP10 == 54 &&
-      js.op[1].inst.RA == inst.RA && js.op[1].inst.RB == inst.RB)
+  // With the data cache emulated, the dcbst has to write the line back.
+  if (!SConfig::GetInstance().bAccurateDataCache && CanMergeNextInstructions(1) &&
+      js.op[1].inst.OPCD == 31 && js.op[1].inst.SUBOP10 == 54 && js.op[1].inst.RA == inst.RA &&
+      js.op[1].inst.RB == inst.RB)
   {
     js.skipInstructions = 1;
   }
@@ -7,6 +7,7 @@
 #include "Common/CPUDetect.h"
 #include "Common/CommonTypes.h"
 #include "Common/x64Emitter.h"
+#include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/ProcessorInterface.h"
 #include "Core/PowerPC/Jit64/JitRegCache.h"
@@ -238,6 +239,8 @@ void Jit64::mtspr(UGeckoInstruction inst)
 
   case SPR_HID0:
   {
+    // The interpreter handles HID0.DCFI.
+    FALLBACK_IF(SConfig::GetInstance().bAccurateDataCache);
     gpr.BindToRegister(d, true, false);
     BTR(32, gpr.R(d), Imm8(31 - 20));  // ICFI
     MOV(32, PPCSTATE(spr[iIndex]), gpr.R(d));
@@ -317,7 +317,8 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg& opAddress,
   bool slowmem = (flags & SAFE_LOADSTORE_FORCE_SLOWMEM) != 0;
 
   registersInUse[reg_value] = false;
-  if (g_jit->jo.fastmem && !(flags & SAFE_LOADSTORE_NO_FASTMEM) && !slowmem)
+  if (g_jit->jo.fastmem && !(flags & SAFE_LOADSTORE_NO_FASTMEM) && !slowmem &&
+      !g_jit->js.fastmemFaultAddresses.count(g_jit->js.compilerPC))
   {
     u8* backpatchStart = GetWritableCodePtr();
     MovInfo mov;
@@ -483,7 +484,8 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
   // set the correct immediate format
   reg_value = FixImmediate(accessSize, reg_value);
 
-  if (g_jit->jo.fastmem && !(flags & SAFE_LOADSTORE_NO_FASTMEM) && !slowmem)
+  if (g_jit->jo.fastmem && !(flags & SAFE_LOADSTORE_NO_FASTMEM) && !slowmem &&
+      !g_jit->js.fastmemFaultAddresses.count(g_jit->js.compilerPC))
   {
     u8* backpatchStart = GetWritableCodePtr();
     MovInfo mov;
@@ -1143,3 +1145,21 @@ void EmuCodeBlock::Clear()
   m_back_patch_info.clear();
   m_exception_handler_at_loc.clear();
 }
+
+void EmuCodeBlock::ClearBackPatchInfo(const u8* begin, const u8* end)
+{
+  for (auto iter = m_back_patch_info.begin(); iter != m_back_patch_info.end();)
+  {
+    if (iter->first >= begin && iter->first < end)
+      iter = m_back_patch_info.erase(iter);
+    else
+      iter++;
+  }
+  for (auto iter = m_exception_handler_at_loc.begin(); iter != m_exception_handler_at_loc.end();)
+  {
+    if (iter->first >= begin && iter->first < end)
+      iter = m_exception_handler_at_loc.erase(iter);
+    else
+      iter++;
+  }
+}
@@ -121,6 +121,8 @@ public:
   void ConvertDoubleToSingle(Gen::X64Reg dst, Gen::X64Reg src);
   void SetFPRF(Gen::X64Reg xmm);
   void Clear();
+  // Forgets the backpatch info of the code in [begin, end), which is about to be reused.
+  void ClearBackPatchInfo(const u8* begin, const u8* end);
 
 protected:
   ConstantPool m_const_pool;
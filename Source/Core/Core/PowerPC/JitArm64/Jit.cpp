@@ -8,8 +8,10 @@
 
 #include "Common/Arm64Emitter.h"
 #include "Common/CommonTypes.h"
+#include "Common/JitRegister.h"
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
+#include "Common/MemoryUtil.h"
 #include "Common/PerformanceCounter.h"
 #include "Common/StringUtil.h"
 
@@ -42,6 +44,8 @@ void JitArm64::Init()
 
   size_t child_code_size = SConfig::GetInstance().bMMU ? FARCODE_SIZE_MMU : FARCODE_SIZE;
   AllocCodeSpace(CODE_SIZE + child_code_size);
+  if (SConfig::GetInstance().bHugePages)
+    Common::AdviseHugePages(region, total_region_size);
   AddChildCodeSpace(&farcode, child_code_size);
   jo.enableBlocklink = true;
   jo.optimizeGatherPipe = true;
@@ -600,6 +604,7 @@ void JitArm64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBlock*
   js.skipInstructions = 0;
   js.curBlock = b;
   js.carryFlagSet = false;
+  js.codeLines.clear();
 
   PPCAnalyst::CodeOp* ops = code_buf->codebuffer;
 
@@ -657,6 +662,8 @@ void JitArm64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBlock*
     js.op = &ops[i];
     js.instructionNumber = i;
     js.instructionsLeft = (code_block.m_num_instructions - 1) - i;
+    if (JitRegister::IsEnabled())
+      js.codeLines.push_back({GetCodePtr(), ops[i].address});
     const GekkoOPInfo* opinfo = ops[i].opinfo;
     js.downcountAmount += opinfo->numCycles;
     js.isLastInstruction = i == (code_block.m_num_instructions - 1);
@@ -5,8 +5,10 @@
 #include "Common/Arm64Emitter.h"
 #include "Common/CommonTypes.h"
 
+#include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
+#include "Core/HW/CPU.h"
 #include "Core/PowerPC/JitArm64/Jit.h"
 #include "Core/PowerPC/JitArm64/JitArm64_RegCache.h"
 #include "Core/PowerPC/PPCTables.h"
@@ -169,7 +171,22 @@ void JitArm64::bcx(UGeckoInstruction inst)
   gpr.Flush(FlushMode::FLUSH_MAINTAIN_STATE);
   fpr.Flush(FlushMode::FLUSH_MAINTAIN_STATE);
 
-  WriteExit(destination, inst.LK, js.compilerPC + 4);
+  // Going around an idle loop again wouldn't change anything until the next event.
+  if (code_block.m_idle_loop && destination == js.blockStart && !inst.LK && !CPU::IsStepping() &&
+      !SConfig::GetInstance().bEnableDebugging)
+  {
+    WA = gpr.GetReg();
+    ARM64Reg XA = EncodeRegTo64(WA);
+    MOVP2R(XA, &CoreTiming::Idle);
+    BLR(XA);
+    gpr.Unlock(WA);
+
+    WriteExceptionExit(destination);
+  }
+  else
+  {
+    WriteExit(destination, inst.LK, js.compilerPC + 4);
+  }
 
   SwitchToNearCode();
 
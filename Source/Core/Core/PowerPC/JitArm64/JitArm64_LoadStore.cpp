@@ -553,6 +553,7 @@ void JitArm64::dcbx(UGeckoInstruction inst)
 {
   INSTRUCTION_START
   JITDISABLE(bJITLoadStoreOff);
+  FALLBACK_IF(SConfig::GetInstance().bAccurateDataCache);
 
   gpr.Lock(W30);
 
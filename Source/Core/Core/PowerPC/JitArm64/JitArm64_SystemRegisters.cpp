@@ -6,6 +6,7 @@
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 
+#include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/PowerPC/JitArm64/Jit.h"
@@ -117,6 +118,8 @@ void JitArm64::mtsr(UGeckoInstruction inst)
 {
   INSTRUCTION_START
   JITDISABLE(bJITSystemRegistersOff);
+  // The interpreter unmaps the fastmem pages that depend on the segment registers.
+  FALLBACK_IF(SConfig::GetInstance().bMMU);
 
   gpr.BindToRegister(inst.RS, true);
   STR(INDEX_UNSIGNED, gpr.R(inst.RS), PPC_REG, PPCSTATE_OFF(sr[inst.SR]));
@@ -145,6 +148,8 @@ void JitArm64::mtsrin(UGeckoInstruction inst)
 {
   INSTRUCTION_START
   JITDISABLE(bJITSystemRegistersOff);
+  // The interpreter unmaps the fastmem pages that depend on the segment registers.
+  FALLBACK_IF(SConfig::GetInstance().bMMU);
 
   u32 b = inst.RB, d = inst.RD;
   gpr.BindToRegister(d, d == b);
@@ -91,35 +91,43 @@ void JitArm64::GenerateAsm()
     MOVP2R(MEM_REG, Memory::logical_base);
     SetJumpTarget(membaseend);
 
-    // iCache[(address >> 2) & iCache_Mask];
+    // set = &iCache[((address >> 2) & iCache_Mask) * ways];
+    static_assert(JitBaseBlockCache::FAST_BLOCK_MAP_WAYS * sizeof(JitBlock*) == 16,
+                  "The set lookup is scaled for two ways");
     ARM64Reg pc_masked = W25;
-    ARM64Reg cache_base = X27;
+    ARM64Reg cache_set = X27;
     ARM64Reg block = X30;
-    ORRI2R(pc_masked, WZR, JitBaseBlockCache::FAST_BLOCK_MAP_MASK << 3);
-    AND(pc_masked, pc_masked, DISPATCHER_PC, ArithOption(DISPATCHER_PC, ST_LSL, 1));
-    MOVP2R(cache_base, GetBlockCache()->GetFastBlockMap());
-    LDR(block, cache_base, EncodeRegTo64(pc_masked));
-    FixupBranch not_found = CBZ(block);
-
-    // b.effectiveAddress != addr || b.msrBits != msr
-    ARM64Reg pc_and_msr = W25;
-    ARM64Reg pc_and_msr2 = W24;
-    LDR(INDEX_UNSIGNED, pc_and_msr, block, offsetof(JitBlock, effectiveAddress));
-    CMP(pc_and_msr, DISPATCHER_PC);
-    FixupBranch pc_missmatch = B(CC_NEQ);
-
-    LDR(INDEX_UNSIGNED, pc_and_msr2, PPC_REG, PPCSTATE_OFF(msr));
-    ANDI2R(pc_and_msr2, pc_and_msr2, JitBaseBlockCache::JIT_CACHE_MSR_MASK);
-    LDR(INDEX_UNSIGNED, pc_and_msr, block, offsetof(JitBlock, msrBits));
-    CMP(pc_and_msr, pc_and_msr2);
-    FixupBranch msr_missmatch = B(CC_NEQ);
-
-    // return blocks[block_num].normalEntry;
-    LDR(INDEX_UNSIGNED, block, block, offsetof(JitBlock, normalEntry));
-    BR(block);
-    SetJumpTarget(not_found);
-    SetJumpTarget(pc_missmatch);
-    SetJumpTarget(msr_missmatch);
+    ORRI2R(pc_masked, WZR, JitBaseBlockCache::FAST_BLOCK_MAP_SET_MASK << 4);
+    AND(pc_masked, pc_masked, DISPATCHER_PC, ArithOption(DISPATCHER_PC, ST_LSL, 2));
+    MOVP2R(cache_set, GetBlockCache()->GetFastBlockMap());
+    ADD(cache_set, cache_set, EncodeRegTo64(pc_masked));
+
+    // Check the ways of the set, an empty one doesn't mean the next one is empty too.
+    for (u32 way = 0; way < JitBaseBlockCache::FAST_BLOCK_MAP_WAYS; way++)
+    {
+      LDR(INDEX_UNSIGNED, block, cache_set, way * sizeof(JitBlock*));
+      FixupBranch not_found = CBZ(block);
+
+      // b.effectiveAddress != addr || b.msrBits != msr
+      ARM64Reg pc_and_msr = W25;
+      ARM64Reg pc_and_msr2 = W24;
+      LDR(INDEX_UNSIGNED, pc_and_msr, block, offsetof(JitBlock, effectiveAddress));
+      CMP(pc_and_msr, DISPATCHER_PC);
+      FixupBranch pc_missmatch = B(CC_NEQ);
+
+      LDR(INDEX_UNSIGNED, pc_and_msr2, PPC_REG, PPCSTATE_OFF(msr));
+      ANDI2R(pc_and_msr2, pc_and_msr2, JitBaseBlockCache::JIT_CACHE_MSR_MASK);
+      LDR(INDEX_UNSIGNED, pc_and_msr, block, offsetof(JitBlock, msrBits));
+      CMP(pc_and_msr, pc_and_msr2);
+      FixupBranch msr_missmatch = B(CC_NEQ);
+
+      // return blocks[block_num].normalEntry;
+      LDR(INDEX_UNSIGNED, block, block, offsetof(JitBlock, normalEntry));
+      BR(block);
+      SetJumpTarget(not_found);
+      SetJumpTarget(pc_missmatch);
+      SetJumpTarget(msr_missmatch);
+    }
   }
 
   // Call C version of Dispatch().
@@ -7,6 +7,7 @@
 #include "Common/CommonTypes.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/CPU.h"
+#include "Core/PowerPC/JitCommon/JitDiskCache.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PowerPC.h"
 
@@ -19,6 +20,7 @@ const u8* JitBase::Dispatch(JitBase& jit)
 
 void JitTrampoline(JitBase& jit, u32 em_address)
 {
+  JitDiskCache::Precompile(jit, em_address);
   jit.Jit(em_address);
 }
 
@@ -51,6 +53,9 @@ bool JitBase::CanMergeNextInstructions(int count) const
 void JitBase::UpdateMemoryOptions()
 {
   bool any_watchpoints = PowerPC::memchecks.HasAny();
-  jo.fastmem = SConfig::GetInstance().bFastmem && (UReg_MSR(MSR).DR || !any_watchpoints);
-  jo.memcheck = SConfig::GetInstance().bMMU || any_watchpoints;
+  // The emulated data cache is only reachable from the slow memory paths.
+  bool data_cache = SConfig::GetInstance().bAccurateDataCache;
+  jo.fastmem = SConfig::GetInstance().bFastmem && (UReg_MSR(MSR).DR || !any_watchpoints) &&
+               !data_cache;
+  jo.memcheck = SConfig::GetInstance().bMMU || any_watchpoints || data_cache;
 }
@@ -10,8 +10,10 @@
 
 #include <map>
 #include <unordered_set>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/JitRegister.h"
 #include "Common/x64Emitter.h"
 #include "Core/ConfigManager.h"
 #include "Core/MachineContext.h"
@@ -99,6 +101,17 @@ protected:
     std::unordered_set<u32> fifoWriteAddresses;
     std::unordered_set<u32> pairedQuantizeAddresses;
     std::unordered_set<u32> noSpeculativeConstantsAddresses;
+    // Start addresses of blocks that ran often enough to be recompiled as superblocks.
+    std::unordered_set<u32> hotBlockAddresses;
+    // Loads and stores whose fastmem access faulted. They are compiled with the checked access
+    // from then on, instead of faulting again after every recompile.
+    std::unordered_set<u32> fastmemFaultAddresses;
+    // Number of fastmem accesses that faulted and were backpatched.
+    u64 fastmemFaults = 0;
+
+    // Where the code of each instruction of the current block starts, while JitRegister is
+    // enabled.
+    std::vector<JitRegister::CodeLine> codeLines;
   };
 
   PPCAnalyst::CodeBlock code_block;
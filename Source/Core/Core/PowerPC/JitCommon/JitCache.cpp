@@ -19,11 +19,14 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/JitRegister.h"
+#include "Core/Analytics.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/HW/Memmap.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "VideoCommon/FrameTelemetry.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -43,9 +46,34 @@ JitBaseBlockCache::JitBaseBlockCache(JitBase& jit) : m_jit{jit}
 
 JitBaseBlockCache::~JitBaseBlockCache() = default;
 
+// Hashes the instructions a block was compiled from. Returns false for code outside of RAM, which
+// is always recompiled.
+static bool HashBlockCode(const JitBlock& block, u64* hash)
+{
+  u64 result = 0xcbf29ce484222325ULL;
+  for (u32 address : block.physical_addresses)
+  {
+    const u32 masked = address & 0x3FFFFFFF;
+    const u8* ptr;
+    if (masked < Memory::REALRAM_SIZE)
+      ptr = Memory::m_pRAM + masked;
+    else if (Memory::m_pEXRAM && (masked >> 28) == 0x1 &&
+             (masked & 0x0FFFFFFF) < Memory::EXRAM_SIZE)
+      ptr = Memory::m_pEXRAM + (masked & Memory::EXRAM_MASK);
+    else
+      return false;
+
+    u32 instruction;
+    std::memcpy(&instruction, ptr, sizeof(instruction));
+    result = (result ^ instruction) * 0x100000001b3ULL;
+  }
+  *hash = result;
+  return true;
+}
+
 void JitBaseBlockCache::Init()
 {
-  JitRegister::Init(SConfig::GetInstance().m_perfDir);
+  JitRegister::Init(SConfig::GetInstance().m_perfDir, SConfig::GetInstance().m_perfJitDump);
 
   Clear();
 }
@@ -62,8 +90,10 @@ void JitBaseBlockCache::Clear()
 #if defined(_DEBUG) || defined(DEBUGFAST)
   Core::DisplayMessage("Clearing code cache.", 3000);
 #endif
+  DolphinAnalytics::Instance()->ReportJitCacheFlush();
   m_jit.js.fifoWriteAddresses.clear();
   m_jit.js.pairedQuantizeAddresses.clear();
+  m_jit.js.hotBlockAddresses.clear();
   for (auto& e : block_map)
   {
     DestroyBlock(e.second);
@@ -109,11 +139,11 @@ JitBlock* JitBaseBlockCache::AllocateBlock(u32 em_address)
 void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
                                       const std::set<u32>& physical_addresses)
 {
-  size_t index = FastLookupIndexForAddress(block.effectiveAddress);
-  fast_block_map[index] = &block;
-  block.fast_block_map_index = index;
+  InsertIntoFastBlockMap(block);
 
   block.physical_addresses = physical_addresses;
+  block.has_code_hash = HashBlockCode(block, &block.code_hash);
+  FrameTelemetry::AddJitBlockCompile();
 
   u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
   for (u32 addr : physical_addresses)
@@ -136,13 +166,14 @@ void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
   if (JitRegister::IsEnabled() &&
       (symbol = g_symbolDB.GetSymbolFromAddr(block.effectiveAddress)) != nullptr)
   {
-    JitRegister::Register(block.checkedEntry, block.codeSize, "JIT_PPC_%s_%08x",
-                          symbol->function_name.c_str(), block.physicalAddress);
+    JitRegister::RegisterLines(block.checkedEntry, block.codeSize, symbol->function_name,
+                               m_jit.js.codeLines, "JIT_PPC_%s_%08x",
+                               symbol->function_name.c_str(), block.physicalAddress);
   }
   else
   {
-    JitRegister::Register(block.checkedEntry, block.codeSize, "JIT_PPC_%08x",
-                          block.physicalAddress);
+    JitRegister::RegisterLines(block.checkedEntry, block.codeSize, "JIT_PPC", m_jit.js.codeLines,
+                               "JIT_PPC_%08x", block.physicalAddress);
   }
 }
 
@@ -172,9 +203,19 @@ JitBlock* JitBaseBlockCache::GetBlockFromStartAddress(u32 addr, u32 msr)
 
 const u8* JitBaseBlockCache::Dispatch()
 {
-  JitBlock* block = fast_block_map[FastLookupIndexForAddress(PC)];
+  const size_t set = FastLookupIndexForAddress(PC);
+  JitBlock* block = nullptr;
+  for (size_t way = 0; way < FAST_BLOCK_MAP_WAYS && !block; way++)
+  {
+    JitBlock* candidate = fast_block_map[set + way];
+    if (candidate && candidate->effectiveAddress == PC &&
+        candidate->msrBits == (MSR & JIT_CACHE_MSR_MASK))
+    {
+      block = candidate;
+    }
+  }
 
-  if (!block || block->effectiveAddress != PC || block->msrBits != (MSR & JIT_CACHE_MSR_MASK))
+  if (!block)
     block = MoveBlockIntoFastCache(PC, MSR & JIT_CACHE_MSR_MASK);
 
   if (!block)
@@ -203,25 +244,33 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
   if (destroy_block)
   {
     // destroy JIT blocks
-    ErasePhysicalRange(pAddr, length);
+    // Games invalidate whole overlays after DMAing them in, even if most of the code is the same
+    // as before. Blocks whose instructions didn't change are kept. Forced invalidations (like
+    // breakpoints) always recompile.
+    const bool destroyed = ErasePhysicalRange(pAddr, length, !forced);
 
     // If the code was actually modified, we need to clear the relevant entries from the
     // FIFO write address cache, so we don't end up with FIFO checks in places they shouldn't
     // be (this can clobber flags, and thus break any optimization that relies on flags
     // being in the right place between instructions).
-    if (!forced)
+    if (!forced && destroyed)
     {
       for (u32 i = address; i < address + length; i += 4)
       {
         m_jit.js.fifoWriteAddresses.erase(i);
         m_jit.js.pairedQuantizeAddresses.erase(i);
+        m_jit.js.hotBlockAddresses.erase(i);
+        m_jit.js.fastmemFaultAddresses.erase(i);
       }
     }
   }
 }
 
-void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
+bool JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length, bool keep_unchanged)
 {
+  bool destroyed = false;
+  bool kept = false;
+
   // Iterate over all macro blocks which overlap the given range.
   u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
   auto start = block_range_map.lower_bound(address & range_mask);
@@ -233,8 +282,22 @@ void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
     while (iter != start->second.end())
     {
       JitBlock* block = *iter;
-      if (block->OverlapsPhysicalRange(address, length))
+      u64 hash;
+      if (block->OverlapsPhysicalRange(address, length) && keep_unchanged &&
+          block->has_code_hash && HashBlockCode(*block, &hash) && hash == block->code_hash)
+      {
+        // The cache lines of the block are still occupied.
+        for (u32 addr : block->physical_addresses)
+        {
+          if (addr >= address && addr - address < length)
+            valid_block.Set(addr / 32);
+        }
+        kept = true;
+        iter++;
+      }
+      else if (block->OverlapsPhysicalRange(address, length))
       {
+        destroyed = true;
         // If the block overlaps, also remove all other occupied slots in the other macro blocks.
         // This will leak empty macro blocks, but they may be reused or cleared later on.
         for (u32 addr : block->physical_addresses)
@@ -267,6 +330,40 @@ void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
     else
       start++;
   }
+
+  return destroyed || !kept;
+}
+
+size_t JitBaseBlockCache::EraseCodeRange(const u8* begin, const u8* end)
+{
+  const u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  size_t erased = 0;
+  auto iter = block_map.begin();
+  while (iter != block_map.end())
+  {
+    JitBlock& block = iter->second;
+    if (block.checkedEntry < begin || block.checkedEntry >= end)
+    {
+      iter++;
+      continue;
+    }
+
+    // Links from the blocks that stay are reverted to the dispatcher by DestroyBlock. The cache
+    // lines stay marked in valid_block, which only costs an unneeded invalidation later on.
+    for (u32 addr : block.physical_addresses)
+    {
+      auto range = block_range_map.find(addr & range_mask);
+      if (range == block_range_map.end())
+        continue;
+      range->second.erase(&block);
+      if (range->second.empty())
+        block_range_map.erase(range);
+    }
+    DestroyBlock(block);
+    iter = block_map.erase(iter);
+    erased++;
+  }
+  return erased;
 }
 
 u32* JitBaseBlockCache::GetBlockBitSet() const
@@ -371,19 +468,34 @@ JitBlock* JitBaseBlockCache::MoveBlockIntoFastCache(u32 addr, u32 msr)
   if (!block)
     return nullptr;
 
+  FrameTelemetry::AddJitFastBlockMapMiss();
+
   // Drop old fast block map entry
   if (fast_block_map[block->fast_block_map_index] == block)
     fast_block_map[block->fast_block_map_index] = nullptr;
 
   // And create a new one
-  size_t index = FastLookupIndexForAddress(addr);
-  fast_block_map[index] = block;
-  block->fast_block_map_index = index;
+  InsertIntoFastBlockMap(*block);
 
   return block;
 }
 
+void JitBaseBlockCache::InsertIntoFastBlockMap(JitBlock& block)
+{
+  // The block goes into the first way, the others move down one and the last one falls out.
+  const size_t set = FastLookupIndexForAddress(block.effectiveAddress);
+  for (size_t way = FAST_BLOCK_MAP_WAYS - 1; way > 0; way--)
+  {
+    JitBlock* moved = fast_block_map[set + way - 1];
+    fast_block_map[set + way] = moved;
+    if (moved)
+      moved->fast_block_map_index = set + way;
+  }
+  fast_block_map[set] = &block;
+  block.fast_block_map_index = set;
+}
+
 size_t JitBaseBlockCache::FastLookupIndexForAddress(u32 address)
 {
-  return (address >> 2) & FAST_BLOCK_MAP_MASK;
+  return ((address >> 2) & FAST_BLOCK_MAP_SET_MASK) * FAST_BLOCK_MAP_WAYS;
 }
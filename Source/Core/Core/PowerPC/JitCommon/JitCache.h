@@ -64,6 +64,11 @@ struct JitBlock
   // This set stores all physical addresses of all occupied instructions.
   std::set<u32> physical_addresses;
 
+  // Hash of the instructions the block was compiled from. Cache invalidations by the game keep
+  // the block if its instructions still hash the same. Only valid if has_code_hash is set.
+  u64 code_hash = 0;
+  bool has_code_hash = false;
+
   // Block profiling data, structure is inlined in Jit.cpp
   struct ProfileData
   {
@@ -74,6 +79,10 @@ struct JitBlock
     u64 ticStop;
   } profile_data = {};
 
+  // Runs left until the block is recompiled with the tier-2 analyzer options. Only counts down
+  // in blocks the JIT emitted a tier-up check for.
+  u32 tier_up_countdown = 0;
+
   // This tracks the position if this block within the fast block cache.
   // We allow each block to have only one map entry.
   size_t fast_block_map_index;
@@ -118,8 +127,12 @@ public:
   // is valid (MSR.IR and MSR.DR, the address translation bits).
   static constexpr u32 JIT_CACHE_MSR_MASK = 0x30;
 
-  static constexpr u32 FAST_BLOCK_MAP_ELEMENTS = 0x10000;
-  static constexpr u32 FAST_BLOCK_MAP_MASK = FAST_BLOCK_MAP_ELEMENTS - 1;
+  // The fast block map is set associative: (address >> 2) & FAST_BLOCK_MAP_SET_MASK picks a set
+  // of FAST_BLOCK_MAP_WAYS entries, the most recently inserted block first.
+  static constexpr u32 FAST_BLOCK_MAP_WAYS = 2;
+  static constexpr u32 FAST_BLOCK_MAP_SETS = 0x10000;
+  static constexpr u32 FAST_BLOCK_MAP_SET_MASK = FAST_BLOCK_MAP_SETS - 1;
+  static constexpr u32 FAST_BLOCK_MAP_ELEMENTS = FAST_BLOCK_MAP_SETS * FAST_BLOCK_MAP_WAYS;
 
   explicit JitBaseBlockCache(JitBase& jit);
   virtual ~JitBaseBlockCache();
@@ -148,7 +161,12 @@ public:
   const u8* Dispatch();
 
   void InvalidateICache(u32 address, u32 length, bool forced);
-  void ErasePhysicalRange(u32 address, u32 length);
+  // Destroys the blocks overlapping the range. With keep_unchanged, blocks whose instructions are
+  // unchanged survive. Returns false if every overlapping block survived.
+  bool ErasePhysicalRange(u32 address, u32 length, bool keep_unchanged = false);
+  // Destroys the blocks whose code starts in [begin, end), so the JIT can reuse that part of its
+  // code space. Returns the number of destroyed blocks.
+  size_t EraseCodeRange(const u8* begin, const u8* end);
 
   u32* GetBlockBitSet() const;
 
@@ -165,8 +183,9 @@ private:
   void DestroyBlock(JitBlock& block);
 
   JitBlock* MoveBlockIntoFastCache(u32 em_address, u32 msr);
+  void InsertIntoFastBlockMap(JitBlock& block);
 
-  // Fast but risky block lookup based on fast_block_map.
+  // Index of the first entry of the fast_block_map set the address belongs to.
   size_t FastLookupIndexForAddress(u32 address);
 
   // links_to hold all exit points of all valid blocks in a reverse way.
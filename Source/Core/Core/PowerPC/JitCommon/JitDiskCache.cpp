@@ -0,0 +1,330 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/PowerPC/JitCommon/JitDiskCache.h"
+
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/Logging/Log.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/PPCTables.h"
+#include "Core/PowerPC/PowerPC.h"
+
+namespace JitDiskCache
+{
+namespace
+{
+constexpr u32 CACHE_MAGIC = 0x4354494A;  // "JITC"
+constexpr u32 CACHE_VERSION = 2;
+
+struct Header
+{
+  u32 magic;
+  u32 version;
+  u32 num_blocks;
+  u32 num_fifo_writes;
+  u32 num_paired_quantize;
+  u32 num_no_speculative_constants;
+  u32 num_fastmem_faults;
+};
+
+struct BlockHeader
+{
+  u32 effective_address;
+  u32 msr_bits;
+  u32 physical_address;
+  u32 hot;
+  u64 code_hash;
+  // Followed by this many (physical start, instruction count) pairs.
+  u32 num_ranges;
+  u32 pad;
+};
+
+struct Block
+{
+  u32 physical_address;
+  bool hot;
+  u64 code_hash;
+  std::vector<std::pair<u32, u32>> ranges;
+};
+
+// Indexed by effective address and MSR bits, like the block cache.
+std::map<std::pair<u32, u32>, Block> s_blocks;
+std::unordered_set<u32> s_fifo_writes;
+std::unordered_set<u32> s_paired_quantize;
+std::unordered_set<u32> s_no_speculative_constants;
+std::unordered_set<u32> s_fastmem_faults;
+
+std::string s_game_id;
+bool s_enabled = false;
+bool s_loaded = false;
+bool s_precompile_pending = false;
+
+bool IsRAMAddress(u32 address)
+{
+  address &= 0x3FFFFFFF;
+  if (address < Memory::REALRAM_SIZE)
+    return true;
+  return Memory::m_pEXRAM && (address >> 28) == 0x1 && (address & 0x0FFFFFFF) < Memory::EXRAM_SIZE;
+}
+
+std::string GetCachePath()
+{
+  return File::GetUserPath(D_CACHE_IDX) + JIT_CACHE_DIR DIR_SEP + s_game_id + ".cache";
+}
+
+// Hash of the instructions currently in memory, or 0 if any of them isn't in RAM.
+u64 HashCode(const std::vector<std::pair<u32, u32>>& ranges)
+{
+  std::vector<u32> code;
+  for (const auto& range : ranges)
+  {
+    for (u32 i = 0; i < range.second; i++)
+    {
+      const u32 address = range.first + i * 4;
+      if (!IsRAMAddress(address))
+        return 0;
+      code.push_back(Memory::Read_U32(address));
+    }
+  }
+  return GetStripeHash64(reinterpret_cast<const u8*>(code.data()),
+                         static_cast<u32>(code.size() * sizeof(u32)), 0);
+}
+
+void WriteAddresses(File::IOFile& file, const std::unordered_set<u32>& addresses)
+{
+  const std::vector<u32> list(addresses.begin(), addresses.end());
+  file.WriteArray(list.data(), list.size());
+}
+
+bool ReadAddresses(File::IOFile& file, u32 count, std::unordered_set<u32>* addresses)
+{
+  std::vector<u32> list(count);
+  if (!file.ReadArray(list.data(), list.size()))
+    return false;
+  addresses->insert(list.begin(), list.end());
+  return true;
+}
+
+void Load()
+{
+  File::IOFile file(GetCachePath(), "rb");
+  if (!file)
+    return;
+
+  Header header;
+  if (!file.ReadArray(&header, 1) || header.magic != CACHE_MAGIC ||
+      header.version != CACHE_VERSION)
+  {
+    WARN_LOG(DYNA_REC, "Ignoring outdated JIT cache %s", GetCachePath().c_str());
+    return;
+  }
+
+  for (u32 i = 0; i < header.num_blocks; i++)
+  {
+    BlockHeader block_header;
+    if (!file.ReadArray(&block_header, 1))
+      return;
+    Block& block = s_blocks[{block_header.effective_address, block_header.msr_bits}];
+    block.physical_address = block_header.physical_address;
+    block.hot = block_header.hot != 0;
+    block.code_hash = block_header.code_hash;
+    block.ranges.resize(block_header.num_ranges);
+    if (!file.ReadArray(block.ranges.data(), block.ranges.size()))
+      return;
+  }
+
+  if (!ReadAddresses(file, header.num_fifo_writes, &s_fifo_writes) ||
+      !ReadAddresses(file, header.num_paired_quantize, &s_paired_quantize) ||
+      !ReadAddresses(file, header.num_no_speculative_constants, &s_no_speculative_constants) ||
+      !ReadAddresses(file, header.num_fastmem_faults, &s_fastmem_faults))
+  {
+    return;
+  }
+  INFO_LOG(DYNA_REC, "Loaded %zu blocks from the JIT cache", s_blocks.size());
+}
+
+void Save()
+{
+  const std::string path = GetCachePath();
+  File::CreateFullPath(path);
+  File::IOFile file(path, "wb");
+  if (!file)
+  {
+    ERROR_LOG(DYNA_REC, "Failed to write the JIT cache %s", path.c_str());
+    return;
+  }
+
+  const Header header = {CACHE_MAGIC,
+                         CACHE_VERSION,
+                         static_cast<u32>(s_blocks.size()),
+                         static_cast<u32>(s_fifo_writes.size()),
+                         static_cast<u32>(s_paired_quantize.size()),
+                         static_cast<u32>(s_no_speculative_constants.size()),
+                         static_cast<u32>(s_fastmem_faults.size())};
+  file.WriteArray(&header, 1);
+  for (const auto& entry : s_blocks)
+  {
+    const Block& block = entry.second;
+    const BlockHeader block_header = {entry.first.first,
+                                      entry.first.second,
+                                      block.physical_address,
+                                      block.hot,
+                                      block.code_hash,
+                                      static_cast<u32>(block.ranges.size()),
+                                      0};
+    file.WriteArray(&block_header, 1);
+    file.WriteArray(block.ranges.data(), block.ranges.size());
+  }
+  WriteAddresses(file, s_fifo_writes);
+  WriteAddresses(file, s_paired_quantize);
+  WriteAddresses(file, s_no_speculative_constants);
+  WriteAddresses(file, s_fastmem_faults);
+}
+
+void AddBlock(const JitBase& jit, const JitBlock& jit_block)
+{
+  Block block;
+  block.physical_address = jit_block.physicalAddress;
+  block.hot = jit.js.hotBlockAddresses.count(jit_block.effectiveAddress) != 0;
+  for (u32 address : jit_block.physical_addresses)
+  {
+    if (!block.ranges.empty() &&
+        block.ranges.back().first + block.ranges.back().second * 4 == address)
+    {
+      block.ranges.back().second++;
+    }
+    else
+    {
+      block.ranges.emplace_back(address, 1);
+    }
+  }
+  block.code_hash = HashCode(block.ranges);
+  if (block.code_hash)
+    s_blocks[{jit_block.effectiveAddress, jit_block.msrBits}] = std::move(block);
+}
+}  // Anonymous namespace
+
+void Init()
+{
+  s_blocks.clear();
+  s_fifo_writes.clear();
+  s_paired_quantize.clear();
+  s_no_speculative_constants.clear();
+  s_fastmem_faults.clear();
+  s_loaded = false;
+
+  // With the MMU, looking up the physical addresses would touch the TLB.
+  s_enabled = SConfig::GetInstance().bJITPersistentCache && !SConfig::GetInstance().bMMU;
+  s_precompile_pending = s_enabled;
+}
+
+void Shutdown(JitBase& jit)
+{
+  if (!s_enabled || !s_loaded)
+    return;
+
+  jit.GetBlockCache()->RunOnBlocks([&jit](const JitBlock& block) { AddBlock(jit, block); });
+  s_fifo_writes.insert(jit.js.fifoWriteAddresses.begin(), jit.js.fifoWriteAddresses.end());
+  s_paired_quantize.insert(jit.js.pairedQuantizeAddresses.begin(),
+                           jit.js.pairedQuantizeAddresses.end());
+  s_no_speculative_constants.insert(jit.js.noSpeculativeConstantsAddresses.begin(),
+                                    jit.js.noSpeculativeConstantsAddresses.end());
+  s_fastmem_faults.insert(jit.js.fastmemFaultAddresses.begin(),
+                          jit.js.fastmemFaultAddresses.end());
+  Save();
+}
+
+void Precompile(JitBase& jit, u32 em_address)
+{
+  if (!s_precompile_pending)
+    return;
+
+  // The game ID is only known once the game has booted.
+  if (!s_loaded)
+  {
+    s_game_id = SConfig::GetInstance().GetGameID();
+    if (s_game_id.empty())
+      return;
+    s_loaded = true;
+    Load();
+  }
+  s_precompile_pending = false;
+
+  // Only blocks whose instructions are still the same are worth anything.
+  const u32 msr_bits = MSR & JitBaseBlockCache::JIT_CACHE_MSR_MASK;
+  std::vector<const std::pair<const std::pair<u32, u32>, Block>*> valid_blocks;
+  for (const auto& entry : s_blocks)
+  {
+    const u32 address = entry.first.first;
+    const Block& block = entry.second;
+    if (entry.first.second != msr_bits || address == em_address)
+      continue;
+    const PowerPC::TranslateResult translated = PowerPC::JitCache_TranslateAddress(address);
+    if (!translated.valid || translated.address != block.physical_address ||
+        HashCode(block.ranges) != block.code_hash ||
+        jit.GetBlockCache()->GetBlockFromStartAddress(address, MSR))
+    {
+      continue;
+    }
+    valid_blocks.push_back(&entry);
+  }
+
+  // What the JIT learned about the blocks has to be known before compiling them, or they would
+  // be compiled again the first time they run.
+  for (const auto* entry : valid_blocks)
+  {
+    const u32 address = entry->first.first;
+    if (entry->second.hot)
+      jit.js.hotBlockAddresses.insert(address);
+    if (s_paired_quantize.count(address))
+      jit.js.pairedQuantizeAddresses.insert(address);
+    if (s_no_speculative_constants.count(address))
+      jit.js.noSpeculativeConstantsAddresses.insert(address);
+  }
+  for (u32 address : s_fifo_writes)
+  {
+    if (!PowerPC::HostIsRAMAddress(address))
+      continue;
+    const OpType type = PPCTables::GetOpInfo(PowerPC::HostRead_U32(address))->type;
+    if (type == OpType::Store || type == OpType::StoreFP || type == OpType::StorePS)
+      jit.js.fifoWriteAddresses.insert(address);
+  }
+  // Faulting accesses are remembered even without a valid block, they are likely MMIO accesses
+  // in code that is compiled later on.
+  for (u32 address : s_fastmem_faults)
+  {
+    if (!PowerPC::HostIsRAMAddress(address))
+      continue;
+    const OpType type = PPCTables::GetOpInfo(PowerPC::HostRead_U32(address))->type;
+    if (type == OpType::Load || type == OpType::LoadFP || type == OpType::LoadPS ||
+        type == OpType::Store || type == OpType::StoreFP || type == OpType::StorePS)
+    {
+      jit.js.fastmemFaultAddresses.insert(address);
+    }
+  }
+
+  for (const auto* entry : valid_blocks)
+    jit.Jit(entry->first.first);
+  INFO_LOG(DYNA_REC, "Precompiled %zu of %zu blocks from the JIT cache", valid_blocks.size(),
+           s_blocks.size());
+}
+
+void OnStateLoaded()
+{
+  s_precompile_pending = s_enabled;
+}
+}  // namespace JitDiskCache
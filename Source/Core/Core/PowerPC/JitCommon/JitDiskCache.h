@@ -0,0 +1,28 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+class JitBase;
+
+// Remembers which blocks a game compiled, and what the JIT learned about them (FIFO writes,
+// paired quantizers, wrong speculative constants, hot blocks), in User/Cache/JIT/<game ID>.
+// On boot and after loading a state, the blocks whose PPC code still matches are compiled
+// up front in one go, instead of one by one while the game is running.
+//
+// The compiled code itself isn't stored. It has the addresses of the JIT's own state baked in,
+// so the blocks are compiled again; the cache only saves discovering them.
+namespace JitDiskCache
+{
+void Init();
+void Shutdown(JitBase& jit);
+
+// Compiles the remembered blocks once the game code is in memory. em_address is the block the
+// dispatcher is about to compile itself.
+void Precompile(JitBase& jit, u32 em_address);
+
+void OnStateLoaded();
+}
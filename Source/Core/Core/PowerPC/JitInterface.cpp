@@ -25,6 +25,7 @@
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/CachedInterpreter/CachedInterpreter.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitDiskCache.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/Profiler.h"
@@ -42,7 +43,10 @@ namespace JitInterface
 void DoState(PointerWrap& p)
 {
   if (g_jit && p.GetMode() == PointerWrap::MODE_READ)
+  {
     g_jit->ClearCache();
+    JitDiskCache::OnStateLoaded();
+  }
 }
 CPUCoreBase* InitJitCore(int core)
 {
@@ -68,6 +72,7 @@ CPUCoreBase* InitJitCore(int core)
     return nullptr;
   }
   g_jit->Init();
+  JitDiskCache::Init();
   return g_jit;
 }
 
@@ -99,6 +104,8 @@ void WriteProfileResults(const std::string& filename)
             name.c_str(), stat.run_count, stat.cost, stat.tick_counter, percent, timePercent,
             (double)stat.tick_counter * 1000.0 / (double)prof_stats.countsPerSec, stat.block_size);
   }
+  fprintf(f.GetHandle(), "# %" PRIu64 " fastmem faults, %" PRIu64 " loads/stores use slowmem\n",
+          prof_stats.fastmem_faults, prof_stats.fastmem_fault_addresses);
 }
 
 void GetProfileResults(ProfileStats* prof_stats)
@@ -110,6 +117,8 @@ void GetProfileResults(ProfileStats* prof_stats)
   prof_stats->cost_sum = 0;
   prof_stats->timecost_sum = 0;
   prof_stats->block_stats.clear();
+  prof_stats->fastmem_faults = g_jit->js.fastmemFaults;
+  prof_stats->fastmem_fault_addresses = g_jit->js.fastmemFaultAddresses.size();
 
   Core::State old_state = Core::GetState();
   if (old_state == Core::State::Running)
@@ -232,6 +241,9 @@ void CompileExceptionCheck(ExceptionType type)
   case ExceptionType::SpeculativeConstants:
     exception_addresses = &g_jit->js.noSpeculativeConstantsAddresses;
     break;
+  case ExceptionType::HotBlock:
+    exception_addresses = &g_jit->js.hotBlockAddresses;
+    break;
   }
 
   if (PC != 0 && (exception_addresses->find(PC)) == (exception_addresses->end()))
@@ -255,6 +267,7 @@ void Shutdown()
 {
   if (g_jit)
   {
+    JitDiskCache::Shutdown(*g_jit);
     g_jit->Shutdown();
     delete g_jit;
     g_jit = nullptr;
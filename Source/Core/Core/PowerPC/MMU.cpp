@@ -165,6 +165,28 @@ BatTable dbat_table;
 
 static void GenerateDSIException(u32 _EffectiveAddress, bool _bWrite);
 
+// Data accesses to MEM1 and MEM2 go through the emulated data cache when it is enabled.
+template <XCheckTLBFlag flag>
+static bool UseDataCache()
+{
+  return flag != XCheckTLBFlag::Opcode && flag != XCheckTLBFlag::OpcodeNoException &&
+         ppcState.dCache.emulated && HID0.DCE;
+}
+
+// Whether a physical address is in MEM1 or MEM2, the memory behind the data cache.
+static bool IsDataCacheable(u32 address)
+{
+  return (address & 0xF8000000) == 0x00000000 ||
+         (Memory::m_pEXRAM && (address >> 28) == 0x1 &&
+          (address & 0x0FFFFFFF) < Memory::EXRAM_SIZE);
+}
+
+// The address the data cache uses for a cacheable physical address, without the MEM1 mirrors.
+static u32 PhysicalCacheAddress(u32 address)
+{
+  return (address & 0xF8000000) == 0x00000000 ? address & Memory::RAM_MASK : address;
+}
+
 template <XCheckTLBFlag flag, typename T, bool never_translate = false>
 static T ReadFromHardware(u32 em_address)
 {
@@ -212,7 +234,15 @@ static T ReadFromHardware(u32 em_address)
     // mirrors of memory).
     // TODO: Only the first REALRAM_SIZE is supposed to be backed by actual memory.
     T value;
-    std::memcpy(&value, &Memory::m_pRAM[em_address & Memory::RAM_MASK], sizeof(T));
+    if (UseDataCache<flag>())
+    {
+      ppcState.dCache.Read(em_address & Memory::RAM_MASK, reinterpret_cast<u8*>(&value),
+                           sizeof(T));
+    }
+    else
+    {
+      std::memcpy(&value, &Memory::m_pRAM[em_address & Memory::RAM_MASK], sizeof(T));
+    }
     return bswap(value);
   }
 
@@ -220,7 +250,10 @@ static T ReadFromHardware(u32 em_address)
       (em_address & 0x0FFFFFFF) < Memory::EXRAM_SIZE)
   {
     T value;
-    std::memcpy(&value, &Memory::m_pEXRAM[em_address & 0x0FFFFFFF], sizeof(T));
+    if (UseDataCache<flag>())
+      ppcState.dCache.Read(em_address, reinterpret_cast<u8*>(&value), sizeof(T));
+    else
+      std::memcpy(&value, &Memory::m_pEXRAM[em_address & 0x0FFFFFFF], sizeof(T));
     return bswap(value);
   }
 
@@ -301,7 +334,15 @@ static void WriteToHardware(u32 em_address, const T data)
     // mirrors of memory).
     // TODO: Only the first REALRAM_SIZE is supposed to be backed by actual memory.
     const T swapped_data = bswap(data);
-    std::memcpy(&Memory::m_pRAM[em_address & Memory::RAM_MASK], &swapped_data, sizeof(T));
+    if (UseDataCache<flag>())
+    {
+      ppcState.dCache.Write(em_address & Memory::RAM_MASK,
+                            reinterpret_cast<const u8*>(&swapped_data), sizeof(T));
+    }
+    else
+    {
+      std::memcpy(&Memory::m_pRAM[em_address & Memory::RAM_MASK], &swapped_data, sizeof(T));
+    }
     return;
   }
 
@@ -309,7 +350,10 @@ static void WriteToHardware(u32 em_address, const T data)
       (em_address & 0x0FFFFFFF) < Memory::EXRAM_SIZE)
   {
     const T swapped_data = bswap(data);
-    std::memcpy(&Memory::m_pEXRAM[em_address & 0x0FFFFFFF], &swapped_data, sizeof(T));
+    if (UseDataCache<flag>())
+      ppcState.dCache.Write(em_address, reinterpret_cast<const u8*>(&swapped_data), sizeof(T));
+    else
+      std::memcpy(&Memory::m_pEXRAM[em_address & 0x0FFFFFFF], &swapped_data, sizeof(T));
     return;
   }
 
@@ -527,7 +571,6 @@ void Write_U16(const u16 var, const u32 address)
 }
 void Write_U16_Swap(const u16 var, const u32 address)
 {
-  Memcheck(address, var, true, 2);
   Write_U16(Common::swap16(var), address);
 }
 
@@ -538,7 +581,6 @@ void Write_U32(const u32 var, const u32 address)
 }
 void Write_U32_Swap(const u32 var, const u32 address)
 {
-  Memcheck(address, var, true, 4);
   Write_U32(Common::swap32(var), address);
 }
 
@@ -549,7 +591,6 @@ void Write_U64(const u64 var, const u32 address)
 }
 void Write_U64_Swap(const u64 var, const u32 address)
 {
-  Memcheck(address, (u32)var, true, 8);
   Write_U64(Common::swap64(var), address);
 }
 
@@ -762,12 +803,55 @@ void ClearCacheLine(u32 address)
     address = translated_address.address;
   }
 
+  if (UseDataCache<XCheckTLBFlag::Write>() && IsDataCacheable(address))
+  {
+    ppcState.dCache.ZeroLine(PhysicalCacheAddress(address));
+    return;
+  }
+
   // TODO: This isn't precisely correct for non-RAM regions, but the difference
   // is unlikely to matter.
   for (u32 i = 0; i < 32; i += 8)
     WriteToHardware<XCheckTLBFlag::Write, u64, true>(address + i, 0);
 }
 
+// Translates a data cache block instruction's address. Returns false if the instruction has
+// nothing to do.
+static bool TranslateCacheBlockAddress(u32* address)
+{
+  if (!UseDataCache<XCheckTLBFlag::NoException>())
+    return false;
+  if (UReg_MSR(MSR).DR)
+  {
+    auto translated_address = TranslateAddress<XCheckTLBFlag::NoException>(*address);
+    if (!translated_address.Success())
+      return false;
+    *address = translated_address.address;
+  }
+  if (!IsDataCacheable(*address))
+    return false;
+  *address = PhysicalCacheAddress(*address);
+  return true;
+}
+
+void FlushCacheLine(u32 address)
+{
+  if (TranslateCacheBlockAddress(&address))
+    ppcState.dCache.Flush(address);
+}
+
+void StoreCacheLine(u32 address)
+{
+  if (TranslateCacheBlockAddress(&address))
+    ppcState.dCache.Store(address);
+}
+
+void InvalidateCacheLine(u32 address)
+{
+  if (TranslateCacheBlockAddress(&address))
+    ppcState.dCache.Invalidate(address);
+}
+
 u32 IsOptimizableMMIOAccess(u32 address, u32 accessSize)
 {
   if (PowerPC::memchecks.HasAny())
@@ -959,6 +1043,10 @@ void SDRUpdated()
   }
   PowerPC::ppcState.pagetable_base = htaborg << 16;
   PowerPC::ppcState.pagetable_hashmask = ((htabmask << 10) | 0x3ff);
+
+#ifndef _ARCH_32
+  Memory::ClearPageTableMappings();
+#endif
 }
 
 enum class TLBLookupResult
@@ -1045,6 +1133,10 @@ void InvalidateTLBEntry(u32 address)
   TLBEntry& tlbe_i = ppcState.tlb[1][entry_index];
   tlbe_i.tag[0] = TLBEntry::INVALID_TAG;
   tlbe_i.tag[1] = TLBEntry::INVALID_TAG;
+
+#ifndef _ARCH_32
+  Memory::InvalidatePageTableMappings(address);
+#endif
 }
 
 // Page Address Translation
@@ -1140,6 +1232,27 @@ static TranslateAddressResult TranslatePageAddress(const u32 address, const XChe
   return TranslateAddressResult{TranslateAddressResult::PAGE_FAULT, 0};
 }
 
+bool TranslatePageTableAddress(u32 address, bool write, u32* physical_address, bool* changed)
+{
+  u32 bat_address = address;
+  if (!UReg_MSR(MSR).DR || TranslateBatAddess(dbat_table, &bat_address))
+    return false;
+
+  const TranslateAddressResult result =
+      TranslatePageAddress(address, write ? XCheckTLBFlag::Write : XCheckTLBFlag::Read);
+  if (result.result != TranslateAddressResult::PAGE_TABLE_TRANSLATED)
+    return false;
+
+  // The translation left the page in the TLB.
+  const u32 tag = address >> HW_PAGE_INDEX_SHIFT;
+  const TLBEntry& tlbe = ppcState.tlb[0][tag & HW_PAGE_INDEX_MASK];
+  UPTE2 PTE2;
+  PTE2.Hex = tlbe.tag[0] == tag ? tlbe.pte[0] : tlbe.pte[1];
+  *physical_address = result.address;
+  *changed = PTE2.C != 0;
+  return true;
+}
+
 static void UpdateBATs(BatTable& bat_table, u32 base_spr)
 {
   // TODO: Separate BATs for MSR.PR==0 and MSR.PR==1
@@ -1243,6 +1356,15 @@ void DBATUpdated()
     UpdateFakeMMUBat(dbat_table, 0x40000000);
     UpdateFakeMMUBat(dbat_table, 0x70000000);
   }
+  if (ppcState.dCache.emulated)
+  {
+    // Cached memory has to go through the data cache, so keep the JIT off its fast paths.
+    for (u32& entry : dbat_table)
+    {
+      if ((entry & BAT_MAPPED_BIT) && IsDataCacheable(entry & BAT_RESULT_MASK))
+        entry &= ~BAT_PHYSICAL_BIT;
+    }
+  }
 
 #ifndef _ARCH_32
   Memory::UpdateLogicalMemory(dbat_table);
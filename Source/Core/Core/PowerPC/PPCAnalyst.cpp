@@ -38,6 +38,8 @@ constexpr int CODEBUFFER_SIZE = 32000;
 
 // 0 does not perform block merging
 constexpr u32 BRANCH_FOLLOWING_THRESHOLD = 2;
+// Used with OPTION_SUPERBLOCK, only hot blocks get compiled with it.
+constexpr u32 SUPERBLOCK_BRANCH_FOLLOWING_THRESHOLD = 8;
 
 constexpr u32 INVALID_BRANCH_TARGET = 0xFFFFFFFF;
 
@@ -683,6 +685,78 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const Gekk
   }
 }
 
+static bool IsPollingLoad(UGeckoInstruction inst)
+{
+  switch (inst.OPCD)
+  {
+  case 32:  // lwz
+  case 34:  // lbz
+  case 40:  // lhz
+  case 42:  // lha
+    return true;
+  case 31:
+    switch (inst.SUBOP10)
+    {
+    case 23:   // lwzx
+    case 87:   // lbzx
+    case 279:  // lhzx
+    case 343:  // lhax
+    case 534:  // lwbrx
+    case 790:  // lhbrx
+      return true;
+    }
+  }
+  return false;
+}
+
+// Whether the block starts with a loop that only loads and compares, and branches back to the
+// start without using anything the previous iteration computed. Such a loop comes out the same
+// on every iteration until something else writes the memory it polls, which can only happen in an
+// event, an interrupt or on the GPU thread, so the JITs skip ahead to the next event instead of
+// spinning. This is stricter than, but includes, the lwz/cmpwi/beq loop that Jit64 looks for.
+static bool IsIdleLoop(const CodeBlock& block, const CodeOp* code)
+{
+  constexpr u32 banned_flags = FL_ENDBLOCK | FL_SET_CA | FL_READ_CA | FL_TIMER |
+                               FL_CHECKEXCEPTIONS | FL_EVIL | FL_USE_FPU;
+
+  BitSet32 loop_writes;
+  for (u32 i = 0; i < block.m_num_instructions; i++)
+  {
+    const CodeOp& op = code[i];
+    if (op.skip)
+      return false;
+
+    if (op.inst.OPCD == 16)  // bcx
+    {
+      const u32 destination = SignExt16(op.inst.BD << 2) + (op.inst.AA ? 0 : op.address);
+      if (i == 0 || destination != block.m_address || op.inst.LK ||
+          !(op.inst.BO & BO_DONT_DECREMENT_FLAG))
+      {
+        return false;
+      }
+
+      // Registers the loop writes must be written before they're read in the same iteration.
+      BitSet32 defined;
+      for (u32 j = 0; j < i; j++)
+      {
+        if (code[j].regsIn & loop_writes & ~defined)
+          return false;
+        defined |= code[j].regsOut;
+      }
+      return true;
+    }
+
+    if (op.opinfo->flags & banned_flags)
+      return false;
+    if ((op.opinfo->flags & FL_SET_OE) && op.inst.OE)
+      return false;
+    if (op.opinfo->type != OpType::Integer && !IsPollingLoad(op.inst))
+      return false;
+    loop_writes |= op.regsOut;
+  }
+  return false;
+}
+
 u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32 blockSize)
 {
   // Clear block stats
@@ -701,6 +775,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32
   // Reset our block state
   block->m_broken = false;
   block->m_memory_exception = false;
+  block->m_idle_loop = false;
   block->m_num_instructions = 0;
   block->m_gqr_used = BitSet8(0);
   block->m_physical_addresses.clear();
@@ -712,6 +787,8 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32
   size_t caller = 0;
   u32 numFollows = 0;
   u32 num_inst = 0;
+  const u32 follow_threshold = HasOption(OPTION_SUPERBLOCK) ? SUPERBLOCK_BRANCH_FOLLOWING_THRESHOLD :
+                                                              BRANCH_FOLLOWING_THRESHOLD;
 
   for (u32 i = 0; i < blockSize; ++i)
   {
@@ -748,7 +825,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32
     //       If it is small, the performance will be down.
     //       If it is big, the size of generated code will be big and
     //       cache clearning will happen many times.
-    if (HasOption(OPTION_BRANCH_FOLLOW) && numFollows < BRANCH_FOLLOWING_THRESHOLD)
+    if (HasOption(OPTION_BRANCH_FOLLOW) && numFollows < follow_threshold)
     {
       if (inst.OPCD == 18 && blockSize > 1)
       {
@@ -969,6 +1046,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32
   block->m_gqr_used = gqrUsed;
   block->m_gqr_modified = gqrModified;
   block->m_gpr_inputs = gprBlockInputs;
+  block->m_idle_loop = IsIdleLoop(*block, code);
   return address;
 }
 
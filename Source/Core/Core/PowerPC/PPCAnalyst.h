@@ -151,6 +151,9 @@ struct CodeBlock
   // Did we have a memory_exception?
   bool m_memory_exception;
 
+  // Does the block start with a loop that only polls memory? See IsIdleLoop().
+  bool m_idle_loop;
+
   // Which GQRs this block uses, if any.
   BitSet8 m_gqr_used;
 
@@ -218,6 +221,10 @@ public:
 
     // Reorder cror instructions next to their associated fcmp.
     OPTION_CROR_MERGE = (1 << 6),
+
+    // Follow many more branches than usual, so a hot path gets compiled into one superblock.
+    // Register stats and flag liveness then span the whole path. Used for tier-2 recompiles.
+    OPTION_SUPERBLOCK = (1 << 7),
   };
 
   PPCAnalyzer() : m_options(0) {}
@@ -4,10 +4,12 @@
 
 #include "Core/PowerPC/PPCCache.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "Common/ChunkFile.h"
 #include "Common/Swap.h"
+#include "Core/ConfigManager.h"
 #include "Core/HW/Memmap.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -17,43 +19,49 @@ namespace PowerPC
 static const u32 s_plru_mask[8] = {11, 11, 19, 19, 37, 37, 69, 69};
 static const u32 s_plru_value[8] = {11, 3, 17, 1, 36, 4, 64, 0};
 
+static u32 WayFromValid(u32 m)
+{
+  u32 w = 0;
+  while (m & (1 << w))
+    w++;
+  return w;
+}
+
+static u32 WayFromPLRU(u32 m)
+{
+  u32 b[7];
+  for (int i = 0; i < 7; i++)
+    b[i] = m & (1 << i);
+  u32 w;
+  if (b[0])
+    if (b[2])
+      if (b[6])
+        w = 7;
+      else
+        w = 6;
+    else if (b[5])
+      w = 5;
+    else
+      w = 4;
+  else if (b[1])
+    if (b[4])
+      w = 3;
+    else
+      w = 2;
+  else if (b[3])
+    w = 1;
+  else
+    w = 0;
+  return w;
+}
+
 InstructionCache::InstructionCache()
 {
   for (u32 m = 0; m < 0xff; m++)
-  {
-    u32 w = 0;
-    while (m & (1 << w))
-      w++;
-    way_from_valid[m] = w;
-  }
+    way_from_valid[m] = WayFromValid(m);
 
   for (u32 m = 0; m < 128; m++)
-  {
-    u32 b[7];
-    for (int i = 0; i < 7; i++)
-      b[i] = m & (1 << i);
-    u32 w;
-    if (b[0])
-      if (b[2])
-        if (b[6])
-          w = 7;
-        else
-          w = 6;
-      else if (b[5])
-        w = 5;
-      else
-        w = 4;
-    else if (b[1])
-      if (b[4])
-        w = 3;
-      else
-        w = 2;
-    else if (b[3])
-      w = 1;
-    else
-      w = 0;
-    way_from_plru[m] = w;
-  }
+    way_from_plru[m] = WayFromPLRU(m);
 }
 
 void InstructionCache::Reset()
@@ -163,4 +171,176 @@ void InstructionCache::DoState(PointerWrap& p)
   p.DoArray(lookup_table_ex);
   p.DoArray(lookup_table_vmem);
 }
+
+void DataCache::Init()
+{
+  memset(data, 0, sizeof(data));
+  memset(tags, 0, sizeof(tags));
+  emulated = SConfig::GetInstance().bAccurateDataCache;
+
+  Reset();
+}
+
+void DataCache::Reset()
+{
+  memset(valid, 0, sizeof(valid));
+  memset(dirty, 0, sizeof(dirty));
+  memset(plru, 0, sizeof(plru));
+}
+
+u32 DataCache::FindWay(u32 set, u32 tag) const
+{
+  for (u32 way = 0; way < DCACHE_WAYS; way++)
+  {
+    if ((valid[set] & (1 << way)) && tags[set][way] == tag)
+      return way;
+  }
+  return DCACHE_WAYS;
+}
+
+u32 DataCache::AllocateWay(u32 set)
+{
+  const u32 way =
+      valid[set] != 0xff ? WayFromValid(valid[set]) : WayFromPLRU(plru[set] & 0x7f);
+  if (dirty[set] & (1 << way))
+    WriteBack(set, way);
+  valid[set] &= ~(1 << way);
+  return way;
+}
+
+void DataCache::WriteBack(u32 set, u32 way)
+{
+  const u32 line_address = (tags[set][way] << 12) | (set << 5);
+  Memory::CopyToEmu(line_address, data[set][way], DCACHE_BLOCK_SIZE);
+  dirty[set] &= ~(1 << way);
+}
+
+void DataCache::Touch(u32 set, u32 way)
+{
+  plru[set] = (plru[set] & ~s_plru_mask[way]) | s_plru_value[way];
+}
+
+void DataCache::Read(u32 addr, u8* dst, u32 size)
+{
+  while (size != 0)
+  {
+    const u32 offset = addr & (DCACHE_BLOCK_SIZE - 1);
+    const u32 chunk = std::min(size, DCACHE_BLOCK_SIZE - offset);
+    const u32 set = (addr >> 5) & 0x7f;
+    const u32 tag = addr >> 12;
+
+    u32 way = FindWay(set, tag);
+    if (way == DCACHE_WAYS && HID0.DLOCK)
+    {
+      // A locked cache serves hits, misses go to memory without allocating.
+      Memory::CopyFromEmu(dst, addr, chunk);
+    }
+    else
+    {
+      if (way == DCACHE_WAYS)
+      {
+        way = AllocateWay(set);
+        Memory::CopyFromEmu(data[set][way], addr & ~(DCACHE_BLOCK_SIZE - 1), DCACHE_BLOCK_SIZE);
+        tags[set][way] = tag;
+        valid[set] |= 1 << way;
+      }
+      Touch(set, way);
+      memcpy(dst, &data[set][way][offset], chunk);
+    }
+
+    addr += chunk;
+    dst += chunk;
+    size -= chunk;
+  }
+}
+
+void DataCache::Write(u32 addr, const u8* src, u32 size)
+{
+  while (size != 0)
+  {
+    const u32 offset = addr & (DCACHE_BLOCK_SIZE - 1);
+    const u32 chunk = std::min(size, DCACHE_BLOCK_SIZE - offset);
+    const u32 set = (addr >> 5) & 0x7f;
+    const u32 tag = addr >> 12;
+
+    u32 way = FindWay(set, tag);
+    if (way == DCACHE_WAYS && HID0.DLOCK)
+    {
+      Memory::CopyToEmu(addr, src, chunk);
+    }
+    else
+    {
+      // Store misses allocate the line.
+      if (way == DCACHE_WAYS)
+      {
+        way = AllocateWay(set);
+        Memory::CopyFromEmu(data[set][way], addr & ~(DCACHE_BLOCK_SIZE - 1), DCACHE_BLOCK_SIZE);
+        tags[set][way] = tag;
+        valid[set] |= 1 << way;
+      }
+      Touch(set, way);
+      memcpy(&data[set][way][offset], src, chunk);
+      dirty[set] |= 1 << way;
+    }
+
+    addr += chunk;
+    src += chunk;
+    size -= chunk;
+  }
+}
+
+void DataCache::Flush(u32 addr)
+{
+  const u32 set = (addr >> 5) & 0x7f;
+  const u32 way = FindWay(set, addr >> 12);
+  if (way == DCACHE_WAYS)
+    return;
+  if (dirty[set] & (1 << way))
+    WriteBack(set, way);
+  valid[set] &= ~(1 << way);
+}
+
+void DataCache::Store(u32 addr)
+{
+  const u32 set = (addr >> 5) & 0x7f;
+  const u32 way = FindWay(set, addr >> 12);
+  if (way != DCACHE_WAYS && (dirty[set] & (1 << way)))
+    WriteBack(set, way);
+}
+
+void DataCache::Invalidate(u32 addr)
+{
+  const u32 set = (addr >> 5) & 0x7f;
+  const u32 way = FindWay(set, addr >> 12);
+  if (way == DCACHE_WAYS)
+    return;
+  valid[set] &= ~(1 << way);
+  dirty[set] &= ~(1 << way);
+}
+
+void DataCache::ZeroLine(u32 addr)
+{
+  const u32 set = (addr >> 5) & 0x7f;
+  const u32 tag = addr >> 12;
+  u32 way = FindWay(set, tag);
+  if (way == DCACHE_WAYS)
+  {
+    // dcbz allocates the line without reading memory.
+    way = AllocateWay(set);
+    tags[set][way] = tag;
+    valid[set] |= 1 << way;
+  }
+  Touch(set, way);
+  memset(data[set][way], 0, DCACHE_BLOCK_SIZE);
+  dirty[set] |= 1 << way;
+}
+
+void DataCache::DoState(PointerWrap& p)
+{
+  p.DoArray(data);
+  p.DoArray(tags);
+  p.DoArray(plru);
+  p.DoArray(valid);
+  p.DoArray(dirty);
+}
 }  // namespace PowerPC
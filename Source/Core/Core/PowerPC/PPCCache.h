@@ -39,4 +39,45 @@ struct InstructionCache
   void Reset();
   void DoState(PointerWrap& p);
 };
+
+const u32 DCACHE_SETS = 128;
+const u32 DCACHE_WAYS = 8;
+// size of a data cache block in bytes
+const u32 DCACHE_BLOCK_SIZE = 32;
+
+// Write-back L1 data cache, only used when the accurate data cache option is set. Without it,
+// loads and stores access memory directly. Stores stay in the cache until the line is evicted or
+// written back by dcbf/dcbst, and dcbi discards them, like on hardware. Addresses are physical
+// MEM1/MEM2 addresses, the data is stored in memory (big endian) order.
+struct DataCache
+{
+  u8 data[DCACHE_SETS][DCACHE_WAYS][DCACHE_BLOCK_SIZE];
+  u32 tags[DCACHE_SETS][DCACHE_WAYS];
+  u32 plru[DCACHE_SETS];
+  u32 valid[DCACHE_SETS];
+  u32 dirty[DCACHE_SETS];
+
+  // Set from the config when the core starts, not part of savestates.
+  bool emulated = false;
+
+  // Copy size bytes through the cache. Misses fill the line unless the cache is locked.
+  void Read(u32 addr, u8* dst, u32 size);
+  void Write(u32 addr, const u8* src, u32 size);
+  // dcbf, dcbst, dcbi and dcbz on the line containing addr.
+  void Flush(u32 addr);
+  void Store(u32 addr);
+  void Invalidate(u32 addr);
+  void ZeroLine(u32 addr);
+  // Drops every line without writing it back (HID0.DCFI).
+  void Reset();
+  void Init();
+  void DoState(PointerWrap& p);
+
+private:
+  // Returns DCACHE_WAYS if the line isn't cached.
+  u32 FindWay(u32 set, u32 tag) const;
+  u32 AllocateWay(u32 set);
+  void WriteBack(u32 set, u32 way);
+  void Touch(u32 set, u32 way);
+};
 }  // namespace PowerPC
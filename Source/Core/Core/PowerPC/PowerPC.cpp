@@ -23,6 +23,7 @@
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/Interpreter/Interpreter.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/Profiler.h"
 
 namespace PowerPC
 {
@@ -94,6 +95,7 @@ void DoState(PointerWrap& p)
   p.Do(ppcState.pagetable_hashmask);
 
   ppcState.iCache.DoState(p);
+  ppcState.dCache.DoState(p);
 
   if (p.GetMode() == PointerWrap::MODE_READ)
   {
@@ -219,6 +221,7 @@ void Init(int cpu_core)
 
   InitializeCPUCore(cpu_core);
   ppcState.iCache.Init();
+  ppcState.dCache.Init();
 
   if (SConfig::GetInstance().bEnableDebugging)
     breakpoints.ClearAllTemporary();
@@ -232,6 +235,7 @@ void Reset()
 
   ResetRegisters();
   ppcState.iCache.Reset();
+  ppcState.dCache.Reset();
 }
 
 void ScheduleInvalidateCacheThreadSafe(u32 address)
@@ -250,6 +254,7 @@ void ScheduleInvalidateCacheThreadSafe(u32 address)
 void Shutdown()
 {
   InjectExternalCPUCore(nullptr);
+  Profiler::StopSampling();
   JitInterface::Shutdown();
   s_interpreter->Shutdown();
   s_cpu_core_base = nullptr;
@@ -126,6 +126,7 @@ struct PowerPCState
   u32 pagetable_hashmask;
 
   InstructionCache iCache;
+  DataCache dCache;
 };
 
 #if _M_X86_64
@@ -274,10 +275,18 @@ void Write_F64(double var, u32 address);
 void DMA_LCToMemory(u32 memAddr, u32 cacheAddr, u32 numBlocks);
 void DMA_MemoryToLC(u32 cacheAddr, u32 memAddr, u32 numBlocks);
 void ClearCacheLine(u32 address);  // Zeroes 32 bytes; address should be 32-byte-aligned
+// dcbf, dcbst and dcbi on the emulated data cache, no-ops when it is disabled.
+void FlushCacheLine(u32 address);
+void StoreCacheLine(u32 address);
+void InvalidateCacheLine(u32 address);
 
 // TLB functions
 void SDRUpdated();
 void InvalidateTLBEntry(u32 address);
+// Translates a data access through the page table for the fastmem fault handler, setting the
+// referenced bit, and the changed bit for a store, like the access itself would. Returns false if
+// translation is off, a BAT maps the address or the page table doesn't.
+bool TranslatePageTableAddress(u32 address, bool write, u32* physical_address, bool* changed);
 void DBATUpdated();
 void IBATUpdated();
 
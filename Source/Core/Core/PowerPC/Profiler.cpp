@@ -4,17 +4,144 @@
 
 #include "Core/PowerPC/Profiler.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/Event.h"
+#include "Common/File.h"
+#include "Common/MsgHandler.h"
 #include "Common/PerformanceCounter.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
+#include "Core/PowerPC/PowerPC.h"
 
 namespace Profiler
 {
 bool g_ProfileBlocks = false;
+std::atomic<bool> g_sample_requested{false};
+
+// Frames beyond this are left out, the back chain of a corrupted stack may never end.
+constexpr size_t MAX_STACK_DEPTH = 64;
+
+static std::thread s_sampler_thread;
+static Common::Event s_sampler_stop;
+static bool s_sampling = false;
+
+// Innermost function first, by symbol address (or instruction address without a symbol).
+static std::map<std::vector<u32>, u64> s_samples;
+static std::mutex s_samples_mutex;
 
 void WriteProfileResults(const std::string& filename)
 {
   JitInterface::WriteProfileResults(filename);
 }
 
+static void SamplerThread(u32 interval_us)
+{
+  Common::SetCurrentThreadName("Profiler sampler");
+  while (!s_sampler_stop.WaitFor(std::chrono::microseconds(interval_us)))
+    g_sample_requested.store(true, std::memory_order_relaxed);
+}
+
+void StartSampling(u32 interval_us)
+{
+  if (s_sampling)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(s_samples_mutex);
+    s_samples.clear();
+  }
+  s_sampler_stop.Reset();
+  s_sampler_thread = std::thread(SamplerThread, std::max<u32>(interval_us, 100));
+  s_sampling = true;
+}
+
+void StopSampling()
+{
+  if (!s_sampling)
+    return;
+
+  s_sampler_stop.Set();
+  s_sampler_thread.join();
+  g_sample_requested.store(false, std::memory_order_relaxed);
+  s_sampling = false;
+}
+
+bool IsSampling()
+{
+  return s_sampling;
+}
+
+static void AddFrame(std::vector<u32>* stack, u32 address)
+{
+  const Symbol* symbol = g_symbolDB.GetSymbolFromAddr(address);
+  const u32 function = symbol ? symbol->address : address;
+  // A function that hasn't saved LR yet shows up both as LR and in the back chain.
+  if (stack->empty() || stack->back() != function)
+    stack->push_back(function);
+}
+
+void TakeSample()
+{
+  g_sample_requested.store(false, std::memory_order_relaxed);
+
+  std::vector<u32> stack;
+  AddFrame(&stack, PC);
+  if (LR != 0)
+    AddFrame(&stack, LR - 4);
+
+  // Follow the back chain, the word after each frame pointer is a saved LR.
+  u32 frame = PowerPC::ppcState.gpr[1];
+  while (stack.size() < MAX_STACK_DEPTH && frame && PowerPC::HostIsRAMAddress(frame) &&
+         PowerPC::HostIsRAMAddress(frame + 4))
+  {
+    frame = PowerPC::HostRead_U32(frame);
+    if (!frame || !PowerPC::HostIsRAMAddress(frame + 4))
+      break;
+    const u32 return_address = PowerPC::HostRead_U32(frame + 4);
+    if (!return_address)
+      break;
+    AddFrame(&stack, return_address - 4);
+  }
+
+  std::lock_guard<std::mutex> lock(s_samples_mutex);
+  ++s_samples[stack];
+}
+
+void WriteSampleResults(const std::string& filename)
+{
+  File::IOFile f(filename, "w");
+  if (!f)
+  {
+    PanicAlert("Failed to open %s", filename.c_str());
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(s_samples_mutex);
+  for (const auto& sample : s_samples)
+  {
+    std::string line;
+    for (auto it = sample.first.rbegin(); it != sample.first.rend(); ++it)
+    {
+      const Symbol* symbol = g_symbolDB.GetSymbolFromAddr(*it);
+      std::string name = symbol ? symbol->function_name : StringFromFormat("%08x", *it);
+      // The separator of the folded format.
+      std::replace(name.begin(), name.end(), ';', ':');
+      if (!line.empty())
+        line += ';';
+      line += name;
+    }
+    fprintf(f.GetHandle(), "%s %" PRIu64 "\n", line.c_str(), sample.second);
+  }
+}
+
 }  // namespace
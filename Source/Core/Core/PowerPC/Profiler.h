@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <string>
 #include <vector>
@@ -30,6 +31,10 @@ struct ProfileStats
   u64 cost_sum;
   u64 timecost_sum;
   u64 countsPerSec;
+  // Backpatched fastmem faults, and the loads and stores that use the checked access because of
+  // them.
+  u64 fastmem_faults = 0;
+  u64 fastmem_fault_addresses = 0;
 };
 
 namespace Profiler
@@ -37,4 +42,18 @@ namespace Profiler
 extern bool g_ProfileBlocks;
 
 void WriteProfileResults(const std::string& filename);
+
+// Sampling profiler. Unlike block profiling it doesn't change the generated code: a host thread
+// requests a sample at a fixed interval, and the CPU thread takes it at the next
+// CoreTiming::Advance, where PC is exact even with linked JIT blocks. A sample is the guest call
+// stack, folded to the functions in g_symbolDB.
+extern std::atomic<bool> g_sample_requested;
+
+void StartSampling(u32 interval_us = 1000);
+void StopSampling();
+bool IsSampling();
+void TakeSample();
+// Writes one "outermost;...;innermost count" line per call stack, the folded stack format read
+// by flamegraph.pl and speedscope.
+void WriteSampleResults(const std::string& filename);
 }
@@ -11,10 +11,12 @@
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
+#include "Common/ThreadPool.h"
 
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -102,15 +104,14 @@ bool GetRefs(MEGASignature* sig, std::istringstream* iss)
   return true;
 }
 
-bool Compare(u32 address, u32 size, const MEGASignature& sig)
+bool Compare(const std::vector<u32>& code, const MEGASignature& sig)
 {
-  if (size != sig.code.size() * sizeof(u32))
+  if (code.size() != sig.code.size())
     return false;
 
   for (size_t i = 0; i < sig.code.size(); ++i)
   {
-    if (sig.code[i] != 0 &&
-        PowerPC::HostRead_U32(static_cast<u32>(address + i * sizeof(u32))) != sig.code[i])
+    if (sig.code[i] != 0 && code[i] != sig.code[i])
       return false;
   }
   return true;
@@ -123,6 +124,7 @@ MEGASignatureDB::~MEGASignatureDB() = default;
 void MEGASignatureDB::Clear()
 {
   m_signatures.clear();
+  m_size_index.clear();
 }
 
 bool MEGASignatureDB::Load(const std::string& file_path)
@@ -141,6 +143,7 @@ bool MEGASignatureDB::Load(const std::string& file_path)
 
     if (GetCode(&sig, &iss) && GetName(&sig, &iss) && GetRefs(&sig, &iss))
     {
+      m_size_index[static_cast<u32>(sig.code.size() * sizeof(u32))].push_back(m_signatures.size());
       m_signatures.push_back(std::move(sig));
     }
     else
@@ -159,19 +162,54 @@ bool MEGASignatureDB::Save(const std::string& file_path) const
 
 void MEGASignatureDB::Apply(PPCSymbolDB* symbol_db) const
 {
+  struct Candidate
+  {
+    Symbol* symbol;
+    const std::vector<size_t>* signatures;
+    std::vector<u32> code;
+    const MEGASignature* match;
+  };
+
+  // Guest memory is read up front, matching the code against the signatures is then
+  // independent per symbol and spread over the thread pool.
+  std::vector<Candidate> candidates;
   for (auto& it : symbol_db->AccessSymbols())
   {
-    auto& symbol = it.second;
-    for (const auto& sig : m_signatures)
-    {
-      if (Compare(symbol.address, symbol.size, sig))
-      {
-        symbol.name = sig.name;
-        INFO_LOG(SYMBOLS, "Found %s at %08x (size: %08x)!", sig.name.c_str(), symbol.address,
-                 symbol.size);
-        break;
-      }
-    }
+    Symbol& symbol = it.second;
+    const auto index = m_size_index.find(static_cast<u32>(symbol.size));
+    if (index == m_size_index.end())
+      continue;
+
+    std::vector<u32> code(symbol.size / sizeof(u32));
+    for (size_t i = 0; i < code.size(); ++i)
+      code[i] = PowerPC::HostRead_U32(static_cast<u32>(symbol.address + i * sizeof(u32)));
+    candidates.push_back({&symbol, &index->second, std::move(code), nullptr});
+  }
+
+  Common::ParallelForWorker::Loop(
+      0, static_cast<s32>(candidates.size()), 64, [&](s32 begin, s32 end) {
+        for (s32 i = begin; i < end; ++i)
+        {
+          Candidate& candidate = candidates[i];
+          for (size_t sig_index : *candidate.signatures)
+          {
+            if (Compare(candidate.code, m_signatures[sig_index]))
+            {
+              candidate.match = &m_signatures[sig_index];
+              break;
+            }
+          }
+        }
+      });
+
+  for (const Candidate& candidate : candidates)
+  {
+    if (!candidate.match)
+      continue;
+    Symbol& symbol = *candidate.symbol;
+    symbol.name = candidate.match->name;
+    INFO_LOG(SYMBOLS, "Found %s at %08x (size: %08x)!", symbol.name.c_str(), symbol.address,
+             symbol.size);
   }
   symbol_db->Index();
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -54,4 +55,6 @@ public:
 
 private:
   std::vector<MEGASignature> m_signatures;
+  // Indices into m_signatures by code size in bytes, only functions of the same size can match.
+  std::unordered_map<u32, std::vector<size_t>> m_size_index;
 };
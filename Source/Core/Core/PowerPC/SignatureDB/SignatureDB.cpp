@@ -122,22 +122,28 @@ void HashSignatureDB::Clear()
 
 void HashSignatureDB::Apply(PPCSymbolDB* symbol_db) const
 {
-  for (const auto& entry : m_database)
+  // A game has far fewer functions than the databases have entries, so look up each function's
+  // hash instead of each database entry's.
+  for (auto& it : symbol_db->AccessSymbols())
   {
-    for (const auto& function : symbol_db->GetSymbolsFromHash(entry.first))
+    Symbol& function = it.second;
+    if (function.type != Symbol::Type::Function)
+      continue;
+    const auto entry = m_database.find(function.hash);
+    if (entry == m_database.end())
+      continue;
+
+    // Found the function. Let's rename it according to the symbol file.
+    function.Rename(entry->second.name);
+    if (entry->second.size == static_cast<unsigned int>(function.size))
     {
-      // Found the function. Let's rename it according to the symbol file.
-      function->Rename(entry.second.name);
-      if (entry.second.size == static_cast<unsigned int>(function->size))
-      {
-        INFO_LOG(SYMBOLS, "Found %s at %08x (size: %08x)!", entry.second.name.c_str(),
-                 function->address, function->size);
-      }
-      else
-      {
-        ERROR_LOG(SYMBOLS, "Wrong size! Found %s at %08x (size: %08x instead of %08x)!",
-                  entry.second.name.c_str(), function->address, function->size, entry.second.size);
-      }
+      INFO_LOG(SYMBOLS, "Found %s at %08x (size: %08x)!", entry->second.name.c_str(),
+               function.address, function.size);
+    }
+    else
+    {
+      ERROR_LOG(SYMBOLS, "Wrong size! Found %s at %08x (size: %08x instead of %08x)!",
+                entry->second.name.c_str(), function.address, function.size, entry->second.size);
     }
   }
   symbol_db->Index();
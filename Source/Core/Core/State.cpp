@@ -4,6 +4,11 @@
 
 #include "Core/State.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <deque>
 #include <lzo/lzo1x.h>
 #include <map>
 #include <mutex>
@@ -21,6 +26,7 @@
 #include "Common/ScopeGuard.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 #include "Common/Timer.h"
 #include "Common/Version.h"
 
@@ -29,6 +35,7 @@
 #include "Core/CoreTiming.h"
 #include "Core/GeckoCode.h"
 #include "Core/HW/HW.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/Wiimote.h"
 #include "Core/Host.h"
 #include "Core/Movie.h"
@@ -36,6 +43,7 @@
 #include "Core/PowerPC/PowerPC.h"
 
 #include "VideoCommon/AVIDump.h"
+#include "VideoCommon/Fifo.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoBackendBase.h"
 
@@ -51,12 +59,13 @@ static const u32 IN_LEN = 128 * 1024u;
 
 static const u32 OUT_LEN = IN_LEN + (IN_LEN / 16) + 64 + 3;
 
-static unsigned char __LZO_MMODEL out[OUT_LEN];
+// Chunks are compressed independently, so a batch of them is compressed in parallel before
+// being written out in order. This bounds the extra memory used to about BATCH_CHUNKS * OUT_LEN.
+static const u32 BATCH_CHUNKS = 64;
 
-#define HEAP_ALLOC(var, size)                                                                      \
-  lzo_align_t __LZO_MMODEL var[((size) + (sizeof(lzo_align_t) - 1)) / sizeof(lzo_align_t)]
-
-static HEAP_ALLOC(wrkmem, LZO1X_1_MEM_COMPRESS);
+// Compressed states are read in slices this large, and the chunks of each slice are decompressed
+// while the next one is read.
+static const size_t LOAD_READ_SLICE = 4 * 1024 * 1024;
 
 static std::string g_last_filename;
 
@@ -65,6 +74,8 @@ static AfterLoadCallbackFunc s_on_after_load_callback;
 // Temporary undo state buffer
 static std::vector<u8> g_undo_load_buffer;
 static std::vector<u8> g_current_buffer;
+// Kept between loads, so reloading a state over and over doesn't fault in fresh memory each time
+static std::vector<u8> g_load_buffer;
 static int g_loadDepth = 0;
 
 static std::mutex g_cs_undo_load_buffer;
@@ -73,8 +84,26 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 
 static std::thread g_save_thread;
 
+// Rewind buffer. The newest snapshot is kept whole, and each older one is stored as the pages
+// in which it differs from the snapshot taken after it.
+static const size_t REWIND_PAGE_SIZE = 4096;
+
+struct RewindDelta
+{
+  size_t size;
+  std::vector<u32> pages;
+  std::vector<u8> data;
+};
+
+static std::mutex g_cs_rewind;
+static std::vector<u8> g_rewind_current;
+static std::deque<RewindDelta> g_rewind_deltas;  // oldest first
+static size_t g_rewind_delta_bytes = 0;
+static u32 g_rewind_field_count = 0;
+static std::atomic<bool> g_rewind_capture_queued{false};
+
 // Don't forget to increase this after doing changes on the savestate system
-static const u32 STATE_VERSION = 94;  // Last changed in PR 6456
+static const u32 STATE_VERSION = 95;  // Last changed in PR 6456
 
 // Maps savestate versions to Dolphin versions.
 // Versions after 42 don't need to be added to this list,
@@ -200,6 +229,21 @@ static std::string DoState(PointerWrap& p)
   return version_created_by;
 }
 
+// States are also saved and loaded from the CPU thread itself (e.g. by netplay and movie
+// keyframes at the end of a field), which then has to stop the GPU thread on its own.
+static void RunWithEmulationPaused(const std::function<void()>& function)
+{
+  if (!Core::IsCPUThread())
+  {
+    Core::RunAsCPUThread(function);
+    return;
+  }
+
+  Fifo::PauseAndLock(true, false);
+  function();
+  Fifo::PauseAndLock(false, true);
+}
+
 void LoadFromBuffer(std::vector<u8>& buffer)
 {
   if (NetPlay::IsNetPlayRunning())
@@ -208,7 +252,7 @@ void LoadFromBuffer(std::vector<u8>& buffer)
     return;
   }
 
-  Core::RunAsCPUThread([&] {
+  RunWithEmulationPaused([&] {
     u8* ptr = &buffer[0];
     PointerWrap p(&ptr, PointerWrap::MODE_READ);
     DoState(p);
@@ -217,7 +261,7 @@ void LoadFromBuffer(std::vector<u8>& buffer)
 
 void SaveToBuffer(std::vector<u8>& buffer)
 {
-  Core::RunAsCPUThread([&] {
+  RunWithEmulationPaused([&] {
     u8* ptr = nullptr;
     PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
 
@@ -230,6 +274,52 @@ void SaveToBuffer(std::vector<u8>& buffer)
     DoState(p);
   });
 }
+
+Snapshot::Snapshot() : memory(std::make_unique<Memory::RAMSnapshot>())
+{
+}
+
+Snapshot::~Snapshot() = default;
+
+void SaveToSnapshot(Snapshot& snapshot)
+{
+  RunWithEmulationPaused([&] {
+    Memory::SetDoStateSkipsRAM(true);
+    Common::ScopeGuard skip_guard([] { Memory::SetDoStateSkipsRAM(false); });
+
+    u8* ptr = nullptr;
+    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+
+    DoState(p);
+    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
+    snapshot.state.resize(buffer_size);
+
+    ptr = &snapshot.state[0];
+    p.SetMode(PointerWrap::MODE_WRITE);
+    DoState(p);
+
+    Memory::SaveRAMSnapshot(*snapshot.memory);
+  });
+}
+
+void LoadFromSnapshot(const Snapshot& snapshot)
+{
+  if (snapshot.state.empty())
+    return;
+
+  RunWithEmulationPaused([&] {
+    Memory::SetDoStateSkipsRAM(true);
+    Common::ScopeGuard skip_guard([] { Memory::SetDoStateSkipsRAM(false); });
+
+    // PointerWrap doesn't write to the buffer in MODE_READ.
+    u8* ptr = const_cast<u8*>(snapshot.state.data());
+    PointerWrap p(&ptr, PointerWrap::MODE_READ);
+    DoState(p);
+
+    Memory::LoadRAMSnapshot(*snapshot.memory);
+  });
+}
+
 // return state number not in map
 static int GetEmptySlot(std::map<double, int> m)
 {
@@ -277,6 +367,182 @@ static std::map<double, int> GetSavedStates()
   return m;
 }
 
+// States are stored as IN_LEN sized chunks, each prefixed by its compressed size. The last chunk
+// is always shorter than IN_LEN (possibly empty), which marks the end.
+static bool CompressChunks(const u8* buffer_data, size_t buffer_size,
+                           const std::function<void(const u8*, size_t)>& write)
+{
+  const size_t chunk_count = buffer_size / IN_LEN + 1;
+  std::vector<u8> batch_out(std::min<size_t>(chunk_count, BATCH_CHUNKS) * OUT_LEN);
+  std::array<lzo_uint, BATCH_CHUNKS> batch_lengths;
+  std::atomic<bool> failed{false};
+
+  for (size_t batch = 0; batch < chunk_count; batch += BATCH_CHUNKS)
+  {
+    const s32 batch_size = static_cast<s32>(std::min<size_t>(chunk_count - batch, BATCH_CHUNKS));
+    Common::ParallelForWorker::Loop(0, batch_size, 1, [&](s32 begin, s32 end) {
+      std::vector<lzo_align_t> wrkmem((LZO1X_1_MEM_COMPRESS + sizeof(lzo_align_t) - 1) /
+                                      sizeof(lzo_align_t));
+      for (s32 i = begin; i < end; ++i)
+      {
+        const size_t offset = (batch + i) * IN_LEN;
+        const lzo_uint cur_len =
+            static_cast<lzo_uint>(std::min<size_t>(buffer_size - offset, IN_LEN));
+        if (lzo1x_1_compress(buffer_data + offset, cur_len, &batch_out[i * OUT_LEN],
+                             &batch_lengths[i], wrkmem.data()) != LZO_E_OK)
+        {
+          failed = true;
+        }
+      }
+    });
+
+    for (s32 i = 0; i < batch_size; ++i)
+    {
+      // The size of the data to write is 'out_len'
+      const lzo_uint32 out_len = static_cast<lzo_uint32>(batch_lengths[i]);
+      write(reinterpret_cast<const u8*>(&out_len), sizeof(out_len));
+      write(&batch_out[i * OUT_LEN], out_len);
+    }
+  }
+
+  return !failed;
+}
+
+// Decompresses the chunk with the given index into its place in buffer.
+static int DecompressChunk(const u8* compressed, lzo_uint32 compressed_len, size_t index,
+                           std::vector<u8>& buffer, std::atomic<size_t>& total_len)
+{
+  const size_t offset = index * IN_LEN;
+  if (offset > buffer.size())
+    return LZO_E_OUTPUT_OVERRUN;
+
+  lzo_uint new_len = static_cast<lzo_uint>(std::min<size_t>(buffer.size() - offset, IN_LEN));
+  const int res =
+      lzo1x_decompress_safe(compressed, compressed_len, buffer.data() + offset, &new_len, nullptr);
+  total_len += new_len;
+  return res;
+}
+
+static bool CheckDecompressResult(int result, size_t total_len, const std::vector<u8>& buffer)
+{
+  if (result != LZO_E_OK || total_len != buffer.size())
+  {
+    // This doesn't seem to happen anymore.
+    PanicAlertT("Internal LZO Error - decompression failed (%d) (%li, %li) \n"
+                "Try loading the state again",
+                result, static_cast<long>(total_len), static_cast<long>(buffer.size()));
+    return false;
+  }
+
+  return true;
+}
+
+// The buffer has to be sized to the uncompressed size already.
+static bool DecompressChunks(const u8* compressed, size_t compressed_size, std::vector<u8>& buffer)
+{
+  // Find the chunks in the compressed data, then decompress them in parallel. Every chunk but
+  // the last holds exactly IN_LEN bytes.
+  std::vector<std::pair<size_t, lzo_uint32>> chunks;
+  for (size_t pos = 0; pos + sizeof(lzo_uint32) <= compressed_size;)
+  {
+    lzo_uint32 cur_len;  // number of bytes to read
+    std::memcpy(&cur_len, &compressed[pos], sizeof(cur_len));
+    pos += sizeof(cur_len);
+    if (cur_len > compressed_size - pos)
+      break;
+    chunks.emplace_back(pos, cur_len);
+    pos += cur_len;
+  }
+
+  std::atomic<int> result{LZO_E_OK};
+  std::atomic<size_t> total_len{0};
+  const s32 chunk_count = static_cast<s32>(chunks.size());
+  Common::ParallelForWorker::Loop(0, chunk_count, 1, [&](s32 begin, s32 end) {
+    for (s32 i = begin; i < end; ++i)
+    {
+      const int res = DecompressChunk(&compressed[chunks[i].first], chunks[i].second, i, buffer,
+                                      total_len);
+      if (res != LZO_E_OK)
+        result = res;
+    }
+  });
+
+  return CheckDecompressResult(result, total_len, buffer);
+}
+
+// Like DecompressChunks, but reads the compressed data from the file itself. Chunks are
+// decompressed on the thread pool as soon as they have been read, overlapping the rest of the
+// read.
+static bool ReadAndDecompressChunks(File::IOFile& f, size_t compressed_size,
+                                    std::vector<u8>& buffer)
+{
+  // Not a vector, there is no point in zeroing it first.
+  std::unique_ptr<u8[]> compressed(new u8[compressed_size]);
+  std::atomic<int> result{LZO_E_OK};
+  std::atomic<size_t> total_len{0};
+  Common::TaskGroup tasks;
+
+  size_t read_pos = 0;
+  size_t parse_pos = 0;
+  size_t chunk_index = 0;
+  while (read_pos < compressed_size)
+  {
+    const size_t slice = std::min(compressed_size - read_pos, LOAD_READ_SLICE);
+    if (!f.ReadBytes(&compressed[read_pos], slice))
+    {
+      tasks.Wait();
+      PanicAlert("wtf? reading bytes: %zu", compressed_size);
+      return false;
+    }
+    read_pos += slice;
+
+    // Queue every chunk that is complete now.
+    while (parse_pos + sizeof(lzo_uint32) <= read_pos)
+    {
+      lzo_uint32 cur_len;
+      std::memcpy(&cur_len, &compressed[parse_pos], sizeof(cur_len));
+      const size_t data_pos = parse_pos + sizeof(cur_len);
+      if (cur_len > compressed_size - data_pos)
+      {
+        // Truncated, the size check below reports it.
+        parse_pos = compressed_size;
+        break;
+      }
+      if (data_pos + cur_len > read_pos)
+        break;
+
+      const u8* data = &compressed[data_pos];
+      const size_t index = chunk_index++;
+      tasks.Run([data, cur_len, index, &buffer, &result, &total_len] {
+        const int res = DecompressChunk(data, cur_len, index, buffer, total_len);
+        if (res != LZO_E_OK)
+          result = res;
+      });
+      parse_pos = data_pos + cur_len;
+    }
+  }
+  tasks.Wait();
+
+  return CheckDecompressResult(result, total_len, buffer);
+}
+
+// Movie keyframes use the same format as the savestate files, without the header.
+void CompressState(const std::vector<u8>& state, std::vector<u8>& compressed)
+{
+  compressed.clear();
+  if (!CompressChunks(state.data(), state.size(), [&](const u8* data, size_t size) {
+        compressed.insert(compressed.end(), data, data + size);
+      }))
+  {
+    PanicAlertT("Internal LZO Error - compression failed");
+  }
+}
+
+bool DecompressState(const std::vector<u8>& compressed, std::vector<u8>& state)
+{
+  return DecompressChunks(compressed.data(), compressed.size(), state);
+}
+
 struct CompressAndDumpState_args
 {
   std::vector<u8>* buffer_vector;
@@ -345,32 +611,10 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
 
   if (header.size != 0)  // non-zero header size means the state is compressed
   {
-    lzo_uint i = 0;
-    while (true)
+    if (!CompressChunks(buffer_data, buffer_size,
+                        [&](const u8* data, size_t size) { f.WriteBytes(data, size); }))
     {
-      lzo_uint32 cur_len = 0;
-      lzo_uint out_len = 0;
-
-      if ((i + IN_LEN) >= buffer_size)
-      {
-        cur_len = (lzo_uint32)(buffer_size - i);
-      }
-      else
-      {
-        cur_len = IN_LEN;
-      }
-
-      if (lzo1x_1_compress(buffer_data + i, cur_len, out, &out_len, wrkmem) != LZO_E_OK)
-        PanicAlertT("Internal LZO Error - compression failed");
-
-      // The size of the data to write is 'out_len'
-      f.WriteArray((lzo_uint32*)&out_len, 1);
-      f.WriteBytes(out, out_len);
-
-      if (cur_len != IN_LEN)
-        break;
-
-      i += cur_len;
+      PanicAlertT("Internal LZO Error - compression failed");
     }
   }
   else  // uncompressed
@@ -453,6 +697,7 @@ std::string GetInfoStringOfSlot(int slot, bool translate)
 
 static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_data)
 {
+  ret_data.clear();
   Flush();
   File::IOFile f(filename, "rb");
   if (!f)
@@ -471,51 +716,32 @@ static void LoadFileStateData(const std::string& filename, std::vector<u8>& ret_
     return;
   }
 
-  std::vector<u8> buffer;
-
+  // ret_data keeps its memory from the previous load, resizing it doesn't allocate again.
   if (header.size != 0)  // non-zero size means the state is compressed
   {
     Core::DisplayMessage("Decompressing State...", 500);
 
-    buffer.resize(header.size);
+    ret_data.resize(header.size);
 
-    lzo_uint i = 0;
-    while (true)
+    if (!ReadAndDecompressChunks(f, static_cast<size_t>(f.GetSize() - sizeof(StateHeader)),
+                                 ret_data))
     {
-      lzo_uint32 cur_len = 0;  // number of bytes to read
-      lzo_uint new_len = 0;    // number of bytes to write
-
-      if (!f.ReadArray(&cur_len, 1))
-        break;
-
-      f.ReadBytes(out, cur_len);
-      const int res = lzo1x_decompress(out, cur_len, &buffer[i], &new_len, nullptr);
-      if (res != LZO_E_OK)
-      {
-        // This doesn't seem to happen anymore.
-        PanicAlertT("Internal LZO Error - decompression failed (%d) (%li, %li) \n"
-                    "Try loading the state again",
-                    res, i, new_len);
-        return;
-      }
-
-      i += new_len;
+      ret_data.clear();
+      return;
     }
   }
   else  // uncompressed
   {
     const size_t size = (size_t)(f.GetSize() - sizeof(StateHeader));
-    buffer.resize(size);
+    ret_data.resize(size);
 
-    if (!f.ReadBytes(&buffer[0], size))
+    if (!f.ReadBytes(&ret_data[0], size))
     {
       PanicAlert("wtf? reading bytes: %zu", size);
+      ret_data.clear();
       return;
     }
   }
-
-  // all good
-  ret_data.swap(buffer);
 }
 
 void LoadAs(const std::string& filename)
@@ -548,14 +774,13 @@ void LoadAs(const std::string& filename)
     bool loadedSuccessfully = false;
     std::string version_created_by;
 
-    // brackets here are so buffer gets freed ASAP
     {
-      std::vector<u8> buffer;
-      LoadFileStateData(filename, buffer);
+      // The next load reuses g_load_buffer, nothing may point into it after DoState.
+      LoadFileStateData(filename, g_load_buffer);
 
-      if (!buffer.empty())
+      if (!g_load_buffer.empty())
       {
-        u8* ptr = &buffer[0];
+        u8* ptr = &g_load_buffer[0];
         PointerWrap p(&ptr, PointerWrap::MODE_READ);
         version_created_by = DoState(p);
         loaded = true;
@@ -599,6 +824,119 @@ void SetOnAfterLoadCallback(AfterLoadCallbackFunc callback)
   s_on_after_load_callback = std::move(callback);
 }
 
+// Records the pages of older that differ from newer.
+static RewindDelta MakeRewindDelta(const std::vector<u8>& older, const std::vector<u8>& newer)
+{
+  RewindDelta delta;
+  delta.size = older.size();
+  for (size_t offset = 0; offset < older.size(); offset += REWIND_PAGE_SIZE)
+  {
+    const size_t len = std::min(REWIND_PAGE_SIZE, older.size() - offset);
+    if (offset + len <= newer.size() && std::memcmp(&older[offset], &newer[offset], len) == 0)
+      continue;
+
+    delta.pages.push_back(static_cast<u32>(offset / REWIND_PAGE_SIZE));
+    delta.data.insert(delta.data.end(), older.begin() + offset, older.begin() + offset + len);
+  }
+  return delta;
+}
+
+// Turns the snapshot a delta was made against back into the one before it.
+static void ApplyRewindDelta(std::vector<u8>& snapshot, const RewindDelta& delta)
+{
+  snapshot.resize(delta.size);
+  for (size_t i = 0; i < delta.pages.size(); ++i)
+  {
+    const size_t offset = delta.pages[i] * REWIND_PAGE_SIZE;
+    const size_t len = std::min(REWIND_PAGE_SIZE, delta.size - offset);
+    std::memcpy(&snapshot[offset], &delta.data[i * REWIND_PAGE_SIZE], len);
+  }
+}
+
+static void CaptureRewindSnapshot()
+{
+  if (!Core::IsRunningAndStarted())
+    return;
+
+  std::vector<u8> snapshot;
+  SaveToBuffer(snapshot);
+
+  std::lock_guard<std::mutex> lk(g_cs_rewind);
+  if (!g_rewind_current.empty())
+  {
+    g_rewind_deltas.push_back(MakeRewindDelta(g_rewind_current, snapshot));
+    g_rewind_delta_bytes += g_rewind_deltas.back().data.size();
+  }
+  g_rewind_current.swap(snapshot);
+
+  // Drop the oldest snapshots once over budget.
+  const size_t budget =
+      static_cast<size_t>(std::max(SConfig::GetInstance().m_rewind_buffer_size, 0)) << 20;
+  while (!g_rewind_deltas.empty() && g_rewind_current.size() + g_rewind_delta_bytes > budget)
+  {
+    g_rewind_delta_bytes -= g_rewind_deltas.front().data.size();
+    g_rewind_deltas.pop_front();
+  }
+}
+
+// Called from the CPU thread at the end of every field. The snapshot itself is taken from the
+// host thread, which pauses the CPU thread at a point where the state can be saved.
+void RewindFieldUpdate()
+{
+  const SConfig& config = SConfig::GetInstance();
+  if (!config.m_rewind_enabled || NetPlay::IsNetPlayRunning() || Movie::IsMovieActive())
+    return;
+
+  if (++g_rewind_field_count < static_cast<u32>(std::max(config.m_rewind_interval, 1)))
+    return;
+  g_rewind_field_count = 0;
+
+  if (g_rewind_capture_queued.exchange(true))
+    return;
+
+  Core::QueueHostJob([] {
+    CaptureRewindSnapshot();
+    g_rewind_capture_queued = false;
+  });
+}
+
+void Rewind()
+{
+  if (NetPlay::IsNetPlayRunning() || Movie::IsMovieActive())
+  {
+    Core::DisplayMessage("Rewinding is disabled during Netplay and movies", 2000);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lk(g_cs_rewind);
+  if (g_rewind_current.empty())
+  {
+    Core::DisplayMessage("Nothing to rewind", 2000);
+    return;
+  }
+
+  LoadFromBuffer(g_rewind_current);
+  g_rewind_field_count = 0;
+
+  // The next rewind goes one snapshot further back. The oldest one stays, so it can be
+  // returned to repeatedly.
+  if (!g_rewind_deltas.empty())
+  {
+    ApplyRewindDelta(g_rewind_current, g_rewind_deltas.back());
+    g_rewind_delta_bytes -= g_rewind_deltas.back().data.size();
+    g_rewind_deltas.pop_back();
+  }
+}
+
+void ClearRewindBuffer()
+{
+  std::lock_guard<std::mutex> lk(g_cs_rewind);
+  std::vector<u8>().swap(g_rewind_current);
+  g_rewind_deltas.clear();
+  g_rewind_delta_bytes = 0;
+  g_rewind_field_count = 0;
+}
+
 void Init()
 {
   if (lzo_init() != LZO_E_OK)
@@ -617,10 +955,14 @@ void Shutdown()
     std::vector<u8>().swap(g_current_buffer);
   }
 
+  std::vector<u8>().swap(g_load_buffer);
+
   {
     std::lock_guard<std::mutex> lk(g_cs_undo_load_buffer);
     std::vector<u8>().swap(g_undo_load_buffer);
   }
+
+  ClearRewindBuffer();
 }
 
 static std::string MakeStateFilename(int number)
@@ -7,11 +7,17 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "Common/CommonTypes.h"
 
+namespace Memory
+{
+struct RAMSnapshot;
+}
+
 namespace State
 {
 // number of states
@@ -50,11 +56,37 @@ void LoadAs(const std::string& filename);
 void SaveToBuffer(std::vector<u8>& buffer);
 void LoadFromBuffer(std::vector<u8>& buffer);
 
+// Compresses a buffer from SaveToBuffer the way state files are. DecompressState expects the
+// state to be resized to the uncompressed size already.
+void CompressState(const std::vector<u8>& state, std::vector<u8>& compressed);
+bool DecompressState(const std::vector<u8>& compressed, std::vector<u8>& state);
+
+// In-memory snapshots for rollback and run-ahead. RAM is kept separately from the rest of the
+// state, so that saving over (or loading from) a snapshot only copies the RAM pages written since.
+// Unlike LoadFromBuffer, loading a snapshot is allowed during Netplay.
+struct Snapshot
+{
+  Snapshot();
+  ~Snapshot();
+
+  std::unique_ptr<Memory::RAMSnapshot> memory;
+  std::vector<u8> state;
+};
+
+void SaveToSnapshot(Snapshot& snapshot);
+void LoadFromSnapshot(const Snapshot& snapshot);
+
 void LoadLastSaved(int i = 1);
 void SaveFirstSaved();
 void UndoSaveState();
 void UndoLoadState();
 
+// Rewind buffer. While enabled, a snapshot is taken every few fields and kept in memory, and
+// Rewind() steps back through them, newest first.
+void RewindFieldUpdate();
+void Rewind();
+void ClearRewindBuffer();
+
 // wait until previously scheduled savestate event (if any) is done
 void Flush();
 
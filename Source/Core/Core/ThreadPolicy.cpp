@@ -0,0 +1,169 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/ThreadPolicy.h"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
+#include "Core/Config/MainSettings.h"
+
+namespace ThreadPolicy
+{
+namespace
+{
+constexpr std::array<Role, 4> ROLES = {{Role::CPU, Role::GPU, Role::DSP, Role::Audio}};
+constexpr std::array<const char*, 4> ROLE_NAMES = {{"CPU", "GPU", "DSP", "Audio"}};
+constexpr std::array<const char*, 3> PRIORITY_NAMES = {{"normal", "high", "realtime"}};
+
+const Config::ConfigInfo<int>& GetAffinityInfo(Role role)
+{
+  switch (role)
+  {
+  case Role::CPU:
+    return Config::MAIN_CPU_THREAD_AFFINITY;
+  case Role::GPU:
+    return Config::MAIN_GPU_THREAD_AFFINITY;
+  case Role::DSP:
+    return Config::MAIN_DSP_THREAD_AFFINITY;
+  default:
+    return Config::MAIN_AUDIO_THREAD_AFFINITY;
+  }
+}
+
+const Config::ConfigInfo<int>& GetPriorityInfo(Role role)
+{
+  switch (role)
+  {
+  case Role::CPU:
+    return Config::MAIN_CPU_THREAD_PRIORITY;
+  case Role::GPU:
+    return Config::MAIN_GPU_THREAD_PRIORITY;
+  case Role::DSP:
+    return Config::MAIN_DSP_THREAD_PRIORITY;
+  default:
+    return Config::MAIN_AUDIO_THREAD_PRIORITY;
+  }
+}
+
+Affinity GetAffinity(Role role)
+{
+  return static_cast<Affinity>(std::clamp(Config::Get(GetAffinityInfo(role)),
+                                          static_cast<int>(Affinity::OSDefault),
+                                          static_cast<int>(Affinity::DedicatedCore)));
+}
+
+const std::vector<Common::LogicalCPU>& GetTopology()
+{
+  static const std::vector<Common::LogicalCPU> topology = Common::GetCPUTopology();
+  return topology;
+}
+
+u64 GetMask(bool performance_only)
+{
+  u64 mask = 0;
+  for (const Common::LogicalCPU& cpu : GetTopology())
+  {
+    if (cpu.performance || !performance_only)
+      mask |= 1ULL << cpu.index;
+  }
+  return mask;
+}
+
+u64 GetCoreMask(u32 core)
+{
+  u64 mask = 0;
+  for (const Common::LogicalCPU& cpu : GetTopology())
+  {
+    if (cpu.core == core)
+      mask |= 1ULL << cpu.index;
+  }
+  return mask;
+}
+
+// The roles take the physical performance cores in order. One is always left for everything
+// else, the OS included.
+std::optional<u32> GetDedicatedCore(Role role)
+{
+  std::vector<u32> cores;
+  for (const Common::LogicalCPU& cpu : GetTopology())
+  {
+    if (cpu.performance && std::find(cores.begin(), cores.end(), cpu.core) == cores.end())
+      cores.push_back(cpu.core);
+  }
+
+  const size_t index = static_cast<size_t>(role);
+  if (index + 1 >= cores.size())
+    return {};
+  return cores[index];
+}
+
+u64 GetAffinityMask(Role role, Affinity affinity)
+{
+  if (affinity == Affinity::DedicatedCore)
+  {
+    if (const std::optional<u32> core = GetDedicatedCore(role))
+      return GetCoreMask(*core);
+  }
+
+  u64 reserved = 0;
+  for (Role other : ROLES)
+  {
+    if (other == role || GetAffinity(other) != Affinity::DedicatedCore)
+      continue;
+    if (const std::optional<u32> core = GetDedicatedCore(other))
+      reserved |= GetCoreMask(*core);
+  }
+
+  const u64 mask = GetMask(true);
+  return (mask & ~reserved) ? mask & ~reserved : mask;
+}
+}  // Anonymous namespace
+
+void ApplyToCurrentThread(Role role)
+{
+  const char* name = ROLE_NAMES[static_cast<size_t>(role)];
+  const Affinity affinity = GetAffinity(role);
+  auto priority = static_cast<Common::ThreadPriority>(
+      std::clamp(Config::Get(GetPriorityInfo(role)), 0, 2));
+
+  std::string cpus = "any CPU";
+  if (affinity != Affinity::OSDefault)
+  {
+    const u64 mask = GetAffinityMask(role, affinity);
+    if (!mask)
+    {
+      WARN_LOG(CORE, "%s thread: the CPU topology is unknown, leaving its affinity to the OS",
+               name);
+    }
+    else if (!Common::SetCurrentThreadAffinity(mask))
+    {
+      WARN_LOG(CORE, "%s thread: failed to set the affinity mask %016" PRIx64, name, mask);
+    }
+    else if (mask != GetMask(false))
+    {
+      cpus = StringFromFormat("the CPUs in mask %016" PRIx64, mask);
+    }
+  }
+
+  if (priority != Common::ThreadPriority::Normal && !Common::SetCurrentThreadPriority(priority))
+  {
+    WARN_LOG(CORE, "%s thread: the OS refused %s priority", name,
+             PRIORITY_NAMES[static_cast<size_t>(priority)]);
+    priority = Common::ThreadPriority::Normal;
+  }
+
+  NOTICE_LOG(CORE, "%s thread runs on %s with %s priority", name, cpus.c_str(),
+             PRIORITY_NAMES[static_cast<size_t>(priority)]);
+}
+}  // namespace ThreadPolicy
@@ -0,0 +1,34 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+// Where the emulation threads run and how the scheduler treats them, configured per role in the
+// Core section of Dolphin.ini. Hybrid CPUs otherwise tend to put them on efficiency cores.
+namespace ThreadPolicy
+{
+enum class Role
+{
+  CPU,
+  GPU,
+  DSP,
+  Audio,
+};
+
+// Values of the *ThreadAffinity settings.
+enum class Affinity
+{
+  // Wherever the OS wants.
+  OSDefault = 0,
+  // The performance cores of hybrid CPUs, all cores otherwise. Skips the cores dedicated to the
+  // other roles, which keeps the other threads off the SMT siblings of the CPU thread.
+  PerformanceCores = 1,
+  // A physical performance core of its own, PerformanceCores if there aren't enough of them.
+  DedicatedCore = 2,
+};
+
+// Applies the affinity and priority configured for the role to the calling thread, and logs
+// what the thread ended up with.
+void ApplyToCurrentThread(Role role);
+}  // namespace ThreadPolicy
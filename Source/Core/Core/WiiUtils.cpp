@@ -9,6 +9,7 @@
 #include <cinttypes>
 #include <cstddef>
 #include <cstring>
+#include <future>
 #include <map>
 #include <memory>
 #include <optional>
@@ -85,9 +86,20 @@ static bool ImportWAD(IOS::HLE::Kernel& ios, const DiscIO::WiiWAD& wad)
 
   const bool contents_imported = [&]() {
     const u64 title_id = tmd.GetTitleId();
-    for (const IOS::ES::Content& content : tmd.GetContents())
+    const std::vector<IOS::ES::Content> contents = tmd.GetContents();
+    // The next content is read from the WAD while ES decrypts and writes the current one.
+    const auto read_content = [&wad](u16 index) {
+      return std::async(std::launch::async, [&wad, index] { return wad.GetContent(index); });
+    };
+    std::future<std::vector<u8>> next_data;
+    if (!contents.empty())
+      next_data = read_content(contents[0].index);
+    for (size_t i = 0; i < contents.size(); ++i)
     {
-      const std::vector<u8> data = wad.GetContent(content.index);
+      const IOS::ES::Content& content = contents[i];
+      const std::vector<u8> data = next_data.get();
+      if (i + 1 < contents.size())
+        next_data = read_content(contents[i + 1].index);
 
       if (es->ImportContentBegin(context, title_id, content.id) < 0 ||
         es->ImportContentData(context, 0, data.data(), static_cast<u32>(data.size())) < 0 ||
@@ -16,6 +16,7 @@
 #include "DiscIO/Blob.h"
 #include "DiscIO/CISOBlob.h"
 #include "DiscIO/CompressedBlob.h"
+#include "DiscIO/DCZBlob.h"
 #include "DiscIO/DirectoryBlob.h"
 #include "DiscIO/DriveBlob.h"
 #include "DiscIO/FileBlob.h"
@@ -198,6 +199,8 @@ std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename)
     return CISOFileReader::Create(std::move(file));
   case GCZ_MAGIC:
     return CompressedBlobReader::Create(std::move(file), filename);
+  case DCZ_MAGIC:
+    return DCZFileReader::Create(std::move(file), filename);
   case TGC_MAGIC:
     return TGCFileReader::Create(std::move(file));
   case WBFS_MAGIC:
@@ -206,7 +209,7 @@ std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename)
     if (auto directory_blob = DirectoryBlobReader::Create(filename))
       return std::move(directory_blob);
 
-    return PlainFileReader::Create(std::move(file));
+    return PlainFileReader::Create(std::move(file), filename);
   }
 }
 
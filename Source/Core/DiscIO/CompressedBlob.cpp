@@ -8,6 +8,7 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cstdio>
 #include <cstring>
@@ -24,12 +25,16 @@
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
+#include "Common/ThreadPool.h"
 #include "DiscIO/Blob.h"
 #include "DiscIO/CompressedBlob.h"
 #include "DiscIO/DiscScrubber.h"
 
 namespace DiscIO
 {
+// Input and output buffered per batch of blocks that are compressed in parallel.
+static constexpr u32 COMPRESS_BATCH_BYTES = 16 * 1024 * 1024;
+
 bool IsGCZBlob(File::IOFile& file);
 
 CompressedBlobReader::CompressedBlobReader(File::IOFile file, const std::string& filename)
@@ -75,9 +80,9 @@ CompressedBlobReader::~CompressedBlobReader()
 // IMPORTANT: Calling this function invalidates all earlier pointers gotten from this function.
 u64 CompressedBlobReader::GetBlockCompressedSize(u64 block_num) const
 {
-  u64 start = m_block_pointers[block_num];
+  u64 start = GetBlockOffset(block_num);
   if (block_num < m_header.num_blocks - 1)
-    return m_block_pointers[block_num + 1] - start;
+    return GetBlockOffset(block_num + 1) - start;
   else if (block_num == m_header.num_blocks - 1)
     return m_header.compressed_data_size - start;
   else
@@ -85,19 +90,15 @@ u64 CompressedBlobReader::GetBlockCompressedSize(u64 block_num) const
   return 0;
 }
 
+u64 CompressedBlobReader::GetBlockOffset(u64 block_num) const
+{
+  return m_block_pointers[block_num] & ~(1ULL << 63);
+}
+
 bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
 {
-  bool uncompressed = false;
   u32 comp_block_size = (u32)GetBlockCompressedSize(block_num);
-  u64 offset = m_block_pointers[block_num] + m_data_offset;
-
-  if (offset & (1ULL << 63))
-  {
-    if (comp_block_size != m_header.block_size)
-      PanicAlert("Uncompressed block with wrong size");
-    uncompressed = true;
-    offset &= ~(1ULL << 63);
-  }
+  u64 offset = GetBlockOffset(block_num) + m_data_offset;
 
   // clear unused part of zlib buffer. maybe this can be deleted when it works fully.
   memset(&m_zlib_buffer[comp_block_size], 0, m_zlib_buffer.size() - comp_block_size);
@@ -111,8 +112,54 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
     return false;
   }
 
+  return DecompressBlock(block_num, m_zlib_buffer.data(), comp_block_size, out_ptr);
+}
+
+bool CompressedBlobReader::ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr)
+{
+  if (num_blocks <= 1)
+    return num_blocks == 0 || GetBlock(block_num, out_ptr);
+
+  // The blocks are stored back to back, so they can be read from the file at once.
+  const u64 last_block = block_num + num_blocks - 1;
+  const u64 start = GetBlockOffset(block_num);
+  const u64 end = GetBlockOffset(last_block) + GetBlockCompressedSize(last_block);
+  m_batch_buffer.resize(end - start);
+
+  m_file.Seek(start + m_data_offset, SEEK_SET);
+  if (!m_file.ReadBytes(m_batch_buffer.data(), m_batch_buffer.size()))
+  {
+    PanicAlertT("The disc image \"%s\" is truncated, some of the data is missing.",
+                m_file_name.c_str());
+    m_file.Clear();
+    return false;
+  }
+
+  std::atomic<bool> success{true};
+  Common::ParallelForWorker::Loop(0, static_cast<s32>(num_blocks), 1, [&](s32 begin, s32 end) {
+    for (s32 i = begin; i < end; ++i)
+    {
+      const u64 block = block_num + i;
+      if (!DecompressBlock(block, &m_batch_buffer[GetBlockOffset(block) - start],
+                           (u32)GetBlockCompressedSize(block), out_ptr + i * m_header.block_size))
+      {
+        success = false;
+      }
+    }
+  });
+  return success;
+}
+
+// Only reads constant members, blocks are decompressed from several threads at once.
+bool CompressedBlobReader::DecompressBlock(u64 block_num, const u8* data, u32 comp_block_size,
+                                           u8* out_ptr) const
+{
+  const bool uncompressed = (m_block_pointers[block_num] & (1ULL << 63)) != 0;
+  if (uncompressed && comp_block_size != m_header.block_size)
+    PanicAlert("Uncompressed block with wrong size");
+
   // First, check hash.
-  u32 block_hash = HashAdler32(m_zlib_buffer.data(), comp_block_size);
+  u32 block_hash = HashAdler32(data, comp_block_size);
   if (block_hash != m_hashes[block_num])
     PanicAlertT("The disc image \"%s\" is corrupt.\n"
                 "Hash of block %" PRIu64 " is %08x instead of %08x.",
@@ -120,12 +167,12 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
 
   if (uncompressed)
   {
-    std::copy(m_zlib_buffer.begin(), m_zlib_buffer.begin() + comp_block_size, out_ptr);
+    std::copy(data, data + comp_block_size, out_ptr);
   }
   else
   {
     z_stream z = {};
-    z.next_in = m_zlib_buffer.data();
+    z.next_in = const_cast<u8*>(data);
     z.avail_in = comp_block_size;
     if (z.avail_in > m_header.block_size)
     {
@@ -193,10 +240,6 @@ bool CompressFileToBlob(const std::string& infile_path, const std::string& outfi
     scrubbing = true;
   }
 
-  z_stream z = {};
-  if (deflateInit(&z, 9) != Z_OK)
-    return false;
-
   callback(GetStringT("Files opened, ready to compress."), 0, arg);
 
   CompressedBlobHeader header;
@@ -210,8 +253,14 @@ bool CompressFileToBlob(const std::string& infile_path, const std::string& outfi
 
   std::vector<u64> offsets(header.num_blocks);
   std::vector<u32> hashes(header.num_blocks);
-  std::vector<u8> out_buf(block_size);
-  std::vector<u8> in_buf(block_size);
+
+  // Blocks are read in batches on this thread (the scrubber has to see them in order), deflated
+  // in parallel, then written out in order.
+  const u32 batch_blocks = std::max<u32>(1, COMPRESS_BATCH_BYTES / block_size);
+  std::vector<u8> out_buf(static_cast<size_t>(batch_blocks) * block_size);
+  std::vector<u8> in_buf(static_cast<size_t>(batch_blocks) * block_size);
+  // Compressed size of each block in the batch, 0 if it is stored as-is.
+  std::vector<int> comp_sizes(batch_blocks);
 
   // seek past the header (we will write it at the end)
   outfile.Seek(sizeof(CompressedBlobHeader), SEEK_CUR);
@@ -227,84 +276,113 @@ bool CompressFileToBlob(const std::string& infile_path, const std::string& outfi
   int progress_monitor = std::max<int>(1, header.num_blocks / 1000);
   bool success = true;
 
-  for (u32 i = 0; i < header.num_blocks; i++)
+  for (u32 batch = 0; batch < header.num_blocks && success; batch += batch_blocks)
   {
-    if (i % progress_monitor == 0)
+    const u32 batch_size = std::min(batch_blocks, header.num_blocks - batch);
+    for (u32 j = 0; j < batch_size; j++)
     {
-      const u64 inpos = infile.Tell();
-      int ratio = 0;
-      if (inpos != 0)
-        ratio = (int)(100 * position / inpos);
-
-      std::string temp =
-          StringFromFormat(GetStringT("%i of %i blocks. Compression ratio %i%%").c_str(), i,
-                           header.num_blocks, ratio);
-      bool was_cancelled = !callback(temp, (float)i / (float)header.num_blocks, arg);
-      if (was_cancelled)
+      const u32 i = batch + j;
+      if (i % progress_monitor == 0)
       {
-        success = false;
-        break;
+        const u64 inpos = infile.Tell();
+        int ratio = 0;
+        if (inpos != 0)
+          ratio = (int)(100 * position / inpos);
+
+        std::string temp =
+            StringFromFormat(GetStringT("%i of %i blocks. Compression ratio %i%%").c_str(), i,
+                             header.num_blocks, ratio);
+        bool was_cancelled = !callback(temp, (float)i / (float)header.num_blocks, arg);
+        if (was_cancelled)
+        {
+          success = false;
+          break;
+        }
       }
-    }
-
-    offsets[i] = position;
-
-    size_t read_bytes;
-    if (scrubbing)
-      read_bytes = disc_scrubber.GetNextBlock(infile, in_buf.data());
-    else
-      infile.ReadArray(in_buf.data(), header.block_size, &read_bytes);
-    if (read_bytes < header.block_size)
-      std::fill(in_buf.begin() + read_bytes, in_buf.begin() + header.block_size, 0);
 
-    int retval = deflateReset(&z);
-    z.next_in = in_buf.data();
-    z.avail_in = header.block_size;
-    z.next_out = out_buf.data();
-    z.avail_out = block_size;
+      u8* block = &in_buf[static_cast<size_t>(j) * block_size];
+      size_t read_bytes;
+      if (scrubbing)
+        read_bytes = disc_scrubber.GetNextBlock(infile, block);
+      else
+        infile.ReadArray(block, header.block_size, &read_bytes);
+      if (read_bytes < header.block_size)
+        std::fill(block + read_bytes, block + header.block_size, 0);
+    }
+    if (!success)
+      break;
 
-    if (retval != Z_OK)
+    std::atomic<bool> deflate_failed{false};
+    Common::ParallelForWorker::Loop(0, static_cast<s32>(batch_size), 1, [&](s32 begin, s32 end) {
+      z_stream z = {};
+      if (deflateInit(&z, 9) != Z_OK)
+      {
+        deflate_failed = true;
+        return;
+      }
+      for (s32 j = begin; j < end; ++j)
+      {
+        if (deflateReset(&z) != Z_OK)
+        {
+          deflate_failed = true;
+          break;
+        }
+        z.next_in = &in_buf[static_cast<size_t>(j) * block_size];
+        z.avail_in = header.block_size;
+        z.next_out = &out_buf[static_cast<size_t>(j) * block_size];
+        z.avail_out = block_size;
+
+        int status = deflate(&z, Z_FINISH);
+        if ((status != Z_STREAM_END) || (z.avail_out < 10))
+          comp_sizes[j] = 0;
+        else
+          comp_sizes[j] = block_size - z.avail_out;
+      }
+      deflateEnd(&z);
+    });
+    if (deflate_failed)
     {
       ERROR_LOG(DISCIO, "Deflate failed");
       success = false;
       break;
     }
 
-    int status = deflate(&z, Z_FINISH);
-    int comp_size = block_size - z.avail_out;
-
-    u8* write_buf;
-    int write_size;
-    if ((status != Z_STREAM_END) || (z.avail_out < 10))
-    {
-      // PanicAlert("%i %i Store %i", i*block_size, position, comp_size);
-      // let's store uncompressed
-      write_buf = in_buf.data();
-      offsets[i] |= 0x8000000000000000ULL;
-      write_size = block_size;
-      num_stored++;
-    }
-    else
+    for (u32 j = 0; j < batch_size; j++)
     {
-      // let's store compressed
-      // PanicAlert("Comp %i to %i", block_size, comp_size);
-      write_buf = out_buf.data();
-      write_size = comp_size;
-      num_compressed++;
-    }
+      const u32 i = batch + j;
+      offsets[i] = position;
 
-    if (!outfile.WriteBytes(write_buf, write_size))
-    {
-      PanicAlertT("Failed to write the output file \"%s\".\n"
-                  "Check that you have enough space available on the target drive.",
-                  outfile_path.c_str());
-      success = false;
-      break;
-    }
+      u8* write_buf;
+      int write_size;
+      if (comp_sizes[j] == 0)
+      {
+        // let's store uncompressed
+        write_buf = &in_buf[static_cast<size_t>(j) * block_size];
+        offsets[i] |= 0x8000000000000000ULL;
+        write_size = block_size;
+        num_stored++;
+      }
+      else
+      {
+        // let's store compressed
+        write_buf = &out_buf[static_cast<size_t>(j) * block_size];
+        write_size = comp_sizes[j];
+        num_compressed++;
+      }
+
+      if (!outfile.WriteBytes(write_buf, write_size))
+      {
+        PanicAlertT("Failed to write the output file \"%s\".\n"
+                    "Check that you have enough space available on the target drive.",
+                    outfile_path.c_str());
+        success = false;
+        break;
+      }
 
-    position += write_size;
+      position += write_size;
 
-    hashes[i] = HashAdler32(write_buf, write_size);
+      hashes[i] = HashAdler32(write_buf, write_size);
+    }
   }
 
   header.compressed_data_size = position;
@@ -324,9 +402,6 @@ bool CompressFileToBlob(const std::string& infile_path, const std::string& outfi
     outfile.WriteArray(hashes.data(), header.num_blocks);
   }
 
-  // Cleanup
-  deflateEnd(&z);
-
   if (success)
   {
     callback(GetStringT("Done compressing disc image."), 1.0f, arg);
@@ -366,11 +441,11 @@ bool DecompressBlobToFile(const std::string& infile_path, const std::string& out
   }
 
   const CompressedBlobHeader& header = reader->GetHeader();
-  static const size_t BUFFER_BLOCKS = 32;
-  size_t buffer_size = header.block_size * BUFFER_BLOCKS;
-  size_t last_buffer_size = header.block_size * (header.num_blocks % BUFFER_BLOCKS);
+  // Whole batches of blocks are read at once, which decompresses them in parallel.
+  const u32 buffer_blocks = std::max<u32>(1, COMPRESS_BATCH_BYTES / header.block_size);
+  const size_t buffer_size = static_cast<size_t>(header.block_size) * buffer_blocks;
   std::vector<u8> buffer(buffer_size);
-  u32 num_buffers = (header.num_blocks + BUFFER_BLOCKS - 1) / BUFFER_BLOCKS;
+  u32 num_buffers = (header.num_blocks + buffer_blocks - 1) / buffer_blocks;
   int progress_monitor = std::max<int>(1, num_buffers / 100);
   bool success = true;
 
@@ -385,8 +460,11 @@ bool DecompressBlobToFile(const std::string& infile_path, const std::string& out
         break;
       }
     }
-    const size_t sz = i == num_buffers - 1 ? last_buffer_size : buffer_size;
-    reader->Read(i * buffer_size, sz, buffer.data());
+    const u64 first_block = i * buffer_blocks;
+    const u32 num_blocks =
+        static_cast<u32>(std::min<u64>(buffer_blocks, header.num_blocks - first_block));
+    const size_t sz = static_cast<size_t>(header.block_size) * num_blocks;
+    reader->ReadMultipleAlignedBlocks(first_block, num_blocks, buffer.data());
     if (!outfile.WriteBytes(buffer.data(), sz))
     {
       PanicAlertT("Failed to write the output file \"%s\".\n"
@@ -53,10 +53,15 @@ public:
   u64 GetRawSize() const override { return m_file_size; }
   u64 GetBlockCompressedSize(u64 block_num) const;
   bool GetBlock(u64 block_num, u8* out_ptr) override;
+  // Reads the compressed blocks in one go and decompresses them in parallel.
+  bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr) override;
 
 private:
   CompressedBlobReader(File::IOFile file, const std::string& filename);
 
+  u64 GetBlockOffset(u64 block_num) const;
+  bool DecompressBlock(u64 block_num, const u8* data, u32 comp_block_size, u8* out_ptr) const;
+
   CompressedBlobHeader m_header;
   std::vector<u64> m_block_pointers;
   std::vector<u32> m_hashes;
@@ -64,6 +69,7 @@ private:
   File::IOFile m_file;
   u64 m_file_size;
   std::vector<u8> m_zlib_buffer;
+  std::vector<u8> m_batch_buffer;
   std::string m_file_name;
 };
 
@@ -0,0 +1,620 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "DiscIO/DCZBlob.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <zlib.h>
+
+#include "Common/Assert.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
+#include "Common/ThreadPool.h"
+#include "Core/IOS/ES/Formats.h"
+#include "DiscIO/Blob.h"
+
+namespace DiscIO
+{
+constexpr u64 CLUSTER_SIZE = 0x8000;
+constexpr u64 CLUSTER_HEADER_SIZE = 0x400;
+constexpr u64 CLUSTER_DATA_SIZE = CLUSTER_SIZE - CLUSTER_HEADER_SIZE;
+constexpr u32 MIN_BLOCK_SIZE = 0x8000;
+constexpr u32 MAX_BLOCK_SIZE = 0x200000;
+// Input and output buffered per batch of blocks that are compressed in parallel.
+constexpr u32 CONVERT_BATCH_BYTES = 16 * 1024 * 1024;
+
+// Finds the data areas of the encrypted partitions of a Wii disc. GC discs and unencrypted
+// Wii discs have none.
+static std::vector<DCZPartitionEntry> FindWiiPartitions(BlobReader& reader)
+{
+  std::vector<DCZPartitionEntry> partitions;
+  if (reader.ReadSwapped<u32>(0x18) != u32(0x5D1C9EA3) || reader.ReadSwapped<u32>(0x60) != u32(0))
+    return partitions;
+
+  const u64 disc_size = reader.GetDataSize();
+  for (u32 partition_group = 0; partition_group < 4; ++partition_group)
+  {
+    const std::optional<u32> number_of_partitions =
+        reader.ReadSwapped<u32>(0x40000 + (partition_group * 8));
+    const std::optional<u32> partition_table_offset =
+        reader.ReadSwapped<u32>(0x40000 + (partition_group * 8) + 4);
+    if (!number_of_partitions || !partition_table_offset)
+      continue;
+
+    for (u32 i = 0; i < *number_of_partitions; i++)
+    {
+      const std::optional<u32> partition_offset =
+          reader.ReadSwapped<u32>((u64(*partition_table_offset) << 2) + (i * 8));
+      if (!partition_offset)
+        continue;
+
+      DCZPartitionEntry entry;
+      entry.partition_offset = u64(*partition_offset) << 2;
+      const std::optional<u32> data_offset =
+          reader.ReadSwapped<u32>(entry.partition_offset + 0x2b8);
+      const std::optional<u32> data_size =
+          reader.ReadSwapped<u32>(entry.partition_offset + 0x2bc);
+      if (!data_offset || !data_size)
+        continue;
+      entry.data_offset = entry.partition_offset + (u64(*data_offset) << 2);
+      if (entry.data_offset >= disc_size)
+        continue;
+      // Only whole clusters that are on the disc can be stored decrypted.
+      entry.data_size = std::min(u64(*data_size) << 2, disc_size - entry.data_offset);
+      entry.data_size -= entry.data_size % CLUSTER_SIZE;
+      if (entry.data_size != 0)
+        partitions.push_back(entry);
+    }
+  }
+  return partitions;
+}
+
+static std::unique_ptr<mbedtls_aes_context> GetPartitionKey(BlobReader& reader,
+                                                            u64 partition_offset, bool encrypt)
+{
+  std::vector<u8> ticket_buffer(sizeof(IOS::ES::Ticket));
+  if (!reader.Read(partition_offset, ticket_buffer.size(), ticket_buffer.data()))
+    return nullptr;
+  const IOS::ES::TicketReader ticket{std::move(ticket_buffer)};
+  if (!ticket.IsValid())
+    return nullptr;
+
+  const std::array<u8, 16> key = ticket.GetTitleKey();
+  auto aes_context = std::make_unique<mbedtls_aes_context>();
+  if (encrypt)
+    mbedtls_aes_setkey_enc(aes_context.get(), key.data(), 128);
+  else
+    mbedtls_aes_setkey_dec(aes_context.get(), key.data(), 128);
+  return aes_context;
+}
+
+// The hash block is encrypted with a zero IV, the data with bytes 0x3D0-0x3DF of the
+// encrypted hash block as IV.
+static void EncryptCluster(mbedtls_aes_context* key, const u8* in, u8* out)
+{
+  u8 iv[16] = {};
+  mbedtls_aes_crypt_cbc(key, MBEDTLS_AES_ENCRYPT, CLUSTER_HEADER_SIZE, iv, in, out);
+  std::memcpy(iv, &out[0x3d0], sizeof(iv));
+  mbedtls_aes_crypt_cbc(key, MBEDTLS_AES_ENCRYPT, CLUSTER_DATA_SIZE, iv, in + CLUSTER_HEADER_SIZE,
+                        out + CLUSTER_HEADER_SIZE);
+}
+
+static void DecryptCluster(mbedtls_aes_context* key, const u8* in, u8* out)
+{
+  u8 iv[16] = {};
+  mbedtls_aes_crypt_cbc(key, MBEDTLS_AES_DECRYPT, CLUSTER_HEADER_SIZE, iv, in, out);
+  std::memcpy(iv, &in[0x3d0], sizeof(iv));
+  mbedtls_aes_crypt_cbc(key, MBEDTLS_AES_DECRYPT, CLUSTER_DATA_SIZE, iv, in + CLUSTER_HEADER_SIZE,
+                        out + CLUSTER_HEADER_SIZE);
+}
+
+DCZFileReader::DCZFileReader(File::IOFile file, const std::string& path)
+    : m_file(std::move(file)), m_path(path), m_file_size(m_file.GetSize())
+{
+}
+
+DCZFileReader::~DCZFileReader()
+{
+}
+
+std::unique_ptr<DCZFileReader> DCZFileReader::Create(File::IOFile file, const std::string& path)
+{
+  auto reader = std::unique_ptr<DCZFileReader>(new DCZFileReader(std::move(file), path));
+  if (!reader->Initialize())
+    return nullptr;
+  return reader;
+}
+
+bool DCZFileReader::Initialize()
+{
+  m_file.Seek(0, SEEK_SET);
+  if (!m_file.ReadArray(&m_header, 1) || m_header.magic != DCZ_MAGIC ||
+      m_header.version != DCZ_VERSION || m_header.block_size < MIN_BLOCK_SIZE ||
+      m_header.block_size > MAX_BLOCK_SIZE ||
+      m_header.num_blocks != (m_header.data_size + m_header.block_size - 1) / m_header.block_size)
+  {
+    ERROR_LOG(DISCIO, "%s is not a valid DCZ file", m_path.c_str());
+    return false;
+  }
+  if (m_header.compression != DCZCompression::None &&
+      m_header.compression != DCZCompression::Deflate)
+  {
+    ERROR_LOG(DISCIO, "%s uses unsupported compression %u", m_path.c_str(),
+              static_cast<u32>(m_header.compression));
+    return false;
+  }
+
+  std::vector<DCZPartitionEntry> partitions(m_header.num_partitions);
+  m_blocks.resize(m_header.num_blocks);
+  if (!m_file.ReadArray(partitions.data(), partitions.size()) ||
+      !m_file.Seek(m_header.index_offset, SEEK_SET) ||
+      !m_file.ReadArray(m_blocks.data(), m_blocks.size()))
+  {
+    ERROR_LOG(DISCIO, "%s is truncated", m_path.c_str());
+    return false;
+  }
+
+  for (auto& cache_line : m_cache)
+    cache_line.data.resize(m_header.block_size);
+  m_read_buffer.resize(m_header.block_size);
+  m_encrypted_cluster.resize(CLUSTER_SIZE);
+
+  // The partition headers (tickets included) are stored unencrypted, like on the disc.
+  for (const DCZPartitionEntry& entry : partitions)
+  {
+    std::unique_ptr<mbedtls_aes_context> key = GetPartitionKey(*this, entry.partition_offset, true);
+    if (!key)
+    {
+      ERROR_LOG(DISCIO, "%s: no valid ticket for the partition at 0x%" PRIx64, m_path.c_str(),
+                entry.partition_offset);
+      return false;
+    }
+    m_partitions.push_back({entry, std::move(key)});
+  }
+  return true;
+}
+
+const DCZFileReader::PartitionData* DCZFileReader::FindPartitionData(u64 offset) const
+{
+  for (const PartitionData& partition : m_partitions)
+  {
+    if (offset >= partition.entry.data_offset &&
+        offset - partition.entry.data_offset < partition.entry.data_size)
+    {
+      return &partition;
+    }
+  }
+  return nullptr;
+}
+
+u64 DCZFileReader::GetBlockSize(u64 block) const
+{
+  return std::min<u64>(m_header.block_size, m_header.data_size - block * m_header.block_size);
+}
+
+const DCZFileReader::CachedBlock* DCZFileReader::GetBlock(u64 block)
+{
+  CachedBlock* line = &m_cache[0];
+  for (CachedBlock& cache_line : m_cache)
+  {
+    if (cache_line.index == block)
+    {
+      cache_line.last_use = ++m_use_counter;
+      return &cache_line;
+    }
+    if (cache_line.last_use < line->last_use)
+      line = &cache_line;
+  }
+
+  const DCZBlockEntry& entry = m_blocks[block];
+  const u64 size = GetBlockSize(block);
+  line->index = UINT64_MAX;
+
+  if (entry.flags & DCZ_BLOCK_ZERO)
+  {
+    std::fill(line->data.begin(), line->data.begin() + size, 0);
+  }
+  else
+  {
+    const bool stored = (entry.flags & DCZ_BLOCK_STORED) != 0;
+    if ((stored && entry.size != size) || (!stored && entry.size > m_read_buffer.size()))
+    {
+      PanicAlertT("The disc image \"%s\" is corrupt.", m_path.c_str());
+      return nullptr;
+    }
+
+    u8* target = stored ? line->data.data() : m_read_buffer.data();
+    if (!m_file.Seek(entry.offset, SEEK_SET) || !m_file.ReadBytes(target, entry.size))
+    {
+      PanicAlertT("The disc image \"%s\" is truncated, some of the data is missing.",
+                  m_path.c_str());
+      m_file.Clear();
+      return nullptr;
+    }
+
+    if (!stored)
+    {
+      z_stream z = {};
+      z.next_in = m_read_buffer.data();
+      z.avail_in = entry.size;
+      z.next_out = line->data.data();
+      z.avail_out = static_cast<uInt>(size);
+      inflateInit(&z);
+      // The zlib stream ends with a checksum of the data, which inflate checks.
+      const int status = inflate(&z, Z_FINISH);
+      inflateEnd(&z);
+      if (status != Z_STREAM_END || z.avail_out != 0)
+      {
+        PanicAlertT("The disc image \"%s\" is corrupt.\n"
+                    "Block %" PRIu64 " could not be decompressed.",
+                    m_path.c_str(), block);
+        return nullptr;
+      }
+    }
+  }
+
+  line->index = block;
+  line->last_use = ++m_use_counter;
+  return line;
+}
+
+bool DCZFileReader::ReadImage(u64 offset, u64 size, u8* out_ptr)
+{
+  if (offset + size > m_header.data_size || offset + size < offset)
+    return false;
+
+  while (size > 0)
+  {
+    const u64 block = offset / m_header.block_size;
+    const CachedBlock* cached = GetBlock(block);
+    if (!cached)
+      return false;
+
+    const u64 offset_in_block = offset - block * m_header.block_size;
+    const u64 copy_size = std::min(size, GetBlockSize(block) - offset_in_block);
+    std::memcpy(out_ptr, cached->data.data() + offset_in_block, copy_size);
+
+    offset += copy_size;
+    out_ptr += copy_size;
+    size -= copy_size;
+  }
+  return true;
+}
+
+bool DCZFileReader::Read(u64 offset, u64 size, u8* out_ptr)
+{
+  while (size > 0)
+  {
+    const PartitionData* partition = FindPartitionData(offset);
+    if (!partition)
+    {
+      // Read up to the next partition data area as it is stored.
+      u64 end = offset + size;
+      for (const PartitionData& other : m_partitions)
+      {
+        if (other.entry.data_offset > offset)
+          end = std::min(end, other.entry.data_offset);
+      }
+      if (!ReadImage(offset, end - offset, out_ptr))
+        return false;
+      out_ptr += end - offset;
+      size -= end - offset;
+      offset = end;
+      continue;
+    }
+
+    const u64 cluster_offset =
+        offset - (offset - partition->entry.data_offset) % CLUSTER_SIZE;
+    if (m_encrypted_cluster_offset != cluster_offset)
+    {
+      u8 decrypted[CLUSTER_SIZE];
+      m_encrypted_cluster_offset = UINT64_MAX;
+      if (!ReadImage(cluster_offset, CLUSTER_SIZE, decrypted))
+        return false;
+      EncryptCluster(partition->key.get(), decrypted, m_encrypted_cluster.data());
+      m_encrypted_cluster_offset = cluster_offset;
+    }
+
+    const u64 offset_in_cluster = offset - cluster_offset;
+    const u64 copy_size = std::min(size, CLUSTER_SIZE - offset_in_cluster);
+    std::memcpy(out_ptr, &m_encrypted_cluster[offset_in_cluster], copy_size);
+    offset += copy_size;
+    out_ptr += copy_size;
+    size -= copy_size;
+  }
+  return true;
+}
+
+bool DCZFileReader::ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr, u64 partition_offset)
+{
+  auto it = std::find_if(m_partitions.begin(), m_partitions.end(), [&](const auto& partition) {
+    return partition.entry.partition_offset == partition_offset;
+  });
+  if (it == m_partitions.end())
+    return false;
+
+  while (size > 0)
+  {
+    const u64 cluster = offset / CLUSTER_DATA_SIZE;
+    const u64 offset_in_cluster = offset % CLUSTER_DATA_SIZE;
+    if (cluster * CLUSTER_SIZE >= it->entry.data_size)
+      return false;
+
+    const u64 copy_size = std::min(size, CLUSTER_DATA_SIZE - offset_in_cluster);
+    if (!ReadImage(it->entry.data_offset + cluster * CLUSTER_SIZE + CLUSTER_HEADER_SIZE +
+                       offset_in_cluster,
+                   copy_size, out_ptr))
+    {
+      return false;
+    }
+    offset += copy_size;
+    out_ptr += copy_size;
+    size -= copy_size;
+  }
+  return true;
+}
+
+// Reads the input with the partition data areas decrypted, which is what DCZ files store.
+class DecryptingReader
+{
+public:
+  DecryptingReader(BlobReader& reader, const std::vector<DCZPartitionEntry>& partitions)
+      : m_reader(reader), m_partitions(partitions)
+  {
+    for (const DCZPartitionEntry& entry : m_partitions)
+      m_keys.push_back(GetPartitionKey(m_reader, entry.partition_offset, false));
+  }
+
+  bool HasAllKeys() const
+  {
+    return std::all_of(m_keys.begin(), m_keys.end(),
+                       [](const auto& key) { return key != nullptr; });
+  }
+
+  bool Read(u64 offset, u64 size, u8* out_ptr)
+  {
+    while (size > 0)
+    {
+      size_t index = m_partitions.size();
+      u64 end = offset + size;
+      for (size_t i = 0; i < m_partitions.size(); i++)
+      {
+        const DCZPartitionEntry& entry = m_partitions[i];
+        if (offset >= entry.data_offset && offset - entry.data_offset < entry.data_size)
+          index = i;
+        else if (entry.data_offset > offset)
+          end = std::min(end, entry.data_offset);
+      }
+
+      if (index == m_partitions.size())
+      {
+        if (!m_reader.Read(offset, end - offset, out_ptr))
+          return false;
+        out_ptr += end - offset;
+        size -= end - offset;
+        offset = end;
+        continue;
+      }
+
+      const DCZPartitionEntry& entry = m_partitions[index];
+      const u64 cluster_offset = offset - (offset - entry.data_offset) % CLUSTER_SIZE;
+      u8 encrypted[CLUSTER_SIZE];
+      u8 decrypted[CLUSTER_SIZE];
+      if (!m_reader.Read(cluster_offset, CLUSTER_SIZE, encrypted))
+        return false;
+      DecryptCluster(m_keys[index].get(), encrypted, decrypted);
+
+      const u64 offset_in_cluster = offset - cluster_offset;
+      const u64 copy_size = std::min(size, CLUSTER_SIZE - offset_in_cluster);
+      std::memcpy(out_ptr, &decrypted[offset_in_cluster], copy_size);
+      offset += copy_size;
+      out_ptr += copy_size;
+      size -= copy_size;
+    }
+    return true;
+  }
+
+private:
+  BlobReader& m_reader;
+  const std::vector<DCZPartitionEntry>& m_partitions;
+  std::vector<std::unique_ptr<mbedtls_aes_context>> m_keys;
+};
+
+bool ConvertToDCZ(const std::string& infile_path, const std::string& outfile_path,
+                  u32 block_size, CompressCB callback, void* arg)
+{
+  if (block_size < MIN_BLOCK_SIZE || block_size > MAX_BLOCK_SIZE ||
+      (block_size & (block_size - 1)) != 0)
+  {
+    PanicAlertT("Invalid block size %u for a DCZ file.", block_size);
+    return false;
+  }
+
+  std::unique_ptr<BlobReader> reader = CreateBlobReader(infile_path);
+  if (!reader)
+  {
+    PanicAlertT("Failed to open the input file \"%s\".", infile_path.c_str());
+    return false;
+  }
+  if (reader->GetBlobType() == BlobType::DCZ)
+  {
+    PanicAlertT("\"%s\" is already compressed! Cannot compress it further.", infile_path.c_str());
+    return false;
+  }
+
+  const std::vector<DCZPartitionEntry> partitions = FindWiiPartitions(*reader);
+  DecryptingReader decrypting_reader(*reader, partitions);
+  if (!decrypting_reader.HasAllKeys())
+  {
+    PanicAlertT("\"%s\" has a partition without a valid ticket.", infile_path.c_str());
+    return false;
+  }
+
+  File::IOFile outfile(outfile_path, "wb");
+  if (!outfile)
+  {
+    PanicAlertT("Failed to open the output file \"%s\".\n"
+                "Check that you have permissions to write the target folder and that the media can "
+                "be written.",
+                outfile_path.c_str());
+    return false;
+  }
+
+  callback(GetStringT("Files opened, ready to compress."), 0, arg);
+
+  DCZHeader header = {};
+  header.magic = DCZ_MAGIC;
+  header.version = DCZ_VERSION;
+  header.compression = DCZCompression::Deflate;
+  header.block_size = block_size;
+  header.data_size = reader->GetDataSize();
+  header.num_blocks = static_cast<u32>((header.data_size + block_size - 1) / block_size);
+  header.num_partitions = static_cast<u32>(partitions.size());
+  header.index_offset = sizeof(DCZHeader) + sizeof(DCZPartitionEntry) * partitions.size();
+
+  std::vector<DCZBlockEntry> blocks(header.num_blocks);
+  u64 position = header.index_offset + sizeof(DCZBlockEntry) * blocks.size();
+  // The header and the tables are written at the end.
+  outfile.Seek(position, SEEK_SET);
+
+  const u32 batch_blocks = std::max<u32>(1, CONVERT_BATCH_BYTES / block_size);
+  std::vector<u8> in_buf(static_cast<size_t>(batch_blocks) * block_size);
+  std::vector<u8> out_buf(static_cast<size_t>(batch_blocks) * block_size);
+  int progress_monitor = std::max<int>(1, header.num_blocks / 1000);
+  bool success = true;
+
+  for (u32 batch = 0; batch < header.num_blocks && success; batch += batch_blocks)
+  {
+    const u32 batch_size = std::min(batch_blocks, header.num_blocks - batch);
+    for (u32 j = 0; j < batch_size; j++)
+    {
+      const u32 i = batch + j;
+      if (i % progress_monitor == 0)
+      {
+        const u64 inpos = u64(i) * block_size;
+        const int ratio = inpos != 0 ? static_cast<int>(100 * position / inpos) : 0;
+        const std::string text =
+            StringFromFormat(GetStringT("%i of %i blocks. Compression ratio %i%%").c_str(), i,
+                             header.num_blocks, ratio);
+        if (!callback(text, (float)i / (float)header.num_blocks, arg))
+        {
+          success = false;
+          break;
+        }
+      }
+
+      const u64 offset = u64(i) * block_size;
+      const u64 size = std::min<u64>(block_size, header.data_size - offset);
+      if (!decrypting_reader.Read(offset, size, &in_buf[static_cast<size_t>(j) * block_size]))
+      {
+        PanicAlertT("Failed to read from the input file \"%s\".", infile_path.c_str());
+        success = false;
+        break;
+      }
+    }
+    if (!success)
+      break;
+
+    std::atomic<bool> deflate_failed{false};
+    Common::ParallelForWorker::Loop(0, static_cast<s32>(batch_size), 1, [&](s32 begin, s32 end) {
+      z_stream z = {};
+      if (deflateInit(&z, 9) != Z_OK)
+      {
+        deflate_failed = true;
+        return;
+      }
+      for (s32 j = begin; j < end; ++j)
+      {
+        DCZBlockEntry& entry = blocks[batch + j];
+        const u64 size = std::min<u64>(block_size, header.data_size - u64(batch + j) * block_size);
+        const u8* in = &in_buf[static_cast<size_t>(j) * block_size];
+        if (std::all_of(in, in + size, [](u8 byte) { return byte == 0; }))
+        {
+          entry.flags = DCZ_BLOCK_ZERO;
+          entry.size = 0;
+          continue;
+        }
+
+        if (deflateReset(&z) != Z_OK)
+        {
+          deflate_failed = true;
+          break;
+        }
+        z.next_in = const_cast<u8*>(in);
+        z.avail_in = static_cast<uInt>(size);
+        z.next_out = &out_buf[static_cast<size_t>(j) * block_size];
+        z.avail_out = static_cast<uInt>(size);
+        // Blocks that don't get smaller are stored as-is.
+        if (deflate(&z, Z_FINISH) == Z_STREAM_END && z.avail_out != 0)
+        {
+          entry.flags = 0;
+          entry.size = static_cast<u32>(size - z.avail_out);
+        }
+        else
+        {
+          entry.flags = DCZ_BLOCK_STORED;
+          entry.size = static_cast<u32>(size);
+        }
+      }
+      deflateEnd(&z);
+    });
+    if (deflate_failed)
+    {
+      ERROR_LOG(DISCIO, "Deflate failed");
+      success = false;
+      break;
+    }
+
+    for (u32 j = 0; j < batch_size && success; j++)
+    {
+      DCZBlockEntry& entry = blocks[batch + j];
+      entry.offset = position;
+      if (entry.size == 0)
+        continue;
+
+      const std::vector<u8>& buf = (entry.flags & DCZ_BLOCK_STORED) ? in_buf : out_buf;
+      if (!outfile.WriteBytes(&buf[static_cast<size_t>(j) * block_size], entry.size))
+      {
+        PanicAlertT("Failed to write the output file \"%s\".\n"
+                    "Check that you have enough space available on the target drive.",
+                    outfile_path.c_str());
+        success = false;
+      }
+      position += entry.size;
+    }
+  }
+
+  if (success)
+  {
+    outfile.Seek(0, SEEK_SET);
+    success = outfile.WriteArray(&header, 1) &&
+              outfile.WriteArray(partitions.data(), partitions.size()) &&
+              outfile.WriteArray(blocks.data(), blocks.size());
+  }
+
+  if (!success)
+  {
+    // Remove the incomplete output file.
+    outfile.Close();
+    File::Delete(outfile_path);
+    return false;
+  }
+
+  callback(GetStringT("Done compressing disc image."), 1.0f, arg);
+  return true;
+}
+
+}  // namespace
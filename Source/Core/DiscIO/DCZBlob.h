@@ -0,0 +1,132 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// DCZ is a random-access container for GC/Wii disc images.
+//
+// The image is split into fixed-size blocks which are compressed independently. The data areas
+// of Wii partitions are stored decrypted (hash blocks included), which compresses much better
+// than encrypted data. Raw reads encrypt those clusters again, while reads through VolumeWii
+// go through ReadWiiDecrypted and skip AES entirely.
+//
+// File layout:
+// * DCZHeader
+// * DCZPartitionEntry[num_partitions]
+// * DCZBlockEntry[num_blocks], at index_offset. It is a plain array, so it can be used in place.
+// * Block data
+
+#pragma once
+
+#include <array>
+#include <mbedtls/aes.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "DiscIO/Blob.h"
+
+namespace DiscIO
+{
+static constexpr u32 DCZ_MAGIC = 0x015A4344;  // "DCZ\x01"
+static constexpr u32 DCZ_VERSION = 1;
+
+enum class DCZCompression : u32
+{
+  None = 0,
+  Deflate = 1,
+};
+
+struct DCZHeader
+{
+  u32 magic;
+  u32 version;
+  DCZCompression compression;
+  u32 block_size;
+  u64 data_size;
+  u64 index_offset;
+  u32 num_blocks;
+  u32 num_partitions;
+};
+
+// A Wii partition whose data area is stored decrypted.
+struct DCZPartitionEntry
+{
+  u64 partition_offset;
+  u64 data_offset;  // of the first cluster, from the start of the disc
+  u64 data_size;    // a multiple of the cluster size
+};
+
+enum : u32
+{
+  // The block is stored as-is.
+  DCZ_BLOCK_STORED = 1,
+  // The block only holds zeroes and takes no space in the file.
+  DCZ_BLOCK_ZERO = 2,
+};
+
+struct DCZBlockEntry
+{
+  u64 offset;  // in the file
+  u32 size;    // in the file
+  u32 flags;
+};
+
+class DCZFileReader : public BlobReader
+{
+public:
+  static std::unique_ptr<DCZFileReader> Create(File::IOFile file, const std::string& path);
+  ~DCZFileReader();
+
+  BlobType GetBlobType() const override { return BlobType::DCZ; }
+  u64 GetDataSize() const override { return m_header.data_size; }
+  u64 GetRawSize() const override { return m_file_size; }
+  bool Read(u64 offset, u64 size, u8* out_ptr) override;
+
+  bool SupportsReadWiiDecrypted() const override { return !m_partitions.empty(); }
+  bool ReadWiiDecrypted(u64 offset, u64 size, u8* out_ptr, u64 partition_offset) override;
+
+private:
+  struct PartitionData
+  {
+    DCZPartitionEntry entry;
+    std::unique_ptr<mbedtls_aes_context> key;
+  };
+
+  struct CachedBlock
+  {
+    u64 index = UINT64_MAX;
+    u64 last_use = 0;
+    std::vector<u8> data;
+  };
+
+  DCZFileReader(File::IOFile file, const std::string& path);
+  bool Initialize();
+
+  const PartitionData* FindPartitionData(u64 offset) const;
+  u64 GetBlockSize(u64 block) const;
+  const CachedBlock* GetBlock(u64 block);
+  // Reads the image as stored, with Wii partition data decrypted.
+  bool ReadImage(u64 offset, u64 size, u8* out_ptr);
+
+  File::IOFile m_file;
+  std::string m_path;
+  u64 m_file_size;
+  DCZHeader m_header;
+  std::vector<PartitionData> m_partitions;
+  std::vector<DCZBlockEntry> m_blocks;
+
+  std::array<CachedBlock, 8> m_cache;
+  u64 m_use_counter = 0;
+  std::vector<u8> m_read_buffer;
+
+  u64 m_encrypted_cluster_offset = UINT64_MAX;
+  std::vector<u8> m_encrypted_cluster;
+};
+
+// block_size has to be a power of two between 32 KiB and 2 MiB.
+bool ConvertToDCZ(const std::string& infile_path, const std::string& outfile_path,
+                  u32 block_size = 0x20000, CompressCB callback = nullptr, void* arg = nullptr);
+
+}  // namespace
@@ -24,6 +24,7 @@
 #include "Common/File.h"
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
+#include "Common/MappedFile.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
 #include "Core/Boot/DolReader.h"
@@ -100,6 +101,25 @@ bool DiscContent::Read(u64* offset, u64* length, u8** buffer) const
     const u64 bytes_to_read = std::min(m_size - offset_in_content, *length);
 
     if (std::holds_alternative<std::string>(m_content_source))
+    {
+      if (!m_mapping_attempted)
+      {
+        m_mapping_attempted = true;
+        auto mapping = std::make_shared<File::MappedFile>();
+        if (mapping->Open(std::get<std::string>(m_content_source)) && mapping->GetSize() >= m_size)
+        {
+          mapping->SetAccessPattern(File::MappedFile::AccessPattern::Sequential);
+          m_mapping = std::move(mapping);
+        }
+      }
+    }
+
+    if (m_mapping)
+    {
+      if (!m_mapping->Read(offset_in_content, bytes_to_read, *buffer))
+        return false;
+    }
+    else if (std::holds_alternative<std::string>(m_content_source))
     {
       File::IOFile file(std::get<std::string>(m_content_source), "rb");
       file.Seek(offset_in_content, SEEK_SET);
@@ -21,6 +21,7 @@ namespace File
 {
 struct FSTEntry;
 class IOFile;
+class MappedFile;
 }
 
 namespace DiscIO
@@ -56,6 +57,9 @@ private:
   u64 m_offset;
   u64 m_size = 0;
   ContentSource m_content_source;
+  // Files are mapped on their first read. Shared so that DiscContent stays copyable.
+  mutable std::shared_ptr<File::MappedFile> m_mapping;
+  mutable bool m_mapping_attempted = false;
 };
 
 class DiscContentContainer
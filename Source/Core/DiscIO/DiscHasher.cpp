@@ -0,0 +1,99 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "DiscIO/DiscHasher.h"
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <mbedtls/md5.h>
+#include <mbedtls/sha1.h>
+#include <vector>
+#include <zlib.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/ThreadPool.h"
+#include "DiscIO/Blob.h"
+
+namespace DiscIO
+{
+constexpr size_t HASH_CHUNK_SIZE = 32 * 1024 * 1024;
+
+bool ComputeDiscHashes(BlobReader& reader, u32 hash_types, DiscHashes* hashes,
+                       const std::function<bool(int)>& report_progress)
+{
+  const u64 data_size = reader.GetDataSize();
+
+  mbedtls_md5_context md5_context;
+  mbedtls_sha1_context sha1_context;
+  mbedtls_md5_init(&md5_context);
+  mbedtls_sha1_init(&sha1_context);
+  mbedtls_md5_starts(&md5_context);
+  mbedtls_sha1_starts(&sha1_context);
+  uLong crc = crc32(0, nullptr, 0);
+
+  std::vector<std::function<void(const u8*, size_t)>> hashers;
+  if (hash_types & DISC_HASH_CRC32)
+  {
+    hashers.push_back([&crc](const u8* data, size_t size) {
+      crc = crc32(crc, data, static_cast<uInt>(size));
+    });
+  }
+  if (hash_types & DISC_HASH_MD5)
+  {
+    hashers.push_back([&md5_context](const u8* data, size_t size) {
+      mbedtls_md5_update(&md5_context, data, size);
+    });
+  }
+  if (hash_types & DISC_HASH_SHA1)
+  {
+    hashers.push_back([&sha1_context](const u8* data, size_t size) {
+      mbedtls_sha1_update(&sha1_context, data, size);
+    });
+  }
+
+  // One buffer is hashed while the other one is being filled.
+  std::vector<u8> buffers[2] = {std::vector<u8>(HASH_CHUNK_SIZE), std::vector<u8>(HASH_CHUNK_SIZE)};
+  std::future<void> hashing;
+  bool success = true;
+  u64 offset = 0;
+  for (int current = 0; offset < data_size; current ^= 1)
+  {
+    const size_t size = static_cast<size_t>(std::min<u64>(HASH_CHUNK_SIZE, data_size - offset));
+    success = reader.Read(offset, size, buffers[current].data());
+    if (hashing.valid())
+      hashing.wait();
+    if (!success)
+      break;
+
+    const u8* data = buffers[current].data();
+    hashing = std::async(std::launch::async, [&hashers, data, size] {
+      Common::ParallelForWorker::Loop(0, static_cast<s32>(hashers.size()), 1,
+                                      [&](s32 begin, s32 end) {
+                                        for (s32 i = begin; i < end; i++)
+                                          hashers[i](data, size);
+                                      });
+    });
+    offset += size;
+
+    if (!report_progress(static_cast<int>(100 * offset / data_size)))
+    {
+      success = false;
+      break;
+    }
+  }
+  if (hashing.valid())
+    hashing.wait();
+
+  if (success)
+  {
+    hashes->crc32 = static_cast<u32>(crc);
+    mbedtls_md5_finish(&md5_context, hashes->md5.data());
+    mbedtls_sha1_finish(&sha1_context, hashes->sha1.data());
+  }
+  mbedtls_md5_free(&md5_context);
+  mbedtls_sha1_free(&sha1_context);
+  return success;
+}
+}
@@ -0,0 +1,37 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <functional>
+
+#include "Common/CommonTypes.h"
+
+namespace DiscIO
+{
+class BlobReader;
+
+enum DiscHashType : u32
+{
+  DISC_HASH_CRC32 = 1 << 0,
+  DISC_HASH_MD5 = 1 << 1,
+  DISC_HASH_SHA1 = 1 << 2,
+  DISC_HASH_ALL = DISC_HASH_CRC32 | DISC_HASH_MD5 | DISC_HASH_SHA1,
+};
+
+struct DiscHashes
+{
+  u32 crc32 = 0;
+  std::array<u8, 16> md5{};
+  std::array<u8, 20> sha1{};
+};
+
+// Hashes the whole image as it would be dumped, e.g. for comparing it with redump.org data.
+// The next chunk is read while the current one is hashed, and the selected hashes are computed on
+// separate worker threads. report_progress gets a percentage and returns false to cancel.
+// Returns false if reading failed or the hashing was cancelled.
+bool ComputeDiscHashes(BlobReader& reader, u32 hash_types, DiscHashes* hashes,
+                       const std::function<bool(int)>& report_progress);
+}
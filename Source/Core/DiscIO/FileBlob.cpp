@@ -10,21 +10,40 @@
 
 namespace DiscIO
 {
-PlainFileReader::PlainFileReader(File::IOFile file) : m_file(std::move(file))
+// How far ahead of sequential reads the kernel is asked to read a mapped file
+constexpr u64 READ_AHEAD_SIZE = 4 * 1024 * 1024;
+
+PlainFileReader::PlainFileReader(File::IOFile file, const std::string& path)
+    : m_file(std::move(file))
 {
   m_size = m_file.GetSize();
+  if (m_mapping.Open(path) && m_mapping.GetSize() != static_cast<u64>(m_size))
+    m_mapping.Close();
 }
 
-std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file)
+std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file, const std::string& path)
 {
   if (file)
-    return std::unique_ptr<PlainFileReader>(new PlainFileReader(std::move(file)));
+    return std::unique_ptr<PlainFileReader>(new PlainFileReader(std::move(file), path));
 
   return nullptr;
 }
 
 bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
 {
+  if (m_mapping.IsOpen())
+  {
+    // Streaming reads get the data after them prefetched in large steps, so that a hint is only
+    // given every now and then.
+    if (offset == m_next_sequential_offset && offset + nbytes > m_prefetched_until)
+    {
+      m_mapping.Prefetch(offset + nbytes, READ_AHEAD_SIZE);
+      m_prefetched_until = offset + nbytes + READ_AHEAD_SIZE / 2;
+    }
+    m_next_sequential_offset = offset + nbytes;
+    return m_mapping.Read(offset, nbytes, out_ptr);
+  }
+
   if (m_file.Seek(offset, SEEK_SET) && m_file.ReadBytes(out_ptr, nbytes))
   {
     return true;
@@ -10,6 +10,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
+#include "Common/MappedFile.h"
 #include "DiscIO/Blob.h"
 
 namespace DiscIO
@@ -17,7 +18,7 @@ namespace DiscIO
 class PlainFileReader : public BlobReader
 {
 public:
-  static std::unique_ptr<PlainFileReader> Create(File::IOFile file);
+  static std::unique_ptr<PlainFileReader> Create(File::IOFile file, const std::string& path);
 
   BlobType GetBlobType() const override { return BlobType::PLAIN; }
   u64 GetDataSize() const override { return m_size; }
@@ -25,10 +26,14 @@ public:
   bool Read(u64 offset, u64 nbytes, u8* out_ptr) override;
 
 private:
-  PlainFileReader(File::IOFile file);
+  PlainFileReader(File::IOFile file, const std::string& path);
 
   File::IOFile m_file;
+  // Used instead of m_file for files on local drives
+  File::MappedFile m_mapping;
   s64 m_size;
+  u64 m_next_sequential_offset = 0;
+  u64 m_prefetched_until = 0;
 };
 
 }  // namespace
@@ -6,8 +6,8 @@
 #include <cinttypes>
 #include <cstddef>
 #include <cstring>
-#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -301,10 +301,9 @@ std::unique_ptr<FileInfo> FileSystemGCWii::FindFileInfo(u64 disc_offset) const
   if (!IsValid())
     return nullptr;
 
-  // Build a cache (unless there already is one)
-  if (m_offset_file_info_cache.empty())
-  {
-    u32 fst_entries = m_root.GetSize();
+  // Build the index once, the DVD thread and the UI can both look up offsets
+  std::call_once(m_offset_file_info_cache_flag, [this] {
+    const u32 fst_entries = m_root.GetSize();
     for (u32 i = 0; i < fst_entries; i++)
     {
       FileInfoGCWii file_info(m_root, i);
@@ -312,13 +311,23 @@ std::unique_ptr<FileInfo> FileSystemGCWii::FindFileInfo(u64 disc_offset) const
       {
         const u32 size = file_info.GetSize();
         if (size != 0)
-          m_offset_file_info_cache.emplace(file_info.GetOffset() + size, i);
+          m_offset_file_info_cache.emplace_back(file_info.GetOffset() + size, i);
       }
     }
-  }
+    // Like the map this replaces, keep the first file listed for each end offset
+    std::stable_sort(m_offset_file_info_cache.begin(), m_offset_file_info_cache.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    m_offset_file_info_cache.erase(
+        std::unique(m_offset_file_info_cache.begin(), m_offset_file_info_cache.end(),
+                    [](const auto& a, const auto& b) { return a.first == b.first; }),
+        m_offset_file_info_cache.end());
+    m_offset_file_info_cache.shrink_to_fit();
+  });
 
   // Get the first file that ends after disc_offset
-  const auto it = m_offset_file_info_cache.upper_bound(disc_offset);
+  const auto it = std::upper_bound(
+      m_offset_file_info_cache.begin(), m_offset_file_info_cache.end(), disc_offset,
+      [](u64 offset, const std::pair<u64, u32>& entry) { return offset < entry.first; });
   if (it == m_offset_file_info_cache.end())
     return nullptr;
   std::unique_ptr<FileInfo> result(std::make_unique<FileInfoGCWii>(m_root, it->second));
@@ -5,10 +5,11 @@
 #pragma once
 
 #include <cstddef>
-#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -97,8 +98,10 @@ private:
   bool m_valid;
   std::vector<u8> m_file_system_table;
   FileInfoGCWii m_root;
-  // Maps the end offset of files to FST indexes
-  mutable std::map<u64, u32> m_offset_file_info_cache;
+  // End offsets of the files that aren't empty and their FST indexes, sorted by end offset.
+  // Built by the first offset lookup.
+  mutable std::vector<std::pair<u64, u32>> m_offset_file_info_cache;
+  mutable std::once_flag m_offset_file_info_cache_flag;
 
   std::unique_ptr<FileInfo> FindFileInfo(const std::string& path, const FileInfo& file_info) const;
 };
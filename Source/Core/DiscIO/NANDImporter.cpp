@@ -16,12 +16,15 @@
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
+#include "Common/ThreadPool.h"
 #include "Core/IOS/ES/Formats.h"
 
 namespace DiscIO
 {
 constexpr size_t NAND_SIZE = 0x20000000;
 constexpr size_t NAND_KEYS_SIZE = 0x400;
+constexpr size_t NAND_AES_KEY_OFFSET = 0x158;
+constexpr size_t NAND_FAT_BLOCK_SIZE = 0x4000;
 
 NANDImporter::NANDImporter() = default;
 NANDImporter::~NANDImporter() = default;
@@ -42,6 +45,7 @@ void NANDImporter::ImportNANDBin(const std::string& path_to_bin,
 
   FindSuperblock();
   ProcessEntry(0, nand_root);
+  ExtractFiles();
   ExportKeys(nand_root);
   ExtractCertificates(nand_root);
 }
@@ -65,15 +69,24 @@ bool NANDImporter::ReadNANDBin(const std::string& path_to_bin,
 
   m_nand.resize(NAND_SIZE);
 
-  for (size_t i = 0; i < NAND_TOTAL_BLOCKS; i++)
+  // Blocks are read in batches rather than with a read and a seek each.
+  constexpr size_t BLOCKS_PER_READ = 64;
+  constexpr size_t NAND_BLOCK_WITH_ECC_SIZE = NAND_BLOCK_SIZE + NAND_ECC_BLOCK_SIZE;
+  std::vector<u8> blocks(NAND_BLOCK_WITH_ECC_SIZE * BLOCKS_PER_READ);
+  for (size_t i = 0; i < NAND_TOTAL_BLOCKS; i += BLOCKS_PER_READ)
   {
-    // Instead of updating on every cycle, we only update every 1000 cycles for a balance between
+    // Instead of updating on every cycle, we only update every 1024 blocks for a balance between
     // not updating fast enough vs updating too fast
-    if (i % 1000 == 0)
+    if (i % 1024 == 0)
       m_update_callback();
 
-    file.ReadBytes(&m_nand[i * NAND_BLOCK_SIZE], NAND_BLOCK_SIZE);
-    file.Seek(NAND_ECC_BLOCK_SIZE, SEEK_CUR);  // We don't care about the ECC blocks
+    file.ReadBytes(blocks.data(), blocks.size());
+    // We don't care about the ECC blocks
+    for (size_t j = 0; j < BLOCKS_PER_READ; j++)
+    {
+      std::memcpy(&m_nand[(i + j) * NAND_BLOCK_SIZE], &blocks[j * NAND_BLOCK_WITH_ECC_SIZE],
+                  NAND_BLOCK_SIZE);
+    }
   }
 
   m_nand_keys.resize(NAND_KEYS_SIZE);
@@ -170,27 +183,55 @@ void NANDImporter::ProcessDirectory(const NANDFSTEntry& entry, const std::string
 
 void NANDImporter::ProcessFile(const NANDFSTEntry& entry, const std::string& parent_path)
 {
-  constexpr size_t NAND_AES_KEY_OFFSET = 0x158;
-  constexpr size_t NAND_FAT_BLOCK_SIZE = 0x4000;
-
-  m_update_callback();
   INFO_LOG(DISCIO, "File: %s", FormatDebugString(entry).c_str());
 
-  const std::string path = GetPath(entry, parent_path);
-  File::IOFile file(path, "wb");
-  std::array<u8, 16> key{};
-  std::copy(&m_nand_keys[NAND_AES_KEY_OFFSET], &m_nand_keys[NAND_AES_KEY_OFFSET + key.size()],
-            key.begin());
-  u16 sub = Common::swap16(entry.sub);
-  u32 remaining_bytes = Common::swap32(entry.size);
+  // Extracted by ExtractFiles once all directories exist.
+  m_files.push_back({entry, GetPath(entry, parent_path)});
+}
+
+void NANDImporter::ExtractFiles()
+{
+  // Files don't depend on each other, so they are decrypted and written in parallel. Batches keep
+  // the update callback on this thread.
+  constexpr size_t FILES_PER_BATCH = 64;
+
+  mbedtls_aes_context aes_context;
+  mbedtls_aes_setkey_dec(&aes_context, &m_nand_keys[NAND_AES_KEY_OFFSET], 128);
+
+  for (size_t batch = 0; batch < m_files.size(); batch += FILES_PER_BATCH)
+  {
+    m_update_callback();
+    const size_t batch_end = std::min(batch + FILES_PER_BATCH, m_files.size());
+    Common::ParallelForWorker::Loop(static_cast<s32>(batch), static_cast<s32>(batch_end), 1,
+                                    [&](s32 begin, s32 end) {
+                                      std::vector<u8> buffer(NAND_FAT_BLOCK_SIZE);
+                                      for (s32 i = begin; i < end; ++i)
+                                        ExtractFile(&aes_context, m_files[i], buffer.data());
+                                    });
+  }
+  m_files.clear();
+}
+
+void NANDImporter::ExtractFile(mbedtls_aes_context* aes_context, const NANDFile& nand_file,
+                               u8* buffer)
+{
+  static constexpr std::array<u8, 16> ZERO_IV{};
+
+  File::IOFile file(nand_file.path, "wb");
+  u16 sub = Common::swap16(nand_file.entry.sub);
+  u32 remaining_bytes = Common::swap32(nand_file.entry.size);
 
   while (remaining_bytes > 0)
   {
-    std::array<u8, 16> iv{};
-    std::vector<u8> block = Common::AES::Decrypt(
-        key.data(), iv.data(), &m_nand[NAND_FAT_BLOCK_SIZE * sub], NAND_FAT_BLOCK_SIZE);
+    if (NAND_FAT_BLOCK_SIZE * (sub + 1) > NAND_SIZE)
+    {
+      ERROR_LOG(DISCIO, "Invalid FAT block 0x%04x in %s", sub, nand_file.path.c_str());
+      return;
+    }
+    Common::AES::DecryptCBC(aes_context, ZERO_IV.data(), &m_nand[NAND_FAT_BLOCK_SIZE * sub],
+                            buffer, NAND_FAT_BLOCK_SIZE);
     u32 size = remaining_bytes < NAND_FAT_BLOCK_SIZE ? remaining_bytes : NAND_FAT_BLOCK_SIZE;
-    file.WriteBytes(block.data(), size);
+    file.WriteBytes(buffer, size);
     remaining_bytes -= size;
     sub = Common::swap16(&m_nand[m_nand_fat_offset + 2 * sub]);
   }
@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 
+#include <mbedtls/aes.h>
+
 #include "Common/CommonTypes.h"
 
 namespace DiscIO
@@ -42,6 +44,12 @@ private:
   };
 #pragma pack(pop)
 
+  struct NANDFile
+  {
+    NANDFSTEntry entry;
+    std::string path;
+  };
+
   bool ReadNANDBin(const std::string& path_to_bin, std::function<std::string()> get_otp_dump_path);
   void FindSuperblock();
   std::string GetPath(const NANDFSTEntry& entry, const std::string& parent_path);
@@ -49,12 +57,15 @@ private:
   void ProcessEntry(u16 entry_number, const std::string& parent_path);
   void ProcessFile(const NANDFSTEntry& entry, const std::string& parent_path);
   void ProcessDirectory(const NANDFSTEntry& entry, const std::string& parent_path);
+  void ExtractFiles();
+  void ExtractFile(mbedtls_aes_context* aes_context, const NANDFile& nand_file, u8* buffer);
   void ExportKeys(const std::string& nand_root);
 
   std::vector<u8> m_nand;
   std::vector<u8> m_nand_keys;
   size_t m_nand_fat_offset = 0;
   size_t m_nand_fst_offset = 0;
+  std::vector<NANDFile> m_files;
   std::function<void()> m_update_callback;
   size_t m_nand_root_length = 0;
 };
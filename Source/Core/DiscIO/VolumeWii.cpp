@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstring>
 #include <map>
@@ -19,9 +20,11 @@
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
+#include "Common/ThreadPool.h"
 
 #include "DiscIO/Blob.h"
 #include "DiscIO/DiscExtractor.h"
@@ -34,10 +37,15 @@
 namespace DiscIO
 {
 constexpr u64 PARTITION_DATA_OFFSET = 0x20000;
+constexpr u64 H3_TABLE_SIZE = 0x18000;
+constexpr u32 BLOCKS_PER_SUBGROUP = 8;
+constexpr u32 BLOCKS_PER_GROUP = 64;
+// Groups of clusters read and checked at a time by CheckIntegrity
+constexpr u32 GROUPS_PER_BATCH = 8;
+constexpr std::array<u8, 16> ZERO_IV{};
 
 VolumeWii::VolumeWii(std::unique_ptr<BlobReader> reader)
-    : m_pReader(std::move(reader)), m_game_partition(PARTITION_NONE),
-      m_last_decrypted_block(UINT64_MAX)
+    : m_pReader(std::move(reader)), m_game_partition(PARTITION_NONE)
 {
   ASSERT(m_pReader);
 
@@ -148,7 +156,6 @@ bool VolumeWii::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, const Partition
   if (!aes_context)
     return false;
 
-  std::vector<u8> read_buffer(BLOCK_TOTAL_SIZE);
   while (_Length > 0)
   {
     // Calculate offsets
@@ -156,30 +163,50 @@ bool VolumeWii::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, const Partition
         partition.offset + PARTITION_DATA_OFFSET + _ReadOffset / BLOCK_DATA_SIZE * BLOCK_TOTAL_SIZE;
     u64 data_offset_in_block = _ReadOffset % BLOCK_DATA_SIZE;
 
-    if (m_last_decrypted_block != block_offset_on_disc)
+    DecryptedBlock* block = FindDecryptedBlock(block_offset_on_disc);
+    if (!block)
     {
-      // Read the current block
-      if (!m_pReader->Read(block_offset_on_disc, BLOCK_TOTAL_SIZE, read_buffer.data()))
+      // Read the missing blocks that this read needs next in one go
+      const u64 blocks_left =
+          (data_offset_in_block + _Length + BLOCK_DATA_SIZE - 1) / BLOCK_DATA_SIZE;
+      size_t num_blocks = 1;
+      while (num_blocks < std::min<u64>(blocks_left, MAX_BLOCKS_PER_BATCH) &&
+             !FindDecryptedBlock(block_offset_on_disc + num_blocks * BLOCK_TOTAL_SIZE))
+      {
+        num_blocks++;
+      }
+
+      m_read_buffer.resize(num_blocks * BLOCK_TOTAL_SIZE);
+      if (!m_pReader->Read(block_offset_on_disc, m_read_buffer.size(), m_read_buffer.data()))
         return false;
 
-      // Decrypt the block's data.
-      // 0x3D0 - 0x3DF in read_buffer will be overwritten,
-      // but that won't affect anything, because we won't
-      // use the content of read_buffer anymore after this
-      mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, BLOCK_DATA_SIZE, &read_buffer[0x3D0],
-                            &read_buffer[BLOCK_HEADER_SIZE], m_last_decrypted_block_data);
-      m_last_decrypted_block = block_offset_on_disc;
-
-      // The only thing we currently use from the 0x000 - 0x3FF part
-      // of the block is the IV (at 0x3D0), but it also contains SHA-1
-      // hashes that IOS uses to check that discs aren't tampered with.
-      // http://wiibrew.org/wiki/Wii_Disc#Encrypted
+      for (size_t i = num_blocks; i-- > 0;)
+      {
+        // Evict the least recently used block. Blocks decrypted by this loop are never picked,
+        // since they were used more recently than the rest of the cache.
+        DecryptedBlock* target =
+            &*std::min_element(m_decrypted_blocks.begin(), m_decrypted_blocks.end(),
+                               [](const DecryptedBlock& a, const DecryptedBlock& b) {
+                                 return a.last_use < b.last_use;
+                               });
+
+        // Decrypt the block's data. The IV is at 0x3D0 in the still encrypted block header.
+        // The only thing we currently use from the 0x000 - 0x3FF part of the block is the IV,
+        // but it also contains SHA-1 hashes that IOS uses to check that discs aren't tampered
+        // with. http://wiibrew.org/wiki/Wii_Disc#Encrypted
+        const u8* encrypted_block = &m_read_buffer[i * BLOCK_TOTAL_SIZE];
+        Common::AES::DecryptCBC(aes_context, &encrypted_block[0x3D0],
+                                &encrypted_block[BLOCK_HEADER_SIZE], target->data.data(),
+                                BLOCK_DATA_SIZE);
+        target->offset_on_disc = block_offset_on_disc + i * BLOCK_TOTAL_SIZE;
+        target->last_use = ++m_decrypted_block_use_counter;
+        block = target;
+      }
     }
 
     // Copy the decrypted data
     u64 copy_size = std::min(_Length, BLOCK_DATA_SIZE - data_offset_in_block);
-    memcpy(_pBuffer, &m_last_decrypted_block_data[data_offset_in_block],
-           static_cast<size_t>(copy_size));
+    memcpy(_pBuffer, &block->data[data_offset_in_block], static_cast<size_t>(copy_size));
 
     // Update offsets
     _Length -= copy_size;
@@ -190,6 +217,19 @@ bool VolumeWii::Read(u64 _ReadOffset, u64 _Length, u8* _pBuffer, const Partition
   return true;
 }
 
+VolumeWii::DecryptedBlock* VolumeWii::FindDecryptedBlock(u64 offset_on_disc) const
+{
+  for (DecryptedBlock& block : m_decrypted_blocks)
+  {
+    if (block.offset_on_disc == offset_on_disc)
+    {
+      block.last_use = ++m_decrypted_block_use_counter;
+      return &block;
+    }
+  }
+  return nullptr;
+}
+
 std::vector<Partition> VolumeWii::GetPartitions() const
 {
   std::vector<Partition> partitions;
@@ -370,56 +410,129 @@ bool VolumeWii::CheckIntegrity(const Partition& partition) const
   m_pReader->Read(partition.offset + 0x2BC, 4, (u8*)&partSizeDiv4);
   u64 partDataSize = (u64)Common::swap32(partSizeDiv4) * 4;
 
-  u32 nClusters = (u32)(partDataSize / 0x8000);
-  for (u32 clusterID = 0; clusterID < nClusters; ++clusterID)
+  // The H3 table has the hashes of the H2 tables of every group
+  std::vector<u8> h3_table(H3_TABLE_SIZE);
+  const std::optional<u32> h3_offset = m_pReader->ReadSwapped<u32>(partition.offset + 0x2B4);
+  if (!h3_offset || !m_pReader->Read(partition.offset + (u64(*h3_offset) << 2), H3_TABLE_SIZE,
+                                     h3_table.data()))
   {
-    u64 clusterOff = partition.offset + PARTITION_DATA_OFFSET + (u64)clusterID * 0x8000;
+    WARN_LOG(DISCIO, "Integrity Check: could not read the H3 table");
+    return false;
+  }
 
-    // Read and decrypt the cluster metadata
-    u8 clusterMDCrypted[0x400];
-    u8 clusterMD[0x400];
-    u8 IV[16] = {0};
-    if (!m_pReader->Read(clusterOff, 0x400, clusterMDCrypted))
+  const u32 nClusters = (u32)(partDataSize / BLOCK_TOTAL_SIZE);
+  std::vector<u8> raw(GROUPS_PER_BATCH * BLOCKS_PER_GROUP * BLOCK_TOTAL_SIZE);
+  std::vector<std::array<u8, BLOCK_HEADER_SIZE>> headers(GROUPS_PER_BATCH * BLOCKS_PER_GROUP);
+  std::vector<u8> meaningful(GROUPS_PER_BATCH * BLOCKS_PER_GROUP);
+  for (u32 batch_start = 0; batch_start < nClusters;
+       batch_start += GROUPS_PER_BATCH * BLOCKS_PER_GROUP)
+  {
+    const u32 batch_size = std::min(GROUPS_PER_BATCH * BLOCKS_PER_GROUP, nClusters - batch_start);
+    const u64 batch_offset =
+        partition.offset + PARTITION_DATA_OFFSET + u64(batch_start) * BLOCK_TOTAL_SIZE;
+    if (!m_pReader->Read(batch_offset, u64(batch_size) * BLOCK_TOTAL_SIZE, raw.data()))
     {
-      WARN_LOG(DISCIO, "Integrity Check: fail at cluster %d: could not read metadata", clusterID);
+      WARN_LOG(DISCIO, "Integrity Check: fail at cluster %u: could not read data", batch_start);
       return false;
     }
-    mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, 0x400, IV, clusterMDCrypted, clusterMD);
-
-    // Some clusters have invalid data and metadata because they aren't
-    // meant to be read by the game (for example, holes between files). To
-    // try to avoid reporting errors because of these clusters, we check
-    // the 0x00 paddings in the metadata.
-    //
-    // This may cause some false negatives though: some bad clusters may be
-    // skipped because they are *too* bad and are not even recognized as
-    // valid clusters. To be improved.
-    bool meaningless = false;
-    for (u32 idx = 0x26C; idx < 0x280; ++idx)
-      if (clusterMD[idx] != 0)
-        meaningless = true;
-
-    if (meaningless)
-      continue;
 
-    u8 clusterData[0x7C00];
-    if (!Read((u64)clusterID * 0x7C00, 0x7C00, clusterData, partition))
-    {
-      WARN_LOG(DISCIO, "Integrity Check: fail at cluster %d: could not read data", clusterID);
+    // Check the H0 hashes of every cluster, which is where nearly all of the work is
+    std::atomic<bool> failed{false};
+    Common::ParallelForWorker::Loop(0, static_cast<s32>(batch_size), 4, [&](s32 begin, s32 end) {
+      std::array<u8, BLOCK_DATA_SIZE> data;
+      for (s32 i = begin; i < end && !failed; i++)
+      {
+        const u8* cluster = &raw[i * BLOCK_TOTAL_SIZE];
+        Common::AES::DecryptCBC(aes_context, ZERO_IV.data(), cluster, headers[i].data(),
+                                BLOCK_HEADER_SIZE);
+
+        // Some clusters have invalid data and metadata because they aren't
+        // meant to be read by the game (for example, holes between files). To
+        // try to avoid reporting errors because of these clusters, we check
+        // the 0x00 paddings in the metadata.
+        //
+        // This may cause some false negatives though: some bad clusters may be
+        // skipped because they are *too* bad and are not even recognized as
+        // valid clusters. To be improved.
+        meaningful[i] = std::all_of(&headers[i][0x26C], &headers[i][0x280],
+                                    [](u8 byte) { return byte == 0; });
+        if (!meaningful[i])
+          continue;
+
+        Common::AES::DecryptCBC(aes_context, &cluster[0x3D0], &cluster[BLOCK_HEADER_SIZE],
+                                data.data(), BLOCK_DATA_SIZE);
+        for (u32 hashID = 0; hashID < 31; ++hashID)
+        {
+          u8 hash[20];
+          mbedtls_sha1(&data[hashID * 0x400], 0x400, hash);
+          if (memcmp(hash, &headers[i][hashID * 20], 20))
+          {
+            WARN_LOG(DISCIO, "Integrity Check: fail at cluster %u: hash %u is invalid",
+                     batch_start + i, hashID);
+            failed = true;
+            break;
+          }
+        }
+      }
+    });
+    if (failed)
       return false;
-    }
 
-    for (u32 hashID = 0; hashID < 31; ++hashID)
+    // Check the H1 hashes of every subgroup of 8 clusters and the H2 hashes of every group of
+    // 64 clusters, but only when none of their clusters were skipped above.
+    for (u32 group_start = 0; group_start < batch_size; group_start += BLOCKS_PER_GROUP)
     {
-      u8 hash[20];
+      const u32 group_size = std::min(BLOCKS_PER_GROUP, batch_size - group_start);
+      bool group_meaningful = group_size == BLOCKS_PER_GROUP;
+      for (u32 subgroup = 0; subgroup * BLOCKS_PER_SUBGROUP < group_size; subgroup++)
+      {
+        const u32 first = group_start + subgroup * BLOCKS_PER_SUBGROUP;
+        const u32 count = std::min(BLOCKS_PER_SUBGROUP, batch_size - first);
+        if (count != BLOCKS_PER_SUBGROUP ||
+            !std::all_of(&meaningful[first], &meaningful[first] + count, [](u8 m) { return m; }))
+        {
+          group_meaningful = false;
+          continue;
+        }
+
+        u8 h1[BLOCKS_PER_SUBGROUP * 20];
+        for (u32 i = 0; i < BLOCKS_PER_SUBGROUP; i++)
+          mbedtls_sha1(headers[first + i].data(), 0x26C, &h1[i * 20]);
+        for (u32 i = 0; i < BLOCKS_PER_SUBGROUP; i++)
+        {
+          if (memcmp(h1, &headers[first + i][0x280], sizeof(h1)))
+          {
+            WARN_LOG(DISCIO, "Integrity Check: fail at cluster %u: H1 table is invalid",
+                     batch_start + first + i);
+            return false;
+          }
+        }
+      }
+      if (!group_meaningful)
+        continue;
 
-      mbedtls_sha1(clusterData + hashID * 0x400, 0x400, hash);
+      u8 h2[BLOCKS_PER_GROUP / BLOCKS_PER_SUBGROUP * 20];
+      for (u32 subgroup = 0; subgroup < BLOCKS_PER_GROUP / BLOCKS_PER_SUBGROUP; subgroup++)
+      {
+        mbedtls_sha1(&headers[group_start + subgroup * BLOCKS_PER_SUBGROUP][0x280],
+                     BLOCKS_PER_SUBGROUP * 20, &h2[subgroup * 20]);
+      }
+      for (u32 i = 0; i < BLOCKS_PER_GROUP; i++)
+      {
+        if (memcmp(h2, &headers[group_start + i][0x340], sizeof(h2)))
+        {
+          WARN_LOG(DISCIO, "Integrity Check: fail at cluster %u: H2 table is invalid",
+                   batch_start + group_start + i);
+          return false;
+        }
+      }
 
-      // Note that we do not use strncmp here
-      if (memcmp(hash, clusterMD + hashID * 20, 20))
+      const u32 group = (batch_start + group_start) / BLOCKS_PER_GROUP;
+      u8 h3[20];
+      mbedtls_sha1(h2, sizeof(h2), h3);
+      if (u64(group + 1) * 20 > h3_table.size() || memcmp(h3, &h3_table[group * 20], sizeof(h3)))
       {
-        WARN_LOG(DISCIO, "Integrity Check: fail at cluster %d: hash %d is invalid", clusterID,
-                 hashID);
+        WARN_LOG(DISCIO, "Integrity Check: fail at group %u: H3 hash is invalid", group);
         return false;
       }
     }
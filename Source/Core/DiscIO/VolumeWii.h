@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <map>
 #include <mbedtls/aes.h>
 #include <memory>
@@ -81,8 +82,23 @@ private:
   std::map<Partition, PartitionDetails> m_partitions;
   Partition m_game_partition;
 
-  mutable u64 m_last_decrypted_block;
-  mutable u8 m_last_decrypted_block_data[BLOCK_DATA_SIZE];
+  struct DecryptedBlock
+  {
+    u64 offset_on_disc = UINT64_MAX;
+    u64 last_use = 0;
+    std::array<u8, BLOCK_DATA_SIZE> data;
+  };
+
+  // Enough for streaming from a few files at once without the reads evicting each other.
+  static constexpr size_t DECRYPTED_BLOCK_CACHE_SIZE = 32;
+  // Missing blocks that are read and decrypted together, at most.
+  static constexpr size_t MAX_BLOCKS_PER_BATCH = 8;
+
+  DecryptedBlock* FindDecryptedBlock(u64 offset_on_disc) const;
+
+  mutable std::array<DecryptedBlock, DECRYPTED_BLOCK_CACHE_SIZE> m_decrypted_blocks;
+  mutable u64 m_decrypted_block_use_counter = 0;
+  mutable std::vector<u8> m_read_buffer;
 };
 
 }  // namespace
@@ -3,28 +3,40 @@
 // Refer to the license.txt file included.
 
 #include <OptionParser.h>
+#include <algorithm>
+#include <cinttypes>
 #include <cstddef>
 #include <cstdio>
 #include <cstring>
+#include <iostream>
 #include <signal.h>
 #include <string>
 #include <thread>
 #include <unistd.h>
+#include <variant>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/Event.h"
 #include "Common/Flag.h"
 #include "Common/Logging/LogManager.h"
 #include "Common/MsgHandler.h"
+#include "Common/Timer.h"
 
 #include "Core/Analytics.h"
 #include "Core/Boot/Boot.h"
 #include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/FifoPlayer/FifoPlayer.h"
+#include "Core/HW/SystemTimers.h"
 #include "Core/Host.h"
 #include "Core/IOS/IOS.h"
 #include "Core/IOS/STM/STM.h"
+#include "Core/Movie.h"
 #include "Core/State.h"
 
 #include "UICommon/CommandLineParse.h"
@@ -33,6 +45,8 @@
 #endif
 #include "UICommon/UICommon.h"
 
+#include "VideoCommon/DrawProfiler.h"
+#include "VideoCommon/FrameTelemetry.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/VideoBackendBase.h"
 
@@ -361,9 +375,123 @@ static Platform* GetPlatform()
   return nullptr;
 }
 
+// Writes the frame times of a benchmark run, as CSV to stdout when no file was given.
+static bool WriteBenchmarkResults(const std::string& filename)
+{
+  const std::vector<FrameTelemetry::Frame> frames = FrameTelemetry::GetFrames();
+  if (!frames.empty())
+  {
+    double cpu_total = 0;
+    double gpu_total = 0;
+    for (const FrameTelemetry::Frame& frame : frames)
+    {
+      cpu_total += frame.cpu_frame_time_ms;
+      gpu_total += std::max(frame.gpu_frame_time_ms, 0.0f);
+    }
+    fprintf(stderr, "Benchmark: %zu frames, %.3f ms CPU, %.3f ms GPU per frame\n", frames.size(),
+            cpu_total / frames.size(), gpu_total / frames.size());
+  }
+
+  if (filename.empty())
+  {
+    FrameTelemetry::ExportCSV(std::cout);
+    return std::cout.good();
+  }
+  return FrameTelemetry::Export(filename);
+}
+
+// Writes the per draw costs of a profiled benchmark run and prints the most expensive objects.
+static bool WriteDrawProfile(const std::string& filename)
+{
+  const std::vector<DrawProfiler::ObjectCost> costs = DrawProfiler::GetObjectCosts();
+  constexpr size_t SHOWN_OBJECTS = 10;
+  fprintf(stderr, "Most expensive objects (frame/object: draws, CPU us, GPU us):\n");
+  for (size_t i = 0; i < std::min(costs.size(), SHOWN_OBJECTS); i++)
+  {
+    const DrawProfiler::ObjectCost& cost = costs[i];
+    fprintf(stderr, "  %u/%u: %u, %.1f, ", cost.frame, cost.object, cost.draws, cost.cpu_time_us);
+    if (cost.gpu_time_us >= 0.0f)
+      fprintf(stderr, "%.1f\n", cost.gpu_time_us);
+    else
+      fprintf(stderr, "-\n");
+  }
+
+  return DrawProfiler::Export(filename);
+}
+
+struct ReplayTiming
+{
+  u64 start_ms = 0;
+  u64 end_ms = 0;
+  u64 frames = 0;
+  u64 lag_frames = 0;
+  double emulated_seconds = 0;
+};
+
+// Stops emulation once the movie has played to its end, and notes how long that took.
+static void WatchReplay(ReplayTiming* timing)
+{
+  while (s_running.IsSet())
+  {
+    if (Core::IsRunningAndStarted() && !Movie::IsPlayingInput())
+    {
+      timing->end_ms = Common::Timer::GetTimeMs();
+      timing->frames = Movie::GetCurrentFrame();
+      timing->lag_frames = Movie::GetCurrentLagCount();
+      timing->emulated_seconds =
+          static_cast<double>(CoreTiming::GetTicks()) / SystemTimers::GetTicksPerSecond();
+      s_running.Clear();
+      updateMainFrameEvent.Set();
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+static void PrintReplayTiming(const ReplayTiming& timing)
+{
+  if (!timing.end_ms)
+  {
+    fprintf(stderr, "Replay: stopped before the end of the movie\n");
+    return;
+  }
+
+  const double seconds = std::max<u64>(timing.end_ms - timing.start_ms, 1) / 1000.0;
+  fprintf(stderr,
+          "Replay: %" PRIu64 " frames (%" PRIu64 " lag) in %.2f s, %.1f frames/s, "
+          "%.2f s emulated (%.0f%% speed)\n",
+          timing.frames, timing.lag_frames, seconds, timing.frames / seconds,
+          timing.emulated_seconds, timing.emulated_seconds / seconds * 100);
+}
+
 int main(int argc, char* argv[])
 {
   auto parser = CommandLineParse::CreateParser(CommandLineParse::ParserOptions::OmitGUIOptions);
+  parser->add_option("--benchmark")
+      .action("store")
+      .metavar("<loops>")
+      .type("int")
+      .help("Play a FIFO log this many times without a frame limit and report the frame times");
+  parser->add_option("--benchmark_output")
+      .action("store")
+      .metavar("<file>")
+      .type("string")
+      .help("Write the benchmark frame times to a .csv or .json file instead of stdout");
+  parser->add_option("--benchmark_draws")
+      .action("store")
+      .metavar("<file>")
+      .type("string")
+      .help("With --benchmark, play the log object by object and write the cost of every draw "
+            "to a .csv file");
+  parser->add_option("--replay")
+      .action("store_true")
+      .help("Play the movie given with --movie as fast as possible without audio or video, then "
+            "exit and report the timing");
+  parser->add_option("--replay_present")
+      .action("store")
+      .metavar("<fields>")
+      .type("int")
+      .help("While replaying, still show every Nth field (e.g. to dump frames)");
   optparse::Values& options = CommandLineParse::ParseArguments(parser.get(), argc, argv);
   std::vector<std::string> args = parser->args();
 
@@ -395,6 +523,28 @@ int main(int argc, char* argv[])
     return 0;
   }
 
+  const u32 benchmark_loops =
+      options.is_set("benchmark") ? static_cast<u32>(static_cast<int>(options.get("benchmark"))) :
+                                    0;
+  if (options.is_set("benchmark") &&
+      (!benchmark_loops || !boot || !std::holds_alternative<BootParameters::DFF>(boot->parameters)))
+  {
+    fprintf(stderr, "--benchmark needs a FIFO log and a loop count of at least 1\n");
+    return 1;
+  }
+  if (options.is_set("benchmark_draws") && !benchmark_loops)
+  {
+    fprintf(stderr, "--benchmark_draws needs --benchmark\n");
+    return 1;
+  }
+
+  const bool replay = options.is_set("replay");
+  if (replay && !options.is_set("movie"))
+  {
+    fprintf(stderr, "--replay needs a movie to play (--movie)\n");
+    return 1;
+  }
+
   std::string user_directory;
   if (options.is_set("user"))
   {
@@ -427,12 +577,53 @@ int main(int argc, char* argv[])
 
   DolphinAnalytics::Instance()->ReportDolphinStart("nogui");
 
+  if (benchmark_loops)
+  {
+    // The FIFO player powers down after the last loop, which stops the main loop below.
+    FifoPlayer::GetInstance().SetLoopLimit(benchmark_loops);
+    if (options.is_set("benchmark_draws"))
+      FifoPlayer::GetInstance().SetProfileDraws(true);
+    Config::SetCurrent(Config::GFX_VSYNC, false);
+  }
+
+  if (options.is_set("movie"))
+  {
+    std::optional<std::string> savestate_path;
+    if (!Movie::PlayInput(static_cast<const char*>(options.get("movie")), &savestate_path))
+    {
+      fprintf(stderr, "Could not play the specified movie\n");
+      return 1;
+    }
+    boot->savestate_path = savestate_path;
+  }
+
+  // Replays never touch the audio device. The backend is put back before the config is saved.
+  const std::string audio_backend = SConfig::GetInstance().sBackend;
+  if (replay)
+  {
+    SConfig::GetInstance().sBackend = BACKEND_NULLSOUND;
+    Config::SetCurrent(Config::GFX_VSYNC, false);
+
+    const int present =
+        options.is_set("replay_present") ? static_cast<int>(options.get("replay_present")) : 0;
+    if (present > 0)
+      Core::SetOutputInterval(present);
+    else
+      Core::SetOutputSuppressed(true);
+  }
+
   if (!BootManager::BootCore(std::move(boot)))
   {
     fprintf(stderr, "Could not boot the specified file\n");
     return 1;
   }
 
+  if (benchmark_loops || replay)
+  {
+    SConfig::GetInstance().m_EmulationSpeed = 0.0f;
+    BootManager::SetEmulationSpeedReset(true);
+  }
+
 #ifdef USE_DISCORD_PRESENCE
   Discord::UpdateDiscordPresence();
 #endif
@@ -443,15 +634,51 @@ int main(int argc, char* argv[])
     updateMainFrameEvent.Wait();
   }
 
+  ReplayTiming replay_timing;
+  std::thread replay_watcher;
+  if (replay)
+  {
+    replay_timing.start_ms = Common::Timer::GetTimeMs();
+    replay_watcher = std::thread(WatchReplay, &replay_timing);
+  }
+
   if (s_running.IsSet())
     platform->MainLoop();
+
+  if (replay_watcher.joinable())
+    replay_watcher.join();
   Core::Stop();
 
   Core::Shutdown();
+
+  if (replay)
+  {
+    PrintReplayTiming(replay_timing);
+    Core::SetOutputInterval(0);
+    SConfig::GetInstance().sBackend = audio_backend;
+  }
+
+  int exit_code = 0;
+  if (benchmark_loops)
+  {
+    const std::string output =
+        options.is_set("benchmark_output") ? options["benchmark_output"] : std::string();
+    if (!WriteBenchmarkResults(output))
+    {
+      fprintf(stderr, "Could not write the benchmark results\n");
+      exit_code = 1;
+    }
+    if (options.is_set("benchmark_draws") && !WriteDrawProfile(options["benchmark_draws"]))
+    {
+      fprintf(stderr, "Could not write the draw profile\n");
+      exit_code = 1;
+    }
+  }
+
   platform->Shutdown();
   UICommon::Shutdown();
 
   delete platform;
 
-  return 0;
+  return exit_code;
 }
@@ -252,8 +252,9 @@ void FIFOPlayerWindow::UpdateInfo()
 
     for (u32 i = 0; i < file->GetFrameCount(); ++i)
     {
-      fifo_bytes += file->GetFrame(i).fifoData.size();
-      for (const auto& mem_update : file->GetFrame(i).memoryUpdates)
+      const auto frame = file->GetFrame(i);
+      fifo_bytes += frame->fifoData.size();
+      for (const auto& mem_update : frame->memoryUpdates)
         mem_bytes += mem_update.data.size();
     }
 
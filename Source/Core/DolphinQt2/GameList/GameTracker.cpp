@@ -13,8 +13,9 @@
 
 static const QStringList game_filters{
     QStringLiteral("*.gcm"),  QStringLiteral("*.iso"), QStringLiteral("*.tgc"),
-    QStringLiteral("*.ciso"), QStringLiteral("*.gcz"), QStringLiteral("*.wbfs"),
-    QStringLiteral("*.wad"),  QStringLiteral("*.elf"), QStringLiteral("*.dol")};
+    QStringLiteral("*.ciso"), QStringLiteral("*.gcz"), QStringLiteral("*.dcz"),
+    QStringLiteral("*.wbfs"), QStringLiteral("*.wad"), QStringLiteral("*.elf"),
+    QStringLiteral("*.dol")};
 
 GameTracker::GameTracker(QObject* parent) : QFileSystemWatcher(parent)
 {
@@ -134,8 +135,11 @@ void GameTracker::UpdateFileInternal(const QString& file)
 {
   if (QFileInfo(file).exists())
   {
-    GameRemoved(file);
+    emit GameRemoved(file);
     addPath(file);
+    // The file has changed on disk, so the cached entry can't be reused as is
+    if (m_cache.UpdateFile(file.toStdString(), m_title_database))
+      m_cache.Save();
     LoadGame(file);
   }
   else if (removePath(file))
@@ -402,5 +402,8 @@ void HotkeyScheduler::Run()
 
     if (IsHotkey(HK_UNDO_SAVE_STATE))
       State::UndoSaveState();
+
+    if (IsHotkey(HK_REWIND))
+      State::Rewind();
   }
 }
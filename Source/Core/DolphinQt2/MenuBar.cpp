@@ -919,6 +919,8 @@ void MenuBar::LoadSymbolMap()
     SignatureDB db(SignatureDB::HandlerType::DSY);
     if (db.Load(File::GetSysDirectory() + TOTALDB))
       db.Apply(&g_symbolDB);
+    // Boot loads this map and patches HLE functions without scanning again.
+    g_symbolDB.SaveSymbolMap(writable_map_file);
 
     QMessageBox::warning(this, tr("Warning"),
                          tr("'%1' not found, scanning for common functions instead")
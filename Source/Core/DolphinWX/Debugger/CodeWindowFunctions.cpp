@@ -160,6 +160,20 @@ void CCodeWindow::OnProfilerMenu(wxCommandEvent& event)
         wxExecute(OpenCommand, wxEXEC_SYNC);
     }
     break;
+  case IDM_PROFILE_SAMPLES:
+    if (GetParentMenuBar()->IsChecked(IDM_PROFILE_SAMPLES))
+      Profiler::StartSampling();
+    else
+      Profiler::StopSampling();
+    break;
+  case IDM_WRITE_SAMPLES:
+  {
+    std::string filename = File::GetUserPath(D_DUMP_IDX) + "Debug/profiler_samples.folded";
+    File::CreateFullPath(filename);
+    Profiler::WriteSampleResults(filename);
+    Parent->StatusBarMessage("Wrote %s", filename.c_str());
+    break;
+  }
   }
 }
 
@@ -245,6 +259,8 @@ void CCodeWindow::OnSymbolsMenu(wxCommandEvent& event)
       SignatureDB db(SignatureDB::HandlerType::DSY);
       if (db.Load(File::GetSysDirectory() + TOTALDB))
         db.Apply(&g_symbolDB);
+      // Boot loads this map and patches HLE functions without scanning again.
+      g_symbolDB.SaveSymbolMap(writable_map_file);
       Parent->StatusBarMessage("'%s' not found, scanning for common functions instead",
         writable_map_file.c_str());
     }
@@ -76,6 +76,7 @@
 
 #include "UICommon/UICommon.h"
 
+#include "VideoCommon/FrameTelemetry.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/PostProcessing.h"
 #include "VideoCommon/RenderBase.h"
@@ -1332,6 +1333,10 @@ void CFrame::ParseHotkeys()
   // Screenshot hotkey
   if (IsHotkey(HK_SCREENSHOT))
     Core::SaveScreenShot();
+  if (IsHotkey(HK_EXPORT_FRAME_TELEMETRY))
+    FrameTelemetry::ExportToDumpFolder();
+  if (IsHotkey(HK_TOGGLE_TRACE_CAPTURE))
+    Core::ToggleTraceCapture();
   if (IsHotkey(HK_EXIT))
     wxPostEvent(this, wxCommandEvent(wxEVT_MENU, wxID_EXIT));
 
@@ -1661,6 +1666,8 @@ void CFrame::ParseHotkeys()
     State::UndoLoadState();
   if (IsHotkey(HK_UNDO_SAVE_STATE))
     State::UndoSaveState();
+  if (IsHotkey(HK_REWIND))
+    State::Rewind();
 }
 
 void CFrame::HandleFrameSkipHotkeys()
@@ -63,6 +63,8 @@
 #include "UICommon/GameFile.h"
 #include "UICommon/GameFileCache.h"
 #include "UICommon/UICommon.h"
+#include "VideoCommon/HiresTextures.h"
+#include "VideoCommon/ShaderUIDBundle.h"
 
 struct CompressionProgress final
 {
@@ -263,6 +265,9 @@ GameListCtrl::GameListCtrl(bool disable_scanning, wxWindow* parent, const wxWind
   Bind(wxEVT_MENU, &GameListCtrl::OnExportSave, this, IDM_EXPORT_SAVE);
   Bind(wxEVT_MENU, &GameListCtrl::OnSetDefaultISO, this, IDM_SET_DEFAULT_ISO);
   Bind(wxEVT_MENU, &GameListCtrl::OnCompressISO, this, IDM_COMPRESS_ISO);
+  Bind(wxEVT_MENU, &GameListCtrl::OnBuildTexturePack, this, IDM_BUILD_TEXTURE_PACK);
+  Bind(wxEVT_MENU, &GameListCtrl::OnBuildMaterialMaps, this, IDM_BUILD_MATERIAL_MAPS);
+  Bind(wxEVT_MENU, &GameListCtrl::OnExportShaderUIDs, this, IDM_EXPORT_SHADER_UIDS);
   Bind(wxEVT_MENU, &GameListCtrl::OnMultiCompressISO, this, IDM_MULTI_COMPRESS_ISO);
   Bind(wxEVT_MENU, &GameListCtrl::OnMultiDecompressISO, this, IDM_MULTI_DECOMPRESS_ISO);
   Bind(wxEVT_MENU, &GameListCtrl::OnDeleteISO, this, IDM_DELETE_ISO);
@@ -273,9 +278,11 @@ GameListCtrl::GameListCtrl(bool disable_scanning, wxWindow* parent, const wxWind
   Bind(DOLPHIN_EVT_RESCAN_GAMELIST, &GameListCtrl::OnRescanGameList, this);
 
   wxTheApp->Bind(DOLPHIN_EVT_LOCAL_INI_CHANGED, &GameListCtrl::OnLocalIniModified, this);
+  Bind(wxEVT_IDLE, &GameListCtrl::OnIdle, this);
 
   if (!disable_scanning)
   {
+    CallAfter(&GameListCtrl::UpdateFileSystemWatcher);
     m_scan_thread = std::thread([&] {
       Common::SetCurrentThreadName("Game list scanner");
 
@@ -289,7 +296,10 @@ GameListCtrl::GameListCtrl(bool disable_scanning, wxWindow* parent, const wxWind
       m_scan_trigger.Wait();
       while (!m_scan_exiting.IsSet())
       {
-        RescanList();
+        if (m_rescan_requested.TestAndClear())
+          RescanList();
+        else
+          UpdateChangedFiles();
         m_scan_trigger.Wait();
       }
     });
@@ -394,7 +404,8 @@ void GameListCtrl::BrowseForDirectory()
     {
       SConfig::GetInstance().m_ISOFolder.push_back(sPath);
       SConfig::GetInstance().SaveSettings();
-      m_scan_trigger.Set();
+      UpdateFileSystemWatcher();
+      RequestRescan();
     }
   }
 }
@@ -468,6 +479,7 @@ void GameListCtrl::RefreshList()
     }
 
     // add all items
+    m_banner_loaded.assign(m_shown_files.size(), false);
     for (int i = 0; i < (int)m_shown_files.size(); i++)
       InsertItemInReportView(i);
     SetColors();
@@ -539,16 +551,10 @@ void GameListCtrl::UpdateItemAtColumn(long index, int column)
   }
   case COLUMN_BANNER:
   {
-    int image_index = m_image_indexes.utility_banner[0];  // nobanner
-
-    wxImage banner = WxUtils::ToWxImage(iso_file.GetBannerImage());
-    if (banner.IsOk())
-    {
-      wxImageList* img_list = GetImageList(wxIMAGE_LIST_SMALL);
-      image_index = img_list->Add(WxUtils::ScaleImageToBitmap(banner, this, img_list->GetSize()));
-    }
-
-    SetItemColumnImage(index, COLUMN_BANNER, image_index);
+    // Scaling thousands of banners up front makes big lists slow to show, so rows start out
+    // with the placeholder and LoadVisibleBanners fills in the ones that get scrolled to.
+    m_banner_loaded[GetItemData(index)] = false;
+    SetItemColumnImage(index, COLUMN_BANNER, m_image_indexes.utility_banner[0]);  // nobanner
     break;
   }
   case COLUMN_TITLE:
@@ -593,6 +599,31 @@ void GameListCtrl::UpdateItemAtColumn(long index, int column)
   }
 }
 
+void GameListCtrl::LoadVisibleBanners()
+{
+  if (GetItemCount() == 0 || GetColumnWidth(COLUMN_BANNER) == 0)
+    return;
+
+  const long first = std::max(GetTopItem(), 0L);
+  const long last = std::min<long>(first + GetCountPerPage() + 1, GetItemCount());
+  for (long index = first; index < last; index++)
+  {
+    const size_t item = GetItemData(index);
+    if (item >= m_banner_loaded.size() || m_banner_loaded[item])
+      continue;
+    m_banner_loaded[item] = true;
+
+    wxImage banner = WxUtils::ToWxImage(m_shown_files[item]->GetBannerImage());
+    if (banner.IsOk())
+    {
+      wxImageList* img_list = GetImageList(wxIMAGE_LIST_SMALL);
+      const int image_index =
+          img_list->Add(WxUtils::ScaleImageToBitmap(banner, this, img_list->GetSize()));
+      SetItemColumnImage(index, COLUMN_BANNER, image_index);
+    }
+  }
+}
+
 void GameListCtrl::InsertItemInReportView(long index)
 {
   // When using wxListCtrl, there is no hope of per-column text colors.
@@ -659,6 +690,12 @@ void GameListCtrl::RescanList()
 
   post_status(_("Scanning..."));
 
+  // A full scan covers whatever the file system watcher reported
+  {
+    std::lock_guard<std::mutex> lk(m_changed_paths_mutex);
+    m_changed_paths.clear();
+  }
+
   const std::vector<std::string> game_paths = UICommon::FindAllGamePaths(
     SConfig::GetInstance().m_ISOFolder, SConfig::GetInstance().m_RecursiveISOFolder);
 
@@ -694,6 +731,108 @@ void GameListCtrl::RescanList()
     m_cache.Save();
 }
 
+void GameListCtrl::RequestRescan()
+{
+  m_rescan_requested.Set();
+  m_scan_trigger.Set();
+}
+
+void GameListCtrl::UpdateChangedFiles()
+{
+  std::vector<std::string> paths;
+  {
+    std::lock_guard<std::mutex> lk(m_changed_paths_mutex);
+    paths.swap(m_changed_paths);
+  }
+  std::sort(paths.begin(), paths.end());
+  paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+  bool cache_changed = false;
+  {
+    std::unique_lock<std::mutex> lk(m_cache_mutex);
+    for (const std::string& path : paths)
+      cache_changed |= m_cache.UpdateFile(path, m_title_database);
+  }
+
+  if (cache_changed)
+  {
+    QueueEvent(new wxCommandEvent(DOLPHIN_EVT_REFRESH_GAMELIST));
+    m_cache.Save();
+  }
+}
+
+void GameListCtrl::UpdateFileSystemWatcher()
+{
+#if wxUSE_FSWATCHER
+  // The watcher needs a running event loop, so this isn't done in the constructor.
+  if (!m_watcher)
+  {
+    m_watcher = std::make_unique<wxFileSystemWatcher>();
+    m_watcher->SetOwner(this);
+    Bind(wxEVT_FSWATCHER, &GameListCtrl::OnFileSystemChange, this);
+  }
+
+  m_watcher->RemoveAll();
+  for (const std::string& folder : SConfig::GetInstance().m_ISOFolder)
+  {
+    const wxFileName dir = wxFileName::DirName(StrToWxStr(folder));
+    if (!dir.DirExists())
+      continue;
+    if (SConfig::GetInstance().m_RecursiveISOFolder)
+      m_watcher->AddTree(dir);
+    else
+      m_watcher->Add(dir);
+  }
+#endif
+}
+
+#if wxUSE_FSWATCHER
+void GameListCtrl::OnFileSystemChange(wxFileSystemWatcherEvent& event)
+{
+  const int type = event.GetChangeType();
+  if (type & (wxFSW_EVENT_WARNING | wxFSW_EVENT_ERROR))
+  {
+    // Events may have been lost
+    RequestRescan();
+    return;
+  }
+
+  std::vector<wxFileName> names{event.GetPath()};
+  if (type & wxFSW_EVENT_RENAME)
+    names.push_back(event.GetNewPath());
+
+  bool changed = false;
+  for (const wxFileName& name : names)
+  {
+    if (name.DirExists())
+    {
+      // A new or renamed folder can hold any number of games
+      if (type & (wxFSW_EVENT_CREATE | wxFSW_EVENT_RENAME))
+        RequestRescan();
+      continue;
+    }
+
+    const std::string extension = "." + WxStrToStr(name.GetExt().Lower());
+    const auto& extensions = UICommon::GetGameFileExtensions();
+    if (std::find(extensions.begin(), extensions.end(), extension) == extensions.end())
+      continue;
+
+    std::lock_guard<std::mutex> lk(m_changed_paths_mutex);
+    m_changed_paths.push_back(WxStrToStr(name.GetFullPath()));
+    changed = true;
+  }
+
+  if (changed)
+    m_scan_trigger.Set();
+}
+#endif
+
+void GameListCtrl::OnIdle(wxIdleEvent& event)
+{
+  event.Skip();
+  LoadVisibleBanners();
+}
+
 void GameListCtrl::OnRefreshGameList(wxCommandEvent& WXUNUSED(event))
 {
   RefreshList();
@@ -707,7 +846,9 @@ void GameListCtrl::OnRescanGameList(wxCommandEvent& event)
     std::unique_lock<std::mutex> lk(m_cache_mutex);
     m_cache.Clear();
   }
-  m_scan_trigger.Set();
+  // The folders may have changed
+  UpdateFileSystemWatcher();
+  RequestRescan();
 }
 
 void GameListCtrl::OnLocalIniModified(wxCommandEvent& ev)
@@ -716,7 +857,7 @@ void GameListCtrl::OnLocalIniModified(wxCommandEvent& ev)
   // We need show any changes to the ini which could impact our columns. Currently only the
   // EmuState/Issues settings can do that. We also need to persist the changes to the cache - so
   // just trigger a rescan which will sync the cache and then display the new values.
-  m_scan_trigger.Set();
+  RequestRescan();
 }
 
 void GameListCtrl::OnColBeginDrag(wxListEvent& event)
@@ -993,6 +1134,18 @@ void GameListCtrl::OnRightClick(wxMouseEvent& event)
 
         wxMenuItem* changeDiscItem = popupMenu.Append(IDM_LIST_CHANGE_DISC, _("Change &Disc"));
         changeDiscItem->Enable(Core::IsRunning());
+
+        wxMenuItem* texture_pack_item =
+          popupMenu.Append(IDM_BUILD_TEXTURE_PACK, _("Build Custom Texture Pack..."));
+        texture_pack_item->Enable(!Core::IsRunning());
+
+        wxMenuItem* material_maps_item =
+          popupMenu.Append(IDM_BUILD_MATERIAL_MAPS, _("Build Custom Texture Material Maps..."));
+        material_maps_item->Enable(!Core::IsRunning());
+
+        wxMenuItem* shader_uids_item =
+          popupMenu.Append(IDM_EXPORT_SHADER_UIDS, _("Export Shader UIDs..."));
+        shader_uids_item->Enable(!Core::IsRunning());
       }
 
       if (platform == DiscIO::Platform::WiiDisc)
@@ -1133,7 +1286,7 @@ void GameListCtrl::OnDeleteISO(wxCommandEvent& WXUNUSED(event))
   {
     for (const UICommon::GameFile* iso : GetAllSelectedISOs())
       File::Delete(iso->GetFilePath());
-    m_scan_trigger.Set();
+    RequestRescan();
   }
 }
 
@@ -1298,7 +1451,7 @@ void GameListCtrl::CompressSelection(bool _compress)
   if (!all_good)
     WxUtils::ShowErrorDialog(_("Dolphin was unable to complete the requested action."));
 
-  m_scan_trigger.Set();
+  RequestRescan();
 }
 
 bool GameListCtrl::CompressCB(const std::string& text, float percent, void* arg)
@@ -1371,7 +1524,73 @@ void GameListCtrl::OnCompressISO(wxCommandEvent& WXUNUSED(event))
   if (!all_good)
     WxUtils::ShowErrorDialog(_("Dolphin was unable to complete the requested action."));
 
-  m_scan_trigger.Set();
+  RequestRescan();
+}
+
+void GameListCtrl::OnBuildTexturePack(wxCommandEvent& WXUNUSED(event))
+{
+  const UICommon::GameFile* iso = GetSelectedISO();
+  if (!iso || Core::IsRunning())
+    return;
+
+  bool all_good;
+  {
+    wxProgressDialog dialog(_("Building Custom Texture Pack"), _("Working..."), 1000, this,
+      wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME |
+      wxPD_ESTIMATED_TIME | wxPD_REMAINING_TIME | wxPD_SMOOTH);
+
+    all_good = HiresTexture::BuildPack(iso->GetGameID(), [&dialog](size_t done, size_t total) {
+      return dialog.Update(static_cast<int>(done * 1000 / total),
+        wxString::Format(_("Converting texture %u of %u"), static_cast<unsigned int>(done + 1),
+          static_cast<unsigned int>(total)));
+    });
+  }
+
+  if (!all_good)
+    WxUtils::ShowErrorDialog(_("Dolphin was unable to build a texture pack. Make sure the custom "
+      "textures of this game are in Load/Textures."));
+}
+
+void GameListCtrl::OnBuildMaterialMaps(wxCommandEvent& WXUNUSED(event))
+{
+  const UICommon::GameFile* iso = GetSelectedISO();
+  if (!iso || Core::IsRunning())
+    return;
+
+  bool all_good;
+  {
+    wxProgressDialog dialog(_("Building Material Maps"), _("Working..."), 1000, this,
+      wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_ELAPSED_TIME |
+      wxPD_ESTIMATED_TIME | wxPD_REMAINING_TIME | wxPD_SMOOTH);
+
+    all_good =
+      HiresTexture::BuildMaterialMaps(iso->GetGameID(), [&dialog](size_t done, size_t total) {
+      return dialog.Update(static_cast<int>(done * 1000 / total),
+        wxString::Format(_("Building material map %u of %u"),
+          static_cast<unsigned int>(done + 1), static_cast<unsigned int>(total)));
+    });
+  }
+
+  if (!all_good)
+    WxUtils::ShowErrorDialog(_("Dolphin was unable to build the material maps. Make sure the "
+      "custom textures of this game in Load/Textures have normal maps."));
+}
+
+void GameListCtrl::OnExportShaderUIDs(wxCommandEvent& WXUNUSED(event))
+{
+  const UICommon::GameFile* iso = GetSelectedISO();
+  if (!iso || Core::IsRunning())
+    return;
+
+  if (!ShaderUIDBundle::Export(iso->GetGameID()))
+  {
+    WxUtils::ShowErrorDialog(_("Dolphin was unable to export the shader UIDs of this game. They "
+      "are only recorded after the game has been played."));
+    return;
+  }
+  wxMessageBox(wxString::Format(_("Shader UIDs exported to %s"),
+    StrToWxStr(ShaderUIDBundle::GetExportPath(iso->GetGameID()))),
+    _("Export Shader UIDs"), wxOK | wxICON_INFORMATION, this);
 }
 
 void GameListCtrl::OnChangeDisc(wxCommandEvent& WXUNUSED(event))
@@ -6,10 +6,12 @@
 
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include <wx/fswatcher.h>
 #include <wx/listctrl.h>
 #include <wx/tipwin.h>
 
@@ -85,6 +87,11 @@ private:
   void SetColors();
   void RefreshList();
   void RescanList();
+  void RequestRescan();
+  // Only re-reads the files that the file system watcher reported as changed
+  void UpdateChangedFiles();
+  void UpdateFileSystemWatcher();
+  void LoadVisibleBanners();
   std::vector<const UICommon::GameFile*> GetAllSelectedISOs() const;
 
   // events
@@ -106,10 +113,17 @@ private:
   void OnSetDefaultISO(wxCommandEvent& event);
   void OnDeleteISO(wxCommandEvent& event);
   void OnCompressISO(wxCommandEvent& event);
+  void OnBuildTexturePack(wxCommandEvent& event);
+  void OnBuildMaterialMaps(wxCommandEvent& event);
+  void OnExportShaderUIDs(wxCommandEvent& event);
   void OnMultiCompressISO(wxCommandEvent& event);
   void OnMultiDecompressISO(wxCommandEvent& event);
   void OnChangeDisc(wxCommandEvent& event);
   void OnLocalIniModified(wxCommandEvent& event);
+  void OnIdle(wxIdleEvent& event);
+#if wxUSE_FSWATCHER
+  void OnFileSystemChange(wxFileSystemWatcherEvent& event);
+#endif
 
   void CompressSelection(bool _compress);
   void AutomaticColumnWidth();
@@ -136,8 +150,18 @@ private:
   std::thread m_scan_thread;
   Common::Event m_scan_trigger;
   Common::Flag m_scan_exiting;
+  // A full rescan was requested, otherwise the scan thread only looks at m_changed_paths
+  Common::Flag m_rescan_requested;
+  std::mutex m_changed_paths_mutex;
+  std::vector<std::string> m_changed_paths;
+#if wxUSE_FSWATCHER
+  std::unique_ptr<wxFileSystemWatcher> m_watcher;
+#endif
   // UI thread's view into the cache
   std::vector<std::shared_ptr<const UICommon::GameFile>> m_shown_files;
+  // Banners are only scaled and added to the image list once their row is visible,
+  // indexed like m_shown_files
+  std::vector<bool> m_banner_loaded;
 
   int m_last_column;
   int m_last_sort;
@@ -256,6 +256,8 @@ enum
   // Profiler
   IDM_PROFILE_BLOCKS,
   IDM_WRITE_PROFILE,
+  IDM_PROFILE_SAMPLES,
+  IDM_WRITE_SAMPLES,
   // --------------------------------------------------------------
 
   // --------------------------------------------------------------
@@ -298,6 +300,9 @@ enum
   IDM_SET_DEFAULT_ISO,
   IDM_DELETE_ISO,
   IDM_COMPRESS_ISO,
+  IDM_BUILD_TEXTURE_PACK,
+  IDM_BUILD_MATERIAL_MAPS,
+  IDM_EXPORT_SHADER_UIDS,
   IDM_START_NETPLAY,
   IDM_MULTI_COMPRESS_ISO,
   IDM_MULTI_DECOMPRESS_ISO,
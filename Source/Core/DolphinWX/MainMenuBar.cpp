@@ -513,6 +513,9 @@ wxMenu* MainMenuBar::CreateProfilerMenu() const
   profiler_menu->AppendCheckItem(IDM_PROFILE_BLOCKS, _("&Profile Blocks"));
   profiler_menu->AppendSeparator();
   profiler_menu->Append(IDM_WRITE_PROFILE, _("&Write to profile.txt, Show"));
+  profiler_menu->AppendSeparator();
+  profiler_menu->AppendCheckItem(IDM_PROFILE_SAMPLES, _("&Sample Functions"));
+  profiler_menu->Append(IDM_WRITE_SAMPLES, _("Write &Samples to profiler_samples.folded"));
 
   return profiler_menu;
 }
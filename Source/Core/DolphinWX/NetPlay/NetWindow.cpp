@@ -403,6 +403,7 @@ void NetPlayDialog::GetNetSettings(NetSettings& settings)
   settings.m_CPUthread = instance.bCPUThread;
   settings.m_CPUcore = instance.iCPUCore;
   settings.m_EnableCheats = instance.bEnableCheats;
+  settings.m_GeckoNative = instance.bGeckoNative;
   settings.m_SelectedLanguage = instance.SelectedLanguage;
   settings.m_OverrideGCLanguage = instance.bOverrideGCLanguage;
   settings.m_ProgressiveScan = Config::Get(Config::SYSCONF_PROGRESSIVE_SCAN);
@@ -253,6 +253,11 @@ wxTRANSLATE("Show the current time on the on-screen display.\n\nIf "
 static wxString show_frame_times_desc =
 wxTRANSLATE("Show frame times on the on-screen display in addition to FPS,\nThis option only works when polling method is set to \"On SI Read\".\n\nIf "
   "unsure, leave this unchecked.");
+static wxString show_frame_time_stats_desc =
+    wxTRANSLATE("Show the median and worst frame times of the last minute, and what the last "
+                "frame that took much longer than the others spent its time on. A summary of "
+                "the session is written to the log when emulation stops.\n\nIf unsure, leave "
+                "this unchecked.");
 static wxString log_render_time_to_file_desc =
     wxTRANSLATE("Log the render time of every frame to User/Logs/render_time.txt. Use this "
                 "feature when you want to measure the performance of Dolphin.\n\nIf "
@@ -309,6 +314,11 @@ static wxString wait_cache_hires_textures_desc =
     "but improves stability and reduces stuttering in-game. Most useful with textures on "
     "networked drive. "
     "\n\nIf unsure, leave this unchecked.");
+static wxString stream_hires_textures_desc =
+    _("Load custom textures in the background as the game uses them and keep the most recently "
+      "used ones in system RAM.\nTextures are shown at native resolution until they are loaded. "
+      "Uses less RAM than prefetching and avoids stuttering with large texture packs.\n\nIf "
+      "unsure, leave this unchecked.");
 static wxString dump_efb_desc =
     _("Dump the contents of EFB copies to User/Dump/Textures/\n\nIf unsure, leave this unchecked.");
 static wxString internal_resolution_frame_dumping_desc = _(
@@ -401,6 +411,13 @@ static wxString Tessellation_displacement_desc =
 static wxString scaling_factor_desc = _("Multiplier applied to the texture size.");
 static wxString texture_deposterize_desc =
     _("Decrease some gradient's artifacts caused by scaling.");
+static wxString texture_scaling_async_desc =
+    _("Scale textures on worker threads instead of while drawing. New textures show up at native "
+      "resolution for a few frames until their scaled version is ready, but the stutter caused "
+      "by scaling goes away.\n\nIf unsure, leave this unchecked.");
+static wxString texture_scaling_cache_desc =
+    _("Keep scaled textures on disk, so they don't need to be scaled again in later sessions.\n\n"
+      "If unsure, leave this checked.");
 static wxString stereoshader_desc =
     _("Selects which shader will be used to transform the two images when stereoscopy is enabled.");
 static wxString forcedLogivOp_desc =
@@ -598,6 +615,9 @@ VideoConfigDiag::VideoConfigDiag(wxWindow* parent, const std::string& title)
         szr_other->Add(CreateCheckBox(page_general, _("Show frame times on FPS display"),
           wxGetTranslation(show_frame_times_desc),
           Config::GFX_SHOW_FRAME_TIMES));
+        szr_other->Add(CreateCheckBox(page_general, _("Show Frame Time Statistics"),
+                                      wxGetTranslation(show_frame_time_stats_desc),
+                                      Config::GFX_SHOW_FRAME_TIME_STATS));
         szr_other->Add(CreateCheckBoxRefBool(page_general, _("Auto Adjust Window Size"),
                                              (auto_window_size_desc),
                                              SConfig::GetInstance().bRenderWindowAutoSize));
@@ -825,6 +845,16 @@ VideoConfigDiag::VideoConfigDiag(wxWindow* parent, const std::string& title)
                                   page_enh, wxID_ANY, sf_choices[vconfig.iTexScalingFactor - 1]),
                               1, wxRIGHT | wxTOP | wxBOTTOM, 5);
 
+      szr_texturescaling->AddSpacer(0);
+      szr_texturescaling->Add(CreateCheckBox(page_enh, _("Scale in Background"),
+                                             (texture_scaling_async_desc),
+                                             Config::GFX_ENHANCE_TEXTURE_SCALING_ASYNC),
+                              1, wxALIGN_CENTER_VERTICAL);
+      szr_texturescaling->Add(CreateCheckBox(page_enh, _("Cache on Disk"),
+                                             (texture_scaling_cache_desc),
+                                             Config::GFX_ENHANCE_TEXTURE_SCALING_CACHE),
+                              1, wxALIGN_CENTER_VERTICAL);
+
       wxStaticBoxSizer* const group_scaling =
           new wxStaticBoxSizer(wxVERTICAL, page_enh, _("Texture Scaling"));
       group_scaling->Add(szr_texturescaling, 1, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, 5);
@@ -1355,8 +1385,12 @@ VideoConfigDiag::VideoConfigDiag(wxWindow* parent, const std::string& title)
       hires_texturemaps =
           CreateCheckBox(page_advanced, _("Load Custom Material Maps"),
                          load_hires_material_maps_desc, Config::GFX_HIRES_MATERIAL_MAPS);
+      stream_hires_textures =
+          CreateCheckBox(page_advanced, _("Stream Custom Textures"), stream_hires_textures_desc,
+                         Config::GFX_STREAM_HIRES_TEXTURES);
       szr_utility->Add(cache_hires_textures);
       szr_utility->Add(wait_cache_hires_textures);
+      szr_utility->Add(stream_hires_textures);
       if (vconfig.backend_info.bSupportsInternalResolutionFrameDumps)
       {
         szr_utility->Add(CreateCheckBox(page_advanced, _("Full Resolution Frame Dumps"),
@@ -1958,8 +1992,9 @@ void VideoConfigDiag::OnUpdateUI(wxUpdateUIEvent& ev)
   real_xfb->Enable(vconfig.bUseXFB);
 
   // custom textures
-  cache_hires_textures->Enable(vconfig.bHiresTextures);
-  wait_cache_hires_textures->Enable(vconfig.bHiresTextures);
+  cache_hires_textures->Enable(vconfig.bHiresTextures && !vconfig.bStreamHiresTextures);
+  wait_cache_hires_textures->Enable(vconfig.bHiresTextures && !vconfig.bStreamHiresTextures);
+  stream_hires_textures->Enable(vconfig.bHiresTextures);
   hires_texturemaps->Enable(vconfig.bHiresTextures && vconfig.bEnablePixelLighting);
   hires_texturemaps->Show(vconfig.backend_info.bSupportsNormalMaps);
 
@@ -7,9 +7,11 @@
 #include <libudev.h>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unistd.h>
 
+#include <sys/epoll.h>
 #include <sys/eventfd.h>
 
 #include "Common/Assert.h"
@@ -29,6 +31,16 @@ static std::thread s_hotplug_thread;
 static Common::Flag s_hotplug_thread_running;
 static int s_wakeup_eventfd;
 
+// Reads the events of all devices as they arrive, so UpdateInput only copies the latest state
+// instead of draining the devices on the emulation thread.
+static std::thread s_input_thread;
+static Common::Flag s_input_thread_running;
+static int s_input_epoll_fd = -1;
+static int s_input_wakeup_eventfd = -1;
+// Guards s_input_devices and the epoll registrations, held while events are read.
+static std::mutex s_input_devices_mutex;
+static std::map<int, evdevDevice*> s_input_devices;
+
 // There is no easy way to get the device name from only a dev node
 // during a device removed event, since libevdev can't work on removed devices;
 // sysfs is not stable, so this is probably the easiest way to get a name for a node.
@@ -139,9 +151,91 @@ static void StopHotplugThread()
   close(s_wakeup_eventfd);
 }
 
+static void InputThreadFunc()
+{
+  Common::SetCurrentThreadName("evdev Input Thread");
+
+  epoll_event events[16];
+  while (s_input_thread_running.IsSet())
+  {
+    const int count = epoll_wait(s_input_epoll_fd, events, 16, -1);
+    std::lock_guard<std::mutex> lk(s_input_devices_mutex);
+    for (int i = 0; i < count; i++)
+    {
+      const auto it = s_input_devices.find(events[i].data.fd);
+      if (it == s_input_devices.end())
+        continue;
+      if (events[i].events & (EPOLLERR | EPOLLHUP))
+      {
+        // The device is gone, the hotplug thread removes it.
+        epoll_ctl(s_input_epoll_fd, EPOLL_CTL_DEL, it->first, nullptr);
+        s_input_devices.erase(it);
+        continue;
+      }
+      it->second->ReadEvents();
+    }
+  }
+}
+
+static void StartInputThread()
+{
+  if (!s_input_thread_running.TestAndSet())
+    return;
+
+  s_input_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  s_input_wakeup_eventfd = eventfd(0, 0);
+  ASSERT_MSG(PAD, s_input_epoll_fd != -1 && s_input_wakeup_eventfd != -1,
+             "Couldn't create the evdev input epoll.");
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = s_input_wakeup_eventfd;
+  epoll_ctl(s_input_epoll_fd, EPOLL_CTL_ADD, s_input_wakeup_eventfd, &event);
+  s_input_thread = std::thread(InputThreadFunc);
+}
+
+static void StopInputThread()
+{
+  if (!s_input_thread_running.TestAndClear())
+    return;
+  uint64_t value = 1;
+  if (write(s_input_wakeup_eventfd, &value, sizeof(uint64_t)) < 0)
+  {
+  }
+  s_input_thread.join();
+
+  std::lock_guard<std::mutex> lk(s_input_devices_mutex);
+  s_input_devices.clear();
+  close(s_input_epoll_fd);
+  close(s_input_wakeup_eventfd);
+  s_input_epoll_fd = -1;
+  s_input_wakeup_eventfd = -1;
+}
+
+static bool RegisterInputDevice(int fd, evdevDevice* device)
+{
+  std::lock_guard<std::mutex> lk(s_input_devices_mutex);
+  if (s_input_epoll_fd == -1)
+    return false;
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  if (epoll_ctl(s_input_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+    return false;
+  s_input_devices[fd] = device;
+  return true;
+}
+
+static void UnregisterInputDevice(int fd)
+{
+  std::lock_guard<std::mutex> lk(s_input_devices_mutex);
+  if (s_input_devices.erase(fd))
+    epoll_ctl(s_input_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
 void Init()
 {
   s_devnode_name_map.clear();
+  StartInputThread();
   StartHotplugThread();
 }
 
@@ -192,6 +286,7 @@ void PopulateDevices()
 void Shutdown()
 {
   StopHotplugThread();
+  StopInputThread();
 }
 
 evdevDevice::evdevDevice(const std::string& devnode) : m_devfile(devnode)
@@ -210,19 +305,30 @@ evdevDevice::evdevDevice(const std::string& devnode) : m_devfile(devnode)
 
   m_name = StripSpaces(libevdev_get_name(m_dev));
 
+  // The inputs keep a reference to m_state, it must not be resized once they exist.
+  int slot_count = 0;
+  for (int key = 0; key < KEY_MAX; key++)
+    slot_count += libevdev_has_event_code(m_dev, EV_KEY, key);
+  for (int axis = 0; axis < 0x100; axis++)
+    slot_count += libevdev_has_event_code(m_dev, EV_ABS, axis);
+  m_slots.reserve(slot_count);
+  m_state.resize(slot_count);
+  m_shared_state = std::make_unique<std::atomic<int>[]>(slot_count);
+
   // Controller buttons (and keyboard keys)
   int num_buttons = 0;
   for (int key = 0; key < KEY_MAX; key++)
     if (libevdev_has_event_code(m_dev, EV_KEY, key))
-      AddInput(new Button(num_buttons++, key, m_dev));
+      AddInput(new Button(num_buttons++, key, m_state, AddSlot(EV_KEY, key)));
 
   // Absolute axis (thumbsticks)
   int num_axis = 0;
   for (int axis = 0; axis < 0x100; axis++)
     if (libevdev_has_event_code(m_dev, EV_ABS, axis))
     {
-      AddAnalogInputs(new Axis(num_axis, axis, false, m_dev),
-        new Axis(num_axis, axis, true, m_dev));
+      const size_t slot = AddSlot(EV_ABS, axis);
+      AddAnalogInputs(new Axis(num_axis, axis, false, m_dev, m_state, slot),
+        new Axis(num_axis, axis, true, m_dev, m_state, slot));
       num_axis++;
     }
 
@@ -242,18 +348,31 @@ evdevDevice::evdevDevice(const std::string& devnode) : m_devfile(devnode)
 
   m_initialized = true;
   m_interesting = num_axis >= 2 || num_buttons >= 8;
+
+  PublishState();
+  // Without the input thread the events are read by UpdateInput.
+  if (m_interesting)
+    m_registered = RegisterInputDevice(m_fd, this);
 }
 
 evdevDevice::~evdevDevice()
 {
   if (m_initialized)
   {
+    if (m_registered)
+      UnregisterInputDevice(m_fd);
     libevdev_free(m_dev);
     close(m_fd);
   }
 }
 
-void evdevDevice::UpdateInput()
+size_t evdevDevice::AddSlot(u16 type, u16 code)
+{
+  m_slots.emplace_back(type, code);
+  return m_slots.size() - 1;
+}
+
+void evdevDevice::ReadEvents()
 {
   // Run through all evdev events
   // libevdev will keep track of the actual controller state internally which can be queried
@@ -267,6 +386,38 @@ void evdevDevice::UpdateInput()
     else
       rc = libevdev_next_event(m_dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
   } while (rc >= 0);
+
+  PublishState();
+}
+
+void evdevDevice::PublishState()
+{
+  const u32 sequence = m_sequence.load(std::memory_order_relaxed);
+  m_sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < m_slots.size(); i++)
+  {
+    int value = 0;
+    libevdev_fetch_event_value(m_dev, m_slots[i].first, m_slots[i].second, &value);
+    m_shared_state[i].store(value, std::memory_order_relaxed);
+  }
+  m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void evdevDevice::UpdateInput()
+{
+  if (!m_registered)
+    ReadEvents();
+
+  u32 begin, end;
+  do
+  {
+    begin = m_sequence.load(std::memory_order_acquire);
+    for (size_t i = 0; i < m_state.size(); i++)
+      m_state[i] = m_shared_state[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    end = m_sequence.load(std::memory_order_relaxed);
+  } while ((begin & 1) != 0 || begin != end);
 }
 
 bool evdevDevice::IsValid() const
@@ -301,16 +452,15 @@ std::string evdevDevice::Button::GetName() const
 
 ControlState evdevDevice::Button::GetState() const
 {
-  int value = 0;
-  libevdev_fetch_event_value(m_dev, EV_KEY, m_code, &value);
-  return value;
+  return m_state[m_slot];
 }
 
-evdevDevice::Axis::Axis(u8 index, u16 code, bool upper, libevdev* dev)
-  : m_code(code), m_index(index), m_upper(upper), m_dev(dev)
+evdevDevice::Axis::Axis(u8 index, u16 code, bool upper, libevdev* dev,
+                        const std::vector<int>& state, size_t slot)
+  : m_code(code), m_index(index), m_upper(upper), m_state(state), m_slot(slot)
 {
-  m_min = libevdev_get_abs_minimum(m_dev, m_code);
-  m_range = libevdev_get_abs_maximum(m_dev, m_code) - m_min;
+  m_min = libevdev_get_abs_minimum(dev, m_code);
+  m_range = libevdev_get_abs_maximum(dev, m_code) - m_min;
 }
 
 std::string evdevDevice::Axis::GetName() const
@@ -320,8 +470,7 @@ std::string evdevDevice::Axis::GetName() const
 
 ControlState evdevDevice::Axis::GetState() const
 {
-  int value = 0;
-  libevdev_fetch_event_value(m_dev, EV_ABS, m_code, &value);
+  const int value = m_state[m_slot];
 
   // Value from 0.0 to 1.0
   ControlState fvalue = MathUtil::Clamp(double(value - m_min) / double(m_range), 0.0, 1.0);
@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <libevdev/libevdev.h>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "InputCommon/ControllerInterface/ControllerInterface.h"
@@ -25,20 +28,25 @@ private:
   {
   public:
     std::string GetName() const override;
-    Button(u8 index, u16 code, libevdev* dev) : m_index(index), m_code(code), m_dev(dev) {}
+    Button(u8 index, u16 code, const std::vector<int>& state, size_t slot)
+        : m_index(index), m_code(code), m_state(state), m_slot(slot)
+    {
+    }
     ControlState GetState() const override;
 
   private:
     const u8 m_index;
     const u16 m_code;
-    libevdev* m_dev;
+    const std::vector<int>& m_state;
+    const size_t m_slot;
   };
 
   class Axis : public Core::Device::Input
   {
   public:
     std::string GetName() const override;
-    Axis(u8 index, u16 code, bool upper, libevdev* dev);
+    Axis(u8 index, u16 code, bool upper, libevdev* dev, const std::vector<int>& state,
+         size_t slot);
     ControlState GetState() const override;
 
   private:
@@ -47,7 +55,8 @@ private:
     const bool m_upper;
     int m_range;
     int m_min;
-    libevdev* m_dev;
+    const std::vector<int>& m_state;
+    const size_t m_slot;
   };
 
   class ForceFeedback : public Core::Device::Output
@@ -74,13 +83,30 @@ public:
   std::string GetName() const override { return m_name; }
   std::string GetSource() const override { return "evdev"; }
   bool IsInteresting() const { return m_initialized && m_interesting; }
+  // Drains the pending events of the device and publishes the new state. Called by the input
+  // thread when the device becomes readable.
+  void ReadEvents();
+
 private:
+  size_t AddSlot(u16 type, u16 code);
+  void PublishState();
+
   const std::string m_devfile;
   int m_fd;
   libevdev* m_dev;
   std::string m_name;
   bool m_initialized;
   bool m_interesting;
+  bool m_registered = false;
+
+  // Event type and code of every input value.
+  std::vector<std::pair<u16, u16>> m_slots;
+  // Values published by the input thread. Readers retry while m_sequence is odd or changed
+  // during the copy, so polling never waits for the input thread.
+  std::unique_ptr<std::atomic<int>[]> m_shared_state;
+  std::atomic<u32> m_sequence{0};
+  // The copy taken by UpdateInput, which the inputs read.
+  std::vector<int> m_state;
 };
 }
 }
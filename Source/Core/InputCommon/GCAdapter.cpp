@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <libusb.h>
 #include <mutex>
 #include <chrono>
@@ -11,6 +12,7 @@
 #include "Common/Flag.h"
 #include "Common/Logging/Log.h"
 #include "Common/Thread.h"
+#include "Common/Timer.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -36,12 +38,21 @@ namespace GCAdapter
       ControllerTypes::CONTROLLER_NONE, ControllerTypes::CONTROLLER_NONE };
   static u8 s_controller_rumble[4];
 
+  // A report read from the adapter, stamped with the host time the read completed at.
+  struct Report
+  {
+    u8 payload[37];
+    int size;
+    u64 time_us;
+  };
+  static constexpr size_t REPORT_HISTORY = 16;
+  static constexpr int MAX_POLL_RATE = 1000;
+
   static std::mutex s_mutex;
-  static u8 s_controller_payload[37];
+  static std::array<Report, REPORT_HISTORY> s_reports;
+  static u64 s_report_count = 0;
   static u8 s_controller_payload_swap[37];
 
-  static std::atomic<int> s_controller_payload_size = { 0 };
-
   static std::thread s_adapter_input_thread;
   static std::thread s_adapter_output_thread;
   static Common::Flag s_adapter_thread_running;
@@ -92,8 +103,35 @@ namespace GCAdapter
     return s_read_rate;
   }
 
+  // Waits for the next read slot when the poll rate is capped. Sleeps through most of the wait
+  // and yields for the rest, since sleeps can overshoot by a millisecond or more.
+  static void WaitForPoll(u64* next_poll_us, u64 poll_period_us)
+  {
+    if (poll_period_us == 0)
+      return;
+
+    u64 now = Common::Timer::GetTimeUs();
+    while (now < *next_poll_us)
+    {
+      if (*next_poll_us - now > 2000)
+        Common::SleepCurrentThread(1);
+      else
+        Common::YieldCPU();
+      now = Common::Timer::GetTimeUs();
+    }
+    // Don't try to catch up on missed slots, that would only bunch reads together.
+    *next_poll_us = std::max(*next_poll_us + poll_period_us, now);
+  }
+
   static void Read()
   {
+    Common::SetCurrentThreadName("GC Adapter Read Thread");
+    if (SConfig::GetInstance().m_adapter_realtime_thread &&
+      !Common::SetCurrentThreadRealtimePriority())
+    {
+      WARN_LOG(SERIALINTERFACE, "Could not raise the priority of the GC adapter read thread");
+    }
+
     s_consecutive_slow_transfers = 0;
     adapter_error = false;
 
@@ -102,13 +140,26 @@ namespace GCAdapter
     bool has_prev_input = false;
     s_read_rate = 0.0;
 
+    {
+      std::lock_guard<std::mutex> lk(s_mutex);
+      s_report_count = 0;
+    }
+
+    const int poll_rate = std::min(SConfig::GetInstance().m_adapter_poll_rate, MAX_POLL_RATE);
+    const u64 poll_period_us = poll_rate > 0 ? 1000000 / poll_rate : 0;
+    u64 next_poll_us = Common::Timer::GetTimeUs();
+
     int payload_size = 0;
     while (s_adapter_thread_running.IsSet())
     {
+      WaitForPoll(&next_poll_us, poll_period_us);
+
       bool reuseOldInputsEnabled = SConfig::GetInstance().bAdapterWarning;
       std::chrono::time_point<std::chrono::high_resolution_clock> start = std::chrono::high_resolution_clock::now();
-      adapter_error = libusb_interrupt_transfer(s_handle, s_endpoint_in, s_controller_payload_swap,
-        sizeof(s_controller_payload_swap), &payload_size, TIMEOUT) != LIBUSB_SUCCESS && reuseOldInputsEnabled;
+      const int transfer = libusb_interrupt_transfer(s_handle, s_endpoint_in, s_controller_payload_swap,
+        sizeof(s_controller_payload_swap), &payload_size, TIMEOUT);
+      const u64 time_us = Common::Timer::GetTimeUs();
+      adapter_error = transfer != LIBUSB_SUCCESS && reuseOldInputsEnabled;
 
       double elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count() / 1000000.0;
 
@@ -137,11 +188,19 @@ namespace GCAdapter
 
       {
         std::lock_guard<std::mutex> lk(s_mutex);
-        std::swap(s_controller_payload_swap, s_controller_payload);
-        s_controller_payload_size.store(payload_size);
+        Report& report = s_reports[s_report_count % REPORT_HISTORY];
+        std::copy(std::begin(s_controller_payload_swap), std::end(s_controller_payload_swap),
+          std::begin(report.payload));
+        report.size = payload_size;
+        report.time_us = time_us;
+        s_report_count++;
       }
 
-      Common::YieldCPU();
+      // Failed transfers can return right away, which would spin at real-time priority.
+      if (transfer != LIBUSB_SUCCESS && transfer != LIBUSB_ERROR_TIMEOUT)
+        Common::SleepCurrentThread(1);
+      else
+        Common::YieldCPU();
     }
   }
 
@@ -450,6 +509,37 @@ namespace GCAdapter
     NOTICE_LOG(SERIALINTERFACE, "GC Adapter detached");
   }
 
+  // Picks the report to hand to the game; s_mutex must be held. By default that's the latest one,
+  // which makes the input's age depend on where the game's SI poll falls between two reads.
+  // Matching the host time the poll is emulated for keeps that age steady instead.
+  static const Report& SelectReport()
+  {
+    const Report& latest = s_reports[(s_report_count + REPORT_HISTORY - 1) % REPORT_HISTORY];
+    if (!SConfig::GetInstance().m_adapter_match_poll_time || s_report_count < 2)
+      return latest;
+
+    const u64 poll_time_us = SystemTimers::GetHostTimeUsAtTicks(CoreTiming::GetTicks());
+    if (poll_time_us == 0 || poll_time_us >= latest.time_us)
+      return latest;
+
+    const auto distance = [poll_time_us](const Report& report) {
+      return report.time_us > poll_time_us ? report.time_us - poll_time_us :
+        poll_time_us - report.time_us;
+    };
+
+    // Reports are in time order, so the distance shrinks until the poll time is passed.
+    const Report* closest = &latest;
+    const u64 available = std::min<u64>(s_report_count, REPORT_HISTORY);
+    for (u64 i = 1; i < available; i++)
+    {
+      const Report& report = s_reports[(s_report_count - 1 - i) % REPORT_HISTORY];
+      if (distance(report) >= distance(*closest))
+        break;
+      closest = &report;
+    }
+    return *closest;
+  }
+
   GCPadStatus Input(int chan)
   {
     if (!UseAdapter())
@@ -463,9 +553,10 @@ namespace GCAdapter
 
     {
       std::lock_guard<std::mutex> lk(s_mutex);
-      std::copy(std::begin(s_controller_payload), std::end(s_controller_payload),
+      const Report& report = SelectReport();
+      std::copy(std::begin(report.payload), std::end(report.payload),
         std::begin(controller_payload_copy));
-      payload_size = s_controller_payload_size.load();
+      payload_size = report.size;
     }
 
     GCPadStatus pad = {};
@@ -19,6 +19,7 @@
 #include "Common/File.h"
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
+#include "Common/ThreadPool.h"
 
 #include "Core/TitleDatabase.h"
 
@@ -28,16 +29,20 @@
 
 namespace UICommon
 {
-static constexpr u32 CACHE_REVISION = 8;  // Last changed in PR 6560
+static constexpr u32 CACHE_REVISION = 9;  // Last changed for DCZ support
 
-std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
-                                          bool recursive_scan)
+const std::vector<std::string>& GetGameFileExtensions()
 {
   static const std::vector<std::string> search_extensions = {
-      ".gcm", ".tgc", ".iso", ".ciso", ".gcz", ".wbfs", ".wad", ".dol", ".elf"};
+      ".gcm", ".tgc", ".iso", ".ciso", ".gcz", ".dcz", ".wbfs", ".wad", ".dol", ".elf"};
+  return search_extensions;
+}
 
+std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
+                                          bool recursive_scan)
+{
   // TODO: We could process paths iteratively as they are found
-  return Common::DoFileSearch(directories_to_scan, search_extensions, recursive_scan);
+  return Common::DoFileSearch(directories_to_scan, GetGameFileExtensions(), recursive_scan);
 }
 
 void GameFileCache::ForEach(std::function<void(const std::shared_ptr<const GameFile>&)> f) const
@@ -112,9 +117,16 @@ bool GameFileCache::Update(const std::vector<std::string>& all_game_paths)
 
   // Now that the previous loop has run, game_paths only contains paths that
   // aren't in m_cached_files, so we simply add all of them to m_cached_files.
-  for (const auto& path : game_paths)
+  // Opening a file is mostly waiting for the disk, so they are opened in parallel.
+  const std::vector<std::string> new_paths(game_paths.begin(), game_paths.end());
+  std::vector<std::shared_ptr<GameFile>> new_files(new_paths.size());
+  Common::ParallelForWorker::Loop(0, static_cast<s32>(new_paths.size()), 1,
+                                  [&](s32 begin, s32 end) {
+                                    for (s32 i = begin; i < end; i++)
+                                      new_files[i] = std::make_shared<GameFile>(new_paths[i]);
+                                  });
+  for (auto& file : new_files)
   {
-    auto file = std::make_shared<GameFile>(path);
     if (file->IsValid())
     {
       cache_changed = true;
@@ -127,12 +139,41 @@ bool GameFileCache::Update(const std::vector<std::string>& all_game_paths)
 
 bool GameFileCache::UpdateAdditionalMetadata(const Core::TitleDatabase& title_database)
 {
-  bool cache_changed = false;
+  std::vector<u8> changed(m_cached_files.size());
+  Common::ParallelForWorker::Loop(0, static_cast<s32>(m_cached_files.size()), 16,
+                                  [&](s32 begin, s32 end) {
+                                    for (s32 i = begin; i < end; i++)
+                                    {
+                                      changed[i] = UpdateAdditionalMetadata(&m_cached_files[i],
+                                                                            title_database);
+                                    }
+                                  });
 
-  for (auto& file : m_cached_files)
-    cache_changed |= UpdateAdditionalMetadata(&file, title_database);
+  return std::find(changed.begin(), changed.end(), 1) != changed.end();
+}
 
-  return cache_changed;
+bool GameFileCache::UpdateFile(const std::string& path, const Core::TitleDatabase& title_database)
+{
+  auto it = std::find_if(
+      m_cached_files.begin(), m_cached_files.end(),
+      [&path](const std::shared_ptr<GameFile>& file) { return file->GetFilePath() == path; });
+
+  auto file = std::make_shared<GameFile>(path);
+  if (!file->IsValid() || DiscIO::ShouldHideFromGameList(path))
+  {
+    if (it == m_cached_files.end())
+      return false;
+    m_cached_files.erase(it);
+    return true;
+  }
+
+  UpdateAdditionalMetadata(&file, title_database);
+  // Replaced rather than modified, so that other threads can keep using the old object
+  if (it != m_cached_files.end())
+    *it = std::move(file);
+  else
+    m_cached_files.push_back(std::move(file));
+  return true;
 }
 
 bool GameFileCache::UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_file,
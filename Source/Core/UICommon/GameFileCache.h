@@ -25,6 +25,9 @@ namespace UICommon
 {
 class GameFile;
 
+// Including the leading dot, in lowercase.
+const std::vector<std::string>& GetGameFileExtensions();
+
 std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
                                           bool recursive_scan);
 
@@ -40,8 +43,12 @@ public:
                                            const Core::TitleDatabase& title_database);
 
   // These functions return true if the call modified the cache.
+  // The files are opened and checked on worker threads.
   bool Update(const std::vector<std::string>& all_game_paths);
   bool UpdateAdditionalMetadata(const Core::TitleDatabase& title_database);
+  // Re-reads a single file after a file system watcher reported a change to it. The file is
+  // removed from the cache if it's gone or isn't a valid game anymore.
+  bool UpdateFile(const std::string& path, const Core::TitleDatabase& title_database);
 
   bool Load();
   bool Save();
@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <array>
 #include <memory>
 
 #include "Common/CommonTypes.h"
@@ -14,6 +15,7 @@
 #include "VideoBackends/D3D12/D3DUtil.h"
 #include "VideoBackends/D3D12/FramebufferManager.h"
 #include "VideoBackends/D3D12/Render.h"
+#include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/VideoConfig.h"
 
 namespace DX12
@@ -31,6 +33,12 @@ static D3D12_RESOURCE_STATES s_current_bbox_state = D3D12_RESOURCE_STATE_UNORDER
 static int s_bbox_shadow_copy[4];
 static bool s_bbox_cpu_dirty = false;
 static bool s_bbox_gpu_dirty = false;
+
+// Latency tolerant mode, see VideoConfig::bBBoxLatencyTolerant.
+static BoundingBox::ReadbackRing s_readback_ring;
+static std::array<ComPtr<ID3D12Resource>, BoundingBox::ReadbackRing::NUM_SLOTS> s_readback_buffers;
+static std::array<UINT64, BoundingBox::ReadbackRing::NUM_SLOTS> s_readback_fences;
+
 void BBox::Init()
 {
   memset(s_bbox_shadow_copy, 0, sizeof(s_bbox_shadow_copy));
@@ -55,6 +63,17 @@ void BBox::Init()
     D3D12_RESOURCE_STATE_COPY_DEST,
     nullptr,
     IID_PPV_ARGS(s_bbox_staging_buffer.ReleaseAndGetAddressOf())));
+  for (ComPtr<ID3D12Resource>& buffer : s_readback_buffers)
+  {
+    CheckHR(D3D::device->CreateCommittedResource(
+      &hprops,
+      D3D12_HEAP_FLAG_NONE,
+      &staging_buffer_desc,
+      D3D12_RESOURCE_STATE_COPY_DEST,
+      nullptr,
+      IID_PPV_ARGS(buffer.ReleaseAndGetAddressOf())));
+  }
+  s_readback_ring = {};
 
   s_bbox_stream_buffer = std::make_unique<D3DStreamBuffer>(BBOX_STREAM_BUFFER_SIZE, BBOX_STREAM_BUFFER_SIZE, nullptr);
 
@@ -108,6 +127,11 @@ void BBox::Shutdown()
   {
     D3D::command_list_mgr->DestroyResourceAfterCurrentCommandListExecuted(s_bbox_staging_buffer.Detach());
   }
+  for (ComPtr<ID3D12Resource>& buffer : s_readback_buffers)
+  {
+    if (buffer)
+      D3D::command_list_mgr->DestroyResourceAfterCurrentCommandListExecuted(buffer.Detach());
+  }
   s_bbox_stream_buffer.reset();
 }
 
@@ -117,7 +141,35 @@ void BBox::Set(int index, int value)
   {
     s_bbox_shadow_copy[index] = value;
     s_bbox_cpu_dirty = true;
+    s_readback_ring.Invalidate();
+  }
+}
+
+static int GetLatencyTolerant(int index)
+{
+  // Values the CPU wrote are still to be uploaded, a copy now would read the old ones.
+  if (s_bbox_gpu_dirty && !s_bbox_cpu_dirty)
+  {
+    // The copy runs with the current command list, we don't flush it.
+    const u32 slot = s_readback_ring.Begin();
+    D3D::ResourceBarrier(D3D::current_command_list, s_bbox_buffer.Get(), s_current_bbox_state, D3D12_RESOURCE_STATE_COPY_SOURCE, 0);
+    s_current_bbox_state = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    D3D::current_command_list->CopyBufferRegion(s_readback_buffers[slot].Get(), 0, s_bbox_buffer.Get(), 0, BBOX_BUFFER_SIZE);
+    s_readback_fences[slot] = D3D::command_list_mgr->GetCurrentCommandListFenceValue();
+    s_bbox_gpu_dirty = false;
   }
+  const UINT64 completed_fence = D3D::command_list_mgr->GetCompletedFenceValue();
+  s_readback_ring.Poll(
+    [completed_fence](u32 slot) { return completed_fence >= s_readback_fences[slot]; },
+    [](u32 slot) {
+      D3D12_RANGE read_range = { 0, BBOX_BUFFER_SIZE };
+      void* readback_buffer_map = nullptr;
+      CheckHR(s_readback_buffers[slot]->Map(0, &read_range, &readback_buffer_map));
+      memcpy(s_bbox_shadow_copy, readback_buffer_map, BBOX_BUFFER_SIZE);
+      D3D12_RANGE write_range = {};
+      s_readback_buffers[slot]->Unmap(0, &write_range);
+    });
+  return s_bbox_shadow_copy[index];
 }
 
 int BBox::Get(int index)
@@ -125,6 +177,9 @@ int BBox::Get(int index)
   if (!s_bbox_buffer)
     return 0;
 
+  if (g_ActiveConfig.bBBoxLatencyTolerant)
+    return GetLatencyTolerant(index);
+
   if (s_bbox_gpu_dirty)
   {
     D3D::command_list_mgr->CPUAccessNotify();
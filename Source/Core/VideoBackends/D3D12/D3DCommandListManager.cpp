@@ -53,6 +53,23 @@ D3DCommandListManager::D3DCommandListManager(
     m_queued_command_list = new ID3D12QueuedCommandList(m_backing_command_list, m_command_queue);
   }
 
+  if (g_ActiveConfig.bBackendMultithreading)
+  {
+    // Texture uploads go through a copy queue, see GetCopyCommandList().
+    D3D12_COMMAND_QUEUE_DESC copy_queue_desc = {
+      D3D12_COMMAND_LIST_TYPE_COPY,   // D3D12_COMMAND_LIST_TYPE Type;
+      0,                              // INT Priority;
+      D3D12_COMMAND_QUEUE_FLAG_NONE,  // D3D12_COMMAND_QUEUE_FLAG Flags;
+      0                               // UINT NodeMask;
+    };
+    CheckHR(m_device->CreateCommandQueue(&copy_queue_desc, IID_PPV_ARGS(&m_copy_queue)));
+    for (auto& allocator : m_copy_command_allocators)
+      CheckHR(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&allocator)));
+    CheckHR(m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, m_copy_command_allocators[0], nullptr, IID_PPV_ARGS(&m_copy_command_list)));
+    CheckHR(m_copy_command_list->Close());
+    CheckHR(m_device->CreateFence(m_copy_fence_value, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_copy_fence)));
+  }
+
   // Create fence that will be used to measure GPU progress of app rendering requests (e.g. CPU readback of GPU data).
   m_queue_fence_value = 0;
   CheckHR(m_device->CreateFence(m_queue_fence_value, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_queue_fence)));
@@ -121,8 +138,48 @@ void D3DCommandListManager::EnsureDrawLimit()
   }
 }
 
+ID3D12GraphicsCommandList* D3DCommandListManager::GetCopyCommandList()
+{
+  if (!m_copy_queue)
+    return nullptr;
+
+  if (!m_copy_work_pending)
+  {
+    ID3D12CommandAllocator* allocator = m_copy_command_allocators[m_current_copy_command_allocator];
+    WaitOnCPUForFence(m_copy_fence, m_copy_command_allocator_fences[m_current_copy_command_allocator]);
+    CheckHR(allocator->Reset());
+    CheckHR(m_copy_command_list->Reset(allocator, nullptr));
+    m_copy_work_pending = true;
+  }
+  return m_copy_command_list;
+}
+
+void D3DCommandListManager::ExecuteCopyWork()
+{
+  if (!m_copy_work_pending)
+    return;
+
+  CheckHR(m_copy_command_list->Close());
+  ID3D12CommandList* const execute_list[1] = { m_copy_command_list };
+  m_copy_queue->ExecuteCommandLists(1, execute_list);
+  m_copy_fence_value++;
+  CheckHR(m_copy_queue->Signal(m_copy_fence, m_copy_fence_value));
+
+  // The current command list may already sample the uploaded textures. Fences on the graphics
+  // queue are signaled after this wait, so they also cover the copies and their upload memory.
+  if (g_ActiveConfig.bBackendMultithreading)
+    m_queued_command_list->QueueFenceGpuWait(m_copy_fence, m_copy_fence_value);
+  else
+    CheckHR(m_command_queue->Wait(m_copy_fence, m_copy_fence_value));
+
+  m_copy_command_allocator_fences[m_current_copy_command_allocator] = m_copy_fence_value;
+  m_current_copy_command_allocator = (m_current_copy_command_allocator + 1) % m_copy_command_allocators.size();
+  m_copy_work_pending = false;
+}
+
 void D3DCommandListManager::ExecuteQueuedWork(bool wait_for_gpu_completion, bool terminate_worker_tread)
 {
+  ExecuteCopyWork();
   m_queue_fence_value++;
 
   if (g_ActiveConfig.bBackendMultithreading)
@@ -160,6 +217,7 @@ void D3DCommandListManager::ExecuteQueuedWork(bool wait_for_gpu_completion, bool
 
 void D3DCommandListManager::ExecuteQueuedWorkAndPresent(IDXGISwapChain* swap_chain, UINT sync_interval, UINT flags)
 {
+  ExecuteCopyWork();
   m_queue_fence_value++;
 
   if (g_ActiveConfig.bBackendMultithreading)
@@ -340,6 +398,18 @@ void D3DCommandListManager::FreeDescriptorAfterCurrentCommandListExecuted(D3DDes
 
 D3DCommandListManager::~D3DCommandListManager()
 {
+  if (m_copy_queue)
+  {
+    if (m_copy_work_pending)
+      m_copy_command_list->Close();
+    WaitOnCPUForFence(m_copy_fence, m_copy_fence_value);
+    m_copy_command_list->Release();
+    for (auto& allocator : m_copy_command_allocators)
+      allocator->Release();
+    m_copy_fence->Release();
+    m_copy_queue->Release();
+  }
+
   if (g_ActiveConfig.bBackendMultithreading)
   {
     // Wait for background thread to exit.
@@ -371,6 +441,14 @@ D3DCommandListManager::~D3DCommandListManager()
   CloseHandle(m_wait_on_cpu_fence_event);
 }
 
+void D3DCommandListManager::WaitForFenceValue(UINT64 fence_value)
+{
+  if (fence_value >= GetCurrentCommandListFenceValue())
+    ExecuteQueuedWork(true);
+  else
+    WaitOnCPUForFence(m_queue_fence, fence_value);
+}
+
 void D3DCommandListManager::WaitOnCPUForFence(ID3D12Fence* fence, UINT64 fence_value)
 {
   if (fence->GetCompletedValue() >= fence_value)
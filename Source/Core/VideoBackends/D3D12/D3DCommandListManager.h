@@ -40,6 +40,13 @@ public:
   void ExecuteQueuedWork(bool wait_for_gpu_completion = false, bool terminate_worker_tread = false);
   void ExecuteQueuedWorkAndPresent(IDXGISwapChain* swap_chain, UINT sync_interval, UINT flags);
 
+  // Uploads to textures the GPU hasn't used yet can be recorded on a copy queue, off the draw
+  // stream. The graphics queue waits for them before it executes the current command list.
+  // Returns nullptr when the copy queue is not in use (backend multithreading is off).
+  ID3D12GraphicsCommandList* GetCopyCommandList();
+  // Starts the copies recorded so far right away instead of with the next command list.
+  void ExecuteCopyWork();
+
   void DestroyResourceAfterCurrentCommandListExecuted(ID3D12Resource* resource);
   void FreeDescriptorAfterCurrentCommandListExecuted(D3DDescriptorHeapManager* descriptor_heap,
     size_t index);
@@ -50,6 +57,14 @@ public:
   void SetCommandListPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY primitive_topology);
   D3D_PRIMITIVE_TOPOLOGY GetCommandListPrimitiveTopology() const;
 
+  // Fence value the current command list signals once executed, changes with every list.
+  UINT64 GetCurrentCommandListFenceValue() const { return m_queue_fence_value + 1; }
+  // Fence value of the last command list the GPU finished.
+  UINT64 GetCompletedFenceValue() const { return m_queue_fence->GetCompletedValue(); }
+  // Blocks until the command list that signals fence_value has executed, submitting the current
+  // one if needed.
+  void WaitForFenceValue(UINT64 fence_value);
+
 
 
   void CPUAccessNotify();
@@ -104,6 +119,15 @@ private:
   std::array<std::vector<ID3D12Resource*>, 2> m_deferred_destruction_lists;
   std::array<std::vector<PendingDescriptorFree>, 2> m_deferred_descriptor_free_lists;
   std::array<UINT64, 2> m_deferred_destruction_list_fences;
+
+  ID3D12CommandQueue* m_copy_queue{};
+  ID3D12GraphicsCommandList* m_copy_command_list{};
+  std::array<ID3D12CommandAllocator*, 2> m_copy_command_allocators{};
+  std::array<UINT64, 2> m_copy_command_allocator_fences{};
+  UINT m_current_copy_command_allocator{};
+  ID3D12Fence* m_copy_fence{};
+  UINT64 m_copy_fence_value{};
+  bool m_copy_work_pending = false;
 };
 
 }  // namespace
\ No newline at end of file
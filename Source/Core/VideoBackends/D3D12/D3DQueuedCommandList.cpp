@@ -363,6 +363,14 @@ void ID3D12QueuedCommandList::BackgroundThreadFunction(ID3D12QueuedCommandList*
         break;
       }
 
+      case D3DQueueItemType::FenceGpuWait:
+      {
+        CheckHR(parent_queued_command_list->m_command_queue->Wait(qitem->FenceGpuWait.fence, qitem->FenceGpuWait.fence_value));
+
+        item += BufferOffsetForQueueItemType<FenceGpuWaitArguments>();
+        break;
+      }
+
       case D3DQueueItemType::FenceCpuSignal:
       {
         CheckHR(qitem->FenceCpuSignal.fence->Signal(qitem->FenceCpuSignal.fence_value));
@@ -475,6 +483,19 @@ void ID3D12QueuedCommandList::QueueFenceGpuSignal(ID3D12Fence* fence_to_signal,
   CheckForOverflow();
 }
 
+void ID3D12QueuedCommandList::QueueFenceGpuWait(ID3D12Fence* fence_to_wait, UINT64 fence_value)
+{
+  D3DQueueItem* item = reinterpret_cast<D3DQueueItem*>(m_queue_array_back);
+
+  item->Type = D3DQueueItemType::FenceGpuWait;
+  item->FenceGpuWait.fence = fence_to_wait;
+  item->FenceGpuWait.fence_value = fence_value;
+
+  m_queue_array_back += BufferOffsetForQueueItemType<FenceGpuWaitArguments>();
+
+  CheckForOverflow();
+}
+
 void ID3D12QueuedCommandList::QueueFenceCpuSignal(ID3D12Fence* fence_to_signal, UINT64 fence_value)
 {
   D3DQueueItem* item = reinterpret_cast<D3DQueueItem*>(m_queue_array_back);
@@ -46,6 +46,7 @@ enum D3DQueueItemType
   ResetCommandList,
   ResetCommandAllocator,
   FenceGpuSignal,
+  FenceGpuWait,
   FenceCpuSignal,
   Stop
 };
@@ -223,6 +224,12 @@ struct FenceGpuSignalArguments
   UINT64 fence_value;
 };
 
+struct FenceGpuWaitArguments
+{
+  ID3D12Fence* fence;
+  UINT64 fence_value;
+};
+
 struct FenceCpuSignalArguments
 {
   ID3D12Fence* fence;
@@ -271,6 +278,7 @@ struct D3DQueueItem
     ResetCommandListArguments ResetCommandList;
     ResetCommandAllocatorArguments ResetCommandAllocator;
     FenceGpuSignalArguments FenceGpuSignal;
+    FenceGpuWaitArguments FenceGpuWait;
     FenceCpuSignalArguments FenceCpuSignal;
     StopArguments Stop;
   };
@@ -286,6 +294,8 @@ public:
 
   void QueueExecute();
   void QueueFenceGpuSignal(ID3D12Fence* fence_to_signal, UINT64 fence_value);
+  // Makes the queue wait for a fence signaled by another queue before executing later lists.
+  void QueueFenceGpuWait(ID3D12Fence* fence_to_wait, UINT64 fence_value);
   void QueueFenceCpuSignal(ID3D12Fence* fence_to_signal, UINT64 fence_value);
   void QueuePresent(IDXGISwapChain* swap_chain, UINT sync_interval, UINT flags);
 
@@ -8,6 +8,7 @@
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
+#include "Common/TraceEvents.h"
 #include "Common/Logging/Log.h"
 #include "VideoBackends/D3D12/D3DBase.h"
 #include "VideoBackends/D3D12/D3DBlob.h"
@@ -31,6 +32,7 @@ bool CompileShader(
   const D3D_SHADER_MACRO* pDefines,
   const char* pEntry, bool throwerror)
 {
+  TRACE_SCOPE("CompileShader");
 #if defined(_DEBUG) || defined(DEBUGFAST)
   UINT flags = D3DCOMPILE_ENABLE_BACKWARDS_COMPATIBILITY | D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
 #else
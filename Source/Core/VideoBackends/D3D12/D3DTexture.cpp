@@ -110,10 +110,6 @@ void ReplaceTexture2D(ID3D12Resource* texture12, const u8* buffer, DXGI_FORMAT f
         reinterpret_cast<u8*>(s_texture_upload_stream_buffer->GetCPUAddressOfCurrentAllocation());
   }
 
-  ResourceBarrier(current_command_list, texture12, current_resource_state,
-                  D3D12_RESOURCE_STATE_COPY_DEST,
-                  D3D12CalcSubresource(level, layer, 0, miplevels, layers));
-
   D3D12_PLACED_SUBRESOURCE_FOOTPRINT upload_footprint = {};
   u32 upload_rows = 0;
   u64 upload_row_size_in_bytes = 0;
@@ -140,6 +136,26 @@ void ReplaceTexture2D(ID3D12Resource* texture12, const u8* buffer, DXGI_FORMAT f
       texture12, D3D12CalcSubresource(level, layer, 0, miplevels, layers));
   CD3DX12_TEXTURE_COPY_LOCATION src =
       CD3DX12_TEXTURE_COPY_LOCATION(upload_buffer, upload_footprint);
+
+  // A texture still in the common state hasn't been used by any command list, so it can be filled
+  // on the copy queue without barriers. It is transitioned when it gets bound.
+  ID3D12GraphicsCommandList* copy_command_list = nullptr;
+  if (current_resource_state == D3D12_RESOURCE_STATE_COMMON &&
+      upload_size <= MAXIMUM_TEXTURE_UPLOAD_BUFFER_SIZE)
+  {
+    copy_command_list = D3D::command_list_mgr->GetCopyCommandList();
+  }
+  if (copy_command_list)
+  {
+    copy_command_list->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+    if (upload_size > SYNC_TEXTURE_UPLOAD_BUFFER_SIZE)
+      D3D::command_list_mgr->ExecuteCopyWork();
+    return;
+  }
+
+  ResourceBarrier(current_command_list, texture12, current_resource_state,
+                  D3D12_RESOURCE_STATE_COPY_DEST,
+                  D3D12CalcSubresource(level, layer, 0, miplevels, layers));
   D3D::current_command_list->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
 
   // Release temporary buffer after commands complete.
@@ -60,12 +60,13 @@ DXTexture::DXTexture(const TextureConfig& tex_config) : HostTexture(tex_config)
     D3D12_RESOURCE_DESC texdesc12 = CD3DX12_RESOURCE_DESC::Tex2D(dxgi_format,
       m_config.width, m_config.height, m_config.layers, m_config.levels);
     CD3DX12_HEAP_PROPERTIES hprop(D3D12_HEAP_TYPE_DEFAULT);
+    // Created in the common state so the first upload can go through the copy queue.
     CheckHR(
       D3D::device->CreateCommittedResource(
         &hprop,
         D3D12_HEAP_FLAG_NONE,
         &texdesc12,
-        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+        D3D12_RESOURCE_STATE_COMMON,
         nullptr,
         IID_PPV_ARGS(pTexture.ReleaseAndGetAddressOf())
       )
@@ -80,7 +81,7 @@ DXTexture::DXTexture(const TextureConfig& tex_config) : HostTexture(tex_config)
       DXGI_FORMAT_UNKNOWN,
       false,
       m_config.enviroment,
-      D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+      D3D12_RESOURCE_STATE_COMMON
     );
     // EXISTINGD3D11TODO: better debug names
     D3D::SetDebugObjectName12(m_texture->GetTex(), "a texture of the TextureCache");
@@ -156,6 +156,11 @@ void PerfQuery::FlushResults()
     FlushOne();
 }
 
+void PerfQuery::PollResults()
+{
+  WeakFlush();
+}
+
 void PerfQuery::WeakFlush()
 {
   UINT64 completed_fence = m_tracking_fence->GetCompletedValue();
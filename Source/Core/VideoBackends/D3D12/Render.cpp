@@ -251,12 +251,17 @@ void Renderer::Init()
 
 Renderer::~Renderer()
 {
+  FlushFrameDump();
   D3D::EndFrame();
   D3D::WaitForOutstandingRenderingToComplete();
-  if (m_frame_dump_buffer)
+  for (FrameDumpBuffer& buffer : m_frame_dump_buffers)
   {
-    D3D::command_list_mgr->DestroyResourceAfterCurrentCommandListExecuted(m_frame_dump_buffer);
-    m_frame_dump_buffer = nullptr;
+    if (buffer.buffer)
+    {
+      D3D::command_list_mgr->DestroyResourceAfterCurrentCommandListExecuted(buffer.buffer);
+      buffer.buffer = nullptr;
+    }
+    buffer.size = 0;
   }
   if (m_frame_dump_render_texture)
   {
@@ -265,7 +270,6 @@ Renderer::~Renderer()
   }
   m_frame_dump_render_texture_width = 0;
   m_frame_dump_render_texture_height = 0;
-  m_frame_dump_buffer_size = 0;
   TeardownDeviceObjects();
   m_post_processor.reset();
 }
@@ -631,6 +635,10 @@ void Renderer::SwapImpl(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height
   {
     DumpFrame(rc, xfb_addr, xfb_source_list, xfb_count, fb_width, fb_stride, fb_height, ticks);
   }
+  else
+  {
+    FlushFrameDump();
+  }
 
   // Reset viewport for drawing text
   D3D::SetViewportAndScissor(0, 0, GetBackbufferWidth(), GetBackbufferHeight());
@@ -1187,28 +1195,90 @@ void Renderer::PrepareFrameDumpRenderTexture(u32 width, u32 height)
     DXGI_FORMAT_R8G8B8A8_UNORM, 1, 1);
 }
 
-void Renderer::PrepareFrameDumpBuffer(u32 width, u32 height)
+Renderer::FrameDumpBuffer* Renderer::PrepareFrameDumpBuffer(u32 width, u32 height, u64 ticks)
 {
+  // The buffer to copy to is the one the dump thread got last time, it has to be done with it.
+  FinishFrameData();
+  UnmapFrameDumpBuffers();
+  m_current_frame_dump_buffer = (m_current_frame_dump_buffer + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+
+  // Hand the oldest frame to the dump thread, its copy was submitted two presents ago.
+  const size_t oldest_buffer = (m_current_frame_dump_buffer + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+  if (m_frame_dump_buffers[oldest_buffer].pending)
+    WriteFrameDumpBuffer(oldest_buffer);
+
+  FrameDumpBuffer& buffer = m_frame_dump_buffers[m_current_frame_dump_buffer];
   const unsigned int screenshot_buffer_size =
     Common::AlignUpSizePow2(width * 4, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT) *
     height;
-  if (screenshot_buffer_size < m_frame_dump_buffer_size)
+  if (!buffer.buffer || screenshot_buffer_size > buffer.size)
   {
-    return;
+    if (buffer.buffer)
+      D3D::command_list_mgr->DestroyResourceAfterCurrentCommandListExecuted(buffer.buffer);
+    buffer.buffer = nullptr;
+    buffer.size = screenshot_buffer_size;
+    CD3DX12_HEAP_PROPERTIES hprop(D3D12_HEAP_TYPE_READBACK);
+    auto rdesc = CD3DX12_RESOURCE_DESC::Buffer(buffer.size);
+    CheckHR(
+      D3D::device->CreateCommittedResource(
+        &hprop,
+        D3D12_HEAP_FLAG_NONE,
+        &rdesc,
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        nullptr,
+        IID_PPV_ARGS(&buffer.buffer)
+      )
+    );
   }
-  m_frame_dump_buffer_size = screenshot_buffer_size;
-  CD3DX12_HEAP_PROPERTIES hprop(D3D12_HEAP_TYPE_READBACK);
-  auto rdesc = CD3DX12_RESOURCE_DESC::Buffer(m_frame_dump_buffer_size);
-  CheckHR(
-    D3D::device->CreateCommittedResource(
-      &hprop,
-      D3D12_HEAP_FLAG_NONE,
-      &rdesc,
-      D3D12_RESOURCE_STATE_COPY_DEST,
-      nullptr,
-      IID_PPV_ARGS(&m_frame_dump_buffer)
-    )
-  );
+
+  buffer.dump_state = AVIDump::FetchState(ticks);
+  buffer.fence_value = D3D::command_list_mgr->GetCurrentCommandListFenceValue();
+  buffer.pending = true;
+  return &buffer;
+}
+
+void Renderer::WriteFrameDumpBuffer(size_t index)
+{
+  FrameDumpBuffer& buffer = m_frame_dump_buffers[index];
+  buffer.pending = false;
+  D3D::command_list_mgr->WaitForFenceValue(buffer.fence_value);
+
+  void* screenshot_texture_map;
+  D3D12_RANGE read_range = { 0, buffer.row_pitch * buffer.height };
+  CheckHR(buffer.buffer->Map(0, &read_range, &screenshot_texture_map));
+  buffer.mapped = true;
+  DumpFrameData(reinterpret_cast<const u8*>(screenshot_texture_map), buffer.width, buffer.height,
+    buffer.row_pitch, buffer.dump_state);
+}
+
+void Renderer::UnmapFrameDumpBuffers()
+{
+  for (FrameDumpBuffer& buffer : m_frame_dump_buffers)
+  {
+    if (buffer.mapped)
+    {
+      D3D12_RANGE write_range = {};
+      buffer.buffer->Unmap(0, &write_range);
+      buffer.mapped = false;
+    }
+  }
+}
+
+void Renderer::FlushFrameDump()
+{
+  // Frames have to be written in order, starting with the oldest one.
+  for (size_t i = 0; i < FRAME_DUMP_BUFFERED_FRAMES; i++)
+  {
+    m_current_frame_dump_buffer = (m_current_frame_dump_buffer + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+    if (m_frame_dump_buffers[m_current_frame_dump_buffer].pending)
+    {
+      FinishFrameData();
+      UnmapFrameDumpBuffers();
+      WriteFrameDumpBuffer(m_current_frame_dump_buffer);
+    }
+  }
+  FinishFrameData();
+  UnmapFrameDumpBuffers();
 }
 
 void  Renderer::DumpFrame(const EFBRectangle& source_rc, u32 xfb_addr,
@@ -1237,13 +1307,10 @@ void  Renderer::DumpFrame(const EFBRectangle& source_rc, u32 xfb_addr,
     src_height = GetTargetRectangle().GetHeight();
     source_box = GetScreenshotSourceBox(m_target_rectangle, src_width, src_height);
   }
-  PrepareFrameDumpBuffer(src_width, src_height);
-
-  unsigned int box_width = source_box.right - source_box.left;
-  unsigned int box_height = source_box.bottom - source_box.top;
+  FrameDumpBuffer* buffer = PrepareFrameDumpBuffer(src_width, src_height, ticks);
 
   D3D12_TEXTURE_COPY_LOCATION dst_location = {};
-  dst_location.pResource = m_frame_dump_buffer;
+  dst_location.pResource = buffer->buffer;
   dst_location.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
   dst_location.PlacedFootprint.Offset = 0;
   dst_location.PlacedFootprint.Footprint.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -1260,19 +1327,9 @@ void  Renderer::DumpFrame(const EFBRectangle& source_rc, u32 xfb_addr,
   src->TransitionToResourceState(D3D::current_command_list, D3D12_RESOURCE_STATE_COPY_SOURCE);
   D3D::current_command_list->CopyTextureRegion(&dst_location, 0, 0, 0, &src_location, &source_box);
 
-  D3D::command_list_mgr->ExecuteQueuedWork(true);
-
-  void* screenshot_texture_map;
-  D3D12_RANGE read_range = { 0, dst_location.PlacedFootprint.Footprint.RowPitch * box_height };
-  CheckHR(m_frame_dump_buffer->Map(0, &read_range, &screenshot_texture_map));
-
-  AVIDump::Frame state = AVIDump::FetchState(ticks);
-  DumpFrameData(reinterpret_cast<const u8*>(screenshot_texture_map), box_width, box_height,
-    dst_location.PlacedFootprint.Footprint.RowPitch, state);
-  FinishFrameData();
-
-  D3D12_RANGE write_range = {};
-  m_frame_dump_buffer->Unmap(0, &write_range);
+  buffer->width = source_box.right - source_box.left;
+  buffer->height = source_box.bottom - source_box.top;
+  buffer->row_pitch = dst_location.PlacedFootprint.Footprint.RowPitch;
 }
 
 D3D12_BLEND_DESC Renderer::GetResetBlendDesc()
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include "VideoCommon/RenderBase.h"
 #include "D3DTexture.h"
@@ -76,14 +77,35 @@ private:
     const XFBSourceBase* const* xfb_sources, u32 xfb_count, u32 fb_width,
     u32 fb_stride, u32 fb_height, u64 ticks);
 
+  // Frames are handed to the dump thread two frames late, so mapping them doesn't wait on the GPU.
+  static const size_t FRAME_DUMP_BUFFERED_FRAMES = 3;
+  struct FrameDumpBuffer
+  {
+    ID3D12Resource* buffer = nullptr;
+    u32 size = 0;
+    u32 width = 0;
+    u32 height = 0;
+    u32 row_pitch = 0;
+    UINT64 fence_value = 0;
+    AVIDump::Frame dump_state;
+    bool pending = false;
+    bool mapped = false;
+  };
+
   void PrepareFrameDumpRenderTexture(u32 width, u32 height);
-  void PrepareFrameDumpBuffer(u32 width, u32 height);
+  // Writes the oldest frame to the dump and returns the buffer to copy this one to.
+  FrameDumpBuffer* PrepareFrameDumpBuffer(u32 width, u32 height, u64 ticks);
+  void WriteFrameDumpBuffer(size_t index);
+  // Requires the dump thread to be done with the frames, see FinishFrameData.
+  void UnmapFrameDumpBuffers();
+  // Writes all pending frames, when dumping stops.
+  void FlushFrameDump();
   void SetupDeviceObjects();
   void TeardownDeviceObjects();
 
   D3DTexture2D* m_frame_dump_render_texture = nullptr;
-  ID3D12Resource* m_frame_dump_buffer = nullptr;
-  u32 m_frame_dump_buffer_size = 0;
+  std::array<FrameDumpBuffer, FRAME_DUMP_BUFFERED_FRAMES> m_frame_dump_buffers;
+  size_t m_current_frame_dump_buffer = FRAME_DUMP_BUFFERED_FRAMES - 1;
   u32 m_frame_dump_render_texture_width = 0;
   u32 m_frame_dump_render_texture_height = 0;
   u32 m_last_multisamples = 1;
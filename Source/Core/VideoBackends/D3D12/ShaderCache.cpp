@@ -17,6 +17,7 @@
 #include "VideoCommon/HLSLCompiler.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/ObjectUsageProfiler.h"
+#include "VideoCommon/ShaderUIDBundle.h"
 
 namespace DX12
 {
@@ -403,6 +404,12 @@ void ShaderCache::LoadHostBasedFromDisk()
     "Ishiiruka.ps",
     StringFromFormat("%s.ps", title_unique_id.c_str())
   );
+  ShaderUIDBundle::Bundle bundle;
+  if (ShaderUIDBundle::Load(title_unique_id, &bundle))
+  {
+    ShaderUIDBundle::Import(bundle.vertex_shaders, vs_bytecode_cache);
+    ShaderUIDBundle::Import(bundle.pixel_shaders, ps_bytecode_cache);
+  }
   std::string pus_cache_filename = GetDiskShaderCacheFileName(API_D3D11, "ups", false, true);
   std::string vus_cache_filename = GetDiskShaderCacheFileName(API_D3D11, "uvs", false, true);
   std::string ps_cache_filename = GetDiskShaderCacheFileName(API_D3D11, "ps", true, true);
@@ -635,7 +642,7 @@ void ShaderCache::HandleGSUIDChange(const GeometryShaderUid &gs_uid, std::functi
 void ShaderCache::HandlePSUIDChange(const PixelShaderUid &ps_uid, bool forcecompile = false, std::function<void()> oncompilationfinished = {})
 {
   ByteCodeCacheEntry* entry = &ps_bytecode_cache->GetOrAdd(ps_uid);
-  if (g_ActiveConfig.bDisableSpecializedShaders && !forcecompile)
+  if (g_ActiveConfig.UsingUberShadersOnly() && !forcecompile)
   {
     return;
   }
@@ -735,7 +742,7 @@ void ShaderCache::HandlePUSUIDChange(const UberShader::PixelUberShaderUid &ps_ui
 void ShaderCache::HandleVSUIDChange(const VertexShaderUid& vs_uid, bool forcecompile = false, std::function<void()> oncompilationfinished = {})
 {
   ByteCodeCacheEntry* entry = &vs_bytecode_cache->GetOrAdd(vs_uid);
-  if (g_ActiveConfig.bDisableSpecializedShaders && !forcecompile)
+  if (g_ActiveConfig.UsingUberShadersOnly() && !forcecompile)
   {
     return;
   }
@@ -933,7 +940,7 @@ void ShaderCache::PrepareShaders(PIXEL_SHADER_RENDER_MODE render_mode,
   const BPMemory &bpm)
 {
   SetCurrentPrimitiveTopology(gs_primitive_type);
-  if (g_ActiveConfig.bBackgroundShaderCompiling || g_ActiveConfig.bDisableSpecializedShaders)
+  if (g_ActiveConfig.UsingUberShaders())
   {
     auto vusid = UberShader::GetVertexUberShaderUid(components, xfr);
     if (!s_last_vertex_uber_shader_bytecode || s_last_vertex_uber_shader_uid != vusid)
@@ -1032,12 +1039,12 @@ void ShaderCache::PrepareShaders(PIXEL_SHADER_RENDER_MODE render_mode,
 bool ShaderCache::TestShaders()
 {
   s_compiler->ProcCompilationResults();  
-  if (g_ActiveConfig.bBackgroundShaderCompiling || g_ActiveConfig.bDisableSpecializedShaders)
+  if (g_ActiveConfig.UsingUberShaders())
   {
-    s_use_pixel_uber_shader = g_ActiveConfig.bDisableSpecializedShaders
+    s_use_pixel_uber_shader = g_ActiveConfig.UsingUberShadersOnly()
       || s_last_pixel_shader_bytecode == nullptr
       || !s_last_pixel_shader_bytecode->m_compiled;
-    s_use_vertex_uber_shader = g_ActiveConfig.bDisableSpecializedShaders
+    s_use_vertex_uber_shader = g_ActiveConfig.UsingUberShadersOnly()
       || s_last_vertex_shader_bytecode == nullptr
       || !s_last_vertex_shader_bytecode->m_compiled;
     return true;
@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <array>
 #include <memory>
 
 #include "Common/Align.h"
@@ -418,6 +419,15 @@ TextureCache::~TextureCache()
   D3D::command_list_mgr->DestroyResourceAfterCurrentCommandListExecuted(m_palette_uniform_buffer);
 }
 
+// Textures filled on the copy queue are still in the common state when they are first bound.
+static D3DTexture2D* GetBindableTexture(const TextureCacheBase::TCacheEntry* entry)
+{
+  D3DTexture2D* texture = static_cast<DXTexture*>(entry->texture.get())->GetRawTexIdentifier();
+  texture->TransitionToResourceState(D3D::current_command_list,
+                                     D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+  return texture;
+}
+
 void TextureCache::BindTextures()
 {
   const bool use_materials = g_ActiveConfig.HiresMaterialMapsEnabled();
@@ -438,81 +448,64 @@ void TextureCache::BindTextures()
   if (last_texture == 0 && !bound_textures[0]->material_map)
   {
     DX12::D3D::current_command_list->SetGraphicsRootDescriptorTable(
-        DESCRIPTOR_TABLE_PS_SRV, static_cast<DXTexture*>(bound_textures[0]->texture.get())
-                                     ->GetRawTexIdentifier()
-                                     ->GetSRVGPU());
+        DESCRIPTOR_TABLE_PS_SRV, GetBindableTexture(bound_textures[0])->GetSRVGPU());
     return;
   }
 
-  // If more than one texture, allocate space for group.
-  D3D12_CPU_DESCRIPTOR_HANDLE s_group_base_texture_cpu_handle;
-  const u32 num_handles = g_ActiveConfig.bForcePhongShading ? 9 : 8;
-  if (!D3D::gpu_descriptor_heap_mgr->AllocateTemporary(
-          num_handles, &s_group_base_texture_cpu_handle, &s_group_base_texture_gpu_handle))
-  {
-    // Kick command buffer before attempting to allocate again. This is slow.
-    D3D::command_list_mgr->ExecuteQueuedWork();
-    if (!D3D::gpu_descriptor_heap_mgr->AllocateTemporary(
-            num_handles, &s_group_base_texture_cpu_handle, &s_group_base_texture_gpu_handle))
-    {
-      PanicAlert("Failed to allocate temporary descriptors.");
-      return;
-    }
-  }
+  // The pixel shaders take all their textures from one descriptor table, so every slot is copied
+  // into a temporary group. Consecutive draws usually sample the same textures, keep using the last
+  // group while the sources don't change. Temporary descriptors and the shadow descriptors they
+  // were copied from both stay valid until the command list that used them has executed.
+  static std::array<D3D12_CPU_DESCRIPTOR_HANDLE, 9> s_group_sources = {};
+  static UINT64 s_group_command_list = 0;
 
+  const u32 num_handles = g_ActiveConfig.bForcePhongShading ? 9 : 8;
+  std::array<D3D12_CPU_DESCRIPTOR_HANDLE, 9> sources;
+  sources.fill(DX12::D3D::null_srv_cpu_shadow);
   for (size_t stage = 0; stage < 8; stage++)
   {
     if (IsValidBindPoint(static_cast<u32>(stage)) && bound_textures[stage])
-    {
-      D3D12_CPU_DESCRIPTOR_HANDLE textureDestDescriptor;
-      textureDestDescriptor.ptr =
-          s_group_base_texture_cpu_handle.ptr + stage * D3D::resource_descriptor_size;
-
-      DX12::D3D::device->CopyDescriptorsSimple(
-          1, textureDestDescriptor,
-          static_cast<DXTexture*>(bound_textures[stage]->texture.get())
-              ->GetRawTexIdentifier()
-              ->GetSRVCPUShadow(),
-          D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-    }
-    else
-    {
-      D3D12_CPU_DESCRIPTOR_HANDLE nullDestDescriptor;
-      nullDestDescriptor.ptr =
-          s_group_base_texture_cpu_handle.ptr + stage * D3D::resource_descriptor_size;
-
-      DX12::D3D::device->CopyDescriptorsSimple(1, nullDestDescriptor,
-                                               DX12::D3D::null_srv_cpu_shadow,
-                                               D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-    }
+      sources[stage] = GetBindableTexture(bound_textures[stage])->GetSRVCPUShadow();
   }
-
-  if (g_ActiveConfig.HiresMaterialMapsEnabled() && g_ActiveConfig.bForcePhongShading)
+  if (use_materials && g_ActiveConfig.bForcePhongShading)
   {
     SetupEnviromentTexture();
     if (bound_enviroment)
+      sources[8] = GetBindableTexture(bound_enviroment)->GetSRVCPUShadow();
+  }
+
+  const UINT64 command_list = D3D::command_list_mgr->GetCurrentCommandListFenceValue();
+  bool group_valid = s_group_command_list == command_list;
+  for (u32 i = 0; group_valid && i < num_handles; i++)
+    group_valid = s_group_sources[i].ptr == sources[i].ptr;
+
+  if (!group_valid)
+  {
+    D3D12_CPU_DESCRIPTOR_HANDLE s_group_base_texture_cpu_handle;
+    if (!D3D::gpu_descriptor_heap_mgr->AllocateTemporary(
+            num_handles, &s_group_base_texture_cpu_handle, &s_group_base_texture_gpu_handle))
     {
-      D3D12_CPU_DESCRIPTOR_HANDLE textureDestDescriptor;
-      textureDestDescriptor.ptr =
-          s_group_base_texture_cpu_handle.ptr + 8 * D3D::resource_descriptor_size;
-
-      DX12::D3D::device->CopyDescriptorsSimple(
-          1, textureDestDescriptor,
-          static_cast<DXTexture*>(bound_enviroment->texture.get())
-              ->GetRawTexIdentifier()
-              ->GetSRVCPUShadow(),
-          D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+      // Kick command buffer before attempting to allocate again. This is slow.
+      D3D::command_list_mgr->ExecuteQueuedWork();
+      if (!D3D::gpu_descriptor_heap_mgr->AllocateTemporary(
+              num_handles, &s_group_base_texture_cpu_handle, &s_group_base_texture_gpu_handle))
+      {
+        s_group_command_list = 0;
+        PanicAlert("Failed to allocate temporary descriptors.");
+        return;
+      }
     }
-    else
-    {
-      D3D12_CPU_DESCRIPTOR_HANDLE nullDestDescriptor;
-      nullDestDescriptor.ptr =
-          s_group_base_texture_cpu_handle.ptr + 8 * D3D::resource_descriptor_size;
 
-      DX12::D3D::device->CopyDescriptorsSimple(1, nullDestDescriptor,
-                                               DX12::D3D::null_srv_cpu_shadow,
+    for (u32 i = 0; i < num_handles; i++)
+    {
+      D3D12_CPU_DESCRIPTOR_HANDLE dest_descriptor;
+      dest_descriptor.ptr = s_group_base_texture_cpu_handle.ptr + i * D3D::resource_descriptor_size;
+      DX12::D3D::device->CopyDescriptorsSimple(1, dest_descriptor, sources[i],
                                                D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
     }
+    s_group_sources = sources;
+    // Kicking the command buffer above moved us to the next list.
+    s_group_command_list = D3D::command_list_mgr->GetCurrentCommandListFenceValue();
   }
 
   // Actually bind the textures.
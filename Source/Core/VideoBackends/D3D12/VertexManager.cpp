@@ -165,6 +165,8 @@ void VertexManager::vFlush(bool use_dst_alpha)
   g_renderer->ApplyState(use_dst_alpha);
 
   Draw(stride);
+  if (ShaderCache::UsePixelUberShader() || ShaderCache::UseVertexUberShader())
+    INCSTAT(stats.thisFrame.numUberShaderDraws);
 
   // Many Gamecube/Wii titles read from the EFB each frame to determine what new rendering work to submit, e.g. where sun rays are
   // occluded and where they aren't. When the CPU wants to read this data (done in Renderer::AccessEFB), it requires that the GPU
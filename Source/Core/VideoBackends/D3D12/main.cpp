@@ -79,6 +79,7 @@ void VideoBackend::InitBackendInfo()
 
   g_Config.backend_info.APIType = API_D3D11;
   g_Config.backend_info.MaxTextureSize = D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION;
+  g_Config.backend_info.VideoMemorySize = 0;
   g_Config.backend_info.bSupportedFormats[PC_TEX_FMT_BGRA32] = false;
   g_Config.backend_info.bSupportedFormats[PC_TEX_FMT_RGBA32] = true;
   g_Config.backend_info.bSupportedFormats[PC_TEX_FMT_I4_AS_I8] = false;
@@ -105,6 +106,7 @@ void VideoBackend::InitBackendInfo()
   g_Config.backend_info.bSupportsBBox = true;
   g_Config.backend_info.bSupportsBBox = true;
   g_Config.backend_info.bSupportsGSInstancing = true;
+  g_Config.backend_info.bSupportsVSLayerOutput = false;
   g_Config.backend_info.bSupportsTessellation = true;
   g_Config.backend_info.bSupportsSSAA = true;
   g_Config.backend_info.bSupportsGPUTextureDecoding = false;
@@ -120,6 +122,7 @@ void VideoBackend::InitBackendInfo()
   g_Config.backend_info.bSupportsDynamicSamplerIndexing = false;
   g_Config.backend_info.bSupportsUberShaders = true;
   g_Config.backend_info.bSupportsHighPrecisionFrameBuffer = true;
+  g_Config.backend_info.bSupportsPrimitiveRestart = false;
   IDXGIFactory* factory;
   IDXGIAdapter* ad;
   hr = create_dxgi_factory(__uuidof(IDXGIFactory), (void**)&factory);
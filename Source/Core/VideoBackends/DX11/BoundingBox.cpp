@@ -2,6 +2,8 @@
 // Licensed under GPLv2++
 // Refer to the license.txt file included.
 
+#include <array>
+
 #include "Common/CommonTypes.h"
 #include "Common/MsgHandler.h"
 
@@ -21,6 +23,11 @@ alignas(128) static s32 s_values[4];
 static bool s_cpu_dirty;
 static bool s_gpu_dirty;
 
+// Latency tolerant mode, see VideoConfig::bBBoxLatencyTolerant.
+static BoundingBox::ReadbackRing s_readback_ring;
+static std::array<D3D::BufferPtr, BoundingBox::ReadbackRing::NUM_SLOTS> s_readback_buffers;
+static std::array<std::array<s32, 4>, BoundingBox::ReadbackRing::NUM_SLOTS> s_readback_values;
+
 void BBox::Init()
 {
   if (g_ActiveConfig.backend_info.bSupportsBBox)
@@ -44,6 +51,13 @@ void BBox::Init()
     hr = D3D::device->CreateBuffer(&desc, nullptr, ToAddr(s_bbox_staging_buffer));
     CHECK(SUCCEEDED(hr), "Create BoundingBox staging buffer.");
     D3D::SetDebugObjectName(s_bbox_staging_buffer.get(), "BoundingBox staging buffer");
+    for (D3D::BufferPtr& buffer : s_readback_buffers)
+    {
+      hr = D3D::device->CreateBuffer(&desc, nullptr, ToAddr(buffer));
+      CHECK(SUCCEEDED(hr), "Create BoundingBox readback buffer.");
+      D3D::SetDebugObjectName(buffer.get(), "BoundingBox readback buffer");
+    }
+    s_readback_ring = {};
     // UAV is required to allow concurrent access.
     D3D11_UNORDERED_ACCESS_VIEW_DESC UAVdesc = {};
     UAVdesc.Format = DXGI_FORMAT_R32_SINT;
@@ -62,6 +76,8 @@ void BBox::Shutdown()
 {
   s_bbox_buffer.reset();
   s_bbox_staging_buffer.reset();
+  for (D3D::BufferPtr& buffer : s_readback_buffers)
+    buffer.reset();
   s_bbox_uav.reset();
 }
 
@@ -88,11 +104,42 @@ void BBox::Set(s32 index, s32 value)
   {
     s_values[index] = value;
     s_cpu_dirty = true;
+    s_readback_ring.Invalidate();
+  }
+}
+
+static s32 GetLatencyTolerant(s32 index)
+{
+  // Values the CPU wrote are still to be uploaded, a copy now would read the old ones.
+  if (s_gpu_dirty && !s_cpu_dirty && g_ActiveConfig.iBBoxMode == BBoxGPU)
+  {
+    const u32 slot = s_readback_ring.Begin();
+    D3D::context->CopyResource(s_readback_buffers[slot].get(), s_bbox_buffer.get());
+    s_gpu_dirty = false;
   }
+  s_readback_ring.Poll(
+      [](u32 slot) {
+        D3D11_MAPPED_SUBRESOURCE map;
+        HRESULT hr = D3D::context->Map(s_readback_buffers[slot].get(), 0, D3D11_MAP_READ,
+                                       D3D11_MAP_FLAG_DO_NOT_WAIT, &map);
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+          return false;
+        if (SUCCEEDED(hr))
+        {
+          memcpy(s_readback_values[slot].data(), map.pData, 4 * sizeof(s32));
+          D3D::context->Unmap(s_readback_buffers[slot].get(), 0);
+        }
+        return true;
+      },
+      [](u32 slot) { memcpy(s_values, s_readback_values[slot].data(), 4 * sizeof(s32)); });
+  return s_values[index];
 }
 
 s32 BBox::Get(s32 index)
 {
+  if (g_ActiveConfig.bBBoxLatencyTolerant)
+    return GetLatencyTolerant(index);
+
   if (s_gpu_dirty && g_ActiveConfig.iBBoxMode == BBoxGPU)
   {
     D3D::context->CopyResource(s_bbox_staging_buffer.get(), s_bbox_buffer.get());
@@ -65,6 +65,23 @@ unsigned int xres, yres;
 
 bool bFrameInProgress = false;
 
+// Present times by present count, matched against the frame statistics to get the latency
+constexpr u32 PRESENT_HISTORY_SIZE = 8;
+static LARGE_INTEGER s_present_times[PRESENT_HISTORY_SIZE];
+static float s_present_latency = -1.0f;
+static bool s_low_latency = false;
+
+static void ApplyFrameLatency()
+{
+  s_low_latency = g_ActiveConfig.bLowLatency;
+  IDXGIDevice1* dxgi_device = nullptr;
+  if (FAILED(device->QueryInterface(__uuidof(IDXGIDevice1), (void**)&dxgi_device)))
+    return;
+  // 3 is the DXGI default
+  dxgi_device->SetMaximumFrameLatency(s_low_latency ? 1 : 3);
+  dxgi_device->Release();
+}
+
 D3D_FEATURE_LEVEL GetFeatureLevel()
 {
   return featlevel;
@@ -393,6 +410,9 @@ HRESULT Create(HWND wnd)
   hr = factory->MakeWindowAssociation(wnd, DXGI_MWA_NO_WINDOW_CHANGES);
   if (FAILED(hr)) MessageBox(wnd, _T("Failed to associate the window"), _T("Dolphin Direct3D 11 backend"), MB_OK | MB_ICONERROR);
 
+  ApplyFrameLatency();
+  s_present_latency = -1.0f;
+
   SetDebugObjectName(context, "device context");
   SAFE_RELEASE(factory);
   SAFE_RELEASE(output);
@@ -441,6 +461,17 @@ HRESULT Create(HWND wnd)
   SetDebugObjectName(backbuf->GetRTV(), "backbuffer render target view");
 
   context->OMSetRenderTargets(1, &backbuf->GetRTV(), nullptr);
+
+  // Deferred contexts are emulated by the runtime when the driver lacks command lists, recording
+  // on them then costs more than it saves. Logged to tell the two cases apart in bug reports.
+  D3D11_FEATURE_DATA_THREADING threading = {};
+  if (SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading))))
+  {
+    INFO_LOG(VIDEO, "D3D11 driver command lists: %s, concurrent creates: %s",
+             threading.DriverCommandLists ? "yes" : "no",
+             threading.DriverConcurrentCreates ? "yes" : "no");
+  }
+
   UINT format_support;
   device->CheckFormatSupport(DXGI_FORMAT_B8G8R8A8_UNORM, &format_support);
   bgra_textures_supported = (format_support & D3D11_FORMAT_SUPPORT_TEXTURE2D) != 0;
@@ -647,8 +678,38 @@ void EndFrame()
 
 void Present()
 {
+  if (s_low_latency != g_ActiveConfig.bLowLatency)
+    ApplyFrameLatency();
+
+  LARGE_INTEGER present_time;
+  QueryPerformanceCounter(&present_time);
   // TODO: Is 1 the correct value for vsyncing?
   swapchain->Present((UINT)g_ActiveConfig.IsVSync(), 0);
+
+  UINT present_count;
+  if (FAILED(swapchain->GetLastPresentCount(&present_count)))
+    return;
+  s_present_times[present_count % PRESENT_HISTORY_SIZE] = present_time;
+
+  // Frame statistics are only available in exclusive fullscreen
+  DXGI_FRAME_STATISTICS stats;
+  if (FAILED(swapchain->GetFrameStatistics(&stats)) ||
+      present_count - stats.PresentCount >= PRESENT_HISTORY_SIZE)
+  {
+    s_present_latency = -1.0f;
+    return;
+  }
+  LARGE_INTEGER frequency;
+  QueryPerformanceFrequency(&frequency);
+  const LONGLONG ticks =
+      stats.SyncQPCTime.QuadPart -
+      s_present_times[stats.PresentCount % PRESENT_HISTORY_SIZE].QuadPart;
+  s_present_latency = static_cast<float>(ticks * 1000.0 / frequency.QuadPart);
+}
+
+float GetPresentLatency()
+{
+  return s_present_latency;
 }
 
 HRESULT SetFullscreenState(bool enable_fullscreen)
@@ -48,6 +48,8 @@ void Reset();
 bool BeginFrame();
 void EndFrame();
 void Present();
+// Milliseconds from the last displayed Present call to its vblank, negative if unknown.
+float GetPresentLatency();
 
 D3D_FEATURE_LEVEL GetFeatureLevel();
 bool GetLogicOpSupported();
@@ -8,6 +8,7 @@
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
+#include "Common/TraceEvents.h"
 #include "Common/Logging/Log.h"
 
 #include "VideoBackends/DX11/D3DBase.h"
@@ -107,6 +108,7 @@ bool CompileShader(
   const D3D_SHADER_MACRO* pDefines,
   const char* pEntry, bool throwerror)
 {
+  TRACE_SCOPE("CompileShader");
   UINT flags = D3DCOMPILE_SKIP_VALIDATION;  
 
   if (g_ActiveConfig.bEnableShaderDebug)
@@ -133,6 +133,40 @@ void ConstantStreamBuffer::AppendData(void* data, u32 size)
   m_offset += size;
 }
 
+ConstantRegionBuffer::ConstantRegionBuffer(u32 size) : m_size(Common::AlignUpSizePow2(size, 256)), m_data_size(size)
+{
+  D3D11_BUFFER_DESC desc = CD3D11_BUFFER_DESC(m_size, D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DEFAULT);
+  device->CreateBuffer(&desc, nullptr, &m_buf);
+}
+
+ConstantRegionBuffer::~ConstantRegionBuffer()
+{
+  m_buf->Release();
+}
+
+u32 ConstantRegionBuffer::UpdateRegions(const void* data, const regionvector& regions)
+{
+  const u8* src = static_cast<const u8*>(data);
+  if (m_need_init || regions.empty())
+  {
+    // The driver has nothing to patch yet, or we don't know what changed.
+    D3D11_BOX box = CD3D11_BOX(0, 0, 0, m_data_size, 1, 1);
+    context1->UpdateSubresource1(m_buf, 0, &box, src, 0, 0, 0);
+    m_need_init = false;
+    return m_data_size;
+  }
+  u32 uploaded = 0;
+  for (const std::pair<u32, u32>& region : regions)
+  {
+    const u32 begin = region.first * 16;
+    const u32 end = std::min((region.second + 1) * 16, m_data_size);
+    D3D11_BOX box = CD3D11_BOX(begin, 0, 0, end, 1, 1);
+    context1->UpdateSubresource1(m_buf, 0, &box, src + begin, 0, 0, 0);
+    uploaded += end - begin;
+  }
+  return uploaded;
+}
+
 CD3DFont font;
 UtilVertexBuffer* util_vbuf = nullptr;
 
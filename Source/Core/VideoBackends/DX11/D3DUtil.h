@@ -7,6 +7,7 @@
 #include <d3d11_2.h>
 
 #include "Common/Align.h"
+#include "Common/ConstantBuffer.h"
 
 #include "VideoBackends/DX11/D3DPtr.h"
 
@@ -110,6 +111,32 @@ private:
   bool m_need_init = true;
 };
 
+// Constant buffer kept in video memory and patched in place, only the float4 ranges that changed
+// since the last upload are copied. Needs partial constant buffer updates.
+class ConstantRegionBuffer
+{
+public:
+  ConstantRegionBuffer(u32 size);
+  ~ConstantRegionBuffer();
+
+  // regions are inclusive float4 ranges, returns the number of bytes uploaded
+  u32 UpdateRegions(const void* data, const regionvector& regions);
+
+  inline ID3D11Buffer* &GetBuffer()
+  {
+    return  m_buf;
+  }
+  inline D3D::BufferDescriptor GetDescriptor()
+  {
+    return D3D::BufferDescriptor(m_buf, 0, m_size >> 4);
+  };
+private:
+  ID3D11Buffer* m_buf = nullptr;
+  u32 m_size = 0;
+  u32 m_data_size = 0;
+  bool m_need_init = true;
+};
+
 extern CD3DFont font;
 
 void InitUtils();
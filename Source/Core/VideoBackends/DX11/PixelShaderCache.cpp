@@ -19,6 +19,7 @@
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/HLSLCompiler.h"
 #include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/ShaderUIDBundle.h"
 
 
 
@@ -46,6 +47,7 @@ D3D::PixelShaderPtr s_rgba6_to_rgb8[2];
 D3D::PixelShaderPtr s_rgb8_to_rgba6[2];
 
 D3D::ConstantStreamBuffer* pscbuf;
+std::unique_ptr<D3D::ConstantRegionBuffer> s_ps_region_buffer;
 
 const char* clear_program_code = R"hlsl(
 	void main(
@@ -440,6 +442,17 @@ ID3D11PixelShader* PixelShaderCache::GetClearProgram()
 
 D3D::BufferDescriptor PixelShaderCache::GetConstantBuffer()
 {
+  if (s_ps_region_buffer)
+  {
+    if (PixelShaderManager::IsDirty())
+    {
+      const u32 sz = s_ps_region_buffer->UpdateRegions(PixelShaderManager::GetBuffer(),
+                                                        PixelShaderManager::GetDirtyRegions());
+      PixelShaderManager::Clear();
+      ADDSTAT(stats.thisFrame.bytesUniformStreamed, sz);
+    }
+    return s_ps_region_buffer->GetDescriptor();
+  }
   if (PixelShaderManager::IsDirty())
   {
     const int sz = PixelShaderManager::ConstantBufferSize * sizeof(float);
@@ -481,9 +494,20 @@ void PixelShaderCache::Init()
 {
   s_compiler = &HLSLAsyncCompiler::getInstance();
   bool use_partial_buffer_update = D3D::SupportPartialContantBufferUpdate();
-  u32 cbsize = PixelShaderManager::ConstantBufferSize * sizeof(float) * (use_partial_buffer_update ? 1024 : 1); // is always a multiple of 16	
-  pscbuf = new D3D::ConstantStreamBuffer(cbsize);
-  ID3D11Buffer* buf = pscbuf->GetBuffer();
+  u32 cbsize = PixelShaderManager::ConstantBufferSize * sizeof(float); // is always a multiple of 16
+  ID3D11Buffer* buf;
+  if (use_partial_buffer_update)
+  {
+    // Patch the changed ranges in place instead of streaming the whole block on every change.
+    s_ps_region_buffer = std::make_unique<D3D::ConstantRegionBuffer>(cbsize);
+    buf = s_ps_region_buffer->GetBuffer();
+    PixelShaderManager::EnableDirtyRegions();
+  }
+  else
+  {
+    pscbuf = new D3D::ConstantStreamBuffer(cbsize);
+    buf = pscbuf->GetBuffer();
+  }
   CHECK(buf != nullptr, "Create pixel shader constant buffer");
   D3D::SetDebugObjectName(buf, "pixel shader constant buffer used to emulate the GX pipeline");
 
@@ -553,6 +577,9 @@ void PixelShaderCache::LoadFromDisk()
     "Ishiiruka.ps",
     StringFromFormat("%s.ps", SConfig::GetInstance().GetGameID().c_str())
   );
+  ShaderUIDBundle::Bundle bundle;
+  if (ShaderUIDBundle::Load(SConfig::GetInstance().GetGameID(), &bundle))
+    ShaderUIDBundle::Import(bundle.pixel_shaders, s_pixel_shaders);
   std::string cache_filename = GetDiskShaderCacheFileName(API_D3D11, "ups", false, true);
   PixelUberShaderCacheInserter uinserter;
   g_pus_disk_cache.OpenAndRead(cache_filename, uinserter);
@@ -673,6 +700,7 @@ void PixelShaderCache::Shutdown()
     delete pscbuf;
   }
   pscbuf = nullptr;
+  s_ps_region_buffer.reset();
   s_ClearProgram.reset();
   s_DepthResolveProgram.reset();
   for (auto & p : s_ColorCopyProgram)
@@ -759,7 +787,7 @@ void PixelShaderCache::CompileUberShader(const UberShader::PixelUberShaderUid& u
 void PixelShaderCache::CompilePShader(const PixelShaderUid& uid, const ShaderHostConfig& hostconfig, bool forcecompile = false, std::function<void()> oncompilationfinished = {})
 {
   PSCacheEntry* entry = &s_pixel_shaders->GetOrAdd(uid);
-  if (g_ActiveConfig.bDisableSpecializedShaders && !forcecompile)
+  if (g_ActiveConfig.UsingUberShadersOnly() && !forcecompile)
   {
     return;
   }
@@ -827,7 +855,7 @@ void PixelShaderCache::PrepareShader(PIXEL_SHADER_RENDER_MODE render_mode,
   const XFMemory &xfr,
   const BPMemory &bpm)
 {
-  if (g_ActiveConfig.bBackgroundShaderCompiling || g_ActiveConfig.bDisableSpecializedShaders)
+  if (g_ActiveConfig.UsingUberShaders())
   {
     auto uuid = UberShader::GetPixelUberShaderUid(components, xfr, bpm);
     if (!s_last_uber_entry || s_last_uber_uid != uuid)
@@ -849,23 +877,26 @@ void PixelShaderCache::PrepareShader(PIXEL_SHADER_RENDER_MODE render_mode,
   CompilePShader(uid, ShaderHostConfig::GetCurrent());
 }
 
-void PixelShaderCache::SetActiveShader()
+bool PixelShaderCache::SetActiveShader()
 {
   ID3D11PixelShader* shader = nullptr;
-  if (!g_ActiveConfig.bDisableSpecializedShaders && s_last_entry && s_last_entry->compiled)
+  bool uber = false;
+  if (!g_ActiveConfig.UsingUberShadersOnly() && s_last_entry && s_last_entry->compiled)
   {
     shader = s_last_entry->shader.get();
   }
   else if (s_last_uber_entry)
   {
     shader = s_last_uber_entry->shader.get();
+    uber = true;
   }
   D3D::stateman->SetPixelShader(shader);
+  return uber;
 }
 
 bool PixelShaderCache::TestShader()
 {
-  if (g_ActiveConfig.bBackgroundShaderCompiling || g_ActiveConfig.bDisableSpecializedShaders)
+  if (g_ActiveConfig.UsingUberShaders())
   {
     return s_last_uber_entry && s_last_uber_entry->compiled;;
   }
@@ -32,7 +32,8 @@ public:
     const BPMemory &bpm);
   static bool TestShader();  
 
-  static void SetActiveShader();
+  // Returns true if the ubershader was set.
+  static bool SetActiveShader();
 
   static D3D::BufferDescriptor GetConstantBuffer();
 
@@ -234,20 +234,80 @@ void Renderer::PrepareFrameDumpRenderTexture(u32 width, u32 height)
     (D3D11_BIND_FLAG)(D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE),
     D3D11_USAGE_DEFAULT, DXGI_FORMAT_R8G8B8A8_UNORM, 1, 1);
 }
-void Renderer::PrepareFrameDumpBuffer(u32 width, u32 height)
+Renderer::FrameDumpImage* Renderer::PrepareFrameDumpImage(u32 texture_width, u32 texture_height, u64 ticks)
 {
-  if (width == m_frame_dump_staging_texture_width
-    && height == m_frame_dump_staging_texture_height)
+  // The image to copy to is the one the dump thread got last time, it has to be done with it.
+  FinishFrameData();
+  UnmapFrameDumpImages();
+  m_current_frame_dump_image = (m_current_frame_dump_image + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+
+  // Hand the oldest frame to the dump thread, its copy has had two frames to finish.
+  const size_t oldest_image = (m_current_frame_dump_image + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+  if (m_frame_dump_images[oldest_image].pending)
+    WriteFrameDumpImage(oldest_image);
+
+  FrameDumpImage& image = m_frame_dump_images[m_current_frame_dump_image];
+  if (!image.staging_texture || image.texture_width != texture_width ||
+    image.texture_height != texture_height)
   {
+    image.staging_texture.reset();
+    image.texture_width = 0;
+    image.texture_height = 0;
+    D3D11_TEXTURE2D_DESC scrtex_desc = CD3D11_TEXTURE2D_DESC(DXGI_FORMAT_R8G8B8A8_UNORM, texture_width, texture_height, 1, 1, 0, D3D11_USAGE_STAGING, D3D11_CPU_ACCESS_READ | D3D11_CPU_ACCESS_WRITE);
+    HRESULT hr = D3D::device->CreateTexture2D(&scrtex_desc, nullptr, D3D::ToAddr(image.staging_texture));
+    CHECK(hr == S_OK, "Create screenshot staging texture");
+    if (FAILED(hr))
+      return nullptr;
+    D3D::SetDebugObjectName(image.staging_texture.get(), "staging screenshot texture");
+    image.texture_width = texture_width;
+    image.texture_height = texture_height;
+  }
+
+  image.dump_state = AVIDump::FetchState(ticks);
+  image.pending = true;
+  return &image;
+}
+
+void Renderer::WriteFrameDumpImage(size_t index)
+{
+  FrameDumpImage& image = m_frame_dump_images[index];
+  image.pending = false;
+
+  D3D11_MAPPED_SUBRESOURCE map;
+  if (FAILED(D3D::context->Map(image.staging_texture.get(), 0, D3D11_MAP_READ, 0, &map)))
     return;
+  image.mapped = true;
+  DumpFrameData(reinterpret_cast<const u8*>(map.pData), image.width, image.height, map.RowPitch,
+    image.dump_state);
+}
+
+void Renderer::UnmapFrameDumpImages()
+{
+  for (FrameDumpImage& image : m_frame_dump_images)
+  {
+    if (image.mapped)
+    {
+      D3D::context->Unmap(image.staging_texture.get(), 0);
+      image.mapped = false;
+    }
+  }
+}
+
+void Renderer::FlushFrameDump()
+{
+  // Frames have to be written in order, starting with the oldest one.
+  for (size_t i = 0; i < FRAME_DUMP_BUFFERED_FRAMES; i++)
+  {
+    m_current_frame_dump_image = (m_current_frame_dump_image + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+    if (m_frame_dump_images[m_current_frame_dump_image].pending)
+    {
+      FinishFrameData();
+      UnmapFrameDumpImages();
+      WriteFrameDumpImage(m_current_frame_dump_image);
+    }
   }
-  m_frame_dump_staging_texture.reset();
-  // We can't render anything outside of the backbuffer anyway, so use the backbuffer size as the screenshot buffer size.
-  // This texture is released to be recreated when the window is resized in Renderer::SwapImpl.
-  D3D11_TEXTURE2D_DESC scrtex_desc = CD3D11_TEXTURE2D_DESC(DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1, 1, 0, D3D11_USAGE_STAGING, D3D11_CPU_ACCESS_READ | D3D11_CPU_ACCESS_WRITE);
-  HRESULT hr = D3D::device->CreateTexture2D(&scrtex_desc, nullptr, D3D::ToAddr(m_frame_dump_staging_texture));
-  CHECK(hr == S_OK, "Create screenshot staging texture");
-  D3D::SetDebugObjectName(m_frame_dump_staging_texture.get(), "staging screenshot texture");
+  FinishFrameData();
+  UnmapFrameDumpImages();
 }
 Renderer::Renderer(void *&window_handle)
 {
@@ -274,7 +334,6 @@ Renderer::Renderer(void *&window_handle)
 
   m_3d_vision_texture = nullptr;
   m_frame_dump_render_texture = nullptr;
-  m_frame_dump_staging_texture.reset();
   CheckForHostConfigChanges();
 }
 
@@ -304,6 +363,7 @@ void Renderer::Init()
 
 Renderer::~Renderer()
 {
+  FlushFrameDump();
   m_post_processor.reset();
   TeardownDeviceObjects();
   if (m_3d_vision_texture)
@@ -316,7 +376,8 @@ Renderer::~Renderer()
   }
   m_3d_vision_texture = nullptr;
   m_frame_dump_render_texture = nullptr;
-  m_frame_dump_staging_texture.reset();
+  for (FrameDumpImage& image : m_frame_dump_images)
+    image.staging_texture.reset();
   D3D::EndFrame();
   D3D::Present();
   D3D::Close();
@@ -637,6 +698,10 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, co
   {
     DumpFrame(rc, xfbAddr, xfbSourceList, xfbCount, fbWidth, fbStride, fbHeight, ticks);
   }
+  else
+  {
+    FlushFrameDump();
+  }
 
   Renderer::DrawDebugText();
   OSD::DrawMessages();
@@ -737,6 +802,11 @@ void Renderer::InsertBlackFrame()
   Renderer::RestoreAPIState();
 }
 
+float Renderer::GetPresentLatency()
+{
+  return D3D::GetPresentLatency();
+}
+
 // ALWAYS call RestoreAPIState for each ResetAPIState call you're doing
 void Renderer::ResetAPIState()
 {
@@ -1048,19 +1118,13 @@ void  Renderer::DumpFrame(const EFBRectangle& source_rc, u32 xfb_addr,
     src_height = GetTargetRectangle().GetHeight();
     source_box = GetScreenshotSourceBox(m_target_rectangle, src_width, src_height);
   }
-  PrepareFrameDumpBuffer(src_width, src_height);
-
-  unsigned int box_width = source_box.right - source_box.left;
-  unsigned int box_height = source_box.bottom - source_box.top;
+  FrameDumpImage* image = PrepareFrameDumpImage(src_width, src_height, ticks);
+  if (!image)
+    return;
 
-  D3D::context->CopySubresourceRegion(m_frame_dump_staging_texture.get(), 0, 0, 0, 0, (ID3D11Resource*)src->GetTex(), 0, &source_box);
-  D3D11_MAPPED_SUBRESOURCE map;
-  D3D::context->Map(m_frame_dump_staging_texture.get(), 0, D3D11_MAP_READ, 0, &map);
-  AVIDump::Frame state = AVIDump::FetchState(ticks);
-  DumpFrameData(reinterpret_cast<const u8*>(map.pData), box_width, box_height,
-    map.RowPitch, state);
-  FinishFrameData();
-  D3D::context->Unmap(m_frame_dump_staging_texture.get(), 0);
+  image->width = source_box.right - source_box.left;
+  image->height = source_box.bottom - source_box.top;
+  D3D::context->CopySubresourceRegion(image->staging_texture.get(), 0, 0, 0, 0, (ID3D11Resource*)src->GetTex(), 0, &source_box);
 }
 
 void Renderer::SetFullscreen(bool enable_fullscreen)
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include "VideoCommon/RenderBase.h"
 #include "VideoBackends/DX11/D3DTexture.h"
@@ -46,6 +47,7 @@ public:
 
   void SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const EFBRectangle& rc, u64 ticks, float Gamma = 1.0f) override;
   void InsertBlackFrame() override;
+  float GetPresentLatency() override;
   void ClearScreen(const EFBRectangle& rc, bool colorEnable, bool alphaEnable, bool zEnable, u32 color, u32 z) override;
 
   void ReinterpretPixelData(unsigned int convtype) override;
@@ -68,18 +70,37 @@ private:
     const XFBSourceBase* const* xfb_sources, u32 xfb_count, u32 fb_width,
     u32 fb_stride, u32 fb_height, u64 ticks);
 
+  // Frames are handed to the dump thread two frames late, so mapping them doesn't wait on the GPU.
+  static const size_t FRAME_DUMP_BUFFERED_FRAMES = 3;
+  struct FrameDumpImage
+  {
+    D3D::Texture2dPtr staging_texture;
+    u32 texture_width = 0;
+    u32 texture_height = 0;
+    u32 width = 0;
+    u32 height = 0;
+    AVIDump::Frame dump_state;
+    bool pending = false;
+    bool mapped = false;
+  };
+
   void PrepareFrameDumpRenderTexture(u32 width, u32 height);
-  void PrepareFrameDumpBuffer(u32 width, u32 height);
+  // Writes the oldest frame to the dump and returns the image to copy this one to.
+  FrameDumpImage* PrepareFrameDumpImage(u32 texture_width, u32 texture_height, u64 ticks);
+  void WriteFrameDumpImage(size_t index);
+  // Requires the dump thread to be done with the frames, see FinishFrameData.
+  void UnmapFrameDumpImages();
+  // Writes all pending frames, when dumping stops.
+  void FlushFrameDump();
   void Create3DVisionTexture(u32 width, u32 height);
   void SetupDeviceObjects();
 
   D3DTexture2D* m_frame_dump_render_texture = nullptr;
-  D3D::Texture2dPtr m_frame_dump_staging_texture;
+  std::array<FrameDumpImage, FRAME_DUMP_BUFFERED_FRAMES> m_frame_dump_images;
+  size_t m_current_frame_dump_image = FRAME_DUMP_BUFFERED_FRAMES - 1;
   D3DTexture2D* m_3d_vision_texture = nullptr;
   u32 m_frame_dump_render_texture_width = 0;
   u32 m_frame_dump_render_texture_height = 0;
-  u32 m_frame_dump_staging_texture_width = 0;
-  u32 m_frame_dump_staging_texture_height = 0;
   u32 m_3d_vision_texture_width = 0;
   u32 m_3d_vision_texture_height = 0;
   u32 m_last_multisamples = 0;
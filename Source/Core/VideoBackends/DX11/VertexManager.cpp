@@ -178,11 +178,13 @@ void VertexManager::vFlush(bool useDstAlpha)
   D3DVertexFormat* current_vertex_format = static_cast<D3DVertexFormat*>(VertexLoaderManager::GetCurrentVertexFormat());
   u32 stride = current_vertex_format->GetVertexStride();
   PrepareDrawBuffers(stride);
-  VertexShaderCache::SetActiveShader(current_vertex_format);
-  PixelShaderCache::SetActiveShader();
+  const bool vertex_uber = VertexShaderCache::SetActiveShader(current_vertex_format);
+  const bool pixel_uber = PixelShaderCache::SetActiveShader();
   g_renderer->ApplyState(useDstAlpha);
 
   Draw(stride);
+  if (vertex_uber || pixel_uber)
+    INCSTAT(stats.thisFrame.numUberShaderDraws);
 
   g_renderer->RestoreState();
 }
@@ -13,6 +13,7 @@
 #include "VideoCommon/HLSLCompiler.h"
 #include "VideoBackends/DX11/D3DState.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/ShaderUIDBundle.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexShaderGen.h"
 #include "VideoCommon/VertexShaderManager.h"
@@ -58,10 +59,22 @@ ID3D11InputLayout* VertexShaderCache::GetClearInputLayout()
 }
 
 D3D::ConstantStreamBuffer* vscbuf = nullptr;
+std::unique_ptr<D3D::ConstantRegionBuffer> s_vs_region_buffer;
 
 D3D::BufferDescriptor VertexShaderCache::GetConstantBuffer()
 {
   // TODO: divide the global variables of the generated shaders into about 5 constant buffers to speed this up
+  if (s_vs_region_buffer)
+  {
+    if (VertexShaderManager::IsDirty())
+    {
+      const u32 size = s_vs_region_buffer->UpdateRegions(VertexShaderManager::GetBuffer(),
+                                                          VertexShaderManager::GetDirtyRegions());
+      VertexShaderManager::Clear();
+      ADDSTAT(stats.thisFrame.bytesUniformStreamed, size);
+    }
+    return s_vs_region_buffer->GetDescriptor();
+  }
   if (VertexShaderManager::IsDirty())
   {
     const size_t size = sizeof(float) * VertexShaderManager::ConstantBufferSize;
@@ -142,9 +155,20 @@ void VertexShaderCache::Init()
   };
 
   bool use_partial_buffer_update = D3D::SupportPartialContantBufferUpdate();
-  u32 cbsize = VertexShaderManager::ConstantBufferSize * sizeof(float) * (use_partial_buffer_update ? 1024 : 1); // is always multiple of 16
-  vscbuf = new D3D::ConstantStreamBuffer(cbsize);
-  ID3D11Buffer* buf = vscbuf->GetBuffer();
+  u32 cbsize = VertexShaderManager::ConstantBufferSize * sizeof(float); // is always multiple of 16
+  ID3D11Buffer* buf;
+  if (use_partial_buffer_update)
+  {
+    // Most changes only touch a few matrices, patch those in place.
+    s_vs_region_buffer = std::make_unique<D3D::ConstantRegionBuffer>(cbsize);
+    buf = s_vs_region_buffer->GetBuffer();
+    VertexShaderManager::EnableDirtyRegions();
+  }
+  else
+  {
+    vscbuf = new D3D::ConstantStreamBuffer(cbsize);
+    buf = vscbuf->GetBuffer();
+  }
 
   CHECK(buf != nullptr, "Create vertex shader constant buffer (size=%u)", cbsize);
   D3D::SetDebugObjectName(buf, "vertex shader constant buffer used to emulate the GX pipeline");
@@ -210,6 +234,9 @@ void VertexShaderCache::LoadFromDisk()
     "Ishiiruka.vs",
     StringFromFormat("%s.vs", SConfig::GetInstance().GetGameID().c_str())
   );
+  ShaderUIDBundle::Bundle bundle;
+  if (ShaderUIDBundle::Load(SConfig::GetInstance().GetGameID(), &bundle))
+    ShaderUIDBundle::Import(bundle.vertex_shaders, s_vshaders);
   std::string cache_filename = GetDiskShaderCacheFileName(API_D3D11, "uvs", false, true);
   VertexUberShaderCacheInserter uinserter;
   g_vus_disk_cache.OpenAndRead(cache_filename, uinserter);
@@ -315,7 +342,9 @@ void VertexShaderCache::Shutdown()
   if (vscbuf != nullptr)
   {
     delete vscbuf;
+    vscbuf = nullptr;
   }
+  s_vs_region_buffer.reset();
 
   s_simple_vertex_shader.reset();
   s_clear_vertex_shader.reset();
@@ -399,7 +428,7 @@ void VertexShaderCache::CompileUberShader(const UberShader::VertexUberShaderUid&
 void VertexShaderCache::CompileVShader(const VertexShaderUid& uid, const ShaderHostConfig& hostconfig, bool forcecompile = false, std::function<void()> oncompilationfinished = {})
 {
   VSCacheEntry* entry = &s_vshaders->GetOrAdd(uid);
-  if (g_ActiveConfig.bDisableSpecializedShaders && !forcecompile)
+  if (g_ActiveConfig.UsingUberShadersOnly() && !forcecompile)
   {
     return;
   }
@@ -464,7 +493,7 @@ void VertexShaderCache::PrepareShader(
   &xfr,
   const BPMemory &bpm)
 {
-  if (g_ActiveConfig.bBackgroundShaderCompiling || g_ActiveConfig.bDisableSpecializedShaders)
+  if (g_ActiveConfig.UsingUberShaders())
   {
     auto uuid = UberShader::GetVertexUberShaderUid(components, xfr);
     if (!s_last_uber_entry || s_last_uber_uid != uuid)
@@ -485,10 +514,11 @@ void VertexShaderCache::PrepareShader(
   CompileVShader(uid, ShaderHostConfig::GetCurrent());
 }
 
-void VertexShaderCache::SetActiveShader(D3DVertexFormat* current_vertex_format)
+bool VertexShaderCache::SetActiveShader(D3DVertexFormat* current_vertex_format)
 {
   ID3D11VertexShader* shader = nullptr;
-  if (!g_ActiveConfig.bDisableSpecializedShaders && s_last_entry && s_last_entry->compiled)
+  bool uber = false;
+  if (!g_ActiveConfig.UsingUberShadersOnly() && s_last_entry && s_last_entry->compiled)
   {
     current_vertex_format->SetInputLayout(s_last_entry->bytecode);
     shader = s_last_entry->shader.get();
@@ -499,13 +529,15 @@ void VertexShaderCache::SetActiveShader(D3DVertexFormat* current_vertex_format)
       VertexLoaderManager::GetUberVertexFormat(current_vertex_format->GetVertexDeclaration()));
     uber_vertex_format->SetInputLayout(s_last_uber_entry->bytecode);
     shader = s_last_uber_entry->shader.get();
+    uber = true;
   }
   D3D::stateman->SetVertexShader(shader);
+  return uber;
 }
 
 bool VertexShaderCache::TestShader()
 {
-  if (g_ActiveConfig.bBackgroundShaderCompiling || g_ActiveConfig.bDisableSpecializedShaders)
+  if (g_ActiveConfig.UsingUberShaders())
   {
     return s_last_uber_entry && s_last_uber_entry->compiled;
   }
@@ -24,7 +24,8 @@ public:
     const XFMemory &xfr,
     const BPMemory &bpm);
   static bool TestShader();
-  static void SetActiveShader(D3DVertexFormat* current_vertex_format);
+  // Returns true if the ubershader was set.
+  static bool SetActiveShader(D3DVertexFormat* current_vertex_format);
   static D3D::BufferDescriptor GetConstantBuffer();
 
   static ID3D11VertexShader* GetSimpleVertexShader();
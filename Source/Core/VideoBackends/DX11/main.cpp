@@ -86,6 +86,7 @@ void VideoBackend::InitBackendInfo()
   g_Config.backend_info.bNeedBlendIndices = false;
   g_Config.backend_info.bSupportsOversizedViewports = false;
   g_Config.backend_info.bSupportsGeometryShaders = true;
+  g_Config.backend_info.bSupportsVSLayerOutput = false;
   g_Config.backend_info.bSupports3DVision = true;
   g_Config.backend_info.bSupportsPostProcessing = true;
   g_Config.backend_info.bSupportsClipControl = true;
@@ -100,6 +101,7 @@ void VideoBackend::InitBackendInfo()
   g_Config.backend_info.bSupportsDynamicSamplerIndexing = false;
   g_Config.backend_info.bSupportsUberShaders = true;
   g_Config.backend_info.bSupportsHighPrecisionFrameBuffer = true;
+  g_Config.backend_info.bSupportsPrimitiveRestart = false;
   g_Config.ClearFormats();
   IDXGIFactory* factory;
   IDXGIAdapter* ad;
@@ -110,6 +112,7 @@ void VideoBackend::InitBackendInfo()
   // adapters
   g_Config.backend_info.Adapters.clear();
   g_Config.backend_info.AAModes.clear();
+  g_Config.backend_info.VideoMemorySize = 0;
   while (factory->EnumAdapters((UINT)g_Config.backend_info.Adapters.size(), &ad) !=
          DXGI_ERROR_NOT_FOUND)
   {
@@ -143,6 +146,7 @@ void VideoBackend::InitBackendInfo()
       g_Config.backend_info.bSupportsComputeTextureEncoding = shader_model_5_supported;
       g_Config.backend_info.MaxTextureSize =
           DX11::D3D::GetMaxTextureSize(DX11::D3D::GetFeatureLevel(ad));
+      g_Config.backend_info.VideoMemorySize = desc.DedicatedVideoMemory;
     }
 
     g_Config.backend_info.Adapters.push_back(UTF16ToUTF8(desc.Description));
@@ -4,6 +4,8 @@
 
 #include <string>
 
+#include "Common/TraceEvents.h"
+
 #include "VideoBackends/DX9/D3DShader.h"
 
 #include "VideoCommon/VideoConfig.h"
@@ -35,6 +37,7 @@ enum ShaderType
 // code->bytecode.
 bool CompileShader(const char *code, u32 len, u8 **bytecode, u32 *bytecodelen, ShaderType shader_type, const D3D_SHADER_MACRO* macros)
 {
+  TRACE_SCOPE("CompileShader");
   ID3DBlob* shaderBuffer = NULL;
   ID3DBlob* errorBuffer = NULL;
 
@@ -138,6 +138,11 @@ void PerfQuery::FlushResults()
     FlushOne();
 }
 
+void PerfQuery::PollResults()
+{
+  WeakFlush();
+}
+
 void PerfQuery::WeakFlush()
 {
   if (!ShouldEmulate())
@@ -18,6 +18,7 @@ public:
   void ResetQuery();
   u32 GetQueryResult(PerfQueryType type);
   void FlushResults();
+  void PollResults();
   bool IsFlushed() const;
   void CreateDeviceObjects();
   void DestroyDeviceObjects();
@@ -76,6 +76,7 @@ void VideoBackend::InitBackendInfo()
   const int maxConstants = (shaderModel < 3) ? 32 : ((shaderModel < 4) ? 224 : 65536);
   g_Config.backend_info.APIType = shaderModel < 3 ? API_D3D9_SM20 : API_D3D9_SM30;
   g_Config.backend_info.MaxTextureSize = static_cast<u32>(device_caps.MaxTextureWidth);
+  g_Config.backend_info.VideoMemorySize = 0;
   g_Config.backend_info.bSupportsExclusiveFullscreen = false;
   g_Config.backend_info.bSupportsSeparateAlphaFunction = (device_caps.PrimitiveMiscCaps & D3DPMISCCAPS_SEPARATEALPHABLEND) == D3DPMISCCAPS_SEPARATEALPHABLEND;
   // Dual source blend disabled by default until a proper method to test for support is found	
@@ -88,6 +89,7 @@ void VideoBackend::InitBackendInfo()
   g_Config.backend_info.bSupportsOversizedViewports = false;
   g_Config.backend_info.bSupportsBBox = false;
   g_Config.backend_info.bSupportsGeometryShaders = false;
+  g_Config.backend_info.bSupportsVSLayerOutput = false;
   g_Config.backend_info.bSupports3DVision = false;
   g_Config.backend_info.bSupportsPostProcessing = false;
   g_Config.backend_info.bSupportsClipControl = true;
@@ -107,6 +109,7 @@ void VideoBackend::InitBackendInfo()
   g_Config.backend_info.bSupportsBitfield = false;
   g_Config.backend_info.bSupportsUberShaders = false;
   g_Config.backend_info.bSupportsHighPrecisionFrameBuffer = false;
+  g_Config.backend_info.bSupportsPrimitiveRestart = false;
   g_Config.ClearFormats();
   // adapters
   g_Config.backend_info.Adapters.clear();
@@ -19,6 +19,11 @@ alignas(128) static s32 s_values[4];
 static bool s_cpu_dirty;
 static bool s_gpu_dirty;
 
+// Latency tolerant mode, see VideoConfig::bBBoxLatencyTolerant.
+static BoundingBox::ReadbackRing s_readback_ring;
+static std::array<GLuint, BoundingBox::ReadbackRing::NUM_SLOTS> s_readback_buffer_ids;
+static std::array<GLsync, BoundingBox::ReadbackRing::NUM_SLOTS> s_readback_fences;
+
 namespace OGL
 {
 
@@ -31,6 +36,17 @@ void BBox::Init()
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_bbox_buffer_id);
     glBufferData(GL_SHADER_STORAGE_BUFFER, 4 * sizeof(s32), s_values, GL_DYNAMIC_DRAW);
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, s_bbox_buffer_id);
+
+    glGenBuffers(static_cast<GLsizei>(s_readback_buffer_ids.size()), s_readback_buffer_ids.data());
+    for (GLuint buffer_id : s_readback_buffer_ids)
+    {
+      glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_id);
+      glBufferData(GL_COPY_WRITE_BUFFER, 4 * sizeof(s32), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    s_readback_fences.fill(nullptr);
+    s_readback_ring = {};
+
     s_cpu_dirty = true;
     s_gpu_dirty = true;
   }
@@ -39,7 +55,17 @@ void BBox::Init()
 void BBox::Shutdown()
 {
   if (g_ActiveConfig.backend_info.bSupportsBBox)
+  {
     glDeleteBuffers(1, &s_bbox_buffer_id);
+    glDeleteBuffers(static_cast<GLsizei>(s_readback_buffer_ids.size()),
+                    s_readback_buffer_ids.data());
+    for (GLsync& fence : s_readback_fences)
+    {
+      if (fence)
+        glDeleteSync(fence);
+      fence = nullptr;
+    }
+  }
 }
 
 void BBox::Update()
@@ -63,11 +89,45 @@ void BBox::Set(s32 index, s32 value)
   {
     s_values[index] = value;
     s_cpu_dirty = true;
+    s_readback_ring.Invalidate();
   }
 }
 
+static s32 GetLatencyTolerant(s32 index)
+{
+  // Values the CPU wrote are still to be uploaded, a copy now would read the old ones.
+  if (s_gpu_dirty && !s_cpu_dirty && g_ActiveConfig.iBBoxMode == BBoxGPU)
+  {
+    const u32 slot = s_readback_ring.Begin();
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_COPY_READ_BUFFER, s_bbox_buffer_id);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, s_readback_buffer_ids[slot]);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, 4 * sizeof(s32));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (s_readback_fences[slot])
+      glDeleteSync(s_readback_fences[slot]);
+    s_readback_fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    s_gpu_dirty = false;
+  }
+  s_readback_ring.Poll(
+      [](u32 slot) {
+        GLenum result = glClientWaitSync(s_readback_fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        return result != GL_TIMEOUT_EXPIRED;
+      },
+      [](u32 slot) {
+        glBindBuffer(GL_COPY_READ_BUFFER, s_readback_buffer_ids[slot]);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, 4 * sizeof(s32), s_values);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+      });
+  return s_values[index];
+}
+
 s32 BBox::Get(s32 index)
 {
+  if (g_ActiveConfig.bBBoxLatencyTolerant)
+    return GetLatencyTolerant(index);
+
   if (s_gpu_dirty && g_ActiveConfig.iBBoxMode == BBoxGPU)
   {
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_bbox_buffer_id);
@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
 #include "Common/GL/GLInterfaceBase.h"
@@ -217,6 +219,29 @@ GLuint OGLTexture::GetFramebuffer() const
   return m_framebuffer;
 }
 
+void OGLTexture::BindStages(const std::array<const OGLTexture*, 9>& textures)
+{
+  std::array<GLuint, 9> names;
+  u32 first = static_cast<u32>(names.size());
+  u32 last = 0;
+  for (u32 i = 0; i < names.size(); i++)
+  {
+    names[i] = textures[i] ? textures[i]->m_texId : s_Textures[i];
+    if (names[i] != s_Textures[i])
+    {
+      first = std::min(first, i);
+      last = i;
+    }
+  }
+  if (first == names.size())
+    return;
+
+  // Unlike glBindTexture this takes the target from the texture itself and leaves the active
+  // texture unit alone.
+  glBindTextures(first, last - first + 1, &names[first]);
+  std::copy(names.begin() + first, names.begin() + last + 1, s_Textures.begin() + first);
+}
+
 void OGLTexture::Bind(u32 stage)
 {
   if (s_Textures[stage] != m_texId || !g_ActiveConfig.backend_info.bSupportsBindingLayout)
@@ -4,6 +4,8 @@
 // Refer to the license.txt file included.
 
 #pragma once
+#include <array>
+
 #include "Common/CommonTypes.h"
 #include "Common/GL/GLUtil.h"
 
@@ -29,6 +31,9 @@ public:
   GLuint GetFramebuffer() const;
   uintptr_t GetInternalObject() const override { return static_cast<uintptr_t>(m_texId); };
   static void DisableStage(u32 stage);
+  // Binds the textures of stages 0-8 with a single glBindTextures call, only covering the stages
+  // that changed. Stages without a texture keep their binding. Needs GL_ARB_multi_bind.
+  static void BindStages(const std::array<const OGLTexture*, 9>& textures);
   static void SetStage();
 
 private:
@@ -130,6 +130,11 @@ void PerfQueryGL::DisableQuery(PerfQueryGroup type)
   }
 }
 
+void PerfQueryGL::PollResults()
+{
+  WeakFlush();
+}
+
 void PerfQueryGL::WeakFlush()
 {
   while (!IsFlushed())
@@ -223,6 +228,11 @@ void PerfQueryGLESNV::DisableQuery(PerfQueryGroup type)
   }
 }
 
+void PerfQueryGLESNV::PollResults()
+{
+  WeakFlush();
+}
+
 void PerfQueryGLESNV::WeakFlush()
 {
   while (!IsFlushed())
@@ -58,6 +58,7 @@ public:
   void EnableQuery(PerfQueryGroup type) override;
   void DisableQuery(PerfQueryGroup type) override;
   void FlushResults() override;
+  void PollResults() override;
 
 private:
 
@@ -77,6 +78,7 @@ public:
   void EnableQuery(PerfQueryGroup type) override;
   void DisableQuery(PerfQueryGroup type) override;
   void FlushResults() override;
+  void PollResults() override;
 
 private:
 
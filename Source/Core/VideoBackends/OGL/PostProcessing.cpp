@@ -279,6 +279,10 @@ void OGLPostProcessingShader::Draw(PostProcessor* p,
     if (!pass.enabled)
       continue;
 
+    // Static passes keep their output while the source is the same
+    if (pass.IsOutputCached(src_rect, src_size, src_layer, gamma))
+      continue;
+
     if (!(is_last_pass && skip_final_copy))
     {
       // Force output build
@@ -384,6 +388,7 @@ void OGLPostProcessingShader::Draw(PostProcessor* p,
     {
       m_passes[passidx].ClenaupOutput();
     }
+    m_passes[pass_index].SetOutputCached(src_rect, src_size, src_layer, gamma);
   }
 
   // Unbind input textures after rendering, so that they can safely be used as outputs again.
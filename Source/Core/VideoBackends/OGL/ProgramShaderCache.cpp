@@ -2,12 +2,16 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <string>
+#include <vector>
 
 #include "Common/Align.h"
 #include "Common/Common.h"
+#include "Common/GL/GLExtensions/GLExtensions.h"
 #include "Common/MathUtil.h"
 #include "Common/StringUtil.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/Host.h"
 #include "Core/ConfigManager.h"
@@ -23,6 +27,8 @@
 #include "VideoCommon/ImageWrite.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/ShaderSourceCache.h"
+#include "VideoCommon/ShaderUIDBundle.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexShaderManager.h"
 
@@ -44,6 +50,20 @@ static LinearDiskCache<SHADERUID, u8> g_program_disk_cache;
 static LinearDiskCache<UBERSHADERUID, u8> g_uber_program_disk_cache;
 static GLuint CurrentProgram = 0;
 
+// Only filled while CompileShaders() works through the usage profile.
+static ShaderSourceCache<VertexShaderUid> s_vertex_sources(
+    [](ShaderCode& code, const VertexShaderUid& uid, const ShaderHostConfig& hostconfig) {
+      GenerateVertexShaderCode(code, uid.GetUidData(), hostconfig);
+    });
+static ShaderSourceCache<PixelShaderUid> s_pixel_sources(
+    [](ShaderCode& code, const PixelShaderUid& uid, const ShaderHostConfig& hostconfig) {
+      GeneratePixelShaderCode(code, uid.GetUidData(), hostconfig);
+    });
+static ShaderSourceCache<GeometryShaderUid> s_geometry_sources(
+    [](ShaderCode& code, const GeometryShaderUid& uid, const ShaderHostConfig& hostconfig) {
+      GenerateGeometryShaderCode(code, uid.GetUidData(), hostconfig);
+    });
+
 ProgramShaderCache::PCache* ProgramShaderCache::pshaders;
 ProgramShaderCache::UberPCache ProgramShaderCache::pushaders;
 
@@ -58,6 +78,12 @@ std::mutex ProgramShaderCache::s_mutex;
 std::queue<std::unique_ptr<ProgramShaderCache::QueueEntry>> ProgramShaderCache::s_compilation_queue;
 std::thread ProgramShaderCache::s_thread;
 
+// Programs handed to the driver's compiler threads at once, and how often they are polled
+static constexpr size_t MAX_PENDING_PROGRAMS = 64;
+static constexpr std::chrono::milliseconds PENDING_PROGRAM_POLL_INTERVAL{1};
+// Programs loaded from the disk cache whose link status wasn't checked yet
+static std::vector<SHADER*> s_loaded_binaries;
+
 static char s_glsl_header[4096] = "";
 
 static std::string GetGLSLVersionString()
@@ -237,11 +263,11 @@ std::future<bool> ProgramShaderCache::CompileShader(const SHADERUID& uid, SHADER
   ShaderCode pcode;
   ShaderCode gcode;
   const ShaderHostConfig& hostconfig = ShaderHostConfig::GetCurrent();
-  GenerateVertexShaderCode(vcode, uid.vuid.GetUidData(), hostconfig);
-  GeneratePixelShaderCode(pcode, uid.puid.GetUidData(), hostconfig);
+  s_vertex_sources.Get(uid.vuid, hostconfig, vcode);
+  s_pixel_sources.Get(uid.puid, hostconfig, pcode);
   bool use_geometry = g_ActiveConfig.backend_info.bSupportsGeometryShaders && !uid.guid.GetUidData().IsPassthrough();
   if (use_geometry)
-    GenerateGeometryShaderCode(gcode, uid.guid.GetUidData(), hostconfig);
+    s_geometry_sources.Get(uid.guid, hostconfig, gcode);
 
   INCSTAT(stats.numPixelShadersCreated);
   SETSTAT(stats.numPixelShadersAlive, static_cast<int>(pshaders->size()));
@@ -298,6 +324,7 @@ SHADER* ProgramShaderCache::SetShader(PIXEL_SHADER_RENDER_MODE render_mode, u32
   {
     // Shader wasn't already set
     last_entry[render_mode] = &pshaders->GetOrAdd(uid);
+    last_entry[render_mode]->shader.vertex_stereo = uid.vuid.GetUidData().vertex_stereo != 0;
     last_uid[render_mode] = uid;
   }
   PCacheEntry* entry = last_entry[render_mode];
@@ -386,41 +413,54 @@ std::future<bool> ProgramShaderCache::CompileShader(
 bool ProgramShaderCache::CompileShaderWorker(
     SHADER& shader, const char* vcode, const char* pcode, const char* gcode)
 {
-  GLuint vsid = CompileSingleShader(GL_VERTEX_SHADER, vcode);
-  GLuint psid = CompileSingleShader(GL_FRAGMENT_SHADER, pcode);
+  GLuint shader_ids[3];
+  const GLuint pid = StartProgram(vcode, pcode, gcode, shader_ids);
+  return FinishProgram(shader, pid, shader_ids, vcode, pcode, gcode);
+}
 
+GLuint ProgramShaderCache::StartProgram(const char* vcode, const char* pcode, const char* gcode,
+                                        GLuint* shader_ids)
+{
+  shader_ids[0] = StartSingleShader(GL_VERTEX_SHADER, vcode);
+  shader_ids[1] = StartSingleShader(GL_FRAGMENT_SHADER, pcode);
   // Optional geometry shader
-  GLuint gsid = 0;
-  if (gcode)
-    gsid = CompileSingleShader(GL_GEOMETRY_SHADER, gcode);
-
-  if (!vsid || !psid || (gcode && !gsid))
-  {
-    glDeleteShader(vsid);
-    glDeleteShader(psid);
-    glDeleteShader(gsid);
-    return false;
-  }
+  shader_ids[2] = gcode ? StartSingleShader(GL_GEOMETRY_SHADER, gcode) : 0;
 
   GLuint pid = glCreateProgram();
 
-  glAttachShader(pid, vsid);
-  glAttachShader(pid, psid);
-  if (gsid)
-    glAttachShader(pid, gsid);
+  glAttachShader(pid, shader_ids[0]);
+  glAttachShader(pid, shader_ids[1]);
+  if (shader_ids[2])
+    glAttachShader(pid, shader_ids[2]);
 
   if (g_ogl_config.bSupportsGLSLCache)
     glProgramParameteri(pid, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
   SetProgramBindings(pid, false);
 
+  // Linking a program with a broken shader fails as well, FinishProgram reports the shader.
   glLinkProgram(pid);
+  return pid;
+}
+
+bool ProgramShaderCache::FinishProgram(SHADER& shader, GLuint pid, const GLuint* shader_ids,
+                                       const char* vcode, const char* pcode, const char* gcode)
+{
+  GLuint vsid = CheckSingleShader(shader_ids[0], GL_VERTEX_SHADER, vcode);
+  GLuint psid = CheckSingleShader(shader_ids[1], GL_FRAGMENT_SHADER, pcode);
+  GLuint gsid = gcode ? CheckSingleShader(shader_ids[2], GL_GEOMETRY_SHADER, gcode) : 0;
 
   // original shaders aren't needed any more
   glDeleteShader(vsid);
   glDeleteShader(psid);
   glDeleteShader(gsid);
 
+  if (!vsid || !psid || (gcode && !gsid))
+  {
+    glDeleteProgram(pid);
+    return false;
+  }
+
   GLint linkStatus;
   glGetProgramiv(pid, GL_LINK_STATUS, &linkStatus);
   GLsizei length = 0;
@@ -554,12 +594,23 @@ bool ProgramShaderCache::CompileComputeShaderWorker(SHADER& shader, const std::s
 
 GLuint ProgramShaderCache::CompileSingleShader(GLuint type, const char* code)
 {
+  return CheckSingleShader(StartSingleShader(type, code), type, code);
+}
+
+GLuint ProgramShaderCache::StartSingleShader(GLuint type, const char* code)
+{
+  TRACE_SCOPE("CompileShader");
   GLuint result = glCreateShader(type);
   std::vector<const char*> src(2);
   src[0] = s_glsl_header;
   src[1] = code;
   glShaderSource(result, 2, src.data(), nullptr);
   glCompileShader(result);
+  return result;
+}
+
+GLuint ProgramShaderCache::CheckSingleShader(GLuint result, GLuint type, const char* code)
+{
   GLint compileStatus;
   glGetShaderiv(result, GL_COMPILE_STATUS, &compileStatus);
   GLsizei length = 0;
@@ -629,44 +680,105 @@ void ProgramShaderCache::CompileThreadWorker(std::unique_ptr<cInterfaceBase> sha
         g_ogl_config.gl_vendor, g_ogl_config.gl_renderer, g_ogl_config.gl_version);
   }
 
+  // With parallel shader compilation, every queued program is handed to the driver's compiler
+  // threads right away and picked up once it is done, instead of one being built at a time.
+  const bool parallel = g_ogl_config.bSupportsParallelShaderCompile;
+  if (parallel)
+    glMaxShaderCompilerThreads(0xFFFFFFFF);
+  std::vector<PendingProgram> pending;
+
   std::unique_ptr<QueueEntry> entry;
   while(true)
   {
+    entry.reset();
+    if (pending.size() >= MAX_PENDING_PROGRAMS)
+    {
+      std::this_thread::sleep_for(PENDING_PROGRAM_POLL_INTERVAL);
+    }
+    else
     {
       std::unique_lock<std::mutex> lock(s_mutex);
-      if (s_compilation_queue.empty())
+      const auto has_work = [] { return !s_compilation_queue.empty(); };
+      if (pending.empty())
+        s_condition_var.wait(lock, has_work);
+      else
+        s_condition_var.wait_for(lock, PENDING_PROGRAM_POLL_INTERVAL, has_work);
+      if (!s_compilation_queue.empty())
       {
-        s_condition_var.wait(lock, []{return !s_compilation_queue.empty();});
+        entry = std::move(s_compilation_queue.front());
+        s_compilation_queue.pop();
       }
-      entry = std::move(s_compilation_queue.front());
-      s_compilation_queue.pop();
     }
-    if (entry->kill_thread)
+    if (entry && entry->kill_thread)
     {
       break;
     }
-    bool success;
-    if (entry->compute_shader)
+    if (entry && entry->compute_shader)
     {
-      success = CompileComputeShaderWorker(*entry->shader, entry->ccode);
+      entry->promise.set_value(CompileComputeShaderWorker(*entry->shader, entry->ccode));
     }
-    else
+    else if (entry)
     {
       const char* gcode = entry->gcode.empty() ? nullptr : entry->gcode.c_str();
-      success =
-          CompileShaderWorker(*entry->shader, entry->vcode.c_str(), entry->pcode.c_str(), gcode);
+      if (parallel)
+      {
+        PendingProgram program;
+        program.pid =
+            StartProgram(entry->vcode.c_str(), entry->pcode.c_str(), gcode, program.shader_ids);
+        program.entry = std::move(entry);
+        pending.push_back(std::move(program));
+      }
+      else
+      {
+        entry->promise.set_value(CompileShaderWorker(*entry->shader, entry->vcode.c_str(),
+                                                     entry->pcode.c_str(), gcode));
+      }
     }
-    entry->promise.set_value(success);
+    FinishPendingPrograms(&pending, false);
   }
+  FinishPendingPrograms(&pending, true);
   shared_context->Shutdown();
   entry->promise.set_value(true);
 }
 
+void ProgramShaderCache::FinishPendingPrograms(std::vector<PendingProgram>* pending, bool wait)
+{
+  for (auto iter = pending->begin(); iter != pending->end();)
+  {
+    GLint completed = GL_TRUE;
+    if (!wait)
+      glGetProgramiv(iter->pid, GL_COMPLETION_STATUS, &completed);
+    if (completed != GL_TRUE)
+    {
+      ++iter;
+      continue;
+    }
+    QueueEntry& entry = *iter->entry;
+    const char* gcode = entry.gcode.empty() ? nullptr : entry.gcode.c_str();
+    entry.promise.set_value(FinishProgram(*entry.shader, iter->pid, iter->shader_ids,
+                                          entry.vcode.c_str(), entry.pcode.c_str(), gcode));
+    iter = pending->erase(iter);
+  }
+}
+
 void ProgramShaderCache::GetShaderId(SHADERUID* uid, PIXEL_SHADER_RENDER_MODE render_mode, u32 components, PrimitiveType primitive_type)
 {
   GetPixelShaderUID(uid->puid, render_mode, components, xfmem, bpmem);
   GetVertexShaderUID(uid->vuid, components, xfmem, bpmem);
   GetGeometryShaderUid(uid->guid, primitive_type, xfmem, components);
+  // Stereo triangles can be drawn twice as instances that pick their layer in the vertex shader,
+  // which removes the geometry shader from the common case.
+  if (g_ActiveConfig.iStereoMode > 0 && g_ActiveConfig.backend_info.bSupportsVSLayerOutput &&
+      primitive_type == PrimitiveType::Triangles && !g_ActiveConfig.bWireFrame &&
+      !g_ActiveConfig.TessellationEnabled())
+  {
+    uid->vuid.GetUidData<vertex_shader_uid_data>().vertex_stereo = 1;
+    uid->vuid.ClearHASH();
+    uid->vuid.CalculateUIDHash();
+    uid->guid.GetUidData<geometry_shader_uid_data>().vertex_stereo = 1;
+    uid->guid.ClearHASH();
+    uid->guid.CalculateUIDHash();
+  }
   uid->CalculateHash();
 }
 
@@ -758,6 +870,20 @@ void ProgramShaderCache::LoadFromDisk()
     "Ishiiruka.ps.OGL",
     StringFromFormat("%s.ps.OGL", SConfig::GetInstance().GetGameID().c_str())
   );
+  ShaderUIDBundle::Bundle bundle;
+  if (ShaderUIDBundle::Load(SConfig::GetInstance().GetGameID(), &bundle))
+  {
+    // Only bundles exported from an OpenGL profile know which shaders form a program.
+    for (size_t i = 0; i < bundle.programs.size(); i++)
+    {
+      SHADERUID uid;
+      uid.vuid = bundle.vertex_shaders[bundle.programs[i].vertex_shader];
+      uid.puid = bundle.pixel_shaders[bundle.programs[i].pixel_shader];
+      uid.guid = bundle.geometry_shaders[bundle.programs[i].geometry_shader];
+      uid.CalculateHash();
+      pshaders->Import(uid, bundle.programs.size() - i);
+    }
+  }
 
   // Read our shader cache, only if supported
   if (g_ogl_config.bSupportsGLSLCache)
@@ -781,6 +907,7 @@ void ProgramShaderCache::LoadFromDisk()
         ProgramUberShaderCacheInserter uinserter;
         g_uber_program_disk_cache.OpenAndRead(cache_filename, uinserter);
       }
+      CheckLoadedBinaries();
 
     }
     SETSTAT(stats.numPixelShadersAlive, pshaders->size());
@@ -847,7 +974,7 @@ void ProgramShaderCache::CompileUberShaders()
 void ProgramShaderCache::CompileShaders()
 {
   pKey_t gameid = (pKey_t)GetMurmurHash3(reinterpret_cast<const u8*>(SConfig::GetInstance().GetGameID().data()), (u32)SConfig::GetInstance().GetGameID().size(), 0);
-  size_t shader_count = 0;
+  std::vector<SHADERUID> programs;
   pshaders->ForEachMostUsedByCategory(gameid,
     [&](const SHADERUID& it, size_t total)
   {
@@ -860,18 +987,11 @@ void ProgramShaderCache::CompileShaders()
     item.guid.CalculateUIDHash();
     item.CalculateHash();
     const pixel_shader_uid_data& uid_data = item.puid.GetUidData();
-    shader_count++;
-    if (!uid_data.bounding_box || g_ActiveConfig.backend_info.bSupportsBBox)
+    if ((!uid_data.bounding_box || g_ActiveConfig.backend_info.bSupportsBBox) &&
+        (!item.vuid.GetUidData().vertex_stereo ||
+         g_ActiveConfig.backend_info.bSupportsVSLayerOutput))
     {
-      Host_UpdateProgressDialog(GetStringT("Compiling Shaders...").c_str(),
-        static_cast<int>(shader_count), static_cast<int>(total));
-
-      PCacheEntry& newentry = pshaders->GetOrAdd(item);
-      if (newentry.compile_started)
-        return;
-      newentry.in_cache = false;
-      newentry.compile_started = true;
-      CompileShader(item, newentry.shader).wait();
+      programs.push_back(item);
     }
   },
     [](PCacheEntry& entry)
@@ -879,6 +999,42 @@ void ProgramShaderCache::CompileShaders()
     return !entry.shader.glprogid;
   }
   , true);
+  if (programs.empty())
+    return;
+
+  // Programs share most of their stages, generate each source once and on all cores.
+  // The GL thread is left with the compiles.
+  Host_UpdateProgressDialog(GetStringT("Generating Shaders...").c_str(), 0, static_cast<int>(programs.size()));
+  std::vector<VertexShaderUid> vertex_shaders;
+  std::vector<PixelShaderUid> pixel_shaders;
+  std::vector<GeometryShaderUid> geometry_shaders;
+  for (const SHADERUID& item : programs)
+  {
+    vertex_shaders.push_back(item.vuid);
+    pixel_shaders.push_back(item.puid);
+    if (g_ActiveConfig.backend_info.bSupportsGeometryShaders && !item.guid.GetUidData().IsPassthrough())
+      geometry_shaders.push_back(item.guid);
+  }
+  const ShaderHostConfig& hostconfig = ShaderHostConfig::GetCurrent();
+  s_vertex_sources.Prefetch(vertex_shaders, hostconfig);
+  s_pixel_sources.Prefetch(pixel_shaders, hostconfig);
+  s_geometry_sources.Prefetch(geometry_shaders, hostconfig);
+
+  for (size_t i = 0; i < programs.size(); i++)
+  {
+    Host_UpdateProgressDialog(GetStringT("Compiling Shaders...").c_str(),
+      static_cast<int>(i + 1), static_cast<int>(programs.size()));
+
+    PCacheEntry& newentry = pshaders->GetOrAdd(programs[i]);
+    if (newentry.compile_started)
+      continue;
+    newentry.in_cache = false;
+    newentry.compile_started = true;
+    CompileShader(programs[i], newentry.shader).wait();
+  }
+  s_vertex_sources.Clear();
+  s_pixel_sources.Clear();
+  s_geometry_sources.Clear();
   Host_UpdateProgressDialog("", -1, -1);
 }
 
@@ -1066,6 +1222,7 @@ void ProgramShaderCache::CreateHeader()
     "%s\n" // ES texture buffer
     "%s\n" // ES dual source blend
     "%s\n"  // shader image load store
+    "%s\n"  // vertex shader layer output
 
     // Precision defines for GLSL ES
     "%s\n"
@@ -1137,6 +1294,10 @@ void ProgramShaderCache::CreateHeader()
     ((!is_glsles && v < GLSL_430) || (is_glsles && v < GLSLES_310)) ?
     "#extension GL_ARB_shader_image_load_store : enable" :
     ""
+    , !g_ActiveConfig.backend_info.bSupportsVSLayerOutput ? "" :
+    GLExtensions::Supports("GL_ARB_shader_viewport_layer_array") ?
+    "#extension GL_ARB_shader_viewport_layer_array : enable" :
+    "#extension GL_AMD_vertex_shader_layer : enable"
     , is_glsles ? "precision highp float;" : ""
     , is_glsles ? "precision highp int;" : ""
     , is_glsles ? "precision highp sampler2DArray;" : ""
@@ -1177,12 +1338,42 @@ bool ProgramShaderCache::ShouldPrecompileUberShaders()
 
 bool ProgramShaderCache::UsingExclusiveUberShaders()
 {
-  return g_ActiveConfig.backend_info.bSupportsUberShaders && g_ActiveConfig.bDisableSpecializedShaders;
+  return g_ActiveConfig.UsingUberShadersOnly();
 }
 
 bool ProgramShaderCache::UsingHybridUberShaders()
 {
-  return g_ActiveConfig.backend_info.bSupportsUberShaders && g_ActiveConfig.bBackgroundShaderCompiling;
+  return g_ActiveConfig.UsingHybridUberShaders();
+}
+
+bool ProgramShaderCache::IsUberShader(const SHADER* shader)
+{
+  return last_uber_entry && shader == &last_uber_entry->shader;
+}
+
+// The status of the loaded binaries is only asked for after all of them were handed to the driver.
+// With parallel shader compilation, it loads them on its compiler threads in the meantime.
+void ProgramShaderCache::CheckLoadedBinaries()
+{
+  for (SHADER* shader : s_loaded_binaries)
+  {
+    // Already dropped, when a key was in the file twice
+    if (!shader->glprogid)
+      continue;
+    GLint success = GL_FALSE;
+    glGetProgramiv(shader->glprogid, GL_LINK_STATUS, &success);
+
+    if (success)
+    {
+      shader->SetProgramVariables();
+    }
+    else
+    {
+      glDeleteProgram(shader->glprogid);
+      shader->glprogid = 0;
+    }
+  }
+  s_loaded_binaries.clear();
 }
 
 void ProgramShaderCache::ProgramShaderCacheInserter::Read(const SHADERUID& key, const u8* value, u32 value_size)
@@ -1196,19 +1387,7 @@ void ProgramShaderCache::ProgramShaderCacheInserter::Read(const SHADERUID& key,
   entry.compile_started = true;
   entry.shader.glprogid = glCreateProgram();
   glProgramBinary(entry.shader.glprogid, *prog_format, binary, binary_size);
-
-  GLint success;
-  glGetProgramiv(entry.shader.glprogid, GL_LINK_STATUS, &success);
-
-  if (success)
-  {
-    entry.shader.SetProgramVariables();
-  }
-  else
-  {
-    glDeleteProgram(entry.shader.glprogid);
-    entry.shader.glprogid = 0;
-  }
+  s_loaded_binaries.push_back(&entry.shader);
 }
 
 void ProgramShaderCache::ProgramUberShaderCacheInserter::Read(const UBERSHADERUID& key, const u8* value, u32 value_size)
@@ -1222,19 +1401,7 @@ void ProgramShaderCache::ProgramUberShaderCacheInserter::Read(const UBERSHADERUI
   entry.compile_started = true;
   entry.shader.glprogid = glCreateProgram();
   glProgramBinary(entry.shader.glprogid, *prog_format, binary, binary_size);
-
-  GLint success;
-  glGetProgramiv(entry.shader.glprogid, GL_LINK_STATUS, &success);
-
-  if (success)
-  {
-    entry.shader.SetProgramVariables();
-  }
-  else
-  {
-    glDeleteProgram(entry.shader.glprogid);
-    entry.shader.glprogid = 0;
-  }
+  s_loaded_binaries.push_back(&entry.shader);
 }
 
 
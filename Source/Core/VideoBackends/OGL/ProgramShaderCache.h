@@ -12,6 +12,7 @@
 #include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #include "Common/GL/GLInterfaceBase.h"
 #include "Common/GL/GLUtil.h"
@@ -112,6 +113,7 @@ struct SHADER
   }
   GLuint glprogid = 0; // OpenGL program id
   bool initialized = false;
+  bool vertex_stereo = false; // Must be drawn with one instance per eye
   void SetProgramVariables();
   void Bind();
 };
@@ -123,6 +125,8 @@ public:
 
   static GLuint GetCurrentProgram();
   static SHADER* SetShader(PIXEL_SHADER_RENDER_MODE render_mode, u32 components, PrimitiveType primitive_type, const GLVertexFormat* vertex_format);
+  // True if shader was returned by SetShader in place of a specialized program.
+  static bool IsUberShader(const SHADER* shader);
   static SHADER* SetUberShader(PrimitiveType primitive_type, u32 components, const GLVertexFormat* vertex_format);
   static void BindVertexFormat(const GLVertexFormat* vertex_format);
   static void InvalidateVertexFormat();
@@ -179,6 +183,14 @@ private:
     bool kill_thread = false;
   };
 
+  // A program whose compiles and link run on the driver's compiler threads
+  struct PendingProgram
+  {
+    std::unique_ptr<QueueEntry> entry;
+    GLuint pid;
+    GLuint shader_ids[3];
+  };
+
   typedef ObjectUsageProfiler<SHADERUID, pKey_t, PCacheEntry, SHADERUID::ShaderUidHasher> PCache;
   typedef std::unordered_map<UBERSHADERUID, PCacheEntry, UBERSHADERUID::ShaderUidHasher> UberPCache;
 
@@ -186,6 +198,16 @@ private:
   static void CompileShaders();
   static bool CompileShaderWorker(
       SHADER& shader, const char* vcode, const char* pcode, const char* gcode);
+  // CompileShaderWorker split in two. StartProgram only issues the compiles and the link, with
+  // parallel shader compilation the driver works on them until FinishProgram reads the results.
+  static GLuint StartProgram(const char* vcode, const char* pcode, const char* gcode,
+                             GLuint* shader_ids);
+  static bool FinishProgram(SHADER& shader, GLuint pid, const GLuint* shader_ids,
+                            const char* vcode, const char* pcode, const char* gcode);
+  static void FinishPendingPrograms(std::vector<PendingProgram>* pending, bool wait);
+  static GLuint StartSingleShader(GLuint type, const char* code);
+  static GLuint CheckSingleShader(GLuint result, GLuint type, const char* code);
+  static void CheckLoadedBinaries();
   static bool CompileComputeShaderWorker(SHADER& shader, const std::string& code);
   static void CompileThreadWorker(std::unique_ptr<cInterfaceBase> shared_context);
   static void CompileUberShaders();
@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <cstddef>
+#include <cstring>
 #include <vector>
 
 #include "Common/Common.h"
@@ -117,21 +119,23 @@ static const u8 rasters[CHARACTER_COUNT][CHARACTER_HEIGHT] = {
   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x8f, 0xf1, 0x60, 0x00, 0x00, 0x00 } };
 
 static const char* s_vertexShaderSrc = "uniform vec2 charSize;\n"
-"uniform vec2 offset;"
 "in vec2 rawpos;\n"
 "in vec2 rawtex0;\n"
+"in vec4 rawcolor0;\n"
 "out vec2 uv0;\n"
+"out vec4 col0;\n"
 "void main(void) {\n"
-"	gl_Position = vec4(rawpos + offset,0,1);\n"
+"	gl_Position = vec4(rawpos,0,1);\n"
 "	uv0 = rawtex0 * charSize;\n"
+"	col0 = rawcolor0;\n"
 "}\n";
 
 static const char* s_fragmentShaderSrc = "SAMPLER_BINDING(8) uniform sampler2D samp8;\n"
-"uniform vec4 color;\n"
 "in vec2 uv0;\n"
+"in vec4 col0;\n"
 "out vec4 ocol0;\n"
 "void main(void) {\n"
-"	ocol0 = texture(samp8,uv0) * color;\n"
+"	ocol0 = texture(samp8,uv0) * col0;\n"
 "}\n";
 
 static SHADER s_shader;
@@ -166,10 +170,6 @@ RasterFont::RasterFont()
   // bound uniforms
   glUniform2f(glGetUniformLocation(s_shader.glprogid, "charSize"), 1.0f / GLfloat(CHARACTER_COUNT),
     1.0f);
-  uniform_color_id = glGetUniformLocation(s_shader.glprogid, "color");
-  glUniform4f(uniform_color_id, 1.0f, 1.0f, 1.0f, 1.0f);
-  uniform_offset_id = glGetUniformLocation(s_shader.glprogid, "offset");
-  glUniform2f(uniform_offset_id, 0.0f, 0.0f);
 
   // generate VBO & VAO
   glGenBuffers(1, &VBO);
@@ -177,10 +177,14 @@ RasterFont::RasterFont()
   glBindBuffer(GL_ARRAY_BUFFER, VBO);
   glBindVertexArray(VAO);
   glEnableVertexAttribArray(SHADER_POSITION_ATTRIB);
-  glVertexAttribPointer(SHADER_POSITION_ATTRIB, 2, GL_FLOAT, 0, sizeof(GLfloat) * 4, nullptr);
+  glVertexAttribPointer(SHADER_POSITION_ATTRIB, 2, GL_FLOAT, 0, sizeof(Vertex),
+    (void*)offsetof(Vertex, x));
   glEnableVertexAttribArray(SHADER_TEXTURE0_ATTRIB);
-  glVertexAttribPointer(SHADER_TEXTURE0_ATTRIB, 2, GL_FLOAT, 0, sizeof(GLfloat) * 4,
-    (GLfloat*)nullptr + 2);
+  glVertexAttribPointer(SHADER_TEXTURE0_ATTRIB, 2, GL_FLOAT, 0, sizeof(Vertex),
+    (void*)offsetof(Vertex, u));
+  glEnableVertexAttribArray(SHADER_COLOR0_ATTRIB);
+  glVertexAttribPointer(SHADER_COLOR0_ATTRIB, 4, GL_UNSIGNED_BYTE, 1, sizeof(Vertex),
+    (void*)offsetof(Vertex, color));
 }
 
 RasterFont::~RasterFont()
@@ -191,25 +195,24 @@ RasterFont::~RasterFont()
   s_shader.Destroy();
 }
 
-void RasterFont::printMultilineText(const std::string& text, double start_x, double start_y,
-  double z, int bbWidth, int bbHeight, u32 color)
+void RasterFont::BuildVertices(const std::string& text, CachedText* entry)
 {
-  std::vector<GLfloat> vertices(text.length() * 6 * 4);
+  std::vector<Vertex>& vertices = entry->vertices;
+  vertices.clear();
 
-  int usage = 0;
-  GLfloat delta_x = GLfloat(2 * CHARACTER_WIDTH) / GLfloat(bbWidth);
-  GLfloat delta_y = GLfloat(2 * CHARACTER_HEIGHT) / GLfloat(bbHeight);
-  GLfloat border_x = 2.0f / GLfloat(bbWidth);
-  GLfloat border_y = 4.0f / GLfloat(bbHeight);
+  GLfloat delta_x = GLfloat(2 * CHARACTER_WIDTH) / GLfloat(entry->bbWidth);
+  GLfloat delta_y = GLfloat(2 * CHARACTER_HEIGHT) / GLfloat(entry->bbHeight);
+  GLfloat border_x = 2.0f / GLfloat(entry->bbWidth);
+  GLfloat border_y = 4.0f / GLfloat(entry->bbHeight);
 
-  GLfloat x = GLfloat(start_x);
-  GLfloat y = GLfloat(start_y);
+  GLfloat x = GLfloat(entry->x);
+  GLfloat y = GLfloat(entry->y);
 
   for (const char& c : text)
   {
     if (c == '\n')
     {
-      x = GLfloat(start_x);
+      x = GLfloat(entry->x);
       y -= delta_y + border_y;
       continue;
     }
@@ -224,59 +227,110 @@ void RasterFont::printMultilineText(const std::string& text, double start_x, dou
     if (c < CHARACTER_OFFSET || c >= CHARACTER_COUNT + CHARACTER_OFFSET)
       continue;
 
-    vertices[usage++] = x;
-    vertices[usage++] = y;
-    vertices[usage++] = GLfloat(c - CHARACTER_OFFSET);
-    vertices[usage++] = 0.0f;
+    const GLfloat u0 = GLfloat(c - CHARACTER_OFFSET);
+    const GLfloat u1 = u0 + 1.0f;
+    vertices.push_back({x, y, u0, 0.0f, 0});
+    vertices.push_back({x + delta_x, y, u1, 0.0f, 0});
+    vertices.push_back({x + delta_x, y + delta_y, u1, 1.0f, 0});
+    vertices.push_back({x, y, u0, 0.0f, 0});
+    vertices.push_back({x + delta_x, y + delta_y, u1, 1.0f, 0});
+    vertices.push_back({x, y + delta_y, u0, 1.0f, 0});
 
-    vertices[usage++] = x + delta_x;
-    vertices[usage++] = y;
-    vertices[usage++] = GLfloat(c - CHARACTER_OFFSET + 1);
-    vertices[usage++] = 0.0f;
+    x += delta_x + border_x;
+  }
 
-    vertices[usage++] = x + delta_x;
-    vertices[usage++] = y + delta_y;
-    vertices[usage++] = GLfloat(c - CHARACTER_OFFSET + 1);
-    vertices[usage++] = 1.0f;
+  // The text color is ARGB, the vertex color is read as RGBA bytes.
+  const u32 text_color = ((entry->color >> 16) & 0xff) | (entry->color & 0xff00ff00) |
+                         ((entry->color & 0xff) << 16);
+  const u32 shadow_color = entry->color & 0xff000000;
+  const GLfloat shadow_x = 2.0f / GLfloat(entry->bbWidth);
+  const GLfloat shadow_y = -2.0f / GLfloat(entry->bbHeight);
 
-    vertices[usage++] = x;
-    vertices[usage++] = y;
-    vertices[usage++] = GLfloat(c - CHARACTER_OFFSET);
-    vertices[usage++] = 0.0f;
+  const size_t count = vertices.size();
+  vertices.resize(count * 2);
+  for (size_t i = 0; i < count; i++)
+  {
+    vertices[count + i] = vertices[i];
+    vertices[count + i].color = text_color;
+    vertices[i].x += shadow_x;
+    vertices[i].y += shadow_y;
+    vertices[i].color = shadow_color;
+  }
+}
 
-    vertices[usage++] = x + delta_x;
-    vertices[usage++] = y + delta_y;
-    vertices[usage++] = GLfloat(c - CHARACTER_OFFSET + 1);
-    vertices[usage++] = 1.0f;
+void RasterFont::printMultilineText(const std::string& text, double start_x, double start_y,
+  double z, int bbWidth, int bbHeight, u32 color)
+{
+  if (text.empty())
+    return;
 
-    vertices[usage++] = x;
-    vertices[usage++] = y + delta_y;
-    vertices[usage++] = GLfloat(c - CHARACTER_OFFSET);
-    vertices[usage++] = 1.0f;
+  // The same text may be printed several times with different parameters.
+  std::string key = text;
+  key.push_back('\0');
+  key.append(reinterpret_cast<const char*>(&start_x), sizeof(start_x));
+  key.append(reinterpret_cast<const char*>(&start_y), sizeof(start_y));
+  key.append(reinterpret_cast<const char*>(&bbWidth), sizeof(bbWidth));
+  key.append(reinterpret_cast<const char*>(&bbHeight), sizeof(bbHeight));
+  key.append(reinterpret_cast<const char*>(&color), sizeof(color));
+
+  auto result = m_text_cache.emplace(std::move(key), CachedText());
+  CachedText& entry = result.first->second;
+  if (result.second)
+  {
+    entry.x = start_x;
+    entry.y = start_y;
+    entry.bbWidth = bbWidth;
+    entry.bbHeight = bbHeight;
+    entry.color = color;
+    BuildVertices(text, &entry);
+  }
+  entry.last_frame = m_frame;
 
-    x += delta_x + border_x;
+  // skip all whitespace strings
+  if (!entry.vertices.empty())
+    m_queued.push_back(&entry);
+}
+
+void RasterFont::Flush()
+{
+  m_batch.clear();
+  // All shadows first, so that no text is covered by the shadow of a later string.
+  for (const CachedText* entry : m_queued)
+  {
+    m_batch.insert(m_batch.end(), entry->vertices.begin(),
+      entry->vertices.begin() + entry->vertices.size() / 2);
   }
+  for (const CachedText* entry : m_queued)
+  {
+    m_batch.insert(m_batch.end(), entry->vertices.begin() + entry->vertices.size() / 2,
+      entry->vertices.end());
+  }
+  m_queued.clear();
 
-  if (!usage)
+  // Drop the strings which were not printed this frame.
+  for (auto it = m_text_cache.begin(); it != m_text_cache.end();)
   {
-    return;
+    if (it->second.last_frame != m_frame)
+      it = m_text_cache.erase(it);
+    else
+      ++it;
   }
+  m_frame++;
+
+  if (m_batch.empty())
+    return;
 
   glBindVertexArray(VAO);
   glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, usage * sizeof(GLfloat), vertices.data(), GL_STREAM_DRAW);
+  if (m_batch.size() != m_uploaded.size() ||
+    std::memcmp(m_batch.data(), m_uploaded.data(), m_batch.size() * sizeof(Vertex)) != 0)
+  {
+    glBufferData(GL_ARRAY_BUFFER, m_batch.size() * sizeof(Vertex), m_batch.data(),
+      GL_STREAM_DRAW);
+    m_uploaded.swap(m_batch);
+  }
 
   s_shader.Bind();
-
-  // shadows
-  glUniform2f(uniform_offset_id, 2.0f / GLfloat(bbWidth), -2.0f / GLfloat(bbHeight));
-  glUniform4f(uniform_color_id, 0.0f, 0.0f, 0.0f, GLfloat((color >> 24) & 0xff) / 255.f);
-  glDrawArrays(GL_TRIANGLES, 0, usage / 4);
-
-  glUniform2f(uniform_offset_id, 0.0f, 0.0f);
-  glUniform4f(uniform_color_id, GLfloat((color >> 16) & 0xff) / 255.f,
-    GLfloat((color >> 8) & 0xff) / 255.f, GLfloat((color >> 0) & 0xff) / 255.f,
-    GLfloat((color >> 24) & 0xff) / 255.f);
-  glDrawArrays(GL_TRIANGLES, 0, usage / 4);
+  glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_uploaded.size()));
 }
 }
@@ -5,11 +5,17 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
 namespace OGL
 {
+// Text is queued by printMultilineText and drawn by Flush with a single draw call per frame.
+// The vertices of every string are kept while the string is printed each frame, so the
+// statistics overlay doesn't rebuild them glyph by glyph, and the buffer is only uploaded
+// again when the frame's text changed.
 class RasterFont
 {
 public:
@@ -19,12 +25,36 @@ public:
 
   void printMultilineText(const std::string& text, double x, double y, double z, int bbWidth,
     int bbHeight, u32 color);
+  void Flush();
 
 private:
+  struct Vertex
+  {
+    float x, y;
+    float u, v;
+    u32 color;
+  };
+
+  struct CachedText
+  {
+    double x, y;
+    int bbWidth, bbHeight;
+    u32 color;
+    u64 last_frame;
+    // Shadow quads followed by the same number of text quads.
+    std::vector<Vertex> vertices;
+  };
+
+  void BuildVertices(const std::string& text, CachedText* entry);
+
   u32 VBO;
   u32 VAO;
   u32 texture;
-  u32 uniform_color_id;
-  u32 uniform_offset_id;
+
+  std::unordered_map<std::string, CachedText> m_text_cache;
+  std::vector<const CachedText*> m_queued;
+  std::vector<Vertex> m_batch;
+  std::vector<Vertex> m_uploaded;
+  u64 m_frame = 0;
 };
 }
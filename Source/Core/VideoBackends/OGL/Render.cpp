@@ -36,6 +36,7 @@
 
 #include "VideoCommon/AVIDump.h"
 #include "VideoCommon/BPFunctions.h"
+#include "VideoCommon/DrawProfiler.h"
 #include "VideoCommon/DriverDetails.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/IndexGenerator.h"
@@ -504,6 +505,9 @@ Renderer::Renderer()
 
   // Clip distance support is useless without a method to clamp the depth range
   g_Config.backend_info.bSupportsDepthClamp = GLExtensions::Supports("GL_ARB_depth_clamp");
+  g_Config.backend_info.bSupportsPrimitiveRestart =
+      !DriverDetails::HasBug(DriverDetails::BUG_PRIMITIVE_RESTART) &&
+      (GLExtensions::Version() >= 310 || GLExtensions::Supports("GL_NV_primitive_restart"));
 
   // Desktop OpenGL supports bitfield manulipation and dynamic sampler indexing if it supports
   // shader5. OpenGL ES 3.1 supports it implicitly without an extension
@@ -512,8 +516,12 @@ Renderer::Renderer()
       GLExtensions::Supports("GL_ARB_gpu_shader5");
 
   g_ogl_config.bSupportsGLSLCache = GLExtensions::Supports("GL_ARB_get_program_binary");
+  g_ogl_config.bSupportsParallelShaderCompile =
+      GLExtensions::Supports("GL_KHR_parallel_shader_compile") ||
+      GLExtensions::Supports("GL_ARB_parallel_shader_compile");
   g_ogl_config.bSupportsGLPinnedMemory = GLExtensions::Supports("GL_AMD_pinned_memory");
   g_ogl_config.bSupportsGLSync = GLExtensions::Supports("GL_ARB_sync");
+  g_ogl_config.bSupportsTimerQuery = GLExtensions::Supports("GL_ARB_timer_query");
   g_ogl_config.bSupportsGLBaseVertex = GLExtensions::Supports("GL_ARB_draw_elements_base_vertex") ||
                                        GLExtensions::Supports("GL_EXT_draw_elements_base_vertex") ||
                                        GLExtensions::Supports("GL_OES_draw_elements_base_vertex");
@@ -532,6 +540,7 @@ Renderer::Renderer()
   g_ogl_config.bSupportsImageLoadStore = GLExtensions::Supports("GL_ARB_shader_image_load_store");
   g_ogl_config.bSupportsConservativeDepth = GLExtensions::Supports("GL_ARB_conservative_depth");
   g_ogl_config.bSupportsAniso = GLExtensions::Supports("GL_EXT_texture_filter_anisotropic");
+  g_ogl_config.bSupportsMultiBind = GLExtensions::Supports("GL_ARB_multi_bind");
   g_Config.backend_info.bSupportsComputeShaders = GLExtensions::Supports("GL_ARB_compute_shader");
 
   if (GLInterface->GetMode() == GLInterfaceMode::MODE_OPENGLES3)
@@ -687,6 +696,13 @@ Renderer::Renderer()
   g_Config.backend_info.bSupportsEarlyZ =
       g_ogl_config.bSupportsImageLoadStore || g_ogl_config.bSupportsConservativeDepth;
 
+  // Writing gl_Layer from the vertex shader lets stereo draws skip the geometry shader.
+  g_Config.backend_info.bSupportsVSLayerOutput =
+      g_Config.backend_info.bSupportsGeometryShaders &&
+      GLInterface->GetMode() == GLInterfaceMode::MODE_OPENGL &&
+      (GLExtensions::Supports("GL_ARB_shader_viewport_layer_array") ||
+       GLExtensions::Supports("GL_AMD_vertex_shader_layer"));
+
   glGetIntegerv(GL_MAX_SAMPLES, &g_ogl_config.max_samples);
   if (g_ogl_config.max_samples < 1 || !g_ogl_config.bSupportsMSAA)
     g_ogl_config.max_samples = 1;
@@ -799,6 +815,21 @@ void Renderer::Shutdown()
   s_raster_font.reset();
   m_post_processor.reset();
 
+  if (m_gpu_timer_query_active)
+    glEndQuery(GL_TIME_ELAPSED);
+  if (m_gpu_timer_queries[0])
+    glDeleteQueries(GPU_TIMER_QUERY_COUNT, m_gpu_timer_queries.data());
+  m_gpu_timer_queries = {};
+  m_gpu_timer_query_active = false;
+
+  ResolveDrawTimers();
+  if (!m_free_draw_timer_queries.empty())
+  {
+    glDeleteQueries(static_cast<GLsizei>(m_free_draw_timer_queries.size()),
+                    m_free_draw_timer_queries.data());
+    m_free_draw_timer_queries.clear();
+  }
+
   OpenGL_DeleteAttributelessVAO();
 }
 
@@ -844,6 +875,24 @@ void Renderer::Init()
     glEnable(GL_CLIP_DISTANCE1);
     glEnable(GL_DEPTH_CLAMP);
   }
+  // IndexGenerator uses 65535 to separate triangle strips.
+  if (g_ActiveConfig.backend_info.bSupportsPrimitiveRestart)
+  {
+    if (GLInterface->GetMode() == GLInterfaceMode::MODE_OPENGLES3)
+    {
+      glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+    }
+    else if (GLExtensions::Version() >= 310)
+    {
+      glEnable(GL_PRIMITIVE_RESTART);
+      glPrimitiveRestartIndex(65535);
+    }
+    else
+    {
+      glEnableClientState(GL_PRIMITIVE_RESTART_NV);
+      glPrimitiveRestartIndexNV(65535);
+    }
+  }
 
   glPixelStorei(GL_UNPACK_ALIGNMENT, 4);  // 4-byte pixel alignment
 
@@ -1342,9 +1391,6 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
   DrawFrame(flipped_trc, rc, xfbAddr, xfbSourceList, xfbCount, 0, dst_size, fbWidth, fbStride,
             fbHeight, Gamma);
 
-  // The FlushFrameDump call here is necessary even after frame dumping is stopped.
-  // If left out, screenshots are "one frame" behind, as an extra frame is dumped and buffered.
-  FlushFrameDump();
   if (IsFrameDumping())
   {
     // Currently, we only use the off-screen buffer as a frame dump source if full-resolution
@@ -1445,6 +1491,7 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
   // Do our OSD callbacks
   OSD::DoCallbacks(OSD::CallbackType::OnFrame);
   OSD::DrawMessages();
+  s_raster_font->Flush();
 
 #ifdef ANDROID
   if (m_surface_needs_change.IsSet())
@@ -1459,6 +1506,8 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
 
   // Copy the rendered frame to the real window
   GLInterface->Swap();
+  UpdateGPUFrameTimer();
+  ResolveDrawTimers();
 
   // Clear framebuffer
   glClearColor(0, 0, 0, 0);
@@ -1503,6 +1552,88 @@ void Renderer::SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight,
     m_post_processor->ReloadShaders();
 }
 
+void Renderer::UpdateGPUFrameTimer()
+{
+  if (!g_ogl_config.bSupportsTimerQuery)
+    return;
+
+  if (m_gpu_timer_query_active)
+  {
+    glEndQuery(GL_TIME_ELAPSED);
+    m_gpu_timer_query_active = false;
+    m_gpu_timer_queries_issued++;
+  }
+  if (!m_gpu_timer_queries[0])
+    glGenQueries(GPU_TIMER_QUERY_COUNT, m_gpu_timer_queries.data());
+
+  while (m_gpu_timer_queries_read != m_gpu_timer_queries_issued)
+  {
+    const GLuint query = m_gpu_timer_queries[m_gpu_timer_queries_read % GPU_TIMER_QUERY_COUNT];
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      break;
+    GLuint64 elapsed_ns = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+    m_gpu_frame_time = static_cast<float>(elapsed_ns / 1000000.0);
+    m_gpu_timer_queries_read++;
+  }
+
+  if (m_gpu_timer_queries_issued - m_gpu_timer_queries_read < GPU_TIMER_QUERY_COUNT)
+  {
+    glBeginQuery(GL_TIME_ELAPSED,
+                 m_gpu_timer_queries[m_gpu_timer_queries_issued % GPU_TIMER_QUERY_COUNT]);
+    m_gpu_timer_query_active = true;
+  }
+}
+
+void Renderer::BeginDrawTimer(size_t draw)
+{
+  if (!g_ogl_config.bSupportsTimerQuery)
+    return;
+
+  if (m_free_draw_timer_queries.size() < 2)
+  {
+    std::array<GLuint, 64> queries;
+    glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+    m_free_draw_timer_queries.insert(m_free_draw_timer_queries.end(), queries.begin(),
+                                     queries.end());
+  }
+  DrawTimer timer = {draw, m_free_draw_timer_queries.back(), 0};
+  m_free_draw_timer_queries.pop_back();
+  glQueryCounter(timer.begin, GL_TIMESTAMP);
+  m_draw_timers.push_back(timer);
+}
+
+void Renderer::EndDrawTimer()
+{
+  if (m_draw_timers.empty() || m_draw_timers.back().end)
+    return;
+
+  DrawTimer& timer = m_draw_timers.back();
+  timer.end = m_free_draw_timer_queries.back();
+  m_free_draw_timer_queries.pop_back();
+  glQueryCounter(timer.end, GL_TIMESTAMP);
+}
+
+void Renderer::ResolveDrawTimers()
+{
+  for (const DrawTimer& timer : m_draw_timers)
+  {
+    m_free_draw_timer_queries.push_back(timer.begin);
+    if (!timer.end)
+      continue;
+
+    GLuint64 begin_ns = 0;
+    GLuint64 end_ns = 0;
+    glGetQueryObjectui64v(timer.begin, GL_QUERY_RESULT, &begin_ns);
+    glGetQueryObjectui64v(timer.end, GL_QUERY_RESULT, &end_ns);
+    DrawProfiler::SetGPUTime(timer.draw, static_cast<float>((end_ns - begin_ns) / 1000.0));
+    m_free_draw_timer_queries.push_back(timer.end);
+  }
+  m_draw_timers.clear();
+}
+
 void Renderer::InsertBlackFrame()
 {
   ResetAPIState();
@@ -1649,55 +1780,79 @@ void Renderer::DrawRealXFB(const TargetRectangle& target_rc,
 
 void Renderer::FlushFrameDump()
 {
-  if (!m_last_frame_exported)
-    return;
-
+  // Frames have to be written in order, the oldest one is after the current buffer.
+  for (size_t i = 0; i < FRAME_DUMP_BUFFERED_FRAMES; i++)
+  {
+    m_current_frame_dump_buffer = (m_current_frame_dump_buffer + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+    if (m_frame_dump_buffers[m_current_frame_dump_buffer].pending)
+    {
+      FinishFrameData();
+      UnmapFrameDumpBuffers();
+      WriteFrameDumpBuffer(m_current_frame_dump_buffer);
+    }
+  }
   FinishFrameData();
-  glBindBuffer(GL_PIXEL_PACK_BUFFER, m_frame_dumping_pbo[0]);
-  m_frame_pbo_is_mapped[0] = true;
-  void* data = glMapBufferRange(
-      GL_PIXEL_PACK_BUFFER, 0, m_last_frame_width[0] * m_last_frame_height[0] * 4, GL_MAP_READ_BIT);
-  DumpFrameData(reinterpret_cast<u8*>(data), m_last_frame_width[0], m_last_frame_height[0],
-                m_last_frame_width[0] * 4, m_last_frame_state, true);
+  UnmapFrameDumpBuffers();
+}
+
+void Renderer::WriteFrameDumpBuffer(size_t index)
+{
+  FrameDumpBuffer& buffer = m_frame_dump_buffers[index];
+  buffer.pending = false;
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.pbo);
+  void* data =
+      glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, buffer.width * buffer.height * 4, GL_MAP_READ_BIT);
   glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-  m_last_frame_exported = false;
+  if (!data)
+    return;
+  buffer.mapped = true;
+  DumpFrameData(reinterpret_cast<u8*>(data), buffer.width, buffer.height, buffer.width * 4,
+                buffer.state, true);
 }
 
-void Renderer::DumpFrame(const TargetRectangle& flipped_trc, u64 ticks)
+void Renderer::UnmapFrameDumpBuffers()
 {
-  if (!m_frame_dumping_pbo[0])
-  {
-    glGenBuffers(2, m_frame_dumping_pbo.data());
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_frame_dumping_pbo[0]);
-  }
-  else
+  for (FrameDumpBuffer& buffer : m_frame_dump_buffers)
   {
-    FlushFrameDump();
-    std::swap(m_frame_dumping_pbo[0], m_frame_dumping_pbo[1]);
-    std::swap(m_frame_pbo_is_mapped[0], m_frame_pbo_is_mapped[1]);
-    std::swap(m_last_frame_width[0], m_last_frame_width[1]);
-    std::swap(m_last_frame_height[0], m_last_frame_height[1]);
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_frame_dumping_pbo[0]);
-    if (m_frame_pbo_is_mapped[0])
-      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
-    m_frame_pbo_is_mapped[0] = false;
+    if (!buffer.mapped)
+      continue;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.pbo);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    buffer.mapped = false;
   }
+}
+
+void Renderer::DumpFrame(const TargetRectangle& flipped_trc, u64 ticks)
+{
+  // The buffer to read into is the one the dump thread got last time, it has to be done with it.
+  FinishFrameData();
+  UnmapFrameDumpBuffers();
+  m_current_frame_dump_buffer = (m_current_frame_dump_buffer + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+
+  // Hand the oldest frame to the dump thread, its readback has had two frames to finish.
+  const size_t oldest_buffer = (m_current_frame_dump_buffer + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+  if (m_frame_dump_buffers[oldest_buffer].pending)
+    WriteFrameDumpBuffer(oldest_buffer);
 
-  if (flipped_trc.GetWidth() != m_last_frame_width[0] ||
-      flipped_trc.GetHeight() != m_last_frame_height[0])
+  FrameDumpBuffer& buffer = m_frame_dump_buffers[m_current_frame_dump_buffer];
+  if (!buffer.pbo)
+    glGenBuffers(1, &buffer.pbo);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.pbo);
+  if (flipped_trc.GetWidth() != buffer.width || flipped_trc.GetHeight() != buffer.height)
   {
-    m_last_frame_width[0] = flipped_trc.GetWidth();
-    m_last_frame_height[0] = flipped_trc.GetHeight();
-    glBufferData(GL_PIXEL_PACK_BUFFER, m_last_frame_width[0] * m_last_frame_height[0] * 4, nullptr,
-                 GL_STREAM_READ);
+    buffer.width = flipped_trc.GetWidth();
+    buffer.height = flipped_trc.GetHeight();
+    glBufferData(GL_PIXEL_PACK_BUFFER, buffer.width * buffer.height * 4, nullptr, GL_STREAM_READ);
   }
 
-  m_last_frame_state = AVIDump::FetchState(ticks);
-  m_last_frame_exported = true;
+  buffer.state = AVIDump::FetchState(ticks);
+  buffer.pending = true;
 
   glPixelStorei(GL_PACK_ALIGNMENT, 1);
-  glReadPixels(flipped_trc.left, flipped_trc.bottom, m_last_frame_width[0], m_last_frame_height[0],
-               GL_RGBA, GL_UNSIGNED_BYTE, 0);
+  glReadPixels(flipped_trc.left, flipped_trc.bottom, buffer.width, buffer.height, GL_RGBA,
+               GL_UNSIGNED_BYTE, 0);
   glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 }
 
@@ -1774,8 +1929,12 @@ void Renderer::DestroyFrameDumpResources()
     glDeleteFramebuffers(1, &m_frame_dump_render_framebuffer);
   if (m_frame_dump_render_texture)
     glDeleteTextures(1, &m_frame_dump_render_texture);
-  if (m_frame_dumping_pbo[0])
-    glDeleteBuffers(2, m_frame_dumping_pbo.data());
+  for (FrameDumpBuffer& buffer : m_frame_dump_buffers)
+  {
+    if (buffer.pbo)
+      glDeleteBuffers(1, &buffer.pbo);
+    buffer = {};
+  }
 }
 
 // ALWAYS call RestoreAPIState for each ResetAPIState call you're doing
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <string>
+#include <vector>
 #include "VideoCommon/RenderBase.h"
 
 struct XFBSourceBase;
@@ -38,6 +39,7 @@ enum class ES_TEXBUF_TYPE
 struct VideoConfig
 {
   bool bSupportsGLSLCache;
+  bool bSupportsParallelShaderCompile;
   bool bSupportsGLPinnedMemory;
   bool bSupportsGLSync;
   bool bSupportsGLBaseVertex;
@@ -56,6 +58,8 @@ struct VideoConfig
   bool bSupportsConservativeDepth;
   bool bSupportsImageLoadStore;
   bool bSupportsAniso;
+  bool bSupportsMultiBind;
+  bool bSupportsTimerQuery;
 
   const char* gl_vendor;
   const char* gl_renderer;
@@ -102,6 +106,9 @@ public:
   void SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const EFBRectangle& rc, u64 ticks,
     float Gamma) override;
   void InsertBlackFrame() override;
+  float GetGPUFrameTime() override { return m_gpu_frame_time; }
+  void BeginDrawTimer(size_t draw) override;
+  void EndDrawTimer() override;
   void ClearScreen(const EFBRectangle& rc, bool colorEnable, bool alphaEnable, bool zEnable,
     u32 color, u32 z) override;
 
@@ -149,7 +156,24 @@ private:
   void BlitScreen(const TargetRectangle& dst_rect, const TargetRectangle& src_rect, const  TargetSize& src_size, GLuint src_texture,
     GLuint src_depth_texture, const TargetSize& dst_size, GLuint dst_texture, float gamma);
 
+  // Frames are read back to a ring of PBOs and written to the dump two frames later, so mapping
+  // them doesn't wait on the GPU.
+  static constexpr size_t FRAME_DUMP_BUFFERED_FRAMES = 3;
+  struct FrameDumpBuffer
+  {
+    GLuint pbo = 0;
+    int width = 0;
+    int height = 0;
+    AVIDump::Frame state;
+    bool pending = false;
+    bool mapped = false;
+  };
+
+  // Writes all pending frames, when dumping stops.
   void FlushFrameDump();
+  void WriteFrameDumpBuffer(size_t index);
+  // Requires the dump thread to be done with the frames, see FinishFrameData.
+  void UnmapFrameDumpBuffers();
   void DumpFrame(const TargetRectangle& flipped_trc, u64 ticks);
   void DumpFrameUsingFBO(const EFBRectangle& source_rc, u32 xfb_addr,
     const XFBSourceBase* const* xfb_sources, u32 xfb_count, u32 fb_width,
@@ -163,12 +187,29 @@ private:
   u32 m_frame_dump_render_texture_width = 0;
   u32 m_frame_dump_render_texture_height = 0;
 
-  // avi dumping state to delay one frame
-  std::array<u32, 2> m_frame_dumping_pbo = {};
-  std::array<bool, 2> m_frame_pbo_is_mapped = {};
-  std::array<int, 2> m_last_frame_width = {};
-  std::array<int, 2> m_last_frame_height = {};
-  bool m_last_frame_exported = false;
-  AVIDump::Frame m_last_frame_state;
+  std::array<FrameDumpBuffer, FRAME_DUMP_BUFFERED_FRAMES> m_frame_dump_buffers;
+  size_t m_current_frame_dump_buffer = FRAME_DUMP_BUFFERED_FRAMES - 1;
+
+  // Each frame is a GL_TIME_ELAPSED query from one swap to the next. Results are collected once
+  // the GPU has them, so this never stalls; when all queries are in flight a frame goes untimed.
+  static constexpr size_t GPU_TIMER_QUERY_COUNT = 4;
+  void UpdateGPUFrameTimer();
+  std::array<GLuint, GPU_TIMER_QUERY_COUNT> m_gpu_timer_queries = {};
+  u64 m_gpu_timer_queries_issued = 0;
+  u64 m_gpu_timer_queries_read = 0;
+  bool m_gpu_timer_query_active = false;
+  float m_gpu_frame_time = -1.0f;
+
+  // GL_TIMESTAMP pairs around profiled draws, they can't use GL_TIME_ELAPSED because the frame
+  // timer does. Read back at the next swap, waiting for the GPU is fine while profiling.
+  struct DrawTimer
+  {
+    size_t draw;
+    GLuint begin;
+    GLuint end;
+  };
+  void ResolveDrawTimers();
+  std::vector<DrawTimer> m_draw_timers;
+  std::vector<GLuint> m_free_draw_timer_queries;
 };
 }
@@ -630,4 +630,28 @@ bool TextureCache::DecodeTextureOnGPU(HostTexture* dst, u32 dst_level, const u8*
   return true;
 }
 
+void TextureCache::BindTextures()
+{
+  // Without binding layouts the programs remap units, so every Bind goes through to GL.
+  if (!g_ogl_config.bSupportsMultiBind || !g_ActiveConfig.backend_info.bSupportsBindingLayout)
+  {
+    TextureCacheBase::BindTextures();
+    return;
+  }
+
+  std::array<const OGLTexture*, 9> textures = {};
+  for (u32 i = 0; i < bound_textures.size(); ++i)
+  {
+    if (IsValidBindPoint(i) && bound_textures[i])
+      textures[i] = static_cast<const OGLTexture*>(bound_textures[i]->texture.get());
+  }
+  if (g_ActiveConfig.HiresMaterialMapsEnabled() && g_ActiveConfig.bForcePhongShading)
+  {
+    SetupEnviromentTexture();
+    if (bound_enviroment)
+      textures[8] = static_cast<const OGLTexture*>(bound_enviroment->texture.get());
+  }
+  OGLTexture::BindStages(textures);
+}
+
 }
@@ -44,6 +44,7 @@ private:
   bool CompileShaders() override;
   void DeleteShaders() override;
   bool SupportsGPUTextureDecode(TextureFormat format, TlutFormat palette_format) override;
+  void BindTextures() override;
   void* m_last_addr = {};
   u32 m_last_size = {};
   u64 m_last_hash = {};
@@ -84,18 +84,29 @@ void VertexManager::ResetBuffer(u32 stride)
   IndexGenerator::Start(m_cpu_i_buffer.data());
 }
 
-void VertexManager::Draw(u32 stride)
+void VertexManager::Draw(u32 stride, GLsizei instances)
 {
   u32 index_size = IndexGenerator::GetIndexLen();
   u32 max_index = IndexGenerator::GetNumVerts();
   GLenum primitive_mode = 0;
-  static const GLenum modes[3] = {
+  static const GLenum modes[4] = {
       GL_POINTS,
       GL_LINES,
-      GL_TRIANGLES
+      GL_TRIANGLES,
+      GL_TRIANGLE_STRIP
   };
   primitive_mode = modes[static_cast<u32>(m_current_primitive_type)];
-  if (g_ogl_config.bSupportsGLBaseVertex)
+  if (instances > 1)
+  {
+    if (g_ogl_config.bSupportsGLBaseVertex)
+      glDrawElementsInstancedBaseVertex(primitive_mode, index_size, GL_UNSIGNED_SHORT,
+                                        (u8*)nullptr + m_index_offset, instances,
+                                        (GLint)m_baseVertex);
+    else
+      glDrawElementsInstanced(primitive_mode, index_size, GL_UNSIGNED_SHORT,
+                              (u8*)nullptr + m_index_offset, instances);
+  }
+  else if (g_ogl_config.bSupportsGLBaseVertex)
   {
     glDrawRangeElementsBaseVertex(primitive_mode, 0, max_index, index_size, GL_UNSIGNED_SHORT, (u8*)nullptr + m_index_offset, (GLint)m_baseVertex);
   }
@@ -165,7 +176,9 @@ void VertexManager::vFlush(bool useDstAlpha)
   PrepareDrawBuffers(stride);
   active_shader->Bind();
   g_renderer->ApplyState(false);
-  Draw(stride);
+  Draw(stride, active_shader->vertex_stereo ? 2 : 1);
+  if (ProgramShaderCache::IsUberShader(active_shader))
+    INCSTAT(stats.thisFrame.numUberShaderDraws);
   // If the GPU does not support dual-source blending, we can approximate the effect by drawing
   // the object a second time, with the write mask set to alpha only using a shader that outputs
   // the destination/constant alpha value (which would normally be SRC_COLOR.a).
@@ -192,7 +205,7 @@ void VertexManager::vFlush(bool useDstAlpha)
       glDisable(GL_COLOR_LOGIC_OP);
 
     active_shader->Bind();
-    Draw(stride);
+    Draw(stride, active_shader->vertex_stereo ? 2 : 1);
     g_renderer->ResetAPIState();
   }
   g_Config.iSaveTargetId++;
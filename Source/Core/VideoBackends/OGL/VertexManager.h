@@ -40,7 +40,7 @@ protected:
   void ResetBuffer(u32 stride) override;
   u16* GetIndexBuffer() override;
 private:
-  void Draw(u32 stride);
+  void Draw(u32 stride, GLsizei instances);
   void vFlush(bool useDstAlpha) override;
   void PrepareDrawBuffers(u32 stride);
 
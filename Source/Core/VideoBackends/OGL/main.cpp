@@ -95,6 +95,7 @@ void VideoBackend::InitBackendInfo()
 {
   g_Config.backend_info.APIType = API_OPENGL;
   g_Config.backend_info.MaxTextureSize = 1024;
+  g_Config.backend_info.VideoMemorySize = 0;
   g_Config.ClearFormats();
   g_Config.backend_info.bSupportedFormats[PC_TEX_FMT_RGBA32] = true;
   g_Config.backend_info.bSupportedFormats[PC_TEX_FMT_R_FLOAT] = true;
@@ -105,6 +106,7 @@ void VideoBackend::InitBackendInfo()
   g_Config.backend_info.bSupportsExclusiveFullscreen = false;
   g_Config.backend_info.bSupportsOversizedViewports = true;
   g_Config.backend_info.bSupportsGeometryShaders = true;
+  g_Config.backend_info.bSupportsVSLayerOutput = false;
   g_Config.backend_info.bSupports3DVision = false;
   g_Config.backend_info.bSupportsPostProcessing = true;
   g_Config.backend_info.bSupportsSSAA = true;
@@ -122,6 +124,7 @@ void VideoBackend::InitBackendInfo()
   g_Config.backend_info.bSupportsAsyncShaderCompilation = true;
   g_Config.backend_info.bSupportsUberShaders = true;
   g_Config.backend_info.bSupportsHighPrecisionFrameBuffer = false;
+  g_Config.backend_info.bSupportsPrimitiveRestart = false;
   g_Config.backend_info.Adapters.clear();
 
   // aamodes - 1 is to stay consistent with D3D (means no AA)
@@ -19,6 +19,7 @@ static u8 efb[EFB_WIDTH*EFB_HEIGHT * 6];
 namespace EfbInterface
 {
 u32 perf_values[PQ_NUM_MEMBERS];
+thread_local u32* thread_perf_values = perf_values;
 
 static inline u32 GetColorOffset(u16 x, u16 y)
 {
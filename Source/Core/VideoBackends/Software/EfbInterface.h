@@ -61,16 +61,19 @@ void CopyToXFB(yuv422_packed* xfb_in_ram, u32 fbWidth, u32 fbHeight, const EFBRe
 void BypassXFB(u8* texture, u32 fbWidth, u32 fbHeight, const EFBRectangle& sourceRc, float Gamma);
 
 extern u32 perf_values[PQ_NUM_MEMBERS];
+// The counters the calling thread increments. The rasterizer's tile workers count into their
+// own and add them to perf_values when they are done.
+extern thread_local u32* thread_perf_values;
 inline void IncPerfCounterQuadCount(PerfQueryType type)
 {
   // NOTE: hardware doesn't process individual pixels but quads instead.
   // Current software renderer architecture works on pixels though, so
   // we have this "quad" hack here to only increment the registers on
   // every fourth rendered pixel
-  static u32 quad[PQ_NUM_MEMBERS];
+  static thread_local u32 quad[PQ_NUM_MEMBERS];
   if (++quad[type] != 3)
     return;
   quad[type] = 0;
-  ++perf_values[type];
+  ++thread_perf_values[type];
 }
 }
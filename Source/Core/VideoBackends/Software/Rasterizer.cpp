@@ -4,8 +4,12 @@
 
 #include <algorithm>
 #include <cstring>
+#include <iterator>
+#include <mutex>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/ThreadPool.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/NativeVertexFormat.h"
 #include "VideoBackends/Software/Rasterizer.h"
@@ -20,32 +24,73 @@ namespace Rasterizer
 {
 static constexpr int BLOCK_SIZE = 2;
 
-static Slope ZSlope;
-static Slope WSlope;
-static Slope ColorSlopes[2][4];
-static Slope TexSlopes[8][3];
+// Tiles are a multiple of the block size, so every block is shaded by a single worker and the
+// pixels of a tile see the triangles in the order they were drawn.
+static constexpr s32 TILE_SIZE = 32;
+static constexpr s32 TILES_X = (EFB_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+static constexpr s32 TILES_Y = (EFB_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+// Bounds the memory of the binned triangles, flushing in between doesn't change the output.
+static constexpr size_t MAX_BINNED_TRIANGLES = 4096;
 
-static s32 vertex0X;
-static s32 vertex0Y;
-static float vertexOffsetX;
-static float vertexOffsetY;
+// Everything needed to shade a triangle, set up when it is drawn.
+struct TriangleSetup
+{
+  Slope ZSlope;
+  Slope WSlope;
+  Slope ColorSlopes[2][4];
+  Slope TexSlopes[8][3];
+
+  s32 vertex0X;
+  s32 vertex0Y;
+  float vertexOffsetX;
+  float vertexOffsetY;
+
+  // Half-edge constants and deltas in 28.4 fixed point
+  s32 C1, C2, C3;
+  s32 DX12, DX23, DX31;
+  s32 DY12, DY23, DY31;
+
+  // Scissored bounding rectangle
+  s32 minx, maxx, miny, maxy;
+};
+
+// The state of one thread shading pixels.
+struct RasterContext
+{
+  Tev tev;
+  RasterBlock rasterBlock;
+  u32 rasterizedPixels = 0;
+  u32 tevPixelsIn = 0;
+  u32 tevPixelsOut = 0;
+};
+
+// Kept across triangles for zfreeze.
+static Slope ZSlope;
 
 static s32 scissorLeft = 0;
 static s32 scissorTop = 0;
 static s32 scissorRight = 0;
 static s32 scissorBottom = 0;
 
-static Tev tev;
-static RasterBlock rasterBlock;
+// Used by the video thread when drawing serially, the tile workers copy its TEV registers.
+static RasterContext s_context;
+
+static std::vector<TriangleSetup> s_triangles;
+static std::vector<u32> s_tile_bins[TILES_X * TILES_Y];
+static std::mutex s_merge_lock;
 
 void Init()
 {
-  tev.Init();
+  s_context.tev.Init();
 
   // Set initial z reference plane in the unlikely case that zfreeze is enabled when drawing the first primitive.
   // TODO: This is just a guess!
   ZSlope.dfdx = ZSlope.dfdy = 0.f;
   ZSlope.f0 = 1.f;
+
+  s_triangles.clear();
+  for (std::vector<u32>& bin : s_tile_bins)
+    bin.clear();
 }
 
 // Returns approximation of log2(f) in s28.4
@@ -94,17 +139,28 @@ void SetScissor()
 
 void SetTevReg(int reg, int comp, bool konst, s16 color)
 {
-  tev.SetRegColor(reg, comp, konst, color);
+  Flush();
+  s_context.tev.SetRegColor(reg, comp, konst, color);
 }
 
-static void Draw(s32 x, s32 y, s32 xi, s32 yi)
+static void AddStats(RasterContext& context)
 {
-  INCSTAT(stats.thisFrame.rasterizedPixels);
+  ADDSTAT(stats.thisFrame.rasterizedPixels, context.rasterizedPixels);
+  ADDSTAT(stats.thisFrame.tevPixelsIn, context.tevPixelsIn);
+  ADDSTAT(stats.thisFrame.tevPixelsOut, context.tevPixelsOut);
+  context.rasterizedPixels = 0;
+  context.tevPixelsIn = 0;
+  context.tevPixelsOut = 0;
+}
+
+static void Draw(const TriangleSetup& tri, RasterContext& context, s32 x, s32 y, s32 xi, s32 yi)
+{
+  context.rasterizedPixels++;
 
-  float dx = vertexOffsetX + (float)(x - vertex0X);
-  float dy = vertexOffsetY + (float)(y - vertex0Y);
+  float dx = tri.vertexOffsetX + (float)(x - tri.vertex0X);
+  float dy = tri.vertexOffsetY + (float)(y - tri.vertex0Y);
 
-  s32 z = (s32)MathUtil::Clamp<float>(ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
+  s32 z = (s32)MathUtil::Clamp<float>(tri.ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
 
   if (!BoundingBox::active && bpmem.UseEarlyDepthTest() && g_ActiveConfig.bZComploc)
   {
@@ -119,7 +175,9 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
     EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
   }
 
-  RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
+  Tev& tev = context.tev;
+  const RasterBlock& rasterBlock = context.rasterBlock;
+  const RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
   tev.Position[0] = x;
   tev.Position[1] = y;
@@ -130,7 +188,7 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
   {
     for (int comp = 0; comp < 4; comp++)
     {
-      u16 color = (u16)ColorSlopes[i][comp].GetValue(dx, dy);
+      u16 color = (u16)tri.ColorSlopes[i][comp].GetValue(dx, dy);
 
       // clamp color value to 0
       u16 mask = ~(color >> 8);
@@ -159,19 +217,21 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
     tev.TextureLinear[i] = rasterBlock.TextureLinear[i];
   }
 
-  tev.Draw();
+  context.tevPixelsIn++;
+  if (tev.Draw())
+    context.tevPixelsOut++;
 }
 
-static void InitTriangle(float X1, float Y1, s32 xi, s32 yi)
+static void InitTriangle(TriangleSetup* tri, float X1, float Y1, s32 xi, s32 yi)
 {
-  vertex0X = xi;
-  vertex0Y = yi;
+  tri->vertex0X = xi;
+  tri->vertex0Y = yi;
 
   // adjust a little less than 0.5
   const float adjust = 0.495f;
 
-  vertexOffsetX = ((float)xi - X1) + adjust;
-  vertexOffsetY = ((float)yi - Y1) + adjust;
+  tri->vertexOffsetX = ((float)xi - X1) + adjust;
+  tri->vertexOffsetY = ((float)yi - Y1) + adjust;
 }
 
 static void InitSlope(Slope *slope, float f1, float f2, float f3, float DX31, float DX12, float DY12, float DY31)
@@ -186,7 +246,7 @@ static void InitSlope(Slope *slope, float f1, float f2, float f3, float DX31, fl
   slope->f0 = f1;
 }
 
-static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoord)
+static inline void CalculateLOD(const RasterBlock& rasterBlock, s32* lodp, bool* linear, u32 texmap, u32 texcoord)
 {
   const FourTexUnits& texUnit = bpmem.tex[(texmap >> 2) & 1];
   const u8 subTexmap = texmap & 3;
@@ -199,17 +259,17 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   float sDelta, tDelta;
   if (tm0.diag_lod)
   {
-    float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-    float *uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
+    const float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+    const float *uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
 
     sDelta = fabsf(uv0[0] - uv1[0]);
     tDelta = fabsf(uv0[1] - uv1[1]);
   }
   else
   {
-    float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-    float *uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
-    float *uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
+    const float *uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+    const float *uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
+    const float *uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
 
     sDelta = std::max(fabsf(uv0[0] - uv1[0]), fabsf(uv0[0] - uv2[0]));
     tDelta = std::max(fabsf(uv0[1] - uv1[1]), fabsf(uv0[1] - uv2[1]));
@@ -234,7 +294,7 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   *lodp = lod;
 }
 
-static void BuildBlock(s32 blockX, s32 blockY)
+static void BuildBlock(const TriangleSetup& tri, RasterBlock& rasterBlock, s32 blockX, s32 blockY)
 {
   for (s32 yi = 0; yi < BLOCK_SIZE; yi++)
   {
@@ -242,10 +302,10 @@ static void BuildBlock(s32 blockX, s32 blockY)
     {
       RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
-      float dx = vertexOffsetX + (float)(xi + blockX - vertex0X);
-      float dy = vertexOffsetY + (float)(yi + blockY - vertex0Y);
+      float dx = tri.vertexOffsetX + (float)(xi + blockX - tri.vertex0X);
+      float dy = tri.vertexOffsetY + (float)(yi + blockY - tri.vertex0Y);
 
-      float invW = 1.0f / WSlope.GetValue(dx, dy);
+      float invW = 1.0f / tri.WSlope.GetValue(dx, dy);
       pixel.InvW = invW;
 
       // tex coords
@@ -254,13 +314,13 @@ static void BuildBlock(s32 blockX, s32 blockY)
         float projection = invW;
         if (xfmem.texMtxInfo[i].projection)
         {
-          float q = TexSlopes[i][2].GetValue(dx, dy) * invW;
+          float q = tri.TexSlopes[i][2].GetValue(dx, dy) * invW;
           if (q != 0.0f)
             projection = invW / q;
         }
 
-        pixel.Uv[i][0] = TexSlopes[i][0].GetValue(dx, dy) * projection;
-        pixel.Uv[i][1] = TexSlopes[i][1].GetValue(dx, dy) * projection;
+        pixel.Uv[i][0] = tri.TexSlopes[i][0].GetValue(dx, dy) * projection;
+        pixel.Uv[i][1] = tri.TexSlopes[i][1].GetValue(dx, dy) * projection;
       }
     }
   }
@@ -273,7 +333,7 @@ static void BuildBlock(s32 blockX, s32 blockY)
     u32 texcoord = indref & 3;
     indref >>= 3;
 
-    CalculateLOD(&rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
+    CalculateLOD(rasterBlock, &rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
   }
 
   for (unsigned int i = 0; i <= bpmem.genMode.numtevstages; i++)
@@ -285,12 +345,12 @@ static void BuildBlock(s32 blockX, s32 blockY)
       u32 texmap = order.getTexMap(stageOdd);
       u32 texcoord = order.getTexCoord(stageOdd);
 
-      CalculateLOD(&rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
+      CalculateLOD(rasterBlock, &rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
     }
   }
 }
 
-static inline void PrepareBlock(s32 blockX, s32 blockY)
+static inline void PrepareBlock(const TriangleSetup& tri, s32 blockX, s32 blockY)
 {
   static s32 x = -1;
   static s32 y = -1;
@@ -302,10 +362,179 @@ static inline void PrepareBlock(s32 blockX, s32 blockY)
   {
     x = blockX;
     y = blockY;
-    BuildBlock(x, y);
+    BuildBlock(tri, s_context.rasterBlock, x, y);
   }
 }
 
+// Shades the blocks of the triangle that start inside the given rectangle, left and top are
+// aligned to the block size.
+static void DrawBlocks(const TriangleSetup& tri, RasterContext& context, s32 left, s32 top, s32 right, s32 bottom)
+{
+  // Fixed-pos32 deltas
+  const s32 FDX12 = tri.DX12 * 16;
+  const s32 FDX23 = tri.DX23 * 16;
+  const s32 FDX31 = tri.DX31 * 16;
+
+  const s32 FDY12 = tri.DY12 * 16;
+  const s32 FDY23 = tri.DY23 * 16;
+  const s32 FDY31 = tri.DY31 * 16;
+
+  const s32 startx = std::max(tri.minx, left);
+  const s32 endx = std::min(tri.maxx, right);
+  const s32 starty = std::max(tri.miny, top);
+  const s32 endy = std::min(tri.maxy, bottom);
+
+  // Loop through blocks
+  for (s32 y = starty; y < endy; y += BLOCK_SIZE)
+  {
+    for (s32 x = startx; x < endx; x += BLOCK_SIZE)
+    {
+      // Corners of block
+      s32 x0 = x << 4;
+      s32 x1 = (x + BLOCK_SIZE - 1) << 4;
+      s32 y0 = y << 4;
+      s32 y1 = (y + BLOCK_SIZE - 1) << 4;
+
+      // Evaluate half-space functions
+      bool a00 = tri.C1 + tri.DX12 * y0 - tri.DY12 * x0 > 0;
+      bool a10 = tri.C1 + tri.DX12 * y0 - tri.DY12 * x1 > 0;
+      bool a01 = tri.C1 + tri.DX12 * y1 - tri.DY12 * x0 > 0;
+      bool a11 = tri.C1 + tri.DX12 * y1 - tri.DY12 * x1 > 0;
+      int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
+
+      bool b00 = tri.C2 + tri.DX23 * y0 - tri.DY23 * x0 > 0;
+      bool b10 = tri.C2 + tri.DX23 * y0 - tri.DY23 * x1 > 0;
+      bool b01 = tri.C2 + tri.DX23 * y1 - tri.DY23 * x0 > 0;
+      bool b11 = tri.C2 + tri.DX23 * y1 - tri.DY23 * x1 > 0;
+      int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
+
+      bool c00 = tri.C3 + tri.DX31 * y0 - tri.DY31 * x0 > 0;
+      bool c10 = tri.C3 + tri.DX31 * y0 - tri.DY31 * x1 > 0;
+      bool c01 = tri.C3 + tri.DX31 * y1 - tri.DY31 * x0 > 0;
+      bool c11 = tri.C3 + tri.DX31 * y1 - tri.DY31 * x1 > 0;
+      int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
+
+      // Skip block when outside an edge
+      if (a == 0x0 || b == 0x0 || c == 0x0)
+        continue;
+
+      BuildBlock(tri, context.rasterBlock, x, y);
+
+      // Accept whole block when totally covered
+      if (a == 0xF && b == 0xF && c == 0xF)
+      {
+        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+        {
+          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
+          {
+            Draw(tri, context, x + ix, y + iy, ix, iy);
+          }
+        }
+      }
+      else // Partially covered block
+      {
+        s32 CY1 = tri.C1 + tri.DX12 * y0 - tri.DY12 * x0;
+        s32 CY2 = tri.C2 + tri.DX23 * y0 - tri.DY23 * x0;
+        s32 CY3 = tri.C3 + tri.DX31 * y0 - tri.DY31 * x0;
+
+        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+        {
+          s32 CX1 = CY1;
+          s32 CX2 = CY2;
+          s32 CX3 = CY3;
+
+          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
+          {
+            if (CX1 > 0 && CX2 > 0 && CX3 > 0)
+            {
+              Draw(tri, context, x + ix, y + iy, ix, iy);
+            }
+
+            CX1 -= FDY12;
+            CX2 -= FDY23;
+            CX3 -= FDY31;
+          }
+
+          CY1 += FDX12;
+          CY2 += FDX23;
+          CY3 += FDX31;
+        }
+      }
+    }
+  }
+}
+
+static bool UseTileWorkers()
+{
+  // The bounding box search and the TEV dumps depend on the pixels being drawn in order.
+  return !BoundingBox::active && !g_ActiveConfig.bDumpTevStages &&
+         !g_ActiveConfig.bDumpTevTextureFetches && Common::ThreadPool::GetThreadCount() > 0;
+}
+
+static void BinTriangle(const TriangleSetup& tri)
+{
+  const u32 index = static_cast<u32>(s_triangles.size());
+  s_triangles.push_back(tri);
+
+  const s32 tile_right = (tri.maxx - 1) / TILE_SIZE;
+  const s32 tile_bottom = (tri.maxy - 1) / TILE_SIZE;
+  for (s32 tile_y = tri.miny / TILE_SIZE; tile_y <= tile_bottom; tile_y++)
+  {
+    for (s32 tile_x = tri.minx / TILE_SIZE; tile_x <= tile_right; tile_x++)
+      s_tile_bins[tile_y * TILES_X + tile_x].push_back(index);
+  }
+
+  if (s_triangles.size() >= MAX_BINNED_TRIANGLES)
+    Flush();
+}
+
+void Flush()
+{
+  if (s_triangles.empty())
+    return;
+
+  s32 tiles[TILES_X * TILES_Y];
+  s32 tile_count = 0;
+  for (s32 i = 0; i < TILES_X * TILES_Y; i++)
+  {
+    if (!s_tile_bins[i].empty())
+      tiles[tile_count++] = i;
+  }
+
+  Common::ParallelForWorker::Loop(0, tile_count, 1, [&](s32 begin, s32 end) {
+    RasterContext context;
+    context.tev.Init();
+    context.tev.CopyRegColors(s_context.tev);
+    u16 bbox[4];
+    std::copy(std::begin(BoundingBox::coords), std::end(BoundingBox::coords), bbox);
+    context.tev.BoundingBoxCoords = bbox;
+    u32 perf[PQ_NUM_MEMBERS] = {};
+    EfbInterface::thread_perf_values = perf;
+
+    for (s32 i = begin; i < end; i++)
+    {
+      const s32 left = (tiles[i] % TILES_X) * TILE_SIZE;
+      const s32 top = (tiles[i] / TILES_X) * TILE_SIZE;
+      for (u32 index : s_tile_bins[tiles[i]])
+        DrawBlocks(s_triangles[index], context, left, top, left + TILE_SIZE, top + TILE_SIZE);
+    }
+
+    EfbInterface::thread_perf_values = EfbInterface::perf_values;
+    std::lock_guard<std::mutex> guard(s_merge_lock);
+    AddStats(context);
+    for (int i = 0; i < PQ_NUM_MEMBERS; i++)
+      EfbInterface::perf_values[i] += perf[i];
+    BoundingBox::coords[BoundingBox::LEFT] = std::min(BoundingBox::coords[BoundingBox::LEFT], bbox[BoundingBox::LEFT]);
+    BoundingBox::coords[BoundingBox::RIGHT] = std::max(BoundingBox::coords[BoundingBox::RIGHT], bbox[BoundingBox::RIGHT]);
+    BoundingBox::coords[BoundingBox::TOP] = std::min(BoundingBox::coords[BoundingBox::TOP], bbox[BoundingBox::TOP]);
+    BoundingBox::coords[BoundingBox::BOTTOM] = std::max(BoundingBox::coords[BoundingBox::BOTTOM], bbox[BoundingBox::BOTTOM]);
+  });
+
+  s_triangles.clear();
+  for (s32 i = 0; i < tile_count; i++)
+    s_tile_bins[tiles[i]].clear();
+}
+
 void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVertexData *v2)
 {
   INCSTAT(stats.thisFrame.numTrianglesDrawn);
@@ -363,10 +592,11 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
   float fltdy12 = flty1 - v1->screenPosition.y;
   float fltdy31 = v2->screenPosition.y - flty1;
 
-  InitTriangle(fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
+  TriangleSetup tri;
+  InitTriangle(&tri, fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
 
   float w[3] = { 1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w, 1.0f / v2->projectedPosition.w };
-  InitSlope(&WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+  InitSlope(&tri.WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
 
   // TODO: The zfreeze emulation is not quite correct, yet!
   // Many things might prevent us from reaching this line (culling, clipping, scissoring).
@@ -374,17 +604,18 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
   // We're currently sloppy at this since we abort early if any of the culling/clipping/scissoring tests fail.
   if (!bpmem.genMode.zfreeze || !g_ActiveConfig.bZFreeze)
     InitSlope(&ZSlope, v0->screenPosition[2], v1->screenPosition[2], v2->screenPosition[2], fltdx31, fltdx12, fltdy12, fltdy31);
+  tri.ZSlope = ZSlope;
 
   for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
   {
     for (int comp = 0; comp < 4; comp++)
-      InitSlope(&ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp], v2->color[i][comp], fltdx31, fltdx12, fltdy12, fltdy31);
+      InitSlope(&tri.ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp], v2->color[i][comp], fltdx31, fltdx12, fltdy12, fltdy31);
   }
 
   for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
   {
     for (int comp = 0; comp < 3; comp++)
-      InitSlope(&TexSlopes[i][comp], v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1], v2->texCoords[i][comp] * w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+      InitSlope(&tri.TexSlopes[i][comp], v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1], v2->texCoords[i][comp] * w[2], fltdx31, fltdx12, fltdy12, fltdy31);
   }
 
   // Half-edge constants
@@ -397,92 +628,39 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
   if (DY23 < 0 || (DY23 == 0 && DX23 > 0)) C2++;
   if (DY31 < 0 || (DY31 == 0 && DX31 > 0)) C3++;
 
+  tri.C1 = C1;
+  tri.C2 = C2;
+  tri.C3 = C3;
+  tri.DX12 = DX12;
+  tri.DX23 = DX23;
+  tri.DX31 = DX31;
+  tri.DY12 = DY12;
+  tri.DY23 = DY23;
+  tri.DY31 = DY31;
+
   if (!BoundingBox::active)
   {
-    // Start in corner of 8x8 block
-    minx &= ~(BLOCK_SIZE - 1);
-    miny &= ~(BLOCK_SIZE - 1);
-    // Loop through blocks
-    for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
-    {
-      for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
-      {
-        // Corners of block
-        s32 x0 = x << 4;
-        s32 x1 = (x + BLOCK_SIZE - 1) << 4;
-        s32 y0 = y << 4;
-        s32 y1 = (y + BLOCK_SIZE - 1) << 4;
-
-        // Evaluate half-space functions
-        bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
-        bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
-        bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
-        bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
-        int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
-
-        bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
-        bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
-        bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
-        bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
-        int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
-
-        bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
-        bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
-        bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
-        bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
-        int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
-
-        // Skip block when outside an edge
-        if (a == 0x0 || b == 0x0 || c == 0x0)
-          continue;
-
-        BuildBlock(x, y);
-
-        // Accept whole block when totally covered
-        if (a == 0xF && b == 0xF && c == 0xF)
-        {
-          for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
-          {
-            for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-            {
-              Draw(x + ix, y + iy, ix, iy);
-            }
-          }
-        }
-        else // Partially covered block
-        {
-          s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
-          s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
-          s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
-
-          for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
-          {
-            s32 CX1 = CY1;
-            s32 CX2 = CY2;
-            s32 CX3 = CY3;
+    // Start in corner of 2x2 block
+    tri.minx = minx & ~(BLOCK_SIZE - 1);
+    tri.miny = miny & ~(BLOCK_SIZE - 1);
+    tri.maxx = maxx;
+    tri.maxy = maxy;
 
-            for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-            {
-              if (CX1 > 0 && CX2 > 0 && CX3 > 0)
-              {
-                Draw(x + ix, y + iy, ix, iy);
-              }
-
-              CX1 -= FDY12;
-              CX2 -= FDY23;
-              CX3 -= FDY31;
-            }
-
-            CY1 += FDX12;
-            CY2 += FDX23;
-            CY3 += FDX31;
-          }
-        }
-      }
+    if (UseTileWorkers())
+    {
+      BinTriangle(tri);
+    }
+    else
+    {
+      Flush();
+      DrawBlocks(tri, s_context, tri.minx, tri.miny, tri.maxx, tri.maxy);
+      AddStats(s_context);
     }
   }
   else
   {
+    Flush();
+
     // Calculating bbox
     // First check for alpha channel - don't do anything it if always fails,
     // Change bbox to primitive size if it always passes
@@ -532,8 +710,8 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
         if (CX1 > 0 && CX2 > 0 && CX3 > 0)
         {
           // Build the new raster block every other pixel
-          PrepareBlock(x, y);
-          Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+          PrepareBlock(tri, x, y);
+          Draw(tri, s_context, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
 
           if (y >= BoundingBox::coords[BoundingBox::TOP])
             break;
@@ -572,8 +750,8 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
       {
         if (CY1 > 0 && CY2 > 0 && CY3 > 0)
         {
-          PrepareBlock(x, y);
-          Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+          PrepareBlock(tri, x, y);
+          Draw(tri, s_context, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
 
           if (x >= BoundingBox::coords[BoundingBox::LEFT])
             break;
@@ -612,8 +790,8 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
         if (CX1 > 0 && CX2 > 0 && CX3 > 0)
         {
           // Build the new raster block every other pixel
-          PrepareBlock(x, y);
-          Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+          PrepareBlock(tri, x, y);
+          Draw(tri, s_context, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
 
           if (y <= BoundingBox::coords[BoundingBox::BOTTOM])
             break;
@@ -653,8 +831,8 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
         if (CY1 > 0 && CY2 > 0 && CY3 > 0)
         {
           // Build the new raster block every other pixel
-          PrepareBlock(x, y);
-          Draw(x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
+          PrepareBlock(tri, x, y);
+          Draw(tri, s_context, x, y, x & (BLOCK_SIZE - 1), y & (BLOCK_SIZE - 1));
 
           if (x <= BoundingBox::coords[BoundingBox::RIGHT])
             break;
@@ -669,6 +847,7 @@ void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVer
       CX2 += FDY23;
       CX3 += FDY31;
     }
+    AddStats(s_context);
   }
 }
 
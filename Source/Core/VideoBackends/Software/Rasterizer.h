@@ -13,6 +13,9 @@ namespace Rasterizer
 void Init();
 
 void DrawTriangleFrontFace(OutputVertexData *v0, OutputVertexData *v1, OutputVertexData *v2);
+// Shades the triangles that were binned for the tile workers. Has to run before anything
+// reads the EFB or changes the state the triangles are drawn with.
+void Flush();
 
 void SetScissor();
 
@@ -24,7 +27,7 @@ struct Slope
   float dfdy;
   float f0;
 
-  float GetValue(float dx, float dy)
+  float GetValue(float dx, float dy) const
   {
     return f0 + (dfdx * dx) + (dfdy * dy);
   }
@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <iterator>
 #include <limits>
 
 #include "Common/ChunkFile.h"
@@ -46,6 +48,8 @@ SWVertexLoader::SWVertexLoader()
   LocalVBuffer.resize(MAXVBUFFERSIZE);
   LocalIBuffer.resize(MAXIBUFFERSIZE);
   m_SetupUnit = new SetupUnit;
+  // The matrix indices are read from xfmem when the batch is flushed.
+  m_per_vertex_matrix_indices = false;
 }
 
 SWVertexLoader::~SWVertexLoader()
@@ -98,42 +102,59 @@ void SWVertexLoader::vFlush(bool useDstAlpha)
     Rasterizer::SetTevReg(i, Tev::ALP_C, true, kcolors[i * 4 + 3]);
   }
 
-  for (u32 i = 0; i < IndexGenerator::GetIndexLen(); i++)
-  {
-    u16 index = LocalIBuffer[i];
+  // The matrix indices are the same for the whole batch, vertices can override them.
+  memset(&m_Vertex, 0, sizeof(m_Vertex));
+  SetFormat(g_main_cp_state.last_id, primitiveType);
+  const PortableVertexDeclaration& vdec = VertexLoaderManager::GetCurrentVertexFormat()->GetVertexDeclaration();
+  const bool has_normals = (VertexLoaderManager::g_current_components & VB_HAS_NRM0) != 0;
+  const bool nbt = (VertexLoaderManager::g_current_components & VB_HAS_NRM2) != 0;
 
-    if (index == 0xffff)
+  const u32 index_count = IndexGenerator::GetIndexLen();
+  for (u32 i = 0; i < index_count;)
+  {
+    if (LocalIBuffer[i] == 0xffff)
     {
       // primitive restart
       m_SetupUnit->Init(primitiveType);
+      i++;
       continue;
     }
-    memset(&m_Vertex, 0, sizeof(m_Vertex));
-
-    // Super Mario Sunshine requires those to be zero for those debug boxes.
-    memset(&m_Vertex.color, 0, sizeof(m_Vertex.color));
-
-    // parse the videocommon format to our own struct format (m_Vertex)
-    SetFormat(g_main_cp_state.last_id, primitiveType);
-    ParseVertex(VertexLoaderManager::GetCurrentVertexFormat()->GetVertexDeclaration(), index);
 
-    // transform this vertex so that it can be used for rasterization (outVertex)
-    OutputVertexData* outVertex = m_SetupUnit->GetVertex();
-    TransformUnit::TransformPosition(&m_Vertex, outVertex);
-    memset(&outVertex->normal, 0, sizeof(outVertex->normal));
-    if (VertexLoaderManager::g_current_components & VB_HAS_NRM0)
+    // parse the videocommon format to our own struct format, up to the next primitive restart
+    int count = 0;
+    for (; count < TransformUnit::BATCH_SIZE && i < index_count && LocalIBuffer[i] != 0xffff; count++, i++)
     {
-      TransformUnit::TransformNormal(&m_Vertex, (VertexLoaderManager::g_current_components & VB_HAS_NRM2) != 0, outVertex);
+      // Super Mario Sunshine requires the colors to be zero for those debug boxes.
+      m_Vertices[count] = m_Vertex;
+      ParseVertex(vdec, LocalIBuffer[i], &m_Vertices[count]);
     }
-    TransformUnit::TransformColor(&m_Vertex, outVertex);
-    TransformUnit::TransformTexCoord(&m_Vertex, outVertex, m_TexGenSpecialCase);
 
-    // assemble and rasterize the primitive
-    m_SetupUnit->SetupVertex();
+    // positions and normals are transformed for the whole batch at once
+    TransformUnit::TransformPositions(m_Vertices, count, m_Transformed);
+    if (has_normals)
+      TransformUnit::TransformNormals(m_Vertices, count, nbt, m_Transformed);
 
-    INCSTAT(stats.thisFrame.numVerticesLoaded)
+    for (int j = 0; j < count; j++)
+    {
+      // transform this vertex so that it can be used for rasterization (outVertex)
+      OutputVertexData* outVertex = m_SetupUnit->GetVertex();
+      outVertex->mvPosition = m_Transformed[j].mvPosition;
+      outVertex->projectedPosition = m_Transformed[j].projectedPosition;
+      if (has_normals)
+        std::copy(std::begin(m_Transformed[j].normal), std::end(m_Transformed[j].normal), outVertex->normal);
+      TransformUnit::TransformColor(&m_Vertices[j], outVertex);
+      TransformUnit::TransformTexCoord(&m_Vertices[j], outVertex, m_TexGenSpecialCase);
+
+      // assemble and rasterize the primitive
+      m_SetupUnit->SetupVertex();
+
+      INCSTAT(stats.thisFrame.numVerticesLoaded)
+    }
   }
 
+  // The BP and XF state only changes in between batches.
+  Rasterizer::Flush();
+
   DebugUtil::OnObjectEnd();
 }
 
@@ -224,33 +245,33 @@ static void ReadVertexAttribute(T* dst, DataReader src, const AttributeFormat& f
   }
 }
 
-void SWVertexLoader::ParseVertex(const PortableVertexDeclaration& vdec, int index)
+void SWVertexLoader::ParseVertex(const PortableVertexDeclaration& vdec, int index, InputVertexData* vertex)
 {
   DataReader src(LocalVBuffer.data(), LocalVBuffer.data() + LocalVBuffer.size());
   src.ReadSkip(index * vdec.stride);
 
-  ReadVertexAttribute<float>(&m_Vertex.position[0], src, vdec.position, 0, 3, false);
+  ReadVertexAttribute<float>(&vertex->position[0], src, vdec.position, 0, 3, false);
 
   for (int i = 0; i < 3; i++)
   {
-    ReadVertexAttribute<float>(&m_Vertex.normal[i][0], src, vdec.normals[i], 0, 3, false);
+    ReadVertexAttribute<float>(&vertex->normal[i][0], src, vdec.normals[i], 0, 3, false);
   }
 
   for (int i = 0; i < 2; i++)
   {
-    ReadVertexAttribute<u8>(m_Vertex.color[i], src, vdec.colors[i], 0, 4, true);
+    ReadVertexAttribute<u8>(vertex->color[i], src, vdec.colors[i], 0, 4, true);
   }
 
   for (int i = 0; i < 8; i++)
   {
-    ReadVertexAttribute<float>(m_Vertex.texCoords[i], src, vdec.texcoords[i], 0, 2, false);
+    ReadVertexAttribute<float>(vertex->texCoords[i], src, vdec.texcoords[i], 0, 2, false);
 
     // the texmtr is stored as third component of the texCoord
     if (vdec.texcoords[i].components >= 3)
     {
-      ReadVertexAttribute<u8>(&m_Vertex.texMtx[i], src, vdec.texcoords[i], 2, 1, false);
+      ReadVertexAttribute<u8>(&vertex->texMtx[i], src, vdec.texcoords[i], 2, 1, false);
     }
   }
 
-  ReadVertexAttribute<u8>(&m_Vertex.posMtx, src, vdec.posmtx, 0, 1, false);
+  ReadVertexAttribute<u8>(&vertex->posMtx, src, vdec.posmtx, 0, 1, false);
 }
@@ -11,6 +11,7 @@
 #include "Common/CommonTypes.h"
 
 #include "VideoBackends/Software/NativeVertexFormat.h"
+#include "VideoBackends/Software/TransformUnit.h"
 
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexManagerBase.h"
@@ -37,9 +38,12 @@ private:
   std::vector<u8> LocalVBuffer;
   std::vector<u16> LocalIBuffer;
 
+  // The matrix indices from SetFormat, copied to each vertex before it is parsed.
   InputVertexData m_Vertex;
+  InputVertexData m_Vertices[TransformUnit::BATCH_SIZE];
+  OutputVertexData m_Transformed[TransformUnit::BATCH_SIZE];
 
-  void ParseVertex(const PortableVertexDeclaration& vdec, int index);
+  void ParseVertex(const PortableVertexDeclaration& vdec, int index, InputVertexData* vertex);
 
   SetupUnit *m_SetupUnit;
 
@@ -27,7 +27,6 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/FramebufferManagerBase.h"
-#include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/PixelEngine.h"
@@ -148,6 +147,7 @@ void VideoSoftware::InitBackendInfo()
   g_Config.backend_info.bSupportsDualSourceBlend = true;
   g_Config.backend_info.bSupportsEarlyZ = true;
   g_Config.backend_info.bSupportsOversizedViewports = true;
+  g_Config.backend_info.bSupportsPrimitiveRestart = false;
 
   // aamodes
   g_Config.backend_info.AAModes = { 1 };
@@ -220,7 +220,6 @@ void VideoSoftware::Video_Prepare()
   g_perf_query = std::make_unique<PerfQuery>();
   Fifo::Init(); // must be done before OpcodeDecoder_Init()
   OpcodeDecoder::Init();
-  IndexGenerator::Init();
   VertexShaderManager::Init();
   PixelShaderManager::Init(true);
   g_texture_cache = std::make_unique<TextureCache>();
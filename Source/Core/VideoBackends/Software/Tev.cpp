@@ -3,9 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <cmath>
+#include <cstring>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "VideoBackends/Software/DebugUtil.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/Tev.h"
@@ -13,7 +15,6 @@
 
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/PerfQueryBase.h"
-#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
@@ -337,6 +338,85 @@ void Tev::DrawAlphaCompare(TevStageCombiner::AlphaCombiner& ac, const InputRegTy
   }
 }
 
+#if defined(_M_X86)
+// Lane i holds component i of the ABGR registers, so lane 0 takes the alpha combiner's settings
+// and the others the color combiner's. Matches DrawColorRegular and DrawAlphaRegular followed by
+// the clamps, bit for bit.
+void Tev::DrawRegularSIMD(TevStageCombiner::ColorCombiner& cc, TevStageCombiner::AlphaCombiner& ac)
+{
+  alignas(16) s16 in[4][8] = {};
+  const u32 color_sel[4] = {cc.a, cc.b, cc.c, cc.d};
+  const u32 alpha_sel[4] = {ac.a, ac.b, ac.c, ac.d};
+  for (int i = 0; i < 4; i++)
+  {
+    in[i][ALP_C] = *m_AlphaInputLUT[alpha_sel[i]];
+    in[i][BLU_C] = *m_ColorInputLUT[color_sel[i]][BLU_INP];
+    in[i][GRN_C] = *m_ColorInputLUT[color_sel[i]][GRN_INP];
+    in[i][RED_C] = *m_ColorInputLUT[color_sel[i]][RED_INP];
+  }
+
+  // a, b and c are 8 bit unsigned and d is 11 bit signed, like in InputRegType
+  const __m128i byte_mask = _mm_set1_epi16(0xFF);
+  const __m128i a = _mm_and_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(in[0])), byte_mask);
+  const __m128i b = _mm_and_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(in[1])), byte_mask);
+  __m128i c = _mm_and_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(in[2])), byte_mask);
+  __m128i d = _mm_srai_epi16(_mm_slli_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(in[3])), 5), 5);
+
+  // a * (256 - c) + b * c
+  c = _mm_add_epi16(c, _mm_srli_epi16(c, 7));
+  __m128i temp = _mm_madd_epi16(_mm_unpacklo_epi16(a, b),
+                                _mm_unpacklo_epi16(_mm_sub_epi16(_mm_set1_epi16(256), c), c));
+
+  const __m128i alpha_lane = _mm_set_epi32(0, 0, 0, -1);
+  auto select = [&alpha_lane](__m128i alpha, __m128i color) {
+    return _mm_or_si128(_mm_and_si128(alpha_lane, alpha), _mm_andnot_si128(alpha_lane, color));
+  };
+  const __m128i lshift_color = _mm_cvtsi32_si128(m_ScaleLShiftLUT[cc.shift]);
+  const __m128i lshift_alpha = _mm_cvtsi32_si128(m_ScaleLShiftLUT[ac.shift]);
+  const __m128i rshift_color = _mm_cvtsi32_si128(m_ScaleRShiftLUT[cc.shift]);
+  const __m128i rshift_alpha = _mm_cvtsi32_si128(m_ScaleRShiftLUT[ac.shift]);
+
+  temp = select(_mm_sll_epi32(temp, lshift_alpha), _mm_sll_epi32(temp, lshift_color));
+  const s32 round_color = (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
+  const s32 round_alpha = (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
+  temp = _mm_add_epi32(temp, _mm_set_epi32(round_color, round_color, round_color, round_alpha));
+
+  // Alpha is negated before the shift and color after it.
+  const __m128i negate_alpha = _mm_and_si128(alpha_lane, _mm_set1_epi32(ac.op ? -1 : 0));
+  const __m128i negate_color = _mm_andnot_si128(alpha_lane, _mm_set1_epi32(cc.op ? -1 : 0));
+  temp = _mm_sub_epi32(_mm_xor_si128(temp, negate_alpha), negate_alpha);
+  temp = _mm_srai_epi32(temp, 8);
+  temp = _mm_sub_epi32(_mm_xor_si128(temp, negate_color), negate_color);
+
+  const s32 bias_color = m_BiasLUT[cc.bias];
+  const s32 bias_alpha = m_BiasLUT[ac.bias];
+  __m128i result = _mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(d, d), 16),
+                                 _mm_set_epi32(bias_color, bias_color, bias_color, bias_alpha));
+  result = select(_mm_sll_epi32(result, lshift_alpha), _mm_sll_epi32(result, lshift_color));
+  result = _mm_add_epi32(result, temp);
+  result = select(_mm_sra_epi32(result, rshift_alpha), _mm_sra_epi32(result, rshift_color));
+
+  // Truncate to the 16 bit registers, then clamp
+  result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+  result = _mm_packs_epi32(result, result);
+  const s16 min_color = cc.clamp ? 0 : -1024;
+  const s16 max_color = cc.clamp ? 255 : 1023;
+  const s16 min_alpha = ac.clamp ? 0 : -1024;
+  const s16 max_alpha = ac.clamp ? 255 : 1023;
+  result = _mm_max_epi16(result, _mm_setr_epi16(min_alpha, min_color, min_color, min_color,
+                                                min_alpha, min_color, min_color, min_color));
+  result = _mm_min_epi16(result, _mm_setr_epi16(max_alpha, max_color, max_color, max_color,
+                                                max_alpha, max_color, max_color, max_color));
+
+  alignas(16) s16 out[8];
+  _mm_store_si128(reinterpret_cast<__m128i*>(out), result);
+  Reg[cc.dest][BLU_C] = out[BLU_C];
+  Reg[cc.dest][GRN_C] = out[GRN_C];
+  Reg[cc.dest][RED_C] = out[RED_C];
+  Reg[ac.dest][ALP_C] = out[ALP_C];
+}
+#endif
+
 static bool AlphaCompare(int alpha, int ref, AlphaTest::CompareMode comp)
 {
   switch (comp)
@@ -506,12 +586,14 @@ void Tev::Indirect(unsigned int stageNum, s32 s, s32 t)
   }
 }
 
-void Tev::Draw()
+bool Tev::Draw()
 {
   ASSERT(Position[0] >= 0 && Position[0] < EFB_WIDTH);
   ASSERT(Position[1] >= 0 && Position[1] < EFB_HEIGHT);
 
-  INCSTAT(stats.thisFrame.tevPixelsIn);
+  // Results of previous pixels don't carry over, which also keeps the output independent of
+  // the order the tiles are shaded in.
+  std::memcpy(Reg, RegInit, sizeof(Reg));
 
   for (unsigned int stageNum = 0; stageNum < bpmem.genMode.numindstages.Value(); stageNum++)
   {
@@ -591,47 +673,56 @@ void Tev::Draw()
     // set color
     SetRasColor(order.getColorChan(stageOdd), ac.rswap * 2);
 
-    // combine inputs
-    InputRegType inputs[4];
-    for (int i = 0; i < 3; i++)
+#if defined(_M_X86)
+    if (cc.bias != 3 && ac.bias != 3)
     {
-      inputs[BLU_C + i].a = *m_ColorInputLUT[cc.a][i];
-      inputs[BLU_C + i].b = *m_ColorInputLUT[cc.b][i];
-      inputs[BLU_C + i].c = *m_ColorInputLUT[cc.c][i];
-      inputs[BLU_C + i].d = *m_ColorInputLUT[cc.d][i];
-    }
-    inputs[ALP_C].a = *m_AlphaInputLUT[ac.a];
-    inputs[ALP_C].b = *m_AlphaInputLUT[ac.b];
-    inputs[ALP_C].c = *m_AlphaInputLUT[ac.c];
-    inputs[ALP_C].d = *m_AlphaInputLUT[ac.d];
-
-    if (cc.bias != 3)
-      DrawColorRegular(cc, inputs);
-    else
-      DrawColorCompare(cc, inputs);
-
-    if (cc.clamp)
-    {
-      Reg[cc.dest][RED_C] = Clamp255(Reg[cc.dest][RED_C]);
-      Reg[cc.dest][GRN_C] = Clamp255(Reg[cc.dest][GRN_C]);
-      Reg[cc.dest][BLU_C] = Clamp255(Reg[cc.dest][BLU_C]);
+      DrawRegularSIMD(cc, ac);
     }
     else
+#endif
     {
-      Reg[cc.dest][RED_C] = Clamp1024(Reg[cc.dest][RED_C]);
-      Reg[cc.dest][GRN_C] = Clamp1024(Reg[cc.dest][GRN_C]);
-      Reg[cc.dest][BLU_C] = Clamp1024(Reg[cc.dest][BLU_C]);
-    }
+      // combine inputs
+      InputRegType inputs[4];
+      for (int i = 0; i < 3; i++)
+      {
+        inputs[BLU_C + i].a = *m_ColorInputLUT[cc.a][i];
+        inputs[BLU_C + i].b = *m_ColorInputLUT[cc.b][i];
+        inputs[BLU_C + i].c = *m_ColorInputLUT[cc.c][i];
+        inputs[BLU_C + i].d = *m_ColorInputLUT[cc.d][i];
+      }
+      inputs[ALP_C].a = *m_AlphaInputLUT[ac.a];
+      inputs[ALP_C].b = *m_AlphaInputLUT[ac.b];
+      inputs[ALP_C].c = *m_AlphaInputLUT[ac.c];
+      inputs[ALP_C].d = *m_AlphaInputLUT[ac.d];
 
-    if (ac.bias != 3)
-      DrawAlphaRegular(ac, inputs);
-    else
-      DrawAlphaCompare(ac, inputs);
+      if (cc.bias != 3)
+        DrawColorRegular(cc, inputs);
+      else
+        DrawColorCompare(cc, inputs);
 
-    if (ac.clamp)
-      Reg[ac.dest][ALP_C] = Clamp255(Reg[ac.dest][ALP_C]);
-    else
-      Reg[ac.dest][ALP_C] = Clamp1024(Reg[ac.dest][ALP_C]);
+      if (cc.clamp)
+      {
+        Reg[cc.dest][RED_C] = Clamp255(Reg[cc.dest][RED_C]);
+        Reg[cc.dest][GRN_C] = Clamp255(Reg[cc.dest][GRN_C]);
+        Reg[cc.dest][BLU_C] = Clamp255(Reg[cc.dest][BLU_C]);
+      }
+      else
+      {
+        Reg[cc.dest][RED_C] = Clamp1024(Reg[cc.dest][RED_C]);
+        Reg[cc.dest][GRN_C] = Clamp1024(Reg[cc.dest][GRN_C]);
+        Reg[cc.dest][BLU_C] = Clamp1024(Reg[cc.dest][BLU_C]);
+      }
+
+      if (ac.bias != 3)
+        DrawAlphaRegular(ac, inputs);
+      else
+        DrawAlphaCompare(ac, inputs);
+
+      if (ac.clamp)
+        Reg[ac.dest][ALP_C] = Clamp255(Reg[ac.dest][ALP_C]);
+      else
+        Reg[ac.dest][ALP_C] = Clamp1024(Reg[ac.dest][ALP_C]);
+    }
 
 #if ALLOW_TEV_DUMPS
     if (g_ActiveConfig.bDumpTevStages)
@@ -654,7 +745,7 @@ void Tev::Draw()
   if (!BoundingBox::active)
   {
     if (!TevAlphaTest(output[ALP_C]))
-      return;
+      return false;
     // z texture
     if (bpmem.ztex2.op)
     {
@@ -766,21 +857,21 @@ void Tev::Draw()
       EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
 
       if (!EfbInterface::ZCompare(Position[0], Position[1], Position[2]))
-        return;
+        return false;
 
       EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
     }
   }
   // branchless bounding box update
-  BoundingBox::coords[BoundingBox::LEFT] = std::min((u16)Position[0], BoundingBox::coords[BoundingBox::LEFT]);
-  BoundingBox::coords[BoundingBox::RIGHT] = std::max((u16)Position[0], BoundingBox::coords[BoundingBox::RIGHT]);
-  BoundingBox::coords[BoundingBox::TOP] = std::min((u16)Position[1], BoundingBox::coords[BoundingBox::TOP]);
-  BoundingBox::coords[BoundingBox::BOTTOM] = std::max((u16)Position[1], BoundingBox::coords[BoundingBox::BOTTOM]);
+  BoundingBoxCoords[BoundingBox::LEFT] = std::min((u16)Position[0], BoundingBoxCoords[BoundingBox::LEFT]);
+  BoundingBoxCoords[BoundingBox::RIGHT] = std::max((u16)Position[0], BoundingBoxCoords[BoundingBox::RIGHT]);
+  BoundingBoxCoords[BoundingBox::TOP] = std::min((u16)Position[1], BoundingBoxCoords[BoundingBox::TOP]);
+  BoundingBoxCoords[BoundingBox::BOTTOM] = std::max((u16)Position[1], BoundingBoxCoords[BoundingBox::BOTTOM]);
 
   // if we are only calculating the bounding box,
   // there's no need to actually draw anything
   if (BoundingBox::active)
-    return;
+    return false;
 
 #if ALLOW_TEV_DUMPS
   if (g_ActiveConfig.bDumpTevStages)
@@ -802,10 +893,10 @@ void Tev::Draw()
   }
 #endif
 
-  INCSTAT(stats.thisFrame.tevPixelsOut);
   EfbInterface::IncPerfCounterQuadCount(PQ_BLEND_INPUT);
 
   EfbInterface::BlendTev(Position[0], Position[1], output);
+  return true;
 }
 
 void Tev::SetRegColor(int reg, int comp, bool konst, s16 color)
@@ -816,7 +907,13 @@ void Tev::SetRegColor(int reg, int comp, bool konst, s16 color)
   }
   else
   {
-    Reg[reg][comp] = color;
+    RegInit[reg][comp] = color;
   }
 }
 
+void Tev::CopyRegColors(const Tev& other)
+{
+  std::memcpy(RegInit, other.RegInit, sizeof(RegInit));
+  std::memcpy(KonstantColors, other.KonstantColors, sizeof(KonstantColors));
+}
+
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BoundingBox.h"
 
 class Tev
 {
@@ -24,6 +25,8 @@ class Tev
 
   // color order: ABGR
   s16 Reg[4][4];
+  // The register values set by the game, every pixel starts from them.
+  s16 RegInit[4][4];
   s16 KonstantColors[4][4];
   s16 TexColor[4];
   s16 RasColor[4];
@@ -63,6 +66,8 @@ class Tev
   void DrawColorCompare(TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
   void DrawAlphaRegular(TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
   void DrawAlphaCompare(TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
+  // Both regular combiners at once, with all four components in one vector.
+  void DrawRegularSIMD(TevStageCombiner::ColorCombiner& cc, TevStageCombiner::AlphaCombiner& ac);
 
   void Indirect(unsigned int stageNum, s32 s, s32 t);
 
@@ -74,6 +79,8 @@ public:
   bool IndirectLinear[4];
   s32 TextureLod[16];
   bool TextureLinear[16];
+  // Where Draw() extends the bounding box, the rasterizer's tile workers each have their own.
+  u16* BoundingBoxCoords = BoundingBox::coords;
 
   enum
   {
@@ -85,7 +92,10 @@ public:
 
   void Init();
 
-  void Draw();
+  // Returns true if the pixel made it to blending.
+  bool Draw();
 
   void SetRegColor(int reg, int comp, bool konst, s16 color);
+  // Copies the register and konst colors of another Tev.
+  void CopyRegColors(const Tev& other);
 };
@@ -4,8 +4,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include "Common/Common.h"
+#include "Common/Intrinsics.h"
 #include "Core/HW/Memmap.h"
 #include "VideoBackends/Software/TextureSampler.h"
 
@@ -43,7 +45,26 @@ static inline void WrapCoord(int* coordp, int wrapMode, int imageSize)
   *coordp = coord;
 }
 
-static inline void SetTexel(u8 *inTexel, u32 *outTexel, u32 fract)
+#if defined(_M_X86)
+// Returns the weighted sum of the components of two RGBA texels, weights must fit in s16.
+static inline __m128i WeightTexels(const u8* texel0, const u8* texel1, u32 weight0, u32 weight1)
+{
+  u32 in0, in1;
+  std::memcpy(&in0, texel0, sizeof(u32));
+  std::memcpy(&in1, texel1, sizeof(u32));
+  const __m128i interleaved = _mm_unpacklo_epi8(
+      _mm_unpacklo_epi8(_mm_cvtsi32_si128(in0), _mm_cvtsi32_si128(in1)), _mm_setzero_si128());
+  return _mm_madd_epi16(interleaved, _mm_set1_epi32(static_cast<s32>(weight0 | (weight1 << 16))));
+}
+
+static inline void StoreTexel(__m128i sum, int shift, u8* sample)
+{
+  sum = _mm_srl_epi32(sum, _mm_cvtsi32_si128(shift));
+  const u32 out = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(sum, sum), sum));
+  std::memcpy(sample, &out, sizeof(u32));
+}
+#else
+static inline void SetTexel(const u8 *inTexel, u32 *outTexel, u32 fract)
 {
   outTexel[0] = inTexel[0] * fract;
   outTexel[1] = inTexel[1] * fract;
@@ -51,13 +72,52 @@ static inline void SetTexel(u8 *inTexel, u32 *outTexel, u32 fract)
   outTexel[3] = inTexel[3] * fract;
 }
 
-static inline void AddTexel(u8 *inTexel, u32 *outTexel, u32 fract)
+static inline void AddTexel(const u8 *inTexel, u32 *outTexel, u32 fract)
 {
   outTexel[0] += inTexel[0] * fract;
   outTexel[1] += inTexel[1] * fract;
   outTexel[2] += inTexel[2] * fract;
   outTexel[3] += inTexel[3] * fract;
 }
+#endif
+
+// Blends two texels with weights that add up to 16.
+static inline void BlendMips(const u8 texels[2][4], u32 fract, u8* sample)
+{
+#if defined(_M_X86)
+  StoreTexel(WeightTexels(texels[0], texels[1], 16 - fract, fract), 4, sample);
+#else
+  u32 texel[4];
+  SetTexel(texels[0], texel, 16 - fract);
+  AddTexel(texels[1], texel, fract);
+
+  sample[0] = (u8)(texel[0] >> 4);
+  sample[1] = (u8)(texel[1] >> 4);
+  sample[2] = (u8)(texel[2] >> 4);
+  sample[3] = (u8)(texel[3] >> 4);
+#endif
+}
+
+// Blends the four texels around the sample location, the fractions are 1.7 fixed point.
+static inline void BlendBilinear(const u8 texels[4][4], u32 fractS, u32 fractT, u8* sample)
+{
+#if defined(_M_X86)
+  const __m128i top = WeightTexels(texels[0], texels[1], (128 - fractS) * (128 - fractT), fractS * (128 - fractT));
+  const __m128i bottom = WeightTexels(texels[2], texels[3], (128 - fractS) * fractT, fractS * fractT);
+  StoreTexel(_mm_add_epi32(top, bottom), 14, sample);
+#else
+  u32 texel[4];
+  SetTexel(texels[0], texel, (128 - fractS) * (128 - fractT));
+  AddTexel(texels[1], texel, (fractS) * (128 - fractT));
+  AddTexel(texels[2], texel, (128 - fractS) * (fractT));
+  AddTexel(texels[3], texel, (fractS) * (fractT));
+
+  sample[0] = (u8)(texel[0] >> 14);
+  sample[1] = (u8)(texel[1] >> 14);
+  sample[2] = (u8)(texel[2] >> 14);
+  sample[3] = (u8)(texel[3] >> 14);
+#endif
+}
 
 void Sample(s32 s, s32 t, s32 lod, bool linear, u8 texmap, u8 *sample)
 {
@@ -82,19 +142,11 @@ void Sample(s32 s, s32 t, s32 lod, bool linear, u8 texmap, u8 *sample)
 
   if (mipLinear)
   {
-    u8 sampledTex[4];
-    u32 texel[4];
+    u8 sampledTex[2][4];
 
-    SampleMip(s, t, baseMip, linear, texmap, sampledTex);
-    SetTexel(sampledTex, texel, (16 - lodFract));
-
-    SampleMip(s, t, baseMip + 1, linear, texmap, sampledTex);
-    AddTexel(sampledTex, texel, lodFract);
-
-    sample[0] = (u8)(texel[0] >> 4);
-    sample[1] = (u8)(texel[1] >> 4);
-    sample[2] = (u8)(texel[2] >> 4);
-    sample[3] = (u8)(texel[3] >> 4);
+    SampleMip(s, t, baseMip, linear, texmap, sampledTex[0]);
+    SampleMip(s, t, baseMip + 1, linear, texmap, sampledTex[1]);
+    BlendMips(sampledTex, lodFract, sample);
   }
   else
 #endif
@@ -178,8 +230,7 @@ void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8 *sample)
     int imageTPlus1 = imageT + 1;
     int fractT = t & 0x7f;
 
-    u8 sampledTex[4];
-    u32 texel[4];
+    u8 sampledTex[4][4];
 
     WrapCoord(&imageS, tm0.wrap_s, imageWidth);
     WrapCoord(&imageT, tm0.wrap_t, imageHeight);
@@ -188,37 +239,20 @@ void SampleMip(s32 s, s32 t, s32 mip, bool linear, u8 texmap, u8 *sample)
 
     if (!(ti0.format == GX_TF_RGBA8 && texUnit.texImage1[subTexmap].image_type))
     {
-      TexDecoder::DecodeTexel(sampledTex, imageSrc, imageS, imageT, imageWidth, ti0.format, tlut, tlutfmt);
-      SetTexel(sampledTex, texel, (128 - fractS) * (128 - fractT));
-
-      TexDecoder::DecodeTexel(sampledTex, imageSrc, imageSPlus1, imageT, imageWidth, ti0.format, tlut, tlutfmt);
-      AddTexel(sampledTex, texel, (fractS) * (128 - fractT));
-
-      TexDecoder::DecodeTexel(sampledTex, imageSrc, imageS, imageTPlus1, imageWidth, ti0.format, tlut, tlutfmt);
-      AddTexel(sampledTex, texel, (128 - fractS) * (fractT));
-
-      TexDecoder::DecodeTexel(sampledTex, imageSrc, imageSPlus1, imageTPlus1, imageWidth, ti0.format, tlut, tlutfmt);
-      AddTexel(sampledTex, texel, (fractS) * (fractT));
+      TexDecoder::DecodeTexel(sampledTex[0], imageSrc, imageS, imageT, imageWidth, ti0.format, tlut, tlutfmt);
+      TexDecoder::DecodeTexel(sampledTex[1], imageSrc, imageSPlus1, imageT, imageWidth, ti0.format, tlut, tlutfmt);
+      TexDecoder::DecodeTexel(sampledTex[2], imageSrc, imageS, imageTPlus1, imageWidth, ti0.format, tlut, tlutfmt);
+      TexDecoder::DecodeTexel(sampledTex[3], imageSrc, imageSPlus1, imageTPlus1, imageWidth, ti0.format, tlut, tlutfmt);
     }
     else
     {
-      TexDecoder::DecodeTexelRGBA8FromTmem(sampledTex, imageSrc, imageSrcOdd, imageS, imageT, imageWidth);
-      SetTexel(sampledTex, texel, (128 - fractS) * (128 - fractT));
-
-      TexDecoder::DecodeTexelRGBA8FromTmem(sampledTex, imageSrc, imageSrcOdd, imageSPlus1, imageT, imageWidth);
-      AddTexel(sampledTex, texel, (fractS) * (128 - fractT));
-
-      TexDecoder::DecodeTexelRGBA8FromTmem(sampledTex, imageSrc, imageSrcOdd, imageS, imageTPlus1, imageWidth);
-      AddTexel(sampledTex, texel, (128 - fractS) * (fractT));
-
-      TexDecoder::DecodeTexelRGBA8FromTmem(sampledTex, imageSrc, imageSrcOdd, imageSPlus1, imageTPlus1, imageWidth);
-      AddTexel(sampledTex, texel, (fractS) * (fractT));
+      TexDecoder::DecodeTexelRGBA8FromTmem(sampledTex[0], imageSrc, imageSrcOdd, imageS, imageT, imageWidth);
+      TexDecoder::DecodeTexelRGBA8FromTmem(sampledTex[1], imageSrc, imageSrcOdd, imageSPlus1, imageT, imageWidth);
+      TexDecoder::DecodeTexelRGBA8FromTmem(sampledTex[2], imageSrc, imageSrcOdd, imageS, imageTPlus1, imageWidth);
+      TexDecoder::DecodeTexelRGBA8FromTmem(sampledTex[3], imageSrc, imageSrcOdd, imageSPlus1, imageTPlus1, imageWidth);
     }
 
-    sample[0] = (u8)(texel[0] >> 14);
-    sample[1] = (u8)(texel[1] >> 14);
-    sample[2] = (u8)(texel[2] >> 14);
-    sample[3] = (u8)(texel[3] >> 14);
+    BlendBilinear(sampledTex, fractS, fractT, sample);
   }
   else
   {
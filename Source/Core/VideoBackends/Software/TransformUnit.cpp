@@ -6,6 +6,7 @@
 #include <cmath>
 
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/MathUtil.h"
 #include "Common/Swap.h"
 
@@ -104,6 +105,155 @@ void TransformNormal(const InputVertexData *src, bool nbt, OutputVertexData *dst
   }
 }
 
+#if defined(_M_X86)
+// Loads element i of the matrices of every lane, broadcast when they share one.
+static inline __m128 LoadMatrixElement(const float* const mats[BATCH_SIZE], bool uniform, int i)
+{
+  if (uniform)
+    return _mm_set1_ps(mats[0][i]);
+  return _mm_setr_ps(mats[0][i], mats[1][i], mats[2][i], mats[3][i]);
+}
+
+// Vectors of the x, y and z components of BATCH_SIZE vertices.
+struct Vec3x4
+{
+  __m128 x, y, z;
+};
+
+static inline Vec3x4 LoadVec3x4(const Vec3* const vecs[BATCH_SIZE])
+{
+  return {_mm_setr_ps(vecs[0]->x, vecs[1]->x, vecs[2]->x, vecs[3]->x),
+          _mm_setr_ps(vecs[0]->y, vecs[1]->y, vecs[2]->y, vecs[3]->y),
+          _mm_setr_ps(vecs[0]->z, vecs[1]->z, vecs[2]->z, vecs[3]->z)};
+}
+
+static inline void StoreVec3x4(const Vec3x4& vec, int count, Vec3* const dst[BATCH_SIZE])
+{
+  alignas(16) float x[BATCH_SIZE], y[BATCH_SIZE], z[BATCH_SIZE];
+  _mm_store_ps(x, vec.x);
+  _mm_store_ps(y, vec.y);
+  _mm_store_ps(z, vec.z);
+  for (int i = 0; i < count; i++)
+    dst[i]->set(x[i], y[i], z[i]);
+}
+
+// Rows are evaluated in the same order as MultiplyVec3Mat33/34, so the results match them exactly.
+template <bool Translate>
+static inline Vec3x4 MultiplyVec3x4Mat3(const Vec3x4& vec, const float* const mats[BATCH_SIZE], bool uniform)
+{
+  constexpr int stride = Translate ? 4 : 3;
+  Vec3x4 result;
+  __m128* rows[3] = {&result.x, &result.y, &result.z};
+  for (int row = 0; row < 3; row++)
+  {
+    __m128 sum = _mm_add_ps(_mm_mul_ps(LoadMatrixElement(mats, uniform, row * stride + 0), vec.x),
+                            _mm_mul_ps(LoadMatrixElement(mats, uniform, row * stride + 1), vec.y));
+    sum = _mm_add_ps(sum, _mm_mul_ps(LoadMatrixElement(mats, uniform, row * stride + 2), vec.z));
+    if (Translate)
+      sum = _mm_add_ps(sum, LoadMatrixElement(mats, uniform, row * stride + 3));
+    *rows[row] = sum;
+  }
+  return result;
+}
+
+// Unused lanes repeat the last vertex.
+static inline int BatchLane(int lane, int count)
+{
+  return std::min(lane, count - 1);
+}
+
+void TransformPositions(const InputVertexData *src, int count, OutputVertexData *dst)
+{
+  const float* mats[BATCH_SIZE];
+  const Vec3* positions[BATCH_SIZE];
+  bool uniform = true;
+  for (int i = 0; i < BATCH_SIZE; i++)
+  {
+    const InputVertexData& vertex = src[BatchLane(i, count)];
+    mats[i] = &xfmem.posMatrices[vertex.posMtx * 4];
+    positions[i] = &vertex.position;
+    uniform &= vertex.posMtx == src[0].posMtx;
+  }
+
+  const Vec3x4 mv = MultiplyVec3x4Mat3<true>(LoadVec3x4(positions), mats, uniform);
+  Vec3* mv_dst[BATCH_SIZE];
+  for (int i = 0; i < count; i++)
+    mv_dst[i] = &dst[i].mvPosition;
+  StoreVec3x4(mv, count, mv_dst);
+
+  const float* proj = xfmem.projection.rawProjection;
+  __m128 x, y, z, w;
+  if (xfmem.projection.type == GX_PERSPECTIVE)
+  {
+    x = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[0]), mv.x), _mm_mul_ps(_mm_set1_ps(proj[1]), mv.z));
+    y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[2]), mv.y), _mm_mul_ps(_mm_set1_ps(proj[3]), mv.z));
+    z = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[4]), mv.z), _mm_set1_ps(proj[5])),
+                   _mm_set1_ps(1.0f - (float)1e-7));
+    w = _mm_xor_ps(mv.z, _mm_set1_ps(-0.0f));
+  }
+  else
+  {
+    x = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[0]), mv.x), _mm_set1_ps(proj[1]));
+    y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[2]), mv.y), _mm_set1_ps(proj[3]));
+    z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(proj[4]), mv.z), _mm_set1_ps(proj[5]));
+    w = _mm_set1_ps(1.0f);
+  }
+
+  // Transpose to one Vec4 per vertex
+  _MM_TRANSPOSE4_PS(x, y, z, w);
+  const __m128 projected[BATCH_SIZE] = {x, y, z, w};
+  for (int i = 0; i < count; i++)
+    _mm_storeu_ps(&dst[i].projectedPosition.x, projected[i]);
+}
+
+void TransformNormals(const InputVertexData *src, int count, bool nbt, OutputVertexData *dst)
+{
+  const float* mats[BATCH_SIZE];
+  bool uniform = true;
+  for (int i = 0; i < BATCH_SIZE; i++)
+  {
+    const InputVertexData& vertex = src[BatchLane(i, count)];
+    mats[i] = &xfmem.normalMatrices[(vertex.posMtx & 31) * 3];
+    uniform &= (vertex.posMtx & 31) == (src[0].posMtx & 31);
+  }
+
+  for (int n = 0; n < (nbt ? 3 : 1); n++)
+  {
+    const Vec3* normals[BATCH_SIZE];
+    Vec3* normal_dst[BATCH_SIZE];
+    for (int i = 0; i < BATCH_SIZE; i++)
+      normals[i] = &src[BatchLane(i, count)].normal[n];
+    for (int i = 0; i < count; i++)
+      normal_dst[i] = &dst[i].normal[n];
+
+    Vec3x4 normal = MultiplyVec3x4Mat3<false>(LoadVec3x4(normals), mats, uniform);
+    if (n == 0)
+    {
+      // Vec3::Normalize, which multiplies with the reciprocal of the length
+      const __m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normal.x, normal.x), _mm_mul_ps(normal.y, normal.y)),
+                                        _mm_mul_ps(normal.z, normal.z));
+      const __m128 inv_length = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length2));
+      normal.x = _mm_mul_ps(normal.x, inv_length);
+      normal.y = _mm_mul_ps(normal.y, inv_length);
+      normal.z = _mm_mul_ps(normal.z, inv_length);
+    }
+    StoreVec3x4(normal, count, normal_dst);
+  }
+}
+#else
+void TransformPositions(const InputVertexData *src, int count, OutputVertexData *dst)
+{
+  for (int i = 0; i < count; i++)
+    TransformPosition(&src[i], &dst[i]);
+}
+
+void TransformNormals(const InputVertexData *src, int count, bool nbt, OutputVertexData *dst)
+{
+  for (int i = 0; i < count; i++)
+    TransformNormal(&src[i], nbt, &dst[i]);
+}
+#endif
+
 static void TransformTexCoordRegular(const TexMtxInfo &texinfo, int coordNum, bool specialCase, const InputVertexData *srcVertex, OutputVertexData *dstVertex)
 {
   const Vec3 *src;
@@ -13,4 +13,12 @@ void TransformPosition(const InputVertexData *src, OutputVertexData *dst);
 void TransformNormal(const InputVertexData *src, bool nbt, OutputVertexData *dst);
 void TransformColor(const InputVertexData *src, OutputVertexData *dst);
 void TransformTexCoord(const InputVertexData *src, OutputVertexData *dst, bool specialCase);
+
+// How many vertices the batched transforms work on at once.
+constexpr int BATCH_SIZE = 4;
+
+// Same as TransformPosition and TransformNormal for count <= BATCH_SIZE vertices, with each lane
+// of a vector holding a different vertex. Only write the positions or normals of dst.
+void TransformPositions(const InputVertexData *src, int count, OutputVertexData *dst);
+void TransformNormals(const InputVertexData *src, int count, bool nbt, OutputVertexData *dst);
 }
@@ -16,6 +16,8 @@
 #include "VideoBackends/Vulkan/Util.h"
 #include "VideoBackends/Vulkan/VulkanContext.h"
 
+#include "VideoCommon/VideoConfig.h"
+
 namespace Vulkan
 {
 BoundingBox::BoundingBox()
@@ -24,6 +26,9 @@ BoundingBox::BoundingBox()
 
 BoundingBox::~BoundingBox()
 {
+  if (g_command_buffer_mgr)
+    g_command_buffer_mgr->RemoveFencePointCallback(this);
+
   if (m_gpu_buffer != VK_NULL_HANDLE)
   {
     vkDestroyBuffer(g_vulkan_context->GetDevice(), m_gpu_buffer, nullptr);
@@ -45,6 +50,16 @@ bool BoundingBox::Initialize()
   if (!CreateReadbackBuffer())
     return false;
 
+  // Async readbacks are done once the command buffer they were recorded to has executed.
+  g_command_buffer_mgr->AddFencePointCallback(this, [](VkCommandBuffer, VkFence) {},
+                                              [this](VkFence fence) {
+                                                for (size_t i = 0; i < m_async_fences.size(); i++)
+                                                {
+                                                  if (m_async_fences[i] == fence)
+                                                    m_async_done[i] = true;
+                                                }
+                                              });
+
   return true;
 }
 
@@ -117,8 +132,16 @@ s32 BoundingBox::Get(size_t index)
 {
   ASSERT(index < NUM_VALUES);
 
-  if (!m_valid)
+  if (g_ActiveConfig.bBBoxLatencyTolerant)
+  {
+    if (!m_valid)
+      QueueAsyncReadback();
+    PollAsyncReadbacks();
+  }
+  else if (!m_valid)
+  {
     Readback();
+  }
 
   s32 value;
   m_readback_buffer->Read(index * sizeof(s32), &value, sizeof(value), false);
@@ -142,6 +165,7 @@ void BoundingBox::Set(size_t index, s32 value)
   // Flag as dirty, and update values.
   m_readback_buffer->Write(index * sizeof(s32), &value, sizeof(value), true);
   m_values_dirty[index] = true;
+  m_async_ring.Invalidate();
 }
 
 bool BoundingBox::CreateGPUBuffer()
@@ -210,10 +234,18 @@ bool BoundingBox::CreateReadbackBuffer()
   if (!m_readback_buffer || !m_readback_buffer->Map())
     return false;
 
+  for (std::unique_ptr<StagingBuffer>& buffer : m_async_buffers)
+  {
+    buffer = StagingBuffer::Create(STAGING_BUFFER_TYPE_READBACK, BUFFER_SIZE,
+      VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    if (!buffer || !buffer->Map())
+      return false;
+  }
+
   return true;
 }
 
-void BoundingBox::Readback()
+void BoundingBox::RecordReadback(StagingBuffer* buffer)
 {
   // Can't be done within a render pass.
   StateTracker::GetInstance()->EndRenderPass();
@@ -223,22 +255,27 @@ void BoundingBox::Readback()
     g_command_buffer_mgr->GetCurrentCommandBuffer(), m_gpu_buffer,
     VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, 0,
     BUFFER_SIZE, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
-  m_readback_buffer->PrepareForGPUWrite(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+  buffer->PrepareForGPUWrite(g_command_buffer_mgr->GetCurrentCommandBuffer(),
     VK_ACCESS_TRANSFER_WRITE_BIT,
     VK_PIPELINE_STAGE_TRANSFER_BIT);
 
   // Copy from GPU -> readback buffer.
   VkBufferCopy region = { 0, 0, BUFFER_SIZE };
   vkCmdCopyBuffer(g_command_buffer_mgr->GetCurrentCommandBuffer(), m_gpu_buffer,
-    m_readback_buffer->GetBuffer(), 1, &region);
+    buffer->GetBuffer(), 1, &region);
 
   // Restore GPU buffer access.
   Util::BufferMemoryBarrier(g_command_buffer_mgr->GetCurrentCommandBuffer(), m_gpu_buffer,
     VK_ACCESS_TRANSFER_READ_BIT,
     VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, 0, BUFFER_SIZE,
     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
-  m_readback_buffer->FlushGPUCache(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+  buffer->FlushGPUCache(g_command_buffer_mgr->GetCurrentCommandBuffer(),
     VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+}
+
+void BoundingBox::Readback()
+{
+  RecordReadback(m_readback_buffer.get());
 
   // Wait until these commands complete.
   Util::ExecuteCurrentCommandsAndRestoreState(false, true);
@@ -248,4 +285,33 @@ void BoundingBox::Readback()
   m_valid = true;
 }
 
+void BoundingBox::QueueAsyncReadback()
+{
+  // Values the CPU wrote are still to be flushed, a copy now would read the old ones.
+  for (bool dirty : m_values_dirty)
+  {
+    if (dirty)
+      return;
+  }
+
+  // The copy executes with the current command buffer, we don't wait for it.
+  const u32 slot = m_async_ring.Begin();
+  RecordReadback(m_async_buffers[slot].get());
+  m_async_fences[slot] = g_command_buffer_mgr->GetCurrentCommandBufferFence();
+  m_async_done[slot] = false;
+
+  // Until the next draw, Get keeps returning the values we have.
+  m_valid = true;
+}
+
+void BoundingBox::PollAsyncReadbacks()
+{
+  m_async_ring.Poll([this](u32 slot) { return m_async_done[slot]; },
+                    [this](u32 slot) {
+                      std::array<s32, NUM_VALUES> values;
+                      m_async_buffers[slot]->Read(0, values.data(), BUFFER_SIZE, true);
+                      m_readback_buffer->Write(0, values.data(), BUFFER_SIZE, false);
+                    });
+}
+
 }  // namespace Vulkan
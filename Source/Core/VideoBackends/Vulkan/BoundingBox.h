@@ -11,6 +11,7 @@
 #include "Common/CommonTypes.h"
 
 #include "VideoBackends/Vulkan/VulkanLoader.h"
+#include "VideoCommon/BoundingBox.h"
 
 namespace Vulkan
 {
@@ -36,8 +37,13 @@ public:
 private:
   bool CreateGPUBuffer();
   bool CreateReadbackBuffer();
+  void RecordReadback(StagingBuffer* buffer);
   void Readback();
 
+  // Latency tolerant mode, see VideoConfig::bBBoxLatencyTolerant.
+  void QueueAsyncReadback();
+  void PollAsyncReadbacks();
+
   VkBuffer m_gpu_buffer = VK_NULL_HANDLE;
   VkDeviceMemory m_gpu_memory = VK_NULL_HANDLE;
 
@@ -47,6 +53,12 @@ private:
   std::unique_ptr<StagingBuffer> m_readback_buffer;
   std::array<bool, NUM_VALUES> m_values_dirty = {};
   bool m_valid = true;
+
+  using ReadbackRing = ::BoundingBox::ReadbackRing;
+  ReadbackRing m_async_ring;
+  std::array<std::unique_ptr<StagingBuffer>, ReadbackRing::NUM_SLOTS> m_async_buffers;
+  std::array<VkFence, ReadbackRing::NUM_SLOTS> m_async_fences = {};
+  std::array<bool, ReadbackRing::NUM_SLOTS> m_async_done = {};
 };
 
 }  // namespace Vulkan
@@ -15,7 +15,8 @@
 namespace Vulkan
 {
 CommandBufferManager::CommandBufferManager(bool use_threaded_submission)
-  : m_submit_semaphore(1, 1), m_use_threaded_submission(use_threaded_submission)
+  : m_submit_semaphore(MAX_PENDING_SUBMITS, MAX_PENDING_SUBMITS),
+    m_use_threaded_submission(use_threaded_submission)
 {
 }
 
@@ -25,7 +26,8 @@ CommandBufferManager::~CommandBufferManager()
   if (m_use_threaded_submission)
   {
     // Wait for all command buffers to be consumed by the worker thread.
-    m_submit_semaphore.Wait();
+    for (int i = 0; i < MAX_PENDING_SUBMITS; i++)
+      m_submit_semaphore.Wait();
     m_submit_loop->Stop();
     m_submit_thread.join();
   }
@@ -37,6 +39,10 @@ CommandBufferManager::~CommandBufferManager()
 
 bool CommandBufferManager::Initialize()
 {
+  // Like the submit thread, the compute queue is part of backend multithreading.
+  m_use_async_compute =
+    m_use_threaded_submission && g_vulkan_context->GetAsyncComputeQueue() != VK_NULL_HANDLE;
+
   if (!CreateCommandBuffers())
     return false;
 
@@ -54,6 +60,7 @@ bool CommandBufferManager::CreateCommandBuffers()
   for (FrameResources& resources : m_frame_resources)
   {
     resources.init_command_buffer_used = false;
+    resources.compute_command_buffer_used = false;
     resources.needs_fence_wait = false;
 
     VkCommandPoolCreateInfo pool_info = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, nullptr, 0,
@@ -87,6 +94,17 @@ bool CommandBufferManager::CreateCommandBuffers()
       return false;
     }
 
+    if (m_use_async_compute)
+    {
+      VkSemaphoreCreateInfo semaphore_info = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, nullptr, 0 };
+      res = vkCreateSemaphore(device, &semaphore_info, nullptr, &resources.compute_semaphore);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateSemaphore failed: ");
+        return false;
+      }
+    }
+
     // TODO: A better way to choose the number of descriptors.
     VkDescriptorPoolSize pool_sizes[] = { { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 500000 },
     { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 500000 },
@@ -130,6 +148,11 @@ void CommandBufferManager::DestroyCommandBuffers()
       vkDestroyFence(device, resources.fence, nullptr);
       resources.fence = VK_NULL_HANDLE;
     }
+    if (resources.compute_semaphore != VK_NULL_HANDLE)
+    {
+      vkDestroySemaphore(device, resources.compute_semaphore, nullptr);
+      resources.compute_semaphore = VK_NULL_HANDLE;
+    }
     if (resources.descriptor_pool != VK_NULL_HANDLE)
     {
       vkDestroyDescriptorPool(device, resources.descriptor_pool, nullptr);
@@ -207,8 +230,10 @@ void CommandBufferManager::PrepareToSubmitCommandBuffer()
 void CommandBufferManager::WaitForWorkerThreadIdle()
 {
   // Drain the semaphore, then allow another request in the future.
-  m_submit_semaphore.Wait();
-  m_submit_semaphore.Post();
+  for (int i = 0; i < MAX_PENDING_SUBMITS; i++)
+    m_submit_semaphore.Wait();
+  for (int i = 0; i < MAX_PENDING_SUBMITS; i++)
+    m_submit_semaphore.Post();
 }
 
 void CommandBufferManager::WaitForGPUIdle()
@@ -286,6 +311,16 @@ void CommandBufferManager::SubmitCommandBuffer(bool submit_on_worker_thread,
   }
   else
   {
+    // Command buffers still waiting for the worker thread have to reach the queue first. This one
+    // already holds a slot, so having all the other ones means the worker thread is idle.
+    if (m_use_threaded_submission)
+    {
+      for (int i = 1; i < MAX_PENDING_SUBMITS; i++)
+        m_submit_semaphore.Wait();
+      for (int i = 1; i < MAX_PENDING_SUBMITS; i++)
+        m_submit_semaphore.Post();
+    }
+
     // Pass through to normal submission path.
     SubmitCommandBuffer(m_current_frame, wait_semaphore, signal_semaphore, present_swap_chain,
       present_image_index);
@@ -300,13 +335,14 @@ void CommandBufferManager::SubmitCommandBuffer(size_t index, VkSemaphore wait_se
   FrameResources& resources = m_frame_resources[index];
 
   // This may be executed on the worker thread, so don't modify any state of the manager class.
-  uint32_t wait_bits = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  std::array<VkSemaphore, 2> wait_semaphores;
+  std::array<VkPipelineStageFlags, 2> wait_bits;
   VkSubmitInfo submit_info = { VK_STRUCTURE_TYPE_SUBMIT_INFO,
     nullptr,
     0,
-    nullptr,
-    &wait_bits,
-    static_cast<u32>(resources.command_buffers.size()),
+    wait_semaphores.data(),
+    wait_bits.data(),
+    2,
     resources.command_buffers.data(),
     0,
     nullptr };
@@ -320,8 +356,33 @@ void CommandBufferManager::SubmitCommandBuffer(size_t index, VkSemaphore wait_se
 
   if (wait_semaphore != VK_NULL_HANDLE)
   {
-    submit_info.pWaitSemaphores = &wait_semaphore;
-    submit_info.waitSemaphoreCount = 1;
+    wait_semaphores[submit_info.waitSemaphoreCount] = wait_semaphore;
+    wait_bits[submit_info.waitSemaphoreCount++] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  }
+
+  // The compute work only produces data that is copied by the graphics queue, so it runs
+  // alongside the previous command buffer and this one only waits for it at its transfers.
+  if (resources.compute_command_buffer_used)
+  {
+    VkSubmitInfo compute_submit_info = { VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      nullptr,
+      0,
+      nullptr,
+      nullptr,
+      1,
+      &resources.command_buffers[2],
+      1,
+      &resources.compute_semaphore };
+    VkResult res = vkQueueSubmit(g_vulkan_context->GetAsyncComputeQueue(), 1,
+      &compute_submit_info, VK_NULL_HANDLE);
+    if (res != VK_SUCCESS)
+    {
+      LOG_VULKAN_ERROR(res, "vkQueueSubmit failed: ");
+      PanicAlert("Failed to submit compute command buffer.");
+    }
+
+    wait_semaphores[submit_info.waitSemaphoreCount] = resources.compute_semaphore;
+    wait_bits[submit_info.waitSemaphoreCount++] = VK_PIPELINE_STAGE_TRANSFER_BIT;
   }
 
   if (signal_semaphore != VK_NULL_HANDLE)
@@ -424,6 +485,7 @@ void CommandBufferManager::ActivateCommandBuffer()
 
   // Reset upload command buffer state
   resources.init_command_buffer_used = false;
+  resources.compute_command_buffer_used = false;
 }
 
 void CommandBufferManager::ExecuteCommandBuffer(bool submit_off_thread, bool wait_for_completion)
@@ -45,6 +45,19 @@ public:
   {
     return m_frame_resources[m_current_frame].command_buffers[1];
   }
+  // Work recorded here runs on the async compute queue, ahead of both the init and the draw
+  // command buffer, which wait for it before any of their transfers. Returns VK_NULL_HANDLE when
+  // there is no such queue.
+  VkCommandBuffer GetCurrentComputeCommandBuffer()
+  {
+    if (!m_use_async_compute)
+      return VK_NULL_HANDLE;
+    m_frame_resources[m_current_frame].compute_command_buffer_used = true;
+    return m_frame_resources[m_current_frame].command_buffers[2];
+  }
+  bool UsesAsyncCompute() const { return m_use_async_compute; }
+  // Resources that are kept per command buffer can be indexed with this.
+  size_t GetCurrentCommandBufferIndex() const { return m_current_frame; }
   VkDescriptorPool GetCurrentDescriptorPool() const
   {
     return m_frame_resources[m_current_frame].descriptor_pool;
@@ -114,12 +127,15 @@ private:
 
   struct FrameResources
   {
-    // [0] - Init (upload) command buffer, [1] - draw command buffer
+    // [0] - Init (upload) command buffer, [1] - draw command buffer, [2] - async compute
     VkCommandPool command_pool;
-    std::array<VkCommandBuffer, 2> command_buffers;
+    std::array<VkCommandBuffer, 3> command_buffers;
     VkDescriptorPool descriptor_pool;
     VkFence fence;
+    // Signaled by the async compute submission, waited on by the graphics one.
+    VkSemaphore compute_semaphore;
     bool init_command_buffer_used;
+    bool compute_command_buffer_used;
     bool needs_fence_wait;
 
     std::vector<std::function<void()>> cleanup_resources;
@@ -133,7 +149,10 @@ private:
     m_fence_point_callbacks;
 
   // Threaded command buffer execution
-  // Semaphore determines when a command buffer can be queued
+  // Semaphore determines when a command buffer can be queued. Every command buffer except the one
+  // being built can wait for the worker thread, so a slow vkQueueSubmit or vkQueuePresentKHR
+  // doesn't hold up recording the next one.
+  static constexpr int MAX_PENDING_SUBMITS = static_cast<int>(NUM_COMMAND_BUFFERS) - 1;
   Common::Semaphore m_submit_semaphore;
   std::thread m_submit_thread;
   std::unique_ptr<Common::BlockingLoop> m_submit_loop;
@@ -149,6 +168,7 @@ private:
   std::mutex m_pending_submit_lock;
   Common::Flag m_present_failed_flag;
   bool m_use_threaded_submission = false;
+  bool m_use_async_compute = false;
 };
 
 extern std::unique_ptr<CommandBufferManager> g_command_buffer_mgr;
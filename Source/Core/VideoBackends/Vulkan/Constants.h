@@ -12,9 +12,9 @@
 
 namespace Vulkan
 {
-// Number of command buffers. Having two allows one buffer to be
-// executed whilst another is being built.
-constexpr size_t NUM_COMMAND_BUFFERS = 2;
+// Number of command buffers. One is being built, with threaded submission the others can wait
+// for the submit thread or execute meanwhile.
+constexpr size_t NUM_COMMAND_BUFFERS = 3;
 
 // Staging buffer usage - optimize for uploads or readbacks
 enum STAGING_BUFFER_TYPE
@@ -104,13 +104,17 @@ constexpr VkFormat TEXTURECACHE_TEXTURE_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
 constexpr size_t INITIAL_TEXTURE_UPLOAD_BUFFER_SIZE = 16 * 1024 * 1024;
 constexpr size_t MAXIMUM_TEXTURE_UPLOAD_BUFFER_SIZE = 64 * 1024 * 1024;
 
-// Textures greater than 1024*1024 will be put in staging textures that are released after
+// Textures greater than 1024*1024 will be put in pooled staging buffers that are recycled after
 // execution instead. A 2048x2048 texture is 16MB, and we'd only fit four of these in our
 // streaming buffer and be blocking frequently. Games are unlikely to have textures this
 // large anyway, so it's only really an issue for HD texture packs, and memory is not
 // a limiting factor in these scenarios anyway.
 constexpr size_t STAGING_TEXTURE_UPLOAD_THRESHOLD = 1024 * 1024 * 8;
 
+// Idle staging buffers for large uploads are kept around up to this total size, so loading a
+// hires texture pack doesn't allocate and free device memory for every texture.
+constexpr size_t MAXIMUM_LARGE_UPLOAD_BUFFER_POOL_SIZE = 128 * 1024 * 1024;
+
 // Streaming uniform buffer size
 constexpr size_t INITIAL_UNIFORM_STREAM_BUFFER_SIZE = 16 * 1024 * 1024;
 constexpr size_t MAXIMUM_UNIFORM_STREAM_BUFFER_SIZE = 32 * 1024 * 1024;
@@ -705,7 +705,7 @@ void FramebufferManager::DestroyConversionShaders()
 
 u32 FramebufferManager::PeekEFBColor(u32 x, u32 y)
 {
-  if (!m_color_readback_texture_valid && !PopulateColorReadbackTexture())
+  if (!m_color_readback_tiles_valid[GetPeekTileIndex(x, y)] && !PopulateColorReadbackTexture())
     return 0;
 
   u32 value;
@@ -761,9 +761,8 @@ bool FramebufferManager::PopulateColorReadbackTexture()
   // Copy from EFB or copy texture to staging texture.
   src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-  m_color_readback_texture->CopyFromImage(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-    src_texture->GetImage(), src_aspect, 0, 0, EFB_WIDTH,
-    EFB_HEIGHT, 0, 0);
+  CopyInvalidPeekTiles(m_color_readback_texture.get(), m_color_readback_tiles_valid, src_texture,
+                       src_aspect);
 
   // Restore original layout if we used the EFB as a source.
   if (src_texture == m_efb_color_texture.get())
@@ -779,13 +778,13 @@ bool FramebufferManager::PopulateColorReadbackTexture()
   if (!m_color_readback_texture->IsMapped() && !m_color_readback_texture->Map())
     return false;
 
-  m_color_readback_texture_valid = true;
+  m_color_readback_tiles_valid.fill(true);
   return true;
 }
 
 float FramebufferManager::PeekEFBDepth(u32 x, u32 y)
 {
-  if (!m_depth_readback_texture_valid && !PopulateDepthReadbackTexture())
+  if (!m_depth_readback_tiles_valid[GetPeekTileIndex(x, y)] && !PopulateDepthReadbackTexture())
     return 0.0f;
 
   float value;
@@ -845,9 +844,8 @@ bool FramebufferManager::PopulateDepthReadbackTexture()
   // Copy from EFB or copy texture to staging texture.
   src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-  m_depth_readback_texture->CopyFromImage(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-    src_texture->GetImage(), src_aspect, 0, 0, EFB_WIDTH,
-    EFB_HEIGHT, 0, 0);
+  CopyInvalidPeekTiles(m_depth_readback_texture.get(), m_depth_readback_tiles_valid, src_texture,
+                       src_aspect);
 
   // Restore original layout if we used the EFB as a source.
   if (src_texture == m_efb_depth_texture.get())
@@ -863,14 +861,58 @@ bool FramebufferManager::PopulateDepthReadbackTexture()
   if (!m_depth_readback_texture->IsMapped() && !m_depth_readback_texture->Map())
     return false;
 
-  m_depth_readback_texture_valid = true;
+  m_depth_readback_tiles_valid.fill(true);
   return true;
 }
 
 void FramebufferManager::InvalidatePeekCache()
 {
-  m_color_readback_texture_valid = false;
-  m_depth_readback_texture_valid = false;
+  m_color_readback_tiles_valid.fill(false);
+  m_depth_readback_tiles_valid.fill(false);
+}
+
+void FramebufferManager::InvalidatePeekCache(const EFBRectangle& rc)
+{
+  if (rc.left >= rc.right || rc.top >= rc.bottom)
+    return;
+
+  u32 first_x = static_cast<u32>(std::max(rc.left, 0)) / PEEK_TILE_SIZE;
+  u32 first_y = static_cast<u32>(std::max(rc.top, 0)) / PEEK_TILE_SIZE;
+  u32 last_x = std::min(static_cast<u32>(rc.right - 1) / PEEK_TILE_SIZE, PEEK_TILES_WIDE - 1);
+  u32 last_y = std::min(static_cast<u32>(rc.bottom - 1) / PEEK_TILE_SIZE, PEEK_TILES_HIGH - 1);
+  for (u32 tile_y = first_y; tile_y <= last_y; tile_y++)
+  {
+    for (u32 tile_x = first_x; tile_x <= last_x; tile_x++)
+    {
+      m_color_readback_tiles_valid[tile_y * PEEK_TILES_WIDE + tile_x] = false;
+      m_depth_readback_tiles_valid[tile_y * PEEK_TILES_WIDE + tile_x] = false;
+    }
+  }
+}
+
+EFBRectangle FramebufferManager::GetPeekTileRect(u32 index)
+{
+  u32 left = (index % PEEK_TILES_WIDE) * PEEK_TILE_SIZE;
+  u32 top = (index / PEEK_TILES_WIDE) * PEEK_TILE_SIZE;
+  u32 right = std::min(left + PEEK_TILE_SIZE, static_cast<u32>(EFB_WIDTH));
+  u32 bottom = std::min(top + PEEK_TILE_SIZE, static_cast<u32>(EFB_HEIGHT));
+  return EFBRectangle(left, top, right, bottom);
+}
+
+void FramebufferManager::CopyInvalidPeekTiles(StagingTexture2D* dst_texture,
+                                              const PeekTiles& valid_tiles, Texture2D* src_texture,
+                                              VkImageAspectFlags src_aspect)
+{
+  for (u32 i = 0; i < valid_tiles.size(); i++)
+  {
+    if (valid_tiles[i])
+      continue;
+
+    EFBRectangle rc = GetPeekTileRect(i);
+    dst_texture->CopyFromImage(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+                               src_texture->GetImage(), src_aspect, rc.left, rc.top,
+                               rc.GetWidth(), rc.GetHeight(), 0, 0);
+  }
 }
 
 bool FramebufferManager::CreateReadbackRenderPasses()
@@ -1058,10 +1100,10 @@ void FramebufferManager::DestroyReadbackTextures()
 {
   m_color_copy_texture.reset();
   m_color_readback_texture.reset();
-  m_color_readback_texture_valid = false;
+  m_color_readback_tiles_valid.fill(false);
   m_depth_copy_texture.reset();
   m_depth_readback_texture.reset();
-  m_depth_readback_texture_valid = false;
+  m_depth_readback_tiles_valid.fill(false);
 }
 
 bool FramebufferManager::CreateReadbackFramebuffer()
@@ -1123,7 +1165,7 @@ void FramebufferManager::PokeEFBColor(u32 x, u32 y, u32 color)
   CreatePokeVertices(&m_color_poke_vertices, x, y, 0.0f, color);
 
   // Update the peek cache if it's valid, since we know the color of the pixel now.
-  if (m_color_readback_texture_valid)
+  if (m_color_readback_tiles_valid[GetPeekTileIndex(x, y)])
     m_color_readback_texture->WriteTexel(x, y, &color, sizeof(color));
 }
 
@@ -1136,7 +1178,7 @@ void FramebufferManager::PokeEFBDepth(u32 x, u32 y, float depth)
   CreatePokeVertices(&m_depth_poke_vertices, x, y, depth, 0);
 
   // Update the peek cache if it's valid, since we know the color of the pixel now.
-  if (m_depth_readback_texture_valid)
+  if (m_depth_readback_tiles_valid[GetPeekTileIndex(x, y)])
     m_depth_readback_texture->WriteTexel(x, y, &depth, sizeof(depth));
 }
 
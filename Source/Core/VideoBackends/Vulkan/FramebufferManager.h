@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <utility>
 
@@ -79,6 +80,8 @@ public:
   u32 PeekEFBColor(u32 x, u32 y);
   float PeekEFBDepth(u32 x, u32 y);
   void InvalidatePeekCache();
+  // Only drops the tiles of the peek cache that overlap rc, in EFB coordinates.
+  void InvalidatePeekCache(const EFBRectangle& rc);
 
   // Writes a value to the framebuffer. This will never block, and writes will be batched.
   void PokeEFBColor(u32 x, u32 y, u32 color);
@@ -151,8 +154,20 @@ private:
   // CPU-side EFB readback texture
   std::unique_ptr<StagingTexture2D> m_color_readback_texture;
   std::unique_ptr<StagingTexture2D> m_depth_readback_texture;
-  bool m_color_readback_texture_valid = false;
-  bool m_depth_readback_texture_valid = false;
+  // The readback textures are kept per tile, a miss reads back every tile that isn't valid.
+  static constexpr u32 PEEK_TILE_SIZE = 64;
+  static constexpr u32 PEEK_TILES_WIDE = (EFB_WIDTH + PEEK_TILE_SIZE - 1) / PEEK_TILE_SIZE;
+  static constexpr u32 PEEK_TILES_HIGH = (EFB_HEIGHT + PEEK_TILE_SIZE - 1) / PEEK_TILE_SIZE;
+  using PeekTiles = std::array<bool, PEEK_TILES_WIDE * PEEK_TILES_HIGH>;
+  static u32 GetPeekTileIndex(u32 x, u32 y)
+  {
+    return (y / PEEK_TILE_SIZE) * PEEK_TILES_WIDE + (x / PEEK_TILE_SIZE);
+  }
+  static EFBRectangle GetPeekTileRect(u32 index);
+  void CopyInvalidPeekTiles(StagingTexture2D* dst_texture, const PeekTiles& valid_tiles,
+                            Texture2D* src_texture, VkImageAspectFlags src_aspect);
+  PeekTiles m_color_readback_tiles_valid = {};
+  PeekTiles m_depth_readback_tiles_valid = {};
 
   // EFB poke drawing setup
   std::unique_ptr<VertexFormat> m_poke_vertex_format;
@@ -209,6 +209,10 @@ void VulkanPostProcessingShader::Draw(PostProcessor* p,
     if (!pass.enabled)
       continue;
 
+    // Static passes keep their output while the source is the same
+    if (pass.IsOutputCached(src_rect, src_size, src_layer, gamma))
+      continue;
+
     if (!(is_last_pass && skip_final_copy))
     {
       // Force output build
@@ -334,6 +338,7 @@ void VulkanPostProcessingShader::Draw(PostProcessor* p,
       static_cast<int>(src_texture->GetWidth()),
       static_cast<int>(src_texture->GetHeight()));
     draw.EndRenderPass();
+    m_passes[pass_index].SetOutputCached(src_rect, src_size, src_layer, gamma);
   }
 
   // Copy the last pass output to the target if not done already
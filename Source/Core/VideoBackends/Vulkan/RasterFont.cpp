@@ -123,8 +123,6 @@ static const char VERTEX_SHADER_SOURCE[] = R"(
 
 layout(std140, push_constant) uniform PCBlock {
   vec2 char_size;
-  vec2 offset;
-  vec4 color;
 } PC;
 
 layout(location = 0) in vec4 ipos;
@@ -132,12 +130,14 @@ layout(location = 5) in vec4 icol0;
 layout(location = 8) in vec3 itex0;
 
 layout(location = 0) out vec2 uv0;
+layout(location = 1) out vec4 col0;
 
 void main()
 {
-  gl_Position = vec4(ipos.xy + PC.offset, 0.0f, 1.0f);
+  gl_Position = vec4(ipos.xy, 0.0f, 1.0f);
   gl_Position.y = -gl_Position.y;
   uv0 = itex0.xy * PC.char_size;
+  col0 = icol0;
 }
 
 )";
@@ -146,19 +146,18 @@ static const char FRAGMENT_SHADER_SOURCE[] = R"(
 
 layout(std140, push_constant) uniform PCBlock {
   vec2 char_size;
-  vec2 offset;
-  vec4 color;
 } PC;
 
 layout(set = 1, binding = 0) uniform sampler2DArray samp0;
 
 layout(location = 0) in vec2 uv0;
+layout(location = 1) in vec4 col0;
 
 layout(location = 0) out vec4 ocol0;
 
 void main()
 {
-  ocol0 = texture(samp0, float3(uv0, 0.0)) * PC.color;
+  ocol0 = texture(samp0, float3(uv0, 0.0)) * col0;
 }
 
 )";
@@ -300,37 +299,30 @@ bool RasterFont::CreateShaders()
   return m_vertex_shader != VK_NULL_HANDLE && m_fragment_shader != VK_NULL_HANDLE;
 }
 
-void RasterFont::PrintMultiLineText(VkRenderPass render_pass, const std::string& text,
-  float start_x, float start_y, u32 bbWidth, u32 bbHeight,
-  u32 color)
+void RasterFont::BuildVertices(const std::string& text, CachedText* entry)
 {
-  // skip empty strings
-  if (text.empty())
-    return;
+  std::vector<UtilityShaderVertex>& vertices = entry->vertices;
+  vertices.clear();
 
-  UtilityShaderDraw draw(g_command_buffer_mgr->GetCurrentCommandBuffer(),
-    g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_PUSH_CONSTANT),
-    render_pass, m_vertex_shader, VK_NULL_HANDLE, m_fragment_shader,
-    PrimitiveType::Triangles);
-
-  UtilityShaderVertex* vertices = draw.ReserveVertices(text.length() * 6);
-  size_t num_vertices = 0;
-  if (!vertices)
-    return;
+  float delta_x = float(2 * CHARACTER_WIDTH) / float(entry->bbWidth);
+  float delta_y = float(2 * CHARACTER_HEIGHT) / float(entry->bbHeight);
+  float border_x = 2.0f / float(entry->bbWidth);
+  float border_y = 4.0f / float(entry->bbHeight);
 
-  float delta_x = float(2 * CHARACTER_WIDTH) / float(bbWidth);
-  float delta_y = float(2 * CHARACTER_HEIGHT) / float(bbHeight);
-  float border_x = 2.0f / float(bbWidth);
-  float border_y = 4.0f / float(bbHeight);
+  float x = entry->x;
+  float y = entry->y;
 
-  float x = float(start_x);
-  float y = float(start_y);
+  // The text color is ARGB, the vertex color is RGBA.
+  const u32 text_color = ((entry->color >> 16) & 0xFF) | (entry->color & 0xFF00FF00) |
+                         ((entry->color & 0xFF) << 16);
+  const u32 shadow_color = entry->color & 0xFF000000;
 
+  UtilityShaderVertex vertex;
   for (const char& c : text)
   {
     if (c == '\n')
     {
-      x = float(start_x);
+      x = entry->x;
       y -= delta_y + border_y;
       continue;
     }
@@ -345,77 +337,134 @@ void RasterFont::PrintMultiLineText(VkRenderPass render_pass, const std::string&
     if (c < CHARACTER_OFFSET || c >= CHARACTER_COUNT + CHARACTER_OFFSET)
       continue;
 
-    vertices[num_vertices].SetPosition(x, y);
-    vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET), 0.0f);
-    num_vertices++;
-
-    vertices[num_vertices].SetPosition(x + delta_x, y);
-    vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET + 1),
-      0.0f);
-    num_vertices++;
-
-    vertices[num_vertices].SetPosition(x + delta_x, y + delta_y);
-    vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET + 1),
-      1.0f);
-    num_vertices++;
+    const float u0 = static_cast<float>(c - CHARACTER_OFFSET);
+    const float u1 = u0 + 1.0f;
+    const float quad[6][4] = {{x, y, u0, 0.0f},
+                              {x + delta_x, y, u1, 0.0f},
+                              {x + delta_x, y + delta_y, u1, 1.0f},
+                              {x, y, u0, 0.0f},
+                              {x + delta_x, y + delta_y, u1, 1.0f},
+                              {x, y + delta_y, u0, 1.0f}};
+    for (const auto& corner : quad)
+    {
+      vertex.SetPosition(corner[0], corner[1]);
+      vertex.SetTextureCoordinates(corner[2], corner[3]);
+      vertex.SetColor(text_color);
+      vertices.push_back(vertex);
+    }
 
-    vertices[num_vertices].SetPosition(x, y);
-    vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET), 0.0f);
-    num_vertices++;
+    x += delta_x + border_x;
+  }
 
-    vertices[num_vertices].SetPosition(x + delta_x, y + delta_y);
-    vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET + 1),
-      1.0f);
-    num_vertices++;
+  const float shadow_x = 2.0f / entry->bbWidth;
+  const float shadow_y = -2.0f / entry->bbHeight;
+  const size_t count = vertices.size();
+  vertices.resize(count * 2);
+  for (size_t i = 0; i < count; i++)
+  {
+    vertices[count + i] = vertices[i];
+    vertices[i].Position[0] += shadow_x;
+    vertices[i].Position[1] += shadow_y;
+    vertices[i].SetColor(shadow_color);
+  }
+}
 
-    vertices[num_vertices].SetPosition(x, y + delta_y);
-    vertices[num_vertices].SetTextureCoordinates(static_cast<float>(c - CHARACTER_OFFSET), 1.0f);
-    num_vertices++;
+void RasterFont::PrintMultiLineText(const std::string& text, float start_x, float start_y,
+  u32 bbWidth, u32 bbHeight, u32 color)
+{
+  // skip empty strings
+  if (text.empty())
+    return;
 
-    x += delta_x + border_x;
+  // The same text may be printed several times with different parameters.
+  std::string key = text;
+  key.push_back('\0');
+  key.append(reinterpret_cast<const char*>(&start_x), sizeof(start_x));
+  key.append(reinterpret_cast<const char*>(&start_y), sizeof(start_y));
+  key.append(reinterpret_cast<const char*>(&bbWidth), sizeof(bbWidth));
+  key.append(reinterpret_cast<const char*>(&bbHeight), sizeof(bbHeight));
+  key.append(reinterpret_cast<const char*>(&color), sizeof(color));
+
+  auto result = m_text_cache.emplace(std::move(key), CachedText());
+  CachedText& entry = result.first->second;
+  if (result.second)
+  {
+    entry.x = start_x;
+    entry.y = start_y;
+    entry.bbWidth = bbWidth;
+    entry.bbHeight = bbHeight;
+    entry.color = color;
+    BuildVertices(text, &entry);
   }
+  entry.last_frame = m_frame;
 
   // skip all whitespace strings
-  if (num_vertices == 0)
-    return;
+  if (!entry.vertices.empty())
+    m_queued.push_back(&entry);
+}
 
-  draw.CommitVertices(num_vertices);
+void RasterFont::Flush(VkRenderPass render_pass)
+{
+  size_t num_vertices = 0;
+  for (const CachedText* entry : m_queued)
+    num_vertices += entry->vertices.size();
 
-  struct PCBlock
+  if (num_vertices > 0)
   {
-    float char_size[2];
-    float offset[2];
-    float color[4];
-  } pc_block = {};
-
-  pc_block.char_size[0] = 1.0f / static_cast<float>(CHARACTER_COUNT);
-  pc_block.char_size[1] = 1.0f;
-
-  // shadows
-  pc_block.offset[0] = 2.0f / bbWidth;
-  pc_block.offset[1] = -2.0f / bbHeight;
-  pc_block.color[3] = (color >> 24) / 255.0f;
-
-  draw.SetPushConstants(&pc_block, sizeof(pc_block));
-  draw.SetPSSampler(0, m_texture->GetView(), g_object_cache->GetLinearSampler());
-
-  // Setup alpha blending
-  BlendingState blend_state = RenderState::GetNoBlendingBlendState();
-  blend_state.blendenable = true;
-  blend_state.srcfactor = BlendMode::SRCALPHA;
-  blend_state.dstfactor = BlendMode::INVSRCALPHA;
-  draw.SetBlendState(blend_state);
-
-  draw.Draw();
-
-  // non-shadowed part
-  pc_block.offset[0] = 0.0f;
-  pc_block.offset[1] = 0.0f;
-  pc_block.color[0] = ((color >> 16) & 0xFF) / 255.0f;
-  pc_block.color[1] = ((color >> 8) & 0xFF) / 255.0f;
-  pc_block.color[2] = (color & 0xFF) / 255.0f;
-  draw.SetPushConstants(&pc_block, sizeof(pc_block));
-  draw.Draw();
+    UtilityShaderDraw draw(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+      g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_PUSH_CONSTANT),
+      render_pass, m_vertex_shader, VK_NULL_HANDLE, m_fragment_shader,
+      PrimitiveType::Triangles);
+
+    UtilityShaderVertex* vertices = draw.ReserveVertices(num_vertices);
+    if (vertices)
+    {
+      // All shadows first, so that no text is covered by the shadow of a later string.
+      UtilityShaderVertex* out = vertices;
+      for (const CachedText* entry : m_queued)
+      {
+        const size_t half = entry->vertices.size() / 2;
+        std::memcpy(out, entry->vertices.data(), half * sizeof(UtilityShaderVertex));
+        out += half;
+      }
+      for (const CachedText* entry : m_queued)
+      {
+        const size_t half = entry->vertices.size() / 2;
+        std::memcpy(out, entry->vertices.data() + half, half * sizeof(UtilityShaderVertex));
+        out += half;
+      }
+      draw.CommitVertices(num_vertices);
+
+      struct PCBlock
+      {
+        float char_size[2];
+      } pc_block = {};
+      pc_block.char_size[0] = 1.0f / static_cast<float>(CHARACTER_COUNT);
+      pc_block.char_size[1] = 1.0f;
+      draw.SetPushConstants(&pc_block, sizeof(pc_block));
+      draw.SetPSSampler(0, m_texture->GetView(), g_object_cache->GetLinearSampler());
+
+      // Setup alpha blending
+      BlendingState blend_state = RenderState::GetNoBlendingBlendState();
+      blend_state.blendenable = true;
+      blend_state.srcfactor = BlendMode::SRCALPHA;
+      blend_state.dstfactor = BlendMode::INVSRCALPHA;
+      draw.SetBlendState(blend_state);
+
+      draw.Draw();
+    }
+  }
+  m_queued.clear();
+
+  // Drop the strings which were not printed this frame.
+  for (auto it = m_text_cache.begin(); it != m_text_cache.end();)
+  {
+    if (it->second.last_frame != m_frame)
+      it = m_text_cache.erase(it);
+    else
+      ++it;
+  }
+  m_frame++;
 }
 
 }  // namespace Vulkan
@@ -6,15 +6,20 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
 #include "VideoBackends/Vulkan/Constants.h"
+#include "VideoBackends/Vulkan/Util.h"
 
 namespace Vulkan
 {
 class Texture2D;
 
+// Text is queued by PrintMultiLineText and drawn by Flush with a single draw per frame.
+// The vertices of a string are kept for as long as it is printed every frame.
 class RasterFont
 {
 public:
@@ -25,12 +30,28 @@ public:
 
   bool Initialize();
 
-  void PrintMultiLineText(VkRenderPass render_pass, const std::string& text, float start_x,
-    float start_y, u32 bbWidth, u32 bbHeight, u32 color);
+  void PrintMultiLineText(const std::string& text, float start_x, float start_y, u32 bbWidth,
+    u32 bbHeight, u32 color);
+  void Flush(VkRenderPass render_pass);
 
 private:
+  struct CachedText
+  {
+    float x, y;
+    u32 bbWidth, bbHeight;
+    u32 color;
+    u64 last_frame;
+    // Shadow quads followed by the same number of text quads.
+    std::vector<UtilityShaderVertex> vertices;
+  };
+
   bool CreateTexture();
   bool CreateShaders();
+  void BuildVertices(const std::string& text, CachedText* entry);
+
+  std::unordered_map<std::string, CachedText> m_text_cache;
+  std::vector<const CachedText*> m_queued;
+  u64 m_frame = 0;
 
   std::unique_ptr<Texture2D> m_texture;
 
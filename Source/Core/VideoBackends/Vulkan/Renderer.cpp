@@ -12,6 +12,7 @@
 
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
 
 #include "Core/Core.h"
 
@@ -187,7 +188,7 @@ void Renderer::RenderText(const std::string& text, int left, int top, u32 color)
   u32 backbuffer_width = m_swap_chain->GetWidth();
   u32 backbuffer_height = m_swap_chain->GetHeight();
 
-  m_raster_font->PrintMultiLineText(m_swap_chain->GetRenderAppendPass(), text,
+  m_raster_font->PrintMultiLineText(text,
     left * 2.0f / static_cast<float>(backbuffer_width) - 1,
     1 - top * 2.0f / static_cast<float>(backbuffer_height),
     backbuffer_width, backbuffer_height, color);
@@ -349,6 +350,8 @@ void Renderer::BeginFrame()
 void Renderer::ClearScreen(const EFBRectangle& rc, bool color_enable, bool alpha_enable,
   bool z_enable, u32 color, u32 z)
 {
+  FramebufferManager::GetInstance()->InvalidatePeekCache(rc);
+
   // Native -> EFB coordinates
   TargetRectangle target_rc = Renderer::ConvertEFBRectangle(rc);
 
@@ -493,6 +496,7 @@ void Renderer::ReinterpretPixelData(unsigned int convtype)
 {
   StateTracker::GetInstance()->EndRenderPass();
   StateTracker::GetInstance()->SetPendingRebind();
+  FramebufferManager::GetInstance()->InvalidatePeekCache();
   FramebufferManager::GetInstance()->ReinterpretPixelData(convtype);
 
   // EFB framebuffer has now changed, so update accordingly.
@@ -525,6 +529,22 @@ void Renderer::SwapImpl(u32 xfb_addr, u32 fb_width, u32 fb_stride, u32 fb_height
   StateTracker::GetInstance()->EndRenderPass();
   StateTracker::GetInstance()->OnEndFrame();
 
+  // Let the user know ubershaders are being drawn with while pipelines compile.
+  const size_t pending_pipelines = g_shader_cache->GetPendingPipelineCount();
+  const size_t pending_shaders = g_shader_cache->GetPendingShaderCount();
+  if (pending_pipelines > 0)
+  {
+    OSD::AddTypedMessage(OSD::MessageType::PendingPipelines,
+                         StringFromFormat("Compiling %zu pipelines...", pending_pipelines),
+                         OSD::Duration::SHORT, OSD::Color::CYAN);
+  }
+  else if (pending_shaders > 0)
+  {
+    OSD::AddTypedMessage(OSD::MessageType::PendingPipelines,
+                         StringFromFormat("Compiling %zu shaders...", pending_shaders),
+                         OSD::Duration::SHORT, OSD::Color::CYAN);
+  }
+
 
   // There are a few variables which can alter the final window draw rectangle, and some of them
   // are determined by guest state. Currently, the only way to catch these is to update every frame.
@@ -707,6 +727,7 @@ void Renderer::InsertBlackFrame()
     DrawDebugText();
     OSD::DoCallbacks(OSD::CallbackType::OnFrame);
     OSD::DrawMessages();
+    m_raster_font->Flush(m_swap_chain->GetRenderAppendPass());
 
     // End drawing to backbuffer
     vkCmdEndRenderPass(g_command_buffer_mgr->GetCurrentCommandBuffer());
@@ -905,6 +926,7 @@ void Renderer::DrawScreen(const TargetRectangle& scaled_efb_rect, u32 xfb_addr,
   DrawDebugText();
   OSD::DoCallbacks(OSD::CallbackType::OnFrame);
   OSD::DrawMessages();
+  m_raster_font->Flush(m_swap_chain->GetRenderAppendPass());
 
   // End drawing to backbuffer
   vkCmdEndRenderPass(g_command_buffer_mgr->GetCurrentCommandBuffer());
@@ -1031,14 +1053,15 @@ StagingTexture2D* Renderer::PrepareFrameDumpImage(u32 width, u32 height, u64 tic
   // the next image to it.
   FinishFrameData();
 
-  // If the last image hasn't been written to the frame dump yet, write it now.
-  // This is necessary so that the worker thread is no more than one frame behind, and the pointer
-  // (which is actually the buffer) is safe for us to re-use next time.
-  if (m_frame_dump_images[m_current_frame_dump_image].pending)
-    WriteFrameDumpImage(m_current_frame_dump_image);
-
-  // Move to the next image buffer
+  // Move to the next image buffer. The worker thread got it last time and is done with it now.
   m_current_frame_dump_image = (m_current_frame_dump_image + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+
+  // Write the oldest image to the frame dump, its copy was submitted two frames ago, so it has
+  // most likely completed. This frees it for the next frame.
+  const size_t oldest_image = (m_current_frame_dump_image + 1) % FRAME_DUMP_BUFFERED_FRAMES;
+  if (m_frame_dump_images[oldest_image].pending)
+    WriteFrameDumpImage(oldest_image);
+
   FrameDumpImage& image = m_frame_dump_images[m_current_frame_dump_image];
 
   // Ensure the dimensions of the readback texture are sufficient.
@@ -1070,12 +1093,12 @@ StagingTexture2D* Renderer::PrepareFrameDumpImage(u32 width, u32 height, u64 tic
 void Renderer::FlushFrameDump()
 {
   // We must write frames in order, so this is why we use a counter rather than a range.
+  // The oldest frame is the one after the current image.
   for (size_t i = 0; i < FRAME_DUMP_BUFFERED_FRAMES; i++)
   {
+    m_current_frame_dump_image = (m_current_frame_dump_image + 1) % FRAME_DUMP_BUFFERED_FRAMES;
     if (m_frame_dump_images[m_current_frame_dump_image].pending)
       WriteFrameDumpImage(m_current_frame_dump_image);
-
-    m_current_frame_dump_image = (m_current_frame_dump_image + 1) % FRAME_DUMP_BUFFERED_FRAMES;
   }
 
   // Since everything has been written now, may as well start at index zero.
@@ -1298,6 +1321,11 @@ void Renderer::CheckForConfigChanges()
     g_command_buffer_mgr->WaitForGPUIdle();
     m_swap_chain->SetVSync(g_ActiveConfig.IsVSync());
   }
+  if (m_swap_chain && g_ActiveConfig.bLowLatency != m_swap_chain->IsLowLatencyEnabled())
+  {
+    g_command_buffer_mgr->WaitForGPUIdle();
+    m_swap_chain->SetLowLatency(g_ActiveConfig.bLowLatency);
+  }
 
   // Wipe sampler cache if force texture filtering or anisotropy changes.
   if (anisotropy_changed || filtering_changed)
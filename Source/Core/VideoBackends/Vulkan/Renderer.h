@@ -131,7 +131,7 @@ private:
   // NOTE: Assumes that frame.ticks and frame.pending are valid.
   void WriteFrameDumpImage(size_t index);
 
-  // If there is a pending frame in this buffer, writes it to the frame dump.
+  // Writes the oldest pending frame to the frame dump.
   // Ensures that the specified readback buffer meets the size requirements of the current frame.
   StagingTexture2D* PrepareFrameDumpImage(u32 width, u32 height, u64 ticks);
 
@@ -167,8 +167,8 @@ private:
   // Texture used for screenshot/frame dumping
   std::unique_ptr<Texture2D> m_frame_dump_render_texture;
 
-  // Readback resources for frame dumping
-  static const size_t FRAME_DUMP_BUFFERED_FRAMES = 2;
+  // Readback resources for frame dumping, frames are written two frames after they were copied.
+  static const size_t FRAME_DUMP_BUFFERED_FRAMES = 3;
   struct FrameDumpImage
   {
     std::unique_ptr<StagingTexture2D> readback_texture;
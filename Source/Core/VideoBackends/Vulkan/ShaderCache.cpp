@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <deque>
 #include <sstream>
 #include <type_traits>
 #include <xxhash.h>
@@ -14,6 +15,7 @@
 #include "Common/CommonFuncs.h"
 #include "Common/LinearDiskCache.h"
 #include "Common/MsgHandler.h"
+#include "Common/ThreadPool.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Host.h"
@@ -25,6 +27,7 @@
 #include "VideoBackends/Vulkan/VertexFormat.h"
 #include "VideoBackends/Vulkan/VulkanContext.h"
 #include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/ShaderUIDBundle.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/UberShaderPixel.h"
 #include "VideoCommon/UberShaderVertex.h"
@@ -34,6 +37,117 @@ namespace Vulkan
 {
 std::unique_ptr<ShaderCache> g_shader_cache;
 
+// Compiles pipelines on the shared thread pool. Pipelines needed to draw the current frame are
+// taken before any of the background work, such as precompiling the pipeline UID cache. The less
+// used part of the shader UID cache comes last.
+class ShaderCache::PipelineCompilePool final : Common::IWorker
+{
+public:
+  PipelineCompilePool() { Common::ThreadPool::RegisterWorker(this); }
+  ~PipelineCompilePool() { Common::ThreadPool::UnregisterWorker(this); }
+
+  bool NextTask(size_t ID) override
+  {
+    AsyncPipeline* pipeline = nullptr;
+    std::function<void()> shader;
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      pipeline = Pop(m_high_priority);
+      if (!pipeline)
+        pipeline = Pop(m_low_priority);
+      if (!pipeline && !m_shaders.empty())
+      {
+        shader = std::move(m_shaders.front());
+        m_shaders.pop_front();
+      }
+      if (!pipeline && !shader)
+        return false;
+      m_running++;
+    }
+    if (pipeline)
+      pipeline->cache->CompileAsyncPipeline(*pipeline);
+    else
+      shader();
+    m_running--;
+    return true;
+  }
+
+  void Queue(AsyncPipeline* pipeline, bool high_priority)
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      (high_priority ? m_high_priority : m_low_priority).push_back(pipeline);
+    }
+    Common::ThreadPool::NotifyWorkPending();
+  }
+
+  void QueueShader(std::function<void()>&& compile)
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_shaders.push_back(std::move(compile));
+    }
+    Common::ThreadPool::NotifyWorkPending();
+  }
+
+  void Cancel()
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_high_priority.clear();
+      m_low_priority.clear();
+      m_shaders.clear();
+    }
+    size_t loop_count = 0;
+    while (m_running.load() > 0)
+      Common::cYield(loop_count++);
+  }
+
+private:
+  // A pipeline moved to the high priority queue is still in the low priority one, skip it there.
+  static AsyncPipeline* Pop(std::deque<AsyncPipeline*>& queue)
+  {
+    while (!queue.empty())
+    {
+      AsyncPipeline* pipeline = queue.front();
+      queue.pop_front();
+      if (!pipeline->started.test_and_set())
+        return pipeline;
+    }
+    return nullptr;
+  }
+
+  std::mutex m_lock;
+  std::deque<AsyncPipeline*> m_high_priority;
+  std::deque<AsyncPipeline*> m_low_priority;
+  std::deque<std::function<void()>> m_shaders;
+  std::atomic<s32> m_running{0};
+};
+
+ShaderCache::PipelineCompilePool& ShaderCache::GetCompilePool()
+{
+  // Outlives every ShaderCache, pool threads may still look at it after a cache is destroyed.
+  static PipelineCompilePool pool;
+  return pool;
+}
+
+// Returns the module of it, compiling it on the calling thread unless another thread already is,
+// in which case this waits for that thread to finish.
+template <typename CompileFunc>
+static VkShaderModule GetOrCompileShaderModule(ShaderCache::vkShaderItem& it, CompileFunc compile)
+{
+  if (!it.initialized.test_and_set())
+  {
+    compile();
+    return it.module;
+  }
+
+  size_t loop_count = 0;
+  while (!it.compiled.load())
+    Common::cYield(loop_count++);
+  return it.module;
+}
+
 ShaderCache::ShaderCache()
 {
 }
@@ -247,12 +361,15 @@ VkPipeline ShaderCache::CreatePipeline(const PipelineInfo& info)
   static constexpr std::array<VkPrimitiveTopology, 4> vk_primitive_topologies = {
     { VK_PRIMITIVE_TOPOLOGY_POINT_LIST, VK_PRIMITIVE_TOPOLOGY_LINE_LIST,
     VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP } };
+  // IndexGenerator separates triangle strips with 0xFFFF, this has no effect on non-indexed draws.
+  const VkPrimitiveTopology topology =
+      vk_primitive_topologies[static_cast<u32>(info.rasterization_state.primitive.Value())];
   VkPipelineInputAssemblyStateCreateInfo input_assembly_state = {
       VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
       nullptr,                  // const void*                                pNext
       0,                        // VkPipelineInputAssemblyStateCreateFlags    flags
-      vk_primitive_topologies[static_cast<u32>(info.rasterization_state.primitive.Value())],  // VkPrimitiveTopology
-      VK_FALSE                  // VkBool32                                   primitiveRestartEnable
+      topology,                 // VkPrimitiveTopology                        topology
+      topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP  // VkBool32             primitiveRestartEnable
   };
 
   // Shaders to stages
@@ -276,14 +393,22 @@ VkPipeline ShaderCache::CreatePipeline(const PipelineInfo& info)
                                           info.gs,
                                           "main"};
   }
+  static const std::array<VkSpecializationMapEntry, 2> ps_constant_entries = {{
+      {0, offsetof(UberShader::PixelUberShaderConstants, num_tev_stages), sizeof(u32)},
+      {1, offsetof(UberShader::PixelUberShaderConstants, alpha_test), sizeof(u32)}}};
+  const VkSpecializationInfo ps_specialization = {
+      static_cast<uint32_t>(ps_constant_entries.size()), ps_constant_entries.data(),
+      sizeof(info.ps_constants), &info.ps_constants};
   if (info.ps != VK_NULL_HANDLE)
   {
+    const bool specialized = info.ps_constants != UberShader::PixelUberShaderConstants{};
     shader_stages[num_shader_stages++] = {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
                                           nullptr,
                                           0,
                                           VK_SHADER_STAGE_FRAGMENT_BIT,
                                           info.ps,
-                                          "main"};
+                                          "main",
+                                          specialized ? &ps_specialization : nullptr};
   }
 
   // Fill in Vulkan descriptor structs from our state structures.
@@ -372,6 +497,109 @@ std::pair<VkPipeline, bool> ShaderCache::GetPipelineWithCacheResult(const Pipeli
   return{ pipeline, false };
 }
 
+std::pair<VkPipeline, bool> ShaderCache::GetPipelineAsync(const AsyncPipelineKey& key,
+                                                          bool high_priority)
+{
+  auto iter = m_async_pipelines.find(key);
+  if (iter != m_async_pipelines.end())
+  {
+    AsyncPipeline& pipeline = *iter->second;
+    if (pipeline.done.load())
+      return {pipeline.pipeline, false};
+
+    if (high_priority && !pipeline.high_priority)
+    {
+      pipeline.high_priority = true;
+      GetCompilePool().Queue(&pipeline, true);
+    }
+    return {VK_NULL_HANDLE, false};
+  }
+
+  std::unique_ptr<AsyncPipeline> pipeline = std::make_unique<AsyncPipeline>(key);
+  pipeline->cache = this;
+  // The shader maps are only modified on this thread, the items themselves stay put.
+  if (key.info.vs == VK_NULL_HANDLE || key.info.ps == VK_NULL_HANDLE)
+  {
+    pipeline->vs_item = &m_vs_cache.shader_map->GetOrAdd(key.vs_uid);
+    pipeline->ps_item = &m_ps_cache.shader_map->GetOrAdd(key.ps_uid);
+  }
+  pipeline->high_priority = high_priority;
+  m_pending_pipelines++;
+  GetCompilePool().Queue(pipeline.get(), high_priority);
+  m_async_pipelines.emplace(key, std::move(pipeline));
+  return {VK_NULL_HANDLE, true};
+}
+
+void ShaderCache::CompileAsyncPipeline(AsyncPipeline& pipeline)
+{
+  PipelineInfo info = pipeline.key.info;
+  if (pipeline.vs_item)
+  {
+    info.vs = GetOrCompileShaderModule(*pipeline.vs_item, [&]() {
+      CompileVertexShaderForUid(pipeline.key.vs_uid, *pipeline.vs_item);
+    });
+    info.ps = GetOrCompileShaderModule(*pipeline.ps_item, [&]() {
+      CompilePixelShaderForUid(pipeline.key.ps_uid, *pipeline.ps_item);
+    });
+  }
+
+  // A pipeline that failed to compile stays null, the caller keeps drawing with ubershaders.
+  if (info.vs != VK_NULL_HANDLE && info.ps != VK_NULL_HANDLE)
+    pipeline.pipeline = CreatePipeline(info);
+  pipeline.done.store(true);
+  m_pending_pipelines--;
+}
+
+void ShaderCache::WaitForAsyncPipelines()
+{
+  const size_t total = m_pending_pipelines.load();
+  size_t reported = total + 1;
+  size_t loop_count = 0;
+  for (size_t pending = total; pending > 0; pending = m_pending_pipelines.load())
+  {
+    if (pending != reported)
+    {
+      Host_UpdateProgressDialog(GetStringT("Compiling pipelines...").c_str(),
+                                static_cast<int>(total - pending), static_cast<int>(total));
+      reported = pending;
+    }
+    if (!GetCompilePool().NextTask(0))
+      Common::cYield(loop_count++);
+  }
+  if (total > 0)
+    Host_UpdateProgressDialog("", -1, -1);
+
+  for (const auto& it : m_async_pipelines)
+  {
+    const AsyncPipeline& pipeline = *it.second;
+    if (pipeline.pipeline == VK_NULL_HANDLE)
+      continue;
+
+    PipelineInfo info = pipeline.key.info;
+    if (pipeline.vs_item)
+    {
+      info.vs = pipeline.vs_item->module;
+      info.ps = pipeline.ps_item->module;
+    }
+    if (!m_pipeline_objects.emplace(info, std::make_pair(pipeline.pipeline, true)).second)
+      vkDestroyPipeline(g_vulkan_context->GetDevice(), pipeline.pipeline, nullptr);
+  }
+  m_async_pipelines.clear();
+}
+
+void ShaderCache::CancelAsyncPipelines()
+{
+  GetCompilePool().Cancel();
+  for (const auto& it : m_async_pipelines)
+  {
+    if (it.second->pipeline != VK_NULL_HANDLE)
+      vkDestroyPipeline(g_vulkan_context->GetDevice(), it.second->pipeline, nullptr);
+  }
+  m_async_pipelines.clear();
+  m_pending_pipelines.store(0);
+  m_pending_shaders.store(0);
+}
+
 VkPipeline ShaderCache::CreateComputePipeline(const ComputePipelineInfo& info)
 {
   VkComputePipelineCreateInfo pipeline_info =
@@ -411,7 +639,7 @@ VkPipeline ShaderCache::GetComputePipeline(const ComputePipelineInfo& info)
 
 void ShaderCache::ClearPipelineCache()
 {
-  // TODO: Stop any async compiling happening.
+  CancelAsyncPipelines();
   for (const auto& it : m_pipeline_objects)
   {
     if (it.second.first != VK_NULL_HANDLE)
@@ -452,7 +680,17 @@ bool ShaderCache::CreatePipelineCache(bool load_from_disk)
 {
   // We have to keep the pipeline cache file name around since when we save it
   // we delete the old one, by which time the game's unique ID is already cleared.
-  m_pipeline_cache_filename = GetDiskShaderCacheFileName(API_VULKAN, "pipeline", true, true);
+  // The blob is only usable with the driver that wrote it, keep one per driver so switching
+  // between GPUs or driver versions doesn't throw the other one away.
+  const VkPhysicalDeviceProperties& properties = g_vulkan_context->GetDeviceProperties();
+  std::array<u32, 3 + VK_UUID_SIZE / sizeof(u32)> driver;
+  driver[0] = properties.vendorID;
+  driver[1] = properties.deviceID;
+  driver[2] = properties.driverVersion;
+  std::memcpy(&driver[3], properties.pipelineCacheUUID, VK_UUID_SIZE);
+  const std::string type =
+      StringFromFormat("pipeline-%08X", XXH32(driver.data(), sizeof(driver), 0));
+  m_pipeline_cache_filename = GetDiskShaderCacheFileName(API_VULKAN, type.c_str(), true, true);
 
   std::vector<u8> disk_data;
   if (load_from_disk)
@@ -623,8 +861,8 @@ struct ShaderUsageCacheReader : public LinearDiskCacheReader<Uid, u32>
     item.CalculateUIDHash();
     ShaderCache::vkShaderItem& it = m_shader_map->GetOrAdd(key);
     it.initialized.test_and_set();
-    it.compiled = true;
     it.module = module;
+    it.compiled = true;
   }
 
   ObjectUsageProfiler<Uid, pKey_t, ShaderCache::vkShaderItem, UidHasher>* m_shader_map;
@@ -647,8 +885,8 @@ struct ShaderCacheReader : public LinearDiskCacheReader<Uid, u32>
     item.CalculateUIDHash();
     ShaderCache::vkShaderItem& it = m_shader_map[key];
     it.initialized.test_and_set();
-    it.compiled = true;
     it.module = module;
+    it.compiled = true;
   }
 
   std::unordered_map<Uid, ShaderCache::vkShaderItem, UidHasher>& m_shader_map;
@@ -670,6 +908,12 @@ void ShaderCache::LoadShaderCaches(bool forcecompile)
     "Ishiiruka.ps",
     StringFromFormat("%s.ps", SConfig::GetInstance().GetGameID().c_str())
   ));
+  ShaderUIDBundle::Bundle bundle;
+  if (ShaderUIDBundle::Load(SConfig::GetInstance().GetGameID(), &bundle))
+  {
+    ShaderUIDBundle::Import(bundle.vertex_shaders, m_vs_cache.shader_map.get());
+    ShaderUIDBundle::Import(bundle.pixel_shaders, m_ps_cache.shader_map.get());
+  }
 
   ShaderUsageCacheReader<VertexShaderUid, VertexShaderUid::ShaderUidHasher> vs_reader(m_vs_cache.shader_map.get());
   m_vs_cache.disk_cache.OpenAndRead(GetDiskShaderCacheFileName(API_VULKAN, "vs", true, true), vs_reader);
@@ -695,7 +939,7 @@ void ShaderCache::LoadShaderCaches(bool forcecompile)
   }
   if ((g_ActiveConfig.bCompileShaderOnStartup || forcecompile) && !g_ActiveConfig.bDisableSpecializedShaders)
   {
-    CompileShaders();
+    CompileShaders(forcecompile);
   }
 
   SETSTAT(stats.numVertexShadersCreated, static_cast<int>(m_vs_cache.shader_map->size()));
@@ -704,97 +948,121 @@ void ShaderCache::LoadShaderCaches(bool forcecompile)
   SETSTAT(stats.numPixelShadersAlive, static_cast<int>(m_ps_cache.shader_map->size()));
 }
 
-void ShaderCache::CompileUberShaders()
+template <typename Uid>
+void ShaderCache::CompileShadersInParallel(std::vector<std::pair<Uid, vkShaderItem*>>& items,
+                                           void (ShaderCache::*compile)(const Uid&, vkShaderItem&),
+                                           const std::string& message, size_t blocking_count)
 {
-  int shader_count = 0;
-  UberShader::EnumerateVertexUberShaderUids([&](const UberShader::VertexUberShaderUid& uid, size_t total) {
-    vkShaderItem& it = m_vus_cache.shader_map[uid];
+  // A shader may have been compiled for a draw by the time the pool gets to it.
+  const auto compile_item = [this, compile](const Uid& uid, vkShaderItem& it) {
     if (!it.initialized.test_and_set())
-    {
-      CompileVertexUberShaderForUid(uid, it);
-    }
-    shader_count++;
-    Host_UpdateProgressDialog(GetStringT("Compiling Vertex Uber shaders...").c_str(),
-      static_cast<int>(shader_count), static_cast<int>(total));
-  });  
+      (this->*compile)(uid, it);
+  };
+
+  // Progress is reported from this thread between batches, the host dialog isn't thread safe.
+  const s32 total = static_cast<s32>(std::min(blocking_count, items.size()));
+  const s32 batch_size = static_cast<s32>(Common::ThreadPool::GetThreadCount() + 1) * 4;
+  for (s32 batch = 0; batch < total; batch += batch_size)
+  {
+    const s32 batch_end = std::min(batch + batch_size, total);
+    Common::ParallelForWorker::Loop(batch, batch_end, 1, [&](s32 begin, s32 end) {
+      for (s32 i = begin; i < end; i++)
+        compile_item(items[i].first, *items[i].second);
+    });
+    Host_UpdateProgressDialog(message.c_str(), batch_end, total);
+  }
   Host_UpdateProgressDialog("", -1, -1);
-  shader_count = 0;
+
+  // The rest is compiled in the background after everything draws need right now.
+  for (size_t i = total; i < items.size(); i++)
+  {
+    const Uid uid = items[i].first;
+    vkShaderItem* it = items[i].second;
+    m_pending_shaders++;
+    GetCompilePool().QueueShader([this, compile_item, uid, it]() {
+      compile_item(uid, *it);
+      m_pending_shaders--;
+    });
+  }
+}
+
+void ShaderCache::CompileUberShaders()
+{
+  std::vector<std::pair<UberShader::VertexUberShaderUid, vkShaderItem*>> vertex_shaders;
+  UberShader::EnumerateVertexUberShaderUids([&](const UberShader::VertexUberShaderUid& uid, size_t total) {
+    vertex_shaders.emplace_back(uid, &m_vus_cache.shader_map[uid]);
+  });
+  CompileShadersInParallel(vertex_shaders, &ShaderCache::CompileVertexUberShaderForUid,
+                           GetStringT("Compiling Vertex Uber shaders..."), vertex_shaders.size());
+
+  std::vector<std::pair<UberShader::PixelUberShaderUid, vkShaderItem*>> pixel_shaders;
   UberShader::EnumeratePixelUberShaderUids([&](const UberShader::PixelUberShaderUid& uid, size_t total) {
-    vkShaderItem& it = m_pus_cache.shader_map[uid];
-    if (!it.initialized.test_and_set())
-    {
-      CompilePixelUberShaderForUid(uid, it);
-    }
-    shader_count++;
-    Host_UpdateProgressDialog(GetStringT("Compiling Pixel Uber shaders...").c_str(),
-      static_cast<int>(shader_count), static_cast<int>(total));    
+    pixel_shaders.emplace_back(uid, &m_pus_cache.shader_map[uid]);
   });
-  Host_UpdateProgressDialog("", -1, -1);
+  CompileShadersInParallel(pixel_shaders, &ShaderCache::CompilePixelUberShaderForUid,
+                           GetStringT("Compiling Pixel Uber shaders..."), pixel_shaders.size());
 }
 
-void ShaderCache::CompileShaders()
+void ShaderCache::CompileShaders(bool compile_all)
 {
+  // The UID caches are ordered by how much each shader was used, only the most used part has to
+  // be ready before boot continues.
+  const auto blocking_count = [compile_all](size_t count) {
+    const size_t percent = compile_all ? 100 :
+      static_cast<size_t>(std::min(std::max(g_ActiveConfig.iCompileShaderOnStartupPercent, 0), 100));
+    return (count * percent + 99) / 100;
+  };
+
   pKey_t gameid = (pKey_t)GetMurmurHash3(reinterpret_cast<const u8*>(SConfig::GetInstance().GetGameID().data()), (u32)SConfig::GetInstance().GetGameID().size(), 0);
-  int shader_count = 0;
+  std::vector<std::pair<VertexShaderUid, vkShaderItem*>> vertex_shaders;
   m_vs_cache.shader_map->ForEachMostUsedByCategory(gameid,
     [&](const VertexShaderUid& uid, size_t total)
   {
     VertexShaderUid item = uid;
     item.ClearHASH();
     item.CalculateUIDHash();
-    vkShaderItem& it = m_vs_cache.shader_map->GetOrAdd(item);
-    if (!it.initialized.test_and_set())
-    {
-      CompileVertexShaderForUid(item, it);
-      Host_UpdateProgressDialog(GetStringT("Compiling Vertex shaders...").c_str(),
-        static_cast<int>(shader_count), static_cast<int>(total));
-    }
+    vertex_shaders.emplace_back(item, &m_vs_cache.shader_map->GetOrAdd(item));
   },
     [](vkShaderItem& entry)
   {
     return !entry.compiled;
   }
   , true);
-  shader_count = 0;
+  CompileShadersInParallel(vertex_shaders, &ShaderCache::CompileVertexShaderForUid,
+                           GetStringT("Compiling Vertex shaders..."),
+                           blocking_count(vertex_shaders.size()));
+
+  std::vector<std::pair<PixelShaderUid, vkShaderItem*>> pixel_shaders;
   m_ps_cache.shader_map->ForEachMostUsedByCategory(gameid,
     [&](const PixelShaderUid& uid, size_t total)
   {
     PixelShaderUid item = uid;
     item.ClearHASH();
     item.CalculateUIDHash();
-    vkShaderItem& it = m_ps_cache.shader_map->GetOrAdd(item);
-    if (!it.initialized.test_and_set())
-    {
-      CompilePixelShaderForUid(item, it);
-      Host_UpdateProgressDialog(GetStringT("Compiling Pixel shaders...").c_str(),
-        static_cast<int>(shader_count), static_cast<int>(total));
-    }
+    pixel_shaders.emplace_back(item, &m_ps_cache.shader_map->GetOrAdd(item));
   },
     [](vkShaderItem& entry)
   {
     return !entry.compiled;
   }
   , true);
+  CompileShadersInParallel(pixel_shaders, &ShaderCache::CompilePixelShaderForUid,
+                           GetStringT("Compiling Pixel shaders..."),
+                           blocking_count(pixel_shaders.size()));
 
   if (g_vulkan_context->SupportsGeometryShaders())
   {
-    shader_count = 0;
+    std::vector<std::pair<GeometryShaderUid, vkShaderItem*>> geometry_shaders;
     EnumerateGeometryShaderUids([&](const GeometryShaderUid& uid, size_t total)
     {
       GeometryShaderUid item = uid;
       item.ClearHASH();
       item.CalculateUIDHash();
-      vkShaderItem& it = m_gs_cache.shader_map[item];
-      shader_count++;
-      if (!it.initialized.test_and_set())
-      {
-        CompileGeometryShaderForUid(item, it);
-        Host_UpdateProgressDialog(GetStringT("Compiling Geometry shaders...").c_str(),
-          static_cast<int>(shader_count), static_cast<int>(total));
-      }
+      geometry_shaders.emplace_back(item, &m_gs_cache.shader_map[item]);
     });
+    CompileShadersInParallel(geometry_shaders, &ShaderCache::CompileGeometryShaderForUid,
+                             GetStringT("Compiling Geometry shaders..."), geometry_shaders.size());
   }
-  Host_UpdateProgressDialog("", -1, -1);
 }
 
 void ShaderCache::Reload()
@@ -836,6 +1104,8 @@ static void DestroyShaderCache(T& cache)
 
 void ShaderCache::DestroyShaderCaches()
 {
+  // Background compiles still point at the shader items.
+  CancelAsyncPipelines();
   m_vs_cache.shader_map->Persist([](VertexShaderUid &uid) {
     uid.ClearHASH();
     uid.CalculateUIDHash();
@@ -874,14 +1144,15 @@ void ShaderCache::CompileVertexShaderForUid(const VertexShaderUid& uid, ShaderCa
     // Append to shader cache if it created successfully.
     if (module != VK_NULL_HANDLE)
     {
+      std::lock_guard<std::mutex> guard(m_disk_cache_lock);
       m_vs_cache.disk_cache.Append(uid, spv.data(), static_cast<u32>(spv.size()));
       INCSTAT(stats.numVertexShadersCreated);
       INCSTAT(stats.numVertexShadersAlive);
     }
   }
-  it.compiled = true;
   // We still insert null entries to prevent further compilation attempts.
   it.module = module;
+  it.compiled = true;
 }
 
 void ShaderCache::CompileVertexUberShaderForUid(const UberShader::VertexUberShaderUid& uid, ShaderCache::vkShaderItem& it)
@@ -899,12 +1170,13 @@ void ShaderCache::CompileVertexUberShaderForUid(const UberShader::VertexUberShad
     // Append to shader cache if it created successfully.
     if (module != VK_NULL_HANDLE)
     {
+      std::lock_guard<std::mutex> guard(m_disk_cache_lock);
       m_vus_cache.disk_cache.Append(uid, spv.data(), static_cast<u32>(spv.size()));
     }
   }
-  it.compiled = true;
   // We still insert null entries to prevent further compilation attempts.
   it.module = module;
+  it.compiled = true;
 }
 
 void ShaderCache::CompileGeometryShaderForUid(const GeometryShaderUid& uid, ShaderCache::vkShaderItem& it)
@@ -921,11 +1193,14 @@ void ShaderCache::CompileGeometryShaderForUid(const GeometryShaderUid& uid, Shad
 
     // Append to shader cache if it created successfully.
     if (module != VK_NULL_HANDLE)
+    {
+      std::lock_guard<std::mutex> guard(m_disk_cache_lock);
       m_gs_cache.disk_cache.Append(uid, spv.data(), static_cast<u32>(spv.size()));
+    }
   }
-  it.compiled = true;
   // We still insert null entries to prevent further compilation attempts.
   it.module = module;
+  it.compiled = true;
 }
 
 void ShaderCache::CompilePixelShaderForUid(const PixelShaderUid& uid, ShaderCache::vkShaderItem& it)
@@ -943,14 +1218,15 @@ void ShaderCache::CompilePixelShaderForUid(const PixelShaderUid& uid, ShaderCach
     // Append to shader cache if it created successfully.
     if (module != VK_NULL_HANDLE)
     {
+      std::lock_guard<std::mutex> guard(m_disk_cache_lock);
       m_ps_cache.disk_cache.Append(uid, spv.data(), static_cast<u32>(spv.size()));
       INCSTAT(stats.numPixelShadersCreated);
       INCSTAT(stats.numPixelShadersAlive);
     }
   }
-  it.compiled = true;
   // We still insert null entries to prevent further compilation attempts.
   it.module = module;
+  it.compiled = true;
 }
 
 void ShaderCache::CompilePixelUberShaderForUid(const UberShader::PixelUberShaderUid& uid, ShaderCache::vkShaderItem& it)
@@ -968,65 +1244,46 @@ void ShaderCache::CompilePixelUberShaderForUid(const UberShader::PixelUberShader
     // Append to shader cache if it created successfully.
     if (module != VK_NULL_HANDLE)
     {
+      std::lock_guard<std::mutex> guard(m_disk_cache_lock);
       m_pus_cache.disk_cache.Append(uid, spv.data(), static_cast<u32>(spv.size()));
       INCSTAT(stats.numPixelShadersCreated);
       INCSTAT(stats.numPixelShadersAlive);
     }
   }
-  it.compiled = true;
   // We still insert null entries to prevent further compilation attempts.
   it.module = module;
+  it.compiled = true;
 }
 
 VkShaderModule ShaderCache::GetVertexShaderForUid(const VertexShaderUid& uid)
 {
   vkShaderItem& it = m_vs_cache.shader_map->GetOrAdd(uid);
-  if (it.initialized.test_and_set())
-    return it.module;
-
-  CompileVertexShaderForUid(uid, it);
-  return it.module;
+  return GetOrCompileShaderModule(it, [&]() { CompileVertexShaderForUid(uid, it); });
 }
 
 VkShaderModule ShaderCache::GetGeometryShaderForUid(const GeometryShaderUid& uid)
 {
   ASSERT(g_vulkan_context->SupportsGeometryShaders());
   vkShaderItem& it = m_gs_cache.shader_map[uid];
-  if (it.initialized.test_and_set())
-    return it.module;
-
-  CompileGeometryShaderForUid(uid, it);
-  return it.module;
+  return GetOrCompileShaderModule(it, [&]() { CompileGeometryShaderForUid(uid, it); });
 }
 
 VkShaderModule ShaderCache::GetPixelShaderForUid(const PixelShaderUid& uid)
 {
   vkShaderItem& it = m_ps_cache.shader_map->GetOrAdd(uid);
-  if (it.initialized.test_and_set())
-    return it.module;
-
-  CompilePixelShaderForUid(uid, it);
-  return it.module;
+  return GetOrCompileShaderModule(it, [&]() { CompilePixelShaderForUid(uid, it); });
 }
 
 VkShaderModule ShaderCache::GetVertexUberShaderForUid(const UberShader::VertexUberShaderUid& uid)
 {
   vkShaderItem& it = m_vus_cache.shader_map[uid];
-  if (it.initialized.test_and_set())
-    return it.module;
-
-  CompileVertexUberShaderForUid(uid, it);
-  return it.module;
+  return GetOrCompileShaderModule(it, [&]() { CompileVertexUberShaderForUid(uid, it); });
 }
 
 VkShaderModule ShaderCache::GetPixelUberShaderForUid(const UberShader::PixelUberShaderUid& uid)
 {
   vkShaderItem& it = m_pus_cache.shader_map[uid];
-  if (it.initialized.test_and_set())
-    return it.module;
-
-  CompilePixelUberShaderForUid(uid, it);
-  return it.module;
+  return GetOrCompileShaderModule(it, [&]() { CompilePixelUberShaderForUid(uid, it); });
 }
 
 void ShaderCache::RecompileSharedShaders()
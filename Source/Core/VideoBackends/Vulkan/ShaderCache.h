@@ -5,12 +5,15 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/LinearDiskCache.h"
@@ -47,6 +50,8 @@ struct PipelineInfo
   RasterizationState rasterization_state;
   DepthState depth_state;
   MultisamplingState multisampling_state;
+  // Only set with the pixel ubershader, zero for every other shader.
+  UberShader::PixelUberShaderConstants ps_constants;
 
   bool operator==(const PipelineInfo& rhs) const
   {
@@ -83,6 +88,7 @@ struct PipelineInfoHash
     h = h * 137 + (uintptr_t)key.multisampling_state.hex;
     h = h * 137 + (uintptr_t)(((uintptr_t)key.blend_state.hex << 32) |
       key.rasterization_state.hex | (uintptr_t(key.depth_state.hex) << 12));
+    h = h * 137 + ((key.ps_constants.num_tev_stages << 2) | key.ps_constants.alpha_test);
     return h;
   }
 };
@@ -123,6 +129,33 @@ struct ComputePipelineInfoHash
   }
 };
 
+// A pipeline built from specialized shaders that may not have been compiled yet. The vertex and
+// pixel shader modules in info are left null, the shaders are identified by their uids instead.
+// When info already has its vertex and pixel shader, only the pipeline itself is compiled and the
+// UIDs are left cleared.
+struct AsyncPipelineKey
+{
+  PipelineInfo info;
+  VertexShaderUid vs_uid;
+  PixelShaderUid ps_uid;
+
+  bool operator==(const AsyncPipelineKey& rhs) const
+  {
+    return info == rhs.info && vs_uid == rhs.vs_uid && ps_uid == rhs.ps_uid;
+  }
+};
+
+struct AsyncPipelineKeyHash
+{
+  size_t operator()(const AsyncPipelineKey& key) const
+  {
+    size_t h = PipelineInfoHash()(key.info);
+    h = h * 137 + VertexShaderUid::ShaderUidHasher()(key.vs_uid);
+    h = h * 137 + PixelShaderUid::ShaderUidHasher()(key.ps_uid);
+    return h;
+  }
+};
+
 class ShaderCache
 {
 public:
@@ -157,6 +190,23 @@ public:
   // otherwise for a cache hit it will be true.
   std::pair<VkPipeline, bool> GetPipelineWithCacheResult(const PipelineInfo& info);
   
+  // Returns the pipeline for key if it has been compiled. Otherwise the missing shaders and the
+  // pipeline are queued on the compile pool and VK_NULL_HANDLE is returned, the caller is
+  // expected to draw with ubershaders until the pipeline is ready. High priority requests are
+  // compiled before any queued background work, a queued background request that is then needed
+  // for drawing is moved ahead. The second field is true if this is the first request for key.
+  std::pair<VkPipeline, bool> GetPipelineAsync(const AsyncPipelineKey& key, bool high_priority);
+
+  // Number of pipelines that are queued or being compiled on the compile pool.
+  size_t GetPendingPipelineCount() const { return m_pending_pipelines.load(); }
+  // Number of shaders from the UID cache still compiling after boot continued.
+  size_t GetPendingShaderCount() const { return m_pending_shaders.load(); }
+
+  // Helps the compile pool until every queued pipeline has been compiled, then moves them over to
+  // the regular pipeline map so GetPipeline() finds them. Used to replay the pipeline UID cache
+  // at boot when draws can't fall back to ubershaders.
+  void WaitForAsyncPipelines();
+
   // Creates a compute pipeline, and does not track the handle.
   VkPipeline CreateComputePipeline(const ComputePipelineInfo& info);
 
@@ -188,14 +238,43 @@ public:
   class vkShaderItem
   {
   public:
-    bool compiled{};
+    // Set once module is valid, shaders can be compiled on the compile pool.
+    std::atomic<bool> compiled{};
     std::atomic_flag initialized{};
     VkShaderModule module = VK_NULL_HANDLE;
     vkShaderItem() {}
   };
 
 private:
-  void CompileShaders();
+  class PipelineCompilePool;
+
+  struct AsyncPipeline
+  {
+    explicit AsyncPipeline(const AsyncPipelineKey& key_) : key(key_) {}
+
+    AsyncPipelineKey key;
+    ShaderCache* cache;
+    vkShaderItem* vs_item = nullptr;
+    vkShaderItem* ps_item = nullptr;
+    bool high_priority;
+    // Whichever queue entry is picked up first compiles the pipeline.
+    std::atomic_flag started = ATOMIC_FLAG_INIT;
+    std::atomic<bool> done{false};
+    VkPipeline pipeline = VK_NULL_HANDLE;
+  };
+
+  static PipelineCompilePool& GetCompilePool();
+  void CompileAsyncPipeline(AsyncPipeline& pipeline);
+  // Drops all queued compiles and waits for the running ones to finish.
+  void CancelAsyncPipelines();
+
+  // Compiles the first blocking_count items on the thread pool and waits for them, the rest is
+  // queued as background work.
+  template <typename Uid>
+  void CompileShadersInParallel(std::vector<std::pair<Uid, vkShaderItem*>>& items,
+                                void (ShaderCache::*compile)(const Uid&, vkShaderItem&),
+                                const std::string& message, size_t blocking_count);
+  void CompileShaders(bool compile_all);
   void CompileUberShaders();
   bool CreatePipelineCache(bool load_from_disk);
   bool ValidatePipelineCache(const u8* data, size_t data_length);
@@ -251,6 +330,12 @@ private:
       m_pipeline_objects;
   std::unordered_map<ComputePipelineInfo, VkPipeline, ComputePipelineInfoHash>
       m_compute_pipeline_objects;
+  std::unordered_map<AsyncPipelineKey, std::unique_ptr<AsyncPipeline>, AsyncPipelineKeyHash>
+      m_async_pipelines;
+  std::atomic<size_t> m_pending_pipelines{0};
+  std::atomic<size_t> m_pending_shaders{0};
+  // Shaders are appended to the disk caches from the compile pool threads as well.
+  std::mutex m_disk_cache_lock;
   VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
   std::string m_pipeline_cache_filename;
 
@@ -5,10 +5,12 @@
 #include "VideoBackends/Vulkan/ShaderCompiler.h"
 #include "VideoBackends/Vulkan/VulkanContext.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdlib>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <string>
 
 // glslang includes
@@ -20,6 +22,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
+#include "Common/TraceEvents.h"
 
 #include "VideoCommon/VideoConfig.h"
 
@@ -138,6 +141,7 @@ bool CompileShaderToSPV(SPIRVCodeVector* out_code, EShLanguage stage, const char
   const char* source_code, size_t source_code_length, const char* header,
   size_t header_length)
 {
+  TRACE_SCOPE("CompileShader");
   if (!InitializeGlslang())
     return false;
 
@@ -164,7 +168,7 @@ bool CompileShaderToSPV(SPIRVCodeVector* out_code, EShLanguage stage, const char
   shader->setStringsWithLengths(&pass_source_code, &pass_source_code_length, 1);
 
   auto DumpBadShader = [&](const char* msg) {
-    static int counter = 0;
+    static std::atomic<int> counter{0};
     std::string filename = StringFromFormat(
       "%sbad_%s_%04i.txt", File::GetUserPath(D_DUMP_IDX).c_str(), stage_filename, counter++);
 
@@ -232,7 +236,7 @@ bool CompileShaderToSPV(SPIRVCodeVector* out_code, EShLanguage stage, const char
   // Dump source code of shaders out to file if enabled.
   if (g_ActiveConfig.iLog & CONF_SAVESHADERS)
   {
-    static int counter = 0;
+    static std::atomic<int> counter{0};
     std::string filename = StringFromFormat("%s%s_%04i.txt", File::GetUserPath(D_DUMP_IDX).c_str(),
       stage_filename, counter++);
 
@@ -275,7 +279,7 @@ void CopyGLSLToSPVVector(SPIRVCodeVector* out_code, const char* stage_filename,
 
   if (g_ActiveConfig.iLog & CONF_SAVESHADERS)
   {
-    static int counter = 0;
+    static std::atomic<int> counter{0};
     std::string filename = StringFromFormat("%s%s_%04i.txt", File::GetUserPath(D_DUMP_IDX).c_str(),
       stage_filename, counter++);
 
@@ -295,7 +299,10 @@ void CopyGLSLToSPVVector(SPIRVCodeVector* out_code, const char* stage_filename,
 
 bool InitializeGlslang()
 {
+  // Shaders are compiled from the thread pool too, the first compile may come from any thread.
+  static std::mutex init_lock;
   static bool glslang_initialized = false;
+  std::lock_guard<std::mutex> guard(init_lock);
   if (glslang_initialized)
     return true;
 
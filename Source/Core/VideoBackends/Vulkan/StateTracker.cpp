@@ -106,6 +106,8 @@ void StateTracker::InvalidateShaderPointers()
   m_uber_ps_uid = {};
   m_uber_vs_uid = {};
   // Invalidate shader pointers.
+  m_uber_vs = VK_NULL_HANDLE;
+  m_uber_ps = VK_NULL_HANDLE;
   m_pipeline_state.vs = VK_NULL_HANDLE;
   m_pipeline_state.gs = VK_NULL_HANDLE;
   m_pipeline_state.ps = VK_NULL_HANDLE;
@@ -138,6 +140,10 @@ void StateTracker::ReloadPipelineUIDCache()
     VERTEXSHADERGEN_UID_VERSION,
     GEOMETRYSHADERGEN_UID_VERSION,
     PIXELSHADERGEN_UID_VERSION, PIPELINE_UID_VERSION));
+
+  // Without ubershaders to draw with, every pipeline the game used before has to exist first.
+  if (!IsBackgroundCompiling())
+    g_shader_cache->WaitForAsyncPipelines();
 }
 
 void StateTracker::ReloadUberPipelineUIDCache()
@@ -178,7 +184,7 @@ void StateTracker::AppendToUberPipelineUIDCache(const PipelineInfo& info)
   sinfo.blend_state_bits = info.blend_state.hex;
   sinfo.rasterizer_state_bits = info.rasterization_state.hex;
   sinfo.depth_state_bits = info.depth_state.hex;
-  sinfo.vertex_decl = m_pipeline_state.vertex_format->GetVertexDeclaration();
+  sinfo.vertex_decl = info.vertex_format->GetVertexDeclaration();
   sinfo.vs_uid = m_uber_vs_uid;
   sinfo.gs_uid = m_gs_uid;
   sinfo.ps_uid = m_uber_ps_uid;
@@ -193,7 +199,7 @@ void StateTracker::AppendToPipelineUIDCache(const PipelineInfo& info)
   sinfo.blend_state_bits = info.blend_state.hex;
   sinfo.rasterizer_state_bits = info.rasterization_state.hex;
   sinfo.depth_state_bits = info.depth_state.hex;
-  sinfo.vertex_decl = m_pipeline_state.vertex_format->GetVertexDeclaration();
+  sinfo.vertex_decl = info.vertex_format->GetVertexDeclaration();
   sinfo.vs_uid = m_vs_uid;
   sinfo.gs_uid = m_gs_uid;
   sinfo.ps_uid = m_ps_uid;
@@ -221,12 +227,6 @@ bool StateTracker::PrecachePipelineUID(const SerializedPipelineUID& uid)
   pinfo.pipeline_layout = ps_uid.GetUidData().bounding_box ?
     g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_BBOX) :
     g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_STANDARD);
-  pinfo.vs = g_shader_cache->GetVertexShaderForUid(vs_uid);
-  if (pinfo.vs == VK_NULL_HANDLE)
-  {
-    WARN_LOG(VIDEO, "Failed to get vertex shader from cached UID.");
-    return false;
-  }
   if (g_vulkan_context->SupportsGeometryShaders() && !gs_uid.GetUidData().IsPassthrough())
   {
     pinfo.gs = g_shader_cache->GetGeometryShaderForUid(gs_uid);
@@ -236,25 +236,14 @@ bool StateTracker::PrecachePipelineUID(const SerializedPipelineUID& uid)
       return false;
     }
   }
-  pinfo.ps = g_shader_cache->GetPixelShaderForUid(ps_uid);
-  if (pinfo.ps == VK_NULL_HANDLE)
-  {
-    WARN_LOG(VIDEO, "Failed to get pixel shader from cached UID.");
-    return false;
-  }
   pinfo.render_pass = m_load_render_pass;
   pinfo.blend_state.hex = uid.blend_state_bits;
   pinfo.rasterization_state.hex = uid.rasterizer_state_bits;
   pinfo.depth_state.hex = uid.depth_state_bits;
+  pinfo.multisampling_state.hex = m_pipeline_state.multisampling_state.hex;
 
-  VkPipeline pipeline = g_shader_cache->GetPipeline(pinfo);
-  if (pipeline == VK_NULL_HANDLE)
-  {
-    WARN_LOG(VIDEO, "Failed to get pipeline from cached UID.");
-    return false;
-  }
-
-  // We don't need to do anything with this pipeline, just make sure it exists.
+  // The shaders and the pipeline are compiled on the compile pool, see ReloadPipelineUIDCache.
+  g_shader_cache->GetPipelineAsync({pinfo, vs_uid, ps_uid}, false);
   return true;
 }
 
@@ -411,20 +400,24 @@ bool StateTracker::CheckForShaderChanges(PrimitiveType gx_primitive_type, u32 co
   PixelShaderUid ps_uid;
   GetPixelShaderUID(ps_uid, dstalpha_mode, components, xfmem, bpmem);
 
-  bool changed = false;
-  bool use_ubershaders = g_ActiveConfig.bDisableSpecializedShaders;
+  bool changed = m_specialized_pipeline_pending || m_uber_pipeline_pending;
+  bool use_ubershaders = g_ActiveConfig.UsingUberShadersOnly();
+  const bool background_compiling = IsBackgroundCompiling();
   if (!use_ubershaders)
   {
+    // With background compiling the shaders are compiled along with the pipeline.
     if (vs_uid != m_vs_uid)
     {
-      m_pipeline_state.vs = g_shader_cache->GetVertexShaderForUid(vs_uid);
+      if (!background_compiling)
+        m_pipeline_state.vs = g_shader_cache->GetVertexShaderForUid(vs_uid);
       m_vs_uid = vs_uid;
       changed = true;
     }
 
     if (ps_uid != m_ps_uid)
     {
-      m_pipeline_state.ps = g_shader_cache->GetPixelShaderForUid(ps_uid);
+      if (!background_compiling)
+        m_pipeline_state.ps = g_shader_cache->GetPixelShaderForUid(ps_uid);
       m_ps_uid = ps_uid;
       changed = true;
     }
@@ -457,33 +450,47 @@ bool StateTracker::CheckForShaderChanges(PrimitiveType gx_primitive_type, u32 co
     m_dstalpha_mode = dstalpha_mode;
   }
 
-  // Switching to/from ubershaders? Have to adjust the vertex format and pipeline layout.
-  if (use_ubershaders != m_using_ubershaders)
-  {
-    m_using_ubershaders = use_ubershaders;
-    UpdatePipelineLayout();
-    UpdatePipelineVertexFormat();
-  }
+  // Background compiling picks between the two in UpdatePipeline.
+  if (!background_compiling)
+    SetUsingUbershaders(use_ubershaders);
 
-  if (use_ubershaders)
+  // Ubershaders are kept up to date while background compiling, to draw with in the meantime.
+  if (use_ubershaders || background_compiling)
   {
     UberShader::VertexUberShaderUid uber_vs_uid = UberShader::GetVertexUberShaderUid(components, xfmem);
     VkShaderModule vs = g_shader_cache->GetVertexUberShaderForUid(uber_vs_uid);
-    if (vs != m_pipeline_state.vs)
+    if (vs != m_uber_vs)
     {
       m_uber_vs_uid = uber_vs_uid;
-      m_pipeline_state.vs = vs;
+      m_uber_vs = vs;
       changed = true;
     }
 
     UberShader::PixelUberShaderUid uber_ps_uid = UberShader::GetPixelUberShaderUid(components, xfmem, bpmem);
     VkShaderModule ps = g_shader_cache->GetPixelUberShaderForUid(uber_ps_uid);
-    if (ps != m_pipeline_state.ps)
+    if (ps != m_uber_ps)
     {
       m_uber_ps_uid = uber_ps_uid;
-      m_pipeline_state.ps = ps;
+      m_uber_ps = ps;
       changed = true;
     }
+
+    if (g_ActiveConfig.bUberShaderSpecialization)
+    {
+      const UberShader::PixelUberShaderConstants constants =
+        UberShader::GetPixelUberShaderConstants(bpmem);
+      if (constants != m_uber_constants)
+      {
+        m_uber_constants = constants;
+        changed = true;
+      }
+    }
+
+    if (use_ubershaders)
+    {
+      m_pipeline_state.vs = m_uber_vs;
+      m_pipeline_state.ps = m_uber_ps;
+    }
   }
 
   if (changed)
@@ -501,6 +508,8 @@ void StateTracker::ClearShaders()
   std::memset(&m_uber_vs_uid, 0xFF, sizeof(m_uber_vs_uid));
   std::memset(&m_uber_ps_uid, 0xFF, sizeof(m_uber_ps_uid));
 
+  m_uber_vs = VK_NULL_HANDLE;
+  m_uber_ps = VK_NULL_HANDLE;
   m_pipeline_state.vs = VK_NULL_HANDLE;
   m_pipeline_state.gs = VK_NULL_HANDLE;
   m_pipeline_state.ps = VK_NULL_HANDLE;
@@ -756,6 +765,7 @@ void StateTracker::UnbindTexture(VkImageView view)
 void StateTracker::InvalidateDescriptorSets()
 {
   m_descriptor_sets.fill(VK_NULL_HANDLE);
+  m_sampler_set_cache.clear();
   m_dirty_flags |= DIRTY_FLAG_ALL_DESCRIPTOR_SETS;
 
   // Defer SSBO descriptor update until bbox is actually enabled.
@@ -1085,12 +1095,97 @@ bool StateTracker::IsSSBODescriptorRequired() const
   return m_bbox_enabled || (m_using_ubershaders && g_ActiveConfig.iBBoxMode == BBoxMode::BBoxGPU);
 }
 
+bool StateTracker::IsBackgroundCompiling()
+{
+  return g_ActiveConfig.UsingHybridUberShaders();
+}
+
+VkPipeline StateTracker::GetSpecializedPipelineAsync()
+{
+  // The ubershader vertex format and layout may be in use, the specialized pipeline wants its own.
+  PipelineInfo info = m_pipeline_state;
+  info.vertex_format = m_vertex_format;
+  info.pipeline_layout = g_object_cache->GetPipelineLayout(
+    m_bbox_enabled ? PIPELINE_LAYOUT_BBOX : PIPELINE_LAYOUT_STANDARD);
+  info.vs = VK_NULL_HANDLE;
+  info.ps = VK_NULL_HANDLE;
+  const AsyncPipelineKey key = {
+    m_dstalpha_mode == PSRM_ALPHA_PASS ? GetAlphaPassPipelineConfig(info) : info, m_vs_uid,
+    m_ps_uid};
+
+  auto result = g_shader_cache->GetPipelineAsync(key, true);
+  if (result.second)
+    AppendToPipelineUIDCache(key.info);
+  m_specialized_pipeline_pending = result.first == VK_NULL_HANDLE;
+  return result.first;
+}
+
+VkPipeline StateTracker::GetSpecializedUberPipelineAsync()
+{
+  PipelineInfo info = m_dstalpha_mode == PSRM_ALPHA_PASS ?
+    GetAlphaPassPipelineConfig(m_pipeline_state) : m_pipeline_state;
+  info.ps_constants = m_uber_constants;
+  AsyncPipelineKey key = {info, VertexShaderUid(), PixelShaderUid()};
+  key.vs_uid.ClearUID();
+  key.ps_uid.ClearUID();
+
+  // A pipeline creation with constant state is much cheaper than compiling a specialized shader,
+  // so it is queued along with the draws waiting for those.
+  VkPipeline pipeline = g_shader_cache->GetPipelineAsync(key, true).first;
+  m_uber_pipeline_pending = pipeline == VK_NULL_HANDLE;
+  return pipeline;
+}
+
+void StateTracker::SetUsingUbershaders(bool enable)
+{
+  // Switching to/from ubershaders? Have to adjust the vertex format and pipeline layout.
+  if (enable == m_using_ubershaders)
+    return;
+
+  m_using_ubershaders = enable;
+  UpdatePipelineLayout();
+  UpdatePipelineVertexFormat();
+}
+
 bool StateTracker::UpdatePipeline()
 {
+  if (IsBackgroundCompiling())
+  {
+    VkPipeline pipeline = GetSpecializedPipelineAsync();
+    SetUsingUbershaders(pipeline == VK_NULL_HANDLE);
+    if (pipeline != VK_NULL_HANDLE)
+    {
+      m_pipeline_object = pipeline;
+      m_dirty_flags |= DIRTY_FLAG_PIPELINE_BINDING;
+      return true;
+    }
+
+    // Draw with ubershaders until the specialized pipeline is ready.
+    m_pipeline_state.vs = m_uber_vs;
+    m_pipeline_state.ps = m_uber_ps;
+  }
+  else
+  {
+    m_specialized_pipeline_pending = false;
+  }
+
   // We need at least a vertex and fragment shader
   if (m_pipeline_state.vs == VK_NULL_HANDLE || m_pipeline_state.ps == VK_NULL_HANDLE)
     return false;
 
+  // The plain ubershader pipeline is used until the specialized variant is ready.
+  m_uber_pipeline_pending = false;
+  if (m_using_ubershaders && g_ActiveConfig.bUberShaderSpecialization)
+  {
+    VkPipeline pipeline = GetSpecializedUberPipelineAsync();
+    if (pipeline != VK_NULL_HANDLE)
+    {
+      m_pipeline_object = pipeline;
+      m_dirty_flags |= DIRTY_FLAG_PIPELINE_BINDING;
+      return true;
+    }
+  }
+
   // Grab a new pipeline object, this can fail.
   // We have to use a different blend state for the alpha pass of the dstalpha fallback.
   if (m_dstalpha_mode == PSRM_ALPHA_PASS)
@@ -1187,25 +1282,38 @@ bool StateTracker::UpdateDescriptorSet()
   if (m_dirty_flags & DIRTY_FLAG_PS_SAMPLERS ||
     m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] == VK_NULL_HANDLE)
   {
-    VkDescriptorSetLayout layout =
-      g_object_cache->GetDescriptorSetLayout(DESCRIPTOR_SET_LAYOUT_PIXEL_SHADER_SAMPLERS);
-    VkDescriptorSet set = g_command_buffer_mgr->AllocateDescriptorSet(layout);
-    if (set == VK_NULL_HANDLE)
-      return false;
+    auto cached = m_sampler_set_cache.find(m_bindings.ps_samplers);
+    if (cached != m_sampler_set_cache.end())
+    {
+      if (m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] != cached->second)
+      {
+        m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] = cached->second;
+        m_dirty_flags |= DIRTY_FLAG_DESCRIPTOR_SET_BINDING;
+      }
+    }
+    else
+    {
+      VkDescriptorSetLayout layout =
+        g_object_cache->GetDescriptorSetLayout(DESCRIPTOR_SET_LAYOUT_PIXEL_SHADER_SAMPLERS);
+      VkDescriptorSet set = g_command_buffer_mgr->AllocateDescriptorSet(layout);
+      if (set == VK_NULL_HANDLE)
+        return false;
 
-    writes[num_writes++] = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-      nullptr,
-      set,
-      0,
-      0,
-      static_cast<u32>(NUM_PIXEL_SHADER_SAMPLERS),
-      VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-      m_bindings.ps_samplers.data(),
-      nullptr,
-      nullptr };
+      writes[num_writes++] = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        nullptr,
+        set,
+        0,
+        0,
+        static_cast<u32>(NUM_PIXEL_SHADER_SAMPLERS),
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        m_bindings.ps_samplers.data(),
+        nullptr,
+        nullptr };
 
-    m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] = set;
-    m_dirty_flags |= DIRTY_FLAG_DESCRIPTOR_SET_BINDING;
+      m_descriptor_sets[DESCRIPTOR_SET_BIND_POINT_PIXEL_SHADER_SAMPLERS] = set;
+      m_sampler_set_cache.emplace(m_bindings.ps_samplers, set);
+      m_dirty_flags |= DIRTY_FLAG_DESCRIPTOR_SET_BINDING;
+    }
   }
 
   if (m_bbox_enabled &&
@@ -7,6 +7,7 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <unordered_map>
 
 #include "Common/CommonTypes.h"
 #include "VideoBackends/Vulkan/Constants.h"
@@ -66,6 +67,8 @@ public:
   void SetSampler(size_t index, VkSampler sampler);
 
   void SetBBoxEnable(bool enable);
+  // True if the bound pipeline uses ubershaders.
+  bool IsUsingUberShaders() const { return m_using_ubershaders; }
   void SetBBoxBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
 
   void UnbindTexture(VkImageView view);
@@ -197,6 +200,15 @@ private:
   // since the bbox writes are determined by a uniform.
   bool IsSSBODescriptorRequired() const;
 
+  // Specialized shaders are compiled on the compile pool while ubershaders are drawn with.
+  static bool IsBackgroundCompiling();
+  // Returns the specialized pipeline for the current state, or VK_NULL_HANDLE while it is pending.
+  VkPipeline GetSpecializedPipelineAsync();
+  // Returns the ubershader pipeline specialized on m_uber_constants, or VK_NULL_HANDLE while it is
+  // pending.
+  VkPipeline GetSpecializedUberPipelineAsync();
+  void SetUsingUbershaders(bool enable);
+
   bool UpdatePipeline();
   void UpdatePipelineLayout();
   void UpdatePipelineVertexFormat();
@@ -224,7 +236,13 @@ private:
   PixelShaderUid m_ps_uid = {};
   UberShader::VertexUberShaderUid m_uber_vs_uid = {};
   UberShader::PixelUberShaderUid m_uber_ps_uid = {};
+  VkShaderModule m_uber_vs = VK_NULL_HANDLE;
+  VkShaderModule m_uber_ps = VK_NULL_HANDLE;
   bool m_using_ubershaders = false;
+  UberShader::PixelUberShaderConstants m_uber_constants = {};
+  bool m_uber_pipeline_pending = false;
+  // The specialized pipeline is looked up again on every draw until it has been compiled.
+  bool m_specialized_pipeline_pending = false;
 
   // pipeline state
   PipelineInfo m_pipeline_state = {};
@@ -245,6 +263,41 @@ private:
     VkDescriptorBufferInfo ps_ssbo = {};
   } m_bindings;
   u32 m_num_active_descriptor_sets = 0;
+
+  // Sampler sets written for the current command buffer, keyed by their bindings. Games tend to
+  // alternate between a few groups of textures, switching back to one reuses its set instead of
+  // allocating and writing a new one. Cleared with the descriptor pool.
+  using SamplerBindings = std::array<VkDescriptorImageInfo, NUM_PIXEL_SHADER_SAMPLERS>;
+  struct SamplerBindingsHash
+  {
+    size_t operator()(const SamplerBindings& key) const
+    {
+      size_t h = -1;
+      for (const VkDescriptorImageInfo& info : key)
+      {
+        h = h * 137 + (uintptr_t)info.imageView;
+        h = h * 137 + (uintptr_t)info.sampler;
+      }
+      return h;
+    }
+  };
+  struct SamplerBindingsEqual
+  {
+    bool operator()(const SamplerBindings& lhs, const SamplerBindings& rhs) const
+    {
+      for (size_t i = 0; i < lhs.size(); i++)
+      {
+        if (lhs[i].imageView != rhs[i].imageView || lhs[i].sampler != rhs[i].sampler ||
+          lhs[i].imageLayout != rhs[i].imageLayout)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+  std::unordered_map<SamplerBindings, VkDescriptorSet, SamplerBindingsHash, SamplerBindingsEqual>
+    m_sampler_set_cache;
   size_t m_uniform_buffer_reserve_size = 0;
 
   // rasterization
@@ -77,19 +77,30 @@ bool StreamBuffer::ResizeBuffer(size_t size)
   VkMemoryRequirements memory_requirements;
   vkGetBufferMemoryRequirements(g_vulkan_context->GetDevice(), buffer, &memory_requirements);
 
-  // Aim for a coherent mapping if possible.
-  u32 memory_type_index = g_vulkan_context->GetUploadMemoryType(memory_requirements.memoryTypeBits,
-    &m_coherent_mapping);
-
-  // Allocate memory for backing this buffer
+  // Prefer video memory the CPU can write to (resizable BAR), so draws don't read over the bus.
+  // Fall back to host memory if there is no such type or it is full.
   VkMemoryAllocateInfo memory_allocate_info = {
       VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,  // VkStructureType    sType
       nullptr,                                 // const void*        pNext
       memory_requirements.size,                // VkDeviceSize       allocationSize
-      memory_type_index                        // uint32_t           memoryTypeIndex
+      0                                        // uint32_t           memoryTypeIndex
   };
   VkDeviceMemory memory = VK_NULL_HANDLE;
-  res = vkAllocateMemory(g_vulkan_context->GetDevice(), &memory_allocate_info, nullptr, &memory);
+  res = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+  if (g_vulkan_context->GetDeviceLocalUploadMemoryType(memory_requirements.memoryTypeBits,
+                                                       memory_requirements.size,
+                                                       &memory_allocate_info.memoryTypeIndex,
+                                                       &m_coherent_mapping))
+  {
+    res = vkAllocateMemory(g_vulkan_context->GetDevice(), &memory_allocate_info, nullptr, &memory);
+  }
+  if (res != VK_SUCCESS)
+  {
+    // Aim for a coherent mapping if possible.
+    memory_allocate_info.memoryTypeIndex = g_vulkan_context->GetUploadMemoryType(
+        memory_requirements.memoryTypeBits, &m_coherent_mapping);
+    res = vkAllocateMemory(g_vulkan_context->GetDevice(), &memory_allocate_info, nullptr, &memory);
+  }
   if (res != VK_SUCCESS)
   {
     LOG_VULKAN_ERROR(res, "vkAllocateMemory failed: ");
@@ -14,6 +14,7 @@
 
 #include "VideoBackends/Vulkan/CommandBufferManager.h"
 #include "VideoBackends/Vulkan/VulkanContext.h"
+#include "VideoCommon/VideoConfig.h"
 
 #if defined(VK_USE_PLATFORM_XLIB_KHR)
 #include <X11/Xlib.h>
@@ -198,6 +199,14 @@ bool SwapChain::SelectPresentMode()
     return it != present_modes.end();
   };
 
+  // Mailbox doesn't tear either, but replaces queued images instead of waiting behind them.
+  m_low_latency_enabled = g_ActiveConfig.bLowLatency;
+  if (m_vsync_enabled && m_low_latency_enabled && CheckForMode(VK_PRESENT_MODE_MAILBOX_KHR))
+  {
+    m_present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
+    return true;
+  }
+
   // If vsync is enabled, use VK_PRESENT_MODE_FIFO_KHR.
   // This check should not fail with conforming drivers, as the FIFO present mode is mandated by
   // the specification (VK_KHR_swapchain). In case it isn't though, fall through to any other mode.
@@ -479,6 +488,15 @@ bool SwapChain::SetVSync(bool enabled)
   return RecreateSwapChain();
 }
 
+bool SwapChain::SetLowLatency(bool enabled)
+{
+  if (m_low_latency_enabled == enabled)
+    return true;
+
+  // The present mode is picked from the config when the swap chain is created.
+  return RecreateSwapChain();
+}
+
 bool SwapChain::RecreateSurface(void* native_handle)
 {
   // Destroy the old swap chain, images, and surface.
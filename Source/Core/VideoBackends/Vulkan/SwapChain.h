@@ -32,6 +32,7 @@ public:
   VkSurfaceKHR GetSurface() const { return m_surface; }
   VkSurfaceFormatKHR GetSurfaceFormat() const { return m_surface_format; }
   bool IsVSyncEnabled() const { return m_vsync_enabled; }
+  bool IsLowLatencyEnabled() const { return m_low_latency_enabled; }
   VkSwapchainKHR GetSwapChain() const { return m_swap_chain; }
   VkRenderPass GetRenderClearPass() const { return m_render_clear_pass; }
   VkRenderPass GetRenderAppendPass() const { return m_render_append_pass; }
@@ -59,6 +60,8 @@ public:
 
   // Change vsync enabled state. This may fail as it causes a swapchain recreation.
   bool SetVSync(bool enabled);
+  // Same for the low latency state, which prefers mailbox over FIFO when vsync is on.
+  bool SetLowLatency(bool enabled);
 
 private:
   bool SelectSurfaceFormat();
@@ -86,6 +89,7 @@ private:
   VkSurfaceFormatKHR m_surface_format = {};
   VkPresentModeKHR m_present_mode = VK_PRESENT_MODE_RANGE_SIZE_KHR;
   bool m_vsync_enabled;
+  bool m_low_latency_enabled = false;
 
   VkSwapchainKHR m_swap_chain = VK_NULL_HANDLE;
   std::vector<SwapChainImage> m_swap_chain_images;
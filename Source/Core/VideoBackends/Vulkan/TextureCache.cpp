@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -52,6 +53,8 @@ TextureCache::~TextureCache()
   }
   TextureCache::DeleteShaders();
   m_scaler.reset();
+  if (m_texture_upload_buffer)
+    g_command_buffer_mgr->RemoveFencePointCallback(this);
 }
 
 TextureCache* TextureCache::GetInstance()
@@ -69,6 +72,10 @@ bool TextureCache::Initialize()
     PanicAlert("Failed to create texture upload buffer");
     return false;
   }
+  g_command_buffer_mgr->AddFencePointCallback(
+    this, std::bind(&TextureCache::OnCommandBufferQueued, this, std::placeholders::_1,
+      std::placeholders::_2),
+    std::bind(&TextureCache::OnCommandBufferExecuted, this, std::placeholders::_1));
 
   if (!CreateRenderPasses())
   {
@@ -92,6 +99,81 @@ bool TextureCache::Initialize()
   return true;
 }
 
+StagingBuffer* TextureCache::GetLargeUploadBuffer(VkDeviceSize size)
+{
+  // Use the smallest idle buffer that fits.
+  LargeUploadBuffer* best = nullptr;
+  for (LargeUploadBuffer& it : m_large_upload_buffers)
+  {
+    if (!it.in_use && it.buffer->GetSize() >= size &&
+      (!best || it.buffer->GetSize() < best->buffer->GetSize()))
+    {
+      best = &it;
+    }
+  }
+
+  if (!best)
+  {
+    // Round up so textures of similar size can share buffers.
+    VkDeviceSize buffer_size = STAGING_TEXTURE_UPLOAD_THRESHOLD;
+    while (buffer_size < size)
+      buffer_size *= 2;
+
+    std::unique_ptr<StagingBuffer> buffer = StagingBuffer::Create(
+      STAGING_BUFFER_TYPE_UPLOAD, buffer_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    if (!buffer || !buffer->Map())
+      return nullptr;
+
+    m_large_upload_buffers.push_back({std::move(buffer)});
+    best = &m_large_upload_buffers.back();
+  }
+
+  best->in_use = true;
+  return best->buffer.get();
+}
+
+void TextureCache::OnCommandBufferQueued(VkCommandBuffer command_buffer, VkFence fence)
+{
+  for (LargeUploadBuffer& it : m_large_upload_buffers)
+  {
+    if (it.in_use && it.fence == VK_NULL_HANDLE)
+      it.fence = fence;
+  }
+}
+
+void TextureCache::OnCommandBufferExecuted(VkFence fence)
+{
+  VkDeviceSize pooled_size = 0;
+  for (LargeUploadBuffer& it : m_large_upload_buffers)
+  {
+    if (it.fence == fence)
+    {
+      it.fence = VK_NULL_HANDLE;
+      it.in_use = false;
+    }
+    if (!it.in_use)
+      pooled_size += it.buffer->GetSize();
+  }
+
+  // Release idle buffers, largest first, until the pool is back within its budget.
+  while (pooled_size > MAXIMUM_LARGE_UPLOAD_BUFFER_POOL_SIZE)
+  {
+    auto largest = m_large_upload_buffers.end();
+    for (auto it = m_large_upload_buffers.begin(); it != m_large_upload_buffers.end(); ++it)
+    {
+      if (!it->in_use &&
+        (largest == m_large_upload_buffers.end() ||
+          it->buffer->GetSize() > largest->buffer->GetSize()))
+      {
+        largest = it;
+      }
+    }
+
+    pooled_size -= largest->buffer->GetSize();
+    m_large_upload_buffers.erase(largest);
+  }
+}
+
 bool TextureCache::Palettize(TCacheEntry* _entry, const TCacheEntry* base_entry)
 {
   TCacheEntry* entry = static_cast<TCacheEntry*>(_entry);
@@ -115,9 +197,36 @@ void TextureCache::LoadLut(u32 lutFmt, void* addr, u32 size)
   m_pallette_size = size;
 }
 
-void TextureCache::CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
-  u32 num_blocks_y, u32 memory_stride,
-  bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
+namespace
+{
+class DeferredEFBCopy final : public TextureCacheBase::PendingEFBCopy
+{
+public:
+  DeferredEFBCopy(TextureConverter* converter, std::unique_ptr<StagingTexture2D> texture)
+    : m_converter(converter), m_texture(std::move(texture)),
+    m_fence(g_command_buffer_mgr->GetCurrentCommandBufferFence())
+  {
+  }
+
+  void WriteToMemory(u8* dst) override
+  {
+    if (m_fence == g_command_buffer_mgr->GetCurrentCommandBufferFence())
+      Util::ExecuteCurrentCommandsAndRestoreState(false, true);
+    else
+      g_command_buffer_mgr->WaitForFence(m_fence);
+
+    m_texture->ReadTexels(0, 0, m_texture->GetWidth(), m_texture->GetHeight(), dst, memory_stride);
+    m_converter->ReleaseStagingTexture(std::move(m_texture));
+  }
+
+private:
+  TextureConverter* m_converter;
+  std::unique_ptr<StagingTexture2D> m_texture;
+  VkFence m_fence;
+};
+}  // Anonymous namespace
+
+Texture2D* TextureCache::PrepareEFBForEncoding(bool is_depth_copy, const EFBRectangle& src_rect)
 {
   // Flush EFB pokes first, as they're expected to be included.
   FramebufferManager::GetInstance()->FlushEFBPokes();
@@ -143,6 +252,14 @@ void TextureCache::CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_widt
   // reading from the texture immediately afterwards.
   StateTracker::GetInstance()->EndRenderPass();
   StateTracker::GetInstance()->OnReadback();
+  return src_texture;
+}
+
+void TextureCache::CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
+  u32 num_blocks_y, u32 memory_stride,
+  bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
+{
+  Texture2D* src_texture = PrepareEFBForEncoding(is_depth_copy, src_rect);
 
   // Transition to shader resource before reading.
   VkImageLayout original_layout = src_texture->GetLayout();
@@ -157,6 +274,27 @@ void TextureCache::CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_widt
   src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(), original_layout);
 }
 
+std::unique_ptr<TextureCacheBase::PendingEFBCopy>
+TextureCache::CopyEFBDeferred(const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
+  u32 num_blocks_y, u32 memory_stride, bool is_depth_copy,
+  const EFBRectangle& src_rect, bool scale_by_half)
+{
+  Texture2D* src_texture = PrepareEFBForEncoding(is_depth_copy, src_rect);
+
+  VkImageLayout original_layout = src_texture->GetLayout();
+  src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  std::unique_ptr<StagingTexture2D> texture = m_texture_converter->EncodeTextureToStagingTexture(
+    src_texture->GetView(), format, native_width, bytes_per_row, num_blocks_y, is_depth_copy,
+    src_rect, scale_by_half);
+
+  src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(), original_layout);
+  if (!texture)
+    return nullptr;
+  return std::make_unique<DeferredEFBCopy>(m_texture_converter.get(), std::move(texture));
+}
+
 HostTextureFormat TextureCache::GetHostTextureFormat(const s32 texformat, const TlutFormat tlutfmt, u32 width, u32 height)
 {
   const bool compressed_supported = ((width & 3) == 0) && ((height & 3) == 0);
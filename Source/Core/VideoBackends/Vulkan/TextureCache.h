@@ -6,8 +6,10 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "VideoBackends/Vulkan/StagingBuffer.h"
 #include "VideoBackends/Vulkan/StreamBuffer.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureScalerCommon.h"
@@ -48,6 +50,10 @@ public:
     u32 num_blocks_y, u32 memory_stride,
     bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half) override;
 
+  std::unique_ptr<PendingEFBCopy> CopyEFBDeferred(const EFBCopyFormat& format, u32 native_width,
+    u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
+    bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half) override;
+
   bool SupportsGPUTextureDecode(TextureFormat format, TlutFormat palette_format) override;
   TextureConverter* GetTextureConverter()
   {
@@ -81,12 +87,29 @@ public:
   {
     return m_texture_upload_buffer.get();
   }
+  // Returns a mapped staging buffer of at least size bytes for uploads too large for the texture
+  // upload buffer. It can be written right away and is reused once the current command buffer
+  // has executed.
+  StagingBuffer* GetLargeUploadBuffer(VkDeviceSize size);
 private:
+  struct LargeUploadBuffer
+  {
+    std::unique_ptr<StagingBuffer> buffer;
+    VkFence fence = VK_NULL_HANDLE;
+    bool in_use = false;
+  };
+
+  void OnCommandBufferQueued(VkCommandBuffer command_buffer, VkFence fence);
+  void OnCommandBufferExecuted(VkFence fence);
+
   bool CreateRenderPasses();
+  // Resolves the EFB and ends the render pass so it can be encoded.
+  Texture2D* PrepareEFBForEncoding(bool is_depth_copy, const EFBRectangle& src_rect);
 
   std::array<VkRenderPass, 5> m_render_pass;
 
   std::unique_ptr<StreamBuffer> m_texture_upload_buffer;
+  std::vector<LargeUploadBuffer> m_large_upload_buffers;
 
   std::unique_ptr<TextureConverter> m_texture_converter;
 
@@ -66,6 +66,19 @@ TextureConverter::~TextureConverter()
       vkDestroyShaderModule(g_vulkan_context->GetDevice(), it.second.compute_shader, nullptr);
   }
 
+  if (m_async_decoding_textures[0])
+  {
+    g_command_buffer_mgr->RemoveFencePointCallback(this);
+    for (const auto& views : m_async_decoding_layer_views)
+    {
+      for (VkImageView view : views)
+      {
+        if (view != VK_NULL_HANDLE)
+          g_command_buffer_mgr->DeferImageViewDestruction(view);
+      }
+    }
+  }
+
   if (m_rgb_to_yuyv_shader != VK_NULL_HANDLE)
     vkDestroyShaderModule(g_vulkan_context->GetDevice(), m_rgb_to_yuyv_shader, nullptr);
   if (m_yuyv_to_rgb_shader != VK_NULL_HANDLE)
@@ -110,6 +123,12 @@ bool TextureConverter::Initialize()
     return false;
   }
 
+  if (g_command_buffer_mgr->UsesAsyncCompute() && !CreateAsyncDecodingTextures())
+  {
+    PanicAlert("Failed to create async decoding textures");
+    return false;
+  }
+
   if (!CompileYUYVConversionShaders())
   {
     PanicAlert("Failed to compile YUYV conversion shaders");
@@ -218,13 +237,79 @@ void TextureConverter::EncodeTextureToMemory(VkImageView src_texture, u8* dest_p
   u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
   bool is_depth_copy, const EFBRectangle& src_rect,
   bool scale_by_half)
+{
+  if (!EncodeTextureToRenderTexture(src_texture, format, native_width, bytes_per_row, num_blocks_y,
+    is_depth_copy, src_rect, scale_by_half))
+  {
+    return;
+  }
+
+  u32 render_width = bytes_per_row / sizeof(u32);
+  u32 render_height = num_blocks_y;
+  m_encoding_download_texture->CopyFromImage(
+    g_command_buffer_mgr->GetCurrentCommandBuffer(), m_encoding_render_texture->GetImage(),
+    VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, render_width, render_height, 0, 0);
+
+  // Block until the GPU has finished copying to the staging texture.
+  Util::ExecuteCurrentCommandsAndRestoreState(false, true);
+
+  // Copy from staging texture to the final destination, adjusting pitch if necessary.
+  m_encoding_download_texture->ReadTexels(0, 0, render_width, render_height, dest_ptr,
+    memory_stride);
+}
+
+std::unique_ptr<StagingTexture2D> TextureConverter::EncodeTextureToStagingTexture(
+  VkImageView src_texture, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
+  u32 num_blocks_y, bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
+{
+  if (!EncodeTextureToRenderTexture(src_texture, format, native_width, bytes_per_row, num_blocks_y,
+    is_depth_copy, src_rect, scale_by_half))
+  {
+    return nullptr;
+  }
+
+  u32 render_width = bytes_per_row / sizeof(u32);
+  u32 render_height = num_blocks_y;
+  std::unique_ptr<StagingTexture2D> texture;
+  auto iter = std::find_if(m_encoding_staging_textures.begin(), m_encoding_staging_textures.end(),
+    [render_width, render_height](const std::unique_ptr<StagingTexture2D>& tex) {
+    return tex->GetWidth() == render_width && tex->GetHeight() == render_height;
+  });
+  if (iter != m_encoding_staging_textures.end())
+  {
+    texture = std::move(*iter);
+    m_encoding_staging_textures.erase(iter);
+  }
+  else
+  {
+    texture = StagingTexture2D::Create(STAGING_BUFFER_TYPE_READBACK, render_width, render_height,
+      ENCODING_TEXTURE_FORMAT);
+    if (!texture || !texture->Map())
+      return nullptr;
+  }
+
+  texture->CopyFromImage(g_command_buffer_mgr->GetCurrentCommandBuffer(),
+    m_encoding_render_texture->GetImage(), VK_IMAGE_ASPECT_COLOR_BIT, 0, 0,
+    render_width, render_height, 0, 0);
+  return texture;
+}
+
+void TextureConverter::ReleaseStagingTexture(std::unique_ptr<StagingTexture2D> texture)
+{
+  if (m_encoding_staging_textures.size() < MAX_ENCODING_STAGING_TEXTURES)
+    m_encoding_staging_textures.push_back(std::move(texture));
+}
+
+bool TextureConverter::EncodeTextureToRenderTexture(VkImageView src_texture,
+  const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row, u32 num_blocks_y,
+  bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half)
 {
   VkShaderModule shader = GetEncodingShader(format);
   if (shader == VK_NULL_HANDLE)
   {
     ERROR_LOG(VIDEO, "Missing encoding fragment shader for format %u->%u", format.efb_format,
       static_cast<u32>(format.copy_format));
-    return;
+    return false;
   }
 
   // Can't do our own draw within a render pass.
@@ -263,16 +348,7 @@ void TextureConverter::EncodeTextureToMemory(VkImageView src_texture, u8* dest_p
   // Transition the image before copying
   m_encoding_render_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-  m_encoding_download_texture->CopyFromImage(
-    g_command_buffer_mgr->GetCurrentCommandBuffer(), m_encoding_render_texture->GetImage(),
-    VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, render_width, render_height, 0, 0);
-
-  // Block until the GPU has finished copying to the staging texture.
-  Util::ExecuteCurrentCommandsAndRestoreState(false, true);
-
-  // Copy from staging texture to the final destination, adjusting pitch if necessary.
-  m_encoding_download_texture->ReadTexels(0, 0, render_width, render_height, dest_ptr,
-    memory_stride);
+  return true;
 }
 
 void TextureConverter::EncodeTextureToMemoryYUYV(void* dst_ptr, u32 dst_width, u32 dst_stride,
@@ -499,37 +575,54 @@ bool TextureConverter::DecodeTexture(HostTexture* dst, u32 dst_level,
     break;
   }
 
-  // Place compute shader dispatches together in the init command buffer.
+  // Dispatch on the async compute queue while the current command buffer has a free layer,
+  // the init command buffer then copies from it once the compute work has finished.
+  VkCommandBuffer init_command_buffer = g_command_buffer_mgr->GetCurrentInitCommandBuffer();
+  VkCommandBuffer compute_command_buffer = init_command_buffer;
+  Texture2D* decoding_texture = m_decoding_texture.get();
+  VkImageView decoding_view = m_decoding_texture->GetView();
+  u32 decoding_layer = 0;
+  if (m_async_decoding_textures[0] && m_async_decoding_layers_used < ASYNC_DECODING_TEXTURE_LAYERS)
+  {
+    const size_t index = g_command_buffer_mgr->GetCurrentCommandBufferIndex();
+    compute_command_buffer = g_command_buffer_mgr->GetCurrentComputeCommandBuffer();
+    decoding_texture = m_async_decoding_textures[index].get();
+    decoding_layer = m_async_decoding_layers_used++;
+    decoding_view = m_async_decoding_layer_views[index][decoding_layer];
+  }
+
+  // Otherwise place compute shader dispatches together in the init command buffer.
   // That way we don't have to pay a penalty for switching from graphics->compute,
   // or end/restart our render pass.
-  VkCommandBuffer command_buffer = g_command_buffer_mgr->GetCurrentInitCommandBuffer();
-
   // Dispatch compute to temporary texture.
-  ComputeShaderDispatcher dispatcher(command_buffer,
+  ComputeShaderDispatcher dispatcher(compute_command_buffer,
     g_object_cache->GetPipelineLayout(PIPELINE_LAYOUT_COMPUTE),
     iter->second.compute_shader);
-  m_decoding_texture->TransitionToLayout(command_buffer, Texture2D::ComputeImageLayout::WriteOnly);
+  decoding_texture->TransitionToLayout(compute_command_buffer,
+    Texture2D::ComputeImageLayout::WriteOnly);
   dispatcher.SetPushConstants(&constants, sizeof(constants));
-  dispatcher.SetStorageImage(m_decoding_texture->GetView(), m_decoding_texture->GetLayout());
+  dispatcher.SetStorageImage(decoding_view, decoding_texture->GetLayout());
   dispatcher.SetTexelBuffer(0, data_view);
   if (has_palette)
     dispatcher.SetTexelBuffer(1, m_texel_buffer_view_r16_uint);
   auto groups = TextureConversionShader::GetDispatchCount(iter->second.base_info, aligned_width, aligned_height);
   dispatcher.Dispatch(groups.first, groups.second, 1);
 
-  // Copy from temporary texture to final destination.
-  m_decoding_texture->TransitionToLayout(command_buffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-  static_cast<VKTexture*>(dst)->GetRawTexIdentifier()->TransitionToLayout(command_buffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-  VkImageCopy image_copy = { { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+  // Copy from temporary texture to final destination. The async layers stay in the general
+  // layout, the semaphore between the queues makes the writes visible.
+  if (decoding_texture == m_decoding_texture.get())
+    decoding_texture->TransitionToLayout(init_command_buffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+  static_cast<VKTexture*>(dst)->GetRawTexIdentifier()->TransitionToLayout(init_command_buffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+  VkImageCopy image_copy = { { VK_IMAGE_ASPECT_COLOR_BIT, 0, decoding_layer, 1 },
   { 0, 0, 0 },
   { VK_IMAGE_ASPECT_COLOR_BIT, dst_level, 0, 1 },
   { 0, 0, 0 },
   { width, height, 1 } };
-  vkCmdCopyImage(command_buffer, m_decoding_texture->GetImage(),
-    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, static_cast<VKTexture*>(dst)->GetRawTexIdentifier()->GetImage(),
+  vkCmdCopyImage(init_command_buffer, decoding_texture->GetImage(),
+    decoding_texture->GetLayout(), static_cast<VKTexture*>(dst)->GetRawTexIdentifier()->GetImage(),
     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &image_copy);
   // Texture should always be in SHADER_READ_ONLY layout prior to use.
-  static_cast<VKTexture*>(dst)->GetRawTexIdentifier()->TransitionToLayout(command_buffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  static_cast<VKTexture*>(dst)->GetRawTexIdentifier()->TransitionToLayout(init_command_buffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   return true;
 }
 
@@ -768,6 +861,47 @@ bool TextureConverter::CreateDecodingTexture()
   return static_cast<bool>(m_decoding_texture);
 }
 
+bool TextureConverter::CreateAsyncDecodingTextures()
+{
+  for (size_t i = 0; i < NUM_COMMAND_BUFFERS; i++)
+  {
+    m_async_decoding_textures[i] = Texture2D::Create(
+      DECODING_TEXTURE_WIDTH, DECODING_TEXTURE_HEIGHT, 1, ASYNC_DECODING_TEXTURE_LAYERS,
+      VK_FORMAT_R8G8B8A8_UNORM, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+      VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+    if (!m_async_decoding_textures[i])
+      return false;
+
+    // The decoding shaders write to layer 0 of an array, so each layer gets its own view.
+    for (u32 layer = 0; layer < ASYNC_DECODING_TEXTURE_LAYERS; layer++)
+    {
+      VkImageViewCreateInfo view_info = {
+        VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        nullptr,
+        0,
+        m_async_decoding_textures[i]->GetImage(),
+        VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        { VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
+          VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY },
+        { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, layer, 1 } };
+      VkResult res = vkCreateImageView(g_vulkan_context->GetDevice(), &view_info, nullptr,
+        &m_async_decoding_layer_views[i][layer]);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateImageView failed: ");
+        return false;
+      }
+    }
+  }
+
+  // Every submitted command buffer takes its layers with it.
+  g_command_buffer_mgr->AddFencePointCallback(
+    this, [this](VkCommandBuffer, VkFence) { m_async_decoding_layers_used = 0; },
+    [](VkFence) {});
+  return true;
+}
+
 bool TextureConverter::CompileYUYVConversionShaders()
 {
   static const char RGB_TO_YUYV_SHADER_SOURCE[] = R"(
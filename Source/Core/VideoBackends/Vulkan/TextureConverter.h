@@ -8,8 +8,10 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "VideoBackends/Vulkan/Constants.h"
 #include "VideoBackends/Vulkan/StreamBuffer.h"
 #include "VideoBackends/Vulkan/TextureCache.h"
 #include "VideoCommon/BPMemory.h"
@@ -41,6 +43,13 @@ public:
     u32 memory_stride, bool is_depth_copy, const EFBRectangle& src_rect,
     bool scale_by_half);
 
+  // Same encode, but only records the copy to a staging texture. The texels can be read once the
+  // current command buffer has completed, then the texture should be given back.
+  std::unique_ptr<StagingTexture2D> EncodeTextureToStagingTexture(
+    VkImageView src_texture, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
+    u32 num_blocks_y, bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half);
+  void ReleaseStagingTexture(std::unique_ptr<StagingTexture2D> texture);
+
   // Encodes texture to guest memory in XFB (YUYV) format.
   void EncodeTextureToMemoryYUYV(void* dst_ptr, u32 dst_width, u32 dst_stride, u32 dst_height,
     Texture2D* src_texture, const MathUtil::Rectangle<int>& src_rect);
@@ -59,11 +68,19 @@ private:
   static const u32 ENCODING_TEXTURE_WIDTH = EFB_WIDTH * 4;
   static const u32 ENCODING_TEXTURE_HEIGHT = 1024;
   static const VkFormat ENCODING_TEXTURE_FORMAT = VK_FORMAT_B8G8R8A8_UNORM;
+  static const size_t MAX_ENCODING_STAGING_TEXTURES = 16;
+
+  // Draws the encoded copy to m_encoding_render_texture and leaves it in TRANSFER_SRC layout.
+  bool EncodeTextureToRenderTexture(VkImageView src_texture, const EFBCopyFormat& format,
+    u32 native_width, u32 bytes_per_row, u32 num_blocks_y,
+    bool is_depth_copy, const EFBRectangle& src_rect, bool scale_by_half);
   static const size_t NUM_PALETTE_CONVERSION_SHADERS = 3;
 
   // Maximum size of a texture based on BP registers.
   static const u32 DECODING_TEXTURE_WIDTH = 1024;
   static const u32 DECODING_TEXTURE_HEIGHT = 1024;
+  // Decodes per command buffer that can run on the async compute queue.
+  static const u32 ASYNC_DECODING_TEXTURE_LAYERS = 4;
 
   bool CreateTexelBuffer();
   VkBufferView CreateTexelBufferView(VkFormat format) const;
@@ -77,6 +94,7 @@ private:
   bool CreateEncodingDownloadTexture();
 
   bool CreateDecodingTexture();
+  bool CreateAsyncDecodingTextures();
 
   bool CompileYUYVConversionShaders();
 
@@ -107,6 +125,7 @@ private:
   VkRenderPass m_encoding_render_pass = VK_NULL_HANDLE;
   std::unique_ptr<Texture2D> m_encoding_render_texture;
   std::unique_ptr<StagingTexture2D> m_encoding_download_texture;
+  std::vector<std::unique_ptr<StagingTexture2D>> m_encoding_staging_textures;
 
   // Texture decoding - GX format in memory->RGBA8
   struct TextureDecodingPipeline
@@ -118,6 +137,14 @@ private:
   std::map<std::pair<TextureFormat, TlutFormat>, TextureDecodingPipeline> m_decoding_pipelines;
   std::unique_ptr<Texture2D> m_decoding_texture;
 
+  // With an async compute queue, decoding writes to a layer of the texture that belongs to the
+  // current command buffer, and only the copy to the destination stays on the graphics queue.
+  // The layers are reused once the command buffer's fence has passed.
+  std::array<std::unique_ptr<Texture2D>, NUM_COMMAND_BUFFERS> m_async_decoding_textures;
+  std::array<std::array<VkImageView, ASYNC_DECODING_TEXTURE_LAYERS>, NUM_COMMAND_BUFFERS>
+    m_async_decoding_layer_views = {};
+  u32 m_async_decoding_layers_used = 0;
+
   // XFB encoding/decoding shaders
   VkShaderModule m_rgb_to_yuyv_shader = VK_NULL_HANDLE;
   VkShaderModule m_yuyv_to_rgb_shader = VK_NULL_HANDLE;
@@ -349,21 +349,41 @@ void VKTexture::Load(const u8* src, u32 width, u32 height, u32 expanded_width, u
   else
   {
     // Slow path. The data for the image is too large to fit in the streaming buffer, so we need
-    // to allocate a temporary texture to store the data in, then copy to the real texture.
-    std::unique_ptr<StagingTexture2D> staging_texture = StagingTexture2D::Create(
-      STAGING_BUFFER_TYPE_UPLOAD, width, height, m_texture->GetFormat());
-
-    if (!staging_texture || !staging_texture->Map())
+    // a separate staging buffer from the pool to store the data in, then copy to the real texture.
+    StagingBuffer* staging_buffer =
+      TextureCache::GetInstance()->GetLargeUploadBuffer(upload_size);
+    if (!staging_buffer)
     {
-      PanicAlert("Failed to allocate staging texture for large texture upload.");
+      PanicAlert("Failed to allocate staging buffer for large texture upload.");
       return;
     }
 
-    // Copy data to staging texture first, then to the "real" texture.
-    staging_texture->WriteTexels(0, 0, width, height, src, source_pitch);
-    staging_texture->CopyToImage(g_command_buffer_mgr->GetCurrentInitCommandBuffer(),
-      m_texture->GetImage(), VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, width,
-      height, level, layer);
+    char* staging_pointer = staging_buffer->GetMapPointer();
+    if (upload_pitch != source_pitch)
+    {
+      u32 copy_pitch = std::min(source_pitch, upload_pitch);
+      for (u32 row = 0; row < block_H; row++)
+      {
+        std::memcpy(staging_pointer + row * upload_pitch, src + row * source_pitch, copy_pitch);
+      }
+    }
+    else
+    {
+      std::memcpy(staging_pointer, src, upload_size);
+    }
+    staging_buffer->FlushCPUCache();
+
+    VkBufferImageCopy image_copy = {
+      0,                                               // VkDeviceSize                bufferOffset
+      0,                                               // uint32_t                    bufferRowLength
+      0,                                               // uint32_t                    bufferImageHeight
+      { VK_IMAGE_ASPECT_COLOR_BIT, level, layer, 1 },  // VkImageSubresourceLayers    imageSubresource
+      { 0, 0, 0 },                                     // VkOffset3D                  imageOffset
+      { width, height, 1 }                             // VkExtent3D                  imageExtent
+    };
+    vkCmdCopyBufferToImage(g_command_buffer_mgr->GetCurrentInitCommandBuffer(),
+      staging_buffer->GetBuffer(), m_texture->GetImage(),
+      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &image_copy);
   }
   // Last mip level? We shouldn't be doing any further uploads now, so transition for rendering.
   if (level == (m_config.levels - 1))
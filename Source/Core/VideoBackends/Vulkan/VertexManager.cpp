@@ -16,6 +16,7 @@
 #include "VideoBackends/Vulkan/VertexFormat.h"
 #include "VideoBackends/Vulkan/VulkanContext.h"
 
+#include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/Statistics.h"
@@ -154,8 +155,8 @@ void VertexManager::vFlush(bool use_dst_alpha)
   // with the command buffer that has the corresponding draw.
   PrepareDrawBuffers(vertex_stride);
 
-  // Flush all EFB pokes and invalidate the peek cache.
-  FramebufferManager::GetInstance()->InvalidatePeekCache();
+  // Flush all EFB pokes and invalidate the peek cache where the draw can write.
+  FramebufferManager::GetInstance()->InvalidatePeekCache(BPFunctions::GetScissorRect());
   FramebufferManager::GetInstance()->FlushEFBPokes();
 
   // If bounding box is enabled, we need to flush any changes first, then invalidate what we have.
@@ -186,6 +187,9 @@ void VertexManager::vFlush(bool use_dst_alpha)
     m_current_draw_base_index, m_current_draw_base_vertex, 0);
   if (PerfQueryBase::ShouldEmulate())
     static_cast<PerfQuery*>(g_perf_query.get())->EndQuery();
+  INCSTAT(stats.thisFrame.numDrawCalls);
+  if (StateTracker::GetInstance()->IsUsingUberShaders())
+    INCSTAT(stats.thisFrame.numUberShaderDraws);
 
   // If the GPU does not support dual-source blending, we can approximate the effect by drawing
   // the object a second time, with the write mask set to alpha only using a shader that outputs
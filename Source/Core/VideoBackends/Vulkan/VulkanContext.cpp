@@ -222,6 +222,7 @@ void VulkanContext::PopulateBackendInfo(VideoConfig* config)
 {
   config->backend_info.APIType = API_VULKAN;
   config->backend_info.MaxTextureSize = 16 * 1024;
+  config->backend_info.VideoMemorySize = 0;
   config->backend_info.bSupportsExclusiveFullscreen = false;  // Currently WSI does not allow this.
   config->backend_info.bSupports3DVision = false;             // D3D-exclusive.
   config->backend_info.bSupportsOversizedViewports = true;    // Assumed support.
@@ -235,6 +236,7 @@ void VulkanContext::PopulateBackendInfo(VideoConfig* config)
   config->backend_info.bSupportsDualSourceBlend = false;      // Dependent on features.
   config->backend_info.bSupportsGeometryShaders = false;      // Dependent on features.
   config->backend_info.bSupportsGSInstancing = false;         // Dependent on features.
+  config->backend_info.bSupportsVSLayerOutput = false;        // Not implemented.
   config->backend_info.bSupportsBBox = false;                 // Dependent on features.
   config->backend_info.bSupportsSSAA = false;                 // Dependent on features.
   config->backend_info.bSupportsFragmentStoresAndAtomics = false;     // Dependent on features.
@@ -254,6 +256,7 @@ void VulkanContext::PopulateBackendInfo(VideoConfig* config)
   config->backend_info.bSupportsAsyncShaderCompilation = false;
   config->backend_info.bSupportsUberShaders = true;
   config->backend_info.bSupportsHighPrecisionFrameBuffer = false;
+  config->backend_info.bSupportsPrimitiveRestart = true;
 }
 
 void VulkanContext::PopulateBackendInfoAdapters(VideoConfig* config, const GPUList& gpu_list)
@@ -272,6 +275,15 @@ void VulkanContext::PopulateBackendInfoFeatures(VideoConfig* config, VkPhysicalD
   const VkPhysicalDeviceFeatures& features)
 {
   config->backend_info.MaxTextureSize = properties.limits.maxImageDimension2D;
+
+  VkPhysicalDeviceMemoryProperties memory_properties;
+  vkGetPhysicalDeviceMemoryProperties(gpu, &memory_properties);
+  config->backend_info.VideoMemorySize = 0;
+  for (u32 i = 0; i < memory_properties.memoryHeapCount; i++)
+  {
+    if (memory_properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+      config->backend_info.VideoMemorySize += memory_properties.memoryHeaps[i].size;
+  }
   config->backend_info.bSupportsDualSourceBlend = (features.dualSrcBlend == VK_TRUE);
   config->backend_info.bSupportsGeometryShaders = (features.geometryShader == VK_TRUE);
   config->backend_info.bSupportsGSInstancing = (features.geometryShader == VK_TRUE);
@@ -545,13 +557,17 @@ bool VulkanContext::CreateDevice(VkSurfaceKHR surface, bool enable_validation_la
   device_info.pNext = nullptr;
   device_info.flags = 0;
 
-  static constexpr float queue_priorities[] = { 1.0f };
+  // A second queue of the graphics family runs texture decoding alongside drawing. Staying in the
+  // same family means images don't have to change queue ownership between the two.
+  static constexpr float queue_priorities[] = { 1.0f, 1.0f };
+  const bool has_async_compute_queue =
+    queue_family_properties[m_graphics_queue_family_index].queueCount > 1;
   VkDeviceQueueCreateInfo graphics_queue_info = {};
   graphics_queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
   graphics_queue_info.pNext = nullptr;
   graphics_queue_info.flags = 0;
   graphics_queue_info.queueFamilyIndex = m_graphics_queue_family_index;
-  graphics_queue_info.queueCount = 1;
+  graphics_queue_info.queueCount = has_async_compute_queue ? 2 : 1;
   graphics_queue_info.pQueuePriorities = queue_priorities;
 
   VkDeviceQueueCreateInfo present_queue_info = {};
@@ -609,6 +625,11 @@ bool VulkanContext::CreateDevice(VkSurfaceKHR surface, bool enable_validation_la
 
   // Grab the graphics and present queues.
   vkGetDeviceQueue(m_device, m_graphics_queue_family_index, 0, &m_graphics_queue);
+  if (has_async_compute_queue)
+  {
+    vkGetDeviceQueue(m_device, m_graphics_queue_family_index, 1, &m_async_compute_queue);
+    INFO_LOG(VIDEO, "Using a second queue of the graphics family for async compute");
+  }
   if (surface)
   {
     vkGetDeviceQueue(m_device, m_present_queue_family_index, 0, &m_present_queue);
@@ -733,6 +754,35 @@ u32 VulkanContext::GetUploadMemoryType(u32 bits, bool* is_coherent)
   return type_index;
 }
 
+bool VulkanContext::GetDeviceLocalUploadMemoryType(u32 bits, VkDeviceSize size,
+                                                   u32* out_type_index, bool* is_coherent)
+{
+  // Without resizable BAR the window is usually 256MB and shared with the driver, so only use it
+  // when the buffer is a small fraction of the heap.
+  static constexpr VkDeviceSize HEAP_SIZE_DIVISOR = 8;
+
+  VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  u32 type_index;
+  if (!GetMemoryType(bits, flags, &type_index))
+  {
+    flags &= ~VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    if (!GetMemoryType(bits, flags, &type_index))
+      return false;
+  }
+
+  const VkMemoryType& type = m_device_memory_properties.memoryTypes[type_index];
+  if (m_device_memory_properties.memoryHeaps[type.heapIndex].size / HEAP_SIZE_DIVISOR < size)
+    return false;
+
+  *out_type_index = type_index;
+  if (is_coherent)
+    *is_coherent = ((flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0);
+
+  return true;
+}
+
 u32 VulkanContext::GetReadbackMemoryType(u32 bits, bool* is_coherent, bool* is_cached)
 {
   // Try for cached and coherent memory first.
@@ -58,6 +58,8 @@ public:
   VkQueue GetGraphicsQueue() const { return m_graphics_queue; }
   u32 GetGraphicsQueueFamilyIndex() const { return m_graphics_queue_family_index; }
   VkQueue GetPresentQueue() const { return m_present_queue; }
+  // Second queue of the graphics family, VK_NULL_HANDLE if the family only has one.
+  VkQueue GetAsyncComputeQueue() const { return m_async_compute_queue; }
   u32 GetPresentQueueFamilyIndex() const { return m_present_queue_family_index; }
   const VkQueueFamilyProperties& GetGraphicsQueueProperties() const
   {
@@ -105,6 +107,11 @@ public:
 
   // Finds a memory type for upload or readback buffers.
   u32 GetUploadMemoryType(u32 bits, bool* is_coherent = nullptr);
+
+  // Finds a device-local memory type the CPU can write to directly, for buffers the GPU reads
+  // every draw. Only used when the heap has plenty of room left for a buffer of this size.
+  bool GetDeviceLocalUploadMemoryType(u32 bits, VkDeviceSize size, u32* out_type_index,
+                                      bool* is_coherent = nullptr);
   u32 GetReadbackMemoryType(u32 bits, bool* is_coherent = nullptr, bool* is_cached = nullptr);
 
 private:
@@ -123,6 +130,7 @@ private:
   u32 m_graphics_queue_family_index = 0;
   VkQueue m_present_queue = VK_NULL_HANDLE;
   u32 m_present_queue_family_index = 0;
+  VkQueue m_async_compute_queue = VK_NULL_HANDLE;
   VkQueueFamilyProperties m_graphics_queue_properties = {};
 
   VkDebugReportCallbackEXT m_debug_report_callback = VK_NULL_HANDLE;
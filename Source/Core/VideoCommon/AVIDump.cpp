@@ -13,9 +13,19 @@ extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/mathematics.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
+// Hardware frames for encoders that only take GPU surfaces (VAAPI). NVENC and QSV also take
+// frames in system memory.
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(56, 0, 100)
+#define HAVE_AV_HWCONTEXT 1
+extern "C" {
+#include <libavutil/hwcontext.h>
+}
+#endif
+
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
@@ -43,6 +53,10 @@ static AVFrame* s_src_frame = nullptr;
 static AVFrame* s_scaled_frame = nullptr;
 static AVPixelFormat s_pix_fmt = AV_PIX_FMT_BGR24;
 static SwsContext* s_sws_context = nullptr;
+#ifdef HAVE_AV_HWCONTEXT
+static AVBufferRef* s_hw_device_context = nullptr;
+static AVFrame* s_hw_frame = nullptr;
+#endif
 static int s_width;
 static int s_height;
 static u64 s_last_frame;
@@ -126,51 +140,83 @@ static std::string GetDumpPath(const std::string& format)
   return s_dump_path;
 }
 
-bool AVIDump::CreateVideoFile()
+static bool IsPixelFormatSupported(const AVCodec* codec, AVPixelFormat pix_fmt)
 {
-  const std::string& s_format = g_Config.sDumpFormat;
-
-  std::string s_dump_path = GetDumpPath(s_format);
+  if (!codec->pix_fmts)
+    return true;
+  for (const AVPixelFormat* fmt = codec->pix_fmts; *fmt != AV_PIX_FMT_NONE; fmt++)
+  {
+    if (*fmt == pix_fmt)
+      return true;
+  }
+  return false;
+}
 
-  if (s_dump_path.empty())
-    return false;
+// The format the encoder is fed with, YUV420P unless it wants something else.
+static AVPixelFormat GetEncoderPixelFormat(const AVCodec* codec)
+{
+  if (g_Config.bUseFFV1)
+    return AV_PIX_FMT_BGRA;
+  if (IsPixelFormatSupported(codec, AV_PIX_FMT_YUV420P))
+    return AV_PIX_FMT_YUV420P;
+  if (IsPixelFormatSupported(codec, AV_PIX_FMT_NV12))
+    return AV_PIX_FMT_NV12;
+  return codec->pix_fmts[0];
+}
 
-  AVOutputFormat* output_format = av_guess_format(s_format.c_str(), s_dump_path.c_str(), nullptr);
-  if (!output_format)
+#ifdef HAVE_AV_HWCONTEXT
+static AVHWDeviceType GetHardwareDeviceType(AVPixelFormat pix_fmt)
+{
+  switch (pix_fmt)
   {
-    ERROR_LOG(VIDEO, "Invalid format %s", s_format.c_str());
-    return false;
+  case AV_PIX_FMT_VAAPI:
+    return AV_HWDEVICE_TYPE_VAAPI;
+  case AV_PIX_FMT_QSV:
+    return AV_HWDEVICE_TYPE_QSV;
+  case AV_PIX_FMT_CUDA:
+    return AV_HWDEVICE_TYPE_CUDA;
+  default:
+    return AV_HWDEVICE_TYPE_NONE;
   }
+}
 
-  if (avformat_alloc_output_context2(&s_format_context, output_format, nullptr,
-    s_dump_path.c_str()) < 0)
+// Frames are converted to NV12 on the CPU and uploaded to a pool of GPU surfaces.
+static bool CreateHardwareFrames(AVCodecContext* codec_context, AVHWDeviceType type)
+{
+  if (av_hwdevice_ctx_create(&s_hw_device_context, type, nullptr, nullptr, 0) < 0)
   {
-    ERROR_LOG(VIDEO, "Could not allocate output context");
+    ERROR_LOG(VIDEO, "Could not create %s device", av_hwdevice_get_type_name(type));
     return false;
   }
 
-  const std::string& codec_name = g_Config.bUseFFV1 ? "ffv1" : g_Config.sDumpCodec;
-
-  AVCodecID codec_id = output_format->video_codec;
-
-  if (!codec_name.empty())
+  AVBufferRef* frames_ref = av_hwframe_ctx_alloc(s_hw_device_context);
+  if (!frames_ref)
+    return false;
+  AVHWFramesContext* frames_context = reinterpret_cast<AVHWFramesContext*>(frames_ref->data);
+  frames_context->format = codec_context->pix_fmt;
+  frames_context->sw_format = AV_PIX_FMT_NV12;
+  frames_context->width = codec_context->width;
+  frames_context->height = codec_context->height;
+  frames_context->initial_pool_size = 4;
+  if (av_hwframe_ctx_init(frames_ref) < 0)
   {
-    const AVCodecDescriptor* codec_desc = avcodec_descriptor_get_by_name(codec_name.c_str());
-    if (codec_desc)
-      codec_id = codec_desc->id;
-    else
-      WARN_LOG(VIDEO, "Invalid codec %s", codec_name.c_str());
+    ERROR_LOG(VIDEO, "Could not create %s frames", av_hwdevice_get_type_name(type));
+    av_buffer_unref(&frames_ref);
+    return false;
   }
 
-  const AVCodec* codec = nullptr;
+  // The codec context owns the reference now.
+  codec_context->hw_frames_ctx = frames_ref;
+  s_hw_frame = av_frame_alloc();
+  return s_hw_frame != nullptr;
+}
+#endif
 
-  codec = avcodec_find_encoder(codec_id);
+static bool OpenCodec(const AVCodec* codec, const AVOutputFormat* output_format)
+{
   s_codec_context = avcodec_alloc_context3(codec);
-  if (!codec || !s_codec_context)
-  {
-    ERROR_LOG(VIDEO, "Could not find encoder or allocate codec context");
+  if (!s_codec_context)
     return false;
-  }
 
   // Force XVID FourCC for better compatibility
   if (codec->id == AV_CODEC_ID_MPEG4)
@@ -183,24 +229,37 @@ bool AVIDump::CreateVideoFile()
   s_codec_context->time_base.num = 1;
   s_codec_context->time_base.den = VideoInterface::GetTargetRefreshRate();
   s_codec_context->gop_size = 12;
-  s_codec_context->pix_fmt = g_Config.bUseFFV1 ? AV_PIX_FMT_BGRA : AV_PIX_FMT_YUV420P;
+  s_codec_context->pix_fmt = GetEncoderPixelFormat(codec);
 
   if (output_format->flags & AVFMT_GLOBALHEADER)
     s_codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
 
+  AVPixelFormat sw_pix_fmt = s_codec_context->pix_fmt;
+  const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(s_codec_context->pix_fmt);
+  if (desc && (desc->flags & AV_PIX_FMT_FLAG_HWACCEL))
+  {
+#ifdef HAVE_AV_HWCONTEXT
+    AVHWDeviceType type = GetHardwareDeviceType(s_codec_context->pix_fmt);
+    if (type == AV_HWDEVICE_TYPE_NONE || !CreateHardwareFrames(s_codec_context, type))
+      return false;
+    sw_pix_fmt = AV_PIX_FMT_NV12;
+#else
+    return false;
+#endif
+  }
+
   if (avcodec_open2(s_codec_context, codec, nullptr) < 0)
   {
-    ERROR_LOG(VIDEO, "Could not open codec");
+    ERROR_LOG(VIDEO, "Could not open codec %s", codec->name);
     return false;
   }
 
-  s_src_frame = av_frame_alloc();
   s_scaled_frame = av_frame_alloc();
-
-  s_scaled_frame->format = s_codec_context->pix_fmt;
+  if (!s_scaled_frame)
+    return false;
+  s_scaled_frame->format = sw_pix_fmt;
   s_scaled_frame->width = s_width;
   s_scaled_frame->height = s_height;
-
 #if LIBAVCODEC_VERSION_MAJOR >= 55
   if (av_frame_get_buffer(s_scaled_frame, 1))
     return false;
@@ -208,6 +267,88 @@ bool AVIDump::CreateVideoFile()
   if (avcodec_default_get_buffer(s_codec_context, s_scaled_frame))
     return false;
 #endif
+  return true;
+}
+
+static void CloseCodec()
+{
+  av_frame_free(&s_scaled_frame);
+  avcodec_free_context(&s_codec_context);
+#ifdef HAVE_AV_HWCONTEXT
+  av_frame_free(&s_hw_frame);
+  av_buffer_unref(&s_hw_device_context);
+#endif
+}
+
+bool AVIDump::CreateVideoFile()
+{
+  const std::string& s_format = g_Config.sDumpFormat;
+
+  std::string s_dump_path = GetDumpPath(s_format);
+
+  if (s_dump_path.empty())
+    return false;
+
+  AVOutputFormat* output_format = av_guess_format(s_format.c_str(), s_dump_path.c_str(), nullptr);
+  if (!output_format)
+  {
+    ERROR_LOG(VIDEO, "Invalid format %s", s_format.c_str());
+    return false;
+  }
+
+  if (avformat_alloc_output_context2(&s_format_context, output_format, nullptr,
+    s_dump_path.c_str()) < 0)
+  {
+    ERROR_LOG(VIDEO, "Could not allocate output context");
+    return false;
+  }
+
+  const std::string& codec_name = g_Config.bUseFFV1 ? "ffv1" : g_Config.sDumpCodec;
+
+  AVCodecID codec_id = output_format->video_codec;
+
+  if (!codec_name.empty())
+  {
+    const AVCodecDescriptor* codec_desc = avcodec_descriptor_get_by_name(codec_name.c_str());
+    if (codec_desc)
+      codec_id = codec_desc->id;
+    else
+      WARN_LOG(VIDEO, "Invalid codec %s", codec_name.c_str());
+  }
+
+  const AVCodec* codec = nullptr;
+
+  // Hardware encoders are picked by name, as they share the codec id with the software ones.
+  if (!g_Config.bUseFFV1 && !g_Config.sDumpEncoder.empty())
+  {
+    const AVCodec* encoder = avcodec_find_encoder_by_name(g_Config.sDumpEncoder.c_str());
+    if (!encoder || encoder->type != AVMEDIA_TYPE_VIDEO)
+    {
+      WARN_LOG(VIDEO, "Invalid encoder %s", g_Config.sDumpEncoder.c_str());
+    }
+    else if (OpenCodec(encoder, output_format))
+    {
+      codec = encoder;
+    }
+    else
+    {
+      WARN_LOG(VIDEO, "Encoder %s is not available, falling back to software encoding",
+               g_Config.sDumpEncoder.c_str());
+      CloseCodec();
+    }
+  }
+
+  if (!codec)
+  {
+    codec = avcodec_find_encoder(codec_id);
+    if (!codec || !OpenCodec(codec, output_format))
+    {
+      ERROR_LOG(VIDEO, "Could not find or open encoder");
+      return false;
+    }
+  }
+
+  s_src_frame = av_frame_alloc();
 
 
   s_stream = avformat_new_stream(s_format_context, codec);
@@ -308,7 +449,8 @@ void AVIDump::AddFrame(const u8* data, int width, int height, int stride, const
   // Convert image from {BGR24, RGBA} to desired pixel format
   s_sws_context =
     sws_getCachedContext(s_sws_context, width, height, s_pix_fmt, s_width, s_height,
-      s_codec_context->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
+      static_cast<AVPixelFormat>(s_scaled_frame->format), SWS_BICUBIC, nullptr, nullptr,
+      nullptr);
   if (s_sws_context)
   {
     sws_scale(s_sws_context, s_src_frame->data, s_src_frame->linesize, 0, height,
@@ -347,7 +489,20 @@ void AVIDump::AddFrame(const u8* data, int width, int height, int stride, const
   {
     s_last_frame = state.ticks;
     s_last_pts = pts_in_ticks;
-    error = SendFrameAndReceivePacket(s_codec_context, &pkt, s_scaled_frame, &got_packet);
+    AVFrame* frame = s_scaled_frame;
+#ifdef HAVE_AV_HWCONTEXT
+    if (s_codec_context->hw_frames_ctx)
+    {
+      av_frame_unref(s_hw_frame);
+      error = av_hwframe_get_buffer(s_codec_context->hw_frames_ctx, s_hw_frame, 0);
+      if (!error)
+        error = av_hwframe_transfer_data(s_hw_frame, s_scaled_frame, 0);
+      s_hw_frame->pts = s_scaled_frame->pts;
+      frame = s_hw_frame;
+    }
+#endif
+    if (!error)
+      error = SendFrameAndReceivePacket(s_codec_context, &pkt, frame, &got_packet);
   }
   if (!error && got_packet)
   {
@@ -392,9 +547,7 @@ void AVIDump::Stop()
 void AVIDump::CloseVideoFile()
 {
   av_frame_free(&s_src_frame);
-  av_frame_free(&s_scaled_frame);
-
-  avcodec_free_context(&s_codec_context);
+  CloseCodec();
 
   if (s_format_context)
   {
@@ -8,6 +8,7 @@
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
@@ -23,21 +24,21 @@ void AsyncRequests::PullEventsInternal()
   std::unique_lock<std::mutex> lock(m_mutex);
   m_empty.Set();
 
-  while (!m_queue.empty())
+  while (!IsQueueEmpty())
   {
-    Event e = m_queue.front();
+    Event e = GetQueueFront();
 
     // try to merge as many efb pokes as possible
     // it's a bit hacky, but some games render a complete frame in this way
     if ((e.type == Event::EFB_POKE_COLOR || e.type == Event::EFB_POKE_Z))
     {
       m_merged_efb_pokes.clear();
-      Event first_event = m_queue.front();
+      Event first_event = GetQueueFront();
       EFBAccessType t = first_event.type == Event::EFB_POKE_COLOR ? EFBAccessType::PokeColor : EFBAccessType::PokeZ;
 
       do
       {
-        e = m_queue.front();
+        e = GetQueueFront();
 
         EfbPokeData d;
         d.data = e.efb_poke.data;
@@ -45,10 +46,11 @@ void AsyncRequests::PullEventsInternal()
         d.y = e.efb_poke.y;
         m_merged_efb_pokes.push_back(d);
 
-        m_queue.pop();
-      } while (!m_queue.empty() && m_queue.front().type == first_event.type);
+        PopQueue();
+      } while (!IsQueueEmpty() && GetQueueFront().type == first_event.type);
 
       lock.unlock();
+      g_texture_cache->OnEFBModified();
       g_renderer->PokeEFB(t, m_merged_efb_pokes.data(), m_merged_efb_pokes.size());
       lock.lock();
       continue;
@@ -58,7 +60,7 @@ void AsyncRequests::PullEventsInternal()
     HandleEvent(e);
     lock.lock();
 
-    m_queue.pop();
+    PopQueue();
   }
 
   if (m_wake_me_up_again)
@@ -84,14 +86,14 @@ void AsyncRequests::PushEvent(const AsyncRequests::Event& event, bool blocking)
   if (!m_enable)
     return;
 
-  m_queue.push(event);
+  m_queue.push_back(event);
 
   Fifo::RunGpu();
   if (blocking)
   {
     m_cond.wait(lock, [this]
     {
-      return m_queue.empty();
+      return IsQueueEmpty();
     });
   }
 }
@@ -104,8 +106,8 @@ void AsyncRequests::SetEnable(bool enable)
   if (!enable)
   {
     // flush the queue on disabling
-    while (!m_queue.empty())
-      m_queue.pop();
+    while (!IsQueueEmpty())
+      PopQueue();
     if (m_wake_me_up_again)
       m_cond.notify_all();
   }
@@ -119,6 +121,7 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
   case Event::EFB_POKE_COLOR:
   {
     EfbPokeData poke = { e.efb_poke.x, e.efb_poke.y, e.efb_poke.data };
+    g_texture_cache->OnEFBModified();
     g_renderer->PokeEFB(EFBAccessType::PokeColor, &poke, 1);
   }
   break;
@@ -126,6 +129,7 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
   case Event::EFB_POKE_Z:
   {
     EfbPokeData poke = { e.efb_poke.x, e.efb_poke.y, e.efb_poke.data };
+    g_texture_cache->OnEFBModified();
     g_renderer->PokeEFB(EFBAccessType::PokeZ, &poke, 1);
   }
   break;
@@ -156,6 +160,10 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
     g_perf_query->FlushResults();
     break;
 
+  case Event::PERF_QUERY_POLL:
+    g_perf_query->PollResults();
+    break;
+
   }
 }
 
@@ -6,7 +6,6 @@
 
 #include <condition_variable>
 #include <mutex>
-#include <queue>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -28,6 +27,7 @@ public:
       SWAP_EVENT,
       BBOX_READ,
       PERF_QUERY,
+      PERF_QUERY_POLL,
     } type;
     u64 time;
 
@@ -86,10 +86,24 @@ private:
   void PullEventsInternal();
   void HandleEvent(const Event& e);
 
+  bool IsQueueEmpty() const { return m_queue_head == m_queue.size(); }
+  const Event& GetQueueFront() const { return m_queue[m_queue_head]; }
+  void PopQueue()
+  {
+    if (++m_queue_head == m_queue.size())
+    {
+      m_queue.clear();
+      m_queue_head = 0;
+    }
+  }
+
   static AsyncRequests s_singleton;
 
   Common::Flag m_empty;
-  std::queue<Event> m_queue;
+  // A queue that keeps its storage once it is drained, std::queue allocated a block every few
+  // events.
+  std::vector<Event> m_queue;
+  size_t m_queue_head = 0;
   std::mutex m_mutex;
   std::condition_variable m_cond;
 
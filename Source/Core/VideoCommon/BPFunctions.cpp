@@ -10,6 +10,7 @@
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoCommon.h"
@@ -37,6 +38,14 @@ void SetGenerationMode()
 }
 
 void SetScissor()
+{
+  g_renderer->SetScissorRect(GetScissorRect());
+  VertexShaderManager::SetViewportChanged();
+  GeometryShaderManager::SetViewportChanged();
+  PixelShaderManager::SetViewportChanged();
+}
+
+EFBRectangle GetScissorRect()
 {
   /* NOTE: the minimum value here for the scissor rect and offset is -342.
   * GX internally adds on an offset of 342 to both the offset and scissor
@@ -63,10 +72,7 @@ void SetScissor()
   if (rc.left > rc.right) std::swap(rc.right, rc.left);
   if (rc.top > rc.bottom) std::swap(rc.bottom, rc.top);
 
-  g_renderer->SetScissorRect(rc);
-  VertexShaderManager::SetViewportChanged();
-  GeometryShaderManager::SetViewportChanged();
-  PixelShaderManager::SetViewportChanged();
+  return rc;
 }
 
 void SetLineWidth()
@@ -134,6 +140,7 @@ void ClearScreen(const EFBRectangle &rc)
       color = RGBA8ToRGB565ToRGBA8(color);
       z = Z24ToZ16ToZ24(z);
     }
+    g_texture_cache->OnEFBModified(rc);
     g_renderer->ClearScreen(rc, colorEnable, alphaEnable, zEnable, color, z);
   }
 }
@@ -202,6 +209,7 @@ void OnPixelFormatChange()
     goto skip;
   }
 
+  g_texture_cache->OnEFBModified();
   g_renderer->ReinterpretPixelData(convtype);
 
 skip:
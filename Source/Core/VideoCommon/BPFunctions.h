@@ -19,6 +19,8 @@ namespace BPFunctions
 void FlushPipeline();
 void SetGenerationMode();
 void SetScissor();
+// The scissor rectangle in EFB coordinates, clamped to the EFB.
+EFBRectangle GetScissorRect();
 void SetLineWidth();
 void SetDepthMode();
 void SetBlendMode();
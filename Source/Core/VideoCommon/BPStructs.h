@@ -9,3 +9,6 @@ struct BPCmd;
 void BPInit();
 void BPReload();
 void BPWritten(const BPCmd& bp);
+
+// True while the GPU drops the draws and EFB copies of a fast-forward frame.
+bool BPIsFrameSkipped();
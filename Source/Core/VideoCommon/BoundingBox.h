@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "VideoCommon/NativeVertexFormat.h"
 
 // Bounding Box manager
@@ -41,4 +43,51 @@ void Prepare(const VAT& vat, int primitive, const TVtxDesc& vtxDesc, const Porta
 // Save state
 void DoState(PointerWrap& p);
 
+// Bookkeeping for the backends' GPU bounding box in latency tolerant mode. A read copies the GPU
+// values into the next of a few staging buffers and then takes the newest copy the GPU has
+// already finished, so the CPU never waits. Copies started before the CPU last wrote the values
+// are dropped, they would overwrite the write.
+class ReadbackRing
+{
+public:
+  static constexpr u32 NUM_SLOTS = 3;
+
+  // Returns the staging buffer to copy the current GPU values to.
+  u32 Begin()
+  {
+    const u32 slot = m_next;
+    m_next = (m_next + 1) % NUM_SLOTS;
+    m_pending[slot] = true;
+    m_slot_generation[slot] = m_generation;
+    return slot;
+  }
+
+  // The CPU changed the values.
+  void Invalidate() { m_generation++; }
+
+  // Checks the copies oldest first. is_done(slot) must not wait for the GPU, read(slot) is only
+  // called for copies that are still current.
+  template <typename IsDone, typename Read>
+  void Poll(IsDone is_done, Read read)
+  {
+    for (u32 i = 0; i < NUM_SLOTS; i++)
+    {
+      const u32 slot = (m_next + i) % NUM_SLOTS;
+      if (!m_pending[slot])
+        continue;
+      if (!is_done(slot))
+        break;
+      if (m_slot_generation[slot] == m_generation)
+        read(slot);
+      m_pending[slot] = false;
+    }
+  }
+
+private:
+  u32 m_next = 0;
+  u32 m_generation = 0;
+  std::array<u32, NUM_SLOTS> m_slot_generation{};
+  std::array<bool, NUM_SLOTS> m_pending{};
+};
+
 }; // end of namespace BoundingBox
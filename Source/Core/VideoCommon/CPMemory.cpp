@@ -38,6 +38,7 @@ template <bool is_preprocess>
 void LoadCPReg(u32 sub_cmd, u32 value)
 {
   CPState* state = is_preprocess ? &g_preprocess_cp_state : &g_main_cp_state;
+  // Rewriting the same vertex format or array pointer doesn't dirty the loaders.
   switch (sub_cmd & 0xF0)
   {
   case 0x30:
@@ -51,42 +52,67 @@ void LoadCPReg(u32 sub_cmd, u32 value)
     break;
 
   case 0x50:
-    state->vtx_desc.Hex &= ~0x1FFFF;  // keep the Upper bits
-    state->vtx_desc.Hex |= value;
-    state->attr_dirty = 0xFF;
-    state->bases_dirty = true;
+  {
+    const u64 vtx_desc = (state->vtx_desc.Hex & ~0x1FFFFull) | value;  // keep the Upper bits
+    if (vtx_desc != state->vtx_desc.Hex)
+    {
+      state->vtx_desc.Hex = vtx_desc;
+      state->attr_dirty = 0xFF;
+      state->bases_dirty = true;
+    }
     break;
+  }
 
   case 0x60:
-    state->vtx_desc.Hex &= 0x1FFFF;  // keep the lower 17Bits
-    state->vtx_desc.Hex |= (u64)value << 17;
-    state->attr_dirty = 0xFF;
-    state->bases_dirty = true;
+  {
+    const u64 vtx_desc = (state->vtx_desc.Hex & 0x1FFFF) | ((u64)value << 17);  // keep the lower 17Bits
+    if (vtx_desc != state->vtx_desc.Hex)
+    {
+      state->vtx_desc.Hex = vtx_desc;
+      state->attr_dirty = 0xFF;
+      state->bases_dirty = true;
+    }
     break;
+  }
 
   case 0x70:
     ASSERT((sub_cmd & 0x0F) < 8);
-    state->vtx_attr[sub_cmd & 7].g0.Hex = value;
-    state->attr_dirty |= 1 << (sub_cmd & 7);
+    if (state->vtx_attr[sub_cmd & 7].g0.Hex != value)
+    {
+      state->vtx_attr[sub_cmd & 7].g0.Hex = value;
+      state->attr_dirty |= 1 << (sub_cmd & 7);
+    }
     break;
 
   case 0x80:
     ASSERT((sub_cmd & 0x0F) < 8);
-    state->vtx_attr[sub_cmd & 7].g1.Hex = value;
-    state->attr_dirty |= 1 << (sub_cmd & 7);
+    if (state->vtx_attr[sub_cmd & 7].g1.Hex != value)
+    {
+      state->vtx_attr[sub_cmd & 7].g1.Hex = value;
+      state->attr_dirty |= 1 << (sub_cmd & 7);
+    }
     break;
 
   case 0x90:
     ASSERT((sub_cmd & 0x0F) < 8);
-    state->vtx_attr[sub_cmd & 7].g2.Hex = value;
-    state->attr_dirty |= 1 << (sub_cmd & 7);
+    if (state->vtx_attr[sub_cmd & 7].g2.Hex != value)
+    {
+      state->vtx_attr[sub_cmd & 7].g2.Hex = value;
+      state->attr_dirty |= 1 << (sub_cmd & 7);
+    }
     break;
 
     // Pointers to vertex arrays in GC RAM
   case 0xA0:
-    state->array_bases[sub_cmd & 0xF] = value & CommandProcessor::GetPhysicalAddressMask();
-    state->bases_dirty = true;
+  {
+    const u32 base = value & CommandProcessor::GetPhysicalAddressMask();
+    if (state->array_bases[sub_cmd & 0xF] != base)
+    {
+      state->array_bases[sub_cmd & 0xF] = base;
+      state->bases_dirty = true;
+    }
     break;
+  }
 
   case 0xB0:
     state->array_strides[sub_cmd & 0xF] = value & 0xFF;
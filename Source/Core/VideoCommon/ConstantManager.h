@@ -85,4 +85,6 @@ struct TessellationShaderConstants
 {
   float4 tessparams;
   int4 cullparams;
+  // x: projected edge size to factor scale, 0 uses the fixed factor
+  float4 tessadapt;
 };
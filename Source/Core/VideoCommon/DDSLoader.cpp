@@ -262,34 +262,28 @@ bool ImageLoader::ReadDDS(ImageLoaderParams& loader_params)
   }
 
   //
-  // Suport only Basic DDS compresion Formats
+  // Suport only Basic DDS compresion Formats, they are uploaded without decoding.
+  // The sRGB and typeless DX10 variants hold the same blocks as the UNORM ones, and the
+  // emulated hardware doesn't do any gamma conversion either.
   //
-  u32 FourCC = ddsd.ddpfPixelFormat.dwFourCC;
-  if ((FourCC == FOURCC_DXT1 || dxt10_format == 71) &&
-      g_ActiveConfig.backend_info.bSupportedFormats[HostTextureFormat::PC_TEX_FMT_DXT1])
-  {
-    block_size = 8;
-  }
-  else if ((FourCC == FOURCC_DXT3 || dxt10_format == 74) &&
-           g_ActiveConfig.backend_info.bSupportedFormats[HostTextureFormat::PC_TEX_FMT_DXT3])
-  {
-    block_size = 16;
-  }
-  else if ((FourCC == FOURCC_DXT5 || dxt10_format == 77) &&
-           g_ActiveConfig.backend_info.bSupportedFormats[HostTextureFormat::PC_TEX_FMT_DXT5])
-  {
-    block_size = 16;
-  }
-  else if (dxt10_format == 98 &&
-           g_ActiveConfig.backend_info.bSupportedFormats[HostTextureFormat::PC_TEX_FMT_BPTC])
-  {
-    block_size = 16;
-  }
-  else
+  const u32 FourCC = ddsd.ddpfPixelFormat.dwFourCC;
+  HostTextureFormat format = HostTextureFormat::PC_TEX_FMT_NONE;
+  if (FourCC == FOURCC_DXT1 || (dxt10_format >= 70 && dxt10_format <= 72))
+    format = HostTextureFormat::PC_TEX_FMT_DXT1;
+  else if (FourCC == FOURCC_DXT3 || (dxt10_format >= 73 && dxt10_format <= 75))
+    format = HostTextureFormat::PC_TEX_FMT_DXT3;
+  else if (FourCC == FOURCC_DXT5 || (dxt10_format >= 76 && dxt10_format <= 78))
+    format = HostTextureFormat::PC_TEX_FMT_DXT5;
+  else if (dxt10_format >= 97 && dxt10_format <= 99)
+    format = HostTextureFormat::PC_TEX_FMT_BPTC;
+
+  if (format == HostTextureFormat::PC_TEX_FMT_NONE ||
+      !g_ActiveConfig.backend_info.bSupportedFormats[format])
   {
     // unsupported format
     return false;
   }
+  block_size = format == HostTextureFormat::PC_TEX_FMT_DXT1 ? 8 : 16;
 
   //
   // How big will the buffer need to be to load all of the pixel data
@@ -351,24 +345,12 @@ bool ImageLoader::ReadDDS(ImageLoaderParams& loader_params)
   }
   loader_params.Width = ddsd.dwWidth;
   loader_params.Height = ddsd.dwHeight;
-  if (FourCC == FOURCC_DXT1 || dxt10_format == 71)
+  loader_params.resultTex = format;
+  if (format == HostTextureFormat::PC_TEX_FMT_DXT1)
   {
-    loader_params.resultTex = HostTextureFormat::PC_TEX_FMT_DXT1;
     loader_params.Width = ((ddsd.dwWidth + 3) >> 2) << 2;
     loader_params.Height = ((ddsd.dwHeight + 3) >> 2) << 2;
   }
-  else if (FourCC == FOURCC_DXT3 || dxt10_format == 74)
-  {
-    loader_params.resultTex = HostTextureFormat::PC_TEX_FMT_DXT3;
-  }
-  else if (FourCC == FOURCC_DXT5 || dxt10_format == 77)
-  {
-    loader_params.resultTex = HostTextureFormat::PC_TEX_FMT_DXT5;
-  }
-  else
-  {
-    loader_params.resultTex = HostTextureFormat::PC_TEX_FMT_BPTC;
-  }  
   // loader_params should get the number of mipmaps, not counting the first level
   loader_params.nummipmaps = (ddsd.dwMipMapCount != 0) ? (ddsd.dwMipMapCount - 1) : 0;
   return true;
@@ -0,0 +1,41 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+class VertexLoaderBase;
+struct VertexLoaderParameters;
+
+// Display list cache.
+// Games tend to call the same static display lists every frame. The register loads
+// inside them are cheap and have side effects (flushes, EFB copies, ...) so they are
+// always replayed through the opcode decoder, but converting their vertices is not.
+// We remember the converted vertex data of every primitive batch of a display list,
+// keyed on address, size and content hash, and copy it straight to the vertex buffer
+// the next time the same list is called with the same vertex format.
+// Invalidation is implicit: a list whose memory has been written since it was recorded
+// no longer matches its hash and is recorded again.
+namespace DLCache
+{
+void Init();
+void Shutdown();
+void Clear();
+
+// Evicts lists that have not been called for a while. Called once per frame.
+void ProgressiveCleanup();
+
+// Brackets the interpretation of a display list. data points to the list contents,
+// which may be a copy (deterministic GPU thread) rather than emulated memory.
+void BeginDisplayList(u32 address, const u8* data, u32 size);
+void EndDisplayList();
+
+// Called by VertexLoaderManager for every primitive batch.
+// Returns true and fills finalcount if the converted vertices were copied from the cache.
+bool ReplayVertices(const VertexLoaderParameters& parameters, const VertexLoaderBase* loader,
+                    s32* finalcount);
+void RecordVertices(const VertexLoaderParameters& parameters, const VertexLoaderBase* loader,
+                    s32 finalcount);
+}  // namespace DLCache
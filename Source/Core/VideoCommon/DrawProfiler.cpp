@@ -0,0 +1,211 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/DrawProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VertexShaderGen.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace DrawProfiler
+{
+namespace
+{
+struct Object
+{
+  u32 loop;
+  u32 frame;
+  u32 object;
+};
+
+std::atomic<bool> s_enabled{false};
+
+// Written by the CPU thread while the GPU is idle, read by the video thread.
+std::atomic<u32> s_current_loop{0};
+std::atomic<u32> s_current_frame{0};
+std::atomic<u32> s_current_object{0};
+
+// Video thread only.
+Object s_batch_object{};
+Draw s_pending_draw{};
+std::chrono::steady_clock::time_point s_draw_start;
+
+std::mutex s_draws_lock;
+std::vector<Draw> s_draws;
+
+void WriteCSV(std::ostream& file, const std::vector<Draw>& draws)
+{
+  file << "loop,frame,object,indices,vertex_shader_uid,pixel_shader_uid,texture_address,"
+          "texture_hash,cpu_time_us,gpu_time_us\n";
+  for (const Draw& draw : draws)
+  {
+    file << StringFromFormat("%u,%u,%u,%u,%016" PRIx64 ",%016" PRIx64 ",%08x,%016" PRIx64
+                             ",%.3f,",
+                             draw.loop, draw.frame, draw.object, draw.indices,
+                             draw.vertex_shader_uid, draw.pixel_shader_uid, draw.texture_address,
+                             draw.texture_hash, draw.cpu_time_us);
+    if (draw.gpu_time_us >= 0.0f)
+      file << StringFromFormat("%.3f", draw.gpu_time_us);
+    file << '\n';
+  }
+}
+}  // Anonymous namespace
+
+void SetEnabled(bool enabled)
+{
+  s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsEnabled()
+{
+  return s_enabled.load(std::memory_order_relaxed);
+}
+
+void SetCurrentObject(u32 loop, u32 frame, u32 object)
+{
+  s_current_loop.store(loop, std::memory_order_relaxed);
+  s_current_frame.store(frame, std::memory_order_relaxed);
+  s_current_object.store(object, std::memory_order_release);
+}
+
+void BeginBatch()
+{
+  if (!IsEnabled())
+    return;
+
+  const u32 object = s_current_object.load(std::memory_order_acquire);
+  s_batch_object = {s_current_loop.load(std::memory_order_relaxed),
+                    s_current_frame.load(std::memory_order_relaxed), object};
+}
+
+void BeginDraw(u32 indices, u32 texture_address, u64 texture_hash)
+{
+  // The backends pick their shaders from the same state, so this names the shaders the draw
+  // uses without asking them.
+  VertexShaderUid vs_uid;
+  GetVertexShaderUID(vs_uid, VertexLoaderManager::g_current_components, xfmem, bpmem);
+  vs_uid.CalculateUIDHash();
+  PixelShaderUid ps_uid;
+  GetPixelShaderUID(ps_uid, PSRM_DEFAULT, VertexLoaderManager::g_current_components, xfmem,
+                    bpmem);
+  ps_uid.CalculateUIDHash();
+
+  s_pending_draw.loop = s_batch_object.loop;
+  s_pending_draw.frame = s_batch_object.frame;
+  s_pending_draw.object = s_batch_object.object;
+  s_pending_draw.indices = indices;
+  s_pending_draw.vertex_shader_uid = VertexShaderUid::ShaderUidHasher()(vs_uid);
+  s_pending_draw.pixel_shader_uid = PixelShaderUid::ShaderUidHasher()(ps_uid);
+  s_pending_draw.texture_address = texture_address;
+  s_pending_draw.texture_hash = texture_hash;
+  s_pending_draw.gpu_time_us = -1.0f;
+  s_draw_start = std::chrono::steady_clock::now();
+}
+
+void EndDraw()
+{
+  s_pending_draw.cpu_time_us =
+      std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - s_draw_start)
+          .count();
+
+  std::lock_guard<std::mutex> lk(s_draws_lock);
+  if (s_draws.size() < MAX_DRAWS)
+    s_draws.push_back(s_pending_draw);
+}
+
+size_t GetNextDrawIndex()
+{
+  std::lock_guard<std::mutex> lk(s_draws_lock);
+  return s_draws.size();
+}
+
+void SetGPUTime(size_t draw, float gpu_time_us)
+{
+  std::lock_guard<std::mutex> lk(s_draws_lock);
+  if (draw < s_draws.size())
+    s_draws[draw].gpu_time_us = gpu_time_us;
+}
+
+std::vector<Draw> GetDraws()
+{
+  std::lock_guard<std::mutex> lk(s_draws_lock);
+  return s_draws;
+}
+
+std::vector<ObjectCost> GetObjectCosts()
+{
+  struct Totals
+  {
+    u32 draws = 0;
+    double cpu_time_us = 0;
+    double gpu_time_us = 0;
+    bool has_gpu_time = false;
+    u32 loops = 0;
+    u32 last_loop = 0;
+  };
+  std::map<std::pair<u32, u32>, Totals> objects;
+  for (const Draw& draw : GetDraws())
+  {
+    Totals& totals = objects[{draw.frame, draw.object}];
+    if (!totals.loops || totals.last_loop != draw.loop)
+    {
+      totals.loops++;
+      totals.last_loop = draw.loop;
+    }
+    totals.draws++;
+    totals.cpu_time_us += draw.cpu_time_us;
+    if (draw.gpu_time_us >= 0.0f)
+    {
+      totals.gpu_time_us += draw.gpu_time_us;
+      totals.has_gpu_time = true;
+    }
+  }
+
+  std::vector<ObjectCost> costs;
+  costs.reserve(objects.size());
+  for (const auto& entry : objects)
+  {
+    const Totals& totals = entry.second;
+    costs.push_back({entry.first.first, entry.first.second, totals.draws / totals.loops,
+                     static_cast<float>(totals.cpu_time_us / totals.loops),
+                     totals.has_gpu_time ? static_cast<float>(totals.gpu_time_us / totals.loops) :
+                                           -1.0f});
+  }
+  std::sort(costs.begin(), costs.end(), [](const ObjectCost& a, const ObjectCost& b) {
+    if (a.gpu_time_us != b.gpu_time_us)
+      return a.gpu_time_us > b.gpu_time_us;
+    return a.cpu_time_us > b.cpu_time_us;
+  });
+  return costs;
+}
+
+bool Export(const std::string& filename)
+{
+  std::ofstream file;
+  File::OpenFStream(file, filename, std::ios_base::out);
+  if (!file.is_open())
+    return false;
+
+  WriteCSV(file, GetDraws());
+  return file.good();
+}
+
+void ExportCSV(std::ostream& stream)
+{
+  WriteCSV(stream, GetDraws());
+}
+}  // namespace DrawProfiler
@@ -0,0 +1,72 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Cost of every draw while the FIFO player profiles a log. The player writes one object at a
+// time and waits for the GPU in between, so each draw can be attributed to the object it came
+// from. The video thread times the backend's draw on the CPU and, where the backend supports it,
+// on the GPU.
+namespace DrawProfiler
+{
+struct Draw
+{
+  u32 loop;
+  u32 frame;
+  u32 object;
+  u32 indices;
+  u64 vertex_shader_uid;
+  u64 pixel_shader_uid;
+  // First texture the draw samples, zero if it doesn't use any.
+  u32 texture_address;
+  u64 texture_hash;
+  float cpu_time_us;
+  // Negative when the backend doesn't measure GPU time.
+  float gpu_time_us;
+};
+
+struct ObjectCost
+{
+  u32 frame;
+  u32 object;
+  u32 draws;
+  // Averages over the loops the object was played in.
+  float cpu_time_us;
+  float gpu_time_us;
+};
+
+// Later draws are dropped.
+constexpr size_t MAX_DRAWS = 1 << 20;
+
+void SetEnabled(bool enabled);
+bool IsEnabled();
+
+// Called by the FIFO player, with the GPU idle, before it writes the object.
+void SetCurrentObject(u32 loop, u32 frame, u32 object);
+
+// Called by the vertex manager. A batch belongs to the object that was current when its first
+// primitive was added, even if it is only flushed by a later object.
+void BeginBatch();
+void BeginDraw(u32 indices, u32 texture_address, u64 texture_hash);
+void EndDraw();
+// Index the draw between BeginDraw and EndDraw will have, for SetGPUTime.
+size_t GetNextDrawIndex();
+
+// Called by backends that time draws on the GPU, once the result is available.
+void SetGPUTime(size_t draw, float gpu_time_us);
+
+std::vector<Draw> GetDraws();
+// Sorted by GPU time, or CPU time when the backend doesn't measure GPU time.
+std::vector<ObjectCost> GetObjectCosts();
+
+// Writes one row per draw.
+bool Export(const std::string& filename);
+void ExportCSV(std::ostream& stream);
+}  // namespace DrawProfiler
@@ -2,20 +2,64 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cinttypes>
 #include <fstream>
 #include <iomanip>
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
 #include "Common/Timer.h"
+#include "Core/Analytics.h"
+#include "Core/HW/DVD/DVDThread.h"
 #include "VideoCommon/FPSCounter.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VideoConfig.h"
 
 static constexpr u64 FPS_REFRESH_INTERVAL = 250000;
+// Spikes are only looked for once the median means something.
+static constexpr size_t MIN_FRAMES_FOR_SPIKES = 60;
 
 FPSCounter::FPSCounter()
 {
   m_last_time = Common::Timer::GetTimeUs();
+  m_last_shaders_created = stats.GetShadersCreated();
+}
+
+FPSCounter::~FPSCounter()
+{
+  if (!m_total_frames)
+    return;
+
+  // Average FPS of the slowest fraction of the session, walking the histogram from the top.
+  auto get_low_fps = [this](double fraction) {
+    const u64 wanted = std::max<u64>(1, static_cast<u64>(m_total_frames * fraction));
+    u64 count = 0;
+    double total_ms = 0;
+    for (size_t i = HISTOGRAM_BUCKETS; i-- > 0 && count < wanted;)
+    {
+      const u64 taken = std::min<u64>(m_histogram[i], wanted - count);
+      count += taken;
+      total_ms += taken * (i + 0.5) / 10.0;
+    }
+    return static_cast<float>(1000.0 * count / total_ms);
+  };
+
+  NOTICE_LOG(VIDEO,
+             "Frame times of %" PRIu64 " frames: p50 %.1f ms, p95 %.1f ms, p99 %.1f ms, "
+             "1%% low %.1f fps, 0.1%% low %.1f fps, %" PRIu64 " spikes",
+             m_total_frames, GetHistogramPercentile(0.5), GetHistogramPercentile(0.95),
+             GetHistogramPercentile(0.99), get_low_fps(0.01), get_low_fps(0.001), m_total_spikes);
+  for (const Spike& spike : m_worst_spikes)
+  {
+    NOTICE_LOG(VIDEO,
+               "  Frame %" PRIu64 ": %.1f ms (median %.1f ms), %u shaders compiled, "
+               "%u textures loaded, %u DVD reads",
+               spike.frame, spike.frame_time_ms, spike.median_ms, spike.shaders_compiled,
+               spike.textures_loaded, spike.dvd_reads);
+  }
 }
 
 void FPSCounter::LogRenderTimeToFile(u64 val)
@@ -33,6 +77,8 @@ void FPSCounter::Update()
   if (g_ActiveConfig.bLogRenderTimeToFile)
     LogRenderTimeToFile(diff);
 
+  AddFrameTime(diff / 1000.0f);
+
   m_frame_counter++;
   m_time_since_update += diff;
   m_last_time = time;
@@ -42,5 +88,122 @@ void FPSCounter::Update()
     m_fps = m_frame_counter / (m_time_since_update / 1000000.0);
     m_frame_counter = 0;
     m_time_since_update = 0;
+    UpdateFrameTimeStats();
+  }
+}
+
+void FPSCounter::AddFrameTime(float frame_time_ms)
+{
+  const int shaders_created = stats.GetShadersCreated();
+  const u32 shaders_compiled = static_cast<u32>(shaders_created - m_last_shaders_created);
+  const u32 dvd_reads = DVDThread::TakeReadCount();
+  m_last_shaders_created = shaders_created;
+
+  // The first frame also counts the time spent booting.
+  if (!m_had_first_frame)
+  {
+    m_had_first_frame = true;
+    return;
+  }
+
+  const size_t bucket = std::min(static_cast<size_t>(frame_time_ms * 10), HISTOGRAM_BUCKETS - 1);
+  m_histogram[bucket]++;
+  m_total_frames++;
+
+  // A spike takes twice as long as the median frame, and at least 4 ms more.
+  const float median_ms = m_stats.p50_ms;
+  if (m_frame_time_count >= MIN_FRAMES_FOR_SPIKES && frame_time_ms > median_ms * 2 &&
+      frame_time_ms > median_ms + 4)
+  {
+    m_last_spike.frame = m_total_frames;
+    m_last_spike.frame_time_ms = frame_time_ms;
+    m_last_spike.median_ms = median_ms;
+    m_last_spike.shaders_compiled = shaders_compiled;
+    m_last_spike.textures_loaded = static_cast<u32>(stats.thisFrame.numTextureUploads);
+    m_last_spike.dvd_reads = dvd_reads;
+    m_total_spikes++;
+
+    auto iter = std::find_if(m_worst_spikes.begin(), m_worst_spikes.end(),
+                             [frame_time_ms](const Spike& spike) {
+                               return spike.frame_time_ms < frame_time_ms;
+                             });
+    if (iter != m_worst_spikes.end() || m_worst_spikes.size() < MAX_LOGGED_SPIKES)
+    {
+      m_worst_spikes.insert(iter, m_last_spike);
+      if (m_worst_spikes.size() > MAX_LOGGED_SPIKES)
+        m_worst_spikes.pop_back();
+    }
+  }
+
+  DolphinAnalytics::PerformanceSample sample;
+  sample.frame_time_ms = frame_time_ms;
+  sample.shader_stall_ms = 0;
+  if (shaders_compiled && m_frame_time_count >= MIN_FRAMES_FOR_SPIKES)
+    sample.shader_stall_ms = std::max(frame_time_ms - median_ms, 0.0f);
+  sample.shaders_compiled = shaders_compiled;
+  sample.texture_cache_hits = static_cast<u32>(stats.thisFrame.numTextureCacheHits);
+  sample.texture_cache_misses = static_cast<u32>(stats.thisFrame.numTextureCacheMisses);
+  sample.texture_uploads = static_cast<u32>(stats.thisFrame.numTextureUploads);
+  DolphinAnalytics::Instance()->ReportPerformanceInfo(sample);
+
+  m_frame_times[m_frame_time_pos] = frame_time_ms;
+  m_frame_time_pos = (m_frame_time_pos + 1) % FRAME_TIME_WINDOW;
+  if (m_frame_time_count < FRAME_TIME_WINDOW)
+    m_frame_time_count++;
+}
+
+void FPSCounter::UpdateFrameTimeStats()
+{
+  if (!m_frame_time_count)
+    return;
+
+  std::vector<float> sorted(m_frame_times.begin(), m_frame_times.begin() + m_frame_time_count);
+  std::sort(sorted.begin(), sorted.end());
+
+  const size_t count = sorted.size();
+  auto percentile = [&](double p) {
+    return sorted[std::min(count - 1, static_cast<size_t>(count * p))];
+  };
+  auto low_fps = [&](size_t divisor) {
+    const size_t slowest = std::max<size_t>(1, count / divisor);
+    double total_ms = 0;
+    for (size_t i = count - slowest; i < count; i++)
+      total_ms += sorted[i];
+    return total_ms > 0 ? static_cast<float>(1000.0 * slowest / total_ms) : 0.0f;
+  };
+
+  m_stats.p50_ms = percentile(0.5);
+  m_stats.p95_ms = percentile(0.95);
+  m_stats.p99_ms = percentile(0.99);
+  m_stats.low_1_fps = low_fps(100);
+  m_stats.low_01_fps = low_fps(1000);
+}
+
+float FPSCounter::GetHistogramPercentile(double percentile) const
+{
+  const u64 wanted = static_cast<u64>(m_total_frames * percentile);
+  u64 count = 0;
+  for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+  {
+    count += m_histogram[i];
+    if (count > wanted)
+      return (i + 0.5f) / 10.0f;
+  }
+  return HISTOGRAM_BUCKETS / 10.0f;
+}
+
+std::string FPSCounter::GetFrameTimeStatsString() const
+{
+  std::string str = StringFromFormat(
+      "Frame time p50/p95/p99: %.1f/%.1f/%.1f ms, 1%% low: %.1f fps, 0.1%% low: %.1f fps",
+      m_stats.p50_ms, m_stats.p95_ms, m_stats.p99_ms, m_stats.low_1_fps, m_stats.low_01_fps);
+  if (m_last_spike.frame)
+  {
+    str += StringFromFormat("\nLast spike: %.1f ms, %" PRIu64
+                            " frames ago (%u shaders, %u textures, %u DVD reads)",
+                            m_last_spike.frame_time_ms, m_total_frames - m_last_spike.frame,
+                            m_last_spike.shaders_compiled, m_last_spike.textures_loaded,
+                            m_last_spike.dvd_reads);
   }
+  return str;
 }
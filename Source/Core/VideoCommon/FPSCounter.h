@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <array>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
@@ -13,17 +16,66 @@ class FPSCounter
 public:
   // Initializes the FPS counter.
   FPSCounter();
+  // Writes the frame time statistics of the session to the log.
+  ~FPSCounter();
 
   // Called when a frame is rendered (updated every second).
   void Update();
 
   float GetFPS() const { return m_fps; }
+  // Lows, percentiles and the last spike of the recent frames, for the OSD.
+  std::string GetFrameTimeStatsString() const;
+
 private:
+  // A frame that took much longer than the ones around it, with what it spent the time on.
+  struct Spike
+  {
+    u64 frame;
+    float frame_time_ms;
+    float median_ms;
+    u32 shaders_compiled;
+    u32 textures_loaded;
+    u32 dvd_reads;
+  };
+
+  struct FrameTimeStats
+  {
+    float p50_ms = 0;
+    float p95_ms = 0;
+    float p99_ms = 0;
+    // Average FPS of the slowest 1% / 0.1% of the frames.
+    float low_1_fps = 0;
+    float low_01_fps = 0;
+  };
+
+  // About a minute of frames at 60 fps.
+  static constexpr size_t FRAME_TIME_WINDOW = 3600;
+  // The session histogram has 0.1 ms steps, the last bucket takes everything slower.
+  static constexpr size_t HISTOGRAM_BUCKETS = 2000;
+  static constexpr size_t MAX_LOGGED_SPIKES = 16;
+
   u64 m_last_time = 0;
   u64 m_time_since_update = 0;
   u32 m_frame_counter = 0;
   float m_fps = 0;
   std::ofstream m_bench_file;
 
+  std::array<float, FRAME_TIME_WINDOW> m_frame_times{};
+  size_t m_frame_time_count = 0;
+  size_t m_frame_time_pos = 0;
+  FrameTimeStats m_stats;
+
+  std::array<u32, HISTOGRAM_BUCKETS> m_histogram{};
+  u64 m_total_frames = 0;
+  u64 m_total_spikes = 0;
+  // The slowest spikes of the session.
+  std::vector<Spike> m_worst_spikes;
+  Spike m_last_spike{};
+  int m_last_shaders_created = 0;
+  bool m_had_first_frame = false;
+
   void LogRenderTimeToFile(u64 val);
+  void AddFrameTime(float frame_time_ms);
+  void UpdateFrameTimeStats();
+  float GetHistogramPercentile(double percentile) const;
 };
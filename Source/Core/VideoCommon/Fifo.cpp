@@ -11,8 +11,11 @@
 #include "Common/ChunkFile.h"
 #include "Common/Event.h"
 #include "Common/FPURoundMode.h"
+#include "Common/Flag.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/Timer.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
@@ -55,9 +58,13 @@ static CoreTiming::EventType* s_event_sync_gpu;
 // STATE_TO_SAVE
 static u8* s_video_buffer;
 static u8* s_video_buffer_read_ptr;
-static std::atomic<u8*> s_video_buffer_write_ptr;
-static std::atomic<u8*> s_video_buffer_seen_ptr;
-static u8* s_video_buffer_pp_read_ptr;
+// Written by different threads, so they get their own cache lines.
+alignas(64) static std::atomic<u8*> s_video_buffer_write_ptr;
+alignas(64) static std::atomic<u8*> s_video_buffer_seen_ptr;
+alignas(64) static u8* s_video_buffer_pp_read_ptr;
+// Deterministic mode only: the end of the data copied from the FIFO by the CPU thread. The data
+// past the write_ptr isn't preprocessed yet, so it isn't visible to the GPU thread either.
+static u8* s_video_buffer_copy_ptr;
 // The read_ptr is always owned by the GPU thread.  In normal mode, so is the
 // write_ptr, despite it being atomic.  In deterministic GPU thread mode,
 // things get a bit more complicated:
@@ -70,12 +77,33 @@ static u8* s_video_buffer_pp_read_ptr;
 // polls, it's just atomic.
 // - The pp_read_ptr is the CPU preprocessing version of the read_ptr.
 
-static std::atomic<int> s_sync_ticks;
+// Dual core only, owned by the GPU thread. While reading directly, the decoder runs on the FIFO
+// in emulated RAM and s_video_buffer stays empty. The data from s_direct_read_ptr up to
+// s_direct_read_end is a command the decoder needs more chunks for. It is copied to
+// s_video_buffer, going back to the copying path, when the next chunk doesn't follow it in RAM or
+// it grows large enough that the CPU could wrap around the FIFO and overwrite it.
+static bool s_direct_read;
+static u32 s_direct_read_ptr;
+static u32 s_direct_read_end;
+static constexpr u32 DIRECT_READ_MAX_PENDING = 4096;
+
+alignas(64) static std::atomic<int> s_sync_ticks;
 static bool s_syncing_suspended;
 static Common::Event s_sync_wakeup_event;
+// Set when RunGpuBatched() didn't wake the GPU thread for data it has pending.
+static Common::Flag s_gpu_wakeup_pending;
+
+static std::atomic<int> s_sync_counts[NUM_SYNC_GPU_REASONS];
+static std::atomic<int> s_sync_wait_us[NUM_SYNC_GPU_REASONS];
+static std::atomic<int> s_deferred_sync_count;
+// Swap syncs skipped in a row, only touched by the CPU thread.
+static int s_deferred_swap_syncs;
+
+static void StopDirectRead();
 
 void DoState(PointerWrap& p)
 {
+  StopDirectRead();
   p.DoArray(s_video_buffer, FIFO_SIZE);
   u8* write_ptr = s_video_buffer_write_ptr;
   p.DoPointer(write_ptr, s_video_buffer);
@@ -85,6 +113,7 @@ void DoState(PointerWrap& p)
   {
     // We're good and paused, right?
     s_video_buffer_seen_ptr = s_video_buffer_pp_read_ptr = s_video_buffer_read_ptr;
+    s_video_buffer_copy_ptr = write_ptr;
   }
 
   p.Do(s_sync_ticks);
@@ -102,6 +131,8 @@ void PauseAndLock(bool doLock, bool unpauseOnUnlock)
     if (!param.bCPUThread || s_use_deterministic_gpu_thread)
       return;
 
+    if (s_gpu_wakeup_pending.TestAndClear())
+      s_gpu_mainloop.Wakeup();
     s_gpu_mainloop.WaitYield(std::chrono::milliseconds(100), Host_YieldToUI);
   }
   else
@@ -130,10 +161,12 @@ void Shutdown()
   s_video_buffer = nullptr;
   s_video_buffer_write_ptr = nullptr;
   s_video_buffer_pp_read_ptr = nullptr;
+  s_video_buffer_copy_ptr = nullptr;
   s_video_buffer_read_ptr = nullptr;
   s_video_buffer_seen_ptr = nullptr;
   s_fifo_aux_write_ptr = nullptr;
   s_fifo_aux_read_ptr = nullptr;
+  s_direct_read = false;
 }
 
 // May be executed from any thread, even the graphics thread.
@@ -160,9 +193,25 @@ void EmulatorState(bool running)
 
 void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
 {
+  const int reason_index = static_cast<int>(reason);
+  s_sync_counts[reason_index]++;
   if (s_use_deterministic_gpu_thread)
   {
+    // Nothing is read back at a swap, it only keeps the GPU thread from falling behind. Every
+    // other reason either reads GPU results or needs the buffers drained, so only swaps are
+    // deferred. A full buffer still syncs through Wraparound and AuxSpace.
+    if (reason == SyncGPUReason::Swap && !s_gpu_mainloop.IsDone() &&
+        s_deferred_swap_syncs < SConfig::GetInstance().iGpuSyncMaxDeferredFields)
+    {
+      s_deferred_swap_syncs++;
+      s_deferred_sync_count++;
+      return;
+    }
+    s_deferred_swap_syncs = 0;
+
+    const u64 wait_start = Common::Timer::GetTimeUs();
     s_gpu_mainloop.Wait();
+    s_sync_wait_us[reason_index] += static_cast<int>(Common::Timer::GetTimeUs() - wait_start);
     if (!s_gpu_mainloop.IsRunning())
       return;
 
@@ -186,6 +235,7 @@ void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
       // after write_ptr here, and read it before in RunGpuLoop, so
       // 'write_ptr > seen_ptr' there cannot become spuriously true.
       s_video_buffer_write_ptr = write_ptr = s_video_buffer + size;
+      s_video_buffer_copy_ptr = write_ptr;
       s_video_buffer_pp_read_ptr = s_video_buffer;
       s_video_buffer_read_ptr = s_video_buffer;
       s_video_buffer_seen_ptr = write_ptr;
@@ -193,6 +243,24 @@ void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
   }
 }
 
+const char* GetSyncGPUReasonName(int reason)
+{
+  static const char* const names[NUM_SYNC_GPU_REASONS] = {
+    "Other", "Wraparound", "EFB poke", "Perf query", "BBox", "Swap", "Aux space",
+  };
+  return names[reason];
+}
+
+void TakeSyncCounts(int* syncs, int* wait_us, int* deferred)
+{
+  for (int i = 0; i < NUM_SYNC_GPU_REASONS; i++)
+  {
+    syncs[i] = s_sync_counts[i].exchange(0);
+    wait_us[i] = s_sync_wait_us[i].exchange(0);
+  }
+  *deferred = s_deferred_sync_count.exchange(0);
+}
+
 void PushFifoAuxBuffer(const void* ptr, size_t size)
 {
   if (size > (size_t)(s_fifo_aux_data + FIFO_SIZE - s_fifo_aux_write_ptr))
@@ -243,15 +311,102 @@ static void ReadDataFromFifo(u32 readPtr)
   s_video_buffer_write_ptr += len;
 }
 
-// The deterministic_gpu_thread version.
+static bool CanReadDirect()
+{
+  // The vertex loader may read a few bytes past the end of the data. The MEM1 mapping is padded to
+  // RAM_SIZE, MEM2 ends right after the last byte.
+  return SConfig::GetInstance().bGpuFifoDirectRead &&
+         (CommandProcessor::fifo.CPEnd & 0x3FFFFFFF) < Memory::REALRAM_SIZE;
+}
+
+static void StopDirectRead()
+{
+  if (!s_direct_read)
+    return;
+  s_direct_read = false;
+  const u32 pending = s_direct_read_end - s_direct_read_ptr;
+  Memory::CopyFromEmu(s_video_buffer, s_direct_read_ptr, pending);
+  s_video_buffer_read_ptr = s_video_buffer;
+  s_video_buffer_write_ptr = s_video_buffer + pending;
+}
+
+// Points g_VideoData at the data left over from earlier chunks followed by the chunk at readPtr.
+static void ReadFifoChunk(u32 readPtr)
+{
+  if (s_direct_read && (readPtr != s_direct_read_end ||
+                        s_direct_read_end - s_direct_read_ptr + 32 > DIRECT_READ_MAX_PENDING))
+  {
+    StopDirectRead();
+  }
+
+  if (s_direct_read)
+  {
+    s_direct_read_end = readPtr + 32;
+    u8* start = Memory::GetPointer(s_direct_read_ptr);
+    g_VideoData.SetReadPosition(start, start + (s_direct_read_end - s_direct_read_ptr));
+    return;
+  }
+
+  ReadDataFromFifo(readPtr);
+  g_VideoData.SetReadPosition(s_video_buffer_read_ptr, s_video_buffer_write_ptr);
+}
+
+// Takes where the decoder stopped in the chunk read by ReadFifoChunk. Returns whether it used up
+// all the data.
+static bool FinishFifoChunk(u32 readPtr, u32 next_read_ptr, u8* decoded_ptr)
+{
+  if (s_direct_read)
+  {
+    s_direct_read_ptr += static_cast<u32>(decoded_ptr - Memory::GetPointer(s_direct_read_ptr));
+    if (s_direct_read_ptr == s_direct_read_end)
+    {
+      s_direct_read_ptr = s_direct_read_end = next_read_ptr;
+      return true;
+    }
+    if (next_read_ptr != s_direct_read_end)
+      StopDirectRead();
+    return false;
+  }
+
+  s_video_buffer_read_ptr = decoded_ptr;
+  const u32 pending = static_cast<u32>(s_video_buffer_write_ptr - s_video_buffer_read_ptr);
+  // Once the leftover data lies within the chunk just read, the decoder can pick it up from RAM.
+  if (pending <= 32 && next_read_ptr == readPtr + 32 && CanReadDirect())
+  {
+    s_direct_read = true;
+    s_direct_read_end = next_read_ptr;
+    s_direct_read_ptr = next_read_ptr - pending;
+    s_video_buffer_read_ptr = s_video_buffer;
+    s_video_buffer_write_ptr = s_video_buffer;
+  }
+  return pending == 0;
+}
+
+// Preprocesses the data copied by ReadDataFromFifoOnCPU and hands it to the GPU thread.
+static void PreprocessDataFromFifoOnCPU()
+{
+  u8* copy_ptr = s_video_buffer_copy_ptr;
+  if (copy_ptr == s_video_buffer_write_ptr)
+    return;
+  DataReader fifo_reader(s_video_buffer_pp_read_ptr, copy_ptr);
+  s_video_buffer_pp_read_ptr = OpcodeDecoder::Run<true>(fifo_reader, nullptr);
+  // This would have to be locked if the GPU thread didn't spin.
+  s_video_buffer_write_ptr = copy_ptr;
+  s_gpu_mainloop.Wakeup();
+}
+
+// The deterministic_gpu_thread version. The preprocessor runs once for all the data copied in a
+// row instead of restarting on every 32 byte chunk, commands spanning many chunks were parsed
+// over and over again.
 static void ReadDataFromFifoOnCPU(u32 readPtr)
 {
   size_t len = 32;
-  u8* write_ptr = s_video_buffer_write_ptr;
+  u8* write_ptr = s_video_buffer_copy_ptr;
   if (len > (size_t)(s_video_buffer + FIFO_SIZE - write_ptr))
   {
     // We can't wrap around while the GPU is working on the data.
     // This should be very rare due to the reset in SyncGPU.
+    PreprocessDataFromFifoOnCPU();
     SyncGPU(SyncGPUReason::Wraparound);
     if (!s_gpu_mainloop.IsRunning())
     {
@@ -272,11 +427,8 @@ static void ReadDataFromFifoOnCPU(u32 readPtr)
       return;
     }
   }
-  Memory::CopyFromEmu(s_video_buffer_write_ptr, readPtr, len);
-  DataReader fifo_reader(s_video_buffer_pp_read_ptr, write_ptr + len);
-  s_video_buffer_pp_read_ptr = OpcodeDecoder::Run<true>(fifo_reader, nullptr);
-  // This would have to be locked if the GPU thread didn't spin.
-  s_video_buffer_write_ptr = write_ptr + len;
+  Memory::CopyFromEmu(write_ptr, readPtr, len);
+  s_video_buffer_copy_ptr = write_ptr + len;
 }
 
 void ResetVideoBuffer()
@@ -285,8 +437,10 @@ void ResetVideoBuffer()
   s_video_buffer_write_ptr = s_video_buffer;
   s_video_buffer_seen_ptr = s_video_buffer;
   s_video_buffer_pp_read_ptr = s_video_buffer;
+  s_video_buffer_copy_ptr = s_video_buffer;
   s_fifo_aux_write_ptr = s_fifo_aux_data;
   s_fifo_aux_read_ptr = s_fifo_aux_data;
+  s_direct_read = false;
 }
 
 // Description: Main FIFO update loop
@@ -306,6 +460,8 @@ void RunGpuLoop()
     if (!s_emu_running_state.IsSet())
       return;
 
+    TRACE_SCOPE("Fifo::RunGpuLoop");
+
     if (s_use_deterministic_gpu_thread)
     {
       AsyncRequests::GetInstance()->PullEvents();
@@ -337,8 +493,10 @@ void RunGpuLoop()
           break;
 
         u32 cyclesExecuted = 0;
-        u32 readPtr = fifo.CPReadPointer;
-        ReadDataFromFifo(readPtr);
+        const u32 chunk_ptr = fifo.CPReadPointer;
+        ReadFifoChunk(chunk_ptr);
+
+        u32 readPtr = chunk_ptr;
 
         if (readPtr == fifo.CPEnd)
           readPtr = fifo.CPBase;
@@ -350,13 +508,12 @@ void RunGpuLoop()
           "instability in the game. Please report it.",
           fifo.CPReadWriteDistance - 32);
 
-        u8* write_ptr = s_video_buffer_write_ptr;
-        g_VideoData.SetReadPosition(s_video_buffer_read_ptr, write_ptr);
-        s_video_buffer_read_ptr = OpcodeDecoder::Run(g_VideoData, &cyclesExecuted);
+        u8* decoded_ptr = OpcodeDecoder::Run(g_VideoData, &cyclesExecuted);
+        const bool drained = FinishFifoChunk(chunk_ptr, readPtr, decoded_ptr);
 
         Common::AtomicStore(fifo.CPReadPointer, readPtr);
         Common::AtomicAdd(fifo.CPReadWriteDistance, -32);
-        if ((write_ptr - s_video_buffer_read_ptr) == 0)
+        if (drained)
           Common::AtomicStore(fifo.SafeCPReadPointer, fifo.CPReadPointer);
 
         CommandProcessor::SetCPStatusFromGPU();
@@ -403,6 +560,8 @@ void FlushGpu()
   if (!param.bCPUThread || s_use_deterministic_gpu_thread)
     return;
 
+  if (s_gpu_wakeup_pending.TestAndClear())
+    s_gpu_mainloop.Wakeup();
   s_gpu_mainloop.Wait();
 }
 
@@ -424,6 +583,7 @@ void RunGpu()
   // wake up GPU thread
   if (param.bCPUThread && !s_use_deterministic_gpu_thread)
   {
+    s_gpu_wakeup_pending.Clear();
     s_gpu_mainloop.Wakeup();
   }
 
@@ -439,6 +599,34 @@ void RunGpu()
   }
 }
 
+void RunGpuBatched()
+{
+  const SConfig& param = SConfig::GetInstance();
+
+  // A running GPU thread picks the data up by itself, waking a sleeping one costs a syscall.
+  // So let it sleep until enough data is pending, the next VI field wakes it at the latest.
+  if (param.bCPUThread && !s_use_deterministic_gpu_thread && !param.bSyncGPU &&
+      param.iGpuWakeupThreshold > 0 && s_gpu_mainloop.IsSleeping() &&
+      CommandProcessor::fifo.CPReadWriteDistance < static_cast<u32>(param.iGpuWakeupThreshold))
+  {
+    s_gpu_wakeup_pending.Set();
+    return;
+  }
+  RunGpu();
+}
+
+void RunBatchedGpuWakeup()
+{
+  if (s_gpu_wakeup_pending.IsSet())
+    RunGpu();
+}
+
+void TakeWakeupCounts(int* wakeups, int* sleeps)
+{
+  *wakeups = s_gpu_mainloop.TakeWakeupCount();
+  *sleeps = s_gpu_mainloop.TakeSleepCount();
+}
+
 static int RunGpuOnCpu(int ticks)
 {
   SCPFifoStruct& fifo = CommandProcessor::fifo;
@@ -450,7 +638,6 @@ static int RunGpuOnCpu(int ticks)
     if (s_use_deterministic_gpu_thread)
     {
       ReadDataFromFifoOnCPU(fifo.CPReadPointer);
-      s_gpu_mainloop.Wakeup();
     }
     else
     {
@@ -475,6 +662,9 @@ static int RunGpuOnCpu(int ticks)
     fifo.CPReadWriteDistance -= 32;
   }
 
+  if (s_use_deterministic_gpu_thread)
+    PreprocessDataFromFifoOnCPU();
+
   CommandProcessor::SetCPStatusFromGPU();
 
   if (reset_simd_state)
@@ -516,11 +706,13 @@ void UpdateWantDeterminism(bool want)
 
   if (s_use_deterministic_gpu_thread != gpu_thread)
   {
+    StopDirectRead();
     s_use_deterministic_gpu_thread = gpu_thread;
     if (gpu_thread)
     {
       // These haven't been updated in non-deterministic mode.
       s_video_buffer_seen_ptr = s_video_buffer_pp_read_ptr = s_video_buffer_read_ptr;
+      s_video_buffer_copy_ptr = s_video_buffer_write_ptr;
       CopyPreprocessCPStateFromMain();
       VertexLoaderManager::MarkAllDirty();
     }
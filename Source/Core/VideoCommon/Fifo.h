@@ -32,15 +32,28 @@ enum class SyncGPUReason
   Swap,
   AuxSpace,
 };
+constexpr int NUM_SYNC_GPU_REASONS = 7;
 
 // In deterministic GPU thread mode this waits for the GPU to be done with pending work.
+// Swap syncs may be deferred while the GPU thread is busy, see SConfig::iGpuSyncMaxDeferredFields.
 void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr = true);
+const char* GetSyncGPUReasonName(int reason);
+// SyncGPU calls and the microseconds spent waiting per reason, and the deferred swap syncs since
+// the last call, for the statistics.
+void TakeSyncCounts(int* syncs, int* wait_us, int* deferred);
 
 void PushFifoAuxBuffer(const void* ptr, size_t size);
 void* PopFifoAuxBuffer(size_t size);
 
 void FlushGpu();
 void RunGpu();
+// Like RunGpu(), but a sleeping GPU thread is only woken once SConfig::iGpuWakeupThreshold bytes
+// are pending. Used for gather pipe bursts.
+void RunGpuBatched();
+// Wakes the GPU thread if RunGpuBatched() held back a wakeup, called at every VI field.
+void RunBatchedGpuWakeup();
+// GPU thread wakeups and sleeps since the last call, for the statistics.
+void TakeWakeupCounts(int* wakeups, int* sleeps);
 void GpuMaySleep();
 void RunGpuLoop();
 void ExitGpuLoop();
@@ -0,0 +1,201 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <fstream>
+
+#include "Common/CommonFuncs.h"
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/FrameArena.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+
+#include "Core/ConfigManager.h"
+
+#include "VideoCommon/FrameTelemetry.h"
+#include "VideoCommon/OnScreenDisplay.h"
+#include "VideoCommon/Statistics.h"
+
+namespace FrameTelemetry
+{
+namespace
+{
+// Only the video thread writes. Readers copy the ring and then drop the entries that were
+// overwritten while they were copying, so neither side ever waits.
+std::array<Frame, MAX_FRAMES> s_frames;
+std::atomic<u64> s_frame_count{0};
+std::atomic<u32> s_jit_block_compiles{0};
+std::atomic<u32> s_jit_fast_map_misses{0};
+
+std::chrono::steady_clock::time_point s_last_frame_time;
+int s_last_shaders_created = 0;
+u64 s_last_video_thread_allocations = 0;
+
+void WriteCSV(std::ostream& file, const std::vector<Frame>& frames)
+{
+  file << "frame,cpu_frame_time_ms,gpu_frame_time_ms,draw_calls,shader_cache_misses,"
+          "texture_cache_hits,texture_cache_misses,texture_uploads,efb_copies,"
+          "efb_copies_skipped,fifo_bytes,jit_block_compiles,jit_fast_map_misses,"
+          "video_thread_allocations,frame_arena_bytes\n";
+  for (const Frame& frame : frames)
+  {
+    file << StringFromFormat("%" PRIu64 ",%.3f,", frame.frame_number, frame.cpu_frame_time_ms);
+    if (frame.gpu_frame_time_ms >= 0.0f)
+      file << StringFromFormat("%.3f", frame.gpu_frame_time_ms);
+    file << StringFromFormat(",%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,", frame.draw_calls,
+                             frame.shader_cache_misses, frame.texture_cache_hits,
+                             frame.texture_cache_misses, frame.texture_uploads, frame.efb_copies,
+                             frame.efb_copies_skipped, frame.fifo_bytes, frame.jit_block_compiles,
+                             frame.jit_fast_map_misses);
+    if (Common::HEAP_ALLOCATION_COUNTING)
+      file << frame.video_thread_allocations;
+    file << StringFromFormat(",%u\n", frame.frame_arena_bytes);
+  }
+}
+
+void WriteJSON(std::ostream& file, const std::vector<Frame>& frames)
+{
+  file << "{\"game_id\":\"" << SConfig::GetInstance().GetGameID() << "\",\"frames\":[";
+  for (size_t i = 0; i < frames.size(); i++)
+  {
+    const Frame& frame = frames[i];
+    file << (i ? ",\n" : "\n");
+    file << StringFromFormat("{\"frame\":%" PRIu64 ",\"cpu_frame_time_ms\":%.3f,",
+                             frame.frame_number, frame.cpu_frame_time_ms);
+    if (frame.gpu_frame_time_ms >= 0.0f)
+      file << StringFromFormat("\"gpu_frame_time_ms\":%.3f,", frame.gpu_frame_time_ms);
+    else
+      file << "\"gpu_frame_time_ms\":null,";
+    file << StringFromFormat("\"draw_calls\":%u,\"shader_cache_misses\":%u,"
+                             "\"texture_cache_hits\":%u,\"texture_cache_misses\":%u,"
+                             "\"texture_uploads\":%u,\"efb_copies\":%u,"
+                             "\"efb_copies_skipped\":%u,\"fifo_bytes\":%u,"
+                             "\"jit_block_compiles\":%u,\"jit_fast_map_misses\":%u,",
+                             frame.draw_calls, frame.shader_cache_misses, frame.texture_cache_hits,
+                             frame.texture_cache_misses, frame.texture_uploads, frame.efb_copies,
+                             frame.efb_copies_skipped, frame.fifo_bytes, frame.jit_block_compiles,
+                             frame.jit_fast_map_misses);
+    if (Common::HEAP_ALLOCATION_COUNTING)
+      file << StringFromFormat("\"video_thread_allocations\":%u,", frame.video_thread_allocations);
+    else
+      file << "\"video_thread_allocations\":null,";
+    file << StringFromFormat("\"frame_arena_bytes\":%u}", frame.frame_arena_bytes);
+  }
+  file << "\n]}\n";
+}
+}  // Anonymous namespace
+
+void AddJitBlockCompile()
+{
+  s_jit_block_compiles.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AddJitFastBlockMapMiss()
+{
+  s_jit_fast_map_misses.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RecordFrame(float gpu_frame_time_ms)
+{
+  const auto now = std::chrono::steady_clock::now();
+  const u64 count = s_frame_count.load(std::memory_order_relaxed);
+  const int shaders_created = stats.GetShadersCreated();
+
+  Frame& frame = s_frames[count % MAX_FRAMES];
+  frame.frame_number = count;
+  frame.cpu_frame_time_ms =
+      count ? std::chrono::duration<float, std::milli>(now - s_last_frame_time).count() : 0.0f;
+  frame.gpu_frame_time_ms = gpu_frame_time_ms;
+  frame.draw_calls = stats.thisFrame.numDrawCalls;
+  frame.shader_cache_misses =
+      count ? static_cast<u32>(shaders_created - s_last_shaders_created) : 0;
+  frame.texture_cache_hits = stats.thisFrame.numTextureCacheHits;
+  frame.texture_cache_misses = stats.thisFrame.numTextureCacheMisses;
+  frame.texture_uploads = stats.thisFrame.numTextureUploads;
+  frame.efb_copies = stats.thisFrame.numEFBCopies;
+  frame.efb_copies_skipped = stats.thisFrame.numEFBCopiesSkipped;
+  frame.fifo_bytes = stats.thisFrame.bytesFifo;
+  frame.jit_block_compiles = s_jit_block_compiles.exchange(0, std::memory_order_relaxed);
+  frame.jit_fast_map_misses = s_jit_fast_map_misses.exchange(0, std::memory_order_relaxed);
+  const u64 video_thread_allocations = Common::GetThreadHeapAllocationCount();
+  frame.video_thread_allocations =
+      static_cast<u32>(video_thread_allocations - s_last_video_thread_allocations);
+  frame.frame_arena_bytes = static_cast<u32>(Common::FrameArena::GetUsedBytes());
+
+  s_last_frame_time = now;
+  s_last_video_thread_allocations = video_thread_allocations;
+  s_last_shaders_created = shaders_created;
+  s_frame_count.store(count + 1, std::memory_order_release);
+}
+
+std::vector<Frame> GetFrames()
+{
+  const u64 end = s_frame_count.load(std::memory_order_acquire);
+  const u64 begin = end > MAX_FRAMES ? end - MAX_FRAMES : 0;
+
+  std::vector<Frame> frames;
+  frames.reserve(static_cast<size_t>(end - begin));
+  for (u64 i = begin; i < end; i++)
+    frames.push_back(s_frames[i % MAX_FRAMES]);
+
+  // Anything the video thread got to while we were copying is garbage, including the entry it
+  // may be writing right now.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const u64 first_valid = s_frame_count.load(std::memory_order_relaxed) + 1;
+  if (first_valid > begin + MAX_FRAMES)
+  {
+    const size_t drop =
+        static_cast<size_t>(std::min<u64>(first_valid - MAX_FRAMES - begin, frames.size()));
+    frames.erase(frames.begin(), frames.begin() + drop);
+  }
+  return frames;
+}
+
+bool Export(const std::string& filename)
+{
+  const std::vector<Frame> frames = GetFrames();
+  std::ofstream file;
+  File::OpenFStream(file, filename, std::ios_base::out);
+  if (!file.is_open())
+    return false;
+
+  std::string extension;
+  SplitPath(filename, nullptr, nullptr, &extension);
+  if (!strcasecmp(extension.c_str(), ".json"))
+    WriteJSON(file, frames);
+  else
+    WriteCSV(file, frames);
+  return file.good();
+}
+
+void ExportCSV(std::ostream& stream)
+{
+  WriteCSV(stream, GetFrames());
+}
+
+void ExportToDumpFolder()
+{
+  const std::string path = File::GetUserPath(D_DUMP_IDX) + FRAME_TELEMETRY_DIR DIR_SEP +
+                           SConfig::GetInstance().GetGameID();
+  File::CreateFullPath(path);
+
+  std::string name;
+  for (int i = 1; File::Exists((name = StringFromFormat("%s-%d", path.c_str(), i)) + ".csv"); ++i)
+  {
+  }
+
+  if (!Export(name + ".csv") || !Export(name + ".json"))
+  {
+    ERROR_LOG(VIDEO, "Failed to export frame telemetry to %s", name.c_str());
+    OSD::AddMessage("Failed to export frame telemetry");
+    return;
+  }
+  OSD::AddMessage("Frame telemetry saved to " + name + ".csv");
+}
+}  // namespace FrameTelemetry
@@ -0,0 +1,58 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Per frame counters, kept for the last few minutes so stutter can be matched to what the game
+// was doing. The video thread records one entry per swap into a ring without taking locks, the
+// ring can be exported from any thread.
+namespace FrameTelemetry
+{
+struct Frame
+{
+  u64 frame_number;
+  float cpu_frame_time_ms;
+  // Negative when the backend doesn't measure GPU time.
+  float gpu_frame_time_ms;
+  u32 draw_calls;
+  u32 shader_cache_misses;
+  u32 texture_cache_hits;
+  u32 texture_cache_misses;
+  u32 texture_uploads;
+  u32 efb_copies;
+  u32 efb_copies_skipped;
+  u32 fifo_bytes;
+  u32 jit_block_compiles;
+  // Dispatches of compiled blocks that weren't in the JIT's fast block map.
+  u32 jit_fast_map_misses;
+  // Heap allocations of the video thread, only counted in builds with ENABLE_ALLOCATION_COUNTING.
+  u32 video_thread_allocations;
+  u32 frame_arena_bytes;
+};
+
+// Five minutes at 60 fps.
+constexpr size_t MAX_FRAMES = 18000;
+
+// Called by the JIT, from the CPU thread.
+void AddJitBlockCompile();
+void AddJitFastBlockMapMiss();
+
+// Called by the renderer once per swap, before the frame statistics are reset.
+void RecordFrame(float gpu_frame_time_ms);
+
+// Returns the recorded frames, oldest first.
+std::vector<Frame> GetFrames();
+
+// The format is picked from the extension, .json or CSV otherwise.
+bool Export(const std::string& filename);
+void ExportCSV(std::ostream& stream);
+// Writes a CSV and a JSON file to Dump/Telemetry, named after the game and the current time.
+void ExportToDumpFolder();
+}  // namespace FrameTelemetry
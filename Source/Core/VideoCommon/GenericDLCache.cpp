@@ -1,52 +1,263 @@
-// Copyright (C) 2003-2009 Dolphin Project.
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
 
-// This program is free software: you can redistribute it and/or modify
-// it under the terms of the GNU General Public License as published by
-// the Free Software Foundation, version 2.0.
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include <xxhash.h>
 
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License 2.0 for more details.
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BoundingBox.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DLCache.h"
+#include "VideoCommon/RenderBase.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VideoConfig.h"
 
-// A copy of the GPL 2.0 should have been included with the program.
-// If not, see http://www.gnu.org/licenses/
+namespace DLCache
+{
+namespace
+{
+// Lists that have not been called for this many frames are dropped.
+constexpr int MAX_UNUSED_FRAMES = 120;
+// Upper bound for the converted vertex data kept around.
+constexpr size_t MAX_CACHED_BYTES = 64 * 1024 * 1024;
+// Lists smaller than this hold at most a handful of vertices, hashing them is not worth it.
+constexpr u32 MIN_LIST_SIZE = 64;
 
-// Official SVN repository and contact information can be found at
-// http://code.google.com/p/dolphin-emu/
+struct CachedPrimitive
+{
+  // Offset of the vertex data inside the display list.
+  u32 offset;
+  // Everything the converted output depends on besides the list contents.
+  const VertexLoaderBase* loader;
+  u64 vtx_desc;
+  u32 vat[3];
+  u32 matrix_index_a;
+  u32 matrix_index_b;
+  u32 count;
+  s32 final_count;
+  // Location of the converted vertices in CachedDisplayList::vertex_data.
+  u32 data_offset;
+  u32 data_size;
+};
 
-// TODO: Handle cache-is-full condition :p
+struct CachedDisplayList
+{
+  u64 hash = 0;
+  int last_frame = 0;
+  bool recorded = false;
+  // Sorted by offset, as that's the order the decoder walks the list in.
+  std::vector<CachedPrimitive> primitives;
+  std::vector<u8> vertex_data;
+};
 
+std::unordered_map<u64, CachedDisplayList> s_cache;
+size_t s_cached_bytes = 0;
 
-#include "Common.h"
-#include "DLCache.h"
+CachedDisplayList* s_current = nullptr;
+const u8* s_current_start = nullptr;
+u32 s_current_size = 0;
+size_t s_cursor = 0;
+bool s_recording = false;
+// Display lists can call other lists, only the outermost one is cached.
+int s_depth = 0;
 
-namespace DLCache
+inline u64 MakeKey(u32 address, u32 size)
+{
+  return (static_cast<u64>(address) << 32) | size;
+}
+
+inline bool IsVertexDataCacheable(const VertexLoaderParameters& parameters)
+{
+  // The CPU bounding box is updated by the vertex loader itself.
+  if (g_ActiveConfig.iBBoxMode == BBoxCPU && BoundingBox::active)
+    return false;
+
+  // Indexed attributes are read from the vertex arrays, which are not covered by the hash.
+  for (int i = 0; i < 12; i++)
+  {
+    if (parameters.VtxDesc->GetVertexArrayStatus(i) & INDEX8)
+      return false;
+  }
+  return true;
+}
+
+inline bool GetListOffset(const VertexLoaderParameters& parameters, u32* offset)
+{
+  if (parameters.source < s_current_start ||
+      parameters.source >= s_current_start + s_current_size)
+  {
+    // Vertices of a nested display list.
+    return false;
+  }
+  *offset = static_cast<u32>(parameters.source - s_current_start);
+  return true;
+}
+
+void ResetEntry(CachedDisplayList& entry)
 {
+  s_cached_bytes -= entry.vertex_data.size();
+  entry.primitives.clear();
+  entry.vertex_data.clear();
+  entry.vertex_data.shrink_to_fit();
+  entry.recorded = false;
+}
+}  // Anonymous namespace
 
 void Init()
 {
+  Clear();
 }
 
 void Shutdown()
 {
+  Clear();
 }
 
-void Clear() 
+void Clear()
 {
+  s_cache.clear();
+  s_cached_bytes = 0;
+  s_current = nullptr;
+  s_current_start = nullptr;
+  s_current_size = 0;
+  s_recording = false;
 }
 
 void ProgressiveCleanup()
 {
+  for (auto it = s_cache.begin(); it != s_cache.end();)
+  {
+    // A frame can end in the middle of a display list.
+    if (&it->second != s_current && frameCount - it->second.last_frame > MAX_UNUSED_FRAMES)
+    {
+      s_cached_bytes -= it->second.vertex_data.size();
+      it = s_cache.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+void BeginDisplayList(u32 address, const u8* data, u32 size)
+{
+  if (s_depth++ > 0 || !g_ActiveConfig.bDisplayListCache || size < MIN_LIST_SIZE)
+    return;
+
+  const u64 hash = XXH64(data, size, 0);
+  CachedDisplayList& entry = s_cache[MakeKey(address, size)];
+  if (entry.hash != hash || !entry.recorded)
+  {
+    // Either new, or the game has written to the list since we saw it last.
+    ResetEntry(entry);
+    entry.hash = hash;
+    s_recording = s_cached_bytes < MAX_CACHED_BYTES;
+  }
+  else
+  {
+    s_recording = false;
+  }
+  entry.last_frame = frameCount;
+
+  s_current = &entry;
+  s_current_start = data;
+  s_current_size = size;
+  s_cursor = 0;
+}
+
+void EndDisplayList()
+{
+  if (--s_depth > 0)
+    return;
+
+  if (s_current && s_recording)
+    s_current->recorded = true;
+  s_current = nullptr;
+  s_recording = false;
 }
-}  // namespace
 
-// NOTE - outside the namespace on purpose.
-bool HandleDisplayList(u32 address, u32 size)
+bool ReplayVertices(const VertexLoaderParameters& parameters, const VertexLoaderBase* loader,
+                    s32* finalcount)
 {
-	return false;
+  u32 offset;
+  if (!s_current || s_recording || !GetListOffset(parameters, &offset))
+    return false;
+
+  const std::vector<CachedPrimitive>& primitives = s_current->primitives;
+  if (s_cursor >= primitives.size() || primitives[s_cursor].offset != offset)
+  {
+    // Some batches were not recorded, e.g. because they were skipped by the viewport check.
+    auto it = std::lower_bound(
+        primitives.begin(), primitives.end(), offset,
+        [](const CachedPrimitive& primitive, u32 value) { return primitive.offset < value; });
+    if (it == primitives.end() || it->offset != offset)
+      return false;
+    s_cursor = it - primitives.begin();
+  }
+
+  const CachedPrimitive& primitive = primitives[s_cursor];
+  if (primitive.loader != loader || primitive.count != static_cast<u32>(parameters.count) ||
+      primitive.vtx_desc != parameters.VtxDesc->Hex ||
+      primitive.vat[0] != parameters.VtxAttr->g0.Hex ||
+      primitive.vat[1] != parameters.VtxAttr->g1.Hex ||
+      primitive.vat[2] != parameters.VtxAttr->g2.Hex ||
+      primitive.matrix_index_a != g_main_cp_state.matrix_index_a.Hex ||
+      primitive.matrix_index_b != g_main_cp_state.matrix_index_b.Hex ||
+      !IsVertexDataCacheable(parameters))
+  {
+    return false;
+  }
+
+  std::memcpy(parameters.destination, s_current->vertex_data.data() + primitive.data_offset,
+              primitive.data_size);
+  *finalcount = primitive.final_count;
+  s_cursor++;
+  ADDSTAT(stats.thisFrame.numDLPrimsCached, primitive.final_count);
+  return true;
 }
 
-void IncrementCheckContextId()
+void RecordVertices(const VertexLoaderParameters& parameters, const VertexLoaderBase* loader,
+                    s32 finalcount)
 {
+  u32 offset;
+  if (!s_current || !s_recording || !GetListOffset(parameters, &offset) ||
+      !IsVertexDataCacheable(parameters))
+  {
+    return;
+  }
+
+  const u32 data_size = static_cast<u32>(loader->m_native_stride * finalcount);
+  if (s_cached_bytes + data_size > MAX_CACHED_BYTES)
+  {
+    // Keep what we have, the batches recorded so far can still be replayed.
+    s_recording = false;
+    s_current->recorded = true;
+    return;
+  }
+
+  CachedPrimitive primitive;
+  primitive.offset = offset;
+  primitive.loader = loader;
+  primitive.vtx_desc = parameters.VtxDesc->Hex;
+  primitive.vat[0] = parameters.VtxAttr->g0.Hex;
+  primitive.vat[1] = parameters.VtxAttr->g1.Hex;
+  primitive.vat[2] = parameters.VtxAttr->g2.Hex;
+  primitive.matrix_index_a = g_main_cp_state.matrix_index_a.Hex;
+  primitive.matrix_index_b = g_main_cp_state.matrix_index_b.Hex;
+  primitive.count = static_cast<u32>(parameters.count);
+  primitive.final_count = finalcount;
+  primitive.data_offset = static_cast<u32>(s_current->vertex_data.size());
+  primitive.data_size = data_size;
+  s_current->primitives.push_back(primitive);
+
+  s_current->vertex_data.insert(s_current->vertex_data.end(), parameters.destination,
+                                parameters.destination + data_size);
+  s_cached_bytes += data_size;
 }
+}  // namespace DLCache
@@ -3,6 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <cmath>
+#ifdef _M_ARM_64
+#include <arm_neon.h>
+#endif
 
 #include "Common/CPUDetect.h"
 #include "Common/Common.h"
@@ -957,108 +960,143 @@ struct DXTBlock
   u8 lines[4];
 };
 
-// inline void decodebytesC4(u32 *dst, const u8 *src, u32 numbytes, u32 tlutaddr, u32 tlutfmt)
-inline void decodebytesC4_5A3_To_BGRA32(u32* dst, const u8* src, u32 tlutaddr)
+#ifdef _M_ARM_64
+inline uint8x16_t Expand3To8(uint8x16_t v)
 {
-  u16* tlut = (u16*)(texMem + tlutaddr);
-  for (u32 x = 0; x < 4; x++)
-  {
-    u8 val = src[x];
-    *dst++ = decode5A3(Common::swap16(tlut[val >> 4]));
-    *dst++ = decode5A3(Common::swap16(tlut[val & 0xF]));
-  }
+  return vorrq_u8(vorrq_u8(vshlq_n_u8(v, 5), vshlq_n_u8(v, 2)), vshrq_n_u8(v, 1));
 }
 
-inline void decodebytesC4_5A3_To_rgba32(u32* dst, const u8* src, u32 tlutaddr)
+inline uint8x16_t Expand4To8(uint8x16_t v)
 {
-  u16* tlut = (u16*)(texMem + tlutaddr);
-  for (u32 x = 0; x < 4; x++)
-  {
-    u8 val = src[x];
-    *dst++ = decode5A3RGBA(Common::swap16(tlut[val >> 4]));
-    *dst++ = decode5A3RGBA(Common::swap16(tlut[val & 0xF]));
-  }
+  return vorrq_u8(vshlq_n_u8(v, 4), v);
 }
 
-inline void decodebytesC4_To_Raw16(u16* dst, const u8* src, u32 tlutaddr)
+inline uint8x16_t Expand5To8(uint8x16_t v)
 {
-  u16* tlut = (u16*)(texMem + tlutaddr);
-  for (u32 x = 0; x < 4; x++)
-  {
-    u8 val = src[x];
-    *dst++ = Common::swap16(tlut[val >> 4]);
-    *dst++ = Common::swap16(tlut[val & 0xF]);
-  }
+  return vorrq_u8(vshlq_n_u8(v, 3), vshrq_n_u8(v, 2));
 }
 
-inline void decodebytesC4IA8_To_RGBA(u32* dst, const u8* src, u32 tlutaddr)
+inline uint8x16_t Expand6To8(uint8x16_t v)
 {
-  u16* tlut = (u16*)(texMem + tlutaddr);
-  for (u32 x = 0; x < 4; x++)
-  {
-    u8 val = src[x];
-    *dst++ = decodeIA8Swapped(tlut[val >> 4]);
-    *dst++ = decodeIA8Swapped(tlut[val & 0xF]);
-  }
+  return vorrq_u8(vshlq_n_u8(v, 2), vshrq_n_u8(v, 4));
 }
 
-inline void decodebytesC4RGB565_To_RGBA(u32* dst, const u8* src, u32 tlutaddr)
+// Splits the 32 bytes of an 8x8 block of 4 bit texels into one vector per row, the high nibble
+// of a byte is the left texel.
+inline void SplitNibbles(uint8x8_t* rows, const u8* src)
 {
-  u16* tlut = (u16*)(texMem + tlutaddr);
-  for (u32 x = 0; x < 4; x++)
+  for (u32 i = 0; i < 2; i++)
   {
-    u8 val = src[x];
-    *dst++ = decode565RGBA(Common::swap16(tlut[val >> 4]));
-    *dst++ = decode565RGBA(Common::swap16(tlut[val & 0xF]));
+    const uint8x16_t v = vld1q_u8(src + 16 * i);
+    const uint8x16x2_t texels = vzipq_u8(vshrq_n_u8(v, 4), vandq_u8(v, vdupq_n_u8(0xF)));
+    rows[4 * i + 0] = vget_low_u8(texels.val[0]);
+    rows[4 * i + 1] = vget_high_u8(texels.val[0]);
+    rows[4 * i + 2] = vget_low_u8(texels.val[1]);
+    rows[4 * i + 3] = vget_high_u8(texels.val[1]);
   }
 }
 
-// inline void decodebytesC8(u32 *dst, const u8 *src, u32 numbytes, u32 tlutaddr, u32 tlutfmt)
-inline void decodebytesC8_5A3_To_BGRA32(u32* dst, const u8* src, u32 tlutaddr)
+// Interleaves the channels of a 4x4 block, given in texel order, and stores its rows.
+inline void StoreBlock4x4(u32* dst, u32 pitch, uint8x16_t c0, uint8x16_t c1, uint8x16_t c2,
+                          uint8x16_t c3)
 {
-  u16* tlut = (u16*)(texMem + tlutaddr);
-  for (u32 x = 0; x < 8; x++)
-  {
-    u8 val = src[x];
-    *dst++ = decode5A3(Common::swap16(tlut[val]));
+  const uint8x16x2_t c01 = vzipq_u8(c0, c1);
+  const uint8x16x2_t c23 = vzipq_u8(c2, c3);
+  const uint16x8x2_t top =
+      vzipq_u16(vreinterpretq_u16_u8(c01.val[0]), vreinterpretq_u16_u8(c23.val[0]));
+  const uint16x8x2_t bottom =
+      vzipq_u16(vreinterpretq_u16_u8(c01.val[1]), vreinterpretq_u16_u8(c23.val[1]));
+  vst1q_u8((u8*)dst, vreinterpretq_u8_u16(top.val[0]));
+  vst1q_u8((u8*)(dst + pitch), vreinterpretq_u8_u16(top.val[1]));
+  vst1q_u8((u8*)(dst + pitch * 2), vreinterpretq_u8_u16(bottom.val[0]));
+  vst1q_u8((u8*)(dst + pitch * 3), vreinterpretq_u8_u16(bottom.val[1]));
+}
+#endif
+
+// Palettes are decoded once per texture instead of once per texel.
+static void DecodePalette(u32* palette, u32 tlutaddr, u32 count, u32 tlutfmt, bool rgba)
+{
+  const u16* tlut = (u16*)(texMem + tlutaddr);
+  for (u32 i = 0; i < count; i++)
+  {
+    if (tlutfmt == GX_TL_RGB5A3)
+      palette[i] = rgba ? decode5A3RGBA(Common::swap16(tlut[i])) :
+                          decode5A3(Common::swap16(tlut[i]));
+    else if (tlutfmt == GX_TL_IA8)
+      palette[i] = decodeIA8Swapped(tlut[i]);
+    else
+      palette[i] = decode565RGBA(Common::swap16(tlut[i]));
   }
 }
 
-inline void decodebytesC8_5A3_To_RGBA32(u32* dst, const u8* src, u32 tlutaddr)
+inline void decodeblockC4(u32* dst, const u8* src, u32 pitch, const u32* palette)
 {
-  u16* tlut = (u16*)(texMem + tlutaddr);
-  for (u32 x = 0; x < 8; x++)
+#ifdef _M_ARM_64
+  // One table lookup per byte of the palette entries.
+  const uint8x16x4_t planes = vld4q_u8((const u8*)palette);
+  uint8x8_t rows[8];
+  SplitNibbles(rows, src);
+  for (u32 iy = 0; iy < 8; iy++)
+  {
+    uint8x8x4_t texels;
+    texels.val[0] = vqtbl1_u8(planes.val[0], rows[iy]);
+    texels.val[1] = vqtbl1_u8(planes.val[1], rows[iy]);
+    texels.val[2] = vqtbl1_u8(planes.val[2], rows[iy]);
+    texels.val[3] = vqtbl1_u8(planes.val[3], rows[iy]);
+    vst4_u8((u8*)(dst + iy * pitch), texels);
+  }
+#else
+  for (u32 iy = 0; iy < 8; iy++, dst += pitch)
   {
-    u8 val = src[x];
-    *dst++ = decode5A3RGBA(Common::swap16(tlut[val]));
+    for (u32 x = 0; x < 4; x++)
+    {
+      u8 val = src[iy * 4 + x];
+      dst[x * 2] = palette[val >> 4];
+      dst[x * 2 + 1] = palette[val & 0xF];
+    }
   }
+#endif
 }
 
-inline void decodebytesC8_To_Raw16(u16* dst, const u8* src, u32 tlutaddr)
+inline void decodeblockC4_To_Raw16(u16* dst, const u8* src, u32 pitch, const u16* palette)
 {
-  u16* tlut = (u16*)(texMem + tlutaddr);
-  for (u32 x = 0; x < 8; x++)
+#ifdef _M_ARM_64
+  const uint8x16x2_t planes = vld2q_u8((const u8*)palette);
+  uint8x8_t rows[8];
+  SplitNibbles(rows, src);
+  for (u32 iy = 0; iy < 8; iy++)
   {
-    u8 val = src[x];
-    *dst++ = Common::swap16(tlut[val]);
+    uint8x8x2_t texels;
+    texels.val[0] = vqtbl1_u8(planes.val[0], rows[iy]);
+    texels.val[1] = vqtbl1_u8(planes.val[1], rows[iy]);
+    vst2_u8((u8*)(dst + iy * pitch), texels);
   }
+#else
+  for (u32 iy = 0; iy < 8; iy++, dst += pitch)
+  {
+    for (u32 x = 0; x < 4; x++)
+    {
+      u8 val = src[iy * 4 + x];
+      dst[x * 2] = palette[val >> 4];
+      dst[x * 2 + 1] = palette[val & 0xF];
+    }
+  }
+#endif
 }
 
-inline void decodebytesC8IA8_To_RGBA(u32* dst, const u8* src, u32 tlutaddr)
+inline void decodebytesC8(u32* dst, const u8* src, const u32* palette)
 {
-  u16* tlut = (u16*)(texMem + tlutaddr);
   for (u32 x = 0; x < 8; x++)
-  {
-    *dst++ = decodeIA8Swapped(tlut[src[x]]);
-  }
+    dst[x] = palette[src[x]];
 }
 
-inline void decodebytesC8RGB565_To_RGBA(u32* dst, const u8* src, u32 tlutaddr)
+inline void decodebytesC8_To_Raw16(u16* dst, const u8* src, u32 tlutaddr)
 {
   u16* tlut = (u16*)(texMem + tlutaddr);
   for (u32 x = 0; x < 8; x++)
   {
-    *dst++ = decode565RGBA(Common::swap16(tlut[src[x]]));
+    u8 val = src[x];
+    *dst++ = Common::swap16(tlut[val]);
   }
 }
 
@@ -1115,6 +1153,13 @@ inline void decodebytesC14X2rgb565_To_RGBA(u32* dst, const u16* src, u32 tlutadd
 // Needs more speed.
 inline void decodebytesIA4(u16* dst, const u8* src)
 {
+#ifdef _M_ARM_64
+  const uint8x8_t val = vld1_u8(src);
+  uint8x8x2_t texels;
+  texels.val[0] = vorr_u8(vshl_n_u8(val, 4), vand_u8(val, vdup_n_u8(0xF)));
+  texels.val[1] = vorr_u8(vand_u8(val, vdup_n_u8(0xF0)), vshr_n_u8(val, 4));
+  vst2_u8((u8*)dst, texels);
+#else
   for (u32 x = 0; x < 8; x++)
   {
     const u8 val = src[x];
@@ -1122,10 +1167,21 @@ inline void decodebytesIA4(u16* dst, const u8* src)
     u8 l = Convert4To8(val & 0xF);
     dst[x] = (a << 8) | l;
   }
+#endif
 }
 
 inline void decodebytesIA4RGBA(u32* dst, const u8* src)
 {
+#ifdef _M_ARM_64
+  const uint8x8_t val = vld1_u8(src);
+  const uint8x8_t l = vorr_u8(vshl_n_u8(val, 4), vand_u8(val, vdup_n_u8(0xF)));
+  uint8x8x4_t texels;
+  texels.val[0] = l;
+  texels.val[1] = l;
+  texels.val[2] = l;
+  texels.val[3] = vorr_u8(vand_u8(val, vdup_n_u8(0xF0)), vshr_n_u8(val, 4));
+  vst4_u8((u8*)dst, texels);
+#else
   for (u32 x = 0; x < 8; x++)
   {
     const u8 val = src[x];
@@ -1133,6 +1189,97 @@ inline void decodebytesIA4RGBA(u32* dst, const u8* src)
     u8 l = Convert4To8(val & 0xF);
     dst[x] = (a << 24) | l << 16 | l << 8 | l;
   }
+#endif
+}
+
+inline void decodeblockI4(u8* dst, const u8* src, u32 pitch)
+{
+#ifdef _M_ARM_64
+  uint8x8_t rows[8];
+  SplitNibbles(rows, src);
+  for (u32 iy = 0; iy < 8; iy++)
+    vst1_u8(dst + iy * pitch, vorr_u8(vshl_n_u8(rows[iy], 4), rows[iy]));
+#else
+  for (u32 iy = 0; iy < 8; iy++, dst += pitch)
+  {
+    for (u32 ix = 0; ix < 4; ix++)
+    {
+      u32 val = src[iy * 4 + ix];
+      dst[ix * 2] = Convert4To8(val >> 4);
+      dst[ix * 2 + 1] = Convert4To8(val & 0xF);
+    }
+  }
+#endif
+}
+
+inline void decodeblockI4RGBA(u32* dst, const u8* src, u32 pitch)
+{
+#ifdef _M_ARM_64
+  uint8x8_t rows[8];
+  SplitNibbles(rows, src);
+  for (u32 iy = 0; iy < 8; iy++)
+  {
+    const uint8x8_t i = vorr_u8(vshl_n_u8(rows[iy], 4), rows[iy]);
+    uint8x8x4_t texels;
+    texels.val[0] = i;
+    texels.val[1] = i;
+    texels.val[2] = i;
+    texels.val[3] = i;
+    vst4_u8((u8*)(dst + iy * pitch), texels);
+  }
+#else
+  for (u32 iy = 0; iy < 8; iy++, dst += pitch)
+  {
+    for (u32 ix = 0; ix < 4; ix++)
+    {
+      u32 val = src[iy * 4 + ix];
+      u8 i1 = Convert4To8(val >> 4);
+      u8 i2 = Convert4To8(val & 0xF);
+      memset(dst + ix * 2, i1, 4);
+      memset(dst + ix * 2 + 1, i2, 4);
+    }
+  }
+#endif
+}
+
+inline void decodebytesI8RGBA(u32* dst, const u8* src)
+{
+#ifdef _M_ARM_64
+  const uint8x8_t i = vld1_u8(src);
+  uint8x8x4_t texels;
+  texels.val[0] = i;
+  texels.val[1] = i;
+  texels.val[2] = i;
+  texels.val[3] = i;
+  vst4_u8((u8*)dst, texels);
+#else
+  for (u32 x = 0; x < 8; x++)
+    dst[x] = u32(src[x]) * 0x01010101;
+#endif
+}
+
+// IA8 and RGB565 are stored big endian.
+inline void decodebytesSwap16(u16* dst, const u16* src)
+{
+#ifdef _M_ARM_64
+  vst1_u8((u8*)dst, vrev16_u8(vld1_u8((const u8*)src)));
+#else
+  for (u32 x = 0; x < 4; x++)
+    dst[x] = Common::swap16(src[x]);
+#endif
+}
+
+inline void decodebytesIA8RGBA(u32* dst, const u16* src)
+{
+#ifdef _M_ARM_64
+  // Each texel is stored as AI, the intensity goes to the three color channels.
+  alignas(16) static const u8 shuffle[16] = {1, 1, 1, 0, 3, 3, 3, 2, 5, 5, 5, 4, 7, 7, 7, 6};
+  const uint8x8_t val = vld1_u8((const u8*)src);
+  vst1q_u8((u8*)dst, vqtbl1q_u8(vcombine_u8(val, val), vld1q_u8(shuffle)));
+#else
+  for (u32 x = 0; x < 4; x++)
+    dst[x] = decodeIA8Swapped(src[x]);
+#endif
 }
 
 inline void decodebytesRGB5A3(u32* dst, const u16* src)
@@ -1198,6 +1345,101 @@ inline void decodebytesARGB8_4ToRgba(u32* dst, const u16* src, const u16* src2)
 #endif
 }
 
+inline void decodeblockRGB565RGBA(u32* dst, const u8* src, u32 pitch)
+{
+#ifdef _M_ARM_64
+  // RRRRRGGG GGGBBBBB
+  const uint8x16x2_t val = vld2q_u8(src);
+  const uint8x16_t high = val.val[0];
+  const uint8x16_t low = val.val[1];
+  const uint8x16_t r = Expand5To8(vshrq_n_u8(high, 3));
+  const uint8x16_t g =
+      Expand6To8(vorrq_u8(vshlq_n_u8(vandq_u8(high, vdupq_n_u8(7)), 3), vshrq_n_u8(low, 5)));
+  const uint8x16_t b = Expand5To8(vandq_u8(low, vdupq_n_u8(0x1F)));
+  StoreBlock4x4(dst, pitch, r, g, b, vdupq_n_u8(0xFF));
+#else
+  const u16* s = (const u16*)src;
+  for (u32 iy = 0; iy < 4; iy++, dst += pitch)
+    for (u32 x = 0; x < 4; x++)
+      dst[x] = decode565RGBA(Common::swap16(*s++));
+#endif
+}
+
+#ifdef _M_ARM_64
+inline void DecodeRGB5A3Channels(const u8* src, uint8x16_t* r, uint8x16_t* g, uint8x16_t* b,
+                                 uint8x16_t* a)
+{
+  const uint8x16x2_t val = vld2q_u8(src);
+  const uint8x16_t high = val.val[0];
+  const uint8x16_t low = val.val[1];
+  const uint8x16_t opaque = vtstq_u8(high, vdupq_n_u8(0x80));
+  // 1RRRRRGG GGGBBBBB
+  const uint8x16_t r5 = vandq_u8(vshrq_n_u8(high, 2), vdupq_n_u8(0x1F));
+  const uint8x16_t g5 =
+      vorrq_u8(vshlq_n_u8(vandq_u8(high, vdupq_n_u8(3)), 3), vshrq_n_u8(low, 5));
+  const uint8x16_t b5 = vandq_u8(low, vdupq_n_u8(0x1F));
+  // 0AAARRRR GGGGBBBB
+  const uint8x16_t a3 = vandq_u8(vshrq_n_u8(high, 4), vdupq_n_u8(7));
+  const uint8x16_t r4 = vandq_u8(high, vdupq_n_u8(0xF));
+  const uint8x16_t g4 = vshrq_n_u8(low, 4);
+  const uint8x16_t b4 = vandq_u8(low, vdupq_n_u8(0xF));
+  *r = vbslq_u8(opaque, Expand5To8(r5), Expand4To8(r4));
+  *g = vbslq_u8(opaque, Expand5To8(g5), Expand4To8(g4));
+  *b = vbslq_u8(opaque, Expand5To8(b5), Expand4To8(b4));
+  *a = vbslq_u8(opaque, vdupq_n_u8(0xFF), Expand3To8(a3));
+}
+#endif
+
+inline void decodeblockRGB5A3(u32* dst, const u8* src, u32 pitch)
+{
+#ifdef _M_ARM_64
+  uint8x16_t r, g, b, a;
+  DecodeRGB5A3Channels(src, &r, &g, &b, &a);
+  StoreBlock4x4(dst, pitch, b, g, r, a);
+#else
+  for (u32 iy = 0; iy < 4; iy++)
+    decodebytesRGB5A3(dst + iy * pitch, (const u16*)src + iy * 4);
+#endif
+}
+
+inline void decodeblockRGB5A3rgba(u32* dst, const u8* src, u32 pitch)
+{
+#ifdef _M_ARM_64
+  uint8x16_t r, g, b, a;
+  DecodeRGB5A3Channels(src, &r, &g, &b, &a);
+  StoreBlock4x4(dst, pitch, r, g, b, a);
+#else
+  for (u32 iy = 0; iy < 4; iy++)
+    decodebytesRGB5A3rgba(dst + iy * pitch, (const u16*)src + iy * 4);
+#endif
+}
+
+// The first 32 bytes of a block hold the AR pairs, the last 32 bytes the GB pairs.
+inline void decodeblockARGB8(u32* dst, const u8* src, u32 pitch)
+{
+#ifdef _M_ARM_64
+  const uint8x16x2_t ar = vld2q_u8(src);
+  const uint8x16x2_t gb = vld2q_u8(src + 32);
+  StoreBlock4x4(dst, pitch, gb.val[1], gb.val[0], ar.val[1], ar.val[0]);
+#else
+  for (u32 iy = 0; iy < 4; iy++)
+    decodebytesARGB8_4(dst + iy * pitch, (const u16*)src + 4 * iy, (const u16*)src + 4 * iy + 16);
+#endif
+}
+
+inline void decodeblockARGB8ToRgba(u32* dst, const u8* src, u32 pitch)
+{
+#ifdef _M_ARM_64
+  const uint8x16x2_t ar = vld2q_u8(src);
+  const uint8x16x2_t gb = vld2q_u8(src + 32);
+  StoreBlock4x4(dst, pitch, ar.val[1], gb.val[0], gb.val[1], ar.val[0]);
+#else
+  for (u32 iy = 0; iy < 4; iy++)
+    decodebytesARGB8_4ToRgba(dst + iy * pitch, (const u16*)src + 4 * iy,
+                             (const u16*)src + 4 * iy + 16);
+#endif
+}
+
 struct DXT1Block
 {
   u16 color1;
@@ -1272,6 +1514,25 @@ inline u32 makeRGBA(u32 r, u32 g, u32 b, u32 a)
   return (a << 24) | (b << 16) | (g << 8) | r;
 }
 
+#ifdef _M_ARM_64
+// Looks up the texels of a block in its four colors, 2 bits per texel, leftmost texel in the
+// high bits of a line.
+inline void ExpandDXTBlock(u32* dst, const DXT1Block* src, u32 pitch, const u32* colors)
+{
+  alignas(16) static const s8 shifts[16] = {-6, -6, -6, -6, -4, -4, -4, -4,
+                                            -2, -2, -2, -2, 0,  0,  0,  0};
+  alignas(16) static const u8 offsets[16] = {0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3};
+  const uint8x16_t table = vld1q_u8((const u8*)colors);
+  for (u32 y = 0; y < 4; y++)
+  {
+    uint8x16_t index = vshlq_u8(vdupq_n_u8(src->lines[y]), vld1q_s8(shifts));
+    index = vandq_u8(index, vdupq_n_u8(3));
+    index = vaddq_u8(vshlq_n_u8(index, 2), vld1q_u8(offsets));
+    vst1q_u8((u8*)(dst + y * pitch), vqtbl1q_u8(table, index));
+  }
+}
+#endif
+
 inline void decodeDXTBlock(u32* dst, const DXT1Block* src, u32 pitch)
 {
   // S3TC Decoder (Note: GCN decodes differently from PC so we can't use native support)
@@ -1302,6 +1563,9 @@ inline void decodeDXTBlock(u32* dst, const DXT1Block* src, u32 pitch)
     colors[3] = makecol(red2, green2, blue2, 0);  // Color2 but transparent
   }
 
+#ifdef _M_ARM_64
+  ExpandDXTBlock(dst, src, pitch, colors);
+#else
   for (u32 y = 0; y < 4; y++)
   {
     u32 val = src->lines[y];
@@ -1312,6 +1576,7 @@ inline void decodeDXTBlock(u32* dst, const DXT1Block* src, u32 pitch)
     }
     dst += pitch;
   }
+#endif
 }
 
 inline void decodeDXTBlockRGBA(u32* dst, const DXT1Block* src, u32 pitch)
@@ -1344,6 +1609,9 @@ inline void decodeDXTBlockRGBA(u32* dst, const DXT1Block* src, u32 pitch)
     colors[3] = makeRGBA(red2, green2, blue2, 0);  // Color2 but transparent
   }
 
+#ifdef _M_ARM_64
+  ExpandDXTBlock(dst, src, pitch, colors);
+#else
   for (u32 y = 0; y < 4; y++)
   {
     u32 val = src->lines[y];
@@ -1354,6 +1622,7 @@ inline void decodeDXTBlockRGBA(u32* dst, const DXT1Block* src, u32 pitch)
     }
     dst += pitch;
   }
+#endif
 }
 
 inline void DXT1ToDXT3Block(DXT3Block* dst, const DXT1Block* src)
@@ -1469,31 +1738,28 @@ static HostTextureFormat Decode_real(u8* dst, const u8* src, u32 width, u32 heig
     if (tlutfmt == 2)
     {
       // Special decoding is required for TLUT format 5A3
+      u32 palette[16];
+      DecodePalette(palette, tlutaddr, 16, tlutfmt, false);
       for (u32 y = 0; y < height; y += 8)
         for (u32 x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
-          for (u32 iy = 0, xStep = yStep * 8; iy < 8; iy++, xStep++)
-            decodebytesC4_5A3_To_BGRA32((u32*)dst + (y + iy) * width + x, src + 4 * xStep,
-                                        tlutaddr);
+          decodeblockC4((u32*)dst + y * width + x, src + 32 * yStep, width, palette);
     }
     else
     {
+      const u16* tlut = (u16*)(texMem + tlutaddr);
+      u16 palette[16];
+      for (u32 i = 0; i < 16; i++)
+        palette[i] = Common::swap16(tlut[i]);
       for (u32 y = 0; y < height; y += 8)
         for (u32 x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
-          for (u32 iy = 0, xStep = yStep * 8; iy < 8; iy++, xStep++)
-            decodebytesC4_To_Raw16((u16*)dst + (y + iy) * width + x, src + 4 * xStep, tlutaddr);
+          decodeblockC4_To_Raw16((u16*)dst + y * width + x, src + 32 * yStep, width, palette);
     }
     return GetPCFormatFromTLUTFormat(tlutfmt);
   case GX_TF_I4:
   {
     for (u32 y = 0; y < height; y += 8)
       for (u32 x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
-        for (u32 iy = 0, xStep = yStep * 8; iy < 8; iy++, xStep++)
-          for (u32 ix = 0; ix < 4; ix++)
-          {
-            u32 val = src[4 * xStep + ix];
-            dst[(y + iy) * width + x + ix * 2] = Convert4To8(val >> 4);
-            dst[(y + iy) * width + x + ix * 2 + 1] = Convert4To8(val & 0xF);
-          }
+        decodeblockI4(dst + y * width + x, src + 32 * yStep, width);
   }
     return PC_TEX_FMT_I4_AS_I8;
   case GX_TF_I8:  // speed critical
@@ -1508,11 +1774,12 @@ static HostTextureFormat Decode_real(u8* dst, const u8* src, u32 width, u32 heig
     if (tlutfmt == 2)
     {
       // Special decoding is required for TLUT format 5A3
+      u32 palette[256];
+      DecodePalette(palette, tlutaddr, 256, tlutfmt, false);
       for (u32 y = 0; y < height; y += 4)
         for (u32 x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
           for (u32 iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-            decodebytesC8_5A3_To_BGRA32((u32*)dst + (y + iy) * width + x, src + 8 * xStep,
-                                        tlutaddr);
+            decodebytesC8((u32*)dst + (y + iy) * width + x, src + 8 * xStep, palette);
     }
     else
     {
@@ -1537,12 +1804,7 @@ static HostTextureFormat Decode_real(u8* dst, const u8* src, u32 width, u32 heig
     for (u32 y = 0; y < height; y += 4)
       for (u32 x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
         for (u32 iy = 0, xStep = yStep * 4; iy < 4; iy++, xStep++)
-        {
-          u16* ptr = (u16*)dst + (y + iy) * width + x;
-          u16* s = (u16*)(src + 8 * xStep);
-          for (u32 j = 0; j < 4; j++)
-            *ptr++ = Common::swap16(*s++);
-        }
+          decodebytesSwap16((u16*)dst + (y + iy) * width + x, (u16*)(src + 8 * xStep));
   }
     return PC_TEX_FMT_IA8;
   case GX_TF_C14X2:
@@ -1569,21 +1831,14 @@ static HostTextureFormat Decode_real(u8* dst, const u8* src, u32 width, u32 heig
     for (u32 y = 0; y < height; y += 4)
       for (u32 x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
         for (u32 iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-        {
-          u16* ptr = (u16*)dst + (y + iy) * width + x;
-          u16* s = (u16*)(src + 8 * xStep);
-          for (u32 j = 0; j < 4; j++)
-            *ptr++ = Common::swap16(*s++);
-        }
+          decodebytesSwap16((u16*)dst + (y + iy) * width + x, (u16*)(src + 8 * xStep));
   }
     return PC_TEX_FMT_RGB565;
   case GX_TF_RGB5A3:
   {
     for (u32 y = 0; y < height; y += 4)
       for (u32 x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
-        for (u32 iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-          // decodebytesRGB5A3((u32*)dst+(y+iy)*width+x, (u16*)src, 4);
-          decodebytesRGB5A3((u32*)dst + (y + iy) * width + x, (u16*)(src + 8 * xStep));
+        decodeblockRGB5A3((u32*)dst + y * width + x, src + 32 * yStep, width);
   }
     return PC_TEX_FMT_BGRA32;
   case GX_TF_RGBA8:  // speed critical
@@ -1591,12 +1846,7 @@ static HostTextureFormat Decode_real(u8* dst, const u8* src, u32 width, u32 heig
     for (u32 y = 0; y < height; y += 4)
     {
       for (u32 x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
-      {
-        const u8* src2 = src + 64 * yStep;
-        for (u32 iy = 0; iy < 4; iy++)
-          decodebytesARGB8_4((u32*)dst + (y + iy) * width + x, (u16*)src2 + 4 * iy,
-                             (u16*)src2 + 4 * iy + 16);
-      }
+        decodeblockARGB8((u32*)dst + y * width + x, src + 64 * yStep, width);
     }
   }
     return PC_TEX_FMT_BGRA32;
@@ -1674,100 +1924,39 @@ HostTextureFormat Decode_RGBA(u32* dst, const u8* src, u32 width, u32 height, u3
   switch (texformat)
   {
   case GX_TF_C4:
-    if (tlutfmt == 2)
-    {
-      // Special decoding is required for TLUT format 5A3
-      for (u32 y = 0; y < height; y += 8)
-        for (u32 x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
-          for (u32 iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
-            decodebytesC4_5A3_To_rgba32(dst + (y + iy) * width + x, src + 4 * xStep, tlutaddr);
-    }
-    else if (tlutfmt == 0)
-    {
-      for (u32 y = 0; y < height; y += 8)
-        for (u32 x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
-          for (u32 iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
-            decodebytesC4IA8_To_RGBA(dst + (y + iy) * width + x, src + 4 * xStep, tlutaddr);
-    }
-    else
-    {
-      for (u32 y = 0; y < height; y += 8)
-        for (u32 x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
-          for (u32 iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
-            decodebytesC4RGB565_To_RGBA(dst + (y + iy) * width + x, src + 4 * xStep, tlutaddr);
-    }
-    break;
+  {
+    u32 palette[16];
+    DecodePalette(palette, tlutaddr, 16, tlutfmt, true);
+    for (u32 y = 0; y < height; y += 8)
+      for (u32 x = 0; x < width; x += 8, src += 32)
+        decodeblockC4(dst + y * width + x, src, width, palette);
+  }
+  break;
   case GX_TF_I4:
   {
-    // Reference C implementation:
     for (u32 y = 0; y < height; y += 8)
-      for (u32 x = 0; x < width; x += 8)
-        for (u32 iy = 0; iy < 8; iy++, src += 4)
-          for (u32 ix = 0; ix < 4; ix++)
-          {
-            u32 val = src[ix];
-            u8 i1 = Convert4To8(val >> 4);
-            u8 i2 = Convert4To8(val & 0xF);
-            memset(dst + (y + iy) * width + x + ix * 2, i1, 4);
-            memset(dst + (y + iy) * width + x + ix * 2 + 1, i2, 4);
-          }
+      for (u32 x = 0; x < width; x += 8, src += 32)
+        decodeblockI4RGBA(dst + y * width + x, src, width);
   }
   break;
   case GX_TF_I8:  // speed critical
   {
-    // Reference C implementation
     for (u32 y = 0; y < height; y += 4)
       for (u32 x = 0; x < width; x += 8)
         for (u32 iy = 0; iy < 4; ++iy, src += 8)
-        {
-          u32* newdst = dst + (y + iy) * width + x;
-          const u8* newsrc = src;
-          u8 srcval;
-
-          srcval = (newsrc++)[0];
-          (newdst++)[0] = srcval | (srcval << 8) | (srcval << 16) | (srcval << 24);
-          srcval = (newsrc++)[0];
-          (newdst++)[0] = srcval | (srcval << 8) | (srcval << 16) | (srcval << 24);
-          srcval = (newsrc++)[0];
-          (newdst++)[0] = srcval | (srcval << 8) | (srcval << 16) | (srcval << 24);
-          srcval = (newsrc++)[0];
-          (newdst++)[0] = srcval | (srcval << 8) | (srcval << 16) | (srcval << 24);
-          srcval = (newsrc++)[0];
-          (newdst++)[0] = srcval | (srcval << 8) | (srcval << 16) | (srcval << 24);
-          srcval = (newsrc++)[0];
-          (newdst++)[0] = srcval | (srcval << 8) | (srcval << 16) | (srcval << 24);
-          srcval = (newsrc++)[0];
-          (newdst++)[0] = srcval | (srcval << 8) | (srcval << 16) | (srcval << 24);
-          srcval = newsrc[0];
-          newdst[0] = srcval | (srcval << 8) | (srcval << 16) | (srcval << 24);
-        }
+          decodebytesI8RGBA(dst + (y + iy) * width + x, src);
   }
   break;
   case GX_TF_C8:
-    if (tlutfmt == 2)
-    {
-      // Special decoding is required for TLUT format 5A3
-      for (u32 y = 0; y < height; y += 4)
-        for (u32 x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
-          for (u32 iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-            decodebytesC8_5A3_To_RGBA32((u32*)dst + (y + iy) * width + x, src + 8 * xStep,
-                                        tlutaddr);
-    }
-    else if (tlutfmt == 0)
-    {
-      for (u32 y = 0; y < height; y += 4)
-        for (u32 x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
-          for (u32 iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-            decodebytesC8IA8_To_RGBA(dst + (y + iy) * width + x, src + 8 * xStep, tlutaddr);
-    }
-    else
-    {
-      for (u32 y = 0; y < height; y += 4)
-        for (u32 x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
-          for (u32 iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-            decodebytesC8RGB565_To_RGBA(dst + (y + iy) * width + x, src + 8 * xStep, tlutaddr);
-    }
-    break;
+  {
+    u32 palette[256];
+    DecodePalette(palette, tlutaddr, 256, tlutfmt, true);
+    for (u32 y = 0; y < height; y += 4)
+      for (u32 x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+        for (u32 iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
+          decodebytesC8(dst + (y + iy) * width + x, src + 8 * xStep, palette);
+  }
+  break;
   case GX_TF_IA4:
   {
     for (u32 y = 0; y < height; y += 4)
@@ -1778,18 +1967,10 @@ HostTextureFormat Decode_RGBA(u32* dst, const u8* src, u32 width, u32 height, u3
   break;
   case GX_TF_IA8:
   {
-    // Reference C implementation:
     for (u32 y = 0; y < height; y += 4)
       for (u32 x = 0; x < width; x += 4)
         for (u32 iy = 0; iy < 4; iy++, src += 8)
-        {
-          u32* ptr = dst + (y + iy) * width + x;
-          u16* s = (u16*)src;
-          ptr[0] = decodeIA8Swapped(s[0]);
-          ptr[1] = decodeIA8Swapped(s[1]);
-          ptr[2] = decodeIA8Swapped(s[2]);
-          ptr[3] = decodeIA8Swapped(s[3]);
-        }
+          decodebytesIA8RGBA(dst + (y + iy) * width + x, (u16*)src);
   }
   break;
   case GX_TF_C14X2:
@@ -1821,38 +2002,23 @@ HostTextureFormat Decode_RGBA(u32* dst, const u8* src, u32 width, u32 height, u3
     break;
   case GX_TF_RGB565:
   {
-    // Reference C implementation.
     for (u32 y = 0; y < height; y += 4)
-      for (u32 x = 0; x < width; x += 4)
-        for (u32 iy = 0; iy < 4; iy++, src += 8)
-        {
-          u32* ptr = dst + (y + iy) * width + x;
-          u16* s = (u16*)src;
-          for (u32 j = 0; j < 4; j++)
-            *ptr++ = decode565RGBA(Common::swap16(*s++));
-        }
+      for (u32 x = 0; x < width; x += 4, src += 32)
+        decodeblockRGB565RGBA(dst + y * width + x, src, width);
   }
   break;
   case GX_TF_RGB5A3:
   {
-    // Reference C implementation:
     for (u32 y = 0; y < height; y += 4)
-      for (u32 x = 0; x < width; x += 4)
-        for (u32 iy = 0; iy < 4; iy++, src += 8)
-          decodebytesRGB5A3rgba(dst + (y + iy) * width + x, (u16*)src);
+      for (u32 x = 0; x < width; x += 4, src += 32)
+        decodeblockRGB5A3rgba(dst + y * width + x, src, width);
   }
   break;
   case GX_TF_RGBA8:  // speed critical
   {
-    // Reference C implementation.
     for (u32 y = 0; y < height; y += 4)
-      for (u32 x = 0; x < width; x += 4)
-      {
-        for (u32 iy = 0; iy < 4; iy++)
-          decodebytesARGB8_4ToRgba(dst + (y + iy) * width + x, (u16*)src + 4 * iy,
-                                   (u16*)src + 4 * iy + 16);
-        src += 64;
-      }
+      for (u32 x = 0; x < width; x += 4, src += 64)
+        decodeblockARGB8ToRgba(dst + y * width + x, src, width);
   }
   break;
   case GX_TF_CMPR:  // speed critical
@@ -20,7 +20,8 @@ bool geometry_shader_uid_data::IsPassthrough() const
 {
   const bool stereo = g_ActiveConfig.iStereoMode > 0;
   const bool wireframe = g_ActiveConfig.bWireFrame;
-  return primitive_type == static_cast<u32>(PrimitiveType::Triangles) && !stereo && !wireframe;
+  return primitive_type == static_cast<u32>(PrimitiveType::Triangles) &&
+         (!stereo || vertex_stereo) && !wireframe;
 }
 
 void GetGeometryShaderUid(GeometryShaderUid& out, PrimitiveType primitive_type, const XFMemory& xfr,
@@ -28,6 +29,9 @@ void GetGeometryShaderUid(GeometryShaderUid& out, PrimitiveType primitive_type,
 {
   out.ClearUID();
   geometry_shader_uid_data& uid_data = out.GetUidData<geometry_shader_uid_data>();
+  // Strips are split up into triangles before they reach the geometry shader.
+  if (primitive_type == PrimitiveType::TriangleStrip)
+    primitive_type = PrimitiveType::Triangles;
   uid_data.primitive_type = static_cast<u32>(primitive_type);
   uid_data.numTexGens = xfr.numTexGen.numTexGens;
   bool forced_lighting_enabled =
@@ -36,7 +36,8 @@ struct geometry_shader_uid_data
   u32 numTexGens : 4;
   u32 pixel_lighting : 1;
   u32 primitive_type : 2;
-  u32 padding : 24;
+  u32 vertex_stereo : 1;  // The vertex shader writes the layer, see vertex_shader_uid_data
+  u32 padding : 23;
 };
 
 #pragma pack()
@@ -0,0 +1,164 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+#include "VideoCommon/HiresTexturePack.h"
+
+namespace
+{
+constexpr u32 PACK_MAGIC = 0x31505448;  // "HTP1"
+constexpr u32 PACK_VERSION = 1;
+// Texture data is aligned, so levels can be handed to the backends as is.
+constexpr u64 DATA_ALIGNMENT = 16;
+
+struct PackHeader
+{
+  u32 magic;
+  u32 version;
+  u32 entry_count;
+  u32 reserved;
+  u64 index_offset;
+};
+
+static_assert(std::is_trivially_copyable<HiresTexturePack::Entry>::value,
+              "Entry is written to disk as is");
+static_assert(sizeof(HiresTexturePack::Entry) == 32, "Entry must not contain implicit padding");
+}  // Anonymous namespace
+
+std::string HiresTexturePack::GetPackPath(const std::string& game_id)
+{
+  return File::GetUserPath(D_HIRESTEXTURES_IDX) + game_id + ".htp";
+}
+
+bool HiresTexturePack::Open(const std::string& filename)
+{
+  Close();
+  if (m_mapping.Open(filename))
+    m_mapping.SetAccessPattern(File::MappedFile::AccessPattern::Random);
+  else if (!m_file.Open(filename, "rb"))
+    return false;
+
+  const u64 file_size = m_mapping.IsOpen() ? m_mapping.GetSize() : m_file.GetSize();
+  PackHeader header;
+  if (!ReadAt(0, sizeof(header), reinterpret_cast<u8*>(&header)) || header.magic != PACK_MAGIC ||
+      header.version != PACK_VERSION || header.index_offset > file_size)
+  {
+    ERROR_LOG(VIDEO, "Invalid custom texture pack %s", filename.c_str());
+    Close();
+    return false;
+  }
+
+  // The index is read in one go and parsed from memory
+  std::vector<u8> index(file_size - header.index_offset);
+  if (!ReadAt(header.index_offset, index.size(), index.data()))
+    index.clear();
+
+  size_t position = 0;
+  m_entries.reserve(header.entry_count);
+  for (u32 i = 0; i < header.entry_count; i++)
+  {
+    Entry entry;
+    u16 name_length;
+    if (index.size() - position < sizeof(entry) + sizeof(name_length))
+      break;
+    std::memcpy(&entry, &index[position], sizeof(entry));
+    std::memcpy(&name_length, &index[position + sizeof(entry)], sizeof(name_length));
+    position += sizeof(entry) + sizeof(name_length);
+    if (index.size() - position < name_length || entry.offset + entry.size > file_size)
+      break;
+    std::string basename(reinterpret_cast<const char*>(&index[position]), name_length);
+    position += name_length;
+    m_entries.emplace(std::move(basename), entry);
+  }
+
+  if (m_entries.size() != header.entry_count)
+  {
+    ERROR_LOG(VIDEO, "Custom texture pack %s is truncated", filename.c_str());
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void HiresTexturePack::Close()
+{
+  m_mapping.Close();
+  m_file.Close();
+  m_entries.clear();
+}
+
+const HiresTexturePack::Entry* HiresTexturePack::Find(const std::string& basename) const
+{
+  auto iter = m_entries.find(basename);
+  return iter != m_entries.end() ? &iter->second : nullptr;
+}
+
+bool HiresTexturePack::Read(const Entry& entry, u8* dst)
+{
+  return ReadAt(entry.offset, entry.size, dst);
+}
+
+bool HiresTexturePack::ReadAt(u64 offset, u64 size, u8* dst)
+{
+  if (m_mapping.IsOpen())
+    return m_mapping.Read(offset, size, dst);
+  if (!m_file.Seek(offset, SEEK_SET) || !m_file.ReadBytes(dst, size))
+  {
+    m_file.Clear();
+    return false;
+  }
+  return true;
+}
+
+bool HiresTexturePack::Writer::Begin(const std::string& filename)
+{
+  m_entries.clear();
+  File::CreateFullPath(filename);
+  if (!m_file.Open(filename, "wb"))
+    return false;
+  // Filled in by Finish()
+  const PackHeader header = {};
+  return m_file.WriteArray(&header, 1);
+}
+
+bool HiresTexturePack::Writer::Add(const std::string& basename, Entry entry, const u8* data)
+{
+  static const u8 padding[DATA_ALIGNMENT] = {};
+  const u64 position = m_file.Tell();
+  const u64 aligned = (position + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+  if (!m_file.WriteBytes(padding, aligned - position) || !m_file.WriteBytes(data, entry.size))
+    return false;
+  entry.offset = aligned;
+  m_entries.emplace_back(basename, entry);
+  return true;
+}
+
+bool HiresTexturePack::Writer::Finish()
+{
+  PackHeader header = {};
+  header.magic = PACK_MAGIC;
+  header.version = PACK_VERSION;
+  header.entry_count = static_cast<u32>(m_entries.size());
+  header.index_offset = m_file.Tell();
+  for (const auto& item : m_entries)
+  {
+    const u16 name_length = static_cast<u16>(item.first.size());
+    m_file.WriteArray(&item.second, 1);
+    m_file.WriteArray(&name_length, 1);
+    m_file.WriteBytes(item.first.data(), name_length);
+  }
+  m_file.Seek(0, SEEK_SET);
+  m_file.WriteArray(&header, 1);
+  const bool success = m_file.IsGood();
+  m_file.Close();
+  m_entries.clear();
+  return success;
+}
@@ -0,0 +1,70 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/MappedFile.h"
+
+// Single file container for custom textures, Load/Textures/<GameID>.htp.
+// Every texture is stored the way HiresTexture hands it to the texture cache: all levels of the
+// color map followed by the levels of the optional normal and emissive maps, already decoded to
+// the host texture format. The index sits at the end of the file and is read when the pack is
+// opened, the texture data itself is only read when a texture is requested.
+// The pack is mapped where possible. Its pages then live in the OS file cache only, so several
+// emulator instances using the same pack share them instead of each reading its own copy.
+class HiresTexturePack
+{
+public:
+  struct Entry
+  {
+    u64 offset;
+    u32 size;
+    u32 format;  // HostTextureFormat
+    u32 width;
+    u32 height;
+    u16 levels;
+    u16 nrm_levels;
+    u16 lum_levels;
+    u16 has_arbitrary_mips;
+  };
+
+  static std::string GetPackPath(const std::string& game_id);
+
+  bool Open(const std::string& filename);
+  void Close();
+  bool IsOpen() const { return m_mapping.IsOpen() || m_file.IsOpen(); }
+  size_t GetEntryCount() const { return m_entries.size(); }
+
+  const Entry* Find(const std::string& basename) const;
+  const std::unordered_map<std::string, Entry>& GetEntries() const { return m_entries; }
+  // Reads the texture data of entry to dst, which must hold entry.size bytes.
+  bool Read(const Entry& entry, u8* dst);
+
+  // Builds a new pack. Textures are appended as they come, the index is written by Finish().
+  class Writer
+  {
+  public:
+    bool Begin(const std::string& filename);
+    bool Add(const std::string& basename, Entry entry, const u8* data);
+    bool Finish();
+
+  private:
+    File::IOFile m_file;
+    std::vector<std::pair<std::string, Entry>> m_entries;
+  };
+
+private:
+  bool ReadAt(u64 offset, u64 size, u8* dst);
+
+  File::MappedFile m_mapping;
+  // Only used when the pack can't be mapped
+  File::IOFile m_file;
+  std::unordered_map<std::string, Entry> m_entries;
+};
@@ -4,7 +4,10 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -25,12 +28,14 @@
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
 #include "Common/Thread.h"
+#include "Common/ThreadPool.h"
 #include "Common/Timer.h"
 
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Host.h"
 
+#include "VideoCommon/HiresTexturePack.h"
 #include "VideoCommon/HiresTextures.h"
 #include "VideoCommon/ImageLoader.h"
 #include "VideoCommon/OnScreenDisplay.h"
@@ -114,16 +119,195 @@ static Common::Flag s_textureCacheAbortLoading;
 static std::atomic<size_t> size_sum;
 static size_t max_mem = 0;
 static std::thread s_prefetcher;
+// Only accessed from the video thread, or by BuildPack() while no game is running
+static HiresTexturePack s_pack;
+static bool s_building_pack = false;
+// Material maps generated by BuildMaterialMaps(). Read by the loading threads as well.
+static HiresTexturePack s_material_cache;
+static std::mutex s_material_cache_mutex;
+// Bump when BuildMaterial changes, maps generated by an older version are ignored.
+constexpr u64 MATERIAL_GENERATOR_VERSION = 1;
+
+// Streaming: textures are loaded by pool threads when they are first requested and the least
+// recently used ones are dropped once the memory budget is exceeded. Everything below is guarded
+// by s_textureCacheMutex.
+struct StreamedTexture
+{
+  std::string basename;
+  u64 last_used_frame;
+};
+// Textures used in this many recent frames are never evicted, and requests that were not repeated
+// for as long are no longer worth loading.
+constexpr u64 STREAM_WORKING_SET_FRAMES = 60;
+static size_t s_memory_budget = 0;
+static u64 s_frame = 0;
+// Most recently used at the front
+static std::list<StreamedTexture> s_lru;
+static std::unordered_map<std::string, std::list<StreamedTexture>::iterator> s_lru_index;
+// Most recent request at the front, with the frame each one was last requested in
+static std::deque<std::string> s_stream_queue;
+static std::unordered_map<std::string, u64> s_stream_requests;
+static size_t s_stream_workers = 0;
+static std::condition_variable s_stream_workers_done;
+static bool s_stream_loaded = false;
+static std::atomic<u64> s_stream_generation{1};
 
 static const std::string s_format_prefix = "tex1_";
 static const std::string s_enviroment_prefix = "env_";
 
+// Binary form of a custom texture name, tex1_<width>x<height>[_m]_<hash>[_<tlut hash>|_$]_<format>
+// GenBaseName looks textures up by it, so a cache miss doesn't have to build any strings.
+struct TextureKey
+{
+  enum class Tlut : u8
+  {
+    None,
+    Hash,
+    Wildcard
+  };
+
+  u64 tex_hash;
+  u64 tlut_hash;
+  u32 width;
+  u32 height;
+  s32 format;
+  bool has_mipmaps;
+  Tlut tlut;
+
+  bool operator==(const TextureKey& other) const
+  {
+    return tex_hash == other.tex_hash && tlut_hash == other.tlut_hash && width == other.width &&
+           height == other.height && format == other.format &&
+           has_mipmaps == other.has_mipmaps && tlut == other.tlut;
+  }
+};
+
+struct TextureKeyHash
+{
+  size_t operator()(const TextureKey& key) const
+  {
+    // The texture hash is already well distributed.
+    return static_cast<size_t>(key.tex_hash ^ (key.tlut_hash * 31) ^
+                               (u64(key.width) << 48 | u64(key.height) << 32 |
+                                u32(key.format) << 8 | u32(key.has_mipmaps) << 2 |
+                                u32(key.tlut)));
+  }
+};
+
+// Names of all textures in s_textureMap and s_pack, rebuilt by Update()
+static std::unordered_map<TextureKey, std::string, TextureKeyHash> s_texture_keys;
+
+static std::string GetTextureName(const TextureKey& key)
+{
+  std::string name = s_format_prefix + StringFromFormat("%dx%d%s_%016" PRIx64, key.width,
+                                                        key.height, key.has_mipmaps ? "_m" : "",
+                                                        key.tex_hash);
+  if (key.tlut == TextureKey::Tlut::Hash)
+    name += StringFromFormat("_%016" PRIx64, key.tlut_hash);
+  else if (key.tlut == TextureKey::Tlut::Wildcard)
+    name += "_$";
+  return name + StringFromFormat("_%d", key.format);
+}
+
+static bool ParseHash(const std::string& str, u64* hash)
+{
+  if (str.size() != 16)
+    return false;
+  *hash = 0;
+  for (char c : str)
+  {
+    if (c >= '0' && c <= '9')
+      *hash = (*hash << 4) | u64(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      *hash = (*hash << 4) | u64(c - 'a' + 10);
+    else
+      return false;
+  }
+  return true;
+}
+
+static bool ParseTextureName(const std::string& name, TextureKey* key)
+{
+  const std::vector<std::string> parts = SplitString(name, '_');
+  size_t i = 1;
+  if (parts.size() < 4 || sscanf(parts[i++].c_str(), "%ux%u", &key->width, &key->height) != 2)
+    return false;
+  key->has_mipmaps = parts[i] == "m";
+  if (key->has_mipmaps)
+    i++;
+  if (i >= parts.size() || !ParseHash(parts[i++], &key->tex_hash))
+    return false;
+  key->tlut_hash = 0;
+  key->tlut = TextureKey::Tlut::None;
+  if (parts.size() - i == 2)
+  {
+    if (parts[i] == "$")
+      key->tlut = TextureKey::Tlut::Wildcard;
+    else if (ParseHash(parts[i], &key->tlut_hash))
+      key->tlut = TextureKey::Tlut::Hash;
+    else
+      return false;
+    i++;
+  }
+  if (parts.size() - i != 1 || sscanf(parts[i].c_str(), "%d", &key->format) != 1)
+    return false;
+  // Only names GenBaseName can produce are reachable.
+  return GetTextureName(*key) == name;
+}
+
+static void AddTextureKey(const std::string& name)
+{
+  TextureKey key;
+  if (ParseTextureName(name, &key))
+    s_texture_keys.emplace(key, name);
+}
+
 HiresTexture::HiresTexture()
     : m_format(PC_TEX_FMT_NONE), m_height(0), m_levels(0), m_nrm_levels(0), m_lum_levels(0),
       m_cached_data(nullptr), m_cached_data_size(0)
 {
 }
 
+static void StopStreaming()
+{
+  std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+  s_stream_queue.clear();
+  s_stream_requests.clear();
+  s_stream_workers_done.wait(lk, [] { return s_stream_workers == 0; });
+}
+
+static void ClearStreamedTextures()
+{
+  std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+  s_lru.clear();
+  s_lru_index.clear();
+}
+
+static void TouchStreamedTexture(const std::string& basename)
+{
+  auto iter = s_lru_index.find(basename);
+  if (iter == s_lru_index.end())
+    return;
+  iter->second->last_used_frame = s_frame;
+  s_lru.splice(s_lru.begin(), s_lru, iter->second);
+}
+
+static void EvictStreamedTextures()
+{
+  while (size_sum.load() > s_memory_budget && !s_lru.empty() &&
+         s_lru.back().last_used_frame + STREAM_WORKING_SET_FRAMES < s_frame)
+  {
+    auto iter = s_textureCache.find(s_lru.back().basename);
+    if (iter != s_textureCache.end())
+    {
+      size_sum.fetch_sub(iter->second->m_cached_data_size);
+      s_textureCache.erase(iter);
+    }
+    s_lru_index.erase(s_lru.back().basename);
+    s_lru.pop_back();
+  }
+}
+
 void HiresTexture::Init()
 {
   size_sum.store(0);
@@ -141,9 +325,14 @@ void HiresTexture::Shutdown()
     s_textureCacheAbortLoading.Set();
     s_prefetcher.join();
   }
+  StopStreaming();
+  ClearStreamedTextures();
   s_textureMap.clear();
+  s_texture_keys.clear();
   s_enviromentMap.clear();
   s_textureCache.clear();
+  s_pack.Close();
+  s_material_cache.Close();
 }
 
 std::set<std::string> HiresTexture::GetTextureDirectory(const std::string& game_id)
@@ -306,7 +495,33 @@ void HiresTexture::ProccessTexture(const std::string& fileitem, std::string& fil
     {
       dst.resize(min_item_size);
     }
-    dst[level] = mip_level_detail;
+    // Prefer the DDS version of a level, it goes to the GPU without being decoded
+    if (mip_level_detail.is_compressed || !dst[level].is_compressed)
+      dst[level] = mip_level_detail;
+  }
+}
+
+void HiresTexture::ProccessDirectory(const std::string& directory,
+                                     const std::vector<std::string>& extensions,
+                                     const bool BuildMaterialMaps)
+{
+  std::vector<std::string> filenames =
+      Common::DoFileSearch({directory}, extensions, /*recursive*/ true);
+
+  for (const std::string& fileitem : filenames)
+  {
+    std::string filename;
+    std::string extension;
+    SplitPath(fileitem, nullptr, &filename, &extension);
+    if (filename.rfind(s_format_prefix, 0) == 0)
+    {
+      ProccessTexture(fileitem, filename, extension, BuildMaterialMaps);
+    }
+    else if (filename.rfind(s_enviroment_prefix, 0) == 0)
+    {
+      filename = filename.substr(s_enviroment_prefix.length());
+      ProccessEnviroment(fileitem, filename, extension);
+    }
   }
 }
 
@@ -318,10 +533,18 @@ void HiresTexture::Update()
     s_textureCacheAbortLoading.Set();
     s_prefetcher.join();
   }
+  StopStreaming();
+  ClearStreamedTextures();
+  s_memory_budget = g_ActiveConfig.iHiresTexturesMemoryBudget > 0 ?
+                        size_t(g_ActiveConfig.iHiresTexturesMemoryBudget) * 1024 * 1024 :
+                        max_mem;
 
   if (!g_ActiveConfig.bHiresTextures)
   {
+    s_pack.Close();
+  s_material_cache.Close();
     s_textureMap.clear();
+    s_texture_keys.clear();
     s_enviromentMap.clear();
     s_textureCache.clear();
     s_enviromentCache.clear();
@@ -329,7 +552,7 @@ void HiresTexture::Update()
     return;
   }
 
-  if (!g_ActiveConfig.bCacheHiresTextures)
+  if (!g_ActiveConfig.bCacheHiresTextures || g_ActiveConfig.bStreamHiresTextures)
   {
     s_textureCache.clear();
     s_enviromentCache.clear();
@@ -338,8 +561,9 @@ void HiresTexture::Update()
 
   s_textureMap.clear();
   s_enviromentMap.clear();
+  s_pack.Close();
+  s_material_cache.Close();
   const std::string& game_id = SConfig::GetInstance().GetGameID();
-  const std::set<std::string> texture_directories = GetTextureDirectory(game_id);
   const std::string resource_directory = File::GetSysDirectory() + RESOURCES_DIR DIR_SEP;
   std::vector<std::string> Extensions;
   Extensions.push_back(".png");
@@ -348,48 +572,31 @@ void HiresTexture::Update()
     Extensions.push_back(".dds");
   }
 
-  std::vector<std::string> Resourcefilenames =
-      Common::DoFileSearch({resource_directory}, Extensions, /*recursive*/ true);
+  ProccessDirectory(resource_directory, Extensions, BuildMaterialMaps);
 
-  for (const std::string& fileitem : Resourcefilenames)
+  // A texture pack replaces the texture directories of the game
+  if (s_pack.Open(HiresTexturePack::GetPackPath(game_id)) ||
+      s_pack.Open(HiresTexturePack::GetPackPath(game_id.substr(0, 3))))
   {
-    std::string filename;
-    std::string extension;
-    SplitPath(fileitem, nullptr, &filename, &extension);
-    if (filename.rfind(s_format_prefix, 0) == 0)
-    {
-      ProccessTexture(fileitem, filename, extension, BuildMaterialMaps);
-    }
-    else if (filename.rfind(s_enviroment_prefix, 0) == 0)
-    {
-      filename = filename.substr(s_enviroment_prefix.length());
-      ProccessEnviroment(fileitem, filename, extension);
-    }
+    INFO_LOG(VIDEO, "Using %zu custom textures from the texture pack", s_pack.GetEntryCount());
   }
-
-  for (const auto& texture_directory : texture_directories)
+  else
   {
-    std::vector<std::string> filenames =
-        Common::DoFileSearch({texture_directory}, Extensions, /*recursive*/ true);
-
-    for (const std::string& fileitem : filenames)
-    {
-      std::string filename;
-      std::string extension;
-      SplitPath(fileitem, nullptr, &filename, &extension);
-      if (filename.rfind(s_format_prefix, 0) == 0)
-      {
-        ProccessTexture(fileitem, filename, extension, BuildMaterialMaps);
-      }
-      else if (filename.rfind(s_enviroment_prefix, 0) == 0)
-      {
-        filename = filename.substr(s_enviroment_prefix.length());
-        ProccessEnviroment(fileitem, filename, extension);
-      }
-    }
+    for (const auto& texture_directory : GetTextureDirectory(game_id))
+      ProccessDirectory(texture_directory, Extensions, BuildMaterialMaps);
+  }
+  s_texture_keys.clear();
+  for (const auto& entry : s_textureMap)
+    AddTextureKey(entry.first);
+  for (const auto& entry : s_pack.GetEntries())
+    AddTextureKey(entry.first);
+  if (BuildMaterialMaps && s_material_cache.Open(GetMaterialCachePath(game_id)))
+  {
+    INFO_LOG(VIDEO, "Using %zu generated material maps", s_material_cache.GetEntryCount());
   }
 
-  if (g_ActiveConfig.bCacheHiresTextures && s_textureMap.size() > 0)
+  if (g_ActiveConfig.bCacheHiresTextures && !g_ActiveConfig.bStreamHiresTextures &&
+      s_textureMap.size() > 0)
   {
     // remove cached but deleted textures
     auto iter = s_textureCache.begin();
@@ -428,6 +635,63 @@ void HiresTexture::Update()
   }
 }
 
+void HiresTexture::StreamTextures()
+{
+  std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+  while (!s_stream_queue.empty())
+  {
+    const std::string basename = std::move(s_stream_queue.front());
+    s_stream_queue.pop_front();
+    auto request = s_stream_requests.find(basename);
+    if (request == s_stream_requests.end())
+      continue;
+    // Not used anymore since it was requested
+    if (request->second + STREAM_WORKING_SET_FRAMES < s_frame)
+    {
+      s_stream_requests.erase(request);
+      continue;
+    }
+
+    lk.unlock();
+    HiresTexture* ptr =
+        Load(basename, [](size_t requested_size) { return new u8[requested_size]; }, true);
+    lk.lock();
+    // The request is gone if streaming was stopped in the meantime
+    if (!s_stream_requests.erase(basename))
+    {
+      delete ptr;
+      continue;
+    }
+    if (ptr == nullptr)
+      continue;
+
+    size_sum.fetch_add(ptr->m_cached_data_size);
+    s_textureCache[basename] = std::shared_ptr<HiresTexture>(ptr);
+    s_lru.push_front({basename, s_frame});
+    s_lru_index[basename] = s_lru.begin();
+    s_stream_loaded = true;
+    EvictStreamedTextures();
+  }
+  s_stream_workers--;
+  s_stream_workers_done.notify_all();
+}
+
+void HiresTexture::NewFrame()
+{
+  std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+  s_frame++;
+  if (s_stream_loaded)
+  {
+    s_stream_loaded = false;
+    s_stream_generation++;
+  }
+}
+
+u64 HiresTexture::GetStreamGeneration()
+{
+  return s_stream_generation.load();
+}
+
 void HiresTexture::Prefetch()
 {
   Common::SetCurrentThreadName("Prefetcher");
@@ -465,7 +729,7 @@ void HiresTexture::Prefetch()
       return;
     }
 
-    if (size_sum.load() > max_mem)
+    if (size_sum.load() > s_memory_budget)
     {
       Config::SetCurrent(Config::GFX_HIRES_TEXTURES, false);
 
@@ -529,7 +793,7 @@ void HiresTexture::Prefetch()
       return;
     }
 
-    if (size_sum.load() > max_mem)
+    if (size_sum.load() > s_memory_budget)
     {
       Config::SetCurrent(Config::GFX_HIRES_TEXTURES, false);
 
@@ -577,8 +841,6 @@ std::string HiresTexture::GenBaseName(const u8* texture, size_t texture_size, co
                                       size_t tlut_size, u32 width, u32 height, int format,
                                       bool has_mipmaps, bool dump)
 {
-  std::string name = "";
-  HiresTextureCache::iterator convert_iter;
   // checking for min/max on paletted textures
   u32 min = 0xffff;
   u32 max = 0;
@@ -615,25 +877,29 @@ std::string HiresTexture::GenBaseName(const u8* texture, size_t texture_size, co
     tlut_size = 2 * (max + 1 - min);
     tlut += 2 * min;
   }
-  u64 tex_hash = XXH64(texture, texture_size, 0);
-  u64 tlut_hash = 0;
-  if (tlut_size)
-    tlut_hash = XXH64(tlut, tlut_size, 0);
-  std::string basename = s_format_prefix + StringFromFormat("%dx%d%s_%016" PRIx64, width, height,
-                                                            has_mipmaps ? "_m" : "", tex_hash);
-  std::string tlutname = tlut_size ? StringFromFormat("_%016" PRIx64, tlut_hash) : "";
-  std::string formatname = StringFromFormat("_%d", format);
-  std::string fullname = basename + tlutname + formatname;
-  std::string wildcardname = basename + "_$" + formatname;
-
-  if (!dump && s_textureMap.find(wildcardname) != s_textureMap.end())
-    return wildcardname;
-
-    // else generate the complete texture
-  if (dump || s_textureMap.find(fullname) != s_textureMap.end())
-    return fullname;
-
-  return "";
+  TextureKey key;
+  key.tex_hash = XXH64(texture, texture_size, 0);
+  key.width = width;
+  key.height = height;
+  key.format = format;
+  key.has_mipmaps = has_mipmaps;
+
+  if (!dump)
+  {
+    key.tlut_hash = 0;
+    key.tlut = TextureKey::Tlut::Wildcard;
+    auto iter = s_texture_keys.find(key);
+    if (iter != s_texture_keys.end())
+      return iter->second;
+  }
+
+  // else generate the complete texture
+  key.tlut_hash = tlut_size ? XXH64(tlut, tlut_size, 0) : 0;
+  key.tlut = tlut_size ? TextureKey::Tlut::Hash : TextureKey::Tlut::None;
+  if (dump)
+    return GetTextureName(key);
+  auto iter = s_texture_keys.find(key);
+  return iter != s_texture_keys.end() ? iter->second : std::string();
 }
 
 inline u8* LoadImageFromFile(const char* path, int& width, int& height)
@@ -748,10 +1014,113 @@ inline void BuildMaterial(const HiresTextureCacheItem& item, ImageLoaderParams&
   }
 }
 
+std::string HiresTexture::GetMaterialCachePath(const std::string& game_id)
+{
+  return File::GetUserPath(D_HIRESTEXTURES_IDX) + game_id + ".mat.htp";
+}
+
+// Generated maps are stored under the texture name and a hash of the maps they are built from,
+// so editing one of the source textures invalidates the generated map.
+static std::string GetMaterialCacheName(const std::string& basename,
+                                        const HiresTextureCacheItem& item)
+{
+  u64 hash = MATERIAL_GENERATOR_VERSION;
+  std::string data;
+  for (size_t map_index : {MapType::normal, MapType::bump, MapType::specular})
+  {
+    const u64 levels = item.maps[map_index].size();
+    hash = XXH64(&levels, sizeof(levels), hash);
+    for (const hires_mip_level& level : item.maps[map_index])
+    {
+      data.clear();
+      if (!level.path.empty())
+        File::ReadFileToString(level.path, data);
+      hash = XXH64(data.data(), data.size(), hash);
+    }
+  }
+  return basename + StringFromFormat("_%016" PRIx64, hash);
+}
+
+static bool ReadCachedMaterial(const std::string& basename, const HiresTextureCacheItem& item,
+                               const HiresTexture& texture, u8* dst, size_t dst_size,
+                               u32* levels, size_t* size)
+{
+  if (!s_material_cache.IsOpen())
+    return false;
+  const HiresTexturePack::Entry* entry =
+      s_material_cache.Find(GetMaterialCacheName(basename, item));
+  if (!entry || entry->width != texture.m_width || entry->height != texture.m_height ||
+      entry->format != texture.m_format || entry->size > dst_size)
+  {
+    return false;
+  }
+  std::lock_guard<std::mutex> lk(s_material_cache_mutex);
+  if (!s_material_cache.Read(*entry, dst))
+    return false;
+  *levels = entry->levels;
+  *size = entry->size;
+  return true;
+}
+
 std::shared_ptr<HiresTexture>
 HiresTexture::Search(const std::string& basename,
-                     std::function<u8*(size_t)> request_buffer_delegate)
+                     std::function<u8*(size_t)> request_buffer_delegate, bool* pending)
 {
+  // GenBaseName found no custom texture
+  if (basename.empty())
+    return nullptr;
+
+  // Pack entries are read straight into the upload buffer, the OS file cache keeps them warm.
+  if (const HiresTexturePack::Entry* entry = s_pack.Find(basename))
+  {
+    if (!s_pack.Read(*entry, request_buffer_delegate(entry->size)))
+    {
+      ERROR_LOG(VIDEO, "Failed to read custom texture %s from the texture pack", basename.c_str());
+      return nullptr;
+    }
+    std::shared_ptr<HiresTexture> ret(new HiresTexture());
+    ret->m_format = static_cast<HostTextureFormat>(entry->format);
+    ret->m_width = entry->width;
+    ret->m_height = entry->height;
+    ret->m_levels = entry->levels;
+    ret->m_nrm_levels = entry->nrm_levels;
+    ret->m_lum_levels = entry->lum_levels;
+    ret->has_arbitrary_mips = entry->has_arbitrary_mips != 0;
+    return ret;
+  }
+
+  if (g_ActiveConfig.bStreamHiresTextures)
+  {
+    std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+    auto iter = s_textureCache.find(basename);
+    if (iter != s_textureCache.end())
+    {
+      TouchStreamedTexture(basename);
+      HiresTexture* current = iter->second.get();
+      u8* dst = request_buffer_delegate(current->m_cached_data_size);
+      memcpy(dst, current->m_cached_data.get(), current->m_cached_data_size);
+      return iter->second;
+    }
+    if (s_textureMap.find(basename) == s_textureMap.end())
+      return nullptr;
+
+    if (pending)
+      *pending = true;
+    auto request = s_stream_requests.emplace(basename, s_frame);
+    if (!request.second)
+    {
+      request.first->second = s_frame;
+      return nullptr;
+    }
+    s_stream_queue.push_front(basename);
+    if (s_stream_workers < std::max<size_t>(Common::ThreadPool::GetThreadCount() / 2, 1))
+    {
+      s_stream_workers++;
+      Common::AsyncWorker::ExecuteAsync(StreamTextures);
+    }
+    return nullptr;
+  }
+
   if (g_ActiveConfig.bCacheHiresTextures)
   {
     std::unique_lock<std::mutex> lk(s_textureCacheMutex);
@@ -765,7 +1134,7 @@ HiresTexture::Search(const std::string& basename,
       return iter->second;
     }
     lk.unlock();
-    if (size_sum.load() < max_mem)
+    if (size_sum.load() < s_memory_budget)
     {
       std::shared_ptr<HiresTexture> ptr(Load(
           basename, [](size_t requested_size) { return new u8[requested_size]; }, true));
@@ -815,7 +1184,7 @@ HiresTexture::SearchEnviroment(const std::string& basename,
       return iter->second;
     }
     lk.unlock();
-    if (size_sum.load() < max_mem)
+    if (size_sum.load() < s_memory_budget)
     {
       std::shared_ptr<HiresTexture> ptr(LoadEnviroment(
           basename, [](size_t requested_size) { return new u8[requested_size]; }, true));
@@ -917,12 +1286,13 @@ HiresTexture* HiresTexture::Load(const std::string& basename,
           MapType::normal :
           MapType::material;
   size_t emissive_index = MapType::emissive;
+  // Packs keep the material maps, whether they are used is decided when the pack is loaded.
+  const bool material_maps = g_ActiveConfig.HiresMaterialMapsEnabled() || s_building_pack;
   bool nrm_posible =
       current.maps[MapType::color].size() == current.maps[material_mat_index].size() &&
-      g_ActiveConfig.HiresMaterialMapsEnabled();
+      material_maps;
   bool emissive_posible =
-      current.maps[MapType::color].size() == current.maps[emissive_index].size() &&
-      g_ActiveConfig.HiresMaterialMapsEnabled();
+      current.maps[MapType::color].size() == current.maps[emissive_index].size() && material_maps;
   size_t remaining_buffer_size = 0;
   size_t total_buffer_size = 0;
   std::function<u8*(size_t, bool)> first_level_function = [&](size_t requiredsize,
@@ -1020,7 +1390,18 @@ HiresTexture* HiresTexture::Load(const std::string& basename,
     maxwidth = std::max(maxwidth >> 1, 1u);
     maxheight = std::max(maxheight >> 1, 1u);
   }
-  if (nrm_posible)
+  u32 cached_levels = 0;
+  size_t cached_size = 0;
+  if (nrm_posible && ret != nullptr && g_ActiveConfig.bHiresMaterialMapsBuild &&
+      !s_building_pack &&
+      ReadCachedMaterial(basename, current, *ret, buffer_pointer, remaining_buffer_size,
+                         &cached_levels, &cached_size))
+  {
+    ret->m_nrm_levels = cached_levels;
+    buffer_pointer += cached_size;
+    remaining_buffer_size -= cached_size;
+  }
+  else if (nrm_posible)
   {
     for (size_t level = 0; level < current.maps[material_mat_index].size(); level++)
     {
@@ -1033,7 +1414,8 @@ HiresTexture* HiresTexture::Load(const std::string& basename,
         // don't give support to mixed formats
         break;
       }
-      if (g_ActiveConfig.bHiresMaterialMapsBuild && imgInfo.resultTex == PC_TEX_FMT_RGBA32)
+      if (g_ActiveConfig.bHiresMaterialMapsBuild && !s_building_pack &&
+          imgInfo.resultTex == PC_TEX_FMT_RGBA32)
       {
         BuildMaterial(current, imgInfo, level);
       }
@@ -1274,3 +1656,177 @@ HiresTexture* HiresTexture::LoadEnviroment(const std::string& basename,
   }
   return ret;
 }
+
+bool HiresTexture::BuildPack(const std::string& game_id,
+                             std::function<bool(size_t done, size_t total)> progress)
+{
+  s_textureMap.clear();
+  s_enviromentMap.clear();
+  for (const auto& texture_directory : GetTextureDirectory(game_id))
+    ProccessDirectory(texture_directory, {".png", ".dds"}, false);
+  // Enviroment maps are few and stay in the texture directories
+  s_enviromentMap.clear();
+  if (s_textureMap.empty())
+    return false;
+
+  const std::string filename = HiresTexturePack::GetPackPath(game_id);
+  const std::string temp_filename = filename + ".tmp";
+  HiresTexturePack::Writer writer;
+  if (!writer.Begin(temp_filename))
+  {
+    s_textureMap.clear();
+    return false;
+  }
+
+  s_building_pack = true;
+  bool success = true;
+  size_t done = 0;
+  std::vector<u8> buffer;
+  for (const auto& item : s_textureMap)
+  {
+    if (!progress(done++, s_textureMap.size()))
+    {
+      success = false;
+      break;
+    }
+    std::unique_ptr<HiresTexture> texture(Load(item.first,
+                                               [&buffer](size_t requested_size) {
+                                                 buffer.resize(requested_size);
+                                                 return buffer.data();
+                                               },
+                                               false));
+    if (!texture)
+    {
+      WARN_LOG(VIDEO, "Skipping custom texture %s", item.first.c_str());
+      continue;
+    }
+
+    size_t layer_size = 0;
+    for (u32 level = 0; level < texture->m_levels; level++)
+    {
+      layer_size += TextureUtil::GetTextureSizeInBytes(
+          TextureUtil::CalculateLevelSize(texture->m_width, level),
+          TextureUtil::CalculateLevelSize(texture->m_height, level), texture->m_format);
+    }
+    const size_t layers = 1 + (texture->m_nrm_levels ? 1 : 0) + (texture->m_lum_levels ? 1 : 0);
+    HiresTexturePack::Entry entry = {};
+    entry.size = static_cast<u32>(layer_size * layers);
+    entry.format = texture->m_format;
+    entry.width = texture->m_width;
+    entry.height = texture->m_height;
+    entry.levels = static_cast<u16>(texture->m_levels);
+    entry.nrm_levels = static_cast<u16>(texture->m_nrm_levels);
+    entry.lum_levels = static_cast<u16>(texture->m_lum_levels);
+    entry.has_arbitrary_mips = texture->has_arbitrary_mips;
+    if (entry.size > buffer.size() || !writer.Add(item.first, entry, buffer.data()))
+    {
+      success = false;
+      break;
+    }
+  }
+  s_building_pack = false;
+  s_textureMap.clear();
+
+  success = writer.Finish() && success;
+  if (success)
+  {
+    File::Delete(filename);
+    success = File::Rename(temp_filename, filename);
+  }
+  if (!success)
+    File::Delete(temp_filename);
+  return success;
+}
+
+bool HiresTexture::BuildMaterialMaps(const std::string& game_id,
+                                     std::function<bool(size_t done, size_t total)> progress)
+{
+  s_textureMap.clear();
+  s_enviromentMap.clear();
+  for (const auto& texture_directory : GetTextureDirectory(game_id))
+    ProccessDirectory(texture_directory, {".png"}, true);
+  s_enviromentMap.clear();
+
+  std::vector<const std::pair<const std::string, HiresTextureCacheItem>*> items;
+  for (const auto& item : s_textureMap)
+  {
+    if (!item.second.maps[MapType::normal].empty())
+      items.push_back(&item);
+  }
+  if (items.empty())
+  {
+    s_textureMap.clear();
+    return false;
+  }
+
+  const std::string filename = GetMaterialCachePath(game_id);
+  const std::string temp_filename = filename + ".tmp";
+  HiresTexturePack::Writer writer;
+  if (!writer.Begin(temp_filename))
+  {
+    s_textureMap.clear();
+    return false;
+  }
+
+  bool success = true;
+  size_t done = 0;
+  std::vector<u8> buffer;
+  for (const auto* item : items)
+  {
+    if (!progress(done++, items.size()))
+    {
+      success = false;
+      break;
+    }
+    const HiresTextureCacheItem& current = item->second;
+    buffer.clear();
+    HiresTexturePack::Entry entry = {};
+    entry.format = PC_TEX_FMT_RGBA32;
+    for (size_t level = 0; level < current.maps[MapType::normal].size(); level++)
+    {
+      const size_t offset = buffer.size();
+      ImageLoaderParams imgInfo = LoadMipLevel(current.maps[MapType::normal][level],
+                                               [&buffer, offset](size_t requiredsize, bool) {
+                                                 buffer.resize(offset + requiredsize);
+                                                 return buffer.data() + offset;
+                                               },
+                                               false);
+      if (level == 0)
+      {
+        entry.width = imgInfo.Width;
+        entry.height = imgInfo.Height;
+      }
+      if (imgInfo.dst == nullptr || imgInfo.resultTex != PC_TEX_FMT_RGBA32 ||
+          imgInfo.Width != TextureUtil::CalculateLevelSize(entry.width, static_cast<u32>(level)) ||
+          imgInfo.Height != TextureUtil::CalculateLevelSize(entry.height, static_cast<u32>(level)))
+      {
+        buffer.resize(offset);
+        break;
+      }
+      BuildMaterial(current, imgInfo, level);
+      entry.levels++;
+    }
+    if (entry.levels == 0)
+    {
+      WARN_LOG(VIDEO, "Skipping material map of custom texture %s", item->first.c_str());
+      continue;
+    }
+    entry.size = static_cast<u32>(buffer.size());
+    if (!writer.Add(GetMaterialCacheName(item->first, current), entry, buffer.data()))
+    {
+      success = false;
+      break;
+    }
+  }
+  s_textureMap.clear();
+
+  success = writer.Finish() && success;
+  if (success)
+  {
+    File::Delete(filename);
+    success = File::Rename(temp_filename, filename);
+  }
+  if (!success)
+    File::Delete(temp_filename);
+  return success;
+}
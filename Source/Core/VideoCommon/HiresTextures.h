@@ -21,8 +21,14 @@ public:
   static void Update();
   static void Shutdown();
 
+  // When streaming, a texture that is not loaded yet is queued and nullptr is returned with
+  // pending set. GetStreamGeneration() changes once streamed textures become available.
   static std::shared_ptr<HiresTexture> Search(const std::string& basename,
-                                              std::function<u8*(size_t)> request_buffer_delegate);
+                                              std::function<u8*(size_t)> request_buffer_delegate,
+                                              bool* pending = nullptr);
+  static u64 GetStreamGeneration();
+  // Called once per frame, drives the texture streaming.
+  static void NewFrame();
 
   static std::shared_ptr<HiresTexture>
   SearchEnviroment(const std::string& basename, std::function<u8*(size_t)> request_buffer_delegate);
@@ -33,6 +39,18 @@ public:
                                  size_t tlut_size, u32 width, u32 height, int format,
                                  bool has_mipmaps, bool dump = false);
 
+  // Converts the loose custom textures of a game into a HiresTexturePack, which is used instead
+  // of the texture directories from then on. Must not be called while a game is running.
+  // progress receives the number of converted textures and returns false to abort.
+  static bool BuildPack(const std::string& game_id,
+                        std::function<bool(size_t done, size_t total)> progress);
+  // Generates the material maps of a game from its normal, bump and specular maps once and
+  // stores them in Load/Textures/<GameID>.mat.htp. When material maps are built, textures
+  // whose source maps didn't change since then are loaded from there instead.
+  static bool BuildMaterialMaps(const std::string& game_id,
+                                std::function<bool(size_t done, size_t total)> progress);
+  static std::string GetMaterialCachePath(const std::string& game_id);
+
   ~HiresTexture(){};
   HostTextureFormat m_format;
   u32 m_width, m_height, m_levels, m_nrm_levels, m_lum_levels;
@@ -45,6 +63,9 @@ private:
                               const std::string& extension, const bool BuildMaterialMaps);
   static void ProccessEnviroment(const std::string& fileitem, std::string& filename,
                                  const std::string& extension);
+  static void ProccessDirectory(const std::string& directory,
+                                const std::vector<std::string>& extensions,
+                                const bool BuildMaterialMaps);
   static HiresTexture* Load(const std::string& base_filename,
                             std::function<u8*(size_t)> request_buffer_delegate, bool cacheresult);
   static HiresTexture* LoadEnviroment(const std::string& base_filename,
@@ -52,6 +73,7 @@ private:
                                       bool cacheresult);
 
   static void Prefetch();
+  static void StreamTextures();
   HiresTexture();
   static std::set<std::string> GetTextureDirectory(const std::string& game_id);
 };
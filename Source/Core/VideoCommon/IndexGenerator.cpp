@@ -5,6 +5,7 @@
 #include <cstddef>
 
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/Logging/Log.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OpcodeDecoding.h"
@@ -14,20 +15,109 @@
 u16 *IndexGenerator::index_buffer_current;
 u16 *IndexGenerator::BASEIptr;
 u32 IndexGenerator::base_index;
+bool IndexGenerator::primitive_restart;
 
 static void(*primitive_table[8])(u32);
 
-void IndexGenerator::Init()
+namespace
 {
-  primitive_table[OpcodeDecoder::GX_DRAW_QUADS] = IndexGenerator::AddQuads;
-#if defined(_DEBUG) || defined(DEBUGFAST)
-  primitive_table[OpcodeDecoder::GX_DRAW_QUADS_2] = IndexGenerator::AddQuads_nonstandard;
+constexpr u16 RESTART_INDEX = 0xFFFF;
+
+// Index patterns of 24 entries (three SSE registers), each repetition of the pattern adds
+// step[] to the indices.
+struct IndexPattern
+{
+  u16 offset[24];
+  u16 step[24];
+};
+
+// 8 triangles of a strip, odd ones have their winding swapped.
+constexpr IndexPattern STRIP_PATTERN = {
+  {0, 1, 2, 1, 3, 2, 2, 3, 4, 3, 5, 4, 4, 5, 6, 5, 7, 6, 6, 7, 8, 7, 9, 8},
+  {8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8}};
+
+// 8 triangles of a fan, the first index always is the center vertex.
+constexpr IndexPattern FAN_PATTERN = {
+  {0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5, 0, 5, 6, 0, 6, 7, 0, 7, 8, 0, 8, 9},
+  {0, 8, 8, 0, 8, 8, 0, 8, 8, 0, 8, 8, 0, 8, 8, 0, 8, 8, 0, 8, 8, 0, 8, 8}};
+
+// 4 quads, two triangles each.
+constexpr IndexPattern QUAD_PATTERN = {
+  {0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7, 8, 9, 10, 8, 10, 11, 12, 13, 14, 12, 14, 15},
+  {16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+   16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16}};
+
+// Writes count repetitions of pattern, starting at index first.
+u16* WritePattern(u16* ptr, const IndexPattern& pattern, u32 first, u32 count)
+{
+#if _M_SSE >= 0x200
+  const __m128i base = _mm_set1_epi16(static_cast<s16>(first));
+  __m128i a = _mm_add_epi16(base, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.offset)));
+  __m128i b = _mm_add_epi16(base, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.offset + 8)));
+  __m128i c = _mm_add_epi16(base, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.offset + 16)));
+  const __m128i step_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.step));
+  const __m128i step_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.step + 8));
+  const __m128i step_c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.step + 16));
+  for (u32 i = 0; i < count; i++)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), a);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr + 8), b);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr + 16), c);
+    a = _mm_add_epi16(a, step_a);
+    b = _mm_add_epi16(b, step_b);
+    c = _mm_add_epi16(c, step_c);
+    ptr += 24;
+  }
 #else
-  primitive_table[OpcodeDecoder::GX_DRAW_QUADS_2] = IndexGenerator::AddQuads;
+  for (u32 i = 0; i < count; i++)
+  {
+    for (u32 j = 0; j < 24; j++)
+      ptr[j] = static_cast<u16>(first + pattern.offset[j] + i * pattern.step[j]);
+    ptr += 24;
+  }
 #endif
-  primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLES] = IndexGenerator::AddList;
-  primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP] = IndexGenerator::AddStrip;
-  primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_FAN] = IndexGenerator::AddFan;
+  return ptr;
+}
+
+// Writes first, first + 1, ..., first + count - 1.
+u16* WriteSequence(u16* ptr, u32 first, u32 count)
+{
+  u32 i = 0;
+#if _M_SSE >= 0x200
+  __m128i indices = _mm_add_epi16(_mm_set1_epi16(static_cast<s16>(first)),
+                                  _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7));
+  const __m128i step = _mm_set1_epi16(8);
+  for (; i + 8 <= count; i += 8)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr + i), indices);
+    indices = _mm_add_epi16(indices, step);
+  }
+#endif
+  for (; i < count; i++)
+    ptr[i] = static_cast<u16>(first + i);
+  return ptr + count;
+}
+}  // Anonymous namespace
+
+void IndexGenerator::Init(bool use_primitive_restart)
+{
+  primitive_restart = use_primitive_restart;
+  if (primitive_restart)
+  {
+    primitive_table[OpcodeDecoder::GX_DRAW_QUADS] = IndexGenerator::AddQuads<true>;
+    primitive_table[OpcodeDecoder::GX_DRAW_QUADS_2] = IndexGenerator::AddQuads_nonstandard<true>;
+    primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLES] = IndexGenerator::AddList<true>;
+    primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP] = IndexGenerator::AddStrip<true>;
+    primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_FAN] = IndexGenerator::AddFan<true>;
+  }
+  else
+  {
+    primitive_table[OpcodeDecoder::GX_DRAW_QUADS] = IndexGenerator::AddQuads<false>;
+    primitive_table[OpcodeDecoder::GX_DRAW_QUADS_2] = IndexGenerator::AddQuads_nonstandard<false>;
+    primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLES] = IndexGenerator::AddList<false>;
+    primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP] = IndexGenerator::AddStrip<false>;
+    primitive_table[OpcodeDecoder::GX_DRAW_TRIANGLE_FAN] = IndexGenerator::AddFan<false>;
+  }
   primitive_table[OpcodeDecoder::GX_DRAW_LINES] = &IndexGenerator::AddLineList;
   primitive_table[OpcodeDecoder::GX_DRAW_LINE_STRIP] = &IndexGenerator::AddLineStrip;
   primitive_table[OpcodeDecoder::GX_DRAW_POINTS] = &IndexGenerator::AddPoints;
@@ -47,40 +137,70 @@ void IndexGenerator::AddIndices(int primitive, u32 numVerts)
 }
 
 // Triangles
+template <bool pr>
 __forceinline u16* IndexGenerator::WriteTriangle(u16* ptr, u32 index1, u32 index2, u32 index3)
 {
   *ptr++ = index1;
   *ptr++ = index2;
   *ptr++ = index3;
+  if (pr)
+    *ptr++ = RESTART_INDEX;
   return ptr;
 }
 
+template <bool pr>
 void IndexGenerator::AddList(u32 const numVerts)
 {
-  u32 i = base_index + 2;
   u32 top = (base_index + numVerts);
   u16* ptr = index_buffer_current;
+  if (!pr)
+  {
+    // A list is drawn as is, indices just count up.
+    index_buffer_current = WriteSequence(ptr, base_index, numVerts - numVerts % 3);
+    return;
+  }
+  u32 i = base_index + 2;
   while (i < top)
   {
-    ptr = WriteTriangle(ptr, i - 2, i - 1, i);
+    ptr = WriteTriangle<pr>(ptr, i - 2, i - 1, i);
     i += 3;
   }
   index_buffer_current = ptr;
 }
 
+template <bool pr>
 void IndexGenerator::AddStrip(u32 const numVerts)
 {
   u16* ptr = index_buffer_current;
+  if (pr)
+  {
+    // Strips stay strips, one restart index separates them from the next primitive.
+    if (numVerts >= 3)
+    {
+      ptr = WriteSequence(ptr, base_index, numVerts);
+      *ptr++ = RESTART_INDEX;
+    }
+    index_buffer_current = ptr;
+    return;
+  }
+
   u32 top = (base_index + numVerts);
   u32 a = base_index;
   u32 i = a + 2;
+  if (numVerts >= 2)
+  {
+    const u32 blocks = (numVerts - 2) / 8;
+    ptr = WritePattern(ptr, STRIP_PATTERN, a, blocks);
+    a += blocks * 8;
+    i += blocks * 8;
+  }
   u32 wind = 1;
   while (i < top)
   {
     u32 b = i - wind;
     wind ^= 1;
     u32 c = i - wind;
-    ptr = WriteTriangle(
+    ptr = WriteTriangle<pr>(
       ptr,
       a,
       b,
@@ -110,15 +230,43 @@ void IndexGenerator::AddStrip(u32 const numVerts)
  * so we use 6 indices for 3 triangles
  */
 
+template <bool pr>
 void IndexGenerator::AddFan(u32 numVerts)
 {
   u32 i = base_index + 2;
   u32 top = (base_index + numVerts);
   u16* ptr = index_buffer_current;
 
+  if (pr)
+  {
+    for (; i + 3 <= top; i += 3)
+    {
+      *ptr++ = i - 1;
+      *ptr++ = i + 0;
+      *ptr++ = base_index;
+      *ptr++ = i + 1;
+      *ptr++ = i + 2;
+      *ptr++ = RESTART_INDEX;
+    }
+    for (; i + 2 <= top; i += 2)
+    {
+      *ptr++ = i - 1;
+      *ptr++ = i + 0;
+      *ptr++ = base_index;
+      *ptr++ = i + 1;
+      *ptr++ = RESTART_INDEX;
+    }
+  }
+  else if (numVerts >= 2)
+  {
+    const u32 blocks = (numVerts - 2) / 8;
+    ptr = WritePattern(ptr, FAN_PATTERN, base_index, blocks);
+    i += blocks * 8;
+  }
+
   while (i < top)
   {
-    ptr = WriteTriangle(ptr, base_index, i - 1, i);
+    ptr = WriteTriangle<pr>(ptr, base_index, i - 1, i);
     ++i;
   }
   index_buffer_current = ptr;
@@ -141,45 +289,58 @@ void IndexGenerator::AddFan(u32 numVerts)
  * A simple triangle has to be rendered for three vertices.
  * ZWW do this for sun rays
  */
+template <bool pr>
 void IndexGenerator::AddQuads(u32 numVerts)
 {
   u32 i = base_index + 3;
   u32 top = (base_index + numVerts);
   u16* ptr = index_buffer_current;
-  while (i < top)
+  if (pr)
+  {
+    while (i < top)
+    {
+      *ptr++ = i - 2;
+      *ptr++ = i - 1;
+      *ptr++ = i - 3;
+      *ptr++ = i - 0;
+      *ptr++ = RESTART_INDEX;
+      i += 4;
+    }
+  }
+  else
   {
-    ptr = WriteTriangle(ptr, i - 3, i - 2, i - 1);
-    ptr = WriteTriangle(ptr, i - 3, i - 1, i - 0);
-    i += 4;
+    const u32 blocks = numVerts / 16;
+    ptr = WritePattern(ptr, QUAD_PATTERN, base_index, blocks);
+    i += blocks * 16;
+    while (i < top)
+    {
+      ptr = WriteTriangle<pr>(ptr, i - 3, i - 2, i - 1);
+      ptr = WriteTriangle<pr>(ptr, i - 3, i - 1, i - 0);
+      i += 4;
+    }
   }
 
   // three vertices remaining, so render a triangle
   if (i == top)
   {
-    ptr = WriteTriangle(ptr, top - 3, top - 2, top - 1);
+    ptr = WriteTriangle<pr>(ptr, top - 3, top - 2, top - 1);
   }
   index_buffer_current = ptr;
 }
 
+template <bool pr>
 void IndexGenerator::AddQuads_nonstandard(u32 numVerts)
 {
+#if defined(_DEBUG) || defined(DEBUGFAST)
   WARN_LOG(VIDEO, "Non-standard primitive drawing command GL_DRAW_QUADS_2");
-  AddQuads(numVerts);
+#endif
+  AddQuads<pr>(numVerts);
 }
 
 // Lines
 void IndexGenerator::AddLineList(u32 numVerts)
 {
-  u32 i = base_index + 1;
-  u32 top = (base_index + numVerts);
-  u16* ptr = index_buffer_current;
-  while (i < top)
-  {
-    *ptr++ = i - 1;
-    *ptr++ = i;
-    i += 2;
-  }
-  index_buffer_current = ptr;
+  index_buffer_current = WriteSequence(index_buffer_current, base_index, numVerts & ~1u);
 }
 
 // shouldn't be used as strips as LineLists are much more common
@@ -201,13 +362,5 @@ void IndexGenerator::AddLineStrip(u32 numVerts)
 // Points
 void IndexGenerator::AddPoints(u32 numVerts)
 {
-  u32 i = base_index;
-  u32 top = (base_index + numVerts);
-  u16 *ptr = index_buffer_current;
-  while (i < top)
-  {
-    *ptr++ = i;
-    ++i;
-  }
-  index_buffer_current = ptr;
+  index_buffer_current = WriteSequence(index_buffer_current, base_index, numVerts);
 }
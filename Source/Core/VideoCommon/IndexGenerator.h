@@ -9,7 +9,9 @@ class IndexGenerator
 {
 public:
   // Init
-  static void Init();
+  // With use_primitive_restart, triangles are written as strips separated by restart indices, the
+  // backend then has to draw them as PrimitiveType::TriangleStrip.
+  static void Init(bool use_primitive_restart);
   static void Start(u16 *Indexptr);
 
   static void AddIndices(int primitive, u32 numVertices);
@@ -35,12 +37,29 @@ public:
   {
     return BASEIptr;
   }
+
+  static inline bool UsesPrimitiveRestart()
+  {
+    return primitive_restart;
+  }
+
+  // Drops every index written past end and the last num_verts vertices, for culled triangles.
+  static inline void Truncate(u16* end, u32 num_verts)
+  {
+    index_buffer_current = end;
+    base_index -= num_verts;
+  }
 private:
   // Triangles
+  template <bool pr>
   static void AddList(u32 numVerts);
+  template <bool pr>
   static void AddStrip(u32 numVerts);
+  template <bool pr>
   static void AddFan(u32 numVerts);
+  template <bool pr>
   static void AddQuads(u32 numVerts);
+  template <bool pr>
   static void AddQuads_nonstandard(u32 numVerts);
 
   // Lines
@@ -50,9 +69,11 @@ private:
   // Points
   static void AddPoints(u32 numVerts);
 
+  template <bool pr>
   static u16* WriteTriangle(u16 *ptr, u32 index1, u32 index2, u32 index3);
 
   static u16 *index_buffer_current;
   static u16 *BASEIptr;
   static u32 base_index;
+  static bool primitive_restart;
 };
@@ -15,16 +15,17 @@
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/DLCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/TessellationShaderManager.h"
-#include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/TextureCacheBase.h"
+#include "VideoCommon/VertexDataCache.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -160,10 +161,21 @@ u32 VideoBackendBase::Video_GetQueryResult(PerfQueryType type)
     return 0;
   }
 
-  Fifo::SyncGPU(Fifo::SyncGPUReason::PerfQuery);
-
   AsyncRequests::Event e;
   e.time = 0;
+
+  // Neither wait for the GPU thread nor the GPU, the results of the queries still pending are
+  // picked up by a later read.
+  if (g_perf_query->ShouldReadAsync())
+  {
+    e.type = AsyncRequests::Event::PERF_QUERY_POLL;
+    if (!g_perf_query->IsFlushed())
+      AsyncRequests::GetInstance()->PushEvent(e, false);
+    return g_perf_query->GetQueryResult(type);
+  }
+
+  Fifo::SyncGPU(Fifo::SyncGPUReason::PerfQuery);
+
   e.type = AsyncRequests::Event::PERF_QUERY;
 
   if (!g_perf_query->IsFlushed())
@@ -213,7 +225,8 @@ void VideoBackendBase::InitializeShared()
   PixelEngine::Init();
   BPInit();
   VertexLoaderManager::Init();
-  IndexGenerator::Init();
+  DLCache::Init();
+  VertexDataCache::Init();
   VertexShaderManager::Init();
   GeometryShaderManager::Init();
   PixelShaderManager::Init(!(g_ActiveConfig.backend_info.APIType & API_D3D9));
@@ -242,12 +255,18 @@ void VideoBackendBase::ShutdownShared()
 
 void VideoBackendBase::CleanupShared()
 {
+  DLCache::Shutdown();
+  VertexDataCache::Shutdown();
   VertexLoaderManager::Shutdown();
 }
 
 // Run from the CPU thread
 void VideoBackendBase::DoState(PointerWrap& p)
 {
+  // Memory is saved after us, it has to hold the deferred EFB copies by then.
+  if (g_texture_cache)
+    g_texture_cache->FlushAllPendingEFBCopies();
+
   bool software = false;
   p.Do(software);
 
@@ -280,6 +299,9 @@ void VideoBackendBase::CheckInvalidState()
     m_invalid = false;
 
     BPReload();
-    g_texture_cache->Invalidate();
+    if (g_ActiveConfig.bKeepTexturesOnStateLoad)
+      g_texture_cache->InvalidateForStateLoad();
+    else
+      g_texture_cache->Invalidate();
   }
 }
@@ -31,6 +31,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 #include <algorithm>
+#include <climits>
 #include <fstream>
 #include <functional>
 #include <map>
@@ -72,6 +73,17 @@ public:
     m_category_mask = pKey_t(1) << (m_category_id % (sizeof(pKey_t) * 8));
   }
 
+  // Adds obj to the current category without counting a use, the usage count is raised to at
+  // least usage_count so imported objects keep their relative order.
+  void Import(const Tobj& obj, pKey_t usage_count)
+  {
+    ObjectMetadata& item = m_objects[obj];
+    item.usage_count = std::max(item.usage_count, usage_count);
+    // Unlike GetOrAdd this always marks the category, ForEachMostUsedByCategory has to see
+    // imported objects before the profile was ever saved.
+    MarkCategory(item);
+  }
+
   TInfo& GetOrAdd(const Tobj& obj)
   {
     ObjectMetadata& item = m_objects[obj];
@@ -80,10 +92,17 @@ public:
     {
       item.usage_count++;
     }
-    if (m_categories.size() <= 1)
+    if (m_categories.size() > 1)
     {
-      return item.info;
+      MarkCategory(item);
     }
+    return item.info;
+  }
+
+private:
+  struct ObjectMetadata;
+  void MarkCategory(ObjectMetadata& item)
+  {
     if (item.category_mask.size() < m_max_category_index)
     {
       item.category_mask.resize(m_max_category_index);
@@ -96,9 +115,9 @@ public:
         item.category_count++;
       }
     }
-    return item.info;
   }
 
+public:
   void ForEach(const std::function<void(TInfo&)>& func)
   {
     for (auto& item : m_objects)
@@ -25,6 +25,7 @@ enum class MessageType
   NetPlayPing,
   NetPlayBuffer,
   Volume,
+  PendingPipelines,
 
   // This entry must be kept last so that persistent typed messages are
   // displayed before other messages
@@ -15,12 +15,15 @@
 #include "Common/CommonTypes.h"
 #include "Common/MsgHandler.h"
 #include "Common/Logging/Log.h"
+#include "Common/TraceEvents.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
 #include "Core/HW/Memmap.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BPStructs.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/DLCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/Statistics.h"
@@ -62,7 +65,9 @@ __forceinline u32 InterpretDisplayList(u32 address, u32 size)
 
     // temporarily swap dl and non-dl (small "hack" for the stats)
     Statistics::SwapDL();
+    DLCache::BeginDisplayList(address, startAddress, size);
     OpcodeDecoder::Run<false, false>(g_VideoData, &cycles);
+    DLCache::EndDisplayList();
     INCSTAT(stats.thisFrame.numDListsCalled);
     // un-swap
     Statistics::SwapDL();
@@ -161,7 +166,9 @@ void Init()
 template <bool is_preprocess, bool sizeCheck>
 u8* Run(DataReader& reader, u32* cycles)
 {
+  TRACE_SCOPE(is_preprocess ? "OpcodeDecoder::Preprocess" : "OpcodeDecoder::Run");
   u32 totalCycles = 0;
+  u8* const runStart = reader.GetReadPosition();
   u8* opcodeStart;
   while (true)
   {
@@ -298,7 +305,8 @@ u8* Run(DataReader& reader, u32* cycles)
           parameters.skip_draw = xfmem.viewport.wd == 0.0f
             || xfmem.viewport.ht == 0.0f
             || (bpmem.scissorBR.x + 1 - bpmem.scissorTL.x) == 0
-            || (bpmem.scissorBR.y + 1 - bpmem.scissorTL.y) == 0;
+            || (bpmem.scissorBR.y + 1 - bpmem.scissorTL.y) == 0
+            || BPIsFrameSkipped();
           parameters.VtxDesc = &state.vtx_desc;
           parameters.VtxAttr = &state.vtx_attr[vtx_attr_group];
           parameters.source = reader.GetReadPosition();
@@ -363,6 +371,9 @@ end:
   {
     *cycles = totalCycles;
   }
+  // Display lists are run with sizeCheck off, only count what came through the FIFO.
+  if (!is_preprocess && sizeCheck)
+    ADDSTAT(stats.thisFrame.bytesFifo, static_cast<int>(opcodeStart - runStart));
   return opcodeStart;
 }
 
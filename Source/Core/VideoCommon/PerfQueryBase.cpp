@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <memory>
+#include "Core/Core.h"
 #include "VideoCommon/PerfQueryBase.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -12,3 +13,9 @@ bool PerfQueryBase::ShouldEmulate()
 {
   return g_ActiveConfig.bPerfQueriesEnable;
 }
+
+bool PerfQueryBase::ShouldReadAsync()
+{
+  // Results would depend on how far the GPU is behind.
+  return g_ActiveConfig.bPerfQueriesAsync && !Core::WantsDeterminism();
+}
@@ -40,6 +40,11 @@ public:
   // NOTE: Called from CPU+GPU thread
   static bool ShouldEmulate();
 
+  // Checks if reads should return the results of the queries the GPU has finished so far,
+  // instead of waiting for all of them.
+  // NOTE: Called from CPU thread
+  static bool ShouldReadAsync();
+
   // Begin querying the specified value for the following host GPU commands
   virtual void EnableQuery(PerfQueryGroup type)
   {}
@@ -63,6 +68,10 @@ public:
   virtual void FlushResults()
   {}
 
+  // Collect the results of the queries the GPU has finished, without waiting for the others
+  virtual void PollResults()
+  {}
+
   // True if there are no further pending query results
   // NOTE: Called from CPU thread
   virtual bool IsFlushed() const
@@ -112,6 +112,7 @@ bool PostProcessingShaderConfiguration::LoadShader(const std::string& sub_dir,
   m_any_options_dirty = false;
   m_compile_time_constants_dirty = false;
   m_requires_depth_buffer = false;
+  m_time_dependent = false;
   m_frame_output.color_output_scale = 1.0;
   m_frame_output.depth_scale = 1.0;
   m_frame_output.depth_count = 0;
@@ -243,6 +244,11 @@ bool PostProcessingShaderConfiguration::ParseShader(const std::string& dirname,
     m_shader_source = code;
   }
 
+  // Randomize() seeds from the time as well
+  m_time_dependent = m_shader_source.find("GetTime") != std::string::npos ||
+                     m_shader_source.find("u_time") != std::string::npos ||
+                     m_shader_source.find("Randomize") != std::string::npos;
+
   return ParseConfiguration(dirname, configuration_string);
 }
 
@@ -599,6 +605,7 @@ bool PostProcessingShaderConfiguration::ParsePassBlock(const std::string& dirnam
         new_input.address_mode = POST_PROCESSING_ADDRESS_MODE_BORDER;
         new_input.texture_unit = texture_unit;
         new_input.pass_output_index = 0;
+        new_input.bicubic = false;
         pass.inputs.push_back(std::move(new_input));
         input = &pass.inputs.back();
       }
@@ -672,6 +679,7 @@ bool PostProcessingShaderConfiguration::ParsePassBlock(const std::string& dirnam
       }
       else if (extra == "Filter")
       {
+        input->bicubic = false;
         if (value == "Nearest")
         {
           input->filter = POST_PROCESSING_INPUT_FILTER_NEAREST;
@@ -680,6 +688,12 @@ bool PostProcessingShaderConfiguration::ParsePassBlock(const std::string& dirnam
         {
           input->filter = POST_PROCESSING_INPUT_FILTER_LINEAR;
         }
+        else if (value == "Bicubic")
+        {
+          // Built from bilinear taps
+          input->filter = POST_PROCESSING_INPUT_FILTER_LINEAR;
+          input->bicubic = true;
+        }
         else
         {
           ERROR_LOG(VIDEO, "Post processing configuration error: Invalid input filter: %s",
@@ -791,6 +805,7 @@ void PostProcessingShaderConfiguration::CreateDefaultPass()
   input.address_mode = POST_PROCESSING_ADDRESS_MODE_CLAMP;
   input.texture_unit = 0;
   input.pass_output_index = 0;
+  input.bicubic = false;
 
   RenderPass pass;
   pass.entry_point = "main";
@@ -1042,8 +1057,8 @@ bool PostProcessingShader::Reconfigure(const TargetSize& new_size)
   if (size_changed)
     m_ready = ResizeOutputTextures(new_size);
 
-  // Re-link on size change due to the input pointer changes
-  if (m_ready && (m_config->IsDirty() || size_changed))
+  // Re-link on size change due to the input pointer changes, this also drops cached outputs
+  if (m_ready && (m_config->IsDirty() || m_config->IsCompileTimeConstantsDirty() || size_changed))
     LinkPassOutputs();
 
   // Recompile shaders if compile-time constants have changed
@@ -1123,8 +1138,10 @@ void PostProcessingShader::LinkPassOutputs()
         m_config->GetPass(pass_index);
     RenderPassData& pass = m_passes[pass_index];
     pass.enabled = pass_config.CheckEnabled();
+    pass.SetStatic(false);
     if (!pass.enabled)
       continue;
+    bool is_static = !m_config->IsTimeDependent();
     size_t previous_pass_index = m_last_pass_index;
     m_last_pass_index = pass_index;
     m_last_pass_uses_color_buffer = false;
@@ -1155,22 +1172,32 @@ void PostProcessingShader::LinkPassOutputs()
         if (pass_output_index < 0)
         {
           m_last_pass_uses_color_buffer = true;
+          is_static = false;
         }
         else
         {
           m_passes[pass_output_index].AddReference();
+          is_static = is_static && m_passes[pass_output_index].IsStatic();
         }
       }
       break;
       case POST_PROCESSING_INPUT_TYPE_COLOR_BUFFER:
         m_last_pass_uses_color_buffer = true;
+        is_static = false;
+        break;
+
+      case POST_PROCESSING_INPUT_TYPE_IMAGE:
         break;
 
       default:
+        is_static = false;
         break;
       }
     }
+    pass.SetStatic(is_static);
   }
+  // The last pass may write straight to the target, it is always drawn
+  m_passes[m_last_pass_index].SetStatic(false);
   if (!IsLastPassScaled())
   {
     // If is not scaled we whant to keep this texture for output
@@ -1238,7 +1265,7 @@ void PostProcessingShader::RenderPassData::AddOutput()
 void PostProcessingShader::RenderPassData::ClenaupOutput()
 {
   ref_count--;
-  if (output_texture && ref_count <= 0)
+  if (output_texture && ref_count <= 0 && !is_static)
   {
     ReleaseOutput();
   }
@@ -1246,6 +1273,7 @@ void PostProcessingShader::RenderPassData::ClenaupOutput()
 
 void PostProcessingShader::RenderPassData::ReleaseOutput()
 {
+  output_cached = false;
   if (output_texture)
   {
     g_texture_cache->DisposeTexture(output_texture);
@@ -1253,6 +1281,25 @@ void PostProcessingShader::RenderPassData::ReleaseOutput()
   }
 }
 
+bool PostProcessingShader::RenderPassData::IsOutputCached(const TargetRectangle& src_rect,
+                                                          const TargetSize& src_size,
+                                                          int src_layer, float gamma) const
+{
+  return output_cached && output_texture && cached_src_rect == src_rect &&
+         cached_src_size == src_size && cached_src_layer == src_layer && cached_gamma == gamma;
+}
+
+void PostProcessingShader::RenderPassData::SetOutputCached(const TargetRectangle& src_rect,
+                                                           const TargetSize& src_size,
+                                                           int src_layer, float gamma)
+{
+  output_cached = is_static;
+  cached_src_rect = src_rect;
+  cached_src_size = src_size;
+  cached_src_layer = src_layer;
+  cached_gamma = gamma;
+}
+
 PostProcessor::PostProcessor(API_TYPE apitype) : m_APIType(apitype)
 {
   m_timer.Start();
@@ -2667,6 +2714,9 @@ std::string PostProcessor::GetPassFragmentShaderSource(
     const PostProcessingShaderConfiguration::RenderPass* pass)
 {
   std::string shader_source;
+  // Passes without an entry point copy their first input. With a bicubic input they upsample the
+  // output of a pass that ran at a lower OutputScale.
+  const char* copy_sample = pass->IsBicubicCopy() ? "SampleInputBicubic(0)" : "SampleInput(0)";
 
   // Include the user's code here
   if (!pass->entry_point.empty())
@@ -2680,7 +2730,7 @@ std::string PostProcessor::GetPassFragmentShaderSource(
   {
     // No entry point? This pass should perform a copy.
     if (pass->entry_point.empty())
-      shader_source += "void main() { ocol0 = SampleInput(0); }\n";
+      shader_source += StringFromFormat("void main() { ocol0 = %s; }\n", copy_sample);
     else if (pass->entry_point != "main")
       shader_source += StringFromFormat("void main() { %s(); }\n", pass->entry_point.c_str());
   }
@@ -2699,7 +2749,7 @@ std::string PostProcessor::GetPassFragmentShaderSource(
 
     // No entry point? This pass should perform a copy.
     if (pass->entry_point.empty())
-      shader_source += "\tocol0 = SampleInput(0);\n";
+      shader_source += StringFromFormat("\tocol0 = %s;\n", copy_sample);
     else
       shader_source += StringFromFormat(
           "\t%s();\n", (pass->entry_point != "main") ? pass->entry_point.c_str() : "main");
@@ -117,6 +117,8 @@ public:
       PostProcessingAddressMode address_mode;
       u32 texture_unit;
       u32 pass_output_index;
+      // Upsample with the bicubic filter in copy passes, the sampler stays linear
+      bool bicubic;
 
       std::unique_ptr<u8[]> external_image_data;
       TargetSize external_image_size;
@@ -127,6 +129,18 @@ public:
     HostTextureFormat output_format;
     std::vector<const ConfigurationOption*> dependent_options;
 
+    bool IsBicubicCopy() const
+    {
+      if (!entry_point.empty())
+        return false;
+      for (const Input& input : inputs)
+      {
+        if (input.texture_unit == 0)
+          return input.bicubic;
+      }
+      return false;
+    }
+
     void GetInputLocations(
       int& color_buffer_index,
       int& depth_buffer_index,
@@ -231,6 +245,12 @@ public:
     return m_requires_depth_buffer;
   }
 
+  // True if the source reads the time, so no pass output can be reused across frames.
+  bool IsTimeDependent() const
+  {
+    return m_time_dependent;
+  }
+
   bool HasOptions() const
   {
     return !m_running_options.empty();
@@ -284,6 +304,7 @@ public:
   bool m_any_options_dirty = false;
   bool m_compile_time_constants_dirty = false;
   bool m_requires_depth_buffer = false;
+  bool m_time_dependent = false;
   std::string m_shader_name;
   std::string m_shader_source;
   ConfigMap m_running_options;
@@ -358,6 +379,14 @@ protected:
     TextureConfig config{};
     size_t use_count{};
     size_t ref_count{};
+    // Only reads external images or other static passes, so the output can be kept between draws
+    bool is_static{};
+    // Source state the output was last drawn with, only tracked for static passes
+    bool output_cached{};
+    TargetRectangle cached_src_rect{};
+    TargetSize cached_src_size{};
+    int cached_src_layer{};
+    float cached_gamma{};
   public:
     uintptr_t shader{};
     std::vector<InputBinding> inputs;
@@ -375,6 +404,16 @@ protected:
     void ReleaseOutput();
     void AddReference() { use_count++; }
     void ClearReference() { use_count = 0; }
+    bool IsStatic() const { return is_static; }
+    void SetStatic(bool value)
+    {
+      is_static = value;
+      output_cached = false;
+    }
+    bool IsOutputCached(const TargetRectangle& src_rect, const TargetSize& src_size,
+                        int src_layer, float gamma) const;
+    void SetOutputCached(const TargetRectangle& src_rect, const TargetSize& src_size,
+                         int src_layer, float gamma);
   };
 
   virtual void ReleasePassNativeResources(RenderPassData& pass) = 0;
@@ -28,6 +28,7 @@
 #include "Common/Event.h"
 #include "Common/FileUtil.h"
 #include "Common/Flag.h"
+#include "Common/FrameArena.h"
 #include "Common/Hash.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
@@ -52,10 +53,14 @@
 
 #include "VideoCommon/AVIDump.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BPStructs.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/Debugger.h"
+#include "VideoCommon/DLCache.h"
+#include "VideoCommon/Fifo.h"
 #include "VideoCommon/FPSCounter.h"
+#include "VideoCommon/FrameTelemetry.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/ImageWrite.h"
@@ -64,8 +69,10 @@
 #include "VideoCommon/PostProcessing.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/TessellationShaderManager.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VideoConfig.h"
+#include "VideoCommon/VertexDataCache.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/XFMemory.h"
@@ -119,10 +126,20 @@ void Renderer::RenderToXFB(u32 xfbAddr, const EFBRectangle& sourceRc, u32 fbStri
 
   if (g_ActiveConfig.bUseXFB)
   {
+    // Nothing was drawn in a skipped frame, the previous copy is shown again instead.
+    if (BPIsFrameSkipped())
+      return;
     FramebufferManagerBase::CopyToXFB(xfbAddr, fbStride, fbHeight, sourceRc, Gamma);
   }
   else
   {
+    if (Core::IsOutputSuppressed() || BPIsFrameSkipped())
+    {
+      // Swap would have counted the frame.
+      Movie::FrameUpdate();
+      return;
+    }
+
     // The timing is not predictable here. So try to use the XFB path to dump frames.
     u64 ticks = CoreTiming::GetTicks();
     // below div two to convert from bytes to pixels - it expects width, not stride
@@ -370,6 +387,10 @@ void Renderer::DrawDebugText()
     if (g_ActiveConfig.bShowFPS && g_ActiveConfig.bShowFrameTimes && SConfig::GetInstance().iPollingMethod == POLLING_ONSIREAD)
       final_cyan += " (" + frame_time_str + " ms)";
 
+    const float present_latency = GetPresentLatency();
+    if (g_ActiveConfig.bShowFPS && present_latency >= 0.0f)
+      final_cyan += StringFromFormat(" - Present: %.1f ms", present_latency);
+
     if (g_ActiveConfig.bShowFPS && SConfig::GetInstance().m_ShowFrameCount)
       final_cyan += " - ";
 
@@ -386,6 +407,12 @@ void Renderer::DrawDebugText()
     final_yellow += "\n";
   }
 
+  if (g_ActiveConfig.bShowFrameTimeStats)
+  {
+    final_cyan += m_fps_counter.GetFrameTimeStatsString() + "\n";
+    final_yellow += "\n";
+  }
+
   if (SConfig::GetInstance().m_ShowLag)
   {
     final_cyan += StringFromFormat("Lag: %" PRIu64 "\n", Movie::GetCurrentLagCount());
@@ -883,6 +910,9 @@ void Renderer::RecordVideoMemory()
 
 void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const EFBRectangle& rc, u64 ticks, float Gamma)
 {
+  // Don't let deferred EFB copies linger for more than a frame.
+  g_texture_cache->FlushAllPendingEFBCopies();
+
   // Heuristic to detect if a GameCube game is in 16:9 anamorphic widescreen mode.
   if (!SConfig::GetInstance().bWii)
   {
@@ -901,18 +931,31 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
 
   static bool skip_next = false;
 
+  Fifo::TakeWakeupCounts(&stats.thisFrame.numGpuWakeups, &stats.thisFrame.numGpuSleeps);
+  Fifo::TakeSyncCounts(stats.thisFrame.numGpuSyncs, stats.thisFrame.gpuSyncWaitUs,
+                       &stats.thisFrame.numGpuSyncsDeferred);
+
   if (skip_next)
+  {
     InsertBlackFrame();
+  }
   else
+  {
+    RenderTimeScope render_time;
     // TODO: merge more generic parts into VideoCommon
     SwapImpl(xfbAddr, fbWidth, fbStride, fbHeight, rc, ticks, Gamma);
+  }
 
   skip_next = false;
+  UpdateDynamicEFBScale();
 
   if (m_xfb_written || (g_ActiveConfig.bUseXFB && g_ActiveConfig.bUseRealXFB))
     m_fps_counter.Update();
 
   frameCount++;
+  DLCache::ProgressiveCleanup();
+  VertexDataCache::ProgressiveCleanup();
+  TessellationShaderManager::NewFrame();
   GFX_DEBUGGER_PAUSE_AT(NEXT_FRAME, true);
   if (g_ActiveConfig.iBlackFrameInsertion != VideoConfig::BFI_OFF)
   {
@@ -960,12 +1003,87 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
   // Begin new frame
   // Set default viewport and scissor, for the clear to work correctly
   // New frame
+  FrameTelemetry::RecordFrame(GetGPUFrameTime());
   stats.ResetFrame();
+  Common::FrameArena::Reset();
 
   Core::Callback_VideoCopiedToXFB(m_xfb_written || (g_ActiveConfig.bUseXFB && g_ActiveConfig.bUseRealXFB));
   m_xfb_written = false;
 }
 
+static float GetEFBScaleFactor(int scale)
+{
+  switch (scale)
+  {
+  case SCALE_1X:
+    return 1.0f;
+  case SCALE_1_5X:
+    return 1.5f;
+  case SCALE_2X:
+    return 2.0f;
+  case SCALE_2_5X:
+    return 2.5f;
+  default:
+    return static_cast<float>(scale - 3);
+  }
+}
+
+// Picks the internal resolution from the time the video thread spends in draws, EFB copies and
+// the swap. These are the calls that block in the driver when the GPU falls behind, while a
+// video thread waiting for the emulated CPU doesn't count, so a CPU bound game stays at the
+// configured scale.
+void Renderer::UpdateDynamicEFBScale()
+{
+  const float render_time_ms =
+      std::chrono::duration<float, std::milli>(m_frame_render_time).count();
+  m_frame_render_time = {};
+
+  const int max_scale = g_Config.iEFBScale;
+  if (!g_ActiveConfig.bDynamicEFBScale || max_scale < SCALE_1X)
+  {
+    if (m_dynamic_efb_scale != 0)
+    {
+      m_dynamic_efb_scale = 0;
+      SetDynamicEFBScale(0);
+    }
+    return;
+  }
+  if (m_dynamic_efb_scale < SCALE_1X || m_dynamic_efb_scale > max_scale)
+  {
+    m_dynamic_efb_scale = max_scale;
+    m_average_render_time_ms = render_time_ms;
+    SetDynamicEFBScale(max_scale);
+  }
+
+  m_average_render_time_ms += (render_time_ms - m_average_render_time_ms) * 0.1f;
+  if (m_dynamic_efb_scale_cooldown > 0)
+  {
+    m_dynamic_efb_scale_cooldown--;
+    return;
+  }
+
+  const float budget_ms = 1000.0f / std::max(VideoInterface::GetTargetRefreshRate(), 1u);
+  int new_scale = m_dynamic_efb_scale;
+  if (m_average_render_time_ms > budget_ms * 0.9f && new_scale > SCALE_1X)
+  {
+    new_scale--;
+  }
+  else if (new_scale < max_scale)
+  {
+    // Only go up if the frame would still fit with the work growing with the pixel count
+    const float growth = GetEFBScaleFactor(new_scale + 1) / GetEFBScaleFactor(new_scale);
+    if (m_average_render_time_ms * growth * growth < budget_ms * 0.8f)
+      new_scale++;
+  }
+
+  if (new_scale != m_dynamic_efb_scale)
+  {
+    m_dynamic_efb_scale = new_scale;
+    SetDynamicEFBScale(new_scale);
+    m_dynamic_efb_scale_cooldown = 60;
+  }
+}
+
 bool Renderer::IsFrameDumping()
 {
   if (m_screenshot_request.IsSet())
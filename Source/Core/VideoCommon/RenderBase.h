@@ -13,6 +13,7 @@
 // ---------------------------------------------------------------------------------------------
 
 #pragma once
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -32,6 +33,7 @@
 #include "VideoCommon/RenderState.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
 
 class PostProcessor;
 
@@ -141,6 +143,15 @@ public:
   void Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const EFBRectangle& rc, u64 ticks, float Gamma = 1.0f);
   virtual void SwapImpl(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const EFBRectangle& rc, u64 ticks, float Gamma = 1.0f) = 0;
   virtual void InsertBlackFrame() = 0;
+  // GPU time of the last frame the backend has a result for, negative if it isn't measured.
+  virtual float GetGPUFrameTime() { return -1.0f; }
+  // Times a draw on the GPU for DrawProfiler, backends that can't leave its GPU time unset.
+  virtual void BeginDrawTimer(size_t draw) {}
+  virtual void EndDrawTimer() {}
+  // Time from presenting the last displayed frame to its vblank, negative when not measured.
+  virtual float GetPresentLatency() { return -1.0f; }
+  // Time the video thread spent submitting work and waiting for the driver in this frame
+  void AddRenderTime(std::chrono::steady_clock::duration time) { m_frame_render_time += time; }
   PEControl::PixelFormat GetPrevPixelFormat() const { return m_prev_efb_format; }
   void StorePixelFormat(PEControl::PixelFormat new_format) { m_prev_efb_format = new_format; }
 
@@ -192,6 +203,7 @@ protected:
   Common::Event m_surface_changed;
   void* m_new_surface_handle = nullptr;
 private:
+  void UpdateDynamicEFBScale();
   void RunFrameDumps();
   void ShutdownFrameDumping();
   PEControl::PixelFormat m_prev_efb_format = PEControl::INVALID_FMT;
@@ -200,6 +212,12 @@ private:
   u32 m_efb_scale_denominatorX = 1;
   u32 m_efb_scale_denominatorY = 1;
   u32 m_ssaa_multiplier = 1;
+
+  std::chrono::steady_clock::duration m_frame_render_time{};
+  float m_average_render_time_ms = 0.0f;
+  int m_dynamic_efb_scale = 0;
+  // Frames to wait after a scale change before the render time is judged again
+  u32 m_dynamic_efb_scale_cooldown = 0;
   
   // These will be set on the first call to SetWindowSize.
   u32 m_last_window_request_width = 0;
@@ -235,3 +253,27 @@ private:
 };
 
 extern std::unique_ptr<Renderer> g_renderer;
+
+// Adds the time until the end of the scope to the render time of the current frame, as long as
+// the dynamic EFB scale needs it.
+class RenderTimeScope
+{
+public:
+  RenderTimeScope() : m_active(g_ActiveConfig.bDynamicEFBScale)
+  {
+    if (m_active)
+      m_start = std::chrono::steady_clock::now();
+  }
+  ~RenderTimeScope()
+  {
+    if (m_active)
+      g_renderer->AddRenderTime(std::chrono::steady_clock::now() - m_start);
+  }
+
+  RenderTimeScope(const RenderTimeScope&) = delete;
+  RenderTimeScope& operator=(const RenderTimeScope&) = delete;
+
+private:
+  bool m_active;
+  std::chrono::steady_clock::time_point m_start;
+};
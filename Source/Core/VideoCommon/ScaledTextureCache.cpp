@@ -0,0 +1,231 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cinttypes>
+#include <cstring>
+#include <lzo/lzo1x.h>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <xxhash.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+#include "VideoCommon/ScaledTextureCache.h"
+
+namespace ScaledTextureCache
+{
+namespace
+{
+constexpr u32 CACHE_MAGIC = 0x48435453;  // "STCH"
+// Keys hold GetHash64() values, bump this whenever the texture hash changes.
+constexpr u32 CACHE_VERSION = 2;
+// Nothing is appended once the file has grown past this.
+constexpr u64 MAX_FILE_SIZE = 1024ULL * 1024 * 1024;
+
+static_assert(std::is_trivially_copyable<Key>::value, "Key is written to disk as is");
+static_assert(sizeof(Key) == 24, "Key must not contain implicit padding");
+
+struct FileHeader
+{
+  u32 magic;
+  u32 version;
+};
+
+struct RecordHeader
+{
+  Key key;
+  u32 compressed_size;
+  u32 size;
+};
+
+struct KeyHasher
+{
+  size_t operator()(const Key& key) const
+  {
+    return static_cast<size_t>(XXH64(&key, sizeof(Key), 0));
+  }
+};
+
+struct KeyEqual
+{
+  bool operator()(const Key& a, const Key& b) const
+  {
+    return std::memcmp(&a, &b, sizeof(Key)) == 0;
+  }
+};
+
+struct Record
+{
+  u64 offset;
+  u32 compressed_size;
+  u32 size;
+};
+
+std::mutex s_lock;
+// The file is only created once there is something to store.
+std::string s_filename;
+File::IOFile s_file;
+u64 s_file_size = 0;
+std::unordered_map<Key, Record, KeyHasher, KeyEqual> s_index;
+std::vector<u8> s_compressed;
+std::vector<u8> s_work_memory;
+
+std::string GetCachePath(const std::string& game_id)
+{
+  return File::GetUserPath(D_CACHE_IDX) + "ScaledTextures" DIR_SEP + game_id + ".stc";
+}
+
+bool CreateCacheFile(const std::string& filename)
+{
+  File::CreateFullPath(filename);
+  if (!s_file.Open(filename, "w+b"))
+    return false;
+  const FileHeader header = {CACHE_MAGIC, CACHE_VERSION};
+  s_file.WriteArray(&header, 1);
+  s_file_size = sizeof(FileHeader);
+  return s_file.IsGood();
+}
+
+bool ReadIndex()
+{
+  FileHeader header;
+  if (!s_file.ReadArray(&header, 1) || header.magic != CACHE_MAGIC ||
+      header.version != CACHE_VERSION)
+  {
+    return false;
+  }
+
+  const u64 file_size = s_file.GetSize();
+  u64 offset = sizeof(FileHeader);
+  RecordHeader record;
+  while (offset + sizeof(RecordHeader) <= file_size && s_file.ReadArray(&record, 1))
+  {
+    const u64 data_offset = offset + sizeof(RecordHeader);
+    if (data_offset + record.compressed_size > file_size)
+      break;
+    s_index[record.key] = {data_offset, record.compressed_size, record.size};
+    offset = data_offset + record.compressed_size;
+    s_file.Seek(offset, SEEK_SET);
+  }
+
+  // Drop a record that was cut short, new ones are appended after the last complete one.
+  s_file.Clear();
+  if (offset != file_size)
+    s_file.Resize(offset);
+  s_file_size = offset;
+  return true;
+}
+}  // Anonymous namespace
+
+void Init(const std::string& game_id)
+{
+  Shutdown();
+  if (game_id.empty() || lzo_init() != LZO_E_OK)
+    return;
+
+  std::lock_guard<std::mutex> guard(s_lock);
+  s_filename = GetCachePath(game_id);
+  s_work_memory.resize(LZO1X_1_MEM_COMPRESS);
+  if (!File::Exists(s_filename))
+    return;
+
+  if (!s_file.Open(s_filename, "r+b") || !ReadIndex())
+  {
+    WARN_LOG(VIDEO, "Discarding invalid scaled texture cache %s", s_filename.c_str());
+    s_index.clear();
+    s_file.Close();
+    File::Delete(s_filename);
+    return;
+  }
+  INFO_LOG(VIDEO, "Loaded %zu scaled textures from %s", s_index.size(), s_filename.c_str());
+}
+
+void Shutdown()
+{
+  std::lock_guard<std::mutex> guard(s_lock);
+  s_filename.clear();
+  s_file.Close();
+  s_file_size = 0;
+  s_index.clear();
+  s_compressed.clear();
+  s_compressed.shrink_to_fit();
+  s_work_memory.clear();
+  s_work_memory.shrink_to_fit();
+}
+
+bool Contains(const Key& key)
+{
+  std::lock_guard<std::mutex> guard(s_lock);
+  return s_index.count(key) != 0;
+}
+
+bool Lookup(const Key& key, u32* dst, u32 size)
+{
+  std::lock_guard<std::mutex> guard(s_lock);
+  if (!s_file.IsOpen())
+    return false;
+  auto iter = s_index.find(key);
+  if (iter == s_index.end() || iter->second.size != size)
+    return false;
+
+  const Record& record = iter->second;
+  s_compressed.resize(record.compressed_size);
+  lzo_uint decompressed_size = size;
+  if (!s_file.Seek(record.offset, SEEK_SET) ||
+      !s_file.ReadBytes(s_compressed.data(), record.compressed_size) ||
+      lzo1x_decompress_safe(s_compressed.data(), record.compressed_size,
+                            reinterpret_cast<u8*>(dst), &decompressed_size,
+                            nullptr) != LZO_E_OK ||
+      decompressed_size != size)
+  {
+    WARN_LOG(VIDEO, "Dropping corrupted scaled texture %016" PRIx64, key.hash);
+    s_file.Clear();
+    s_index.erase(iter);
+    return false;
+  }
+  return true;
+}
+
+void Store(const Key& key, const u32* data, u32 size)
+{
+  std::lock_guard<std::mutex> guard(s_lock);
+  if (s_filename.empty() || s_file_size >= MAX_FILE_SIZE || s_index.count(key))
+    return;
+  if (!s_file.IsOpen() && !CreateCacheFile(s_filename))
+  {
+    ERROR_LOG(VIDEO, "Failed to create scaled texture cache %s", s_filename.c_str());
+    // Don't retry on every texture.
+    s_filename.clear();
+    s_file.Close();
+    return;
+  }
+
+  // Worst case expansion of incompressible data, see the LZO documentation.
+  s_compressed.resize(size + size / 16 + 64 + 3);
+  lzo_uint compressed_size = 0;
+  if (lzo1x_1_compress(reinterpret_cast<const u8*>(data), size, s_compressed.data(),
+                       &compressed_size, s_work_memory.data()) != LZO_E_OK)
+  {
+    return;
+  }
+
+  const RecordHeader record = {key, static_cast<u32>(compressed_size), size};
+  s_file.Seek(s_file_size, SEEK_SET);
+  if (!s_file.WriteArray(&record, 1) || !s_file.WriteBytes(s_compressed.data(), compressed_size))
+  {
+    ERROR_LOG(VIDEO, "Failed to write to the scaled texture cache");
+    s_filename.clear();
+    s_file.Close();
+    return;
+  }
+  s_index[key] = {s_file_size + sizeof(RecordHeader), record.compressed_size, size};
+  s_file_size += sizeof(RecordHeader) + compressed_size;
+}
+}  // namespace ScaledTextureCache
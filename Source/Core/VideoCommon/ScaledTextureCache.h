@@ -0,0 +1,40 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Per-game disk cache of TextureScaler output.
+// Scaling is slow enough to cause stutter even on worker threads, and its result only depends
+// on the decoded texture and the scaler settings, so it is kept across sessions in
+// Cache/ScaledTextures/<GameID>.stc. The file is append only: the index (key -> file offset)
+// is rebuilt when the cache is opened and the LZO compressed levels are read on demand.
+// All functions are thread safe.
+namespace ScaledTextureCache
+{
+struct Key
+{
+  // Hash of the texture data combined with the palette hash, see TextureCacheBase::Load().
+  u64 hash;
+  u32 format;
+  u16 width;
+  u16 height;
+  u8 level;
+  u8 type;
+  u8 factor;
+  u8 deposterize;
+  u32 padding;
+};
+
+void Init(const std::string& game_id);
+void Shutdown();
+
+bool Contains(const Key& key);
+// Copies the scaled RGBA level to dst, which must hold size bytes. Returns false on a miss.
+bool Lookup(const Key& key, u32* dst, u32 size);
+void Store(const Key& key, const u32* data, u32 size);
+}  // namespace ScaledTextureCache
@@ -121,11 +121,20 @@ public:
     __attribute__((format(printf, 2, 3)))
 #endif
   {
+    // Most lines fit on the stack, a temporary string for each of them used to be the bulk of the
+    // allocations made by shader generation.
+    char line[1024];
     va_list arglist;
     va_start(arglist, fmt);
-    m_buffer += StringFromFormatV(fmt, arglist);
+    va_list arglist_copy;
+    va_copy(arglist_copy, arglist);
+    if (CharArrayFromFormatV(line, sizeof(line), fmt, arglist))
+      m_buffer += line;
+    else
+      m_buffer += StringFromFormatV(fmt, arglist_copy);
+    va_end(arglist_copy);
     va_end(arglist);
-}
+  }
   void clear()
   {
     m_buffer.clear();
@@ -134,6 +143,10 @@ public:
   {
     m_buffer = src.m_buffer;
   }
+  void assign(const char* src, size_t size)
+  {
+    m_buffer.assign(src, size);
+  }
   const char* data() const
   {
     return m_buffer.c_str();
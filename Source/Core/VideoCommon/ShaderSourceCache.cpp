@@ -0,0 +1,50 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <lzo/lzo1x.h>
+
+#include "VideoCommon/ShaderSourceCache.h"
+
+namespace ShaderSourceCompression
+{
+bool Compress(const ShaderCode& code, CompressedSource* out)
+{
+  static const bool s_lzo_initialized = lzo_init() == LZO_E_OK;
+  if (!s_lzo_initialized)
+    return false;
+
+  const u32 size = static_cast<u32>(code.size());
+  std::vector<u8> work_memory(LZO1X_1_MEM_COMPRESS);
+  // Worst case expansion of incompressible data, see the LZO documentation.
+  out->data.resize(size + size / 16 + 64 + 3);
+  lzo_uint compressed_size = 0;
+  if (lzo1x_1_compress(reinterpret_cast<const u8*>(code.data()), size, out->data.data(),
+                       &compressed_size, work_memory.data()) != LZO_E_OK)
+  {
+    out->data.clear();
+    return false;
+  }
+  out->data.resize(compressed_size);
+  out->data.shrink_to_fit();
+  out->size = size;
+  return true;
+}
+
+bool Decompress(const CompressedSource& source, ShaderCode* code)
+{
+  if (source.data.empty())
+    return false;
+  std::vector<char> buffer(source.size);
+  lzo_uint size = source.size;
+  if (lzo1x_decompress_safe(source.data.data(), source.data.size(),
+                            reinterpret_cast<u8*>(buffer.data()), &size,
+                            nullptr) != LZO_E_OK ||
+      size != source.size)
+  {
+    return false;
+  }
+  code->assign(buffer.data(), buffer.size());
+  return true;
+}
+}  // namespace ShaderSourceCompression
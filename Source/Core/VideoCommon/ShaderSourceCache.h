@@ -0,0 +1,105 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/ThreadPool.h"
+#include "VideoCommon/ShaderGenCommon.h"
+
+namespace ShaderSourceCompression
+{
+struct CompressedSource
+{
+  std::vector<u8> data;
+  u32 size = 0;
+};
+
+// LZO, shader sources usually shrink to a fifth of their size.
+bool Compress(const ShaderCode& code, CompressedSource* out);
+bool Decompress(const CompressedSource& source, ShaderCode* code);
+}  // namespace ShaderSourceCompression
+
+// Generated shader sources kept compressed in memory, keyed by uid.
+// Compiling a whole usage profile (after a driver update threw away the disk caches) used to
+// generate every source on the thread that owns the compiler. Prefetch generates them on the
+// thread pool instead, and as programs share most of their stages each source is only generated
+// once. All sources belong to the host config of the last Prefetch.
+template <typename Uid>
+class ShaderSourceCache
+{
+public:
+  using Generator = std::function<void(ShaderCode&, const Uid&, const ShaderHostConfig&)>;
+
+  explicit ShaderSourceCache(Generator generator) : m_generator(std::move(generator)) {}
+
+  // Generates the sources of all uids that aren't cached yet, returns once they are done.
+  void Prefetch(const std::vector<Uid>& uids, const ShaderHostConfig& hostconfig)
+  {
+    std::vector<const Uid*> missing;
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      if (hostconfig.bits != m_hostconfig.bits)
+      {
+        m_sources.clear();
+        m_hostconfig = hostconfig;
+      }
+      for (const Uid& uid : uids)
+      {
+        if (m_sources.emplace(uid, ShaderSourceCompression::CompressedSource()).second)
+          missing.push_back(&uid);
+      }
+    }
+
+    Common::ParallelForWorker::Loop(
+        0, static_cast<s32>(missing.size()), 8, [&](s32 begin, s32 end) {
+          ShaderCode code;
+          for (s32 i = begin; i < end; i++)
+          {
+            code.clear();
+            m_generator(code, *missing[i], hostconfig);
+            ShaderSourceCompression::CompressedSource source;
+            if (!ShaderSourceCompression::Compress(code, &source))
+              continue;
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_sources[*missing[i]] = std::move(source);
+          }
+        });
+  }
+
+  // Writes the source of uid to code, generating it when it wasn't prefetched.
+  void Get(const Uid& uid, const ShaderHostConfig& hostconfig, ShaderCode& code)
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      auto iter = m_sources.find(uid);
+      if (hostconfig.bits == m_hostconfig.bits && iter != m_sources.end() &&
+          ShaderSourceCompression::Decompress(iter->second, &code))
+      {
+        return;
+      }
+    }
+    code.clear();
+    m_generator(code, uid, hostconfig);
+  }
+
+  void Clear()
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_sources.clear();
+  }
+
+private:
+  Generator m_generator;
+  std::mutex m_lock;
+  ShaderHostConfig m_hostconfig = {};
+  std::unordered_map<Uid, ShaderSourceCompression::CompressedSource,
+                     typename Uid::ShaderUidHasher>
+      m_sources;
+};
@@ -0,0 +1,258 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "Common/CommonPaths.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+
+#include "VideoCommon/ObjectUsageProfiler.h"
+#include "VideoCommon/ShaderUIDBundle.h"
+
+namespace ShaderUIDBundle
+{
+namespace
+{
+constexpr u32 BUNDLE_MAGIC = 0x44495553;  // "SUID"
+constexpr u32 BUNDLE_VERSION = 1;
+
+struct FileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 vertex_shader_version;
+  u32 pixel_shader_version;
+  u32 geometry_shader_version;
+  u32 vertex_shader_size;
+  u32 pixel_shader_size;
+  u32 geometry_shader_size;
+  u32 vertex_shader_count;
+  u32 pixel_shader_count;
+  u32 geometry_shader_count;
+  u32 program_count;
+};
+
+template <typename Uid>
+using UidData = typename std::decay<decltype(std::declval<const Uid&>().GetUidData())>::type;
+
+template <typename Uid>
+constexpr u32 UidDataSize()
+{
+  return static_cast<u32>(sizeof(UidData<Uid>));
+}
+
+FileHeader GetCurrentHeader()
+{
+  FileHeader header = {};
+  header.magic = BUNDLE_MAGIC;
+  header.version = BUNDLE_VERSION;
+  header.vertex_shader_version = VERTEXSHADERGEN_UID_VERSION;
+  header.pixel_shader_version = PIXELSHADERGEN_UID_VERSION;
+  header.geometry_shader_version = GEOMETRYSHADERGEN_UID_VERSION;
+  header.vertex_shader_size = UidDataSize<VertexShaderUid>();
+  header.pixel_shader_size = UidDataSize<PixelShaderUid>();
+  header.geometry_shader_size = UidDataSize<GeometryShaderUid>();
+  return header;
+}
+
+template <typename Uid>
+bool ReadUids(File::IOFile& file, u32 count, std::vector<Uid>* uids)
+{
+  std::vector<UidData<Uid>> data(count);
+  if (count && !file.ReadArray(data.data(), count))
+    return false;
+  uids->resize(count);
+  for (u32 i = 0; i < count; i++)
+  {
+    (*uids)[i].template GetUidData<UidData<Uid>>() = data[i];
+    (*uids)[i].ClearHASH();
+    (*uids)[i].CalculateUIDHash();
+  }
+  return true;
+}
+
+template <typename Uid>
+bool WriteUids(File::IOFile& file, const std::vector<Uid>& uids)
+{
+  for (const Uid& uid : uids)
+  {
+    if (!file.WriteArray(&uid.GetUidData(), 1))
+      return false;
+  }
+  return true;
+}
+
+// Same layout as OGL::SHADERUID, the key of the OpenGL program usage profile.
+struct ProgramUid
+{
+  size_t hash = {};
+  VertexShaderUid vuid;
+  PixelShaderUid puid;
+  GeometryShaderUid guid;
+
+  bool operator==(const ProgramUid& r) const
+  {
+    return std::tie(vuid, puid, guid) == std::tie(r.vuid, r.puid, r.guid);
+  }
+
+  struct ShaderUidHasher
+  {
+    std::size_t operator()(const ProgramUid& k) const { return k.hash; }
+  };
+};
+
+// Collects the shaders of one stage in profile order, dropping duplicates.
+template <typename Uid>
+class UidList
+{
+public:
+  explicit UidList(std::vector<Uid>* uids) : m_uids(uids) {}
+
+  u32 Add(Uid uid)
+  {
+    uid.ClearHASH();
+    uid.CalculateUIDHash();
+    auto result = m_index.emplace(uid, static_cast<u32>(m_uids->size()));
+    if (result.second)
+      m_uids->push_back(uid);
+    return result.first->second;
+  }
+
+private:
+  std::vector<Uid>* m_uids;
+  std::unordered_map<Uid, u32, typename Uid::ShaderUidHasher> m_index;
+};
+
+template <typename Uid>
+void ReadProfile(const std::string& filename, pKey_t version,
+                 const std::function<void(const Uid&)>& func)
+{
+  const std::string path = StringFromFormat("%s%s.usage",
+                                            File::GetUserPath(D_SHADERUIDCACHE_IDX).c_str(),
+                                            filename.c_str());
+  if (!File::Exists(path))
+    return;
+  ObjectUsageProfiler<Uid, pKey_t, u8, typename Uid::ShaderUidHasher> profile(version);
+  profile.ReadFromFile(path);
+  profile.ForEachMostUsed(func);
+}
+}  // Anonymous namespace
+
+std::string GetExportPath(const std::string& game_id)
+{
+  return File::GetUserPath(D_DUMP_IDX) + SHADER_UIDS_DIR DIR_SEP + game_id + ".suid";
+}
+
+bool Load(const std::string& game_id, Bundle* bundle)
+{
+  if (game_id.empty())
+    return false;
+
+  std::string filename = File::GetUserPath(D_LOAD_IDX) + SHADER_UIDS_DIR DIR_SEP + game_id + ".suid";
+  if (!File::Exists(filename))
+    filename = File::GetSysDirectory() + SHADER_UIDS_DIR DIR_SEP + game_id + ".suid";
+  File::IOFile file(filename, "rb");
+  if (!file)
+    return false;
+
+  FileHeader header;
+  const FileHeader expected = GetCurrentHeader();
+  if (!file.ReadArray(&header, 1) || header.magic != expected.magic ||
+      header.version != expected.version ||
+      header.vertex_shader_version != expected.vertex_shader_version ||
+      header.pixel_shader_version != expected.pixel_shader_version ||
+      header.geometry_shader_version != expected.geometry_shader_version ||
+      header.vertex_shader_size != expected.vertex_shader_size ||
+      header.pixel_shader_size != expected.pixel_shader_size ||
+      header.geometry_shader_size != expected.geometry_shader_size)
+  {
+    WARN_LOG(VIDEO, "Ignoring shader UID bundle %s, it was made for another version",
+             filename.c_str());
+    return false;
+  }
+
+  Bundle result;
+  result.programs.resize(header.program_count);
+  if (!ReadUids(file, header.vertex_shader_count, &result.vertex_shaders) ||
+      !ReadUids(file, header.pixel_shader_count, &result.pixel_shaders) ||
+      !ReadUids(file, header.geometry_shader_count, &result.geometry_shaders) ||
+      (header.program_count && !file.ReadArray(result.programs.data(), header.program_count)))
+  {
+    WARN_LOG(VIDEO, "Shader UID bundle %s is truncated", filename.c_str());
+    return false;
+  }
+  for (const Program& program : result.programs)
+  {
+    if (program.vertex_shader >= header.vertex_shader_count ||
+        program.pixel_shader >= header.pixel_shader_count ||
+        program.geometry_shader >= header.geometry_shader_count)
+    {
+      WARN_LOG(VIDEO, "Shader UID bundle %s is corrupted", filename.c_str());
+      return false;
+    }
+  }
+
+  INFO_LOG(VIDEO, "Loaded %zu vertex and %zu pixel shader UIDs from %s",
+           result.vertex_shaders.size(), result.pixel_shaders.size(), filename.c_str());
+  *bundle = std::move(result);
+  return true;
+}
+
+bool Save(const std::string& filename, const Bundle& bundle)
+{
+  File::CreateFullPath(filename);
+  File::IOFile file(filename, "wb");
+  if (!file)
+    return false;
+
+  FileHeader header = GetCurrentHeader();
+  header.vertex_shader_count = static_cast<u32>(bundle.vertex_shaders.size());
+  header.pixel_shader_count = static_cast<u32>(bundle.pixel_shaders.size());
+  header.geometry_shader_count = static_cast<u32>(bundle.geometry_shaders.size());
+  header.program_count = static_cast<u32>(bundle.programs.size());
+  return file.WriteArray(&header, 1) && WriteUids(file, bundle.vertex_shaders) &&
+         WriteUids(file, bundle.pixel_shaders) && WriteUids(file, bundle.geometry_shaders) &&
+         (bundle.programs.empty() ||
+          file.WriteArray(bundle.programs.data(), bundle.programs.size()));
+}
+
+bool Export(const std::string& game_id)
+{
+  Bundle bundle;
+  UidList<VertexShaderUid> vertex_shaders(&bundle.vertex_shaders);
+  UidList<PixelShaderUid> pixel_shaders(&bundle.pixel_shaders);
+  UidList<GeometryShaderUid> geometry_shaders(&bundle.geometry_shaders);
+
+  // The D3D and Vulkan backends share one profile per stage, OpenGL profiles whole programs.
+  ReadProfile<VertexShaderUid>(game_id + ".vs", VERTEXSHADERGEN_UID_VERSION,
+                               [&](const VertexShaderUid& uid) { vertex_shaders.Add(uid); });
+  ReadProfile<PixelShaderUid>(game_id + ".ps", PIXELSHADERGEN_UID_VERSION,
+                              [&](const PixelShaderUid& uid) { pixel_shaders.Add(uid); });
+  ReadProfile<ProgramUid>(
+      game_id + ".ps.OGL",
+      PIXELSHADERGEN_UID_VERSION * VERTEXSHADERGEN_UID_VERSION * GEOMETRYSHADERGEN_UID_VERSION,
+      [&](const ProgramUid& uid) {
+        bundle.programs.push_back({vertex_shaders.Add(uid.vuid), pixel_shaders.Add(uid.puid),
+                                   geometry_shaders.Add(uid.guid)});
+      });
+
+  if (bundle.empty())
+    return false;
+  const std::string filename = GetExportPath(game_id);
+  if (!Save(filename, bundle))
+  {
+    ERROR_LOG(VIDEO, "Failed to write shader UID bundle %s", filename.c_str());
+    return false;
+  }
+  NOTICE_LOG(VIDEO, "Exported %zu vertex and %zu pixel shader UIDs to %s",
+             bundle.vertex_shaders.size(), bundle.pixel_shaders.size(), filename.c_str());
+  return true;
+}
+}  // namespace ShaderUIDBundle
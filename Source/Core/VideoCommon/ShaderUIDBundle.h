@@ -0,0 +1,58 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/VertexShaderGen.h"
+
+// Backend neutral list of the shaders a game uses, <GameID>.suid. Bundles are looked up in
+// Load/ShaderUIDs first and then in Sys/ShaderUIDs, where the ones we ship live. Every backend
+// imports the bundle into its usage profile, so precompiling on startup doesn't depend on the game
+// having been run with that backend before.
+namespace ShaderUIDBundle
+{
+// A vertex, pixel and geometry shader drawn together, as indices into the shader lists.
+struct Program
+{
+  u32 vertex_shader;
+  u32 pixel_shader;
+  u32 geometry_shader;
+};
+
+// All lists are ordered most used first.
+struct Bundle
+{
+  std::vector<VertexShaderUid> vertex_shaders;
+  std::vector<PixelShaderUid> pixel_shaders;
+  std::vector<GeometryShaderUid> geometry_shaders;
+  std::vector<Program> programs;
+
+  bool empty() const { return vertex_shaders.empty() && pixel_shaders.empty(); }
+};
+
+std::string GetExportPath(const std::string& game_id);
+
+// Reads the bundle of game_id, returns false if there is none or it was written for other UID
+// versions.
+bool Load(const std::string& game_id, Bundle* bundle);
+bool Save(const std::string& filename, const Bundle& bundle);
+
+// Builds a bundle from the usage profiles every backend keeps in Cache/ShadersUIDS and writes it
+// to Dump/ShaderUIDs. Returns false if the game has no profile yet.
+bool Export(const std::string& game_id);
+
+// Adds uids to a usage profile, keeping the order of the bundle.
+template <typename Uid, typename Profiler>
+void Import(const std::vector<Uid>& uids, Profiler* profiler)
+{
+  for (size_t i = 0; i < uids.size(); i++)
+    profiler->Import(uids[i], static_cast<u64>(uids.size() - i));
+}
+}  // namespace ShaderUIDBundle
@@ -18,6 +18,12 @@ void Statistics::ResetFrame()
   memset(&thisFrame, 0, sizeof(ThisFrame));
 }
 
+int Statistics::GetShadersCreated() const
+{
+  return numVertexShadersCreated + numPixelShadersCreated + numGeometryShadersCreated +
+         numHullShadersCreated + numDomainShadersCreated;
+}
+
 void Statistics::SwapDL()
 {
   std::swap(stats.thisFrame.numDLPrims, stats.thisFrame.numPrims);
@@ -44,6 +50,9 @@ std::string Statistics::ToString()
   }
   str += StringFromFormat("Textures created: %i\n", stats.numTexturesCreated);
   str += StringFromFormat("Textures alive: %i\n", stats.numTexturesAlive);
+  str += StringFromFormat("Texture memory: %i MB (%i MB pooled, budget %i MB)\n",
+                          stats.textureMemoryMB, stats.texturePoolMemoryMB,
+                          stats.textureMemoryBudgetMB);
   str += StringFromFormat("pshaders created: %i\n", stats.numPixelShadersCreated);
   str += StringFromFormat("pshaders alive: %i\n", stats.numPixelShadersAlive);
   str += StringFromFormat("vshaders created: %i\n", stats.numVertexShadersCreated);
@@ -58,8 +67,24 @@ std::string Statistics::ToString()
   str += StringFromFormat("dlists called: %i\n", stats.thisFrame.numDListsCalled);
   str += StringFromFormat("Primitive joins: %i\n", stats.thisFrame.numPrimitiveJoins);
   str += StringFromFormat("Draw calls: %i\n", stats.thisFrame.numDrawCalls);
+  str += StringFromFormat("Ubershader draws: %i\n", stats.thisFrame.numUberShaderDraws);
+  str += StringFromFormat("GPU thread wakeups: %i\n", stats.thisFrame.numGpuWakeups);
+  str += StringFromFormat("GPU thread sleeps: %i\n", stats.thisFrame.numGpuSleeps);
+  for (int i = 0; i < Fifo::NUM_SYNC_GPU_REASONS; i++)
+  {
+    if (stats.thisFrame.numGpuSyncs[i])
+    {
+      str += StringFromFormat("GPU syncs (%s): %i, waited %i us\n", Fifo::GetSyncGPUReasonName(i),
+                              stats.thisFrame.numGpuSyncs[i], stats.thisFrame.gpuSyncWaitUs[i]);
+    }
+  }
+  str += StringFromFormat("GPU syncs deferred: %i\n", stats.thisFrame.numGpuSyncsDeferred);
   str += StringFromFormat("Primitives: %i\n", stats.thisFrame.numPrims);
   str += StringFromFormat("Primitives (DL): %i\n", stats.thisFrame.numDLPrims);
+  str += StringFromFormat("Primitives (DL cached): %i\n", stats.thisFrame.numDLPrimsCached);
+  str += StringFromFormat("Primitives (array cached): %i\n", stats.thisFrame.numArrayPrimsCached);
+  str += StringFromFormat("Triangles culled (CPU): %i\n",
+                          stats.thisFrame.numTrianglesCulled + stats.thisFrame.numTrianglesRejected);
   str += StringFromFormat("XF loads: %i\n", stats.thisFrame.numXFLoads);
   str += StringFromFormat("XF loads (DL): %i\n", stats.thisFrame.numXFLoadsInDL);
   str += StringFromFormat("CP loads: %i\n", stats.thisFrame.numCPLoads);
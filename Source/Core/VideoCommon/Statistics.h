@@ -6,6 +6,8 @@
 
 #include <string>
 
+#include "VideoCommon/Fifo.h"
+
 struct Statistics
 {
   int numDomainShadersCreated;
@@ -21,6 +23,9 @@ struct Statistics
 
   int numTexturesCreated;
   int numTexturesAlive;
+  int textureMemoryMB;
+  int texturePoolMemoryMB;
+  int textureMemoryBudgetMB;
 
   int numVertexLoaders;
 
@@ -43,13 +48,30 @@ struct Statistics
 
     int numPrims;
     int numDLPrims;
+    int numDLPrimsCached;
+    int numArrayPrimsCached;
     int numShaderChanges;
 
     int numPrimitiveJoins;
     int numDrawCalls;
+    int numUberShaderDraws;
 
     int numDListsCalled;
 
+    int numTextureCacheHits;
+    int numTextureCacheMisses;
+    int numTextureUploads;
+    int numEFBCopies;
+    int numEFBCopiesSkipped;
+
+    int numGpuWakeups;
+    int numGpuSleeps;
+
+    int numGpuSyncs[Fifo::NUM_SYNC_GPU_REASONS];
+    int gpuSyncWaitUs[Fifo::NUM_SYNC_GPU_REASONS];
+    int numGpuSyncsDeferred;
+
+    int bytesFifo;
     int bytesVertexStreamed;
     int bytesIndexStreamed;
     int bytesUniformStreamed;
@@ -68,6 +90,9 @@ struct Statistics
   ThisFrame thisFrame;
   void ResetFrame();
   static void SwapDL();
+  // Shaders of all stages created so far, the difference between two frames is the number of
+  // shader cache misses.
+  int GetShadersCreated() const;
 
   static std::string ToString();
   static std::string ToStringProj();
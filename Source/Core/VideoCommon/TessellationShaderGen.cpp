@@ -87,6 +87,10 @@ float CalcTessFactor(float3 Origin, float Diameter)
 {
   float distance = 1.0 - saturate(length(Origin) * )hlsl" I_TESSPARAMS R"hlsl(.x);
   distance = distance * distance;
+  // One segment per target edge length in pixels. Shared edges get the same factor on both
+  // sides, so the result is crack free.
+  if ()hlsl" I_TESSADAPT R"hlsl(.x > 0.0)
+    return clamp(round(GetScreenSize(Origin,Diameter) * )hlsl" I_TESSADAPT R"hlsl(.x * distance), 1.0, )hlsl" I_TESSPARAMS R"hlsl(.y);
   return round(max(4.0,)hlsl" I_TESSPARAMS R"hlsl(.y * GetScreenSize(Origin,Diameter) * distance));
 }
 ConstantOutput TConstFunc(InputPatch<VS_OUTPUT, 3> patch)
@@ -437,6 +441,7 @@ inline void GenerateTessellationShader(ShaderCode& out,
     out.Write("cbuffer TSBlock : register(b0) {\n");
   out.Write("\tfloat4 " I_TESSPARAMS ";\n"
             "\tint4 " I_CULLPARAMS ";\n"
+            "\tfloat4 " I_TESSADAPT ";\n"
             "};\n");
 
   if (ApiType == API_OPENGL)
@@ -137,8 +137,9 @@ struct Tessellation_shader_uid_data
 
 #define I_TESSPARAMS  "ctess"
 #define I_CULLPARAMS  "ccullp"
+#define I_TESSADAPT   "ctessadapt"
 
-#define TESSELLATIONSHADERGEN_UID_VERSION 1
+#define TESSELLATIONSHADERGEN_UID_VERSION 2
 typedef ShaderUid<Tessellation_shader_uid_data> TessellationShaderUid;
 
 void GenerateTessellationShaderCode(ShaderCode& object, API_TYPE ApiType, const Tessellation_shader_uid_data& uid_data);
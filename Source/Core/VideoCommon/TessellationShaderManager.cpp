@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 
@@ -17,11 +18,15 @@
 
 alignas(256) TessellationShaderConstants TessellationShaderManager::constants;
 bool TessellationShaderManager::dirty;
+u32 TessellationShaderManager::frame_patches;
+float TessellationShaderManager::factor_cap;
 
 void TessellationShaderManager::Init()
 {
   memset(&constants, 0, sizeof(constants));
   dirty = true;
+  frame_patches = 0;
+  factor_cap = FLT_MAX;
 }
 
 void TessellationShaderManager::Shutdown()
@@ -39,7 +44,7 @@ void TessellationShaderManager::SetConstants()
   if (g_ActiveConfig.TessellationEnabled())
   {
     float tessmin = 1.0f / ((500000 - float(g_ActiveConfig.iTessellationDistance) * 500.0f) + 0.01f);
-    float tessmax = float(g_ActiveConfig.iTessellationMax);
+    float tessmax = std::min(float(g_ActiveConfig.iTessellationMax), factor_cap);
     float rounding = float(g_ActiveConfig.iTessellationRoundingIntensity) * 0.01f;
     float displacement = float(g_ActiveConfig.iTessellationDisplacementIntensity) * 0.01f;
     if (constants.tessparams[0] != tessmin
@@ -53,6 +58,15 @@ void TessellationShaderManager::SetConstants()
       constants.tessparams[3] = displacement;
       dirty = true;
     }
+    // GetScreenSize is in clip space, where the render target is 2 units high.
+    float adapt = 0.0f;
+    if (g_ActiveConfig.iTessellationEdgeLength > 0)
+      adapt = g_renderer->GetTargetHeight() * 0.5f / float(g_ActiveConfig.iTessellationEdgeLength);
+    if (constants.tessadapt[0] != adapt)
+    {
+      constants.tessadapt[0] = adapt;
+      dirty = true;
+    }
     RasterizationState state = {};
     state.Generate(bpmem, PrimitiveType::Triangles);
     int cull = state.cullmode.Value() > 0 ? (state.cullmode.Value() == GenMode::CullMode::CULL_FRONT ? 1 : -1) : 0;
@@ -66,6 +80,26 @@ void TessellationShaderManager::SetConstants()
   }
 }
 
+void TessellationShaderManager::CountPatches(u32 count)
+{
+  frame_patches += count;
+}
+
+void TessellationShaderManager::NewFrame()
+{
+  // A patch tessellated with factor f produces about f * f triangles.
+  if (g_ActiveConfig.iTessellationTriangleBudget > 0 && frame_patches > 0)
+  {
+    const float budget = float(g_ActiveConfig.iTessellationTriangleBudget) * 1000.0f;
+    factor_cap = std::max(std::sqrt(budget / float(frame_patches)), 1.0f);
+  }
+  else
+  {
+    factor_cap = FLT_MAX;
+  }
+  frame_patches = 0;
+}
+
 void TessellationShaderManager::DoState(PointerWrap &p)
 {
   if (p.GetMode() == PointerWrap::MODE_READ)
@@ -14,6 +14,8 @@ class PointerWrap;
 class TessellationShaderManager
 {
   static bool dirty;
+  static u32 frame_patches;
+  static float factor_cap;
 public:
   static void Init();
   static void Dirty();
@@ -29,5 +31,9 @@ public:
   static void DoState(PointerWrap &p);
 
   static void SetConstants();
+  // Keeps the triangles generated by the tessellator within the configured budget. Patches are
+  // counted for every tessellated draw, the factor limit is updated once per frame.
+  static void CountPatches(u32 count);
+  static void NewFrame();
   alignas(256) static TessellationShaderConstants constants;
 };
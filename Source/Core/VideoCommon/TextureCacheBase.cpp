@@ -2,8 +2,10 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 
@@ -11,6 +13,9 @@
 #include "Common/FileUtil.h"
 #include "Common/MemoryUtil.h"
 #include "Common/StringUtil.h"
+#include "Common/Thread.h"
+#include "Common/ThreadPool.h"
+#include "Common/TraceEvents.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/FifoPlayer/FifoPlayer.h"
@@ -20,9 +25,11 @@
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/HiresTextures.h"
+#include "VideoCommon/ImageWrite.h"
 #include "VideoCommon/PostProcessing.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/SamplerCommon.h"
+#include "VideoCommon/ScaledTextureCache.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
@@ -35,6 +42,32 @@ static const u64 MAX_TEXTURE_BINARY_SIZE =
     1024 * 1024 * 4;  // 1024 x 1024 texel times 8 nibbles per texel
 std::unique_ptr<TextureCacheBase> g_texture_cache;
 
+static ScaledTextureCache::Key GetScaledTextureKey(u64 hash, u32 format, u32 level, u32 width,
+                                                   u32 height, int type, int factor,
+                                                   bool deposterize)
+{
+  ScaledTextureCache::Key key = {};
+  key.hash = hash;
+  key.format = format;
+  key.width = static_cast<u16>(width);
+  key.height = static_cast<u16>(height);
+  key.level = static_cast<u8>(level);
+  key.type = static_cast<u8>(type);
+  key.factor = static_cast<u8>(factor);
+  key.deposterize = deposterize;
+  return key;
+}
+
+struct TextureCacheBase::AsyncScaleState
+{
+  std::mutex lock;
+  std::vector<std::shared_ptr<AsyncScaleJob>> results;
+  // TextureScaler keeps its work buffers around, so every job borrows one.
+  std::vector<std::unique_ptr<TextureScaler>> idle_scalers;
+  std::atomic<bool> has_results{false};
+  std::atomic<bool> shutdown{false};
+};
+
 TextureCacheBase::TCacheEntry::TCacheEntry(std::unique_ptr<HostTexture> tex, bool material,
                                            bool luma)
 {
@@ -69,14 +102,20 @@ TextureCacheBase::TextureCacheBase()
                                       backup_config.texfmt_overlay_center);
 
   HiresTexture::Init();
+  if (backup_config.scaling_cache)
+    ScaledTextureCache::Init(SConfig::GetInstance().GetGameID());
 
   texture_pool_memory_usage = 0;
+  texture_pool_idle_memory = 0;
   InvalidateAllBindPoints();
   m_scaler = std::make_unique<TextureScaler>();
+  m_async_scale_state = std::make_shared<AsyncScaleState>();
 }
 
 void TextureCacheBase::Invalidate()
 {
+  FlushAllPendingEFBCopies();
+  m_efb_copy_records.clear();
   InvalidateAllBindPoints();
   bound_textures.fill(nullptr);
   auto iter = textures_by_address.begin();
@@ -86,36 +125,91 @@ void TextureCacheBase::Invalidate()
     iter = InvalidateTexture(iter);
   }
   textures_by_address.clear();
+  textures_by_page.clear();
   textures_by_hash.clear();
+  m_async_scale_entries.clear();
 }
 
+void TextureCacheBase::InvalidateForStateLoad()
+{
+  FlushAllPendingEFBCopies();
+  m_efb_copy_records.clear();
+  InvalidateAllBindPoints();
+  bound_textures.fill(nullptr);
+
+  // EFB copies and everything built from them hold GPU results of the state that was left,
+  // which the hash of the memory below them doesn't reflect. Dropping them also drops their
+  // references, so they are collected before anything is removed.
+  std::vector<TexAddrCache::iterator> stale;
+  for (auto iter = textures_by_address.begin(); iter != textures_by_address.end(); ++iter)
+  {
+    TCacheEntry* entry = iter->second;
+    if (entry->IsEfbCopy() || entry->tmem_only || entry->palette_base ||
+        !entry->references.empty())
+    {
+      stale.push_back(iter);
+    }
+    else
+    {
+      // EFB copies of the loaded state may overlap it again.
+      entry->may_have_overlapping_textures = true;
+    }
+  }
+  for (TexAddrCache::iterator iter : stale)
+    InvalidateTexture(iter);
+}
+
+// Dumps being encoded on the pool. Past the limit the GPU thread waits, so that a burst of new
+// textures doesn't keep an unbounded amount of copies around.
+static std::atomic<u32> s_pending_dumps{0};
+constexpr u32 MAX_PENDING_DUMPS = 64;
+
 TextureCacheBase::~TextureCacheBase()
 {
   HiresTexture::Shutdown();
+  ScaledTextureCache::Shutdown();
+  // The backend is already gone, nobody is going to read them anymore.
+  m_pending_efb_copies.clear();
   Invalidate();
   texture_pool.clear();
   texture_pool_memory_usage = 0;
+  texture_pool_idle_memory = 0;
   if (TextureCacheBase::temp)
   {
     Common::FreeAlignedMemory(TextureCacheBase::temp);
     TextureCacheBase::temp = nullptr;
   }
   m_scaler.reset();
+  m_async_scale_state->shutdown.store(true);
+  // Let the dumps that are still being written finish.
+  while (s_pending_dumps.load(std::memory_order_acquire) != 0)
+    Common::SleepCurrentThread(1);
 }
 
 void TextureCacheBase::OnConfigChanged(VideoConfig& config)
 {
   if (config.bHiresTextures != backup_config.hires_textures ||
-      config.bCacheHiresTextures != backup_config.cache_hires_textures)
+      config.bCacheHiresTextures != backup_config.cache_hires_textures ||
+      config.bStreamHiresTextures != backup_config.stream_hires_textures ||
+      config.iHiresTexturesMemoryBudget != backup_config.hires_textures_memory_budget)
   {
     HiresTexture::Update();
   }
 
+  if (config.bTexScalingCache != backup_config.scaling_cache)
+  {
+    if (config.bTexScalingCache)
+      ScaledTextureCache::Init(SConfig::GetInstance().GetGameID());
+    else
+      ScaledTextureCache::Shutdown();
+  }
+
   // TODO: Invalidating texcache is really stupid in some of these cases
   if (config.iSafeTextureCache_ColorSamples != backup_config.colorsamples ||
       config.bTexFmtOverlayEnable != backup_config.texfmt_overlay ||
       config.bTexFmtOverlayCenter != backup_config.texfmt_overlay_center ||
       config.bHiresTextures != backup_config.hires_textures ||
+      config.bStreamHiresTextures != backup_config.stream_hires_textures ||
       config.iTexScalingFactor != backup_config.scaling_factor ||
       config.iTexScalingType != backup_config.scaling_mode ||
       config.bTexDeposterize != backup_config.scaling_deposterize ||
@@ -145,16 +239,21 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
   backup_config.texfmt_overlay_center = config.bTexFmtOverlayCenter;
   backup_config.hires_textures = config.bHiresTextures;
   backup_config.cache_hires_textures = config.bCacheHiresTextures;
+  backup_config.stream_hires_textures = config.bStreamHiresTextures;
+  backup_config.hires_textures_memory_budget = config.iHiresTexturesMemoryBudget;
   backup_config.stereo_3d = config.iStereoMode > 0;
   backup_config.efb_mono_depth = config.bStereoEFBMonoDepth;
   backup_config.scaling_factor = config.iTexScalingFactor;
   backup_config.scaling_mode = config.iTexScalingType;
   backup_config.scaling_deposterize = config.bTexDeposterize;
+  backup_config.scaling_cache = config.bTexScalingCache;
   backup_config.gpu_texture_decoding = config.bEnableGPUTextureDecoding;
 }
 
 void TextureCacheBase::Cleanup(s32 _frameCount)
 {
+  HiresTexture::NewFrame();
+
   s32 texture_kill_threshold = TEXTURE_KILL_THRESHOLD;
   if (texture_pool_memory_usage < (TEXTURE_POOL_MEMORY_LIMIT / 2))
   {
@@ -233,7 +332,9 @@ void TextureCacheBase::Cleanup(s32 _frameCount)
     }
     if (_frameCount > TEXTURE_POOL_KILL_THRESHOLD + iter2->second.frameCount)
     {
-      texture_pool_memory_usage -= iter2->second.texture->GetConfig().GetSizeInBytes();
+      const size_t size = iter2->second.texture->GetConfig().GetSizeInBytes();
+      texture_pool_memory_usage -= size;
+      texture_pool_idle_memory -= size;
       iter2 = texture_pool.erase(iter2);
     }
     else
@@ -241,6 +342,58 @@ void TextureCacheBase::Cleanup(s32 _frameCount)
       ++iter2;
     }
   }
+
+  const size_t budget = GetTextureMemoryBudget();
+  if (budget != 0 && texture_pool_memory_usage > budget)
+    EvictToBudget(_frameCount, budget);
+
+  SETSTAT(stats.textureMemoryMB, static_cast<int>(texture_pool_memory_usage >> 20));
+  SETSTAT(stats.texturePoolMemoryMB, static_cast<int>(texture_pool_idle_memory >> 20));
+  SETSTAT(stats.textureMemoryBudgetMB, static_cast<int>(budget >> 20));
+}
+
+size_t TextureCacheBase::GetTextureMemoryBudget()
+{
+  // The rest is left for the EFB, framebuffers, stream buffers and the driver.
+  return static_cast<size_t>(g_ActiveConfig.backend_info.VideoMemorySize / 2);
+}
+
+void TextureCacheBase::EvictToBudget(s32 frame_count, size_t budget)
+{
+  // Textures not used since the last frame, least recently used and largest first. EFB copies
+  // that only live on the GPU can't be recreated, so they stay.
+  std::vector<std::pair<u64, TexAddrCache::iterator>> candidates;
+  for (auto iter = textures_by_address.begin(); iter != textures_by_address.end(); ++iter)
+  {
+    const TCacheEntry* entry = iter->second;
+    if (entry->IsEfbCopy() || entry->frameCount == FRAMECOUNT_INVALID ||
+        entry->frameCount >= frame_count)
+    {
+      continue;
+    }
+    const u64 age = static_cast<u64>(frame_count - entry->frameCount);
+    candidates.emplace_back(age * entry->texture->GetConfig().GetSizeInBytes(), iter);
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  // Invalidated textures go to the pool, which is emptied below.
+  for (const auto& candidate : candidates)
+  {
+    if (texture_pool_memory_usage - texture_pool_idle_memory <= budget)
+      break;
+    InvalidateTexture(candidate.second);
+  }
+
+  auto iter = texture_pool.begin();
+  while (iter != texture_pool.end() && texture_pool_memory_usage > budget)
+  {
+    const size_t size = iter->second.texture->GetConfig().GetSizeInBytes();
+    texture_pool_memory_usage -= size;
+    texture_pool_idle_memory -= size;
+    iter = texture_pool.erase(iter);
+  }
+  SETSTAT(stats.numTexturesAlive, textures_by_address.size());
 }
 
 bool TextureCacheBase::TCacheEntry::OverlapsMemoryRange(u32 range_address, u32 range_size) const
@@ -258,6 +411,17 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::ApplyPaletteToEntry(TCacheEntry
                                                                      u32 tlutaddr, u32 tlutfmt,
                                                                      u32 palette_size)
 {
+  const u64 palette_hash =
+      GetHash64(&texMem[tlutaddr], palette_size, g_ActiveConfig.iSafeTextureCache_ColorSamples);
+  for (TCacheEntry* palettized : entry->palettized_entries)
+  {
+    if (!palettized->tmem_only && palettized->palette_hash == palette_hash &&
+        palettized->palette_format == tlutfmt && palettized->palette_size == palette_size)
+    {
+      return palettized;
+    }
+  }
+
   TextureConfig newconfig = entry->GetConfig();
   newconfig.rendertarget = true;
   newconfig.pcformat = PC_TEX_FMT_RGBA32;
@@ -273,8 +437,14 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::ApplyPaletteToEntry(TCacheEntry
     decoded_entry->is_efb_copy = false;
     g_texture_cache->LoadLut(tlutfmt, &texMem[tlutaddr], palette_size);
     auto iter = textures_by_address.emplace(entry->addr, decoded_entry);
+    AddToRangeIndex(decoded_entry);
     if (g_texture_cache->Palettize(decoded_entry, entry))
     {
+      decoded_entry->palette_base = entry;
+      decoded_entry->palette_hash = palette_hash;
+      decoded_entry->palette_format = tlutfmt;
+      decoded_entry->palette_size = palette_size;
+      entry->palettized_entries.push_back(decoded_entry);
       return decoded_entry;
     }
     InvalidateTexture(iter);
@@ -311,10 +481,9 @@ void TextureCacheBase::ScaleTextureCacheEntryTo(TextureCacheBase::TCacheEntry* e
 
     entry->texture.swap(new_texture);
 
-    auto config = new_texture->GetConfig();
     // At this point new_texture has the old texture in it,
     // we can potentially reuse this, so let's move it back to the pool
-    texture_pool.emplace(config, TexPoolEntry(std::move(new_texture)));
+    DisposeTexture(new_texture);
   }
   else
   {
@@ -333,27 +502,36 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u32 tlut
     return entry_to_update;
   entry_to_update->may_have_overlapping_textures = false;
 
+  // EFB copies can be updated by smaller copies made into them later, e.g. when a game builds
+  // an atlas out of several copies. Their format is an EFB copy format, which has no palette.
+  const bool update_efb_copy = entry_to_update->IsEfbCopy();
   const bool isPaletteTexture =
+      !update_efb_copy &&
       (entry_to_update->format == GX_TF_C4 || entry_to_update->format == GX_TF_C8 ||
        entry_to_update->format == GX_TF_C14X2 || entry_to_update->format >= 0x10000);
 
-  // Efb copies and paletted textures are excluded from these updates, until there's an example
-  // where a game would benefit from this. Both would require more work to be done.
-  if (entry_to_update->IsEfbCopy())
-    return entry_to_update;
-
   u32 block_width = TexDecoder::GetBlockWidthInTexels(entry_to_update->format & 0xf);
   u32 block_height = TexDecoder::GetBlockHeightInTexels(entry_to_update->format & 0xf);
   u32 block_size = block_width * block_height *
                    TexDecoder::GetTexelSizeInNibbles(entry_to_update->format & 0xf) / 2;
 
-  u32 numBlocksX = (entry_to_update->native_width + block_width - 1) / block_width;
+  // The rows of an EFB copy can be further apart in memory than its width.
+  u32 numBlocksX = update_efb_copy ?
+                       entry_to_update->memory_stride / block_size :
+                       (entry_to_update->native_width + block_width - 1) / block_width;
+  if (numBlocksX == 0)
+    return entry_to_update;
 
-  auto iter = FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes);
-  while (iter.first != iter.second)
+  // Apply the copies in the order they were made, so newer ones end up on top where they overlap.
+  Common::FrameArena::Vector<TCacheEntry*> copies =
+      FindOverlappingTextures(entry_to_update->addr, entry_to_update->size_in_bytes);
+  std::sort(copies.begin(), copies.end(),
+            [](const TCacheEntry* a, const TCacheEntry* b) { return a->id < b->id; });
+  for (TCacheEntry* entry : copies)
   {
-    TCacheEntry* entry = iter.first->second;
+    // An EFB copy only contains the copies made before it in the parts it doesn't cover itself.
     if (entry != entry_to_update && entry->IsEfbCopy() && !entry->tmem_only &&
+        (!update_efb_copy || entry->id > entry_to_update->id) &&
         entry->references.count(entry_to_update) == 0 &&
         entry->OverlapsMemoryRange(entry_to_update->addr, entry_to_update->size_in_bytes) &&
         entry->memory_stride == numBlocksX * block_size)
@@ -374,7 +552,6 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u32 tlut
           }
           else
           {
-            ++iter.first;
             continue;
           }
         }
@@ -403,6 +580,10 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u32 tlut
           dst_y = 0;
         }
 
+        // Blocks past the width of the texture are only padding in its rows.
+        if (dst_x >= entry_to_update->native_width || dst_y >= entry_to_update->native_height)
+          continue;
+
         u32 copy_width =
             std::min(entry->native_width - src_x, entry_to_update->native_width - dst_x);
         u32 copy_height =
@@ -438,6 +619,8 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u32 tlut
         dstrect.right = (dst_x + copy_width);
         dstrect.bottom = (dst_y + copy_height);
         entry_to_update->texture->CopyRectangleFromTexture(entry->texture.get(), srcrect, dstrect);
+        // The scaled version is generated from the texture data without this update.
+        CancelAsyncScale(entry_to_update);
 
         if (isPaletteTexture)
         {
@@ -456,36 +639,72 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u32 tlut
       else
       {
         // If the hash does not match, this EFB copy will not be used for anything, so remove it
-        iter.first = InvalidateTexture(iter.first);
-        continue;
+        InvalidateTexture(GetTexCacheIter(entry));
       }
     }
-    ++iter.first;
   }
   return entry_to_update;
 }
 
-void TextureCacheBase::DumpTexture(TCacheEntry* entry, std::string basename, u32 level)
+std::string TextureCacheBase::GetDumpFilename(const std::string& basename, u32 level)
 {
+  std::string name = basename;
+  if (level > 0)
+  {
+    name += StringFromFormat("_mip%i", level);
+  }
+  // The basename contains the hash, a texture that was seen before has been dumped already.
+  if (!m_dumped_textures.insert(name).second)
+    return {};
+
   std::string szDir = File::GetUserPath(D_DUMPTEXTURES_IDX) + SConfig::GetInstance().GetGameID();
 
   // make sure that the directory exists
   if (!File::Exists(szDir) || !File::IsDirectory(szDir))
     File::CreateDir(szDir);
 
-  if (level > 0)
-  {
-    basename += StringFromFormat("_mip%i", level);
-  }
-
   /*std::string filename = szDir + "/" + basename +
                          (TexDecoder::IsCompressed(entry->GetConfig().pcformat) ? ".dds" : ".png");*/
-  std::string filename = szDir + "/" + basename + ".png";
+  std::string filename = szDir + "/" + name + ".png";
+  if (File::Exists(filename))
+    return {};
+  return filename;
+}
 
-  if (!File::Exists(filename))
+void TextureCacheBase::DumpTexture(TCacheEntry* entry, std::string basename, u32 level)
+{
+  const std::string filename = GetDumpFilename(basename, level);
+  if (!filename.empty())
     entry->texture->Save(filename, level);
 }
 
+bool TextureCacheBase::DumpTextureData(const std::string& basename, u32 level, const u8* data,
+                                       u32 width, u32 height, u32 row_length,
+                                       HostTextureFormat format)
+{
+  if (format != PC_TEX_FMT_RGBA32 && format != PC_TEX_FMT_BGRA32)
+    return false;
+
+  std::string filename = GetDumpFilename(basename, level);
+  if (filename.empty())
+    return true;
+
+  // The decode buffer is reused right away.
+  auto pixels = std::make_shared<std::vector<u8>>(width * height * 4);
+  for (u32 y = 0; y < height; ++y)
+    std::memcpy(&(*pixels)[y * width * 4], data + y * row_length * 4, width * 4);
+
+  while (s_pending_dumps.load(std::memory_order_acquire) >= MAX_PENDING_DUMPS)
+    Common::YieldCPU();
+  s_pending_dumps.fetch_add(1, std::memory_order_relaxed);
+  const bool bgra = format == PC_TEX_FMT_BGRA32;
+  Common::AsyncWorker::ExecuteAsync([pixels, filename, width, height, bgra]() {
+    TextureToPng(pixels->data(), width * 4, filename, width, height, false, bgra);
+    s_pending_dumps.fetch_sub(1, std::memory_order_release);
+  });
+  return true;
+}
+
 // Used by TextureCacheBase::Load
 TextureCacheBase::TCacheEntry* TextureCacheBase::ReturnEntry(u32 stage, TCacheEntry* entry)
 {
@@ -606,6 +825,17 @@ void TextureCacheBase::LoadEnviromentTexture(std::string basename)
 
 TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
 {
+  TRACE_SCOPE("TextureCacheBase::Load");
+  ApplyAsyncScaleResults();
+
+  // Look up the bound textures again when streamed custom textures arrived
+  const u64 stream_generation = HiresTexture::GetStreamGeneration();
+  if (stream_generation != m_hires_stream_generation)
+  {
+    m_hires_stream_generation = stream_generation;
+    InvalidateAllBindPoints();
+  }
+
   // if this stage was not invalidated by changes to texture registers, keep the current texture
   if (IsValidBindPoint(stage) && bound_textures[stage])
   {
@@ -754,6 +984,13 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
       ++iter;
       continue;
     }
+    // Reload entries that were missing their custom texture once streamed textures arrived
+    if (entry->hires_pending_generation != 0 &&
+        entry->hires_pending_generation != HiresTexture::GetStreamGeneration())
+    {
+      iter = InvalidateTexture(iter);
+      continue;
+    }
     // Do not load strided EFB copies, they are not meant to be used directly
     if (entry->IsEfbCopy() && entry->native_width >= nativeW && entry->native_height >= nativeH &&
         entry->memory_stride == entry->BytesPerRow())
@@ -769,7 +1006,11 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
         // texture formats. I'm not sure what effect checking width/height/levels
         // would have.
         if (!isPaletteTexture)
+        {
+          INCSTAT(stats.thisFrame.numTextureCacheHits);
+          entry = DoPartialTextureUpdates(entry, tlutaddr, tlutfmt, palette_size);
           return ReturnEntry(stage, entry);
+        }
         // Note that we found an unconverted EFB copy, then continue. We'll
         // perform the conversion later. Currently, we only convert EFB copies to
         // palette textures; we could do other conversions if it proved to be
@@ -793,6 +1034,7 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
           entry->native_levels >= tex_levels && entry->native_width == nativeW &&
           entry->native_height == nativeH)
       {
+        INCSTAT(stats.thisFrame.numTextureCacheHits);
         entry = DoPartialTextureUpdates(iter->second, tlutaddr, tlutfmt, palette_size);
         return ReturnEntry(stage, entry);
       }
@@ -813,17 +1055,25 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   std::string basename;
   if (unconverted_copy != textures_by_address.end())
   {
-    g_texture_cache->LoadLut(tlutfmt, &texMem[tlutaddr], palette_size);
-    // Perform palette decoding.
+    // Perform palette decoding, unless the copy was already used with this palette.
     TCacheEntry* decoded_entry =
         ApplyPaletteToEntry(unconverted_copy->second, tlutaddr, tlutfmt, palette_size);
 
     if (decoded_entry)
     {
+      INCSTAT(stats.thisFrame.numTextureCacheHits);
       return ReturnEntry(stage, decoded_entry);
     }
   }
 
+  // Everything below decodes memory, so deferred EFB copies in the texture have to be there first.
+  // The EFB copy entries above are hashed against the old memory until then.
+  if (!from_tmem && !m_pending_efb_copies.empty() &&
+      FlushPendingEFBCopies(address, texture_size + additional_mips_size))
+  {
+    return Load(stage);
+  }
+
   // Search the texture cache for normal textures by hash
   //
   // If the texture was fully hashed, the address does not need to match. Identical duplicate
@@ -840,8 +1090,11 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
       TCacheEntry* entry = hash_iter->second;
       // All parameters, except the address, need to match here
       if (entry->format == full_format && entry->native_levels >= tex_levels &&
-          entry->native_width == nativeW && entry->native_height == nativeH)
+          entry->native_width == nativeW && entry->native_height == nativeH &&
+          (entry->hires_pending_generation == 0 ||
+           entry->hires_pending_generation == HiresTexture::GetStreamGeneration()))
       {
+        INCSTAT(stats.thisFrame.numTextureCacheHits);
         entry = DoPartialTextureUpdates(hash_iter->second, tlutaddr, tlutfmt, palette_size);
         return ReturnEntry(stage, entry);
       }
@@ -849,6 +1102,8 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
     }
   }
 
+  INCSTAT(stats.thisFrame.numTextureCacheMisses);
+
   // If at least one entry was not used for the same frame, overwrite the oldest one
   if (temp_frameCount != 0x7fffffff)
   {
@@ -857,6 +1112,7 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   }
 
   std::shared_ptr<HiresTexture> hires_tex;
+  bool hires_pending = false;
   if (g_ActiveConfig.bHiresTextures || g_ActiveConfig.bDumpTextures)
   {
     basename =
@@ -865,10 +1121,12 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   }
   if (g_ActiveConfig.bHiresTextures)
   {
-    hires_tex = HiresTexture::Search(basename, [this](size_t required_size) {
-      this->CheckTempSize(required_size);
-      return this->temp;
-    });
+    hires_tex = HiresTexture::Search(basename,
+                                     [this](size_t required_size) {
+                                       this->CheckTempSize(required_size);
+                                       return this->temp;
+                                     },
+                                     &hires_pending);
     if (hires_tex)
     {
       if (hires_tex->m_width != width || hires_tex->m_height != height)
@@ -886,10 +1144,12 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
           HiresTexture::GenBaseName(src_data, texture_size, &texMem[tlutaddr], 0, width, height,
                                     texformat, use_mipmaps, g_ActiveConfig.bDumpTextures);
 
-      hires_tex = HiresTexture::Search(tempname, [this](size_t required_size) {
-        this->CheckTempSize(required_size);
-        return this->temp;
-      });
+      hires_tex = HiresTexture::Search(tempname,
+                                       [this](size_t required_size) {
+                                         this->CheckTempSize(required_size);
+                                         return this->temp;
+                                       },
+                                       &hires_pending);
       if (hires_tex)
       {
         if (hires_tex->m_width != width || hires_tex->m_height != height)
@@ -913,8 +1173,24 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   }
   // how many levels the allocated texture shall have
   const u32 texLevels = hires_tex ? hires_tex->m_levels : tex_levels;
-  const bool use_scaling =
-      (g_ActiveConfig.iTexScalingType > 0) && !hires_tex && (width < 384) && (height < 384);
+  // Don't bother scaling textures that are about to be replaced by their custom version
+  const bool use_scaling = (g_ActiveConfig.iTexScalingType > 0) && !hires_tex && !hires_pending &&
+                           (width < 384) && (height < 384);
+  // Scaled textures are only kept on disk if the hash covers the whole texture
+  const bool cache_scaled =
+      use_scaling && g_ActiveConfig.bTexScalingCache &&
+      (g_ActiveConfig.iSafeTextureCache_ColorSamples == 0 ||
+       std::max(texture_size, palette_size) <=
+           (u32)g_ActiveConfig.iSafeTextureCache_ColorSamples * 8);
+  // Upload at native resolution now and swap in the scaled texture once it's ready, unless it can
+  // be read back from the disk cache right away
+  const bool scale_async =
+      use_scaling && g_ActiveConfig.bTexScalingAsync &&
+      !(cache_scaled &&
+        ScaledTextureCache::Contains(GetScaledTextureKey(
+            full_hash, full_format, 0, expandedWidth, height, g_ActiveConfig.iTexScalingType,
+            g_ActiveConfig.iTexScalingFactor, g_ActiveConfig.bTexDeposterize)));
+  std::vector<AsyncScaleLevel> async_scale_levels;
   // We can decode on the GPU if it is a supported format and the flag is enabled.
   // Currently we don't decode RGBA8 textures from Tmem, as that would require copying from both
   // banks, and if we're doing an copy we may as well just do the whole thing on the CPU, since
@@ -924,7 +1200,9 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
       !hires_tex && !use_scaling && g_ActiveConfig.UseGPUTextureDecoding() &&
       g_texture_cache->SupportsGPUTextureDecode(static_cast<TextureFormat>(texformat),
                                                 static_cast<TlutFormat>(tlutfmt)) &&
-      !(from_tmem && texformat == GX_TF_RGBA8);
+      !(from_tmem && texformat == GX_TF_RGBA8) &&
+      // CMPR is uploaded as is where the backend supports DXT, the shaders only write RGBA8.
+      (texformat != GX_TF_CMPR || pcfmt == PC_TEX_FMT_RGBA32);
 
   // create the entry/texture
   TextureConfig config;
@@ -940,8 +1218,11 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
   config.layers += emissivematerial ? 1 : 0;
   if (use_scaling)
   {
-    config.width *= g_ActiveConfig.iTexScalingFactor;
-    config.height *= g_ActiveConfig.iTexScalingFactor;
+    if (!scale_async)
+    {
+      config.width *= g_ActiveConfig.iTexScalingFactor;
+      config.height *= g_ActiveConfig.iTexScalingFactor;
+    }
     config.pcformat = PC_TEX_FMT_RGBA32;
   }
   TCacheEntry* entry = AllocateCacheEntry(config, materialmap);
@@ -957,10 +1238,13 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
 
   entry->SetGeneralParameters(address, texture_size, full_format);
   entry->SetDimensions(nativeW, nativeH, tex_levels);
-  entry->SetHiresParams(!!hires_tex, basename, use_scaling, emissivematerial,
+  AddToRangeIndex(entry);
+  entry->SetHiresParams(!!hires_tex, basename, use_scaling && !scale_async, emissivematerial,
                         !!hires_tex && hires_tex->has_arbitrary_mips, false);
   entry->SetHashes(full_hash, tex_hash);
   entry->is_efb_copy = false;
+  if (hires_pending)
+    entry->hires_pending_generation = HiresTexture::GetStreamGeneration();
 
   // load texture
   if (hires_tex)
@@ -1014,6 +1298,8 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
       ptr_odd = &texMem[bpmem.tex[stage / 4].texImage2[stage % 4].tmem_odd * TMEM_LINE_SIZE];
     }
 
+    // Set when the level was dumped from its decoded data.
+    bool dumped = false;
     if (decode_on_gpu)
     {
       u32 row_stride = bytes_per_block * (expandedWidth / bsw);
@@ -1041,17 +1327,31 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
                            PC_TEX_FMT_RGBA32 == config.pcformat,
                            config.pcformat >= PC_TEX_FMT_DXT1);
       }
-      if (use_scaling)
+      if (g_ActiveConfig.bDumpTextures)
+      {
+        dumped = DumpTextureData(basename, 0, texturedata, width, height, expandedWidth,
+                                 config.pcformat);
+      }
+      if (scale_async)
       {
+        const u32* pixels = reinterpret_cast<const u32*>(texturedata);
+        async_scale_levels.push_back(
+            {std::vector<u32>(pixels, pixels + expandedWidth * height), width, height, expandedWidth});
+      }
+      else if (use_scaling)
+      {
+        const ScaledTextureCache::Key key = GetScaledTextureKey(
+            full_hash, full_format, 0, expandedWidth, height, g_ActiveConfig.iTexScalingType,
+            g_ActiveConfig.iTexScalingFactor, g_ActiveConfig.bTexDeposterize);
         texturedata =
-            reinterpret_cast<u8*>(m_scaler->Scale((u32*)texturedata, expandedWidth, height));
+            ScaleTexture(texturedata, expandedWidth, height, cache_scaled ? &key : nullptr);
         twidth *= g_ActiveConfig.iTexScalingFactor;
         theight *= g_ActiveConfig.iTexScalingFactor;
         texpandedWidth *= g_ActiveConfig.iTexScalingFactor;
       }
       entry->texture->Load(texturedata, twidth, theight, texpandedWidth, 0, 0);
     }
-    if (g_ActiveConfig.bDumpTextures)
+    if (g_ActiveConfig.bDumpTextures && !dumped)
     {
       DumpTexture(entry, basename, 0);
     }
@@ -1066,6 +1366,7 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
       const u32 mip_size =
           TexDecoder::GetTextureSizeInBytes(expanded_mip_width, expanded_mip_height, texformat);
       const u8*& mip_src_data = from_tmem ? ((level % 2) ? ptr_odd : ptr_even) : src_data;
+      bool dumped = false;
       if (decode_on_gpu)
       {
         u32 row_stride = bytes_per_block * (expanded_mip_width / bsw);
@@ -1084,10 +1385,26 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
                            texformat, tlutaddr, static_cast<TlutFormat>(tlutfmt),
                            PC_TEX_FMT_RGBA32 == config.pcformat,
                            config.pcformat >= PC_TEX_FMT_DXT1);
-        if (use_scaling)
+        if (g_ActiveConfig.bDumpTextures)
+        {
+          dumped = DumpTextureData(basename, level, texturedata, mip_width, mip_height,
+                                   expanded_mip_width, config.pcformat);
+        }
+        if (scale_async)
         {
-          texturedata =
-              reinterpret_cast<u8*>(m_scaler->Scale((u32*)texturedata, expandedWidth, height));
+          const u32* pixels = reinterpret_cast<const u32*>(texturedata);
+          async_scale_levels.push_back(
+              {std::vector<u32>(pixels, pixels + expanded_mip_width * mip_height), mip_width,
+               mip_height, expanded_mip_width});
+        }
+        else if (use_scaling)
+        {
+          const ScaledTextureCache::Key key = GetScaledTextureKey(
+              full_hash, full_format, level, expanded_mip_width, mip_height,
+              g_ActiveConfig.iTexScalingType, g_ActiveConfig.iTexScalingFactor,
+              g_ActiveConfig.bTexDeposterize);
+          texturedata = ScaleTexture(texturedata, expanded_mip_width, mip_height,
+                                     cache_scaled ? &key : nullptr);
           twidth *= g_ActiveConfig.iTexScalingFactor;
           theight *= g_ActiveConfig.iTexScalingFactor;
           texpandedWidth *= g_ActiveConfig.iTexScalingFactor;
@@ -1097,12 +1414,16 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
       mip_src_data +=
           TexDecoder::GetTextureSizeInBytes(expanded_mip_width, expanded_mip_height, texformat);
 
-      if (g_ActiveConfig.bDumpTextures)
+      if (g_ActiveConfig.bDumpTextures && !dumped)
         DumpTexture(entry, basename, level);
     }
   }
 
+  if (!async_scale_levels.empty())
+    QueueAsyncScale(entry, std::move(async_scale_levels), cache_scaled, full_hash, full_format);
+
   INCSTAT(stats.numTexturesCreated);
+  INCSTAT(stats.thisFrame.numTextureUploads);
   SETSTAT(stats.numTexturesAlive, textures_by_address.size());
   entry = DoPartialTextureUpdates(iter->second, tlutaddr, tlutfmt, palette_size);
   return ReturnEntry(stage, entry);
@@ -1112,6 +1433,8 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
                                                  bool is_depth_copy, const EFBRectangle& srcRect,
                                                  bool isIntensity, bool scaleByHalf)
 {
+  RenderTimeScope render_time;
+
   // Emulation methods:
   //
   // - EFB to RAM:
@@ -1460,16 +1783,6 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
     c_tex_h = g_renderer->EFBToScaledY(c_tex_h);
   }
 
-  // remove all texture cache entries at dstAddr
-  {
-    auto iter_range = textures_by_address.equal_range(dstAddr);
-    TexAddrCache::iterator iter = iter_range.first;
-    while (iter != iter_range.second)
-    {
-      iter = InvalidateTexture(iter);
-    }
-  }
-
   // Get the base (in memory) format of this efb copy.
   u32 baseFormat = TexDecoder::GetEfbCopyBaseFormat(dstFormat);
 
@@ -1499,6 +1812,45 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
                                   tex_h != 1 && (dstFormat == 6 || dstFormat == 32));
   }
 
+  EFBCopyRecord record = {dstAddr,
+                          covered_range,
+                          dstFormat,
+                          dstStride,
+                          srcRect,
+                          bpmem.triggerEFBCopy.Hex,
+                          srcFormat,
+                          is_depth_copy,
+                          copy_to_ram,
+                          g_renderer->GetTargetWidth(),
+                          g_renderer->GetTargetHeight(),
+                          scaled_tex_w,
+                          scaled_tex_h,
+                          0};
+  // The fifo recorder needs to see every copy to mark its memory.
+  if (g_ActiveConfig.bSkipRedundantEFBCopies && !g_bRecordFifoData && IsRedundantEFBCopy(record))
+  {
+    INCSTAT(stats.thisFrame.numEFBCopiesSkipped);
+    return;
+  }
+
+  // This copy replaces or overlaps the destination of any copy recorded there.
+  m_efb_copy_records.erase(
+      std::remove_if(m_efb_copy_records.begin(), m_efb_copy_records.end(),
+                     [dstAddr, covered_range](const EFBCopyRecord& r) {
+                       return r.addr < dstAddr + covered_range && dstAddr < r.addr + r.covered_range;
+                     }),
+      m_efb_copy_records.end());
+
+  // remove all texture cache entries at dstAddr
+  {
+    auto iter_range = textures_by_address.equal_range(dstAddr);
+    TexAddrCache::iterator iter = iter_range.first;
+    while (iter != iter_range.second)
+    {
+      iter = InvalidateTexture(iter);
+    }
+  }
+
   bool copy_to_vram = true;
   // Only apply triggered post-processing on specific formats, to avoid false positives.
   // Skip depth copies, single-channel textures (basically RGB565/RGB5A3/RGBA8 only)
@@ -1510,11 +1862,37 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
       g_renderer->GetPostProcessor()->OnEFBCopy(&targetSource);
     }
   }
+  INCSTAT(stats.thisFrame.numEFBCopies);
+  // Older deferred copies must not land on top of this one.
+  if (!m_pending_efb_copies.empty())
+    FlushPendingEFBCopies(dstAddr, covered_range);
   if (copy_to_ram)
   {
     EFBCopyFormat format(srcFormat, static_cast<TextureFormat>(dstFormat));
-    CopyEFB(dst, format, tex_w, bytes_per_row, num_blocks_y, dstStride, is_depth_copy, srcRect,
-            scaleByHalf);
+    std::unique_ptr<PendingEFBCopy> pending_copy;
+    if (g_ActiveConfig.bDeferEFBCopies)
+    {
+      pending_copy = CopyEFBDeferred(format, tex_w, bytes_per_row, num_blocks_y, dstStride,
+                                     is_depth_copy, srcRect, scaleByHalf);
+    }
+    if (pending_copy)
+    {
+      pending_copy->addr = dstAddr;
+      pending_copy->bytes_per_row = bytes_per_row;
+      pending_copy->num_blocks_y = num_blocks_y;
+      pending_copy->memory_stride = dstStride;
+      m_pending_efb_copies.push_back(std::move(pending_copy));
+      if (m_pending_efb_copies.size() > MAX_PENDING_EFB_COPIES)
+      {
+        WritePendingEFBCopy(m_pending_efb_copies.front().get());
+        m_pending_efb_copies.erase(m_pending_efb_copies.begin());
+      }
+    }
+    else
+    {
+      CopyEFB(dst, format, tex_w, bytes_per_row, num_blocks_y, dstStride, is_depth_copy, srcRect,
+              scaleByHalf);
+    }
   }
   else
   {
@@ -1561,20 +1939,12 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
   // TODO: This also invalidates partial overlaps, which we currently don't have a better way
   //       of dealing with.
   bool invalidate_textures = dstStride == bytes_per_row || !copy_to_vram;
-  auto iter = FindOverlappingTextures(dstAddr, covered_range);
-  while (iter.first != iter.second)
+  for (TCacheEntry* entry : FindOverlappingTextures(dstAddr, covered_range))
   {
-    TCacheEntry* entry = iter.first->second;
-    if (entry->OverlapsMemoryRange(dstAddr, covered_range))
-    {
-      if (invalidate_textures)
-      {
-        iter.first = InvalidateTexture(iter.first);
-        continue;
-      }
+    if (invalidate_textures)
+      InvalidateTexture(GetTexCacheIter(entry));
+    else
       entry->may_have_overlapping_textures = true;
-    }
-    ++iter.first;
   }
 
   if (copy_to_vram)
@@ -1615,6 +1985,113 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32
       }
 
       textures_by_address.emplace(dstAddr, entry);
+      AddToRangeIndex(entry);
+
+      if (g_ActiveConfig.bSkipRedundantEFBCopies)
+      {
+        record.entry_id = entry->id;
+        if (m_efb_copy_records.size() >= MAX_EFB_COPY_RECORDS)
+          m_efb_copy_records.erase(m_efb_copy_records.begin());
+        m_efb_copy_records.push_back(record);
+      }
+    }
+  }
+}
+
+bool TextureCacheBase::IsRedundantEFBCopy(const EFBCopyRecord& copy)
+{
+  auto record = std::find_if(m_efb_copy_records.begin(), m_efb_copy_records.end(),
+                             [&copy](const EFBCopyRecord& r) { return r.addr == copy.addr; });
+  if (record == m_efb_copy_records.end() || record->covered_range != copy.covered_range ||
+      record->format != copy.format || record->stride != copy.stride ||
+      !(record->rect == copy.rect) || record->copy_params != copy.copy_params ||
+      record->src_format != copy.src_format || record->is_depth_copy != copy.is_depth_copy ||
+      record->copy_to_ram != copy.copy_to_ram || record->target_width != copy.target_width ||
+      record->target_height != copy.target_height || record->scaled_width != copy.scaled_width ||
+      record->scaled_height != copy.scaled_height)
+  {
+    return false;
+  }
+
+  auto iter_range = textures_by_address.equal_range(copy.addr);
+  for (auto iter = iter_range.first; iter != iter_range.second; ++iter)
+  {
+    TCacheEntry* entry = iter->second;
+    if (entry->id != record->entry_id)
+      continue;
+
+    // The previous copy may still be pending, its hash is only updated once it is written.
+    if (!m_pending_efb_copies.empty())
+      FlushPendingEFBCopies(copy.addr, copy.covered_range);
+    return entry->IsEfbCopy() && entry->hash == entry->CalculateHash();
+  }
+  return false;
+}
+
+void TextureCacheBase::OnEFBModified(const EFBRectangle& rect)
+{
+  if (m_efb_copy_records.empty())
+    return;
+
+  // Scaled rectangles are rounded, so a draw next to a copy may still reach its edge.
+  m_efb_copy_records.erase(std::remove_if(m_efb_copy_records.begin(), m_efb_copy_records.end(),
+                                          [&rect](const EFBCopyRecord& r) {
+                                            return r.rect.left <= rect.right &&
+                                                   rect.left <= r.rect.right &&
+                                                   r.rect.top <= rect.bottom &&
+                                                   rect.top <= r.rect.bottom;
+                                          }),
+                           m_efb_copy_records.end());
+}
+
+void TextureCacheBase::OnEFBModified()
+{
+  m_efb_copy_records.clear();
+}
+
+bool TextureCacheBase::FlushPendingEFBCopies(u32 address, u32 size)
+{
+  bool flushed = false;
+  auto iter = m_pending_efb_copies.begin();
+  while (iter != m_pending_efb_copies.end())
+  {
+    PendingEFBCopy* copy = iter->get();
+    if (copy->addr < address + size && address < copy->addr + copy->GetCoveredRange())
+    {
+      WritePendingEFBCopy(copy);
+      iter = m_pending_efb_copies.erase(iter);
+      flushed = true;
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+  return flushed;
+}
+
+void TextureCacheBase::FlushAllPendingEFBCopies()
+{
+  for (auto& copy : m_pending_efb_copies)
+    WritePendingEFBCopy(copy.get());
+  m_pending_efb_copies.clear();
+}
+
+void TextureCacheBase::WritePendingEFBCopy(PendingEFBCopy* copy)
+{
+  u8* dst = Memory::GetPointer(copy->addr);
+  if (dst)
+    copy->WriteToMemory(dst);
+
+  // The copy in VRAM was hashed against what memory held before.
+  auto iter_range = textures_by_address.equal_range(copy->addr);
+  for (auto iter = iter_range.first; iter != iter_range.second; ++iter)
+  {
+    TCacheEntry* entry = iter->second;
+    if (entry->IsEfbCopy())
+    {
+      u64 hash = entry->CalculateHash();
+      entry->SetHashes(hash, hash);
     }
   }
 }
@@ -1625,15 +2102,16 @@ std::unique_ptr<HostTexture> TextureCacheBase::AllocateTexture(const TextureConf
   std::unique_ptr<HostTexture> entry;
   if (iter != texture_pool.end())
   {
+    texture_pool_idle_memory -= config.GetSizeInBytes();
     entry = std::move(iter->second.texture);
     texture_pool.erase(iter);
   }
   else
   {
     entry = CreateTexture(config);
-    texture_pool_memory_usage += config.GetSizeInBytes();
     if (!entry)
       return nullptr;
+    texture_pool_memory_usage += config.GetSizeInBytes();
 
     INCSTAT(stats.numTexturesCreated);
   }
@@ -1651,28 +2129,164 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::AllocateCacheEntry(const Textur
   }
   TCacheEntry* cacheEntry = new TCacheEntry(std::move(texture), materialmap, luma);
   cacheEntry->textures_by_hash_iter = textures_by_hash.end();
+  cacheEntry->id = m_next_entry_id++;
   return cacheEntry;
 }
 
 void TextureCacheBase::DisposeTexture(std::unique_ptr<HostTexture>& texture)
 {
   auto config = texture->GetConfig();
+  texture_pool_idle_memory += config.GetSizeInBytes();
   texture_pool.emplace(config, TexPoolEntry(std::move(texture)));
 }
 
 void TextureCacheBase::DisposeCacheEntry(TCacheEntry* entry)
 {
+  CancelAsyncScale(entry);
+  if (entry->palette_base)
+  {
+    auto& siblings = entry->palette_base->palettized_entries;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), entry), siblings.end());
+  }
+  // The conversions stay around as normal textures until they are invalidated or unused.
+  for (TCacheEntry* palettized : entry->palettized_entries)
+    palettized->palette_base = nullptr;
   if (entry->textures_by_hash_iter != textures_by_hash.end())
   {
     textures_by_hash.erase(entry->textures_by_hash_iter);
     entry->textures_by_hash_iter = textures_by_hash.end();
   }
 
-  auto config = entry->texture->GetConfig();
-  texture_pool.emplace(config, TexPoolEntry(std::move(entry->texture)));
+  DisposeTexture(entry->texture);
   delete entry;
 }
 
+u8* TextureCacheBase::ScaleTexture(u8* data, u32 width, u32 height,
+                                   const ScaledTextureCache::Key* key)
+{
+  const u32 factor = g_ActiveConfig.iTexScalingFactor;
+  const u32 size = width * height * factor * factor * sizeof(u32);
+  if (key)
+  {
+    m_scaled_texture_buffer.resize(size / sizeof(u32));
+    if (ScaledTextureCache::Lookup(*key, m_scaled_texture_buffer.data(), size))
+      return reinterpret_cast<u8*>(m_scaled_texture_buffer.data());
+  }
+
+  u32* scaled = m_scaler->Scale(reinterpret_cast<u32*>(data), width, height);
+  if (key)
+    ScaledTextureCache::Store(*key, scaled, size);
+  return reinterpret_cast<u8*>(scaled);
+}
+
+void TextureCacheBase::QueueAsyncScale(TCacheEntry* entry, std::vector<AsyncScaleLevel>&& levels,
+                                       bool cache, u64 hash, u32 format)
+{
+  auto job = std::make_shared<AsyncScaleJob>();
+  job->id = ++m_async_scale_next_id;
+  job->factor = g_ActiveConfig.iTexScalingFactor;
+  job->type = g_ActiveConfig.iTexScalingType;
+  job->deposterize = g_ActiveConfig.bTexDeposterize;
+  job->cache = cache;
+  job->hash = hash;
+  job->format = format;
+  job->levels = std::move(levels);
+
+  entry->async_scale_id = job->id;
+  m_async_scale_entries.emplace(job->id, entry);
+
+  std::shared_ptr<AsyncScaleState> state = m_async_scale_state;
+  Common::AsyncWorker::ExecuteAsync([state, job]() {
+    if (state->shutdown.load())
+      return;
+
+    std::unique_ptr<TextureScaler> scaler;
+    {
+      std::lock_guard<std::mutex> guard(state->lock);
+      if (!state->idle_scalers.empty())
+      {
+        scaler = std::move(state->idle_scalers.back());
+        state->idle_scalers.pop_back();
+      }
+    }
+    if (!scaler)
+      scaler = std::make_unique<TextureScaler>();
+
+    const u32 area = job->factor * job->factor;
+    for (u32 i = 0; i < job->levels.size(); ++i)
+    {
+      AsyncScaleLevel& level = job->levels[i];
+      const u32* scaled =
+          scaler->Scale(level.data.data(), level.expanded_width, level.height, job->factor,
+                        job->type, job->deposterize);
+      level.data.assign(scaled, scaled + level.expanded_width * level.height * area);
+      if (job->cache)
+      {
+        ScaledTextureCache::Store(
+            GetScaledTextureKey(job->hash, job->format, i, level.expanded_width, level.height,
+                                job->type, job->factor, job->deposterize),
+            level.data.data(), static_cast<u32>(level.data.size() * sizeof(u32)));
+      }
+    }
+
+    std::lock_guard<std::mutex> guard(state->lock);
+    state->idle_scalers.push_back(std::move(scaler));
+    state->results.push_back(job);
+    state->has_results.store(true, std::memory_order_release);
+  });
+}
+
+void TextureCacheBase::ApplyAsyncScaleResults()
+{
+  if (!m_async_scale_state->has_results.load(std::memory_order_acquire))
+    return;
+
+  std::vector<std::shared_ptr<AsyncScaleJob>> results;
+  {
+    std::lock_guard<std::mutex> guard(m_async_scale_state->lock);
+    results.swap(m_async_scale_state->results);
+    m_async_scale_state->has_results.store(false, std::memory_order_relaxed);
+  }
+
+  for (const std::shared_ptr<AsyncScaleJob>& job : results)
+  {
+    // The entry may have been invalidated or partially updated in the meantime.
+    auto iter = m_async_scale_entries.find(job->id);
+    if (iter == m_async_scale_entries.end())
+      continue;
+    TCacheEntry* entry = iter->second;
+    m_async_scale_entries.erase(iter);
+    entry->async_scale_id = 0;
+
+    TextureConfig config = entry->GetConfig();
+    config.width *= job->factor;
+    config.height *= job->factor;
+    std::unique_ptr<HostTexture> texture = AllocateTexture(config);
+    if (!texture)
+      continue;
+
+    for (u32 level = 0; level < job->levels.size(); ++level)
+    {
+      const AsyncScaleLevel& scaled = job->levels[level];
+      texture->Load(reinterpret_cast<const u8*>(scaled.data.data()), scaled.width * job->factor,
+                    scaled.height * job->factor, scaled.expanded_width * job->factor, level, 0);
+    }
+    INCSTAT(stats.thisFrame.numTextureUploads);
+    // Only the entry is bound, the new texture is picked up by the next BindTextures().
+    DisposeTexture(entry->texture);
+    entry->texture = std::move(texture);
+    entry->is_scaled = true;
+  }
+}
+
+void TextureCacheBase::CancelAsyncScale(TCacheEntry* entry)
+{
+  if (entry->async_scale_id == 0)
+    return;
+  m_async_scale_entries.erase(entry->async_scale_id);
+  entry->async_scale_id = 0;
+}
+
 TextureCacheBase::TexPool::iterator
 TextureCacheBase::FindMatchingTextureFromPool(const TextureConfig& config)
 {
@@ -1721,25 +2335,63 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter)
       return ++iter;
     }
   }
+  RemoveFromRangeIndex(iter->second);
   DisposeCacheEntry(iter->second);
   return textures_by_address.erase(iter);
 }
 
-std::pair<TextureCacheBase::TexAddrCache::iterator, TextureCacheBase::TexAddrCache::iterator>
+std::pair<u32, u32> TextureCacheBase::GetRangeIndexPages(u32 addr, u32 size_in_bytes)
+{
+  const u32 last_addr = size_in_bytes ? addr + size_in_bytes - 1 : addr;
+  return std::make_pair(addr >> RANGE_INDEX_PAGE_SHIFT, last_addr >> RANGE_INDEX_PAGE_SHIFT);
+}
+
+void TextureCacheBase::AddToRangeIndex(TCacheEntry* entry)
+{
+  const auto pages = GetRangeIndexPages(entry->addr, entry->size_in_bytes);
+  for (u32 page = pages.first; page <= pages.second; ++page)
+    textures_by_page[page].push_back(entry);
+}
+
+void TextureCacheBase::RemoveFromRangeIndex(TCacheEntry* entry)
+{
+  const auto pages = GetRangeIndexPages(entry->addr, entry->size_in_bytes);
+  for (u32 page = pages.first; page <= pages.second; ++page)
+  {
+    auto bucket = textures_by_page.find(page);
+    if (bucket == textures_by_page.end())
+      continue;
+    std::vector<TCacheEntry*>& entries = bucket->second;
+    auto iter = std::find(entries.begin(), entries.end(), entry);
+    if (iter != entries.end())
+    {
+      *iter = entries.back();
+      entries.pop_back();
+    }
+    if (entries.empty())
+      textures_by_page.erase(bucket);
+  }
+}
+
+Common::FrameArena::Vector<TextureCacheBase::TCacheEntry*>
 TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
 {
-  // We index by the starting address only, so there is no way to query all textures
-  // which end after the given addr. But the GC textures have a limited size, so we
-  // look for all textures which have a start address bigger than addr minus the maximal
-  // texture size. But this yields false-positives which must be checked later on.
-
-  // 1024 x 1024 texel times 8 nibbles per texel
-  constexpr u32 max_texture_size = 1024 * 1024 * 4;
-  u32 lower_addr = addr > max_texture_size ? addr - max_texture_size : 0;
-  auto begin = textures_by_address.lower_bound(lower_addr);
-  auto end = textures_by_address.upper_bound(addr + size_in_bytes);
-
-  return std::make_pair(begin, end);
+  Common::FrameArena::Vector<TCacheEntry*> result;
+  const auto pages = GetRangeIndexPages(addr, size_in_bytes);
+  for (u32 page = pages.first; page <= pages.second; ++page)
+  {
+    auto bucket = textures_by_page.find(page);
+    if (bucket == textures_by_page.end())
+      continue;
+    for (TCacheEntry* entry : bucket->second)
+    {
+      // Entries spanning several of the pages are only reported from the first one
+      const u32 first_page = std::max(entry->addr >> RANGE_INDEX_PAGE_SHIFT, pages.first);
+      if (first_page == page && entry->OverlapsMemoryRange(addr, size_in_bytes))
+        result.push_back(entry);
+    }
+  }
+  return result;
 }
 
 u32 TextureCacheBase::TCacheEntry::BytesPerRow() const
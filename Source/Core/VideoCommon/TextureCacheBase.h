@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/FrameArena.h"
 #include "Common/Thread.h"
 
 #include "VideoCommon/BPMemory.h"
@@ -24,6 +25,10 @@
 
 struct VideoConfig;
 class TextureScaler;
+namespace ScaledTextureCache
+{
+struct Key;
+}
 
 enum TextureCacheParams
 {
@@ -63,6 +68,13 @@ public:
     bool emissive = false;
     bool may_have_overlapping_textures = true;
     bool tmem_only = false;  // indicates that this texture only exists in the tmem cache
+    // Increases with every allocated entry, newer EFB copies are applied on top of older ones.
+    u64 id = 0;
+    // Nonzero while a scaled version of this texture is being generated in the background
+    u64 async_scale_id = 0;
+    // Stream generation at the time this entry was loaded without its custom texture, which
+    // was still streaming in. Zero otherwise.
+    u64 hires_pending_generation = 0;
 
     // Keep an iterator to the entry in textures_by_hash, so it does not need to be searched when
     // removing the cache entry
@@ -73,6 +85,15 @@ public:
     //   * partially updated textures which refer to this efb copy
     std::unordered_set<TCacheEntry*> references;
 
+    // Palette conversions of this EFB copy. Each of them remembers the copy it was made from and
+    // the palette it was made with, so using the copy with the same palette again doesn't need
+    // another conversion.
+    std::vector<TCacheEntry*> palettized_entries;
+    TCacheEntry* palette_base = nullptr;
+    u64 palette_hash = 0;
+    u32 palette_format = 0;
+    u32 palette_size = 0;
+
     std::string basename;
 
     explicit TCacheEntry(std::unique_ptr<HostTexture> tex, bool material = false,
@@ -141,6 +162,22 @@ public:
     const TextureConfig GetConfig() const { return texture->GetConfig(); }
   };
 
+  // An EFB copy to RAM that is still on its way back from the GPU, see CopyEFBDeferred.
+  class PendingEFBCopy
+  {
+  public:
+    virtual ~PendingEFBCopy() = default;
+    // Waits for the GPU and writes num_blocks_y rows of bytes_per_row bytes, memory_stride apart.
+    virtual void WriteToMemory(u8* dst) = 0;
+
+    u32 GetCoveredRange() const { return num_blocks_y * memory_stride; }
+
+    u32 addr = 0;
+    u32 bytes_per_row = 0;
+    u32 num_blocks_y = 0;
+    u32 memory_stride = 0;
+  };
+
   virtual ~TextureCacheBase();  // needs virtual for DX11 dtor
 
   void OnConfigChanged(VideoConfig& config);
@@ -148,6 +185,9 @@ public:
   // frameCount is the current frame number.
   void Cleanup(s32 _frameCount);
   void Invalidate();
+  // Invalidate() for a loaded savestate which keeps the textures decoded from memory. They are
+  // checked against their hash on the next use, so only the ones that still match are reused.
+  void InvalidateForStateLoad();
 
   virtual HostTextureFormat GetHostTextureFormat(const s32 texformat, const TlutFormat tlutfmt,
                                                  u32 width, u32 height) = 0;
@@ -156,6 +196,21 @@ public:
   virtual void CopyEFB(u8* dst, const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
                        u32 num_blocks_y, u32 memory_stride, bool is_depth_copy,
                        const EFBRectangle& src_rect, bool scale_by_half) = 0;
+  // Same as CopyEFB, but only queues the copy on the GPU instead of waiting for it. Returns
+  // nullptr if the backend can't do that, CopyEFB is used then.
+  virtual std::unique_ptr<PendingEFBCopy>
+  CopyEFBDeferred(const EFBCopyFormat& format, u32 native_width, u32 bytes_per_row,
+                  u32 num_blocks_y, u32 memory_stride, bool is_depth_copy,
+                  const EFBRectangle& src_rect, bool scale_by_half)
+  {
+    return nullptr;
+  }
+  // Writes the deferred EFB copies overlapping [address, address + size) to memory.
+  // Returns true if there were any.
+  bool FlushPendingEFBCopies(u32 address, u32 size);
+  // Called wherever the CPU may look at the results, the game syncing with the GPU, end of frame
+  // and savestates.
+  void FlushAllPendingEFBCopies();
 
   virtual bool CompileShaders() = 0;  // currently only implemented by OGL
   virtual void DeleteShaders() = 0;   // currently only implemented by OGL
@@ -170,6 +225,10 @@ public:
   void LoadEnviromentTexture(std::string basename);
   void CopyRenderTargetToTexture(u32 dstAddr, u32 dstFormat, u32 dstStride, bool is_depth_copy,
                                  const EFBRectangle& srcRect, bool isIntensity, bool scaleByHalf);
+  // Called whenever the EFB is written to. Copies reading from the rectangle aren't redundant
+  // anymore, even if they are repeated with the same parameters.
+  void OnEFBModified(const EFBRectangle& rect);
+  void OnEFBModified();
   u8* GetTemporalBuffer() { return temp; }
   // Returns true if the texture data and palette formats are supported by the GPU decoder.
   virtual bool SupportsGPUTextureDecode(TextureFormat format, TlutFormat palette_format)
@@ -221,6 +280,29 @@ private:
     EnvCacheEntry(TCacheEntry* tex) : envtexture(tex) {}
   };
 
+  // Background texture scaling: the entry is uploaded at native resolution and its texture is
+  // replaced by the scaled one once a pool thread has finished it.
+  struct AsyncScaleLevel
+  {
+    std::vector<u32> data;
+    u32 width;
+    u32 height;
+    u32 expanded_width;
+  };
+  struct AsyncScaleJob
+  {
+    u64 id;
+    int factor;
+    int type;
+    bool deposterize;
+    // Set if the results go to the disk cache as well
+    bool cache;
+    u64 hash;
+    u32 format;
+    std::vector<AsyncScaleLevel> levels;
+  };
+  struct AsyncScaleState;
+
   using TexAddrCache = std::multimap<u32, TCacheEntry*>;
   using TexHashCache = std::multimap<u64, TCacheEntry*>;
   using EnviromentCache = std::unordered_map<std::string, EnvCacheEntry>;
@@ -233,27 +315,53 @@ private:
   TCacheEntry* DoPartialTextureUpdates(TCacheEntry* entry_to_update, u32 tlutaddr, u32 tlutfmt,
                                        u32 palette_size);
   TCacheEntry* ApplyPaletteToEntry(TCacheEntry* entry, u32 tlutaddr, u32 tlutfmt, u32 palette_size);
+  // Returns the file to dump a level to, or an empty string if it was dumped already.
+  std::string GetDumpFilename(const std::string& basename, u32 level);
   void DumpTexture(TCacheEntry* entry, std::string basename, u32 level);
+  // Dumps a level from its decoded data on the pool, without reading back the texture. Returns
+  // false if the data isn't 32-bit color, then the texture has to be dumped instead.
+  bool DumpTextureData(const std::string& basename, u32 level, const u8* data, u32 width,
+                       u32 height, u32 row_length, HostTextureFormat format);
+
+  u8* ScaleTexture(u8* data, u32 width, u32 height, const ScaledTextureCache::Key* key);
+  void QueueAsyncScale(TCacheEntry* entry, std::vector<AsyncScaleLevel>&& levels, bool cache,
+                       u64 hash, u32 format);
+  void ApplyAsyncScaleResults();
+  void CancelAsyncScale(TCacheEntry* entry);
 
   TCacheEntry* AllocateCacheEntry(const TextureConfig& config, bool materialmap = false,
                                   bool luma = false);
   void DisposeCacheEntry(TCacheEntry* texture);
 
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
+  // Half of the video memory reported by the backend, 0 if it is unknown.
+  static size_t GetTextureMemoryBudget();
+  // Frees pooled textures, then the least recently used textures weighted by size, until the
+  // textures fit in the budget again.
+  void EvictToBudget(s32 frame_count, size_t budget);
   TexAddrCache::iterator GetTexCacheIter(TCacheEntry* entry);
   TexAddrCache::iterator InvalidateTexture(TexAddrCache::iterator t_iter);
   TCacheEntry* ReturnEntry(u32 stage, TCacheEntry* entry);
+  void WritePendingEFBCopy(PendingEFBCopy* copy);
 
-  // Return all possible overlapping textures. As addr+size of the textures is not
-  // indexed, this may return false positives.
-  std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
-  FindOverlappingTextures(u32 addr, u32 size_in_bytes);
+  // Returns the textures overlapping [addr, addr + size_in_bytes), using textures_by_page.
+  // The result is only valid until the end of the frame.
+  Common::FrameArena::Vector<TCacheEntry*> FindOverlappingTextures(u32 addr, u32 size_in_bytes);
+  static std::pair<u32, u32> GetRangeIndexPages(u32 addr, u32 size_in_bytes);
+  void AddToRangeIndex(TCacheEntry* entry);
+  void RemoveFromRangeIndex(TCacheEntry* entry);
 
   TexAddrCache textures_by_address;
+  // Every entry of textures_by_address, bucketed by the 64 KiB pages of memory it covers.
+  static constexpr u32 RANGE_INDEX_PAGE_SHIFT = 16;
+  std::unordered_map<u32, std::vector<TCacheEntry*>> textures_by_page;
   TexHashCache textures_by_hash;
   EnviromentCache enviroment_cache;
   TexPool texture_pool;
+  // Size of every texture the cache created, in use or pooled
   size_t texture_pool_memory_usage = {};
+  // Size of the textures waiting in texture_pool
+  size_t texture_pool_idle_memory = {};
 
   // Backup configuration values
   struct BackupConfig
@@ -263,15 +371,56 @@ private:
     bool texfmt_overlay_center;
     bool hires_textures;
     bool cache_hires_textures;
+    bool stream_hires_textures;
+    s32 hires_textures_memory_budget;
     bool stereo_3d;
     bool efb_mono_depth;
     s32 scaling_mode;
     s32 scaling_factor;
     bool scaling_deposterize;
+    bool scaling_cache;
     bool gpu_texture_decoding;
   };
   BackupConfig backup_config = {};
   std::unique_ptr<TextureScaler> m_scaler;
+  // Holds scaled textures read back from the disk cache
+  std::vector<u32> m_scaled_texture_buffer;
+  // Shared with the jobs still running on the pool, which may outlive the texture cache.
+  std::shared_ptr<AsyncScaleState> m_async_scale_state;
+  std::unordered_map<u64, TCacheEntry*> m_async_scale_entries;
+  u64 m_async_scale_next_id = 0;
+  // Names of the textures dumped (or being dumped) in this session.
+  std::unordered_set<std::string> m_dumped_textures;
+  u64 m_hires_stream_generation = 0;
+  // Deferred EFB copies, they never overlap as a new copy flushes the ones below it.
+  static constexpr size_t MAX_PENDING_EFB_COPIES = 64;
+  std::vector<std::unique_ptr<PendingEFBCopy>> m_pending_efb_copies;
+  u64 m_next_entry_id = 1;
+
+  // An EFB copy whose source rectangle hasn't been written to since. Repeating it is redundant
+  // as long as the entry it created is still cached and the memory below it is unchanged.
+  struct EFBCopyRecord
+  {
+    u32 addr;
+    u32 covered_range;
+    u32 format;
+    u32 stride;
+    EFBRectangle rect;
+    // bpmem.triggerEFBCopy, which holds the clamping, gamma, scaling and intensity bits.
+    u32 copy_params;
+    PEControl::PixelFormat src_format;
+    bool is_depth_copy;
+    bool copy_to_ram;
+    // The EFB and the entry are resized with the internal resolution.
+    int target_width;
+    int target_height;
+    u32 scaled_width;
+    u32 scaled_height;
+    u64 entry_id;
+  };
+  bool IsRedundantEFBCopy(const EFBCopyRecord& copy);
+  static constexpr size_t MAX_EFB_COPY_RECORDS = 64;
+  std::vector<EFBCopyRecord> m_efb_copy_records;
 };
 
 extern std::unique_ptr<TextureCacheBase> g_texture_cache;
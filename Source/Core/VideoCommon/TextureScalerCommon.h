@@ -29,6 +29,8 @@ public:
   ~TextureScaler();
 
   u32* Scale(u32* data, int width, int height);
+  // Takes the settings explicitly instead of reading g_ActiveConfig, for use off the GPU thread.
+  u32* Scale(u32* data, int width, int height, int factor, int type, bool deposterize);
 
   enum
   {
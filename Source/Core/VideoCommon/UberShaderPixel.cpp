@@ -140,6 +140,14 @@ PixelUberShaderUid GetPixelUberShaderUid(u32 components, const XFMemory &xfr, co
   return out;
 }
 
+PixelUberShaderConstants GetPixelUberShaderConstants(const BPMemory& bpm)
+{
+  PixelUberShaderConstants constants;
+  constants.num_tev_stages = bpm.genMode.numtevstages + 2;
+  constants.alpha_test = bpm.alpha_test.TestResult() == AlphaTest::PASS ? 1 : 2;
+  return constants;
+}
+
 void ClearUnusedPixelUberShaderUidBits(API_TYPE ApiType, PixelUberShaderUid* uid)
 {
   pixel_ubershader_uid_data& uid_data = uid->GetUidData<pixel_ubershader_uid_data>();
@@ -167,6 +175,12 @@ void GenPixelShader(ShaderCode& out, API_TYPE ApiType, const ShaderHostConfig& h
             early_depth ? ", early-depth" : "", per_pixel_depth ? ", per-pixel depth" : "");
   WritePixelShaderCommonHeader(out, ApiType, numTexgen, per_pixel_lighting, bounding_box);
   WriteUberShaderCommonHeader(out, ApiType, host_config);
+  if (ApiType == API_VULKAN)
+  {
+    // See PixelUberShaderConstants.
+    out.Write("layout(constant_id = 0) const uint UBER_NUM_TEV_STAGES = 0u;\n"
+              "layout(constant_id = 1) const uint UBER_ALPHA_TEST = 0u;\n\n");
+  }
   if (per_pixel_lighting)
     WriteLightingFunction(out);
 
@@ -881,8 +895,17 @@ void GenPixelShader(ShaderCode& out, API_TYPE ApiType, const ShaderHostConfig& h
     color_input_prefix = "lit_";
   }
 
-  out.Write("  uint num_stages = %s;\n\n",
-            BitfieldExtract("bpmem_genmode", bpmem.genMode.numtevstages).c_str());
+  if (ApiType == API_VULKAN)
+  {
+    // A constant stage count lets the driver unroll the TEV loop.
+    out.Write("  uint num_stages = UBER_NUM_TEV_STAGES != 0u ? UBER_NUM_TEV_STAGES - 2u : %s;\n\n",
+              BitfieldExtract("bpmem_genmode", bpmem.genMode.numtevstages).c_str());
+  }
+  else
+  {
+    out.Write("  uint num_stages = %s;\n\n",
+              BitfieldExtract("bpmem_genmode", bpmem.genMode.numtevstages).c_str());
+  }
 
   out.Write("  // Main tev loop\n");
   if (ApiType == API_D3D11)
@@ -1245,9 +1268,12 @@ void GenPixelShader(ShaderCode& out, API_TYPE ApiType, const ShaderHostConfig& h
       out.Write("  depth = float(zbuffer_zCoord) / 16777216.0;\n");
   }
 
-  out.Write("  // Alpha Test\n"
-            "  if (bpmem_alphaTest != 0u) {\n"
-            "    bool comp0 = alphaCompare(TevResult.a, " I_ALPHA ".r, %s);\n",
+  out.Write("  // Alpha Test\n");
+  if (ApiType == API_VULKAN)
+    out.Write("  if (UBER_ALPHA_TEST == 2u || (UBER_ALPHA_TEST == 0u && bpmem_alphaTest != 0u)) {\n");
+  else
+    out.Write("  if (bpmem_alphaTest != 0u) {\n");
+  out.Write("    bool comp0 = alphaCompare(TevResult.a, " I_ALPHA ".r, %s);\n",
             BitfieldExtract("bpmem_alphaTest", AlphaTest().comp0).c_str());
   out.Write("    bool comp1 = alphaCompare(TevResult.a, " I_ALPHA ".g, %s);\n",
             BitfieldExtract("bpmem_alphaTest", AlphaTest().comp1).c_str());
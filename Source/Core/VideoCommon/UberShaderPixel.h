@@ -39,6 +39,22 @@ typedef ShaderUid<pixel_ubershader_uid_data> PixelUberShaderUid;
 
 PixelUberShaderUid GetPixelUberShaderUid(u32 components, const XFMemory &xfr, const BPMemory &bpm);
 
+// Vulkan specialization constants of the pixel ubershader. Zero leaves the state to the uniforms,
+// which is what a pipeline without specialization info gets, so every variant shares one module.
+struct PixelUberShaderConstants
+{
+  u32 num_tev_stages;  // Number of TEV stages plus one.
+  u32 alpha_test;      // 1 if the alpha test always passes, 2 if it has to be evaluated.
+
+  bool operator==(const PixelUberShaderConstants& rhs) const
+  {
+    return num_tev_stages == rhs.num_tev_stages && alpha_test == rhs.alpha_test;
+  }
+  bool operator!=(const PixelUberShaderConstants& rhs) const { return !operator==(rhs); }
+};
+
+PixelUberShaderConstants GetPixelUberShaderConstants(const BPMemory& bpm);
+
 void GenPixelShader(ShaderCode& out, API_TYPE ApiType, const ShaderHostConfig& host_config,
                           const pixel_ubershader_uid_data& uid_data);
 
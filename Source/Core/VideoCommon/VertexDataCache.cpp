@@ -0,0 +1,234 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include <xxhash.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BoundingBox.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/RenderBase.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexDataCache.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace VertexDataCache
+{
+namespace
+{
+// Batches that have not been drawn for this many frames are dropped.
+constexpr int MAX_UNUSED_FRAMES = 60;
+// Upper bound for the converted vertex data kept around.
+constexpr size_t MAX_CACHED_BYTES = 32 * 1024 * 1024;
+// Small batches convert about as fast as they hash.
+constexpr int MIN_VERTEX_COUNT = 32;
+// Batches spread over more array data than this are not worth hashing.
+constexpr u32 MAX_ARRAY_RANGE = 1024 * 1024;
+
+struct CachedBatch
+{
+  int last_frame = 0;
+  // The first miss only marks the batch as seen, the second one stores it.
+  bool seen = false;
+  s32 final_count = 0;
+  std::vector<u8> vertex_data;
+};
+
+// Everything the converted output depends on besides the hashed memory.
+struct BatchState
+{
+  const VertexLoaderBase* loader;
+  u64 vtx_desc;
+  u32 vat[3];
+  u32 matrix_index_a;
+  u32 matrix_index_b;
+  u32 count;
+  u32 strides[12];
+};
+
+std::unordered_map<u64, CachedBatch> s_cache;
+size_t s_cached_bytes = 0;
+
+// Key of the batch that missed in ReplayVertices, so RecordVertices doesn't hash it again.
+u64 s_pending_key = 0;
+bool s_pending = false;
+
+inline u32 ReadIndex(const u8* data, bool index16)
+{
+  return index16 ? (static_cast<u32>(data[0]) << 8) | data[1] : data[0];
+}
+
+bool ComputeKey(const VertexLoaderParameters& parameters, const VertexLoaderBase* loader,
+                u64* key)
+{
+  if (!g_ActiveConfig.bVertexDataCache || parameters.count < MIN_VERTEX_COUNT)
+    return false;
+
+  // The CPU bounding box is updated by the vertex loader itself.
+  if (g_ActiveConfig.iBBoxMode == BBoxCPU && BoundingBox::active)
+    return false;
+
+  // Only batches whose vertices are made of matrix and array indices are cached, the layout of
+  // those is known without decoding the attribute formats.
+  const TVtxDesc& vtx_desc = *parameters.VtxDesc;
+  int arrays[12];
+  u32 offsets[12];
+  bool index16[12];
+  int num_arrays = 0;
+  u32 vertex_size = 0;
+  for (int i = 0; i < 9; i++)
+    vertex_size += (vtx_desc.Hex >> i) & 1;
+  for (int i = 0; i < 12; i++)
+  {
+    const u32 status = vtx_desc.GetVertexArrayStatus(i);
+    if (status == NOT_PRESENT)
+      continue;
+    if (status == DIRECT)
+      return false;
+    // Normal, binormal and tangent with separate indices.
+    if (i == ARRAY_NORMAL && parameters.VtxAttr->g0.NormalIndex3 &&
+        parameters.VtxAttr->g0.NormalElements)
+    {
+      return false;
+    }
+    arrays[num_arrays] = i;
+    offsets[num_arrays] = vertex_size;
+    index16[num_arrays] = status == INDEX16;
+    num_arrays++;
+    vertex_size += status == INDEX16 ? 2 : 1;
+  }
+  if (num_arrays == 0 || vertex_size != loader->m_VertexSize)
+    return false;
+
+  u32 min_index[12];
+  u32 max_index[12];
+  std::fill(min_index, min_index + num_arrays, UINT32_MAX);
+  std::fill(max_index, max_index + num_arrays, 0);
+  const u8* vertex = parameters.source;
+  for (int v = 0; v < parameters.count; v++, vertex += vertex_size)
+  {
+    for (int a = 0; a < num_arrays; a++)
+    {
+      const u32 index = ReadIndex(vertex + offsets[a], index16[a]);
+      min_index[a] = std::min(min_index[a], index);
+      max_index[a] = std::max(max_index[a], index);
+    }
+  }
+
+  BatchState state = {};
+  state.loader = loader;
+  state.vtx_desc = vtx_desc.Hex;
+  state.vat[0] = parameters.VtxAttr->g0.Hex;
+  state.vat[1] = parameters.VtxAttr->g1.Hex;
+  state.vat[2] = parameters.VtxAttr->g2.Hex;
+  state.matrix_index_a = g_main_cp_state.matrix_index_a.Hex;
+  state.matrix_index_b = g_main_cp_state.matrix_index_b.Hex;
+  state.count = static_cast<u32>(parameters.count);
+
+  // Every hash seeds the next one.
+  u64 hash = XXH64(parameters.source, vertex_size * parameters.count, 0);
+  for (int a = 0; a < num_arrays; a++)
+  {
+    const int array = arrays[a];
+    const u32 stride = g_main_cp_state.array_strides[array];
+    const u8* base = cached_arraybases[array];
+    // The last element is hashed up to the stride, its exact size depends on the format.
+    const u32 range = (max_index[a] - min_index[a] + 1) * stride;
+    if (!base || stride == 0 || range > MAX_ARRAY_RANGE)
+      return false;
+    state.strides[array] = stride;
+    hash = XXH64(base + min_index[a] * stride, range, hash);
+  }
+  *key = XXH64(&state, sizeof(state), hash);
+  return true;
+}
+}  // Anonymous namespace
+
+void Init()
+{
+  Clear();
+}
+
+void Shutdown()
+{
+  Clear();
+}
+
+void Clear()
+{
+  s_cache.clear();
+  s_cached_bytes = 0;
+  s_pending = false;
+}
+
+void ProgressiveCleanup()
+{
+  for (auto it = s_cache.begin(); it != s_cache.end();)
+  {
+    // Batches seen only once are most likely dynamic and are dropped quickly.
+    const int max_unused = it->second.vertex_data.empty() ? 1 : MAX_UNUSED_FRAMES;
+    if (frameCount - it->second.last_frame > max_unused)
+    {
+      s_cached_bytes -= it->second.vertex_data.size();
+      it = s_cache.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+bool ReplayVertices(const VertexLoaderParameters& parameters, const VertexLoaderBase* loader,
+                    s32* finalcount)
+{
+  s_pending = false;
+  u64 key;
+  if (!ComputeKey(parameters, loader, &key))
+    return false;
+
+  auto it = s_cache.find(key);
+  if (it == s_cache.end() || it->second.vertex_data.empty())
+  {
+    s_pending_key = key;
+    s_pending = true;
+    return false;
+  }
+
+  CachedBatch& batch = it->second;
+  std::memcpy(parameters.destination, batch.vertex_data.data(), batch.vertex_data.size());
+  *finalcount = batch.final_count;
+  batch.last_frame = frameCount;
+  ADDSTAT(stats.thisFrame.numArrayPrimsCached, batch.final_count);
+  return true;
+}
+
+void RecordVertices(const VertexLoaderParameters& parameters, const VertexLoaderBase* loader,
+                    s32 finalcount)
+{
+  if (!s_pending)
+    return;
+  s_pending = false;
+
+  CachedBatch& batch = s_cache[s_pending_key];
+  batch.last_frame = frameCount;
+  if (!batch.seen)
+  {
+    batch.seen = true;
+    return;
+  }
+
+  const u32 data_size = static_cast<u32>(loader->m_native_stride * finalcount);
+  if (data_size == 0 || s_cached_bytes + data_size > MAX_CACHED_BYTES)
+    return;
+
+  batch.final_count = finalcount;
+  batch.vertex_data.assign(parameters.destination, parameters.destination + data_size);
+  s_cached_bytes += data_size;
+}
+}  // namespace VertexDataCache
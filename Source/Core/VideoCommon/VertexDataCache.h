@@ -0,0 +1,36 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+class VertexLoaderBase;
+struct VertexLoaderParameters;
+
+// Converted vertex cache for indexed geometry.
+// Static models are usually drawn from vertex arrays that never change, with the same
+// index stream every frame, whether the draw comes from a display list or not.
+// Batches made only of indices are keyed on the index stream, the referenced range of every
+// array and the vertex format, and their converted vertices are copied to the vertex buffer
+// instead of running the loader again.
+// A batch is only stored the second time it is seen, so geometry that is rewritten every
+// frame (CPU skinning, particles) costs a hash but doesn't fill up the cache.
+namespace VertexDataCache
+{
+void Init();
+void Shutdown();
+void Clear();
+
+// Evicts batches that have not been drawn for a while. Called once per frame.
+void ProgressiveCleanup();
+
+// Called by VertexLoaderManager for every primitive batch, after the vertex array pointers
+// have been updated. Returns true and fills finalcount if the vertices were copied from the
+// cache. Otherwise the batch is remembered for the following RecordVertices call.
+bool ReplayVertices(const VertexLoaderParameters& parameters, const VertexLoaderBase* loader,
+                    s32* finalcount);
+void RecordVertices(const VertexLoaderParameters& parameters, const VertexLoaderBase* loader,
+                    s32 finalcount);
+}  // namespace VertexDataCache
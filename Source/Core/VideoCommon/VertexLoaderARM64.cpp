@@ -4,8 +4,10 @@
 
 #include "VideoCommon/VertexLoaderARM64.h"
 #include "Common/CommonTypes.h"
-#include "VideoCommon/DataReader.h"
+#include "Common/JitRegister.h"
+#include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 
 using namespace Arm64Gen;
 
@@ -17,20 +19,21 @@ constexpr ARM64Reg scratch1_reg = W16;
 constexpr ARM64Reg scratch2_reg = W15;
 constexpr ARM64Reg scratch3_reg = W14;
 constexpr ARM64Reg saved_count = W12;
+constexpr ARM64Reg posmtx_reg = W13;
 
 constexpr ARM64Reg stride_reg = X11;
 constexpr ARM64Reg arraybase_reg = X10;
 constexpr ARM64Reg scale_reg = X9;
 
-alignas(16) static const float scale_factors[] = {
-	1.0 / (1ULL << 0),  1.0 / (1ULL << 1),  1.0 / (1ULL << 2),  1.0 / (1ULL << 3),
-	1.0 / (1ULL << 4),  1.0 / (1ULL << 5),  1.0 / (1ULL << 6),  1.0 / (1ULL << 7),
-	1.0 / (1ULL << 8),  1.0 / (1ULL << 9),  1.0 / (1ULL << 10), 1.0 / (1ULL << 11),
-	1.0 / (1ULL << 12), 1.0 / (1ULL << 13), 1.0 / (1ULL << 14), 1.0 / (1ULL << 15),
-	1.0 / (1ULL << 16), 1.0 / (1ULL << 17), 1.0 / (1ULL << 18), 1.0 / (1ULL << 19),
-	1.0 / (1ULL << 20), 1.0 / (1ULL << 21), 1.0 / (1ULL << 22), 1.0 / (1ULL << 23),
-	1.0 / (1ULL << 24), 1.0 / (1ULL << 25), 1.0 / (1ULL << 26), 1.0 / (1ULL << 27),
-	1.0 / (1ULL << 28), 1.0 / (1ULL << 29), 1.0 / (1ULL << 30), 1.0 / (1ULL << 31),
+static const u32 MASKINDEXED = INDEX8 & INDEX16;
+
+// Same layout as in VertexLoaderX64: the fractions are not part of the loader uid, so the
+// position and texture coordinate scales are written by RunVertices.
+// 0: position, 1-4: normals by format, 5-12: texture coordinates.
+alignas(16) static float scale_factors[13] = {
+	0.0f,
+	fractionTable[7], fractionTable[6], fractionTable[15], fractionTable[14],
+	0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
 };
 
 VertexLoaderARM64::VertexLoaderARM64(const TVtxDesc& vtx_desc, const VAT& vtx_att)
@@ -43,11 +46,14 @@ VertexLoaderARM64::VertexLoaderARM64(const TVtxDesc& vtx_desc, const VAT& vtx_at
 	ClearCodeSpace();
 	GenerateVertexLoader();
 	WriteProtect();
+
+	std::string name = GetName();
+	JitRegister::Register(region, GetCodePtr(), name.c_str());
 }
 
 void VertexLoaderARM64::GetVertexAddr(int array, u64 attribute, ARM64Reg reg)
 {
-	if (attribute & MASK_INDEXED)
+	if (attribute & MASKINDEXED)
 	{
 		if (attribute == INDEX8)
 		{
@@ -99,7 +105,7 @@ void VertexLoaderARM64::GetVertexAddr(int array, u64 attribute, ARM64Reg reg)
 
 s32 VertexLoaderARM64::GetAddressImm(int array, u64 attribute, Arm64Gen::ARM64Reg reg, u32 align)
 {
-	if (attribute & MASK_INDEXED || (m_src_ofs > 255 && (m_src_ofs & (align - 1))))
+	if (attribute & MASKINDEXED || (m_src_ofs > 255 && (m_src_ofs & (align - 1))))
 		GetVertexAddr(array, attribute, reg);
 	else
 		return m_src_ofs;
@@ -107,7 +113,7 @@ s32 VertexLoaderARM64::GetAddressImm(int array, u64 attribute, Arm64Gen::ARM64Re
 }
 
 int VertexLoaderARM64::ReadVertex(u64 attribute, int format, int count_in, int count_out,
-	bool dequantize, u8 scaling_exponent,
+	bool dequantize, int scale_index,
 	AttributeFormat* native_format, s32 offset)
 {
 	ARM64Reg coords = count_in == 3 ? Q31 : D31;
@@ -118,14 +124,11 @@ int VertexLoaderARM64::ReadVertex(u64 attribute, int format, int count_in, int c
 	int load_size =
 		load_bytes == 1 ? 1 : load_bytes <= 2 ? 2 : load_bytes <= 4 ? 4 : load_bytes <= 8 ? 8 : 16;
 	load_size <<= 3;
-	elem_size <<= 3;
 
 	if (offset == -1)
 	{
-		if (count_in == 1)
-			m_float_emit.LDR(elem_size, INDEX_UNSIGNED, coords, EncodeRegTo64(scratch1_reg), 0);
-		else
-			m_float_emit.LD1(elem_size, 1, coords, EncodeRegTo64(scratch1_reg));
+		// A plain load of the attribute size, LD1 would fill the unused lanes from memory.
+		m_float_emit.LDR(load_size, INDEX_UNSIGNED, coords, EncodeRegTo64(scratch1_reg), 0);
 	}
 	else if (offset & (load_size - 1))  // Not aligned - unscaled
 	{
@@ -161,9 +164,9 @@ int VertexLoaderARM64::ReadVertex(u64 attribute, int format, int count_in, int c
 
 		m_float_emit.SCVTF(32, coords, coords);
 
-		if (dequantize && scaling_exponent)
+		if (dequantize)
 		{
-			m_float_emit.LDR(32, INDEX_UNSIGNED, scale, scale_reg, scaling_exponent * 4);
+			m_float_emit.LDR(32, INDEX_UNSIGNED, scale, scale_reg, scale_index * 4);
 			m_float_emit.FMUL(32, coords, coords, scale, 0);
 		}
 	}
@@ -188,23 +191,10 @@ int VertexLoaderARM64::ReadVertex(u64 attribute, int format, int count_in, int c
 		m_float_emit.ST1(32, 1, coords, EncodeRegTo64(scratch2_reg));
 	}
 
-	// Z-Freeze
-	if (native_format == &m_native_vtx_decl.position)
-	{
-		CMP(count_reg, 3);
-		FixupBranch dont_store = B(CC_GT);
-		MOVP2R(EncodeRegTo64(scratch2_reg), VertexLoaderManager::position_cache);
-		ADD(EncodeRegTo64(scratch1_reg), EncodeRegTo64(scratch2_reg), EncodeRegTo64(count_reg),
-			ArithOption(EncodeRegTo64(count_reg), ST_LSL, 4));
-		m_float_emit.STUR(write_size, coords, EncodeRegTo64(scratch1_reg), -16);
-		SetJumpTarget(dont_store);
-	}
-
 	native_format->components = count_out;
 	native_format->enable = true;
 	native_format->offset = m_dst_ofs;
-	native_format->type = VAR_FLOAT;
-	native_format->integer = false;
+	native_format->type = FORMAT_FLOAT;
 	m_dst_ofs += sizeof(float) * count_out;
 
 	if (attribute == DIRECT)
@@ -264,7 +254,7 @@ void VertexLoaderARM64::ReadColor(u64 attribute, int format, s32 offset)
 		ORR(scratch1_reg, scratch1_reg, scratch2_reg, ArithOption(scratch2_reg, ST_LSR, 2));
 
 		// A
-		ORR(scratch2_reg, scratch2_reg, 8, 7);  // 0xFF000000
+		ORR(scratch1_reg, scratch1_reg, 8, 7);  // 0xFF000000
 
 		STR(INDEX_UNSIGNED, scratch1_reg, dst_reg, m_dst_ofs);
 		load_bytes = 2;
@@ -376,51 +366,35 @@ void VertexLoaderARM64::GenerateVertexLoader()
 	};
 
 	bool has_tc = false;
-	bool has_tc_scale = false;
 	for (int i = 0; i < 8; i++)
-	{
-		has_tc |= tc[i];
-		has_tc_scale |= !!m_VtxAttr.texCoord[i].Frac;
-	}
+		has_tc |= tc[i] && m_VtxAttr.texCoord[i].Format != FORMAT_FLOAT;
 
-	bool need_scale =
-		(m_VtxAttr.ByteDequant && m_VtxAttr.PosFrac) || (has_tc && has_tc_scale) || m_VtxDesc.Normal;
+	bool need_scale = (m_VtxAttr.ByteDequant && (m_VtxAttr.PosFormat != FORMAT_FLOAT || has_tc)) ||
+		m_VtxDesc.Normal;
 
 	AlignCode16();
-	if (m_VtxDesc.Position & MASK_INDEXED)
+	if (m_VtxDesc.Position & MASKINDEXED)
 		MOV(skipped_reg, WZR);
 	MOV(saved_count, count_reg);
 
 	MOVP2R(stride_reg, g_main_cp_state.array_strides);
-	MOVP2R(arraybase_reg, VertexLoaderManager::cached_arraybases);
+	MOVP2R(arraybase_reg, cached_arraybases);
 
 	if (need_scale)
 		MOVP2R(scale_reg, scale_factors);
 
+	if (!m_VtxDesc.PosMatIdx)
+	{
+		MOVP2R(EncodeRegTo64(scratch1_reg), &g_main_cp_state.matrix_index_a);
+		LDR(INDEX_UNSIGNED, posmtx_reg, EncodeRegTo64(scratch1_reg), 0);
+		AND(posmtx_reg, posmtx_reg, 0, 5);
+	}
+
 	const u8* loop_start = GetCodePtr();
 
+	// The position matrix index is written after the other attributes.
 	if (m_VtxDesc.PosMatIdx)
-	{
-		LDRB(INDEX_UNSIGNED, scratch1_reg, src_reg, m_src_ofs);
-		AND(scratch1_reg, scratch1_reg, 0, 5);
-		STR(INDEX_UNSIGNED, scratch1_reg, dst_reg, m_dst_ofs);
-
-		// Z-Freeze
-		CMP(count_reg, 3);
-		FixupBranch dont_store = B(CC_GT);
-		MOVP2R(EncodeRegTo64(scratch2_reg), VertexLoaderManager::position_matrix_index);
-		STR(INDEX_UNSIGNED, scratch1_reg, EncodeRegTo64(scratch2_reg), 0);
-		SetJumpTarget(dont_store);
-
-		m_native_components |= VB_HAS_POSMTXIDX;
-		m_native_vtx_decl.posmtx.components = 4;
-		m_native_vtx_decl.posmtx.enable = true;
-		m_native_vtx_decl.posmtx.offset = m_dst_ofs;
-		m_native_vtx_decl.posmtx.type = VAR_UNSIGNED_BYTE;
-		m_native_vtx_decl.posmtx.integer = true;
-		m_src_ofs += sizeof(u8);
-		m_dst_ofs += sizeof(u32);
-	}
+		m_src_ofs++;
 
 	u32 texmatidx_ofs[8];
 	const u64 tm[8] = {
@@ -444,14 +418,13 @@ void VertexLoaderARM64::GenerateVertexLoader()
 		s32 offset =
 			GetAddressImm(ARRAY_POSITION, m_VtxDesc.Position, EncodeRegTo64(scratch1_reg), load_size);
 		int pos_elements = m_VtxAttr.PosElements + 2;
-		ReadVertex(m_VtxDesc.Position, m_VtxAttr.PosFormat, pos_elements, pos_elements,
-			m_VtxAttr.ByteDequant, m_VtxAttr.PosFrac, &m_native_vtx_decl.position, offset);
+		ReadVertex(m_VtxDesc.Position, m_VtxAttr.PosFormat, pos_elements, 3, m_VtxAttr.ByteDequant, 0,
+			&m_native_vtx_decl.position, offset);
 	}
 
 	if (m_VtxDesc.Normal)
 	{
-		static const u8 map[8] = { 7, 6, 15, 14 };
-		u8 scaling_exponent = map[m_VtxAttr.NormalFormat];
+		int scale_index = m_VtxAttr.NormalFormat + 1;
 
 		s32 offset = -1;
 		for (int i = 0; i < (m_VtxAttr.NormalElements ? 3 : 1); i++)
@@ -474,7 +447,7 @@ void VertexLoaderARM64::GenerateVertexLoader()
 					offset += i * elem_size * 3;
 			}
 			int bytes_read = ReadVertex(m_VtxDesc.Normal, m_VtxAttr.NormalFormat, 3, 3, true,
-				scaling_exponent, &m_native_vtx_decl.normals[i], offset);
+				scale_index, &m_native_vtx_decl.normals[i], offset);
 
 			if (offset == -1)
 				ADD(EncodeRegTo64(scratch1_reg), EncodeRegTo64(scratch1_reg), bytes_read);
@@ -490,10 +463,6 @@ void VertexLoaderARM64::GenerateVertexLoader()
 	const u64 col[2] = { m_VtxDesc.Color0, m_VtxDesc.Color1 };
 	for (int i = 0; i < 2; i++)
 	{
-		m_native_vtx_decl.colors[i].components = 4;
-		m_native_vtx_decl.colors[i].type = VAR_UNSIGNED_BYTE;
-		m_native_vtx_decl.colors[i].integer = false;
-
 		if (col[i])
 		{
 			u32 align = 4;
@@ -506,18 +475,13 @@ void VertexLoaderARM64::GenerateVertexLoader()
 			m_native_vtx_decl.colors[i].components = 4;
 			m_native_vtx_decl.colors[i].enable = true;
 			m_native_vtx_decl.colors[i].offset = m_dst_ofs;
-			m_native_vtx_decl.colors[i].type = VAR_UNSIGNED_BYTE;
-			m_native_vtx_decl.colors[i].integer = false;
+			m_native_vtx_decl.colors[i].type = FORMAT_UBYTE;
 			m_dst_ofs += 4;
 		}
 	}
 
 	for (int i = 0; i < 8; i++)
 	{
-		m_native_vtx_decl.texcoords[i].offset = m_dst_ofs;
-		m_native_vtx_decl.texcoords[i].type = VAR_FLOAT;
-		m_native_vtx_decl.texcoords[i].integer = false;
-
 		int elements = m_VtxAttr.texCoord[i].Elements + 1;
 		if (tc[i])
 		{
@@ -532,17 +496,15 @@ void VertexLoaderARM64::GenerateVertexLoader()
 
 			s32 offset =
 				GetAddressImm(ARRAY_TEXCOORD0 + i, tc[i], EncodeRegTo64(scratch1_reg), load_size);
-			u8 scaling_exponent = m_VtxAttr.texCoord[i].Frac;
 			ReadVertex(tc[i], m_VtxAttr.texCoord[i].Format, elements, tm[i] ? 2 : elements,
-				m_VtxAttr.ByteDequant, scaling_exponent, &m_native_vtx_decl.texcoords[i], offset);
+				m_VtxAttr.ByteDequant, 5 + i, &m_native_vtx_decl.texcoords[i], offset);
 		}
 		if (tm[i])
 		{
-			m_native_components |= VB_HAS_TEXMTXIDX0 << i;
+			m_native_components |= (VB_HAS_TEXMTXIDX0 | VB_HAS_UV0) << i;
 			m_native_vtx_decl.texcoords[i].components = 3;
 			m_native_vtx_decl.texcoords[i].enable = true;
-			m_native_vtx_decl.texcoords[i].type = VAR_FLOAT;
-			m_native_vtx_decl.texcoords[i].integer = false;
+			m_native_vtx_decl.texcoords[i].type = FORMAT_FLOAT;
 
 			LDRB(INDEX_UNSIGNED, scratch2_reg, src_reg, texmatidx_ofs[i]);
 			m_float_emit.UCVTF(S31, scratch2_reg);
@@ -579,6 +541,22 @@ void VertexLoaderARM64::GenerateVertexLoader()
 		}
 	}
 
+	if (m_VtxDesc.PosMatIdx)
+	{
+		LDRB(INDEX_UNSIGNED, scratch1_reg, src_reg, 0);
+		AND(scratch1_reg, scratch1_reg, 0, 5);
+		STR(INDEX_UNSIGNED, scratch1_reg, dst_reg, m_dst_ofs);
+	}
+	else
+	{
+		STR(INDEX_UNSIGNED, posmtx_reg, dst_reg, m_dst_ofs);
+	}
+	m_native_vtx_decl.posmtx.components = 4;
+	m_native_vtx_decl.posmtx.enable = true;
+	m_native_vtx_decl.posmtx.offset = m_dst_ofs;
+	m_native_vtx_decl.posmtx.type = FORMAT_UBYTE;
+	m_dst_ofs += sizeof(u32);
+
 	// Prepare for the next vertex.
 	ADD(dst_reg, dst_reg, m_dst_ofs);
 	const u8* cont = GetCodePtr();
@@ -587,7 +565,7 @@ void VertexLoaderARM64::GenerateVertexLoader()
 	SUB(count_reg, count_reg, 1);
 	CBNZ(count_reg, loop_start);
 
-	if (m_VtxDesc.Position & MASK_INDEXED)
+	if (m_VtxDesc.Position & MASKINDEXED)
 	{
 		SUB(W0, saved_count, skipped_reg);
 		RET(X30);
@@ -604,13 +582,32 @@ void VertexLoaderARM64::GenerateVertexLoader()
 
 	FlushIcache();
 
+	m_native_stride = m_dst_ofs;
 	m_VertexSize = m_src_ofs;
-	m_native_vtx_decl.stride = m_dst_ofs;
+	m_native_vtx_decl.stride = m_native_stride;
+}
+
+bool VertexLoaderARM64::EnvironmentIsSupported()
+{
+	return g_ActiveConfig.iBBoxMode == BBoxGPU || !BoundingBox::active;
 }
 
-int VertexLoaderARM64::RunVertices(DataReader src, DataReader dst, int count)
+int VertexLoaderARM64::RunVertices(const VertexLoaderParameters& parameters)
 {
-	m_numLoadedVertices += count;
-	return ((int(*)(u8 * src, u8 * dst, int count))region)(src.GetPointer(), dst.GetPointer(),
-		count);
+	const VAT& vat = *parameters.VtxAttr;
+	scale_factors[0] = fractionTable[vat.g0.PosFrac];
+	if (m_native_components & VB_HAS_UVALL)
+	{
+		scale_factors[5] = fractionTable[vat.g0.Tex0Frac];
+		scale_factors[6] = fractionTable[vat.g1.Tex1Frac];
+		scale_factors[7] = fractionTable[vat.g1.Tex2Frac];
+		scale_factors[8] = fractionTable[vat.g1.Tex3Frac];
+		scale_factors[9] = fractionTable[vat.g2.Tex4Frac];
+		scale_factors[10] = fractionTable[vat.g2.Tex5Frac];
+		scale_factors[11] = fractionTable[vat.g2.Tex6Frac];
+		scale_factors[12] = fractionTable[vat.g2.Tex7Frac];
+	}
+	m_numLoadedVertices += parameters.count;
+	return ((int (*)(const u8* src, u8* dst, int count))region)(
+		parameters.source, parameters.destination, parameters.count);
 }
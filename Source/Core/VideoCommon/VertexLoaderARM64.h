@@ -12,9 +12,9 @@ public:
 	VertexLoaderARM64(const TVtxDesc& vtx_desc, const VAT& vtx_att);
 
 protected:
-	std::string GetName() const override { return "VertexLoaderARM64"; }
 	bool IsInitialized() override { return true; }
-	int RunVertices(DataReader src, DataReader dst, int count) override;
+	int RunVertices(const VertexLoaderParameters& parameters) override;
+	bool EnvironmentIsSupported() override;
 
 private:
 	u32 m_src_ofs = 0;
@@ -23,7 +23,7 @@ private:
 	Arm64Gen::ARM64FloatEmitter m_float_emit;
 	void GetVertexAddr(int array, u64 attribute, Arm64Gen::ARM64Reg reg);
 	s32 GetAddressImm(int array, u64 attribute, Arm64Gen::ARM64Reg reg, u32 align);
-	int ReadVertex(u64 attribute, int format, int count_in, int count_out, bool dequantize, u8 scaling_exponent, AttributeFormat* native_format, s32 offset = -1);
+	int ReadVertex(u64 attribute, int format, int count_in, int count_out, bool dequantize, int scale_index, AttributeFormat* native_format, s32 offset = -1);
 	void ReadColor(u64 attribute, int format, s32 offset);
 	void GenerateVertexLoader();
 };
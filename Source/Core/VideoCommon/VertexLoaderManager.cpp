@@ -3,19 +3,27 @@
 // Refer to the license.txt file included.
 // Modified for Ishiiruka by Tino
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 
 #include "Core/ConfigManager.h"
 #include "Core/HW/Memmap.h"
 
+#include "Common/CommonPaths.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
 #include "Common/ThreadPool.h"
 #include "Common/StringUtil.h"
 
+#include "VideoCommon/DLCache.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexDataCache.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
@@ -25,6 +33,7 @@
 
 static VertexLoaderBase *s_cpu_loaders[8];
 static std::string last_game_code;
+static bool s_loader_profile_pending = false;
 
 typedef std::unordered_map<VertexLoaderUID, std::unique_ptr<VertexLoaderBase>> VertexLoaderMap;
 
@@ -65,6 +74,85 @@ struct codeentry
 };
 }
 
+// Per-game profile of the vertex formats a game uses the most.
+// It is written when emulation stops and replayed on the next boot, so the loaders
+// (jitted or precompiled) are built before the first draw instead of mid-frame.
+constexpr u32 LOADER_PROFILE_MAGIC = 0x504C5649;  // "IVLP"
+constexpr u32 LOADER_PROFILE_VERSION = 1;
+constexpr size_t LOADER_PROFILE_MAX_ENTRIES = 256;
+
+struct LoaderProfileEntry
+{
+  u32 vid[4];
+  u64 num_verts;
+};
+
+static std::string GetLoaderProfilePath(const std::string& game_id)
+{
+  return File::GetUserPath(D_CACHE_IDX) + "VertexLoaders" DIR_SEP + game_id + ".vlp";
+}
+
+static std::vector<LoaderProfileEntry> ReadLoaderProfile(const std::string& filename)
+{
+  std::vector<LoaderProfileEntry> entries;
+  File::IOFile file(filename, "rb");
+  u32 header[3];
+  if (!file.ReadArray(header, 3) || header[0] != LOADER_PROFILE_MAGIC ||
+      header[1] != LOADER_PROFILE_VERSION || header[2] > LOADER_PROFILE_MAX_ENTRIES)
+  {
+    return entries;
+  }
+  entries.resize(header[2]);
+  if (!file.ReadArray(entries.data(), entries.size()))
+    entries.clear();
+  return entries;
+}
+
+static void SaveLoaderProfile()
+{
+  if (last_game_code.empty() || s_vertex_loader_map.empty())
+    return;
+
+  const std::string filename = GetLoaderProfilePath(last_game_code);
+  std::vector<LoaderProfileEntry> entries = ReadLoaderProfile(filename);
+  for (const auto& it : s_vertex_loader_map)
+  {
+    u64 num_verts = it.second->m_numLoadedVertices;
+    if (it.second->GetFallback())
+      num_verts += it.second->GetFallback()->m_numLoadedVertices;
+    if (!num_verts)
+      continue;
+
+    LoaderProfileEntry entry;
+    for (u32 i = 0; i < 4; i++)
+      entry.vid[i] = it.first.GetElement(i);
+    auto existing = std::find_if(entries.begin(), entries.end(), [&entry](const auto& e) {
+      return std::equal(e.vid, e.vid + 4, entry.vid);
+    });
+    if (existing != entries.end())
+    {
+      existing->num_verts += num_verts;
+    }
+    else
+    {
+      entry.num_verts = num_verts;
+      entries.push_back(entry);
+    }
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const auto& a, const auto& b) { return a.num_verts > b.num_verts; });
+  if (entries.size() > LOADER_PROFILE_MAX_ENTRIES)
+    entries.resize(LOADER_PROFILE_MAX_ENTRIES);
+
+  File::CreateFullPath(filename);
+  File::IOFile file(filename, "wb");
+  const u32 header[3] = {LOADER_PROFILE_MAGIC, LOADER_PROFILE_VERSION,
+                         static_cast<u32>(entries.size())};
+  if (!file.WriteArray(header, 3) || !file.WriteArray(entries.data(), entries.size()))
+    WARN_LOG(VIDEO, "Failed to write vertex loader profile %s", filename.c_str());
+}
+
 void AppendListToString(std::string *dest)
 {
   std::vector<entry> entries;
@@ -92,10 +180,15 @@ void Init()
   for (VertexLoaderBase*& vertexLoader : g_main_cp_state.vertex_loaders)
     vertexLoader = nullptr;
   last_game_code = SConfig::GetInstance().GetGameID();
+  s_loader_profile_pending = !last_game_code.empty();
 }
 
 void Shutdown()
 {
+  SaveLoaderProfile();
+  // Cached display lists and batches reference the loaders.
+  DLCache::Clear();
+  VertexDataCache::Clear();
   s_vertex_loader_map.clear();
   s_native_vertex_map.clear();
 }
@@ -235,6 +328,30 @@ void GetVertexSizeAndComponents(const VertexLoaderParameters &parameters, u32 &v
   components = s_cpu_loaders[parameters.vtx_attr_group]->m_native_components;
 }
 
+// Builds the loaders recorded in the game's profile.
+// Has to run on the video thread once the vertex manager exists.
+static void WarmUpLoadersFromProfile()
+{
+  s_loader_profile_pending = false;
+  const std::vector<LoaderProfileEntry> entries =
+      ReadLoaderProfile(GetLoaderProfilePath(last_game_code));
+  for (const LoaderProfileEntry& entry : entries)
+  {
+    // Inverse of the VertexLoaderUID encoding. The fraction bits are masked out of the uid,
+    // loaders read them from the current VAT every time they run.
+    TVtxDesc vtx_desc;
+    vtx_desc.Hex = (static_cast<u64>(entry.vid[0]) << 1) | (entry.vid[2] >> 31);
+    VAT vtx_attr;
+    vtx_attr.g0.Hex = entry.vid[1];
+    vtx_attr.g1.Hex = entry.vid[2] & 0x7FFFFFFFu;
+    vtx_attr.g2.Hex = entry.vid[3];
+    GetOrAddLoader(vtx_desc, vtx_attr);
+  }
+  if (!entries.empty())
+    INFO_LOG(VIDEO, "Prepared %zu vertex loaders from the profile of %s", entries.size(),
+             last_game_code.c_str());
+}
+
 inline void UpdateLoader(const VertexLoaderParameters &parameters)
 {
   g_main_cp_state.vertex_loaders[parameters.vtx_attr_group] = GetOrAddLoader(*parameters.VtxDesc, *parameters.VtxAttr);
@@ -243,6 +360,8 @@ inline void UpdateLoader(const VertexLoaderParameters &parameters)
 
 bool ConvertVertices(VertexLoaderParameters &parameters, u32 &readsize, u32 &writesize)
 {
+  if (s_loader_profile_pending)
+    WarmUpLoadersFromProfile();
   if (parameters.needloaderrefresh)
   {
     UpdateLoader(parameters);
@@ -272,9 +391,22 @@ bool ConvertVertices(VertexLoaderParameters &parameters, u32 &readsize, u32 &wri
   VertexShaderManager::SetVertexFormat(loader->m_native_components);
   g_vertex_manager->PrepareForAdditionalData(parameters.primitive, parameters.count, loader->m_native_stride);
   parameters.destination = g_vertex_manager->GetCurrentBufferPointer();
-  s32 finalcount = loader->RunVertices(parameters);
+  s32 finalcount;
+  if (!DLCache::ReplayVertices(parameters, loader, &finalcount) &&
+      !VertexDataCache::ReplayVertices(parameters, loader, &finalcount))
+  {
+    finalcount = loader->RunVertices(parameters);
+    DLCache::RecordVertices(parameters, loader, finalcount);
+    VertexDataCache::RecordVertices(parameters, loader, finalcount);
+  }
   writesize = loader->m_native_stride * finalcount;
+  u16* const first_index = IndexGenerator::GetBasePointer() + IndexGenerator::GetIndexLen();
   IndexGenerator::AddIndices(parameters.primitive, finalcount);
+  if (!g_vertex_manager->CullTriangles(parameters.primitive, loader->m_native_vtx_decl,
+                                       parameters.destination, finalcount, first_index))
+  {
+    writesize = 0;
+  }
   ADDSTAT(stats.thisFrame.numPrims, finalcount);
   INCSTAT(stats.thisFrame.numPrimitiveJoins);
   return true;
@@ -7,10 +7,15 @@
 #include <memory>
 
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
+#include "Common/TraceEvents.h"
 #include "Core/ConfigManager.h"
 
+#include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/BPStructs.h"
+#include "VideoCommon/CPMemory.h"
 #include "VideoCommon/Debugger.h"
+#include "VideoCommon/DrawProfiler.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/TessellationShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
@@ -41,6 +46,18 @@ static const PrimitiveType primitive_from_gx[8] = {
   PrimitiveType::Points,    // GX_DRAW_POINTS
 };
 
+// IndexGenerator writes all triangles as strips when primitive restart is used.
+static const PrimitiveType primitive_from_gx_pr[8] = {
+  PrimitiveType::TriangleStrip, // GX_DRAW_QUADS
+  PrimitiveType::TriangleStrip, // GX_DRAW_QUADS_2
+  PrimitiveType::TriangleStrip, // GX_DRAW_TRIANGLES
+  PrimitiveType::TriangleStrip, // GX_DRAW_TRIANGLE_STRIP
+  PrimitiveType::TriangleStrip, // GX_DRAW_TRIANGLE_FAN
+  PrimitiveType::Lines,         // GX_DRAW_LINES
+  PrimitiveType::Lines,         // GX_DRAW_LINE_STRIP
+  PrimitiveType::Points,        // GX_DRAW_POINTS
+};
+
 // Due to the BT.601 standard which the GameCube is based on being a compromise
 // between PAL and NTSC, neither standard gets square pixels. They are each off
 // by ~9% in opposite directions.
@@ -60,10 +77,14 @@ static bool AspectIs16_9(float width, float height)
 
 PrimitiveType VertexManagerBase::GetPrimitiveType(int primitive)
 {
-  return primitive_from_gx[primitive & 7];
+  return (IndexGenerator::UsesPrimitiveRestart() ? primitive_from_gx_pr : primitive_from_gx)[primitive & 7];
 }
 
-VertexManagerBase::VertexManagerBase() {}
+VertexManagerBase::VertexManagerBase()
+{
+  // Backend features are only known once the backend has created its device.
+  IndexGenerator::Init(g_ActiveConfig.backend_info.bSupportsPrimitiveRestart);
+}
 
 VertexManagerBase::~VertexManagerBase() {}
 
@@ -73,6 +94,17 @@ inline u32 GetRemainingIndices(int prim)
 {
   OpcodeDecoder::GxDrawMode primitive = static_cast<OpcodeDecoder::GxDrawMode>(prim);
   u32 index_len = VertexManagerBase::MAXIBUFFERSIZE - IndexGenerator::GetIndexLen();
+  if (IndexGenerator::UsesPrimitiveRestart() && primitive <= OpcodeDecoder::GX_DRAW_TRIANGLE_FAN)
+  {
+    // Every primitive is followed by a restart index.
+    if (primitive == OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP)
+      return index_len > 0 ? index_len - 1 : 0;
+    if (primitive == OpcodeDecoder::GX_DRAW_TRIANGLE_FAN)
+      return index_len / 2;
+    if (primitive == OpcodeDecoder::GX_DRAW_TRIANGLES)
+      return index_len / 4 * 3;
+    return index_len / 5 * 4;
+  }
   if (primitive == OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP || primitive == OpcodeDecoder::GX_DRAW_TRIANGLE_FAN)
   {
     return index_len / 3 + 2;
@@ -100,7 +132,7 @@ void VertexManagerBase::PrepareForAdditionalData(int primitive, u32 count, u32 s
 
   // We can't merge different kinds of primitives, so we have to flush here
   // Check for size in buffer, if the buffer gets full, call Flush()
-  PrimitiveType new_primitive_type = primitive_from_gx[primitive];
+  PrimitiveType new_primitive_type = GetPrimitiveType(primitive);
   if (m_current_primitive_type != new_primitive_type)
   {
     RasterizationState raster_state = {};
@@ -109,7 +141,7 @@ void VertexManagerBase::PrepareForAdditionalData(int primitive, u32 count, u32 s
   }
   if (count > max_index_size
     || needed_vertex_bytes > GetRemainingSize()
-    || m_current_primitive_type != primitive_from_gx[primitive])
+    || m_current_primitive_type != new_primitive_type)
   {
 #if defined(_DEBUG) || defined(DEBUGFAST)
     if (count > IndexGenerator::GetRemainingIndices())
@@ -123,16 +155,65 @@ void VertexManagerBase::PrepareForAdditionalData(int primitive, u32 count, u32 s
 #endif
     Flush();
   }
-  m_current_primitive_type = primitive_from_gx[primitive];
+  m_current_primitive_type = new_primitive_type;
   m_cull_all = bpmem.genMode.cullmode == GenMode::CULL_ALL && primitive < 5;
   // need to alloc new buffer
   if (m_is_flushed)
   {
+    DrawProfiler::BeginBatch();
     g_vertex_manager->ResetBuffer(stride);
     m_is_flushed = false;
+    m_used_matrix_rows = 0;
+    m_used_normal_matrices = 0;
+  }
+  TrackMatrixUsage();
+}
+
+// Bits first to last, both inclusive.
+static u64 RowMask(u32 first, u32 last)
+{
+  last = std::min(last, 63u);
+  return (~0ULL >> (63 - last)) & (~0ULL << first);
+}
+
+void VertexManagerBase::TrackMatrixUsage()
+{
+  const TVtxDesc& desc = g_main_cp_state.vtx_desc;
+  if (desc.Hex & 0x1FF)
+  {
+    // Per vertex matrix indices can point anywhere.
+    m_used_matrix_rows = ~0ULL;
+    m_used_normal_matrices = ~0U;
+    return;
+  }
+
+  const TMatrixIndexA& ma = g_main_cp_state.matrix_index_a;
+  const TMatrixIndexB& mb = g_main_cp_state.matrix_index_b;
+  // Position and texture matrices take up to 3 rows, normal matrices overlap the same way.
+  const u32 pos = ma.PosNormalMtxIdx;
+  m_used_matrix_rows |= RowMask(pos, pos + 2);
+  m_used_normal_matrices |= static_cast<u32>(RowMask(pos & 31, (pos & 31) + 2));
+  for (u32 tex : {u32(ma.Tex0MtxIdx), u32(ma.Tex1MtxIdx), u32(ma.Tex2MtxIdx), u32(ma.Tex3MtxIdx),
+                  u32(mb.Tex4MtxIdx), u32(mb.Tex5MtxIdx), u32(mb.Tex6MtxIdx), u32(mb.Tex7MtxIdx)})
+  {
+    m_used_matrix_rows |= RowMask(tex, tex + 2);
   }
 }
 
+bool VertexManagerBase::IsXFRangeInUse(u32 start, u32 end) const
+{
+  if (m_is_flushed)
+    return false;
+  if (end <= XFMEM_POSMATRICES_END)
+    return (m_used_matrix_rows & RowMask(start / 4, (end - 1) / 4)) != 0;
+  if (start >= XFMEM_NORMALMATRICES && end <= XFMEM_NORMALMATRICES_END)
+  {
+    const u64 used = RowMask((start - XFMEM_NORMALMATRICES) / 3, (end - 1 - XFMEM_NORMALMATRICES) / 3);
+    return (m_used_normal_matrices & used) != 0;
+  }
+  return true;
+}
+
 std::pair<size_t, size_t> VertexManagerBase::ResetFlushAspectRatioCount()
 {
   std::pair<size_t, size_t> val = std::make_pair(m_flush_count_4_3, m_flush_count_anamorphic);
@@ -210,6 +291,8 @@ static void SetSamplerState(u32 index, bool custom_tex, bool has_arbitrary_mips,
 
 void VertexManagerBase::DoFlush()
 {
+  TRACE_SCOPE("VertexManagerBase::Flush");
+  RenderTimeScope render_time;
   // loading a state will invalidate BP, so check for it
   NativeVertexFormat* current_vertex_format = VertexLoaderManager::GetCurrentVertexFormat();
   g_video_backend->CheckInvalidState();
@@ -241,6 +324,7 @@ void VertexManagerBase::DoFlush()
   PRIM_LOG("pixel: tev=%d, ind=%d, texgen=%d, dstalpha=%d, alphatest=0x%x", (int)bpmem.genMode.numtevstages + 1, (int)bpmem.genMode.numindstages.Value(),
     (int)bpmem.genMode.numtexgens, (u32)bpmem.dstalpha.enable, (bpmem.alpha_test.hex >> 16) & 0xff);
 #endif
+  const TextureCacheBase::TCacheEntry* first_texture = nullptr;
   if (!m_cull_all)
   {
     u32 usedtextures = 0;
@@ -262,6 +346,8 @@ void VertexManagerBase::DoFlush()
         const TextureCacheBase::TCacheEntry* tentry = g_texture_cache->Load(i);
         if (tentry)
         {
+          if (!first_texture)
+            first_texture = tentry;
           int materiallayer = 0;
           int emissivelayer = 0;
           if (g_ActiveConfig.HiresMaterialMapsEnabled())
@@ -327,9 +413,12 @@ void VertexManagerBase::DoFlush()
     }
   }
 
-  if (m_current_primitive_type == PrimitiveType::Triangles)
+  if (m_current_primitive_type == PrimitiveType::Triangles || m_current_primitive_type == PrimitiveType::TriangleStrip)
   {
     const PortableVertexDeclaration &vtx_dcl = current_vertex_format->GetVertexDeclaration();
+    // Skip the restart index behind the last triangle.
+    const u32 index_len = IndexGenerator::GetIndexLen();
+    const u32 last_triangle_end = IndexGenerator::UsesPrimitiveRestart() && index_len > 0 ? index_len - 1 : index_len;
     if (bpmem.genMode.zfreeze)
     {
       if (m_zslope_refresh_required)
@@ -338,9 +427,9 @@ void VertexManagerBase::DoFlush()
         m_zslope_refresh_required = false;
       }
     }
-    else if (IndexGenerator::GetIndexLen() >= 3)
+    else if (last_triangle_end >= 3)
     {
-      CalculateZSlope(vtx_dcl, g_vertex_manager->GetIndexBuffer() + IndexGenerator::GetIndexLen() - 3);
+      CalculateZSlope(vtx_dcl, g_vertex_manager->GetIndexBuffer() + last_triangle_end - 3);
     }
 
     // if cull mode is CULL_ALL, ignore triangles and quads
@@ -354,13 +443,28 @@ void VertexManagerBase::DoFlush()
   GeometryShaderManager::SetConstants();
   TessellationShaderManager::SetConstants();
   PixelShaderManager::SetConstants();
+  if (g_ActiveConfig.TessellationEnabled() && m_current_primitive_type == PrimitiveType::Triangles)
+    TessellationShaderManager::CountPatches(IndexGenerator::GetIndexLen() / 3);
   const bool useDstAlpha = bpmem.dstalpha.enable &&
     bpmem.blendmode.alphaupdate &&
     bpmem.zcontrol.pixel_format == PEControl::RGBA6_Z24;
 
   if (PerfQueryBase::ShouldEmulate())
     g_perf_query->EnableQuery(bpmem.zcontrol.early_ztest ? PQG_ZCOMP_ZCOMPLOC : PQG_ZCOMP);
+  const bool profile_draw = DrawProfiler::IsEnabled();
+  if (profile_draw)
+  {
+    DrawProfiler::BeginDraw(IndexGenerator::GetIndexLen(), first_texture ? first_texture->addr : 0,
+                            first_texture ? first_texture->base_hash : 0);
+    g_renderer->BeginDrawTimer(DrawProfiler::GetNextDrawIndex());
+  }
+  g_texture_cache->OnEFBModified(BPFunctions::GetScissorRect());
   g_vertex_manager->vFlush(useDstAlpha);
+  if (profile_draw)
+  {
+    g_renderer->EndDrawTimer();
+    DrawProfiler::EndDraw();
+  }
   if (PerfQueryBase::ShouldEmulate())
     g_perf_query->DisableQuery(bpmem.zcontrol.early_ztest ? PQG_ZCOMP_ZCOMPLOC : PQG_ZCOMP);
 
@@ -419,3 +523,189 @@ void VertexManagerBase::CalculateZSlope(const PortableVertexDeclaration &vert_de
   m_zslope.f0 = out[2] - (out[0] * m_zslope.dfdx + out[1] * m_zslope.dfdy);
   m_zslope_refresh_required = true;
 }
+
+// Clip space x, y and w rows of the position matrix followed by the projection.
+static void GetClipMatrix(u32 matrix_index, float out[3][4])
+{
+  const float* world = xfmem.posMatrices + (matrix_index & 0x3F) * 4;
+  const float* raw = xfmem.projection.rawProjection;
+  if (xfmem.projection.type == GX_PERSPECTIVE)
+  {
+    const float pw = g_ActiveConfig.fAspectRatioHackW;
+    const float ph = g_ActiveConfig.fAspectRatioHackH;
+    for (int i = 0; i < 4; i++)
+    {
+      out[0][i] = (raw[0] * world[i] + raw[1] * world[8 + i]) * pw;
+      out[1][i] = (raw[2] * world[4 + i] + raw[3] * world[8 + i]) * ph;
+      out[2][i] = -world[8 + i];
+    }
+  }
+  else
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      out[0][i] = raw[0] * world[i];
+      out[1][i] = raw[2] * world[4 + i];
+      out[2][i] = 0.0f;
+    }
+    out[0][3] += raw[1];
+    out[1][3] += raw[3];
+    out[2][3] = 1.0f;
+  }
+}
+
+bool VertexManagerBase::CullTriangles(int primitive, const PortableVertexDeclaration& vtx_decl,
+                                      const u8* vertices, u32 count, u16* first_index)
+{
+  // Free look moves the camera after the game's transform, tessellation displaces the vertices.
+  if (!g_ActiveConfig.bCPUCull || primitive > OpcodeDecoder::GX_DRAW_TRIANGLE_FAN || count < 3 ||
+      m_cull_all || g_ActiveConfig.bFreeLook || g_ActiveConfig.TessellationEnabled())
+  {
+    return true;
+  }
+  // Without clipping, the hardware draws whatever lands inside the scissor rectangle.
+  // Stereo shifts the vertices of each eye horizontally.
+  const bool cull_outside =
+      (xfmem.clipDisable & 1) == 0 && g_ActiveConfig.iStereoMode == STEREO_OFF;
+  const u32 cull_mode = bpmem.genMode.cullmode;
+
+  // Transform the positions once, strips and fans share most of them between triangles.
+  m_cull_positions.resize(count * 4);
+  m_cull_outcodes.resize(count);
+  float* clip = m_cull_positions.data();
+  u32 current_matrix = UINT32_MAX;
+  float matrix[3][4];
+  const u8* vertex = vertices;
+#if _M_SSE >= 0x200
+  __m128 columns[4];
+#endif
+  for (u32 i = 0; i < count; i++, vertex += vtx_decl.stride, clip += 4)
+  {
+    const u32 matrix_index = vtx_decl.posmtx.enable ? vertex[vtx_decl.posmtx.offset] :
+                                                      xfmem.MatrixIndexA.PosNormalMtxIdx;
+    const float* position = reinterpret_cast<const float*>(vertex + vtx_decl.position.offset);
+    const float z = vtx_decl.position.components == 3 ? position[2] : 0.0f;
+    if (matrix_index != current_matrix)
+    {
+      current_matrix = matrix_index;
+      GetClipMatrix(matrix_index, matrix);
+#if _M_SSE >= 0x200
+      for (int j = 0; j < 4; j++)
+        columns[j] = _mm_setr_ps(matrix[0][j], matrix[1][j], matrix[2][j], 0.0f);
+#endif
+    }
+#if _M_SSE >= 0x200
+    const __m128 result = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(position[0])),
+                   _mm_mul_ps(columns[1], _mm_set1_ps(position[1]))),
+        _mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(z)), columns[3]));
+    _mm_storeu_ps(clip, result);
+    // x and y against w and -w, one bit per plane.
+    const __m128 w = _mm_shuffle_ps(result, result, _MM_SHUFFLE(2, 2, 2, 2));
+    const int outside_positive = _mm_movemask_ps(_mm_cmpgt_ps(result, w)) & 3;
+    const int outside_negative =
+        _mm_movemask_ps(_mm_cmplt_ps(result, _mm_sub_ps(_mm_setzero_ps(), w))) & 3;
+    m_cull_outcodes[i] = static_cast<u8>(outside_positive | (outside_negative << 2));
+#else
+    for (int j = 0; j < 3; j++)
+    {
+      clip[j] = matrix[j][0] * position[0] + matrix[j][1] * position[1] + matrix[j][2] * z +
+                matrix[j][3];
+    }
+    m_cull_outcodes[i] = static_cast<u8>((clip[0] > clip[2]) | ((clip[1] > clip[2]) << 1) |
+                                         ((clip[0] < -clip[2]) << 2) |
+                                         ((clip[1] < -clip[2]) << 3));
+#endif
+  }
+
+  u32 culled = 0;
+  u32 rejected = 0;
+  // Same test as the software renderer's clipper.
+  auto is_visible = [&](u32 a, u32 b, u32 c) {
+    if (cull_outside && (m_cull_outcodes[a] & m_cull_outcodes[b] & m_cull_outcodes[c]))
+    {
+      rejected++;
+      return false;
+    }
+    const float* v0 = &m_cull_positions[a * 4];
+    const float* v1 = &m_cull_positions[b * 4];
+    const float* v2 = &m_cull_positions[c * 4];
+    const float normal_z = (v0[0] * v2[2] - v2[0] * v0[2]) * v1[1] +
+                           (v2[0] * v0[1] - v0[0] * v2[1]) * v1[2] +
+                           (v2[1] * v0[2] - v0[1] * v2[2]) * v1[0];
+    const bool backface = normal_z < 0.0f;
+    if (normal_z == 0.0f || ((cull_mode & 1) && !backface) || ((cull_mode & 2) && backface))
+    {
+      culled++;
+      return false;
+    }
+    return true;
+  };
+
+  // The triangles in the order and winding IndexGenerator writes them in.
+  // Without primitive restart the visible ones are written again as a list, with it only whole
+  // batches are dropped, as its strips can't be split up cheaply.
+  const bool rewrite = !IndexGenerator::UsesPrimitiveRestart();
+  const u32 base = IndexGenerator::GetNumVerts() - count;
+  u16* out = first_index;
+  u32 visible = 0;
+  auto add_triangle = [&](u32 a, u32 b, u32 c) {
+    if (!rewrite && visible > 0)
+      return;
+    if (!is_visible(a, b, c))
+      return;
+    visible++;
+    if (rewrite)
+    {
+      out[0] = static_cast<u16>(base + a);
+      out[1] = static_cast<u16>(base + b);
+      out[2] = static_cast<u16>(base + c);
+      out += 3;
+    }
+  };
+
+  switch (primitive)
+  {
+  case OpcodeDecoder::GX_DRAW_QUADS:
+  case OpcodeDecoder::GX_DRAW_QUADS_2:
+  {
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+      add_triangle(i, i + 1, i + 2);
+      add_triangle(i, i + 2, i + 3);
+    }
+    if (i + 3 == count)
+      add_triangle(i, i + 1, i + 2);
+    break;
+  }
+  case OpcodeDecoder::GX_DRAW_TRIANGLES:
+    for (u32 i = 0; i + 3 <= count; i += 3)
+      add_triangle(i, i + 1, i + 2);
+    break;
+  case OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP:
+    for (u32 i = 0; i + 3 <= count; i++)
+    {
+      if (i & 1)
+        add_triangle(i, i + 2, i + 1);
+      else
+        add_triangle(i, i + 1, i + 2);
+    }
+    break;
+  case OpcodeDecoder::GX_DRAW_TRIANGLE_FAN:
+    for (u32 i = 1; i + 2 <= count; i++)
+      add_triangle(0, i, i + 1);
+    break;
+  }
+
+  ADDSTAT(stats.thisFrame.numTrianglesCulled, culled);
+  ADDSTAT(stats.thisFrame.numTrianglesRejected, rejected);
+  if (visible == 0)
+  {
+    IndexGenerator::Truncate(first_index, count);
+    return false;
+  }
+  if (rewrite)
+    IndexGenerator::Truncate(out, 0);
+  return true;
+}
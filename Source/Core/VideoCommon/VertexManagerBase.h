@@ -54,6 +54,18 @@ public:
     DoFlush();
   }
 
+  // XF matrix loads only have to end the current batch when its vertices read the loaded matrices.
+  bool IsXFRangeInUse(u32 start, u32 end) const;
+  // With the position matrix index stored in every vertex, changing it doesn't end the batch.
+  bool HasPerVertexMatrixIndices() const { return m_per_vertex_matrix_indices; }
+
+  // Removes the triangles of the last primitive batch that can't produce any pixels: the ones
+  // facing the culled side, zero area ones and ones entirely outside of the clip volume.
+  // vertices and first_index point to the batch's converted vertices and first index.
+  // Returns false if nothing of the batch is left, its vertices don't need to be kept then.
+  bool CullTriangles(int primitive, const PortableVertexDeclaration& vtx_decl, const u8* vertices,
+                     u32 count, u16* first_index);
+
   virtual std::unique_ptr<NativeVertexFormat> CreateNativeVertexFormat(const PortableVertexDeclaration& vtx_decl) = 0;
 
   void DoState(PointerWrap& p);
@@ -84,6 +96,7 @@ protected:
   u8 *m_pEndBufferPointer = nullptr;
 
   bool m_cull_all = false;
+  bool m_per_vertex_matrix_indices = true;
 
   void CalculateZSlope(const PortableVertexDeclaration &vert_decl, const u16* indices);
   virtual void vDoState(PointerWrap& p) {}
@@ -92,8 +105,15 @@ protected:
 private:
   size_t m_flush_count_4_3 = 0;
   size_t m_flush_count_anamorphic = 0;
+  // One bit per 4 word row of the position matrix memory and per normal matrix read by the batch.
+  u64 m_used_matrix_rows = 0;
+  u32 m_used_normal_matrices = 0;
+  // Clip space x, y and w of the batch being culled, and which clip planes they are outside of.
+  std::vector<float> m_cull_positions;
+  std::vector<u8> m_cull_outcodes;
 
   void DoFlush();
+  void TrackMatrixUsage();
 
   virtual void vFlush(bool useDstAlpha) = 0;
   virtual u16* GetIndexBuffer() = 0;
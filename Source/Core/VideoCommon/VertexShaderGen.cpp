@@ -13,6 +13,7 @@
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DriverDetails.h"
+#include "VideoCommon/GeometryShaderGen.h"
 #include "VideoCommon/LightingShaderGen.h"
 #include "VideoCommon/VertexShaderGen.h"
 #include "VideoCommon/VideoConfig.h"
@@ -119,6 +120,16 @@ inline void GenerateVertexShader(ShaderCode& out, API_TYPE api_type,
   if ((api_type & API_D3D9) == 0)
     out.Write("};\n");
 
+  // With vertex stereo the eye offsets are read from the geometry shader constants.
+  if (uid_data.vertex_stereo)
+  {
+    out.Write("UBO_BINDING(std140, 3) uniform GSBlock {\n"
+              "\tfloat4 " I_STEREOPARAMS ";\n"
+              "\tfloat4 " I_LINEPTPARAMS ";\n"
+              "\tint4 " I_TEXOFFSET ";\n"
+              "};\n");
+  }
+
   out.Write("struct VS_OUTPUT {\n");
   GenerateVSOutputMembers(out, api_type, uid_data.pixel_lighting, uid_data.numTexGens);
   out.Write("};\n");
@@ -153,6 +164,8 @@ inline void GenerateVertexShader(ShaderCode& out, API_TYPE api_type,
       GenerateVSOutputMembers(
           out, api_type, uid_data.pixel_lighting, uid_data.numTexGens,
           GetInterpolationQualifier(api_type, hostconfig.msaa, hostconfig.ssaa, false, true));
+      if (uid_data.vertex_stereo)
+        out.Write("\tflat int layer;\n");
       out.Write("} vs;\n");
     }
     else
@@ -542,9 +555,18 @@ inline void GenerateVertexShader(ShaderCode& out, API_TYPE api_type,
 
   if (api_type == API_OPENGL || api_type == API_VULKAN)
   {
+    if (uid_data.vertex_stereo)
+    {
+      // The draw is instanced once per eye, this is the same offset the geometry shader applies.
+      out.Write("int eye = gl_InstanceID;\n");
+      out.Write("o.pos.x += ((eye == 0) ? " I_STEREOPARAMS ".x : " I_STEREOPARAMS
+                ".y) * (o.pos.w - " I_STEREOPARAMS ".z);\n");
+    }
     if (hostconfig.backend_geometry_shaders || api_type == API_VULKAN)
     {
       AssignVSOutputMembers(out, api_type, "vs", "o", uid_data.pixel_lighting, uid_data.numTexGens);
+      if (uid_data.vertex_stereo)
+        out.Write("vs.layer = eye;\ngl_Layer = eye;\n");
     }
     else
     {
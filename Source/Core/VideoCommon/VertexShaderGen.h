@@ -104,7 +104,8 @@ struct vertex_shader_uid_data
   u32 numColorChans : 2;
   u32 dualTexTrans_enabled : 1;
   u32 pixel_lighting : 1;
-  u32 pad1 : 2;
+  u32 vertex_stereo : 1;  // Both eyes are drawn as instances, without a geometry shader
+  u32 pad1 : 1;
 
   u32 texMtxInfo_n_projection : 16; // Stored separately to guarantee that the texMtxInfo struct is 8 bits wide
   u32 pad0 : 16;
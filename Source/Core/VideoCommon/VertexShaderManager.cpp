@@ -739,8 +739,13 @@ void VertexShaderManager::SetTexMatrixChangedA(u32 Value)
 {
   if (g_main_cp_state.matrix_index_a.Hex != Value)
   {
-    g_vertex_manager->Flush();
-    s_tex_matrices_changed[0] = true;
+    // The vertex loaders store the position matrix index in every vertex, so only changes of the
+    // texture matrix indices end the batch.
+    const bool tex_changed = ((g_main_cp_state.matrix_index_a.Hex ^ Value) & ~0x3Fu) != 0;
+    if (tex_changed || !g_vertex_manager->HasPerVertexMatrixIndices())
+      g_vertex_manager->Flush();
+    if (tex_changed)
+      s_tex_matrices_changed[0] = true;
     g_main_cp_state.matrix_index_a.Hex = Value;
   }
 }
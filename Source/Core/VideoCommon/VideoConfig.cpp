@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <atomic>
 #include <cmath>
 #include <mutex>
 
@@ -21,6 +22,9 @@ VideoConfig g_Config;
 VideoConfig g_ActiveConfig;
 static std::mutex config_mutex;
 static bool s_has_registered_callback = false;
+// The config version g_Config was last read at
+static std::atomic<u64> s_refreshed_version{0};
+static std::atomic<int> s_dynamic_efb_scale{0};
 
 void UpdateActiveConfig()
 {
@@ -28,6 +32,19 @@ void UpdateActiveConfig()
     Movie::SetGraphicsConfig();
   std::unique_lock<std::mutex> config_lock(config_mutex);
   g_ActiveConfig = g_Config;
+
+  // Only fixed scales are lowered, the dynamic scale never goes above the configured one
+  const int dynamic_efb_scale = s_dynamic_efb_scale.load();
+  if (g_ActiveConfig.bDynamicEFBScale && dynamic_efb_scale >= SCALE_1X &&
+      dynamic_efb_scale < g_ActiveConfig.iEFBScale)
+  {
+    g_ActiveConfig.iEFBScale = dynamic_efb_scale;
+  }
+}
+
+void SetDynamicEFBScale(int scale)
+{
+  s_dynamic_efb_scale.store(scale);
 }
 void VideoConfig::ClearFormats()
 {
@@ -56,6 +73,8 @@ VideoConfig::VideoConfig()
   bTexDeposterize = false;
   iTexScalingType = 0;
   iTexScalingFactor = 2;
+  bTexScalingAsync = false;
+  bTexScalingCache = true;
   backend_info.bSupportsMultithreading = false;
   backend_info.bSupportsInternalResolutionFrameDumps = false;
   bEnableValidationLayer = false;
@@ -75,11 +94,15 @@ void VideoConfig::Refresh()
     // thread will detect the config has changed and act accordingly.
     Config::AddConfigChangedCallback([]()
     {
-      Core::RunAsCPUThread([]() { g_Config.Refresh(); }); });
+      // Pausing the emulation isn't worth it if nothing changed since the last refresh
+      if (Config::GetConfigVersion() != s_refreshed_version.load())
+        Core::RunAsCPUThread([]() { g_Config.Refresh(); }); });
     s_has_registered_callback = true;
   }
   std::unique_lock<std::mutex> config_lock(config_mutex);
+  s_refreshed_version.store(Config::GetConfigVersion());
   bVSync = Config::Get(Config::GFX_VSYNC);
+  bLowLatency = Config::Get(Config::GFX_LOW_LATENCY);
   iAdapter = Config::Get(Config::GFX_ADAPTER);
 
   bWidescreenHack = Config::Get(Config::GFX_WIDESCREEN_HACK);
@@ -95,6 +118,7 @@ void VideoConfig::Refresh()
   bShowNetPlayMessages = Config::Get(Config::GFX_SHOW_NETPLAY_MESSAGES);
   bShowOSDClock = Config::Get(Config::GFX_SHOW_OSD_CLOCK);
   bShowFrameTimes = Config::Get(Config::GFX_SHOW_FRAME_TIMES);
+  bShowFrameTimeStats = Config::Get(Config::GFX_SHOW_FRAME_TIME_STATS);
   bLogRenderTimeToFile = Config::Get(Config::GFX_LOG_RENDER_TIME_TO_FILE);
   bOverlayStats = Config::Get(Config::GFX_OVERLAY_STATS);
   bOverlayProjStats = Config::Get(Config::GFX_OVERLAY_PROJ_STATS);
@@ -104,13 +128,17 @@ void VideoConfig::Refresh()
   bHiresMaterialMapsBuild = Config::Get(Config::GFX_HIRES_MATERIAL_MAPS_BUILD);  
   bCacheHiresTextures = Config::Get(Config::GFX_CACHE_HIRES_TEXTURES);
   bWaitForCacheHiresTextures = Config::Get(Config::GFX_WAIT_CACHE_HIRES_TEXTURES);
+  bStreamHiresTextures = Config::Get(Config::GFX_STREAM_HIRES_TEXTURES);
+  iHiresTexturesMemoryBudget = Config::Get(Config::GFX_HIRES_TEXTURES_MEMORY_BUDGET);
   bDumpEFBTarget = Config::Get(Config::GFX_DUMP_EFB_TARGET);
   bDumpFramesAsImages = Config::Get(Config::GFX_DUMP_FRAMES_AS_IMAGES);
   bFreeLook = Config::Get(Config::GFX_FREE_LOOK);
   bCompileShaderOnStartup = Config::Get(Config::GFX_COMPILE_SHADERS_ON_STARTUP);
+  iCompileShaderOnStartupPercent = Config::Get(Config::GFX_COMPILE_SHADERS_ON_STARTUP_PERCENT);
   bUseFFV1 = Config::Get(Config::GFX_USE_FFV1);
   sDumpFormat = Config::Get(Config::GFX_DUMP_FORMAT);
   sDumpCodec = Config::Get(Config::GFX_DUMP_CODEC);
+  sDumpEncoder = Config::Get(Config::GFX_DUMP_ENCODER);
   sDumpPath = Config::Get(Config::GFX_DUMP_PATH);
   iBitrateKbps = Config::Get(Config::GFX_BITRATE_KBPS);
   bInternalResolutionFrameDumps = Config::Get(Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS);
@@ -134,6 +162,7 @@ void VideoConfig::Refresh()
   iMultisamples = Config::Get(Config::GFX_MSAA);
   bSSAA = Config::Get(Config::GFX_SSAA);
   iEFBScale = Config::Get(Config::GFX_EFB_SCALE);
+  bDynamicEFBScale = Config::Get(Config::GFX_DYNAMIC_EFB_SCALE);
   bTexFmtOverlayEnable = Config::Get(Config::GFX_TEXFMT_OVERLAY_ENABLE);
   bTexFmtOverlayCenter = Config::Get(Config::GFX_TEXFMT_OVERLAY_CENTER);
   bWireFrame = Config::Get(Config::GFX_ENABLE_WIREFRAME);
@@ -174,6 +203,8 @@ void VideoConfig::Refresh()
   iTexScalingType = Config::Get(Config::GFX_ENHANCE_TEXTURE_SCALING_TYPE);
   iTexScalingFactor = Config::Get(Config::GFX_ENHANCE_TEXTURE_SCALING_FACTOR);
   bTexDeposterize = Config::Get(Config::GFX_ENHANCE_USE_DEPOSTERIZE);
+  bTexScalingAsync = Config::Get(Config::GFX_ENHANCE_TEXTURE_SCALING_ASYNC);
+  bTexScalingCache = Config::Get(Config::GFX_ENHANCE_TEXTURE_SCALING_CACHE);
 
   bTessellation = Config::Get(Config::GFX_ENHANCE_TESSELLATION);
   bTessellationEarlyCulling = Config::Get(Config::GFX_ENHANCE_TESSELLATION_EARLY_CULLING);
@@ -181,6 +212,8 @@ void VideoConfig::Refresh()
   iTessellationMax = Config::Get(Config::GFX_ENHANCE_TESSELLATION_MAX);
   iTessellationRoundingIntensity = Config::Get(Config::GFX_ENHANCE_TESSELLATION_ROUNDING_INTENSITY);
   iTessellationDisplacementIntensity = Config::Get(Config::GFX_ENHANCE_TESSELLATION_DISPLACEMENT_INTENSITY);
+  iTessellationEdgeLength = Config::Get(Config::GFX_ENHANCE_TESSELLATION_EDGE_LENGTH);
+  iTessellationTriangleBudget = Config::Get(Config::GFX_ENHANCE_TESSELLATION_TRIANGLE_BUDGET);
 
   iStereoMode = Config::Get(Config::GFX_STEREO_MODE);
   iStereoDepth = Config::Get(Config::GFX_STEREO_DEPTH);
@@ -194,11 +227,18 @@ void VideoConfig::Refresh()
   bEFBAccessEnable = Config::Get(Config::GFX_HACK_EFB_ACCESS_ENABLE);
   bEFBFastAccess = Config::Get(Config::GFX_HACK_EFB_FAST_ACCESS_ENABLE);
   iBBoxMode = Config::Get(Config::GFX_HACK_BBOX_MODE);
+  bBBoxLatencyTolerant = Config::Get(Config::GFX_HACK_BBOX_LATENCY_TOLERANT);
   bForceProgressive = Config::Get(Config::GFX_HACK_FORCE_PROGRESSIVE);
   bSkipEFBCopyToRam = Config::Get(Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM);
+  bDeferEFBCopies = Config::Get(Config::GFX_HACK_DEFER_EFB_COPIES);
+  bSkipRedundantEFBCopies = Config::Get(Config::GFX_HACK_SKIP_REDUNDANT_EFB_COPIES);
   bCopyEFBScaled = Config::Get(Config::GFX_HACK_COPY_EFB_SCALED);
   bEFBEmulateFormatChanges = Config::Get(Config::GFX_HACK_EFB_EMULATE_FORMAT_CHANGES);
   bVertexRounding = Config::Get(Config::GFX_HACK_VERTEX_ROUDING);
+  bDisplayListCache = Config::Get(Config::GFX_HACK_DISPLAY_LIST_CACHE);
+  bVertexDataCache = Config::Get(Config::GFX_HACK_VERTEX_DATA_CACHE);
+  bCPUCull = Config::Get(Config::GFX_HACK_CPU_CULL);
+  bKeepTexturesOnStateLoad = Config::Get(Config::GFX_HACK_KEEP_TEXTURES_ON_STATE_LOAD);
 
   bForceDualSourceBlend = Config::Get(Config::GFX_HACK_FORCE_DUAL_SOURCE);
   bFullAsyncShaderCompilation = Config::Get(Config::GFX_HACK_FULL_ASYNC_SHADER_COMPILATION);
@@ -207,6 +247,7 @@ void VideoConfig::Refresh()
 
   bBackgroundShaderCompiling = Config::Get(Config::GFX_BACKGROUND_SHADER_COMPILING);
   bDisableSpecializedShaders = Config::Get(Config::GFX_DISABLE_SPECIALIZED_SHADERS);
+  bUberShaderSpecialization = Config::Get(Config::GFX_UBERSHADER_SPECIALIZATION);
 
   phack.m_enable = Config::Get(Config::GFX_PROJECTION_HACK) == 1;
   phack.m_sznear = Config::Get(Config::GFX_PROJECTION_HACK_SZNEAR) == 1;
@@ -214,6 +255,7 @@ void VideoConfig::Refresh()
   phack.m_znear = Config::Get(Config::GFX_PROJECTION_HACK_ZNEAR);
   phack.m_zfar = Config::Get(Config::GFX_PROJECTION_HACK_ZFAR);
   bPerfQueriesEnable = Config::Get(Config::GFX_PERF_QUERIES_ENABLE);
+  bPerfQueriesAsync = Config::Get(Config::GFX_PERF_QUERIES_ASYNC);
 
   if (iEFBScale == SCALE_FORCE_INTEGRAL)
   {
@@ -263,6 +305,8 @@ void VideoConfig::VerifyValidity()
   iTessellationMax = iTessellationMax < 2 ? 2 : (iTessellationMax > 63 ? 63 : iTessellationMax);
   iTessellationRoundingIntensity = iTessellationRoundingIntensity > 100 ? 100 : (iTessellationRoundingIntensity < 0 ? 0 : iTessellationRoundingIntensity);
   iTessellationDisplacementIntensity = iTessellationDisplacementIntensity > 300 ? 300 : (iTessellationDisplacementIntensity < 0 ? 0 : iTessellationDisplacementIntensity);
+  iTessellationEdgeLength = std::max(iTessellationEdgeLength, 0);
+  iTessellationTriangleBudget = std::max(iTessellationTriangleBudget, 0);
   if (iStereoMode > 0)
   {
     if (!backend_info.bSupportsGeometryShaders)
@@ -318,3 +362,14 @@ bool VideoConfig::CanPrecompileUberShaders() const
   // We don't want to precompile ubershaders if they're never going to be used.
   return bBackgroundShaderCompiling || bDisableSpecializedShaders;
 }
+
+bool VideoConfig::UsingUberShadersOnly() const
+{
+  return backend_info.bSupportsUberShaders && bDisableSpecializedShaders;
+}
+
+bool VideoConfig::UsingHybridUberShaders() const
+{
+  return backend_info.bSupportsUberShaders && bBackgroundShaderCompiling &&
+         !bDisableSpecializedShaders;
+}
@@ -112,9 +112,16 @@ struct VideoConfig final
   bool IsVSync() const;
   bool PixelLightingEnabled(const XFMemory& xfr, const u32 components) const;
   bool CanPrecompileUberShaders() const;
+  // Ubershader mode as every backend applies it, see bBackgroundShaderCompiling below. In hybrid
+  // mode a draw uses the ubershaders until its specialized shaders are ready and is never skipped,
+  // whatever bFullAsyncShaderCompilation says.
+  bool UsingUberShadersOnly() const;
+  bool UsingHybridUberShaders() const;
+  bool UsingUberShaders() const { return UsingUberShadersOnly() || UsingHybridUberShaders(); }
 
   // General
   bool bVSync;
+  bool bLowLatency;  // Keep as few frames queued for presentation as the backend allows
   bool bWidescreenHack;
   int iAspectRatio;
   bool bCrop;   // Aspect ratio controls.
@@ -149,6 +156,9 @@ struct VideoConfig final
   u32 iMultisamples;
   bool bSSAA;
   int iEFBScale;
+  // Lowers the internal resolution down to native while rendering can't keep up, see
+  // Renderer::UpdateDynamicEFBScale. iEFBScale is the highest scale used.
+  bool bDynamicEFBScale;
   FilteringMode eFilteringMode;
   HostCullMode eCullMode;
   int iMaxAnisotropy;
@@ -161,12 +171,18 @@ struct VideoConfig final
   bool bTexDeposterize;
   int iTexScalingType;
   int iTexScalingFactor;
+  bool bTexScalingAsync;
+  bool bTexScalingCache;
   bool bTessellation;
   bool bTessellationEarlyCulling;
   int iTessellationDistance;
   int iTessellationMax;
   int iTessellationRoundingIntensity;
   int iTessellationDisplacementIntensity;
+  // Target length of a tessellated edge in pixels, 0 uses the fixed factor.
+  int iTessellationEdgeLength;
+  // Tessellated triangles per frame in thousands, 0 is unlimited.
+  int iTessellationTriangleBudget;
   bool bForceTrueColor;
   bool bHPFrameBuffer;
   // Information
@@ -175,6 +191,7 @@ struct VideoConfig final
   bool bShowNetPlayMessages;
   bool bShowOSDClock;
   bool bShowFrameTimes;
+  bool bShowFrameTimeStats;
   bool bShowInputDisplay;
   bool bOverlayStats;
   bool bOverlayProjStats;
@@ -194,10 +211,15 @@ struct VideoConfig final
   bool bHiresMaterialMapsBuild;
   bool bCacheHiresTextures;
   bool bWaitForCacheHiresTextures;
+  bool bStreamHiresTextures;
+  // Memory custom textures may use in MB, 0 picks a limit based on the system RAM
+  int iHiresTexturesMemoryBudget;
   bool bDumpEFBTarget;
   bool bDumpFramesAsImages;
   bool bUseFFV1;
   std::string sDumpCodec;
+  // libavcodec encoder name, e.g. h264_nvenc, h264_vaapi or h264_qsv. Overrides sDumpCodec.
+  std::string sDumpEncoder;
   std::string sDumpFormat;
   std::string sDumpPath;
   bool bInternalResolutionFrameDumps;
@@ -205,6 +227,9 @@ struct VideoConfig final
   bool bBorderlessFullscreen;
   int iBitrateKbps;
   bool bCompileShaderOnStartup;
+  // Share of the most used cached shaders compiled before boot continues, the rest is compiled in
+  // the background. Currently only supported with Vulkan.
+  int iCompileShaderOnStartupPercent;
 
 
   // Hacks
@@ -212,11 +237,16 @@ struct VideoConfig final
   bool bEFBFastAccess;
   bool bForceProgressive;
   bool bPerfQueriesEnable;
+  // Answer perf query reads with the results the GPU already has, never wait for it.
+  bool bPerfQueriesAsync;
   bool bFullAsyncShaderCompilation;
   bool bEnableGPUTextureDecoding;
   bool bEnableComputeTextureEncoding;
   bool bEFBEmulateFormatChanges;
   bool bSkipEFBCopyToRam;
+  bool bDeferEFBCopies;
+  // Skip EFB copies that would write the same result to the same place again.
+  bool bSkipRedundantEFBCopies;
   bool bCopyEFBScaled;
   int iSafeTextureCache_ColorSamples;
   ProjectionHackConfig phack;
@@ -239,7 +269,16 @@ struct VideoConfig final
 
   bool bFastDepthCalc;
   bool bVertexRounding;
+  bool bDisplayListCache;
+  bool bVertexDataCache;
+  // Drops back facing, zero area and off-screen triangles before they are uploaded.
+  bool bCPUCull;
+  // Textures decoded from memory survive a savestate load and are reused when their hash matches.
+  bool bKeepTexturesOnStateLoad;
   int iBBoxMode;
+  // GPU bounding box reads return the last finished readback instead of waiting for the GPU.
+  // Only for games that tolerate the registers lagging a frame behind, set from their game INI.
+  bool bBBoxLatencyTolerant;
   //for dx9-backend
   bool bForceDualSourceBlend;
   int iLog; // CONF_ bits
@@ -292,6 +331,10 @@ struct VideoConfig final
 
   // Use ubershaders only, don't compile specialized shaders.
   bool bDisableSpecializedShaders;
+
+  // Draw with ubershader pipelines that have the TEV stage count and alpha test baked in once
+  // they are compiled. Currently only supported with Vulkan.
+  bool bUberShaderSpecialization;
   
   // Static config per API
   // TODO: Move this out of VideoConfig
@@ -306,6 +349,8 @@ struct VideoConfig final
     std::string AdapterName; // for OpenGL
 
     u32 MaxTextureSize;
+    // Dedicated video memory of the adapter in bytes, 0 if the backend can't tell.
+    u64 VideoMemorySize;
 
     bool bSupportedFormats[HostTextureFormat::PC_TEX_NUM_FORMATS]; // used for D3D9 in TextureCache		
     bool bSupportsDualSourceBlend; // only supported by D3D11 and OpenGL
@@ -323,6 +368,7 @@ struct VideoConfig final
     bool bSupportsExclusiveFullscreen;
     bool bSupportsBBox;
     bool bSupportsGSInstancing; // Needed by GeometryShaderGen, so must stay in VideoCommon
+    bool bSupportsVSLayerOutput; // Needed by VertexShaderGen, so must stay in VideoCommon
     bool bSupportsPaletteConversion;
     bool bSupportsClipControl; // Needed by VertexShaderGen, so must stay in VideoCommon		
     bool bSupportsSSAA;
@@ -341,6 +387,7 @@ struct VideoConfig final
     bool bSupportsDynamicSamplerIndexing;  // Needed by UberShaders, so must stay in VideoCommon
     bool bSupportsUberShaders;
     bool bSupportsHighPrecisionFrameBuffer;
+    bool bSupportsPrimitiveRestart;  // Needed by IndexGenerator, so must stay in VideoCommon
   } backend_info;
 
   // Utility
@@ -381,3 +428,6 @@ extern VideoConfig g_ActiveConfig;
 
 // Called every frame.
 void UpdateActiveConfig();
+// The scale g_ActiveConfig.iEFBScale is lowered to while the dynamic EFB scale is enabled, 0 to
+// use the configured one.
+void SetDynamicEFBScale(int scale);
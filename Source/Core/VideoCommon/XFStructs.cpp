@@ -2,7 +2,15 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
+
+#ifdef _M_ARM_64
+#include <arm_neon.h>
+#endif
+
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
 
@@ -18,9 +26,51 @@
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/OpcodeDecoding.h"
 
+// Returns true if the count big endian words at src equal the ones at dst. Games often upload the
+// same matrices and registers for every draw, those writes don't need to flush anything.
+static bool XFDataEquals(const u32* dst, const u8* src, u32 count)
+{
+  u32 i = 0;
+#if _M_SSE >= 0x200
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(u32)));
+    data = _mm_or_si128(_mm_slli_epi16(data, 8), _mm_srli_epi16(data, 8));
+    data = _mm_shufflehi_epi16(_mm_shufflelo_epi16(data, 0xB1), 0xB1);
+    const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(data, current)) != 0xFFFF)
+      return false;
+  }
+#elif defined(_M_ARM_64)
+  for (; i + 4 <= count; i += 4)
+  {
+    const uint32x4_t data = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(src + i * sizeof(u32))));
+    if (vminvq_u32(vceqq_u32(data, vld1q_u32(dst + i))) == 0)
+      return false;
+  }
+#endif
+  for (; i < count; i++)
+  {
+    u32 value;
+    std::memcpy(&value, src + i * sizeof(u32), sizeof(u32));
+    if (dst[i] != Common::swap32(value))
+      return false;
+  }
+  return true;
+}
+
+// Returns true if the part of the transfer that falls in [address, blockEnd) changes a register.
+static bool XFRegsChanged(u32 address, u32 blockEnd, u32 dataIndex, int transferSize)
+{
+  const u32 count = std::min<u32>(blockEnd - address, transferSize);
+  return !XFDataEquals(&((u32*)&xfmem)[address], g_VideoData.GetPointer() + dataIndex * sizeof(u32),
+    count);
+}
+
 inline void XFMemWritten(u32 transferSize, u32 baseAddress)
 {
-  g_vertex_manager->Flush();
+  if (g_vertex_manager->IsXFRangeInUse(baseAddress, baseAddress + transferSize))
+    g_vertex_manager->Flush();
   VertexShaderManager::InvalidateXFRange(baseAddress, baseAddress + transferSize);
   PixelShaderManager::InvalidateXFRange(baseAddress, baseAddress + transferSize);
 }
@@ -91,7 +141,7 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
     case XFMEM_SETCHAN1_COLOR:
     case XFMEM_SETCHAN0_ALPHA: // Channel Alpha
     case XFMEM_SETCHAN1_ALPHA:
-      if (((u32*)&xfmem)[address - 0x1000] != (newValue & 0x7fff))
+      if (((u32*)&xfmem)[address] != (newValue & 0x7fff))
         g_vertex_manager->Flush();
       VertexShaderManager::SetLightingConfigChanged();
       break;
@@ -118,10 +168,13 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
     case XFMEM_SETVIEWPORT + 3:
     case XFMEM_SETVIEWPORT + 4:
     case XFMEM_SETVIEWPORT + 5:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetViewportChanged();
-      GeometryShaderManager::SetViewportChanged();
-      PixelShaderManager::SetViewportChanged();
+      if (XFRegsChanged(address, XFMEM_SETVIEWPORT + 6, dataIndex, transferSize))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetViewportChanged();
+        GeometryShaderManager::SetViewportChanged();
+        PixelShaderManager::SetViewportChanged();
+      }
       nextAddress = XFMEM_SETVIEWPORT + 6;
       break;
 
@@ -132,9 +185,12 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
     case XFMEM_SETPROJECTION + 4:
     case XFMEM_SETPROJECTION + 5:
     case XFMEM_SETPROJECTION + 6:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetProjectionChanged();
-      GeometryShaderManager::SetProjectionChanged();
+      if (XFRegsChanged(address, XFMEM_SETPROJECTION + 7, dataIndex, transferSize))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetProjectionChanged();
+        GeometryShaderManager::SetProjectionChanged();
+      }
       nextAddress = XFMEM_SETPROJECTION + 7;
       break;
 
@@ -151,8 +207,11 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
     case XFMEM_SETTEXMTXINFO + 5:
     case XFMEM_SETTEXMTXINFO + 6:
     case XFMEM_SETTEXMTXINFO + 7:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETTEXMTXINFO);
+      if (XFRegsChanged(address, XFMEM_SETTEXMTXINFO + 8, dataIndex, transferSize))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETTEXMTXINFO);
+      }
       nextAddress = XFMEM_SETTEXMTXINFO + 8;
       break;
 
@@ -164,8 +223,11 @@ inline void XFRegWritten(int transferSize, u32 baseAddress)
     case XFMEM_SETPOSMTXINFO + 5:
     case XFMEM_SETPOSMTXINFO + 6:
     case XFMEM_SETPOSMTXINFO + 7:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETPOSMTXINFO);
+      if (XFRegsChanged(address, XFMEM_SETPOSMTXINFO + 8, dataIndex, transferSize))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETPOSMTXINFO);
+      }
       nextAddress = XFMEM_SETPOSMTXINFO + 8;
       break;
 
@@ -238,15 +300,34 @@ void LoadXFReg(u32 transferSize, u32 baseAddress)
       transferSize = 0;
     }
 
-    XFMemWritten(xfMemTransferSize, xfMemBase);
-    OpcodeDecoder::DataReadU32xFuncs[xfMemTransferSize - 1](&((u32*)&xfmem)[xfMemBase]);
+    u32* dst = &((u32*)&xfmem)[xfMemBase];
+    if (XFDataEquals(dst, g_VideoData.GetPointer(), xfMemTransferSize))
+    {
+      g_VideoData.ReadSkip(xfMemTransferSize * sizeof(u32));
+    }
+    else
+    {
+      XFMemWritten(xfMemTransferSize, xfMemBase);
+      OpcodeDecoder::DataReadU32xFuncs[xfMemTransferSize - 1](dst);
+    }
   }
 
   // write to XF regs
   if (transferSize > 0)
   {
-    XFRegWritten(transferSize, baseAddress);
-    OpcodeDecoder::DataReadU32xFuncs[transferSize - 1](&((u32*)&xfmem)[baseAddress]);
+    // The matrix indices are mirrored in the CP state, which may differ from xfmem.
+    const bool writes_matrix_index =
+      baseAddress <= XFMEM_SETMATRIXINDB && baseAddress + transferSize > XFMEM_SETMATRIXINDA;
+    u32* dst = &((u32*)&xfmem)[baseAddress];
+    if (!writes_matrix_index && XFDataEquals(dst, g_VideoData.GetPointer(), transferSize))
+    {
+      g_VideoData.ReadSkip(transferSize * sizeof(u32));
+    }
+    else
+    {
+      XFRegWritten(transferSize, baseAddress);
+      OpcodeDecoder::DataReadU32xFuncs[transferSize - 1](dst);
+    }
   }
 }
 
@@ -268,16 +349,7 @@ void LoadIndexedXF(u32 val, int refarray)
   {
     newData = (u32*)Memory::GetPointer(g_main_cp_state.array_bases[refarray] + g_main_cp_state.array_strides[refarray] * index);
   }
-  bool changed = false;
-  for (int i = 0; i < size; ++i)
-  {
-    if (currData[i] != Common::swap32(newData[i]))
-    {
-      changed = true;
-      break;
-    }
-  }
-  if (changed)
+  if (!XFDataEquals(currData, reinterpret_cast<const u8*>(newData), size))
   {
     XFMemWritten(size, address);
     for (int i = 0; i < size; ++i)
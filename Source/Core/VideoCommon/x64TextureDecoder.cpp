@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <cmath>
+#include <cstring>
 
 #include "Common/Common.h"
 //#include "VideoCommon/VideoCommon.h" // to get debug logs
@@ -1771,6 +1772,369 @@ static HostTextureFormat Decode_real(u8 *dst, const u8 *src, u32 width, u32 heig
   return PC_TEX_FMT_NONE;
 }
 
+// AVX2 versions of the RGBA decoders. Every loop iteration decodes two horizontally adjacent
+// tiles, so they are only used when a texture row holds an even number of tiles. The output is
+// identical to the SSE versions in Decode_RGBA.
+
+// Swaps the big endian 16-bit values in the low half of each 32-bit lane.
+FUNCTION_TARGET_AVX2
+static inline __m256i Swap16x8AVX2(__m256i values)
+{
+  const __m256i mask = _mm256_setr_epi8(1, 0, -128, -128, 5, 4, -128, -128, 9, 8, -128, -128, 13, 12,
+                                        -128, -128, 1, 0, -128, -128, 5, 4, -128, -128, 9, 8, -128,
+                                        -128, 13, 12, -128, -128);
+  return _mm256_shuffle_epi8(values, mask);
+}
+
+// The converters take eight 16-bit values in memory order, zero extended to 32 bits.
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodeIA8x8AVX2(__m256i values)
+{
+  const __m256i mask = _mm256_setr_epi8(1, 1, 1, 0, 5, 5, 5, 4, 9, 9, 9, 8, 13, 13, 13, 12, 1, 1, 1,
+                                        0, 5, 5, 5, 4, 9, 9, 9, 8, 13, 13, 13, 12);
+  return _mm256_shuffle_epi8(values, mask);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodeRGB565x8AVX2(__m256i values)
+{
+  const __m256i v = Swap16x8AVX2(values);
+  const __m256i r = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(v, 8), _mm256_set1_epi32(0xF8)),
+                                    _mm256_and_si256(_mm256_srli_epi32(v, 13), _mm256_set1_epi32(0x07)));
+  const __m256i g = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(v, 5), _mm256_set1_epi32(0xFC00)),
+                                    _mm256_and_si256(_mm256_srli_epi32(v, 1), _mm256_set1_epi32(0x0300)));
+  const __m256i b = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(v, 19), _mm256_set1_epi32(0xF80000)),
+                                    _mm256_and_si256(_mm256_slli_epi32(v, 14), _mm256_set1_epi32(0x070000)));
+  return _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, _mm256_set1_epi32(0xFF000000)));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodeRGB5A3x8AVX2(__m256i values)
+{
+  const __m256i v = Swap16x8AVX2(values);
+
+  // RGB555, alpha = 0xFF
+  const __m256i r0 = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(v, 7), _mm256_set1_epi32(0xF8)),
+                                     _mm256_and_si256(_mm256_srli_epi32(v, 12), _mm256_set1_epi32(0x07)));
+  const __m256i g0 = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(v, 6), _mm256_set1_epi32(0xF800)),
+                                     _mm256_and_si256(_mm256_slli_epi32(v, 1), _mm256_set1_epi32(0x0700)));
+  const __m256i b0 = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(v, 19), _mm256_set1_epi32(0xF80000)),
+                                     _mm256_and_si256(_mm256_slli_epi32(v, 14), _mm256_set1_epi32(0x070000)));
+  const __m256i rgb555 = _mm256_or_si256(_mm256_or_si256(r0, g0),
+                                         _mm256_or_si256(b0, _mm256_set1_epi32(0xFF000000)));
+
+  // RGBA4443
+  const __m256i r1 = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi32(0xF0)),
+                                     _mm256_and_si256(_mm256_srli_epi32(v, 8), _mm256_set1_epi32(0x0F)));
+  const __m256i g1 = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(v, 8), _mm256_set1_epi32(0xF000)),
+                                     _mm256_and_si256(_mm256_slli_epi32(v, 4), _mm256_set1_epi32(0x0F00)));
+  const __m256i b1 = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(v, 20), _mm256_set1_epi32(0xF00000)),
+                                     _mm256_and_si256(_mm256_slli_epi32(v, 16), _mm256_set1_epi32(0x0F0000)));
+  const __m256i a1 = _mm256_or_si256(
+      _mm256_and_si256(_mm256_slli_epi32(v, 17), _mm256_set1_epi32(0xE0000000)),
+      _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(v, 14), _mm256_set1_epi32(0x1C000000)),
+                      _mm256_and_si256(_mm256_slli_epi32(v, 11), _mm256_set1_epi32(0x03000000))));
+  const __m256i rgba4443 = _mm256_or_si256(_mm256_or_si256(r1, g1), _mm256_or_si256(b1, a1));
+
+  // Bit 15 picks the encoding of each texel, no need to special case blocks with mixed texels.
+  const __m256i is_rgb555 = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 31);
+  return _mm256_blendv_epi8(rgba4443, rgb555, is_rgb555);
+}
+
+// Looks up the TLUT entries for eight indices. Entries are gathered in pairs, so nothing past the
+// end of the palette is read.
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodeTlutx8AVX2(const u16* tlut, __m256i indices, TlutFormat tlutfmt)
+{
+  const __m256i pairs = _mm256_i32gather_epi32(reinterpret_cast<const int*>(tlut),
+                                               _mm256_srli_epi32(indices, 1), 4);
+  const __m256i shift = _mm256_slli_epi32(_mm256_and_si256(indices, _mm256_set1_epi32(1)), 4);
+  const __m256i values =
+      _mm256_and_si256(_mm256_srlv_epi32(pairs, shift), _mm256_set1_epi32(0xFFFF));
+  switch (tlutfmt)
+  {
+  case GX_TL_RGB5A3:
+    return DecodeRGB5A3x8AVX2(values);
+  case GX_TL_IA8:
+    return DecodeIA8x8AVX2(values);
+  default:
+    return DecodeRGB565x8AVX2(values);
+  }
+}
+
+// Writes 16 intensity texels as RGBA.
+FUNCTION_TARGET_AVX2
+static inline void StoreI8x16AVX2(u32* dst, __m128i intensities)
+{
+  const __m256i mask0 = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4,
+                                         5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+  const __m256i mask1 = _mm256_add_epi8(mask0, _mm256_set1_epi8(8));
+  const __m256i i = _mm256_broadcastsi128_si256(intensities);
+  _mm256_storeu_si256((__m256i*)dst, _mm256_shuffle_epi8(i, mask0));
+  _mm256_storeu_si256((__m256i*)(dst + 8), _mm256_shuffle_epi8(i, mask1));
+}
+
+// Writes 8 IA texels, given as [I, A] byte pairs, as RGBA.
+FUNCTION_TARGET_AVX2
+static inline void StoreIAx8AVX2(u32* dst, __m128i pairs)
+{
+  const __m256i mask = _mm256_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7, 0, 0, 0, 1, 2,
+                                        2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7);
+  const __m256i ia =
+      _mm256_permute4x64_epi64(_mm256_castsi128_si256(pairs), _MM_SHUFFLE(1, 1, 0, 0));
+  _mm256_storeu_si256((__m256i*)dst, _mm256_shuffle_epi8(ia, mask));
+}
+
+// Splits each byte into its high and low nibble, both expanded to 8 bits.
+static inline void ExpandNibbles(__m128i bytes, __m128i* high, __m128i* low)
+{
+  const __m128i hi = _mm_and_si128(bytes, _mm_set1_epi8(static_cast<char>(0xF0)));
+  const __m128i lo = _mm_and_si128(bytes, _mm_set1_epi8(0x0F));
+  *high = _mm_or_si128(hi, _mm_srli_epi16(hi, 4));
+  *low = _mm_or_si128(lo, _mm_slli_epi16(lo, 4));
+}
+
+// Loads the rows of two adjacent tiles into the low and high half of a register.
+static inline __m128i LoadRowPair(const u8* left, const u8* right)
+{
+  return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)left),
+                            _mm_loadl_epi64((const __m128i*)right));
+}
+
+FUNCTION_TARGET_AVX2
+static bool Decode_RGBA_AVX2(u32* dst, const u8* src, u32 width, u32 height, u32 texformat,
+                             u32 tlutaddr, TlutFormat tlutfmt)
+{
+  const u32 Wsteps4 = (width + 3) / 4;
+  const u32 Wsteps8 = (width + 7) / 8;
+  const u16* tlut = (const u16*)(texMem + tlutaddr);
+
+  switch (texformat)
+  {
+  case GX_TF_C4:
+    if (Wsteps8 % 2)
+      return false;
+    for (u32 y = 0; y < height; y += 8)
+      for (u32 x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 16, yStep += 2)
+        for (u32 iy = 0; iy < 8; iy += 2)
+        {
+          const u8* tile = src + 32 * yStep + 4 * iy;
+          const __m128i indices = LoadRowPair(tile, tile + 32);
+          const __m128i high = _mm_and_si128(_mm_srli_epi16(indices, 4), _mm_set1_epi8(0x0F));
+          const __m128i low = _mm_and_si128(indices, _mm_set1_epi8(0x0F));
+          // Rows iy and iy + 1 of both tiles
+          const __m128i left = _mm_unpacklo_epi8(high, low);
+          const __m128i right = _mm_unpackhi_epi8(high, low);
+          const __m128i rows[2] = {_mm_unpacklo_epi64(left, right),
+                                   _mm_unpackhi_epi64(left, right)};
+          for (u32 i = 0; i < 2; i++)
+          {
+            u32* row = dst + (y + iy + i) * width + x;
+            _mm256_storeu_si256((__m256i*)row,
+                                DecodeTlutx8AVX2(tlut, _mm256_cvtepu8_epi32(rows[i]), tlutfmt));
+            _mm256_storeu_si256(
+                (__m256i*)(row + 8),
+                DecodeTlutx8AVX2(tlut, _mm256_cvtepu8_epi32(_mm_srli_si128(rows[i], 8)), tlutfmt));
+          }
+        }
+    return true;
+  case GX_TF_I4:
+    if (Wsteps8 % 2)
+      return false;
+    for (u32 y = 0; y < height; y += 8)
+      for (u32 x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 16, yStep += 2)
+        for (u32 iy = 0; iy < 8; iy += 2)
+        {
+          const u8* tile = src + 32 * yStep + 4 * iy;
+          __m128i high, low;
+          ExpandNibbles(LoadRowPair(tile, tile + 32), &high, &low);
+          const __m128i left = _mm_unpacklo_epi8(high, low);
+          const __m128i right = _mm_unpackhi_epi8(high, low);
+          StoreI8x16AVX2(dst + (y + iy) * width + x, _mm_unpacklo_epi64(left, right));
+          StoreI8x16AVX2(dst + (y + iy + 1) * width + x, _mm_unpackhi_epi64(left, right));
+        }
+    return true;
+  case GX_TF_I8:
+    if (Wsteps8 % 2)
+      return false;
+    for (u32 y = 0; y < height; y += 4)
+      for (u32 x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 16, yStep += 2)
+        for (u32 iy = 0; iy < 4; iy++)
+        {
+          const u8* tile = src + 32 * yStep + 8 * iy;
+          StoreI8x16AVX2(dst + (y + iy) * width + x, LoadRowPair(tile, tile + 32));
+        }
+    return true;
+  case GX_TF_C8:
+    if (Wsteps8 % 2)
+      return false;
+    for (u32 y = 0; y < height; y += 4)
+      for (u32 x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 16, yStep += 2)
+        for (u32 iy = 0; iy < 4; iy++)
+        {
+          const u8* tile = src + 32 * yStep + 8 * iy;
+          u32* row = dst + (y + iy) * width + x;
+          const __m128i indices = LoadRowPair(tile, tile + 32);
+          _mm256_storeu_si256((__m256i*)row,
+                              DecodeTlutx8AVX2(tlut, _mm256_cvtepu8_epi32(indices), tlutfmt));
+          _mm256_storeu_si256(
+              (__m256i*)(row + 8),
+              DecodeTlutx8AVX2(tlut, _mm256_cvtepu8_epi32(_mm_srli_si128(indices, 8)), tlutfmt));
+        }
+    return true;
+  case GX_TF_IA4:
+    if (Wsteps8 % 2)
+      return false;
+    for (u32 y = 0; y < height; y += 4)
+      for (u32 x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 16, yStep += 2)
+        for (u32 iy = 0; iy < 4; iy++)
+        {
+          const u8* tile = src + 32 * yStep + 8 * iy;
+          __m128i alpha, intensity;
+          ExpandNibbles(LoadRowPair(tile, tile + 32), &alpha, &intensity);
+          u32* row = dst + (y + iy) * width + x;
+          StoreIAx8AVX2(row, _mm_unpacklo_epi8(intensity, alpha));
+          StoreIAx8AVX2(row + 8, _mm_unpackhi_epi8(intensity, alpha));
+        }
+    return true;
+  case GX_TF_IA8:
+  case GX_TF_C14X2:
+  case GX_TF_RGB565:
+  case GX_TF_RGB5A3:
+    if (Wsteps4 % 2)
+      return false;
+    for (u32 y = 0; y < height; y += 4)
+      for (u32 x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 8, yStep += 2)
+        for (u32 iy = 0; iy < 4; iy++)
+        {
+          const u8* tile = src + 32 * yStep + 8 * iy;
+          const __m256i values = _mm256_cvtepu16_epi32(LoadRowPair(tile, tile + 32));
+          __m256i rgba;
+          switch (texformat)
+          {
+          case GX_TF_IA8:
+            rgba = DecodeIA8x8AVX2(values);
+            break;
+          case GX_TF_C14X2:
+            rgba = DecodeTlutx8AVX2(
+                tlut, _mm256_and_si256(Swap16x8AVX2(values), _mm256_set1_epi32(0x3FFF)), tlutfmt);
+            break;
+          case GX_TF_RGB565:
+            rgba = DecodeRGB565x8AVX2(values);
+            break;
+          default:
+            rgba = DecodeRGB5A3x8AVX2(values);
+            break;
+          }
+          _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x), rgba);
+        }
+    return true;
+  case GX_TF_RGBA8:
+    if (Wsteps4 % 2)
+      return false;
+    for (u32 y = 0; y < height; y += 4)
+      for (u32 x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 8, yStep += 2)
+      {
+        // Each tile holds the AR values of its 16 texels followed by their GB values.
+        const u8* src2 = src + 64 * yStep;
+        const __m256i mask0312 = _mm256_setr_epi8(2, 1, 3, 0, 6, 5, 7, 4, 10, 9, 11, 8, 14, 13, 15, 12,
+                                                  2, 1, 3, 0, 6, 5, 7, 4, 10, 9, 11, 8, 14, 13, 15, 12);
+        const __m256i ar0 = _mm256_loadu_si256((const __m256i*)src2);
+        const __m256i gb0 = _mm256_loadu_si256((const __m256i*)src2 + 1);
+        const __m256i ar1 = _mm256_loadu_si256((const __m256i*)src2 + 2);
+        const __m256i gb1 = _mm256_loadu_si256((const __m256i*)src2 + 3);
+
+        // Rows 0 and 2, and rows 1 and 3 of each tile
+        const __m256i rows02_0 = _mm256_shuffle_epi8(_mm256_unpacklo_epi8(ar0, gb0), mask0312);
+        const __m256i rows13_0 = _mm256_shuffle_epi8(_mm256_unpackhi_epi8(ar0, gb0), mask0312);
+        const __m256i rows02_1 = _mm256_shuffle_epi8(_mm256_unpacklo_epi8(ar1, gb1), mask0312);
+        const __m256i rows13_1 = _mm256_shuffle_epi8(_mm256_unpackhi_epi8(ar1, gb1), mask0312);
+
+        u32* row = dst + y * width + x;
+        _mm256_storeu_si256((__m256i*)row, _mm256_permute2x128_si256(rows02_0, rows02_1, 0x20));
+        _mm256_storeu_si256((__m256i*)(row + width),
+                            _mm256_permute2x128_si256(rows13_0, rows13_1, 0x20));
+        _mm256_storeu_si256((__m256i*)(row + 2 * width),
+                            _mm256_permute2x128_si256(rows02_0, rows02_1, 0x31));
+        _mm256_storeu_si256((__m256i*)(row + 3 * width),
+                            _mm256_permute2x128_si256(rows13_0, rows13_1, 0x31));
+      }
+    return true;
+  case GX_TF_CMPR:
+  {
+    // Two DXT blocks at a time, with the four colors of each one in a 128-bit lane.
+    const __m128i color_mask =
+        _mm_setr_epi8(1, 0, -128, -128, 3, 2, -128, -128, 9, 8, -128, -128, 11, 10, -128, -128);
+    const __m256i index_shift = _mm256_setr_epi32(6, 4, 2, 0, 6, 4, 2, 0);
+    const __m256i index_offset = _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4);
+    const __m256i alpha_off = _mm256_set1_epi64x(0x0000FFFFFFFFFFFFLL);
+    for (u32 y = 0; y < height; y += 8)
+    {
+      for (u32 x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+      {
+        for (u32 z = 0, xStep = 2 * yStep; z < 2; ++z, xStep++)
+        {
+          const u8* blocks = src + sizeof(struct DXT1Block) * 2 * xStep;
+          const __m128i dxt = _mm_loadu_si128((const __m128i*)blocks);
+
+          // (c0 c1 of the left block, c0 c1 of the right block) as RGBA
+          const __m128i c565 = _mm_shuffle_epi8(dxt, color_mask);
+          const __m128i endpoints = _mm256_castsi256_si128(
+              DecodeRGB565x8AVX2(_mm256_castsi128_si256(_mm_shuffle_epi8(dxt, _mm_setr_epi8(
+                  0, 1, -128, -128, 2, 3, -128, -128, 8, 9, -128, -128, 10, 11, -128, -128)))));
+
+          // 16 bits per channel, one block per lane
+          const __m256i channels = _mm256_cvtepu8_epi16(endpoints);
+          const __m256i c0 = _mm256_shuffle_epi32(channels, _MM_SHUFFLE(1, 0, 1, 0));
+          const __m256i c1 = _mm256_shuffle_epi32(channels, _MM_SHUFFLE(3, 2, 3, 2));
+
+          // c2 = c0 + 3/8 (c1 - c0), c3 = c1 - 3/8 (c1 - c0)
+          const __m256i diff = _mm256_sub_epi16(c1, c0);
+          const __m256i delta = _mm256_sub_epi16(_mm256_srai_epi16(diff, 1), _mm256_srai_epi16(diff, 3));
+          // c2 = avg(c0, c1), c3 = transparent c1
+          const __m256i average = _mm256_avg_epu16(c0, c1);
+          const __m256i transparent = _mm256_and_si256(c1, alpha_off);
+
+          // Compare the 16-bit colors of each block, c0 > c1 selects the interpolated colors.
+          const __m128i greater = _mm_cmpgt_epi32(c565, _mm_srli_epi64(c565, 32));
+          const __m256i interpolate = _mm256_permute4x64_epi64(
+              _mm256_castsi128_si256(_mm_shuffle_epi32(greater, _MM_SHUFFLE(2, 2, 0, 0))),
+              _MM_SHUFFLE(1, 1, 0, 0));
+          const __m256i c2 = _mm256_blendv_epi8(average, _mm256_add_epi16(c0, delta), interpolate);
+          const __m256i c3 = _mm256_blendv_epi8(transparent, _mm256_sub_epi16(c1, delta), interpolate);
+
+          // (c0, c1, c2, c3) for each block
+          const __m256i c23 = _mm256_shuffle_epi32(_mm256_packus_epi16(c2, c3), _MM_SHUFFLE(2, 0, 0, 0));
+          const __m256i c01 = _mm256_permute4x64_epi64(_mm256_castsi128_si256(endpoints),
+                                                       _MM_SHUFFLE(1, 1, 0, 0));
+          const __m256i palette = _mm256_blend_epi32(c01, c23, 0xCC);
+
+          // The index rows of the left block in the low lanes, the ones of the right block in the
+          // high lanes.
+          u32 left, right;
+          std::memcpy(&left, blocks + 4, sizeof(u32));
+          std::memcpy(&right, blocks + 12, sizeof(u32));
+          const __m256i lines = _mm256_setr_epi32(left, left, left, left, right, right, right, right);
+
+          u32* dst32 = dst + (y + z * 4) * width + x;
+          for (u32 iy = 0; iy < 4; iy++)
+          {
+            const __m256i shift = _mm256_add_epi32(index_shift, _mm256_set1_epi32(8 * iy));
+            const __m256i index = _mm256_add_epi32(
+                _mm256_and_si256(_mm256_srlv_epi32(lines, shift), _mm256_set1_epi32(3)),
+                index_offset);
+            _mm256_storeu_si256((__m256i*)(dst32 + iy * width),
+                                _mm256_permutevar8x32_epi32(palette, index));
+          }
+        }
+      }
+    }
+    return true;
+  }
+  }
+  return false;
+}
+
 // JSD 01/06/11:
 // TODO: we really should ensure BOTH the source and destination addresses are aligned to 16-byte boundaries to
 // squeeze out a little more performance. _mm_loadu_si128/_mm_storeu_si128 is slower than _mm_load_si128/_mm_store_si128
@@ -1781,6 +2145,9 @@ static HostTextureFormat Decode_real(u8 *dst, const u8 *src, u32 width, u32 heig
 
 static HostTextureFormat Decode_RGBA(u32 * dst, const u8 * src, u32 width, u32 height, u32 texformat, u32 tlutaddr, TlutFormat tlutfmt)
 {
+  if (cpu_info.bAVX2 && Decode_RGBA_AVX2(dst, src, width, height, texformat, tlutaddr, tlutfmt))
+    return PC_TEX_FMT_RGBA32;
+
   const u32 Wsteps4 = (width + 3) / 4;
   const u32 Wsteps8 = (width + 7) / 8;
 
@@ -2151,7 +2518,7 @@ static HostTextureFormat Decode_RGBA(u32 * dst, const u8 * src, u32 width, u32 h
       for (u32 y = 0; y < height; y += 4)
         for (u32 x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
           for (u32 iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
-            decodebytesC14X2_5A3_To_BGRA32(dst + (y + iy) * width + x, (u16*)(src + 8 * xStep), tlutaddr);
+            decodebytesC14X2_5A3_To_RGBA(dst + (y + iy) * width + x, (u16*)(src + 8 * xStep), tlutaddr);
     }
     else if (tlutfmt == GX_TL_IA8)
     {
@@ -78,3 +78,30 @@ TEST(BlockingLoop, MultiThreaded)
     loop_thread.join();
   }
 }
+
+TEST(BlockingLoop, WakeupCounts)
+{
+  Common::BlockingLoop loop;
+  std::atomic<int> runs(0);
+  std::thread loop_thread([&]() { loop.Run([&]() { runs++; }); });
+
+  loop.Prepare();
+  loop.Wait();
+  loop.AllowSleep();
+  while (!loop.IsSleeping())
+    std::this_thread::yield();
+  EXPECT_EQ(0, loop.TakeWakeupCount());
+
+  // Only waking the sleeping worker is counted.
+  const int old_runs = runs.load();
+  loop.Wakeup();
+  loop.Wakeup();
+  loop.Wait();
+  EXPECT_LT(old_runs, runs.load());
+  EXPECT_EQ(1, loop.TakeWakeupCount());
+  EXPECT_EQ(0, loop.TakeWakeupCount());
+  EXPECT_LE(1, loop.TakeSleepCount());
+
+  loop.Stop();
+  loop_thread.join();
+}
@@ -0,0 +1,49 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <gtest/gtest.h>
+
+#include "Common/Hash.h"
+
+namespace
+{
+constexpr size_t BUFFER_SIZE = 4096;
+
+std::array<u8, BUFFER_SIZE> GetTestData()
+{
+  std::array<u8, BUFFER_SIZE> data;
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<u8>(i * 31 + 7);
+  return data;
+}
+}  // Anonymous namespace
+
+// Texture hashes end up in on-disk caches, so the values must not depend on the SIMD
+// implementation SetHash64Function() picked for this CPU.
+TEST(Hash, StripeHash64)
+{
+  const auto data = GetTestData();
+  SetHash64Function();
+
+  EXPECT_EQ(0xAF01815466E7E248ULL, GetHash64(data.data(), 0, 0));
+  EXPECT_EQ(0x3678901ADC9924D5ULL, GetHash64(data.data(), 13, 0));
+  EXPECT_EQ(0x559252A05C219BF3ULL, GetHash64(data.data(), 64, 0));
+  EXPECT_EQ(0x7D0F4E0AD464B0B5ULL, GetHash64(data.data(), 100, 0));
+  EXPECT_EQ(0xF60C441EE05E5569ULL, GetHash64(data.data(), 1024, 0));
+  EXPECT_EQ(0xC10F5F712852C260ULL, GetHash64(data.data(), 4096, 0));
+  EXPECT_EQ(0x05C967C7D1AD05BEULL, GetHash64(data.data(), 4096, 64));
+}
+
+TEST(Hash, StripeHash64DetectsChanges)
+{
+  auto data = GetTestData();
+  SetHash64Function();
+
+  const u64 hash = GetHash64(data.data(), BUFFER_SIZE, 0);
+  data[BUFFER_SIZE - 1] ^= 1;
+  EXPECT_NE(hash, GetHash64(data.data(), BUFFER_SIZE, 0));
+  data[BUFFER_SIZE - 1] ^= 1;
+  EXPECT_EQ(hash, GetHash64(data.data(), BUFFER_SIZE, 0));
+}
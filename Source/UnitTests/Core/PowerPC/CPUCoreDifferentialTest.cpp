@@ -0,0 +1,485 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Runs small PowerPC snippets on every CPU core available on the host and checks that the
+// JITs end up in the same state as the interpreter. The time each core took is printed too,
+// which makes this a quick way to see what a JIT change does to throughput.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MemTools.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+// Code and data live in low MEM1 and run with address translation off.
+constexpr u32 CODE_ADDRESS = 0x00003000;
+constexpr u32 SCRATCH_ADDRESS = 0x00008000;
+constexpr size_t SCRATCH_WORDS = 16;
+
+constexpr u32 ITERATIONS = 20000;
+constexpr u64 MAX_STEPS = 100000000;
+
+class ScopeInit final
+{
+public:
+  explicit ScopeInit(int cpu_core) : m_profile_path(File::CreateTempDir())
+  {
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    EMM::InstallExceptionHandler();
+    Memory::Init();
+    PowerPC::Init(cpu_core);
+    CoreTiming::Init();
+  }
+  ~ScopeInit()
+  {
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    Memory::Shutdown();
+    EMM::UninstallExceptionHandler();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+private:
+  std::string m_profile_path;
+};
+
+// Just enough of an assembler to write the snippets below.
+u32 DForm(u32 op, u32 d, u32 a, s32 imm)
+{
+  return (op << 26) | (d << 21) | (a << 16) | (static_cast<u32>(imm) & 0xFFFF);
+}
+
+u32 XForm(u32 op, u32 d, u32 a, u32 b, u32 xo, bool rc = false)
+{
+  return (op << 26) | (d << 21) | (a << 16) | (b << 11) | (xo << 1) | rc;
+}
+
+u32 AForm(u32 op, u32 d, u32 a, u32 b, u32 c, u32 xo)
+{
+  return (op << 26) | (d << 21) | (a << 16) | (b << 11) | (c << 6) | (xo << 1);
+}
+
+u32 Addi(u32 d, u32 a, s32 imm)
+{
+  return DForm(14, d, a, imm);
+}
+u32 Cmpwi(u32 crf, u32 a, s32 imm)
+{
+  return DForm(11, crf << 2, a, imm);
+}
+u32 Lwz(u32 d, u32 a, s32 offset)
+{
+  return DForm(32, d, a, offset);
+}
+u32 Stw(u32 s, u32 a, s32 offset)
+{
+  return DForm(36, s, a, offset);
+}
+u32 Lfs(u32 d, u32 a, s32 offset)
+{
+  return DForm(48, d, a, offset);
+}
+u32 Lfd(u32 d, u32 a, s32 offset)
+{
+  return DForm(50, d, a, offset);
+}
+u32 Stfs(u32 s, u32 a, s32 offset)
+{
+  return DForm(52, s, a, offset);
+}
+u32 Stfd(u32 s, u32 a, s32 offset)
+{
+  return DForm(54, s, a, offset);
+}
+
+u32 Add(u32 d, u32 a, u32 b)
+{
+  return XForm(31, d, a, b, 266);
+}
+u32 Subf(u32 d, u32 a, u32 b)
+{
+  return XForm(31, d, a, b, 40);
+}
+u32 Mullw(u32 d, u32 a, u32 b)
+{
+  return XForm(31, d, a, b, 235);
+}
+u32 Divw(u32 d, u32 a, u32 b)
+{
+  return XForm(31, d, a, b, 491);
+}
+// Logical ops encode the destination in the A field.
+u32 AndDot(u32 a, u32 s, u32 b)
+{
+  return XForm(31, s, a, b, 28, true);
+}
+u32 Or(u32 a, u32 s, u32 b)
+{
+  return XForm(31, s, a, b, 444);
+}
+u32 Xor(u32 a, u32 s, u32 b)
+{
+  return XForm(31, s, a, b, 316);
+}
+u32 Cmpw(u32 crf, u32 a, u32 b)
+{
+  return XForm(31, crf << 2, a, b, 0);
+}
+u32 Rlwinm(u32 a, u32 s, u32 sh, u32 mb, u32 me)
+{
+  return (21 << 26) | (s << 21) | (a << 16) | (sh << 11) | (mb << 6) | (me << 1);
+}
+
+u32 Fadd(u32 d, u32 a, u32 b)
+{
+  return AForm(63, d, a, b, 0, 21);
+}
+u32 Fmul(u32 d, u32 a, u32 c)
+{
+  return AForm(63, d, a, 0, c, 25);
+}
+u32 Fmadd(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(63, d, a, b, c, 29);
+}
+u32 Fmadds(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(59, d, a, b, c, 29);
+}
+
+u32 PsAdd(u32 d, u32 a, u32 b)
+{
+  return AForm(4, d, a, b, 0, 21);
+}
+u32 PsMul(u32 d, u32 a, u32 c)
+{
+  return AForm(4, d, a, 0, c, 25);
+}
+u32 PsMadd(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(4, d, a, b, c, 29);
+}
+u32 PsSum0(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(4, d, a, b, c, 10);
+}
+u32 PsMerge00(u32 d, u32 a, u32 b)
+{
+  return XForm(4, d, a, b, 528);
+}
+u32 PsqL(u32 d, u32 a, s32 offset, bool w, u32 gqr)
+{
+  return (56 << 26) | (d << 21) | (a << 16) | (w << 15) | (gqr << 12) | (offset & 0xFFF);
+}
+u32 PsqSt(u32 s, u32 a, s32 offset, bool w, u32 gqr)
+{
+  return (60 << 26) | (s << 21) | (a << 16) | (w << 15) | (gqr << 12) | (offset & 0xFFF);
+}
+
+// Branch offsets are counted in instructions from the branch itself.
+u32 B(s32 offset, bool link = false)
+{
+  return (18 << 26) | (static_cast<u32>(offset * 4) & 0x3FFFFFC) | link;
+}
+u32 Bc(u32 bo, u32 bi, s32 offset)
+{
+  return (16 << 26) | (bo << 21) | (bi << 16) | (static_cast<u32>(offset * 4) & 0xFFFC);
+}
+u32 Bdnz(s32 offset)
+{
+  return Bc(16, 0, offset);
+}
+u32 Bne(u32 crf, s32 offset)
+{
+  return Bc(4, crf * 4 + 2, offset);
+}
+u32 Blr()
+{
+  return 0x4E800020;
+}
+
+struct Snippet
+{
+  std::vector<u32> code;
+  // Index of the `b .` the snippet finishes on.
+  size_t end;
+  void (*setup)();
+};
+
+struct CPUState
+{
+  std::array<u32, 32> gpr;
+  std::array<std::array<u64, 2>, 32> ps;
+  u32 cr;
+  u32 xer;
+  u32 fpscr;
+  u32 ctr;
+  u32 lr;
+  std::array<u32, SCRATCH_WORDS> scratch;
+};
+
+struct RunResult
+{
+  CPUState state;
+  u64 steps;
+  double seconds;
+};
+
+u32 FloatBits(float value)
+{
+  u32 bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+u64 DoubleBits(double value)
+{
+  u64 bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+RunResult Run(int cpu_core, const Snippet& snippet)
+{
+  ScopeInit guard(cpu_core);
+
+  for (size_t i = 0; i < snippet.code.size(); ++i)
+    Memory::Write_U32(snippet.code[i], CODE_ADDRESS + static_cast<u32>(i * 4));
+  for (size_t i = 0; i < SCRATCH_WORDS; ++i)
+    Memory::Write_U32(0, SCRATCH_ADDRESS + static_cast<u32>(i * 4));
+
+  // Floating point enabled, translation off.
+  MSR = 1 << (31 - 18);
+  GPR(3) = SCRATCH_ADDRESS;
+  CTR = ITERATIONS;
+  snippet.setup();
+  PC = CODE_ADDRESS;
+
+  const u32 end_address = CODE_ADDRESS + static_cast<u32>(snippet.end * 4);
+  RunResult result{};
+  const auto start = std::chrono::steady_clock::now();
+  while (PC != end_address && result.steps < MAX_STEPS)
+  {
+    PowerPC::SingleStep();
+    ++result.steps;
+  }
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(end_address, PC) << "snippet did not finish";
+
+  CPUState& state = result.state;
+  std::memcpy(state.gpr.data(), PowerPC::ppcState.gpr, sizeof(PowerPC::ppcState.gpr));
+  std::memcpy(state.ps.data(), PowerPC::ppcState.ps, sizeof(PowerPC::ppcState.ps));
+  state.cr = PowerPC::GetCR();
+  state.xer = PowerPC::GetXER().Hex;
+  state.fpscr = PowerPC::ppcState.fpscr;
+  // The JITs only maintain FPRF when asked to.
+  if (!SConfig::GetInstance().bFPRF)
+    state.fpscr &= ~FPRF_MASK;
+  state.ctr = CTR;
+  state.lr = LR;
+  for (size_t i = 0; i < SCRATCH_WORDS; ++i)
+    state.scratch[i] = Memory::Read_U32(SCRATCH_ADDRESS + static_cast<u32>(i * 4));
+  return result;
+}
+
+void ExpectSameState(const CPUState& expected, const CPUState& actual)
+{
+  for (size_t i = 0; i < expected.gpr.size(); ++i)
+    EXPECT_EQ(expected.gpr[i], actual.gpr[i]) << "r" << i;
+  for (size_t i = 0; i < expected.ps.size(); ++i)
+  {
+    EXPECT_EQ(expected.ps[i][0], actual.ps[i][0]) << "f" << i << " ps0";
+    EXPECT_EQ(expected.ps[i][1], actual.ps[i][1]) << "f" << i << " ps1";
+  }
+  EXPECT_EQ(expected.cr, actual.cr) << "cr";
+  EXPECT_EQ(expected.xer, actual.xer) << "xer";
+  EXPECT_EQ(expected.fpscr, actual.fpscr) << "fpscr";
+  EXPECT_EQ(expected.ctr, actual.ctr) << "ctr";
+  EXPECT_EQ(expected.lr, actual.lr) << "lr";
+  for (size_t i = 0; i < expected.scratch.size(); ++i)
+    EXPECT_EQ(expected.scratch[i], actual.scratch[i]) << "scratch word " << i;
+}
+
+void PrintTiming(const char* core_name, const RunResult& result, u64 instructions)
+{
+  std::printf("[  TIMING  ] %-18s %10.3f ms %8.2f ns/instruction\n", core_name,
+              result.seconds * 1000.0, result.seconds * 1e9 / instructions);
+}
+
+// The interpreter executes exactly one instruction per step, so it is both the reference
+// state and the instruction count the other cores' timings are divided by.
+void CompareCores(const Snippet& snippet)
+{
+  const RunResult reference = Run(PowerPC::CORE_INTERPRETER, snippet);
+  PrintTiming("Interpreter", reference, reference.steps);
+
+  struct CoreInfo
+  {
+    PowerPC::CPUCore core;
+    const char* name;
+  };
+  static constexpr CoreInfo cores[] = {
+      {PowerPC::CORE_CACHEDINTERPRETER, "CachedInterpreter"},
+#ifdef _M_X86_64
+      {PowerPC::CORE_JIT64, "JIT64"},
+#endif
+#ifdef _M_ARM_64
+      {PowerPC::CORE_JITARM64, "JITARM64"},
+#endif
+  };
+
+  for (const CoreInfo& core : cores)
+  {
+    SCOPED_TRACE(core.name);
+    const RunResult result = Run(core.core, snippet);
+    ExpectSameState(reference.state, result.state);
+    PrintTiming(core.name, result, reference.steps);
+  }
+}
+}  // namespace
+
+TEST(CPUCoreDifferential, Integer)
+{
+  Snippet snippet;
+  snippet.code = {
+      Add(5, 5, 4),  // loop:
+      Mullw(6, 5, 4),
+      Xor(7, 6, 5),
+      Rlwinm(7, 7, 3, 0, 28),
+      Subf(8, 7, 6),
+      Divw(9, 8, 4),
+      Cmpw(1, 9, 5),
+      Stw(9, 3, 0),
+      Lwz(10, 3, 0),
+      Or(11, 10, 8),
+      AndDot(12, 11, 5),
+      Stw(12, 3, 4),
+      Bdnz(-12),
+      B(0),  // end: b .
+  };
+  snippet.end = 13;
+  snippet.setup = [] {
+    GPR(4) = 7;
+    GPR(5) = 0x12345678;
+  };
+  CompareCores(snippet);
+}
+
+TEST(CPUCoreDifferential, Branches)
+{
+  Snippet snippet;
+  snippet.code = {
+      B(8, true),  // loop: bl func
+      Addi(4, 4, 1),
+      Cmpwi(0, 4, 3),
+      Bne(0, 3),      // bne skip
+      Addi(4, 0, 0),  // li r4, 0
+      Addi(6, 6, 1),
+      Bdnz(-6),      // skip: bdnz loop
+      B(0),          // end: b .
+      Add(5, 5, 4),  // func:
+      Blr(),
+  };
+  snippet.end = 7;
+  snippet.setup = [] {};
+  CompareCores(snippet);
+}
+
+TEST(CPUCoreDifferential, FloatingPoint)
+{
+  Snippet snippet;
+  snippet.code = {
+      Lfd(1, 3, 0),  // loop:
+      Lfd(2, 3, 8),
+      Lfs(3, 3, 16),
+      Fadd(4, 1, 2),
+      Fmul(5, 4, 2),
+      Fmadd(6, 5, 1, 2),
+      Fmadds(7, 3, 3, 1),
+      Stfd(6, 3, 24),
+      Stfs(7, 3, 32),
+      Bdnz(-9),
+      B(0),  // end: b .
+  };
+  snippet.end = 10;
+  snippet.setup = [] {
+    // Values and results are exact so that rounding can't differ between cores.
+    Memory::Write_U64(DoubleBits(1.5), SCRATCH_ADDRESS);
+    Memory::Write_U64(DoubleBits(2.25), SCRATCH_ADDRESS + 8);
+    Memory::Write_U32(FloatBits(-0.75f), SCRATCH_ADDRESS + 16);
+  };
+  CompareCores(snippet);
+}
+
+TEST(CPUCoreDifferential, PairedSingles)
+{
+  Snippet snippet;
+  snippet.code = {
+      PsqL(1, 3, 0, false, 0),  // loop:
+      PsqL(2, 3, 8, false, 0),
+      PsAdd(3, 1, 2),
+      PsMul(4, 3, 2),
+      PsMadd(5, 4, 1, 2),
+      PsMerge00(6, 5, 3),
+      PsSum0(7, 6, 4, 5),
+      PsqSt(7, 3, 16, false, 0),
+      Bdnz(-8),
+      B(0),  // end: b .
+  };
+  snippet.end = 9;
+  snippet.setup = [] {
+    Memory::Write_U32(FloatBits(1.5f), SCRATCH_ADDRESS);
+    Memory::Write_U32(FloatBits(-2.0f), SCRATCH_ADDRESS + 4);
+    Memory::Write_U32(FloatBits(0.25f), SCRATCH_ADDRESS + 8);
+    Memory::Write_U32(FloatBits(3.0f), SCRATCH_ADDRESS + 12);
+  };
+  CompareCores(snippet);
+}
+
+TEST(CPUCoreDifferential, QuantizedLoadStore)
+{
+  Snippet snippet;
+  snippet.code = {
+      PsqL(1, 3, 0, false, 1),  // loop: s16 pair, scale 8
+      PsqL(2, 3, 4, true, 2),   //       single u8
+      PsAdd(3, 1, 2),
+      PsqSt(3, 3, 8, false, 3),   //       s8 pair, scale 2
+      PsqSt(3, 3, 12, false, 1),  //       s16 pair, scale 8
+      Bdnz(-5),
+      B(0),  // end: b .
+  };
+  snippet.end = 6;
+  snippet.setup = [] {
+    // GQR layout: store type/scale in the low half, load type/scale in the high half.
+    GQR(1) = (8 << 24) | (7 << 16) | (8 << 8) | 7;
+    GQR(2) = (0 << 24) | (4 << 16);
+    GQR(3) = (2 << 8) | 6;
+    // 256 and -512 load as 1.0 and -2.0, 3 as 3.0; every result stays exactly representable.
+    Memory::Write_U32(0x0100FE00, SCRATCH_ADDRESS);
+    Memory::Write_U32(0x03000000, SCRATCH_ADDRESS + 4);
+  };
+  CompareCores(snippet);
+}
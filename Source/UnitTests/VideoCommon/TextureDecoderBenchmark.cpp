@@ -0,0 +1,215 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+#include "Common/MemoryUtil.h"
+#include "VideoCommon/TextureDecoder.h"
+
+// Throughput of the texture decoders and the texture hashes, for every SIMD level the decoders
+// pick from at runtime. Lower levels are measured by hiding features in cpu_info. The benchmarks
+// are disabled by default, run them with
+//   TextureDecoderBenchmark --gtest_also_run_disabled_tests
+namespace
+{
+struct FeatureLevel
+{
+  const char* name;
+  bool ssse3;
+  // SSE4.1 and SSE4.2
+  bool sse4;
+  bool avx2;
+};
+
+#if defined(_M_X86)
+constexpr FeatureLevel FEATURE_LEVELS[] = {
+    {"SSE2", false, false, false},
+    {"SSSE3", true, false, false},
+    {"SSE4", true, true, false},
+    {"AVX2", true, true, true},
+};
+#else
+constexpr FeatureLevel FEATURE_LEVELS[] = {
+    {"Native", true, true, true},
+};
+#endif
+
+struct TextureFormatInfo
+{
+  const char* name;
+  u32 format;
+};
+
+constexpr TextureFormatInfo TEXTURE_FORMATS[] = {
+    {"I4", GX_TF_I4},         {"I8", GX_TF_I8},         {"IA4", GX_TF_IA4},
+    {"IA8", GX_TF_IA8},       {"RGB565", GX_TF_RGB565}, {"RGB5A3", GX_TF_RGB5A3},
+    {"RGBA8", GX_TF_RGBA8},   {"C4", GX_TF_C4},         {"C8", GX_TF_C8},
+    {"C14X2", GX_TF_C14X2},   {"CMPR", GX_TF_CMPR},
+};
+
+constexpr u32 TEXTURE_SIZES[] = {64, 256, 1024};
+constexpr auto MIN_BENCHMARK_TIME = std::chrono::milliseconds(100);
+
+using AlignedBuffer = std::vector<u8, Common::aligned_allocator<u8, 32>>;
+
+// Runs work until enough time has passed, returns GB/s of bytes per call.
+template <typename Work>
+double Measure(size_t bytes, Work work)
+{
+  u64 calls = 0;
+  const auto start = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::steady_clock::duration::zero();
+  while (elapsed < MIN_BENCHMARK_TIME)
+  {
+    work();
+    calls++;
+    elapsed = std::chrono::steady_clock::now() - start;
+  }
+  return calls * bytes / std::chrono::duration<double, std::nano>(elapsed).count();
+}
+
+class TextureDecoderBenchmark : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_native_cpu_info = cpu_info;
+
+    std::mt19937 rng;
+    m_source.resize(1024 * 1024 * 4);
+    for (u8& byte : m_source)
+      byte = static_cast<u8>(rng());
+    for (u8& byte : texMem)
+      byte = static_cast<u8>(rng());
+    m_destination.resize(1024 * 1024 * 4);
+  }
+
+  void TearDown() override
+  {
+    cpu_info = m_native_cpu_info;
+    SetHash64Function();
+  }
+
+  // Returns false if the CPU doesn't have the level.
+  bool SetFeatureLevel(const FeatureLevel& level)
+  {
+    if ((level.ssse3 && !m_native_cpu_info.bSSSE3) ||
+        (level.sse4 && !(m_native_cpu_info.bSSE4_1 && m_native_cpu_info.bSSE4_2)) ||
+        (level.avx2 && !m_native_cpu_info.bAVX2))
+    {
+      return false;
+    }
+    cpu_info = m_native_cpu_info;
+#if defined(_M_X86)
+    cpu_info.bSSSE3 = level.ssse3;
+    cpu_info.bSSE4_1 = level.sse4;
+    cpu_info.bSSE4_2 = level.sse4;
+    cpu_info.bAVX = level.avx2;
+    cpu_info.bAVX2 = level.avx2;
+#endif
+    SetHash64Function();
+    return true;
+  }
+
+  void PrintHeader(const char* first_column)
+  {
+    std::printf("%-18s", first_column);
+    for (const FeatureLevel& level : FEATURE_LEVELS)
+      std::printf(" %8s", level.name);
+    std::printf("   (GB/s)\n");
+  }
+
+  CPUInfo m_native_cpu_info;
+  AlignedBuffer m_source;
+  AlignedBuffer m_destination;
+};
+}  // Anonymous namespace
+
+// GB/s are of decoded 32-bit texels, so formats with different source sizes compare directly.
+TEST_F(TextureDecoderBenchmark, DISABLED_Decode)
+{
+  for (bool rgba_only : {false, true})
+  {
+    PrintHeader(rgba_only ? "Decode to RGBA" : "Decode");
+    for (const TextureFormatInfo& format : TEXTURE_FORMATS)
+    {
+      for (u32 size : TEXTURE_SIZES)
+      {
+        std::printf("%-7s %4ux%-4u  ", format.name, size, size);
+        for (const FeatureLevel& level : FEATURE_LEVELS)
+        {
+          if (!SetFeatureLevel(level))
+          {
+            std::printf(" %8s", "-");
+            continue;
+          }
+          const double gbps = Measure(size * size * 4, [&] {
+            TexDecoder::Decode(m_destination.data(), m_source.data(), size, size, format.format,
+                               0, GX_TL_RGB5A3, rgba_only);
+          });
+          std::printf(" %8.2f", gbps);
+        }
+        std::printf("\n");
+      }
+    }
+  }
+}
+
+TEST_F(TextureDecoderBenchmark, DISABLED_Hash)
+{
+  struct HashFunction
+  {
+    const char* name;
+    u64 (*hash)(const u8* src, u32 len);
+    bool needs_sse4_2;
+  };
+  static const HashFunction HASH_FUNCTIONS[] = {
+      {"Fletcher", [](const u8* src, u32 len) -> u64 { return HashFletcher(src, len); }, false},
+      {"Adler32", [](const u8* src, u32 len) -> u64 { return HashAdler32(src, len); }, false},
+      {"Ector", [](const u8* src, u32 len) -> u64 { return HashEctor(src, len); }, false},
+      {"CRC32", [](const u8* src, u32 len) -> u64 { return GetCRC32(src, len, 0); }, true},
+      {"HiresTexture",
+       [](const u8* src, u32 len) -> u64 { return GetHashHiresTexture(src, len, 0); }, false},
+      {"Murmur3", [](const u8* src, u32 len) -> u64 { return GetMurmurHash3(src, len, 0); },
+       false},
+      {"Stripe64", [](const u8* src, u32 len) -> u64 { return GetStripeHash64(src, len, 0); },
+       false},
+  };
+
+  PrintHeader("Hash");
+  for (const HashFunction& function : HASH_FUNCTIONS)
+  {
+    for (u32 size : TEXTURE_SIZES)
+    {
+      const u32 length = size * size * 4;
+      std::printf("%-12s %5u KB", function.name, length / 1024);
+      for (const FeatureLevel& level : FEATURE_LEVELS)
+      {
+#if defined(_M_X86)
+        const bool supported = !function.needs_sse4_2 || level.sse4;
+#else
+        const bool supported = true;
+#endif
+        if (!supported || !SetFeatureLevel(level))
+        {
+          std::printf(" %8s", "-");
+          continue;
+        }
+        volatile u64 result = 0;
+        const double gbps =
+            Measure(length, [&] { result = result + function.hash(m_source.data(), length); });
+        std::printf(" %8.2f", gbps);
+      }
+      std::printf("\n");
+    }
+  }
+}
@@ -0,0 +1,237 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/VertexLoader.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexLoaderCompiled.h"
+#include "VideoCommon/VideoConfig.h"
+#ifdef _M_X86_64
+#include "VideoCommon/VertexLoaderX64.h"
+#elif defined(_M_ARM_64)
+#include "VideoCommon/VertexLoaderARM64.h"
+#endif
+
+// After the emitter headers, which have a TEST instruction.
+#include <gtest/gtest.h>  // NOLINT
+
+// Compares the vertex loaders on the formats games actually use: the three most used formats of
+// every game that has precompiled loaders. The speed test is disabled by default, run it with
+//   VertexLoaderBenchmark --gtest_also_run_disabled_tests
+namespace
+{
+// The four words of a VertexLoaderUID, which is also what the precompiled loaders are built from.
+struct Format
+{
+  const char* game;
+  u32 vtx_desc;
+  u32 vat0;
+  u32 vat1;
+  u32 vat2;
+};
+
+// clang-format off
+constexpr Format FORMATS[] = {
+    {"G4BP08", 0x00010500u, 0x41200409u, 0x80000000u, 0x00000000u},
+    {"G4BP08", 0x00010500u, 0x40600403u, 0x00000000u, 0x00000000u},
+    {"G4BP08", 0x00010500u, 0x41200409u, 0x00000000u, 0x00000000u},
+    {"GB4P51", 0x00030f00u, 0x40e00407u, 0x00000000u, 0x00000000u},
+    {"GFZE01", 0x00050500u, 0x41201009u, 0x00000009u, 0x00000000u},
+    {"GFZE01", 0x00150500u, 0x41201009u, 0x00001209u, 0x00000000u},
+    {"GFZE01", 0x00010500u, 0x40e00c07u, 0x00000000u, 0x00000000u},
+    {"GLMP01", 0x00030f00u, 0x41201007u, 0x00000000u, 0x00000000u},
+    {"GLMP01", 0x00002300u, 0x40016009u, 0x80000000u, 0x00000000u},
+    {"GLMP01", 0x00030f03u, 0x41201009u, 0x80000009u, 0x00000000u},
+    {"GM8E01", 0x000f0f00u, 0x40a00c09u, 0x00000009u, 0x00000000u},
+    {"GM8E01", 0x00001100u, 0x4000e007u, 0x00000000u, 0x00000000u},
+    {"GM8E01", 0x003f0f00u, 0x41201009u, 0x00001209u, 0x00000000u},
+    {"GNUEDA", 0x00030f00u, 0x41201009u, 0x80000000u, 0x00000000u},
+    {"GNUEDA", 0x000f3300u, 0x41216009u, 0x00000009u, 0x00000000u},
+    {"GNUEDA", 0x000a0300u, 0x41200009u, 0x00000009u, 0x00000000u},
+    {"GSAE01", 0x00032300u, 0x40e0e007u, 0x00000000u, 0x00000000u},
+    {"GSAE01", 0x00030f81u, 0x40e00407u, 0x80000000u, 0x00000000u},
+    {"GSAE01", 0x00030f03u, 0x40e00407u, 0x80000007u, 0x00000000u},
+    {"GZ2P01", 0x00030f02u, 0x40e00c09u, 0x80000009u, 0x00000000u},
+    {"GZ2P01", 0x00030f00u, 0x40e00c09u, 0x80000000u, 0x00000000u},
+    {"GZ2P01", 0x00010300u, 0x41200008u, 0x00000000u, 0x00000000u},
+    {"R5WEA4", 0x00030f00u, 0x41201009u, 0x00000000u, 0x00000000u},
+    {"R5WEA4", 0x00033f00u, 0x41217009u, 0x00000000u, 0x00000000u},
+    {"R5WEA4", 0x00032f00u, 0x41217009u, 0x00000000u, 0x00000000u},
+    {"RBUP08", 0x00030f00u, 0x40a00c07u, 0x80000000u, 0x00000000u},
+    {"RBUP08", 0x00020a00u, 0x40a00c07u, 0x80000000u, 0x00000000u},
+    {"RBUP08", 0x00aa0a00u, 0x40a01009u, 0x00140a05u, 0x00000000u},
+    {"RMCP01", 0x00032300u, 0x40e16009u, 0x00000000u, 0x00000000u},
+    {"RMCP01", 0x00022300u, 0x40e16009u, 0x00000000u, 0x00000000u},
+    {"RMCP01", 0x00032f00u, 0x40e16c09u, 0x00000000u, 0x00000000u},
+    {"RMGP01", 0x00033f00u, 0x40e16c07u, 0x00000000u, 0x00000000u},
+    {"RMGP01", 0x00000f00u, 0x40000c07u, 0x00000000u, 0x00000000u},
+    {"RMGP01", 0x00033f00u, 0x40e16c07u, 0x80000000u, 0x00000000u},
+    {"RSBP01", 0x00032f02u, 0x41217009u, 0x80000009u, 0x00000000u},
+    {"RSBP01", 0x00002a00u, 0x40017009u, 0x00000000u, 0x00000000u},
+    {"RSBP01", 0x00002f00u, 0x40000c09u, 0x80000000u, 0x00000000u},
+    {"SDWP18", 0x00032f00u, 0x41201009u, 0x80000000u, 0x00000000u},
+    {"SDWP18", 0x00000a00u, 0x40001009u, 0x80000000u, 0x00000000u},
+    {"SDWP18", 0x00022a00u, 0x41201009u, 0x00000000u, 0x00000000u},
+    {"SMNP01", 0x00032f0eu, 0x40e16c07u, 0x80241209u, 0x00000000u},
+    {"SMNP01", 0x00032b00u, 0x40e16c07u, 0x00000000u, 0x00000000u},
+    {"SMNP01", 0x00032f06u, 0x40a16c07u, 0x80001209u, 0x00000000u},
+    {"SPDE52", 0x00030f00u, 0x40e00409u, 0x00000000u, 0x00000000u},
+    {"SPDE52", 0x000f0300u, 0x40e00009u, 0x00000007u, 0x00000000u},
+    {"SPDE52", 0x000a0200u, 0x40e00009u, 0x00000007u, 0x00000000u},
+    {"SPXP41", 0x000f0300u, 0x40e00007u, 0x00000001u, 0x00000000u},
+    {"SPXP41", 0x00030f80u, 0x41201009u, 0x80000000u, 0x04800000u},
+    {"SPXP41", 0x000f3300u, 0x40e16007u, 0x00000001u, 0x00000000u},
+    {"SX4E01", 0x00033f00u, 0x41214c09u, 0x00000000u, 0x00000000u},
+    {"SX4E01", 0x00033f00u, 0x40e12c09u, 0x00000000u, 0x00000000u},
+    {"SX4E01", 0x00032f00u, 0x40e12c09u, 0x00000000u, 0x00000000u},
+};
+// clang-format on
+
+struct LoaderType
+{
+  const char* name;
+  std::function<std::unique_ptr<VertexLoaderBase>(const TVtxDesc&, const VAT&)> create;
+};
+
+template <typename T>
+LoaderType MakeLoaderType(const char* name)
+{
+  return {name, [](const TVtxDesc& vtx_desc, const VAT& vtx_attr) {
+            return std::unique_ptr<VertexLoaderBase>(std::make_unique<T>(vtx_desc, vtx_attr));
+          }};
+}
+
+const std::vector<LoaderType> LOADER_TYPES = {
+    MakeLoaderType<VertexLoader>("Software"),
+#ifdef _M_X86_64
+    MakeLoaderType<VertexLoaderX64>("X64"),
+#elif defined(_M_ARM_64)
+    MakeLoaderType<VertexLoaderARM64>("ARM64"),
+#endif
+    MakeLoaderType<VertexLoaderCompiled>("Compiled"),
+};
+
+constexpr int VERTICES_PER_RUN = 0x10000;
+// Indices are random, every array is a small window so lookups stay in bounds.
+constexpr u32 ARRAY_STRIDE = 8;
+constexpr size_t ARRAY_SIZE = 0x10000 * ARRAY_STRIDE + 256;
+constexpr auto MIN_BENCHMARK_TIME = std::chrono::milliseconds(100);
+
+class VertexLoaderBenchmark : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    g_ActiveConfig.iBBoxMode = BBoxNone;
+    m_array_data.assign(ARRAY_SIZE, 0);
+    for (int i = 0; i < 16; i++)
+    {
+      cached_arraybases[i] = m_array_data.data();
+      g_main_cp_state.array_strides[i] = ARRAY_STRIDE;
+    }
+  }
+
+  static void GetFormat(const Format& format, TVtxDesc* vtx_desc, VAT* vtx_attr)
+  {
+    // VertexLoaderUID keeps PosMatIdx in the otherwise unused top bit of the second VAT word.
+    vtx_desc->Hex = (static_cast<u64>(format.vtx_desc) << 1) | (format.vat1 >> 31);
+    vtx_attr->g0.Hex = format.vat0;
+    vtx_attr->g1.Hex = format.vat1 & 0x7FFFFFFF;
+    vtx_attr->g2.Hex = format.vat2;
+  }
+
+  std::vector<u8> m_array_data;
+};
+}  // namespace
+
+TEST_F(VertexLoaderBenchmark, FormatsHavePrecompiledLoaders)
+{
+  for (const Format& format : FORMATS)
+  {
+    TVtxDesc vtx_desc;
+    VAT vtx_attr;
+    GetFormat(format, &vtx_desc, &vtx_attr);
+
+    VertexLoaderUID uid(vtx_desc, vtx_attr);
+    EXPECT_EQ(format.vtx_desc, uid.GetElement(0)) << format.game;
+    EXPECT_EQ(format.vat0, uid.GetElement(1)) << format.game;
+    EXPECT_EQ(format.vat1, uid.GetElement(2)) << format.game;
+    EXPECT_EQ(format.vat2, uid.GetElement(3)) << format.game;
+
+    VertexLoaderCompiled compiled(vtx_desc, vtx_attr);
+    VertexLoader software(vtx_desc, vtx_attr);
+    ASSERT_TRUE(compiled.IsInitialized()) << format.game << " " << software.GetName();
+    EXPECT_EQ(software.m_VertexSize, compiled.m_VertexSize) << software.GetName();
+    EXPECT_EQ(software.m_native_stride, compiled.m_native_stride) << software.GetName();
+  }
+}
+
+TEST_F(VertexLoaderBenchmark, DISABLED_VerticesPerSecond)
+{
+  std::mt19937 rng;
+  std::vector<u8> source;
+  std::vector<u8> destination;
+
+  std::printf("%-8s", "Game");
+  for (const LoaderType& type : LOADER_TYPES)
+    std::printf(" %12s", type.name);
+  std::printf("   (million vertices per second)\n");
+
+  for (const Format& format : FORMATS)
+  {
+    TVtxDesc vtx_desc;
+    VAT vtx_attr;
+    GetFormat(format, &vtx_desc, &vtx_attr);
+
+    std::string name;
+    std::printf("%-8s", format.game);
+    for (const LoaderType& type : LOADER_TYPES)
+    {
+      std::unique_ptr<VertexLoaderBase> loader = type.create(vtx_desc, vtx_attr);
+      if (!loader->IsInitialized())
+      {
+        std::printf(" %12s", "-");
+        continue;
+      }
+      if (name.empty())
+        name = loader->GetName();
+
+      // Every loader gets the same input, the random indices end up somewhere in the arrays.
+      source.resize(static_cast<size_t>(VERTICES_PER_RUN) * loader->m_VertexSize);
+      rng.seed(0x1234);
+      for (u8& byte : source)
+        byte = static_cast<u8>(rng());
+      destination.resize(static_cast<size_t>(VERTICES_PER_RUN) * loader->m_native_stride + 256);
+
+      VertexLoaderParameters parameters = {};
+      parameters.source = source.data();
+      parameters.destination = destination.data();
+      parameters.VtxDesc = &vtx_desc;
+      parameters.VtxAttr = &vtx_attr;
+      parameters.buf_size = source.size();
+      parameters.count = VERTICES_PER_RUN;
+
+      u64 vertices = 0;
+      const auto start = std::chrono::steady_clock::now();
+      auto elapsed = std::chrono::steady_clock::duration::zero();
+      while (elapsed < MIN_BENCHMARK_TIME)
+      {
+        vertices += loader->RunVertices(parameters);
+        elapsed = std::chrono::steady_clock::now() - start;
+      }
+      std::printf(" %12.1f", vertices / std::chrono::duration<double, std::micro>(elapsed).count());
+    }
+    std::printf("   %s\n", name.c_str());
+  }
+}